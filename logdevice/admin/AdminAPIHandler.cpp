@@ -9,6 +9,7 @@
 #include "logdevice/admin/AdminAPIHandler.h"
 
 #include <array>
+#include <unordered_set>
 
 #include <folly/MoveWrapper.h>
 #include <folly/stats/MultiLevelTimeSeries.h>
@@ -335,12 +336,15 @@ void AdminAPIHandler::getLogGroupThroughput(
     throw err;
   }
 
-  AggregateMap agg = doAggregate(stats_holder_,
-                                 time_series,
-                                 query_intervals,
-                                 processor_->config_->getLogsConfig());
-
   std::string req_log_group = request->log_group_name_ref().value_or("");
+  std::unordered_set<std::string> only_log_groups{req_log_group};
+
+  AggregateMap agg =
+      doAggregate(stats_holder_,
+                  time_series,
+                  query_intervals,
+                  processor_->config_->getLogsConfig(),
+                  req_log_group.empty() ? nullptr : &only_log_groups);
 
   for (const auto& entry : agg) {
     std::string log_group_name = entry.first;
@@ -12,6 +12,7 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/debug.h"
 #include "logdevice/common/request_util.h"
 #include "logdevice/common/settings/SettingsUpdater.h"
 
@@ -26,16 +27,44 @@ void NodesConfigAPIHandler::getNodesConfig(
   // until we get a final list to return.
 
   auto nodes_configuration = processor_->getNodesConfiguration();
+  auto cache = getNodeConfigCache(*nodes_configuration);
   std::vector<thrift::NodeConfig> result_nodes;
 
   forFilteredNodes(*nodes_configuration, filter.get(), [&](node_index_t index) {
-    thrift::NodeConfig node;
-    fillNodeConfig(node, index, *nodes_configuration);
-    result_nodes.push_back(std::move(node));
+    auto it = cache->nodes.find(index);
+    ld_check(it != cache->nodes.end());
+    result_nodes.push_back(it->second);
   });
   out.set_nodes(std::move(result_nodes));
   out.set_version(
       static_cast<int64_t>(nodes_configuration->getVersion().val()));
 }
 
+std::shared_ptr<const NodesConfigAPIHandler::NodeConfigCache>
+NodesConfigAPIHandler::getNodeConfigCache(
+    const configuration::nodes::NodesConfiguration& nodes_configuration) {
+  const uint64_t version = nodes_configuration.getVersion().val();
+  {
+    std::lock_guard<std::mutex> lock(node_config_cache_mutex_);
+    if (node_config_cache_ && node_config_cache_->version == version) {
+      return node_config_cache_;
+    }
+  }
+
+  // Build the new cache without holding the lock. Concurrent callers may
+  // build it too, which is harmless.
+  auto cache = std::make_shared<NodeConfigCache>();
+  cache->version = version;
+  forFilteredNodes(nodes_configuration, nullptr, [&](node_index_t index) {
+    fillNodeConfig(cache->nodes[index], index, nodes_configuration);
+  });
+
+  std::lock_guard<std::mutex> lock(node_config_cache_mutex_);
+  // Don't replace a cache built for a more recent version in the meantime.
+  if (!node_config_cache_ || node_config_cache_->version <= version) {
+    node_config_cache_ = cache;
+  }
+  return cache;
+}
+
 }} // namespace facebook::logdevice
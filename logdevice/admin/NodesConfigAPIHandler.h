@@ -8,10 +8,14 @@
 
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
+
 #include <folly/Optional.h>
 
 #include "logdevice/admin/AdminAPIHandlerBase.h"
 #include "logdevice/common/NodeID.h"
+#include "logdevice/common/configuration/nodes/NodesConfiguration.h"
 #include "logdevice/common/types_internal.h"
 
 namespace facebook { namespace logdevice {
@@ -22,5 +26,23 @@ class NodesConfigAPIHandler : public virtual AdminAPIHandlerBase {
   // See admin.thrift for documentation
   getNodesConfig(thrift::NodesConfigResponse&,
                  std::unique_ptr<thrift::NodesFilter> filter) override;
+
+ private:
+  // thrift::NodeConfig of every node in one version of the nodes
+  // configuration. Automation polls getNodesConfig() much more often than the
+  // nodes configuration changes, so we only convert it once per version and
+  // each call only filters and copies.
+  struct NodeConfigCache {
+    uint64_t version;
+    std::unordered_map<node_index_t, thrift::NodeConfig> nodes;
+  };
+
+  // Returns the cache for `nodes_configuration', rebuilding it if it is for
+  // another version.
+  std::shared_ptr<const NodeConfigCache> getNodeConfigCache(
+      const configuration::nodes::NodesConfiguration& nodes_configuration);
+
+  std::mutex node_config_cache_mutex_;
+  std::shared_ptr<const NodeConfigCache> node_config_cache_;
 };
 }} // namespace facebook::logdevice
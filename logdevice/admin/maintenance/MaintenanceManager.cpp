@@ -243,8 +243,12 @@ void MaintenanceManager::startInternal() {
 
 void MaintenanceManager::activateReevaluationTimer() {
   if (!reevaluation_timer_) {
-    reevaluation_timer_ =
-        std::make_unique<Timer>([this]() { add([this]() { scheduleRun(); }); });
+    reevaluation_timer_ = std::make_unique<Timer>([this]() {
+      add([this]() {
+        force_safety_check_ = true;
+        scheduleRun();
+      });
+    });
   }
   if (!reevaluation_timer_->isActive()) {
     reevaluation_timer_->activate(
@@ -1206,14 +1210,48 @@ folly::SemiFuture<SafetyCheckResult> MaintenanceManager::scheduleSafetyCheck() {
   if (shard_wf.empty() && seq_wf.empty()) {
     unsafe_groups_.clear();
     return folly::makeUnexpected(E::EMPTY);
-  } else {
-    return deps_->postSafetyCheckRequest(
-        *cluster_maintenance_wrapper_,
-        event_log_rebuilding_set_->toShardStatusMap(*nodes_config_),
-        nodes_config_,
-        shard_wf,
-        seq_wf);
   }
+
+  SafetyCheckInputs inputs{
+      nodes_config_->getVersion(),
+      cluster_maintenance_wrapper_->getVersion(),
+      event_log_rebuilding_set_->toShardStatusMap(*nodes_config_),
+      {},
+      {}};
+  for (const ShardWorkflow* wf : shard_wf) {
+    inputs.shards.insert(wf->getShardID());
+  }
+  for (const SequencerWorkflow* wf : seq_wf) {
+    inputs.sequencers.insert(wf->getNodeIndex());
+  }
+
+  if (!force_safety_check_ && last_safety_check_.hasValue() &&
+      last_safety_check_->first == inputs) {
+    ld_info("Reusing result of the last safety check for %zu shards and %zu "
+            "sequencers as its inputs did not change",
+            inputs.shards.size(),
+            inputs.sequencers.size());
+    return SafetyCheckResult(last_safety_check_->second);
+  }
+  force_safety_check_ = false;
+  last_safety_check_.clear();
+
+  auto future = deps_->postSafetyCheckRequest(*cluster_maintenance_wrapper_,
+                                              inputs.status_map,
+                                              nodes_config_,
+                                              shard_wf,
+                                              seq_wf);
+  return std::move(future)
+      .via(this)
+      .thenValue([this, inputs = std::move(inputs)](
+                     SafetyCheckResult&& result) mutable {
+        if (result.hasValue()) {
+          last_safety_check_.assign(
+              std::make_pair(std::move(inputs), result.value()));
+        }
+        return std::move(result);
+      })
+      .semi();
 }
 
 folly::SemiFuture<MaintenanceManager::MMStatus>
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <folly/Optional.h>
 #include <folly/container/F14Map.h>
 #include <folly/container/F14Set.h>
 #include <folly/futures/Future.h>
@@ -559,6 +560,34 @@ class MaintenanceManager : public SerialWorkContext {
   // Updated every time `evaluate` is called
   folly::F14NodeMap<GroupID, Impact> unsafe_groups_;
 
+  // What a safety check run depends on. Event log and NodesConfiguration
+  // updates trigger an evaluation but most of them (e.g. rebuilding progress)
+  // change none of these, in which case the last result is still valid.
+  struct SafetyCheckInputs {
+    membership::MembershipVersion::Type nodes_config_version;
+    uint64_t maintenance_state_version;
+    ShardAuthoritativeStatusMap status_map;
+    ShardSet shards;
+    SafetyCheckScheduler::NodeIndexSet sequencers;
+
+    bool operator==(const SafetyCheckInputs& rhs) const {
+      return nodes_config_version == rhs.nodes_config_version &&
+          maintenance_state_version == rhs.maintenance_state_version &&
+          status_map == rhs.status_map && shards == rhs.shards &&
+          sequencers == rhs.sequencers;
+    }
+  };
+
+  // Inputs and result of the last successful safety check run. Reused by
+  // `scheduleSafetyCheck` if the inputs did not change.
+  folly::Optional<std::pair<SafetyCheckInputs, SafetyCheckScheduler::Result>>
+      last_safety_check_;
+
+  // Set when `reevaluation_timer_` fires. Safety checks also depend on state
+  // that is not in SafetyCheckInputs (cluster state, log metadata), so the
+  // periodic reevaluation always runs them.
+  bool force_safety_check_{false};
+
   folly::Promise<folly::Unit> shutdown_promise_;
 
   // A timer that when fired calls `scheduleRun`
@@ -1045,4 +1045,62 @@ TEST_F(MaintenanceManagerTest, NodesConfigUpdateTestWithSafetyCheckFailures) {
   verifyMaintenanceStatus(N18S0, MaintenanceStatus::COMPLETED);
 }
 
+// An evaluation triggered by an update that changes none of the inputs of the
+// safety check reuses the result of the last one.
+TEST_F(MaintenanceManagerTest, SafetyCheckResultReused) {
+  init();
+  EXPECT_CALL(*maintenance_manager_, runShardWorkflows())
+      .WillRepeatedly(Invoke([this]() { return getShardWorkflowResult(); }));
+  EXPECT_CALL(*maintenance_manager_, runSequencerWorkflows())
+      .WillRepeatedly(
+          Invoke([this]() { return getSequencerWorkflowResult(); }));
+  EXPECT_CALL(
+      *maintenance_manager_, getExpectedStorageStateTransition(::testing::_))
+      .WillRepeatedly(Invoke([this](ShardID shard) {
+        return expected_storage_state_transition_[shard];
+      }));
+
+  auto N1S0 = ShardID(1, 0);
+  auto N2S0 = ShardID(2, 0);
+  auto N9S0 = ShardID(9, 0);
+  std::unordered_map<ShardID,
+                     std::pair<MaintenanceStatus,
+                               membership::StorageStateTransition>>
+      wf_result;
+  for (auto s : {N1S0, N2S0, N9S0}) {
+    wf_result[s] = {MaintenanceStatus::AWAITING_SAFETY_CHECK,
+                    membership::StorageStateTransition::DISABLING_WRITE};
+    safety_check_shards_.push_back(s);
+  }
+  setShardWorkflowResult(wf_result);
+  setSequencerWorkflowResult(SeqWfResult());
+
+  maintenance_manager_->onClusterMaintenanceStateUpdate(cms_, lsn_t(1));
+  maintenance_manager_->onEventLogRebuildingSetUpdate(set_, lsn_t(1));
+  runExecutor();
+  verifyMMStatus(MaintenanceManager::MMStatus::AWAITING_SAFETY_CHECK_RESULTS);
+
+  // All maintenances are unsafe.
+  Impact impact(Impact::ImpactResult::WRITE_AVAILABILITY_LOSS);
+  for (auto group : {"N1N2_MAYDISAPPEAR", "N2_DRAINED", "N9_DRAINED"}) {
+    unsafe_groups_[group] = impact;
+  }
+  safety_check_shards_.clear();
+  fulfillSafetyCheckPromise();
+  runExecutor();
+  verifyMMStatus(MaintenanceManager::MMStatus::AWAITING_STATE_CHANGE);
+  ASSERT_TRUE(safety_check_promise_.isFulfilled());
+
+  // The rebuilding set has a new version but the same shard statuses. The
+  // workflows run again but no new safety check is requested.
+  setShardWorkflowResult(wf_result);
+  maintenance_manager_->onEventLogRebuildingSetUpdate(set_, lsn_t(2));
+  runExecutor();
+  verifyMMStatus(MaintenanceManager::MMStatus::AWAITING_STATE_CHANGE);
+  ASSERT_TRUE(safety_check_promise_.isFulfilled());
+  for (auto s : {N1S0, N2S0, N9S0}) {
+    verifyMaintenanceStatus(s, MaintenanceStatus::BLOCKED_UNTIL_SAFE);
+  }
+}
+
 }}} // namespace facebook::logdevice::maintenance
@@ -7,6 +7,8 @@
  */
 #include "logdevice/admin/safety/SafetyCheckerUtils.h"
 
+#include <folly/hash/Hash.h>
+
 #include "logdevice/common/EpochMetaData.h"
 #include "logdevice/common/FailureDomainNodeSet.h"
 
@@ -15,6 +17,32 @@ using namespace facebook::logdevice;
 
 namespace facebook { namespace logdevice { namespace safety {
 
+size_t StorageSetAvailabilityCache::KeyHasher::
+operator()(const Key& key) const {
+  size_t h = folly::hash::hash_range(
+      key.storage_set.begin(), key.storage_set.end(), 0, ShardID::Hash());
+  for (const auto& scope : key.replication.getDistinctReplicationFactors()) {
+    h = folly::hash::hash_combine(
+        h, static_cast<int>(scope.first), scope.second);
+  }
+  return folly::hash::hash_combine(h, key.require_fully_started);
+}
+
+const std::pair<bool, bool>*
+StorageSetAvailabilityCache::find(const StorageSet& storage_set,
+                                  const ReplicationProperty& replication,
+                                  bool require_fully_started) const {
+  auto it = map_.find(Key{storage_set, replication, require_fully_started});
+  return it == map_.end() ? nullptr : &it->second;
+}
+
+void StorageSetAvailabilityCache::insert(const StorageSet& storage_set,
+                                         const ReplicationProperty& replication,
+                                         bool require_fully_started,
+                                         std::pair<bool, bool> result) {
+  map_[Key{storage_set, replication, require_fully_started}] = result;
+}
+
 folly::Expected<Impact, Status> checkImpactOnLogs(
     const std::vector<logid_t>& log_ids,
     const std::shared_ptr<LogMetaDataFetcher::Results>& metadata,
@@ -33,6 +61,7 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
   std::vector<Impact::ImpactOnEpoch> affected_logs_sample;
   size_t logs_done = 0;
   bool internal_logs_affected = false;
+  StorageSetAvailabilityCache cache;
 
   // Check other logs
   for (logid_t log_id : log_ids) {
@@ -46,7 +75,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
                                    target_storage_state,
                                    safety_margin,
                                    nodes_config,
-                                   cluster_state);
+                                   cluster_state,
+                                   &cache);
     logs_done++;
     if (result.hasError()) {
       // The operation failed. Possibly because we don't have metadata for
@@ -71,6 +101,9 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
       }
     }
   }
+  ld_debug("Checked %lu logs, %lu distinct storage sets",
+           logs_done,
+           cache.size());
 
   return Impact(impact_result_all,
                 std::move(affected_logs_sample),
@@ -89,7 +122,8 @@ folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state) {
+    ClusterState* cluster_state,
+    StorageSetAvailabilityCache* cache) {
   ld_assert(metadata_cache);
   if (metadata_cache->find(log_id) == metadata_cache->end()) {
     // We cannot find the epoch metadata for this log. This can have multiple
@@ -137,16 +171,31 @@ folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     bool safe_writes;
     bool safe_reads;
 
-    std::tie(safe_reads, safe_writes) =
-        checkReadWriteAvailablity(shard_status,
-                                  op_shards,
-                                  epoch_metadata.shards,
-                                  target_storage_state,
-                                  epoch_metadata.replication,
-                                  safety_margin,
-                                  nodes_config,
-                                  cluster_state,
-                                  require_fully_started);
+    const std::pair<bool, bool>* cached = cache
+        ? cache->find(epoch_metadata.shards,
+                      epoch_metadata.replication,
+                      require_fully_started)
+        : nullptr;
+    if (cached) {
+      std::tie(safe_reads, safe_writes) = *cached;
+    } else {
+      std::tie(safe_reads, safe_writes) =
+          checkReadWriteAvailablity(shard_status,
+                                    op_shards,
+                                    epoch_metadata.shards,
+                                    target_storage_state,
+                                    epoch_metadata.replication,
+                                    safety_margin,
+                                    nodes_config,
+                                    cluster_state,
+                                    require_fully_started);
+      if (cache) {
+        cache->insert(epoch_metadata.shards,
+                      epoch_metadata.replication,
+                      require_fully_started,
+                      std::make_pair(safe_reads, safe_writes));
+      }
+    }
 
     if (safe_writes && safe_reads) {
       continue;
@@ -7,6 +7,9 @@
  */
 #pragma once
 
+#include <unordered_map>
+#include <utility>
+
 #include "logdevice/admin/safety/LogMetaDataFetcher.h"
 #include "logdevice/admin/safety/SafetyAPI.h"
 #include "logdevice/common/ClusterState.h"
@@ -17,6 +20,51 @@
 
 namespace facebook { namespace logdevice { namespace safety {
 
+/**
+ * Memoizes results of checkReadWriteAvailablity() by storage set and
+ * replication property. Many logs, and many epochs of each log, share the same
+ * storage set and replication, while the other inputs of the check (shard
+ * status, shards affected by the operation, cluster state, nodes config) are
+ * the same for all logs of one checkImpactOnLogs() call. So the check only
+ * needs to be done once per distinct storage set within that call.
+ *
+ * Not thread-safe.
+ */
+class StorageSetAvailabilityCache {
+ public:
+  // Returns the cached (safe_for_reads, safe_for_writes) pair, or nullptr.
+  const std::pair<bool, bool>* find(const StorageSet& storage_set,
+                                    const ReplicationProperty& replication,
+                                    bool require_fully_started) const;
+
+  void insert(const StorageSet& storage_set,
+              const ReplicationProperty& replication,
+              bool require_fully_started,
+              std::pair<bool, bool> result);
+
+  size_t size() const {
+    return map_.size();
+  }
+
+ private:
+  struct Key {
+    StorageSet storage_set;
+    ReplicationProperty replication;
+    bool require_fully_started;
+
+    bool operator==(const Key& rhs) const {
+      return require_fully_started == rhs.require_fully_started &&
+          storage_set == rhs.storage_set && replication == rhs.replication;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const;
+  };
+
+  std::unordered_map<Key, std::pair<bool, bool>, KeyHasher> map_;
+};
+
 /**
  * Performs safety check on given logs
  */
@@ -36,6 +84,10 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
     ClusterState* cluster_state);
 /**
  * Perform safety check on a single log.
+ *
+ * @param cache  if not nullptr, used to skip checks of storage sets already
+ *               checked with the same other arguments, see
+ *               StorageSetAvailabilityCache.
  */
 folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     logid_t log_id,
@@ -47,7 +99,8 @@ folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state);
+    ClusterState* cluster_state,
+    StorageSetAvailabilityCache* cache = nullptr);
 
 /**
  * Checks whether a node is alive in the FailureDetector (gossip) or not.
@@ -7,8 +7,12 @@
  */
 #include "logdevice/admin/safety/SafetyChecker.h"
 
+#include <utility>
+
 #include <gtest/gtest.h>
 
+#include "logdevice/admin/safety/SafetyCheckerUtils.h"
+
 using namespace facebook::logdevice;
 
 TEST(SafetyCheckerTest, Parse) {
@@ -21,3 +25,24 @@ TEST(SafetyCheckerTest, Parse) {
   ASSERT_EQ(2, safety_margin2[NodeLocationScope::RACK]);
   ASSERT_EQ(5, safety_margin2[NodeLocationScope::NODE]);
 }
+
+TEST(SafetyCheckerTest, StorageSetAvailabilityCache) {
+  using safety::StorageSetAvailabilityCache;
+  StorageSetAvailabilityCache cache;
+  const StorageSet set1{ShardID(1, 0), ShardID(2, 0), ShardID(3, 0)};
+  const StorageSet set2{ShardID(1, 1), ShardID(2, 1), ShardID(3, 1)};
+  const ReplicationProperty r2({{NodeLocationScope::NODE, 2}});
+  const ReplicationProperty r3({{NodeLocationScope::NODE, 3}});
+
+  EXPECT_EQ(nullptr, cache.find(set1, r2, true));
+  cache.insert(set1, r2, true, std::make_pair(true, false));
+  const auto* res = cache.find(set1, r2, true);
+  ASSERT_NE(nullptr, res);
+  EXPECT_EQ(std::make_pair(true, false), *res);
+
+  // Any difference in the key is a miss.
+  EXPECT_EQ(nullptr, cache.find(set2, r2, true));
+  EXPECT_EQ(nullptr, cache.find(set1, r3, true));
+  EXPECT_EQ(nullptr, cache.find(set1, r2, false));
+  EXPECT_EQ(1, cache.size());
+}
@@ -19,12 +19,22 @@ class Directory:
 class Reader:
     def __iter__(self) -> Iterator: ...
     def __next__(self) -> Tuple[Any, Any]: ...
+    def read_into(self, payloads: Any, metadata: Any) -> Tuple[int, Any]: ...
     def stop_iteration(self) -> bool: ...
     def start_reading(self, logid: int, from_: lsn_t, until_: lsn_t) -> bool: ...
     def stop_reading(self, logid: int) -> bool: ...
     def is_connection_healthy(self, logid: int) -> bool: ...
     def without_payload(self) -> bool: ...
 
+class AppendBatch:
+    def __len__(self) -> int: ...
+    def done(self) -> bool: ...
+    def wait(self, timeout: Optional[float] = None) -> List[Tuple[lsn_t, Any]]: ...
+
+class BufferedWriter:
+    def append_async(self, logid: int, payloads: List[Any]) -> AppendBatch: ...
+    def flush(self) -> None: ...
+
 # client API
 class Client:
     def __init__(
@@ -37,6 +47,15 @@ class Client:
         csid: Optional[str] = None,
     ) -> None: ...
     def append(self, logid: int, data: str) -> bool: ...
+    def append_async(self, logid: int, payloads: List[Any]) -> AppendBatch: ...
+    def create_buffered_writer(
+        self,
+        compression: str = "lz4",
+        time_trigger: Optional[float] = None,
+        size_trigger: int = -1,
+        retry_count: int = 0,
+        memory_limit_mb: int = -1,
+    ) -> BufferedWriter: ...
     def create_reader(self, max_logs: int) -> Reader: ...
     def data_size(self, logid: int, start_sec: float, end_sec: float) -> int: ...
     def find_key(self, logid: int, key: str) -> Tuple[int, int]: ...
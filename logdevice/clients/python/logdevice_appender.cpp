@@ -0,0 +1,318 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+
+#include "logdevice/clients/python/util/util.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/include/BufferedWriter.h"
+#include "logdevice/include/Client.h"
+
+using namespace boost::python;
+using namespace facebook::logdevice;
+
+// Outcome of the appends submitted by one append_async() call, filled in by
+// LogDevice threads as the appends complete. Completions never take the GIL:
+// Python only looks at them in wait(), once for the whole batch.
+class AppendBatch : boost::noncopyable {
+ public:
+  explicit AppendBatch(size_t size)
+      // every entry is overwritten by complete()
+      : results_(size, std::make_pair(LSN_INVALID, E::INTERNAL)),
+        remaining_(size) {}
+
+  // Records the outcome of the i-th append of the batch. Thread safe, and
+  // must be called exactly once per append.
+  void complete(size_t i, Status st, lsn_t lsn) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ld_check(i < results_.size());
+    ld_check(remaining_ > 0);
+    results_[i] = std::make_pair(st == E::OK ? lsn : LSN_INVALID, st);
+    if (--remaining_ == 0) {
+      cv_.notify_all();
+    }
+  }
+
+  bool done() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return remaining_ == 0;
+  }
+
+  size_t size() const {
+    return results_.size();
+  }
+
+  /**
+   * Waits for all appends of the batch to complete, without holding the GIL,
+   * and returns a list with an (lsn, status) tuple per append, in the order
+   * of the payloads. Raises with E::TIMEDOUT if TIMEOUT (in seconds, None for
+   * no limit) expires first.
+   */
+  list wait(object timeout) {
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if (!timeout.is_none()) {
+      double seconds = extract_double(timeout, "timeout", true);
+      deadline = std::chrono::steady_clock::now() +
+          std::chrono::milliseconds(lround(seconds * 1000));
+    }
+
+    for (;;) {
+      const auto wait_until = std::min(
+          deadline,
+          std::chrono::steady_clock::now() + std::chrono::milliseconds(1000));
+      bool all_done;
+      {
+        gil_release_and_guard guard;
+        std::unique_lock<std::mutex> lock(mutex_);
+        all_done = cv_.wait_until(
+            lock, wait_until, [this] { return remaining_ == 0; });
+      }
+      if (all_done) {
+        break;
+      }
+      // check for signals using Python layer, and raise if one was found, so
+      // that waiting for a large batch can be interrupted
+      if (PyErr_CheckSignals() != 0) {
+        throw_python_exception();
+      }
+      if (std::chrono::steady_clock::now() >= deadline) {
+        err = E::TIMEDOUT;
+        throw_logdevice_exception();
+      }
+    }
+
+    // complete() no longer touches results_
+    list out;
+    for (const auto& result : results_) {
+      out.append(boost::python::make_tuple(result.first, result.second));
+    }
+    return out;
+  }
+
+ private:
+  std::vector<std::pair<lsn_t, Status>> results_;
+  size_t remaining_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+// Copies the payloads out of a Python iterable of bytes or str objects, so
+// that they can be appended without holding the GIL.
+static std::vector<std::string> extract_payloads(object payloads) {
+  std::vector<std::string> out;
+  stl_input_iterator<object> begin(payloads), end;
+  std::for_each(begin, end, [&](object payload) {
+    out.push_back(extract_string(payload, "payload"));
+  });
+  if (out.empty()) {
+    throw_python_exception(PyExc_ValueError, "no payloads to append");
+  }
+  return out;
+}
+
+object logdevice_append_async(Client& self, logid_t logid, object payloads) {
+  std::vector<std::string> pls = extract_payloads(payloads);
+  auto batch = boost::make_shared<AppendBatch>(pls.size());
+  {
+    gil_release_and_guard guard;
+    for (size_t i = 0; i < pls.size(); ++i) {
+      int rv = self.append(
+          logid, std::move(pls[i]), [batch, i](Status st, const DataRecord& r) {
+            batch->complete(i, st, r.attrs.lsn);
+          });
+      if (rv != 0) {
+        // the callback won't be called
+        batch->complete(i, err, LSN_INVALID);
+      }
+    }
+  }
+  return object(batch);
+}
+
+// A BufferedWriter that reports the outcome of each appended payload to the
+// AppendBatch it was submitted with.
+class BufferedWriterWrapper : public BufferedWriter::AppendCallback,
+                              boost::noncopyable {
+ public:
+  BufferedWriterWrapper(std::shared_ptr<Client> client,
+                        BufferedWriter::Options options) {
+    gil_release_and_guard guard;
+    writer_ = BufferedWriter::create(std::move(client), this, options);
+  }
+
+  ~BufferedWriterWrapper() override {
+    // waits for LogDevice threads to acknowledge, and fails buffered appends
+    gil_release_and_guard guard;
+    writer_.reset();
+  }
+
+  object append_async(logid_t logid, object payloads) {
+    std::vector<std::string> pls = extract_payloads(payloads);
+    auto batch = boost::make_shared<AppendBatch>(pls.size());
+    std::vector<BufferedWriter::Append> appends;
+    std::vector<PendingAppend*> contexts;
+    appends.reserve(pls.size());
+    contexts.reserve(pls.size());
+    for (size_t i = 0; i < pls.size(); ++i) {
+      contexts.push_back(new PendingAppend{batch, i});
+      appends.emplace_back(logid, std::move(pls[i]), contexts.back());
+    }
+
+    std::vector<Status> statuses;
+    {
+      gil_release_and_guard guard;
+      statuses = writer_->append(std::move(appends));
+    }
+    ld_check(statuses.size() == contexts.size());
+    for (size_t i = 0; i < statuses.size(); ++i) {
+      if (statuses[i] != E::OK) {
+        // not queued, no callback will be called for it
+        batch->complete(i, statuses[i], LSN_INVALID);
+        delete contexts[i];
+      }
+    }
+    return object(batch);
+  }
+
+  void flush() {
+    int rv;
+    {
+      gil_release_and_guard guard;
+      rv = writer_->flushAll();
+    }
+    if (rv != 0) {
+      throw_logdevice_exception();
+    }
+  }
+
+  // All records of a batch written by BufferedWriter share its LSN.
+  void onSuccess(logid_t /*log_id*/,
+                 ContextSet contexts_and_payloads,
+                 const DataRecordAttributes& attrs) override {
+    for (auto& entry : contexts_and_payloads) {
+      complete(entry.first, E::OK, attrs.lsn);
+    }
+  }
+
+  void onFailure(logid_t /*log_id*/,
+                 ContextSet contexts_and_payloads,
+                 Status status) override {
+    for (auto& entry : contexts_and_payloads) {
+      complete(entry.first, status, LSN_INVALID);
+    }
+  }
+
+ private:
+  // BufferedWriter context of an appended payload
+  struct PendingAppend {
+    boost::shared_ptr<AppendBatch> batch;
+    size_t index;
+  };
+
+  static void complete(Context context, Status st, lsn_t lsn) {
+    std::unique_ptr<PendingAppend> pending(
+        static_cast<PendingAppend*>(context));
+    pending->batch->complete(pending->index, st, lsn);
+  }
+
+  std::unique_ptr<BufferedWriter> writer_;
+};
+
+object logdevice_create_buffered_writer(boost::shared_ptr<Client> self,
+                                        object compression,
+                                        object time_trigger,
+                                        ssize_t size_trigger,
+                                        int retry_count,
+                                        int32_t memory_limit_mb) {
+  BufferedWriter::Options options;
+  std::string compression_str = extract_string(compression, "compression");
+  if (parseCompression(compression_str.c_str(), &options.compression) != 0) {
+    throw_python_exception(
+        PyExc_ValueError,
+        str("Invalid compression, expected one of none, zstd, lz4, lz4_hc"));
+  }
+  if (!time_trigger.is_none()) {
+    double seconds = extract_double(time_trigger, "time_trigger", true);
+    options.time_trigger = std::chrono::milliseconds(lround(seconds * 1000));
+  }
+  options.size_trigger = size_trigger;
+  options.retry_count = retry_count;
+  options.memory_limit_mb = memory_limit_mb;
+
+  // BufferedWriter needs a std::shared_ptr; this one keeps the Python
+  // object's reference alive for as long as the writer uses it
+  std::shared_ptr<Client> client(
+      self.get(), [self](Client*) mutable { self.reset(); });
+  return object(
+      boost::make_shared<BufferedWriterWrapper>(std::move(client), options));
+}
+
+void register_logdevice_appender() {
+  class_<AppendBatch, boost::shared_ptr<AppendBatch>, boost::noncopyable>(
+      "AppendBatch",
+      R"DOC(
+Results of the appends submitted by one append_async() call.  Appends complete
+on LogDevice threads without taking the GIL; their results are only turned
+into Python objects by wait().
+)DOC",
+      no_init)
+
+      .def("__len__", &AppendBatch::size)
+
+      .def("done",
+           &AppendBatch::done,
+           "True if all appends of the batch have completed.")
+
+      .def("wait",
+           &AppendBatch::wait,
+           (arg("self"), arg("timeout") = object()),
+           R"DOC(
+Wait until all appends of the batch have completed, without holding the GIL,
+and return a list with an (lsn, status) tuple per payload, in the order the
+payloads were given.  Failed appends have LSN_INVALID and the error status.
+
+TIMEOUT is in seconds; None (the default) waits for as long as it takes.
+Raises LogDeviceError with status TIMEDOUT if it expires.  Appends complete
+within the client timeout anyway.
+)DOC");
+
+  class_<BufferedWriterWrapper,
+         boost::shared_ptr<BufferedWriterWrapper>,
+         boost::noncopyable>("BufferedWriter",
+                             R"DOC(
+Writer that batches and compresses appends to the same log into one record
+written by LogDevice.  Readers decode the batches transparently.  Create it
+with Client.create_buffered_writer(); a writer is meant to be long-lived.
+)DOC",
+                             no_init)
+
+      .def("append_async",
+           &BufferedWriterWrapper::append_async,
+           args("self", "logid", "payloads"),
+           R"DOC(
+Queue PAYLOADS, a list of bytes or str objects, for appending to log LOGID,
+and return an AppendBatch.  The GIL is released while they are handed to
+LogDevice.  Payloads appended in the same batch record all get the LSN of that
+record.
+)DOC")
+
+      .def("flush",
+           &BufferedWriterWrapper::flush,
+           args("self"),
+           R"DOC(
+Send all buffered appends right away instead of waiting for the time or size
+trigger.  Does not wait for them to complete.
+)DOC");
+}
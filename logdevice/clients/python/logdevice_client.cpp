@@ -715,8 +715,8 @@ python client)DOC",
          boost::shared_ptr<facebook::logdevice::Client>,
          boost::noncopyable>("Client",
                              R"DOC(
-LogDevice client object.  This only exposes synchronous operations to
-Python at this stage, and raises when errors happen.
+LogDevice client object.  Apart from append_async(), this only exposes
+synchronous operations to Python at this stage, and raises when errors happen.
 )DOC",
                              no_init)
 
@@ -837,6 +837,39 @@ Append a record to log LOGID containing DATA.
 
 DATA can be a bytes object, which is appended as-is,
 or a str/Unicode object which are appended as utf-8 encoded data.
+)DOC")
+
+      .def("append_async",
+           &logdevice_append_async,
+           args("self", "logid", "payloads"),
+           R"DOC(
+Append a record to log LOGID for each of PAYLOADS, a list of bytes or str
+objects, without waiting for the appends to complete.  Returns an AppendBatch
+whose wait() method returns the LSN and status of every append.
+
+The GIL is released while the appends are handed to LogDevice, and their
+completions don't take it, so this sustains much higher append rates than
+calling append() from many threads.  The LSNs of the appends are not
+guaranteed to follow the order of PAYLOADS.
+)DOC")
+
+      .def("create_buffered_writer",
+           &logdevice_create_buffered_writer,
+           (arg("self"),
+            arg("compression") = "lz4",
+            arg("time_trigger") = object(), // None
+            arg("size_trigger") = -1,
+            arg("retry_count") = 0,
+            arg("memory_limit_mb") = -1),
+           R"DOC(
+Return a BufferedWriter, which batches appends to the same log into single
+records, compressed with COMPRESSION (one of none, zstd, lz4, lz4_hc).
+
+A batch is sent once its oldest append has been buffered for TIME_TRIGGER
+seconds (None: no time limit), or once it holds SIZE_TRIGGER bytes of
+payloads (-1: no size limit), or on BufferedWriter.flush().  Failed batches
+are retried up to RETRY_COUNT times.  Appends fail with NOBUFS once buffered
+and in flight payloads exceed MEMORY_LIMIT_MB (-1: no limit).
 )DOC")
 
       .def("find_time",
@@ -1141,6 +1174,7 @@ For example, all these are acceptable
   // register object wrappers from other components
   register_logdevice_reader();
   register_logdevice_record();
+  register_logdevice_appender();
 
   enum_<dbg::Level>("LoggingLevel")
       .value("NONE", dbg::Level::NONE)
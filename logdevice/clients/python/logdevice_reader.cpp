@@ -9,6 +9,8 @@
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstring>
+#include <deque>
 
 #include <boost/make_shared.hpp>
 
@@ -18,6 +20,43 @@
 using namespace boost::python;
 using namespace facebook::logdevice;
 
+// A writable, C-contiguous view of a Python object supporting the buffer
+// protocol (bytearray, memoryview, numpy array, ...). Must be created and
+// destroyed with the GIL held; the memory can be accessed without it.
+class WritableBuffer : boost::noncopyable {
+ public:
+  explicit WritableBuffer(const object& obj) {
+    if (PyObject_GetBuffer(
+            obj.ptr(), &view_, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0) {
+      throw_python_exception();
+    }
+  }
+  ~WritableBuffer() {
+    PyBuffer_Release(&view_);
+  }
+  char* data() {
+    return static_cast<char*>(view_.buf);
+  }
+  size_t size() const {
+    return view_.len;
+  }
+
+ private:
+  Py_buffer view_;
+};
+
+// Per-record entry written by ReaderWrapper::read_into() into the metadata
+// buffer. Payload i occupies [end_offset of record i-1, end_offset of record
+// i) of the payload buffer, so the end offsets prefixed with 0 are the offsets
+// array of an Arrow binary column.
+struct RecordMetadata {
+  uint64_t logid;
+  uint64_t lsn;
+  int64_t timestamp_ms;
+  uint64_t end_offset;
+};
+static_assert(sizeof(RecordMetadata) == 32, "RecordMetadata must be packed");
+
 // A class that implements the Python iterator interface, and treats the
 // LogDevice Reader.read method as an infinite iterator -- returning one
 // record at a time, from the internal buffer that the Reader already
@@ -47,6 +86,14 @@ class ReaderWrapper : boost::noncopyable {
    * object wrapper goes out of scope and is garbage collected.
    */
   boost::python::tuple next() {
+    if (!pending_.empty()) {
+      // left over by read_into()
+      auto record = std::move(pending_.front());
+      pending_.pop_front();
+      return boost::python::make_tuple(
+          boost::shared_ptr<DataRecord>(record.release()), object());
+    }
+
     std::vector<std::unique_ptr<DataRecord>> record;
     GapRecord gap;
 
@@ -97,6 +144,91 @@ class ReaderWrapper : boost::noncopyable {
     throw std::runtime_error("unpossible, the line above always throws!");
   }
 
+  /**
+   * Batch version of next(). Copies as many data records as fit into two
+   * preallocated writable buffers: `payloads' gets the payloads back to back,
+   * `metadata' gets a RecordMetadata (four 64-bit integers: log id, lsn,
+   * timestamp in milliseconds, end offset of the payload) per record. No
+   * Python object is created per record, and the GIL is released while
+   * records are read and copied.
+   *
+   * Blocks like next() until at least one record or a gap is available.
+   * Records that don't fit are kept for the next call.
+   *
+   * Returns a (number of records, GapRecord or None) pair. If there is a gap,
+   * no records are returned with it. (0, None) means that reading has
+   * stopped.
+   */
+  boost::python::tuple read_into(object payloads, object metadata) {
+    WritableBuffer payload_buf(payloads);
+    WritableBuffer meta_buf(metadata);
+    const size_t max_records = meta_buf.size() / sizeof(RecordMetadata);
+    if (max_records == 0) {
+      throw_python_exception(
+          PyExc_ValueError, "Metadata buffer is too small for one record.");
+    }
+
+    size_t nrecords = 0;
+    size_t payload_bytes = 0;
+    // Copies records from pending_ into the buffers while they fit.
+    auto copy_pending = [&] {
+      gil_release_and_guard guard;
+      while (!pending_.empty() && nrecords < max_records) {
+        const DataRecord& r = *pending_.front();
+        const size_t size = r.payload.size();
+        if (size > payload_buf.size() - payload_bytes) {
+          break;
+        }
+        if (size > 0) {
+          memcpy(payload_buf.data() + payload_bytes, r.payload.data(), size);
+        }
+        payload_bytes += size;
+        RecordMetadata m{r.logid.val_,
+                         r.attrs.lsn,
+                         r.attrs.timestamp.count(),
+                         payload_bytes};
+        memcpy(meta_buf.data() + nrecords * sizeof(m), &m, sizeof(m));
+        ++nrecords;
+        pending_.pop_front();
+      }
+    };
+
+    copy_pending();
+    while (nrecords == 0 && pending_.empty() && keep_reading_ &&
+           reader_->isReadingAny()) {
+      if (PyErr_CheckSignals() != 0)
+        throw_python_exception();
+
+      std::vector<std::unique_ptr<DataRecord>> records;
+      GapRecord gap;
+      ssize_t n = 0;
+      {
+        gil_release_and_guard guard;
+        n = reader_->read(max_records, &records, &gap);
+      }
+
+      if (n < 0) {
+        if (err == E::GAP) {
+          return boost::python::make_tuple(
+              0, boost::make_shared<GapRecord>(gap));
+        }
+        throw_logdevice_exception();
+        throw std::runtime_error("unpossible, the line above always throws!");
+      }
+
+      for (auto& record : records) {
+        pending_.push_back(std::move(record));
+      }
+      copy_pending();
+    }
+
+    if (nrecords == 0 && !pending_.empty()) {
+      throw_python_exception(
+          PyExc_ValueError, "Payload buffer is too small for the next record.");
+    }
+    return boost::python::make_tuple(nrecords, object());
+  }
+
   bool stop_iteration() {
     keep_reading_ = false;
     return true; // yes, we did stop as you requested
@@ -139,6 +271,9 @@ class ReaderWrapper : boost::noncopyable {
 
   // should we break out from reading?
   std::atomic<bool> keep_reading_;
+
+  // records read by read_into() that didn't fit into the buffers
+  std::deque<std::unique_ptr<DataRecord>> pending_;
 };
 
 // helper function to wrap a reader for return to Python -- helps hide the
@@ -193,6 +328,28 @@ Implement the 'next' operation from the Python iterator protocol.
 
 This will read until the 'stop_iteration()' method is called
 from Python, or a record (data or gap) can be returned.
+)DOC")
+
+      .def("read_into",
+           &ReaderWrapper::read_into,
+           args("payloads", "metadata"),
+           R"DOC(
+Read a batch of data records into two preallocated writable buffers (e.g.
+bytearray, or numpy arrays), without creating a Python object per record and
+without holding the GIL while reading.
+
+PAYLOADS receives the payloads back to back.  METADATA receives four unsigned
+64-bit integers per record: log id, LSN, timestamp in milliseconds, and the
+offset in PAYLOADS where the payload ends.  E.g. with a numpy array
+meta = numpy.empty((N, 4), dtype=numpy.uint64), up to N records are read.
+Prefixed with 0, the end offsets form the offsets array of an Arrow binary
+column over PAYLOADS.
+
+Blocks like next() until some records or a gap are available.  Returns a
+(number of records, gap) pair; gap is a GapRecord or None, and no records are
+returned along with a gap.  (0, None) means reading has stopped.  Records that
+don't fit are returned by the following calls.  Raises ValueError if the next
+record alone doesn't fit into PAYLOADS.
 )DOC")
 
       .def("stop_iteration",
@@ -6,6 +6,7 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 
 import random
+import struct
 from datetime import datetime
 from time import time as now
 from unittest import TestCase
@@ -124,6 +125,90 @@ class LogDeviceIntegrationTest(TestCase):
                 nread += 1
         self.assertEqual(NWRITES, nread)
 
+    def test_read_into(self):
+        """read_into() returns the same records as iterating, in batches."""
+        NWRITES = 50
+        client = self.client()
+        logid = 1
+        expected = []
+        until_lsn = logdevice.client.LSN_OLDEST
+        for i in range(NWRITES):
+            payload = b"record %d" % i
+            until_lsn = client.append(logid, payload)
+            expected.append((until_lsn, payload))
+
+        reader = client.create_reader(1)
+        reader.start_reading(logid, logdevice.client.LSN_OLDEST, until_lsn)
+
+        # Small buffers, so that records are returned in several batches.
+        payloads = bytearray(64)
+        metadata = bytearray(4 * 8 * 8)
+        records = []
+        while True:
+            n, gap = reader.read_into(payloads, metadata)
+            if gap is not None:
+                self.assertEqual(0, n)
+                continue
+            if n == 0:
+                break
+            begin = 0
+            for i in range(n):
+                log, lsn, _, end = struct.unpack_from("=QQqQ", metadata, i * 32)
+                self.assertEqual(logid, log)
+                records.append((lsn, bytes(payloads[begin:end])))
+                begin = end
+        self.assertEqual(expected, records)
+
+    def test_append_async(self):
+        """append_async() appends every payload and reports all LSNs."""
+        client = self.client()
+        logid = 1
+        payloads = [b"record %d" % i for i in range(100)]
+        batch = client.append_async(logid, payloads)
+        self.assertEqual(len(payloads), len(batch))
+        results = batch.wait(10)
+        self.assertTrue(batch.done())
+        self.assertEqual(len(payloads), len(results))
+        for lsn, status in results:
+            self.assertEqual(ld.status.OK, status)
+            self.assertNotEqual(ld.LSN_INVALID, lsn)
+
+        reader = client.create_reader(1)
+        reader.start_reading(
+            logid, ld.LSN_OLDEST, max(lsn for lsn, _ in results)
+        )
+        records = {}
+        for data, gap in reader:
+            if data is not None:
+                records[data.lsn] = data.payload
+        self.assertEqual(
+            sorted(payloads), sorted(records[lsn] for lsn, _ in results)
+        )
+
+    def test_buffered_writer(self):
+        """Payloads appended through a BufferedWriter share batch LSNs."""
+        client = self.client()
+        logid = 1
+        writer = client.create_buffered_writer(compression="zstd")
+        payloads = [b"record %d" % i for i in range(100)]
+        batch = writer.append_async(logid, payloads)
+        writer.flush()
+        results = batch.wait(10)
+        for lsn, status in results:
+            self.assertEqual(ld.status.OK, status)
+            self.assertNotEqual(ld.LSN_INVALID, lsn)
+        self.assertLess(len(set(lsn for lsn, _ in results)), len(payloads))
+
+        reader = client.create_reader(1)
+        reader.start_reading(
+            logid, ld.LSN_OLDEST, max(lsn for lsn, _ in results)
+        )
+        read = [data.payload for data, gap in reader if data is not None]
+        self.assertEqual(sorted(payloads), sorted(read))
+
+        with self.assertRaises(ValueError):
+            client.create_buffered_writer(compression="gzip")
+
     def test_is_log_empty(self):
         client = self.client()
         client.append(1, "test")
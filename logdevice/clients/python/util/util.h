@@ -14,6 +14,8 @@
 #include <boost/shared_ptr.hpp>
 #include <folly/Demangle.h>
 
+#include "logdevice/include/types.h"
+
 // PyString has been re-named to PyBytes in Python3.  This is a little
 // hack to keep this code compatible with Python 2 and 3
 #if PY_MAJOR_VERSION == 3
@@ -100,6 +102,24 @@ class Reader;
 boost::python::object
     wrap_logdevice_reader(std::unique_ptr<facebook::logdevice::Reader>);
 
+// Client.append_async() and Client.create_buffered_writer(), which return
+// wrappers that are only defined in logdevice_appender.cpp
+namespace facebook { namespace logdevice {
+class Client;
+}}; // namespace facebook::logdevice
+
+boost::python::object
+logdevice_append_async(facebook::logdevice::Client& self,
+                       facebook::logdevice::logid_t logid,
+                       boost::python::object payloads);
+boost::python::object logdevice_create_buffered_writer(
+    boost::shared_ptr<facebook::logdevice::Client> self,
+    boost::python::object compression,
+    boost::python::object time_trigger,
+    ssize_t size_trigger,
+    int retry_count,
+    int32_t memory_limit_mb);
+
 template <typename T>
 inline std::vector<T> to_std_vector(const boost::python::object& iterable) {
   return std::vector<T>(boost::python::stl_input_iterator<T>(iterable),
@@ -109,3 +129,4 @@ inline std::vector<T> to_std_vector(const boost::python::object& iterable) {
 // multiple C++ modules in the single end object requires registration
 void register_logdevice_reader();
 void register_logdevice_record();
+void register_logdevice_appender();
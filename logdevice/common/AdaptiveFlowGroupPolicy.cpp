@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AdaptiveFlowGroupPolicy.h"
+
+#include <algorithm>
+
+namespace facebook { namespace logdevice {
+
+void AdaptiveFlowGroupPolicy::addFeedback(
+    const BackloggedPriorities& backlogged,
+    bool idle) {
+  for (size_t i = 0; i < backlogged.size(); ++i) {
+    backlogged_[i] = backlogged_[i] || backlogged[i];
+  }
+  idle_ = idle_ || idle;
+  have_feedback_ = true;
+}
+
+void AdaptiveFlowGroupPolicy::adjust(const FlowGroupPolicy& configured) {
+  if (!configured.enabled()) {
+    extra_bw_.fill(0);
+  } else if (have_feedback_) {
+    const int64_t pool = configured.entries.back().guaranteed_bw;
+    const int64_t increase = std::max<int64_t>(1, pool / INCREASE_DIVISOR);
+    bool higher_priority_backlogged = false;
+    for (Priority p = Priority::MAX; p < Priority::NUM_PRIORITIES;
+         p = priorityBelow(p)) {
+      int64_t& extra = extra_bw_[asInt(p)];
+      if (backlogged_[asInt(p)] && idle_) {
+        extra += increase;
+      } else if (!backlogged_[asInt(p)] ||
+                 (higher_priority_backlogged && !idle_)) {
+        extra /= 2;
+      }
+      higher_priority_backlogged =
+          higher_priority_backlogged || backlogged_[asInt(p)];
+    }
+  }
+  clamp(configured, extra_bw_);
+
+  backlogged_.fill(false);
+  idle_ = false;
+  have_feedback_ = false;
+}
+
+void AdaptiveFlowGroupPolicy::clamp(const FlowGroupPolicy& configured,
+                                    ExtraBandwidth& extra) {
+  int64_t pool = configured.entries.back().guaranteed_bw;
+  // Higher priorities keep their extra bandwidth first.
+  for (Priority p = Priority::MAX; p < Priority::NUM_PRIORITIES;
+       p = priorityBelow(p)) {
+    const auto& entry = configured.entries[asInt(p)];
+    int64_t& e = extra[asInt(p)];
+    e = std::max<int64_t>(
+        0, std::min({e, entry.max_bw - entry.guaranteed_bw, pool}));
+    pool -= e;
+  }
+}
+
+FlowGroupPolicy
+AdaptiveFlowGroupPolicy::apply(const FlowGroupPolicy& configured) const {
+  FlowGroupPolicy result(configured);
+  if (!configured.enabled()) {
+    return result;
+  }
+  ExtraBandwidth extra = extra_bw_;
+  clamp(configured, extra);
+  int64_t total_extra = 0;
+  for (Priority p = Priority::MAX; p < Priority::NUM_PRIORITIES;
+       p = priorityBelow(p)) {
+    // Capacity (maximum burst) is left as configured.
+    result.entries[asInt(p)].guaranteed_bw += extra[asInt(p)];
+    total_extra += extra[asInt(p)];
+  }
+  auto& pq_entry = result.priorityQEntry();
+  pq_entry.guaranteed_bw = std::max<int64_t>(
+      0, pq_entry.guaranteed_bw - total_extra);
+  return result;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "logdevice/common/Priority.h"
+#include "logdevice/common/configuration/FlowGroupPolicy.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  Adjusts how the bandwidth of a FlowGroup is split between priorities
+ *        based on feedback from the FlowGroups of all Senders, instead of
+ *        using the configured FlowGroupPolicy verbatim.
+ *
+ *        The configured policy defines the bounds. Each priority always gets
+ *        at least its configured guaranteed_bw and never more than its
+ *        max_bw. The extra bandwidth a priority gets is taken from the
+ *        guaranteed_bw of the shared priority queue bucket, so the total
+ *        bandwidth of the FlowGroup never exceeds the configured total.
+ *
+ *        The extra bandwidth is adjusted AIMD style, on each call to adjust():
+ *         - a priority that had messages waiting for bandwidth while the
+ *           FlowGroup was discarding unused credit gets an additive increase;
+ *         - a priority gets a multiplicative decrease if it had nothing
+ *           waiting, or if a higher priority had messages waiting while no
+ *           credit was discarded, i.e. while the FlowGroup was saturated.
+ *
+ *        This way, e.g. rebuilding gets a bigger share when appends leave
+ *        bandwidth unused, and quickly gives it back when they need it.
+ *
+ *        Not thread safe. Used by the TrafficShaper thread only.
+ */
+
+class AdaptiveFlowGroupPolicy {
+ public:
+  using BackloggedPriorities =
+      std::array<bool, asInt(Priority::NUM_PRIORITIES)>;
+
+  // Fraction of the shared priority queue bandwidth given to a priority on
+  // each additive increase.
+  static constexpr int64_t INCREASE_DIVISOR = 16;
+
+  /**
+   * Records what happened during one TrafficShaper quantum.
+   *
+   * @param backlogged  priorities that had messages waiting for bandwidth in
+   *                    at least one Sender
+   * @param idle        true if the FlowGroup had to discard unused credit
+   */
+  void addFeedback(const BackloggedPriorities& backlogged, bool idle);
+
+  /**
+   * Adjusts the split using the feedback accumulated since the last call,
+   * and clears it.
+   */
+  void adjust(const FlowGroupPolicy& configured);
+
+  /**
+   * @return `configured' (in config units, i.e. before
+   *         FlowGroupPolicy::normalize()) with the current extra bandwidth
+   *         moved from the priority queue bucket to the priorities.
+   */
+  FlowGroupPolicy apply(const FlowGroupPolicy& configured) const;
+
+  int64_t extraBandwidth(Priority p) const {
+    return extra_bw_[asInt(p)];
+  }
+
+ private:
+  using ExtraBandwidth = std::array<int64_t, asInt(Priority::NUM_PRIORITIES)>;
+
+  // Bandwidth per second given to each priority on top of its guaranteed_bw.
+  ExtraBandwidth extra_bw_{};
+
+  // Feedback since the last adjust().
+  BackloggedPriorities backlogged_{};
+  bool idle_ = false;
+  bool have_feedback_ = false;
+
+  // Reduces `extra' to what `configured' allows, taking from the lowest
+  // priorities first. The config may have changed since the last adjust().
+  static void clamp(const FlowGroupPolicy& configured, ExtraBandwidth& extra);
+};
+
+}} // namespace facebook::logdevice
@@ -308,7 +308,8 @@ typedef AdminCommandTable<std::string, /* Column family */
                           std::string, /* More context on the iterator */
                           admin_command_table::LSN,  /* Last seek LSN */
                           std::chrono::milliseconds, /* Last seek timestamp */
-                          uint64_t /* RocksDB version after last seek */
+                          uint64_t, /* RocksDB version after last seek */
+                          uint64_t  /* Age in milliseconds */
                           >
     InfoIteratorsTable;
 
@@ -321,6 +322,36 @@ typedef AdminCommandTable<uint64_t,    /* Shard ID */
                           >
     InfoShardsTable;
 
+typedef AdminCommandTable<int64_t,     /* Node */
+                          std::string, /* CPUs */
+                          std::string, /* Shards */
+                          uint64_t,    /* numa_hit */
+                          uint64_t,    /* numa_miss */
+                          uint64_t,    /* numa_foreign */
+                          uint64_t,    /* local_node */
+                          uint64_t     /* other_node */
+                          >
+    InfoNumaTable;
+
+typedef AdminCommandTable<int64_t,     /* Worker */
+                          std::string, /* Kind */
+                          uint64_t,    /* Cycles */
+                          uint64_t,    /* Instructions */
+                          double,      /* IPC */
+                          uint64_t,    /* LLC misses */
+                          uint64_t     /* Context switches */
+                          >
+    StatsPerfTable;
+
+typedef AdminCommandTable<std::string, /* Consumer */
+                          uint64_t,    /* Count */
+                          uint64_t,    /* Used */
+                          uint64_t,    /* Limit */
+                          uint64_t,    /* Base limit */
+                          bool         /* Elastic */
+                          >
+    InfoMemoryTable;
+
 typedef AdminCommandTable<logid_t,                  /* Log ID */
                           uint64_t,                 /* Shard */
                           epoch_t,                  /* Epoch */
@@ -365,6 +396,9 @@ typedef AdminCommandTable<logid_t,                  /* Delta log id */
                           size_t, /* Delta log bytes */
                           size_t, /* delta log records */
                           bool,   /* delta log read stream healthy */
+                          size_t, /* Snapshot sync ms */
+                          size_t, /* Delta sync ms */
+                          size_t, /* Deltas replayed */
                           admin_command_table::LSN /* Propagated version */
                           >
     InfoReplicatedStateMachineTable;
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AppendAdmissionBatcher.h"
+
+#include "logdevice/common/Appender.h"
+#include "logdevice/common/AppenderPrep.h"
+#include "logdevice/common/Sequencer.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+AppendAdmissionBatcher::AppendAdmissionBatcher() = default;
+
+AppendAdmissionBatcher::~AppendAdmissionBatcher() = default;
+
+void AppendAdmissionBatcher::add(std::shared_ptr<AppenderPrep> prep,
+                                 std::shared_ptr<Sequencer> sequencer,
+                                 std::unique_ptr<Appender> appender) {
+  ld_check(prep);
+  ld_check(sequencer);
+  ld_check(appender);
+  const logid_t log_id = appender->getLogID();
+
+  std::vector<Entry>& batch = batches_[log_id];
+  batch.push_back(
+      Entry{std::move(prep), std::move(sequencer), std::move(appender)});
+  ++num_pending_;
+
+  if (batch.size() >= Worker::settings().sequencer_admission_batch_size) {
+    std::vector<Entry> full = std::move(batch);
+    batches_.erase(log_id);
+    num_pending_ -= full.size();
+    start(std::move(full));
+    return;
+  }
+
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (!timer_.isActive()) {
+    timer_.activate(std::chrono::microseconds::zero());
+  }
+}
+
+void AppendAdmissionBatcher::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  num_pending_ = 0;
+  for (auto& kv : batches) {
+    start(std::move(kv.second));
+  }
+}
+
+void AppendAdmissionBatcher::start(std::vector<Entry> batch) {
+  ld_check(!batch.empty());
+
+  std::vector<RunAppenderStatus> statuses;
+  if (batch.size() > 1) {
+    // The sequencer may have been replaced while the batch was collected.
+    bool same_sequencer = true;
+    std::vector<Appender*> appenders;
+    appenders.reserve(batch.size());
+    for (const Entry& entry : batch) {
+      same_sequencer &= entry.sequencer == batch.front().sequencer;
+      appenders.push_back(entry.appender.get());
+    }
+    if (same_sequencer) {
+      statuses = batch.front().sequencer->runAppenders(
+          folly::Range<Appender* const*>(appenders.data(), appenders.size()));
+    }
+  }
+
+  if (statuses.empty()) {
+    for (Entry& entry : batch) {
+      entry.prep->startAppender(
+          std::move(entry.sequencer), std::move(entry.appender));
+    }
+    return;
+  }
+
+  ld_check(statuses.size() == batch.size());
+  STAT_INCR(Worker::stats(), append_admission_batches);
+  STAT_ADD(Worker::stats(), append_admission_batched_appends, batch.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (statuses[i] == RunAppenderStatus::ERROR_DELETE) {
+      // see EpochSequencer::runAppenders()
+      err = E::SYSLIMIT;
+    }
+    Entry& entry = batch[i];
+    entry.prep->onAppenderStarted(
+        statuses[i], entry.sequencer, std::move(entry.appender));
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/Timer.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+class Appender;
+class AppenderPrep;
+class Sequencer;
+
+/**
+ * @file Per-Worker batching of the admission of Appenders into sequencers.
+ *       When --sequencer-admission-batch-size is greater than 1, appends to
+ *       the same log that reach the end of AppenderPrep on a Worker during
+ *       one event loop iteration are held back and started together with
+ *       Sequencer::runAppenders(), which gives them a range of consecutive
+ *       LSNs with a single update of the epoch's sliding window. Workers
+ *       appending to a hot log then contend on the window once per batch
+ *       rather than once per append. The Appenders run independently after
+ *       that, and records are still released in LSN order as the window
+ *       reaps them.
+ *
+ *       Appends that can't be admitted as a batch (the sequencer is not
+ *       active, there is no room in the window for all of them, an append
+ *       was redirected, etc.) are started one by one through
+ *       AppenderPrep::startAppender(), with the usual error handling.
+ */
+
+class AppendAdmissionBatcher {
+ public:
+  AppendAdmissionBatcher();
+  ~AppendAdmissionBatcher();
+
+  AppendAdmissionBatcher(const AppendAdmissionBatcher&) = delete;
+  AppendAdmissionBatcher& operator=(const AppendAdmissionBatcher&) = delete;
+
+  /**
+   * Takes an Appender that AppenderPrep @param prep is about to start on
+   * @param sequencer. The outcome is reported through
+   * AppenderPrep::onAppenderStarted(), on the next iteration of the event
+   * loop or right away if the log's batch is full.
+   */
+  void add(std::shared_ptr<AppenderPrep> prep,
+           std::shared_ptr<Sequencer> sequencer,
+           std::unique_ptr<Appender> appender);
+
+  // Number of Appenders waiting to be started.
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<AppenderPrep> prep;
+    std::shared_ptr<Sequencer> sequencer;
+    std::unique_ptr<Appender> appender;
+  };
+
+  // Starts all pending Appenders.
+  void flush();
+
+  void start(std::vector<Entry> batch);
+
+  std::unordered_map<logid_t, std::vector<Entry>, logid_t::Hash> batches_;
+  size_t num_pending_ = 0;
+
+  // Fires on the next event loop iteration after an Appender is added.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -641,6 +641,11 @@ void AppendRequest::onReplyReceived(const APPENDED_Header& reply,
         // the throttle so that we attempt to establish connection.
         resetServerSocketConnectThrottle(reply.redirect);
         redirect = reply.redirect;
+        if (status_ == E::REDIRECTED &&
+            (reply.flags & APPENDED_Header::REDIRECT_HANDOFF)) {
+          router_->onHandedOff(from.id_.node_, redirect);
+          return;
+        }
       }
       router_->onRedirected(from.id_.node_, redirect, status_);
       return;
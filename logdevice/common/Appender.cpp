@@ -27,9 +27,12 @@
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/PeriodicReleases.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/ReleaseBatcher.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Sequencer.h"
+#include "logdevice/common/ShardLatencyTracker.h"
 #include "logdevice/common/Socket.h"
+#include "logdevice/common/StoreBatcher.h"
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/TraceLogger.h"
 #include "logdevice/common/Worker.h"
@@ -200,6 +203,13 @@ int Appender::sendSTORE(const StoreChainLink copyset[],
   Recipient* r = recipients_.find(dest);
   ld_check(r);
 
+  if (!store_span && getSettings().store_batching_window.count() > 0 &&
+      Worker::onThisThread()->storeBatcher().add(store_msg, dest.asNodeID())) {
+    // Will be sent shortly, together with other STOREs to the same node. The
+    // outcome is reported to onCopySent() as usual.
+    return 1;
+  }
+
   std::unique_ptr<opentracing::Span> store_message_send_span;
 
   if (store_span) {
@@ -653,7 +663,9 @@ int Appender::sendWave() {
   ld_check(recipients_.getReplication() <= COPYSET_SIZE_MAX);
 
   cancelStoreTimer();
+  hedged_wave_ = false;
 
+  last_wave_time_ = std::chrono::steady_clock::now();
   int rv = trySendingWavesOfStores(cfg_synced, cfg_extras, append_ctx);
 
   if (replies_expected_ < recipients_.getReplication()) {
@@ -702,6 +714,7 @@ int Appender::start(std::shared_ptr<EpochSequencer> epoch_sequencer,
   // hold a shared reference of the epoch sequencer object
   epoch_sequencer_ = std::move(epoch_sequencer);
   ld_check(lsn != LSN_INVALID);
+  start_time_ = std::chrono::steady_clock::now();
 
   initStoreTimer();
   initRetryTimer();
@@ -944,7 +957,10 @@ void Appender::Disposer::operator()(Appender* a) {
   a->abort(/*linked=*/false);
 }
 
-void Appender::sendReply(lsn_t lsn, Status status, NodeID redirect) {
+void Appender::sendReply(lsn_t lsn,
+                         Status status,
+                         NodeID redirect,
+                         APPENDED_flags_t flags) {
   CHECK_WORKER_THREAD();
 
   if (lsn == LSN_INVALID) {
@@ -961,7 +977,8 @@ void Appender::sendReply(lsn_t lsn, Status status, NodeID redirect) {
       lsn,
       RecordTimestamp::from(std::chrono::milliseconds(store_hdr_.timestamp)),
       redirect,
-      status};
+      status,
+      flags};
   if (status == E::PREEMPTED || status == E::REDIRECTED) {
     ld_check(redirect.isNodeID());
     // In the preemption case, if we know for sure that no copy of the record
@@ -1195,6 +1212,8 @@ void Appender::sendError(Status reason) {
       reply_to_,
       Sender::sockaddrOrInvalid(Address(reply_to_)),
       usec_since(creation_time_),
+      started() ? to_usec(start_time_ - creation_time_).count() : -1,
+      started() ? usec_since(last_wave_time_) : -1,
       recipients_,
       log_id_,
       started() ? store_hdr_.rid.lsn() : LSN_INVALID,
@@ -1206,7 +1225,10 @@ void Appender::sendError(Status reason) {
   sendReply(LSN_INVALID, client_code);
 }
 
-void Appender::sendRedirect(NodeID to, Status status, lsn_t lsn) {
+void Appender::sendRedirect(NodeID to,
+                            Status status,
+                            lsn_t lsn,
+                            APPENDED_flags_t flags) {
   switch (status) {
     case E::PREEMPTED:
       STAT_ADD(getStats(), append_preempted, append_message_count_);
@@ -1217,14 +1239,30 @@ void Appender::sendRedirect(NodeID to, Status status, lsn_t lsn) {
     default:
       ld_check(false && "Invalid status in sendRedirect()");
   }
-  sendReply(lsn, status, to);
+  sendReply(lsn, status, to, flags);
 }
 
 void Appender::onTimeout() {
   ld_check(started());
   ld_check(!recipients_.isFullyReplicated());
 
-  if (store_timeout_set_) {
+  if (store_timeout_set_ && hedged_wave_) {
+    RATELIMIT_DEBUG(std::chrono::seconds(1),
+                    2,
+                    "Appender %s is sending a new wave instead of waiting "
+                    "for the last copy of wave %u, recipient set: %s",
+                    store_hdr_.rid.toString().c_str(),
+                    store_hdr_.wave,
+                    recipients_.dumpRecipientSet().c_str());
+    STAT_INCR(getStats(), appender_wave_hedged);
+
+    if (wave_send_span_) {
+      wave_send_span_->SetTag("status", "hedged");
+      wave_send_span_->Finish();
+
+      prev_wave_send_span_ = std::move(wave_send_span_);
+    }
+  } else if (store_timeout_set_) {
     if (store_hdr_.wave >= LOG_IF_WAVE_ABOVE) {
       // Separate rate limit for appenders that failed lots of waves.
       // These error messages are expected to be rare and important, don't want
@@ -1265,7 +1303,7 @@ void Appender::onTimeout() {
 
   auto worker = Worker::onThisThread(false);
   if (worker &&
-      worker->updateable_settings_->enable_store_histogram_calculations) {
+      worker->immutable_settings_->enable_store_histogram_calculations) {
     if (store_hdr_.flags & STORE_Header::CHAIN) {
       worker->getWorkerTimeoutStats().onReply(
           recipients_.getFirstOutstandingRecipient(), store_hdr_);
@@ -1276,6 +1314,14 @@ void Appender::onTimeout() {
           });
     }
   }
+  if (worker && worker->immutable_settings_->adaptive_copyset_selection) {
+    // Count the time spent waiting as latency of all shards we didn't hear
+    // from, so that a shard that stops responding looks slow.
+    recipients_.forEachOutstandingRecipient(
+        [this, &worker](const ShardID& shard) {
+          worker->shardLatencyTracker().onReply(shard, store_hdr_);
+        });
+  }
 
   // Only mark the first node in the list of outstanding
   // nodes as graylisted, because if we are doing chain-sending
@@ -1356,9 +1402,12 @@ void Appender::onChainForwardingFailure(unsigned int index) {
 void Appender::onCopySent(Status st, ShardID to, const STORE_Header& mhdr) {
   auto worker = Worker::onThisThread(false);
   if (worker &&
-      worker->updateable_settings_->enable_store_histogram_calculations) {
+      worker->immutable_settings_->enable_store_histogram_calculations) {
     worker->getWorkerTimeoutStats().onCopySent(st, to, mhdr);
   }
+  if (worker && worker->immutable_settings_->adaptive_copyset_selection) {
+    worker->shardLatencyTracker().onCopySent(st, to, mhdr);
+  }
 
   if (mhdr.wave != store_hdr_.wave) {
     ld_check(mhdr.wave < store_hdr_.wave || mhdr.wave > INT_MAX ||
@@ -1468,9 +1517,12 @@ int Appender::onReply(const STORED_Header& header,
                       ShardID rebuildingRecipient) {
   auto worker = Worker::onThisThread(false);
   if (worker &&
-      worker->updateable_settings_->enable_store_histogram_calculations) {
+      worker->immutable_settings_->enable_store_histogram_calculations) {
     worker->getWorkerTimeoutStats().onReply(from, store_hdr_);
   }
+  if (worker && worker->immutable_settings_->adaptive_copyset_selection) {
+    worker->shardLatencyTracker().onReply(from, store_hdr_);
+  }
 
   if (appender_span_) {
     // having an appender span means we have e2e tracing enabled
@@ -1909,7 +1961,9 @@ void Appender::onRecipientSucceeded(Recipient* recipient) {
       // fail the append with the PREEMPTED redirect
       retire(RetireReason::PREEMPTED);
       onComplete();
+      return;
     }
+    maybeHedgeWave();
     return;
   }
 
@@ -1923,6 +1977,7 @@ void Appender::onRecipientSucceeded(Recipient* recipient) {
   ld_check(!reply_sent_);
   // record the latency of this append
   HISTOGRAM_ADD(getStats(), append_latency, usec_since(creation_time_));
+  recordStageLatencies();
   int64_t latency_usec = usec_since(creation_time_);
   const Sockaddr& client_sock_addr =
       Sender::sockaddrOrInvalid(Address(reply_to_));
@@ -1933,6 +1988,8 @@ void Appender::onRecipientSucceeded(Recipient* recipient) {
       reply_to_,
       client_sock_addr,
       latency_usec,
+      to_usec(start_time_ - creation_time_).count(),
+      usec_since(last_wave_time_),
       recipients_,
       log_id_,
       started() ? store_hdr_.rid.lsn() : LSN_INVALID,
@@ -1973,6 +2030,40 @@ void Appender::onRecipientSucceeded(Recipient* recipient) {
   onComplete();
 }
 
+void Appender::maybeHedgeWave() {
+  if (!getSettings().store_hedging || hedged_wave_ || !store_timeout_set_ ||
+      !storeTimerIsActive() || (store_hdr_.flags & STORE_Header::CHAIN) ||
+      recipients_.storeCount() + 1 != recipients_.getReplication()) {
+    // With chain sending the missing copies may not have been forwarded yet,
+    // so a late reply doesn't say anything about the shard that owes it.
+    return;
+  }
+
+  auto threshold = selectStoreHedgeThreshold();
+  if (!threshold.hasValue() || !timeout_.hasValue() ||
+      threshold.value() >= timeout_.value()) {
+    return;
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - last_wave_time_);
+  hedged_wave_ = true;
+  cancelStoreTimer();
+  activateStoreTimer(std::max(threshold.value() - elapsed,
+                              std::chrono::milliseconds::zero()));
+}
+
+void Appender::recordStageLatencies() {
+  ld_check(started());
+  HISTOGRAM_ADD(getStats(),
+                append_start_latency,
+                to_usec(start_time_ - creation_time_).count());
+  HISTOGRAM_ADD(getStats(),
+                append_retry_latency,
+                to_usec(last_wave_time_ - start_time_).count());
+  HISTOGRAM_ADD(getStats(), append_wave_latency, usec_since(last_wave_time_));
+}
+
 bool Appender::onRecipientFailed(Recipient* recipient,
                                  Recipient::State reason) {
   ld_check(!recipient->outcomeKnown());
@@ -2063,9 +2154,16 @@ void Appender::sendReleases(const ShardID* dests,
 
   for (size_t dest_num = 0; dest_num < ndests; ++dest_num) {
     const ShardID& dest = dests[dest_num];
+    const RELEASE_Header header({store_hdr_.rid, release_type, dest.shard()});
 
-    auto release_msg = std::make_unique<RELEASE_Message>(
-        RELEASE_Header({store_hdr_.rid, release_type, dest.shard()}));
+    if (getSettings().release_batching_window.count() > 0 &&
+        Worker::onThisThread()->releaseBatcher().add(
+            header, dest.asNodeID())) {
+      // Will be sent shortly, together with other RELEASEs to the same node.
+      continue;
+    }
+
+    auto release_msg = std::make_unique<RELEASE_Message>(header);
 
     int rv = sender_->sendMessage(std::move(release_msg), dest.asNodeID());
     if (rv != 0) {
@@ -2240,8 +2338,10 @@ bool Appender::storeTimerIsActive() {
   return store_timer_.isActive();
 }
 void Appender::activateStoreTimer(std::chrono::milliseconds delay) {
-  HISTOGRAM_ADD(
-      Worker::stats(), store_timeouts, to_usec(timeout_.value()).count());
+  if (!hedged_wave_) {
+    HISTOGRAM_ADD(
+        Worker::stats(), store_timeouts, to_usec(timeout_.value()).count());
+  }
   store_timer_.activate(delay);
 }
 
@@ -2529,6 +2629,34 @@ Appender::selectStoreTimeout(const StoreChainLink copyset[], int size) const {
   return selected;
 }
 
+folly::Optional<std::chrono::milliseconds>
+Appender::selectStoreHedgeThreshold() {
+  auto worker = Worker::onThisThread(false);
+  if (!worker) {
+    return folly::none;
+  }
+
+  const auto& settings = Worker::settings();
+  if (!settings.enable_store_histogram_calculations) {
+    return folly::none;
+  }
+
+  // Compare against the median of all shards this worker stores on rather
+  // than that of the late shard: a shard that is persistently slow should be
+  // hedged against too.
+  auto estimations = worker->getWorkerTimeoutStats().getEstimations(
+      WorkerTimeoutStats::Levels::TEN_SECONDS);
+  if (!estimations.hasValue()) {
+    return folly::none;
+  }
+
+  const double median =
+      (*estimations)[WorkerTimeoutStats::QuantileIndexes::P50];
+  auto threshold = std::chrono::milliseconds(static_cast<int64_t>(
+      settings.store_hedging_latency_multiplier * median + 0.5));
+  return std::max(threshold, settings.store_hedging_min_delay);
+}
+
 bool Appender::isNodeAlive(NodeID node) {
   auto cs = Worker::getClusterState();
   return (cs == nullptr || cs->isNodeAlive(node.index()));
@@ -29,6 +29,7 @@
 #include "logdevice/common/Request.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/Timestamp.h"
+#include "logdevice/common/protocol/APPENDED_Message.h"
 #include "logdevice/common/protocol/STORED_Message.h"
 #include "logdevice/common/stats/Stats.h"
 
@@ -85,7 +86,6 @@ class TraceLogger;
 class Worker;
 enum class ReleaseType : uint8_t;
 struct Address;
-struct APPENDED_Header;
 struct Settings;
 
 /**
@@ -339,8 +339,12 @@ class Appender : public IntrusiveUnorderedMapHook {
    * @param lsn     (optional) include this LSN in the reply; useful if one was
    *                already assigned to the appender before preemption was
    *                detected
+   * @param flags   (optional) additional APPENDED_Header flags to set
    */
-  void sendRedirect(NodeID to, Status status, lsn_t lsn = LSN_INVALID);
+  void sendRedirect(NodeID to,
+                    Status status,
+                    lsn_t lsn = LSN_INVALID,
+                    APPENDED_flags_t flags = 0);
 
   /**
    * Called when we failed to forward the STORE message to node at position
@@ -400,6 +404,11 @@ class Appender : public IntrusiveUnorderedMapHook {
     return payload_.get();
   }
 
+  // Size in bytes of this Appender and its payload.
+  size_t getFullAppenderSize() const {
+    return full_appender_size_;
+  }
+
   const AppendAttributes& getAppendAttributes() {
     return attrs_;
   }
@@ -512,8 +521,12 @@ class Appender : public IntrusiveUnorderedMapHook {
    * @param st   E::OK if request succeeded, otherwise the error code to send
    * @param redirect  if st = E::PREEMPTED, node id of the sequencer to which
    *                  to resend this append
+   * @param flags     additional APPENDED_Header flags to set in the reply
    */
-  void sendReply(lsn_t lsn, Status st, NodeID redirect = NodeID());
+  void sendReply(lsn_t lsn,
+                 Status st,
+                 NodeID redirect = NodeID(),
+                 APPENDED_flags_t flags = 0);
 
   /**
    * Select store timeout based on node response time statistics.
@@ -667,6 +680,12 @@ class Appender : public IntrusiveUnorderedMapHook {
   virtual bool retryTimerIsActive();
   virtual bool isNodeAlive(NodeID node);
 
+  // How long after the start of a wave --store-hedging gives up on the wave's
+  // last outstanding copy, or folly::none if there isn't enough latency data
+  // to tell.
+  virtual folly::Optional<std::chrono::milliseconds>
+  selectStoreHedgeThreshold();
+
  private:
   using ReleaseTypeRaw = std::underlying_type<ReleaseType>::type;
 
@@ -774,6 +793,12 @@ class Appender : public IntrusiveUnorderedMapHook {
   // time when the appender was created, used to calculate the latency
   std::chrono::steady_clock::time_point creation_time_;
 
+  // Times of start() (the appender got an LSN after waiting in
+  // AppenderBuffer or the sequencer window) and of the last sendWave(). Used
+  // to break append latency down into stages, see recordStageLatencies().
+  std::chrono::steady_clock::time_point start_time_;
+  std::chrono::steady_clock::time_point last_wave_time_;
+
   // deadline after which the client is presumed to have timed out. If the
   // epoch to which this Appender belongs (store_hdr_.epoch) is shut down
   // after this deadline, the appender may abort the request without sending
@@ -808,6 +833,10 @@ class Appender : public IntrusiveUnorderedMapHook {
   // with non-zero STORE timeout, used for diagnosing append failures
   bool store_timeout_set_{false};
 
+  // Set when --store-hedging moved the store timer earlier for the current
+  // wave. onTimeout() then counts the new wave as hedged, not timed out.
+  bool hedged_wave_{false};
+
   // Set to NONE or PER_EPOCH if at some point it is decided that this Appender
   // should not send a global RELEASE message. This can happen if the Appender
   // is aborted because we called retire() before the record was fully
@@ -899,6 +928,15 @@ class Appender : public IntrusiveUnorderedMapHook {
    */
   void onRecipientSucceeded(Recipient* recipient);
 
+  /**
+   * Called when a recipient of the current wave stored its copy but the record
+   * is not fully replicated yet. If --store-hedging is on and only one copy is
+   * missing, moves the store timer up to the hedging threshold so that a slow
+   * shard costs a quick new wave instead of a full store timeout. The new
+   * wave graylists the late shard and amends the copies already stored.
+   */
+  void maybeHedgeWave();
+
   /**
    * Called when we know that we failed to store on a recipient because either:
    * - The recipient replied with a STORED message having status different
@@ -926,6 +964,14 @@ class Appender : public IntrusiveUnorderedMapHook {
    */
   void onMemoryCorruption();
 
+  /**
+   * Called once the record is fully replicated. Adds the time spent before
+   * start(), between start() and the last wave, and in the last wave (STOREs
+   * in flight, storage node queueing and writes, STOREDs in flight) to the
+   * corresponding histograms.
+   */
+  void recordStageLatencies();
+
   /**
    * Send DELETE messages to all nodes in recipients_ for which we do
    * not have a positive acknowledgement of the record being stored.
@@ -21,7 +21,6 @@ namespace facebook { namespace logdevice {
 AppenderBufferQueue::AppenderBufferQueue(logid_t logid,
                                          AppenderBuffer* appender_buffer)
     : logid_(logid),
-      process_timer_([this] { this->onTimerFired(); }),
       resume_callback_(AppenderBuffer::EMPTY_APPENDER_CB),
       appender_buffer_(appender_buffer) {
   ld_check(appender_buffer != nullptr);
@@ -38,6 +37,7 @@ void AppenderBufferQueue::process(AppenderBuffer::AppenderCallback cb) {
 
   while (!queue_.empty() && num_processed < num_allowed) {
     AppenderUniqPtr& appender = queue_.front();
+    const size_t size = appender->getFullAppenderSize();
     auto action = cb(logid_, appender);
     switch (action) {
       case AppenderBuffer::Action::DESTROY:
@@ -50,13 +50,14 @@ void AppenderBufferQueue::process(AppenderBuffer::AppenderCallback cb) {
         break;
     };
 
-    queue_.pop();
+    pop(size);
     ++num_processed;
   }
 
   // re-enqueue appenders with Action::REQUEUE
   while (!re_queue.empty()) {
-    queue_.push(std::move(re_queue.front()));
+    const size_t size = re_queue.front()->getFullAppenderSize();
+    push(std::move(re_queue.front()), size);
     re_queue.pop();
     WORKER_STAT_INCR(appenderbuffer_appender_requeued);
   }
@@ -69,20 +70,33 @@ void AppenderBufferQueue::process(AppenderBuffer::AppenderCallback cb) {
              num_processed);
 
     resume_callback_ = AppenderBuffer::EMPTY_APPENDER_CB;
-    process_timer_.cancel();
 
     // remove the AppenderBufferQueue from the map in AppenderBuffer
     appender_buffer_->deleteQueue(logid_);
   } else if (num_processed >= num_allowed) {
     // We reached the limit of how many Appender objects we are allowed to
     // process before returning control to libevent. Schedule the rest of
-    // processing in the next iteration of event loop and return control to
-    // libevent so that its evbuffer can be processed
+    // processing after the next batch of the other queues being processed
+    // and return control to libevent so that its evbuffer can be processed
     resume_callback_ = cb;
-    process_timer_.activate(std::chrono::milliseconds::zero());
+    appender_buffer_->scheduleResume(this);
   }
 }
 
+void AppenderBufferQueue::push(AppenderUniqPtr appender, size_t size) {
+  queue_.push(std::move(appender));
+  bytes_ += size;
+  appender_buffer_->total_bytes_ += size;
+}
+
+void AppenderBufferQueue::pop(size_t size) {
+  queue_.pop();
+  ld_check(bytes_ >= size);
+  ld_check(appender_buffer_->total_bytes_ >= size);
+  bytes_ -= size;
+  appender_buffer_->total_bytes_ -= size;
+}
+
 void AppenderBuffer::bufferedAppenderSendError(logid_t logid, Status st) {
   auto it = map_.find(logid);
   if (it == map_.end()) {
@@ -95,9 +109,10 @@ void AppenderBuffer::bufferedAppenderSendError(logid_t logid, Status st) {
 void AppenderBufferQueue::drainQueueAndSendError(Status st) {
   while (!queue_.empty()) {
     AppenderUniqPtr& appender = queue_.front();
+    const size_t size = appender->getFullAppenderSize();
     appender->sendError(st);
     WORKER_STAT_INCR(appenderbuffer_appender_failed_sequencer_activation);
-    queue_.pop();
+    pop(size);
   }
 
   ld_debug("AppenderBufferQueue cleared for log %lu, Worker %d, ",
@@ -105,21 +120,51 @@ void AppenderBufferQueue::drainQueueAndSendError(Status st) {
            (int)(Worker::onThisThread()->idx_));
 
   resume_callback_ = AppenderBuffer::EMPTY_APPENDER_CB;
-  process_timer_.cancel();
 
   // remove the AppenderBufferQueue from the map in AppenderBuffer
   appender_buffer_->deleteQueue(logid_);
 }
 
-void AppenderBufferQueue::onTimerFired() {
+void AppenderBufferQueue::resume() {
+  resume_scheduled_ = false;
   process(resume_callback_);
 }
 
 const AppenderBuffer::AppenderCallback AppenderBuffer::EMPTY_APPENDER_CB =
     [](logid_t, AppenderUniqPtr&) { return Action::DESTROY; };
 
-AppenderBuffer::AppenderBuffer(size_t queue_cap)
-    : appender_buffer_queue_cap_(queue_cap) {}
+AppenderBuffer::AppenderBuffer(size_t queue_cap, bool byte_budget)
+    : appender_buffer_queue_cap_(queue_cap),
+      byte_budget_(byte_budget),
+      resume_timer_([this] { onResumeTimerFired(); }) {}
+
+void AppenderBuffer::scheduleResume(AppenderBufferQueue* queue) {
+  if (queue->resume_scheduled_) {
+    return;
+  }
+  queue->resume_scheduled_ = true;
+  resume_queue_.push_back(queue->logid_);
+  if (!resume_timer_.isActive()) {
+    resume_timer_.activate(std::chrono::milliseconds::zero());
+  }
+}
+
+void AppenderBuffer::onResumeTimerFired() {
+  // Give one batch to each of the queues that were waiting when the timer
+  // fired. Queues that still have appenders after their batch go back at the
+  // end of resume_queue_ and get their next turn in the next iteration of the
+  // event loop.
+  for (size_t n = resume_queue_.size(); n > 0; --n) {
+    const logid_t logid = resume_queue_.front();
+    resume_queue_.pop_front();
+    auto it = map_.find(logid);
+    if (it == map_.end() || !it->second->resume_scheduled_) {
+      // the queue was drained in the meantime
+      continue;
+    }
+    it->second->resume();
+  }
+}
 
 bool AppenderBuffer::hasBufferedAppenders(logid_t logid) const {
   auto it = map_.find(logid);
@@ -161,6 +206,34 @@ bool AppenderBuffer::bufferAppender(logid_t logid,
   }
 
   auto it = map_.find(logid);
+  const size_t size = appender->getFullAppenderSize();
+  const Settings& settings = Worker::settings();
+  const size_t max_bytes = byte_budget_
+      ? settings.appender_buffer_max_bytes / settings.num_workers
+      : 0;
+  if (max_bytes > 0) {
+    // This log may only add to its queue while the queue is smaller than
+    // what is left of the budget. This is what bounds a hot log to a fair
+    // share of the budget and keeps room for other logs.
+    const size_t log_bytes = it == map_.end() ? 0 : it->second->bytes();
+    if (total_bytes_ + size > max_bytes ||
+        log_bytes + size > max_bytes - total_bytes_) {
+      RATELIMIT_WARNING(std::chrono::seconds(10),
+                        2,
+                        "Dropping Appender because log %lu has %zu bytes of "
+                        "pending Appenders, with %zu bytes pending for all "
+                        "logs out of a budget of %zu bytes on %s.",
+                        logid.val_,
+                        log_bytes,
+                        total_bytes_,
+                        max_bytes,
+                        Worker::onThisThread()->getName().c_str());
+      err = E::TEMPLIMIT;
+      WORKER_STAT_INCR(appenderbuffer_appender_failed_budget);
+      return false;
+    }
+  }
+
   if (it == map_.end()) {
     // create a new AppenderBufferQueue
     auto res = map_.insert(std::make_pair(
@@ -184,7 +257,7 @@ bool AppenderBuffer::bufferAppender(logid_t logid,
     return false;
   }
 
-  appender_queue->queue_.push(std::move(appender));
+  appender_queue->push(std::move(appender), size);
   WORKER_STAT_INCR(appenderbuffer_appender_buffered);
   WORKER_STAT_INCR(appenderbuffer_pending_appenders);
   return true;
@@ -196,6 +269,8 @@ void AppenderBuffer::deleteQueue(logid_t logid) {
     ld_check(it->second != nullptr);
     // All Appender objects in the queue are getting destroyed
     WORKER_STAT_SUB(appenderbuffer_pending_appenders, it->second->size());
+    ld_check(total_bytes_ >= it->second->bytes());
+    total_bytes_ -= it->second->bytes();
     map_.erase(it);
   }
 }
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -26,6 +27,13 @@ namespace facebook { namespace logdevice {
  *       queues whose capacitity can be set by the administrator. Once the
  *       Sequencer finishes its reactivation, buffered Appender objects will be
  *       processed depending on the reactivation status.
+ *
+ *       The total size of buffered appenders can also be bounded by a byte
+ *       budget shared by all logs of the Worker. A log may only add to its
+ *       queue while the queue holds less than what is left of the budget, so
+ *       that with n logs buffering each one gets at most 1/(n+1) of the budget
+ *       and a single hot log cannot starve the others. Large queues are
+ *       processed a batch at a time, taking turns between logs.
  */
 
 class AppenderBufferQueue;
@@ -52,9 +60,11 @@ class AppenderBuffer {
   using AppenderCallback = std::function<Action(logid_t, AppenderUniqPtr&)>;
 
   /**
-   * Create an AppenderBuffer with the given queue capacity
+   * Create an AppenderBuffer with the given queue capacity. If byte_budget is
+   * true, the total size of buffered appenders is also limited by
+   * Settings::appender_buffer_max_bytes divided by the number of Workers.
    */
-  explicit AppenderBuffer(size_t queue_cap);
+  explicit AppenderBuffer(size_t queue_cap, bool byte_budget = false);
 
   AppenderBuffer(AppenderBuffer&&) = delete;
   AppenderBuffer(const AppenderBuffer&) = delete;
@@ -77,7 +87,9 @@ class AppenderBuffer {
    *         false if the queue is full, and does not claim the ownership.
    *         Sets err to:
    *           E::NOBUFS:    too many appenders queued for this log,
-   *           E::TEMPLIMIT: total size of allocated appenders is above limit.
+   *           E::TEMPLIMIT: total size of allocated appenders is above limit,
+   *                         or this log used up its share of the byte budget
+   *                         of the buffer.
    */
   bool bufferAppender(logid_t logid, AppenderUniqPtr& appender);
 
@@ -128,6 +140,29 @@ class AppenderBuffer {
   // capacity of the AppenderBuffer queue
   size_t appender_buffer_queue_cap_;
 
+  // whether Settings::appender_buffer_max_bytes applies to this buffer
+  const bool byte_budget_;
+
+  // total size of the Appender objects in all queues
+  size_t total_bytes_{0};
+
+  // Logs whose queue was left with appenders to process after a batch, in the
+  // order they get to process their next batch.
+  std::deque<logid_t> resume_queue_;
+
+  // Used when queues of pending Appender objects are sufficiently large: we
+  // need to periodically return to libevent loop to prevent it from running
+  // out of output buffers.
+  Timer resume_timer_;
+
+  // Schedule the next batch of @param queue after the ones already scheduled.
+  void scheduleResume(AppenderBufferQueue* queue);
+
+  // Process one batch of each queue in resume_queue_.
+  void onResumeTimerFired();
+
+  friend class AppenderBufferQueue;
+
   // an AppenderBufferQueue for each logid, stored in a hash map
   std::unordered_map<logid_t,
                      std::unique_ptr<AppenderBufferQueue>,
@@ -147,7 +182,8 @@ class AppenderBufferQueue {
    * calling cb on each item. This function processes Appenders in batch
    * (the batch size is specified in Settings::appender_buffer_process_batch).
    * It periodically returns control to libevent loop after each batch to allow
-   * evbuffer to be processed.
+   * evbuffer to be processed, and lets other queues being processed run their
+   * next batch before this one.
    *
    * @param  cb   Callback function that applies on each Appender object
    **/
@@ -164,6 +200,11 @@ class AppenderBufferQueue {
     return queue_.size();
   }
 
+  /* return total size of the Appender objects in the queue */
+  size_t bytes() const {
+    return bytes_;
+  }
+
  private:
   // logid for the queue
   logid_t logid_;
@@ -171,20 +212,29 @@ class AppenderBufferQueue {
   // a std::queue to store the actual Appender objects
   std::queue<AppenderUniqPtr> queue_;
 
-  // This timer is used when the queue of pending Appender objects is
-  // sufficiently large, we need to periodically return to libevent loop
-  // to prevent it from running out of output buffers
-  Timer process_timer_;
+  // total size of the Appender objects in queue_
+  size_t bytes_{0};
+
+  // true if this queue is in AppenderBuffer::resume_queue_
+  bool resume_scheduled_{false};
 
   // Current callback to process the queue, used to resume processing
-  // upon timer fired
+  // when the AppenderBuffer gets back to this queue
   AppenderBuffer::AppenderCallback resume_callback_;
 
   // parent pointer to AppenderBuffer object
   AppenderBuffer* appender_buffer_;
 
-  // Callback when process_timer_ fires.
-  void onTimerFired();
+  // Add an appender to the back of the queue.
+  void push(AppenderUniqPtr appender, size_t size);
+
+  // Remove the appender at the front of the queue, whose size is @param size.
+  // The appender may have been moved or released already.
+  void pop(size_t size);
+
+  // Called by AppenderBuffer when it is this queue's turn to process its next
+  // batch.
+  void resume();
 
   friend class AppenderBuffer;
 };
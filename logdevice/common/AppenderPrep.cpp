@@ -9,6 +9,7 @@
 
 #include <opentracing/tracer.h>
 
+#include "logdevice/common/AppendAdmissionBatcher.h"
 #include "logdevice/common/Appender.h"
 #include "logdevice/common/AppenderBuffer.h"
 #include "logdevice/common/Checksum.h"
@@ -217,6 +218,17 @@ void AppenderPrep::onSequencerNodeFound(Status st,
     return;
   }
 
+  NodeID handoff_target = getHandoffTarget(sequencer.get());
+  if (handoff_target.isNodeID()) {
+    // the log was handed off to `handoff_target' to shed load from this node
+    STAT_INCR(stats(), append_redirected_handoff);
+    sendRedirect(appender.get(),
+                 handoff_target,
+                 E::REDIRECTED,
+                 APPENDED_Header::REDIRECT_HANDOFF);
+    return;
+  }
+
   Decision redirect_decision = shouldRedirect(seq_node, sequencer.get());
   if (redirect_decision == Decision::REDIRECT) {
     // `seq_node' should handle writes for this log instead
@@ -389,9 +401,30 @@ void AppenderPrep::onSequencerNodeFound(Status st,
         processor->sequencerBatching().buffer(header_.logid, appender)) {
       return;
     }
+
+    // See if this append can be given an LSN together with other appends to
+    // the same log that this Worker receives in the same event loop
+    // iteration.
+    if (getSettings().sequencer_admission_batch_size > 1 &&
+        !MetaDataLog::isMetaDataLog(header_.logid)) {
+      w->appendAdmissionBatcher().add(
+          shared_from_this(), std::move(sequencer), std::move(appender));
+      return;
+    }
   }
 
+  startAppender(std::move(sequencer), std::move(appender));
+}
+
+void AppenderPrep::startAppender(std::shared_ptr<Sequencer> sequencer,
+                                 std::unique_ptr<Appender> appender) {
   RunAppenderStatus status = append(sequencer, appender);
+  onAppenderStarted(status, sequencer, std::move(appender));
+}
+
+void AppenderPrep::onAppenderStarted(RunAppenderStatus status,
+                                     std::shared_ptr<Sequencer>& sequencer,
+                                     std::unique_ptr<Appender> appender) {
   switch (status) {
     case RunAppenderStatus::ERROR_DELETE:
       // Appender could not be started. Report back to AppendRequest.
@@ -525,6 +558,21 @@ NodeID AppenderPrep::getMyNodeID() const {
   return Worker::onThisThread()->processor_->getMyNodeID();
 }
 
+NodeID AppenderPrep::getHandoffTarget(const Sequencer* sequencer) const {
+  if (!sequencer || !canActivateSequencers() ||
+      (header_.flags & APPEND_Header::FORCE)) {
+    // clients set NO_REDIRECT or REACTIVATE_IF_PREEMPTED when they can't
+    // follow redirects; let them take the log back
+    return NodeID();
+  }
+  NodeID target = sequencer->getHandoffTarget();
+  if (!target.isNodeID() || target.index() == getMyNodeID().index() ||
+      !isAlive(target) || isBoycotted(target)) {
+    return NodeID();
+  }
+  return target;
+}
+
 AppenderPrep::Decision AppenderPrep::shouldRedirect(NodeID seq_node,
                                                     const Sequencer* sequencer,
                                                     bool preempted) const {
@@ -675,9 +723,15 @@ int AppenderPrep::bufferAppender(logid_t log_id,
     return 0;
   }
 
-  return w->appenderBuffer().bufferAppender(log_id, appender)
-      ? 0
-      : (err = E::PENDING_FULL, -1);
+  if (w->appenderBuffer().bufferAppender(log_id, appender)) {
+    return 0;
+  }
+  // Keep E::TEMPLIMIT so that appends rejected because of their size are told
+  // apart from the ones rejected because the queue was full.
+  if (err != E::TEMPLIMIT) {
+    err = E::PENDING_FULL;
+  }
+  return -1;
 }
 
 int AppenderPrep::activateAndBuffer(logid_t log_id,
@@ -974,7 +1028,8 @@ void AppenderPrep::sendError(Appender* appender, Status status) const {
 
 void AppenderPrep::sendRedirect(Appender* appender,
                                 NodeID target,
-                                Status status) const {
+                                Status status,
+                                APPENDED_flags_t flags) const {
   ld_check(appender != nullptr);
 
   const logid_t datalog_id = MetaDataLog::dataLogID(header_.logid);
@@ -988,7 +1043,7 @@ void AppenderPrep::sendRedirect(Appender* appender,
                  datalog_id.val_,
                  target.toString().c_str());
 
-  appender->sendRedirect(target, status);
+  appender->sendRedirect(target, status, LSN_INVALID, flags);
 }
 
 StatsHolder* AppenderPrep::stats() const {
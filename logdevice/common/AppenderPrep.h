@@ -13,6 +13,7 @@
 #include "logdevice/common/NodeID.h"
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/PermissionChecker.h"
+#include "logdevice/common/protocol/APPENDED_Message.h"
 #include "logdevice/common/protocol/APPEND_Message.h"
 #include "logdevice/include/Record.h"
 #include "logdevice/include/types.h"
@@ -85,6 +86,24 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   // Called directly in tests
   void execute(std::unique_ptr<Appender>);
 
+  /**
+   * Starts @param appender on @param sequencer with the usual handling of
+   * errors (reactivation, buffering, etc.) and reports the outcome with
+   * onAppenderStarted(). Used by AppendAdmissionBatcher for appends that
+   * could not be admitted as part of a batch.
+   */
+  void startAppender(std::shared_ptr<Sequencer> sequencer,
+                     std::unique_ptr<Appender> appender);
+
+  /**
+   * Reports the outcome of starting @param appender: replies to the client
+   * with err if @param status is ERROR_DELETE, otherwise lets the Appender
+   * run (if SUCCESS_KEEP) and notes that @param sequencer took the append.
+   */
+  void onAppenderStarted(RunAppenderStatus status,
+                         std::shared_ptr<Sequencer>& sequencer,
+                         std::unique_ptr<Appender> appender);
+
   epoch_t getSeen() const {
     return header_.seen;
   }
@@ -133,7 +152,9 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
 
   // Adds the appender to a special queue of appenders which will get processed
   // once the sequencers gets activated.  Returns 0 on success, otherwise
-  // returns -1 and sets err to E::PENDING_FULL.
+  // returns -1 and sets err to E::PENDING_FULL if the queue for the log is
+  // full, or E::TEMPLIMIT if there are too many bytes of appenders buffered
+  // or running.
   virtual int bufferAppender(logid_t log_id,
                              std::unique_ptr<Appender>& appender);
 
@@ -152,8 +173,12 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   // Reply to the client with a given error status.
   virtual void sendError(Appender*, Status) const;
 
-  // Reply to the client with a redirect to `target'.
-  virtual void sendRedirect(Appender*, NodeID target, Status) const;
+  // Reply to the client with a redirect to `target'. `flags' are additional
+  // APPENDED_Header flags to set in the reply.
+  virtual void sendRedirect(Appender*,
+                            NodeID target,
+                            Status,
+                            APPENDED_flags_t flags = 0) const;
 
   // Returns a pointer to the object containing stats.
   virtual StatsHolder* stats() const;
@@ -244,6 +269,13 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
                           const Sequencer* sequencer,
                           bool preempted = false) const;
 
+  /**
+   * @return  node that `sequencer''s log was handed off to (see
+   *          Sequencer::handOff()) if the append should be redirected there,
+   *          or an invalid NodeID otherwise
+   */
+  NodeID getHandoffTarget(const Sequencer* sequencer) const;
+
   /**
    * Buffers the Appender so it gets processed once a sequencer for `log_id'
    * is active. Assumes that `sequencer' is either nullptr or inactive.
@@ -254,6 +286,8 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
    *
    * @return  0 on success and -1 otherwise, with err set to:
    *   PENDING_FULL  - buffer of pending appenders is full
+   *   TEMPLIMIT     - byte budget of the buffer of pending appenders, or of
+   *                   all appenders, is used up
    *   EXISTS        - a sequencer was already reactivated by another thread
    *                   (`sequencer' is updated to point to it)
    *   ABORTED       - `condition' not satisfied
@@ -29,6 +29,8 @@ void AppenderTracer::traceAppend(
     const ClientID& client_id,
     const Sockaddr& client_sock_addr,
     int64_t latency_us,
+    int64_t start_latency_us,
+    int64_t wave_latency_us,
     RecipientSet& recipient_set,
     logid_t log_id,
     lsn_t lsn,
@@ -64,6 +66,11 @@ void AppenderTracer::traceAppend(
     sample->addIntValue("appender_size", full_appender_size);
     sample->addIntValue("seen_epoch", seen_epoch.val());
     sample->addIntValue("latency_us", latency_us);
+    // Breakdown of latency_us, -1 if the appender didn't get that far.
+    // Time before getting an LSN (AppenderBuffer, sequencer window).
+    sample->addIntValue("start_latency_us", start_latency_us);
+    // Time since the last wave of STOREs was sent.
+    sample->addIntValue("wave_latency_us", wave_latency_us);
     sample->addIntValue("log_id", log_id.val());
     sample->addIntValue("lsn", lsn);
     if (backlog_duration) {
@@ -31,6 +31,8 @@ class AppenderTracer : SampledTracer {
                    const ClientID& client_id,
                    const Sockaddr& client_sock_addr,
                    int64_t latency_us,
+                   int64_t start_latency_us,
+                   int64_t wave_latency_us,
                    RecipientSet& recipient_set,
                    logid_t log_id,
                    lsn_t lsn,
@@ -9,16 +9,83 @@
 
 #include <folly/hash/Checksum.h>
 #include <folly/hash/Hash.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/hash/detail/ChecksumDetail.h>
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+const uint64_t CHECKSUM_64BIT_SEED = 0x5715d9be01f6a3f8ULL; // randomly generated
+
+using crc32c_fn_t = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+// The implementation is selected once, on first use, instead of on every
+// call. Both implementations produce identical results.
+crc32c_fn_t selectCrc32cImpl() {
+  static const crc32c_fn_t impl = folly::detail::crc32c_hw_supported()
+      ? &folly::detail::crc32c_hw
+      : &folly::detail::crc32c_sw;
+  return impl;
+}
+
+} // namespace
+
 uint32_t checksum_32bit(Slice slice) {
-  return folly::crc32c((const uint8_t*)slice.data, slice.size);
+  return selectCrc32cImpl()((const uint8_t*)slice.data, slice.size, ~0U);
 }
 
 uint64_t checksum_64bit(Slice slice) {
-  const uint64_t seed = 0x5715d9be01f6a3f8ULL; // randomly generated
-  return folly::hash::SpookyHashV2::Hash64(slice.data, slice.size, seed);
+  return folly::hash::SpookyHashV2::Hash64(
+      slice.data, slice.size, CHECKSUM_64BIT_SEED);
+}
+
+uint32_t checksum_32bit(const Slice* slices, size_t count) {
+  const crc32c_fn_t crc = selectCrc32cImpl();
+  // The returned value is the raw CRC register (no final xor), so it can be
+  // fed back as the starting value for the next slice.
+  uint32_t c32 = ~0U;
+  for (size_t i = 0; i < count; ++i) {
+    c32 = crc((const uint8_t*)slices[i].data, slices[i].size, c32);
+  }
+  return c32;
+}
+
+uint64_t checksum_64bit(const Slice* slices, size_t count) {
+  if (count == 1) {
+    return checksum_64bit(slices[0]);
+  }
+  // SpookyHash's incremental API yields the same hash as the one-shot one.
+  folly::hash::SpookyHashV2 spooky;
+  spooky.Init(CHECKSUM_64BIT_SEED, CHECKSUM_64BIT_SEED);
+  for (size_t i = 0; i < count; ++i) {
+    spooky.Update(slices[i].data, slices[i].size);
+  }
+  uint64_t hash1, hash2;
+  spooky.Final(&hash1, &hash2);
+  return hash1;
+}
+
+void checksum_batch(const Slice* slices,
+                    size_t count,
+                    int nbits,
+                    uint64_t* out) {
+  ld_check(nbits == 32 || nbits == 64);
+  ld_check(count == 0 || (slices != nullptr && out != nullptr));
+  if (nbits == 64) {
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = checksum_64bit(slices[i]);
+    }
+  } else {
+    const crc32c_fn_t crc = selectCrc32cImpl();
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = crc((const uint8_t*)slices[i].data, slices[i].size, ~0U);
+    }
+  }
+}
+
+const char* checksum_32bit_implementation() {
+  return folly::detail::crc32c_hw_supported() ? "hw" : "sw";
 }
 
 Slice checksum_bytes(Slice blob, int nbits, char* buf_out) {
@@ -39,6 +39,37 @@ namespace facebook { namespace logdevice {
 uint32_t checksum_32bit(Slice slice);
 uint64_t checksum_64bit(Slice slice);
 
+/**
+ * Scatter-gather variants: compute the checksum of the concatenation of
+ * `count` slices without first copying them into a contiguous buffer.  The
+ * result is identical to calling the single-slice version on the
+ * concatenated data, so these can be used interchangeably with the above
+ * (checksums are persisted on disk and must never change).
+ *
+ * The 32-bit checksum is CRC32C; folly selects the SSE4.2 / ARMv8 CRC
+ * instruction implementation at runtime when the CPU supports it.
+ */
+uint32_t checksum_32bit(const Slice* slices, size_t count);
+uint64_t checksum_64bit(const Slice* slices, size_t count);
+
+/**
+ * Multi-buffer API: computes an independent `nbits`-bit checksum for each of
+ * the `count` slices and writes it to out[i].  Intended for callers that
+ * checksum a whole batch of payloads at once (e.g. a batch of records being
+ * written to the local log store) so that the implementation selection and
+ * the call overhead are paid once per batch.
+ */
+void checksum_batch(const Slice* slices,
+                    size_t count,
+                    int nbits,
+                    uint64_t* out);
+
+/**
+ * @return name of the CRC32C implementation selected at runtime, e.g.
+ *         "hw" or "sw". Used for logging and benchmarks.
+ */
+const char* checksum_32bit_implementation();
+
 /**
  * Writes a binary checksum of the given blob to the given output buffer.  The
  * output buffer must be at least 8 bytes large to fit a 64-bit checksum.
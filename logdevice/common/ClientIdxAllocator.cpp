@@ -7,52 +7,40 @@
  */
 #include "logdevice/common/ClientIdxAllocator.h"
 
-#include <google/dense_hash_map>
-
 #include "logdevice/common/debug.h"
 
 namespace facebook { namespace logdevice {
 
 ClientID ClientIdxAllocator::issueClientIdx(WorkerType worker_type,
                                             worker_id_t worker_idx) {
-  int client_idx;
-  int wraparound_count = 0;
-  folly::SharedMutex::WriteHolder write_lock(mutex_);
+  const uint64_t max_idx = max_idx_;
+  const auto value = std::make_pair(worker_type, worker_idx);
 
   // This loops but should be O(1) amortised.  If we take long to issue one
   // client index it means previous allocations were blazing fast. :)
+  // Concurrent callers take distinct positions, so they only race for the
+  // same index if one of them went around the whole space in between.
 
-  do {
-    client_idx = next_idx_;
-    advanceNextIdx(&wraparound_count);
-    if (wraparound_count > 1) {
+  for (uint64_t attempts = 0;; ++attempts) {
+    if (attempts > 2 * max_idx) {
       ld_critical("Wrapped around twice while looking for available client "
                   "index.  This "
                   "should not happen in practice with a 31-bit ID space.");
       std::abort();
     }
-    // Loop until we manage to insert into the set (index not already in use)
-  } while (idx_in_use_.find(client_idx) != idx_in_use_.end());
-  idx_in_use_[client_idx] = std::make_pair(worker_type, worker_idx);
-  return ClientID(client_idx);
+    const uint64_t pos = next_pos_.fetch_add(1, std::memory_order_relaxed);
+    const int32_t client_idx = static_cast<int32_t>(pos % max_idx + 1);
+    ld_check(client_idx > 0);
+    // Loop until we manage to insert into the map (index not already in use)
+    if (idx_in_use_.insert(client_idx, value).second) {
+      return ClientID(client_idx);
+    }
+  }
 }
 
 void ClientIdxAllocator::releaseClientIdx(ClientID client_idx) {
-  folly::SharedMutex::WriteHolder write_lock(mutex_);
-  auto it = idx_in_use_.find(client_idx.getIdx());
-  ld_check(it != idx_in_use_.end());
-  idx_in_use_.erase(it);
-}
-
-void ClientIdxAllocator::advanceNextIdx(int* wraparound_count) {
-  if (next_idx_ == max_idx_) {
-    next_idx_ = 1;
-    ++*wraparound_count;
-  } else {
-    ++next_idx_;
-    ld_check(next_idx_ > 0);
-    ld_check(next_idx_ <= max_idx_);
-  }
+  size_t erased = idx_in_use_.erase(client_idx.getIdx());
+  ld_check(erased == 1);
 }
 
 }} // namespace facebook::logdevice
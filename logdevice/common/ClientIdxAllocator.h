@@ -7,13 +7,12 @@
  */
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <limits>
 
-#include <folly/Memory.h>
-#include <folly/SharedMutex.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/hash/Hash.h>
-#include <google/dense_hash_map>
 
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/WorkerType.h"
@@ -33,10 +32,7 @@ namespace facebook { namespace logdevice {
 class ClientIdxAllocator {
  public:
   ClientIdxAllocator() {
-    idx_in_use_.set_empty_key(-1);
-    idx_in_use_.set_deleted_key(-2);
     setMaxClientIdx(std::numeric_limits<int32_t>::max());
-    next_idx_ = 1;
   }
 
   ClientID issueClientIdx(WorkerType worker_type, worker_id_t worker_idx);
@@ -52,9 +48,7 @@ class ClientIdxAllocator {
    * - StoreStateMachine is done, tries to resolve the ClientID to send
    *    the reply.
    */
-  std::pair<WorkerType, worker_id_t> getWorkerId(ClientID client_idx) {
-    folly::SharedMutex::ReadHolder read_lock(mutex_);
-
+  std::pair<WorkerType, worker_id_t> getWorkerId(ClientID client_idx) const {
     auto it = idx_in_use_.find(client_idx.getIdx());
     if (it == idx_in_use_.end()) {
       // client_idx may not be valid if connection was just closed
@@ -78,19 +72,16 @@ class ClientIdxAllocator {
   ClientIdxAllocator& operator=(const ClientIdxAllocator&) = delete;
 
  private:
-  // Method is NOT internally synchronized
-  // mutex_ must be held when calling
-  // Advanced to next client idx.
-  void advanceNextIdx(int* wraparound_count);
-  // Largest index to issue from this instance (index maps to `current_worker_`)
+  // Largest index to issue from this instance
   int32_t max_idx_;
-  // Next index to try to issue
-  int32_t next_idx_;
+  // Number of indexes tried so far. The next index to try is
+  // next_pos_ % max_idx_ + 1.
+  std::atomic<uint64_t> next_pos_{0};
   // Map of client indexes currently in use.  issueClientIdx() will skip these.
-  google::
-      dense_hash_map<int32_t, std::pair<WorkerType, worker_id_t>, folly::Hash>
-          idx_in_use_;
-  folly::SharedMutex mutex_;
+  folly::ConcurrentHashMap<int32_t,
+                           std::pair<WorkerType, worker_id_t>,
+                           folly::Hash>
+      idx_in_use_;
 };
 
 }} // namespace facebook::logdevice
@@ -12,9 +12,12 @@
 #include "logdevice/common/ClusterStateUpdatedRequest.h"
 #include "logdevice/common/GetClusterStateRequest.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/Sender.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/CLUSTER_STATE_SUBSCRIBE_Message.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/stats/Stats.h"
 
 namespace facebook { namespace logdevice {
@@ -172,9 +175,6 @@ void ClusterState::onGetClusterStateDone(
     notifyRefreshComplete();
   };
 
-  const auto& nodes_configuration =
-      Worker::onThisThread()->getNodesConfiguration();
-
   folly::SharedMutex::ReadHolder read_lock(shutdown_mutex_);
   if (shutdown_) {
     RATELIMIT_INFO(std::chrono::seconds(1),
@@ -187,43 +187,124 @@ void ClusterState::onGetClusterStateDone(
   if (status != E::OK) {
     ld_error("Unable to refresh cluster state: %s", error_description(status));
   } else {
-    std::vector<std::string> dead;
-    for (int i = 0; i < nodes_state.size(); i++) {
-      setNodeState(i, static_cast<ClusterState::NodeState>(nodes_state[i]));
-      if (nodes_configuration->isNodeInServiceDiscoveryConfig(i) &&
-          nodes_state[i] == ClusterState::NodeState::DEAD) {
-        dead.push_back("N" + std::to_string(i));
-      }
+    applyClusterState(nodes_state, std::move(boycotted_nodes));
+  }
+}
+
+void ClusterState::applyClusterState(
+    const std::vector<uint8_t>& nodes_state,
+    std::vector<node_index_t> boycotted_nodes) {
+  const auto& nodes_configuration =
+      Worker::onThisThread()->getNodesConfiguration();
+  std::vector<std::string> dead;
+  for (int i = 0; i < nodes_state.size(); i++) {
+    setNodeState(i, static_cast<ClusterState::NodeState>(nodes_state[i]));
+    if (nodes_configuration->isNodeInServiceDiscoveryConfig(i) &&
+        nodes_state[i] == ClusterState::NodeState::DEAD) {
+      dead.push_back("N" + std::to_string(i));
     }
+  }
+
+  std::vector<std::string> boycotted_tostring;
+  boycotted_tostring.reserve(boycotted_nodes.size());
+  for (auto index : boycotted_nodes) {
+    boycotted_tostring.emplace_back("N" + std::to_string(index));
+  }
 
-    std::vector<std::string> boycotted_tostring;
-    boycotted_tostring.reserve(boycotted_nodes.size());
-    for (auto index : boycotted_nodes) {
-      boycotted_tostring.emplace_back("N" + std::to_string(index));
+  setBoycottedNodes(std::move(boycotted_nodes));
+
+  ld_info("Cluster state received with %lu dead nodes (%s) and %lu boycotted "
+          "nodes (%s)",
+          dead.size(),
+          folly::join(',', dead).c_str(),
+          boycotted_tostring.size(),
+          folly::join(',', boycotted_tostring).c_str());
+
+  // notify workers of the update so they can take any action
+  auto cb = [&](Worker& w) {
+    std::unique_ptr<Request> req =
+        std::make_unique<ClusterStateUpdatedRequest>(w.idx_);
+    if (processor_->postRequest(req) != 0) {
+      ld_error("error processing cluster state update on worker #%d: "
+               "postRequest() failed with status %s",
+               w.idx_.val(),
+               error_description(err));
     }
+  };
+  processor_->applyToWorkers(cb);
+}
 
-    setBoycottedNodes(std::move(boycotted_nodes));
-
-    ld_info("Cluster state received with %lu dead nodes (%s) and %lu boycotted "
-            "nodes (%s)",
-            dead.size(),
-            folly::join(',', dead).c_str(),
-            boycotted_tostring.size(),
-            folly::join(',', boycotted_tostring).c_str());
-
-    // notify workers of the update so they can take any action
-    auto cb = [&](Worker& w) {
-      std::unique_ptr<Request> req =
-          std::make_unique<ClusterStateUpdatedRequest>(w.idx_);
-      if (processor_->postRequest(req) != 0) {
-        ld_error("error processing cluster state update on worker #%d: "
-                 "postRequest() failed with status %s",
-                 w.idx_.val(),
-                 error_description(err));
-      }
-    };
-    processor_->applyToWorkers(cb);
+namespace {
+
+void sendClusterStateSubscribe(NodeID node, uint8_t flags) {
+  CLUSTER_STATE_SUBSCRIBE_Header hdr{flags};
+  auto msg = std::make_unique<CLUSTER_STATE_SUBSCRIBE_Message>(hdr);
+  // On failure the next successful refresh subscribes again.
+  Worker::onThisThread()->sender().sendMessage(std::move(msg), node);
+}
+
+} // namespace
+
+void ClusterState::subscribeToPushes(NodeID node) {
+  Worker* w = Worker::onThisThread();
+  folly::Optional<uint16_t> proto =
+      w->sender().getSocketProtocolVersion(node.index());
+  if (!proto.hasValue() ||
+      proto.value() < Compatibility::CLUSTER_STATE_PUSH_SUPPORT) {
+    return;
+  }
+
+  folly::Optional<PushSubscription> prev;
+  {
+    std::lock_guard<std::mutex> lock(push_mutex_);
+    prev = push_subscription_;
+    push_subscription_ = PushSubscription{w->worker_type_, w->idx_, node};
+  }
+
+  // Subscribing again to the same node is a no-op for the node, and restores
+  // the subscription if the connection was closed and reopened since.
+  sendClusterStateSubscribe(node, 0);
+
+  if (prev.hasValue() &&
+      (prev->worker_type != w->worker_type_ || prev->worker != w->idx_ ||
+       prev->node != node)) {
+    // The previous subscription belongs to the connection of the Worker that
+    // made it.
+    const NodeID prev_node = prev->node;
+    std::unique_ptr<Request> req = FuncRequest::make(
+        prev->worker, prev->worker_type, RequestType::MISC, [prev_node] {
+          sendClusterStateSubscribe(
+              prev_node, CLUSTER_STATE_SUBSCRIBE_Header::UNSUBSCRIBE);
+        });
+    processor_->postRequest(req);
+  }
+}
+
+void ClusterState::onClusterStatePushed(
+    const Address& from,
+    const std::vector<uint8_t>& nodes_state,
+    std::vector<node_index_t> boycotted_nodes) {
+  if (from.isClientAddress()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(push_mutex_);
+    Worker* w = Worker::onThisThread();
+    if (!push_subscription_.hasValue() ||
+        push_subscription_->worker_type != w->worker_type_ ||
+        push_subscription_->worker != w->idx_ ||
+        push_subscription_->node != from.asNodeID()) {
+      // A push from a subscription that was just replaced.
+      return;
+    }
+  }
+
+  folly::SharedMutex::ReadHolder read_lock(shutdown_mutex_);
+  if (shutdown_) {
+    return;
   }
+  WORKER_STAT_INCR(client.cluster_state_pushes_received);
+  applyClusterState(nodes_state, std::move(boycotted_nodes));
 }
 
 void ClusterState::resizeClusterState(size_t new_size, bool notifySubscribers) {
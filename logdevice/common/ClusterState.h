@@ -12,13 +12,17 @@
 #include <condition_variable>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <set>
 #include <vector>
 
+#include <folly/Optional.h>
 #include <folly/SharedMutex.h>
 
+#include "logdevice/common/Address.h"
 #include "logdevice/common/NodeID.h"
+#include "logdevice/common/WorkerType.h"
 #include "logdevice/common/UpdateableSharedPtr.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/types_internal.h"
@@ -148,6 +152,23 @@ class ClusterState {
                              const std::vector<uint8_t>& nodes_state,
                              std::vector<node_index_t> boycotted_nodes);
 
+  /**
+   * Client only. Called on the Worker that got a GET_CLUSTER_STATE_REPLY
+   * from `node` when --enable-cluster-state-push is set. Subscribes this
+   * Worker's connection to `node` to pushes of the cluster state, if `node`
+   * supports them, and cancels the previous subscription if it was made to
+   * another node or on another Worker.
+   */
+  void subscribeToPushes(NodeID node);
+
+  /**
+   * Client only. Applies the cluster state pushed by `from`, unless `from`
+   * is no longer the node this client is subscribed to.
+   */
+  void onClusterStatePushed(const Address& from,
+                            const std::vector<uint8_t>& nodes_state,
+                            std::vector<node_index_t> boycotted_nodes);
+
   void noteConfigurationChanged();
   void updateNodesInConfig(const configuration::nodes::ServiceDiscoveryConfig&);
 
@@ -187,6 +208,11 @@ class ClusterState {
 
   void notifyRefreshComplete();
 
+  // Sets the state of all nodes as received from a node of the cluster and
+  // notifies Workers.
+  void applyClusterState(const std::vector<uint8_t>& nodes_state,
+                         std::vector<node_index_t> boycotted_nodes);
+
   folly::SharedMutex mutex_;
   std::unique_ptr<std::atomic<NodeState>[]> node_state_list_ { nullptr };
   std::unordered_set<node_index_t> nodes_in_config_;
@@ -202,5 +228,14 @@ class ClusterState {
   folly::SharedMutex shutdown_mutex_;
   FastUpdateableSharedPtr<std::vector<node_index_t>> boycotted_nodes_{
       std::make_shared<std::vector<node_index_t>>()};
+
+  // Connection that gets cluster state pushes, see subscribeToPushes().
+  struct PushSubscription {
+    WorkerType worker_type;
+    worker_id_t worker;
+    NodeID node;
+  };
+  folly::Optional<PushSubscription> push_subscription_;
+  std::mutex push_mutex_;
 };
 }} // namespace facebook::logdevice
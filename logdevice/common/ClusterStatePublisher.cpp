@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ClusterStatePublisher.h"
+
+#include "logdevice/common/ClusterState.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/GET_CLUSTER_STATE_REPLY_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+ClusterStatePublisher::ClusterStatePublisher() = default;
+
+// The ClusterState subscription isn't removed: the subscription list belongs
+// to the Worker and is destroyed along with this object.
+ClusterStatePublisher::~ClusterStatePublisher() = default;
+
+void ClusterStatePublisher::subscribe(ClientID client) {
+  if (!subscribed_to_cluster_state_) {
+    ClusterState* cs = Worker::getClusterState();
+    if (!cs) {
+      return;
+    }
+    cs->subscribeToUpdates([this](node_index_t, ClusterState::NodeState) {
+      onNodeStateChanged();
+    });
+    subscribed_to_cluster_state_ = true;
+  }
+  subscribers_.insert(client);
+  onNodeStateChanged();
+}
+
+void ClusterStatePublisher::unsubscribe(ClientID client) {
+  subscribers_.erase(client);
+}
+
+void ClusterStatePublisher::onNodeStateChanged() {
+  if (subscribers_.empty()) {
+    return;
+  }
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { push(); });
+  }
+  if (!timer_.isActive()) {
+    timer_.activate(Worker::settings().cluster_state_push_delay);
+  }
+}
+
+void ClusterStatePublisher::push() {
+  std::vector<uint8_t> nodes_state;
+  std::vector<node_index_t> boycotted_nodes;
+  if (getClusterState(&nodes_state, &boycotted_nodes) != E::OK) {
+    // Subscribers keep the state they have. They still refresh it on errors.
+    return;
+  }
+
+  Sender& sender = Worker::onThisThread()->sender();
+  for (auto it = subscribers_.begin(); it != subscribers_.end();) {
+    GET_CLUSTER_STATE_REPLY_Header hdr({REQUEST_ID_INVALID, E::OK});
+    auto msg = std::make_unique<GET_CLUSTER_STATE_REPLY_Message>(
+        hdr, nodes_state, boycotted_nodes);
+    if (sender.sendMessage(std::move(msg), Address(*it)) != 0) {
+      ld_debug("Dropping cluster state subscriber %s: %s",
+               it->toString().c_str(),
+               error_name(err));
+      it = subscribers_.erase(it);
+      continue;
+    }
+    WORKER_STAT_INCR(cluster_state_pushes_sent);
+    ++it;
+  }
+}
+
+Status ClusterStatePublisher::getClusterState(
+    std::vector<uint8_t>* nodes_state,
+    std::vector<node_index_t>* boycotted_nodes) {
+  ld_check(nodes_state);
+  ld_check(boycotted_nodes);
+  Worker* w = Worker::onThisThread();
+  ClusterState* cs = Worker::getClusterState();
+  if (!cs || !w->processor_->isFailureDetectorRunning()) {
+    return E::NOTSUPPORTED;
+  }
+
+  auto my_node_id = w->processor_->getMyNodeID();
+  if (!cs->isNodeAlive(my_node_id.index())) {
+    return E::NOTREADY;
+  }
+
+  auto config = Worker::getConfig();
+  size_t count = config->serverConfig()->getMaxNodeIdx() + 1;
+  nodes_state->resize(count);
+  boycotted_nodes->clear();
+  for (node_index_t i = 0; i < count; i++) {
+    (*nodes_state)[i] = cs->getNodeState(i);
+
+    if (cs->isNodeBoycotted(i)) {
+      boycotted_nodes->emplace_back(i);
+    }
+  }
+  return E::OK;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+
+#include "logdevice/common/ClientID.h"
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-Worker list of the clients connected to this Worker that sent
+ *       CLUSTER_STATE_SUBSCRIBE, see --enable-cluster-state-push. When the
+ *       failure detector changes the state of a node, every subscriber gets
+ *       the whole cluster state in a GET_CLUSTER_STATE_REPLY with an invalid
+ *       client_rqid. Changes that happen within --cluster-state-push-delay
+ *       of each other are coalesced into a single push.
+ *
+ *       A subscriber is dropped when it unsubscribes or when a push to it
+ *       can't be sent, e.g. because its connection was closed.
+ */
+
+class ClusterStatePublisher {
+ public:
+  ClusterStatePublisher();
+  ~ClusterStatePublisher();
+
+  ClusterStatePublisher(const ClusterStatePublisher&) = delete;
+  ClusterStatePublisher& operator=(const ClusterStatePublisher&) = delete;
+
+  // Adds `client` to the subscribers and schedules a push so that it doesn't
+  // miss changes that happened since it got the state it has.
+  void subscribe(ClientID client);
+  void unsubscribe(ClientID client);
+
+  size_t numSubscribers() const {
+    return subscribers_.size();
+  }
+
+  /**
+   * Builds the view of the cluster state of this node that is sent to
+   * clients, in GET_CLUSTER_STATE_REPLY format.
+   *
+   * @return E::OK, or
+   *         E::NOTSUPPORTED if the failure detector isn't running, or
+   *         E::NOTREADY if it doesn't consider this node alive yet.
+   */
+  static Status getClusterState(std::vector<uint8_t>* nodes_state,
+                                std::vector<node_index_t>* boycotted_nodes);
+
+ private:
+  // Called on this Worker when the failure detector changes the state of a
+  // node.
+  void onNodeStateChanged();
+
+  // Sends the current cluster state to all subscribers.
+  void push();
+
+  std::unordered_set<ClientID, ClientID::Hash> subscribers_;
+
+  // whether onNodeStateChanged() is subscribed to ClusterState updates
+  bool subscribed_to_cluster_state_{false};
+
+  // fires --cluster-state-push-delay after the first change since the last
+  // push
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -10,9 +10,24 @@
 #include "logdevice/common/PrincipalParser.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// Whether `cached` refers to the same object as `current`. Unlike comparing
+// raw pointers, this can't mistake a new config allocated at the address of
+// a destroyed one for it.
+template <typename T>
+bool sameObject(const std::weak_ptr<T>& cached,
+                const std::shared_ptr<T>& current) {
+  return !cached.owner_before(current) && !current.owner_before(cached);
+}
+
+} // namespace
+
 void ConfigPermissionChecker::isAllowed(ACTION action,
                                         const PrincipalIdentity& principal,
                                         logid_t logid,
@@ -23,10 +38,59 @@ void ConfigPermissionChecker::isAllowed(ACTION action,
     return;
   }
 
+  Worker* w = Worker::onThisThread();
+  const size_t max_decisions =
+      Worker::settings().permission_decision_cache_size;
+  if (max_decisions == 0) {
+    cb(check(action, principal, logid));
+    return;
+  }
+
+  DecisionCache& cache = *cache_;
+  std::shared_ptr<ServerConfig> server_config = w->getServerConfig();
+  std::shared_ptr<LogsConfig> logs_config = w->getLogsConfig();
+  if (!sameObject(cache.server_config, server_config) ||
+      !sameObject(cache.logs_config, logs_config)) {
+    cache.decisions.clear();
+    cache.server_config = server_config;
+    cache.logs_config = logs_config;
+  }
+
+  // Decisions only depend on the log, the action and the identity names
+  // (see check()). Names are length-prefixed so that they can't run into
+  // each other.
+  std::string& key = cache.key;
+  key.clear();
+  key.append(reinterpret_cast<const char*>(&logid.val_), sizeof(logid.val_));
+  key.push_back(static_cast<char>(action));
+  for (const auto& identity : principal.identities) {
+    const uint32_t len = identity.second.size();
+    key.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    key.append(identity.second);
+  }
+
+  auto it = cache.decisions.find(key);
+  if (it != cache.decisions.end()) {
+    WORKER_STAT_INCR(permission_decision_cache_hits);
+    cb(it->second);
+    return;
+  }
+  WORKER_STAT_INCR(permission_decision_cache_misses);
+  PermissionCheckStatus status = check(action, principal, logid);
+  if (cache.decisions.size() >= max_decisions) {
+    cache.decisions.clear();
+  }
+  cache.decisions.emplace(key, status);
+  cb(status);
+}
+
+PermissionCheckStatus
+ConfigPermissionChecker::check(ACTION action,
+                               const PrincipalIdentity& principal,
+                               logid_t logid) const {
   // If the connection is from an admin, then it is allowed.
   if (isAdmin(principal)) {
-    cb(PermissionCheckStatus::ALLOWED);
-    return;
+    return PermissionCheckStatus::ALLOWED;
   }
 
   auto config = Worker::onThisThread()->getConfig();
@@ -34,33 +98,31 @@ void ConfigPermissionChecker::isAllowed(ACTION action,
       config->getLogGroupByIDShared(logid);
 
   if (log && log->attrs().permissions()) {
-    auto permissions = log->attrs().permissions().value();
-    for (auto identity : principal.identities) {
+    const auto& permissions = log->attrs().permissions().value();
+    for (const auto& identity : principal.identities) {
       auto iter = permissions.find(identity.second);
       if (iter != permissions.end()) {
         if (iter->second[static_cast<int>(action)]) {
-          cb(PermissionCheckStatus::ALLOWED);
-          return;
+          return PermissionCheckStatus::ALLOWED;
         }
       }
     }
     // Attempt to use the default permissions
     auto iter = permissions.find(Principal::DEFAULT);
     if (iter != permissions.end()) {
-      cb(iter->second[static_cast<int>(action)]
-             ? PermissionCheckStatus::ALLOWED
-             : PermissionCheckStatus::DENIED);
-      return;
+      return iter->second[static_cast<int>(action)]
+          ? PermissionCheckStatus::ALLOWED
+          : PermissionCheckStatus::DENIED;
     }
   }
 
-  cb(PermissionCheckStatus::DENIED);
+  return PermissionCheckStatus::DENIED;
 }
 
 bool ConfigPermissionChecker::isAdmin(
     const PrincipalIdentity& principal) const {
   auto config = Worker::onThisThread()->getConfig()->serverConfig();
-  for (auto identity : principal.identities) {
+  for (const auto& identity : principal.identities) {
     if (config->getSecurityConfig().isAdmin(identity.second)) {
       return true;
     }
@@ -7,14 +7,27 @@
  */
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <folly/ThreadLocal.h>
+
 #include "logdevice/common/PermissionChecker.h"
 
 namespace facebook { namespace logdevice {
 
+class LogsConfig;
+class ServerConfig;
+
 /**
  * @file ConfigPermissionChecker is a implementation of PermissionChecker.
  *       The permission information is stored directly on the config file
  *       and is accessed through the config object held in the worker.
+ *
+ *       Decisions are cached per worker, keyed by log, action and the
+ *       principal's identities (see --permission-decision-cache-size), until
+ *       the ServerConfig or LogsConfig the worker sees is replaced.
  */
 
 class ConfigPermissionChecker : public PermissionChecker {
@@ -38,9 +51,24 @@ class ConfigPermissionChecker : public PermissionChecker {
   }
 
  private:
+  // Evaluates the permissions in the config, without the cache.
+  PermissionCheckStatus check(ACTION action,
+                              const PrincipalIdentity& principal,
+                              logid_t logid) const;
+
   // checks the admin list stored on the configuration file to see if the
   // principal should get admin rights.
   bool isAdmin(const PrincipalIdentity& principal) const;
+
+  struct DecisionCache {
+    // configs the decisions were made with
+    std::weak_ptr<ServerConfig> server_config;
+    std::weak_ptr<LogsConfig> logs_config;
+    std::unordered_map<std::string, PermissionCheckStatus> decisions;
+    // reused to build keys of `decisions` without allocating
+    std::string key;
+  };
+  folly::ThreadLocal<DecisionCache> cache_;
 };
 
 }} // namespace facebook::logdevice
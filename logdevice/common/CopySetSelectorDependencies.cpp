@@ -7,6 +7,10 @@
  */
 #include "logdevice/common/CopySetSelectorDependencies.h"
 
+#include "logdevice/common/ShardLatencyTracker.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/settings/Settings.h"
+
 namespace facebook { namespace logdevice {
 
 const NodeAvailabilityChecker*
@@ -14,6 +18,15 @@ CopySetSelectorDependencies::getNodeAvailability() const {
   return NodeAvailabilityChecker::instance();
 }
 
+const ShardLatencyTracker*
+CopySetSelectorDependencies::getShardLatencyTracker() const {
+  Worker* worker = Worker::onThisThread(false);
+  if (!worker || !Worker::settings().adaptive_copyset_selection) {
+    return nullptr;
+  }
+  return &worker->shardLatencyTracker();
+}
+
 const CopySetSelectorDependencies* CopySetSelectorDependencies::instance() {
   static CopySetSelectorDependencies d;
   return &d;
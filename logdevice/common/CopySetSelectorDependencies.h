@@ -11,6 +11,8 @@
 
 namespace facebook { namespace logdevice {
 
+class ShardLatencyTracker;
+
 // Encapsulates the common dependencies of all copyset selectors.
 // Can be mocked, allowing testing copyset selectors in isolation.
 class CopySetSelectorDependencies {
@@ -23,6 +25,12 @@ class CopySetSelectorDependencies {
    */
   virtual const NodeAvailabilityChecker* getNodeAvailability() const;
 
+  /**
+   * Provide per-shard STORE latency estimates, or nullptr if
+   * --adaptive-copyset-selection is off or we're not on a worker thread.
+   */
+  virtual const ShardLatencyTracker* getShardLatencyTracker() const;
+
   // Returns a singleton instance.
   static const CopySetSelectorDependencies* instance();
 };
@@ -55,6 +55,8 @@ class CostQueue : private CostQueueBase<T, ListHook> {
   /* STL idiom conforming methods. */
   using CostQueueBase<T, ListHook>::begin;
   using CostQueueBase<T, ListHook>::end;
+  using CostQueueBase<T, ListHook>::rbegin;
+  using CostQueueBase<T, ListHook>::rend;
   using CostQueueBase<T, ListHook>::front;
   using CostQueueBase<T, ListHook>::back;
   using CostQueueBase<T, ListHook>::empty;
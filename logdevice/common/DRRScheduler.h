@@ -17,6 +17,7 @@
 #include <mutex>
 #include <pthread.h>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include <folly/IntrusiveList.h>
@@ -71,6 +72,14 @@
  * The shares of the queues, or the mode of operation (req based or byte based)
  * can be manually changed from the settings file.
  *
+ * Requests of one principal may further belong to different tenants (e.g. the
+ * clients of different customers reading from a storage node). Within a
+ * principal's queue, tenants are scheduled with the same DRR algorithm, in
+ * proportion to a per-tenant weight passed to enqueue(), so that a tenant
+ * with a deep queue does not starve the others. Requests enqueued without a
+ * tenant all belong to tenant 0. Tenant state is kept for as long as the
+ * scheduler lives, so the number of distinct tenants should be small.
+ *
  */
 namespace facebook { namespace logdevice {
 
@@ -139,6 +148,18 @@ class DRRScheduler {
 
   ~DRRScheduler() {}
 
+  class DRRTenant {
+   public:
+    uint64_t weight_{1};
+    uint64_t deficit_{0};
+
+    // Actual queue of requests.
+    folly::IntrusiveList<T, Link> q_;
+
+    // Links the tenant into DRRQueue::active_ while q_ is not empty.
+    folly::IntrusiveListHook activeHook_;
+  };
+
   class DRRQueue {
    public:
     DRRQueue(DRRPrincipal p, uint64_t quanta)
@@ -146,12 +167,29 @@ class DRRScheduler {
 
     ~DRRQueue() {}
 
+    /*
+     * Returns the tenant whose request is next in line. Tenants with queued
+     * requests take turns at the front of active_, topping up their deficit
+     * by weight * quanta each turn.
+     */
+    DRRTenant* nextTenant(uint64_t quanta) {
+      while (1) {
+        DRRTenant* tenant = &active_.front();
+        if (tenant->deficit_ >= tenant->q_.front().reqSize()) {
+          return tenant;
+        }
+        tenant->deficit_ += tenant->weight_ * quanta;
+        active_.pop_front();
+        active_.push_back(*tenant);
+      }
+    }
+
     DRRStats stats_;
     uint64_t deficit_;
     uint64_t numReqs_;
 
-    // Actual queue of requests.
-    folly::IntrusiveList<T, Link> q_;
+    std::unordered_map<uint64_t, DRRTenant> tenants_;
+    folly::IntrusiveList<DRRTenant, &DRRTenant::activeHook_> active_;
   };
 
   /*
@@ -252,10 +290,19 @@ class DRRScheduler {
   /*
    * Non-blocking interface for enqueing the request.
    */
-  void enqueue(T* req, uint64_t principal) {
+  void enqueue(T* req,
+               uint64_t principal,
+               uint64_t tenant = 0,
+               uint64_t tenantWeight = 1) {
+    ld_check(tenantWeight);
     std::unique_lock<std::mutex> lock(mutex_);
     DRRQueue* queue = queues_[principal].get();
-    queue->q_.push_back(*req);
+    DRRTenant& t = queue->tenants_[tenant];
+    t.weight_ = tenantWeight;
+    if (t.q_.empty()) {
+      queue->active_.push_back(t);
+    }
+    t.q_.push_back(*req);
     numReqs_++;
     queue->numReqs_++;
     cond_.notify_one();
@@ -274,6 +321,19 @@ class DRRScheduler {
     return dequeueInternal();
   }
 
+  /*
+   * Same as blockingDequeue() but gives up and
+   * returns NULL if no request was enqueued
+   * within `timeout`.
+   */
+  T* blockingDequeueFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cond_.wait_for(lock, timeout, [this] { return numReqs_ != 0; })) {
+      return NULL;
+    }
+    return dequeueInternal();
+  }
+
   /*
    * Non-blocking interface for dequeueing the next
    * eligible request. Returns NULL if all the
@@ -294,12 +354,19 @@ class DRRScheduler {
     while (1) {
       DRRQueue* queue = queues_[next_].get();
       if (queue->numReqs_) {
-        req = &queue->q_.front();
+        DRRTenant* tenant = queue->nextTenant(quanta_);
+        req = &tenant->q_.front();
         uint64_t size = req->reqSize();
         ld_check(size);
         if (queue->deficit_ >= size) {
           // We are eligible to dequeue
-          queue->q_.pop_front();
+          tenant->q_.pop_front();
+          tenant->deficit_ -= size;
+          if (tenant->q_.empty()) {
+            tenant->deficit_ = 0;
+            // nextTenant() always returns the front of active_
+            queue->active_.pop_front();
+          }
           numReqs_--;
           queue->numReqs_--;
           queue->deficit_ -= size;
@@ -332,8 +399,10 @@ class DRRScheduler {
   void introspect_contents(std::function<void(const T*)> cb) {
     std::unique_lock<std::mutex> lock(mutex_);
     for (const auto& q : queues_) {
-      for (const auto& req : q->q_) {
-        cb(&req);
+      for (const auto& tenant : q->active_) {
+        for (const auto& req : tenant.q_) {
+          cb(&req);
+        }
       }
     }
   }
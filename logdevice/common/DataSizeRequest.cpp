@@ -10,6 +10,7 @@
 #include <folly/Memory.h>
 
 #include "logdevice/common/EventLoop.h"
+#include "logdevice/common/LogQueryBatcher.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -228,8 +229,14 @@ StorageSetAccessor::SendResult DataSizeRequest::sendTo(ShardID shard) {
   NodeID to(shard.node());
   DATA_SIZE_Header header = {
       id_, log_id_, shard.shard(), start_.count(), end_.count()};
+  Worker* w = Worker::onThisThread();
+  if (batchable_ && w->logQueryBatcher().add(header, to)) {
+    // Will be sent shortly, together with other queries to the same node.
+    // Send errors are reported through onMessageSent().
+    return {StorageSetAccessor::Result::SUCCESS, E::OK};
+  }
   auto msg = std::make_unique<DATA_SIZE_Message>(header);
-  if (Worker::onThisThread()->sender().sendMessage(std::move(msg), to) != 0) {
+  if (w->sender().sendMessage(std::move(msg), to) != 0) {
     if (err == E::PROTONOSUPPORT) {
       RATELIMIT_ERROR(std::chrono::seconds(1),
                       10,
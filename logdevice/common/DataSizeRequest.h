@@ -108,6 +108,15 @@ class DataSizeRequest : public DistributedRequest,
   void setWorkerThread(worker_id_t worker) {
     worker_ = worker;
   }
+
+  /**
+   * Allows the DATA_SIZEs of this request to be held for up to
+   * --log-query-batching-window and sent together with those of other
+   * batchable requests on the same Worker. Used by Client::dataSizeBatch().
+   */
+  void setBatchable() {
+    batchable_ = true;
+  }
   int getThreadAffinity(int /*nthreads*/) override {
     return worker_.val_;
   }
@@ -205,6 +214,7 @@ class DataSizeRequest : public DistributedRequest,
 
   int replication_factor_ = 0;
   worker_id_t worker_ = worker_id_t(-1);
+  bool batchable_ = false;
   std::unique_ptr<NodeSetFinder> nodeset_finder_{nullptr};
 
   // Make sure to call the client callback exactly once
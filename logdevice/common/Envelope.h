@@ -16,6 +16,7 @@
 
 #include "logdevice/common/BWAvailableCallback.h"
 #include "logdevice/common/PriorityMap.h"
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/util.h"
 #include "logdevice/include/Err.h"
@@ -41,7 +42,8 @@ typedef uint64_t message_pos_t;
 
 class Socket;
 
-class Envelope : public BWAvailableCallback {
+class Envelope : public BWAvailableCallback,
+                 public ThreadCachedAllocation<Envelope> {
  public:
   explicit Envelope(Socket& sock, std::unique_ptr<Message> msg)
       : sock_(sock),
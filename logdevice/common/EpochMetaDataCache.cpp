@@ -7,11 +7,92 @@
  */
 #include "logdevice/common/EpochMetaDataCache.h"
 
+#include <algorithm>
+#include <mutex>
+
 namespace facebook { namespace logdevice {
 
-EpochMetaDataCache::EpochMetaDataCache(size_t max_entries)
-    : cache_(max_entries) {
+constexpr size_t EpochMetaDataCache::kMaxShards;
+
+EpochMetaDataCache::EpochMetaDataCache(size_t max_entries) {
   ld_check(max_entries > 0);
+  const size_t nshards = std::min(max_entries, kMaxShards);
+  // round down so that the cache never holds more than max_entries
+  const size_t per_shard = max_entries / nshards;
+  shards_.reserve(nshards);
+  for (size_t i = 0; i < nshards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(per_shard));
+  }
+}
+
+EpochMetaDataCache::Shard& EpochMetaDataCache::getShard(const Key& key) const {
+  return *shards_[KeyHasher()(key) % shards_.size()];
+}
+
+EpochMetaDataCache::Shard& EpochMetaDataCache::getShard(logid_t logid) const {
+  return *shards_[LogIDHasher()(logid) % shards_.size()];
+}
+
+bool EpochMetaDataCache::lookup(const Key& key,
+                                epoch_t* until_out,
+                                EpochMetaData* metadata_out,
+                                RecordSource* source_out,
+                                bool require_consistent) const {
+  ld_check(until_out != nullptr);
+  ld_check(metadata_out != nullptr);
+  ld_check(source_out != nullptr);
+
+  {
+    Shard& shard = getShard(key);
+    folly::SharedMutex::ReadHolder read_guard(shard.mutex);
+    auto it = shard.cache.findWithoutPromotion(key);
+    if (it != shard.cache.end()) {
+      // record in the cache must have a cached source
+      ld_check(MetaDataLogReader::isCachedSource(it->second.source));
+      // if consistent data is required but only a soft one is in the cache,
+      // the entry is ignored
+      if (!require_consistent ||
+          it->second.source != RecordSource::CACHED_SOFT) {
+        *until_out = it->second.until;
+        *source_out = it->second.source;
+        *metadata_out = it->second.metadata;
+        return true;
+      }
+    }
+  }
+
+  return lookupMap(key.first, key.second, until_out, metadata_out, source_out);
+}
+
+bool EpochMetaDataCache::lookupMap(logid_t logid,
+                                   epoch_t epoch,
+                                   epoch_t* until_out,
+                                   EpochMetaData* metadata_out,
+                                   RecordSource* source_out) const {
+  std::shared_ptr<const EpochMetaDataMap> map;
+  {
+    Shard& shard = getShard(logid);
+    folly::SharedMutex::ReadHolder read_guard(shard.mutex);
+    auto it = shard.maps.findWithoutPromotion(logid);
+    if (it == shard.maps.end()) {
+      return false;
+    }
+    map = it->second;
+  }
+
+  ld_check(map != nullptr);
+  if (epoch > map->getEffectiveUntil()) {
+    return false;
+  }
+  auto it = map->find(epoch);
+  if (it == map->end()) {
+    return false;
+  }
+  auto entry = *it;
+  *until_out = entry.first.second;
+  *source_out = RecordSource::CACHED_CONSISTENT;
+  *metadata_out = entry.second;
+  return true;
 }
 
 bool EpochMetaDataCache::getMetaData(logid_t logid,
@@ -20,26 +101,19 @@ bool EpochMetaDataCache::getMetaData(logid_t logid,
                                      EpochMetaData* metadata_out,
                                      RecordSource* source_out,
                                      bool require_consistent) {
-  ld_check(until_out != nullptr);
-  ld_check(metadata_out != nullptr);
-  ld_check(source_out != nullptr);
-  folly::SharedMutex::WriteHolder write_guard(cache_mutex_);
-  auto it = cache_.find(std::make_pair(logid, epoch));
-  if (it == cache_.end()) {
+  const Key key = std::make_pair(logid, epoch);
+  if (!lookup(key, until_out, metadata_out, source_out, require_consistent)) {
     return false;
   }
 
-  // record in the cache must have a cached source
-  ld_check(MetaDataLogReader::isCachedSource(it->second.source));
-  if (require_consistent && it->second.source == RecordSource::CACHED_SOFT) {
-    // require consistent data but only has soft one in cache, consider it as
-    // a miss
-    return false;
+  // Promoting needs the write lock. If other threads are using the shard,
+  // the entry is hot anyway and not worth waiting for.
+  Shard& shard = getShard(key);
+  std::unique_lock<folly::SharedMutex> write_guard(
+      shard.mutex, std::try_to_lock);
+  if (write_guard.owns_lock()) {
+    shard.cache.find(key);
   }
-
-  *until_out = it->second.until;
-  *source_out = it->second.source;
-  *metadata_out = it->second.metadata;
   return true;
 }
 
@@ -49,25 +123,11 @@ bool EpochMetaDataCache::getMetaDataNoPromotion(logid_t logid,
                                                 EpochMetaData* metadata_out,
                                                 RecordSource* source_out,
                                                 bool require_consistent) const {
-  ld_check(until_out != nullptr);
-  ld_check(metadata_out != nullptr);
-  ld_check(source_out != nullptr);
-
-  // using read locks here since the cache is immutable
-  folly::SharedMutex::ReadHolder read_guard(cache_mutex_);
-  auto it = cache_.findWithoutPromotion(std::make_pair(logid, epoch));
-  if (it == cache_.end()) {
-    return false;
-  }
-
-  ld_check(MetaDataLogReader::isCachedSource(it->second.source));
-  if (require_consistent && it->second.source == RecordSource::CACHED_SOFT) {
-    return false;
-  }
-  *until_out = it->second.until;
-  *source_out = it->second.source;
-  *metadata_out = it->second.metadata;
-  return true;
+  return lookup(std::make_pair(logid, epoch),
+                until_out,
+                metadata_out,
+                source_out,
+                require_consistent);
 }
 
 void EpochMetaDataCache::setMetaData(logid_t logid,
@@ -85,16 +145,62 @@ void EpochMetaDataCache::setMetaData(logid_t logid,
     return;
   }
 
-  folly::SharedMutex::WriteHolder write_guard(cache_mutex_);
-  auto it = cache_.findWithoutPromotion(std::make_pair(logid, epoch));
-  if (it != cache_.end() &&
+  const Key key = std::make_pair(logid, epoch);
+  Shard& shard = getShard(key);
+  folly::SharedMutex::WriteHolder write_guard(shard.mutex);
+  auto it = shard.cache.findWithoutPromotion(key);
+  if (it != shard.cache.end() &&
       it->second.source == RecordSource::CACHED_CONSISTENT &&
       source == RecordSource::CACHED_SOFT) {
     // do not overwrite an existing consistent record with a soft one
     return;
   }
 
-  cache_.set(std::make_pair(logid, epoch), {until, source, metadata});
+  shard.cache.set(key, {until, source, metadata});
+}
+
+void EpochMetaDataCache::setMetaDataMap(
+    logid_t logid,
+    std::shared_ptr<const EpochMetaDataMap> map) {
+  ld_check(map != nullptr);
+  Shard& shard = getShard(logid);
+  folly::SharedMutex::WriteHolder write_guard(shard.mutex);
+  auto it = shard.maps.findWithoutPromotion(logid);
+  if (it != shard.maps.end() &&
+      it->second->getEffectiveUntil() > map->getEffectiveUntil()) {
+    // a concurrent reader cached a more recent map
+    return;
+  }
+  shard.maps.set(logid, std::move(map));
+}
+
+bool EpochMetaDataCache::startFetch(logid_t logid,
+                                    folly::Function<void()> on_done) {
+  std::lock_guard<std::mutex> guard(fetches_mutex_);
+  auto it = fetches_.find(logid);
+  if (it == fetches_.end()) {
+    fetches_.emplace(logid, std::vector<folly::Function<void()>>());
+    return true;
+  }
+  it->second.push_back(std::move(on_done));
+  return false;
+}
+
+void EpochMetaDataCache::finishFetch(logid_t logid) {
+  std::vector<folly::Function<void()>> waiters;
+  {
+    std::lock_guard<std::mutex> guard(fetches_mutex_);
+    auto it = fetches_.find(logid);
+    if (it == fetches_.end()) {
+      ld_check(false);
+      return;
+    }
+    waiters = std::move(it->second);
+    fetches_.erase(it);
+  }
+  for (auto& on_done : waiters) {
+    on_done();
+  }
 }
 
 }} // namespace facebook::logdevice
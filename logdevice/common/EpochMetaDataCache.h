@@ -7,14 +7,20 @@
  */
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/SharedMutex.h>
+#include <folly/Function.h>
 #include <folly/container/EvictingCacheMap.h>
 #include <folly/hash/Hash.h>
 
 #include "logdevice/common/EpochMetaData.h"
+#include "logdevice/common/EpochMetaDataMap.h"
 #include "logdevice/common/MetaDataLogReader.h"
 
 namespace facebook { namespace logdevice {
@@ -35,13 +41,20 @@ namespace facebook { namespace logdevice {
  *         information is needed, users should not read from the cache but read
  *         directly from metadata logs instead.
  *
- *  The cache is meant to be shared among all worker threads and is proteceted
- *  by locks.
+ *  The cache is meant to be shared among all worker threads. Entries are
+ *  spread over independently locked shards by key hash, and each shard is an
+ *  LRU of max_entries / number of shards entries. Lookups only take the read
+ *  lock of their shard; promotion in the LRU list is best effort and skipped
+ *  when the shard is contended, so that readers of a hot entry don't
+ *  serialize on each other.
  *
- * TODO: write our own LRU cache implementation that supports:
- *       1) epoch interval ranged looked up
- *       2) finer grained locking
- *       3) reduce write frequency by rate limiting promotions
+ *  Besides individual entries, the cache can hold the whole EpochMetaDataMap
+ *  of a log as read by NodeSetFinder. Lookups that miss an exact entry fall
+ *  back to that map, so that one read of the metadata log answers every epoch
+ *  up to its effective until for all readers of the log in the client.
+ *  Readers can also register the metadata fetch they are about to start with
+ *  startFetch(), so that other readers of the same log that miss the cache at
+ *  the same time wait for it instead of reading the metadata log again.
  */
 
 class EpochMetaData;
@@ -57,7 +70,8 @@ class EpochMetaDataCache : boost::noncopyable {
   // @return       true if there is a cache hit, and results (metadata and
   //               until epoch) will be written into @param metadata_out and
   //               @param until_out, respectively. The entry will also be
-  //               promoted in the LRU list
+  //               promoted in the LRU list unless another thread holds the
+  //               shard's lock
   bool getMetaData(logid_t logid,
                    epoch_t epoch,
                    epoch_t* until_out,
@@ -80,6 +94,28 @@ class EpochMetaDataCache : boost::noncopyable {
                    RecordSource source,
                    const EpochMetaData& metadata);
 
+  // put the whole epoch metadata map of a log, as read from the metadata log,
+  // into the cache. Epochs up to the map's effective until that don't have
+  // an entry of their own are looked up in it and reported as
+  // CACHED_CONSISTENT. Replaces the map cached for the log unless that one
+  // is effective until a higher epoch.
+  void setMetaDataMap(logid_t logid,
+                      std::shared_ptr<const EpochMetaDataMap> map);
+
+  // Called by a reader that missed the cache before it reads the metadata
+  // log of @param logid.
+  // @return  true if no other reader is fetching the metadata of the log;
+  //          the caller should fetch it and call finishFetch() when done,
+  //          whether or not the fetch succeeded. Otherwise @param on_done is
+  //          called, on the thread that calls finishFetch(), once the fetch
+  //          in flight is over, and the caller should then look up the cache
+  //          again.
+  bool startFetch(logid_t logid, folly::Function<void()> on_done);
+
+  // ends the fetch of the metadata of @param logid started after
+  // startFetch() returned true, and notifies the readers waiting for it
+  void finishFetch(logid_t logid);
+
  private:
   using Key = std::pair<logid_t, epoch_t>;
 
@@ -95,12 +131,46 @@ class EpochMetaDataCache : boost::noncopyable {
     EpochMetaData metadata;
   };
 
+  struct LogIDHasher {
+    size_t operator()(const logid_t& logid) const {
+      return folly::hash::twang_mix64(logid.val_);
+    }
+  };
+
   // the internal LRU cache
   using LRUCache = folly::EvictingCacheMap<Key, Value, KeyHasher>;
-  LRUCache cache_;
+  // whole epoch metadata maps, keyed by log
+  using MapCache =
+      folly::EvictingCacheMap<logid_t,
+                              std::shared_ptr<const EpochMetaDataMap>,
+                              LogIDHasher>;
+
+  struct Shard {
+    explicit Shard(size_t max_entries)
+        : cache(max_entries), maps(max_entries) {}
+
+    LRUCache cache;
+    MapCache maps;
+    // protect the access to cache
+    folly::SharedMutex mutex;
+  };
+
+  // upper bound on the number of shards; caches with fewer entries than this
+  // get one shard per entry
+  static constexpr size_t kMaxShards = 16;
+
+  Shard& getShard(const Key& key) const;
+  Shard& getShard(logid_t logid) const;
+
+  // looks up @param key under the read lock of its shard and copies the
+  // entry into the output arguments
+  bool lookup(const Key& key,
+              epoch_t* until_out,
+              EpochMetaData* metadata_out,
+              RecordSource* source_out,
+              bool require_consistent) const;
 
-  // protect the access to lru_cache_
-  folly::SharedMutex cache_mutex_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 }} // namespace facebook::logdevice
@@ -17,6 +17,7 @@
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/LogRecoveryRequest.h"
 #include "logdevice/common/MetaDataLogWriter.h"
+#include "logdevice/common/MutationStoreBatch.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/SimpleEnumMap.h"
@@ -966,6 +967,13 @@ bool EpochRecovery::mutateEpoch(const std::set<ShardID>& mutation_set,
   }
 
   const recovery_id_t recovery_id = id_;
+  // With --recovery-mutation-batching, mutators hand the STOREs of their
+  // first wave to this batch, which sends them once all mutators started.
+  MutationStoreBatch batch;
+  if (deps_->getSettings().recovery_mutation_batching) {
+    store_batch_ = &batch;
+  }
+
   // start all mutators, note that it is possible some may synchronously finish
   for (auto mit = mutators_.begin(); mit != mutators_.end();) {
     ld_check(mit->second != nullptr);
@@ -983,11 +991,17 @@ bool EpochRecovery::mutateEpoch(const std::set<ShardID>& mutation_set,
                      "the EpochRecovery state machine was restarted.",
                      epoch_.val_,
                      getLogID().val_);
-      return true;
+      break;
     }
   }
 
-  return false;
+  store_batch_ = nullptr;
+  // Send errors are reported to the mutators, which may also restart this
+  // EpochRecovery. If it was restarted above, the STOREs of the mutators
+  // that had started are still sent, same as without batching; replies to
+  // them are ignored.
+  batch.flush();
+  return id_ != recovery_id;
 }
 
 std::pair<STORE_Header, STORE_Extra>
@@ -1231,6 +1245,20 @@ bool EpochRecovery::onSealedOrActivated() {
     ld_check(state_ == State::DIGEST);
   }
 
+  if (canSkipDigest()) {
+    // The digest of shards in SEALED would be empty. Consider them digested
+    // without starting read streams on them.
+    for (ShardID shard :
+         recovery_set_.getNodesInState(RecoveryNode::State::SEALED)) {
+      recovery_set_.transition(shard, RecoveryNode::State::DIGESTED);
+      if (deps_->canMutateShard(shard)) {
+        recovery_set_.transition(shard, RecoveryNode::State::MUTATABLE);
+      }
+      STAT_INCR(deps_->getStats(), epoch_recovery_digest_skipped);
+    }
+    return onDigestMayHaveBecomeComplete();
+  }
+
   // start digesting on nodes in SEALED
   int n_matching __attribute__((__unused__)) =
       recovery_set_.advanceMatching(RecoveryNode::State::DIGESTING);
@@ -1238,6 +1266,14 @@ bool EpochRecovery::onSealedOrActivated() {
   return onDigestMayHaveBecomeComplete();
 }
 
+bool EpochRecovery::canSkipDigest() const {
+  ld_check(digest_start_esn_ != ESN_INVALID);
+  // After a restart, shards may store records written by the mutations of
+  // the previous attempt, which SEALED replies don't account for.
+  return deps_->getSettings().recovery_skip_digest_of_drained_epochs &&
+      num_restarts_ == 0 && max_seen_esn_ < digest_start_esn_;
+}
+
 esn_t EpochRecovery::computeDigestStart() const {
   if (lng_ == ESN_INVALID) {
     return ESN_MIN;
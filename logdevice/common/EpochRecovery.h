@@ -40,6 +40,7 @@ struct GAP_Header;
 struct MUTATED_Header;
 struct Settings;
 class LogRecoveryRequest;
+class MutationStoreBatch;
 class RECORD_Message;
 class SenderBase;
 
@@ -342,6 +343,15 @@ class EpochRecovery {
    */
   void onStoreSent(ShardID to, const STORE_Header& header, Status status);
 
+  /**
+   * If not nullptr, Mutators should hand their STOREs to this batch instead
+   * of sending them right away. Only set while mutateEpoch() starts the
+   * Mutators, with --recovery-mutation-batching.
+   */
+  MutationStoreBatch* getStoreBatch() const {
+    return store_batch_;
+  }
+
   /**
    * Called by a Mutator when it has successfully stored enough copies
    * of the record or plug, or when the Mutator determines that it can
@@ -529,6 +539,20 @@ class EpochRecovery {
    */
   esn_t computeDigestStart() const;
 
+  /**
+   * @return true if the digest phase can be skipped for shards that are
+   *         currently SEALED, because SEALED replies show that none of them
+   *         stores a record at or above digest_start_esn_. This is the
+   *         common case for epochs that their sequencer drained before
+   *         handing the log over to another node (e.g., the node stopped
+   *         being a sequencer node or the sequencer was deactivated by
+   *         an admin command): all records are fully stored and released,
+   *         so lng_ is the last record of the epoch and its tail record
+   *         comes with the SEALED replies. The digest of these shards would
+   *         be empty, so there is no need to read it.
+   */
+  bool canSkipDigest() const;
+
   /**
    * Compute the tail record and accumulative log attributes of the epoch based
    * on information from SEALED and digest replies.
@@ -694,6 +718,9 @@ class EpochRecovery {
   // received enough successful STORED replies.
   std::map<esn_t, std::unique_ptr<Mutator>> mutators_;
 
+  // @see getStoreBatch()
+  MutationStoreBatch* store_batch_ = nullptr;
+
   // This timer is started when we first get M=max(N-f, f+1) nodes in
   // DIGESTED state. The remaining N-M nodes in the epoch node set are
   // allowed to participate in recovery if we get SEALED, and later
@@ -123,6 +123,48 @@ RunAppenderStatus EpochSequencer::runAppender(Appender* appender) {
   return RunAppenderStatus::SUCCESS_KEEP;
 }
 
+std::vector<RunAppenderStatus>
+EpochSequencer::runAppenders(folly::Range<Appender* const*> appenders) {
+  ld_check(!appenders.empty());
+  for (Appender* appender : appenders) {
+    if (!appender || appender->started()) {
+      ld_check(false);
+      err = E::INVALID_PARAM;
+      return {};
+    }
+  }
+
+  if (state_.load() != State::ACTIVE) {
+    err = E::NOSEQUENCER;
+    return {};
+  }
+
+  const lsn_t first = window_.growMany(appenders.begin(), appenders.size());
+  if (first == LSN_INVALID) {
+    // same reasons as in runAppender(), but NOBUFS and TOOBIG may mean that
+    // only some of the Appenders didn't fit
+    ld_check(err == E::NOBUFS || err == E::TOOBIG || err == E::DISABLED);
+    return {};
+  }
+
+  const bool byte_offsets = getSettings().byte_offsets;
+  std::vector<RunAppenderStatus> res;
+  res.reserve(appenders.size());
+  for (size_t i = 0; i < appenders.size(); ++i) {
+    if (byte_offsets) {
+      processNextBytes(appenders[i]);
+    }
+    int rv = appenders[i]->start(shared_from_this(), first + i);
+    if (rv != 0) {
+      ld_check(err == E::SYSLIMIT); // INTERNAL asserts in debug mode
+      res.push_back(RunAppenderStatus::ERROR_DELETE);
+    } else {
+      res.push_back(RunAppenderStatus::SUCCESS_KEEP);
+    }
+  }
+  return res;
+}
+
 void EpochSequencer::processNextBytes(Appender* appender) {
   ld_check(appender != nullptr);
   uint64_t in_payload_checksum_bytes = appender->getChecksumBytes();
@@ -11,8 +11,11 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
+#include <folly/Range.h>
 #include <folly/concurrency/AtomicSharedPtr.h>
+#include <folly/lang/Align.h>
 
 #include "logdevice/common/Appender.h"
 #include "logdevice/common/EpochMetaData.h"
@@ -176,6 +179,20 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
    */
   virtual RunAppenderStatus runAppender(Appender* appender);
 
+  /**
+   * Like runAppender(), but for several Appenders of a Worker at once. They
+   * get consecutive LSNs, reserved with a single update of the sliding
+   * window (see SlidingWindowSingleEpoch::growMany()).
+   *
+   * @return  if LSNs were assigned, one status per Appender, in order:
+   *          SUCCESS_KEEP, or ERROR_DELETE if the Appender failed to start
+   *          (err is SYSLIMIT for those). If LSNs could not be assigned, an
+   *          empty vector is returned, none of the Appenders is running, and
+   *          err is set as in runAppender().
+   */
+  virtual std::vector<RunAppenderStatus>
+  runAppenders(folly::Range<Appender* const*> appenders);
+
   /**
    * Tells the EpochSequencer that the Appender whose record was assigned
    * @param lsn has fully stored the record, and the record may
@@ -455,6 +472,11 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
   mutable std::mutex state_mutex_;
 
   ///// Accumulative state of the epoch ////////
+  //
+  // lng_, last_reaped_, draining_target_ and tail_record_ are updated as
+  // Appenders are reaped, on whichever Worker reaps them. They start a new
+  // cache line so that reaping doesn't invalidate state_ and the other fields
+  // read by runAppender() on every Worker admitting appends.
 
   // "last known good" ESN in this epoch. This is
   // the highest ESN such that all records in this epoch
@@ -463,7 +485,8 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
   //
   // initialized to lsn(epoch, ESN_INVALID). The value is an atomic<lsn_t>
   // but the epoch part of lng_ always equals to this epoch (= window_.epoch()).
-  std::atomic<lsn_t> lng_;
+  alignas(folly::hardware_destructive_interference_size) std::atomic<lsn_t>
+      lng_;
 
   // last reaped lsn of the epoch, updated whenever an Appender is reaped from
   // the sliding window. Similar to lng_, initialized to
@@ -472,10 +495,6 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
   // (e.g., preempted, aborted, ...)
   std::atomic<lsn_t> last_reaped_;
 
-  // TODO 7467469: more accumulated states, byte offset, etc
-  // Amount of data written to current epoch up to last appended record.
-  AtomicOffsetMap offsets_within_epoch_;
-
   // Target lsn for the completion of draining/destruction (i.e.,
   // last appender lsn in the window when it was disabled). Initialized to
   // LSN_MAX. Should only be set once for the lifetime of the EpochSequencer.
@@ -487,6 +506,12 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
   // the epoch
   folly::atomic_shared_ptr<TailRecord> tail_record_;
 
+  // TODO 7467469: more accumulated states, byte offset, etc
+  // Amount of data written to current epoch up to last appended record.
+  // Updated by runAppender(), so kept apart from the reaping state above.
+  alignas(folly::hardware_destructive_interference_size)
+      AtomicOffsetMap offsets_within_epoch_;
+
   // return true if the epoch is quiescent, i.e., last_reaped_ advanced to
   // draining_target_
   bool epochQuiescent() const;
@@ -118,6 +118,24 @@ int EventLoopTaskQueue::addWithPriority(Func func, int8_t priority) {
   return 0;
 }
 
+int EventLoopTaskQueue::addBatch(std::vector<std::pair<Func, int8_t>> funcs) {
+  if (UNLIKELY(sem_.isShutdown())) {
+    err = E::SHUTDOWN;
+    return -1;
+  }
+  if (funcs.empty()) {
+    return 0;
+  }
+  // Same ordering requirement as in addWithPriority(): everything must be in
+  // the queues before the tokens become visible to the consumer.
+  for (auto& f : funcs) {
+    ld_check(f.first);
+    queues_[translatePriority(f.second)].enqueue(std::move(f.first));
+  }
+  sem_.post(static_cast<uint32_t>(funcs.size()));
+  return 0;
+}
+
 void EventLoopTaskQueue::haveTasksEventHandler(void* arg, short what) {
   EventLoopTaskQueue* self = static_cast<EventLoopTaskQueue*>(arg);
   if (!(what & EV_READ)) {
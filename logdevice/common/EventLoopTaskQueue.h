@@ -9,6 +9,8 @@
 
 #include <memory>
 #include <numeric>
+#include <utility>
+#include <vector>
 
 #include <folly/Executor.h>
 #include <folly/Function.h>
@@ -89,6 +91,20 @@ class EventLoopTaskQueue {
     return addWithPriority(std::move(func), folly::Executor::LO_PRI);
   }
 
+  /**
+   * Adds several functions, each with its own priority, in one go.  All of
+   * them are enqueued before the semaphore is posted once with the size of
+   * the batch, so the batch wakes up the EventLoop thread at most once
+   * instead of once per function.  Functions of the same priority execute in
+   * the order they appear in `funcs'.
+   *
+   * Can be invoked from any thread.
+   *
+   * @return 0 on success, -1 with err set to SHUTDOWN if shutdown() was
+   *         already called, in which case nothing is enqueued.
+   */
+  virtual int addBatch(std::vector<std::pair<Func, int8_t>> funcs);
+
   /*
    * Checks if the queue is filled up to the soft capacity limit.
    */
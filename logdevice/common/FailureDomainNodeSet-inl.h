@@ -24,35 +24,29 @@ FailureDomainNodeSet<AttrType, HashFn>::FailureDomainNodeSet(
 
   // The user is expected to pass a valid ReplicationProperty object.
   ld_check(rep.isValid());
-  size_t shard_replication = 0;
-  auto scope = NodeLocation::nextSmallerScope(NodeLocationScope::ROOT);
-  while (scope != NodeLocationScope::INVALID) {
-    size_t replication = rep.getReplication(scope);
-    // Do not consider the scope if the user did not specify a replication
-    // factor for it, or if the replication factor for it is <= than the
-    // replication factor at larger scopes.
-    if (replication != 0 && replication > shard_replication) {
-      ScopeState state{};
-      state.replication = replication;
-      scopes_[scope] = state;
-      shard_replication = replication;
-    }
-    scope = NodeLocation::nextSmallerScope(scope);
+  // cluster should have some nodes.
+  ld_check(nodes_configuration.clusterSize() > 0);
+
+  std::shared_ptr<const FailureDomainLayout> layout =
+      FailureDomainLayout::get(storage_set, nodes_configuration, rep);
+  const size_t words = (layout->shards.size() + 63) / 64;
+  for (const FailureDomainLayout::Scope& layout_scope : layout->scopes) {
+    ScopeState& state = scopes_[layout_scope.scope];
+    state.replication = layout_scope.replication;
+    state.domains.resize(layout_scope.num_domains);
+    state.domain_shards.resize(layout_scope.num_domains, ShardBitset(words));
   }
+  fully_shards_.resize(words);
+  empty_shards_.resize(words);
 
   // replication at implicit SHARD scope is equal to the replication at the
   // lowest scope defined by the user (usually NODE).
-  shard_scope_.replication = shard_replication;
+  shard_scope_.replication = layout->shard_replication;
   ld_check(shard_scope_.replication > 0);
+  shard_scope_.domains.resize(layout->shards.size());
 
-  // cluster should have some nodes.
-  ld_check(nodes_configuration.clusterSize() > 0);
-
-  // only include storage shards in nodes configuration and in reader's view
-  // (e.g., exclude shards in "none" state)
-  for (const ShardID shard :
-       nodes_configuration.getStorageMembership()->readerView(storage_set)) {
-    addShard(shard, nodes_configuration);
+  for (size_t i = 0; i < layout->shards.size(); ++i) {
+    addShard(*layout, i);
   }
 
   ld_check(numShards() <= storage_set.size());
@@ -61,38 +55,25 @@ FailureDomainNodeSet<AttrType, HashFn>::FailureDomainNodeSet(
 
 template <typename AttrType, typename HashFn>
 void FailureDomainNodeSet<AttrType, HashFn>::addShard(
-    ShardID shard,
-    const configuration::nodes::NodesConfiguration& nodes_configuration) {
-  const auto* service_disc =
-      nodes_configuration.getNodeServiceDiscovery(shard.node());
-  // shard came from the membership reader view of the node configuration
-  ld_check(service_disc != nullptr);
-
-  for (auto it = scopes_.begin(); it != scopes_.end(); ++it) {
-    const NodeLocationScope scope = it->first;
-    std::string domain_name;
-    if (scope == NodeLocationScope::NODE) {
-      domain_name = std::to_string(shard.node());
-    } else if (!service_disc->location.hasValue() ||
-               !service_disc->location.value().scopeSpecified(scope)) {
-      ld_error("Node %d (%s) in the storage_set does not have location "
-               "information in location scope: %s.",
-               shard.node(),
-               service_disc->address.toString().c_str(),
-               NodeLocation::scopeNames()[scope].c_str());
+    const FailureDomainLayout& layout,
+    size_t idx) {
+  const ShardID shard = layout.shards[idx];
+
+  for (const FailureDomainLayout::Scope& layout_scope : layout.scopes) {
+    const int domain = layout_scope.shard_domains[idx];
+    if (domain < 0) {
+      // no location information at this scope
       continue;
-    } else {
-      domain_name = service_disc->location.value().getDomain(scope);
     }
-
-    ScopeState& state = it->second;
-    FailureDomainState& fd = state.domains[domain_name];
+    ScopeState& state = scopes_.at(layout_scope.scope);
+    FailureDomainState& fd = state.domains[domain];
     state.shard_map[shard] = &fd;
     ++fd.n_shards;
+    setBit(state.domain_shards[domain], idx, true);
   }
 
   // Register the shard in the implicit SHARD scope.
-  FailureDomainState& shard_fd = shard_scope_.domains[shard.toString()];
+  FailureDomainState& shard_fd = shard_scope_.domains[idx];
   shard_scope_.shard_map[shard] = &shard_fd;
   // There can only be one shard in a domain at scope SHARD.
   ld_check(shard_fd.n_shards == 0);
@@ -102,6 +83,8 @@ void FailureDomainNodeSet<AttrType, HashFn>::addShard(
   ++authoritative_count_[static_cast<size_t>(
       AuthoritativeStatus::FULLY_AUTHORITATIVE)];
   shard_authoritative_[shard] = AuthoritativeStatus::FULLY_AUTHORITATIVE;
+  setBit(fully_shards_, idx, true);
+  shard_index_[shard] = idx;
 }
 
 template <typename AttrType, typename HashFn>
@@ -123,6 +106,7 @@ void FailureDomainNodeSet<AttrType, HashFn>::setShardAttribute(ShardID shard,
 
   const AuthoritativeStatus status = status_it->second;
 
+  const size_t idx = shard_index_.at(shard);
   auto result = shard_attribute_.insert(std::make_pair(shard, attr));
   if (!result.second) {
     AttrType old_attr = result.first->second;
@@ -137,11 +121,18 @@ void FailureDomainNodeSet<AttrType, HashFn>::setShardAttribute(ShardID shard,
       result.first->second = attr;
       // remove the old attribute
       removeAttr(shard, old_attr, status);
+      setBit(attr_shards_.at(old_attr), idx, false);
     }
   }
 
   ++attribute_count_[attr];
   addAttr(shard, attr, status);
+  auto bits_it = attr_shards_.find(attr);
+  if (bits_it == attr_shards_.end()) {
+    bits_it =
+        attr_shards_.emplace(attr, ShardBitset(fully_shards_.size())).first;
+  }
+  setBit(bits_it->second, idx, true);
 }
 
 template <typename AttrType, typename HashFn>
@@ -248,6 +239,11 @@ void FailureDomainNodeSet<AttrType, HashFn>::setShardAuthoritativeStatus(
   --authoritative_count_[static_cast<size_t>(prev)];
   ++authoritative_count_[static_cast<size_t>(status)];
 
+  const size_t idx = shard_index_.at(shard);
+  setBit(fully_shards_, idx, isFully(status));
+  setBit(
+      empty_shards_, idx, status == AuthoritativeStatus::AUTHORITATIVE_EMPTY);
+
   forEachScope([&](ScopeState& scope) {
     setShardAuthoritativeStatusAtScope(shard, scope, prev, status, attr);
   });
@@ -351,26 +347,51 @@ FailureDomainNodeSet<AttrType, HashFn>::getShardAuthoritativeStatus(
   return it->second;
 }
 
+template <typename AttrType, typename HashFn>
+typename FailureDomainNodeSet<AttrType, HashFn>::ShardBitset
+FailureDomainNodeSet<AttrType, HashFn>::fullyTaggedShards(
+    attr_pred_t pred) const {
+  ShardBitset tagged(fully_shards_.size());
+  for (const auto& kv : attr_shards_) {
+    if (pred(kv.first)) {
+      for (size_t w = 0; w < tagged.size(); ++w) {
+        tagged[w] |= kv.second[w];
+      }
+    }
+  }
+  for (size_t w = 0; w < tagged.size(); ++w) {
+    tagged[w] &= fully_shards_[w];
+  }
+  return tagged;
+}
+
 template <typename AttrType, typename HashFn>
 size_t FailureDomainNodeSet<AttrType, HashFn>::countCompleteDomains(
     attr_pred_t pred,
     const ScopeState& scope) const {
-  size_t num_complete_domains = 0;
+  const ShardBitset tagged = fullyTaggedShards(pred);
 
-  // iterate all failure domains within the scope; for each domain
-  // check if it is a complete domain wrt to the predicate given
-  for (const auto& domain_kv : scope.domains) {
-    size_t num_shards = 0;
-    const FailureDomainState& domain = domain_kv.second;
-    for (const auto& att_kv : domain.shards_attr) {
-      if (pred(att_kv.first)) {
-        num_shards += att_kv.second.full_only;
-      }
+  if (&scope == &shard_scope_) {
+    // Each domain is a single shard, complete if it is tagged.
+    size_t num_complete_domains = 0;
+    for (uint64_t word : tagged) {
+      num_complete_domains += folly::popcount(word);
     }
+    return num_complete_domains;
+  }
 
-    ld_check(domain.n_shards >= domain.n_empty);
-    if (num_shards > 0 && num_shards >= domain.n_shards - domain.n_empty) {
-      // num_shards > 0 is required to ensure the domain is not empty
+  // A domain is complete if it has at least one fully authoritative shard
+  // matching the predicate (ie it's not empty) and all its other shards are
+  // either matching the predicate too or empty.
+  size_t num_complete_domains = 0;
+  for (const ShardBitset& domain : scope.domain_shards) {
+    uint64_t any_tagged = 0;
+    uint64_t missing = 0;
+    for (size_t w = 0; w < tagged.size(); ++w) {
+      any_tagged |= domain[w] & tagged[w];
+      missing |= domain[w] & ~(tagged[w] | empty_shards_[w]);
+    }
+    if (any_tagged != 0 && missing == 0) {
       ++num_complete_domains;
     }
   }
@@ -410,12 +431,13 @@ void FailureDomainNodeSet<AttrType, HashFn>::resetAttributeCounters() {
   forEachScope([](ScopeState& scope) {
     scope.n_full.clear();
     scope.replicate_set.clear();
-    for (auto& it_fd : scope.domains) {
-      it_fd.second.shards_attr.clear();
+    for (FailureDomainState& fd : scope.domains) {
+      fd.shards_attr.clear();
     }
   });
   shard_attribute_.clear();
   attribute_count_.clear();
+  attr_shards_.clear();
 }
 
 template <typename AttrType, typename HashFn>
@@ -525,6 +547,23 @@ void FailureDomainNodeSet<AttrType, HashFn>::checkConsistency() const {
   for (auto it = scopes_.begin(); it != scopes_.end(); ++it) {
     checkConsistencyAtScope(it->second);
   };
+
+  // The bitsets must agree with the maps.
+  auto bit = [](const ShardBitset& bits, size_t idx) {
+    return (bits[idx / 64] >> (idx % 64)) & 1;
+  };
+  for (const auto& kv : shard_index_) {
+    const AuthoritativeStatus status = shard_authoritative_.at(kv.first);
+    ld_check(bit(fully_shards_, kv.second) == isFully(status));
+    ld_check(bit(empty_shards_, kv.second) ==
+             (status == AuthoritativeStatus::AUTHORITATIVE_EMPTY));
+    auto it_attr = shard_attribute_.find(kv.first);
+    for (const auto& attr_kv : attr_shards_) {
+      ld_check(bit(attr_kv.second, kv.second) ==
+               (it_attr != shard_attribute_.end() &&
+                it_attr->second == attr_kv.first));
+    }
+  }
 }
 
 template <typename AttrType, typename HashFn>
@@ -7,8 +7,50 @@
  */
 #include "logdevice/common/FailureDomainNodeSet.h"
 
+#include <folly/hash/Hash.h>
+
+#include "logdevice/common/Worker.h"
+
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// Layouts cached by a Worker thread for its current NodesConfiguration.
+struct LayoutCache {
+  struct Key {
+    StorageSet storage_set;
+    ReplicationProperty replication;
+    bool operator==(const Key& rhs) const {
+      return storage_set == rhs.storage_set && replication == rhs.replication;
+    }
+  };
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      size_t h = folly::hash::hash_range(
+          key.storage_set.begin(), key.storage_set.end(), 0, ShardID::Hash());
+      for (const auto& scope :
+           key.replication.getDistinctReplicationFactors()) {
+        h = folly::hash::hash_combine(
+            h, static_cast<int>(scope.first), scope.second);
+      }
+      return h;
+    }
+  };
+
+  // Dropped when exceeded. Layouts are small, this only bounds the memory
+  // used if storage sets keep changing.
+  static constexpr size_t kMaxEntries = 4096;
+
+  // Holding the NodesConfiguration guarantees that a different one can't be
+  // allocated at the same address while the cache refers to it.
+  std::shared_ptr<const configuration::nodes::NodesConfiguration>
+      nodes_configuration;
+  folly::F14NodeMap<Key, std::shared_ptr<const FailureDomainLayout>, KeyHasher>
+      map;
+};
+
+} // namespace
+
 const char* fmajorityResultString(FmajorityResult result) {
   switch (result) {
     case FmajorityResult::NONE:
@@ -25,4 +67,97 @@ const char* fmajorityResultString(FmajorityResult result) {
   }
 }
 
+std::shared_ptr<const FailureDomainLayout> FailureDomainLayout::compute(
+    const StorageSet& storage_set,
+    const configuration::nodes::NodesConfiguration& nodes_configuration,
+    const ReplicationProperty& rep) {
+  auto layout = std::make_shared<FailureDomainLayout>();
+
+  auto scope = NodeLocation::nextSmallerScope(NodeLocationScope::ROOT);
+  while (scope != NodeLocationScope::INVALID) {
+    size_t replication = rep.getReplication(scope);
+    // Do not consider the scope if the user did not specify a replication
+    // factor for it, or if the replication factor for it is <= than the
+    // replication factor at larger scopes.
+    if (replication != 0 && replication > layout->shard_replication) {
+      layout->scopes.push_back(Scope{scope, replication, 0, {}});
+      layout->shard_replication = replication;
+    }
+    scope = NodeLocation::nextSmallerScope(scope);
+  }
+
+  // only include storage shards in nodes configuration and in reader's view
+  // (e.g., exclude shards in "none" state)
+  layout->shards =
+      nodes_configuration.getStorageMembership()->readerView(storage_set);
+
+  for (Scope& layout_scope : layout->scopes) {
+    const NodeLocationScope sc = layout_scope.scope;
+    folly::F14FastMap<std::string, int> domain_idx;
+    layout_scope.shard_domains.reserve(layout->shards.size());
+    for (const ShardID shard : layout->shards) {
+      const auto* service_disc =
+          nodes_configuration.getNodeServiceDiscovery(shard.node());
+      // shard came from the membership reader view of the node configuration
+      ld_check(service_disc != nullptr);
+
+      std::string domain_name;
+      if (sc == NodeLocationScope::NODE) {
+        domain_name = std::to_string(shard.node());
+      } else if (!service_disc->location.hasValue() ||
+                 !service_disc->location.value().scopeSpecified(sc)) {
+        ld_error("Node %d (%s) in the storage_set does not have location "
+                 "information in location scope: %s.",
+                 shard.node(),
+                 service_disc->address.toString().c_str(),
+                 NodeLocation::scopeNames()[sc].c_str());
+        layout_scope.shard_domains.push_back(-1);
+        continue;
+      } else {
+        domain_name = service_disc->location.value().getDomain(sc);
+      }
+
+      const int next_idx = static_cast<int>(domain_idx.size());
+      auto ins = domain_idx.emplace(std::move(domain_name), next_idx);
+      layout_scope.shard_domains.push_back(ins.first->second);
+    }
+    layout_scope.num_domains = domain_idx.size();
+  }
+
+  return layout;
+}
+
+std::shared_ptr<const FailureDomainLayout> FailureDomainLayout::get(
+    const StorageSet& storage_set,
+    const configuration::nodes::NodesConfiguration& nodes_configuration,
+    const ReplicationProperty& rep) {
+  static thread_local LayoutCache cache;
+
+  Worker* w = Worker::onThisThread(false);
+  if (!w) {
+    return compute(storage_set, nodes_configuration, rep);
+  }
+  if (cache.nodes_configuration.get() != &nodes_configuration) {
+    auto current = w->getNodesConfiguration();
+    if (current.get() != &nodes_configuration) {
+      // Not the Worker's current config, e.g. one that was just replaced.
+      return compute(storage_set, nodes_configuration, rep);
+    }
+    cache.nodes_configuration = std::move(current);
+    cache.map.clear();
+  }
+
+  LayoutCache::Key key{storage_set, rep};
+  auto it = cache.map.find(key);
+  if (it != cache.map.end()) {
+    return it->second;
+  }
+  if (cache.map.size() >= LayoutCache::kMaxEntries) {
+    cache.map.clear();
+  }
+  auto layout = compute(storage_set, nodes_configuration, rep);
+  cache.map.emplace(std::move(key), layout);
+  return layout;
+}
+
 }} // namespace facebook::logdevice
@@ -9,9 +9,13 @@
 
 #include <algorithm>
 #include <array>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <folly/container/F14Map.h>
+#include <folly/lang/Bits.h>
+#include <folly/small_vector.h>
 
 #include "logdevice/common/AuthoritativeStatus.h"
 #include "logdevice/common/EpochMetaData.h"
@@ -94,7 +98,10 @@ namespace facebook { namespace logdevice {
  * - Changing the authoritative status of a shard consists of a number of
  *   operations equal to the number of replication scopes times the number of
  *   different values for the attribute currently in use;
- * - isFmajority is linear to the number of replication scopes;
+ * - isFmajority is linear to the number of replication scopes when used with
+ *   an attribute value. When used with an attribute predicate, it is
+ *   O(num domains * num shards / 64) per scope: the shards are also tracked
+ *   in dense bitsets so that domains can be checked a word at a time;
  * - canReplicate is linear to the number of replication scopes when used with
  *   an attribute value, or O(num attrs * replication * num scopes) in the worst
  *   case if used with an attribute predicate.
@@ -126,6 +133,49 @@ enum class FmajorityResult {
 
 const char* fmajorityResultString(FmajorityResult result);
 
+/**
+ * Failure domains of the shards of a storage set at the scopes of a
+ * replication property: all that FailureDomainNodeSet needs from the nodes
+ * configuration. Computing it looks up the location of the node of every
+ * shard and hashes domain names, which adds up when a FailureDomainNodeSet is
+ * created for every recovery, read stream or request, so get() caches it.
+ */
+struct FailureDomainLayout {
+  struct Scope {
+    NodeLocationScope scope;
+    size_t replication;
+    size_t num_domains;
+    // For each shard in `shards`, index of its domain at this scope, or -1 if
+    // its node doesn't have location information at this scope.
+    std::vector<int> shard_domains;
+  };
+
+  // Shards of the storage set that are in the reader view of the storage
+  // membership.
+  StorageSet shards;
+  // Scopes with a replication requirement, from the biggest to the smallest.
+  // Scopes whose replication factor isn't greater than the one of a bigger
+  // scope are omitted.
+  std::vector<Scope> scopes;
+  // Replication factor at the implicit SHARD scope.
+  size_t shard_replication{0};
+
+  static std::shared_ptr<const FailureDomainLayout>
+  compute(const StorageSet& storage_set,
+          const configuration::nodes::NodesConfiguration& nodes_configuration,
+          const ReplicationProperty& rep);
+
+  /**
+   * Same as compute(), but if called on a Worker with the Worker's current
+   * nodes configuration, the layout is cached on that Worker until the nodes
+   * configuration changes.
+   */
+  static std::shared_ptr<const FailureDomainLayout>
+  get(const StorageSet& storage_set,
+      const configuration::nodes::NodesConfiguration& nodes_configuration,
+      const ReplicationProperty& rep);
+};
+
 template <typename AttrType, typename HashFn = std::hash<AttrType>>
 class FailureDomainNodeSet {
  public:
@@ -283,10 +333,15 @@ class FailureDomainNodeSet {
     folly::F14FastMap<AttrType, Count, HashFn> shards_attr;
   };
 
+  // Set of shards, with bit i standing for the shard at position i in
+  // FailureDomainLayout::shards. Inline up to 256 shards.
+  using ShardBitset = folly::small_vector<uint64_t, 4>;
+
   // Aggregated data for all domains at the same scope.
   struct ScopeState {
-    // The domains at that scope.
-    folly::F14NodeMap<std::string, FailureDomainState> domains;
+    // The domains at that scope, indexed as in FailureDomainLayout. Never
+    // resized after construction, shard_map points into it.
+    std::vector<FailureDomainState> domains;
     // A mapping between a shard and the domain it belongs to at that scope for
     // fast lookup.
     folly::F14FastMap<ShardID, FailureDomainState*, ShardID::Hash> shard_map;
@@ -302,6 +357,9 @@ class FailureDomainNodeSet {
     // we can replicate at each scope.
     using FDSet = std::unordered_set<const FailureDomainState*>;
     folly::F14FastMap<AttrType, FDSet, HashFn> replicate_set;
+    // Shards of each domain, in the same order as `domains`. Left empty for
+    // the SHARD scope, where each domain is a single shard.
+    std::vector<ShardBitset> domain_shards;
   };
 
   struct ScopeHash {
@@ -344,6 +402,16 @@ class FailureDomainNodeSet {
 
   folly::F14FastMap<AttrType, size_t, HashFn> attribute_count_;
 
+  // Position of each shard in the bitsets below.
+  folly::F14FastMap<ShardID, size_t, ShardID::Hash> shard_index_;
+  // For each attribute, shards tagged with it. Entries are not erased when
+  // they become empty, there are only a handful of attribute values in use.
+  folly::F14FastMap<AttrType, ShardBitset, HashFn> attr_shards_;
+  // Shards that are FULLY_AUTHORITATIVE or UNAVAILABLE, see isFully().
+  ShardBitset fully_shards_;
+  // Shards that are AUTHORITATIVE_EMPTY.
+  ShardBitset empty_shards_;
+
   // For performance, even in debug builds, checkConsistency() is not called
   // every time in setShardAttribute() or setShardAuthoritativeStatus(); this
   // counter is used for deciding when to call it
@@ -355,9 +423,8 @@ class FailureDomainNodeSet {
         st == AuthoritativeStatus::UNAVAILABLE;
   }
 
-  void
-  addShard(ShardID shard,
-           const configuration::nodes::NodesConfiguration& nodes_configuration);
+  // Adds the shard at position @param idx in @param layout.
+  void addShard(const FailureDomainLayout& layout, size_t idx);
 
   // Untag a shard with an attribute. Status is the current authoritative status
   // of that shard.
@@ -375,12 +442,24 @@ class FailureDomainNodeSet {
 
   // Count the number of domains at a scope that have all their shards with the
   // attribute(s).
-  // Note: the predicate version has a complexity of O(N_attrs * N_domains),
-  // while
-  //       the attr version's complexity is O(N_attrs)
+  // Note: the predicate version has a complexity of
+  //       O(N_attrs * N_shards / 64 + N_domains * N_shards / 64), while the
+  //       attr version's complexity is O(1).
   size_t countCompleteDomains(attr_pred_t pred, const ScopeState& scope) const;
   size_t countCompleteDomains(AttrType attr, const ScopeState& scope) const;
 
+  // Fully authoritative shards whose attribute satisfies _pred_.
+  ShardBitset fullyTaggedShards(attr_pred_t pred) const;
+
+  static void setBit(ShardBitset& bits, size_t idx, bool value) {
+    const uint64_t mask = uint64_t(1) << (idx % 64);
+    if (value) {
+      bits[idx / 64] |= mask;
+    } else {
+      bits[idx / 64] &= ~mask;
+    }
+  }
+
   // Check if a domain is complete (all non empty shards are tagged with the
   // value).
   bool domainIsComplete(FailureDomainState& fd, AttrType attr) const;
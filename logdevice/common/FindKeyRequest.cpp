@@ -44,9 +44,8 @@ Request::Execution FindKeyRequest::execute() {
     return Execution::COMPLETE;
   }
 
-  client_timeout_timer_ =
-      std::make_unique<Timer>([this] { this->onClientTimeout(); });
-  client_timeout_timer_->activate(client_timeout_);
+  client_timeout_timer_.assign([this] { this->onClientTimeout(); });
+  client_timeout_timer_.activate(client_timeout_);
 
   auto insert_result = Worker::onThisThread()->runningFindKey().map.insert(
       std::make_pair(id_, std::unique_ptr<FindKeyRequest>(this)));
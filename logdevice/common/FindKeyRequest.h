@@ -226,7 +226,7 @@ class FindKeyRequest : public DistributedRequest,
   const FindKeyAccuracy accuracy_;
 
   std::chrono::milliseconds running_timer_timeout_;
-  std::unique_ptr<Timer> client_timeout_timer_;
+  Timer client_timeout_timer_;
   std::chrono::time_point<std::chrono::steady_clock> client_timer_expiry_;
 
   // Result range.  Initially (0, LSN_MAX].  As storage nodes reply to our
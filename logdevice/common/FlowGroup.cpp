@@ -58,6 +58,9 @@ bool FlowGroup::applyUpdate(FlowGroupsUpdate::GroupEntry& update,
   Priority p = Priority::MAX;
   for (auto& entry : update.overflow_entries) {
     auto priorityq_was_blocked = !meter_it->canDrain() && !priorityq_.empty();
+    if (p != Priority::INVALID && !priorityq_.empty(p)) {
+      update.backlogged[asInt(p)] = true;
+    }
 
     meter_it->setCapacity(policy_it->capacity);
     meter_it->resetDepositBudget(policy_it->max_bw);
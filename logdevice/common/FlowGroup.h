@@ -122,6 +122,11 @@ class FlowGroupsUpdate {
     FlowGroupPolicy policy;
     std::array<OverflowEntry, asInt(Priority::NUM_PRIORITIES) + 1>
         overflow_entries;
+
+    // Set by FlowGroup::applyUpdate() for priorities that have messages
+    // waiting for bandwidth in at least one Sender. Cleared by the
+    // TrafficShaper, see AdaptiveFlowGroupPolicy.
+    std::array<bool, asInt(Priority::NUM_PRIORITIES)> backlogged{};
   };
 
   std::vector<GroupEntry> group_entries;
@@ -266,6 +266,14 @@ bool GetClusterStateRequest::onReply(
   ld_debug("Received GET_CLUSTER_STATE_REPLY message from Node %s",
            Sender::describeConnection(from).c_str());
 
+  if (!getSettings().server && getSettings().enable_cluster_state_push &&
+      !from.isClientAddress()) {
+    ClusterState* cs = getClusterState();
+    if (cs) {
+      cs->subscribeToPushes(from.asNodeID());
+    }
+  }
+
   // finish and destroy request
   return done(E::OK, std::move(nodes_state), std::move(boycotted_nodes));
 }
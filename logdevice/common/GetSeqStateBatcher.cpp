@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/GetSeqStateBatcher.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_GET_SEQ_STATE_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+GetSeqStateBatcher::GetSeqStateBatcher() = default;
+
+GetSeqStateBatcher::~GetSeqStateBatcher() = default;
+
+bool GetSeqStateBatcher::add(std::unique_ptr<GET_SEQ_STATE_Message>& msg,
+                             NodeID to) {
+  ld_check(msg);
+  const Settings& settings = Worker::settings();
+  if (settings.seq_state_batching_window.count() <= 0) {
+    return false;
+  }
+
+  folly::Optional<uint16_t> proto =
+      Worker::onThisThread()->sender().getSocketProtocolVersion(to.index());
+  if (!proto.hasValue() ||
+      proto.value() < Compatibility::MULTI_GET_SEQ_STATE_SUPPORT) {
+    return false;
+  }
+
+  Batch& batch = batches_[to.index()];
+  batch.to = to;
+  batch.requests.push_back(std::move(msg));
+  ++num_pending_;
+
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (batch.requests.size() >= settings.seq_state_batching_max_requests) {
+    // Send on the next event loop iteration.
+    timer_.activate(std::chrono::microseconds::zero());
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.seq_state_batching_window);
+  }
+  return true;
+}
+
+void GetSeqStateBatcher::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  num_pending_ = 0;
+  for (auto& kv : batches) {
+    send(std::move(kv.second));
+  }
+}
+
+void GetSeqStateBatcher::send(Batch batch) {
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+  auto& requests = batch.requests;
+  ld_check(!requests.empty());
+
+  if (requests.size() == 1) {
+    std::unique_ptr<GET_SEQ_STATE_Message> msg = std::move(requests.front());
+    if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+      // sendMessage() doesn't consume the message on failure
+      msg->onSent(err, to);
+    }
+    return;
+  }
+
+  const size_t num_requests = requests.size();
+  auto msg = std::make_unique<MULTI_GET_SEQ_STATE_Message>(std::move(requests));
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_GET_SEQ_STATE with %zu requests to "
+                   "%s: %s",
+                   num_requests,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    msg->onSent(st, to);
+    return;
+  }
+
+  STAT_INCR(Worker::stats(), seq_state_batches_sent);
+  STAT_ADD(Worker::stats(), seq_state_batched_requests_sent, num_requests);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/GET_SEQ_STATE_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-Worker coalescing of GET_SEQ_STATE messages headed to the same
+ *       sequencer node. When --seq-state-batching-window is nonzero,
+ *       GET_SEQ_STATEs of batchable GetSeqStateRequests (currently the ones
+ *       issued by RebuildingPlanner, which asks for the state of every log on
+ *       a rebuilding shard) sent within the window to a node whose connection
+ *       supports MULTI_GET_SEQ_STATE are held back and then sent together in
+ *       one MULTI_GET_SEQ_STATE_Message (or as a plain GET_SEQ_STATE if
+ *       there's only one).
+ *
+ *       As with SealBatcher, batches are only sent from the timer callback,
+ *       so that send failures reported to GetSeqStateRequests don't reenter
+ *       them while they are sending.
+ */
+
+class GetSeqStateBatcher {
+ public:
+  GetSeqStateBatcher();
+  ~GetSeqStateBatcher();
+
+  GetSeqStateBatcher(const GetSeqStateBatcher&) = delete;
+  GetSeqStateBatcher& operator=(const GetSeqStateBatcher&) = delete;
+
+  /**
+   * Takes a GET_SEQ_STATE that a GetSeqStateRequest wants to send to `to`,
+   * if it can be batched.
+   *
+   * The outcome of sending the message, including errors returned by
+   * Sender::sendMessage() when the batch is sent, is reported through
+   * GET_SEQ_STATE_Message::onSent().
+   *
+   * @return  true if `msg` was taken. false if batching is disabled or `to`
+   *          hasn't negotiated a protocol with MULTI_GET_SEQ_STATE support
+   *          yet; `msg` is left untouched and the caller should send it
+   *          directly.
+   */
+  bool add(std::unique_ptr<GET_SEQ_STATE_Message>& msg, NodeID to);
+
+  // Number of GET_SEQ_STATEs waiting to be sent.
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  struct Batch {
+    NodeID to;
+    std::vector<std::unique_ptr<GET_SEQ_STATE_Message>> requests;
+  };
+
+  // Sends all pending batches.
+  void flush();
+
+  void send(Batch batch);
+
+  std::unordered_map<node_index_t, Batch> batches_;
+  size_t num_pending_ = 0;
+
+  // Fires when the oldest pending GET_SEQ_STATE has waited for
+  // --seq-state-batching-window, or right away if a batch grew too big.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
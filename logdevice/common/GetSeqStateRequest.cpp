@@ -9,6 +9,7 @@
 #include "logdevice/common/GetSeqStateRequest.h"
 
 #include "logdevice/common/EpochMetaDataMap.h"
+#include "logdevice/common/GetSeqStateBatcher.h"
 #include "logdevice/common/NodeID.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
@@ -259,7 +260,7 @@ void GetSeqStateRequest::onReply(NodeID from,
   if (status_ == E::AGAIN) {
     // if E::AGAIN, exponential backoff timer will resend the request to the
     // same node if timer hasn't expired. Timer doesn't need to be reset.
-    backoff_timer_->activate();
+    getBackoffTimer().activate();
     return;
   }
 
@@ -444,6 +445,12 @@ void GetSeqStateRequest::onSequencerKnown(NodeID dest,
    * deactivate the callback to prevent the assert in Sender(t11848669).
    */
   on_bw_avail_cb_.deactivate();
+  if (isBatchable() && w->getSeqStateBatcher().add(msg, dest_)) {
+    // Will be sent shortly, together with other GET_SEQ_STATEs to the same
+    // node. Send errors are reported through onSent().
+    activateReplyTimer();
+    return;
+  }
   int rv = w->sender().sendMessage(std::move(msg), dest_, &on_bw_avail_cb_);
   if (rv != 0) {
     ld_debug("Failed to queue GET_SEQ_STATE message for log %lu for sending "
@@ -460,7 +467,7 @@ void GetSeqStateRequest::onSequencerKnown(NodeID dest,
               log_id_.val_,
               dest_.toString().c_str(),
               error_description(err));
-      ld_check(!backoff_timer_->isActive());
+      ld_check(!backoff_timer_ || !backoff_timer_->isActive());
       ld_check(!reply_timer_.isActive());
     } else {
       finalize();
@@ -575,12 +582,16 @@ void GetSeqStateRequest::setupTimers() {
   reply_timer_.assign(on_reply_timeout);
   // reply_timer_ is activated after sending a message
 
-  // setting up exponential backoff timer
-  backoff_timer_ = std::make_unique<ExponentialBackoffTimer>(
-      std::function<void()>(), Worker::settings().seq_state_backoff_time);
-  ld_check(backoff_timer_ != nullptr);
-  backoff_timer_->setCallback(
-      std::bind(&GetSeqStateRequest::retrySending, this));
+  // backoff_timer_ is created by getBackoffTimer() the first time a
+  // sequencer replies with E::AGAIN
+}
+
+ExponentialBackoffTimer& GetSeqStateRequest::getBackoffTimer() {
+  if (!backoff_timer_) {
+    backoff_timer_ = std::make_unique<ExponentialBackoffTimer>(
+        [this] { retrySending(); }, Worker::settings().seq_state_backoff_time);
+  }
+  return *backoff_timer_;
 }
 
 void GetSeqStateRequest::activateReplyTimer() {
@@ -594,15 +605,19 @@ void GetSeqStateRequest::cancelReplyTimer() {
 }
 
 void GetSeqStateRequest::cancelBackoffTimer() {
-  backoff_timer_->cancel();
+  if (backoff_timer_) {
+    backoff_timer_->cancel();
+  }
 }
 
 void GetSeqStateRequest::resetBackoffTimer() {
-  backoff_timer_->reset();
+  if (backoff_timer_) {
+    backoff_timer_->reset();
+  }
 }
 
 void GetSeqStateRequest::destroy() {
-  backoff_timer_->cancel();
+  cancelBackoffTimer();
 
   // destroy this GetSeqStateRequest object
   auto& requestMap = Worker::onThisThread()->runningGetSeqState();
@@ -286,6 +286,8 @@ class GetSeqStateRequest : public Request, public SequencerRouter::Handler {
   virtual void setupTimers();
   virtual void cancelBackoffTimer();
   virtual void resetBackoffTimer();
+  // Creates backoff_timer_ if needed.
+  ExponentialBackoffTimer& getBackoffTimer();
 
   // Decide if `this` request is allowed to execute
   // or an existing request should continue execution.
@@ -312,6 +314,13 @@ class GetSeqStateRequest : public Request, public SequencerRouter::Handler {
   //   false - if no merging happened.
   bool mergeRequest();
 
+  // Whether GET_SEQ_STATE messages of this request may be held back by the
+  // Worker's GetSeqStateBatcher. Only true for background requests issued
+  // for many logs at once, where a few milliseconds of delay don't matter.
+  bool isBatchable() const {
+    return ctx_ == Context::REBUILDING_PLANNER;
+  }
+
   virtual void activateReplyTimer();
   virtual void cancelReplyTimer();
   virtual void destroy();
@@ -329,7 +338,8 @@ class GetSeqStateRequest : public Request, public SequencerRouter::Handler {
   // Timer used to retry GET_SEQ_STATE request if sequencer bringup is
   // in progress. As long as the sequencer node replies with E:AGAIN until
   // timeout, this timer is not reset. Once max time limit is reached,
-  // another node will be picked.
+  // another node will be picked. Only created once a sequencer replies with
+  // E::AGAIN, which few requests see.
   std::unique_ptr<ExponentialBackoffTimer> backoff_timer_{nullptr};
 
   // flags used to resend message to last node.
@@ -10,6 +10,7 @@
 #include <folly/Memory.h>
 
 #include "logdevice/common/EventLoop.h"
+#include "logdevice/common/LogQueryBatcher.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -266,8 +267,14 @@ StorageSetAccessor::SendResult IsLogEmptyRequest::sendTo(ShardID shard) {
 
   NodeID to(shard.node());
   IS_LOG_EMPTY_Header header = {id_, log_id_, shard.shard()};
+  Worker* w = Worker::onThisThread();
+  if (batchable_ && w->logQueryBatcher().add(header, to)) {
+    // Will be sent shortly, together with other queries to the same node.
+    // Send errors are reported through onMessageSent().
+    return {StorageSetAccessor::Result::SUCCESS, E::OK};
+  }
   auto msg = std::make_unique<IS_LOG_EMPTY_Message>(header);
-  if (Worker::onThisThread()->sender().sendMessage(std::move(msg), to) != 0) {
+  if (w->sender().sendMessage(std::move(msg), to) != 0) {
     if (err == E::PROTONOSUPPORT) {
       RATELIMIT_ERROR(std::chrono::seconds(1),
                       10,
@@ -130,6 +130,15 @@ class IsLogEmptyRequest : public DistributedRequest,
   void setWorkerThread(worker_id_t worker) {
     worker_ = worker;
   }
+
+  /**
+   * Allows the IS_LOG_EMPTYs of this request to be held for up to
+   * --log-query-batching-window and sent together with those of other
+   * batchable requests on the same Worker. Used by Client::isLogEmptyBatch().
+   */
+  void setBatchable() {
+    batchable_ = true;
+  }
   int getThreadAffinity(int /*nthreads*/) override {
     return worker_.val_;
   }
@@ -240,6 +249,7 @@ class IsLogEmptyRequest : public DistributedRequest,
   const std::chrono::milliseconds grace_period_;
 
   worker_id_t worker_ = worker_id_t(-1);
+  bool batchable_ = false;
   std::unique_ptr<NodeSetFinder> nodeset_finder_{nullptr};
 
   static bool node_empty_filter(shard_status_t val) {
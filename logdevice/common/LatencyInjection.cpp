@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/LatencyInjection.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <folly/Format.h>
+#include <folly/Random.h>
+#include <folly/Singleton.h>
+#include <folly/hash/Hash.h>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+static folly::LeakySingleton<MessageLatencyInjection> messageLatencyInjection;
+
+// Uniform in [0, 1).
+double uniform01(uint64_t seed, uint64_t n) {
+  if (seed == 0) {
+    return folly::Random::randDouble01();
+  }
+  // Golden ratio increment, so that consecutive indexes are far apart before
+  // mixing.
+  uint64_t bits = folly::hash::twang_mix64(seed + n * 0x9e3779b97f4a7c15ull);
+  return (bits >> 11) * (1.0 / (1ull << 53));
+}
+
+} // namespace
+
+std::chrono::milliseconds LatencyDistribution::sample(uint64_t n) const {
+  using std::chrono::milliseconds;
+  switch (type_) {
+    case Type::FIXED:
+      return latency_;
+    case Type::UNIFORM: {
+      if (max_latency_ <= latency_) {
+        return latency_;
+      }
+      double span = (max_latency_ - latency_).count() + 1;
+      auto offset = static_cast<int64_t>(uniform01(seed_, n) * span);
+      return latency_ + milliseconds(offset);
+    }
+    case Type::EXPONENTIAL: {
+      double value = -latency_.count() * std::log1p(-uniform01(seed_, n));
+      auto res = milliseconds(static_cast<int64_t>(std::llround(value)));
+      return max_latency_.count() > 0 ? std::min(res, max_latency_) : res;
+    }
+  }
+  ld_check(false);
+  return latency_;
+}
+
+std::string LatencyDistribution::toString() const {
+  switch (type_) {
+    case Type::FIXED:
+      return folly::sformat("fixed({}ms)", latency_.count());
+    case Type::UNIFORM:
+      return folly::sformat("uniform({}ms..{}ms, seed={})",
+                            latency_.count(),
+                            max_latency_.count(),
+                            seed_);
+    case Type::EXPONENTIAL:
+      return folly::sformat("exponential(mean={}ms, max={}ms, seed={})",
+                            latency_.count(),
+                            max_latency_.count(),
+                            seed_);
+  }
+  return "invalid";
+}
+
+folly::Optional<LatencyDistribution::Type>
+LatencyDistribution::parseType(const std::string& name) {
+  if (name == "fixed") {
+    return Type::FIXED;
+  }
+  if (name == "uniform") {
+    return Type::UNIFORM;
+  }
+  if (name == "exponential") {
+    return Type::EXPONENTIAL;
+  }
+  return folly::none;
+}
+
+MessageLatencyInjection& MessageLatencyInjection::instance() {
+  return messageLatencyInjection.get();
+}
+
+void MessageLatencyInjection::set(folly::Optional<MessageType> type,
+                                  LatencyDistribution distribution,
+                                  double percent_chance) {
+  Entry entry;
+  if (!distribution.zero()) {
+    entry.distribution = distribution;
+    entry.chance =
+        std::min((double)UINT32_MAX, percent_chance / 100 * UINT32_MAX);
+  }
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (!type.hasValue() || static_cast<size_t>(type.value()) == i) {
+      *entries_[i].wlock() = entry;
+    }
+  }
+  // Keep the fast path enabled as long as any type has injection on.
+  bool enabled = false;
+  for (auto& e : entries_) {
+    enabled |= e.rlock()->chance > 0;
+  }
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void MessageLatencyInjection::clear() {
+  set(folly::none, LatencyDistribution(), 0);
+}
+
+std::chrono::milliseconds
+MessageLatencyInjection::getLatencyToInject(MessageType type) {
+  if (!enabled_.load(std::memory_order_relaxed)) {
+    return std::chrono::milliseconds(0);
+  }
+  const size_t idx = static_cast<size_t>(type);
+  if (idx >= entries_.size()) {
+    return std::chrono::milliseconds(0);
+  }
+  auto entry = entries_[idx].rlock();
+  if (entry->chance == 0 ||
+      (entry->chance != UINT32_MAX &&
+       folly::Random::rand32() >= entry->chance)) {
+    return std::chrono::milliseconds(0);
+  }
+  return entry->distribution.sample(
+      samples_.fetch_add(1, std::memory_order_relaxed));
+}
+
+std::vector<std::pair<MessageType, std::string>>
+MessageLatencyInjection::describe() {
+  std::vector<std::pair<MessageType, std::string>> res;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    auto entry = entries_[i].rlock();
+    if (entry->chance > 0) {
+      res.emplace_back(static_cast<MessageType>(i),
+                       folly::sformat("{} chance={:.2f}%",
+                                      entry->distribution.toString(),
+                                      entry->chance * 100.0 / UINT32_MAX));
+    }
+  }
+  return res;
+}
+
+}} // namespace facebook::logdevice
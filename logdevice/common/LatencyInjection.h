@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <folly/Optional.h>
+#include <folly/Synchronized.h>
+
+#include "logdevice/common/protocol/MessageType.h"
+
+/**
+ * @file Latency injection for simulating slow nodes in tests and benchmarks.
+ *
+ *       LatencyDistribution describes how long to delay an operation.
+ *       IOFaultInjection (server) uses it to delay storage tasks on a shard,
+ *       MessageLatencyInjection below to delay messages of a given type before
+ *       Socket writes them out. Both are configured with the "inject" admin
+ *       commands.
+ */
+
+namespace facebook { namespace logdevice {
+
+class LatencyDistribution {
+ public:
+  enum class Type : uint8_t {
+    // Always `latency'.
+    FIXED,
+    // Uniform between `latency' and `max_latency'.
+    UNIFORM,
+    // Exponential with mean `latency', capped at `max_latency' unless zero.
+    // Approximates the long tail of a struggling disk or network.
+    EXPONENTIAL,
+  };
+
+  LatencyDistribution() {}
+
+  explicit LatencyDistribution(
+      std::chrono::milliseconds latency,
+      Type type = Type::FIXED,
+      std::chrono::milliseconds max_latency = std::chrono::milliseconds(0),
+      uint64_t seed = 0)
+      : type_(type),
+        latency_(latency),
+        max_latency_(max_latency),
+        seed_(seed) {}
+
+  /**
+   * @param n  index of the sample. With a nonzero seed the n-th sample only
+   *           depends on the seed and n, so that a run can be reproduced.
+   *           With seed 0 samples are random.
+   */
+  std::chrono::milliseconds sample(uint64_t n) const;
+
+  // True if sample() always returns 0.
+  bool zero() const {
+    return latency_.count() == 0 &&
+        (type_ != Type::UNIFORM || max_latency_.count() == 0);
+  }
+
+  Type type() const {
+    return type_;
+  }
+  std::chrono::milliseconds latency() const {
+    return latency_;
+  }
+  std::chrono::milliseconds maxLatency() const {
+    return max_latency_;
+  }
+  uint64_t seed() const {
+    return seed_;
+  }
+
+  // E.g. "exponential(mean=5ms, max=100ms, seed=1)".
+  std::string toString() const;
+
+  // Parses "fixed", "uniform" or "exponential".
+  static folly::Optional<Type> parseType(const std::string& name);
+
+ private:
+  Type type_{Type::FIXED};
+  std::chrono::milliseconds latency_{0};
+  std::chrono::milliseconds max_latency_{0};
+  uint64_t seed_{0};
+};
+
+/**
+ * Process-wide configuration of latency injected into message sends, per
+ * message type. Socket::send() asks for the latency of every message and
+ * holds messages back (preserving their order) until it passes. Handshake
+ * messages are never delayed.
+ */
+class MessageLatencyInjection {
+ public:
+  static MessageLatencyInjection& instance();
+
+  /**
+   * Delays messages of type `type', or of all types if folly::none, by a
+   * sample of `distribution' with probability `percent_chance'. A zero
+   * distribution turns injection off for these types.
+   */
+  void set(folly::Optional<MessageType> type,
+           LatencyDistribution distribution,
+           double percent_chance);
+
+  // Turns injection off for all message types.
+  void clear();
+
+  /**
+   * @return how long to hold back a message of type `type' before sending
+   *         it, usually 0.
+   */
+  std::chrono::milliseconds getLatencyToInject(MessageType type);
+
+  /**
+   * @return types with injection enabled and their distributions, for
+   *         admin commands.
+   */
+  std::vector<std::pair<MessageType, std::string>> describe();
+
+ private:
+  struct Entry {
+    LatencyDistribution distribution;
+    // Out of UINT32_MAX, as in IOFaultInjection.
+    uint32_t chance{0};
+  };
+
+  std::array<folly::Synchronized<Entry>, static_cast<size_t>(MessageType::MAX)>
+      entries_;
+  // Fast path when nothing is injected, which is almost always.
+  std::atomic<bool> enabled_{false};
+  // Index of the next sample, see LatencyDistribution::sample().
+  std::atomic<uint64_t> samples_{0};
+};
+
+}} // namespace facebook::logdevice
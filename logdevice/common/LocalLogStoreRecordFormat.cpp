@@ -29,6 +29,54 @@ constexpr size_t minLogStoreBlobSize() {
       sizeof(copyset_size_t);
 }
 
+// Offsets of the fixed part of v2 record headers, see FLAG_FORMAT_V2.
+constexpr size_t V2_FLAGS_OFFSET = sizeof(uint64_t) + sizeof(esn_t);
+constexpr size_t V2_FLAGS_SIZE = 4;
+constexpr size_t V2_WAVE_OFFSET = V2_FLAGS_OFFSET + V2_FLAGS_SIZE;
+constexpr size_t V2_COPYSET_SIZE_OFFSET = V2_WAVE_OFFSET + sizeof(uint32_t);
+constexpr size_t V2_COPYSET_OFFSET =
+    V2_COPYSET_SIZE_OFFSET + sizeof(copyset_size_t);
+
+static_assert(FLAG_FORMAT_V2 < (1u << 7 * V2_FLAGS_SIZE),
+              "v2 flags must fit in a 4-byte varint");
+
+// For a bitmask `mask` with exactly one one-bit, tests that `varint` has that
+// bit set to one.
+inline bool testVarInt(const uint8_t* varint, size_t mask) {
+  ld_assert(mask != 0 && (mask & (mask - 1)) == 0); // mask is a power of two
+  constexpr uint8_t ADDITIONAL_OCTETS_MASK = 1ul << 7;
+  const uint8_t* cur_octet = varint;
+  for (; mask > 127; mask >>= 7, ++cur_octet) {
+    if ((*cur_octet & ADDITIONAL_OCTETS_MASK) == 0) {
+      return false;
+    }
+  }
+  return (*cur_octet & mask) != 0;
+}
+
+// Records in the original format can't have FLAG_FORMAT_V2 set, and are
+// long enough for this check if their flags take 4 bytes.
+inline bool isFormatV2(const Slice& log_store_blob) {
+  return log_store_blob.size >= V2_FLAGS_OFFSET + V2_FLAGS_SIZE &&
+      testVarInt(reinterpret_cast<const uint8_t*>(log_store_blob.data) +
+                     V2_FLAGS_OFFSET,
+                 FLAG_FORMAT_V2);
+}
+
+// Flags of v2 records are a varint padded to V2_FLAGS_SIZE bytes, which
+// decodes the same way as the minimal encoding.
+void encodeV2Flags(flags_t flags, uint8_t* out) {
+  ld_check(flags < (1u << 7 * V2_FLAGS_SIZE));
+  for (size_t i = 0; i < V2_FLAGS_SIZE; ++i, flags >>= 7) {
+    out[i] = (flags & 0x7f) | (i + 1 < V2_FLAGS_SIZE ? 0x80 : 0);
+  }
+}
+
+flags_t decodeV2Flags(const uint8_t* in) {
+  return (in[0] & 0x7f) | (in[1] & 0x7f) << 7 | (in[2] & 0x7f) << 14 |
+      (in[3] & 0x7f) << 21;
+}
+
 uint32_t getRecordWaveOrRecoveryEpoch(const STORE_Header& header,
                                       const STORE_Extra& extra) {
   return (((header.flags & STORE_Header::RECOVERY ||
@@ -49,6 +97,16 @@ size_t recordHeaderSizeEstimate(flags_t flags,
                                 copyset_size_t copyset_size,
                                 const Slice& optional_keys,
                                 const OffsetMap& offsets_within_epoch) {
+  if (flags & FLAG_FORMAT_V2) {
+    return V2_COPYSET_OFFSET + copyset_size * sizeof(ShardID) +
+        (flags & FLAG_OFFSET_WITHIN_EPOCH
+             ? offsets_within_epoch.sizeInLinearBuffer()
+             : 0) +
+        (flags & (FLAG_CUSTOM_KEY | FLAG_OPTIONAL_KEYS)
+             ? folly::kMaxVarintLength32 + optional_keys.size
+             : 0);
+  }
+
   size_t ret = sizeof(int64_t) + sizeof(esn_t) + folly::kMaxVarintLength32 +
       sizeof(uint32_t) +
       ((flags & FLAG_OFFSET_WITHIN_EPOCH && !(flags & FLAG_OFFSET_MAP))
@@ -72,6 +130,60 @@ size_t recordHeaderSizeEstimate(flags_t flags,
   return ret;
 }
 
+namespace {
+
+Slice formRecordHeaderV2BufAppend(int64_t timestamp,
+                                  esn_t last_known_good,
+                                  flags_t flags,
+                                  uint32_t wave_or_recovery_epoch,
+                                  const folly::Range<const ShardID*>& copyset,
+                                  const OffsetMap& offsets_within_epoch,
+                                  const Slice& optional_keys,
+                                  std::string* buf) {
+  // The copyset is always made of ShardIDs and offsets are always an
+  // OffsetMap. Keys are always the map written by serializeOptionalKeys().
+  flags |= FLAG_SHARD_ID;
+  if (flags & FLAG_OFFSET_WITHIN_EPOCH) {
+    flags |= FLAG_OFFSET_MAP;
+  }
+  ld_check(!(flags & FLAG_CUSTOM_KEY) || (flags & FLAG_OPTIONAL_KEYS));
+
+  size_t buf_size_prev = buf->size();
+  APPEND_TO_STRING(buf, timestamp);
+  APPEND_TO_STRING(buf, last_known_good);
+  uint8_t flags_buf[V2_FLAGS_SIZE];
+  encodeV2Flags(flags, flags_buf);
+  buf->append(reinterpret_cast<const char*>(flags_buf), V2_FLAGS_SIZE);
+  APPEND_TO_STRING(buf, wave_or_recovery_epoch);
+  copyset_size_t copyset_size = copyset.size();
+  APPEND_TO_STRING(buf, copyset_size);
+  buf->append(reinterpret_cast<const char*>(copyset.begin()),
+              copyset.size() * sizeof(ShardID));
+  ld_check(buf->size() - buf_size_prev ==
+           V2_COPYSET_OFFSET + copyset.size() * sizeof(ShardID));
+
+  if (flags & FLAG_OFFSET_WITHIN_EPOCH) {
+    ssize_t offsets_map_size = offsets_within_epoch.sizeInLinearBuffer();
+    size_t buf_size_before_offset_map = buf->size();
+    buf->resize(buf->size() + offsets_map_size);
+    int rv = offsets_within_epoch.serialize(
+        &(*buf)[buf_size_before_offset_map], offsets_map_size);
+    ld_check(rv != -1);
+  }
+
+  if (flags & FLAG_OPTIONAL_KEYS) {
+    uint8_t varint_buf[folly::kMaxVarintLength32];
+    size_t n = folly::encodeVarint(optional_keys.size, varint_buf);
+    buf->append(reinterpret_cast<const char*>(varint_buf), n);
+    buf->append(reinterpret_cast<const char*>(optional_keys.data),
+                optional_keys.size);
+  }
+
+  return Slice(buf->data() + buf_size_prev, buf->size() - buf_size_prev);
+}
+
+} // namespace
+
 Slice formRecordHeaderBufAppend(int64_t timestamp,
                                 esn_t last_known_good,
                                 flags_t flags,
@@ -81,6 +193,16 @@ Slice formRecordHeaderBufAppend(int64_t timestamp,
                                 const Slice& optional_keys,
                                 std::string* buf) {
   ld_check(buf != nullptr);
+  if (flags & FLAG_FORMAT_V2) {
+    return formRecordHeaderV2BufAppend(timestamp,
+                                       last_known_good,
+                                       flags,
+                                       wave_or_recovery_epoch,
+                                       copyset,
+                                       offsets_within_epoch,
+                                       optional_keys,
+                                       buf);
+  }
   size_t buf_size_prev = buf->size();
 
   APPEND_TO_STRING(buf, timestamp);
@@ -159,15 +281,19 @@ Slice formRecordHeader(const STORE_Header& store_header,
                        std::string* buf,
                        const bool shard_id_in_copyset,
                        const std::map<KeyType, std::string>& optional_keys,
-                       const STORE_Extra& store_extra) {
+                       const STORE_Extra& store_extra,
+                       bool format_v2) {
   flags_t flags = store_header.flags & FLAG_MASK;
   uint32_t wave_or_recovery_epoch_to_store =
       getRecordWaveOrRecoveryEpoch(store_header, store_extra);
   OffsetMap offsets_within_epoch;
 
-  if (shard_id_in_copyset) {
+  if (shard_id_in_copyset || format_v2) {
     flags |= FLAG_SHARD_ID;
   }
+  if (format_v2) {
+    flags |= FLAG_FORMAT_V2;
+  }
   if (store_header.flags & STORE_Header::AMEND) {
     flags |= FLAG_AMEND;
   }
@@ -357,6 +483,192 @@ int parseFlagsValue(flags_t& flags, const uint8_t** ptr, const uint8_t* end) {
   }
   return 0;
 }
+
+// Parses the optional keys map written by serializeOptionalKeys(), which must
+// take exactly the bytes from `ptr` to `end`.
+int parseOptionalKeys(const uint8_t* ptr,
+                      const uint8_t* const end,
+                      std::map<KeyType, std::string>* optional_keys) {
+  const uint8_t* const start = ptr;
+  auto malformed = [&](const char* what) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Invalid record: %s while parsing optional keys: %s",
+                    what,
+                    hexdump_buf(start, end - start, 700).c_str());
+    err = E::MALFORMED_RECORD;
+    return -1;
+  };
+
+  uint16_t optional_keys_size;
+  if (ptr + sizeof(uint16_t) > end) {
+    return malformed("past end");
+  }
+  memcpy(&optional_keys_size, ptr, sizeof(uint16_t));
+  ptr += sizeof(uint16_t);
+  for (uint16_t i = 0; i < optional_keys_size; i++) {
+    uint8_t key_type;
+    uint16_t key_length;
+    if (ptr + sizeof(uint8_t) + sizeof(uint16_t) > end) {
+      return malformed("past end");
+    }
+    memcpy(&key_type, ptr, sizeof(uint8_t));
+    ptr += sizeof(uint8_t);
+    memcpy(&key_length, ptr, sizeof(uint16_t));
+    ptr += sizeof(uint16_t);
+    if (ptr + key_length > end) {
+      return malformed("past end");
+    }
+    if (optional_keys != nullptr) {
+      optional_keys->insert(std::make_pair(
+          static_cast<KeyType>(key_type),
+          std::string(reinterpret_cast<const char*>(ptr), (size_t)key_length)));
+    }
+    ptr += key_length;
+  }
+  if (ptr != end) {
+    return malformed("map size not equal to blob size");
+  }
+  return 0;
+}
+
+// Output parameters of parse().
+struct ParseOutputs {
+  std::chrono::milliseconds* timestamp;
+  esn_t* last_known_good;
+  flags_t* flags;
+  uint32_t* wave_or_recovery_epoch;
+  copyset_size_t* copyset_size;
+  ShardID* copyset_arr;
+  size_t copyset_arr_size;
+  OffsetMap* offsets_within_epoch;
+  std::map<KeyType, std::string>* optional_keys;
+  Payload* payload;
+};
+
+// Parses a record in the v2 format. Everything up to the copyset is read at
+// fixed offsets; the variable sections are compiled in only for the flag
+// combinations that have them, see parseV2().
+template <bool HasOffsets, bool HasKeys>
+int parseV2Impl(const Slice& log_store_blob,
+                flags_t flags,
+                const ParseOutputs& out) {
+  const uint8_t* const start =
+      reinterpret_cast<const uint8_t*>(log_store_blob.data);
+  const uint8_t* const end = start + log_store_blob.size;
+  auto malformed = [&](const char* what) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Invalid v2 record: %s; blob: %s",
+                    what,
+                    hexdump_buf(log_store_blob, 700).c_str());
+    err = E::MALFORMED_RECORD;
+    return -1;
+  };
+
+  if (log_store_blob.size < V2_COPYSET_OFFSET) {
+    return malformed("too small");
+  }
+  copyset_size_t copyset_size;
+  memcpy(&copyset_size, start + V2_COPYSET_SIZE_OFFSET, sizeof(copyset_size));
+  if (copyset_size < 1 || copyset_size > COPYSET_SIZE_MAX) {
+    return malformed("invalid copyset size");
+  }
+  const uint8_t* ptr = start + V2_COPYSET_OFFSET;
+  if (copyset_size * sizeof(ShardID) > size_t(end - ptr)) {
+    return malformed("past end while parsing copyset");
+  }
+
+  if (out.timestamp != nullptr) {
+    uint64_t raw;
+    memcpy(&raw, start, sizeof(raw));
+    *out.timestamp = std::chrono::milliseconds(raw);
+  }
+  if (out.last_known_good != nullptr) {
+    memcpy(out.last_known_good,
+           start + sizeof(uint64_t),
+           sizeof(*out.last_known_good));
+  }
+  if (out.flags != nullptr) {
+    *out.flags = flags;
+  }
+  if (out.wave_or_recovery_epoch != nullptr) {
+    memcpy(out.wave_or_recovery_epoch,
+           start + V2_WAVE_OFFSET,
+           sizeof(*out.wave_or_recovery_epoch));
+  }
+  if (out.copyset_size != nullptr) {
+    *out.copyset_size = copyset_size;
+  }
+  Status status = E::OK;
+  if (out.copyset_arr != nullptr) {
+    if (copyset_size <= out.copyset_arr_size) {
+      memcpy(out.copyset_arr, ptr, copyset_size * sizeof(ShardID));
+    } else {
+      status = E::NOBUFS;
+    }
+  }
+  ptr += copyset_size * sizeof(ShardID);
+
+  if (HasOffsets) {
+    OffsetMap offsets;
+    int rv = offsets.deserialize(Slice(ptr, end - ptr));
+    if (rv == -1) {
+      return malformed("failed to parse OffsetMap");
+    }
+    if (out.offsets_within_epoch != nullptr) {
+      *out.offsets_within_epoch = std::move(offsets);
+    }
+    ptr += rv;
+  }
+
+  if (HasKeys) {
+    uint32_t keys_size;
+    try {
+      folly::ByteRange range(ptr, end);
+      keys_size = folly::decodeVarint(range);
+      ptr = range.begin();
+    } catch (...) {
+      return malformed("failed to decode optional keys size");
+    }
+    if (keys_size > end - ptr) {
+      return malformed("past end while parsing optional keys");
+    }
+    int rv = parseOptionalKeys(ptr, ptr + keys_size, out.optional_keys);
+    if (rv != 0) {
+      return rv;
+    }
+    ptr += keys_size;
+  }
+
+  if (out.payload != nullptr) {
+    *out.payload = ptr != end ? Payload(ptr, end - ptr) : Payload();
+  }
+  if (status != E::OK) {
+    err = status;
+    return -1;
+  }
+  return 0;
+}
+
+int parseV2(const Slice& log_store_blob, const ParseOutputs& out) {
+  const flags_t flags = decodeV2Flags(
+      reinterpret_cast<const uint8_t*>(log_store_blob.data) + V2_FLAGS_OFFSET);
+  if ((flags & FLAG_CUSTOM_KEY) && !(flags & FLAG_OPTIONAL_KEYS)) {
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+  switch (flags & (FLAG_OFFSET_WITHIN_EPOCH | FLAG_OPTIONAL_KEYS)) {
+    case 0:
+      return parseV2Impl<false, false>(log_store_blob, flags, out);
+    case FLAG_OFFSET_WITHIN_EPOCH:
+      return parseV2Impl<true, false>(log_store_blob, flags, out);
+    case FLAG_OPTIONAL_KEYS:
+      return parseV2Impl<false, true>(log_store_blob, flags, out);
+    default:
+      return parseV2Impl<true, true>(log_store_blob, flags, out);
+  }
+}
 } // namespace
 
 // TODO (t9002309): block entry support
@@ -438,6 +750,20 @@ int parse(const Slice& log_store_blob,
           std::map<KeyType, std::string>* optional_keys,
           Payload* payload_out,
           shard_index_t this_shard) {
+  if (isFormatV2(log_store_blob)) {
+    return parseV2(log_store_blob,
+                   ParseOutputs{timestamp_out,
+                                last_known_good_out,
+                                flags_out,
+                                wave_or_recovery_epoch_out,
+                                copyset_size_out,
+                                copyset_arr_out,
+                                copyset_arr_out_size,
+                                offsets_within_epoch_out,
+                                optional_keys,
+                                payload_out});
+  }
+
   const uint8_t *const start = reinterpret_cast<const uint8_t*>(
                            log_store_blob.data),
                        *const end = start + log_store_blob.size, *ptr = start;
@@ -633,58 +959,11 @@ int parse(const Slice& log_store_blob,
     // If FLAG_OPTIONAL_KEYS is set, we deserialize it as a map.
     // Otherwise we use legacy code to deserialize it as a string.
     if (flags & FLAG_OPTIONAL_KEYS) {
-      uint16_t optional_keys_size;
-      if (ptr + sizeof(uint16_t) > end) {
-        RATELIMIT_ERROR(
-            std::chrono::seconds(10),
-            10,
-            "Invalid record: past end while parsing optional_keys_size: %s",
-            hexdump_buf(log_store_blob, 700).c_str());
-        err = E::MALFORMED_RECORD;
-        return -1;
-      }
-      memcpy(&optional_keys_size, ptr, sizeof(uint16_t));
-      ptr += sizeof(uint16_t);
-      for (uint16_t i = 0; i < optional_keys_size; i++) {
-        uint8_t key_type;
-        uint16_t key_length;
-        if (ptr + sizeof(uint8_t) + sizeof(uint16_t) > end) {
-          RATELIMIT_ERROR(std::chrono::seconds(10),
-                          10,
-                          "Invalid record: past end while parsing key type: %s",
-                          hexdump_buf(log_store_blob, 700).c_str());
-          err = E::MALFORMED_RECORD;
-          return -1;
-        }
-        memcpy(&key_type, ptr, sizeof(uint8_t));
-        ptr += sizeof(uint8_t);
-        memcpy(&key_length, ptr, sizeof(uint16_t));
-        ptr += sizeof(uint16_t);
-        if (ptr + key_length > end) {
-          RATELIMIT_ERROR(
-              std::chrono::seconds(10),
-              10,
-              "Invalid record: past end while parsing key: %s",
-              hexdump_buf(log_store_blob, (ptr - start) * 2).c_str());
-          err = E::MALFORMED_RECORD;
-          return -1;
-        }
-        if (optional_keys != nullptr) {
-          std::string key = std::string(
-              reinterpret_cast<const char*>(ptr), (size_t)key_length);
-          optional_keys->insert(
-              std::make_pair(static_cast<KeyType>(key_type), std::move(key)));
-        }
-        ptr += key_length;
-      }
-      if (ptr - map_head_pos != blob_size) {
-        RATELIMIT_ERROR(std::chrono::seconds(10),
-                        10,
-                        "Optional keys map size is not equal to blob size: %s",
-                        hexdump_buf(log_store_blob, (ptr - start) * 2).c_str());
-        err = E::MALFORMED_RECORD;
-        return -1;
+      rv = parseOptionalKeys(ptr, map_head_pos + blob_size, optional_keys);
+      if (rv != 0) {
+        return rv;
       }
+      ptr = map_head_pos + blob_size;
     } else {
       ld_check(flags & FLAG_CUSTOM_KEY);
       // We parse it as a string and put it into optional keys map
@@ -851,20 +1130,6 @@ int parseTimestamp(const Slice& log_store_blob,
   return 0;
 }
 
-// For a bitmask `mask` with exactly one one-bit, tests that `varint` has that
-// bit set to one.
-static inline bool testVarInt(const uint8_t* varint, size_t mask) {
-  ld_assert(mask != 0 && (mask & (mask - 1)) == 0); // mask is a power of two
-  constexpr uint8_t ADDITIONAL_OCTETS_MASK = 1ul << 7;
-  const uint8_t* cur_octet = varint;
-  for (; mask > 127; mask >>= 7, ++cur_octet) {
-    if ((*cur_octet & ADDITIONAL_OCTETS_MASK) == 0) {
-      return false;
-    }
-  }
-  return (*cur_octet & mask) != 0;
-}
-
 int isWrittenByRecovery(const Slice& log_store_blob,
                         bool* is_written_by_recovery_out) {
   ld_check(is_written_by_recovery_out);
@@ -903,6 +1168,131 @@ int parseFlags(const Slice& log_store_blob, flags_t* flags_out) {
                -1 /* unused */);
 }
 
+int parseFilterableKey(const Slice& log_store_blob,
+                       flags_t* flags_out,
+                       folly::Optional<folly::StringPiece>* key_out) {
+  ld_check(flags_out != nullptr);
+  ld_check(key_out != nullptr);
+  key_out->clear();
+
+  if (log_store_blob.size < minLogStoreBlobSize()) {
+    ld_error("Invalid record: too small (%zu bytes)", log_store_blob.size);
+    err = E::MALFORMED_RECORD;
+    return -1;
+  }
+
+  const uint8_t* ptr = reinterpret_cast<const uint8_t*>(log_store_blob.data);
+  const uint8_t* const end = ptr + log_store_blob.size;
+  auto past_end = [&](size_t bytes) {
+    if (ptr + bytes > end) {
+      ld_error("Invalid record: past end while parsing optional keys");
+      err = E::MALFORMED_RECORD;
+      return true;
+    }
+    return false;
+  };
+
+  if (isFormatV2(log_store_blob)) {
+    const flags_t flags = decodeV2Flags(ptr + V2_FLAGS_OFFSET);
+    *flags_out = flags;
+    if (!(flags & FLAG_OPTIONAL_KEYS)) {
+      return 0;
+    }
+    copyset_size_t copyset_size;
+    if (past_end(V2_COPYSET_OFFSET)) {
+      return -1;
+    }
+    memcpy(&copyset_size, ptr + V2_COPYSET_SIZE_OFFSET, sizeof(copyset_size));
+    ptr += V2_COPYSET_OFFSET;
+    if (past_end(copyset_size * sizeof(ShardID))) {
+      return -1;
+    }
+    ptr += copyset_size * sizeof(ShardID);
+    if (flags & FLAG_OFFSET_WITHIN_EPOCH) {
+      OffsetMap offsets;
+      int rv = offsets.deserialize(Slice(ptr, end - ptr));
+      if (rv == -1) {
+        err = E::MALFORMED_RECORD;
+        return -1;
+      }
+      ptr += rv;
+    }
+    // Varint size of the keys blob.
+    try {
+      folly::ByteRange range(ptr, end);
+      folly::decodeVarint(range);
+      ptr = range.begin();
+    } catch (...) {
+      err = E::MALFORMED_RECORD;
+      return -1;
+    }
+  } else {
+    // Timestamp and last known good.
+    ptr += sizeof(uint64_t) + sizeof(esn_t);
+
+    flags_t flags;
+    int rv = parseFlagsValue(flags, &ptr, end);
+    if (rv != 0) {
+      return rv;
+    }
+    *flags_out = flags;
+    if (!(flags & FLAG_OPTIONAL_KEYS)) {
+      // No keys, or only a legacy FINDKEY key.
+      return 0;
+    }
+
+    // Wave and copyset.
+    copyset_size_t copyset_size;
+    if (past_end(sizeof(uint32_t) + sizeof(copyset_size))) {
+      return -1;
+    }
+    ptr += sizeof(uint32_t);
+    memcpy(&copyset_size, ptr, sizeof(copyset_size));
+    ptr += sizeof(copyset_size);
+    ptr += copyset_size *
+        (flags & FLAG_SHARD_ID ? sizeof(ShardID) : sizeof(node_index_t));
+
+    if (flags & FLAG_OFFSET_WITHIN_EPOCH && !(flags & FLAG_OFFSET_MAP)) {
+      ptr += sizeof(uint64_t);
+    }
+
+    // Size of the keys blob.
+    if (past_end(sizeof(uint16_t))) {
+      return -1;
+    }
+    ptr += sizeof(uint16_t);
+  }
+
+  // Optional keys: number of keys, then (type, length, key) each.
+  uint16_t optional_keys_size;
+  if (past_end(sizeof(uint16_t))) {
+    return -1;
+  }
+  memcpy(&optional_keys_size, ptr, sizeof(uint16_t));
+  ptr += sizeof(uint16_t);
+  for (uint16_t i = 0; i < optional_keys_size; ++i) {
+    uint8_t key_type;
+    uint16_t key_length;
+    if (past_end(sizeof(uint8_t) + sizeof(uint16_t))) {
+      return -1;
+    }
+    memcpy(&key_type, ptr, sizeof(uint8_t));
+    ptr += sizeof(uint8_t);
+    memcpy(&key_length, ptr, sizeof(uint16_t));
+    ptr += sizeof(uint16_t);
+    if (past_end(key_length)) {
+      return -1;
+    }
+    if (static_cast<KeyType>(key_type) == KeyType::FILTERABLE) {
+      *key_out =
+          folly::StringPiece(reinterpret_cast<const char*>(ptr), key_length);
+      return 0;
+    }
+    ptr += key_length;
+  }
+  return 0;
+}
+
 int getCopysetHash(const Slice& log_store_blob, size_t* hash_out) {
   static thread_local std::array<ShardID, COPYSET_SIZE_MAX> copyset;
   ld_check(hash_out != nullptr);
@@ -980,6 +1370,7 @@ std::string flagsToString(flags_t flags) {
   FLAG(DRAINED)
   FLAG(SHARD_ID)
   FLAG(OFFSET_MAP)
+  FLAG(FORMAT_V2)
 
 #undef FLAG
 
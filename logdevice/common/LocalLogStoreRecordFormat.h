@@ -10,6 +10,7 @@
 #include <chrono>
 #include <string>
 
+#include <folly/Optional.h>
 #include <folly/Range.h>
 
 #include "logdevice/common/NodeID.h"
@@ -44,6 +45,24 @@
  *   [0 to  64kb]    user defined key.
  *   [?? bytes]      the rest of the blob is the user-provided data
  *
+ * Records with FLAG_FORMAT_V2 use a layout where everything up to the copyset
+ * is at a fixed offset, so that it can be read without decoding the fields
+ * before it:
+ *   [8 bytes]       timestamp in milliseconds
+ *   [4 bytes]       last_known_good in epoch
+ *   [4 bytes]       flags, as a varint padded to 4 bytes. Readers of the
+ *                   original format decode it as usual and see
+ *                   FLAG_FORMAT_V2, which tells the two formats apart.
+ *   [4 bytes]       wave number or seal epoch of the log recovery, as above
+ *   [1 byte]        copyset size N
+ *   [N * 4 bytes]   ShardID for each of the N copyset entries (FLAG_SHARD_ID
+ *                   is always set)
+ *   [variable]      if FLAG_OFFSET_WITHIN_EPOCH is set, the OffsetMap
+ *   [variable]      if FLAG_OPTIONAL_KEYS is set, varint length of the
+ *                   optional keys followed by the keys, serialized by
+ *                   serializeOptionalKeys()
+ *   [?? bytes]      the rest of the blob is the user-provided data
+ *
  * The format of single copyset index entries is:
  *   [4 bytes] wave number
  *   [1 byte]  flags. is_hole and written by rebuilding
@@ -117,6 +136,10 @@ const flags_t FLAG_SHARD_ID = 1u << 20; //=1048576
 // Indicates if record contains OffsetMap.
 const flags_t FLAG_OFFSET_MAP = 1u << 21; //=2097152
 
+// The record header has the v2 layout described at the top of the file.
+// Only records written with --write-record-format-v2 have it.
+const flags_t FLAG_FORMAT_V2 = 1u << 22; //=4194304
+
 // Please update flagsToString() when adding new flags.
 
 // Flags that indicate that the record in question is a pseudorecord, and can
@@ -242,13 +265,16 @@ Slice formRecordHeader(int64_t timestamp,
  *                              monotonically increasing order);
  *                              KeyType::FILTERABLE is used by server-side
  *                              filtering.[Experimental feature]
+ * @param format_v2             write the header in the v2 layout, see
+ *                              FLAG_FORMAT_V2
  */
 Slice formRecordHeader(const STORE_Header& store_header,
                        const StoreChainLink* copyset,
                        std::string* buf,
                        bool shard_id_in_copyset,
                        const std::map<KeyType, std::string>& optional_keys,
-                       const STORE_Extra& store_extra = STORE_Extra());
+                       const STORE_Extra& store_extra = STORE_Extra(),
+                       bool format_v2 = false);
 
 /**
  * Form copyset index entry flags from the content of a STORE_Header.
@@ -390,6 +416,20 @@ int parseFlags(const Slice& log_store_blob, flags_t* flags_out);
 int isWrittenByRecovery(const Slice& log_store_blob,
                         bool* is_written_by_recovery_out);
 
+/**
+ * Same as parse() but only parses flags and the KeyType::FILTERABLE optional
+ * key, stopping before the OffsetMap and payload. Used by server-side
+ * filtering to reject a record without parsing (and copying the keys of) the
+ * whole record. Only the part of the record up to the optional keys is
+ * validated.
+ *
+ * @param key_out  set to the FILTERABLE key, pointing into log_store_blob, or
+ *                 to folly::none if the record doesn't have one
+ */
+int parseFilterableKey(const Slice& log_store_blob,
+                       flags_t* flags_out,
+                       folly::Optional<folly::StringPiece>* key_out);
+
 /**
  * Computes a hash of record's copyset.
  */
@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/LogQueryBatcher.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_DATA_SIZE_Message.h"
+#include "logdevice/common/protocol/MULTI_IS_LOG_EMPTY_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+LogQueryBatcher::LogQueryBatcher() = default;
+
+LogQueryBatcher::~LogQueryBatcher() = default;
+
+bool LogQueryBatcher::add(const IS_LOG_EMPTY_Header& header, NodeID to) {
+  if (!canBatch(to)) {
+    return false;
+  }
+  addToBatch(is_log_empty_batches_, header, to);
+  return true;
+}
+
+bool LogQueryBatcher::add(const DATA_SIZE_Header& header, NodeID to) {
+  if (!canBatch(to)) {
+    return false;
+  }
+  addToBatch(data_size_batches_, header, to);
+  return true;
+}
+
+bool LogQueryBatcher::canBatch(NodeID to) const {
+  if (Worker::settings().log_query_batching_window.count() <= 0) {
+    return false;
+  }
+  folly::Optional<uint16_t> proto =
+      Worker::onThisThread()->sender().getSocketProtocolVersion(to.index());
+  return proto.hasValue() &&
+      proto.value() >= Compatibility::MULTI_LOG_QUERY_SUPPORT;
+}
+
+template <typename Header>
+void LogQueryBatcher::addToBatch(BatchMap<Header>& batches,
+                                 const Header& header,
+                                 NodeID to) {
+  const Settings& settings = Worker::settings();
+  Batch<Header>& batch = batches[to.index()];
+  batch.to = to;
+  batch.requests.push_back(header);
+  ++num_pending_;
+
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (batch.requests.size() >= settings.log_query_batching_max_queries) {
+    // Send on the next event loop iteration.
+    timer_.activate(std::chrono::microseconds::zero());
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.log_query_batching_window);
+  }
+}
+
+void LogQueryBatcher::flush() {
+  auto is_log_empty_batches = std::move(is_log_empty_batches_);
+  is_log_empty_batches_.clear();
+  auto data_size_batches = std::move(data_size_batches_);
+  data_size_batches_.clear();
+  num_pending_ = 0;
+  for (auto& kv : is_log_empty_batches) {
+    send(std::move(kv.second));
+  }
+  for (auto& kv : data_size_batches) {
+    send(std::move(kv.second));
+  }
+}
+
+void LogQueryBatcher::send(Batch<IS_LOG_EMPTY_Header> batch) {
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+  auto& requests = batch.requests;
+  ld_check(!requests.empty());
+
+  if (requests.size() == 1) {
+    auto msg = std::make_unique<IS_LOG_EMPTY_Message>(requests.front());
+    if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+      IS_LOG_EMPTY_Message::onSentCommon(requests.front(), err, to);
+    }
+    return;
+  }
+
+  const size_t num_requests = requests.size();
+  auto msg = std::make_unique<MULTI_IS_LOG_EMPTY_Message>(std::move(requests));
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_IS_LOG_EMPTY with %zu requests to "
+                   "%s: %s",
+                   num_requests,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    // sendMessage() doesn't consume the message on failure
+    msg->onSent(st, to);
+    return;
+  }
+
+  WORKER_STAT_INCR(client.log_query_batches_sent);
+  WORKER_STAT_ADD(client.log_query_batched_queries_sent, num_requests);
+}
+
+void LogQueryBatcher::send(Batch<DATA_SIZE_Header> batch) {
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+  auto& requests = batch.requests;
+  ld_check(!requests.empty());
+
+  if (requests.size() == 1) {
+    auto msg = std::make_unique<DATA_SIZE_Message>(requests.front());
+    if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+      DATA_SIZE_Message::onSentCommon(requests.front(), err, to);
+    }
+    return;
+  }
+
+  const size_t num_requests = requests.size();
+  auto msg = std::make_unique<MULTI_DATA_SIZE_Message>(std::move(requests));
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_DATA_SIZE with %zu requests to "
+                   "%s: %s",
+                   num_requests,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    // sendMessage() doesn't consume the message on failure
+    msg->onSent(st, to);
+    return;
+  }
+
+  WORKER_STAT_INCR(client.log_query_batches_sent);
+  WORKER_STAT_ADD(client.log_query_batched_queries_sent, num_requests);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/DATA_SIZE_Message.h"
+#include "logdevice/common/protocol/IS_LOG_EMPTY_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-Worker coalescing of IS_LOG_EMPTY and DATA_SIZE messages headed
+ *       to the same storage node. When --log-query-batching-window is
+ *       nonzero, the messages of batchable IsLogEmptyRequests and
+ *       DataSizeRequests (the ones started by Client::isLogEmptyBatch() and
+ *       Client::dataSizeBatch()) sent within the window to a node whose
+ *       connection supports MULTI_IS_LOG_EMPTY and MULTI_DATA_SIZE are held
+ *       back and then sent together in one MULTI_IS_LOG_EMPTY_Message or
+ *       MULTI_DATA_SIZE_Message (or as a plain message if there's only one).
+ *
+ *       As with TrimBatcher, batches are only sent from the timer callback,
+ *       so that send failures reported to the requests don't reenter them
+ *       while they are sending.
+ */
+
+class LogQueryBatcher {
+ public:
+  LogQueryBatcher();
+  ~LogQueryBatcher();
+
+  LogQueryBatcher(const LogQueryBatcher&) = delete;
+  LogQueryBatcher& operator=(const LogQueryBatcher&) = delete;
+
+  /**
+   * Take an IS_LOG_EMPTY or DATA_SIZE that a request wants to send to `to`,
+   * if it can be batched.
+   *
+   * The outcome of sending the message, including errors returned by
+   * Sender::sendMessage() when the batch is sent, is reported through
+   * IS_LOG_EMPTY_Message::onSentCommon() or DATA_SIZE_Message::onSentCommon().
+   *
+   * @return  true if `header` was taken. false if batching is disabled or
+   *          `to` hasn't negotiated a protocol with MULTI_IS_LOG_EMPTY and
+   *          MULTI_DATA_SIZE support yet; the caller should send the message
+   *          directly.
+   */
+  bool add(const IS_LOG_EMPTY_Header& header, NodeID to);
+  bool add(const DATA_SIZE_Header& header, NodeID to);
+
+  // Number of messages waiting to be sent.
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  template <typename Header>
+  struct Batch {
+    NodeID to;
+    std::vector<Header> requests;
+  };
+
+  template <typename Header>
+  using BatchMap = std::unordered_map<node_index_t, Batch<Header>>;
+
+  // Checks whether batching is enabled and `to` supports the MULTI_ messages.
+  bool canBatch(NodeID to) const;
+
+  // Adds `header` to the batch for `to` in `batches` and schedules a flush.
+  template <typename Header>
+  void addToBatch(BatchMap<Header>& batches, const Header& header, NodeID to);
+
+  // Sends all pending batches.
+  void flush();
+
+  void send(Batch<IS_LOG_EMPTY_Header> batch);
+  void send(Batch<DATA_SIZE_Header> batch);
+
+  BatchMap<IS_LOG_EMPTY_Header> is_log_empty_batches_;
+  BatchMap<DATA_SIZE_Header> data_size_batches_;
+  size_t num_pending_ = 0;
+
+  // Fires when the oldest pending message has waited for
+  // --log-query-batching-window, or right away if a batch grew too big.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/MemoryGovernor.h"
+
+#include <algorithm>
+#include <map>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+MemoryGovernor::Handle::Handle(Handle&& rhs) noexcept
+    : governor_(rhs.governor_), it_(rhs.it_) {
+  rhs.governor_ = nullptr;
+}
+
+MemoryGovernor::Handle& MemoryGovernor::Handle::
+operator=(Handle&& rhs) noexcept {
+  if (this != &rhs) {
+    reset();
+    governor_ = rhs.governor_;
+    it_ = rhs.it_;
+    rhs.governor_ = nullptr;
+  }
+  return *this;
+}
+
+void MemoryGovernor::Handle::setBaseLimit(uint64_t limit) {
+  ld_check(governor_);
+  std::lock_guard<std::mutex> lock(governor_->mutex_);
+  ResourceBudget* budget = it_->budget;
+  ld_check(budget);
+  // Keep a lowered limit lowered until the next rebalance().
+  const bool lowered = budget->getLimit() < it_->base_limit;
+  it_->base_limit = limit;
+  budget->setLimit(lowered ? std::min(budget->getLimit(), limit) : limit);
+}
+
+void MemoryGovernor::Handle::reset() {
+  if (governor_) {
+    std::lock_guard<std::mutex> lock(governor_->mutex_);
+    governor_->consumers_.erase(it_);
+    governor_ = nullptr;
+  }
+}
+
+MemoryGovernor* MemoryGovernor::get() {
+  // This singleton leaks, and it's okay
+  static MemoryGovernor* inst = new MemoryGovernor();
+  return inst;
+}
+
+MemoryGovernor::Handle MemoryGovernor::registerBudget(std::string name,
+                                                      ResourceBudget* budget,
+                                                      uint64_t base_limit) {
+  ld_check(budget);
+  budget->setLimit(base_limit);
+  std::lock_guard<std::mutex> lock(mutex_);
+  consumers_.push_back(Consumer{std::move(name), budget, nullptr, base_limit});
+  return Handle(this, std::prev(consumers_.end()));
+}
+
+MemoryGovernor::Handle
+MemoryGovernor::registerUsage(std::string name,
+                              std::function<uint64_t()> get_usage) {
+  ld_check(get_usage);
+  std::lock_guard<std::mutex> lock(mutex_);
+  consumers_.push_back(
+      Consumer{std::move(name), nullptr, std::move(get_usage), 0});
+  return Handle(this, std::prev(consumers_.end()));
+}
+
+uint64_t MemoryGovernor::usageOf(const Consumer& c) {
+  return c.budget ? c.budget->getUsed() : c.get_usage();
+}
+
+void MemoryGovernor::rebalance(uint64_t global_limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (global_limit == 0) {
+    for (Consumer& c : consumers_) {
+      if (c.budget) {
+        c.budget->setLimit(c.base_limit);
+      }
+    }
+    return;
+  }
+
+  // Take a snapshot of usage so that all limits are computed from the same
+  // numbers.
+  std::vector<uint64_t> used;
+  used.reserve(consumers_.size());
+  uint64_t total = 0;
+  uint64_t elastic_used = 0;
+  uint64_t elastic_base = 0;
+  for (const Consumer& c : consumers_) {
+    used.push_back(usageOf(c));
+    total += used.back();
+    if (c.budget) {
+      elastic_used += used.back();
+      elastic_base += c.base_limit;
+    }
+  }
+
+  size_t i = 0;
+  for (Consumer& c : consumers_) {
+    const uint64_t u = used[i++];
+    if (!c.budget) {
+      continue;
+    }
+    uint64_t limit;
+    if (total <= global_limit) {
+      // Under the global limit. Share the headroom in proportion to the base
+      // limits, never going above them.
+      const double share = elastic_base ? 1. * c.base_limit / elastic_base : 0;
+      const auto extra = static_cast<uint64_t>((global_limit - total) * share);
+      limit = std::min(c.base_limit, u + extra);
+    } else {
+      // Over the global limit. Take the excess from budgets in proportion to
+      // their usage. The limit ends up below usage, so acquisitions fail until
+      // enough memory is released.
+      const double share = elastic_used ? 1. * u / elastic_used : 0;
+      limit = u -
+          std::min(u, static_cast<uint64_t>((total - global_limit) * share));
+    }
+    c.budget->setLimit(limit);
+  }
+}
+
+uint64_t MemoryGovernor::getTotalUsage() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t total = 0;
+  for (const Consumer& c : consumers_) {
+    total += usageOf(c);
+  }
+  return total;
+}
+
+std::vector<MemoryGovernor::ConsumerInfo> MemoryGovernor::getConsumers() const {
+  std::map<std::string, ConsumerInfo> by_name;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Consumer& c : consumers_) {
+      auto ins = by_name.emplace(
+          c.name, ConsumerInfo{c.name, 0, 0, 0, 0, c.budget != nullptr});
+      ConsumerInfo& info = ins.first->second;
+      ++info.count;
+      info.used += usageOf(c);
+      if (c.budget) {
+        info.limit += c.budget->getLimit();
+        info.base_limit += c.base_limit;
+      }
+    }
+  }
+  std::vector<ConsumerInfo> res;
+  res.reserve(by_name.size());
+  for (auto& kv : by_name) {
+    res.push_back(std::move(kv.second));
+  }
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "logdevice/common/ResourceBudget.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * Process-wide view of the memory held by the subsystems that buffer data:
+ * read storage tasks, in-flight stores, Sender output buffers etc.
+ *
+ * Each subsystem keeps its own limit (usually a ResourceBudget sized from
+ * settings). Those limits are set independently, so together they can add up
+ * to more memory than the host has. MemoryGovernor enforces a single global
+ * limit on top of them: rebalance() is called periodically and, while total
+ * usage is over the global limit, lowers the limits of elastic consumers
+ * (registered ResourceBudgets) below their current usage so that new
+ * acquisitions fail and the subsystem backs off until memory is released.
+ * Once usage drops, limits are raised back towards their configured values,
+ * with the remaining headroom shared in proportion to those values.
+ *
+ * Consumers registered with registerUsage() are only accounted for: their
+ * usage counts towards the total but the governor can't limit them.
+ *
+ * All methods are thread-safe.
+ */
+class MemoryGovernor : boost::noncopyable {
+ private:
+  struct Consumer {
+    std::string name;
+    // nullptr for consumers registered with registerUsage().
+    ResourceBudget* budget;
+    std::function<uint64_t()> get_usage;
+    // Limit configured by the owner of the budget, before rebalancing.
+    uint64_t base_limit;
+  };
+
+ public:
+  /**
+   * Keeps a consumer registered for as long as it's alive. Must not outlive
+   * the budget or usage function it was created for.
+   */
+  class Handle : boost::noncopyable {
+   public:
+    Handle() {}
+    Handle(Handle&& rhs) noexcept;
+    Handle& operator=(Handle&& rhs) noexcept;
+    ~Handle() {
+      reset();
+    }
+
+    /**
+     * Changes the limit the owner wants the budget to have. Use this instead
+     * of ResourceBudget::setLimit() for registered budgets, otherwise the
+     * next rebalance() will overwrite the new limit.
+     */
+    void setBaseLimit(uint64_t limit);
+
+    // Unregisters the consumer.
+    void reset();
+
+   private:
+    Handle(MemoryGovernor* governor, std::list<Consumer>::iterator it)
+        : governor_(governor), it_(it) {}
+
+    MemoryGovernor* governor_{nullptr};
+    std::list<Consumer>::iterator it_;
+
+    friend class MemoryGovernor;
+  };
+
+  struct ConsumerInfo {
+    std::string name;
+    // Number of registered consumers with this name.
+    size_t count;
+    uint64_t used;
+    // For consumers without a budget, limit and base_limit are 0.
+    uint64_t limit;
+    uint64_t base_limit;
+    bool elastic;
+  };
+
+  // The instance shared by the whole process. Never destroyed.
+  static MemoryGovernor* get();
+
+  /**
+   * Registers a budget whose limit the governor may lower under memory
+   * pressure. Sets the budget's limit to @param base_limit.
+   */
+  Handle registerBudget(std::string name,
+                        ResourceBudget* budget,
+                        uint64_t base_limit);
+
+  /**
+   * Registers memory that is reported by @param get_usage but can't be
+   * limited by the governor. @param get_usage may be called from any thread.
+   */
+  Handle registerUsage(std::string name, std::function<uint64_t()> get_usage);
+
+  /**
+   * Recomputes the limits of registered budgets so that total usage converges
+   * to @param global_limit. 0 means no global limit: all budgets get their
+   * base limits back.
+   */
+  void rebalance(uint64_t global_limit);
+
+  // Total memory used by all registered consumers.
+  uint64_t getTotalUsage() const;
+
+  // One entry per consumer name, sorted by name.
+  std::vector<ConsumerInfo> getConsumers() const;
+
+ private:
+  static uint64_t usageOf(const Consumer& c);
+
+  mutable std::mutex mutex_;
+  std::list<Consumer> consumers_;
+};
+
+}} // namespace facebook::logdevice
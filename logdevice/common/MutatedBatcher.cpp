@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/MutatedBatcher.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_MUTATED_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+MutatedBatcher::MutatedBatcher() = default;
+
+MutatedBatcher::~MutatedBatcher() = default;
+
+bool MutatedBatcher::add(const MUTATED_Header& header, ClientID to) {
+  if (!Worker::settings().recovery_mutation_batching) {
+    return false;
+  }
+
+  batches_[to].push_back(header);
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (!timer_.isActive()) {
+    timer_.activate(std::chrono::microseconds::zero());
+  }
+  return true;
+}
+
+void MutatedBatcher::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  for (auto& kv : batches) {
+    send(kv.first, std::move(kv.second));
+  }
+}
+
+void MutatedBatcher::send(ClientID to, std::vector<MUTATED_Header> replies) {
+  ld_check(!replies.empty());
+  Sender& sender = Worker::onThisThread()->sender();
+
+  if (replies.size() > 1) {
+    const size_t num_replies = replies.size();
+    auto msg = std::make_unique<MULTI_MUTATED_Message>(std::move(replies));
+    if (sender.sendMessage(std::move(msg), to) == 0) {
+      STAT_INCR(Worker::stats(), mutated_batches_sent);
+      STAT_ADD(Worker::stats(), mutated_batched_replies_sent, num_replies);
+      return;
+    }
+    if (err != E::PROTONOSUPPORT) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      10,
+                      "Failed to send MULTI_MUTATED with %zu replies to %s: "
+                      "%s",
+                      num_replies,
+                      Sender::describeConnection(Address(to)).c_str(),
+                      error_description(err));
+      return;
+    }
+    // The sequencer is too old for MULTI_MUTATED, send the replies one by
+    // one. sendMessage() doesn't consume the message on failure.
+    replies = msg->getReplies();
+  }
+
+  for (const MUTATED_Header& header : replies) {
+    auto msg = std::make_unique<MUTATED_Message>(header);
+    if (sender.sendMessage(std::move(msg), to) != 0) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      10,
+                      "Failed to send MUTATED for %s (recovery id %lu) to %s: "
+                      "%s",
+                      header.rid.toString().c_str(),
+                      header.recovery_id.val_,
+                      Sender::describeConnection(Address(to)).c_str(),
+                      error_description(err));
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
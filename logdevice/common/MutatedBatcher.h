@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/ClientID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/MUTATED_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-Worker coalescing of MUTATED replies that a storage node sends to
+ *       the same sequencer node. When --recovery-mutation-batching is set,
+ *       MUTATED replies are held back until the end of the current event
+ *       loop iteration, and the ones for the same connection are sent
+ *       together in one MULTI_MUTATED_Message (or as a plain MUTATED if
+ *       there's only one, or if the sequencer doesn't support MULTI_MUTATED).
+ *
+ *       The mutations of a MULTI_STORE sent by MutationStoreBatch are usually
+ *       written by the same WriteBatchStorageTask, so their replies are
+ *       produced together and end up in the same MULTI_MUTATED.
+ */
+
+class MutatedBatcher {
+ public:
+  MutatedBatcher();
+  ~MutatedBatcher();
+
+  MutatedBatcher(const MutatedBatcher&) = delete;
+  MutatedBatcher& operator=(const MutatedBatcher&) = delete;
+
+  /**
+   * Takes a MUTATED reply for `to`, if batching is enabled. Failures to send
+   * the batch are logged, same as for MUTATED replies sent directly.
+   *
+   * @return  true if `header` was taken, false if batching is disabled; the
+   *          caller should send a MUTATED_Message directly.
+   */
+  bool add(const MUTATED_Header& header, ClientID to);
+
+ private:
+  // Sends all pending batches.
+  void flush();
+
+  void send(ClientID to, std::vector<MUTATED_Header> replies);
+
+  std::unordered_map<ClientID, std::vector<MUTATED_Header>, ClientID::Hash>
+      batches_;
+
+  // Fires at the end of the event loop iteration in which the first pending
+  // reply was added.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
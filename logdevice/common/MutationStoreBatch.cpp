@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/MutationStoreBatch.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+MutationStoreBatch::MutationStoreBatch() = default;
+
+MutationStoreBatch::~MutationStoreBatch() {
+  // flush() must be called before the batch goes away, otherwise the
+  // Mutators would wait for MUTATED replies that will never come.
+  ld_check(batches_.empty());
+  ld_check(full_batches_.empty());
+}
+
+bool MutationStoreBatch::add(std::unique_ptr<STORE_Message>& msg,
+                             NodeID to,
+                             SocketCallback& onclose) {
+  ld_check(msg);
+  const Settings& settings = Worker::settings();
+
+  const PayloadHolder* payload = msg->getPayloadHolder();
+  const size_t bytes = sizeof(STORE_Header) +
+      msg->getCopyset().size() * sizeof(StoreChainLink) +
+      (payload ? payload->size() : 0);
+  if (bytes >= settings.store_batching_max_bytes) {
+    return false;
+  }
+
+  Sender& sender = Worker::onThisThread()->sender();
+  folly::Optional<uint16_t> proto = sender.getSocketProtocolVersion(to.index());
+  if (!proto.hasValue() ||
+      proto.value() < Compatibility::MULTI_STORE_SUPPORT) {
+    return false;
+  }
+  if (sender.registerOnSocketClosed(Address(to), onclose) != 0) {
+    return false;
+  }
+
+  Batch& batch = batches_[to.index()];
+  if (batch.bytes + bytes > settings.store_batching_max_bytes) {
+    full_batches_.push_back(std::move(batch));
+    batch = Batch();
+  }
+  batch.to = to;
+  batch.stores.push_back(std::move(msg));
+  batch.bytes += bytes;
+  return true;
+}
+
+void MutationStoreBatch::flush() {
+  auto full_batches = std::move(full_batches_);
+  full_batches_.clear();
+  auto batches = std::move(batches_);
+  batches_.clear();
+  for (auto& batch : full_batches) {
+    send(std::move(batch));
+  }
+  for (auto& kv : batches) {
+    send(std::move(kv.second));
+  }
+}
+
+void MutationStoreBatch::send(Batch batch) {
+  auto& stores = batch.stores;
+  if (stores.empty()) {
+    return;
+  }
+
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+
+  if (stores.size() == 1) {
+    std::unique_ptr<STORE_Message> msg = std::move(stores.front());
+    if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+      // sendMessage() doesn't consume the message on failure
+      msg->onSentCommon(err, to);
+    }
+    return;
+  }
+
+  const size_t num_records = stores.size();
+  auto msg = std::make_unique<MULTI_STORE_Message>(std::move(stores),
+                                                   TrafficClass::RECOVERY);
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_STORE with %zu mutations to %s: %s",
+                   num_records,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    for (const auto& store : msg->getStores()) {
+      store->onSentCommon(st, to);
+    }
+    return;
+  }
+
+  STAT_INCR(Worker::stats(), mutation_store_batches_sent);
+  STAT_ADD(Worker::stats(), mutation_store_batched_records_sent, num_records);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/SocketCallback.h"
+
+namespace facebook { namespace logdevice {
+
+class STORE_Message;
+
+/**
+ * @file Collects the STOREs that the Mutators of an EpochRecovery send in
+ *       their first wave, grouped by destination node, and sends them as
+ *       MULTI_STORE messages once all Mutators have started. Recovering an
+ *       epoch with many unreplicated records or holes to plug then takes one
+ *       or a few messages per node of the mutation set instead of one STORE
+ *       per record and node, and each storage node writes the batch with one
+ *       WriteBatchStorageTask. See also --recovery-mutation-batching.
+ *
+ *       Lives on the stack of EpochRecovery::mutateEpoch(). Retries in later
+ *       waves and STOREs to nodes that don't support MULTI_STORE are sent
+ *       directly.
+ */
+
+class MutationStoreBatch {
+ public:
+  MutationStoreBatch();
+  ~MutationStoreBatch();
+
+  MutationStoreBatch(const MutationStoreBatch&) = delete;
+  MutationStoreBatch& operator=(const MutationStoreBatch&) = delete;
+
+  /**
+   * Takes a STORE for `to`, if it can be batched. On success `onclose` is
+   * registered with the socket to `to`, exactly as if `msg` was passed to
+   * Sender::sendMessage().
+   *
+   * @return  true if `msg` was taken. false if `to` has no connection that
+   *          supports MULTI_STORE, or the record is too big to be batched;
+   *          `msg` is left untouched and the caller should send it directly.
+   */
+  bool add(std::unique_ptr<STORE_Message>& msg,
+           NodeID to,
+           SocketCallback& onclose);
+
+  // Sends everything collected so far. The outcome of sending each STORE is
+  // reported through STORE_Message::onSentCommon(), same as for STOREs sent
+  // directly.
+  void flush();
+
+ private:
+  struct Batch {
+    NodeID to;
+    std::vector<std::unique_ptr<STORE_Message>> stores;
+    // Approximate size of the records in the batch.
+    size_t bytes = 0;
+  };
+
+  void send(Batch batch);
+
+  std::unordered_map<node_index_t, Batch> batches_;
+  // Batches that reached --store-batching-max-bytes, waiting for flush().
+  std::vector<Batch> full_batches_;
+};
+
+}} // namespace facebook::logdevice
@@ -11,6 +11,7 @@
 
 #include "logdevice/common/EpochRecovery.h"
 #include "logdevice/common/MetaDataLogWriter.h"
+#include "logdevice/common/MutationStoreBatch.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sequencer.h"
 #include "logdevice/common/Worker.h"
@@ -212,6 +213,13 @@ Mutator::sendSTORE(ShardID shard,
 
   ShardID send_to = copyset[wave_info.offset].destination;
   ld_check(send_to == shard);
+
+  MutationStoreBatch* batch = getStoreBatch();
+  if (batch && batch->add(msg, send_to.asNodeID(), socket_callback)) {
+    // The outcome is reported to onMessageSent() as usual.
+    return {StorageSetAccessor::Result::SUCCESS, Status::OK};
+  }
+
   int rv = sender_->sendMessage(
       std::move(msg), send_to.asNodeID(), &bw_callback, &socket_callback);
   if (rv != 0 && err == E::CBREGISTERED) {
@@ -398,6 +406,10 @@ std::unique_ptr<StorageSetAccessor> Mutator::createStorageSetAccessor(
       property);
 }
 
+MutationStoreBatch* Mutator::getStoreBatch() const {
+  return epoch_recovery_ ? epoch_recovery_->getStoreBatch() : nullptr;
+}
+
 std::shared_ptr<Configuration> Mutator::getClusterConfig() const {
   return Worker::getConfig();
 }
@@ -49,6 +49,7 @@ namespace facebook { namespace logdevice {
  */
 
 class EpochRecovery;
+class MutationStoreBatch;
 
 class Mutator {
  public:
@@ -156,6 +157,9 @@ class Mutator {
  protected:
   virtual std::shared_ptr<Configuration> getClusterConfig() const;
 
+  // @see EpochRecovery::getStoreBatch()
+  virtual MutationStoreBatch* getStoreBatch() const;
+
   virtual std::unique_ptr<StorageSetAccessor>
   createStorageSetAccessor(logid_t log_id,
                            EpochMetaData epoch_metadata_with_mutation_set,
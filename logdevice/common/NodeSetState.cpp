@@ -24,11 +24,12 @@ NodeSetState::NodeSetState(const StorageSet& shards,
     : id_(NodeSetState::next_id++),
       all_shards_cnt_(shards.size()),
       healthCheck_(healthCheck),
+      unavailable_bits_((shards.size() + 63) / 64),
       log_id_(log_id) {
   // create the map with all indices in nodes, keys to the map never change
   // after so the map is thread-safe after construction
-  for (const ShardID shard : shards) {
-    shard_states_[shard] = ShardState();
+  for (size_t i = 0; i < shards.size(); ++i) {
+    shard_states_[shards[i]].idx = i;
   }
   graylisting_enabled_.store(grayListingEnabledInSettings());
 }
@@ -70,7 +71,7 @@ NodeSetState::getNotAvailableUntil(ShardID shard) const {
     return std::chrono::steady_clock::time_point::min();
   }
 
-  ShardState n = it->second.load();
+  ShardState n = it->second.state.load();
   return n.getReason() == NotAvailableReason::NONE
       ? std::chrono::steady_clock::time_point::min()
       : n.getTimePoint();
@@ -91,7 +92,7 @@ NodeSetState::getNotAvailableReason(ShardID shard) const {
     ld_check(false);
     return NotAvailableReason::NONE;
   }
-  return it->second.load().getReason();
+  return it->second.state.load().getReason();
 }
 
 void NodeSetState::postHealthCheckRequest(ShardID shard,
@@ -128,7 +129,7 @@ void NodeSetState::checkAndSendSpaceBasedTrims() {
   ShardState old_state;
   std::string nodes_with_less_space;
   for (const auto& it : shard_states_) {
-    old_state = it.second.load();
+    old_state = it.second.state.load();
     if (old_state.getReason() == NotAvailableReason::LOW_WATERMARK_NOSPC ||
         old_state.getReason() == NotAvailableReason::NO_SPC) {
       nodes_with_less_space += it.first.toString() + ", ";
@@ -260,28 +261,33 @@ bool NodeSetState::shouldPerformSpaceBasedRetention() const {
 std::chrono::steady_clock::time_point NodeSetState::checkNotAvailableUntil(
     ShardID shard,
     std::chrono::steady_clock::time_point now) {
+  if (now.time_since_epoch() > next_trimming_check_.load()) {
+    // Attempt to initiate Space based trimming on the nodeset.
+    // We need to do this irrespective of whether 'shard' is in
+    // the low-space state or not.
+    checkAndSendSpaceBasedTrims();
+    atomic_fetch_max(next_trimming_check_,
+                     getDeadline(NotAvailableReason::LOW_WATERMARK_NOSPC)
+                         .time_since_epoch());
+  }
+
+  if (allShardsAvailable()) {
+    ld_assert(shard_states_.count(shard));
+    return std::chrono::steady_clock::time_point::min();
+  }
+
   auto it = shard_states_.find(shard);
   if (it == shard_states_.end()) {
     ld_check(false);
     return std::chrono::steady_clock::time_point::min();
   }
 
-  shard_state_atomic_t& state = it->second;
+  shard_state_atomic_t& state = it->second.state;
   ShardState old_state = state.load();
   NotAvailableReason old_reason;
   std::chrono::steady_clock::time_point tp;
   ShardState new_state = ShardState();
 
-  if (now.time_since_epoch() > next_trimming_check_.load()) {
-    // Attempt to initiate Space based trimming on the nodeset.
-    // We need to do this irrespective of whether 'shard' is in
-    // the low-space state or not.
-    checkAndSendSpaceBasedTrims();
-    atomic_fetch_max(next_trimming_check_,
-                     getDeadline(NotAvailableReason::LOW_WATERMARK_NOSPC)
-                         .time_since_epoch());
-  }
-
   do {
     old_reason = old_state.getReason();
     if (consideredAvailable(old_reason)) {
@@ -310,6 +316,7 @@ std::chrono::steady_clock::time_point NodeSetState::checkNotAvailableUntil(
           ShardState(NotAvailableReason::PROBING, tp.time_since_epoch());
     }
   } while (!state.compare_exchange_strong(old_state, new_state));
+  updateUnavailableBit(it->second);
 
   ld_spew("Shard %s transitioned from %s to %s for log:%lu",
           shard.toString().c_str(),
@@ -365,7 +372,7 @@ std::chrono::steady_clock::time_point NodeSetState::checkNotAvailableUntil(
 
 void NodeSetState::resetGrayList(GrayListResetReason r) {
   for (auto& s : shard_states_) {
-    ShardState cur_state = s.second.load();
+    ShardState cur_state = s.second.state.load();
     if (cur_state.getReason() == NotAvailableReason::SLOW) {
       clearNotAvailableUntil(s.first);
     }
@@ -409,12 +416,13 @@ void NodeSetState::clearNotAvailableUntil(ShardID shard) {
     return;
   }
 
-  shard_state_atomic_t& state = it->second;
+  shard_state_atomic_t& state = it->second.state;
   ShardState old_state = state.exchange(ShardState());
   NotAvailableReason reason = old_state.getReason();
   if (reason == NotAvailableReason::NONE) {
     return;
   }
+  updateUnavailableBit(it->second);
 
   // must have done a reset from an unavailable state
   ld_check(!consideredAvailable(reason));
@@ -469,7 +477,7 @@ bool NodeSetState::setNotAvailableUntil(
     return false;
   }
 
-  shard_state_atomic_t& state = it->second;
+  shard_state_atomic_t& state = it->second.state;
   ShardState old_state = state.load();
   // new state to store
   const ShardState new_state =
@@ -520,6 +528,7 @@ bool NodeSetState::setNotAvailableUntil(
         break;
     }
   } while (!state.compare_exchange_strong(old_state, new_state));
+  updateUnavailableBit(it->second);
 
   ld_check(old_reason == NotAvailableReason::PROBING ||
            consideredAvailable(old_reason) ||
@@ -555,6 +564,31 @@ NodeSetState::numNotAvailableShards(NotAvailableReason reason) const {
   return rv;
 }
 
+bool NodeSetState::allShardsAvailable() const {
+  for (const auto& word : unavailable_bits_) {
+    if (word.load() != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void NodeSetState::updateUnavailableBit(const ShardEntry& entry) {
+  std::atomic<uint64_t>& word = unavailable_bits_[entry.idx / 64];
+  const uint64_t bit = uint64_t(1) << (entry.idx % 64);
+  if (!consideredAvailable(entry.state.load().getReason())) {
+    word.fetch_or(bit);
+    return;
+  }
+  word.fetch_and(~bit);
+  // Another thread may have made the shard unavailable and set the bit
+  // between our change of the state and clearing the bit. Setting the bit
+  // back is enough, as that thread sets it after its own change of the state.
+  if (!consideredAvailable(entry.state.load().getReason())) {
+    word.fetch_or(bit);
+  }
+}
+
 void NodeSetState::refreshStates() {
   std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
 
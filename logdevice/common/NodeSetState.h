@@ -11,6 +11,7 @@
 #include <cstddef>
 #include <limits>
 #include <unordered_map>
+#include <vector>
 
 #include "logdevice/common/NodeID.h"
 #include "logdevice/common/ShardID.h"
@@ -207,6 +208,13 @@ class NodeSetState : public std::enable_shared_from_this<NodeSetState> {
   virtual nodeset_ssize_t
   numNotAvailableShards(NotAvailableReason reason) const;
 
+  /**
+   * @return true if no shard is marked as not available for a reason for
+   *         which consideredAvailable() is false. Cheaper than asking about
+   *         every shard.
+   */
+  bool allShardsAvailable() const;
+
   size_t numShards() const {
     return all_shards_cnt_;
   }
@@ -314,6 +322,12 @@ class NodeSetState : public std::enable_shared_from_this<NodeSetState> {
 
   using shard_state_atomic_t = std::atomic<ShardState>;
 
+  struct ShardEntry {
+    shard_state_atomic_t state{ShardState()};
+    // Position of the shard's bit in unavailable_bits_.
+    size_t idx{0};
+  };
+
   // total number of nodes in cluster configuration that belong to this
   // NodeSet, excluding those with zero weight
   size_t all_shards_cnt_;
@@ -322,11 +336,20 @@ class NodeSetState : public std::enable_shared_from_this<NodeSetState> {
   // of the node and update node's state to PROBING
   NodeSetState::HealthCheck healthCheck_;
 
-  // An auxiliary map of node index to shard_state_atomic_t
+  // An auxiliary map of node index to ShardEntry
   // Keys of the map are fixed after construction and the map is
   // considered as thread-safe.
-  std::unordered_map<ShardID, shard_state_atomic_t, ShardID::Hash>
-      shard_states_;
+  std::unordered_map<ShardID, ShardEntry, ShardID::Hash> shard_states_;
+
+  // One bit per shard, set if the shard's ShardState is not
+  // consideredAvailable(). Updated by updateUnavailableBit() after every
+  // change of a ShardState. Lets checkNotAvailableUntil() skip looking up the
+  // shard while the whole nodeset is available, which is the common case.
+  std::vector<std::atomic<uint64_t>> unavailable_bits_;
+
+  // Sets or clears the bit of the shard in unavailable_bits_ to match its
+  // current ShardState.
+  void updateUnavailableBit(const ShardEntry& entry);
 
   // No. of different types of nodes that are available/not-available.
   // This is an array of NotAvailableReason::Count elments of type
@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/NumaTopology.h"
+
+#include <sched.h>
+#include <sys/sysmacros.h>
+
+#include <boost/filesystem.hpp>
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/Format.h>
+#include <folly/String.h>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+bool readTrimmed(const std::string& path, std::string* out) {
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    return false;
+  }
+  *out = folly::trimWhitespace(contents).str();
+  return true;
+}
+
+} // namespace
+
+NumaTopology NumaTopology::detect(const std::string& sysfs_root) {
+  NumaTopology topology;
+  topology.sysfs_root_ = sysfs_root;
+
+  const fs::path node_dir = fs::path(sysfs_root) / "devices/system/node";
+  boost::system::error_code ec;
+  fs::directory_iterator it(node_dir, ec);
+  if (ec) {
+    ld_info("No NUMA information in %s: %s",
+            node_dir.c_str(),
+            ec.message().c_str());
+    return topology;
+  }
+  for (; it != fs::directory_iterator(); it.increment(ec)) {
+    if (ec) {
+      break;
+    }
+    const std::string name = it->path().filename().string();
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0) {
+      continue;
+    }
+    auto node = folly::tryTo<int>(name.substr(4));
+    if (!node.hasValue()) {
+      continue;
+    }
+    std::string list;
+    std::vector<int> cpus;
+    if (!readTrimmed((it->path() / "cpulist").string(), &list) ||
+        parseCPUList(list, &cpus) != 0) {
+      ld_warning("Failed to read CPUs of NUMA node %d from %s",
+                 node.value(),
+                 it->path().c_str());
+      continue;
+    }
+    if (!cpus.empty()) {
+      // Memory-only nodes are of no use for placing threads.
+      topology.cpus_[node.value()] = std::move(cpus);
+    }
+  }
+  return topology;
+}
+
+std::vector<int> NumaTopology::nodes() const {
+  std::vector<int> res;
+  for (const auto& kv : cpus_) {
+    res.push_back(kv.first);
+  }
+  return res;
+}
+
+std::vector<int> NumaTopology::cpusOfNode(int node) const {
+  auto it = cpus_.find(node);
+  return it == cpus_.end() ? std::vector<int>() : it->second;
+}
+
+int NumaTopology::nodeOfBlockDevice(dev_t dev) const {
+  const fs::path dev_dir = fs::path(sysfs_root_) /
+      folly::sformat("dev/block/{}:{}", major(dev), minor(dev));
+  // Whole disks have the PCI device (or, for NVMe, the controller whose
+  // parent is the PCI device) under device/. Partitions only have it in
+  // their parent directory.
+  for (const char* candidate : {"device/numa_node",
+                                "device/device/numa_node",
+                                "../device/numa_node",
+                                "../device/device/numa_node"}) {
+    std::string contents;
+    if (!readTrimmed((dev_dir / candidate).string(), &contents)) {
+      continue;
+    }
+    auto node = folly::tryTo<int>(contents);
+    // The kernel reports -1 if the device has no affinity.
+    if (node.hasValue() && node.value() >= 0) {
+      return node.value();
+    }
+  }
+  return -1;
+}
+
+folly::Optional<NumaTopology::NodeStats>
+NumaTopology::readNodeStats(int node) const {
+  const std::string path = folly::sformat(
+      "{}/devices/system/node/node{}/numastat", sysfs_root_, node);
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    return folly::none;
+  }
+
+  NodeStats stats;
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', contents, lines, /* ignoreEmpty */ true);
+  for (folly::StringPiece line : lines) {
+    folly::StringPiece name, value;
+    if (!folly::split(' ', line, name, value)) {
+      continue;
+    }
+    auto val = folly::tryTo<uint64_t>(folly::trimWhitespace(value));
+    if (!val.hasValue()) {
+      continue;
+    }
+    if (name == "numa_hit") {
+      stats.numa_hit = val.value();
+    } else if (name == "numa_miss") {
+      stats.numa_miss = val.value();
+    } else if (name == "numa_foreign") {
+      stats.numa_foreign = val.value();
+    } else if (name == "interleave_hit") {
+      stats.interleave_hit = val.value();
+    } else if (name == "local_node") {
+      stats.local_node = val.value();
+    } else if (name == "other_node") {
+      stats.other_node = val.value();
+    }
+  }
+  return stats;
+}
+
+int NumaTopology::parseCPUList(const std::string& list,
+                               std::vector<int>* out) {
+  ld_check(out);
+  std::vector<int> cpus;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', list, ranges, /* ignoreEmpty */ true);
+  for (folly::StringPiece range : ranges) {
+    folly::StringPiece lo_str, hi_str;
+    if (!folly::split('-', range, lo_str, hi_str)) {
+      lo_str = hi_str = range;
+    }
+    auto lo = folly::tryTo<int>(folly::trimWhitespace(lo_str));
+    auto hi = folly::tryTo<int>(folly::trimWhitespace(hi_str));
+    if (!lo.hasValue() || !hi.hasValue() || lo.value() < 0 ||
+        lo.value() > hi.value()) {
+      return -1;
+    }
+    for (int cpu = lo.value(); cpu <= hi.value(); ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  *out = std::move(cpus);
+  return 0;
+}
+
+int NumaTopology::setThreadAffinity(pthread_t thread,
+                                    const std::vector<int>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  int rv = pthread_setaffinity_np(thread, sizeof(set), &set);
+  if (rv != 0) {
+    ld_error("pthread_setaffinity_np() failed: %s", strerror(rv));
+    return -1;
+  }
+  return 0;
+}
+
+}} // namespace facebook::logdevice
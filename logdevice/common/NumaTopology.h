@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <pthread.h>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include <folly/Optional.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file NUMA nodes of the host and the CPUs that belong to them, as reported
+ *       by sysfs. Used by --numa-aware-placement to keep the threads of a
+ *       shard (and, by first-touch allocation, the memory they allocate) on
+ *       the socket that the shard's disk is attached to.
+ *
+ *       No libnuma dependency: everything needed is in
+ *       /sys/devices/system/node and /sys/dev/block. On hosts without NUMA
+ *       information the topology has no nodes and nothing is pinned.
+ */
+
+class NumaTopology {
+ public:
+  // Counters from /sys/devices/system/node/node<N>/numastat, in pages.
+  struct NodeStats {
+    uint64_t numa_hit = 0;
+    uint64_t numa_miss = 0;
+    uint64_t numa_foreign = 0;
+    uint64_t interleave_hit = 0;
+    uint64_t local_node = 0;
+    uint64_t other_node = 0;
+  };
+
+  /**
+   * Reads the topology of this host.
+   *
+   * @param sysfs_root  sysfs mount point; tests point it at a fake tree.
+   */
+  static NumaTopology detect(const std::string& sysfs_root = "/sys");
+
+  // IDs of NUMA nodes that have CPUs, in increasing order.
+  std::vector<int> nodes() const;
+
+  size_t numNodes() const {
+    return cpus_.size();
+  }
+
+  // CPUs of the given node, empty if the node is unknown.
+  std::vector<int> cpusOfNode(int node) const;
+
+  /**
+   * @return NUMA node the given block device (e.g. st_dev of a file on it)
+   *         is attached to, or -1 if sysfs doesn't say.
+   */
+  int nodeOfBlockDevice(dev_t dev) const;
+
+  // Counters of the given node, folly::none if they can't be read.
+  folly::Optional<NodeStats> readNodeStats(int node) const;
+
+  /**
+   * Parses a CPU list in the kernel's format, e.g. "0-3,8,10-11".
+   *
+   * @return 0 on success, -1 if `list` is malformed.
+   */
+  static int parseCPUList(const std::string& list, std::vector<int>* out);
+
+  /**
+   * Restricts the given thread to the given CPUs.
+   *
+   * @return 0 on success, -1 on failure (the error is logged).
+   */
+  static int setThreadAffinity(pthread_t thread, const std::vector<int>& cpus);
+
+ private:
+  std::string sysfs_root_;
+  // Node ID -> CPUs.
+  std::map<int, std::vector<int>> cpus_;
+};
+
+}} // namespace facebook::logdevice
@@ -12,9 +12,11 @@
 #include <event2/buffer.h>
 
 #include "logdevice/common/EventLoop.h"
+#include "logdevice/common/Worker.h"
 #include "logdevice/common/libevent/compat.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/stats/Stats.h"
 namespace facebook { namespace logdevice {
 
 PayloadHolder::PayloadHolder(struct evbuffer* payload)
@@ -28,6 +30,12 @@ PayloadHolder::PayloadHolder(struct evbuffer* payload)
   }
 
   size_t size = payload_evbuffer_->length();
+  // The payload was moved out of the socket's input buffer without copying,
+  // but pullup copies it if it spans several chains of the evbuffer.
+  if (LD_EV(evbuffer_peek)(payload_evbuffer_->get(), -1, nullptr, nullptr, 0) >
+      1) {
+    WORKER_STAT_ADD(payload_bytes_linearized_on_receive, size);
+  }
   payload_flat_ =
       Payload(LD_EV(evbuffer_pullup)(payload_evbuffer_->get(), size), size);
 
@@ -57,9 +65,26 @@ size_t PayloadHolder::size() const {
 void PayloadHolder::serialize(ProtocolWriter& writer) const {
   ld_check(payload_flat_.size() < Message::MAX_LEN); // must have been checked
                                                      // by upper layers
+  if (!writer.isBlackHole()) {
+    WORKER_STAT_ADD(payload_bytes_copied_on_send, payload_flat_.size());
+  }
   writer.write(payload_flat_.data(), payload_flat_.size());
 }
 
+void PayloadHolder::serializeWithoutCopy(ProtocolWriter& writer) const {
+  // Payloads we don't own may be freed by their owner before the evbuffer is
+  // drained, so they are copied.
+  if (!owner() || payload_flat_.size() <= MAX_COPY_TO_EVBUFFER_PAYLOAD_SIZE) {
+    serialize(writer);
+    return;
+  }
+  ld_check(payload_flat_.size() < Message::MAX_LEN);
+  if (!writer.isBlackHole()) {
+    WORKER_STAT_ADD(payload_bytes_sent_by_reference, payload_flat_.size());
+  }
+  writer.writeWithoutCopy(payload_flat_.data(), payload_flat_.size());
+}
+
 /* static */
 PayloadHolder PayloadHolder::deserialize(ProtocolReader& reader,
                                          size_t payload_size,
@@ -89,6 +114,7 @@ PayloadHolder PayloadHolder::deserialize(ProtocolReader& reader,
     }
     reader.read(payload_flat, payload_size);
     if (!reader.error()) {
+      WORKER_STAT_ADD(payload_bytes_copied_on_receive, payload_size);
       return PayloadHolder{payload_flat, payload_size};
     }
   }
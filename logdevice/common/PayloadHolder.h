@@ -128,6 +128,16 @@ class PayloadHolder {
    */
   void serialize(ProtocolWriter& writer) const;
 
+  /**
+   * Like serialize(), but payloads larger than
+   * MAX_COPY_TO_EVBUFFER_PAYLOAD_SIZE that this PayloadHolder owns are added
+   * to the evbuffer by reference instead of being copied (see
+   * ProtocolWriter::writeWithoutCopy()). The caller must keep this
+   * PayloadHolder alive and unchanged until the written data is consumed,
+   * typically by having the Message being sent share ownership of it.
+   */
+  void serializeWithoutCopy(ProtocolWriter& writer) const;
+
   /**
    * Deserialze by constructing a PayloadHolder object from evbuffer. Note that
    * evbuffer might get changed after the call.
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/PerfCounters.h"
+
+#include <cstring>
+
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+PerfCounterValues& PerfCounterValues::operator+=(const PerfCounterValues& rhs) {
+  cycles += rhs.cycles;
+  instructions += rhs.instructions;
+  llc_misses += rhs.llc_misses;
+  context_switches += rhs.context_switches;
+  return *this;
+}
+
+PerfCounterValues PerfCounterValues::
+operator-(const PerfCounterValues& rhs) const {
+  PerfCounterValues res;
+  res.cycles = cycles - rhs.cycles;
+  res.instructions = instructions - rhs.instructions;
+  res.llc_misses = llc_misses - rhs.llc_misses;
+  res.context_switches = context_switches - rhs.context_switches;
+  return res;
+}
+
+#ifdef __linux__
+
+namespace {
+
+int openCounter(uint32_t type, uint64_t config, int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // pid 0 and cpu -1: the calling thread, on any CPU.
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+} // namespace
+
+ThreadPerfCounters::ThreadPerfCounters() {
+  fds_.fill(-1);
+  const std::pair<uint32_t, uint64_t> events[MAX] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+  };
+  for (int i = 0; i < MAX; ++i) {
+    // The first counter that opens leads the group.
+    int fd = openCounter(events[i].first, events[i].second, leader_fd_);
+    if (fd < 0) {
+      ld_debug("perf_event_open() failed for counter %d: %s",
+               i,
+               strerror(errno));
+      continue;
+    }
+    if (leader_fd_ < 0) {
+      leader_fd_ = fd;
+    }
+    fds_[num_open_] = fd;
+    order_[num_open_] = static_cast<Counter>(i);
+    ++num_open_;
+  }
+  if (!isOpen()) {
+    ld_warning("Could not open any performance counter for this thread. "
+               "Check /proc/sys/kernel/perf_event_paranoid.");
+  }
+}
+
+ThreadPerfCounters::~ThreadPerfCounters() {
+  for (int i = 0; i < num_open_; ++i) {
+    close(fds_[i]);
+  }
+}
+
+void ThreadPerfCounters::read(PerfCounterValues& out) const {
+  if (!isOpen()) {
+    return;
+  }
+  // PERF_FORMAT_GROUP layout: number of counters, then their values.
+  uint64_t buf[1 + MAX];
+  ssize_t rv = ::read(leader_fd_, buf, sizeof(buf));
+  if (rv < static_cast<ssize_t>(sizeof(uint64_t)) ||
+      buf[0] > static_cast<uint64_t>(num_open_)) {
+    return;
+  }
+  for (size_t i = 0; i < buf[0]; ++i) {
+    const uint64_t value = buf[1 + i];
+    switch (order_[i]) {
+      case CYCLES:
+        out.cycles = value;
+        break;
+      case INSTRUCTIONS:
+        out.instructions = value;
+        break;
+      case LLC_MISSES:
+        out.llc_misses = value;
+        break;
+      case CONTEXT_SWITCHES:
+        out.context_switches = value;
+        break;
+      case MAX:
+        break;
+    }
+  }
+}
+
+#else
+
+ThreadPerfCounters::ThreadPerfCounters() {
+  fds_.fill(-1);
+}
+
+ThreadPerfCounters::~ThreadPerfCounters() {}
+
+void ThreadPerfCounters::read(PerfCounterValues& /* out */) const {}
+
+#endif
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Hardware and kernel performance counters of the calling thread, read
+ *       with perf_event_open(2). Used by --enable-perf-counters to attribute
+ *       cycles, instructions, last level cache misses and context switches
+ *       to what worker and storage threads were doing, so that a regression
+ *       can be told apart as more work, worse cache behaviour or more
+ *       blocking.
+ *
+ *       All counters are opened as one group and read with a single read(2).
+ *       Counters the kernel or the hardware doesn't support (e.g. hardware
+ *       events in most VMs, or perf_event_paranoid > 2) stay at zero. Only
+ *       user-space events of the calling thread are counted.
+ */
+
+struct PerfCounterValues {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  uint64_t llc_misses{0};
+  uint64_t context_switches{0};
+
+  PerfCounterValues& operator+=(const PerfCounterValues& rhs);
+
+  // Counters are monotonic, so this is how much happened between two reads.
+  PerfCounterValues operator-(const PerfCounterValues& rhs) const;
+};
+
+class ThreadPerfCounters {
+ public:
+  /**
+   * Opens the counters for the calling thread. Must be read from that thread
+   * only.
+   */
+  ThreadPerfCounters();
+  ~ThreadPerfCounters();
+
+  ThreadPerfCounters(const ThreadPerfCounters&) = delete;
+  ThreadPerfCounters& operator=(const ThreadPerfCounters&) = delete;
+
+  /**
+   * @return false if none of the counters could be opened.
+   */
+  bool isOpen() const {
+    return leader_fd_ >= 0;
+  }
+
+  /**
+   * Reads the current values of the counters. Leaves `out` untouched if the
+   * counters are not open or the read fails.
+   */
+  void read(PerfCounterValues& out) const;
+
+ private:
+  enum Counter { CYCLES = 0, INSTRUCTIONS, LLC_MISSES, CONTEXT_SWITCHES, MAX };
+
+  int leader_fd_ = -1;
+  // fds of the counters in the order they were added to the group, which is
+  // the order read() gets their values in.
+  std::array<int, MAX> fds_;
+  std::array<Counter, MAX> order_;
+  int num_open_ = 0;
+};
+
+}} // namespace facebook::logdevice
@@ -28,6 +28,7 @@
 #include "logdevice/common/MetaDataLogWriter.h"
 #include "logdevice/common/NodesConfigurationPublisher.h"
 #include "logdevice/common/NoopTraceLogger.h"
+#include "logdevice/common/NumaTopology.h"
 #include "logdevice/common/PermissionChecker.h"
 #include "logdevice/common/Request.h"
 #include "logdevice/common/SecurityInformation.h"
@@ -41,6 +42,7 @@
 #include "logdevice/common/WheelTimer.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/WorkerLoadBalancing.h"
+#include "logdevice/common/buffered_writer/ZstdDictionaries.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/configuration/nodes/NodesConfigurationManager.h"
 #include "logdevice/common/event_log/EventLogRebuildingSet.h"
@@ -50,6 +52,7 @@
 #include "logdevice/common/stats/ServerHistograms.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/types_internal.h"
+#include "logdevice/common/work_model/CPUOffloadPool.h"
 #include "logdevice/include/Err.h"
 
 namespace {
@@ -173,6 +176,7 @@ Processor::Processor(std::shared_ptr<UpdateableConfig> updateable_config,
       sequencer_locator_(get_sequencer_locator(plugin_registry_, config_)),
       conn_budget_incoming_(settings_->max_incoming_connections),
       conn_budget_external_(settings_->max_external_connections),
+      config_changed_budget_(settings_->max_config_changed_in_flight),
       api_hits_tracer_(std::make_unique<ClientAPIHitsTracer>(trace_logger)),
       HELLOCredentials_(settings_->server ? Principal::CLUSTER_NODE
                                           : std::move(credentials)),
@@ -202,6 +206,15 @@ void Processor::init() {
 
   num_general_workers_ = local_settings->num_workers;
 
+  if (!local_settings->zstd_dictionaries_dir.empty() &&
+      ZstdDictionaries::get().loadDirectory(
+          local_settings->zstd_dictionaries_dir) < 0) {
+    ld_error("Failed to load zstd dictionaries from %s",
+             local_settings->zstd_dictionaries_dir.c_str());
+    err = E::INVALID_CONFIG;
+    throw ConstructorFailed();
+  }
+
   auto config = config_->get();
   // It's important to set the initial cluster state before we start the
   // workers since some of the timers in the worker (NodeStatsController) will
@@ -236,6 +249,13 @@ void Processor::init() {
                                            settings_->watchdog_bt_ratelimit);
     }
 
+    if (settings_->cpu_offload_threads > 0) {
+      cpu_offload_pool_ =
+          std::make_unique<CPUOffloadPool>(settings_->cpu_offload_threads,
+                                           settings_->cpu_offload_queue_size,
+                                           stats_);
+    }
+
     // Now that workers are running, we can initialize SequencerBatching
     // (which waits for all workers to process a Request).  It would be nice
     // to do this lazily only when sequencer batching is actually on, however
@@ -259,6 +279,22 @@ workers_t Processor::createWorkerPool(WorkerType type, size_t count) {
   workers_t workers;
   workers.reserve(count);
 
+  // Each worker serves all shards, so there is no node that is right for a
+  // particular worker. Spreading them evenly keeps each worker's memory on
+  // the node it runs on instead of wherever the scheduler happened to put it.
+  std::vector<int> numa_nodes;
+  NumaTopology topology;
+  if (local_settings->server && local_settings->numa_aware_placement &&
+      type == WorkerType::GENERAL) {
+    topology = NumaTopology::detect();
+    if (topology.numNodes() > 1) {
+      numa_nodes = topology.nodes();
+      ld_info("Spreading %zu workers across %zu NUMA nodes",
+              count,
+              numa_nodes.size());
+    }
+  }
+
   for (int i = 0; i < count; i++) {
     // increment the next worker idx
     std::unique_ptr<Worker> worker;
@@ -269,6 +305,11 @@ workers_t Processor::createWorkerPool(WorkerType type, size_t count) {
           ThreadID::CPU_EXEC,
           local_settings->worker_request_pipe_capacity,
           local_settings->requests_per_iteration));
+      if (!numa_nodes.empty()) {
+        NumaTopology::setThreadAffinity(
+            loops.back()->getThread(),
+            topology.cpusOfNode(numa_nodes[i % numa_nodes.size()]));
+      }
       auto executor = folly::getKeepAliveToken(loops.back().get());
       worker.reset(createWorker(std::move(executor), worker_id_t(i), type));
     } catch (ConstructorFailed&) {
@@ -297,7 +338,8 @@ Processor::Processor(std::shared_ptr<UpdateableConfig> updateable_config,
                               settings,
                               std::make_shared<NoopTraceLogger>(config_))),
       conn_budget_incoming_(settings_.get()->max_incoming_connections),
-      conn_budget_external_(settings_.get()->max_external_connections) {
+      conn_budget_external_(settings_.get()->max_external_connections),
+      config_changed_budget_(settings_.get()->max_config_changed_in_flight) {
   ld_check(settings.get());
   num_general_workers_ = settings_->num_workers;
 }
@@ -534,6 +576,12 @@ void Processor::shutdown() {
     watchdog_thread_->shutdown();
   }
 
+  if (cpu_offload_pool_) {
+    // Runs what's queued, whose results get posted to Workers, which are
+    // still accepting work.
+    cpu_offload_pool_->shutdown();
+  }
+
   if (impl_->allSequencers_) {
     impl_->allSequencers_->shutdown();
   }
@@ -594,6 +642,10 @@ worker_id_t Processor::selectWorkerLoadAware() {
   return impl_->worker_load_balancing_.selectWorker();
 }
 
+double Processor::getRelativeLoad(worker_id_t idx) const {
+  return impl_->worker_load_balancing_.getRelativeLoad(idx);
+}
+
 void Processor::reportLoad(worker_id_t idx,
                            int64_t load,
                            WorkerType worker_type) {
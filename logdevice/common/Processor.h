@@ -64,6 +64,7 @@ class TrafficShaper;
 class UpdateableConfig;
 class UpdateableSecurityInfo;
 class WatchDogThread;
+class CPUOffloadPool;
 class Worker;
 class WheelTimer;
 class Configuration;
@@ -506,6 +507,10 @@ class Processor : public folly::enable_shared_from_this<Processor> {
   // A thread running on server side to detect worker stalls
   std::unique_ptr<WatchDogThread> watchdog_thread_;
 
+  // Threads that Workers hand CPU-bound work to, see
+  // Worker::offloadCPUWork(). nullptr unless --cpu-offload-threads is set.
+  std::unique_ptr<CPUOffloadPool> cpu_offload_pool_;
+
   // ResourceBudget used to limit the total number of accepted connections.
   // See Settings::max_incoming_connections_.
   ResourceBudget conn_budget_incoming_;
@@ -514,6 +519,11 @@ class Processor : public folly::enable_shared_from_this<Processor> {
   // See Settings::max_external_connections_.
   ResourceBudget conn_budget_external_;
 
+  // Limits the number of CONFIG_CHANGED messages carrying the full config
+  // that are queued or being sent to clients with a stale config.
+  // See Settings::max_config_changed_in_flight.
+  ResourceBudget config_changed_budget_;
+
   // Current rebuilding set. Unlike Worker::shard_status_, this is updated
   // immediately after receiving an event log record, without any grace period.
   // nullptr on server means that we haven't yet caught up on the event log.
@@ -575,6 +585,12 @@ class Processor : public folly::enable_shared_from_this<Processor> {
    */
   worker_id_t selectWorkerLoadAware();
 
+  /**
+   * Load of a GENERAL worker relative to the average of all GENERAL workers,
+   * as last reported by them. See WorkerLoadBalancing::getRelativeLoad().
+   */
+  double getRelativeLoad(worker_id_t idx) const;
+
   /**
    * Proxy for WorkerLoadBalancing::reportLoad(), used by Worker to report
    * load.
@@ -8,9 +8,12 @@
 #include "logdevice/common/ReaderImpl.h"
 
 #include <chrono>
+#include <deque>
+#include <iterator>
 #include <thread>
 
 #include <folly/Memory.h>
+#include <folly/ScopeGuard.h>
 #include <sys/time.h>
 
 #include "logdevice/common/Processor.h"
@@ -36,12 +39,18 @@ class ReaderBridgeImpl : public ReaderBridge {
   int onDataRecord(read_stream_id_t,
                    std::unique_ptr<DataRecordOwnsPayload>&&,
                    bool notify_when_consumed) override;
+  int onDataRecords(read_stream_id_t,
+                    std::vector<std::unique_ptr<DataRecord>>& records,
+                    bool notify_when_consumed) override;
   int onGapRecord(read_stream_id_t,
                   GapRecord,
                   bool notify_when_consumed) override;
 
  private:
   void maybeWakeConsumer();
+  // Number of records read() will return for `record', > 1 for buffered
+  // writes that read() decodes.
+  uint32_t countRecords(const DataRecordOwnsPayload& record) const;
   // Helper method, handles interactions with ReaderImpl for one QueueEntry
   // whether data or gap
   int onEntry(ReaderImpl::QueueEntry&& entry, bool notify_when_consumed);
@@ -489,6 +498,8 @@ ssize_t ReaderImpl::read(size_t nrecords,
       } else {
         read_handleData(head, state, data_out);
       }
+    } else if (head.getType() == QueueEntry::Type::BATCH) {
+      read_handleBatch(head, state, data_out);
     } else if (head.getType() == QueueEntry::Type::GAP) {
       bool break_loop;
       read_handleGap(head, state, gap_out, &break_loop);
@@ -614,6 +625,76 @@ void ReaderImpl::read_handleData(
   ++nread_;
 }
 
+void ReaderImpl::read_handleBatch(
+    QueueEntry& entry,
+    LogState* state,
+    std::vector<std::unique_ptr<DataRecord>>* data_out) {
+  QueueEntry::Batch& records = entry.getBatch();
+  ld_check(!records.empty());
+  const read_stream_id_t rsid = entry.getReadStreamID();
+  auto needs_decoding = [&](const DataRecord& record) {
+    return decode_buffered_writes_ && !without_payload_ &&
+        (static_cast<const DataRecordOwnsPayload&>(record).flags_ &
+         RECORD_Header::BUFFERED_WRITER_BLOB);
+  };
+
+  // Take records up to what the caller asked for, stopping before the first
+  // one that needs to be decoded.
+  const size_t limit = std::min(records.size(), nrecords_ - nread_);
+  size_t n = 0;
+  while (n < limit && !needs_decoding(*records[n])) {
+    ++n;
+  }
+
+  if (n > 0) {
+    if (n == records.size() && data_out->empty()) {
+      // The common case when reading fast: hand over the whole batch.
+      data_out->swap(records);
+    } else {
+      data_out->insert(data_out->end(),
+                       std::make_move_iterator(records.begin()),
+                       std::make_move_iterator(records.begin() + n));
+      records.erase(records.begin(), records.begin() + n);
+    }
+    nread_ += n;
+
+    if (wait_only_when_no_data_) {
+      // See read_handleData().
+      may_wait_ = false;
+    }
+
+    state->front_lsn = data_out->back()->attrs.lsn + 1;
+    if (state->front_lsn > state->until_lsn) {
+      // We reached the client-supplied `until` LSN.  ClientReadStream doesn't
+      // deliver anything past it, so this was the end of the batch.  See
+      // read_handleData().
+      ld_check(records.empty());
+      may_wait_ = false;
+      stopReading(state->log_id);
+      return;
+    }
+  }
+
+  if (records.empty()) {
+    return;
+  }
+
+  std::unique_ptr<DataRecordOwnsPayload> blob;
+  if (needs_decoding(*records.front())) {
+    blob.reset(static_cast<DataRecordOwnsPayload*>(records.front().release()));
+    records.erase(records.begin());
+  }
+  if (!records.empty()) {
+    // The rest goes first in the next iteration or read() call.
+    pre_queue_.push_front(std::move(entry));
+  }
+  if (blob) {
+    // Decoded records go in front of the rest of the batch.
+    QueueEntry blob_entry(rsid, std::move(blob), 1);
+    read_decodeBuffered(blob_entry);
+  }
+}
+
 void ReaderImpl::read_handleGap(QueueEntry& entry,
                                 LogState* state,
                                 GapRecord* gap_out,
@@ -652,10 +733,14 @@ void ReaderImpl::read_handleGap(QueueEntry& entry,
 }
 
 void ReaderImpl::read_decodeBuffered(QueueEntry& entry) {
-  // We only expect to see a buffered write come off the main queue.  Check
-  // this so that it doesn't matter if we push to the front or the back of
-  // pre_queue_.
-  ld_check(pre_queue_.empty());
+  // The decoded records (or the gap) go in front of whatever is already in
+  // pre_queue_, e.g. the rest of the batch that the buffered write came in.
+  std::deque<QueueEntry> decoded;
+  SCOPE_EXIT {
+    pre_queue_.insert(pre_queue_.begin(),
+                      std::make_move_iterator(decoded.begin()),
+                      std::make_move_iterator(decoded.end()));
+  };
 
   // Make a copy of attributes since we'll need them after we pass ownership
   // of `entry.getData()'
@@ -671,7 +756,7 @@ void ReaderImpl::read_decodeBuffered(QueueEntry& entry) {
   if (rv != 0) {
     // Whoops, decoding failed.  This is tragic and unlikely with checksums
     // but let's generate a DATALOSS gap to inform the client.
-    pre_queue_.emplace_back( // creating a QueueEntry
+    decoded.emplace_back( // creating a QueueEntry
         entry.getReadStreamID(),
         std::make_unique<GapRecord>(
             log_id, GapType::DATALOSS, attrs.lsn, attrs.lsn));
@@ -692,13 +777,13 @@ void ReaderImpl::read_decodeBuffered(QueueEntry& entry) {
         nullptr, // no rebuilding metadata
         decoder, // shared ownership of the decoder
         batch_offset++);
-    pre_queue_.emplace_back( // creating a QueueEntry
+    decoded.emplace_back( // creating a QueueEntry
         entry.getReadStreamID(),
         std::move(record),
         1);
     // Only allow read() to stop reading the log after consuming the last
     // record
-    pre_queue_.back().setAllowEndReading(&payload == &payloads.back());
+    decoded.back().setAllowEndReading(&payload == &payloads.back());
   }
 }
 
@@ -748,24 +833,29 @@ int ReaderBridgeImpl::onEntry(ReaderImpl::QueueEntry&& entry,
   return 0;
 }
 
-int ReaderBridgeImpl::onDataRecord(
-    read_stream_id_t rsid,
-    std::unique_ptr<DataRecordOwnsPayload>&& record,
-    bool notify_when_consumed) {
+uint32_t
+ReaderBridgeImpl::countRecords(const DataRecordOwnsPayload& record) const {
   uint32_t nrecords = 1;
-  if (record->flags_ & RECORD_Header::BUFFERED_WRITER_BLOB &&
+  if (record.flags_ & RECORD_Header::BUFFERED_WRITER_BLOB &&
       owner_->decode_buffered_writes_ && !owner_->without_payload_) {
     // This record's payload was composed by BufferedWriter. Extract the number
     // of individual records inside the batch in order to correctly determine
     // whether to wake up the consumer (e.g. if a single batch with 100 records
     // is received, read(100) should return immediately).
     size_t batch_size;
-    if (BufferedWriteDecoderImpl::getBatchSize(*record, &batch_size) == 0) {
+    if (BufferedWriteDecoderImpl::getBatchSize(record, &batch_size) == 0) {
       nrecords =
           std::min<size_t>(batch_size, std::numeric_limits<uint32_t>::max());
     }
   }
+  return nrecords;
+}
 
+int ReaderBridgeImpl::onDataRecord(
+    read_stream_id_t rsid,
+    std::unique_ptr<DataRecordOwnsPayload>&& record,
+    bool notify_when_consumed) {
+  const uint32_t nrecords = countRecords(*record);
   ReaderImpl::QueueEntry entry(rsid, std::move(record), nrecords);
   int rv = onEntry(std::move(entry), notify_when_consumed);
   if (rv != 0) {
@@ -774,6 +864,30 @@ int ReaderBridgeImpl::onDataRecord(
   return rv;
 }
 
+int ReaderBridgeImpl::onDataRecords(
+    read_stream_id_t rsid,
+    std::vector<std::unique_ptr<DataRecord>>& records,
+    bool notify_when_consumed) {
+  ld_check(!records.empty());
+  uint64_t nrecords = 0;
+  for (const auto& record : records) {
+    nrecords +=
+        countRecords(static_cast<const DataRecordOwnsPayload&>(*record));
+  }
+
+  auto batch = std::make_unique<ReaderImpl::QueueEntry::Batch>();
+  batch->swap(records);
+  ReaderImpl::QueueEntry entry(
+      rsid,
+      std::move(batch),
+      std::min<uint64_t>(nrecords, std::numeric_limits<uint32_t>::max()));
+  int rv = onEntry(std::move(entry), notify_when_consumed);
+  if (rv != 0) {
+    records.swap(entry.getBatch());
+  }
+  return rv;
+}
+
 int ReaderBridgeImpl::onGapRecord(read_stream_id_t rsid,
                                   GapRecord gap,
                                   bool notify_when_consumed) {
@@ -189,10 +189,13 @@ class ReaderImpl : public Reader {
 
   /**
    * This gets put on the MPMCQueue when ClientReadStream sends us something.
-   * Each entry wraps either a DataRecord or a GapRecord.
+   * Each entry wraps either a DataRecord, a batch of consecutive DataRecords
+   * of one log (see ReaderBridge::onDataRecords()) or a GapRecord.
    */
   struct QueueEntry : boost::noncopyable {
-    enum class Type : char { EMPTY, DATA, GAP };
+    enum class Type : char { EMPTY, DATA, GAP, BATCH };
+
+    using Batch = std::vector<std::unique_ptr<DataRecord>>;
 
     QueueEntry() : type_(Type::EMPTY) {}
 
@@ -208,6 +211,13 @@ class ReaderImpl : public Reader {
       u_.gap = gap.release();
     }
 
+    QueueEntry(read_stream_id_t rsid,
+               std::unique_ptr<Batch> batch,
+               uint32_t nrecords)
+        : rsid_(rsid), records_(nrecords), type_(Type::BATCH) {
+      u_.batch = batch.release();
+    }
+
     ~QueueEntry() {
       reset();
     }
@@ -256,6 +266,12 @@ class ReaderImpl : public Reader {
       return *u_.gap;
     }
 
+    Batch& getBatch() {
+      ld_check(type_ == Type::BATCH);
+      ld_check(u_.batch);
+      return *u_.batch;
+    }
+
     uint32_t getRecordCount() const {
       return records_;
     }
@@ -286,13 +302,14 @@ class ReaderImpl : public Reader {
     // entry with padding.  Without __attribute__((__packed__)) the total would
     // be 32 bytes due to padding and alignment.
     read_stream_id_t rsid_;
-    // We own either `data' or `gap' depending on `type_'.
+    // We own either `data', `gap' or `batch' depending on `type_'.
     union {
       DataRecordOwnsPayload* data;
       GapRecord* gap;
+      Batch* batch;
     } u_;
     // Number of records.  This is normally 1, but may be higher if u_.data was
-    // written using BufferedWriter.
+    // written using BufferedWriter, or for batches.
     uint32_t records_;
     Type type_ = Type::EMPTY;
     // Does ClientReadStream want us to notify it when we consume this entry?
@@ -309,6 +326,9 @@ class ReaderImpl : public Reader {
       } else if (type_ == Type::GAP) {
         delete u_.gap;
         u_.gap = nullptr;
+      } else if (type_ == Type::BATCH) {
+        delete u_.batch;
+        u_.batch = nullptr;
       }
     }
   } __attribute__((__packed__));
@@ -320,6 +340,7 @@ class ReaderImpl : public Reader {
   // - A gap that wasn't immediately delivered because we'd already delivered
   //   data records in the same read() call.
   // - Decoded BufferedWriter writes.
+  // - The rest of a batch that didn't fit in the previous read() call.
   std::deque<QueueEntry> pre_queue_;
 
   // The following members comprise the synchronization mechanism between
@@ -428,14 +449,19 @@ class ReaderImpl : public Reader {
   void read_handleData(QueueEntry& entry,
                        LogState* state,
                        std::vector<std::unique_ptr<DataRecord>>* data_out);
+  // Moves as many records of a batch as the current read() call can take into
+  // `data_out'. Leftovers, and records that need decoding, go to pre_queue_.
+  void read_handleBatch(QueueEntry& entry,
+                        LogState* state,
+                        std::vector<std::unique_ptr<DataRecord>>* data_out);
   void read_handleGap(QueueEntry& entry,
                       LogState* state,
                       GapRecord* gap_out,
                       bool* break_loop_out);
   // Handler for data records that come with the
   // RECORD_Header::BUFFERED_WRITER_BLOB flag set.  Decodes the blob and puts
-  // original records onto `pre_queue_'.  If decoding fails, a DATALOSS gap is
-  // generated instead.
+  // original records at the front of `pre_queue_'.  If decoding fails, a
+  // DATALOSS gap is generated instead.
   void read_decodeBuffered(QueueEntry& entry);
 
   friend class TestReader;
@@ -219,6 +219,15 @@ class ShardRebuildingInterface {
   // Can be called before start().
   virtual void advanceGlobalWindow(RecordTimestamp new_window_end) = 0;
 
+  // Progress of the donors of this shard as seen in the event log, and the
+  // highest progress this node has written to the event log so far. The
+  // latter must be called before the corresponding event is written.
+  // Used for --rebuilding-donor-takeover-lag. Can be called before start().
+  virtual void noteDonorProgress(
+      std::unordered_map<node_index_t, RecordTimestamp> /* donor_progress */) {
+  }
+  virtual void noteMyReportedProgress(RecordTimestamp /* progress */) {}
+
   virtual void noteConfigurationChanged() = 0;
   virtual void noteRebuildingSettingsChanged() = 0;
 
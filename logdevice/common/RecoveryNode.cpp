@@ -216,6 +216,14 @@ void RecoveryNode::transition(State to) {
       break;
 
     case State::DIGESTED:
+      if (state_ == State::SEALED) {
+        // SEALED -> DIGESTED: EpochRecovery skipped the digest of this node
+        // because SEALED replies showed it would be empty
+        ld_check(!resend_->isActive());
+        ld_check(read_stream_id_ == READ_STREAM_ID_INVALID);
+        changeState(to);
+        break;
+      }
       ld_check(read_stream_id_ != READ_STREAM_ID_INVALID);
       read_stream_id_ = READ_STREAM_ID_INVALID;
 
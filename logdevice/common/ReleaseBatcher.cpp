@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ReleaseBatcher.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_RELEASE_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+ReleaseBatcher::ReleaseBatcher() = default;
+
+ReleaseBatcher::~ReleaseBatcher() = default;
+
+bool ReleaseBatcher::add(const RELEASE_Header& header, NodeID to) {
+  const Settings& settings = Worker::settings();
+  if (settings.release_batching_window.count() <= 0) {
+    return false;
+  }
+
+  folly::Optional<uint16_t> proto =
+      Worker::onThisThread()->sender().getSocketProtocolVersion(to.index());
+  if (!proto.hasValue() ||
+      proto.value() < Compatibility::MULTI_RELEASE_SUPPORT) {
+    return false;
+  }
+
+  Batch& batch = batches_[to.index()];
+  batch.to = to;
+  auto ins = batch.index.emplace(
+      ReleaseKey(header.rid.logid, header.shard, header.release_type),
+      batch.releases.size());
+  if (!ins.second) {
+    RELEASE_Header& pending = batch.releases[ins.first->second];
+    if (pending.rid.lsn() < header.rid.lsn()) {
+      pending.rid = header.rid;
+    }
+    return true;
+  }
+  batch.releases.push_back(header);
+  ++num_pending_;
+
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (batch.releases.size() >= settings.release_batching_max_releases) {
+    // Send on the next event loop iteration.
+    timer_.activate(std::chrono::microseconds::zero());
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.release_batching_window);
+  }
+  return true;
+}
+
+void ReleaseBatcher::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  num_pending_ = 0;
+  for (auto& kv : batches) {
+    send(std::move(kv.second));
+  }
+}
+
+void ReleaseBatcher::send(Batch batch) {
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+  auto& releases = batch.releases;
+  ld_check(!releases.empty());
+
+  if (releases.size() == 1) {
+    if (sender.sendMessage(std::make_unique<RELEASE_Message>(releases.front()),
+                           batch.to) != 0) {
+      RELEASE_Message::onSentCommon(releases.front(), err, to);
+    }
+    return;
+  }
+
+  const size_t num_releases = releases.size();
+  auto msg = std::make_unique<MULTI_RELEASE_Message>(std::move(releases));
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_RELEASE with %zu RELEASEs to %s: %s",
+                   num_releases,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    // sendMessage() doesn't consume the message on failure
+    msg->onSent(st, to);
+    return;
+  }
+
+  STAT_INCR(Worker::stats(), release_batches_sent);
+  STAT_ADD(Worker::stats(), release_batched_releases_sent, num_releases);
+}
+
+}} // namespace facebook::logdevice
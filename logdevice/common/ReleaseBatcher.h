@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/RELEASE_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-Worker coalescing of RELEASE messages that sequencers send to the
+ *       same storage node. When --release-batching-window is nonzero,
+ *       RELEASEs sent within the window to a node whose connection supports
+ *       MULTI_RELEASE are held back and then sent together in one
+ *       MULTI_RELEASE_Message (or as a plain RELEASE if there's only one).
+ *
+ *       Releases only move forward, so if a log's last released LSN advances
+ *       several times within the window, only the RELEASE for the highest LSN
+ *       is sent to each shard.
+ *
+ *       As with StoreBatcher, batches are only sent from the timer callback,
+ *       so that send failures reported to sequencers don't reenter them while
+ *       they are sending RELEASEs.
+ */
+
+class ReleaseBatcher {
+ public:
+  ReleaseBatcher();
+  ~ReleaseBatcher();
+
+  ReleaseBatcher(const ReleaseBatcher&) = delete;
+  ReleaseBatcher& operator=(const ReleaseBatcher&) = delete;
+
+  /**
+   * Takes a RELEASE that a sequencer wants to send to `to`, if it can be
+   * batched.
+   *
+   * The outcome of sending the RELEASE, including errors returned by
+   * Sender::sendMessage() when the batch is sent, is reported through
+   * RELEASE_Message::onSentCommon(). A RELEASE superseded by a later one for
+   * the same log and shard is not reported.
+   *
+   * @return  true if `header` was taken. false if batching is disabled or
+   *          `to` hasn't negotiated a protocol with MULTI_RELEASE support yet;
+   *          the caller should send a RELEASE_Message directly.
+   */
+  bool add(const RELEASE_Header& header, NodeID to);
+
+  // Number of RELEASEs waiting to be sent.
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  using ReleaseKey = std::tuple<logid_t, shard_index_t, ReleaseType>;
+
+  struct Batch {
+    NodeID to;
+    std::vector<RELEASE_Header> releases;
+    // index in `releases` of the RELEASE for each log, shard and type
+    std::map<ReleaseKey, size_t> index;
+  };
+
+  // Sends all pending batches.
+  void flush();
+
+  void send(Batch batch);
+
+  std::unordered_map<node_index_t, Batch> batches_;
+  size_t num_pending_ = 0;
+
+  // Fires when the oldest pending RELEASE has waited for
+  // --release-batching-window, or right away if a batch grew too big.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -77,15 +77,44 @@ bool RequestPump::check(const std::unique_ptr<Request>& req, bool force) {
   return true;
 }
 
-int RequestPump::post(std::unique_ptr<Request>& req) {
+int RequestPump::forcePostBatch(std::vector<std::unique_ptr<Request>>& reqs) {
+  for (const auto& req : reqs) {
+    if (!check(req, true)) {
+      return -1;
+    }
+  }
+  if (isShutdown()) {
+    err = E::SHUTDOWN;
+    return -1;
+  }
+  std::vector<std::pair<Func, int8_t>> funcs;
+  funcs.reserve(reqs.size());
+  for (auto& req : reqs) {
+    auto priority = req->getExecutorPriority();
+    funcs.emplace_back(wrap(req), priority);
+  }
+  // Requests are already moved into the functions, so failing here would
+  // lose them. This can only happen if shutdown() races with us, in which
+  // case the requests would have been dropped anyway.
+  int rv = addBatch(std::move(funcs));
+  for (const auto& req : reqs) {
+    ld_check(!req);
+  }
+  return rv;
+}
+
+Func RequestPump::wrap(std::unique_ptr<Request>& req) {
   req->enqueue_time_ = std::chrono::steady_clock::now();
   // Convert to folly function so that the request can be added
   // EventLoopTaskQueue.
-  auto priority = req->getExecutorPriority();
-  Func func = [req = std::move(req)]() mutable {
+  return [req = std::move(req)]() mutable {
     RequestPump::processRequest(req);
   };
-  int rv = addWithPriority(std::move(func), priority);
+}
+
+int RequestPump::post(std::unique_ptr<Request>& req) {
+  auto priority = req->getExecutorPriority();
+  int rv = addWithPriority(wrap(req), priority);
   ld_check(!req);
   return rv;
 }
@@ -69,6 +69,19 @@ class RequestPump : public EventLoopTaskQueue {
    */
   int forcePost(std::unique_ptr<Request>& req);
 
+  /**
+   * Like forcePost() but for several requests at once.  The whole batch is
+   * handed to EventLoopTaskQueue::addBatch(), so the EventLoop thread gets
+   * signalled once regardless of the number of requests.  On success all
+   * unique_ptrs in `reqs' are cleared; if validation fails or the pump is
+   * already shut down, `reqs' is left untouched.
+   *
+   * @return 0 on success, -1 on failures setting `err' to one of:
+   *     INVALID_PARAM  one of the requests is nullptr
+   *     SHUTDOWN       shutdown() was already called
+   */
+  int forcePostBatch(std::vector<std::unique_ptr<Request>>& reqs);
+
   /**
    * Runs a Request on the EventLoop, waiting for it to finish.
    *
@@ -88,6 +101,8 @@ class RequestPump : public EventLoopTaskQueue {
  private:
   bool check(const std::unique_ptr<Request>& req, bool force);
   int post(std::unique_ptr<Request>& req);
+  // Wraps the request into a function to be executed by processRequest().
+  static Func wrap(std::unique_ptr<Request>& req);
   /**
    * Called by enqueued folly function on this instance to process a request.
    */
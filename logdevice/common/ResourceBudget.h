@@ -141,6 +141,10 @@ class ResourceBudget {
     return limit_.load();
   }
 
+  uint64_t getUsed() const {
+    return used_.load();
+  }
+
  private:
   std::atomic<uint64_t> limit_, used_{0};
 };
@@ -48,7 +48,25 @@ enum class SCDCopysetReordering : uint8_t {
   // - If the workload is not bottlenecked by disk, HASH_SHUFFLE_CLIENT_SEED
   // enables multiple storage nodes to participate in reading the log.
   HASH_SHUFFLE_CLIENT_SEED = 2,
+  // Like HASH_SHUFFLE_CLIENT_SEED, but the seed is specific to the read
+  // stream rather than to the client session, and the shuffled copyset is
+  // then rotated by an offset that changes every
+  // SCD_ROTATION_LSN_BLOCK_SIZE LSNs.
+  // Reason: with HASH_SHUFFLE_CLIENT_SEED a block of records with the same
+  // copyset is still served to a given reader by a single storage node, so a
+  // hot reader going through a large block keeps that node busy. Rotating
+  // primary responsibility per block of LSNs spreads the load of every read
+  // stream across the nodes of the copyset. Each LSN still has exactly one
+  // primary, as the rotation only depends on the LSN and the seed.
+  // Requires all storage nodes to support
+  // Compatibility::SCD_LSN_BLOCK_ROTATION_SUPPORT.
+  HASH_SHUFFLE_LSN_BLOCK_ROTATION = 3,
   MAX
 };
 
+// Number of consecutive LSNs for which HASH_SHUFFLE_LSN_BLOCK_ROTATION keeps
+// the same primary. Changing this breaks SCD between servers that disagree
+// on it.
+constexpr uint64_t SCD_ROTATION_LSN_BLOCK_SIZE = 1024;
+
 }} // namespace facebook::logdevice
@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/SSLFetcher.h"
 
+#include <folly/FileUtil.h>
 #include <folly/portability/OpenSSL.h>
 
 // Values for supported identity certificate types
@@ -21,6 +22,148 @@ namespace facebook { namespace logdevice {
 
 const char* SSLFetcher::IDENTITY_TYPE_OID = "1.3.6.1.4.1.40981.2.2.5";
 const char* SSLFetcher::BASIC_CONSTRAINTS_OID = "2.5.29.19";
+constexpr std::chrono::seconds SSLFetcher::SESSION_LIFETIME;
+constexpr size_t SSLFetcher::MAX_SESSIONS;
+constexpr size_t SSLFetcher::TICKET_KEY_SIZE;
+
+std::shared_ptr<folly::SSLContext>
+SSLFetcher::createSSLContext(bool loadCert,
+                             bool ssl_accepting,
+                             bool null_ciphers_only) {
+  std::shared_ptr<folly::SSLContext> context;
+  try {
+    context = std::make_shared<folly::SSLContext>();
+    context->loadTrustedCertificates(ca_path_.c_str());
+    context->loadClientCAList(ca_path_.c_str());
+
+    if (loadCert) {
+      context->loadCertificate(cert_path_.c_str());
+      context->loadPrivateKey(key_path_.c_str());
+    }
+
+    // The node that accepts the connection must present all valid ciphers
+    // that the connecting socket can use. Since we want to separate
+    // encryption and authentication, we include eNULL ciphers in the
+    // list of valid ciphers. It is up to the connecting socket to limit
+    // the list of valid ciphers to enable or disable encryption.
+    std::string null_ciphers = "eNULL";
+#if FOLLY_OPENSSL_IS_110
+    null_ciphers += ":@SECLEVEL=0";
+#endif
+    if (ssl_accepting) {
+      context->ciphers("ALL:!COMPLEMENTOFDEFAULT:" + null_ciphers +
+                       ":@STRENGTH");
+    } else if (null_ciphers_only) {
+      ld_info("Creating SSL context using eNULL ciphers");
+      context->ciphers(null_ciphers);
+    } else {
+      context->ciphers("ALL:!COMPLEMENTOFDEFAULT:!eNULL:@STRENGTH");
+    }
+
+    // Dropping the buffers we are not using and not compressing data
+    context->setOptions(SSL_OP_NO_COMPRESSION);
+    SSL_CTX_set_mode(context->getSSLCtx(), SSL_MODE_RELEASE_BUFFERS);
+
+    if (kernel_tls_) {
+#ifdef SSL_OP_ENABLE_KTLS
+      // OpenSSL silently falls back to userspace encryption if the
+      // kernel or the negotiated cipher doesn't support kTLS (e.g. for
+      // eNULL ciphers).
+      context->setOptions(SSL_OP_ENABLE_KTLS);
+#else
+      RATELIMIT_WARNING(std::chrono::minutes(10),
+                        1,
+                        "Kernel TLS requested but this OpenSSL version "
+                        "doesn't support it");
+#endif
+    }
+
+    // Check peers cert not their hostname
+    context->authenticate(true, false);
+
+    // Don't force the client to use a certificate
+    context->setVerificationOption(folly::SSLContext::VERIFY);
+
+    // Don't force client to use a certificate, however still verify
+    // server certificate. If client does provide a certificate, then it is
+    // also verifed by the server.
+    // TODO: remove callback before open-sourcing
+    SSL_CTX_set_verify(context->getSSLCtx(), SSL_VERIFY_PEER, verify_callback);
+
+    if (!session_resumption_) {
+      // Disabling sessions caching
+      SSL_CTX_set_session_cache_mode(context->getSSLCtx(), SSL_SESS_CACHE_OFF);
+    } else if (ssl_accepting) {
+      setUpSessionTickets(*context);
+    } else {
+      // Sessions are kept by saveSession(), not in the context. The client
+      // cache mode is still needed for OpenSSL to keep the session tickets
+      // it receives.
+      SSL_CTX_set_session_cache_mode(
+          context->getSSLCtx(),
+          SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    }
+  } catch (const std::exception& ex) {
+    ld_error("Failed to load SSL certificate, ex: %s", ex.what());
+    return nullptr;
+  }
+  return context;
+}
+
+void SSLFetcher::setUpSessionTickets(folly::SSLContext& context) {
+  SSL_CTX* ctx = context.getSSLCtx();
+  // Stateless resumption only: the session state lives in the ticket held
+  // by the client, so any node with the same ticket key can resume it.
+  SSL_CTX_set_session_cache_mode(
+      ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_set_timeout(ctx, SESSION_LIFETIME.count());
+  // Required to resume sessions when peers are verified.
+  context.setSessionCacheContext("logdevice");
+
+  if (ticket_key_path_.empty()) {
+    return;
+  }
+  std::string key;
+  if (!folly::readFile(ticket_key_path_.c_str(), key) ||
+      key.size() < TICKET_KEY_SIZE) {
+    // Tickets still work with the random key OpenSSL generated for this
+    // context, but only with this worker and until the context is reloaded.
+    RATELIMIT_ERROR(std::chrono::minutes(10),
+                    1,
+                    "Failed to read a %zu-byte TLS session ticket key from %s",
+                    TICKET_KEY_SIZE,
+                    ticket_key_path_.c_str());
+    return;
+  }
+  if (SSL_CTX_set_tlsext_ticket_keys(
+          ctx, const_cast<char*>(key.data()), TICKET_KEY_SIZE) != 1) {
+    RATELIMIT_ERROR(std::chrono::minutes(10),
+                    1,
+                    "Failed to set the TLS session ticket key from %s",
+                    ticket_key_path_.c_str());
+  }
+}
+
+SSL_SESSION* SSLFetcher::getSession(const std::string& peer) const {
+  auto it = sessions_.find(peer);
+  return it == sessions_.end() ? nullptr : it->second.get();
+}
+
+void SSLFetcher::saveSession(const std::string& peer, SSL* ssl) {
+  std::unique_ptr<SSL_SESSION, SessionDeleter> session(SSL_get1_session(ssl));
+  if (!session) {
+    return;
+  }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+  if (!SSL_SESSION_is_resumable(session.get())) {
+    return;
+  }
+#endif
+  if (sessions_.size() >= MAX_SESSIONS && !sessions_.count(peer)) {
+    sessions_.clear();
+  }
+  sessions_[peer] = std::move(session);
+}
 
 int SSLFetcher::verify_callback(int preverify_ok, X509_STORE_CTX* x509_ctx) {
   // This callback is called after openssl does verification on the
@@ -7,8 +7,11 @@
  */
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 #include <folly/io/async/SSLContext.h>
 #include <folly/portability/OpenSSL.h>
@@ -20,7 +23,9 @@ namespace facebook { namespace logdevice {
 /**
  * @file Loads the SSL context from the specified files, reloads it if it gets
  *       older than the defined expiration interval, provides a shared_ptr to
- *       folly::SSLContext. Does not implement any thread safety mechanics.
+ *       folly::SSLContext. Also keeps the TLS sessions of connections it
+ *       initiated, for resumption. Does not implement any thread safety
+ *       mechanics.
  */
 
 class SSLFetcher {
@@ -28,14 +33,44 @@ class SSLFetcher {
   static const char* IDENTITY_TYPE_OID;
   static const char* BASIC_CONSTRAINTS_OID;
 
+  // How long resumed TLS sessions stay valid.
+  static constexpr std::chrono::seconds SESSION_LIFETIME{3600};
+  // Maximum number of TLS sessions kept for resumption.
+  static constexpr size_t MAX_SESSIONS = 10000;
+  // Size of the session ticket key: 16 bytes of key name, 16 bytes of HMAC
+  // secret and 16 bytes of AES key.
+  static constexpr size_t TICKET_KEY_SIZE = 48;
+
+  /**
+   * @param kernel_tls  If true, ask OpenSSL to hand the symmetric keys to
+   *                    the kernel (kTLS) once the handshake is done, if
+   *                    OpenSSL and the kernel support it. Records are then
+   *                    encrypted and decrypted by the kernel instead of being
+   *                    copied through OpenSSL's buffers.
+   * @param session_resumption  If true, connecting sockets resume the TLS
+   *                    session of the previous connection to the same peer
+   *                    (see getSession()), and accepting sockets issue session
+   *                    tickets encrypted with the key in ticket_key_path.
+   * @param ticket_key_path  File with the TICKET_KEY_SIZE bytes of the
+   *                    session ticket key, shared by all nodes of the cluster
+   *                    so that a session can be resumed with any node, and
+   *                    after restarts. Reloaded along with the certificate.
+   *                    If empty, OpenSSL uses a random per-context key.
+   */
   SSLFetcher(const std::string& cert_path,
              const std::string& key_path,
              const std::string& ca_path,
-             std::chrono::seconds refresh_interval)
+             std::chrono::seconds refresh_interval,
+             bool kernel_tls = false,
+             bool session_resumption = false,
+             const std::string& ticket_key_path = "")
       : cert_path_(cert_path),
         key_path_(key_path),
         ca_path_(ca_path),
-        refresh_interval_(refresh_interval) {}
+        refresh_interval_(refresh_interval),
+        kernel_tls_(kernel_tls),
+        session_resumption_(session_resumption),
+        ticket_key_path_(ticket_key_path) {}
 
   /**
    * @param loadCert          Defines whether or not the certificate will be
@@ -48,69 +83,43 @@ class SSLFetcher {
    *
    * @return                  a pointer to the created SSLContext or a null
    *                          pointer if the certificate could not be loaded.
+   *
+   * A context is kept for each combination of parameters, so that workers
+   * both accepting and initiating connections don't reload the certificates
+   * every time they switch from one to the other.
    */
   std::shared_ptr<folly::SSLContext> getSSLContext(bool loadCert,
                                                    bool ssl_accepting,
                                                    bool null_ciphers_only) {
-    if (!context_ ||
-        requireContextUpdate(loadCert, ssl_accepting, null_ciphers_only)) {
-      try {
-        context_.reset(new folly::SSLContext());
-        context_->loadTrustedCertificates(ca_path_.c_str());
-        context_->loadClientCAList(ca_path_.c_str());
-
-        if (loadCert) {
-          context_->loadCertificate(cert_path_.c_str());
-          context_->loadPrivateKey(key_path_.c_str());
-        }
-
-        // The node that accepts the connection must present all valid ciphers
-        // that the connecting socket can use. Since we want to separate
-        // encryption and authentication, we include eNULL ciphers in the
-        // list of valid ciphers. It is up to the connecting socket to limit
-        // the list of valid ciphers to enable or disable encryption.
-        std::string null_ciphers = "eNULL";
-#if FOLLY_OPENSSL_IS_110
-        null_ciphers += ":@SECLEVEL=0";
-#endif
-        if (ssl_accepting) {
-          context_->ciphers("ALL:!COMPLEMENTOFDEFAULT:" + null_ciphers +
-                            ":@STRENGTH");
-        } else if (null_ciphers_only) {
-          ld_info("Creating SSL context using eNULL ciphers");
-          context_->ciphers(null_ciphers);
-        } else {
-          context_->ciphers("ALL:!COMPLEMENTOFDEFAULT:!eNULL:@STRENGTH");
-        }
-
-        // Dropping the buffers we are not using and not compressing data
-        context_->setOptions(SSL_OP_NO_COMPRESSION);
-        SSL_CTX_set_mode(context_->getSSLCtx(), SSL_MODE_RELEASE_BUFFERS);
-
-        // Check peers cert not their hostname
-        context_->authenticate(true, false);
-
-        // Don't force the client to use a certificate
-        context_->setVerificationOption(folly::SSLContext::VERIFY);
-
-        // Don't force client to use a certificate, however still verify
-        // server certificate. If client does provide a certificate, then it is
-        // also verifed by the server.
-        // TODO: remove callback before open-sourcing
-        SSL_CTX_set_verify(
-            context_->getSSLCtx(), SSL_VERIFY_PEER, verify_callback);
-
-        // Disabling sessions caching
-        SSL_CTX_set_session_cache_mode(
-            context_->getSSLCtx(), SSL_SESS_CACHE_OFF);
-
-      } catch (const std::exception& ex) {
-        ld_error("Failed to load SSL certificate, ex: %s", ex.what());
-        context_.reset();
-        return nullptr;
-      }
+    CachedContext& cached = contexts_[(loadCert ? 4 : 0) +
+                                      (ssl_accepting ? 2 : 0) +
+                                      (null_ciphers_only ? 1 : 0)];
+    auto now = std::chrono::steady_clock::now();
+    if (!cached.context || now - cached.last_loaded > refresh_interval_) {
+      cached.last_loaded = now;
+      cached.context =
+          createSSLContext(loadCert, ssl_accepting, null_ciphers_only);
     }
-    return context_;
+    return cached.context;
+  }
+
+  /**
+   * Returns the TLS session of the last connection to `peer` that can be
+   * resumed, or nullptr. The session is owned by this SSLFetcher; pass it to
+   * SSL_set_session(), which takes its own reference.
+   */
+  SSL_SESSION* getSession(const std::string& peer) const;
+
+  /**
+   * Remembers the session of `ssl`, a connection to `peer`, for getSession(),
+   * if it can be resumed. With TLS 1.3 the session only becomes resumable
+   * once the server's session ticket was received after the handshake, so
+   * this is also worth calling before closing the connection.
+   */
+  void saveSession(const std::string& peer, SSL* ssl);
+
+  bool sessionResumptionEnabled() const {
+    return session_resumption_;
   }
 
  private:
@@ -118,35 +127,35 @@ class SSLFetcher {
   const std::string key_path_;
   const std::string ca_path_;
   const std::chrono::seconds refresh_interval_;
+  const bool kernel_tls_;
+  const bool session_resumption_;
+  const std::string ticket_key_path_;
+
+  struct CachedContext {
+    std::shared_ptr<folly::SSLContext> context;
+    std::chrono::time_point<std::chrono::steady_clock> last_loaded;
+  };
+  // indexed by loadCert, ssl_accepting and null_ciphers_only
+  std::array<CachedContext, 8> contexts_;
+
+  struct SessionDeleter {
+    void operator()(SSL_SESSION* session) const {
+      SSL_SESSION_free(session);
+    }
+  };
+  std::unordered_map<std::string, std::unique_ptr<SSL_SESSION, SessionDeleter>>
+      sessions_;
+
+  std::shared_ptr<folly::SSLContext> createSSLContext(bool loadCert,
+                                                      bool ssl_accepting,
+                                                      bool null_ciphers_only);
 
-  std::shared_ptr<folly::SSLContext> context_;
-  std::chrono::time_point<std::chrono::steady_clock> last_loaded_;
-  bool last_null_cipher_only_ = false;
-  bool last_accepting_state_ = false;
-  bool last_load_cert_ = false;
+  // Sets up session tickets on a context for accepting connections.
+  void setUpSessionTickets(folly::SSLContext& context);
 
   // verification callback for ssl context. Used to check extra critical
   // extensions of a certificate.
   static int verify_callback(int preverify_ok, X509_STORE_CTX* x509_ctx);
-
-  // a context update is required when refresh_interval_ has passed or when any
-  // of the input information is changed
-  bool requireContextUpdate(bool loadCert,
-                            bool ssl_accepting,
-                            bool null_ciphers_only) {
-    auto now = std::chrono::steady_clock::now();
-    bool update = now - last_loaded_ > refresh_interval_ ||
-        loadCert != last_load_cert_ || ssl_accepting != last_accepting_state_ ||
-        null_ciphers_only != last_null_cipher_only_;
-
-    if (update) {
-      last_loaded_ = now;
-      last_null_cipher_only_ = null_ciphers_only;
-      last_accepting_state_ = ssl_accepting;
-      last_load_cert_ = loadCert;
-    }
-    return update;
-  }
 };
 
 }} // namespace facebook::logdevice
@@ -75,10 +75,14 @@ class SampledTracer {
       }
       bool should_log = folly::Random::randDouble(0, 100) < pct;
       if (should_log) {
-        std::unique_ptr<TraceSample> sample = builder();
         uint32_t sample_rate = (uint32_t)std::lround(std::min(
             (double)std::numeric_limits<uint32_t>::max(), 100.0 / pct));
-        logger_->pushSample(table, sample_rate, std::move(sample));
+        // Check the table's budget before paying for building the sample.
+        should_log = force || logger_->consumeSampleBudget(table, sample_rate);
+        if (should_log) {
+          std::unique_ptr<TraceSample> sample = builder();
+          logger_->pushSample(table, sample_rate, std::move(sample));
+        }
       }
       return should_log;
     }
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/SealBatcher.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_SEAL_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+SealBatcher::SealBatcher() = default;
+
+SealBatcher::~SealBatcher() = default;
+
+bool SealBatcher::add(const SEAL_Header& header, NodeID to) {
+  const Settings& settings = Worker::settings();
+  if (settings.seal_batching_window.count() <= 0) {
+    return false;
+  }
+
+  folly::Optional<uint16_t> proto =
+      Worker::onThisThread()->sender().getSocketProtocolVersion(to.index());
+  if (!proto.hasValue() || proto.value() < Compatibility::MULTI_SEAL_SUPPORT) {
+    return false;
+  }
+
+  Batch& batch = batches_[to.index()];
+  batch.to = to;
+  batch.seals.push_back(header);
+  ++num_pending_;
+
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (batch.seals.size() >= settings.seal_batching_max_seals) {
+    // Send on the next event loop iteration.
+    timer_.activate(std::chrono::microseconds::zero());
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.seal_batching_window);
+  }
+  return true;
+}
+
+void SealBatcher::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  num_pending_ = 0;
+  for (auto& kv : batches) {
+    send(std::move(kv.second));
+  }
+}
+
+void SealBatcher::send(Batch batch) {
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+  auto& seals = batch.seals;
+  ld_check(!seals.empty());
+
+  if (seals.size() == 1) {
+    if (sender.sendMessage(
+            std::make_unique<SEAL_Message>(seals.front()), batch.to) != 0) {
+      SEAL_Message::onSentCommon(seals.front(), err, to);
+    }
+    return;
+  }
+
+  const size_t num_seals = seals.size();
+  auto msg = std::make_unique<MULTI_SEAL_Message>(std::move(seals));
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_SEAL with %zu SEALs to %s: %s",
+                   num_seals,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    // sendMessage() doesn't consume the message on failure
+    msg->onSent(st, to);
+    return;
+  }
+
+  STAT_INCR(Worker::stats(), seal_batches_sent);
+  STAT_ADD(Worker::stats(), seal_batched_seals_sent, num_seals);
+}
+
+}} // namespace facebook::logdevice
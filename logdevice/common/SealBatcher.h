@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/SEAL_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-Worker coalescing of SEAL messages that LogRecoveryRequests send
+ *       to the same storage node. When --seal-batching-window is nonzero,
+ *       SEALs sent within the window to a node whose connection supports
+ *       MULTI_SEAL are held back and then sent together in one
+ *       MULTI_SEAL_Message (or as a plain SEAL if there's only one).
+ *
+ *       As with StoreBatcher, batches are only sent from the timer callback,
+ *       so that send failures reported to LogRecoveryRequests don't reenter
+ *       them while they are sending SEALs.
+ */
+
+class SealBatcher {
+ public:
+  SealBatcher();
+  ~SealBatcher();
+
+  SealBatcher(const SealBatcher&) = delete;
+  SealBatcher& operator=(const SealBatcher&) = delete;
+
+  /**
+   * Takes a SEAL that a LogRecoveryRequest wants to send to `to`, if it can
+   * be batched.
+   *
+   * The outcome of sending the SEAL, including errors returned by
+   * Sender::sendMessage() when the batch is sent, is reported through
+   * SEAL_Message::onSentCommon(). The caller is responsible for registering
+   * its socket close callback.
+   *
+   * @return  true if `header` was taken. false if batching is disabled or
+   *          `to` hasn't negotiated a protocol with MULTI_SEAL support yet;
+   *          the caller should send a SEAL_Message directly.
+   */
+  bool add(const SEAL_Header& header, NodeID to);
+
+  // Number of SEALs waiting to be sent.
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  struct Batch {
+    NodeID to;
+    std::vector<SEAL_Header> seals;
+  };
+
+  // Sends all pending batches.
+  void flush();
+
+  void send(Batch batch);
+
+  std::unordered_map<node_index_t, Batch> batches_;
+  size_t num_pending_ = 0;
+
+  // Fires when the oldest pending SEAL has waited for --seal-batching-window,
+  // or right away if a batch grew too big.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
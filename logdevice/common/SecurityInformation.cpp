@@ -23,7 +23,8 @@ bool Principal::isAllowedInConfig(const std::string& str) {
 
 folly::dynamic Principal::toFollyDynamic() const {
   return folly::dynamic::object("name", name)(
-      "max_read_traffic_class", trafficClasses()[max_read_traffic_class]);
+      "max_read_traffic_class", trafficClasses()[max_read_traffic_class])(
+      "read_weight", read_weight);
 };
 
 std::string AuthenticationTypeTranslator::toString(AuthenticationType type) {
@@ -67,6 +67,11 @@ class Principal {
   // The RFC 2474 "Differentiated Services Field Code Point" value to use
   // for all packets sent on connections associated with this principal.
   uint8_t egress_dscp = 0;
+
+  // Weight of this principal's reads relative to other principals' reads of
+  // the same kind (e.g. backlog reads) when storage threads are scheduled
+  // with DRR (see --storage-tasks-use-drr).
+  uint32_t read_weight = 1;
 };
 
 /**
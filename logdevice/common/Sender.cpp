@@ -140,6 +140,9 @@ Sender::Sender(std::shared_ptr<const Settings> settings,
     fg.setScope(this, scope);
     scope = NodeLocation::nextGreaterScope(scope);
   }
+
+  bytes_pending_handle_ = MemoryGovernor::get()->registerUsage(
+      "sender_outbufs", [this] { return bytes_pending_.load(); });
 }
 
 Sender::~Sender() {
@@ -299,6 +302,16 @@ int Sender::notifyPeerConfigUpdated(Socket& sock) {
       return 0;
     }
 
+    ResourceBudget::Token token =
+        Worker::onThisThread()->processor_->config_changed_budget_
+            .acquireToken();
+    if (!token) {
+      // Too many full configs are already queued for sending. Leave the peer
+      // config version as is, a later message on this socket will try again.
+      STAT_INCR(Worker::stats(), config_changed_deferred);
+      return 0;
+    }
+
     ld_info("Detected stale peer config (%u < %u). "
             "Sending CONFIG_CHANGED to %s",
             peer_config_version.val(),
@@ -316,10 +329,12 @@ int Sender::notifyPeerConfigUpdated(Socket& sock) {
         CONFIG_CHANGED_Header::Action::UPDATE};
     metadata.hash.copy(hdr.hash, sizeof hdr.hash);
 
-    msg = std::make_unique<CONFIG_CHANGED_Message>(
+    auto config_changed = std::make_unique<CONFIG_CHANGED_Message>(
         hdr,
         server_config->toString(
             /* with_logs */ nullptr, /* with_zk */ nullptr, true));
+    config_changed->setBudgetToken(std::move(token));
+    msg = std::move(config_changed);
   } else {
     // The peer is a server. Send a CONFIG_ADVISORY to let it know about our
     // config version. Upon receiving this message, if the server config hasn't
@@ -1175,6 +1190,12 @@ void Sender::setClientLocation(const ClientID& cid,
     return;
   }
   sock->peer_location_ = location;
+
+  NodeLocation peer_location;
+  if (my_location_.hasValue() &&
+      peer_location.fromDomainString(location) == 0) {
+    sock->peer_scope_ = my_location_->closestSharedScope(peer_location);
+  }
 }
 
 void Sender::setPeerConfigVersion(const Address& addr,
@@ -1246,6 +1267,16 @@ void Sender::setPeerNodeID(const Address& addr, NodeID node_id) {
     peer_node = node_id;
     if (node_id.isNodeID()) {
       it->second->setDSCP(settings_->server_dscp_default);
+
+      // Now that we know which node this is, use its location from the config
+      // rather than the guess made in addClient().
+      const auto* node_sd = nodes_->getNodeServiceDiscovery(node_id.index());
+      if (node_id.index() == my_node_index_) {
+        it->second->peer_scope_ = NodeLocationScope::NODE;
+      } else if (my_location_.hasValue() && node_sd && node_sd->location) {
+        it->second->peer_scope_ =
+            my_location_->closestSharedScope(*node_sd->location);
+      }
     }
   }
 }
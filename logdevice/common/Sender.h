@@ -22,6 +22,7 @@
 #include <openssl/ossl_typ.h>
 
 #include "logdevice/common/Address.h"
+#include "logdevice/common/MemoryGovernor.h"
 #include "logdevice/common/PrincipalIdentity.h"
 #include "logdevice/common/Priority.h"
 #include "logdevice/common/ResourceBudget.h"
@@ -839,6 +840,9 @@ class Sender : public SenderBase {
   // current number of bytes in all output buffers combined
   std::atomic<size_t> bytes_pending_{0};
 
+  // Reports bytes_pending_ to MemoryGovernor.
+  MemoryGovernor::Handle bytes_pending_handle_;
+
   // if true, disallow sending messages and initiating connections
   bool shutting_down_ = false;
 
@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/Sequencer.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "logdevice/common/AllSequencers.h"
@@ -24,6 +25,7 @@
 #include "logdevice/common/NodeSetFinder.h"
 #include "logdevice/common/PeriodicReleases.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/ReleaseBatcher.h"
 #include "logdevice/common/SequencerBackgroundActivator.h"
 #include "logdevice/common/Socket.h"
 #include "logdevice/common/Worker.h"
@@ -102,6 +104,9 @@ int Sequencer::startActivation(GetMetaDataFunc metadata_func,
     }
 
     setState(State::ACTIVATING);
+    // a sequencer activated on this node takes the log back from any node it
+    // was handed off to
+    handoff_until_ = std::chrono::steady_clock::duration::min();
   }
 
   int rv = metadata_func(log_id_);
@@ -216,6 +221,8 @@ ActivateResult Sequencer::completeActivationWithMetaData(
       // If sequencer for previous epoch was on a different node, we don't know
       // what the append rate was up until now. Tell that to rate estimator.
       append_rate_estimator_.clear(SteadyTimestamp::now());
+      append_count_estimator_.clear(SteadyTimestamp::now());
+      append_bytes_received_estimator_.clear(SteadyTimestamp::now());
     }
   }
 
@@ -300,7 +307,19 @@ void Sequencer::noteDrainingCompleted(epoch_t epoch, Status drain_status) {
              current_draining->getEpoch() >= epoch);
     if (current_draining != nullptr && current_draining->getEpoch() == epoch) {
       // the current draining epoch has finished draining
-      if (drain_status == E::OK) {
+      if (drain_status == E::OK && current_seqs->current == nullptr) {
+        // The sequencer became unavailable on a planned move (see
+        // setUnavailable()) and all appends of its last epoch are fully
+        // stored and released. There is nothing to recover here. The
+        // sequencer that takes over will find the tail of the epoch in
+        // SEALED replies and won't need to read a recovery digest.
+        ld_info("Sequencer of log %lu has finished draining its epoch %u "
+                "before handing the log over.",
+                log_id_.val_,
+                epoch.val_);
+        STAT_INCR(stats_, sequencer_handoff_drained);
+        action = DrainedAction::NONE;
+      } else if (drain_status == E::OK) {
         // start graceful reactivation completion procedure
         // TODO: may check if epoch is exactly current_epoch-1, however don't
         //       bother to do it for now since the completion procedure is a
@@ -901,7 +920,14 @@ RunAppenderStatus Sequencer::runAppender(Appender* appender) {
 
   // note that we do not check the preemption status here: it is checked
   // in AppenderPrep before calling this function
-  std::shared_ptr<EpochSequencer> current = getCurrentEpochSequencer();
+  //
+  // `current' is pinned by the EpochSequencers snapshot, whose reference count
+  // is local to this thread. Copying the shared_ptr to the EpochSequencer
+  // instead would make all Workers appending to this log contend on the same
+  // reference count.
+  std::shared_ptr<EpochSequencers> epoch_seqs = epoch_seqs_.get();
+  ld_assert(epoch_seqs != nullptr);
+  EpochSequencer* current = epoch_seqs->current.get();
   if (current == nullptr) {
     const bool activating = (getState() == State::ACTIVATING);
     err = (activating ? E::INPROGRESS : E::NOSEQUENCER);
@@ -956,6 +982,55 @@ RunAppenderStatus Sequencer::runAppender(Appender* appender) {
   return res;
 }
 
+std::vector<RunAppenderStatus>
+Sequencer::runAppenders(folly::Range<Appender* const*> appenders) {
+  ld_check(!appenders.empty());
+
+  std::shared_ptr<EpochSequencers> epoch_seqs = epoch_seqs_.get();
+  ld_assert(epoch_seqs != nullptr);
+  EpochSequencer* current = epoch_seqs->current.get();
+  if (current == nullptr) {
+    const bool activating = (getState() == State::ACTIVATING);
+    err = (activating ? E::INPROGRESS : E::NOSEQUENCER);
+    return {};
+  }
+
+  const epoch_t epoch = current->getEpoch();
+  ld_check(epoch != EPOCH_INVALID);
+  size_t payload_size = 0;
+  for (Appender* appender : appenders) {
+    if (!appender || appender->started()) {
+      ld_check(false);
+      err = E::INVALID_PARAM;
+      return {};
+    }
+    // Stale appends, appends over the limit and redirected appends are
+    // handled one by one in runAppender().
+    if (appender->isStale(epoch) || appender->maxAppendersHardLimitReached() ||
+        appender->getLSNBeforeRedirect() != LSN_INVALID) {
+      err = E::AGAIN;
+      return {};
+    }
+    payload_size += appender->getPayload()->size();
+  }
+
+  if (settings_->test_sequencer_corrupt_stores) {
+    for (Appender* appender : appenders) {
+      appender->TEST_corruptPayload();
+    }
+  }
+
+  SteadyTimestamp now = SteadyTimestamp::now();
+  atomic_fetch_max(last_append_, now.toMilliseconds());
+
+  std::vector<RunAppenderStatus> res = current->runAppenders(appenders);
+  if (!res.empty()) {
+    append_rate_estimator_.addValue(
+        payload_size, getRateEstimatorWindowSize(), now);
+  }
+  return res;
+}
+
 size_t Sequencer::getNumAppendsInFlight() const {
   auto current = getCurrentEpochSequencer();
   return current == nullptr ? 0 : current->getNumAppendsInFlight();
@@ -1405,6 +1480,31 @@ void Sequencer::clearNoRedirectUntil() {
   no_redirect_until_ = std::chrono::steady_clock::duration::min();
 }
 
+void Sequencer::handOff(NodeID target,
+                        std::chrono::steady_clock::duration hold) {
+  ld_check(target.isNodeID());
+  handoff_target_ = target;
+  handoff_until_ = std::chrono::steady_clock::now().time_since_epoch() + hold;
+  setUnavailable(UnavailabilityReason::HANDED_OFF);
+}
+
+bool Sequencer::renewHandoff(std::chrono::steady_clock::duration hold) {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  auto until = handoff_until_.load();
+  // compare-and-swap so that a concurrent activation clearing the handoff
+  // wins
+  return now < until &&
+      handoff_until_.compare_exchange_strong(until, now + hold);
+}
+
+NodeID Sequencer::getHandoffTarget() const {
+  if (std::chrono::steady_clock::now().time_since_epoch() >=
+      handoff_until_.load()) {
+    return NodeID();
+  }
+  return handoff_target_.load();
+}
+
 ///////////////////////////////////////////////
 
 /* static */
@@ -1510,6 +1610,9 @@ int Sequencer::sendReleases(lsn_t lsn,
     if (!pred || pred(lsn, release_type, shard)) {
       auto h = header;
       h.shard = shard.shard();
+      if (w->releaseBatcher().add(h, shard.asNodeID())) {
+        continue;
+      }
       if (sender.sendMessage(
               std::make_unique<RELEASE_Message>(h), shard.asNodeID()) != 0) {
         RATELIMIT_DEBUG(
@@ -1768,10 +1871,12 @@ void Sequencer::noteConfigurationChanged(std::shared_ptr<Configuration> cfg,
 }
 
 void Sequencer::setUnavailable(UnavailabilityReason r) {
-  // only drain if the node is not a sequencer node anymore; for other cases,
-  // abort all appenders
+  // only drain on planned moves (the node is not a sequencer node anymore, or
+  // the log was deactivated or handed off); for other cases, abort all
+  // appenders
   bool drain = (r == UnavailabilityReason::NOT_A_SEQUENCER_NODE ||
-                        r == UnavailabilityReason::DEACTIVATED_BY_ADMIN
+                        r == UnavailabilityReason::DEACTIVATED_BY_ADMIN ||
+                        r == UnavailabilityReason::HANDED_OFF
                     ? true
                     : false);
   State old_state;
@@ -1833,6 +1938,15 @@ void Sequencer::setUnavailable(UnavailabilityReason r) {
           log_id_.val_);
       STAT_INCR(stats_, sequencer_unavailable_admin_deactivated);
       break;
+    case UnavailabilityReason::HANDED_OFF:
+      RATELIMIT_INFO(std::chrono::seconds(1),
+                     10,
+                     "Transitioning sequencer into UNAVAILABLE state "
+                     "because log %lu was handed off to %s.",
+                     log_id_.val_,
+                     handoff_target_.load().toString().c_str());
+      STAT_INCR(stats_, sequencer_unavailable_handed_off);
+      break;
     case UnavailabilityReason::SHUTDOWN:
       break;
   }
@@ -1955,6 +2069,35 @@ Sequencer::appendRateEstimate() const {
       getRateEstimatorWindowSize(), SteadyTimestamp::now());
 }
 
+static constexpr std::chrono::milliseconds kArrivalRateWindow{1000};
+
+Sequencer::ArrivalRate Sequencer::noteAppendReceived(size_t payload_size) {
+  SteadyTimestamp now = SteadyTimestamp::now();
+  append_count_estimator_.addValue(1, kArrivalRateWindow, now);
+  append_bytes_received_estimator_.addValue(
+      payload_size, kArrivalRateWindow, now);
+  return getArrivalRate(now);
+}
+
+Sequencer::ArrivalRate Sequencer::appendArrivalRate() const {
+  return getArrivalRate(SteadyTimestamp::now());
+}
+
+Sequencer::ArrivalRate Sequencer::getArrivalRate(SteadyTimestamp now) const {
+  // Right after activation the estimates cover a very short interval; divide
+  // by at least a full window so that a handful of appends doesn't look like
+  // a high rate.
+  auto per_sec = [&](const RateEstimator& estimator) {
+    auto rate = estimator.getRate(kArrivalRateWindow, now);
+    return rate.first * 1000.0 /
+        std::max(rate.second, kArrivalRateWindow).count();
+  };
+  ArrivalRate res;
+  res.appends_per_sec = per_sec(append_count_estimator_);
+  res.bytes_per_sec = per_sec(append_bytes_received_estimator_);
+  return res;
+}
+
 std::chrono::milliseconds Sequencer::getRateEstimatorWindowSize() const {
   std::chrono::milliseconds window = settings_->nodeset_adjustment_period;
   if (window.count() <= 0) {
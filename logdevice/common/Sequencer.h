@@ -13,8 +13,11 @@
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <vector>
 
+#include <folly/Range.h>
 #include <folly/SharedMutex.h>
+#include <folly/lang/Align.h>
 
 #include "logdevice/common/Appender.h"
 #include "logdevice/common/EpochMetaDataMap.h"
@@ -288,6 +291,24 @@ class Sequencer {
    */
   RunAppenderStatus runAppender(Appender* appender);
 
+  /**
+   * Attempt to start several Appenders created on this Worker in the current
+   * epoch, reserving a range of consecutive LSNs for all of them at once.
+   * This is a fast path for batches of plain appends: if any of the
+   * Appenders needs more than an LSN (see the errors of runAppender()), or
+   * there is no room for all of them, nothing is started and the caller is
+   * expected to fall back to runAppender() for each one.
+   *
+   * See also EpochSequencer::runAppenders().
+   *
+   * @return  one status per Appender if LSNs were assigned (see
+   *          EpochSequencer::runAppenders()). Otherwise an empty vector, with
+   *          err set to one of the errors of runAppender() or to
+   *            AGAIN   some Appender has to go through runAppender()
+   */
+  std::vector<RunAppenderStatus>
+  runAppenders(folly::Range<Appender* const*> appenders);
+
   /**
    * Called when an Appender is reaped in its epoch and increases the last
    * known good esn of the epoch. Attempt to update last released LSN of the
@@ -348,6 +369,28 @@ class Sequencer {
    */
   void clearNoRedirectUntil();
 
+  /**
+   * Hands this log off to the sequencer on `target': appends arriving here
+   * are redirected to `target' for `hold' (see getHandoffTarget()) and the
+   * current epoch is drained as for any other planned move. Used by
+   * SequencerBackgroundActivator to shed load from overloaded nodes.
+   */
+  void handOff(NodeID target, std::chrono::steady_clock::duration hold);
+
+  /**
+   * Extends an unexpired handoff to last for `hold' from now.
+   *
+   * @return  false if there is no handoff in effect, e.g. because it expired
+   *          or the sequencer was reactivated on this node in the meantime
+   */
+  bool renewHandoff(std::chrono::steady_clock::duration hold);
+
+  /**
+   * @return  node this log was handed off to, or an invalid NodeID if the log
+   *          was not handed off or the handoff has expired
+   */
+  NodeID getHandoffTarget() const;
+
   /////////////////////// LogRecovery ///////////////////////
 
   /**
@@ -711,6 +754,21 @@ class Sequencer {
   // sequencer was only recently activated.
   std::pair<int64_t, std::chrono::milliseconds> appendRateEstimate() const;
 
+  // Rate of appends offered to this sequencer in roughly the last second.
+  // Unlike appendRateEstimate(), this counts every incoming append, including
+  // ones that sequencer batching later merges into a single Appender.  Used
+  // by SequencerBatching to decide when and how much to batch.
+  struct ArrivalRate {
+    double appends_per_sec = 0;
+    double bytes_per_sec = 0;
+  };
+
+  // Counts an incoming append with a payload of `payload_size` bytes and
+  // returns the updated rate.
+  ArrivalRate noteAppendReceived(size_t payload_size);
+
+  ArrivalRate appendArrivalRate() const;
+
   // timer callback for the epoch draining timer
   static void onDrainingTimerExpired(logid_t log_id,
                                      epoch_t draining,
@@ -835,17 +893,29 @@ class Sequencer {
   //
   // This field prevents releasing records in dirty epochs that have not yet
   // been fully recovered.
-  std::atomic<lsn_t> last_released_{LSN_INVALID};
+  //
+  // Advanced by whichever Worker reaps an Appender, so it gets its own cache
+  // line, away from the fields runAppender() reads and writes.
+  alignas(folly::hardware_destructive_interference_size) std::atomic<lsn_t>
+      last_released_{LSN_INVALID};
 
   // Time of the latest append executed by this sequencer. Represented as the
   // number of milliseconds since steady_clock's epoch (note: time_point can't
   // be stored directly as it isn't trivially copyable).
-  std::atomic<std::chrono::milliseconds> last_append_{
-      std::chrono::milliseconds(0)};
+  alignas(folly::hardware_destructive_interference_size)
+      std::atomic<std::chrono::milliseconds> last_append_{
+          std::chrono::milliseconds(0)};
 
   // Estimates rate of appends (in bytes/s). Used for adjusting nodeset size.
   RateEstimator append_rate_estimator_;
 
+  // Estimate rate of incoming appends, in appends/s and bytes/s.
+  // See noteAppendReceived().
+  RateEstimator append_count_estimator_;
+  RateEstimator append_bytes_received_estimator_;
+
+  ArrivalRate getArrivalRate(SteadyTimestamp now) const;
+
   // tail record of the previous epoch, only populated when log recovery
   // initiated by the current epoch is completed
   UpdateableSharedPtr<const TailRecord> tail_record_previous_epoch_;
@@ -867,6 +937,13 @@ class Sequencer {
   std::atomic<std::chrono::steady_clock::duration> no_redirect_until_{
       std::chrono::steady_clock::duration::min()};
 
+  // Node this log was handed off to by handOff() and until when appends
+  // received by this node should be redirected there. Cleared when the
+  // sequencer is activated on this node again.
+  std::atomic<NodeID> handoff_target_{NodeID()};
+  std::atomic<std::chrono::steady_clock::duration> handoff_until_{
+      std::chrono::steady_clock::duration::min()};
+
   // Maximum effective_since ever read by recovery.
   // @seealso onSequencerMetaDataRead
   std::atomic<epoch_t::raw_type> max_effective_since_read_{EPOCH_INVALID.val_};
@@ -894,7 +971,9 @@ class Sequencer {
     // The sequencer is isolated.
     ISOLATED = 3,
     // Deactivated by the admin command
-    DEACTIVATED_BY_ADMIN = 4
+    DEACTIVATED_BY_ADMIN = 4,
+    // Handed off to another node to shed load, see handOff()
+    HANDED_OFF = 5
   };
   // Evict and destroy all managed epoch sequencers and put the sequencer into
   // UNAVAILABLE state
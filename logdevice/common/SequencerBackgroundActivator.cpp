@@ -10,11 +10,13 @@
 #include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/EpochMetaDataUpdater.h"
 #include "logdevice/common/EpochSequencer.h"
+#include "logdevice/common/HashBasedSequencerLocator.h"
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/MetaDataLogWriter.h"
 #include "logdevice/common/NodeSetSelectorFactory.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/configuration/InternalLogs.h"
 
 namespace facebook { namespace logdevice {
 
@@ -44,6 +46,7 @@ void SequencerBackgroundActivator::schedule(std::vector<logid_t> log_ids) {
     ld_check(!MetaDataLog::isMetaDataLog(log_id));
     LogState& state = logs_[log_id];
     activateNodesetAdjustmentTimerIfNeeded(log_id, state);
+    activatePlacementTimerIfNeeded();
     if (state.in_queue) {
       continue;
     }
@@ -626,6 +629,145 @@ void SequencerBackgroundActivator::activateNodesetAdjustmentTimerIfNeeded(
   state.nodeset_adjustment_timer.activate(first_delay);
 }
 
+void SequencerBackgroundActivator::activatePlacementTimerIfNeeded() {
+  if (Worker::settings().sequencer_placement_max_node_bytes_per_sec == 0 ||
+      placement_timer_.isActive()) {
+    return;
+  }
+  if (!placement_timer_.isAssigned()) {
+    placement_timer_.assign([this] {
+      maybeShedLoad();
+      activatePlacementTimerIfNeeded();
+    });
+  }
+  placement_timer_.activate(Worker::settings().sequencer_placement_period);
+}
+
+void SequencerBackgroundActivator::maybeShedLoad() {
+  Worker* w = Worker::onThisThread();
+  const Settings& settings = Worker::settings();
+  const double max_rate = settings.sequencer_placement_max_node_bytes_per_sec;
+  if (max_rate <= 0 || !w->processor_->isFailureDetectorRunning()) {
+    // Disabled, or sequencers are statically placed. Outstanding handoffs
+    // expire on their own.
+    handoffs_.clear();
+    overloaded_periods_ = 0;
+    return;
+  }
+
+  auto& all_seq = w->processor_->allSequencers();
+  double total_rate = 0;
+  std::vector<std::pair<double, std::shared_ptr<Sequencer>>> candidates;
+  for (auto& seq : all_seq.getAll()) {
+    if (seq->getState() != Sequencer::State::ACTIVE) {
+      continue;
+    }
+    const double rate = seq->appendArrivalRate().bytes_per_sec;
+    total_rate += rate;
+    const logid_t log_id = seq->getLogID();
+    if (rate > 0 && !MetaDataLog::isMetaDataLog(log_id) &&
+        !configuration::InternalLogs::isInternal(log_id)) {
+      candidates.emplace_back(rate, std::move(seq));
+    }
+  }
+
+  // Keep a handed-off log away while taking it back would bring this node
+  // within 20% of the limit, so that logs don't bounce back and forth.
+  for (auto it = handoffs_.begin(); it != handoffs_.end();) {
+    auto seq = all_seq.findSequencer(it->first);
+    if (!seq || !seq->getHandoffTarget().isNodeID()) {
+      // expired, or the log was taken back by a client
+      it = handoffs_.erase(it);
+      continue;
+    }
+    if (total_rate + it->second > 0.8 * max_rate) {
+      seq->renewHandoff(settings.sequencer_placement_hold);
+    }
+    ++it;
+  }
+
+  if (total_rate <= max_rate) {
+    overloaded_periods_ = 0;
+    return;
+  }
+  if (++overloaded_periods_ < settings.sequencer_placement_overloaded_periods) {
+    return;
+  }
+  overloaded_periods_ = 0;
+
+  const NodeID my_node_id = w->processor_->getMyNodeID();
+  const auto& nodes_configuration = w->getNodesConfiguration();
+  std::shared_ptr<Configuration> config = w->getConfig();
+  ClusterState* cluster_state = Worker::getClusterState();
+
+  // Logs are handed off to where they'd go if this node were down.
+  configuration::SequencersConfig others =
+      nodes_configuration->getSequencersConfig();
+  for (size_t i = 0; i < others.nodes.size(); ++i) {
+    if (others.nodes[i].index() == my_node_id.index()) {
+      others.weights[i] = 0;
+    }
+  }
+
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+  size_t num_handoffs = 0;
+  for (auto& candidate : candidates) {
+    if (total_rate <= max_rate ||
+        num_handoffs >= settings.sequencer_placement_max_handoffs) {
+      break;
+    }
+    const double rate = candidate.first;
+    if (rate > max_rate) {
+      // would just overload the other node
+      continue;
+    }
+    const logid_t log_id = candidate.second->getLogID();
+    const std::shared_ptr<LogsConfig::LogGroupNode> logcfg =
+        config->getLogGroupByIDShared(log_id);
+    if (!logcfg) {
+      continue;
+    }
+    const auto* attrs =
+        settings.use_sequencer_affinity ? &logcfg->attrs() : nullptr;
+
+    // Only shed logs this node is the primary for. Logs that were handed off
+    // to this node stay here until the node that handed them off takes them
+    // back.
+    NodeID primary;
+    if (HashBasedSequencerLocator::locateSequencer(log_id,
+                                                   nodes_configuration.get(),
+                                                   attrs,
+                                                   cluster_state,
+                                                   &primary) != 0 ||
+        primary.index() != my_node_id.index()) {
+      continue;
+    }
+    NodeID target;
+    if (HashBasedSequencerLocator::locateSequencer(log_id,
+                                                   nodes_configuration.get(),
+                                                   attrs,
+                                                   cluster_state,
+                                                   &target,
+                                                   &others) != 0) {
+      continue;
+    }
+
+    ld_info("Handing log %lu (%.0f bytes/s) off to %s, this node's sequencers "
+            "receive %.0f bytes/s",
+            log_id.val_,
+            rate,
+            target.toString().c_str(),
+            total_rate);
+    candidate.second->handOff(target, settings.sequencer_placement_hold);
+    handoffs_[log_id] = rate;
+    total_rate -= rate;
+    ++num_handoffs;
+    WORKER_STAT_INCR(sequencer_placement_handoffs);
+  }
+}
+
 void SequencerBackgroundActivator::onSettingsUpdated() {
   // Set val = new_val and return true if the original val was != new_val.
   auto upd = [](auto& val, auto new_val) {
@@ -645,6 +787,8 @@ void SequencerBackgroundActivator::onSettingsUpdated() {
       upd(nodeset_max_randomizations_,
           Worker::settings().nodeset_max_randomizations);
 
+  activatePlacementTimerIfNeeded();
+
   if (!adjustment_period_changed && !randomization_settings_changed) {
     return;
   }
@@ -144,6 +144,16 @@ class SequencerBackgroundActivator {
   // Updates nodeset seed.
   void randomizeNodeset(logid_t log_id, LogState& state);
 
+  // Called every sequencer_placement_period. If this node's sequencers have
+  // received more than sequencer_placement_max_node_bytes_per_sec for
+  // sequencer_placement_overloaded_periods periods in a row, hands some of
+  // the hottest logs off to other nodes (see Sequencer::handOff()). Also
+  // renews earlier handoffs that are still needed.
+  void maybeShedLoad();
+
+  // Activates placement_timer_ if load-based sequencer placement is enabled.
+  void activatePlacementTimerIfNeeded();
+
   // Does the actual useful work.
   // Checks if the current sequencer's epoch metadata (nodeset, replication
   // factor etc) and settings (window size) matches the config. If not, starts
@@ -200,6 +210,16 @@ class SequencerBackgroundActivator {
 
   std::unordered_map<logid_t, LogState, logid_t::Hash> logs_;
 
+  // Logs handed off by maybeShedLoad(), with their append throughput at the
+  // time of the handoff.
+  std::unordered_map<logid_t, double, logid_t::Hash> handoffs_;
+
+  // Fires every sequencer_placement_period to call maybeShedLoad().
+  Timer placement_timer_;
+
+  // Number of consecutive placement periods this node was overloaded for.
+  size_t overloaded_periods_{0};
+
   // Queue of log_ids to process.
   std::queue<logid_t> queue_;
 
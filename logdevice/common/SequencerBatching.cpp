@@ -10,6 +10,7 @@
 #include <chrono>
 #include <unordered_set>
 
+#include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/AppendRequestBase.h"
 #include "logdevice/common/Appender.h"
 #include "logdevice/common/AppenderPrep.h"
@@ -18,6 +19,7 @@
 #include "logdevice/common/MetaDataLogWriter.h"
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/Sequencer.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Socket.h"
 #include "logdevice/common/Worker.h"
@@ -33,6 +35,41 @@ using namespace std::literals::chrono_literals;
 using Compression = BufferedWriter::Options::Compression;
 using LogAttributes = logsconfig::LogAttributes;
 
+// Adjusts the batching options of a log to its recent arrival rate when
+// Settings::sequencer_batching_adaptive is set.  The time trigger bounds the
+// latency batching adds to an append, so it is capped at the latency budget;
+// the size trigger is what the log is expected to receive within that time,
+// so that busy logs get batches as large as the budget allows and flush
+// early on bursts.  Compression is only used if such batches are large
+// enough to be worth it.
+static void adapt_log_options(logid_t log_id,
+                              const Settings& settings,
+                              BufferedWriter::LogOptions* opts) {
+  std::shared_ptr<Sequencer> sequencer =
+      Worker::onThisThread()->processor_->allSequencers().findSequencer(
+          log_id);
+  if (!sequencer) {
+    return;
+  }
+  const Sequencer::ArrivalRate rate = sequencer->appendArrivalRate();
+
+  const auto budget = settings.sequencer_batching_adaptive_latency_budget;
+  if (opts->time_trigger.count() < 0 || opts->time_trigger > budget) {
+    opts->time_trigger = budget;
+  }
+  const double batch_bytes = rate.bytes_per_sec *
+      std::chrono::duration<double>(opts->time_trigger).count();
+  opts->size_trigger = std::max<ssize_t>(1, batch_bytes);
+  if (batch_bytes <
+      settings.sequencer_batching_adaptive_compression_threshold) {
+    opts->compression = Compression::NONE;
+  }
+  STAT_INCR(Worker::stats(), seq_batching_adaptive_batches);
+  if (opts->compression == Compression::NONE) {
+    STAT_INCR(Worker::stats(), seq_batching_adaptive_uncompressed_batches);
+  }
+}
+
 static BufferedWriter::LogOptions get_log_options(logid_t log_id) {
   BufferedWriter::LogOptions opts;
 
@@ -44,24 +81,39 @@ static BufferedWriter::LogOptions get_log_options(logid_t log_id) {
 
   auto config = Worker::getConfig();
   const auto& settings = Worker::settings();
+  opts.zstd_dictionary_id = settings.sequencer_batching_zstd_dictionary_id;
 
   const std::shared_ptr<LogsConfig::LogGroupNode> group =
       config->getLogGroupByIDShared(log_id);
 
-  if (!group) {
+  const bool enable_batching = group
+      ? group->attrs().sequencerBatching().getValue(settings.sequencer_batching)
+      : settings.sequencer_batching;
+  if (!enable_batching) {
+    // Only automatic batching sends appends for this log here.  It targets
+    // tiny, latency sensitive appends, so flush them soon.
+    opts.time_trigger = settings.sequencer_batching_auto_time_trigger;
+    opts.size_trigger = settings.sequencer_batching_size_trigger;
+    opts.compression = group
+        ? group->attrs().sequencerBatchingCompression().getValue(
+              settings.sequencer_batching_compression)
+        : settings.sequencer_batching_compression;
+  } else if (!group) {
     opts.time_trigger = settings.sequencer_batching_time_trigger;
     opts.size_trigger = settings.sequencer_batching_size_trigger;
     opts.compression = settings.sequencer_batching_compression;
-    return opts;
+  } else {
+    opts.time_trigger = group->attrs().sequencerBatchingTimeTrigger().getValue(
+        settings.sequencer_batching_time_trigger);
+    opts.size_trigger = group->attrs().sequencerBatchingSizeTrigger().getValue(
+        settings.sequencer_batching_size_trigger);
+    opts.compression = group->attrs().sequencerBatchingCompression().getValue(
+        settings.sequencer_batching_compression);
   }
 
-  opts.time_trigger = group->attrs().sequencerBatchingTimeTrigger().getValue(
-      settings.sequencer_batching_time_trigger);
-  opts.size_trigger = group->attrs().sequencerBatchingSizeTrigger().getValue(
-      settings.sequencer_batching_size_trigger);
-  opts.compression = group->attrs().sequencerBatchingCompression().getValue(
-      settings.sequencer_batching_compression);
-
+  if (settings.sequencer_batching_adaptive) {
+    adapt_log_options(log_id, settings, &opts);
+  }
   return opts;
 }
 
@@ -153,10 +205,26 @@ bool SequencerBatching::buffer(logid_t log_id,
   const std::shared_ptr<LogsConfig::LogGroupNode> group =
       Worker::getConfig()->getLogGroupByIDShared(log_id);
 
-  const bool enable_batching = group
+  std::shared_ptr<const Settings> settings = processor_->settings();
+  bool enable_batching = group
       ? group->attrs().sequencerBatching().getValue(
-            processor_->settings()->sequencer_batching)
-      : processor_->settings()->sequencer_batching;
+            settings->sequencer_batching)
+      : settings->sequencer_batching;
+
+  // Count every incoming append, including the ones we end up batching, so
+  // that batching doesn't hide the rate it depends on.
+  folly::Optional<Sequencer::ArrivalRate> rate;
+  if (settings->sequencer_batching_auto_threshold > 0 ||
+      settings->sequencer_batching_adaptive) {
+    std::shared_ptr<Sequencer> sequencer =
+        processor_->allSequencers().findSequencer(log_id);
+    if (sequencer) {
+      rate = sequencer->noteAppendReceived(appender_in->getPayload()->size());
+    }
+  }
+  if (!enable_batching && rate.hasValue()) {
+    enable_batching = shouldAutoBatch(rate.value(), *appender_in);
+  }
 
   if (shutting_down_.load() || !enable_batching ||
       MetaDataLog::isMetaDataLog(log_id)) {
@@ -181,7 +249,8 @@ bool SequencerBatching::buffer(logid_t log_id,
     return false;
   }
 
-  if (shouldPassthru(*appender_in)) {
+  if (shouldPassthru(*appender_in) ||
+      (rate.hasValue() && shouldPassthruLowRate(rate.value()))) {
     StatsHolder* stats = Worker::stats();
     const size_t payload_size = appender_in->getPayload()->size();
     // Count these as both in and out so that out/in gives an accurate
@@ -231,6 +300,36 @@ bool SequencerBatching::buffer(logid_t log_id,
   return true;
 }
 
+bool SequencerBatching::shouldAutoBatch(const Sequencer::ArrivalRate& rate,
+                                        const Appender& appender) const {
+  std::shared_ptr<const Settings> settings = processor_->settings();
+  if (settings->sequencer_batching_auto_threshold == 0) {
+    return false;
+  }
+  if (rate.appends_per_sec < settings->sequencer_batching_auto_threshold ||
+      appender.getPayload()->size() >
+          settings->sequencer_batching_auto_max_payload_size) {
+    return false;
+  }
+  STAT_INCR(Worker::stats(), append_seq_batching_auto);
+  return true;
+}
+
+bool SequencerBatching::shouldPassthruLowRate(
+    const Sequencer::ArrivalRate& rate) const {
+  std::shared_ptr<const Settings> settings = processor_->settings();
+  if (!settings->sequencer_batching_adaptive) {
+    return false;
+  }
+  // If less than one other append is expected to arrive within the latency
+  // budget, batching would only add latency.
+  const double expected_appends = rate.appends_per_sec *
+      std::chrono::duration<double>(
+          settings->sequencer_batching_adaptive_latency_budget)
+          .count();
+  return expected_appends < 2;
+}
+
 bool SequencerBatching::shouldPassthru(const Appender& appender) const {
   const std::shared_ptr<LogsConfig::LogGroupNode> group =
       Worker::getConfig()->getLogGroupByIDShared(appender.getLogID());
@@ -15,6 +15,7 @@
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/InternalAppendRequest.h"
 #include "logdevice/common/Sender.h"
+#include "logdevice/common/Sequencer.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 #include "logdevice/common/protocol/APPEND_Message.h"
@@ -227,6 +228,16 @@ class SequencerBatching : public BufferedWriterImpl::AppendCallbackInternal,
 
   bool shouldPassthru(const Appender& appender) const;
 
+  // Decides whether an append to a log without sequencer batching enabled
+  // should be batched anyway because the log receives many small appends.
+  // See Settings::sequencer_batching_auto_threshold.
+  bool shouldAutoBatch(const Sequencer::ArrivalRate& rate,
+                       const Appender& appender) const;
+
+  // With Settings::sequencer_batching_adaptive, appends to logs that are too
+  // slow for batches to form within the latency budget are passed through.
+  bool shouldPassthruLowRate(const Sequencer::ArrivalRate& rate) const;
+
   // Common handling of BufferedWriter success and failure
   class DispatchResultsRequest;
   void onResult(logid_t,
@@ -129,6 +129,32 @@ void SequencerRouter::onShouldRetry(NodeID node, Status status) {
   sendTo(node, flags_t(0));
 }
 
+void SequencerRouter::onHandedOff(NodeID from, NodeID to) {
+  ld_check(to.isNodeID());
+  ld_check(handler_);
+
+  if (flags_ & REDIRECT_CYCLE) {
+    // Already insisted on a node and got redirected anyway. Handoffs don't
+    // chain, so treat this as a regular redirect.
+    onRedirected(from, to, E::REDIRECTED);
+    return;
+  }
+
+  ld_debug("Log:%lu was handed off from %s to %s, request[type:%s, "
+           "handler:%p]",
+           log_id_.val_,
+           from.toString().c_str(),
+           to.toString().c_str(),
+           handler_->getRequestTypeName().c_str(),
+           handler_);
+
+  last_reply_.node = from;
+  last_reply_.status = E::REDIRECTED;
+  last_reply_.flags = flags_;
+  ++attempts_;
+  sendTo(to, REDIRECT_CYCLE);
+}
+
 void SequencerRouter::onRedirected(NodeID from, NodeID to, Status status) {
   ld_check(status == E::REDIRECTED || status == E::PREEMPTED);
   ld_check(handler_);
@@ -112,6 +112,12 @@ class SequencerRouter {
   // Called when a redirect reply is received from a node.
   void onRedirected(NodeID from, NodeID to, Status status);
 
+  // Called when `from' redirected us to `to' because it handed the log off
+  // to `to' (APPENDED_Header::REDIRECT_HANDOFF). `to' isn't where the log
+  // hashes to, so the message is resent with REDIRECT_CYCLE to keep `to'
+  // from sending us back.
+  void onHandedOff(NodeID from, NodeID to);
+
   // Called when we're not able to communicate to the given node (e.g. failed
   // to connect, node is not in the config, etc.)
   void onNodeUnavailable(NodeID node, Status status);
@@ -38,6 +38,20 @@ enum class ServerRecordFilterType : uint8_t {
 class ServerRecordFilter {
  public:
   virtual bool operator()(folly::StringPiece key) = 0;
+
+  /**
+   * Evaluates the filter on a block of keys, setting passed[i] to the result
+   * of (*this)(keys[i]). Lets callers holding many records check all of them
+   * with one virtual call instead of one per record.
+   */
+  virtual void filterBatch(const folly::StringPiece* keys,
+                           size_t n,
+                           bool* passed) {
+    for (size_t i = 0; i < n; ++i) {
+      passed[i] = (*this)(keys[i]);
+    }
+  }
+
   virtual std::string toString() const = 0;
   virtual ~ServerRecordFilter() {}
 };
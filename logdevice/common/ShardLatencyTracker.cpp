@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ShardLatencyTracker.h"
+
+#include <cmath>
+
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/settings/Settings.h"
+
+namespace facebook { namespace logdevice {
+
+// Bound on the number of STOREs we remember the send time of.
+constexpr size_t kMaxOutgoingMessages = 10000;
+// STOREs that haven't got a reply for this many half-lives are forgotten
+// (e.g. extras that weren't needed and whose Appender has retired) so that
+// they don't count as outstanding forever.
+constexpr int kOutstandingExpiryHalfLives = 8;
+
+void ShardLatencyTracker::Estimate::add(double sample_us,
+                                        Clock::time_point now,
+                                        std::chrono::milliseconds half_life) {
+  if (!initialized) {
+    latency_us = sample_us;
+    last_update = now;
+    initialized = true;
+    return;
+  }
+  // Weight of the old average is 2^(-dt / half_life), so that how fast the
+  // average moves depends on elapsed time rather than on the STORE rate.
+  const double dt = std::chrono::duration<double, std::milli>(
+                        std::max(now - last_update, Clock::duration::zero()))
+                        .count();
+  const double keep = std::exp2(-dt / half_life.count());
+  // Always let the sample have some weight, otherwise many samples with the
+  // same timestamp would be ignored.
+  const double w = std::min(keep, 0.99);
+  latency_us = latency_us * w + sample_us * (1 - w);
+  last_update = std::max(now, last_update);
+}
+
+double ShardLatencyTracker::Estimate::decayedTowards(
+    double target,
+    Clock::time_point now,
+    std::chrono::milliseconds half_life) const {
+  ld_check(initialized);
+  const double dt = std::chrono::duration<double, std::milli>(
+                        std::max(now - last_update, Clock::duration::zero()))
+                        .count();
+  return target + (latency_us - target) * std::exp2(-dt / half_life.count());
+}
+
+std::chrono::milliseconds ShardLatencyTracker::getHalfLife() const {
+  if (half_life_.count() > 0) {
+    return half_life_;
+  }
+  return Worker::settings().adaptive_copyset_selection_half_life;
+}
+
+void ShardLatencyTracker::onCopySent(Status status,
+                                     ShardID to,
+                                     const STORE_Header& header,
+                                     Clock::time_point now) {
+  if (status != E::OK) {
+    return;
+  }
+
+  const MessageKey key = std::make_tuple(to, header.rid, header.wave);
+  if (lookup_table_.count(key)) {
+    // Duplicate notification, e.g. a resent STORE.
+    return;
+  }
+  outgoing_messages_.emplace_back(key, now);
+  lookup_table_[key] = std::prev(outgoing_messages_.end());
+  ++shards_[to].outstanding;
+
+  cleanup();
+}
+
+void ShardLatencyTracker::onReply(ShardID from,
+                                  const STORE_Header& header,
+                                  Clock::time_point now) {
+  const MessageKey key = std::make_tuple(from, header.rid, header.wave);
+  auto it = lookup_table_.find(key);
+  if (it == lookup_table_.end()) {
+    return;
+  }
+
+  const Clock::time_point sent = it->second->second;
+  outgoing_messages_.erase(it->second);
+  lookup_table_.erase(it);
+
+  const double rtt_us =
+      std::chrono::duration<double, std::micro>(
+          std::max(now - sent, Clock::duration::zero()))
+          .count();
+  const std::chrono::milliseconds half_life = getHalfLife();
+  ShardState& state = shards_[from];
+  ld_check(state.outstanding > 0);
+  --state.outstanding;
+  state.latency.add(rtt_us, now, half_life);
+  overall_.add(rtt_us, now, half_life);
+}
+
+double ShardLatencyTracker::getCost(ShardID shard,
+                                    Clock::time_point now) const {
+  if (!overall_.initialized) {
+    return 0;
+  }
+  const std::chrono::milliseconds half_life = getHalfLife();
+  const double average = overall_.latency_us;
+
+  auto it = shards_.find(shard);
+  if (it == shards_.end()) {
+    return average;
+  }
+  const ShardState& state = it->second;
+  const double latency = state.latency.initialized
+      ? state.latency.decayedTowards(average, now, half_life)
+      : average;
+  return latency * (1 + state.outstanding);
+}
+
+size_t ShardLatencyTracker::numOutstanding(ShardID shard) const {
+  auto it = shards_.find(shard);
+  return it == shards_.end() ? 0 : it->second.outstanding;
+}
+
+void ShardLatencyTracker::cleanup() {
+  if (outgoing_messages_.empty()) {
+    return;
+  }
+  const Clock::time_point newest = outgoing_messages_.back().second;
+  const auto max_age = getHalfLife() * kOutstandingExpiryHalfLives;
+  while (!outgoing_messages_.empty() &&
+         (outgoing_messages_.size() > kMaxOutgoingMessages ||
+          newest - outgoing_messages_.front().second > max_age)) {
+    const MessageKey& key = outgoing_messages_.front().first;
+    auto it = shards_.find(std::get<0>(key));
+    ld_check(it != shards_.end());
+    ld_check(it->second.outstanding > 0);
+    --it->second.outstanding;
+    lookup_table_.erase(key);
+    outgoing_messages_.pop_front();
+  }
+}
+
+void ShardLatencyTracker::clear() {
+  shards_.clear();
+  overall_ = Estimate();
+  lookup_table_.clear();
+  outgoing_messages_.clear();
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+#include "logdevice/common/ShardID.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Worker-local estimate of how quickly each storage shard is accepting
+ *       STOREs, used by --adaptive-copyset-selection.
+ *
+ *       For every shard the tracker keeps an exponentially weighted moving
+ *       average of STORE round-trip time and the number of STOREs currently
+ *       outstanding. The cost of a shard is the expected time until a new
+ *       STORE sent to it is acknowledged, estimated as
+ *       latency * (1 + outstanding). WeightedCopySetSelector compares the
+ *       costs of candidate shards and prefers the cheaper ones.
+ *
+ *       The averages are time-weighted with a configurable half-life:
+ *       a sample's weight halves every half-life, regardless of how many
+ *       samples came after it. A shard that stops getting replies (e.g.
+ *       because it's being avoided) drifts back to the average of all shards
+ *       at the same rate, so a shard that recovers gets its traffic back
+ *       smoothly instead of being pinned at its worst estimate.
+ *
+ *       Unlike WorkerTimeoutStats, which is keyed by node, this works with
+ *       shards, so that one degraded disk doesn't penalize the other shards of
+ *       its node.
+ */
+
+class ShardLatencyTracker {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @param half_life  if zero, taken from Worker settings on every call
+   */
+  explicit ShardLatencyTracker(
+      std::chrono::milliseconds half_life = std::chrono::milliseconds::zero())
+      : half_life_(half_life) {}
+
+  // Appender sent (or failed to send) a STORE for the given wave.
+  void onCopySent(Status status,
+                  ShardID to,
+                  const STORE_Header& header,
+                  Clock::time_point now = Clock::now());
+
+  // The STORE got a reply, or the wave timed out while waiting for it.
+  void onReply(ShardID from,
+               const STORE_Header& header,
+               Clock::time_point now = Clock::now());
+
+  /**
+   * @return  The shard's expected time until a STORE is acknowledged, in
+   *          microseconds. Shards without samples get the average cost of
+   *          all shards. Returns 0 if there are no samples at all.
+   */
+  double getCost(ShardID shard, Clock::time_point now = Clock::now()) const;
+
+  size_t numOutstanding(ShardID shard) const;
+
+  void clear();
+
+ private:
+  struct Estimate {
+    // Moving average of round-trip time in microseconds.
+    double latency_us = 0;
+    Clock::time_point last_update;
+    bool initialized = false;
+
+    void add(double sample_us,
+             Clock::time_point now,
+             std::chrono::milliseconds half_life);
+
+    // Value at `now`, decayed toward `target` since the last update.
+    double decayedTowards(double target,
+                          Clock::time_point now,
+                          std::chrono::milliseconds half_life) const;
+  };
+
+  struct ShardState {
+    Estimate latency;
+    size_t outstanding = 0;
+  };
+
+  using MessageKey = std::tuple<ShardID, RecordID, uint32_t>;
+
+  std::chrono::milliseconds getHalfLife() const;
+
+  // Forgets the oldest outstanding STOREs if there are too many of them.
+  void cleanup();
+
+  std::unordered_map<ShardID, ShardState, ShardID::Hash> shards_;
+
+  // Average over all shards.
+  Estimate overall_;
+
+  std::map<MessageKey, std::list<std::pair<MessageKey, Clock::time_point>>::
+                           iterator>
+      lookup_table_;
+  std::list<std::pair<MessageKey, Clock::time_point>> outgoing_messages_;
+
+  const std::chrono::milliseconds half_life_;
+};
+
+}} // namespace facebook::logdevice
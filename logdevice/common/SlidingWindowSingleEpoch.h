@@ -13,6 +13,8 @@
 #include <memory>
 #include <vector>
 
+#include <folly/lang/Align.h>
+
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/SlidingWindow.h"
 #include "logdevice/common/types_internal.h"
@@ -206,31 +208,66 @@ class SlidingWindowSingleEpoch {
 
     } while (!right_.compare_exchange_weak(r, r + 1));
 
-    // now atomically |= p into state_[r % capacity_]
-    // We do it with an explicit cas loop to check invariants.
+    fillSlot(r, p);
+    return r;
+  }
 
-    uintptr_t cur; // value of slot [r % N] before we mark it INUSE
+  /**
+   * Like grow(), but inserts @param n elements at once and gives them
+   * consecutive LSNs. Tokens for all of them are taken with one update of
+   * size_ and the right edge is moved once, so a Worker admitting several
+   * Appenders of a log touches the contended atomics once rather than n
+   * times. Either all elements are inserted or none is. Conditional inserts
+   * are not supported.
+   *
+   * @param   es  array of @param n pointers to insert, in LSN order. Must
+   *              not contain nullptr.
+   *
+   * @return  on success the LSN assigned to es[0]; es[i] is at that LSN + i.
+   *          On failure LSN_INVALID is returned and err is set as in grow().
+   *          NOBUFS and TOOBIG are reported if there is no room for all n
+   *          elements, even if some of them would fit.
+   */
+  lsn_t growMany(Element* const* es, size_t n) {
+    ld_check(n > 0);
+    for (size_t i = 0; i < n; ++i) {
+      uintptr_t p = reinterpret_cast<uintptr_t>(es[i]);
+      if (!p || (p & SW_FLAGS)) {
+        ld_check(false);
+        err = E::INVALID_PARAM;
+        return LSN_INVALID;
+      }
+    }
+
+    size_t token = size_.fetch_add(n);
+
+    if (token + n > capacity_) {
+      size_.fetch_sub(n);
+      err = E::NOBUFS;
+      return LSN_INVALID;
+    }
 
+    lsn_t r = right_.load();
     do {
-      cur = slot(r).load();
+      if (r == LSN_DISABLED) {
+        size_.fetch_sub(n);
+        err = E::DISABLED;
+        return LSN_INVALID;
+      }
 
-      // cur has to be an unused slot w/o the SW_RETIRED flag since we have
-      // already reserve the slot (i.e., acquire the token) ealier in this
-      // function, and we always clear the front slot before releasing a
-      // slot/token
-      ld_check((cur & ~SW_TAIL) == 0);
-      // cur cannot contain a pointer because we hold 1 space in the
-      // window of size capacity_ (=N). The only LSNs that can
-      // occupy the same entry as r in the state_[] vector are in the
-      // set {r + kN} for arbitrary integers k.  The
-      // (size_.fetch_add(1) > capacity_) check at the beginning
-      // of this function guarantees that r+kN is not yet issued for
-      // all positive k's.  The cleanup code in retire() guarantees
-      // that (r + kN) has already been retired for all negative k's
-      // by the time we get here.  cur can have TAIL bit set if
-      // window is empty
-    } while (!slot(r).compare_exchange_strong(cur, cur | p));
+      if (lsn_to_esn(r).val_ + (n - 1) > esn_max_.val_) {
+        // Not enough ESNs left in this epoch for the whole range.
+        size_.fetch_sub(n);
+        err = E::TOOBIG;
+        return LSN_INVALID;
+      }
+      ld_check(lsn_to_esn(r) < ESN_MAX);
 
+    } while (!right_.compare_exchange_weak(r, r + n));
+
+    for (size_t i = 0; i < n; ++i) {
+      fillSlot(r + i, reinterpret_cast<uintptr_t>(es[i]));
+    }
     return r;
   }
 
@@ -436,6 +473,36 @@ class SlidingWindowSingleEpoch {
     return lsn_to_esn(lsn).val_ % capacity();
   }
 
+  /**
+   * Atomically |= p into the slot of @param r, an LSN for which the caller
+   * holds a token and which it has just taken from right_.
+   */
+  void fillSlot(lsn_t r, uintptr_t p) {
+    // We do it with an explicit cas loop to check invariants.
+
+    uintptr_t cur; // value of slot [r % N] before we mark it INUSE
+
+    do {
+      cur = slot(r).load();
+
+      // cur has to be an unused slot w/o the SW_RETIRED flag since we have
+      // already reserve the slot (i.e., acquire the token) ealier in
+      // grow(), and we always clear the front slot before releasing a
+      // slot/token
+      ld_check((cur & ~SW_TAIL) == 0);
+      // cur cannot contain a pointer because we hold 1 space in the
+      // window of size capacity_ (=N). The only LSNs that can
+      // occupy the same entry as r in the state_[] vector are in the
+      // set {r + kN} for arbitrary integers k.  The
+      // (size_.fetch_add(1) > capacity_) check at the beginning
+      // of grow() guarantees that r+kN is not yet issued for
+      // all positive k's.  The cleanup code in retire() guarantees
+      // that (r + kN) has already been retired for all negative k's
+      // by the time we get here.  cur can have TAIL bit set if
+      // window is empty
+    } while (!slot(r).compare_exchange_strong(cur, cur | p));
+  }
+
   unsigned next_index(unsigned idx) const {
     return (idx < capacity() - 1) ? (idx + 1) : 0;
   }
@@ -481,7 +548,14 @@ class SlidingWindowSingleEpoch {
   // token in the range [0..capacity_). Tokens are put back when
   // retire() shrinks the window and when grow() gets a token that's
   // too large. The value may temporarily exceed capacity_.
-  std::atomic<size_t> size_;
+  //
+  // Appenders of a hot log are admitted and reaped on different Workers.
+  // size_ (written by grow() and retire()), right_ (written by grow() only)
+  // and state_ (read-only after construction) are kept on separate cache
+  // lines so that admitting an Appender doesn't invalidate the line that
+  // reapers read, and vice versa.
+  alignas(folly::hardware_destructive_interference_size)
+      std::atomic<size_t> size_;
 
   // Max ESN to issue, inclusive (typically ESN_MAX - 1)
   const esn_t esn_max_;
@@ -492,7 +566,8 @@ class SlidingWindowSingleEpoch {
   // right edge of the window (max LSN in window plus one), or LSN_DISABLED if
   // the window is disabled. Next successful call to grow() will return this
   // LSN.
-  std::atomic<lsn_t> right_;
+  alignas(folly::hardware_destructive_interference_size) std::atomic<lsn_t>
+      right_;
 
   // tail lsn of the previous epoch, used for validating conditional insert
   // in the case that it's the first insert of the window.
@@ -504,7 +579,8 @@ class SlidingWindowSingleEpoch {
 
   // circular array of Element pointers and flags defined below. Its size is
   // fixed at construction and equals the capacity.
-  std::unique_ptr<std::atomic<uintptr_t>[]> state_;
+  alignas(folly::hardware_destructive_interference_size)
+      std::unique_ptr<std::atomic<uintptr_t>[]> state_;
 
   // a special value that may be stored in `prev_epoch_tail_`. used to
   // indicate that the sliding window is disabled and cannot take new appends
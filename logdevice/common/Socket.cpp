@@ -18,15 +18,18 @@
 #include <openssl/err.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <zstd.h>
 
 #include "event2/bufferevent_ssl.h"
 #include "event2/event.h"
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/BWAvailableCallback.h"
 #include "logdevice/common/BuildInfo.h"
+#include "logdevice/common/Checksum.h"
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/EventHandler.h"
 #include "logdevice/common/FlowGroup.h"
+#include "logdevice/common/LatencyInjection.h"
 #include "logdevice/common/PrincipalParser.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/ResourceBudget.h"
@@ -35,12 +38,14 @@
 #include "logdevice/common/SocketCallback.h"
 #include "logdevice/common/UpdateableSecurityInfo.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/chrono_util.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/libevent/compat.h"
 #include "logdevice/common/plugin/PluginRegistry.h"
 #include "logdevice/common/protocol/ACK_Message.h"
+#include "logdevice/common/protocol/COMPRESSED_FRAME_Message.h"
 #include "logdevice/common/protocol/Compatibility.h"
 #include "logdevice/common/protocol/HELLO_Message.h"
 #include "logdevice/common/protocol/Message.h"
@@ -145,6 +150,7 @@ Socket::Socket(std::unique_ptr<SocketDependencies>& deps,
                         (peer_sockaddr_.valid() ? peer_sockaddr_.toString()
                                                 : std::string("UNKNOWN")) +
                         ")"),
+      peer_scope_(flow_group.scope()),
       flow_group_(flow_group),
       type_(type),
       socket_ref_holder_(std::make_shared<bool>(true), this),
@@ -166,7 +172,9 @@ Socket::Socket(std::unique_ptr<SocketDependencies>& deps,
       close_reason_(E::UNKNOWN),
       num_messages_sent_(0),
       num_messages_received_(0),
-      num_bytes_received_(0) {
+      num_bytes_received_(0),
+      zstd_cctx_(nullptr, ZSTD_freeCCtx),
+      zstd_dctx_(nullptr, ZSTD_freeDCtx) {
   if ((conntype == ConnectionType::SSL) ||
       (forceSSLSockets() && type != SocketType::GOSSIP)) {
     conntype_ = ConnectionType::SSL;
@@ -245,6 +253,22 @@ Socket::Socket(std::unique_ptr<SocketDependencies>& deps,
     err = E::INTERNAL;
     throw ConstructorFailed();
   }
+
+  rv = deps_->evtimerAssign(&coalesced_output_flush_event_,
+                            EventHandler<onCoalescedOutputTimerEvent>,
+                            reinterpret_cast<void*>(this));
+  if (rv != 0) {
+    err = E::INTERNAL;
+    throw ConstructorFailed();
+  }
+
+  rv = deps_->evtimerAssign(&delayed_send_event_,
+                            EventHandler<onDelayedSendTimerEvent>,
+                            reinterpret_cast<void*>(this));
+  if (rv != 0) {
+    err = E::INTERNAL;
+    throw ConstructorFailed();
+  }
 }
 
 Socket::Socket(NodeID server_name,
@@ -353,6 +377,18 @@ void Socket::onBufferedOutputTimerEvent(void* instance, short) {
   self->flushBufferedOutput();
 }
 
+void Socket::onCoalescedOutputTimerEvent(void* instance, short) {
+  auto self = reinterpret_cast<Socket*>(instance);
+  ld_check(self);
+  self->flushCoalescedOutput();
+}
+
+void Socket::onDelayedSendTimerEvent(void* instance, short) {
+  auto self = reinterpret_cast<Socket*>(instance);
+  ld_check(self);
+  self->flushDelayedSends();
+}
+
 Socket::~Socket() {
   ld_debug("Destroying Socket %s", conn_description_.c_str());
   close(E::SHUTDOWN);
@@ -425,6 +461,10 @@ struct bufferevent* Socket::newBufferevent(int sfd,
     return nullptr;
   }
 
+  if (isSSL() && ssl_state == BUFFEREVENT_SSL_CONNECTING) {
+    deps_->buffereventResumeSSLSession(bev, peer_sockaddr_);
+  }
+
   struct evbuffer* outbuf = deps_->getOutput(bev);
   ld_check(outbuf);
 
@@ -636,6 +676,7 @@ size_t Socket::getTotalOutbufLength() {
   if (buffered_output_) {
     pending_bytes += LD_EV(evbuffer_get_length)(buffered_output_);
   }
+  pending_bytes += coalesced_output_.size();
   return pending_bytes;
 }
 
@@ -655,6 +696,10 @@ void Socket::onOutputEmpty(struct bufferevent*, void* arg, short) {
 }
 
 void Socket::flushOutputAndClose(Status reason) {
+  if (flushCoalescedOutput() != 0) {
+    // the socket was closed
+    return;
+  }
   auto pending_bytes = getTotalOutbufLength();
 
   if (pending_bytes == 0) {
@@ -845,6 +890,18 @@ void Socket::flushSerializeQueue() {
 
 void Socket::onConnected() {
   ld_check(bev_);
+  // For SSL sockets, BEV_EVENT_CONNECTED means the handshake completed, in
+  // both directions.
+  if (isSSL() && !kernel_tls_ && deps_->buffereventKernelTLSEnabled(bev_)) {
+    kernel_tls_ = true;
+    STAT_INCR(deps_->getStats(), num_ktls_connections);
+  }
+  if (isSSL()) {
+    STAT_INCR(deps_->getStats(), ssl_handshakes_completed);
+    if (deps_->buffereventSSLSessionReused(bev_)) {
+      STAT_INCR(deps_->getStats(), ssl_handshakes_resumed);
+    }
+  }
   if (expecting_ssl_handshake_) {
     ld_check(connected_);
     // we receive a BEV_EVENT_CONNECTED for an _incoming_ connection after the
@@ -862,6 +919,9 @@ void Socket::onConnected() {
   addHandshakeTimeoutEvent();
   connected_ = true;
   peer_shuttingdown_ = false;
+  if (isSSL()) {
+    deps_->buffereventSaveSSLSession(bev_, peer_sockaddr_);
+  }
 
   ld_debug(
       "Socket(%p) to node %s has connected", this, conn_description_.c_str());
@@ -1111,7 +1171,23 @@ void Socket::close(Status reason) {
     buffered_output_ = nullptr;
   }
 
+  // Messages in coalesced_output_ are still in sendq_ and fail below.
+  deps_->evtimerDel(&coalesced_output_flush_event_);
+  if (!deps_->shuttingDown()) {
+    deps_->noteBytesDrained(coalesced_output_.size());
+  }
+  coalesced_output_.clear();
+  coalesced_output_compressed_ = false;
+
+  // A new connection starts new compression streams.
+  zstd_cctx_.reset();
+  zstd_dctx_.reset();
+
   if (isSSL()) {
+    if (connected_ && !peer_name_.isClientAddress()) {
+      // With TLS 1.3, the session ticket arrives after the handshake.
+      deps_->buffereventSaveSSLSession(bev_, peer_sockaddr_);
+    }
     deps_->buffereventShutDownSSL(bev_);
   }
 
@@ -1135,12 +1211,17 @@ void Socket::close(Status reason) {
   if (isSSL()) {
     STAT_DECR(deps_->getStats(), num_ssl_connections);
   }
+  if (kernel_tls_) {
+    STAT_DECR(deps_->getStats(), num_ktls_connections);
+    kernel_tls_ = false;
+  }
 
   deps_->evtimerDel(&read_more_);
   deps_->evtimerDel(&connect_timeout_event_);
   deps_->evtimerDel(&handshake_timeout_event_);
   deps_->evtimerDel(&deferred_event_queue_event_);
   deps_->eventDel(&end_stream_rewind_event_);
+  deps_->evtimerDel(&delayed_send_event_);
 
   // Move everything here so that this Socket object has a clean state
   // before we call any callback.
@@ -1148,6 +1229,10 @@ void Socket::close(Status reason) {
   std::vector<EnvelopeQueue> moved_queues;
   moved_queues.emplace_back(std::move(serializeq_));
   moved_queues.emplace_back(std::move(sendq_));
+  // Sent after everything in sendq_.
+  auto moved_delayed_sends = std::move(delayed_sends_);
+  delayed_sends_.clear();
+  delayed_sends_cost_ = 0;
   folly::IntrusiveList<SocketCallback, &SocketCallback::listHook_>
       on_close_moved = std::move(impl_->on_close_);
   folly::IntrusiveList<BWAvailableCallback, &BWAvailableCallback::links_>
@@ -1156,6 +1241,7 @@ void Socket::close(Status reason) {
   ld_check(pendingq_.empty());
   ld_check(serializeq_.empty());
   ld_check(sendq_.empty());
+  ld_check(delayed_sends_.empty());
   ld_check(impl_->on_close_.empty());
   ld_check(impl_->pending_bw_cbs_.empty());
   ld_check(deferred_event_queue_.empty());
@@ -1167,6 +1253,9 @@ void Socket::close(Status reason) {
       onSent(std::move(e), reason);
     }
   }
+  for (auto& delayed : moved_delayed_sends) {
+    onSent(std::move(delayed.second), reason);
+  }
 
   // Clients expect all outstanding messages to be completed prior to
   // delivering "on close" callbacks.
@@ -1205,6 +1294,7 @@ bool Socket::isClosed() const {
   ld_check(!connected_);
   ld_check(sendq_.empty());
   ld_check(serializeq_.empty());
+  ld_check(delayed_sends_.empty());
   ld_check(getBytesPending() == 0);
   return true;
 }
@@ -1377,25 +1467,467 @@ int Socket::serializeMessageWithChecksum(const Message& msg,
   return 0;
 }
 
+namespace {
+
+// ProtocolWriter destination appending to the end of a std::string. Unlike
+// the linear buffer destinations in ProtocolWriter.cpp it accepts evbuffer
+// sources (by copying them), since any message can be small enough to be
+// coalesced.
+class CoalescedOutputDestination : public ProtocolWriter::Destination {
+ public:
+  explicit CoalescedOutputDestination(std::string* dest)
+      : dest_(dest), start_(dest->size()) {}
+
+  int write(const void* src, size_t nbytes, size_t nwritten) override {
+    ld_check(start_ + nwritten == dest_->size());
+    dest_->append(static_cast<const char*>(src), nbytes);
+    return 0;
+  }
+
+  int writeWithoutCopy(const void* src,
+                       size_t nbytes,
+                       size_t nwritten) override {
+    return write(src, nbytes, nwritten);
+  }
+
+  int writeEvbuffer(evbuffer* src) override {
+    const size_t nbytes = LD_EV(evbuffer_get_length)(src);
+    const size_t offset = dest_->size();
+    dest_->resize(offset + nbytes);
+    if (LD_EV(evbuffer_copyout)(src, &(*dest_)[offset], nbytes) !=
+        static_cast<ssize_t>(nbytes)) {
+      dest_->resize(offset);
+      err = E::INTERNAL;
+      return -1;
+    }
+    return 0;
+  }
+
+  const char* identify() const override {
+    return "coalesced output destination";
+  }
+
+  bool isNull() const override {
+    return false;
+  }
+
+  uint64_t computeChecksum() override {
+    return checksum_64bit(
+        Slice(dest_->data() + start_, dest_->size() - start_));
+  }
+
+ private:
+  std::string* const dest_;
+  // Offset in dest_ of the first byte written through this destination.
+  const size_t start_;
+};
+
+// Once this many bytes are coalesced, they are flushed right away instead of
+// at the end of the event loop iteration.
+constexpr size_t kMaxCoalescedOutputBytes = 64 * 1024;
+
+// Larger messages are sent uncompressed even on compressed connections, so
+// that a frame never exceeds Message::MAX_LEN.
+constexpr size_t kMaxCompressedMessageSize = Message::MAX_LEN / 2;
+
+// Size of the window of the streaming compression contexts. Bounds the memory
+// used by each compressed connection on both ends.
+constexpr int kCompressionWindowLog = 17;
+
+} // namespace
+
+int Socket::serializeMessageCoalesced(const Message& msg,
+                                      size_t msglen,
+                                      bool compute_checksum,
+                                      bool compress) {
+  if (!coalesced_output_.empty() && coalesced_output_compressed_ != compress) {
+    if (flushCoalescedOutput() != 0) {
+      // Socket was closed.
+      return -1;
+    }
+  }
+  coalesced_output_compressed_ = compress;
+
+  const size_t offset = coalesced_output_.size();
+  ProtocolHeader protohdr;
+  protohdr.len = msglen;
+  protohdr.type = msg.type_;
+  const size_t protohdr_bytes = ProtocolHeader::bytesNeeded(msg.type_, proto_);
+
+  // Leave room for the header, which is filled in once the checksum of the
+  // body is known.
+  coalesced_output_.resize(offset + protohdr_bytes);
+  CoalescedOutputDestination dest(&coalesced_output_);
+  ProtocolWriter writer(&dest, messageTypeNames()[msg.type_].c_str(), proto_);
+  msg.serialize(writer);
+  ssize_t bodylen = writer.result();
+  if (bodylen <= 0) { // unlikely
+    coalesced_output_.resize(offset);
+    RATELIMIT_CRITICAL(std::chrono::seconds(1),
+                       2,
+                       "INTERNAL ERROR: Failed to serialize a message of "
+                       "type %s into the coalesced output buffer",
+                       messageTypeNames()[msg.type_].c_str());
+    ld_check(0);
+    err = E::INTERNAL;
+    close(err);
+    return -1;
+  }
+
+  if (compute_checksum) {
+    protohdr.cksum = writer.computeChecksum();
+    /* For Tests only */
+    if (shouldTamperChecksum()) {
+      protohdr.cksum += 1;
+    }
+  }
+  memcpy(&coalesced_output_[offset], &protohdr, protohdr_bytes);
+  ld_check(bodylen + protohdr_bytes == protohdr.len);
+
+  if (!deps_->evtimerPending(&coalesced_output_flush_event_)) {
+    deps_->evtimerAdd(
+        &coalesced_output_flush_event_, deps_->getZeroTimeout());
+  }
+  return 0;
+}
+
+int Socket::flushCoalescedOutput() {
+  if (coalesced_output_.empty()) {
+    return 0;
+  }
+  ld_check(bev_);
+  deps_->evtimerDel(&coalesced_output_flush_event_);
+
+  struct evbuffer* outbuf =
+      buffered_output_ ? buffered_output_ : deps_->getOutput(bev_);
+  ld_check(outbuf);
+  int rv;
+  if (coalesced_output_compressed_) {
+    rv = writeCompressedFrame(outbuf);
+  } else {
+    rv = LD_EV(evbuffer_add)(
+        outbuf, coalesced_output_.data(), coalesced_output_.size());
+    if (rv != 0) {
+      ld_error("evbuffer_add() failed. error %d", rv);
+      err = E::NOMEM;
+    }
+  }
+  coalesced_output_.clear();
+  if (rv != 0) {
+    close(err);
+    return -1;
+  }
+  return 0;
+}
+
+bool Socket::shouldCompress(MessageType type) {
+  return type_ == SocketType::DATA && handshaken_ &&
+      !isHandshakeMessage(type) &&
+      proto_ >= Compatibility::COMPRESSED_FRAME_SUPPORT &&
+      peer_scope_ > getSettings().socket_compression_boundary;
+}
+
+int Socket::writeCompressedFrame(struct evbuffer* outbuf) {
+  const size_t uncompressed_len = coalesced_output_.size();
+  ld_check(uncompressed_len > 0);
+  auto start_time = std::chrono::steady_clock::now();
+
+  if (!zstd_cctx_) {
+    zstd_cctx_.reset(ZSTD_createCCtx());
+    if (!zstd_cctx_) {
+      err = E::NOMEM;
+      return -1;
+    }
+    ZSTD_CCtx_setParameter(zstd_cctx_.get(),
+                           ZSTD_c_compressionLevel,
+                           getSettings().socket_compression_level);
+    ZSTD_CCtx_setParameter(
+        zstd_cctx_.get(), ZSTD_c_windowLog, kCompressionWindowLog);
+  }
+
+  // The compressed bytes go after the headers, which are filled in once the
+  // size of the frame is known.
+  ProtocolHeader protohdr;
+  protohdr.type = MessageType::COMPRESSED_FRAME;
+  // Messages in the frame carry their own checksums. A zero checksum is not
+  // verified by the recipient.
+  protohdr.cksum = 0;
+  const size_t protohdr_bytes =
+      ProtocolHeader::bytesNeeded(protohdr.type, proto_);
+  COMPRESSED_FRAME_Header framehdr;
+  framehdr.uncompressed_len = uncompressed_len;
+  const size_t prefix_len = protohdr_bytes + sizeof(framehdr);
+
+  compressed_output_.resize(prefix_len + ZSTD_compressBound(uncompressed_len));
+  ZSTD_inBuffer in = {coalesced_output_.data(), uncompressed_len, 0};
+  ZSTD_outBuffer out = {&compressed_output_[prefix_len],
+                        compressed_output_.size() - prefix_len,
+                        0};
+  size_t remaining;
+  do {
+    // ZSTD_e_flush makes all of the input decodable from this frame and the
+    // ones before it, while keeping the history for the next frames.
+    remaining =
+        ZSTD_compressStream2(zstd_cctx_.get(), &out, &in, ZSTD_e_flush);
+    if (ZSTD_isError(remaining)) {
+      RATELIMIT_CRITICAL(std::chrono::seconds(1),
+                         2,
+                         "INTERNAL ERROR: ZSTD_compressStream2() failed on "
+                         "socket %s: %s",
+                         conn_description_.c_str(),
+                         ZSTD_getErrorName(remaining));
+      err = E::INTERNAL;
+      return -1;
+    }
+    if (remaining > 0) {
+      // Out of room, which the bound should have prevented. Grow the buffer.
+      compressed_output_.resize(compressed_output_.size() + remaining);
+      out.dst = &compressed_output_[prefix_len];
+      out.size = compressed_output_.size() - prefix_len;
+    }
+  } while (remaining > 0);
+  ld_check(in.pos == in.size);
+
+  const size_t frame_len = prefix_len + out.pos;
+  ld_check(frame_len <= Message::MAX_LEN + protohdr_bytes);
+  protohdr.len = frame_len;
+  memcpy(&compressed_output_[0], &protohdr, protohdr_bytes);
+  memcpy(&compressed_output_[protohdr_bytes], &framehdr, sizeof(framehdr));
+
+  int rv = LD_EV(evbuffer_add)(outbuf, compressed_output_.data(), frame_len);
+  if (rv != 0) {
+    ld_error("evbuffer_add() failed. error %d", rv);
+    err = E::NOMEM;
+    return -1;
+  }
+
+  // The messages in the frame were accounted for with their uncompressed
+  // size. They are all at the end of sendq_ and are passed to TCP together,
+  // once the last byte of the frame is: move their drain positions to the end
+  // of the frame and fix up the number of bytes pending in Sender.
+  const message_pos_t frame_start = next_pos_ - uncompressed_len;
+  ld_check(frame_start >= drain_pos_);
+  for (auto it = sendq_.rbegin();
+       it != sendq_.rend() && it->getDrainPos() > frame_start;
+       ++it) {
+    it->setDrainPos(frame_start + frame_len);
+  }
+  next_pos_ = frame_start + frame_len;
+  if (frame_len < uncompressed_len) {
+    deps_->noteBytesDrained(uncompressed_len - frame_len);
+  } else {
+    deps_->noteBytesQueued(frame_len - uncompressed_len);
+  }
+
+  if (deps_->getStats()) {
+    auto& stats = deps_->getStats()
+                      ->get()
+                      .per_flow_group_stats[static_cast<int>(peer_scope_)];
+    stats.compression_bytes_in += uncompressed_len;
+    stats.compression_bytes_out += frame_len;
+    stats.compression_usec += usec_since(start_time);
+    ++stats.compressed_frames_sent;
+  }
+  return 0;
+}
+
+int Socket::onCompressedFrameReceived(ProtocolHeader ph,
+                                      struct evbuffer* inbuf) {
+  const size_t protohdr_bytes = ProtocolHeader::bytesNeeded(ph.type, proto_);
+  ProtocolReader reader(ph.type, inbuf, ph.len - protohdr_bytes, proto_);
+  std::unique_ptr<Message> msg =
+      COMPRESSED_FRAME_Message::deserialize(reader).msg;
+  if (!msg) {
+    ld_error("PROTOCOL ERROR: COMPRESSED_FRAME message received from peer %s "
+             "has invalid format. proto_:%hu",
+             conn_description_.c_str(),
+             proto_);
+    err = E::BADMSG;
+    return -1;
+  }
+  if (type_ != SocketType::DATA ||
+      proto_ < Compatibility::COMPRESSED_FRAME_SUPPORT) {
+    ld_error("PROTOCOL ERROR: got a COMPRESSED_FRAME from %s on a %s "
+             "connection with protocol %hu",
+             conn_description_.c_str(),
+             type_ == SocketType::DATA ? "data" : "gossip",
+             proto_);
+    err = E::PROTO;
+    return -1;
+  }
+  MESSAGE_TYPE_STAT_INCR(deps_->getStats(), ph.type, message_received);
+
+  const auto& frame = static_cast<const COMPRESSED_FRAME_Message&>(*msg);
+  const size_t uncompressed_len = frame.getHeader().uncompressed_len;
+  if (uncompressed_len > kMaxCoalescedOutputBytes + kMaxCompressedMessageSize) {
+    ld_error("PROTOCOL ERROR: COMPRESSED_FRAME from %s claims %zu bytes "
+             "uncompressed, expected at most %zu",
+             conn_description_.c_str(),
+             uncompressed_len,
+             kMaxCoalescedOutputBytes + kMaxCompressedMessageSize);
+    err = E::BADMSG;
+    return -1;
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+  if (!zstd_dctx_) {
+    zstd_dctx_.reset(ZSTD_createDCtx());
+    if (!zstd_dctx_) {
+      err = E::NOMEM;
+      return -1;
+    }
+  }
+
+  struct evbuffer* frame_buf = LD_EV(evbuffer_new)();
+  if (!frame_buf) {
+    err = E::NOMEM;
+    return -1;
+  }
+  SCOPE_EXIT {
+    LD_EV(evbuffer_free)(frame_buf);
+  };
+
+  // Decompress straight into a single contiguous chain of frame_buf.
+  struct evbuffer_iovec vec;
+  if (LD_EV(evbuffer_reserve_space)(frame_buf, uncompressed_len, &vec, 1) !=
+      1) {
+    err = E::NOMEM;
+    return -1;
+  }
+  const std::string& compressed = frame.getCompressed();
+  ZSTD_inBuffer in = {compressed.data(), compressed.size(), 0};
+  ZSTD_outBuffer out = {vec.iov_base, uncompressed_len, 0};
+  while (in.pos < in.size || out.pos < out.size) {
+    const size_t in_pos = in.pos;
+    const size_t out_pos = out.pos;
+    size_t rv = ZSTD_decompressStream(zstd_dctx_.get(), &out, &in);
+    if (ZSTD_isError(rv)) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      2,
+                      "ZSTD_decompressStream() failed on a COMPRESSED_FRAME "
+                      "from %s: %s",
+                      conn_description_.c_str(),
+                      ZSTD_getErrorName(rv));
+      err = E::BADMSG;
+      return -1;
+    }
+    if (in.pos == in_pos && out.pos == out_pos) {
+      // No progress: the frame does not match its stated size.
+      break;
+    }
+  }
+  if (in.pos != in.size || out.pos != out.size) {
+    ld_error("PROTOCOL ERROR: COMPRESSED_FRAME from %s decompressed to at "
+             "least %zu bytes with %zu of %zu compressed bytes left, expected "
+             "%zu bytes",
+             conn_description_.c_str(),
+             out.pos,
+             in.size - in.pos,
+             in.size,
+             uncompressed_len);
+    err = E::BADMSG;
+    return -1;
+  }
+  vec.iov_len = uncompressed_len;
+  if (LD_EV(evbuffer_commit_space)(frame_buf, &vec, 1) != 0) {
+    err = E::INTERNAL;
+    return -1;
+  }
+  msg.reset();
+
+  if (deps_->getStats()) {
+    auto& stats = deps_->getStats()
+                      ->get()
+                      .per_flow_group_stats[static_cast<int>(peer_scope_)];
+    stats.decompression_bytes_out += uncompressed_len;
+    stats.decompression_usec += usec_since(start_time);
+  }
+
+  // Process the messages of the frame as if they came from inbuf.
+  const size_t min_protohdr_bytes =
+      sizeof(ProtocolHeader) - sizeof(ProtocolHeader::cksum);
+  size_t left = uncompressed_len;
+  while (left > 0) {
+    ProtocolHeader inner_ph;
+    if (left < min_protohdr_bytes ||
+        LD_EV(evbuffer_remove)(frame_buf, &inner_ph, min_protohdr_bytes) !=
+            min_protohdr_bytes) {
+      ld_error("PROTOCOL ERROR: truncated message header in a "
+               "COMPRESSED_FRAME from %s",
+               conn_description_.c_str());
+      err = E::BADMSG;
+      return -1;
+    }
+    left -= min_protohdr_bytes;
+
+    const size_t inner_protohdr_bytes =
+        ProtocolHeader::bytesNeeded(inner_ph.type, proto_);
+    if (messageDeserializers[inner_ph.type] == nullptr ||
+        isHandshakeMessage(inner_ph.type) ||
+        inner_ph.type == MessageType::COMPRESSED_FRAME ||
+        inner_ph.len <= inner_protohdr_bytes ||
+        inner_ph.len - min_protohdr_bytes > left) {
+      ld_error("PROTOCOL ERROR: got an invalid message of type %d and "
+               "length %u in a COMPRESSED_FRAME from %s",
+               int(inner_ph.type),
+               inner_ph.len,
+               conn_description_.c_str());
+      err = E::BADMSG;
+      return -1;
+    }
+    if (ProtocolHeader::needChecksumInHeader(inner_ph.type, proto_)) {
+      LD_EV(evbuffer_remove)(
+          frame_buf, &inner_ph.cksum, sizeof(inner_ph.cksum));
+    }
+    left -= inner_ph.len - min_protohdr_bytes;
+
+    int rv = onReceived(inner_ph, frame_buf);
+    if (rv != 0) {
+      return rv;
+    }
+    if (LD_EV(evbuffer_get_length)(frame_buf) != left) {
+      // The message was not consumed, the rest of the frame can't be parsed.
+      ld_error("PROTOCOL ERROR: failed to parse a message of type %s in a "
+               "COMPRESSED_FRAME from %s",
+               messageTypeNames()[inner_ph.type].c_str(),
+               conn_description_.c_str());
+      err = E::BADMSG;
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int Socket::serializeMessage(std::unique_ptr<Envelope>&& envelope,
                              size_t msglen) {
   // We should only write to the output buffer once connected.
   ld_check(connected_);
 
   const auto& msg = envelope->message();
-  struct evbuffer* outbuf =
-      buffered_output_ ? buffered_output_ : deps_->getOutput(bev_);
-  ld_check(outbuf);
 
   bool compute_checksum =
       ProtocolHeader::needChecksumInHeader(msg.type_, proto_) &&
       isChecksummingEnabled(msg.type_);
 
+  const bool compress = shouldCompress(msg.type_);
+
   int rv = 0;
-  if (compute_checksum) {
-    rv = serializeMessageWithChecksum(msg, msglen, outbuf);
+  if (compress ? msglen <= kMaxCompressedMessageSize
+               : msglen <= getSettings().socket_coalesce_max_message_size) {
+    rv = serializeMessageCoalesced(msg, msglen, compute_checksum, compress);
+  } else if (flushCoalescedOutput() != 0) {
+    // Socket was closed.
+    return -1;
   } else {
-    rv = serializeMessageWithoutChecksum(msg, msglen, outbuf);
+    struct evbuffer* outbuf =
+        buffered_output_ ? buffered_output_ : deps_->getOutput(bev_);
+    ld_check(outbuf);
+
+    if (compute_checksum) {
+      rv = serializeMessageWithChecksum(msg, msglen, outbuf);
+    } else {
+      rv = serializeMessageWithoutChecksum(msg, msglen, outbuf);
+    }
   }
 
   if (rv != 0) {
@@ -1416,6 +1948,13 @@ int Socket::serializeMessage(std::unique_ptr<Envelope>&& envelope,
   ld_check(!envelope);
 
   deps_->noteBytesQueued(msglen);
+
+  if (coalesced_output_.size() >= kMaxCoalescedOutputBytes) {
+    // Flushed only now that the message is in sendq_, so that a compressed
+    // frame accounts for it. If this closes the socket, close() completes
+    // the message.
+    flushCoalescedOutput();
+  }
   return 0;
 }
 
@@ -1451,6 +1990,58 @@ bool Socket::injectAsyncMessageError(std::unique_ptr<Envelope>&& e) {
   return false;
 }
 
+bool Socket::injectMessageLatency(std::unique_ptr<Envelope>& envelope) {
+  const MessageType type = envelope->message().type_;
+  if (isHandshakeMessage(type)) {
+    return false;
+  }
+  auto latency = MessageLatencyInjection::instance().getLatencyToInject(type);
+  if (latency.count() == 0 && delayed_sends_.empty()) {
+    return false;
+  }
+
+  auto send_time = std::chrono::steady_clock::now() + latency;
+  if (!delayed_sends_.empty()) {
+    send_time = std::max(send_time, delayed_sends_.back().first);
+  }
+  const bool was_empty = delayed_sends_.empty();
+  delayed_sends_cost_ += envelope->cost();
+  delayed_sends_.emplace_back(send_time, std::move(envelope));
+  if (was_empty) {
+    auto usec = to_usec(latency).count();
+    timeval tv{usec / 1000000, usec % 1000000};
+    deps_->evtimerAdd(&delayed_send_event_, &tv);
+  }
+  return true;
+}
+
+void Socket::flushDelayedSends() {
+  const auto now = std::chrono::steady_clock::now();
+  while (!delayed_sends_.empty() && delayed_sends_.front().first <= now) {
+    std::unique_ptr<Envelope> envelope =
+        std::move(delayed_sends_.front().second);
+    delayed_sends_.pop_front();
+    delayed_sends_cost_ -= envelope->cost();
+    if (envelope->message().cancelled()) {
+      onSent(std::move(envelope), E::CANCELLED);
+      continue;
+    }
+    // The protocol is the same as when the message was held back: closing
+    // the socket completes all held back messages.
+    const auto msglen = envelope->message().size(proto_);
+    if (serializeMessage(std::move(envelope), msglen) != 0) {
+      ld_check(err == E::INTERNAL || err == E::PROTONOSUPPORT);
+      onSent(std::move(envelope), err);
+    }
+  }
+  if (!delayed_sends_.empty()) {
+    auto usec = std::max(
+        to_usec(delayed_sends_.front().first - now).count(), int64_t(0));
+    timeval tv{usec / 1000000, usec % 1000000};
+    deps_->evtimerAdd(&delayed_send_event_, &tv);
+  }
+}
+
 int Socket::preSendCheck(const Message& msg) {
   if (!bev_) {
     err = E::NOTCONN;
@@ -1542,6 +2133,10 @@ void Socket::send(std::unique_ptr<Envelope> envelope) {
       return;
     }
 
+    if (injectMessageLatency(envelope)) {
+      return;
+    }
+
     if (serializeMessage(std::move(envelope), msglen) != 0) {
       ld_check(err == E::INTERNAL || err == E::PROTONOSUPPORT);
       onSent(std::move(envelope), err);
@@ -1800,6 +2395,8 @@ void Socket::onBytesPassedToTCP(size_t nbytes) {
           conn_description_.c_str(),
           nbytes,
           deps_->getBytesPending());
+
+  maybeAdaptTcpSendBuf();
 }
 
 void Socket::deferredEventQueueEventCallback(void* instance, short) {
@@ -1975,7 +2572,9 @@ int Socket::receiveMessage() {
   } else {
     // Got message body.
     expectProtocolHeader();
-    int rv = onReceived(recv_message_ph_, inbuf);
+    int rv = recv_message_ph_.type == MessageType::COMPRESSED_FRAME
+        ? onCompressedFrameReceived(recv_message_ph_, inbuf)
+        : onReceived(recv_message_ph_, inbuf);
     if (rv != 0) {
       return rv;
     }
@@ -2319,6 +2918,68 @@ size_t Socket::getTcpSendBufSize() const {
   return tcp_sndbuf_cache_.size;
 }
 
+void Socket::maybeAdaptTcpSendBuf() {
+  if (!getSettings().tcp_sendbuf_adaptive || !bev_ || fd_ < 0 ||
+      peer_sockaddr_.isUnixAddress()) {
+    return;
+  }
+
+  const std::chrono::seconds ADAPT_INTERVAL(1);
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_sndbuf_adapt_time_ < ADAPT_INTERVAL) {
+    return;
+  }
+  last_sndbuf_adapt_time_ = now;
+
+  struct tcp_info info;
+  if (deps_->getTCPInfo(fd_, &info) != 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    2,
+                    "Failed to get TCP_INFO for socket %s: %s",
+                    conn_description_.c_str(),
+                    strerror(errno));
+    return;
+  }
+
+  // The congestion window is how much the kernel lets be in flight during a
+  // round trip, so cwnd * mss approximates bandwidth * RTT. Twice that lets
+  // the window grow without the buffer running dry.
+  const int MIN_SNDBUF = 64 * 1024;
+  const int MAX_SNDBUF = std::max(MIN_SNDBUF,
+                                  getSettings().tcp_sendbuf_kb > 0
+                                      ? getSettings().tcp_sendbuf_kb * 1024
+                                      : 4 * 1024 * 1024);
+  int64_t bdp = int64_t(info.tcpi_snd_cwnd) * info.tcpi_snd_mss;
+  int target = int(std::max<int64_t>(
+      MIN_SNDBUF, std::min<int64_t>(2 * bdp, MAX_SNDBUF)));
+
+  // Don't bother with small changes. The cached size is at most a second old.
+  int current = tcp_sndbuf_cache_.size;
+  if (target > current - current / 4 && target < current + current / 4) {
+    return;
+  }
+
+  if (deps_->setSendBufSize(fd_, target) != 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    2,
+                    "Failed to set sndbuf size for socket %s to %d: %s",
+                    conn_description_.c_str(),
+                    target,
+                    strerror(errno));
+    return;
+  }
+  deps_->buffereventSetMaxSingleWrite(bev_, target);
+  tcp_sndbuf_cache_.size = target;
+  tcp_sndbuf_cache_.update_time = now;
+  STAT_INCR(deps_->getStats(), sock_sndbuf_resized);
+  ld_spew("Resized sndbuf of socket %s to %d (cwnd %u, mss %u, rtt %uus)",
+          conn_description_.c_str(),
+          target,
+          info.tcpi_snd_cwnd,
+          info.tcpi_snd_mss,
+          info.tcpi_rtt);
+}
+
 void Socket::addHandshakeTimeoutEvent() {
   std::chrono::milliseconds timeout = getSettings().handshake_timeout;
   if (timeout.count() > 0) {
@@ -2344,7 +3005,8 @@ void Socket::addConnectAttemptTimeoutEvent() {
 }
 
 size_t Socket::getBytesPending() const {
-  size_t queued_bytes = pendingq_.cost() + serializeq_.cost() + sendq_.cost();
+  size_t queued_bytes = pendingq_.cost() + serializeq_.cost() + sendq_.cost() +
+      delayed_sends_cost_;
 
   size_t buffered_bytes = 0;
   if (bev_) {
@@ -2353,6 +3015,7 @@ size_t Socket::getBytesPending() const {
   if (buffered_output_) {
     buffered_bytes += LD_EV(evbuffer_get_length)(buffered_output_);
   }
+  buffered_bytes += coalesced_output_.size();
 
   return queued_bytes + buffered_bytes;
 }
@@ -2483,6 +3146,12 @@ SocketDependencies::SocketDependencies(Processor* processor,
     : processor_(processor), sender_(sender) {}
 
 const Settings& SocketDependencies::getSettings() const {
+  // Sockets read settings for every message they send or receive. On their
+  // Worker's thread, use the Worker's copy, which is a plain pointer read.
+  Worker* w = Worker::onThisThread(false);
+  if (w && w->processor_ == processor_) {
+    return *w->immutable_settings_;
+  }
   return *processor_->settings();
 }
 
@@ -2696,6 +3365,47 @@ void SocketDependencies::buffereventShutDownSSL(struct bufferevent* bev) {
   }
 }
 
+void SocketDependencies::buffereventResumeSSLSession(struct bufferevent* bev,
+                                                     const Sockaddr& peer) {
+  SSLFetcher& fetcher = Worker::onThisThread()->sslFetcher();
+  if (!fetcher.sessionResumptionEnabled()) {
+    return;
+  }
+  SSL_SESSION* session = fetcher.getSession(peer.toString());
+  if (session) {
+    SSL* ssl = bufferevent_openssl_get_ssl(bev);
+    ld_check(ssl);
+    // If the peer doesn't accept the session, a full handshake is done.
+    SSL_set_session(ssl, session);
+  }
+}
+
+void SocketDependencies::buffereventSaveSSLSession(struct bufferevent* bev,
+                                                   const Sockaddr& peer) {
+  SSLFetcher& fetcher = Worker::onThisThread()->sslFetcher();
+  if (!fetcher.sessionResumptionEnabled()) {
+    return;
+  }
+  SSL* ssl = bufferevent_openssl_get_ssl(bev);
+  ld_check(ssl);
+  fetcher.saveSession(peer.toString(), ssl);
+}
+
+bool SocketDependencies::buffereventSSLSessionReused(struct bufferevent* bev) {
+  SSL* ssl = bufferevent_openssl_get_ssl(bev);
+  return ssl != nullptr && SSL_session_reused(ssl);
+}
+
+bool SocketDependencies::buffereventKernelTLSEnabled(struct bufferevent* bev) {
+#ifdef SSL_OP_ENABLE_KTLS
+  SSL* ssl = bufferevent_openssl_get_ssl(bev);
+  return ssl != nullptr && BIO_get_ktls_send(SSL_get_wbio(ssl));
+#else
+  (void)bev;
+  return false;
+#endif
+}
+
 void SocketDependencies::buffereventFree(struct bufferevent* bev) {
   LD_EV(bufferevent_free)(bev);
 }
@@ -2958,6 +3668,22 @@ void SocketDependencies::configureSocket(bool is_tcp,
     }
   }
 
+#ifdef TCP_NOTSENT_LOWAT
+  if (is_tcp) {
+    int notsent_lowat = getSettings().tcp_notsent_lowat_kb * 1024;
+
+    if (notsent_lowat >= 0) {
+      rv = setsockopt(
+          fd, SOL_TCP, TCP_NOTSENT_LOWAT, &notsent_lowat, sizeof(int));
+      if (rv != 0) {
+        ld_error("Failed to set TCP_NOTSENT_LOWAT for TCP socket %d: %s",
+                 fd,
+                 strerror(errno));
+      }
+    }
+  }
+#endif
+
 #ifdef __linux__
   if (is_tcp) {
     int tcp_user_timeout = getSettings().tcp_user_timeout;
@@ -3002,6 +3728,15 @@ int SocketDependencies::setDSCP(int fd,
   return rv;
 }
 
+int SocketDependencies::getTCPInfo(int fd, struct tcp_info* info) {
+  socklen_t optlen = sizeof(*info);
+  return getsockopt(fd, SOL_TCP, TCP_INFO, info, &optlen);
+}
+
+int SocketDependencies::setSendBufSize(int fd, int size) {
+  return setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+}
+
 ResourceBudget& SocketDependencies::getConnBudgetExternal() {
   return processor_->conn_budget_external_;
 }
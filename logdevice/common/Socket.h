@@ -36,6 +36,10 @@
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/settings/Settings.h"
 
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+struct tcp_info;
+
 namespace facebook { namespace logdevice {
 
 class BWAvailableCallback;
@@ -235,6 +239,11 @@ class Socket : public TrafficShappingSocket {
   // node from the cluster on the other end.
   NodeID peer_node_id_;
 
+  // Smallest location scope shared with the peer. Starts as the scope of
+  // flow_group_ and is refined by Sender once the peer's location is known.
+  // Compared with --socket-compression-boundary.
+  NodeLocationScope peer_scope_;
+
   // Traffic shaping state shared between Sockets with the same bandwidth
   // constraints.
   FlowGroup& flow_group_;
@@ -643,6 +652,60 @@ class Socket : public TrafficShappingSocket {
                                    size_t msglen,
                                    struct evbuffer* outbuf);
 
+  /**
+   * Serializes a small message, with its ProtocolHeader, at the end of
+   * coalesced_output_ and schedules a flush at the end of this event loop
+   * iteration. The checksum, if any, is computed on the contiguous copy.
+   * Used when --socket-coalesce-max-message-size is positive, and for all
+   * but the largest messages if compress is true (see shouldCompress()).
+   *
+   * @return 0 for success, -1 for failure
+   */
+  int serializeMessageCoalesced(const Message& msg,
+                                size_t msglen,
+                                bool compute_checksum,
+                                bool compress);
+
+  /**
+   * Moves coalesced_output_ into the output buffer with a single copy, or
+   * as a COMPRESSED_FRAME if coalesced_output_compressed_ is set.
+   * Must be called before anything else is written to the output buffer so
+   * that messages stay in order.
+   *
+   * @return 0 for success, -1 if the socket got closed
+   */
+  int flushCoalescedOutput();
+
+  /**
+   * @return true if messages of this type should be sent in compressed
+   *         frames: this is a handshaken data connection that negotiated
+   *         COMPRESSED_FRAME_SUPPORT, with a peer that does not share
+   *         --socket-compression-boundary with us.
+   */
+  bool shouldCompress(MessageType type);
+
+  /**
+   * Compresses coalesced_output_ with zstd_cctx_ and writes it to outbuf as a
+   * COMPRESSED_FRAME.
+   *
+   * @return 0 for success, -1 on failure with err set
+   */
+  int writeCompressedFrame(struct evbuffer* outbuf);
+
+  /**
+   * Called by receiveMessage() instead of onReceived() for COMPRESSED_FRAME
+   * messages. Decompresses the frame with zstd_dctx_ and calls onReceived()
+   * for each message in it.
+   *
+   * @return 0 for success, -1 if the socket must be closed with err
+   */
+  int onCompressedFrameReceived(ProtocolHeader ph, struct evbuffer* inbuf);
+
+  /**
+   * A callback for coalesced_output_flush_event_
+   */
+  static void onCoalescedOutputTimerEvent(void* instance, short);
+
   /**
    * Allow the async message error simulator to optionally take ownership of
    * this message just before it is sent.
@@ -652,6 +715,26 @@ class Socket : public TrafficShappingSocket {
    */
   bool injectAsyncMessageError(std::unique_ptr<Envelope>&& msg);
 
+  /**
+   * Holds the message back in delayed_sends_ if MessageLatencyInjection asks
+   * for latency, or if earlier messages are still held back.
+   *
+   * @return  True if the message was taken; flushDelayedSends() will
+   *          serialize it later.
+   */
+  bool injectMessageLatency(std::unique_ptr<Envelope>& envelope);
+
+  /**
+   * Serializes the messages in delayed_sends_ whose time has come, and
+   * schedules delayed_send_event_ for the next one.
+   */
+  void flushDelayedSends();
+
+  /**
+   * A callback for delayed_send_event_
+   */
+  static void onDelayedSendTimerEvent(void* instance, short);
+
   /**
    * Called by connect() and by onConnectAttemptTimeout().
    *
@@ -936,6 +1019,9 @@ class Socket : public TrafficShappingSocket {
     std::chrono::steady_clock::time_point update_time;
   } tcp_sndbuf_cache_;
 
+  // When maybeAdaptTcpSendBuf() last looked at the connection.
+  std::chrono::steady_clock::time_point last_sndbuf_adapt_time_;
+
   // Size of the receive buffer of the underlying TCP socket as reported by
   // getsockopt(SO_RCVBUF). If getsockopt() fails, a default value set in the
   // constructor is used.
@@ -971,6 +1057,10 @@ class Socket : public TrafficShappingSocket {
   // complete yet
   bool expecting_ssl_handshake_ = false;
 
+  // true if the SSL handshake completed and OpenSSL enabled kernel TLS (see
+  // ssl-kernel-tls setting). Only used for the num_ktls_connections stat.
+  bool kernel_tls_ = false;
+
   // true if the message error injection code has decided to rewind
   // a message stream. All traffic for this socket will be diverted until
   // the end of the event loop, at which time the messages will be delivered
@@ -1014,6 +1104,42 @@ class Socket : public TrafficShappingSocket {
   // The zero-timeout timer used to flush the output buffer
   struct event buffered_output_flush_event_;
 
+  // Small messages serialized back-to-back since the last flush, waiting to be
+  // copied into the output buffer together. See serializeMessageCoalesced().
+  // The capacity is kept between flushes.
+  std::string coalesced_output_;
+
+  // The zero-timeout timer used to flush coalesced_output_
+  struct event coalesced_output_flush_event_;
+
+  // Messages held back by MessageLatencyInjection with the time they may be
+  // serialized at, in send() order. While this is not empty all messages go
+  // through it, so injected latency never reorders messages.
+  std::deque<std::pair<std::chrono::steady_clock::time_point,
+                       std::unique_ptr<Envelope>>>
+      delayed_sends_;
+
+  // Sum of Envelope::cost() of delayed_sends_, for getBytesPending().
+  size_t delayed_sends_cost_ = 0;
+
+  // Timer for the front of delayed_sends_
+  struct event delayed_send_event_;
+
+  // True if the messages in coalesced_output_ are to be sent as a
+  // COMPRESSED_FRAME. Compressed and uncompressed messages are never
+  // coalesced together.
+  bool coalesced_output_compressed_{false};
+
+  // Streaming zstd contexts for COMPRESSED_FRAMEs sent and received on this
+  // connection. Created on first use and reset when the socket is closed,
+  // since each frame may refer to the data of earlier ones.
+  std::unique_ptr<ZSTD_CCtx_s, size_t (*)(ZSTD_CCtx_s*)> zstd_cctx_;
+  std::unique_ptr<ZSTD_DCtx_s, size_t (*)(ZSTD_DCtx_s*)> zstd_dctx_;
+
+  // Compressed bytes of the frame being written. The capacity is kept
+  // between frames.
+  std::string compressed_output_;
+
   // called by bev_ when all bytes we have been waiting for arrive
   static void dataReadCallback(struct bufferevent*, void*, short);
 
@@ -1080,6 +1206,13 @@ class Socket : public TrafficShappingSocket {
    */
   void flushBufferedOutput();
 
+  /**
+   * If --sendbuf-adaptive is set and the send buffer wasn't resized in the
+   * last second, resizes it to twice the bandwidth-delay product of the
+   * connection, estimated by the kernel's congestion window times the MSS.
+   */
+  void maybeAdaptTcpSendBuf();
+
   /**
    * A callback for buffered_output_flush_event_
    */
@@ -1175,6 +1308,16 @@ class SocketDependencies {
                                 bufferevent_event_cb eventcb,
                                 void* cbarg);
   virtual void buffereventShutDownSSL(struct bufferevent* bev);
+  // Whether OpenSSL handed sending on this SSL bufferevent to kernel TLS.
+  virtual bool buffereventKernelTLSEnabled(struct bufferevent* bev);
+  // TLS session resumption for connections this side initiates, see
+  // SSLFetcher::getSession(). No-ops without --ssl-session-resumption.
+  virtual void buffereventResumeSSLSession(struct bufferevent* bev,
+                                           const Sockaddr& peer);
+  virtual void buffereventSaveSSLSession(struct bufferevent* bev,
+                                         const Sockaddr& peer);
+  // Whether the handshake of this SSL bufferevent resumed a session.
+  virtual bool buffereventSSLSessionReused(struct bufferevent* bev);
   virtual void buffereventFree(struct bufferevent* bev);
   virtual int evUtilMakeSocketNonBlocking(int sfd);
   virtual int buffereventSetMaxSingleWrite(struct bufferevent* bev,
@@ -1201,6 +1344,8 @@ class SocketDependencies {
   virtual int setDSCP(int fd,
                       sa_family_t sa_family,
                       const uint8_t default_dscp);
+  virtual int getTCPInfo(int fd, struct tcp_info* info);
+  virtual int setSendBufSize(int fd, int size);
   virtual ResourceBudget& getConnBudgetExternal();
   virtual std::string getClusterName();
   virtual ServerInstanceId getServerInstanceId();
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/StoreBatcher.h"
+
+#include <algorithm>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+StoreBatcher::StoreBatcher() = default;
+
+StoreBatcher::~StoreBatcher() = default;
+
+bool StoreBatcher::add(std::unique_ptr<STORE_Message>& msg, NodeID to) {
+  ld_check(msg);
+  const Settings& settings = Worker::settings();
+  if (settings.store_batching_window.count() <= 0) {
+    return false;
+  }
+
+  const PayloadHolder* payload = msg->getPayloadHolder();
+  const size_t bytes = sizeof(STORE_Header) +
+      msg->getCopyset().size() * sizeof(StoreChainLink) +
+      (payload ? payload->size() : 0);
+  if (bytes >= settings.store_batching_max_bytes) {
+    return false;
+  }
+
+  folly::Optional<uint16_t> proto =
+      Worker::onThisThread()->sender().getSocketProtocolVersion(to.index());
+  if (!proto.hasValue() ||
+      proto.value() < Compatibility::MULTI_STORE_SUPPORT) {
+    return false;
+  }
+
+  Batch& batch = batches_[to.index()];
+  batch.to = to;
+  batch.stores.push_back(std::move(msg));
+  batch.bytes += bytes;
+  ++num_pending_;
+
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (batch.bytes >= settings.store_batching_max_bytes) {
+    // Send on the next event loop iteration.
+    timer_.activate(std::chrono::microseconds::zero());
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.store_batching_window);
+  }
+  return true;
+}
+
+void StoreBatcher::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  num_pending_ = 0;
+  for (auto& kv : batches) {
+    send(std::move(kv.second));
+  }
+}
+
+void StoreBatcher::send(Batch batch) {
+  auto& stores = batch.stores;
+  // Appenders may have retired while their STOREs were waiting.
+  stores.erase(std::remove_if(stores.begin(),
+                              stores.end(),
+                              [](const std::unique_ptr<STORE_Message>& store) {
+                                return store->cancelled();
+                              }),
+               stores.end());
+  if (stores.empty()) {
+    return;
+  }
+
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+
+  if (stores.size() == 1) {
+    std::unique_ptr<STORE_Message> msg = std::move(stores.front());
+    if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+      msg->onSentCommon(err, to);
+    }
+    return;
+  }
+
+  const size_t num_records = stores.size();
+  auto msg = std::make_unique<MULTI_STORE_Message>(std::move(stores));
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_STORE with %zu records to %s: %s",
+                   num_records,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    for (const auto& store : msg->getStores()) {
+      store->onSentCommon(st, to);
+    }
+    return;
+  }
+
+  STAT_INCR(Worker::stats(), store_batches_sent);
+  STAT_ADD(Worker::stats(), store_batched_records_sent, num_records);
+}
+
+}} // namespace facebook::logdevice
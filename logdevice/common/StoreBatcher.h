@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+
+namespace facebook { namespace logdevice {
+
+class STORE_Message;
+
+/**
+ * @file Per-Worker coalescing of STORE messages that Appenders send to the
+ *       same storage node. When --store-batching-window is nonzero, STOREs
+ *       sent within the window to a node whose connection supports
+ *       MULTI_STORE are held back and then sent together in one
+ *       MULTI_STORE_Message (or as a plain STORE if there's only one).
+ *
+ *       Batches are only ever sent from the timer callback, never from
+ *       add(), so that send failures reported to Appenders don't reenter an
+ *       Appender in the middle of sending a wave.
+ */
+
+class StoreBatcher {
+ public:
+  StoreBatcher();
+  ~StoreBatcher();
+
+  StoreBatcher(const StoreBatcher&) = delete;
+  StoreBatcher& operator=(const StoreBatcher&) = delete;
+
+  /**
+   * Takes a STORE that an Appender wants to send to `to`, if it can be
+   * batched.
+   *
+   * The outcome of sending the message, including errors returned by
+   * Sender::sendMessage() when the batch is sent, is reported through
+   * STORE_Message::onSentCommon(), same as for STOREs that were passed to
+   * TCP and failed later.
+   *
+   * @return  true if `msg` was taken (it's reset to nullptr). false if
+   *          batching is disabled, `to` hasn't negotiated a protocol with
+   *          MULTI_STORE support yet, or the record is too big to be batched;
+   *          the caller should send `msg` directly.
+   */
+  bool add(std::unique_ptr<STORE_Message>& msg, NodeID to);
+
+  // Number of STOREs waiting to be sent.
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  struct Batch {
+    NodeID to;
+    std::vector<std::unique_ptr<STORE_Message>> stores;
+    // Approximate size of the records in the batch.
+    size_t bytes = 0;
+  };
+
+  // Sends all pending batches.
+  void flush();
+
+  void send(Batch batch);
+
+  std::unordered_map<node_index_t, Batch> batches_;
+  size_t num_pending_ = 0;
+
+  // Fires when the oldest pending STORE has waited for
+  // --store-batching-window, or right away if a batch grew too big.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -44,13 +44,9 @@ Request::Execution SyncSequencerRequest::execute() {
   Worker::onThisThread()->runningSyncSequencerRequests().getList().push_back(
       *this);
 
-  retry_timer_ = std::make_unique<ExponentialBackoffTimer>(
-
-      [this]() { tryAgain(); }, Worker::settings().seq_state_backoff_time);
-
   if (timeout_.count() > 0) {
-    timeout_timer_ = std::make_unique<Timer>([this] { this->onTimeout(); });
-    timeout_timer_->activate(timeout_);
+    timeout_timer_.assign([this] { this->onTimeout(); });
+    timeout_timer_.activate(timeout_);
   }
 
   tryAgain();
@@ -58,6 +54,14 @@ Request::Execution SyncSequencerRequest::execute() {
   return Execution::CONTINUE;
 }
 
+void SyncSequencerRequest::retryLater() {
+  if (!retry_timer_) {
+    retry_timer_ = std::make_unique<ExponentialBackoffTimer>(
+        [this]() { tryAgain(); }, Worker::settings().seq_state_backoff_time);
+  }
+  retry_timer_->activate();
+}
+
 void SyncSequencerRequest::tryAgain() {
   if (isCanceled()) {
     complete(E::CANCELLED);
@@ -120,7 +124,7 @@ void SyncSequencerRequest::tryAgain() {
         logid_.val_,
         error_description(err));
     if (err != E::SHUTDOWN) {
-      retry_timer_->activate();
+      retryLater();
     }
   }
 }
@@ -163,7 +167,7 @@ void SyncSequencerRequest::onGotSeqState(GetSeqStateRequest::Result res) {
     if (complete_if_access_denied_) {
       complete(E::ACCESS);
     } else {
-      retry_timer_->activate();
+      retryLater();
     }
     return;
   }
@@ -208,7 +212,7 @@ void SyncSequencerRequest::onGotSeqState(GetSeqStateRequest::Result res) {
     complete(E::OK);
   } else {
     // When the timer triggers we will retry GetSeqStateRequest.
-    retry_timer_->activate();
+    retryLater();
   }
 }
 
@@ -224,11 +224,12 @@ class SyncSequencerRequest : public Request {
   folly::Optional<epoch_t> min_epoch_;
   folly::Optional<int> override_thread_idx_;
 
-  // Timer for retrying GetSeqStateRequests.
+  // Timer for retrying GetSeqStateRequests. Created on the first retry, as
+  // most requests complete with the first GetSeqStateRequest.
   std::unique_ptr<ExponentialBackoffTimer> retry_timer_;
 
   // Timer for giving up after the user provided timeout.
-  std::unique_ptr<Timer> timeout_timer_;
+  Timer timeout_timer_;
 
   // Updated the first time we successfully complete a GetSeqStateRequest.
   folly::Optional<lsn_t> nextLsn_;
@@ -251,6 +252,9 @@ class SyncSequencerRequest : public Request {
   void complete(Status status);
 
   void tryAgain();
+
+  // Schedules tryAgain() with exponential backoff.
+  void retryLater();
   void onGotSeqState(GetSeqStateRequest::Result res);
 };
 
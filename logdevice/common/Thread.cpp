@@ -8,6 +8,7 @@
 #include "logdevice/common/Thread.h"
 
 #include <errno.h>
+#include <sched.h>
 
 #include "logdevice/common/ThreadID.h"
 #include "logdevice/common/debug.h"
@@ -37,6 +38,23 @@ int Thread::start() {
     return -1;
   }
 
+  if (!cpu_affinity_.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : cpu_affinity_) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpus);
+      }
+    }
+    rv = pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    if (rv != 0) {
+      // Not fatal, the thread will just run anywhere.
+      ld_error("Failed to set CPU affinity for a Thread thread, errno=%d (%s)",
+               rv,
+               strerror(rv));
+    }
+  }
+
   rv = pthread_create(&thread_, &attr, Thread::enter, this);
   if (rv != 0) {
     ld_error(
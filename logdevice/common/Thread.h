@@ -13,6 +13,7 @@
 #include <atomic>
 #include <pthread.h>
 #include <string>
+#include <vector>
 
 #include <folly/CppAttributes.h>
 
@@ -44,6 +45,15 @@ class Thread {
    */
   int start();
 
+  /**
+   * Restricts the thread to the given CPUs from the moment it's created, so
+   * that everything it allocates is first touched on their NUMA node. Must be
+   * called before start(). Empty (the default) means no restriction.
+   */
+  void setCPUAffinity(std::vector<int> cpus) {
+    cpu_affinity_ = std::move(cpus);
+  }
+
   /**
    * Gets the pthread handle of the thread this instance is running on.
    */
@@ -69,6 +79,9 @@ class Thread {
   // pthread handle
   pthread_t thread_;
 
+  // see setCPUAffinity()
+  std::vector<int> cpu_affinity_;
+
   // Static wrapper of run(), passed to pthread_create()
   static void* FOLLY_NULLABLE enter(void* self);
 
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ThreadCachedAllocation.h"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace facebook { namespace logdevice {
+
+namespace {
+struct Registry {
+  std::mutex mutex;
+  std::vector<
+      std::pair<std::string, std::function<ThreadCachedAllocationStats()>>>
+      entries;
+};
+
+Registry& registry() {
+  static Registry* r = new Registry();
+  return *r;
+}
+} // namespace
+
+namespace detail {
+void registerThreadCachedAllocation(
+    std::string name,
+    std::function<ThreadCachedAllocationStats()> get_stats) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.entries.emplace_back(std::move(name), std::move(get_stats));
+}
+} // namespace detail
+
+void forEachThreadCachedAllocation(
+    folly::FunctionRef<void(const std::string& name,
+                            const ThreadCachedAllocationStats& stats)> cb) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (const auto& entry : r.entries) {
+    cb(entry.first, entry.second());
+  }
+}
+
+}} // namespace facebook::logdevice
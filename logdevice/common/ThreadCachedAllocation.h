@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <string>
+#include <typeinfo>
+
+#include <folly/Demangle.h>
+#include <folly/Function.h>
+#include <folly/ThreadLocal.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Mixin that gives a class a per-thread free list of fixed-size blocks.
+ *
+ * Some objects (RECORD_Message, STORE_Message, Envelope) are allocated and
+ * freed on the same Worker at a very high rate, once per record.  Deriving
+ * from ThreadCachedAllocation<T> replaces T's operator new/delete with one
+ * that keeps up to kMaxCachedPerThread freed blocks of sizeof(T) bytes in a
+ * thread-local singly linked list and hands them out again before falling
+ * back to the global allocator.  Allocations of subclasses of T (which have a
+ * different size) go straight to the global allocator.
+ *
+ * Objects may be freed on a different thread than they were allocated on;
+ * the block then simply joins the free list of the freeing thread.  Free
+ * lists are bounded, so this cannot grow memory usage without bound.
+ *
+ * Usage: class Foo : public Base, public ThreadCachedAllocation<Foo> { ... };
+ */
+
+struct ThreadCachedAllocationStats {
+  // Allocations served from a thread's free list, bypassing malloc.
+  uint64_t cache_hits{0};
+  // Allocations that had to go to malloc.
+  uint64_t cache_misses{0};
+  // Deallocations that went back to malloc because the free list was full.
+  uint64_t cache_overflows{0};
+  // Blocks currently sitting in free lists.
+  uint64_t cached{0};
+};
+
+/**
+ * Calls `cb' for every class using ThreadCachedAllocation that has done at
+ * least one allocation so far.  Used by the `stats jemalloc` admin command.
+ */
+void forEachThreadCachedAllocation(
+    folly::FunctionRef<void(const std::string& name,
+                            const ThreadCachedAllocationStats& stats)> cb);
+
+namespace detail {
+void registerThreadCachedAllocation(
+    std::string name,
+    std::function<ThreadCachedAllocationStats()> get_stats);
+} // namespace detail
+
+template <typename T, size_t kMaxCachedPerThread = 256>
+class ThreadCachedAllocation {
+ public:
+  static void* operator new(size_t size) {
+    if (size != sizeof(T)) {
+      return ::operator new(size);
+    }
+    return local().allocate();
+  }
+
+  static void operator delete(void* p, size_t size) {
+    if (size != sizeof(T)) {
+      ::operator delete(p);
+      return;
+    }
+    local().deallocate(p);
+  }
+
+  static ThreadCachedAllocationStats getStats() {
+    ThreadCachedAllocationStats res;
+    res.cache_hits = exited().cache_hits.load(std::memory_order_relaxed);
+    res.cache_misses = exited().cache_misses.load(std::memory_order_relaxed);
+    res.cache_overflows =
+        exited().cache_overflows.load(std::memory_order_relaxed);
+    for (const Cache& c : caches().accessAllThreads()) {
+      res.cache_hits += c.cache_hits.load(std::memory_order_relaxed);
+      res.cache_misses += c.cache_misses.load(std::memory_order_relaxed);
+      res.cache_overflows += c.cache_overflows.load(std::memory_order_relaxed);
+      res.cached += c.size.load(std::memory_order_relaxed);
+    }
+    return res;
+  }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct Counters {
+    std::atomic<uint64_t> cache_hits{0};
+    std::atomic<uint64_t> cache_misses{0};
+    std::atomic<uint64_t> cache_overflows{0};
+  };
+
+  // Only the owning thread modifies a Cache; the atomics are there so that
+  // getStats() can read the counters from another thread.
+  struct Cache : Counters {
+    FreeBlock* head{nullptr};
+    std::atomic<size_t> size{0};
+
+    static void bump(std::atomic<uint64_t>& c) {
+      c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void* allocate() {
+      if (head) {
+        FreeBlock* b = head;
+        head = b->next;
+        size.store(size.load(std::memory_order_relaxed) - 1,
+                   std::memory_order_relaxed);
+        bump(this->cache_hits);
+        return b;
+      }
+      bump(this->cache_misses);
+      return ::operator new(sizeof(T));
+    }
+
+    void deallocate(void* p) {
+      if (size.load(std::memory_order_relaxed) >= kMaxCachedPerThread) {
+        bump(this->cache_overflows);
+        ::operator delete(p);
+        return;
+      }
+      FreeBlock* b = static_cast<FreeBlock*>(p);
+      b->next = head;
+      head = b;
+      size.store(size.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    }
+
+    ~Cache() {
+      while (head) {
+        FreeBlock* b = head;
+        head = b->next;
+        ::operator delete(b);
+      }
+      Counters& e = exited();
+      e.cache_hits += this->cache_hits.load(std::memory_order_relaxed);
+      e.cache_misses += this->cache_misses.load(std::memory_order_relaxed);
+      e.cache_overflows +=
+          this->cache_overflows.load(std::memory_order_relaxed);
+    }
+  };
+
+  struct Tag {};
+  using Caches = folly::ThreadLocal<Cache, Tag, folly::AccessModeStrict>;
+
+  static Cache& local() {
+    static_assert(sizeof(T) >= sizeof(FreeBlock), "T is too small");
+    return *caches();
+  }
+
+  // Leaked on purpose so that blocks freed during static destruction still
+  // have somewhere to go.
+  static Caches& caches() {
+    static Caches* c = [] {
+      detail::registerThreadCachedAllocation(
+          folly::demangle(typeid(T)).toStdString(), &getStats);
+      return new Caches();
+    }();
+    return *c;
+  }
+
+  // Counters of threads that have exited.
+  static Counters& exited() {
+    static Counters* c = new Counters();
+    return *c;
+  }
+};
+
+}} // namespace facebook::logdevice
@@ -11,6 +11,7 @@
 #include "logdevice/common/LibeventTimer.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/RunContext.h"
+#include "logdevice/common/TimerWheel.h"
 #include "logdevice/common/WheelTimer.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/stats/Stats.h"
@@ -98,6 +99,56 @@ class WheelTimerDispatchImpl : public TimerInterface {
   bool is_activated_{false};
 };
 
+// Timer on the timing wheel of the Worker it was created on.  Runs on the
+// Worker's thread like LibEventTimerImpl, but arming and cancelling are O(1)
+// and timers expiring in the same tick share one libevent wakeup.  The
+// TimeoutMap passed to activate() is not needed and ignored.
+class TimerWheelImpl : public TimerInterface, public TimerWheel::Callback {
+ public:
+  TimerWheelImpl() : worker_(Worker::onThisThread()) {}
+
+  void activate(std::chrono::microseconds delay,
+                TimeoutMap* /* timeout_map */ = nullptr) override {
+    ld_check(callback_);
+    ld_check(Worker::onThisThread(false) == worker_);
+    workerRunContext_ = worker_->currentlyRunning_;
+    worker_->timerWheel().schedule(this, delay);
+  }
+
+  void cancel() override {
+    TimerWheel::Callback::cancel();
+  }
+
+  bool isActive() const override {
+    return isScheduled();
+  }
+
+  void setCallback(std::function<void()> callback) override {
+    callback_ = std::move(callback);
+  }
+
+  void assign(std::function<void()> callback) override {
+    setCallback(std::move(callback));
+  }
+
+  bool isAssigned() const override {
+    return !!callback_;
+  }
+
+  void timeoutExpired() override {
+    RunContext run_context = workerRunContext_;
+    Worker::onStartedRunning(run_context);
+    callback_();
+    // `this` might have been destroyed.
+    Worker::onStoppedRunning(run_context);
+  }
+
+ private:
+  Worker* const worker_;
+  std::function<void()> callback_;
+  RunContext workerRunContext_;
+};
+
 decltype(auto)
 WheelTimerDispatchImpl::makeWheelTimerInternalExecutor(Worker* worker) {
   return [timer = this, canceled = is_canceled_, worker]() mutable {
@@ -194,7 +245,10 @@ TimerInterface& Timer::getTimerImpl() const {
     // This is called from tests and ldbench workers. Caller cannot assume
     // Worker interface to be available in those cases.
     auto worker = Worker::onThisThread(false /* enforce_worker */);
-    if (worker && worker->updateable_settings_->enable_hh_wheel_backed_timers) {
+    if (worker && worker->immutable_settings_->enable_worker_timer_wheel) {
+      impl_ = std::make_unique<TimerWheelImpl>();
+    } else if (worker &&
+               worker->immutable_settings_->enable_hh_wheel_backed_timers) {
       impl_ = std::make_unique<WheelTimerDispatchImpl>();
     } else {
       impl_ = std::make_unique<LibEventTimerImpl>();
@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TimerWheel.h"
+
+#include <algorithm>
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+constexpr uint64_t kSlotMask = TimerWheel::kSlots - 1;
+// Deadlines further than this are kept in the last slot of the top level and
+// re-inserted each time that slot is cascaded.
+constexpr uint64_t kMaxDelta =
+    (uint64_t(1) << (TimerWheel::kSlotBits * TimerWheel::kLevels)) - 1;
+} // namespace
+
+void TimerWheel::Callback::cancel() {
+  if (hook_.is_linked()) {
+    ld_check(wheel_);
+    hook_.unlink();
+    --wheel_->size_;
+    --wheel_->level_size_[level_];
+  }
+}
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick,
+                       std::function<void(Clock::time_point)> wakeup,
+                       Clock::time_point now)
+    : tick_(tick), start_(now), wakeup_(std::move(wakeup)) {
+  ld_check(tick_.count() > 0);
+}
+
+TimerWheel::~TimerWheel() {
+  for (auto& level : slots_) {
+    for (auto& slot : level) {
+      slot.clear();
+    }
+  }
+}
+
+uint64_t TimerWheel::toTick(Clock::time_point t, bool round_up) const {
+  if (t <= start_) {
+    return 0;
+  }
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(t - start_);
+  return (us.count() + (round_up ? tick_.count() - 1 : 0)) / tick_.count();
+}
+
+TimerWheel::Clock::time_point TimerWheel::toTime(uint64_t tick) const {
+  return start_ + tick_ * tick;
+}
+
+void TimerWheel::schedule(Callback* cb,
+                          std::chrono::microseconds delay,
+                          Clock::time_point now) {
+  ld_check(cb);
+  cb->cancel();
+  cb->wheel_ = this;
+  ++size_;
+  if (delay < tick_) {
+    immediate_.push_back(*cb);
+    cb->level_ = kLevels;
+    ++level_size_[kLevels];
+    if (!advancing_ && wakeup_tick_ != 0) {
+      reportWakeup(0);
+    }
+    return;
+  }
+
+  if (size_ == 1 && !advancing_) {
+    // Nothing to process in between; skip straight to `now` so that the
+    // next advance() doesn't walk through idle ticks.
+    current_tick_ = std::max(current_tick_, toTick(now, false));
+  }
+  // Round up so that timers never fire early.
+  cb->expiry_tick_ =
+      std::max(toTick(now + delay, /* round_up */ true), current_tick_);
+  insert(cb);
+
+  if (!advancing_ && cb->expiry_tick_ < wakeup_tick_) {
+    // No need to wake up for intermediate cascades: advance() processes
+    // every tick up to the one it is called for.
+    reportWakeup(cb->expiry_tick_);
+  }
+}
+
+void TimerWheel::insert(Callback* cb) {
+  ld_check(cb->expiry_tick_ >= current_tick_);
+  uint64_t delta = cb->expiry_tick_ - current_tick_;
+  uint64_t position = cb->expiry_tick_;
+  if (delta > kMaxDelta) {
+    delta = kMaxDelta;
+    position = current_tick_ + kMaxDelta;
+  }
+  size_t level = 0;
+  while (level + 1 < kLevels &&
+         delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+  size_t slot = (position >> (kSlotBits * level)) & kSlotMask;
+  slots_[level][slot].push_back(*cb);
+  cb->level_ = level;
+  ++level_size_[level];
+  if (level == 0) {
+    level0_bitmap_[slot / 64] |= uint64_t(1) << (slot % 64);
+  }
+}
+
+void TimerWheel::cascade() {
+  for (size_t level = 1; level < kLevels; ++level) {
+    size_t slot = (current_tick_ >> (kSlotBits * level)) & kSlotMask;
+    List list;
+    list.swap(slots_[level][slot]);
+    while (!list.empty()) {
+      Callback& cb = list.front();
+      list.pop_front();
+      --level_size_[level];
+      insert(&cb);
+    }
+    if (slot != 0) {
+      break;
+    }
+  }
+}
+
+uint64_t TimerWheel::nextEventTick() const {
+  if (size_ == 0) {
+    return UINT64_MAX;
+  }
+  if (level_size_[kLevels] > 0) {
+    return 0;
+  }
+  const size_t idx = current_tick_ & kSlotMask;
+  if (idx == 0 && size_ > level_size_[0]) {
+    // current_tick_ hasn't been processed yet and starts with a cascade.
+    return current_tick_;
+  }
+  for (size_t word = idx / 64; word < level0_bitmap_.size(); ++word) {
+    uint64_t bits = level0_bitmap_[word];
+    if (word == idx / 64) {
+      bits &= ~uint64_t(0) << (idx % 64);
+    }
+    if (bits != 0) {
+      size_t slot = word * 64 + __builtin_ctzll(bits);
+      return current_tick_ - idx + slot;
+    }
+  }
+  // Nothing left in this turn of level 0.  The next turn starts with a
+  // cascade; if the lower levels are empty, skip ahead to the first turn
+  // that cascades a non-empty one.
+  uint64_t next = (current_tick_ | kSlotMask) + 1;
+  for (size_t level = 1; level < kLevels && level_size_[level - 1] == 0 &&
+       level_size_[level] == 0;
+       ++level) {
+    const uint64_t span = uint64_t(1) << (kSlotBits * (level + 1));
+    next = (current_tick_ | (span - 1)) + 1;
+  }
+  return next;
+}
+
+void TimerWheel::advance(Clock::time_point now) {
+  const uint64_t target = toTick(now, false);
+  advancing_ = true;
+  // Timers that immediate ones schedule in turn wait for the next advance()
+  // so that this loop terminates.
+  List immediate;
+  immediate.swap(immediate_);
+  while (!immediate.empty()) {
+    Callback& cb = immediate.front();
+    immediate.pop_front();
+    --size_;
+    --level_size_[kLevels];
+    cb.timeoutExpired();
+  }
+  while (current_tick_ <= target) {
+    const size_t idx = current_tick_ & kSlotMask;
+    if (idx == 0) {
+      cascade();
+    }
+    List expired;
+    expired.swap(slots_[0][idx]);
+    level0_bitmap_[idx / 64] &= ~(uint64_t(1) << (idx % 64));
+    // Move on before running callbacks so that timers they schedule for
+    // "now" go to the next tick rather than a full turn of the wheel later.
+    ++current_tick_;
+    while (!expired.empty()) {
+      Callback& cb = expired.front();
+      expired.pop_front();
+      --size_;
+      --level_size_[0];
+      cb.timeoutExpired();
+      // `cb` may have been destroyed.
+    }
+    if (current_tick_ <= target) {
+      // Skip empty ticks.
+      current_tick_ = std::min(nextEventTick(), target + 1);
+    }
+  }
+  advancing_ = false;
+
+  wakeup_tick_ = UINT64_MAX;
+  uint64_t next = nextEventTick();
+  if (next != UINT64_MAX) {
+    reportWakeup(next);
+  }
+}
+
+folly::Optional<TimerWheel::Clock::time_point> TimerWheel::nextWakeup() const {
+  uint64_t next = nextEventTick();
+  if (next == UINT64_MAX) {
+    return folly::none;
+  }
+  return toTime(next);
+}
+
+void TimerWheel::reportWakeup(uint64_t tick) {
+  wakeup_tick_ = tick;
+  if (wakeup_) {
+    wakeup_(toTime(tick));
+  }
+}
+
+}} // namespace facebook::logdevice
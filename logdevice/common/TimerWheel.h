@@ -0,0 +1,162 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include <folly/IntrusiveList.h>
+#include <folly/Optional.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Hierarchical timing wheel for the timers of one thread.
+ *
+ * Timers are intrusive Callback objects linked into one of kLevels wheels of
+ * kSlots slots each.  Level 0 has one slot per tick, level i has one slot per
+ * kSlots^i ticks; a timer lives on the lowest level that covers its
+ * deadline and is moved down a level ("cascaded") when the lower wheel wraps
+ * around.  Scheduling and cancelling are O(1) list operations, unlike the
+ * O(log n) min-heap that libevent keeps for its timers.
+ *
+ * The wheel doesn't own a thread or an event.  The owner calls advance()
+ * when the wakeup reported through the `wakeup` callback is due; all timers
+ * that expire in the same tick are handled by a single wakeup.
+ *
+ * Not thread-safe.  All methods, including destruction of scheduled
+ * Callbacks, must be called on the thread that owns the wheel.
+ */
+
+class TimerWheel {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  class Callback {
+   public:
+    Callback() = default;
+    Callback(const Callback&) = delete;
+    Callback& operator=(const Callback&) = delete;
+
+    virtual ~Callback() {
+      cancel();
+    }
+
+    // Called by advance() once the timer expires.  The callback is no longer
+    // scheduled at that point and may reschedule or destroy itself.
+    virtual void timeoutExpired() = 0;
+
+    bool isScheduled() const {
+      return hook_.is_linked();
+    }
+
+    // Unschedules the timer if it is scheduled.
+    void cancel();
+
+   private:
+    friend class TimerWheel;
+
+    folly::IntrusiveListHook hook_;
+    TimerWheel* wheel_ = nullptr;
+    uint64_t expiry_tick_ = 0;
+    uint8_t level_ = 0;
+  };
+
+  /**
+   * @param tick    granularity of the wheel; timers fire at most one tick
+   *                late
+   * @param wakeup  called with the time advance() should be called next,
+   *                whenever that time moves earlier.  May be empty in tests
+   *                that drive the wheel directly.
+   */
+  explicit TimerWheel(std::chrono::microseconds tick,
+                      std::function<void(Clock::time_point)> wakeup = nullptr,
+                      Clock::time_point now = Clock::now());
+
+  // Unschedules all timers still in the wheel without running them.
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  /**
+   * Schedules `cb` to run after `delay`, cancelling it first if it is
+   * already scheduled.  Delays shorter than a tick expire on the next call
+   * to advance(), which the owner is asked to make right away.
+   */
+  void schedule(Callback* cb,
+                std::chrono::microseconds delay,
+                Clock::time_point now = Clock::now());
+
+  /**
+   * Runs the callbacks of all timers that expired by `now`.
+   */
+  void advance(Clock::time_point now = Clock::now());
+
+  /**
+   * @return  time of the next tick at which advance() has work to do, or
+   *          folly::none if no timers are scheduled.  This may be a tick at
+   *          which timers only move to a lower level of the wheel.
+   */
+  folly::Optional<Clock::time_point> nextWakeup() const;
+
+  // Number of scheduled timers.
+  size_t size() const {
+    return size_;
+  }
+
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotBits = 8;
+  static constexpr size_t kSlots = 1 << kSlotBits;
+
+ private:
+  using List = folly::IntrusiveList<Callback, &Callback::hook_>;
+
+  // Links `cb` into the slot matching its expiry_tick_ and counts it in
+  // level_size_.  Callers account for size_.
+  void insert(Callback* cb);
+
+  // Moves the timers of the current slot of the higher levels one level
+  // down.  Called when level 0 wraps around.
+  void cascade();
+
+  // First tick >= current_tick_ that has a non-empty level 0 slot or at
+  // which a non-empty level has to be cascaded, 0 if there are immediate
+  // timers, or UINT64_MAX if the wheel is empty.
+  uint64_t nextEventTick() const;
+
+  uint64_t toTick(Clock::time_point t, bool round_up) const;
+  Clock::time_point toTime(uint64_t tick) const;
+  void reportWakeup(uint64_t tick);
+
+  const std::chrono::microseconds tick_;
+  const Clock::time_point start_;
+  std::function<void(Clock::time_point)> wakeup_;
+
+  // Next tick advance() will process.
+  uint64_t current_tick_ = 0;
+  // Tick of the last wakeup reported to the owner, UINT64_MAX if none.
+  uint64_t wakeup_tick_ = UINT64_MAX;
+  bool advancing_ = false;
+  size_t size_ = 0;
+  // Number of timers on each level, and in immediate_ at index kLevels.
+  // Lets advance() skip idle stretches in one step when only far away timers
+  // are scheduled.
+  std::array<size_t, kLevels + 1> level_size_{};
+
+  std::array<std::array<List, kSlots>, kLevels> slots_;
+  // Timers scheduled with delays shorter than a tick.
+  List immediate_;
+  // Which level 0 slots may be non-empty.  Bits are cleared lazily when a
+  // slot is processed, so cancelled timers may leave stale bits behind.
+  std::array<uint64_t, kSlots / 64> level0_bitmap_{};
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TraceLogger.h"
+
+#include <limits>
+
+namespace facebook { namespace logdevice {
+
+bool TraceLogger::consumeSampleBudget(const char* table,
+                                      uint32_t& sample_rate) {
+  const uint64_t max_per_sec =
+      cluster_config_->get()->serverConfig()->getTracerMaxSamplesPerSec(table);
+  if (max_per_sec == 0) {
+    return true;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(sample_budgets_mutex_);
+  SampleBudget& budget = sample_budgets_[table];
+  if (now - budget.window_start >= std::chrono::seconds(1)) {
+    budget.window_start = now;
+    budget.published = 0;
+  }
+  if (budget.published >= max_per_sec) {
+    budget.dropped_rate += sample_rate;
+    return false;
+  }
+  ++budget.published;
+  sample_rate = static_cast<uint32_t>(
+      std::min<uint64_t>(std::numeric_limits<uint32_t>::max(),
+                         sample_rate + budget.dropped_rate));
+  budget.dropped_rate = 0;
+  return true;
+}
+
+}} // namespace facebook::logdevice
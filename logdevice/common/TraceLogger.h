@@ -7,8 +7,11 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include <folly/Optional.h>
 
@@ -46,6 +49,18 @@ class TraceLogger {
     return cluster_config_->get()->serverConfig()->getDefaultSamplePercentage();
   }
 
+  /**
+   * Called by tracers for a sample they decided to publish, before building
+   * it. Returns false if `table' has used up its budget of samples for the
+   * current second (see "max-samples-per-sec" in the "trace-logger" config
+   * section), in which case the sample must be dropped. Otherwise adds the
+   * sample rates of the samples dropped since the last published one to
+   * `sample_rate', so that published samples still account for all events.
+   *
+   * Thread safe.
+   */
+  bool consumeSampleBudget(const char* table, uint32_t& sample_rate);
+
   /** Helpers useful in tracing **/
   std::string nodeIDToIPAddress(const NodeID& node_id) const {
     const auto node = cluster_config_->get()->serverConfig()->getNode(node_id);
@@ -62,5 +77,18 @@ class TraceLogger {
  protected:
   const std::shared_ptr<UpdateableConfig> cluster_config_;
   const folly::Optional<NodeID> my_node_id_;
+
+ private:
+  struct SampleBudget {
+    std::chrono::steady_clock::time_point window_start;
+    // Samples published since window_start.
+    uint64_t published = 0;
+    // Sum of the sample rates of the samples dropped since the last published
+    // one.
+    uint64_t dropped_rate = 0;
+  };
+
+  std::mutex sample_budgets_mutex_;
+  std::unordered_map<std::string, SampleBudget> sample_budgets_;
 };
 }} // namespace facebook::logdevice
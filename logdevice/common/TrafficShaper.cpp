@@ -45,6 +45,7 @@ TrafficShaper::TrafficShaper(Processor* processor, StatsHolder* stats)
     : processor_(processor), stats_(stats) {
   nw_update_ = std::make_unique<FlowGroupsUpdate>(
       static_cast<size_t>(NodeLocationScope::ROOT) + 1);
+  nw_adaptive_policies_.resize(nw_update_->group_entries.size());
   read_io_update_ = std::make_unique<FlowGroupsUpdate>(1);
 
   nw_shaping_deps_ = std::make_unique<NwShapingFlowGroupDeps>(stats);
@@ -159,24 +160,44 @@ bool TrafficShaper::dispatchUpdateCommon(
     const configuration::ShapingConfig& shaping_config,
     int nworkers,
     FlowGroupsUpdate& update,
-    FlowGroupDependencies* deps) {
+    FlowGroupDependencies* deps,
+    std::vector<AdaptiveFlowGroupPolicy>* adaptive_policies) {
   bool future_updates_required = false;
+  bool adjust_adaptive = false;
+  if (adaptive_policies) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= next_adaptive_adjustment_) {
+      adjust_adaptive = true;
+      next_adaptive_adjustment_ = now + ADAPTIVE_ADJUSTMENT_INTERVAL;
+    }
+  }
   for (auto& policy_it : shaping_config.flowGroupPolicies) {
     auto scope = policy_it.first;
     auto& ge = update.group_entries[static_cast<int>(scope)];
     if (policy_it.second.enabled()) {
       future_updates_required = true;
     }
+    auto& pq_overflow_entry = ge.priorityQEntry();
 
     // The policy or interval may change at any time via the admin
     // interface, so normalize on each update.
-    ge.policy = policy_it.second.normalize(nworkers, updateInterval_);
+    if (adaptive_policies) {
+      auto& adaptive = (*adaptive_policies)[static_cast<int>(scope)];
+      adaptive.addFeedback(ge.backlogged, pq_overflow_entry.last_overflow > 0);
+      if (adjust_adaptive) {
+        adaptive.adjust(policy_it.second);
+      }
+      ge.policy =
+          adaptive.apply(policy_it.second).normalize(nworkers, updateInterval_);
+    } else {
+      ge.policy = policy_it.second.normalize(nworkers, updateInterval_);
+    }
+    ge.backlogged.fill(false);
 
     // Any overflow from the last run that couldn't be used in the
     // priority queue buckets indicates that the priority queues have
     // filled to capacity.  To ensure compliance with the maximum burst
     // setting, discard this credit so it isn't applied on the next run.
-    auto& pq_overflow_entry = ge.priorityQEntry();
     pq_overflow_entry.last_overflow = 0;
 
     Priority p = Priority::MAX;
@@ -211,11 +232,13 @@ bool TrafficShaper::dispatchUpdateNw() {
   auto config = processor_->config_->updateableServerConfig()->get();
   const configuration::ShapingConfig& shaping_config =
       config->getTrafficShapingConfig();
-  bool future_updates_required =
-      dispatchUpdateCommon(shaping_config,
-                           processor_->getAllWorkersCount(),
-                           *nw_update_,
-                           nw_shaping_deps_.get());
+  bool future_updates_required = dispatchUpdateCommon(
+      shaping_config,
+      processor_->getAllWorkersCount(),
+      *nw_update_,
+      nw_shaping_deps_.get(),
+      processor_->settings()->traffic_shaping_adaptive ? &nw_adaptive_policies_
+                                                       : nullptr);
 
   processor_->applyToWorkers(
       [&](Worker& w) {
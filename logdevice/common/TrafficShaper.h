@@ -13,6 +13,7 @@
 #include <mutex>
 #include <thread>
 
+#include "logdevice/common/AdaptiveFlowGroupPolicy.h"
 #include "logdevice/common/FlowGroup.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/include/ConfigSubscriptionHandle.h"
@@ -65,6 +66,14 @@ class TrafficShaper {
   // comes last to ensure unsubscription before rest of destruction
   ConfigSubscriptionHandle config_update_sub_;
 
+  // How often AdaptiveFlowGroupPolicy::adjust() is called when
+  // traffic-shaping-adaptive is set.
+  static constexpr std::chrono::milliseconds ADAPTIVE_ADJUSTMENT_INTERVAL{100};
+
+  // Indexed by scope. Only network traffic shaping is adaptive.
+  std::vector<AdaptiveFlowGroupPolicy> nw_adaptive_policies_;
+  std::chrono::steady_clock::time_point next_adaptive_adjustment_;
+
   std::chrono::seconds limits_update_interval_{30};
   std::chrono::time_point<std::chrono::steady_clock> next_limits_publication_ =
       std::chrono::time_point<std::chrono::steady_clock>();
@@ -94,10 +103,16 @@ class TrafficShaper {
    */
   bool dispatchUpdateNw();
   bool dispatchUpdateReadIO();
-  bool dispatchUpdateCommon(const configuration::ShapingConfig& shaping_config,
-                            int nworkers,
-                            FlowGroupsUpdate& update,
-                            FlowGroupDependencies* deps);
+  /**
+   * @param adaptive_policies  if not null, the configured policies are
+   *                           adjusted by these before being distributed
+   */
+  bool dispatchUpdateCommon(
+      const configuration::ShapingConfig& shaping_config,
+      int nworkers,
+      FlowGroupsUpdate& update,
+      FlowGroupDependencies* deps,
+      std::vector<AdaptiveFlowGroupPolicy>* adaptive_policies = nullptr);
 
   void setIntervalImpl(const decltype(updateInterval_)& interval);
   std::unique_ptr<FlowGroupDependencies> nw_shaping_deps_;
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TrimBatcher.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_TRIM_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+TrimBatcher::TrimBatcher() = default;
+
+TrimBatcher::~TrimBatcher() = default;
+
+bool TrimBatcher::add(const TRIM_Header& header, NodeID to) {
+  const Settings& settings = Worker::settings();
+  if (settings.trim_batching_window.count() <= 0) {
+    return false;
+  }
+
+  folly::Optional<uint16_t> proto =
+      Worker::onThisThread()->sender().getSocketProtocolVersion(to.index());
+  if (!proto.hasValue() || proto.value() < Compatibility::MULTI_TRIM_SUPPORT) {
+    return false;
+  }
+
+  Batch& batch = batches_[to.index()];
+  batch.to = to;
+  batch.trims.push_back(header);
+  ++num_pending_;
+
+  if (!timer_.isAssigned()) {
+    timer_.assign([this] { flush(); });
+  }
+  if (batch.trims.size() >= settings.trim_batching_max_trims) {
+    // Send on the next event loop iteration.
+    timer_.activate(std::chrono::microseconds::zero());
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.trim_batching_window);
+  }
+  return true;
+}
+
+void TrimBatcher::flush() {
+  auto batches = std::move(batches_);
+  batches_.clear();
+  num_pending_ = 0;
+  for (auto& kv : batches) {
+    send(std::move(kv.second));
+  }
+}
+
+void TrimBatcher::send(Batch batch) {
+  Sender& sender = Worker::onThisThread()->sender();
+  const Address to(batch.to);
+  auto& trims = batch.trims;
+  ld_check(!trims.empty());
+
+  if (trims.size() == 1) {
+    auto msg = std::make_unique<TRIM_Message>(trims.front());
+    if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+      TRIM_Message::onSentCommon(trims.front(), err, to);
+    }
+    return;
+  }
+
+  const size_t num_trims = trims.size();
+  auto msg = std::make_unique<MULTI_TRIM_Message>(std::move(trims));
+  if (sender.sendMessage(std::move(msg), batch.to) != 0) {
+    const Status st = err;
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to send a MULTI_TRIM with %zu trims to %s: %s",
+                   num_trims,
+                   batch.to.toString().c_str(),
+                   error_description(st));
+    // sendMessage() doesn't consume the message on failure
+    msg->onSent(st, to);
+    return;
+  }
+
+  WORKER_STAT_INCR(client.trim_batches_sent);
+  WORKER_STAT_ADD(client.trim_batched_trims_sent, num_trims);
+}
+
+}} // namespace facebook::logdevice
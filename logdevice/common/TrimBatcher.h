@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/TRIM_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-Worker coalescing of TRIM messages headed to the same storage
+ *       node. When --trim-batching-window is nonzero, TRIMs of batchable
+ *       TrimRequests (the ones started by Client::trimBatch()) sent within
+ *       the window to a node whose connection supports MULTI_TRIM are held
+ *       back and then sent together in one MULTI_TRIM_Message (or as a plain
+ *       TRIM if there's only one).
+ *
+ *       As with GetSeqStateBatcher, batches are only sent from the timer
+ *       callback, so that send failures reported to TrimRequests don't
+ *       reenter them while they are sending.
+ */
+
+class TrimBatcher {
+ public:
+  TrimBatcher();
+  ~TrimBatcher();
+
+  TrimBatcher(const TrimBatcher&) = delete;
+  TrimBatcher& operator=(const TrimBatcher&) = delete;
+
+  /**
+   * Takes a TRIM that a TrimRequest wants to send to `to`, if it can be
+   * batched.
+   *
+   * The outcome of sending the message, including errors returned by
+   * Sender::sendMessage() when the batch is sent, is reported through
+   * TRIM_Message::onSentCommon().
+   *
+   * @return  true if `header` was taken. false if batching is disabled or
+   *          `to` hasn't negotiated a protocol with MULTI_TRIM support yet;
+   *          the caller should send a TRIM directly.
+   */
+  bool add(const TRIM_Header& header, NodeID to);
+
+  // Number of TRIMs waiting to be sent.
+  size_t numPending() const {
+    return num_pending_;
+  }
+
+ private:
+  struct Batch {
+    NodeID to;
+    std::vector<TRIM_Header> trims;
+  };
+
+  // Sends all pending batches.
+  void flush();
+
+  void send(Batch batch);
+
+  std::unordered_map<node_index_t, Batch> batches_;
+  size_t num_pending_ = 0;
+
+  // Fires when the oldest pending TRIM has waited for --trim-batching-window,
+  // or right away if a batch grew too big.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -12,6 +12,7 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/SyncSequencerRequest.h"
+#include "logdevice/common/TrimBatcher.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
@@ -300,8 +301,14 @@ void TrimRequest::finalize(Status status) {
 int TrimRequest::sendOneMessage(ShardID to) {
   NodeID node_id(to.node());
   TRIM_Header header = {id_, log_id_, trim_point_, to.shard()};
+  Worker* w = Worker::onThisThread();
+  if (batchable_ && w->trimBatcher().add(header, node_id)) {
+    // Will be sent shortly, together with other TRIMs to the same node.
+    // Send errors are reported through onMessageSent().
+    return 0;
+  }
   auto msg = std::make_unique<TRIM_Message>(header);
-  return Worker::onThisThread()->sender().sendMessage(std::move(msg), node_id);
+  return w->sender().sendMessage(std::move(msg), node_id);
 }
 
 StorageSetAccessor::SendResult TrimRequest::sendTo(ShardID shard) {
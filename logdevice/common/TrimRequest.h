@@ -111,6 +111,15 @@ class TrimRequest : public DistributedRequest {
     bypass_tail_lsn_check_ = true;
   }
 
+  /**
+   * Allows the TRIMs of this request to be held for up to
+   * --trim-batching-window and sent together with TRIMs of other batchable
+   * requests on the same Worker. Used by Client::trimBatch().
+   */
+  void setBatchable() {
+    batchable_ = true;
+  }
+
  private:
   void fetchLogConfig();
 
@@ -176,6 +185,7 @@ class TrimRequest : public DistributedRequest {
 
   bool bypass_write_token_check_ = false;
   bool bypass_tail_lsn_check_ = false;
+  bool batchable_ = false;
 
   std::unique_ptr<NodeSetFinder> nodeset_finder_{nullptr};
 };
@@ -7,9 +7,20 @@
  */
 #include "logdevice/common/WatchDogThread.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <map>
 #include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <folly/experimental/symbolizer/StackTrace.h>
+#include <folly/experimental/symbolizer/Symbolizer.h>
 
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/RunContext.h"
 #include "logdevice/common/ThreadID.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
@@ -19,6 +30,96 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// Signal sent to a stalled Worker's thread to make it record its own stack.
+// Real-time signals are not used by anything else in logdeviced.
+int stackSampleSignal() {
+  return SIGRTMIN;
+}
+
+constexpr size_t kMaxSampledFrames = 64;
+
+// The one stack sample in flight. Filled in by the signal handler on the
+// stalled thread, read by the watchdog thread.
+struct StackSample {
+  enum State { IDLE, REQUESTED, WRITING, DONE };
+  std::atomic<int> state{IDLE};
+  uintptr_t frames[kMaxSampledFrames];
+  ssize_t num_frames{0};
+  RunContext running;
+};
+StackSample stack_sample;
+// Serializes sampling across WatchDogThreads of multiple Processors in the
+// same process (tests).
+std::mutex stack_sample_mutex;
+
+void handle_stack_sample_signal(int /*sig*/) {
+  int expected = StackSample::REQUESTED;
+  if (!stack_sample.state.compare_exchange_strong(expected,
+                                                  StackSample::WRITING)) {
+    // Watchdog gave up on this sample.
+    return;
+  }
+  const int saved_errno = errno;
+  stack_sample.num_frames =
+      folly::symbolizer::getStackTraceSafe(stack_sample.frames,
+                                           kMaxSampledFrames);
+  Worker* w = Worker::onThisThread(false);
+  stack_sample.running = w ? w->currentlyRunning_ : RunContext();
+  errno = saved_errno;
+  stack_sample.state.store(StackSample::DONE, std::memory_order_release);
+}
+
+void install_stack_sample_handler() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    struct sigaction sa;
+    sa.sa_handler = handle_stack_sample_signal;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    int rv = sigaction(stackSampleSignal(), &sa, nullptr);
+    if (rv != 0) {
+      ld_error("Failed to install the handler for stack sampling of stalled "
+               "workers: %s",
+               strerror(errno));
+    }
+  });
+}
+
+// Takes one stack sample of thread `tid`. Returns false if the thread didn't
+// respond within `timeout`.
+bool sample_thread_stack(int tid,
+                         std::chrono::milliseconds timeout,
+                         std::vector<uintptr_t>* frames,
+                         RunContext* running) {
+  stack_sample.state.store(StackSample::REQUESTED);
+  if (syscall(SYS_tgkill, getpid(), tid, stackSampleSignal()) != 0) {
+    stack_sample.state.store(StackSample::IDLE);
+    return false;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (stack_sample.state.load(std::memory_order_acquire) !=
+         StackSample::DONE) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      int expected = StackSample::REQUESTED;
+      if (stack_sample.state.compare_exchange_strong(expected,
+                                                     StackSample::IDLE)) {
+        return false;
+      }
+      // The handler is writing the sample right now, wait for it.
+    }
+    std::this_thread::yield();
+  }
+  const ssize_t n = std::max<ssize_t>(stack_sample.num_frames, 0);
+  frames->assign(stack_sample.frames, stack_sample.frames + n);
+  *running = stack_sample.running;
+  stack_sample.state.store(StackSample::IDLE);
+  return true;
+}
+
+} // namespace
+
 WatchDogThread::WatchDogThread(Processor* p,
                                std::chrono::milliseconds poll_interval,
                                rate_limit_t bt_ratelimit)
@@ -30,6 +131,7 @@ WatchDogThread::WatchDogThread(Processor* p,
       total_stalled_time_ms_(processor_->settings()->num_workers,
                              std::chrono::milliseconds::zero()) {
   ld_check(processor_->getWorkerCount(WorkerType::GENERAL) != 0);
+  install_stack_sample_handler();
   thread_ = std::thread(&WatchDogThread::run, this);
 }
 
@@ -77,6 +179,11 @@ void WatchDogThread::detectStalls() {
                   events_completed_[idx],
                   events_called_new,
                   events_completed_new);
+
+          const size_t samples = processor_->settings()->watchdog_stall_samples;
+          if (samples > 0 && !processor_->isShuttingDown()) {
+            sampleStalledWorker(w, total_stalled_time_ms_[idx], samples);
+          }
         } else {
           // Clear accumulated time for idx which is not stalled any more
           total_stalled_time_ms_[idx] = std::chrono::milliseconds::zero();
@@ -118,6 +225,74 @@ void WatchDogThread::detectStalls() {
   }
 }
 
+void WatchDogThread::sampleStalledWorker(Worker& w,
+                                         std::chrono::milliseconds stalled_for,
+                                         size_t samples) {
+  // Identical samples are counted together.
+  std::map<std::pair<std::vector<uintptr_t>, std::string>, size_t> counts;
+  size_t total = 0;
+  {
+    std::lock_guard<std::mutex> lock(stack_sample_mutex);
+    for (size_t i = 0; i < samples; ++i) {
+      std::vector<uintptr_t> frames;
+      RunContext running;
+      if (!sample_thread_stack(w.getThreadId(),
+                               std::chrono::milliseconds(100),
+                               &frames,
+                               &running)) {
+        RATELIMIT_INFO(std::chrono::seconds(10),
+                       1,
+                       "Failed to sample the stack of stalled %s",
+                       w.getName().c_str());
+        break;
+      }
+      ++counts[std::make_pair(std::move(frames), running.describe())];
+      ++total;
+    }
+  }
+  if (counts.empty()) {
+    return;
+  }
+
+  StallReport report;
+  report.time = std::chrono::system_clock::now();
+  report.worker = w.getName();
+  report.stalled_for = stalled_for;
+  folly::symbolizer::Symbolizer symbolizer;
+  for (const auto& kv : counts) {
+    const std::vector<uintptr_t>& frames = kv.first.first;
+    std::vector<folly::symbolizer::SymbolizedFrame> symbolized(frames.size());
+    symbolizer.symbolize(frames.data(), symbolized.data(), frames.size());
+    folly::symbolizer::StringSymbolizePrinter printer;
+    printer.println(symbolized.data(), symbolized.size());
+    report.stacks.push_back(
+        StallReport::Stack{kv.second, kv.first.second, printer.str()});
+  }
+  std::sort(report.stacks.begin(),
+            report.stacks.end(),
+            [](const StallReport::Stack& a, const StallReport::Stack& b) {
+              return a.count > b.count;
+            });
+
+  ld_info("%s was running %s in %zu of %zu stack samples",
+          report.worker.c_str(),
+          report.stacks[0].running.c_str(),
+          report.stacks[0].count,
+          total);
+
+  std::lock_guard<std::mutex> lock(stall_reports_mutex_);
+  if (stall_reports_.size() >= MAX_STALL_REPORTS) {
+    stall_reports_.pop_front();
+  }
+  stall_reports_.push_back(std::move(report));
+}
+
+std::vector<WatchDogThread::StallReport>
+WatchDogThread::getStallReports() const {
+  std::lock_guard<std::mutex> lock(stall_reports_mutex_);
+  return std::vector<StallReport>(stall_reports_.begin(), stall_reports_.end());
+}
+
 void WatchDogThread::run() {
   ThreadID::set(ThreadID::Type::UTILITY, "ld:watchdog");
 
@@ -9,7 +9,9 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -18,6 +20,7 @@
 namespace facebook { namespace logdevice {
 
 class Processor;
+class Worker;
 
 class WatchDogThread {
  public:
@@ -27,6 +30,37 @@ class WatchDogThread {
 
   void shutdown();
 
+  /**
+   * A Worker found stalled, with stack traces sampled from its thread
+   * (see --watchdog-stall-samples).
+   */
+  struct StallReport {
+    struct Stack {
+      // Number of samples that had this stack and RunContext.
+      size_t count;
+      // What the Worker was running, as RunContext::describe() puts it.
+      std::string running;
+      // Symbolized stack trace, one frame per line.
+      std::string trace;
+    };
+
+    std::chrono::system_clock::time_point time;
+    std::string worker;
+    // For how long the Worker had been stalled when the samples were taken.
+    std::chrono::milliseconds stalled_for;
+    // Most frequent first.
+    std::vector<Stack> stacks;
+  };
+
+  // Maximum number of StallReports kept; older ones are discarded.
+  static constexpr size_t MAX_STALL_REPORTS = 64;
+
+  /**
+   * @return the most recent stall reports, oldest first. Can be called from
+   *         any thread, including while Workers are stalled.
+   */
+  std::vector<StallReport> getStallReports() const;
+
  private:
   std::thread thread_;
 
@@ -47,10 +81,20 @@ class WatchDogThread {
   std::mutex mutex_;
 
   std::vector<std::chrono::milliseconds> total_stalled_time_ms_;
+  // Guards stall_reports_.
+  mutable std::mutex stall_reports_mutex_;
+  std::deque<StallReport> stall_reports_;
+
   // Main thread loop.
   void run();
 
   void detectStalls();
+
+  // Samples the stack of a stalled Worker's thread `samples` times and adds
+  // a StallReport.
+  void sampleStalledWorker(Worker& w,
+                           std::chrono::milliseconds stalled_for,
+                           size_t samples);
 };
 
 }} // namespace facebook::logdevice
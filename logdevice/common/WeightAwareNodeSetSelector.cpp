@@ -18,6 +18,96 @@
 
 namespace facebook { namespace logdevice {
 
+using configuration::nodes::NodesConfiguration;
+
+namespace {
+
+// The part of nodeset selection that doesn't depend on the log: storage nodes
+// and their domains at the replication scope. Looking up and formatting the
+// locations of all nodes adds up when the nodesets of all logs are
+// re-evaluated after a config change, so it's cached, see getTopology().
+struct Topology {
+  struct Node {
+    node_index_t node;
+    shard_size_t num_shards;
+    // Index in `domains`, or -1 if the node doesn't have location information
+    // for the scope.
+    int domain;
+  };
+  struct Domain {
+    std::string name;
+    uint64_t name_hash;
+  };
+
+  // Storage nodes, in the order of the storage membership.
+  std::vector<Node> nodes;
+  // Sorted by name.
+  std::vector<Domain> domains;
+};
+
+std::shared_ptr<const Topology>
+buildTopology(const NodesConfiguration& nodes_configuration,
+              NodeLocationScope replication_scope) {
+  auto topology = std::make_shared<Topology>();
+  const auto& membership = nodes_configuration.getStorageMembership();
+  std::map<std::string, std::vector<size_t>> nodes_by_domain;
+  for (const auto node : *membership) {
+    const auto num_shards = nodes_configuration.getNumShards(node);
+    ld_check(num_shards > 0);
+    topology->nodes.push_back(Topology::Node{node, num_shards, -1});
+
+    std::string location_str;
+    if (replication_scope == NodeLocationScope::ROOT) {
+      // All nodes are in the same replication domain.
+    } else {
+      const auto* sd = nodes_configuration.getNodeServiceDiscovery(node);
+      ld_check(sd != nullptr);
+      if (!sd->location.hasValue() ||
+          !sd->location.value().scopeSpecified(replication_scope)) {
+        continue;
+      }
+      location_str = sd->location.value().getDomain(replication_scope, node);
+    }
+    nodes_by_domain[location_str].push_back(topology->nodes.size() - 1);
+  }
+
+  for (auto& kv : nodes_by_domain) {
+    const int domain = static_cast<int>(topology->domains.size());
+    for (size_t i : kv.second) {
+      topology->nodes[i].domain = domain;
+    }
+    const uint64_t name_hash = folly::hash::fnv64(kv.first);
+    topology->domains.push_back(
+        Topology::Domain{std::move(kv.first), name_hash});
+  }
+  return topology;
+}
+
+// Returns the Topology of @param nodes_configuration at @param scope. The
+// result is cached on this thread until it's called with a different
+// NodesConfiguration.
+std::shared_ptr<const Topology> getTopology(
+    const std::shared_ptr<const NodesConfiguration>& nodes_configuration,
+    NodeLocationScope scope) {
+  struct Cache {
+    std::shared_ptr<const NodesConfiguration> nodes_configuration;
+    std::map<NodeLocationScope, std::shared_ptr<const Topology>> topologies;
+  };
+  static thread_local Cache cache;
+
+  if (cache.nodes_configuration != nodes_configuration) {
+    cache.nodes_configuration = nodes_configuration;
+    cache.topologies.clear();
+  }
+  std::shared_ptr<const Topology>& topology = cache.topologies[scope];
+  if (!topology) {
+    topology = buildTopology(*nodes_configuration, scope);
+  }
+  return topology;
+}
+
+} // namespace
+
 NodeSetSelector::Result
 WeightAwareNodeSetSelector::getStorageSet(logid_t log_id,
                                           const Configuration* cfg,
@@ -83,7 +173,6 @@ WeightAwareNodeSetSelector::getStorageSet(logid_t log_id,
     // To pick a node, we pop one from the back.
     std::vector<CandidateNode> nodes;
   };
-  std::map<std::string, Domain> domains;
 
   // TODO: migrate it to use NodesConfiguration with switchable source
   const auto& nodes_configuration =
@@ -91,15 +180,19 @@ WeightAwareNodeSetSelector::getStorageSet(logid_t log_id,
   ld_check(nodes_configuration != nullptr);
   const auto& membership = nodes_configuration->getStorageMembership();
 
-  for (const auto node : *membership) {
+  std::shared_ptr<const Topology> topology =
+      getTopology(nodes_configuration, replication_scope);
+  // Same indexes as topology->domains.
+  std::vector<Domain> domains(topology->domains.size());
+
+  for (const Topology::Node& topology_node : topology->nodes) {
+    const node_index_t node = topology_node.node;
     // Filter nodes excluded from `options`.
     if (options != nullptr && options->exclude_nodes.count(node)) {
       continue;
     }
 
-    const auto num_shards = nodes_configuration->getNumShards(node);
-    ld_check(num_shards > 0);
-    shard_index_t shard_idx = mapLogToShard_(log_id, num_shards);
+    shard_index_t shard_idx = mapLogToShard_(log_id, topology_node.num_shards);
     ShardID shard = ShardID(node, shard_idx);
 
     // Filter nodes that shouldn't be included in nodesets
@@ -108,13 +201,9 @@ WeightAwareNodeSetSelector::getStorageSet(logid_t log_id,
       continue;
     }
 
-    const auto* sd = nodes_configuration->getNodeServiceDiscovery(node);
-    ld_check(sd != nullptr);
-
-    std::string location_str;
-    if (replication_scope == NodeLocationScope::ROOT) {
-      // All nodes are in the same replication domain.
-    } else {
+    if (topology_node.domain < 0) {
+      const auto* sd = nodes_configuration->getNodeServiceDiscovery(node);
+      ld_check(sd != nullptr);
       if (!sd->location.hasValue()) {
         ld_error("Can't select nodeset because node %d (%s) does not have "
                  "location information",
@@ -125,16 +214,14 @@ WeightAwareNodeSetSelector::getStorageSet(logid_t log_id,
 
       const NodeLocation& location = sd->location.value();
       assert(!location.isEmpty());
-      if (!location.scopeSpecified(replication_scope)) {
-        ld_error("Can't select nodeset because location %s of node %d (%s) "
-                 "doesn't have location for scope %s.",
-                 location.toString().c_str(),
-                 node,
-                 sd->address.toString().c_str(),
-                 NodeLocation::scopeNames()[replication_scope].c_str());
-        return res;
-      }
-      location_str = location.getDomain(replication_scope, node);
+      ld_check(!location.scopeSpecified(replication_scope));
+      ld_error("Can't select nodeset because location %s of node %d (%s) "
+               "doesn't have location for scope %s.",
+               location.toString().c_str(),
+               node,
+               sd->address.toString().c_str(),
+               NodeLocation::scopeNames()[replication_scope].c_str());
+      return res;
     }
 
     CandidateNode n;
@@ -152,13 +239,13 @@ WeightAwareNodeSetSelector::getStorageSet(logid_t log_id,
     } else {
       n.shard_id_hash = folly::Random::rand64();
     }
-    domains[location_str].nodes.push_back(n);
+    domains[topology_node.domain].nodes.push_back(n);
   }
 
-  for (auto& kv : domains) {
-    Domain* d = &kv.second;
+  for (size_t i = 0; i < domains.size(); ++i) {
+    Domain* d = &domains[i];
     d->priority = consistentHashing_
-        ? hash_tuple({seed, log_id.val(), folly::hash::fnv64(kv.first)})
+        ? hash_tuple({seed, log_id.val(), topology->domains[i].name_hash})
         : folly::Random::rand64();
     std::sort(d->nodes.begin(),
               d->nodes.end(),
@@ -219,8 +306,8 @@ WeightAwareNodeSetSelector::getStorageSet(logid_t log_id,
 
     // Initialize queue.
     size_t result_size = 0;
-    for (auto& kv : domains) {
-      Domain* d = &kv.second;
+    for (Domain& domain : domains) {
+      Domain* d = &domain;
       result_size += only_writable ? d->num_picked_writable : d->num_picked;
       if (!d->nodes.empty()) {
         queue.push(d);
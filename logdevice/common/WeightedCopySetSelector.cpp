@@ -9,6 +9,7 @@
 
 #include "logdevice/common/CopySet.h"
 #include "logdevice/common/HashBasedSequencerLocator.h"
+#include "logdevice/common/ShardLatencyTracker.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/util.h"
 
@@ -885,6 +886,16 @@ WeightedCopySetSelector::select(copyset_size_t extras,
       }
     }
 
+    if (const ShardLatencyTracker* tracker = deps_->getShardLatencyTracker()) {
+      size_t replaced = preferFasterShards(copyset_chain.data(),
+                                           replication_,
+                                           hierarchy,
+                                           pick_local_separately,
+                                           *tracker,
+                                           rng);
+      STAT_ADD(stats_, copyset_adaptive_replacements, replaced);
+    }
+
     // Check if all selected nodes are available. If not, blacklist and retry.
     if (checkAvailabilityAndBlacklist(copyset_chain.data(),
                                       replication_,
@@ -1496,6 +1507,106 @@ size_t WeightedCopySetSelector::selectFlat(size_t replication,
   return size;
 }
 
+size_t
+WeightedCopySetSelector::preferFasterShards(StoreChainLink copyset[],
+                                            size_t copyset_size,
+                                            const AdjustedHierarchy& hierarchy,
+                                            bool local_detached,
+                                            const ShardLatencyTracker& tracker,
+                                            RNG& rng) const {
+  const auto now = ShardLatencyTracker::Clock::now();
+  size_t replaced = 0;
+
+  // Draws an alternative to copyset[i] according to weights. Detached
+  // (unavailable) nodes and domains have zero weight and won't be drawn.
+  // Returns an invalid ShardID if the draw doesn't give a shard that can
+  // replace copyset[i]: the copyset must still have at most one copy per leaf
+  // domain and at least secondary_replication_ secondary domains.
+  auto draw_alternative = [&](size_t i, const Hierarchy::Path& path) {
+    const bool stay_in_domain = local_detached && my_domain_idx_.hasValue() &&
+        path[0] == my_domain_idx_.value();
+    size_t secondary_idx = path[0];
+    if (!stay_in_domain &&
+        Sampling::sampleOne(
+            hierarchy.getRoot().getWeights(), &secondary_idx, rng) !=
+            Sampling::Result::OK) {
+      return ShardID();
+    }
+    AdjustedDomain secondary = hierarchy.getRoot().getSubdomain(secondary_idx);
+    size_t leaf_idx;
+    if (Sampling::sampleOne(secondary.getWeights(), &leaf_idx, rng) !=
+        Sampling::Result::OK) {
+      return ShardID();
+    }
+    AdjustedDomain leaf = secondary.getSubdomain(leaf_idx);
+    size_t shard_idx;
+    if (Sampling::sampleOne(leaf.getWeights(), &shard_idx, rng) !=
+        Sampling::Result::OK) {
+      return ShardID();
+    }
+    const ShardID alternative = leaf.getShardID(shard_idx);
+    if (alternative == copyset[i].destination) {
+      return ShardID();
+    }
+
+    folly::small_vector<size_t, 4> secondary_domains = {secondary_idx};
+    for (size_t j = 0; j < copyset_size; ++j) {
+      if (j == i) {
+        continue;
+      }
+      const Hierarchy::Path& other =
+          hierarchy_.node_paths.at(copyset[j].destination);
+      if (other[0] == secondary_idx && other[1] == leaf_idx) {
+        return ShardID();
+      }
+      if (std::find(secondary_domains.begin(),
+                    secondary_domains.end(),
+                    other[0]) == secondary_domains.end()) {
+        secondary_domains.push_back(other[0]);
+      }
+    }
+    if (secondary_domains.size() < secondary_replication_) {
+      return ShardID();
+    }
+    return alternative;
+  };
+
+  // Draws that don't produce a valid alternative are retried a few times,
+  // otherwise shards whose peers are mostly in the copyset already would
+  // rarely get replaced.
+  const int kMaxDraws = 3;
+
+  for (size_t i = 0; i < copyset_size; ++i) {
+    auto it = hierarchy_.node_paths.find(copyset[i].destination);
+    if (it == hierarchy_.node_paths.end()) {
+      continue;
+    }
+    const double cost = tracker.getCost(copyset[i].destination, now);
+    if (cost <= 0) {
+      // No estimates yet.
+      continue;
+    }
+
+    ShardID alternative;
+    for (int draw = 0; draw < kMaxDraws && !alternative.isValid(); ++draw) {
+      alternative = draw_alternative(i, it->second);
+    }
+    if (!alternative.isValid()) {
+      continue;
+    }
+
+    const double alternative_cost = tracker.getCost(alternative, now);
+    if (alternative_cost >= cost ||
+        folly::Random::randDouble01(rng) >= 1 - alternative_cost / cost) {
+      continue;
+    }
+    copyset[i].destination = alternative;
+    ++replaced;
+  }
+
+  return replaced;
+}
+
 bool WeightedCopySetSelector::AdjustedHierarchy::setDomainDetached(
     const Hierarchy::Path& path,
     size_t level,
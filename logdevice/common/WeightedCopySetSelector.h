@@ -374,6 +374,24 @@ class WeightedCopySetSelector : public CopySetSelector {
                            bool* out_biased,
                            RNG& rng) const;
 
+  // Used with --adaptive-copyset-selection. For each shard of a freshly
+  // selected copyset, draws an alternative shard according to weights and,
+  // if replacing it keeps the copyset valid and the alternative is cheaper
+  // according to `tracker`, replaces it with probability
+  // 1 - alternative_cost / current_cost. So a shard that is twice as slow as
+  // its peers loses about half of its copies, and one that's only a bit
+  // slower loses only a few.
+  // Alternatives are drawn from the whole hierarchy, except for copies in the
+  // local domain when it's detached (`local_detached`); those are only
+  // replaced with other shards of the local domain.
+  // @return  Number of replaced shards.
+  size_t preferFasterShards(StoreChainLink copyset[],
+                            size_t copyset_size,
+                            const AdjustedHierarchy& hierarchy,
+                            bool local_detached,
+                            const ShardLatencyTracker& tracker,
+                            RNG& rng) const;
+
   // This is the first step of augment(). It separates the nodes of existing
   // copyset into "useful" and "redundant" (see below). Also fills out some
   // data structures that augment() will be using.
@@ -8,6 +8,7 @@
 #include "logdevice/common/Worker.h"
 
 #include <algorithm>
+#include <deque>
 #include <pthread.h>
 #include <string>
 #include <unistd.h>
@@ -19,6 +20,7 @@
 
 #include "logdevice/common/AbortAppendersEpochRequest.h"
 #include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/AppendAdmissionBatcher.h"
 #include "logdevice/common/AppendRequest.h"
 #include "logdevice/common/AppendRequestBase.h"
 #include "logdevice/common/Appender.h"
@@ -27,6 +29,7 @@
 #include "logdevice/common/CheckSealRequest.h"
 #include "logdevice/common/ClientIdxAllocator.h"
 #include "logdevice/common/ClusterState.h"
+#include "logdevice/common/ClusterStatePublisher.h"
 #include "logdevice/common/ConfigurationFetchRequest.h"
 #include "logdevice/common/CopySetManager.h"
 #include "logdevice/common/DataSizeRequest.h"
@@ -39,25 +42,35 @@
 #include "logdevice/common/GetEpochRecoveryMetadataRequest.h"
 #include "logdevice/common/GetHeadAttributesRequest.h"
 #include "logdevice/common/GetLogInfoRequest.h"
+#include "logdevice/common/GetSeqStateBatcher.h"
 #include "logdevice/common/GetTrimPointRequest.h"
 #include "logdevice/common/GraylistingTracker.h"
 #include "logdevice/common/IsLogEmptyRequest.h"
+#include "logdevice/common/LibeventTimer.h"
 #include "logdevice/common/LogIDUniqueQueue.h"
+#include "logdevice/common/LogQueryBatcher.h"
 #include "logdevice/common/LogRecoveryRequest.h"
 #include "logdevice/common/LogsConfigApiRequest.h"
 #include "logdevice/common/LogsConfigUpdatedRequest.h"
 #include "logdevice/common/MetaDataLogWriter.h"
+#include "logdevice/common/MutatedBatcher.h"
 #include "logdevice/common/NodesConfigurationUpdatedRequest.h"
 #include "logdevice/common/PermissionChecker.h"
 #include "logdevice/common/PrincipalParser.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/ReleaseBatcher.h"
 #include "logdevice/common/SSLFetcher.h"
+#include "logdevice/common/SealBatcher.h"
 #include "logdevice/common/SequencerBackgroundActivator.h"
 #include "logdevice/common/ServerConfigUpdatedRequest.h"
 #include "logdevice/common/ShapingContainer.h"
+#include "logdevice/common/ShardLatencyTracker.h"
+#include "logdevice/common/StoreBatcher.h"
 #include "logdevice/common/SyncSequencerRequest.h"
 #include "logdevice/common/TimeoutMap.h"
+#include "logdevice/common/TimerWheel.h"
 #include "logdevice/common/TraceLogger.h"
+#include "logdevice/common/TrimBatcher.h"
 #include "logdevice/common/TrimRequest.h"
 #include "logdevice/common/WorkerTimeoutStats.h"
 #include "logdevice/common/WriteMetaDataRecord.h"
@@ -71,6 +84,7 @@
 #include "logdevice/common/protocol/MessageTracer.h"
 #include "logdevice/common/stats/ServerHistograms.h"
 #include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/work_model/CPUOffloadPool.h"
 #include "logdevice/include/Err.h"
 
 namespace facebook { namespace logdevice {
@@ -130,13 +144,17 @@ class WorkerImpl {
         // AppenderBuffer queue capacity is the system-wide per-log limit
         // divided by the number of Workers
         appenderBuffer_(w->immutable_settings_->appender_buffer_queue_cap /
-                        w->immutable_settings_->num_workers),
+                            w->immutable_settings_->num_workers,
+                        /*byte_budget=*/true),
         // TODO: Make this configurable
         previously_redirected_appends_(1024),
         sslFetcher_(w->immutable_settings_->ssl_cert_path,
                     w->immutable_settings_->ssl_key_path,
                     w->immutable_settings_->ssl_ca_path,
-                    w->immutable_settings_->ssl_cert_refresh_interval),
+                    w->immutable_settings_->ssl_cert_refresh_interval,
+                    w->immutable_settings_->ssl_kernel_tls,
+                    w->immutable_settings_->ssl_session_resumption,
+                    w->immutable_settings_->ssl_session_ticket_key_path),
 
         graylistingTracker_(std::make_unique<GraylistingTracker>())
 
@@ -185,9 +203,33 @@ class WorkerImpl {
   AppendRequestEpochMap appendRequestEpochMap_;
   CheckNodeHealthRequestSet pendingHealthChecks_;
   SSLFetcher sslFetcher_;
+  AppendAdmissionBatcher appendAdmissionBatcher_;
+  StoreBatcher storeBatcher_;
+  SealBatcher sealBatcher_;
+  ReleaseBatcher releaseBatcher_;
+  MutatedBatcher mutatedBatcher_;
+  GetSeqStateBatcher getSeqStateBatcher_;
+  TrimBatcher trimBatcher_;
+  LogQueryBatcher logQueryBatcher_;
+  ClusterStatePublisher clusterStatePublisher_;
+  ShardLatencyTracker shardLatencyTracker_;
+  // See Worker::timerWheel().  The driver fires when the wheel has work.
+  std::unique_ptr<TimerWheel> timerWheel_;
+  std::unique_ptr<LibeventTimer> timerWheelDriver_;
   std::unique_ptr<SequencerBackgroundActivator> sequencerBackgroundActivator_;
   std::unique_ptr<GraylistingTracker> graylistingTracker_;
   std::unique_ptr<ShapingContainer> read_shaping_container_;
+
+  // Callbacks of work handed to the CPU offload pool, in the order the work
+  // was submitted, and whether the work finished. See
+  // Worker::offloadCPUWork().
+  struct OffloadedCPUWork {
+    folly::Func done;
+    bool finished{false};
+  };
+  std::deque<OffloadedCPUWork> offloadedCPUWork_;
+  // Sequence number of offloadedCPUWork_.front().
+  uint64_t offloadedCPUWorkHead_{0};
 };
 
 std::string Worker::makeThreadName(Processor* processor,
@@ -413,6 +455,10 @@ void Worker::onSettingsUpdated() {
     getWorkerTimeoutStats().clear();
   }
 
+  if (!new_settings->adaptive_copyset_selection) {
+    shardLatencyTracker().clear();
+  }
+
   if (impl_->graylistingTracker_) {
     impl_->graylistingTracker_->onSettingsUpdated();
   }
@@ -525,6 +571,11 @@ void Worker::setupWorker() {
     stats_->get().worker_id = idx_;
   }
 
+  if (settings().enable_perf_counters) {
+    // Must be opened on the thread that will be measured.
+    perfCounters_ = std::make_unique<ThreadPerfCounters>();
+  }
+
   // Subscribe to config updates and setting updates
   initializeSubscriptions();
 
@@ -889,12 +940,23 @@ void Worker::reportLoad() {
 
     PER_WORKER_STAT_ADD_SAMPLE(Worker::stats(), idx_, load_delta);
 
+    // Fraction of wall clock time that the event loop spent running
+    // requests and callbacks, as opposed to waiting for events.
+    auto busy = busy_time_ - last_busy_time_;
+    WORKER_STAT_ADD(worker_busy_usec,
+                    duration_cast<microseconds>(busy).count());
+    HISTOGRAM_ADD(Worker::stats(),
+                  worker_event_loop_utilization,
+                  100 * busy.count() / (now - last_load_time_).count());
+
     ld_spew("%s reporting load %ld", getName().c_str(), load_delta);
     processor_->reportLoad(idx_, load_delta, worker_type_);
+    rebalanceLoad();
   }
 
   last_load_ = now_load;
   last_load_time_ = now;
+  last_busy_time_ = busy_time_;
   load_timer_->activate(seconds(10));
 }
 
@@ -931,15 +993,53 @@ ClusterState* Worker::getClusterState() {
   return Worker::onThisThread()->processor_->cluster_state_.get();
 }
 
+namespace {
+// Adds the performance counters accumulated while running `context' to the
+// perf_* stats of its kind.
+void addPerfCounterStats(const RunContext& context,
+                         const PerfCounterValues& values) {
+#define PERF_STATS_ADD(kind)                                        \
+  do {                                                              \
+    WORKER_STAT_ADD(perf_cycles_##kind, values.cycles);             \
+    WORKER_STAT_ADD(perf_instructions_##kind, values.instructions); \
+    WORKER_STAT_ADD(perf_llc_misses_##kind, values.llc_misses);     \
+    WORKER_STAT_ADD(                                                \
+        perf_context_switches_##kind, values.context_switches);     \
+  } while (0)
+  switch (context.type_) {
+    case RunContext::MESSAGE:
+      PERF_STATS_ADD(messages);
+      break;
+    case RunContext::REQUEST:
+      PERF_STATS_ADD(requests);
+      break;
+    case RunContext::STORAGE_TASK_RESPONSE:
+      PERF_STATS_ADD(storage_task_responses);
+      break;
+    case RunContext::NONE:
+      PERF_STATS_ADD(other);
+      break;
+  }
+#undef PERF_STATS_ADD
+}
+} // namespace
+
 void Worker::onStoppedRunning(RunContext prev_context) {
   Worker* w = Worker::onThisThread();
   ld_check(w);
   std::chrono::steady_clock::time_point start_time;
   start_time = w->currentlyRunningStart_;
 
+  if (w->perfCounters_) {
+    PerfCounterValues now = w->perfCountersStart_;
+    w->perfCounters_->read(now);
+    addPerfCounterStats(prev_context, now - w->perfCountersStart_);
+  }
+
   setCurrentlyRunningContext(RunContext(), prev_context);
 
   auto end_time = w->currentlyRunningStart_;
+  w->busy_time_ += end_time - start_time;
   // Bumping the counters
   if (end_time - start_time >= settings().request_execution_delay_threshold) {
     RATELIMIT_WARNING(std::chrono::seconds(1),
@@ -994,6 +1094,10 @@ void Worker::onStoppedRunning(RunContext prev_context) {
 
 void Worker::onStartedRunning(RunContext new_context) {
   setCurrentlyRunningContext(new_context, RunContext());
+  Worker* w = Worker::onThisThread(false);
+  if (w && w->perfCounters_) {
+    w->perfCounters_->read(w->perfCountersStart_);
+  }
 }
 
 void Worker::activateIsolationTimer() {
@@ -1045,6 +1149,14 @@ Worker::packRunContext() {
     return std::make_tuple(
         RunContext(), std::chrono::steady_clock::duration(0));
   }
+  if (w->perfCounters_) {
+    // Account what the packed context ran so far now, so that the nested
+    // context isn't counted twice.
+    PerfCounterValues now = w->perfCountersStart_;
+    w->perfCounters_->read(now);
+    addPerfCounterStats(w->currentlyRunning_, now - w->perfCountersStart_);
+    w->perfCountersStart_ = now;
+  }
   auto res = std::make_tuple(
       w->currentlyRunning_,
       std::chrono::steady_clock::now() - w->currentlyRunningStart_);
@@ -1066,6 +1178,9 @@ void Worker::unpackRunContext(
   ld_check(w->currentlyRunning_.type_ == RunContext::Type::NONE);
   w->currentlyRunning_ = std::get<0>(s);
   w->currentlyRunningStart_ = std::chrono::steady_clock::now() - std::get<1>(s);
+  if (w->perfCounters_) {
+    w->perfCounters_->read(w->perfCountersStart_);
+  }
 }
 
 //
@@ -1156,6 +1271,10 @@ ClusterStateSubscriptionList& Worker::clusterStateSubscriptions() const {
   return impl_->clusterStateSubscriptions_;
 }
 
+ClusterStatePublisher& Worker::clusterStatePublisher() const {
+  return impl_->clusterStatePublisher_;
+}
+
 AppenderBuffer& Worker::appenderBuffer() const {
   return impl_->appenderBuffer_;
 }
@@ -1209,6 +1328,65 @@ SSLFetcher& Worker::sslFetcher() const {
   return impl_->sslFetcher_;
 }
 
+AppendAdmissionBatcher& Worker::appendAdmissionBatcher() const {
+  return impl_->appendAdmissionBatcher_;
+}
+
+StoreBatcher& Worker::storeBatcher() const {
+  return impl_->storeBatcher_;
+}
+
+SealBatcher& Worker::sealBatcher() const {
+  return impl_->sealBatcher_;
+}
+
+ReleaseBatcher& Worker::releaseBatcher() const {
+  return impl_->releaseBatcher_;
+}
+
+MutatedBatcher& Worker::mutatedBatcher() const {
+  return impl_->mutatedBatcher_;
+}
+
+GetSeqStateBatcher& Worker::getSeqStateBatcher() const {
+  return impl_->getSeqStateBatcher_;
+}
+
+TrimBatcher& Worker::trimBatcher() const {
+  return impl_->trimBatcher_;
+}
+
+LogQueryBatcher& Worker::logQueryBatcher() const {
+  return impl_->logQueryBatcher_;
+}
+
+TimerWheel& Worker::timerWheel() const {
+  if (!impl_->timerWheel_) {
+    Worker* w = const_cast<Worker*>(this);
+    impl_->timerWheelDriver_ =
+        std::make_unique<LibeventTimer>(w->getEventBase(), [this] {
+          // The driver is a LibeventTimer itself; the timers of the wheel
+          // set their own RunContexts.
+          auto prev_context = Worker::packRunContext();
+          impl_->timerWheel_->advance();
+          Worker::unpackRunContext(prev_context);
+        });
+    impl_->timerWheel_ = std::make_unique<TimerWheel>(
+        std::chrono::milliseconds(1),
+        [this](TimerWheel::Clock::time_point when) {
+          auto delay = std::max(when - TimerWheel::Clock::now(),
+                                TimerWheel::Clock::duration::zero());
+          impl_->timerWheelDriver_->activate(
+              std::chrono::duration_cast<std::chrono::microseconds>(delay));
+        });
+  }
+  return *impl_->timerWheel_;
+}
+
+ShardLatencyTracker& Worker::shardLatencyTracker() const {
+  return impl_->shardLatencyTracker_;
+}
+
 std::unique_ptr<SequencerBackgroundActivator>&
 Worker::sequencerBackgroundActivator() const {
   return impl_->sequencerBackgroundActivator_;
@@ -1353,6 +1531,38 @@ void Worker::addWithPriority(folly::Func func, int8_t priority) {
       priority);
 }
 
+void Worker::offloadCPUWork(folly::Func work, folly::Func done) {
+  ld_check(work);
+  ld_check(done);
+  CPUOffloadPool* pool = processor_->cpu_offload_pool_.get();
+  if (!pool) {
+    work();
+    done();
+    return;
+  }
+
+  auto& pending = impl_->offloadedCPUWork_;
+  const uint64_t seq = impl_->offloadedCPUWorkHead_ + pending.size();
+  pending.push_back({std::move(done)});
+  pool->add([this, seq, work = std::move(work)]() mutable {
+    work();
+    add([this, seq] {
+      auto& pending = impl_->offloadedCPUWork_;
+      ld_check(seq >= impl_->offloadedCPUWorkHead_);
+      ld_check(seq - impl_->offloadedCPUWorkHead_ < pending.size());
+      pending[seq - impl_->offloadedCPUWorkHead_].finished = true;
+      // Run the callbacks of everything submitted before the first work that
+      // hasn't finished. A callback may offload more work.
+      while (!pending.empty() && pending.front().finished) {
+        folly::Func cb = std::move(pending.front().done);
+        pending.pop_front();
+        ++impl_->offloadedCPUWorkHead_;
+        cb();
+      }
+    });
+  });
+}
+
 int Worker::forcePost(std::unique_ptr<Request>& req) {
   if (shutting_down_) {
     err = E::SHUTDOWN;
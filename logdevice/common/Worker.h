@@ -25,6 +25,7 @@
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/EventLoop.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
+#include "logdevice/common/PerfCounters.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/RunContext.h"
 #include "logdevice/common/ThreadID.h"
@@ -63,15 +64,17 @@ struct SocketConnectRequest;
 // Otherwise, the versions prefixed with "WORKER_LOG_STAT_" are more convenient.
 // This is a no-op if per-log configuration is not available locally which may
 // be the case in clients.
-#define LOG_STAT_ADD(stats, cluster_config, log_id, name, val)       \
-  do {                                                               \
-    const auto config_ = cluster_config;                             \
-    if (config_ && config_->logsConfig()->isLocal()) {               \
-      const auto log_path_opt_ = config_->getLogGroupPath(log_id);   \
-      if (log_path_opt_) {                                           \
-        LOG_GROUP_STAT_ADD(stats, log_path_opt_.value(), name, val); \
-      }                                                              \
-    }                                                                \
+#define LOG_STAT_ADD(stats, cluster_config, log_id, name, val)             \
+  do {                                                                     \
+    const auto config_ = cluster_config;                                   \
+    if (config_ && config_->logsConfig()->isLocal()) {                     \
+      LOG_ID_STAT_ADD(stats,                                               \
+                      log_id,                                              \
+                      config_->logsConfig()->getVersion(),                 \
+                      [&] { return config_->getLogGroupPath(log_id); },   \
+                      name,                                                \
+                      val);                                                \
+    }                                                                      \
   } while (0)
 
 #define LOG_STAT_SUB(stats, cluster_config, log_id, name, val) \
@@ -109,33 +112,44 @@ namespace facebook { namespace logdevice {
  */
 
 class AllClientReadStreams;
+class AppendAdmissionBatcher;
 class AppenderBuffer;
 class BufferedWriterShard;
 class ClusterState;
+class ClusterStatePublisher;
 class Configuration;
 class EpochRecovery;
 class EventLogStateMachine;
+class GetSeqStateBatcher;
 class GetSeqStateRequestMap;
+class LogQueryBatcher;
 class LogRebuildingInterface;
 class LogStorageState;
 class LogsConfig;
 class LogsConfigManager;
 class MessageDispatch;
 class MetaDataLogReader;
+class MutatedBatcher;
 class Mutator;
 class Processor;
 class RebuildingCoordinatorInterface;
+class ReleaseBatcher;
 class Request;
 class SSLFetcher;
 class Sender;
 class SequencerBackgroundActivator;
+class SealBatcher;
+class StoreBatcher;
 class ServerConfig;
 class ShapingContainer;
 class ShardAuthoritativeStatusManager;
+class ShardLatencyTracker;
 class SocketCallback;
 class StatsHolder;
 class SyncSequencerRequestList;
+class TimerWheel;
 class TraceLogger;
+class TrimBatcher;
 class UpdateableConfig;
 class WorkerImpl;
 class WorkerTimeoutStats;
@@ -351,7 +365,10 @@ class Worker : public WorkContext {
   // configuration settings to use
   UpdateableSettings<Settings> updateable_settings_;
 
-  // local copy of last settings fetched
+  // local copy of last settings fetched, refreshed by onSettingsUpdated().
+  // Code running on this Worker should read settings from here (or through
+  // settings()) rather than through updateable_settings_, which needs a
+  // version check on every access.
   std::shared_ptr<const Settings> immutable_settings_;
 
   const std::shared_ptr<TraceLogger> getTraceLogger() const;
@@ -469,6 +486,10 @@ class Worker : public WorkContext {
   // list of subscriptions to cluster state changes
   ClusterStateSubscriptionList& clusterStateSubscriptions() const;
 
+  // Clients connected to this Worker that get the cluster state pushed to
+  // them when it changes.
+  ClusterStatePublisher& clusterStatePublisher() const;
+
   // We keep track of the total size of allocated Appenders together with
   // corresponding APPEND_Messages and payloads.
   // Note: this is an atomic because Appenders can be destroyed on another
@@ -561,6 +582,43 @@ class Worker : public WorkContext {
   // SSL context fetcher, used to refresh certificate data
   SSLFetcher& sslFetcher() const;
 
+  // Starts Appenders for the same log created on this Worker together, with
+  // a range of LSNs reserved at once.
+  AppendAdmissionBatcher& appendAdmissionBatcher() const;
+
+  // Coalesces STOREs sent by Appenders on this Worker to the same node.
+  StoreBatcher& storeBatcher() const;
+
+  // Coalesces SEALs sent by LogRecoveryRequests on this Worker to the same
+  // node.
+  SealBatcher& sealBatcher() const;
+
+  // Coalesces RELEASEs sent by sequencers on this Worker to the same node.
+  ReleaseBatcher& releaseBatcher() const;
+
+  // Coalesces MUTATED replies sent by this storage Worker to the same
+  // sequencer node.
+  MutatedBatcher& mutatedBatcher() const;
+
+  // Coalesces GET_SEQ_STATEs sent by GetSeqStateRequests on this Worker to the
+  // same node.
+  GetSeqStateBatcher& getSeqStateBatcher() const;
+
+  // Coalesces TRIMs sent by batchable TrimRequests on this Worker to the same
+  // node.
+  TrimBatcher& trimBatcher() const;
+
+  // Coalesces IS_LOG_EMPTYs and DATA_SIZEs sent by batchable IsLogEmptyRequests
+  // and DataSizeRequests on this Worker to the same node.
+  LogQueryBatcher& logQueryBatcher() const;
+
+  // Per-shard STORE latency estimates for adaptive copyset selection.
+  ShardLatencyTracker& shardLatencyTracker() const;
+
+  // Timing wheel backing Timers created on this Worker when
+  // Settings::enable_worker_timer_wheel is set.  Created on first use.
+  TimerWheel& timerWheel() const;
+
   // Sequencer background activator, only runs on one worker
   std::unique_ptr<SequencerBackgroundActivator>&
   sequencerBackgroundActivator() const;
@@ -699,6 +757,11 @@ class Worker : public WorkContext {
   // Time when currentlyRunning_ was set
   std::chrono::steady_clock::time_point currentlyRunningStart_;
 
+  // Performance counters of this thread if --enable-perf-counters is set,
+  // and their values when currentlyRunning_ was set.
+  std::unique_ptr<ThreadPerfCounters> perfCounters_;
+  PerfCounterValues perfCountersStart_;
+
   // This should be called whenever the ServerConfig  has been updated.
   // Has to be called from the worker thread
   virtual void onServerConfigUpdated();
@@ -771,6 +834,19 @@ class Worker : public WorkContext {
   // Add to the executor with a given priority.
   void addWithPriority(folly::Func func, int8_t priority) override;
 
+  /**
+   * Runs `work' on the Processor's CPU offload pool (see CPUOffloadPool and
+   * --cpu-offload-threads), then `done' on this Worker. `done' callbacks run
+   * in the order offloadCPUWork() was called on this Worker, even if the
+   * work finishes out of order. `work' runs on another thread and must not
+   * touch anything owned by the Worker; `done' can, but must check that the
+   * objects it uses still exist.
+   *
+   * If the Processor has no CPU offload pool, runs both inline before
+   * returning.
+   */
+  void offloadCPUWork(folly::Func work, folly::Func done);
+
   /**
    * Post a request into Worker for execution. The post cannot fail with NOBUFS.
    * The priority of the request is embedded in the request instance. As of
@@ -799,6 +875,10 @@ class Worker : public WorkContext {
   // assignment
   void reportLoad();
 
+  // Called after reporting load. Subclasses may move work off this worker if
+  // it's loaded more than others.
+  virtual void rebalanceLoad() {}
+
   void disableSequencersDueIsolationTimeout();
 
   // Initializes subscriptions to config and setting updates
@@ -893,6 +973,11 @@ class Worker : public WorkContext {
   std::unique_ptr<Timer> load_timer_;
   int64_t last_load_ = -1;
   std::chrono::steady_clock::time_point last_load_time_;
+  // Total time spent running requests, message callbacks and storage task
+  // responses, i.e. in some RunContext, and its value at the last
+  // reportLoad(). Used to report event loop utilization.
+  std::chrono::steady_clock::duration busy_time_{0};
+  std::chrono::steady_clock::duration last_busy_time_{0};
   std::unique_ptr<Timer> isolation_timer_;
 
   std::unique_ptr<Timer> cluster_state_polling_;
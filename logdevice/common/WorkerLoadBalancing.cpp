@@ -72,4 +72,17 @@ worker_id_t WorkerLoadBalancing::selectWorker() {
   return worker_id_t(coinflip < prob ? index2 : index1);
 }
 
+double WorkerLoadBalancing::getRelativeLoad(worker_id_t idx) const {
+  ld_check(idx.val_ >= 0);
+  ld_check(idx.val_ < loads_.size());
+  int64_t total = 0;
+  for (const PaddedLoad& load : loads_) {
+    total += load.val.load();
+  }
+  if (total <= 0) {
+    return 0;
+  }
+  return double(loads_[idx.val_].val.load()) * loads_.size() / total;
+}
+
 }} // namespace facebook::logdevice
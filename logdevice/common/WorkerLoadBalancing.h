@@ -54,6 +54,14 @@ class WorkerLoadBalancing {
    */
   worker_id_t selectWorker();
 
+  /**
+   * @return  last load reported by worker `idx' divided by the average load
+   *          of all workers, or 0 if no load was reported.
+   *
+   * Thread-safe.
+   */
+  double getRelativeLoad(worker_id_t idx) const;
+
  private:
   struct PaddedLoad {
     std::atomic<int64_t> val{0};
@@ -7,12 +7,16 @@
  */
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
 
+#include <algorithm>
+
 #include <lz4.h>
 #include <zstd.h>
 
 #include <folly/Varint.h>
+#include <folly/lang/Bits.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/buffered_writer/ZstdDictionaries.h"
 #include "logdevice/common/debug.h"
 
 namespace facebook { namespace logdevice {
@@ -128,7 +132,15 @@ int BufferedWriteDecoderImpl::decodeOne(Slice blob,
   }
 
   flags_t flags;
-  if (decodeHeader(blob, &flags, nullptr) != 0) {
+  size_t batch_size;
+  if (decodeHeader(blob, &flags, &batch_size) != 0) {
+    return -1;
+  }
+  if ((flags & Flags::LENGTHS_COLUMN) && !(flags & Flags::SIZE_INCLUDED)) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Lengths column flag set without batch size, flags 0x%02x",
+                    flags);
     return -1;
   }
 
@@ -142,7 +154,7 @@ int BufferedWriteDecoderImpl::decodeOne(Slice blob,
         blob = Slice(buf.get(), blob.size);
       }
 
-      int rv = decodeUnowned(blob, payloads_out);
+      int rv = decodeUnowned(blob, flags, batch_size, payloads_out);
       if (rv == 0) {
         if (copy_blob_if_uncompressed) {
           pinned_buffers_.push_back(std::move(buf));
@@ -156,7 +168,8 @@ int BufferedWriteDecoderImpl::decodeOne(Slice blob,
     case Compression::ZSTD:
     case Compression::LZ4:
     case Compression::LZ4_HC: {
-      int rv = decodeCompressed(blob, compression, payloads_out);
+      int rv = decodeCompressed(
+          blob, compression, flags, batch_size, payloads_out);
       // If we succeeded, steal the DataRecordOwnsPayload from the client to
       // be consistent with the uncompressed case.
       if (rv == 0) {
@@ -193,9 +206,108 @@ int BufferedWriteDecoderImpl::getCompression(const DataRecord& record,
   return -1;
 }
 
+size_t BufferedWriteDecoderImpl::encodeLengthsColumn(
+    const std::vector<uint32_t>& lengths,
+    int bits,
+    uint8_t* out) {
+  ld_check(bits >= 0 && bits <= 32);
+  const size_t column_size = lengthsColumnSize(lengths.size(), bits);
+  *out++ = bits;
+  memset(out, 0, column_size - 1);
+  size_t bit = 0;
+  for (uint32_t len : lengths) {
+    ld_check(lengthBits(len) <= bits);
+    uint64_t v = uint64_t(len) << (bit % 8);
+    // A length straddles at most 5 bytes (32 bits shifted by up to 7).
+    for (uint8_t* p = out + bit / 8; v != 0; ++p, v >>= 8) {
+      *p |= uint8_t(v);
+    }
+    bit += bits;
+  }
+  return column_size;
+}
+
+int BufferedWriteDecoderImpl::decodeLengthsColumn(
+    const Slice& slice,
+    size_t batch_size,
+    std::vector<Payload>& payloads_out) {
+  const uint8_t *ptr = (const uint8_t*)slice.data, *end = ptr + slice.size;
+  if (ptr == end) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Reached end looking for lengths column bit width");
+    return -1;
+  }
+  const int bits = *ptr++;
+  if (bits > 32) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Invalid lengths column bit width %d",
+                    bits);
+    return -1;
+  }
+  if (batch_size > MAX_PAYLOAD_SIZE_INTERNAL) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Batch size %zu in header is too large",
+                    batch_size);
+    return -1;
+  }
+  const size_t column_bytes = lengthsColumnSize(batch_size, bits) - 1;
+  if (column_bytes > size_t(end - ptr)) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Lengths column needs %zu bytes but only %zd are left",
+                    column_bytes,
+                    end - ptr);
+    return -1;
+  }
+  const uint8_t* column = ptr;
+  const uint8_t* data = ptr + column_bytes;
+  const size_t data_size = end - data;
+
+  // Every length is extracted with one unaligned 64-bit load and a shift, so
+  // unlike the varint format there is no per-byte loop or branching on the
+  // encoding; the running offset is a plain prefix sum over the lengths.
+  const uint64_t mask = (uint64_t(1) << bits) - 1;
+  payloads_out.reserve(payloads_out.size() + batch_size);
+  uint64_t offset = 0;
+  for (size_t i = 0; i < batch_size; ++i) {
+    const size_t bit = i * bits;
+    const size_t byte = bit / 8;
+    uint64_t word = 0;
+    memcpy(&word, column + byte, std::min<size_t>(8, column_bytes - byte));
+    const uint64_t len = (folly::Endian::little(word) >> (bit % 8)) & mask;
+    if (len > data_size - offset) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      1,
+                      "Expected %lu more bytes based on lengths column but "
+                      "there are only %zu left",
+                      len,
+                      data_size - offset);
+      return -1;
+    }
+    payloads_out.push_back(Payload(data + offset, len));
+    offset += len;
+  }
+  if (offset != data_size) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "%zu trailing bytes after the last payload",
+                    size_t(data_size - offset));
+    return -1;
+  }
+  return 0;
+}
+
 int BufferedWriteDecoderImpl::decodeUnowned(
     const Slice& slice,
+    flags_t flags,
+    size_t batch_size,
     std::vector<Payload>& payloads_out) {
+  if (flags & Flags::LENGTHS_COLUMN) {
+    return decodeLengthsColumn(slice, batch_size, payloads_out);
+  }
   const uint8_t *ptr = (const uint8_t*)slice.data, *end = ptr + slice.size;
   for (; ptr < end;) {
     uint64_t len;
@@ -226,6 +338,8 @@ int BufferedWriteDecoderImpl::decodeUnowned(
 int BufferedWriteDecoderImpl::decodeCompressed(
     const Slice& slice,
     const Compression compression,
+    flags_t flags,
+    size_t batch_size,
     std::vector<Payload>& payloads_out) {
   const uint8_t *ptr = (const uint8_t*)slice.data, *end = ptr + slice.size;
 
@@ -251,13 +365,54 @@ int BufferedWriteDecoderImpl::decodeCompressed(
     return -1;
   }
 
+  std::shared_ptr<const ZstdDictionaries::Dictionary> dict;
+  if (flags & Flags::ZSTD_DICTIONARY) {
+    if (compression != Compression::ZSTD) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      1,
+                      "Dictionary flag set on a blob with compression %d",
+                      (int)compression);
+      return -1;
+    }
+    uint64_t dict_id;
+    try {
+      folly::ByteRange range(ptr, end);
+      dict_id = folly::decodeVarint(range);
+      ptr = range.begin();
+    } catch (...) {
+      RATELIMIT_ERROR(std::chrono::seconds(1), 1, "Failed to decode varint");
+      return -1;
+    }
+    dict = ZstdDictionaries::get().find(dict_id);
+    if (!dict) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      1,
+                      "Blob was compressed with zstd dictionary %lu which is "
+                      "not registered in this process",
+                      dict_id);
+      return -1;
+    }
+  }
+
   ld_spew("decompressing blob of size %ld", end - ptr);
   std::unique_ptr<uint8_t[]> buf(new uint8_t[uncompressed_size]);
   if (compression == Compression::ZSTD) {
-    size_t rv = ZSTD_decompress(buf.get(),         // dst
-                                uncompressed_size, // dstCapacity
-                                ptr,               // src
-                                end - ptr);        // compressedSize
+    size_t rv;
+    if (dict) {
+      static thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)>
+          dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+      rv = ZSTD_decompress_usingDDict(dctx.get(),
+                                      buf.get(),         // dst
+                                      uncompressed_size, // dstCapacity
+                                      ptr,               // src
+                                      end - ptr,         // compressedSize
+                                      dict->ddict());
+    } else {
+      rv = ZSTD_decompress(buf.get(),         // dst
+                           uncompressed_size, // dstCapacity
+                           ptr,               // src
+                           end - ptr);        // compressedSize
+    }
     if (ZSTD_isError(rv)) {
       RATELIMIT_ERROR(std::chrono::seconds(1),
                       1,
@@ -297,7 +452,10 @@ int BufferedWriteDecoderImpl::decodeCompressed(
     }
   }
 
-  if (decodeUnowned(Slice(buf.get(), uncompressed_size), payloads_out) != 0) {
+  if (decodeUnowned(Slice(buf.get(), uncompressed_size),
+                    flags,
+                    batch_size,
+                    payloads_out) != 0) {
     return -1;
   }
 
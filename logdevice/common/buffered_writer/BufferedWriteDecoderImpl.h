@@ -30,8 +30,36 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
     // A flag bit which indicates that the blob composed by BufferedWriter
     // contains the size of the batch before individual payloads.
     static constexpr flags_t SIZE_INCLUDED = 1 << 3;
+    // A flag bit which indicates that, instead of prefixing every payload
+    // with a varint length, the (possibly compressed) body of the blob starts
+    // with a column of all payload lengths followed by the payloads back to
+    // back.  The column is a 1-byte bit width W followed by batch size
+    // W-bit lengths packed LSB-first.  Requires SIZE_INCLUDED.
+    static constexpr flags_t LENGTHS_COLUMN = 1 << 4;
+    // Only valid with ZSTD compression.  Indicates that the uncompressed
+    // size varint is followed by a varint ID of the zstd dictionary (see
+    // ZstdDictionaries) the batch was compressed with.
+    static constexpr flags_t ZSTD_DICTIONARY = 1 << 5;
   };
 
+  // Number of bits needed to represent `len' in the lengths column.
+  static int lengthBits(uint64_t len) {
+    return len == 0 ? 0 : 64 - __builtin_clzll(len);
+  }
+
+  // Size in bytes of a lengths column (including the bit width byte) for
+  // `count' lengths of `bits' bits each.
+  static size_t lengthsColumnSize(size_t count, int bits) {
+    return 1 + (count * bits + 7) / 8;
+  }
+
+  // Writes a lengths column for `lengths' into `out', which must have room
+  // for lengthsColumnSize(lengths.size(), bits) bytes. All lengths must fit
+  // in `bits' bits.  Returns the number of bytes written.
+  static size_t encodeLengthsColumn(const std::vector<uint32_t>& lengths,
+                                    int bits,
+                                    uint8_t* out);
+
   int decode(std::vector<std::unique_ptr<DataRecord>>&& records,
              std::vector<Payload>& payloads_out);
   // Decodes a single DataRecord.  Claims ownership of the DataRecord if
@@ -61,12 +89,21 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
 
  private:
   // Decodes an uncompressed blob without claiming ownership of the memory.
-  int decodeUnowned(const Slice& slice, std::vector<Payload>& payloads_out);
+  int decodeUnowned(const Slice& slice,
+                    flags_t flags,
+                    size_t batch_size,
+                    std::vector<Payload>& payloads_out);
+  // Decodes the body of a blob in the LENGTHS_COLUMN format.
+  int decodeLengthsColumn(const Slice& slice,
+                          size_t batch_size,
+                          std::vector<Payload>& payloads_out);
   // Decodes a compressed blob.  In case of successful decoding, adds the
   // buffer containing uncompressed data to pinned_buffers_; the source
   // DataRecord is no longer needed.
   int decodeCompressed(const Slice& slice,
                        BufferedWriter::Options::Compression compression,
+                       flags_t flags,
+                       size_t batch_size,
                        std::vector<Payload>& payloads_out);
 
   // DataRecord instances we decoded and assumed ownership of from the client
@@ -7,6 +7,9 @@
  */
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 
+#include <iterator>
+#include <mutex>
+
 #include <folly/Memory.h>
 #include <folly/hash/Hash.h>
 
@@ -273,19 +276,29 @@ void BufferedWriterImpl::shutDown() {
   postToAllWorkersAndBlockUntilDone<DestroyShardRequest>();
 }
 
+struct BufferedWriterImpl::StagingBuffer {
+  std::mutex mutex;
+  // Chunks in the order they were staged, with their `atomic' flags.
+  // Consecutive non-atomic chunks are merged.
+  std::vector<std::pair<BufferedWriterShard::AppendChunk, bool>> chunks;
+  // Set while a DrainStagingRequest for this buffer is queued.  The buffer is
+  // never non-empty without one.
+  bool drain_pending = false;
+};
+
 namespace {
-// Transfers an AppendChunk to a Worker for processing
-class BufferedAppendRequest : public Request {
+// Transfers the appends staged by a producer thread to a Worker for
+// processing
+class DrainStagingRequest : public Request {
  public:
-  BufferedAppendRequest(worker_id_t worker,
-                        buffered_writer_id_t id,
-                        BufferedWriterShard::AppendChunk appends,
-                        bool atomic)
+  DrainStagingRequest(
+      worker_id_t worker,
+      buffered_writer_id_t id,
+      std::shared_ptr<BufferedWriterImpl::StagingBuffer> buffer)
       : Request(RequestType::BUFFERED_WRITER_APPEND),
         worker_(worker),
         id_(id),
-        appends_(std::move(appends)),
-        atomic_(atomic) {}
+        buffer_(std::move(buffer)) {}
 
   int getThreadAffinity(int /*nthreads*/) override {
     return worker_.val_;
@@ -296,6 +309,14 @@ class BufferedAppendRequest : public Request {
   }
 
   Execution execute() override {
+    std::vector<std::pair<BufferedWriterShard::AppendChunk, bool>> chunks;
+    {
+      std::lock_guard<std::mutex> guard(buffer_->mutex);
+      ld_check(buffer_->drain_pending);
+      chunks.swap(buffer_->chunks);
+      buffer_->drain_pending = false;
+    }
+
     Worker* w = Worker::onThisThread();
     auto it = w->active_buffered_writers_.find(id_);
     if (it == w->active_buffered_writers_.end()) {
@@ -310,24 +331,72 @@ class BufferedAppendRequest : public Request {
     }
 
     BufferedWriterShard* shard = it->second;
-    shard->append(std::move(appends_), atomic_);
+    for (auto& chunk : chunks) {
+      shard->append(std::move(chunk.first), chunk.second);
+    }
     return Execution::COMPLETE;
   }
 
-  // If the Request failed to get posted, this allows the payloads to be
-  // transferred back to the client
-  BufferedWriterShard::AppendChunk releaseChunk() {
-    return std::move(appends_);
-  }
-
  private:
   worker_id_t worker_;
   buffered_writer_id_t id_;
-  BufferedWriterShard::AppendChunk appends_;
-  bool atomic_;
+  std::shared_ptr<BufferedWriterImpl::StagingBuffer> buffer_;
 };
 } // namespace
 
+int BufferedWriterImpl::postChunk(int shard_idx,
+                                  BufferedWriterShard::AppendChunk& chunk,
+                                  bool atomic,
+                                  size_t payload_bytes) {
+  // Only the first chunk staged into an empty buffer posts a request to the
+  // Worker.  Chunks staged before that request runs are picked up by it too,
+  // so a producer that outpaces the Worker pays for one request per
+  // sub-batch rather than per append, without waiting for any timer.  Chunks
+  // from one thread are handed over in the order they were staged.
+  auto& buffers = *staging_;
+  if (buffers.empty()) {
+    buffers.resize(shards_.size());
+  }
+  std::shared_ptr<StagingBuffer>& buffer = buffers[shard_idx];
+  if (!buffer) {
+    buffer = std::make_shared<StagingBuffer>();
+  }
+
+  bool post;
+  {
+    std::lock_guard<std::mutex> guard(buffer->mutex);
+    post = !buffer->drain_pending;
+    buffer->drain_pending = true;
+    if (!atomic && !buffer->chunks.empty() && !buffer->chunks.back().second) {
+      auto& staged = buffer->chunks.back().first;
+      staged.insert(staged.end(),
+                    std::make_move_iterator(chunk.begin()),
+                    std::make_move_iterator(chunk.end()));
+    } else {
+      buffer->chunks.emplace_back(std::move(chunk), atomic);
+    }
+  }
+  append_sink_->onBytesSentToWorker(payload_bytes);
+  if (!post) {
+    return 0;
+  }
+
+  std::unique_ptr<Request> req = std::make_unique<DrainStagingRequest>(
+      worker_id_t(shard_idx), shards_[shard_idx], buffer);
+  int rv = processor()->postRequest(req);
+  if (rv != 0) {
+    // Failed to queue the request.  The buffer was empty, so `chunk' is all
+    // it has; give it back to the caller.
+    append_sink_->onBytesSentToWorker(-ssize_t(payload_bytes));
+    std::lock_guard<std::mutex> guard(buffer->mutex);
+    ld_check(buffer->chunks.size() == 1);
+    chunk = std::move(buffer->chunks.front().first);
+    buffer->chunks.clear();
+    buffer->drain_pending = false;
+  }
+  return rv;
+}
+
 // Helper function shared by two append()s so that it's a single logging
 // callsite
 static void log_memory_limit_exceeded(int memory_limit_mb) {
@@ -357,7 +426,7 @@ int BufferedWriterImpl::append(logid_t log_id,
     return -1;
   }
 
-  // Post a BufferedAppendRequest to the appropriate Worker.
+  // Hand the append to the appropriate Worker.
   int shard_idx = mapLogToShardIndex(log_id);
 
   Status shard_status = append_sink_->canSendToWorker();
@@ -370,19 +439,9 @@ int BufferedWriterImpl::append(logid_t log_id,
   BufferedWriterShard::AppendChunk chunk;
   chunk.emplace_back(
       log_id, std::move(payload), std::move(cb_context), std::move(attrs));
-  std::unique_ptr<Request> req =
-      std::make_unique<BufferedAppendRequest>(worker_id_t(shard_idx),
-                                              shards_[shard_idx],
-                                              std::move(chunk),
-                                              /* atomic */ false);
-  append_sink_->onBytesSentToWorker(payload_size);
-  int rv = processor()->postRequest(req);
+  int rv = postChunk(shard_idx, chunk, /* atomic */ false, payload_size);
   if (rv != 0) {
     // Failed to queue the append.  Return the payload to the caller.
-    append_sink_->onBytesSentToWorker(-payload_size);
-    BufferedAppendRequest* rawreq =
-        static_cast<BufferedAppendRequest*>(req.get());
-    chunk = rawreq->releaseChunk();
     ld_check(chunk.size() == 1);
     payload = std::move(chunk.front().payload);
     attrs = std::move(chunk.front().attrs);
@@ -449,16 +508,8 @@ int BufferedWriterImpl::appendAtomic(logid_t log_id,
     chunks.emplace_back(std::move(append));
   }
 
-  std::unique_ptr<Request> req = std::make_unique<BufferedAppendRequest>(
-      worker_id_t(shard), shards_[shard], std::move(chunks), true);
-  append_sink_->onBytesSentToWorker(append_sizes);
-  int rv = processor()->postRequest(req);
+  int rv = postChunk(shard, chunks, /* atomic */ true, append_sizes);
   if (rv != 0) {
-    // Failed to queue the append.  Return the payload to the caller.
-    append_sink_->onBytesSentToWorker(-append_sizes);
-    BufferedAppendRequest* rawreq =
-        static_cast<BufferedAppendRequest*>(req.get());
-    chunks = rawreq->releaseChunk();
     // err set by postRequest
     return -1;
   }
@@ -530,24 +581,11 @@ BufferedWriterImpl::appendImpl(std::vector<Append>&& input_appends,
       chunk_status[i] = E::OK;
       continue;
     }
-    // Post a BufferedAppendRequest to process this shard's chunk on the
-    // appropriate Worker.
-    std::unique_ptr<Request> req = std::make_unique<BufferedAppendRequest>(
-        worker_id_t(i), shards_[i], std::move(chunks[i]), atomic);
-    append_sink_->onBytesSentToWorker(shard_append_sizes[i]);
-    int rv = processor()->postRequest(req);
-    if (rv == 0) {
-      chunk_status[i] = E::OK;
-    } else {
-      // Failure!  Take the chunk back so that we can restore payloads in the
-      // input vector for all affected appends.
-      chunk_status[i] = err;
-      BufferedAppendRequest* rawreq =
-          static_cast<BufferedAppendRequest*>(req.get());
-      chunks[i] = rawreq->releaseChunk();
-      // rewinding the counter
-      append_sink_->onBytesSentToWorker(-shard_append_sizes[i]);
-    }
+    // Hand this shard's chunk to the appropriate Worker.  On failure,
+    // postChunk() gives the chunk back so that we can restore payloads in the
+    // input vector for all affected appends.
+    int rv = postChunk(i, chunks[i], atomic, shard_append_sizes[i]);
+    chunk_status[i] = rv == 0 ? E::OK : err;
   }
 
   // Iterating backwards so that we can repopulate the input vector for any
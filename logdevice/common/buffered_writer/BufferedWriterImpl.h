@@ -9,8 +9,12 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <memory>
+#include <vector>
 
 #include <folly/Preprocessor.h>
+#include <folly/ThreadLocal.h>
+#include <folly/small_vector.h>
 
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/BufferedWriter.h"
@@ -217,6 +221,9 @@ class BufferedWriterImpl : public BufferedWriter {
   // They must all belong to the same log specified by @param log_id.
   int appendAtomic(logid_t log_id, std::vector<Append>&& appends);
 
+  // Appends staged by one producer thread for one shard, see postChunk().
+  struct StagingBuffer;
+
   // Thread-safe memory budgeting functions.  If a memory limit was configured
   // by the client via Options::memory_limit_mb, append() calls acquire memory
   // which gets released when the writes finish.
@@ -320,6 +327,15 @@ class BufferedWriterImpl : public BufferedWriter {
   // implementation of append(vector)
   std::vector<Status> appendImpl(std::vector<Append>&& appends, bool atomic);
 
+  // Hands a chunk of appends for logs of shard `shard_idx' to its Worker,
+  // through this thread's staging buffer for the shard.  On failure, returns
+  // -1 with err set by Processor::postRequest(), and `chunk' holds the
+  // appends again.
+  int postChunk(int shard_idx,
+                folly::small_vector<Append, 4>& chunk,
+                bool atomic,
+                size_t payload_bytes);
+
   template <typename RequestClass>
   void postToAllWorkersAndBlockUntilDone();
 
@@ -340,6 +356,10 @@ class BufferedWriterImpl : public BufferedWriter {
   // thread pool.
   std::vector<buffered_writer_id_t> shards_;
 
+  // Staging buffers of the calling thread, indexed by shard.  Created
+  // lazily.
+  folly::ThreadLocal<std::vector<std::shared_ptr<StagingBuffer>>> staging_;
+
   // Memory available in bytes, applies if Options::memory_limit_mb is set.
   // This will be modified from multiple threads in a ticket-dispenser
   // fashion, so it gets its own cache line to avoid interference with
@@ -85,6 +85,17 @@ void describeBufferedWriterOptions(options_description& po,
           }),
       "Algorithm to use for client-side compression in Buffered writer. 'none' "
       "for no compression. Supported values: 'zstd', 'lz4', 'lz4_hc'.");
+  po.add_options()((prefix + "payload-lengths-column").c_str(),
+                   value<bool>(&opts->payload_lengths_column)
+                       ->default_value(opts->payload_lengths_column),
+                   "Store payload lengths in a bit-packed column ahead of the "
+                   "payloads. Cheaper to decode but not readable by older "
+                   "clients.");
+  po.add_options()((prefix + "zstd-dictionary-id").c_str(),
+                   value<uint32_t>(&opts->zstd_dictionary_id)
+                       ->default_value(opts->zstd_dictionary_id),
+                   "ID of the registered zstd dictionary to compress batches "
+                   "with when compression is zstd. 0 for no dictionary.");
   po.add_options()((prefix + "memory-limit-mb").c_str(),
                    value<int32_t>(&opts->memory_limit_mb)
                        ->default_value(opts->memory_limit_mb),
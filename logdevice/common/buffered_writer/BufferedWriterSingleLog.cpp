@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/buffered_writer/BufferedWriterSingleLog.h"
 
+#include <algorithm>
 #include <chrono>
 #include <lz4.h>
 #include <lz4hc.h>
@@ -27,6 +28,7 @@
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterShard.h"
+#include "logdevice/common/buffered_writer/ZstdDictionaries.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
 
@@ -273,6 +275,9 @@ void BufferedWriterSingleLog::sendBatch(Batch& batch) {
 
     batch_flags_t flags = Flags::SIZE_INCLUDED |
         (batch_flags_t(options_.compression) & Flags::COMPRESSION_MASK);
+    if (options_.payload_lengths_column) {
+      flags |= Flags::LENGTHS_COLUMN;
+    }
 
     setBatchState(batch, Batch::State::CONSTRUCTING_BLOB);
     construct_blob(batch, flags, checksumBits(), options_.destroy_payloads);
@@ -596,6 +601,29 @@ void BufferedWriterSingleLog::Impl::construct_uncompressed_blob(
   batch.blob_header_size += 2;
   *out++ = 0xb1;
   ld_check(out < end);
+  std::vector<uint32_t> lengths;
+  int length_bits = 0;
+  if (flags & Flags::LENGTHS_COLUMN) {
+    ld_check(flags & Flags::SIZE_INCLUDED);
+    // blob_bytes_total budgeted a varint per payload.  The column is usually
+    // smaller, but a single large payload in a batch of tiny ones can make it
+    // bigger; fall back to varints for such batches.
+    size_t varint_bytes = 0;
+    lengths.reserve(batch.appends.size());
+    for (const auto& append : batch.appends) {
+      const size_t len = append.second.size();
+      const int bits = BufferedWriteDecoderImpl::lengthBits(len);
+      varint_bytes += bits == 0 ? 1 : (bits + 6) / 7;
+      length_bits = std::max(length_bits, bits);
+      lengths.push_back(len);
+    }
+    if (BufferedWriteDecoderImpl::lengthsColumnSize(
+            lengths.size(), length_bits) > varint_bytes) {
+      flags &= ~Flags::LENGTHS_COLUMN;
+      lengths.clear();
+    }
+  }
+
   // Adjust flags to indicate no compression for now; maybe_compress_blob() will
   // overwrite it if it decides to compress.
   *out++ = (batch_flags_t)BufferedWriter::Options::Compression::NONE |
@@ -608,11 +636,19 @@ void BufferedWriterSingleLog::Impl::construct_uncompressed_blob(
     batch.blob_header_size += batch_size_varint_len;
     ld_check(out <= end);
   }
+  const bool lengths_column = flags & Flags::LENGTHS_COLUMN;
+  if (lengths_column) {
+    out += BufferedWriteDecoderImpl::encodeLengthsColumn(
+        lengths, length_bits, out);
+    ld_check(out <= end);
+  }
   for (auto& append : batch.appends) {
     const std::string& client_payload = append.second;
-    size_t len = folly::encodeVarint(client_payload.size(), out);
-    out += len;
-    ld_check(out <= end);
+    if (!lengths_column) {
+      size_t len = folly::encodeVarint(client_payload.size(), out);
+      out += len;
+      ld_check(out <= end);
+    }
     ld_check((ssize_t)(end - out) >= (ssize_t)client_payload.size());
     memcpy(out, client_payload.data(), client_payload.size());
     out += client_payload.size();
@@ -625,8 +661,13 @@ void BufferedWriterSingleLog::Impl::construct_uncompressed_blob(
     }
   }
   // Assert that the running count (batch.blob_bytes_total) was accurate, taking
-  // into account that we didn't use all the bytes we'd reserved for the varint.
-  ld_check(out + (folly::kMaxVarintLength64 - batch_size_varint_len) == end);
+  // into account that we didn't use all the bytes we'd reserved for the varint
+  // and that the lengths column may be smaller than the per-payload varints.
+  if (lengths_column) {
+    ld_check(out + (folly::kMaxVarintLength64 - batch_size_varint_len) <= end);
+  } else {
+    ld_check(out + (folly::kMaxVarintLength64 - batch_size_varint_len) == end);
+  }
   batch.blob = Slice(blob_buf.get(), out - blob_buf.get());
   batch.blob_buf = std::move(blob_buf);
 }
@@ -635,11 +676,24 @@ void BufferedWriterSingleLog::Impl::maybe_compress_blob(
     BufferedWriterSingleLog::Batch& batch,
     Compression compression,
     int checksum_bits,
-    const int zstd_level) {
+    const int zstd_level,
+    uint32_t zstd_dictionary_id) {
   if (compression == Compression::NONE) {
     // Nothing to do.
     return;
   }
+  std::shared_ptr<const ZstdDictionaries::Dictionary> dict;
+  if (compression == Compression::ZSTD && zstd_dictionary_id != 0) {
+    dict = ZstdDictionaries::get().find(zstd_dictionary_id);
+    if (!dict) {
+      RATELIMIT_WARNING(std::chrono::seconds(10),
+                        1,
+                        "zstd dictionary %u is not registered, compressing "
+                        "without a dictionary",
+                        zstd_dictionary_id);
+    }
+  }
+  const ZSTD_CDict* cdict = dict ? dict->cdict(zstd_level) : nullptr;
   ld_check(compression == Compression::ZSTD ||
            compression == Compression::LZ4 ||
            compression == Compression::LZ4_HC);
@@ -656,7 +710,8 @@ void BufferedWriterSingleLog::Impl::maybe_compress_blob(
 
   const size_t compressed_buf_size = batch.blob_header_size + // header
       folly::kMaxVarintLength64 + // uncompressed length
-      compressed_data_bound       // compressed bytes
+      (cdict ? folly::kMaxVarintLength64 : 0) + // dictionary ID
+      compressed_data_bound                     // compressed bytes
       ;
   std::unique_ptr<uint8_t[]> compress_buf(new uint8_t[compressed_buf_size]);
   uint8_t* out = compress_buf.get();
@@ -665,14 +720,35 @@ void BufferedWriterSingleLog::Impl::maybe_compress_blob(
   // Copy the header from batch.blob and set the compression flag
   memcpy(out, batch.blob.data, batch.blob_header_size);
   out[checksum_bits / 8 + 1] |= (uint8_t)compression & Flags::COMPRESSION_MASK;
+  if (cdict) {
+    out[checksum_bits / 8 + 1] |= Flags::ZSTD_DICTIONARY;
+  }
   out += batch.blob_header_size;
 
   // Append uncompressed size so that the decoding path knows how much memory
   // to allocate
   out += folly::encodeVarint(to_compress.size, out);
+  if (cdict) {
+    out += folly::encodeVarint(dict->id(), out);
+  }
 
   size_t compressed_size;
-  if (compression == Compression::ZSTD) {
+  if (compression == Compression::ZSTD && cdict) {
+    static thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)>
+        cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    compressed_size = ZSTD_compress_usingCDict(cctx.get(),
+                                               out,              // dst
+                                               end - out,        // dstCapacity
+                                               to_compress.data, // src
+                                               to_compress.size, // srcSize
+                                               cdict);
+    if (ZSTD_isError(compressed_size)) {
+      ld_error("ZSTD_compress_usingCDict() failed: %s",
+               ZSTD_getErrorName(compressed_size));
+      ld_check(false);
+      return;
+    }
+  } else if (compression == Compression::ZSTD) {
     compressed_size = ZSTD_compress(out,              // dst
                                     end - out,        // dstCapacity
                                     to_compress.data, // src
@@ -716,14 +792,16 @@ void BufferedWriterSingleLog::Impl::construct_blob_long_running(
     batch_flags_t flags,
     int checksum_bits,
     bool destroy_payloads,
-    const int zstd_level) {
+    const int zstd_level,
+    uint32_t zstd_dictionary_id) {
   ld_check(batch.state == Batch::State::CONSTRUCTING_BLOB);
 
   construct_uncompressed_blob(batch, flags, checksum_bits, destroy_payloads);
   maybe_compress_blob(batch,
                       (Compression)(flags & Flags::COMPRESSION_MASK),
                       checksum_bits,
-                      zstd_level);
+                      zstd_level,
+                      zstd_dictionary_id);
 
   if (checksum_bits > 0) {
     // construct_uncompressed_blob() left this many bytes at the front to put
@@ -749,6 +827,7 @@ void BufferedWriterSingleLog::construct_blob(
   }
 
   const int zstd_level = Worker::settings().buffered_writer_zstd_level;
+  const uint32_t zstd_dictionary_id = options_.zstd_dictionary_id;
 
   // We need to call construct_blob_long_running(), then callback().  If the
   // batch is large, we send it to a background thread so that this thread can
@@ -757,8 +836,12 @@ void BufferedWriterSingleLog::construct_blob(
 
   if (batch.blob_bytes_total <
       Worker::settings().buffered_writer_bg_thread_bytes_threshold) {
-    Impl::construct_blob_long_running(
-        batch, flags, checksum_bits, destroy_payloads, zstd_level);
+    Impl::construct_blob_long_running(batch,
+                                      flags,
+                                      checksum_bits,
+                                      destroy_payloads,
+                                      zstd_level,
+                                      zstd_dictionary_id);
     readyToSend(batch);
   } else {
     ProcessorProxy* processor_proxy = parent_->parent_->processorProxy();
@@ -778,9 +861,15 @@ void BufferedWriterSingleLog::construct_blob(
          trigger = parent_->parent_->getBackgroundTaskCountHolder(),
          thread_affinity = Worker::onThisThread()->idx_.val(),
          zstd_level,
+         zstd_dictionary_id,
          this]() mutable {
           BufferedWriterSingleLog::Impl::construct_blob_long_running(
-              batch, flags, checksum_bits, destroy_payloads, zstd_level);
+              batch,
+              flags,
+              checksum_bits,
+              destroy_payloads,
+              zstd_level,
+              zstd_dictionary_id);
           std::unique_ptr<Request> request =
               std::make_unique<ContinueBlobSendRequest>(
                   this, batch, thread_affinity);
@@ -161,15 +161,18 @@ class BufferedWriterSingleLog {
                                 BufferedWriteDecoderImpl::flags_t flags,
                                 int checksum_bits,
                                 bool destroy_payloads,
-                                int zstd_level);
+                                int zstd_level,
+                                uint32_t zstd_dictionary_id = 0);
 
     // Possibly long running.  Checks conditions for compression, and if
-    // satisfied, compresses.
+    // satisfied, compresses.  A non-zero `zstd_dictionary_id' selects a
+    // dictionary registered with ZstdDictionaries for ZSTD compression.
     static void
     maybe_compress_blob(Batch& batch,
                         BufferedWriter::Options::Compression compression,
                         int checksum_bits,
-                        int zstd_level);
+                        int zstd_level,
+                        uint32_t zstd_dictionary_id = 0);
     // Constructs a blob from a batch.  Copies the data, so is therefore
     // potentially long running.
     static void
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/buffered_writer/ZstdDictionaries.h"
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <zstd.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+ZstdDictionaries::Dictionary::~Dictionary() {
+  ZSTD_freeDDict(ddict_);
+  for (auto& kv : cdicts_) {
+    ZSTD_freeCDict(kv.second);
+  }
+}
+
+const ZSTD_CDict* ZstdDictionaries::Dictionary::cdict(int level) const {
+  std::lock_guard<std::mutex> lock(cdicts_mutex_);
+  auto it = cdicts_.find(level);
+  if (it != cdicts_.end()) {
+    return it->second;
+  }
+  ZSTD_CDict* cdict = ZSTD_createCDict(raw_.data(), raw_.size(), level);
+  if (cdict == nullptr) {
+    return nullptr;
+  }
+  cdicts_.emplace(level, cdict);
+  return cdict;
+}
+
+ZstdDictionaries& ZstdDictionaries::get() {
+  // Leaked so that it outlives any thread still decoding during shutdown.
+  static ZstdDictionaries* instance = new ZstdDictionaries();
+  return *instance;
+}
+
+int ZstdDictionaries::add(std::string raw) {
+  const uint32_t id = ZSTD_getDictID_fromDict(raw.data(), raw.size());
+  if (id == 0) {
+    ld_error("Not a zstd dictionary or dictionary has no ID (size %zu)",
+             raw.size());
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  if (dicts_.rlock()->count(id)) {
+    return 0;
+  }
+  ZSTD_DDict* ddict = ZSTD_createDDict(raw.data(), raw.size());
+  if (ddict == nullptr) {
+    err = E::NOMEM;
+    return -1;
+  }
+  std::shared_ptr<const Dictionary> dict(
+      new Dictionary(id, std::move(raw), ddict));
+  dicts_.wlock()->emplace(id, std::move(dict));
+  ld_info("Registered zstd dictionary %u", id);
+  return 0;
+}
+
+int ZstdDictionaries::loadDirectory(const std::string& dir) {
+  namespace fs = boost::filesystem;
+  int loaded = 0;
+  try {
+    for (const auto& entry : fs::directory_iterator(dir)) {
+      if (!fs::is_regular_file(entry.status())) {
+        continue;
+      }
+      std::string raw;
+      if (!folly::readFile(entry.path().string().c_str(), raw)) {
+        ld_error("Failed to read zstd dictionary %s: %s",
+                 entry.path().string().c_str(),
+                 strerror(errno));
+        return -1;
+      }
+      if (add(std::move(raw)) != 0) {
+        ld_error("Invalid zstd dictionary %s", entry.path().string().c_str());
+        return -1;
+      }
+      ++loaded;
+    }
+  } catch (const fs::filesystem_error& e) {
+    ld_error(
+        "Failed to list zstd dictionaries in %s: %s", dir.c_str(), e.what());
+    return -1;
+  }
+  return loaded;
+}
+
+std::shared_ptr<const ZstdDictionaries::Dictionary>
+ZstdDictionaries::find(uint32_t id) const {
+  auto locked = dicts_.rlock();
+  auto it = locked->find(id);
+  return it == locked->end() ? nullptr : it->second;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <folly/Synchronized.h>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Process-wide registry of trained zstd dictionaries used to compress
+ * BufferedWriter batches (including those built by SequencerBatching).
+ *
+ * Dictionaries are identified by the dictionary ID zstd embeds when training
+ * them (`zstd --train`).  A batch compressed with a dictionary records that
+ * ID in its header, so every process decoding such batches must have the
+ * same dictionary registered; decoding fails otherwise.  Dictionaries are
+ * immutable once registered: to change one, train a new dictionary (which
+ * gets a new ID) and switch writers over once all readers have it.
+ */
+class ZstdDictionaries {
+ public:
+  class Dictionary {
+   public:
+    ~Dictionary();
+
+    uint32_t id() const {
+      return id_;
+    }
+
+    // Digested dictionary for decompression.
+    const ZSTD_DDict_s* ddict() const {
+      return ddict_;
+    }
+
+    // Digested dictionary for compression at the given level, created on
+    // first use.  Returns nullptr on allocation failure.
+    const ZSTD_CDict_s* cdict(int level) const;
+
+   private:
+    friend class ZstdDictionaries;
+    Dictionary(uint32_t id, std::string raw, ZSTD_DDict_s* ddict)
+        : id_(id), raw_(std::move(raw)), ddict_(ddict) {}
+
+    const uint32_t id_;
+    const std::string raw_;
+    ZSTD_DDict_s* const ddict_;
+    mutable std::mutex cdicts_mutex_;
+    mutable std::map<int, ZSTD_CDict_s*> cdicts_;
+  };
+
+  static ZstdDictionaries& get();
+
+  /**
+   * Registers a dictionary.  Registering the same dictionary ID twice is a
+   * no-op.
+   *
+   * @return 0 on success, -1 with err set to INVALID_PARAM if `raw' is not a
+   *         zstd dictionary with a non-zero ID, or NOMEM.
+   */
+  int add(std::string raw);
+
+  /**
+   * Registers every regular file in `dir' as a dictionary.
+   *
+   * @return number of dictionaries registered, or -1 if `dir' could not be
+   *         read or contained a file that is not a valid dictionary.
+   */
+  int loadDirectory(const std::string& dir);
+
+  /**
+   * @return the dictionary with the given ID, or nullptr if none was
+   *         registered.
+   */
+  std::shared_ptr<const Dictionary> find(uint32_t id) const;
+
+ private:
+  folly::Synchronized<
+      std::unordered_map<uint32_t, std::shared_ptr<const Dictionary>>>
+      dicts_;
+};
+
+}} // namespace facebook::logdevice
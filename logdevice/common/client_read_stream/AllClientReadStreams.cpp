@@ -7,10 +7,14 @@
  */
 #include "logdevice/common/client_read_stream/AllClientReadStreams.h"
 
+#include <cstring>
+
+#include <folly/Random.h>
 #include <folly/small_vector.h>
 
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/protocol/STOP_Message.h"
@@ -21,6 +25,15 @@ namespace facebook { namespace logdevice {
 
 void AllClientReadStreams::insertAndStart(
     std::unique_ptr<ClientReadStream>&& stream) {
+  if (Worker::settings().client_read_stream_sharing &&
+      attachToSharedStream(stream)) {
+    return;
+  }
+  startStream(std::move(stream));
+}
+
+void AllClientReadStreams::startStream(
+    std::unique_ptr<ClientReadStream>&& stream) {
   read_stream_id_t id = stream->getID();
   auto insert_result = streams_.insert(std::make_pair(id, std::move(stream)));
   ld_check(insert_result.second); // new read streams should have unique IDs
@@ -30,12 +43,276 @@ void AllClientReadStreams::insertAndStart(
 }
 
 void AllClientReadStreams::erase(read_stream_id_t id) {
+  auto sub_it = subscribers_.find(id);
+  if (sub_it != subscribers_.end()) {
+    const read_stream_id_t shared_id = sub_it->second;
+    subscribers_.erase(sub_it);
+    SharedStream* shared = getSharedStream(shared_id);
+    ld_check(shared);
+    shared->subscribers.erase(id);
+    disposeSharedStreamIfUnused(shared_id);
+    return;
+  }
+
+  auto shared_it = shared_streams_.find(id);
+  if (shared_it != shared_streams_.end()) {
+    // The shared stream is done. Its subscribers, if any are left, go away
+    // with it.
+    for (const auto& kv : shared_it->second.subscribers) {
+      subscribers_.erase(kv.first);
+    }
+    auto range = shared_streams_by_log_.equal_range(shared_it->second.log_id);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == id) {
+        shared_streams_by_log_.erase(it);
+        break;
+      }
+    }
+    shared_streams_.erase(shared_it);
+  }
+
   auto it = streams_.find(id);
   if (it != streams_.end()) {
     streams_.erase(it);
   }
 }
 
+AllClientReadStreams::SharedStream*
+AllClientReadStreams::getSharedStream(read_stream_id_t shared_id) {
+  auto it = shared_streams_.find(shared_id);
+  return it == shared_streams_.end() ? nullptr : &it->second;
+}
+
+bool AllClientReadStreams::attachToSharedStream(
+    std::unique_ptr<ClientReadStream>& stream) {
+  if (!stream->isShareable()) {
+    return false;
+  }
+
+  std::unique_ptr<ClientReadStream> new_shared_stream;
+  read_stream_id_t shared_id = findSharedStream(*stream);
+  if (shared_id == READ_STREAM_ID_INVALID) {
+    new_shared_stream = createSharedStream(*stream);
+    shared_id = new_shared_stream->getID();
+  }
+  WORKER_STAT_INCR(client.read_streams_attached_to_shared);
+
+  SharedStream* shared = getSharedStream(shared_id);
+  ld_check(shared);
+  const read_stream_id_t id = stream->getID();
+  const lsn_t start_lsn = stream->getNextLSNToDeliver();
+  if (shared->healthy.hasValue() && !shared->healthy.value()) {
+    stream->getDeps().healthCallback(false);
+  }
+  auto res = shared->subscribers.emplace(
+      id, Subscriber{std::move(stream), start_lsn});
+  ld_check(res.second);
+  subscribers_[id] = shared_id;
+
+  if (new_shared_stream) {
+    startStream(std::move(new_shared_stream));
+  }
+  return true;
+}
+
+read_stream_id_t
+AllClientReadStreams::findSharedStream(const ClientReadStream& stream) const {
+  const lsn_t start_lsn = stream.getNextLSNToDeliver();
+  auto range = shared_streams_by_log_.equal_range(stream.getLogID());
+  for (auto it = range.first; it != range.second; ++it) {
+    auto stream_it = streams_.find(it->second);
+    ld_check(stream_it != streams_.end());
+    const ClientReadStream& shared = *stream_it->second;
+    // Readers that start before what the shared stream already delivered, or
+    // so far ahead that the shared stream doesn't fetch their records yet,
+    // read on their own.
+    if (shared.hasSameReadOptions(stream) &&
+        start_lsn >= shared.getNextLSNToDeliver() &&
+        start_lsn <= shared.getWindowHigh()) {
+      return it->second;
+    }
+  }
+  return READ_STREAM_ID_INVALID;
+}
+
+std::unique_ptr<ClientReadStream>
+AllClientReadStreams::createSharedStream(ClientReadStream& stream) {
+  Worker* w = Worker::onThisThread();
+  const read_stream_id_t shared_id = w->processor_->issueReadStreamID();
+  const logid_t log_id = stream.getLogID();
+  ClientReadStreamDependencies& reader_deps = stream.getDeps();
+
+  // Safe to bind to `this', the shared stream is owned by it.
+  auto deps = std::make_unique<ClientReadStreamDependencies>(
+      shared_id,
+      log_id,
+      reader_deps.getClientSessionID(),
+      [this, shared_id](std::unique_ptr<DataRecord>& record) {
+        return deliverSharedRecord(shared_id, record);
+      },
+      [this, shared_id](const GapRecord& gap) {
+        return deliverSharedGap(shared_id, gap);
+      },
+      [this, shared_id](logid_t) { onSharedStreamDone(shared_id); },
+      reader_deps.getEpochMetaDataCache(),
+      [this, shared_id](bool healthy) {
+        onSharedStreamHealthChange(shared_id, healthy);
+      });
+
+  SharedStream& shared = shared_streams_[shared_id];
+  shared.log_id = log_id;
+  shared_streams_by_log_.emplace(log_id, shared_id);
+  WORKER_STAT_INCR(client.shared_read_streams_created);
+  return stream.makeSharedStream(shared_id, std::move(deps));
+}
+
+void AllClientReadStreams::detach(SharedStream& shared,
+                                  read_stream_id_t id,
+                                  lsn_t next_lsn) {
+  auto it = shared.subscribers.find(id);
+  ld_check(it != shared.subscribers.end());
+  std::unique_ptr<ClientReadStream> stream = std::move(it->second.stream);
+  shared.subscribers.erase(it);
+  subscribers_.erase(id);
+
+  ld_debug("Read stream %lu of log %lu detaches from a shared stream at %s",
+           id.val_,
+           shared.log_id.val_,
+           lsn_to_string(next_lsn).c_str());
+  WORKER_STAT_INCR(client.read_streams_detached_from_shared);
+  stream->setStartLSN(next_lsn);
+  startStream(std::move(stream));
+}
+
+void AllClientReadStreams::disposeSharedStreamIfUnused(
+    read_stream_id_t shared_id) {
+  SharedStream* shared = getSharedStream(shared_id);
+  if (shared && shared->subscribers.empty()) {
+    erase(shared_id);
+  }
+}
+
+bool AllClientReadStreams::deliverSharedRecord(
+    read_stream_id_t shared_id,
+    std::unique_ptr<DataRecord>& record) {
+  SharedStream* shared = getSharedStream(shared_id);
+  ld_check(shared);
+  const lsn_t lsn = record->attrs.lsn;
+  const auto& owned = static_cast<const DataRecordOwnsPayload&>(*record);
+
+  folly::small_vector<read_stream_id_t> ids;
+  for (const auto& kv : shared->subscribers) {
+    if (kv.second.next_lsn <= lsn) {
+      ids.push_back(kv.first);
+    }
+  }
+
+  std::vector<read_stream_id_t> rejected;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    Subscriber& sub = shared->subscribers.at(ids[i]);
+    std::unique_ptr<DataRecord> copy;
+    if (i + 1 < ids.size()) {
+      // Everyone but the last subscriber gets a copy.
+      void* payload = nullptr;
+      if (record->payload.size() > 0) {
+        payload = malloc(record->payload.size());
+        if (payload == nullptr) {
+          throw std::bad_alloc();
+        }
+        memcpy(payload, record->payload.data(), record->payload.size());
+      }
+      copy = std::make_unique<DataRecordOwnsPayload>(
+          record->logid,
+          Payload(payload, record->payload.size()),
+          lsn,
+          record->attrs.timestamp,
+          owned.flags_,
+          owned.extra_metadata_
+              ? std::make_unique<ExtraMetadata>(*owned.extra_metadata_)
+              : nullptr,
+          nullptr,
+          record->attrs.batch_offset,
+          record->attrs.offsets,
+          owned.invalid_checksum_);
+    }
+    // If the last subscriber rejects the record, it stays in `record', which
+    // the shared stream then discards.
+    std::unique_ptr<DataRecord>& to_deliver = copy ? copy : record;
+    if (sub.stream->getDeps().recordCallback(to_deliver)) {
+      sub.next_lsn = lsn + 1;
+    } else {
+      rejected.push_back(ids[i]);
+    }
+  }
+
+  for (read_stream_id_t id : rejected) {
+    detach(*shared, id, lsn);
+  }
+  if (!rejected.empty() && shared->subscribers.empty()) {
+    // We are inside a callback of the shared stream, destroy it later.
+    Worker::onThisThread()->add(
+        [this, shared_id] { disposeSharedStreamIfUnused(shared_id); });
+  }
+  // The shared stream always moves on, rejecting readers re-read on their own.
+  return true;
+}
+
+bool AllClientReadStreams::deliverSharedGap(read_stream_id_t shared_id,
+                                            const GapRecord& gap) {
+  SharedStream* shared = getSharedStream(shared_id);
+  ld_check(shared);
+
+  folly::small_vector<read_stream_id_t> ids;
+  for (const auto& kv : shared->subscribers) {
+    if (kv.second.next_lsn <= gap.hi) {
+      ids.push_back(kv.first);
+    }
+  }
+
+  std::vector<std::pair<read_stream_id_t, lsn_t>> rejected;
+  for (read_stream_id_t id : ids) {
+    Subscriber& sub = shared->subscribers.at(id);
+    // Readers that started in the middle of the gap only get the part of it
+    // after their start LSN.
+    GapRecord clipped(
+        gap.logid, gap.type, std::max(gap.lo, sub.next_lsn), gap.hi);
+    if (sub.stream->getDeps().gapCallback(clipped)) {
+      sub.next_lsn = gap.hi + 1;
+    } else {
+      rejected.emplace_back(id, clipped.lo);
+    }
+  }
+
+  for (const auto& r : rejected) {
+    detach(*shared, r.first, r.second);
+  }
+  if (!rejected.empty() && shared->subscribers.empty()) {
+    Worker::onThisThread()->add(
+        [this, shared_id] { disposeSharedStreamIfUnused(shared_id); });
+  }
+  return true;
+}
+
+void AllClientReadStreams::onSharedStreamDone(read_stream_id_t shared_id) {
+  SharedStream* shared = getSharedStream(shared_id);
+  ld_check(shared);
+  for (auto& kv : shared->subscribers) {
+    kv.second.stream->getDeps().doneCallback(shared->log_id);
+  }
+  // The shared stream disposes of itself and its subscribers right after.
+}
+
+void AllClientReadStreams::onSharedStreamHealthChange(
+    read_stream_id_t shared_id,
+    bool healthy) {
+  SharedStream* shared = getSharedStream(shared_id);
+  ld_check(shared);
+  shared->healthy = healthy;
+  for (auto& kv : shared->subscribers) {
+    kv.second.stream->getDeps().healthCallback(healthy);
+  }
+}
+
 void AllClientReadStreams::onDataRecord(
     ShardID shard,
     logid_t log_id,
@@ -111,6 +388,26 @@ void AllClientReadStreams::forEachStream(
   }
 }
 
+size_t AllClientReadStreams::getBytesBuffered() const {
+  size_t bytes = 0;
+  for (const auto& it : streams_) {
+    bytes += it.second->getBytesBuffered();
+  }
+  return bytes;
+}
+
+std::chrono::milliseconds
+AllClientReadStreams::getNodeRewindDelay(node_index_t node,
+                                         std::chrono::milliseconds spread) {
+  const SteadyTimestamp now = SteadyTimestamp::now();
+  auto it = node_rewind_spread_start_.find(node);
+  if (it == node_rewind_spread_start_.end() || now - it->second > spread) {
+    node_rewind_spread_start_[node] = now;
+    return std::chrono::milliseconds::zero();
+  }
+  return std::chrono::milliseconds(folly::Random::rand64(spread.count() + 1));
+}
+
 void AllClientReadStreams::noteConfigurationChanged() {
   // noteConfigurationChanged() may delete some ClientReadStream instances but
   // forEachStream makes that safe.
@@ -7,11 +7,15 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 
+#include <folly/Optional.h>
+
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
+#include "logdevice/common/Timestamp.h"
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
 #include "logdevice/common/protocol/GAP_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
@@ -24,6 +28,19 @@
  *       This class is not thread-safe.  Each worker thread is meant to have
  *       its own instance.  The read stream for any one log is assumed to be
  *       pinned to a worker thread.
+ *
+ *       With --client-read-stream-sharing, streams of different readers of
+ *       the same log that read with the same options (see
+ *       ClientReadStream::isShareable()) don't talk to storage shards
+ *       themselves. Instead, they attach as subscribers to a shared stream
+ *       with its own read stream ID, which delivers records and gaps to the
+ *       callbacks of each subscriber. A reader can attach as long as its start
+ *       LSN is within the shared stream's window; records below its start LSN
+ *       are skipped for it. A subscriber that rejects a record or gap detaches:
+ *       its own stream is started from that LSN as a private stream, so that
+ *       redelivery and flow control of one slow reader don't hold back the
+ *       others. The shared stream is destroyed when its last subscriber goes
+ *       away.
  */
 
 namespace facebook { namespace logdevice {
@@ -93,10 +110,14 @@ class AllClientReadStreams : public ShardAuthoritativeStatusSubscriber {
    * Forces the map to get cleared and all read streams destroyed.
    */
   void clear() {
+    subscribers_.clear();
+    shared_streams_.clear();
+    shared_streams_by_log_.clear();
     streams_.clear();
   }
 
-  // A helper method for getting ClientReadStream instances from streams_
+  // A helper method for getting ClientReadStream instances from streams_.
+  // Returns nullptr for streams attached to a shared stream.
   ClientReadStream* getStream(read_stream_id_t id);
 
   void getReadStreamsDebugInfo(InfoClientReadStreamsTable& table) const;
@@ -118,12 +139,90 @@ class AllClientReadStreams : public ShardAuthoritativeStatusSubscriber {
    */
   void forEachStream(std::function<void(ClientReadStream& read_stream)> cb);
 
+  // Total size of the record payloads buffered by all read streams on this
+  // worker. See ClientReadStream::getBytesBuffered().
+  size_t getBytesBuffered() const;
+
+  /**
+   * Returns how long a read stream should delay the rewind that lets it read
+   * from `node' again, see --client-read-rewind-spread. The first such rewind
+   * in `spread' isn't delayed, so that a single stream reading from a flappy
+   * node doesn't wait. The following ones, typically from all streams
+   * reading from the node as it comes back, get a random delay in
+   * [0, `spread'], so that their START messages don't all hit storage nodes
+   * at once.
+   */
+  std::chrono::milliseconds
+  getNodeRewindDelay(node_index_t node, std::chrono::milliseconds spread);
+
  private:
+  struct Subscriber {
+    // The reader's own stream. Not started while attached, only its callbacks
+    // are used.
+    std::unique_ptr<ClientReadStream> stream;
+    // Records and gaps below this LSN are not delivered to the reader, either
+    // because it already got them or because it started reading after them.
+    lsn_t next_lsn;
+  };
+
+  struct SharedStream {
+    logid_t log_id;
+    std::unordered_map<read_stream_id_t, Subscriber, read_stream_id_t::Hash>
+        subscribers;
+    // Last health reported by the shared stream, passed on to readers that
+    // attach later.
+    folly::Optional<bool> healthy;
+  };
+
+  // Attaches `stream' to a compatible shared stream of its log, creating one
+  // if needed. Returns false, leaving `stream' untouched, if the stream can't
+  // be shared.
+  bool attachToSharedStream(std::unique_ptr<ClientReadStream>& stream);
+
+  // Finds a shared stream `stream' can attach to.
+  read_stream_id_t findSharedStream(const ClientReadStream& stream) const;
+
+  // Creates a shared stream that reads from where `stream' starts. The caller
+  // starts it once `stream' is attached.
+  std::unique_ptr<ClientReadStream>
+  createSharedStream(ClientReadStream& stream);
+
+  // Takes the subscriber off the shared stream and starts its own stream from
+  // `next_lsn'.
+  void detach(SharedStream& shared, read_stream_id_t id, lsn_t next_lsn);
+
+  // Destroys the shared stream if no one is attached to it anymore.
+  void disposeSharedStreamIfUnused(read_stream_id_t shared_id);
+
+  // Callbacks of shared streams.
+  bool deliverSharedRecord(read_stream_id_t shared_id,
+                           std::unique_ptr<DataRecord>& record);
+  bool deliverSharedGap(read_stream_id_t shared_id, const GapRecord& gap);
+  void onSharedStreamDone(read_stream_id_t shared_id);
+  void onSharedStreamHealthChange(read_stream_id_t shared_id, bool healthy);
+
+  void startStream(std::unique_ptr<ClientReadStream>&& stream);
+
+  SharedStream* getSharedStream(read_stream_id_t shared_id);
+
+  // Start of the last interval of --client-read-rewind-spread in which read
+  // streams rewound to read from a node again, by node.
+  std::unordered_map<node_index_t, SteadyTimestamp> node_rewind_spread_start_;
+
   // Actual container
   std::unordered_map<read_stream_id_t,
                      std::unique_ptr<ClientReadStream>,
                      read_stream_id_t::Hash>
       streams_;
+
+  // Shared streams, by their ID in streams_.
+  std::unordered_map<read_stream_id_t, SharedStream, read_stream_id_t::Hash>
+      shared_streams_;
+  std::unordered_multimap<logid_t, read_stream_id_t, logid_t::Hash>
+      shared_streams_by_log_;
+  // For each attached reader's stream, the ID of its shared stream.
+  std::unordered_map<read_stream_id_t, read_stream_id_t, read_stream_id_t::Hash>
+      subscribers_;
 };
 
 }} // namespace facebook::logdevice
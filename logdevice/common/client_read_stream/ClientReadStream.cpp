@@ -44,6 +44,7 @@
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/event_log/EventLogRebuildingSet.h"
+#include "logdevice/common/protocol/CHECKSUM_FAIL_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
 #include "logdevice/common/settings/Settings.h"
@@ -112,6 +113,7 @@ ClientReadStream::ClientReadStream(
       next_lsn_to_deliver_(start_lsn),
       until_lsn_(until_lsn),
       flow_control_threshold_(flow_control_threshold),
+      buffer_type_(buffer_type),
       buffer_(ClientReadStreamBufferFactory::create(
           buffer_type,
           actual_buffer_size(buffer_capacity, start_lsn, until_lsn),
@@ -330,6 +332,74 @@ void ClientReadStream::getDebugInfo(InfoClientReadStreamsTable& table) const {
   }
 }
 
+bool ClientReadStream::isShareable() const {
+  return !started_ && until_lsn_ == LSN_MAX && reader_ == nullptr &&
+      attrs_ == ReadStreamAttributes() && !deps_->hasRecordBatchCallback() &&
+      !wait_for_all_copies_ && !ship_pseudorecords_ &&
+      !MetaDataLog::isMetaDataLog(log_id_);
+}
+
+bool ClientReadStream::hasSameReadOptions(const ClientReadStream& other) const {
+  return log_id_ == other.log_id_ && until_lsn_ == other.until_lsn_ &&
+      attrs_ == other.attrs_ &&
+      additional_start_flags_ == other.additional_start_flags_ &&
+      flow_control_threshold_ == other.flow_control_threshold_ &&
+      buffer_->capacity() == other.buffer_->capacity() &&
+      force_no_scd_ == other.force_no_scd_ &&
+      use_epoch_metadata_cache_ == other.use_epoch_metadata_cache_ &&
+      ship_pseudorecords_ == other.ship_pseudorecords_ &&
+      require_full_read_set_ == other.require_full_read_set_ &&
+      wait_for_all_copies_ == other.wait_for_all_copies_ &&
+      ignore_released_status_ == other.ignore_released_status_ &&
+      do_not_skip_partially_trimmed_sections_ ==
+      other.do_not_skip_partially_trimmed_sections_ &&
+      ship_corrupted_records_ == other.ship_corrupted_records_;
+}
+
+std::unique_ptr<ClientReadStream> ClientReadStream::makeSharedStream(
+    read_stream_id_t id,
+    std::unique_ptr<ClientReadStreamDependencies> deps) const {
+  auto stream = std::make_unique<ClientReadStream>(id,
+                                                   log_id_,
+                                                   start_lsn_,
+                                                   until_lsn_,
+                                                   flow_control_threshold_,
+                                                   buffer_type_,
+                                                   buffer_->capacity(),
+                                                   std::move(deps),
+                                                   config_,
+                                                   nullptr,
+                                                   &attrs_);
+  stream->additional_start_flags_ = additional_start_flags_;
+  stream->force_no_scd_ = force_no_scd_;
+  stream->use_epoch_metadata_cache_ = use_epoch_metadata_cache_;
+  stream->ship_pseudorecords_ = ship_pseudorecords_;
+  stream->require_full_read_set_ = require_full_read_set_;
+  stream->wait_for_all_copies_ = wait_for_all_copies_;
+  stream->ignore_released_status_ = ignore_released_status_;
+  stream->do_not_skip_partially_trimmed_sections_ =
+      do_not_skip_partially_trimmed_sections_;
+  stream->ship_corrupted_records_ = ship_corrupted_records_;
+  ld_check(hasSameReadOptions(*stream));
+  return stream;
+}
+
+void ClientReadStream::setStartLSN(lsn_t start_lsn) {
+  ld_check(!started_);
+  ld_check(start_lsn <= until_lsn_);
+  const size_t capacity = buffer_->capacity();
+  start_lsn_ = start_lsn;
+  next_lsn_to_deliver_ = start_lsn;
+  buffer_ = ClientReadStreamBufferFactory::create(
+      buffer_type_,
+      actual_buffer_size(capacity, start_lsn, until_lsn_),
+      next_lsn_to_deliver_);
+  window_size_ = buffer_->capacity();
+  calcWindowHigh();
+  calcNextLSNToSlideWindow();
+  updateServerWindow();
+}
+
 void ClientReadStream::start() {
   ld_check(!started_);
   started_ = true;
@@ -513,7 +583,7 @@ void ClientReadStream::sendStart(ShardID shard_id, SenderState& state) {
   ld_check(current_metadata_);
   header.replication = current_metadata_->replication.getReplicationFactor();
   header.scd_copyset_reordering = std::min(
-      SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED,
+      SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION,
       SCDCopysetReordering(deps_->getSettings().scd_copyset_reordering_max));
 
   if (scd_->isActive()) {
@@ -706,7 +776,9 @@ void ClientReadStream::onStarted(ShardID from, const STARTED_Message& msg) {
       ld_check(state.filter_version.val_ <= filter_version_.val_);
       state.filter_version = filter_version_;
       state.setConnectionState(ConnectionState::READING);
-      state.resetReconnectTimer();
+      // The STARTED timer was reset above. Neither timer is needed until the
+      // connection fails, so free them.
+      state.releaseConnectionTimers();
       if (status == E::OK) {
         updateLastReleased(msg.header_.last_released_lsn);
         // Send a quick WINDOW message in case this server missed out on any
@@ -919,6 +991,18 @@ void ClientReadStream::onDataRecord(
     return;
   }
 
+  if (sender_state.window_rtt_probe_lsn != LSN_INVALID &&
+      lsn >= sender_state.window_rtt_probe_lsn) {
+    onWindowRoundTrip(sender_state);
+  }
+
+  if (record->invalid_checksum_) {
+    // Storage nodes don't verify checksums when reading, so let the shard
+    // know. Older storage nodes don't understand the message, in which case
+    // sending it fails and is ignored.
+    deps_->sendChecksumFailMessage(shard, lsn);
+  }
+
   if (record->invalid_checksum_ && !ship_corrupted_records_) {
     // issuing a gap instead of shipping a record with an invalid checksum
     GAP_Header gap_header = {log_id_,
@@ -1304,6 +1388,11 @@ void ClientReadStream::updateGapState(lsn_t next_lsn, SenderState& state) {
  */
 void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
                                           bool redelivery_in_progress) {
+  // Records rejected by the batch callback come before anything else.
+  if (flushRecordBatch() != 0) {
+    return;
+  }
+
   if (done()) {
     // The stream may be in an inconsistent state so better to return early.
     return;
@@ -1419,10 +1508,12 @@ void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
         grace_period_->cancel();
       }
     }
-    if (!slideSenderWindows()) {
+    // Only slide the window once the application took the records.
+    if (flushRecordBatch() != 0 || !slideSenderWindows()) {
       break;
     }
   }
+  flushRecordBatch();
 
   if (scd_->isActive()) {
     scd_->checkNeedsFailoverToAllSendAll();
@@ -1512,7 +1603,7 @@ int ClientReadStream::handleEpochBegin(lsn_t epoch_begin) {
 
 ClientReadStream::ProgressDecision
 ClientReadStream::checkFMajority(bool grace_period_expired) const {
-  if (rewind_scheduler_->isScheduled()) {
+  if (rewind_scheduler_->isImminent()) {
     // We do not allow running the gap detection algorithm while a rewind is
     // scheduled as that rewind may have been scheduled because the
     // authoritative status of a node changed, and issuing a gap right now is
@@ -1994,7 +2085,7 @@ void ClientReadStream::noteConfigurationChanged() {
 void ClientReadStream::onSettingsUpdated() {
   if (current_metadata_) {
     findGapsAndRecords();
-    if (done()) {
+    if (done() && record_batch_.empty()) {
       deps_->dispose();
       return;
     }
@@ -2785,7 +2876,7 @@ void ClientReadStream::updateCurrentReadSet() {
 
   // If either updateStorageShardsSet() or applyShardStatus() scheduled a
   // rewind, no need to send START messages here as they'll be sent by rewind.
-  if (rewind_scheduler_->isScheduled()) {
+  if (rewind_scheduler_->isImminent()) {
     return;
   }
 
@@ -2904,16 +2995,10 @@ bool ClientReadStream::canDeliverRecordsNow() const {
 
 ClientReadStreamSenderState&
 ClientReadStream::createStateForShard(ShardID shard_id) {
-  const auto& settings = deps_->getSettings();
   auto insert_result = storage_set_states_.emplace(
       std::piecewise_construct,
       std::forward_as_tuple(shard_id),
-      std::forward_as_tuple(
-          this,
-          shard_id,
-          deps_->createBackoffTimer(settings.reader_reconnect_delay),
-          deps_->createBackoffTimer(settings.reader_started_timeout),
-          deps_->createBackoffTimer(settings.reader_retry_window_delay)));
+      std::forward_as_tuple(this, shard_id, deps_.get()));
   ld_check(insert_result.second);
   return insert_result.first->second;
 }
@@ -2957,6 +3042,8 @@ void ClientReadStream::resetGapParametersForSender(SenderState& state) {
   state.max_data_record_lsn = LSN_INVALID;
   state.grace_counter = 0;
   state.under_replicated_until = LSN_INVALID;
+  // A record after a rewind doesn't tell how long a WINDOW took.
+  state.window_rtt_probe_lsn = LSN_INVALID;
   setSenderGapState(state, GapState::NONE);
 }
 
@@ -3199,8 +3286,21 @@ int ClientReadStream::deliverRecord(
         // need the notification but to unblock Reader and avoid an issue where
         // it gets stuck waiting for more records (t14156907)
         lsn == until_lsn_;
-    int rv = reader_->onDataRecord(getID(), std::move(record), notify);
-    success = (rv == 0);
+    if (deps_->getSettings().client_read_batch_handoff) {
+      // The Reader gets the record with the rest of the batch in
+      // flushRecordBatch().
+      record_batch_notify_ |= notify;
+      record_batch_.push_back(std::move(record));
+      success = true;
+    } else {
+      int rv = reader_->onDataRecord(getID(), std::move(record), notify);
+      success = (rv == 0);
+    }
+  } else if (deps_->hasRecordBatchCallback()) {
+    // The application gets the record with the rest of the batch in
+    // flushRecordBatch(). Until then, the batch owns it.
+    record_batch_.push_back(std::move(record));
+    success = true;
   } else {
     inside_callback_ = true;
     // This is tricky.  Upcasting from DataRecordOwnsPayload ...
@@ -3282,10 +3382,82 @@ int ClientReadStream::deliverRecord(
   return success ? 0 : -1;
 }
 
+int ClientReadStream::flushRecordBatch() {
+  if (record_batch_.empty()) {
+    return 0;
+  }
+  if (redelivery_timer_ != nullptr && redelivery_timer_->isActive()) {
+    // Recently rejected, wait for the timer.
+    return -1;
+  }
+
+  if (reader_) {
+    // The Reader takes the whole batch as one queue entry, or nothing.
+    if (reader_->onDataRecords(getID(), record_batch_, record_batch_notify_) ==
+        0) {
+      ld_check(record_batch_.empty());
+      record_batch_notify_ = false;
+      adjustRedeliveryTimer(true);
+      return 0;
+    }
+    ld_check(!record_batch_.empty());
+    if (!MetaDataLog::isMetaDataLog(log_id_)) {
+      WORKER_STAT_INCR(client.records_redelivery_attempted);
+    }
+    adjustRedeliveryTimer(false);
+    return -1;
+  }
+
+  const size_t size = record_batch_.size();
+  const lsn_t last_lsn = record_batch_.back()->attrs.lsn;
+  // The callback may consume only part of the batch, e.g. if AsyncReader
+  // needs to deliver a gap in the middle of it. Keep going with the rest.
+  size_t consumed;
+  do {
+    inside_callback_ = true;
+    consumed = std::min(deps_->recordBatchCallback(record_batch_),
+                        record_batch_.size());
+    inside_callback_ = false;
+    // Records that weren't consumed must be intact.
+    ld_check(std::all_of(record_batch_.begin() + consumed,
+                         record_batch_.end(),
+                         [](const std::unique_ptr<DataRecord>& record) {
+                           return record != nullptr;
+                         }));
+    record_batch_.erase(
+        record_batch_.begin(), record_batch_.begin() + consumed);
+  } while (consumed > 0 && !record_batch_.empty());
+
+  const bool success = record_batch_.empty();
+  if (success) {
+    if (last_lsn >= until_lsn_) {
+      deps_->doneCallback(log_id_);
+    }
+  } else {
+    if (!MetaDataLog::isMetaDataLog(log_id_)) {
+      WORKER_STAT_INCR(client.records_redelivery_attempted);
+    }
+    RATELIMIT_DEBUG(std::chrono::seconds(10),
+                    10,
+                    "Record batch callback consumed %zu of %zu records of "
+                    "log %lu",
+                    size - record_batch_.size(),
+                    size,
+                    log_id_.val_);
+  }
+  adjustRedeliveryTimer(success);
+  return success ? 0 : -1;
+}
+
 int ClientReadStream::deliverGap(GapType type, lsn_t lo, lsn_t hi) {
   ld_check(hi <= until_lsn_);
   ld_check(lo <= hi);
 
+  // Records before the gap must reach the application first.
+  if (flushRecordBatch() != 0) {
+    return -1;
+  }
+
   if (type == GapType::DATALOSS) {
     RATELIMIT_WARNING(std::chrono::seconds(10),
                       2,
@@ -3563,15 +3735,84 @@ void ClientReadStream::updateServerWindow() {
 }
 
 void ClientReadStream::updateWindowSize() {
+  const bool autotune = deps_->getSettings().client_read_window_autotune;
+  // Take the drain rate sample even under memory pressure, so that it covers
+  // the time since the previous slide.
+  const size_t autotuned = autotune ? autotuneWindowSize() : 0;
   if (deps_->hasMemoryPressure()) {
     // cut the window size in half
     window_size_ = std::max(size_t(1), window_size_ / 2);
+  } else if (autotune && autotuned > 0) {
+    window_size_ = autotuned;
   } else {
     // increment window size but not more than what the buffer can hold
     window_size_ = std::min(buffer_->capacity(), window_size_ + 1);
   }
 }
 
+size_t ClientReadStream::autotuneWindowSize() {
+  using namespace std::chrono;
+  const auto now = steady_clock::now();
+  const size_t delivered =
+      num_records_delivered_ - records_delivered_at_last_slide_;
+  const auto elapsed = now - last_window_slide_time_;
+  const bool first_slide =
+      last_window_slide_time_ == steady_clock::time_point();
+  last_window_slide_time_ = now;
+  records_delivered_at_last_slide_ = num_records_delivered_;
+  if (first_slide || elapsed <= steady_clock::duration::zero()) {
+    return 0;
+  }
+
+  const double rate =
+      delivered / duration_cast<duration<double>>(elapsed).count();
+  drain_rate_ = drain_rate_ == 0 ? rate : 0.75 * drain_rate_ + 0.25 * rate;
+
+  // Records are delivered in LSN order, so the slowest sender is the one the
+  // window has to be sized for.
+  microseconds rtt{0};
+  for (const auto& it : storage_set_states_) {
+    rtt = std::max(rtt, it.second.window_rtt);
+  }
+  if (rtt == microseconds::zero()) {
+    // No round trip measured yet.
+    return 0;
+  }
+  return windowSizeForBandwidthDelay(
+      drain_rate_, rtt, flow_control_threshold_, buffer_->capacity());
+}
+
+size_t
+ClientReadStream::windowSizeForBandwidthDelay(double drain_rate,
+                                              std::chrono::microseconds rtt,
+                                              double flow_control_threshold,
+                                              size_t capacity) {
+  // Don't let a consumer that stalls for a moment shrink the window to the
+  // point where every few records wait for a WINDOW round trip.
+  const size_t min_size = std::min(capacity, size_t(16));
+  // Records consumed while the WINDOW travels to senders and the records it
+  // allows travel back. These have to be in the part of the window that is
+  // left when it slides. Double that, as the estimates are noisy and so that
+  // a window that limits the drain rate keeps growing.
+  const double in_flight = drain_rate * rtt.count() / 1e6;
+  const double left_after_slide = std::max(1 - flow_control_threshold, 0.05);
+  const double size = 2 * in_flight / left_after_slide;
+  if (!(size < capacity)) {
+    return capacity;
+  }
+  return std::max(min_size, size_t(size));
+}
+
+void ClientReadStream::onWindowRoundTrip(SenderState& state) {
+  using namespace std::chrono;
+  const auto sample = duration_cast<microseconds>(steady_clock::now() -
+                                                  state.window_sent_time);
+  state.window_rtt = state.window_rtt == microseconds::zero()
+      ? sample
+      : (3 * state.window_rtt + sample) / 4;
+  state.window_rtt_probe_lsn = LSN_INVALID;
+}
+
 bool ClientReadStream::slideSenderWindows() {
   // This function should leave everything in a consistent state.
   SCOPE_EXIT {
@@ -3664,7 +3905,7 @@ bool ClientReadStream::slideSenderWindows() {
 
 void ClientReadStream::sendWindowMessage(SenderState& state) {
   // Don't send WINDOW if we're going to send START soon.
-  if (rewind_scheduler_->isScheduled()) {
+  if (rewind_scheduler_->isImminent()) {
     return;
   }
 
@@ -3705,6 +3946,11 @@ void ClientReadStream::sendWindowMessage(SenderState& state) {
         state.getShardID(), server_window_.low, server_window_.high);
     if (rv == 0) {
       state.resetRetryWindowTimer();
+      if (deps_->getSettings().client_read_window_autotune &&
+          state.window_rtt_probe_lsn == LSN_INVALID) {
+        state.window_rtt_probe_lsn = state.getWindowHigh() + 1;
+        state.window_sent_time = std::chrono::steady_clock::now();
+      }
       state.setWindowHigh(server_window_.high);
     } else {
       state.activateRetryWindowTimer();
@@ -3935,6 +4181,22 @@ void ClientReadStream::scheduleRewind(std::string reason) {
   rewind_scheduler_->schedule(nullptr, std::move(reason));
 }
 
+void ClientReadStream::scheduleRewindForShardBackUp(ShardID shard,
+                                                    std::string reason) {
+  ld_check(!reason.empty());
+  if (deps_->getSettings().client_read_rewind_spread ==
+      std::chrono::milliseconds::zero()) {
+    scheduleRewind(std::move(reason));
+    return;
+  }
+  rewind_scheduler_->scheduleDeferrable(
+      nullptr, std::move(reason), deps_->getShardBackUpRewindDelay(shard));
+}
+
+bool ClientReadStream::rewindNeeded() const {
+  return scd_ && scd_->hasScheduledChanges();
+}
+
 void ClientReadStream::rewind(std::string reason) {
   // Clear the buffer and reset gap parameters.
 
@@ -4165,11 +4427,27 @@ size_t ClientReadStream::getBytesBuffered() const {
 
 ClientReadStreamDependencies::ClientReadStreamDependencies() = default;
 
-ClientReadStreamDependencies::~ClientReadStreamDependencies() {}
+ClientReadStreamDependencies::~ClientReadStreamDependencies() {
+  finishSharedMetaDataFetch();
+}
+
+std::chrono::milliseconds
+ClientReadStreamDependencies::getShardBackUpRewindDelay(ShardID shard) {
+  Worker* w = Worker::onThisThread(false);
+  if (w == nullptr) {
+    return std::chrono::milliseconds::zero();
+  }
+  return w->clientReadStreams().getNodeRewindDelay(
+      shard.node(), getSettings().client_read_rewind_spread);
+}
 
 bool ClientReadStreamDependencies::hasMemoryPressure() const {
-  // TODO(T6159466): implement memory limits/accounting
-  return false;
+  const size_t limit = getSettings().client_read_buffered_bytes_limit;
+  Worker* w = Worker::onThisThread(false);
+  if (limit == 0 || w == nullptr) {
+    return false;
+  }
+  return w->clientReadStreams().getBytesBuffered() > limit;
 }
 
 void ClientReadStreamDependencies::getMetaDataForEpoch(
@@ -4204,6 +4482,9 @@ void ClientReadStreamDependencies::getMetaDataForEpoch(
     return;
   }
 
+  // a newer request overrides one waiting for another read stream's read
+  pending_metadata_request_.clear();
+
   if (allow_from_cache && metadata_cache_ != nullptr) {
     metadata_cached_ = std::make_unique<EpochMetaData>();
     epoch_t until = EPOCH_INVALID;
@@ -4283,6 +4564,33 @@ void ClientReadStreamDependencies::getMetaDataForEpoch(
                       epoch.val_,
                       rsid.val_);
     nodeset_finder_.reset();
+    finishSharedMetaDataFetch();
+  }
+
+  // A request that already waited for another read stream's read and still
+  // missed the cache (e.g. because the epoch was not released yet when the
+  // metadata log was read) reads the metadata log itself rather than waiting
+  // again.
+  if (allow_from_cache && metadata_cache_ != nullptr &&
+      !retrying_after_shared_fetch_ &&
+      getSettings().client_share_epoch_metadata_fetches) {
+    auto ticket = callbackHelper_.ticket();
+    auto on_done = [ticket] {
+      ticket.postCallbackRequest([](ClientReadStreamDependencies* deps) {
+        if (deps) {
+          deps->onSharedMetaDataFetchDone();
+        }
+      });
+    };
+    if (!metadata_cache_->startFetch(log_id_, std::move(on_done))) {
+      // Another read stream of the log is reading the metadata log. Its
+      // result will be in the cache once it's done.
+      WORKER_STAT_INCR(client.read_streams_shared_metadata_fetches);
+      pending_metadata_request_ = PendingMetaDataRequest{
+          rsid, epoch, std::move(cb), require_consistent_from_cache};
+      return;
+    }
+    fetching_for_cache_ = true;
   }
 
   // a callback object which essentially wraps the ClientReadStream callback
@@ -4291,6 +4599,11 @@ void ClientReadStreamDependencies::getMetaDataForEpoch(
     MetaDataLogReader::Result result;
     if (st == E::OK) {
       auto map = nodeset_finder_->getResult();
+      // Keep the whole history in the cache so that later requests for any
+      // epoch it covers, from any read stream of the log, are hits.
+      if (metadata_cache_ != nullptr) {
+        metadata_cache_->setMetaDataMap(log_id_, map);
+      }
       epoch_t until;
       std::unique_ptr<EpochMetaData> metadata;
       epoch_t effective_until = map->getEffectiveUntil();
@@ -4314,18 +4627,6 @@ void ClientReadStreamDependencies::getMetaDataForEpoch(
         auto entry = *it;
         until = entry.first.second;
         metadata = std::make_unique<EpochMetaData>(entry.second);
-
-        // Here we can store higher epochs into the cache to avoid future
-        // requests if possible.
-        ++it;
-        for (; it != map->end(); ++it) {
-          auto elem = *it;
-          updateEpochMetaDataCache(
-              elem.first.first,
-              elem.first.second,
-              elem.second,
-              MetaDataLogReader::RecordSource::CACHED_CONSISTENT);
-        }
       }
 
       result = {log_id_,
@@ -4361,6 +4662,9 @@ void ClientReadStreamDependencies::getMetaDataForEpoch(
     // ASAN failures. It will be destroyed after the callback returned.
     std::unique_ptr<NodeSetFinder> nf;
     nodeset_finder_.swap(nf);
+    // On failure, waiting read streams will miss the cache again and one of
+    // them will retry reading the metadata log.
+    finishSharedMetaDataFetch();
     cb(st, std::move(result));
   };
 
@@ -4376,6 +4680,31 @@ void ClientReadStreamDependencies::getMetaDataForEpoch(
   return;
 }
 
+void ClientReadStreamDependencies::onSharedMetaDataFetchDone() {
+  if (!pending_metadata_request_.hasValue()) {
+    // overridden by a request that didn't need to wait
+    return;
+  }
+  PendingMetaDataRequest rq = std::move(pending_metadata_request_.value());
+  pending_metadata_request_.clear();
+  retrying_after_shared_fetch_ = true;
+  getMetaDataForEpoch(rq.rsid,
+                      rq.epoch,
+                      std::move(rq.cb),
+                      /*allow_from_cache=*/true,
+                      rq.require_consistent);
+  retrying_after_shared_fetch_ = false;
+}
+
+void ClientReadStreamDependencies::finishSharedMetaDataFetch() {
+  if (!fetching_for_cache_) {
+    return;
+  }
+  ld_check(metadata_cache_ != nullptr);
+  fetching_for_cache_ = false;
+  metadata_cache_->finishFetch(log_id_);
+}
+
 void ClientReadStreamDependencies::updateEpochMetaDataCache(
     epoch_t epoch,
     epoch_t until,
@@ -4443,6 +4772,21 @@ int ClientReadStreamDependencies::sendWindowMessage(ShardID shard,
   return w->sender().sendMessage(std::move(msg), shard.asNodeID());
 }
 
+int ClientReadStreamDependencies::sendChecksumFailMessage(ShardID shard,
+                                                          lsn_t lsn) {
+  auto w = Worker::onThisThread();
+  ld_check(w);
+
+  CHECKSUM_FAIL_Header header;
+  header.log_id = log_id_;
+  header.lsn = lsn;
+  header.read_stream_id = read_stream_id_;
+  header.shard = shard.shard();
+
+  auto msg = std::make_unique<CHECKSUM_FAIL_Message>(header);
+  return w->sender().sendMessage(std::move(msg), shard.asNodeID());
+}
+
 void ClientReadStreamDependencies::dispose() {
   Worker::onThisThread()->clientReadStreams().erase(read_stream_id_);
 }
@@ -7,10 +7,12 @@
  */
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <queue>
 #include <set>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
@@ -25,6 +27,7 @@
 #include "logdevice/common/ReadStreamAttributes.h"
 #include "logdevice/common/ShardID.h"
 #include "logdevice/common/Timer.h"
+#include "logdevice/common/WorkerCallbackHelper.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamSenderState.h"
 #include "logdevice/common/client_read_stream/RewindScheduler.h"
 #include "logdevice/common/protocol/GAP_Message.h"
@@ -75,6 +78,30 @@ class ReaderBridge {
   virtual int onDataRecord(read_stream_id_t,
                            std::unique_ptr<DataRecordOwnsPayload>&&,
                            bool notify_when_consumed) = 0;
+  // Hands over a batch of consecutive records at once, used with
+  // --client-read-batch-handoff. All records are DataRecordOwnsPayload
+  // instances. On success `records' is left empty and 0 is returned. On
+  // failure -1 is returned, `records' is left intact and ClientReadStream
+  // should retry delivery later. `notify_when_consumed' applies to the
+  // batch as a whole.
+  virtual int onDataRecords(read_stream_id_t rsid,
+                            std::vector<std::unique_ptr<DataRecord>>& records,
+                            bool notify_when_consumed) {
+    // Default implementation delivers the records one by one.
+    while (!records.empty()) {
+      std::unique_ptr<DataRecordOwnsPayload> record(
+          static_cast<DataRecordOwnsPayload*>(records.front().release()));
+      int rv = onDataRecord(rsid,
+                            std::move(record),
+                            notify_when_consumed && records.size() == 1);
+      if (rv != 0) {
+        records.front().reset(record.release());
+        return rv;
+      }
+      records.erase(records.begin());
+    }
+    return 0;
+  }
   // @return 0 on success.  -1 if Reader is unable to accept the gap;
   // ClientReadStream should retry delivery later.
   virtual int onGapRecord(read_stream_id_t,
@@ -93,6 +120,10 @@ class ClientReadStreamDependencies {
   ClientReadStreamDependencies();
 
   using record_cb_t = std::function<bool(std::unique_ptr<DataRecord>&)>;
+  // Consumes records from the front of the vector and returns how many it
+  // consumed. The records it didn't consume must be left intact.
+  using record_batch_cb_t =
+      std::function<size_t(std::vector<std::unique_ptr<DataRecord>>&)>;
   using gap_cb_t = std::function<bool(const GapRecord&)>;
   using done_cb_t = std::function<void(logid_t)>;
   using record_copy_cb_t =
@@ -139,6 +170,10 @@ class ClientReadStreamDependencies {
    * previous request is still inflight, the previous request will be cancelled
    * and overridden by the new question so that its callback won't get called.
    *
+   * With --client-share-epoch-metadata-fetches, a request that misses the
+   * cache while another read stream of the log is reading the metadata log
+   * waits for that read and then looks up the cache again.
+   *
    * @param rsid               The ID of the calling ClientReadStream instance.
    * @param epoch              epoch for which the metadata is requested
    * @param cb                 MetaDataReader::Callback object used to deliver
@@ -197,6 +232,12 @@ class ClientReadStreamDependencies {
                                 lsn_t window_low,
                                 lsn_t window_high);
 
+  /**
+   * Tells the storage shard that a record it sent failed checksum
+   * verification, so that it can check its copy of the record.
+   */
+  virtual int sendChecksumFailMessage(ShardID shard, lsn_t lsn);
+
   /**
    * Call the application-supplied callback to deliver a record.
    */
@@ -204,6 +245,30 @@ class ClientReadStreamDependencies {
     return record_callback_ ? record_callback_(record) : true;
   }
 
+  /**
+   * If set, records are accumulated and delivered through this callback in
+   * batches of consecutive records instead of one by one through
+   * recordCallback(). See ClientReadStream::flushRecordBatch().
+   */
+  void setRecordBatchCallback(record_batch_cb_t cb) {
+    record_batch_callback_ = std::move(cb);
+  }
+
+  virtual bool hasRecordBatchCallback() const {
+    return record_batch_callback_ != nullptr;
+  }
+
+  /**
+   * Call the application-supplied callback to deliver a batch of records.
+   *
+   * @return  number of records consumed from the front of `records`
+   */
+  virtual size_t
+  recordBatchCallback(std::vector<std::unique_ptr<DataRecord>>& records) {
+    return record_batch_callback_ ? record_batch_callback_(records)
+                                  : records.size();
+  }
+
   /**
    * Call the application-supplied callback to report a gap.
    */
@@ -307,6 +372,10 @@ class ClientReadStreamDependencies {
     return client_session_id_;
   }
 
+  EpochMetaDataCache* getEpochMetaDataCache() const {
+    return metadata_cache_;
+  }
+
   // Gets the protocol version of an outgoing socket (if the socket exists).
   virtual folly::Optional<uint16_t>
       getSocketProtocolVersion(node_index_t) const;
@@ -317,11 +386,17 @@ class ClientReadStreamDependencies {
 
   virtual bool hasMemoryPressure() const;
 
+  // How long to delay a rewind that lets `shard' back into reading, to
+  // spread out the rewinds of all read streams on this worker that read
+  // from its node. See --client-read-rewind-spread.
+  virtual std::chrono::milliseconds getShardBackUpRewindDelay(ShardID shard);
+
  private:
   read_stream_id_t read_stream_id_;
   logid_t log_id_;
   std::string client_session_id_;
   record_cb_t record_callback_;
+  record_batch_cb_t record_batch_callback_;
   gap_cb_t gap_callback_;
   done_cb_t done_callback_;
   // If our owner requested health updates, this is the callback.
@@ -344,6 +419,32 @@ class ClientReadStreamDependencies {
 
   // currently running NodeSetFinder
   std::unique_ptr<NodeSetFinder> nodeset_finder_;
+
+  // request for epoch metadata waiting for another read stream's read of the
+  // metadata log, see --client-share-epoch-metadata-fetches
+  struct PendingMetaDataRequest {
+    read_stream_id_t rsid;
+    epoch_t epoch;
+    MetaDataLogReader::Callback cb;
+    bool require_consistent;
+  };
+  folly::Optional<PendingMetaDataRequest> pending_metadata_request_;
+
+  // true if nodeset_finder_ is reading the metadata log on behalf of all read
+  // streams of the log, i.e. EpochMetaDataCache::startFetch() returned true
+  bool fetching_for_cache_{false};
+
+  // set while onSharedMetaDataFetchDone() retries a pending request
+  bool retrying_after_shared_fetch_{false};
+
+  // retries pending_metadata_request_ once the read it waited for is over
+  void onSharedMetaDataFetchDone();
+
+  // lets other read streams waiting for our read of the metadata log know
+  // that it is over, if we were doing one
+  void finishSharedMetaDataFetch();
+
+  WorkerCallbackHelper<ClientReadStreamDependencies> callbackHelper_{this};
 };
 
 /**
@@ -587,6 +688,38 @@ class ClientReadStream : boost::noncopyable {
     wait_for_all_copies_ = true;
   }
 
+  /**
+   * @return  true if this stream, which must not have been started yet, may
+   *          be served by a read stream shared with other readers of the same
+   *          log (see AllClientReadStreams and --client-read-stream-sharing).
+   *          Only streams that read to the end of the log one record at a
+   *          time, without a ReaderBridge or a server-side filter, qualify.
+   */
+  bool isShareable() const;
+
+  /**
+   * @return  true if `other' requests the same records and gaps from storage
+   *          shards as this stream, i.e. the two may differ only in where they
+   *          start reading and in their callbacks.
+   */
+  bool hasSameReadOptions(const ClientReadStream& other) const;
+
+  /**
+   * Creates a stream that reads the same log with the same options and from
+   * the same LSN as this one, but has its own ID and delivers to `deps'. The
+   * new stream is not started.
+   */
+  std::unique_ptr<ClientReadStream>
+  makeSharedStream(read_stream_id_t id,
+                   std::unique_ptr<ClientReadStreamDependencies> deps) const;
+
+  /**
+   * Moves the LSN a stream that was not started yet will start reading from.
+   * Used when a reader detaches from a shared stream and continues on a
+   * private one.
+   */
+  void setStartLSN(lsn_t start_lsn);
+
   /**
    * Called when a client has consumed enough records from the queue for us to
    * ask storage shards for more data (slide the window).
@@ -666,6 +799,10 @@ class ClientReadStream : boost::noncopyable {
     return id_;
   }
 
+  logid_t getLogID() const {
+    return log_id_;
+  }
+
   const std::shared_ptr<UpdateableConfig>& getConfig() const {
     return config_;
   }
@@ -682,6 +819,10 @@ class ClientReadStream : boost::noncopyable {
     return next_lsn_to_deliver_;
   }
 
+  lsn_t getWindowHigh() const {
+    return window_high_;
+  }
+
   /**
    * Returns our current lower bound of the trim point. It's the maximum high
    * LSN of TRIM gaps we got from storage shards so far. Not necessarily a good
@@ -748,6 +889,17 @@ class ClientReadStream : boost::noncopyable {
 
   size_t getBytesBuffered() const;
 
+  /**
+   * Window size used by --client-read-window-autotune: enough records for
+   * the application to consume at `drain_rate' (records per second) during
+   * a round trip of `rtt', considering that the window slides once
+   * `flow_control_threshold' of it was delivered. Bounded by `capacity'.
+   */
+  static size_t windowSizeForBandwidthDelay(double drain_rate,
+                                            std::chrono::microseconds rtt,
+                                            double flow_control_threshold,
+                                            size_t capacity);
+
  private:
   /**
    * @return True if there are records we can ship right now to the application,
@@ -817,6 +969,21 @@ class ClientReadStream : boost::noncopyable {
    */
   int deliverRecord(std::unique_ptr<DataRecordOwnsPayload>& record);
 
+  /**
+   * If the application reads with a batch callback (see
+   * ClientReadStreamDependencies::setRecordBatchCallback()), or through a
+   * Reader with --client-read-batch-handoff, deliverRecord() only moves
+   * records to record_batch_. This hands them over to the application or
+   * the Reader with one call. It's called before anything that must not
+   * happen before the application has seen the records: delivering a gap,
+   * sliding the window and disposing of the stream. So the WINDOW messages
+   * that let storage shards send more are sent once per batch.
+   *
+   * @return 0 if all records were consumed, -1 if some were rejected; they
+   *         stay in record_batch_ and the redelivery timer is activated.
+   */
+  int flushRecordBatch();
+
   /**
    * Attempts to delivers parameter gap record.
    *
@@ -895,6 +1062,19 @@ class ClientReadStream : boost::noncopyable {
    */
   void updateWindowSize();
 
+  /**
+   * Takes a drain rate sample and returns the window size that fits it and
+   * the WINDOW round trip times of senders. Used by updateWindowSize() with
+   * --client-read-window-autotune.
+   */
+  size_t autotuneWindowSize();
+
+  /**
+   * Called when a record that `state' could only send after receiving our
+   * last WINDOW arrives. Averages the round trip into state.window_rtt.
+   */
+  void onWindowRoundTrip(SenderState& state);
+
   /**
    * Set shard's connection state. Used in tests only.
    */
@@ -1116,7 +1296,8 @@ class ClientReadStream : boost::noncopyable {
   // potential to advance next_lsn_to_deliver_ beyond until_lsn_.  If we are
   // done(), we should never yield to the event loop and stay alive.
   void disposeIfDone() {
-    if (done()) {
+    // Records still waiting in record_batch_ need to be redelivered first.
+    if (done() && record_batch_.empty()) {
       deps_->dispose();
     }
   }
@@ -1173,6 +1354,20 @@ class ClientReadStream : boost::noncopyable {
    */
   void scheduleRewind(std::string reason);
 
+  /**
+   * Schedule the rewind that lets `shard' participate in SCD again after it
+   * was in the shards down list. With --client-read-rewind-spread, it may be
+   * delayed to spread out the rewinds of all streams that read from the node
+   * and skipped if it's no longer needed. See RewindScheduler.
+   */
+  void scheduleRewindForShardBackUp(ShardID shard, std::string reason);
+
+  /**
+   * @return false if a rewind wouldn't change what storage shards are asked
+   * to send, i.e. SCD has no change to apply. Used to skip deferred rewinds.
+   */
+  bool rewindNeeded() const;
+
   /**
    * @return true if a rewind has been scheduled.
    */
@@ -1301,6 +1496,9 @@ class ClientReadStream : boost::noncopyable {
    */
   double flow_control_threshold_;
 
+  // type of buffer_, used to recreate it in setStartLSN()
+  const ClientReadStreamBufferType buffer_type_;
+
   /**
    * This member is employed to avoid doing the math every time we call
    * slideSenderWindows().
@@ -1534,6 +1732,21 @@ class ClientReadStream : boost::noncopyable {
   // Counter of the size (in bytes) of the current ReadStream.
   size_t bytes_buffered_{0};
 
+  // Records per second the application consumed between window slides,
+  // averaged. When the window last slid and num_records_delivered_ then.
+  // Only maintained with --client-read-window-autotune.
+  double drain_rate_{0};
+  std::chrono::steady_clock::time_point last_window_slide_time_;
+  size_t records_delivered_at_last_slide_{0};
+
+  // Records delivered to the application's batch callback (or to the
+  // Reader) but not yet consumed by it, in LSN order. See flushRecordBatch().
+  std::vector<std::unique_ptr<DataRecord>> record_batch_;
+
+  // Whether the Reader should notify us when it consumes record_batch_,
+  // because one of the records in it is where the window slides.
+  bool record_batch_notify_{false};
+
   /**
    * When we are in all send all mode but SCD is in use on the log, there is a
    * race condition that can cause erroneous data loss reporting. We fix this by
@@ -1559,6 +1772,7 @@ class ClientReadStream : boost::noncopyable {
   ReadStreamAttributes attrs_ = ReadStreamAttributes();
 
   friend class ClientReadStreamTest;
+  friend class ClientReadStreamBenchmark;
   friend class ClientReadStreamScd;
   friend class ClientReadStreamSenderState;
   friend class ClientReadersFlowTracer;
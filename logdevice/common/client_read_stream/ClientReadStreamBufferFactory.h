@@ -11,6 +11,7 @@
 
 #include "logdevice/common/client_read_stream/ClientReadStreamCircularBuffer.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamOrderedMapBuffer.h"
+#include "logdevice/common/client_read_stream/ClientReadStreamPackedBuffer.h"
 
 namespace facebook { namespace logdevice {
 
@@ -21,6 +22,7 @@ namespace facebook { namespace logdevice {
 enum class ClientReadStreamBufferType : uint8_t {
   CIRCULAR = 0,
   ORDERED_MAP,
+  PACKED,
 };
 
 class ClientReadStreamBufferFactory {
@@ -35,6 +37,9 @@ class ClientReadStreamBufferFactory {
       case ClientReadStreamBufferType::ORDERED_MAP:
         return std::make_unique<ClientReadStreamOrderedMapBuffer>(
             capacity, buffer_head);
+      case ClientReadStreamBufferType::PACKED:
+        return std::make_unique<ClientReadStreamPackedBuffer>(
+            capacity, buffer_head);
     }
 
     ld_check(false);
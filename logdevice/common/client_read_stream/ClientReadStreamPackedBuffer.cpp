@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/client_read_stream/ClientReadStreamPackedBuffer.h"
+
+#include <folly/lang/Bits.h>
+
+#include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+using RecordState = ClientReadStreamRecordState;
+
+ClientReadStreamPackedBuffer::ClientReadStreamPackedBuffer(size_t capacity,
+                                                           lsn_t buffer_head)
+    : capacity_(capacity),
+      slots_(new RecordState[capacity]),
+      bits_((capacity + kBitsPerWord - 1) / kBitsPerWord, 0),
+      buffer_head_(buffer_head) {
+  ld_check(capacity_ > 0);
+}
+
+bool ClientReadStreamPackedBuffer::isMarker(const RecordState& state) {
+  return state.record || state.gap || state.filtered_out;
+}
+
+void ClientReadStreamPackedBuffer::clearBits(size_t from, size_t to) {
+  ld_check(from <= to);
+  ld_check(to <= capacity_);
+  while (from < to) {
+    const size_t shift = from % kBitsPerWord;
+    const size_t n = std::min(kBitsPerWord - shift, to - from);
+    const uint64_t mask = n == kBitsPerWord ? ~uint64_t(0)
+                                            : ((uint64_t(1) << n) - 1) << shift;
+    bits_[from / kBitsPerWord] &= ~mask;
+    from += n;
+  }
+}
+
+size_t ClientReadStreamPackedBuffer::findSetBit(size_t from, size_t to) const {
+  ld_check(from <= to);
+  ld_check(to <= capacity_);
+  while (from < to) {
+    const size_t word = from / kBitsPerWord;
+    const uint64_t bits =
+        bits_[word] & (~uint64_t(0) << (from % kBitsPerWord));
+    if (bits) {
+      const size_t slot = word * kBitsPerWord + folly::findFirstSet(bits) - 1;
+      return std::min(slot, to);
+    }
+    from = (word + 1) * kBitsPerWord;
+  }
+  return to;
+}
+
+RecordState* ClientReadStreamPackedBuffer::createOrGet(lsn_t lsn) {
+  // lsn must be with in the range of
+  // [buffer_head, buffer_head + capacity() - 1]
+  if (!LSNInBuffer(lsn)) {
+    return nullptr;
+  }
+  const size_t slot = getSlot(lsn);
+  // the caller is about to turn the slot into a marker
+  setBit(slot);
+  return &slots_[slot];
+}
+
+RecordState* ClientReadStreamPackedBuffer::find(lsn_t lsn) {
+  if (!LSNInBuffer(lsn)) {
+    return nullptr;
+  }
+
+  const size_t slot = getSlot(lsn);
+  if (!testBit(slot)) {
+    ld_check(!isMarker(slots_[slot]));
+    return nullptr;
+  }
+
+  RecordState& state = slots_[slot];
+  if (!isMarker(state)) {
+    // stale bit of an empty placeholder RecordState, treat it as not
+    // exist
+    ld_check(state.list.empty());
+    return nullptr;
+  }
+
+  return &state;
+}
+
+std::pair<ClientReadStreamRecordState*, lsn_t>
+ClientReadStreamPackedBuffer::findFirstMarker() {
+  // avoid searching beyond buffer capacity
+  // avoid searching beyond LSN_MAX
+  const size_t limit =
+      std::min(capacity(), LSN_MAX - std::max(buffer_head_, 1lu) + 1);
+
+  size_t offset = 0;
+  while (offset < limit) {
+    // slots [first, last) are contiguous in the slab
+    const size_t first = toSlot(offset);
+    const size_t last = first + std::min(limit - offset, capacity_ - first);
+    const size_t slot = findSetBit(first, last);
+    offset += slot - first;
+    if (slot == last) {
+      continue;
+    }
+
+    RecordState& state = slots_[slot];
+    if (isMarker(state)) {
+      return std::make_pair(&state, buffer_head_ + offset);
+    }
+    // for slot that is not a record/gap marker, its list must be
+    // empty
+    ld_check(state.list.empty());
+    clearBit(slot);
+    ++offset;
+  }
+
+  // no gap/record marker in buffer
+  return std::make_pair(nullptr, LSN_INVALID);
+}
+
+ClientReadStreamRecordState* ClientReadStreamPackedBuffer::front() {
+  RecordState& state = slots_[head_];
+  if (testBit(head_) && isMarker(state)) {
+    return &state;
+  }
+
+  // the descriptor is a placeholder, return nullptr
+  ld_check(!isMarker(state));
+  ld_check(state.list.empty());
+  return nullptr;
+}
+
+void ClientReadStreamPackedBuffer::popFront() {
+  RecordState& state = slots_[head_];
+  // record and list, if exist, must be already consumed
+  ld_check(!state.record && !state.filtered_out);
+  ld_check(state.list.empty());
+  state.reset();
+  clearBit(head_);
+}
+
+void ClientReadStreamPackedBuffer::advanceBufferHead(size_t offset) {
+  // Important: caller needs to ensure that there must not be any marker
+  // in the buffer slots that get advanced. Assert in the following statements.
+  const size_t advanced = std::min(offset, capacity());
+
+  if (folly::kIsDebug) {
+    size_t limit = std::min(advanced, LSN_MAX - buffer_head_ + 1);
+    for (size_t i = 0; i < limit; ++i) {
+      const RecordState& state = slots_[toSlot(i)];
+      ld_check(!isMarker(state));
+      ld_check(state.list.empty());
+    }
+  }
+
+  // the slots that are advanced over become the tail of the buffer and must
+  // not keep stale bits
+  if (advanced == capacity_) {
+    clearBits(0, capacity_);
+  } else {
+    const size_t end = head_ + advanced;
+    clearBits(head_, std::min(end, capacity_));
+    if (end > capacity_) {
+      clearBits(0, end - capacity_);
+    }
+  }
+
+  head_ = toSlot(offset % capacity_);
+  buffer_head_ += offset;
+}
+
+void ClientReadStreamPackedBuffer::clear() {
+  size_t slot = findSetBit(0, capacity_);
+  while (slot < capacity_) {
+    slots_[slot].reset();
+    slot = findSetBit(slot + 1, capacity_);
+  }
+  clearBits(0, capacity_);
+}
+
+void ClientReadStreamPackedBuffer::forEachUpto(
+    lsn_t to,
+    std::function<void(lsn_t, RecordState& record)> callback) {
+  ld_check(to >= buffer_head_);
+  forEach(buffer_head_,
+          to,
+          [cb = std::move(callback)](lsn_t lsn, RecordState& rstate) {
+            cb(lsn, rstate);
+            return true;
+          });
+}
+
+void ClientReadStreamPackedBuffer::forEach(
+    lsn_t from,
+    lsn_t to,
+    std::function<bool(lsn_t, ClientReadStreamRecordState& record)> cb) {
+  const bool reverse = from > to;
+  size_t count = (reverse) ? from - to + 1 : to - from + 1;
+  size_t limit = std::min(count, capacity());
+  for (size_t i = 0; i < limit; i++) {
+    const size_t slot = getSlot(from);
+    RecordState& state = slots_[slot];
+    const bool keep_going = cb(from, state);
+    // the callback may have turned the slot into a marker
+    if (isMarker(state) || !state.list.empty()) {
+      setBit(slot);
+    }
+    if (!keep_going) {
+      break;
+    }
+    from += (reverse) ? -1 : 1;
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/client_read_stream/ClientReadStreamBuffer.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file ClientReadStreamPackedBuffer is an implementation of
+ *       ClientReadStreamBuffer that, like ClientReadStreamCircularBuffer,
+ *       preallocates a RecordState descriptor for every LSN in the buffer in a
+ *       single contiguous slab used as a ring. In addition it keeps a packed
+ *       bitmap with one bit per slot, set for every slot that may hold a
+ *       record, gap or filtered out marker.
+ *
+ *       Most of the slots of a read stream's buffer are empty placeholders,
+ *       and scanning them one RecordState at a time touches a cache line every
+ *       couple of slots. findFirstMarker() and front() look at the bitmap
+ *       first, which covers 512 slots per cache line.
+ *
+ *       A bit may be stale (set for a slot that has become an empty
+ *       placeholder again, e.g. because ClientReadStream reset it in place);
+ *       such bits are cleared lazily when a scan finds them. A bit is never
+ *       clear for a slot that is not an empty placeholder.
+ */
+
+class ClientReadStreamPackedBuffer : public ClientReadStreamBuffer {
+ public:
+  ClientReadStreamPackedBuffer(size_t capacity, lsn_t buffer_head);
+
+  // see ClientReadStreamBuffer::createOrGet()
+  // complexity O(1)
+  ClientReadStreamRecordState* createOrGet(lsn_t lsn) override;
+
+  // see ClientReadStreamBuffer::find()
+  // complexity O(1)
+  ClientReadStreamRecordState* find(lsn_t lsn) override;
+
+  // see ClientReadStreamBuffer::findFirstMarker()
+  // complexity O(n / 64 + k) in which n is the number of descriptor slots in
+  // the buffer and k is the number of stale bits before the first marker
+  std::pair<ClientReadStreamRecordState*, lsn_t> findFirstMarker() override;
+
+  // see ClientReadStreamBuffer::front()
+  // complexity O(1)
+  ClientReadStreamRecordState* front() override;
+
+  // see ClientReadStreamBuffer::popFront()
+  // complexity O(1)
+  void popFront() override;
+
+  // see ClientReadStreamBuffer::advanceBufferHead()
+  // complexity O(min(n, offset) / 64)
+  void advanceBufferHead(size_t offset = 1) override;
+
+  // see ClientReadStreamBuffer::capacity()
+  size_t capacity() const override {
+    return capacity_;
+  }
+
+  // see ClientReadStreamBuffer::clear()
+  // complexity O(n / 64 + m) in which m is the number of set bits
+  void clear() override;
+
+  // see ClientReadStreamBuffer::forEachUpto()
+  // complexity O(min(n, to - buffer_head_))
+  void forEachUpto(
+      lsn_t to,
+      std::function<void(lsn_t, ClientReadStreamRecordState& record)> cb)
+      override;
+
+  // see ClientReadStreamBuffer::forEach()
+  // complexity O(min(n, abs(to - from)))
+  void forEach(lsn_t from,
+               lsn_t to,
+               std::function<bool(lsn_t, ClientReadStreamRecordState& record)>
+                   cb) override;
+
+  // see ClientReadStreamBuffer::getBufferHead()
+  lsn_t getBufferHead() const override {
+    return buffer_head_;
+  }
+
+ private:
+  static constexpr size_t kBitsPerWord = 64;
+
+  // get the slot index for the given lsn. lsn must fit in the current buffer
+  size_t getSlot(lsn_t lsn) const {
+    ld_assert(LSNInBuffer(lsn));
+    return toSlot(lsn - buffer_head_);
+  }
+
+  // get the slot index for the given offset from buffer head
+  size_t toSlot(size_t offset) const {
+    ld_check(offset < capacity_);
+    const size_t slot = head_ + offset;
+    return slot >= capacity_ ? slot - capacity_ : slot;
+  }
+
+  bool testBit(size_t slot) const {
+    return bits_[slot / kBitsPerWord] & (uint64_t(1) << (slot % kBitsPerWord));
+  }
+  void setBit(size_t slot) {
+    bits_[slot / kBitsPerWord] |= uint64_t(1) << (slot % kBitsPerWord);
+  }
+  void clearBit(size_t slot) {
+    bits_[slot / kBitsPerWord] &= ~(uint64_t(1) << (slot % kBitsPerWord));
+  }
+
+  // clears bits of slots [from, to)
+  void clearBits(size_t from, size_t to);
+
+  // @return  the first slot in [from, to) whose bit is set, or `to' if there
+  //          is none
+  size_t findSetBit(size_t from, size_t to) const;
+
+  // true if the slot is a record, gap or filtered out marker
+  static bool isMarker(const ClientReadStreamRecordState& state);
+
+  const size_t capacity_;
+  // contiguous slab with descriptors of all slots
+  std::unique_ptr<ClientReadStreamRecordState[]> slots_;
+  // one bit per slot, see @file
+  std::vector<uint64_t> bits_;
+  // slot of buffer_head_
+  size_t head_{0};
+  // tracks the buffer head
+  lsn_t buffer_head_;
+};
+
+}} // namespace facebook::logdevice
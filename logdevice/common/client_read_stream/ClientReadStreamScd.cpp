@@ -244,11 +244,10 @@ bool ClientReadStreamScd::allSendAllFailoverTimerCallback(
   return true;
 }
 
-bool ClientReadStreamScd::FilteredOut::applyDeferredChanges() {
-  small_shardset_t temp_shards_down;
-  small_shardset_t temp_shards_slow;
-  small_shardset_t temp_all_shards;
-
+bool ClientReadStreamScd::FilteredOut::computeDeferredChanges(
+    small_shardset_t& temp_shards_down,
+    small_shardset_t& temp_shards_slow,
+    small_shardset_t& temp_all_shards) const {
   for (const auto& shard : new_shards_down_) {
     temp_shards_down.push_back(shard);
     temp_all_shards.push_back(shard);
@@ -276,6 +275,17 @@ bool ClientReadStreamScd::FilteredOut::applyDeferredChanges() {
     ld_assert(equal(temp_all_shards, all_shards_));
     return false;
   }
+  return true;
+}
+
+bool ClientReadStreamScd::FilteredOut::applyDeferredChanges() {
+  small_shardset_t temp_shards_down;
+  small_shardset_t temp_shards_slow;
+  small_shardset_t temp_all_shards;
+  if (!computeDeferredChanges(
+          temp_shards_down, temp_shards_slow, temp_all_shards)) {
+    return false;
+  }
 
   shards_down_ = std::move(temp_shards_down);
   shards_slow_ = std::move(temp_shards_slow);
@@ -283,6 +293,14 @@ bool ClientReadStreamScd::FilteredOut::applyDeferredChanges() {
   return true;
 }
 
+bool ClientReadStreamScd::FilteredOut::hasDeferredChanges() const {
+  small_shardset_t temp_shards_down;
+  small_shardset_t temp_shards_slow;
+  small_shardset_t temp_all_shards;
+  return computeDeferredChanges(
+      temp_shards_down, temp_shards_slow, temp_all_shards);
+}
+
 bool ClientReadStreamScd::FilteredOut::deferredAddShardDown(ShardID shard) {
   if (!new_shards_down_.insert(shard).second) {
     return false;
@@ -460,6 +478,11 @@ bool ClientReadStreamScd::checkNeedsFailoverToAllSendAll() {
   return false;
 }
 
+bool ClientReadStreamScd::hasScheduledChanges() const {
+  return scheduled_mode_transition_.hasValue() ||
+      filtered_out_.hasDeferredChanges();
+}
+
 void ClientReadStreamScd::scheduleRewindIfShardBackUp(
     ClientReadStreamSenderState& state) {
   ld_check(isActive());
@@ -472,7 +495,8 @@ void ClientReadStreamScd::scheduleRewindIfShardBackUp(
       ld_debug(
           "%s started delivering records or exited an under replicated region",
           state.getShardID().toString().c_str());
-      owner_->scheduleRewind(
+      owner_->scheduleRewindForShardBackUp(
+          state.getShardID(),
           folly::format("{} no longer down", state.getShardID().toString())
               .str());
     }
@@ -162,6 +162,12 @@ class ClientReadStreamScd : public boost::noncopyable {
    */
   void applyScheduledChanges();
 
+  /**
+   * @return true if applyScheduledChanges() has a mode transition or a change
+   * to the filtered out list to apply.
+   */
+  bool hasScheduledChanges() const;
+
   /**
    * Schedule a rewind to the given mode.
    * This function asserts that the current mode is not the requested mode.
@@ -416,6 +422,9 @@ class ClientReadStreamScd : public boost::noncopyable {
     // @returns whether there were any changes at all to be applied
     bool applyDeferredChanges();
 
+    // @returns whether applyDeferredChanges() would change anything
+    bool hasDeferredChanges() const;
+
     // Removes the shard from the filtered out list (including shards
     // down/slow list). Returns true if the shard was in the list.
     // If the shard was not in the list but was scheduled to be added,
@@ -426,6 +435,12 @@ class ClientReadStreamScd : public boost::noncopyable {
     void clear();
 
    private:
+    // Computes the lists applyDeferredChanges() would set into the given
+    // empty lists. @returns whether they differ from the current ones.
+    bool computeDeferredChanges(small_shardset_t& temp_shards_down,
+                                small_shardset_t& temp_shards_slow,
+                                small_shardset_t& temp_all_shards) const;
+
     // The current shards slow/down list
     small_shardset_t shards_slow_;
     small_shardset_t shards_down_;
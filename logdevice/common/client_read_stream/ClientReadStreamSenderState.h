@@ -78,20 +78,19 @@ class ClientReadStreamSenderState : boost::noncopyable {
   };
 
   /**
+   * The reconnect, STARTED and WINDOW retry timers are only created when
+   * first activated, and the first two are destroyed again once the shard
+   * is READING. Most senders of a healthy tailing stream never need them,
+   * and a client with many streams would otherwise hold three timers per
+   * shard per stream.
+   *
    * @param client_read_stream pointer to owner ClientReadStream instance
-   * @param deps               pointer to ClientReadStreamDependencies instance
    * @param shard_id           ID of the shard to read from
-   * @param node_d             ID of the node this shard belongs to.
-   * @param reconnect_timer    timer to use when reconnecting
-   * @param started_timer      timer to use when waiting for STARTED
-   * @param retry_window_timer timer to use when resending WINDOW messages
+   * @param deps               used to create timers
    */
-  ClientReadStreamSenderState(
-      ClientReadStream* client_read_stream,
-      ShardID shard_id,
-      std::unique_ptr<BackoffTimer>&& reconnect_timer,
-      std::unique_ptr<BackoffTimer>&& started_timer,
-      std::unique_ptr<BackoffTimer>&& retry_window_timer);
+  ClientReadStreamSenderState(ClientReadStream* client_read_stream,
+                              ShardID shard_id,
+                              ClientReadStreamDependencies* deps);
 
   /**
    * The largest LSN such that this node sent a data record that is >= next_lsn_
@@ -155,6 +154,17 @@ class ClientReadStreamSenderState : boost::noncopyable {
    */
   lsn_t under_replicated_until = LSN_INVALID;
 
+  /**
+   * Round trip of WINDOW messages, used with --client-read-window-autotune.
+   * When a WINDOW is sent, window_rtt_probe_lsn is set to the first LSN the
+   * sender wasn't allowed to send before, and the time from sending it until
+   * a record at or after that LSN arrives is averaged into window_rtt.
+   * LSN_INVALID if no round trip is being measured.
+   */
+  lsn_t window_rtt_probe_lsn = LSN_INVALID;
+  std::chrono::steady_clock::time_point window_sent_time;
+  std::chrono::microseconds window_rtt{0};
+
   // Pointer to owner
   ClientReadStream* client_read_stream_;
 
@@ -245,15 +255,19 @@ class ClientReadStreamSenderState : boost::noncopyable {
   void activateReconnectTimer();
 
   void cancelReconnectTimer() {
-    reconnect_timer_->cancel();
+    if (reconnect_timer_) {
+      reconnect_timer_->cancel();
+    }
   }
 
   void resetReconnectTimer() {
-    reconnect_timer_->reset();
+    if (reconnect_timer_) {
+      reconnect_timer_->reset();
+    }
   }
 
   bool reconnectTimerIsActive() const {
-    return reconnect_timer_->isActive();
+    return reconnect_timer_ && reconnect_timer_->isActive();
   }
 
   void activateStartedTimer();
@@ -267,19 +281,43 @@ class ClientReadStreamSenderState : boost::noncopyable {
   void extendStartedTimer(filter_version_t);
 
   void resetStartedTimer() {
-    started_timer_->reset();
+    if (started_timer_) {
+      started_timer_->reset();
+    }
   }
 
   void cancelStartedTimer() {
-    started_timer_->cancel();
+    if (started_timer_) {
+      started_timer_->cancel();
+    }
   }
 
-  void activateRetryWindowTimer() {
-    retry_window_timer_->activate();
-  }
+  void activateRetryWindowTimer();
 
   void resetRetryWindowTimer() {
-    retry_window_timer_->reset();
+    if (retry_window_timer_) {
+      retry_window_timer_->reset();
+    }
+  }
+
+  /**
+   * Destroys the reconnect and STARTED timers. This is equivalent to
+   * resetting them, since they are recreated with their initial delay the
+   * next time they are activated. Called once the shard is READING.
+   *
+   * Must not be called from the callback of either timer.
+   */
+  void releaseConnectionTimers() {
+    reconnect_timer_.reset();
+    started_timer_.reset();
+  }
+
+  /**
+   * @return  number of timers currently allocated for this sender.
+   */
+  size_t numTimersAllocated() const {
+    return (reconnect_timer_ ? 1 : 0) + (started_timer_ ? 1 : 0) +
+        (retry_window_timer_ ? 1 : 0);
   }
 
   ShardID getShardID() const {
@@ -305,6 +343,12 @@ class ClientReadStreamSenderState : boost::noncopyable {
   void startedTimerCallback();
 
  private:
+  BackoffTimer& getReconnectTimer();
+  BackoffTimer& getStartedTimer();
+  BackoffTimer& getRetryWindowTimer();
+
+  ClientReadStreamDependencies* deps_;
+
   /**
    * Upper end of the window that this storage node knows about.  We keep
    * track of this to avoid sending duplicate WINDOW messages.
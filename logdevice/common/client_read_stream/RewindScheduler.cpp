@@ -11,6 +11,8 @@
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
 
 namespace facebook { namespace logdevice {
 
@@ -22,27 +24,68 @@ void RewindScheduler::schedule(TimeoutMap* map, std::string reason) {
     // rewind is already scheduled. concatenate the reasons to not overwrite
     // the original one.
     reason_ += "\n" + reason;
+    if (deferrable_) {
+      // The scheduled rewind is needed now. Don't wait longer than if it was
+      // scheduled by this call.
+      deferrable_ = false;
+      using std::chrono::microseconds;
+      const auto remaining = std::chrono::duration_cast<microseconds>(
+          undeferred_time_ - SteadyTimestamp::now());
+      timer_->activate(std::max(remaining, microseconds::zero()), map);
+    }
   } else {
     reason_ = std::move(reason);
-
-    // Decrease delay according to how much time passed since the last call to
-    // positiveFeedback() (last scheduled rewind).
-    delay_.positiveFeedback(SteadyTimestamp::now());
-    timer_->activate(delay_.getCurrentValue(), map);
+    deferrable_ = false;
+    timer_->activate(nextDelay(), map);
     assert(isScheduled());
+  }
+}
 
-    // Double delay for the next time since we are scheduling a rewind.
-    delay_.negativeFeedback();
-
-    // First tick of positive feedback so that we know how much linear decrease
-    // to apply next time schedule() is called.
-    delay_.positiveFeedback(SteadyTimestamp::now());
+void RewindScheduler::scheduleDeferrable(TimeoutMap* map,
+                                         std::string reason,
+                                         std::chrono::milliseconds delay) {
+  if (isScheduled()) {
+    reason_ += "\n" + reason;
+    return;
+  }
+  reason_ = std::move(reason);
+  deferrable_ = true;
+  const std::chrono::milliseconds undeferred = nextDelay();
+  undeferred_time_ = SteadyTimestamp::now() + undeferred;
+  if (delay > undeferred) {
+    WORKER_STAT_INCR(client.read_streams_rewinds_delayed);
   }
+  timer_->activate(std::max(delay, undeferred), map);
+  assert(isScheduled());
+}
+
+std::chrono::milliseconds RewindScheduler::nextDelay() {
+  // Decrease delay according to how much time passed since the last call to
+  // positiveFeedback() (last scheduled rewind).
+  delay_.positiveFeedback(SteadyTimestamp::now());
+  const std::chrono::milliseconds delay = delay_.getCurrentValue();
+
+  // Double delay for the next time since we are scheduling a rewind.
+  delay_.negativeFeedback();
+
+  // First tick of positive feedback so that we know how much linear decrease
+  // to apply next time schedule() is called.
+  delay_.positiveFeedback(SteadyTimestamp::now());
+  return delay;
 }
 
 void RewindScheduler::rewind() {
   std::string reason_tmp;
   std::swap(reason_tmp, reason_);
+  if (deferrable_) {
+    deferrable_ = false;
+    if (!owner_->rewindNeeded()) {
+      ld_debug("Skipping rewind that is no longer needed: %s",
+               reason_tmp.c_str());
+      WORKER_STAT_INCR(client.read_streams_rewinds_skipped);
+      return;
+    }
+  }
   owner_->rewind(std::move(reason_tmp));
   // Note: rewind() may schedule another rewind.
 }
@@ -50,10 +93,15 @@ void RewindScheduler::rewind() {
 void RewindScheduler::cancel() {
   timer_->cancel();
   reason_.clear();
+  deferrable_ = false;
 }
 
 bool RewindScheduler::isScheduled() const {
   return timer_->isActive();
 }
 
+bool RewindScheduler::isImminent() const {
+  return isScheduled() && !deferrable_;
+}
+
 }} // namespace facebook::logdevice
@@ -11,6 +11,7 @@
 
 #include "logdevice/common/ExponentialBackoffAdaptiveVariable.h"
 #include "logdevice/common/Timer.h"
+#include "logdevice/common/Timestamp.h"
 
 namespace facebook { namespace logdevice {
 
@@ -35,6 +36,17 @@ class RewindScheduler {
    */
   void schedule(TimeoutMap* map, std::string reason);
 
+  /**
+   * Schedule a rewind that reading doesn't depend on to make progress, after
+   * at least `delay'. When it is due, it is skipped if
+   * ClientReadStream::rewindNeeded() says there is nothing to rewind for. If
+   * schedule() is called while it is pending, the rewind happens as soon as
+   * schedule() alone would have done it and is not skipped.
+   */
+  void scheduleDeferrable(TimeoutMap* map,
+                          std::string reason,
+                          std::chrono::milliseconds delay);
+
   /**
    * Cancel any scheduled rewind.
    */
@@ -45,6 +57,13 @@ class RewindScheduler {
    */
   bool isScheduled() const;
 
+  /**
+   * @returns True if a rewind is scheduled that will not be skipped, i.e.
+   *          streams will be sent START soon. Deferrable rewinds may be
+   *          delayed by seconds, so reading goes on as usual until then.
+   */
+  bool isImminent() const;
+
  private:
   ClientReadStream* owner_;
 
@@ -65,6 +84,15 @@ class RewindScheduler {
 
   std::unique_ptr<Timer> timer_;
 
+  // True if all rewinds merged into the scheduled one were deferrable.
+  bool deferrable_{false};
+
+  // When the scheduled rewind would have happened if it wasn't deferrable.
+  SteadyTimestamp undeferred_time_;
+
+  // Applies the adaptive delay and returns it.
+  std::chrono::milliseconds nextDelay();
+
   void rewind();
 };
 
@@ -49,6 +49,40 @@ bool parseTraceLogger(const folly::dynamic& clusterMap,
     output.default_sampling = def_iter->second.asDouble();
   }
 
+  def_iter = tracerSection.find("default-max-samples-per-sec");
+  if (def_iter != tracerSection.items().end()) {
+    if (!def_iter->second.isInt() || def_iter->second.asInt() < 0) {
+      ld_error("\"trace-logger.default-max-samples-per-sec\" entry is not a "
+               "non-negative integer");
+      err = E::INVALID_CONFIG;
+      return false;
+    }
+    output.default_max_samples_per_sec = def_iter->second.asInt();
+  }
+
+  auto budgets_iter = tracerSection.find("max-samples-per-sec");
+  if (budgets_iter != tracerSection.items().end()) {
+    const folly::dynamic& budgets = budgets_iter->second;
+    if (!budgets.isObject()) {
+      ld_error("\"trace-logger.max-samples-per-sec\" entry is not a JSON "
+               "object");
+      err = E::INVALID_CONFIG;
+      return false;
+    }
+    output.max_samples_per_sec.clear();
+    for (auto& pair : budgets.items()) {
+      if (!pair.first.isString() || !pair.second.isInt() ||
+          pair.second.asInt() < 0) {
+        ld_error("Invalid entry in \"max-samples-per-sec\" section. "
+                 "Expected a map from String -> non-negative Integer");
+        err = E::INVALID_CONFIG;
+        return false;
+      }
+      output.max_samples_per_sec.insert(
+          std::make_pair(pair.first.asString(), pair.second.asInt()));
+    }
+  }
+
   iter = tracerSection.find("tracers");
   if (iter == clusterMap.items().end()) {
     return true; // trace-logger.tracers is optional and have defaults
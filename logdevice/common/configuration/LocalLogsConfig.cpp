@@ -13,9 +13,11 @@
 #include "logdevice/common/configuration/LogsConfigParser.h"
 #include "logdevice/common/configuration/ParsingHelpers.h"
 #include "logdevice/common/configuration/ReplicationProperty.h"
+#include "logdevice/common/configuration/logs/LazyLogsConfigTree.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/include/Err.h"
 
+using facebook::logdevice::logsconfig::LazyLogsConfigTree;
 using facebook::logdevice::logsconfig::LogGroupNode;
 
 namespace facebook { namespace logdevice { namespace configuration {
@@ -70,6 +72,18 @@ LocalLogsConfig::getLogGroupPath(logid_t id) const {
     return folly::none;
   }
 
+  if (const LazyLogsConfigTree* lazy = lazyTree()) {
+    std::string path;
+    if (lazy->getLogGroupByID(id, &path)) {
+      return path;
+    }
+    const LogGroupInDirectory* internal = internal_logs_.getLogGroupByID(id);
+    if (internal) {
+      return internal->getFullyQualifiedName();
+    }
+    return folly::none;
+  }
+
   const LogGroupInDirectory* res = getLogGroupInDirectoryByIDRaw(id);
   if (res) {
     return res->getFullyQualifiedName();
@@ -80,8 +94,7 @@ LocalLogsConfig::getLogGroupPath(logid_t id) const {
 
 const LocalLogsConfig::LogGroupInDirectory* FOLLY_NULLABLE
 LocalLogsConfig::getLogGroupInDirectoryByIDRaw(logid_t id) const {
-  const logsconfig::LogGroupInDirectory* res =
-      config_tree_->getLogGroupByID(id);
+  const logsconfig::LogGroupInDirectory* res = tree()->getLogGroupByID(id);
 
   if (res) {
     return res;
@@ -99,6 +112,10 @@ bool LocalLogsConfig::logExists(logid_t id) const {
   // Use the masked logid to find the data log in the config because we don't
   // store the metadata logs in the tree
   const logid_t data_log_id = MetaDataLog::dataLogID(id);
+  if (const LazyLogsConfigTree* lazy = lazyTree()) {
+    return lazy->logExists(data_log_id) ||
+        internal_logs_.logExists(data_log_id);
+  }
   return config_tree_->logExists(data_log_id) ||
       internal_logs_.logExists(data_log_id);
 }
@@ -106,6 +123,15 @@ bool LocalLogsConfig::logExists(logid_t id) const {
 std::shared_ptr<LogGroupNode>
 LocalLogsConfig::getLogGroupByIDShared(logid_t id) const {
   // LogGroupNode can be both a normal or an internal log
+  if (const LazyLogsConfigTree* lazy = lazyTree()) {
+    std::shared_ptr<LogGroupNode> group = lazy->getLogGroupByID(id);
+    if (group) {
+      return group;
+    }
+    const logsconfig::LogGroupInDirectory* internal =
+        internal_logs_.getLogGroupByID(id);
+    return internal ? internal->log_group : nullptr;
+  }
   const logsconfig::LogGroupInDirectory* res =
       config_tree_->getLogGroupByID(id);
   if (!res) {
@@ -126,8 +152,7 @@ void LocalLogsConfig::getLogGroupByIDAsync(
 void LocalLogsConfig::getLogRangeByNameAsync(
     std::string name,
     std::function<void(Status, logid_range_t)> cb) const {
-  std::shared_ptr<logsconfig::LogGroupNode> result =
-      config_tree_->findLogGroup(name);
+  std::shared_ptr<logsconfig::LogGroupNode> result = getLogGroup(name);
   if (result == nullptr) {
     cb(E::NOTFOUND, std::make_pair(LOGID_INVALID, LOGID_INVALID));
     return;
@@ -137,12 +162,14 @@ void LocalLogsConfig::getLogRangeByNameAsync(
 
 std::shared_ptr<logsconfig::LogGroupNode>
 LocalLogsConfig::getLogGroupByName(std::string name) const {
-  logid_range_t res;
-  return config_tree_->findLogGroup(name);
+  return getLogGroup(name);
 }
 
 std::shared_ptr<logsconfig::LogGroupNode>
 LocalLogsConfig::getLogGroup(const std::string& path) const {
+  if (const LazyLogsConfigTree* lazy = lazyTree()) {
+    return lazy->findLogGroup(path);
+  }
   return config_tree_->findLogGroup(path);
 }
 
@@ -168,10 +195,10 @@ void LocalLogsConfig::getLogRangesByNamespaceAsync(
   ld_check(config_tree_ != nullptr);
   DirectoryNode* dir;
   // an empty string is a special case, we need all directories in the tree
-  if (ns.size() == 0 || ns == config_tree_->delimiter()) {
-    dir = config_tree_->root();
+  if (ns.size() == 0 || ns == tree()->delimiter()) {
+    dir = tree()->root();
   } else {
-    dir = config_tree_->findDirectory(ns);
+    dir = tree()->findDirectory(ns);
   }
 
   LogsConfig::NamespaceRangeLookupMap res;
@@ -194,7 +221,7 @@ LocalLogsConfig::insert(DirectoryNode* parent,
   // the intermediate namespace (if exists).
   // That's why we set (addIntermediateDirectories = true)
   std::string failure_reason;
-  auto ret = config_tree_->addLogGroup(parent,
+  auto ret = tree()->addLogGroup(parent,
                                        name,
                                        logid_interval,
                                        attrs,
@@ -218,9 +245,9 @@ LocalLogsConfig::insertNamespace(DirectoryNode* parent,
   DirectoryNode* actual_parent = parent;
   // if no parent was passed we fallback to the root of the tree
   if (actual_parent == nullptr) {
-    parent = config_tree_->root();
+    parent = tree()->root();
   }
-  return config_tree_->addDirectory(parent, name, log_attrs);
+  return tree()->addDirectory(parent, name, log_attrs);
 }
 
 bool LocalLogsConfig::replaceLogGroup(const std::string& path,
@@ -228,7 +255,7 @@ bool LocalLogsConfig::replaceLogGroup(const std::string& path,
   ld_check(config_tree_ != nullptr);
   was_modified_in_place_.store(true);
   std::string failure_reason;
-  bool ret = config_tree_->replaceLogGroup(path, new_log_group, failure_reason);
+  bool ret = tree()->replaceLogGroup(path, new_log_group, failure_reason);
   if (!ret) {
     ld_info("Failed to replace LogGroup '%s' %s",
             path.c_str(),
@@ -245,7 +272,7 @@ LocalLogsConfig::insert(logid_t::raw_type logid,
   was_modified_in_place_.store(true);
   std::string failure_reason;
   auto ret =
-      config_tree_->addLogGroup(name,
+      tree()->addLogGroup(name,
                                 logid_range_t(logid_t(logid), logid_t(logid)),
                                 std::move(attrs),
                                 false /* overwrite */,
@@ -265,7 +292,7 @@ std::shared_ptr<logsconfig::LogGroupNode> LocalLogsConfig::insert(
   ld_check(config_tree_ != nullptr);
   was_modified_in_place_.store(true);
   std::string failure_reason;
-  auto added_group = config_tree_->addLogGroup(
+  auto added_group = tree()->addLogGroup(
       name,
       logid_range_t(
           logid_t(logid_interval.lower()), logid_t(logid_interval.upper() - 1)),
@@ -286,12 +313,12 @@ bool LocalLogsConfig::isValid(const ServerConfig& server_config) const {
 }
 
 size_t LocalLogsConfig::size() const {
-  return config_tree_->size() + internal_logs_.size();
+  return tree()->size() + internal_logs_.size();
 }
 
 ReplicationProperty LocalLogsConfig::getNarrowestReplication() {
   if (narrowest_replication_cache_.isEmpty()) {
-    narrowest_replication_cache_ = config_tree_->getNarrowestReplication();
+    narrowest_replication_cache_ = tree()->getNarrowestReplication();
     for (auto it = internal_logs_.logsBegin(); it != internal_logs_.logsEnd();
          ++it) {
       narrowest_replication_cache_ = narrowest_replication_cache_.narrowest(
@@ -301,4 +328,30 @@ ReplicationProperty LocalLogsConfig::getNarrowestReplication() {
   return narrowest_replication_cache_;
 }
 
+LocalLogsConfig::LogsConfigTree* LocalLogsConfig::tree() const {
+  if (is_lazy_.load()) {
+    std::lock_guard<std::mutex> lock(materialize_mutex_);
+    if (is_lazy_.load()) {
+      // Lookups served from lazy_tree_ don't touch config_tree_, and
+      // deserializing it doesn't change its version or delimiter.
+      config_tree_->materialize();
+      is_lazy_.store(false);
+    }
+  }
+  return config_tree_.get();
+}
+
+std::unique_ptr<LocalLogsConfig::LogsConfigTree>
+LocalLogsConfig::copyTree() const {
+  // A copy of a lazy tree is lazy as well.
+  std::lock_guard<std::mutex> lock(materialize_mutex_);
+  return config_tree_->copy();
+}
+
+void LocalLogsConfig::onLogsConfigTreeSet() {
+  std::lock_guard<std::mutex> lock(materialize_mutex_);
+  lazy_tree_ = config_tree_ ? config_tree_->getLazyTree() : nullptr;
+  is_lazy_.store(config_tree_ && config_tree_->isLazy());
+}
+
 }}} // namespace facebook::logdevice::configuration
@@ -7,7 +7,9 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include <boost/container/flat_map.hpp>
@@ -32,6 +34,11 @@ struct ConfigParserOptions;
  * @file A container for logs config that is fully stored locally, i.e.
  *       fully available to this node. Loads the config from the file and
  *       serves it from memory.
+ *
+ *       The LogsConfigTree may be lazy (see LogsConfigTree::createLazy()), in
+ *       which case log groups looked up by id or by name are served from the
+ *       serialized tree and the tree is only deserialized, once, when some
+ *       other method needs it.
  */
 
 namespace facebook { namespace logdevice { namespace configuration {
@@ -104,7 +111,7 @@ class LocalLogsConfig : public LogsConfig {
   folly::Optional<std::string> getLogGroupPath(logid_t id) const;
 
   std::chrono::seconds getMaxBacklogDuration() const {
-    return config_tree_->getMaxBacklogDuration();
+    return tree()->getMaxBacklogDuration();
   }
 
   void setInternalLogsConfig(const InternalLogs& internal_logs) {
@@ -119,22 +126,22 @@ class LocalLogsConfig : public LogsConfig {
 
   LocalLogsConfigIterator logsBegin() const {
     return LocalLogsConfigIterator(
-        &internal_logs_, config_tree_.get(), config_tree_->logsBegin(), false);
+        &internal_logs_, tree(), tree()->logsBegin(), false);
   }
 
   LocalLogsConfigIterator logsEnd() const {
     return LocalLogsConfigIterator(
-        &internal_logs_, config_tree_.get(), internal_logs_.logsEnd(), true);
+        &internal_logs_, tree(), internal_logs_.logsEnd(), true);
   }
 
   LocalLogsConfigReverseIterator logsRBegin() const {
     return LocalLogsConfigReverseIterator(
-        &internal_logs_, config_tree_.get(), config_tree_->logsRBegin(), false);
+        &internal_logs_, tree(), tree()->logsRBegin(), false);
   }
 
   LocalLogsConfigReverseIterator logsREnd() const {
     return LocalLogsConfigReverseIterator(
-        &internal_logs_, config_tree_.get(), internal_logs_.logsREnd(), true);
+        &internal_logs_, tree(), internal_logs_.logsREnd(), true);
   }
 
   std::shared_ptr<logsconfig::LogGroupNode>
@@ -166,7 +173,7 @@ class LocalLogsConfig : public LogsConfig {
   bool isValid(const ServerConfig& server_config) const;
 
   const LogMap& getLogMap() const {
-    return config_tree_->getLogMap();
+    return tree()->getLogMap();
   }
 
   size_t size() const;
@@ -178,24 +185,32 @@ class LocalLogsConfig : public LogsConfig {
   // replaces the underlying logsconfig tree
   void setLogsConfigTree(std::unique_ptr<LogsConfigTree> tree) {
     config_tree_ = std::move(tree);
+    onLogsConfigTreeSet();
     // invalidate the narrowest replication cache
     narrowest_replication_cache_.clear();
   }
+  // Deserializes the tree if it is lazy.
   const LogsConfigTree& getLogsConfigTree() const {
-    return *config_tree_;
+    return *tree();
   }
   DirectoryNode* getRootNamespace() const {
     ld_check(config_tree_ != nullptr);
-    return config_tree_->root();
+    return tree()->root();
   }
 
   // deletes the underlying tree
   void clearLogsConfigTree() {
     config_tree_ = nullptr;
+    onLogsConfigTreeSet();
     // invalidate the narrowest replication cache
     narrowest_replication_cache_.clear();
   }
 
+  // true if the tree is lazy and was not deserialized yet
+  bool isLazy() const {
+    return is_lazy_.load();
+  }
+
   const std::string& getDelimiter() const {
     ld_check(config_tree_ != nullptr);
     return config_tree_->delimiter();
@@ -221,7 +236,7 @@ class LocalLogsConfig : public LogsConfig {
   // logs config tree.
   std::string print() const {
     std::stringstream stream;
-    stream << config_tree_->print();
+    stream << tree()->print();
     stream << " ** INTERNAL LOGS ** " << std::endl;
     for (auto it = internal_logs_.logsBegin(); it != internal_logs_.logsEnd();
          ++it) {
@@ -243,15 +258,39 @@ class LocalLogsConfig : public LogsConfig {
   LocalLogsConfig() : config_tree_(LogsConfigTree::create()) {}
   LocalLogsConfig(const LocalLogsConfig& other)
       : LogsConfig(other),
-        config_tree_(other.config_tree_->copy()),
+        config_tree_(other.copyTree()),
         internal_logs_(other.internal_logs_),
         is_full_config_(other.is_full_config_),
-        was_modified_in_place_(other.was_modified_in_place_.load()) {}
+        was_modified_in_place_(other.was_modified_in_place_.load()) {
+    onLogsConfigTreeSet();
+  }
   LocalLogsConfig& operator=(const LocalLogsConfig& other) = delete;
 
  private:
   std::unique_ptr<LogsConfigTree> config_tree_;
 
+  // If config_tree_ is lazy, its LazyLogsConfigTree. Kept after config_tree_
+  // is deserialized as concurrent lookups may still be using it.
+  std::shared_ptr<const logsconfig::LazyLogsConfigTree> lazy_tree_;
+  // true until config_tree_ is deserialized if it is lazy
+  mutable std::atomic<bool> is_lazy_{false};
+  // serializes deserialization of config_tree_ with copies of it
+  mutable std::mutex materialize_mutex_;
+
+  // Returns config_tree_, deserializing it first if it is lazy.
+  LogsConfigTree* tree() const;
+
+  // Returns lazy_tree_ if config_tree_ is lazy and was not deserialized yet,
+  // nullptr otherwise.
+  const logsconfig::LazyLogsConfigTree* lazyTree() const {
+    return is_lazy_.load() ? lazy_tree_.get() : nullptr;
+  }
+
+  std::unique_ptr<LogsConfigTree> copyTree() const;
+
+  // Updates lazy_tree_ and is_lazy_ after config_tree_ changed.
+  void onLogsConfigTreeSet();
+
   InternalLogs internal_logs_;
   ReplicationProperty narrowest_replication_cache_;
   bool is_full_config_ = false;
@@ -561,6 +561,21 @@ bool parsePrincipals(const folly::dynamic& clusterMap,
       return false;
     }
 
+    successful =
+        getIntFromMap(principal, "read_weight", map_entry->read_weight);
+    // "read_weight" is an optional field, so ignore NOTFOUND errors.
+    if (!successful && err != E::NOTFOUND) {
+      ld_error("While processing principal \"%s\".", name.c_str());
+      err = E::INVALID_CONFIG;
+      return false;
+    }
+    if (map_entry->read_weight == 0) {
+      ld_error("\"read_weight\" of principal \"%s\" must be positive",
+               name.c_str());
+      err = E::INVALID_CONFIG;
+      return false;
+    }
+
     principals_map.insert({name, map_entry});
   }
 
@@ -302,6 +302,10 @@ double ServerConfig::getDefaultSamplePercentage() const {
   return traceLoggerConfig_.getDefaultSamplePercentage();
 }
 
+uint64_t ServerConfig::getTracerMaxSamplesPerSec(const std::string& key) const {
+  return traceLoggerConfig_.getMaxSamplesPerSec(key);
+}
+
 std::unique_ptr<ServerConfig>
 ServerConfig::fromData(std::string cluster_name,
                        NodesConfig nodes,
@@ -249,6 +249,12 @@ class ServerConfig {
    */
   double getDefaultSamplePercentage() const;
 
+  /**
+   * @return the maximum number of samples per second for a tracer, 0 if
+   *         there is no limit
+   */
+  uint64_t getTracerMaxSamplesPerSec(const std::string& key) const;
+
   /**
    * @return if unauthenticated connections are allowed
    */
@@ -143,6 +143,18 @@ void TextConfigUpdaterImpl::update(bool force_reload_logsconfig) {
   auto sem_post_guard =
       folly::makeGuard([this]() { initial_config_sem_.post(); });
 
+  if (!force_reload_logsconfig && isRunningConfig()) {
+    // Parsing the same contents would produce the same config, which would
+    // then be discarded as identical to the one we already have. Sources
+    // often deliver unchanged contents, e.g. when a file is touched, or when
+    // an untrusted CONFIG_CHANGED makes us fetch from the source.
+    ld_info("Received same config contents as already running (hash: %s), "
+            "not parsing them",
+            main_config_state_.output->hash.c_str());
+    STAT_INCR(stats_, config_update_same_version);
+    return;
+  }
+
   // Wipe `included_config_state_' in case the main config no longer refers to
   // it.  (If it does, the callback will repopulate it.)
   State previous_included_state;
@@ -274,6 +286,24 @@ void TextConfigUpdaterImpl::update(bool force_reload_logsconfig) {
                           logs_config_update != ConfigUpdateResult::INVALID);
 }
 
+bool TextConfigUpdaterImpl::isRunningConfig() {
+  std::shared_ptr<UpdateableServerConfig> server_config =
+      target_server_config_.lock();
+  auto running = server_config ? server_config->get() : nullptr;
+  if (!running) {
+    return false;
+  }
+
+  ServerConfig::ConfigMetadata main_metadata, included_metadata;
+  main_metadata.hash = main_config_state_.output->hash;
+  if (included_config_state_.output.hasValue()) {
+    included_metadata.hash = included_config_state_.output->hash;
+  }
+  return !main_metadata.hash.empty() &&
+      hashes_equal(main_metadata, running->getMainConfigMetadata()) &&
+      hashes_equal(included_metadata, running->getIncludedConfigMetadata());
+}
+
 std::pair<ConfigSource*, std::string>
 TextConfigUpdaterImpl::parseMaybeRelativeLocation(const std::string& location,
                                                   ConfigSource* ref_source,
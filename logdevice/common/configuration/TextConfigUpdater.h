@@ -174,6 +174,10 @@ class TextConfigUpdaterImpl : public ConfigSource::AsyncCallback,
   // regardless of whether the main config has changed.
   void update(bool force_reload_logsconfig = false);
 
+  // Returns true if the running ServerConfig was parsed from the main and
+  // included config contents we currently have, according to their hashes.
+  bool isRunningConfig();
+
   // Parses a location of the form "scheme:path" and finds the appropriate
   // registered config source.  If none is found, returns nullptr.
   std::pair<ConfigSource*, std::string>
@@ -27,6 +27,15 @@ double TraceLoggerConfig::getDefaultSamplePercentage() const {
   return default_sampling;
 }
 
+uint64_t
+TraceLoggerConfig::getMaxSamplesPerSec(const std::string& tracer) const {
+  auto iter = max_samples_per_sec.find(tracer);
+  if (iter != max_samples_per_sec.end()) {
+    return iter->second;
+  }
+  return default_max_samples_per_sec;
+}
+
 folly::dynamic TraceLoggerConfig::toFollyDynamic() const {
   folly::dynamic res = folly::dynamic::object;
   if (default_sampling != DEFAULT_SAMPLE_PERCENTAGE) {
@@ -37,6 +46,16 @@ folly::dynamic TraceLoggerConfig::toFollyDynamic() const {
     tracers[kv.first] = kv.second;
   }
   res["tracers"] = std::move(tracers);
+  if (default_max_samples_per_sec != 0) {
+    res["default-max-samples-per-sec"] = default_max_samples_per_sec;
+  }
+  if (!max_samples_per_sec.empty()) {
+    folly::dynamic budgets = folly::dynamic::object;
+    for (const auto& kv : max_samples_per_sec) {
+      budgets[kv.first] = kv.second;
+    }
+    res["max-samples-per-sec"] = std::move(budgets);
+  }
   return res;
 }
 
@@ -24,6 +24,10 @@ struct TraceLoggerConfig {
   TraceLoggerConfig() {}
   double default_sampling = DEFAULT_SAMPLE_PERCENTAGE;
   std::unordered_map<std::string, double> percentages;
+  // Maximum number of samples per second pushed for each table, 0 means no
+  // limit. Samples over the budget are dropped before they are built.
+  uint64_t default_max_samples_per_sec = 0;
+  std::unordered_map<std::string, uint64_t> max_samples_per_sec;
 
   /**
    * Looks up the sampling percentage for a certain tracer in the config
@@ -40,6 +44,12 @@ struct TraceLoggerConfig {
    */
   double getDefaultSamplePercentage() const;
 
+  /**
+   * @return Maximum number of samples per second for a certain tracer, either
+   *         its override or the default. 0 if there is no limit.
+   */
+  uint64_t getMaxSamplesPerSec(const std::string& tracer) const;
+
   folly::dynamic toFollyDynamic() const;
 };
 
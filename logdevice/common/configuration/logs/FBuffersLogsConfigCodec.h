@@ -136,6 +136,34 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
   static std::unique_ptr<Out>
   deserialize(const facebook::logdevice::Payload& payload,
               const std::string& delimiter) {
+    std::unique_ptr<uint8_t[]> buf;
+    Payload fb = verifiedBuffer<Out>(payload, buf);
+    if (fb.data() == nullptr) {
+      return nullptr;
+    }
+    auto ret = fbuffers_deserialize<Out>(
+        flatbuffers::GetRoot<typename TypeMapping<Out>::to>(fb.data()),
+        delimiter);
+
+    if (!ret) {
+      STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
+    }
+
+    return ret;
+  }
+
+  /**
+   * Decompresses (if needed) and verifies the flatbuffer of an object of type
+   * Out serialized in `payload', without deserializing it.
+   *
+   * @param buf  Holds the decompressed flatbuffer if the payload was
+   *             compressed.
+   * @return     The flatbuffer, which points either inside `payload' or
+   *             inside `buf', or an empty Payload on failure.
+   */
+  template <typename Out>
+  static Payload verifiedBuffer(const facebook::logdevice::Payload& payload,
+                                std::unique_ptr<uint8_t[]>& buf) {
     const uint8_t* ptr = static_cast<const uint8_t*>(payload.data());
     const uint8_t* end = ptr + payload.size();
     if (payload.size() == 0 || ptr + 1 >= end) {
@@ -144,7 +172,7 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
                       "Invalid payload size, cannot deserialize!");
       ld_check(false);
       STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
-      return nullptr;
+      return Payload();
     }
     logsconfig_codec_version_t codec_version =
         *ptr++; // Read the first uint8_t of the buffer to know the version
@@ -152,11 +180,10 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
     if (codec_version != CODEC_VERSION) {
       ld_critical("Unknown Codec Version (%u) in the serialized payload",
                   codec_version);
-      return nullptr;
+      return Payload();
     }
 
     bool shouldDecompress = (*ptr++ == 1) ? true : false;
-    std::unique_ptr<uint8_t[]> buf;
     if (shouldDecompress) {
       // Try to Decompress
       size_t uncompressed_size = ZSTD_getDecompressedSize(ptr, end - ptr);
@@ -165,7 +192,7 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
             std::chrono::seconds(1), 1, "ZSTD_getDecompressedSize() failed!");
         ld_check(false);
         STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
-        return nullptr;
+        return Payload();
       }
       buf = std::make_unique<uint8_t[]>(uncompressed_size);
       size_t rv = ZSTD_decompress(buf.get(),         // dst
@@ -179,7 +206,7 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
                         ZSTD_getErrorName(rv));
         ld_check(false);
         STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
-        return nullptr;
+        return Payload();
       }
       if (rv != uncompressed_size) {
         RATELIMIT_ERROR(std::chrono::seconds(1),
@@ -190,7 +217,7 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
                         uncompressed_size);
         ld_check(false);
         STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
-        return nullptr;
+        return Payload();
       }
       // Use the decompressed buffer.
       ptr = buf.get();
@@ -212,7 +239,7 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
                typeid(typename TypeMapping<Out>::to).name());
 
       STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
-      return nullptr;
+      return Payload();
     }
     const int64_t verification_latency_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -220,14 +247,7 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
             .count();
 
     ld_debug("Payload verification took %zums.", verification_latency_ms);
-    auto ret = fbuffers_deserialize<Out>(
-        flatbuffers::GetRoot<typename TypeMapping<Out>::to>(ptr), delimiter);
-
-    if (!ret) {
-      STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
-    }
-
-    return ret;
+    return Payload(ptr, end - ptr);
   }
 
   /* Internal Intemediate Serializers */
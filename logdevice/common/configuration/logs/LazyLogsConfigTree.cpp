@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/configuration/logs/LazyLogsConfigTree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include <boost/algorithm/string/trim.hpp>
+
+#include "logdevice/common/configuration/logs/DefaultLogAttributes.h"
+#include "logdevice/common/configuration/logs/FBuffersLogsConfigCodec.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice { namespace logsconfig {
+
+std::shared_ptr<LazyLogsConfigTree>
+LazyLogsConfigTree::create(Payload payload,
+                           const std::string& delimiter,
+                           lsn_t version) {
+  std::unique_ptr<uint8_t[]> buf;
+  Payload fb =
+      FBuffersLogsConfigCodec::verifiedBuffer<LogsConfigTree>(payload, buf);
+  if (fb.data() == nullptr) {
+    err = E::BADMSG;
+    return nullptr;
+  }
+  if (!buf) {
+    // The flatbuffer points inside `payload', which we don't own.
+    buf = std::make_unique<uint8_t[]>(fb.size());
+    memcpy(buf.get(), fb.data(), fb.size());
+  }
+
+  std::shared_ptr<LazyLogsConfigTree> tree(
+      new LazyLogsConfigTree(std::move(buf), delimiter, version));
+  if (!flatbuffers::GetRoot<fbuffers::LogsConfig>(tree->buf_.get())
+           ->root_dir()) {
+    err = E::BADMSG;
+    ld_critical("LogsConfig Tree deserialization failed, this is most likely "
+                "a bad payload in the snapshot log");
+    return nullptr;
+  }
+  tree->buildIndex();
+  return tree;
+}
+
+LazyLogsConfigTree::LazyLogsConfigTree(std::unique_ptr<uint8_t[]> buf,
+                                       const std::string& delimiter,
+                                       lsn_t version)
+    : buf_(std::move(buf)), delimiter_(delimiter), version_(version) {
+  ld_check(!delimiter_.empty());
+}
+
+void LazyLogsConfigTree::buildIndex() {
+  const fbuffers::LogsConfig* logs_config =
+      flatbuffers::GetRoot<fbuffers::LogsConfig>(buf_.get());
+  dirs_.push_back(DirectoryEntry{logs_config->root_dir(), -1, ""});
+
+  // dirs_ grows as we go, which gives a breadth first walk of the tree.
+  for (size_t i = 0; i < dirs_.size(); ++i) {
+    const fbuffers::Directory* dir = dirs_[i].dir;
+    if (dir->log_groups()) {
+      for (const auto* group : *dir->log_groups()) {
+        logid_range_t range =
+            FBuffersLogsConfigCodec::fbuffers_deserialize<logid_range_t>(
+                group->range());
+        groups_.push_back(LogGroupEntry{
+            group, i, range.first.val(), range.second.val()});
+      }
+    }
+    if (dir->children()) {
+      for (const auto* child : *dir->children()) {
+        dirs_.push_back(DirectoryEntry{
+            child,
+            static_cast<int64_t>(i),
+            dirs_[i].path + child->name()->str() + delimiter_});
+      }
+    }
+  }
+
+  std::sort(groups_.begin(),
+            groups_.end(),
+            [](const LogGroupEntry& a, const LogGroupEntry& b) {
+              return a.from < b.from;
+            });
+
+  paths_.reserve(groups_.size());
+  for (size_t i = 0; i < groups_.size(); ++i) {
+    // If a directory has two log groups with the same name, deserializing
+    // the tree keeps the last one.
+    paths_[dirs_[groups_[i].dir].path + groups_[i].group->name()->str()] = i;
+  }
+}
+
+LogAttributes LazyLogsConfigTree::getDirectoryAttributes(size_t i) const {
+  // Same as fbuffers_deserialize<DirectoryNode>(): the root inherits the
+  // default attributes, other directories inherit their parent's, and a
+  // directory without attributes doesn't inherit anything.
+  const DirectoryEntry& entry = dirs_[i];
+  if (!entry.dir->attrs()) {
+    return LogAttributes();
+  }
+  {
+    auto cache = dir_attrs_cache_.rlock();
+    auto it = cache->find(i);
+    if (it != cache->end()) {
+      return it->second;
+    }
+  }
+
+  LogAttributes attrs =
+      FBuffersLogsConfigCodec::fbuffers_deserialize<LogAttributes>(
+          entry.dir->attrs(),
+          entry.parent < 0 ? LogAttributes(DefaultLogAttributes())
+                           : getDirectoryAttributes(entry.parent));
+  // Another thread may have raced with us, keep the first one.
+  return dir_attrs_cache_.wlock()->emplace(i, std::move(attrs)).first->second;
+}
+
+std::shared_ptr<LogGroupNode> LazyLogsConfigTree::getLogGroup(size_t i) const {
+  ld_check(i < groups_.size());
+  {
+    auto cache = cache_.rlock();
+    auto it = cache->find(i);
+    if (it != cache->end()) {
+      return it->second;
+    }
+  }
+
+  std::shared_ptr<LogGroupNode> group =
+      FBuffersLogsConfigCodec::fbuffers_deserialize<LogGroupNode>(
+          groups_[i].group, delimiter_, getDirectoryAttributes(groups_[i].dir));
+  ld_check(group);
+  // Another thread may have raced with us, keep the first one.
+  return cache_.wlock()->emplace(i, std::move(group)).first->second;
+}
+
+std::string LazyLogsConfigTree::normalizePath(const std::string& path) const {
+  // Same as LogsConfigTree::normalize_path().
+  char delimiter = delimiter_.front();
+  std::string normal = path;
+  boost::trim_if(normal, [&](char c) { return c == delimiter; });
+  return normal;
+}
+
+std::shared_ptr<LogGroupNode>
+LazyLogsConfigTree::findLogGroup(const std::string& path) const {
+  auto it = paths_.find(normalizePath(path));
+  if (it == paths_.end()) {
+    err = E::NOTFOUND;
+    return nullptr;
+  }
+  return getLogGroup(it->second);
+}
+
+const LazyLogsConfigTree::LogGroupEntry* FOLLY_NULLABLE
+LazyLogsConfigTree::findEntry(logid_t logid) const {
+  // first log group that starts after logid
+  auto it = std::upper_bound(groups_.begin(),
+                             groups_.end(),
+                             logid.val(),
+                             [](logid_t::raw_type id, const LogGroupEntry& e) {
+                               return id < e.from;
+                             });
+  if (it == groups_.begin() || std::prev(it)->to < logid.val()) {
+    err = E::NOTFOUND;
+    return nullptr;
+  }
+  return &*std::prev(it);
+}
+
+std::shared_ptr<LogGroupNode>
+LazyLogsConfigTree::getLogGroupByID(logid_t logid,
+                                    std::string* path_out) const {
+  const LogGroupEntry* entry = findEntry(logid);
+  if (!entry) {
+    return nullptr;
+  }
+  if (path_out) {
+    *path_out =
+        delimiter_ + dirs_[entry->dir].path + entry->group->name()->str();
+  }
+  return getLogGroup(entry - groups_.data());
+}
+
+bool LazyLogsConfigTree::logExists(logid_t logid) const {
+  return findEntry(logid) != nullptr;
+}
+
+std::unique_ptr<LogsConfigTree> LazyLogsConfigTree::materialize() const {
+  auto tree = FBuffersLogsConfigCodec::fbuffers_deserialize<LogsConfigTree>(
+      flatbuffers::GetRoot<fbuffers::LogsConfig>(buf_.get()), delimiter_);
+  // create() checked that the tree has a root directory.
+  ld_check(tree);
+  tree->setVersion(version_);
+  return tree;
+}
+
+}}} // namespace facebook::logdevice::logsconfig
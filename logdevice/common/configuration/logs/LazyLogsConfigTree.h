@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/Synchronized.h>
+
+#include "logdevice/common/configuration/logs/LogsConfigTree.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice { namespace logsconfig {
+
+namespace fbuffers {
+struct Directory;
+struct LogGroup;
+} // namespace fbuffers
+
+/**
+ * @file A read-only LogsConfigTree that stays in its serialized FlatBuffers
+ *       form (as found in the snapshot log of LogsConfigStateMachine).
+ *
+ *       Fully deserializing a tree with hundreds of thousands of log groups
+ *       takes seconds and allocates a LogGroupNode and LogAttributes for each
+ *       of them. Clients often only use a handful of logs. This class only
+ *       builds an index of the log groups by path and by log id range, and
+ *       deserializes a log group (with the attributes it inherits from its
+ *       parent directories) the first time it is looked up.
+ *
+ *       materialize() deserializes the whole tree, for callers that need a
+ *       LogsConfigTree (e.g. to iterate over all logs or apply a delta).
+ *
+ *       This class is immutable once created and is thread-safe.
+ */
+
+class LazyLogsConfigTree {
+ public:
+  /**
+   * @param payload    A LogsConfigTree serialized by FBuffersLogsConfigCodec.
+   *                   Its content is copied.
+   * @param delimiter  Namespace delimiter.
+   * @param version    Version of the tree.
+   *
+   * @return the tree, or nullptr and err is set to E::BADMSG if the payload
+   *         could not be decoded.
+   */
+  static std::shared_ptr<LazyLogsConfigTree>
+  create(Payload payload, const std::string& delimiter, lsn_t version);
+
+  lsn_t version() const {
+    return version_;
+  }
+
+  const std::string& delimiter() const {
+    return delimiter_;
+  }
+
+  // Same as LogsConfigTree::findLogGroup().
+  std::shared_ptr<LogGroupNode> findLogGroup(const std::string& path) const;
+
+  /**
+   * @param path_out  If not nullptr, populated with the fully qualified name
+   *                  of the log group.
+   *
+   * @return the log group with `logid' in its range, or nullptr and err is set
+   *         to E::NOTFOUND.
+   */
+  std::shared_ptr<LogGroupNode>
+  getLogGroupByID(logid_t logid, std::string* path_out = nullptr) const;
+
+  bool logExists(logid_t logid) const;
+
+  size_t numLogGroups() const {
+    return groups_.size();
+  }
+
+  // Deserializes the whole tree.
+  std::unique_ptr<LogsConfigTree> materialize() const;
+
+  LazyLogsConfigTree(const LazyLogsConfigTree&) = delete;
+  LazyLogsConfigTree& operator=(const LazyLogsConfigTree&) = delete;
+
+ private:
+  struct DirectoryEntry {
+    const fbuffers::Directory* dir;
+    // index in dirs_ of the parent directory, -1 for the root
+    int64_t parent;
+    // same as DirectoryNode::getFullyQualifiedName() without the leading
+    // delimiter, e.g. "a/b/" for "/a/b/"
+    std::string path;
+  };
+
+  struct LogGroupEntry {
+    const fbuffers::LogGroup* group;
+    // index in dirs_ of the parent directory
+    size_t dir;
+    logid_t::raw_type from;
+    logid_t::raw_type to;
+  };
+
+  LazyLogsConfigTree(std::unique_ptr<uint8_t[]> buf,
+                     const std::string& delimiter,
+                     lsn_t version);
+
+  // Fills dirs_, groups_ and paths_ by walking the flatbuffer.
+  void buildIndex();
+
+  // @return the entry of the log group with `logid' in its range, or nullptr
+  //         and err is set to E::NOTFOUND.
+  const LogGroupEntry* findEntry(logid_t logid) const;
+
+  // Deserializes the log group at index `i' of groups_, or returns it from
+  // cache_.
+  std::shared_ptr<LogGroupNode> getLogGroup(size_t i) const;
+
+  // Attributes of directory at index `i' of dirs_, as deserializing the whole
+  // tree would compute them. Memoized in dir_attrs_cache_, so that log groups
+  // of the same directory don't deserialize its ancestors' attributes again.
+  LogAttributes getDirectoryAttributes(size_t i) const;
+
+  std::string normalizePath(const std::string& path) const;
+
+  // the uncompressed fbuffers::LogsConfig
+  std::unique_ptr<uint8_t[]> buf_;
+  const std::string delimiter_;
+  const lsn_t version_;
+
+  std::vector<DirectoryEntry> dirs_;
+  // sorted by first log id
+  std::vector<LogGroupEntry> groups_;
+  // normalized path (without leading delimiter) => index in groups_
+  std::unordered_map<std::string, size_t> paths_;
+
+  // log groups deserialized so far, by index in groups_
+  mutable folly::Synchronized<
+      std::unordered_map<size_t, std::shared_ptr<LogGroupNode>>>
+      cache_;
+
+  // attributes of directories computed so far, by index in dirs_
+  mutable folly::Synchronized<std::unordered_map<size_t, LogAttributes>>
+      dir_attrs_cache_;
+};
+
+}}} // namespace facebook::logdevice::logsconfig
@@ -13,12 +13,14 @@
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/configuration/InternalLogs.h"
 #include "logdevice/common/configuration/logs/FBuffersLogsConfigCodec.h"
+#include "logdevice/common/configuration/logs/LazyLogsConfigTree.h"
 #include "logdevice/common/stats/ServerHistograms.h"
 
 using facebook::logdevice::logsconfig::Delta;
 using facebook::logdevice::logsconfig::DeltaOpType;
 using facebook::logdevice::logsconfig::DirectoryNode;
 using facebook::logdevice::logsconfig::FBuffersLogsConfigCodec;
+using facebook::logdevice::logsconfig::LazyLogsConfigTree;
 using facebook::logdevice::logsconfig::LogGroupNode;
 using facebook::logdevice::logsconfig::LogsConfigTree;
 
@@ -51,6 +53,7 @@ LogsConfigStateMachine::LogsConfigStateMachine(
 
   self_subscription_ = subscribe(update_cb);
   setSnapshottingGracePeriod(settings_->logsconfig_snapshotting_period);
+  setMaxDeltaSnapshots(settings_->rsm_max_delta_snapshots);
 }
 
 bool LogsConfigStateMachine::canTrimAndSnapshot() const {
@@ -173,6 +176,10 @@ int LogsConfigStateMachine::applyDelta(const logsconfig::Delta& delta,
                                        std::chrono::milliseconds /* unused */,
                                        std::string& failure_reason) {
   auto apply_start_time = std::chrono::steady_clock::now();
+  if (tree.isLazy() && delta.type() != DeltaOpType::SET_TREE) {
+    // The delta needs the whole tree.
+    tree.materialize();
+  }
   int rv = delta.apply(tree, failure_reason);
   const int64_t apply_latency_us =
       std::chrono::duration_cast<std::chrono::microseconds>(
@@ -197,6 +204,11 @@ int LogsConfigStateMachine::serializeState(
     const logsconfig::LogsConfigTree& tree,
     void* buf,
     size_t size) {
+  if (tree.isLazy()) {
+    // Only read-only state machines have lazy trees and they don't snapshot.
+    ld_check(false);
+    return serializeState(*tree.getLazyTree()->materialize(), buf, size);
+  }
   PayloadHolder holder = FBuffersLogsConfigCodec::serialize(tree, false);
   if (buf == nullptr) {
     return holder.size();
@@ -211,6 +223,20 @@ LogsConfigStateMachine::deserializeState(
     Payload payload,
     lsn_t version,
     std::chrono::milliseconds /* unused */) const {
+  if (!is_writable_ && settings_->logsconfig_lazy_materialization) {
+    // Look log groups up in the serialized snapshot until a delta or a user
+    // needs the whole tree, @see LazyLogsConfigTree.
+    auto lazy =
+        LazyLogsConfigTree::create(payload, *delimiter_.rlock(), version);
+    if (lazy == nullptr) {
+      err = E::BADMSG;
+      return nullptr;
+    }
+    ld_info("Loaded lazy LogsConfigTree version %s with %zu log groups",
+            lsn_to_string(version).c_str(),
+            lazy->numLogGroups());
+    return LogsConfigTree::createLazy(std::move(lazy));
+  }
   auto tree = FBuffersLogsConfigCodec::deserialize<LogsConfigTree>(
       payload, *delimiter_.rlock());
   if (tree == nullptr) {
@@ -22,6 +22,7 @@
 #include "logdevice/common/configuration/NodeLocation.h"
 #include "logdevice/common/configuration/ParsingHelpers.h"
 #include "logdevice/common/configuration/ReplicationProperty.h"
+#include "logdevice/common/configuration/logs/LazyLogsConfigTree.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/include/types.h"
 
@@ -1296,6 +1297,34 @@ void LogsConfigTree::rebuildIndex() {
   rebuildIndexForDir(root_.get(), false);
 }
 
+std::unique_ptr<LogsConfigTree>
+LogsConfigTree::createLazy(std::shared_ptr<const LazyLogsConfigTree> lazy) {
+  ld_check(lazy != nullptr);
+  auto tree = create(lazy->delimiter(), LogAttributes());
+  tree->setVersion(lazy->version());
+  tree->lazy_ = std::move(lazy);
+  return tree;
+}
+
+void LogsConfigTree::materialize() {
+  if (!lazy_) {
+    return;
+  }
+  auto start_time = std::chrono::steady_clock::now();
+  std::unique_ptr<LogsConfigTree> full = lazy_->materialize();
+  // The DirectoryNodes don't move, so the parent pointers in the index of
+  // `full' remain valid.
+  root_ = std::move(full->root_);
+  logs_index_ = std::move(full->logs_index_);
+  max_backlog_duration_ = full->max_backlog_duration_;
+  lazy_.reset();
+  ld_info("Materialized LogsConfigTree version %lu in %ldms",
+          version_,
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - start_time)
+              .count());
+}
+
 ReplicationProperty LogsConfigTree::getNarrowestReplication() const {
   return root_->getNarrowestReplication();
 }
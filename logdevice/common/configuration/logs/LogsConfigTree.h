@@ -30,6 +30,7 @@
 namespace facebook { namespace logdevice { namespace logsconfig {
 
 class DirectoryNode;
+class LazyLogsConfigTree;
 class LogGroupNode;
 struct LogGroupInDirectory;
 
@@ -462,6 +463,26 @@ class LogsConfigTree {
     return std::make_unique<LogsConfigTree>(std::move(root), delimiter);
   }
 
+  /**
+   * Creates a tree whose content stays serialized in `lazy' until
+   * materialize() is called. Until then the tree is empty: only version() and
+   * delimiter() are meaningful, and log groups need to be looked up through
+   * getLazyTree(). Copies of a lazy tree are lazy.
+   */
+  static std::unique_ptr<LogsConfigTree>
+  createLazy(std::shared_ptr<const LazyLogsConfigTree> lazy);
+
+  bool isLazy() const {
+    return lazy_ != nullptr;
+  }
+
+  const std::shared_ptr<const LazyLogsConfigTree>& getLazyTree() const {
+    return lazy_;
+  }
+
+  // Deserializes the content of a lazy tree. No-op if the tree is not lazy.
+  void materialize();
+
   /*
    * Adding a new LogGroup to the tree given the parent path (string), name
    * (string)
@@ -709,6 +730,7 @@ class LogsConfigTree {
     delimiter_ = other.delimiter_;
     root_ = std::make_unique<DirectoryNode>(*other.root_);
     version_ = other.version_;
+    lazy_ = other.lazy_;
     // We cannot copy the index because the Parent pointer in
     // LogGroupInDirectory will be pointing to the old tree.
     rebuildIndex();
@@ -780,6 +802,9 @@ class LogsConfigTree {
   // maximum finite backlog duration of a log
   std::chrono::seconds max_backlog_duration_{0};
   LogMap logs_index_;
+  // If not nullptr, the tree is empty and its content is here,
+  // @see createLazy().
+  std::shared_ptr<const LazyLogsConfigTree> lazy_;
   // Max version seen, this is meant to be used if this tree is not backed by
   // LogsConfigManager.
   static std::atomic<uint64_t> max_version;
@@ -47,7 +47,7 @@ int MetaDataLogsReplication::applyUpdate(
   new_config.version_ = membership::MembershipVersion::Type(version_.val() + 1);
   ld_assert(new_config.validate());
   if (config_out != nullptr) {
-    *config_out = new_config;
+    *config_out = std::move(new_config);
   }
   return 0;
 }
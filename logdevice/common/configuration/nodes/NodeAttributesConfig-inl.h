@@ -146,7 +146,7 @@ int NodeAttributesConfig<Attributes>::applyUpdate(
   }
 
   if (new_config_out != nullptr) {
-    *new_config_out = target_config;
+    *new_config_out = std::move(target_config);
   }
 
   dcheckConsistency();
@@ -7,8 +7,11 @@
  */
 #include "logdevice/common/configuration/nodes/NodesConfiguration.h"
 
+#include <algorithm>
 #include <chrono>
+#include <set>
 
+#include <folly/Portability.h>
 #include <folly/hash/SpookyHashV2.h>
 
 #include "logdevice/common/configuration/ServerConfig.h"
@@ -268,7 +271,11 @@ std::shared_ptr<const NodesConfiguration> NodesConfiguration::applyUpdate(
   }
 
   // update storage_hash, num_shards and addr_to_index
-  new_config->recomputeConfigMetadata();
+  if (version_ == MembershipVersion::EMPTY_VERSION) {
+    new_config->recomputeConfigMetadata();
+  } else {
+    new_config->updateConfigMetadata(*this, update);
+  }
   new_config->last_maintenance_ = update.maintenance;
 
   // 7) Finally check the validaity of the new config, for example
@@ -409,6 +416,88 @@ void NodesConfiguration::recomputeConfigMetadata() {
   add_addr_index(*getStorageMembership());
 }
 
+void NodesConfiguration::updateConfigMetadata(const NodesConfiguration& prev,
+                                              const Update& update) {
+  // nodes whose address may have changed or which may have been added to or
+  // removed from a membership
+  std::set<node_index_t> nodes;
+  // nodes that may have been added to or removed from the storage membership
+  std::set<node_index_t> storage_nodes;
+
+  if (update.service_discovery_update) {
+    for (const auto& kv : update.service_discovery_update->node_updates) {
+      nodes.insert(kv.first);
+    }
+  }
+  const auto& seq_update = update.sequencer_config_update;
+  if (seq_update && seq_update->membership_update) {
+    for (const auto& kv : seq_update->membership_update->node_updates) {
+      nodes.insert(kv.first);
+    }
+  }
+  const auto& storage_update = update.storage_config_update;
+  if (storage_update && storage_update->membership_update) {
+    for (const auto& kv : storage_update->membership_update->shard_updates) {
+      storage_nodes.insert(kv.first.node());
+    }
+  }
+
+  const bool storage_attributes_changed =
+      storage_update && storage_update->attributes_update;
+  // Most storage membership updates (e.g. maintenances) only change the
+  // state of existing shards, which doesn't change the storage nodes hash.
+  const bool storage_nodes_changed = update.service_discovery_update ||
+      storage_attributes_changed ||
+      std::any_of(storage_nodes.begin(),
+                  storage_nodes.end(),
+                  [&](node_index_t n) {
+                    return prev.isStorageNode(n) != isStorageNode(n);
+                  });
+
+  if (storage_nodes_changed) {
+    storage_hash_ = computeStorageNodesHash();
+    num_shards_ = computeNumShards();
+  }
+  if (update.service_discovery_update) {
+    max_node_index_ = computeMaxNodeIndex();
+  }
+  // the sequencers config depends on node generations, which are storage
+  // attributes
+  if (update.service_discovery_update || seq_update ||
+      storage_attributes_changed) {
+    sequencer_locator_config_ = computeSequencersConfig();
+  }
+
+  nodes.insert(storage_nodes.begin(), storage_nodes.end());
+  for (const node_index_t n : nodes) {
+    const NodeServiceDiscovery* prev_sd = prev.getNodeServiceDiscovery(n);
+    if (prev_sd) {
+      auto it = addr_to_index_.find(prev_sd->address);
+      if (it != addr_to_index_.end() && it->second == n) {
+        addr_to_index_.erase(it);
+      }
+    }
+    if (isSequencerNode(n) || isStorageNode(n)) {
+      const auto& serv_disc = getServiceDiscovery()->nodeAttributesAt(n);
+      addr_to_index_.insert(std::make_pair(serv_disc.address, n));
+    }
+  }
+
+  dcheckConfigMetadata();
+}
+
+void NodesConfiguration::dcheckConfigMetadata() const {
+  if (folly::kIsDebug) {
+    NodesConfiguration expected(*this);
+    expected.recomputeConfigMetadata();
+    ld_check_eq(expected.storage_hash_, storage_hash_);
+    ld_check_eq(expected.num_shards_, num_shards_);
+    ld_check_eq(expected.max_node_index_, max_node_index_);
+    ld_check(expected.sequencer_locator_config_ == sequencer_locator_config_);
+    ld_check(expected.addr_to_index_ == addr_to_index_);
+  }
+}
+
 std::shared_ptr<const NodesConfiguration>
 NodesConfiguration::withIncrementedVersionAndTimestamp(
     folly::Optional<membership::MembershipVersion::Type> new_nc_version,
@@ -285,6 +285,18 @@ class NodesConfiguration {
   // etc are not reset in this function
   void recomputeConfigMetadata();
 
+  // Same as recomputeConfigMetadata() for a config obtained by applying
+  // `update' to `prev', but only recomputes the metadata that depends on the
+  // sub-configurations `update' changed, and only updates addr_to_index_ for
+  // the nodes it touched. Sub-configurations that were not updated are shared
+  // with `prev'.
+  void updateConfigMetadata(const NodesConfiguration& prev,
+                            const Update& update);
+
+  // debug check that the metadata is what recomputeConfigMetadata() would
+  // compute
+  void dcheckConfigMetadata() const;
+
   // Increments config version, sets last_change_timestamp_ and context
   void touch(std::string context);
 
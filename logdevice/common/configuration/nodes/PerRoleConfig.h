@@ -25,12 +25,13 @@ using facebook::logdevice::toString;
  * attributes config. There will be one PerRoleConfig for each node role.
  */
 
-// convenient utility for making a copy of a config, applying an update and
-// if success, return a const shared_ptr of the new config
+// convenient utility for applying an update to a config and if success,
+// return a const shared_ptr of the new config. applyUpdate() overwrites the
+// whole output config, so there is no need to copy `config' into it first.
 template <typename Config>
 std::shared_ptr<const Config>
 applyConfigUpdate(const Config& config, const typename Config::Update& update) {
-  auto new_config = std::make_shared<Config>(config);
+  auto new_config = std::make_shared<Config>();
   int rv = new_config->applyUpdate(update, new_config.get());
   return rv == 0 ? new_config : nullptr;
 }
@@ -74,6 +74,9 @@ static int logFD = STDERR_FILENO; // from unistd.h
 // If it's nonzero, every subsequent write tries to report and clear it.
 static std::atomic<size_t> writesFailedWouldblock{0};
 static std::atomic<size_t> writesFailedOther{0};
+// How many messages were dropped because the queue of the background writer
+// was full. Reported the same way as the above.
+static std::atomic<size_t> writesDroppedAsync{0};
 
 // Callback to be called for each log entry.
 logging_fn_t customLogFn = nullptr;
@@ -207,6 +210,91 @@ class BackgroundLogger {
 
 struct BackgroundLoggerTag {};
 
+struct LogLine {
+  explicit LogLine(const char* data, size_t len) : line(data, len) {}
+
+  std::string line;
+  folly::AtomicIntrusiveLinkedListHook<LogLine> hook_;
+};
+
+/**
+ * Writes formatted log lines to logFD on a dedicated thread, so that threads
+ * calling log() never block in write(). See enableAsyncWrites().
+ */
+class BackgroundWriter {
+ public:
+  BackgroundWriter() {
+    thread_ = std::thread(&BackgroundWriter::mainLoop, this);
+  }
+
+  // @return false if the queue is full and the line was dropped.
+  bool push(const char* data, size_t len) {
+    if (pending_.load(std::memory_order_relaxed) >= maxBufferedLogMsg.load()) {
+      return false;
+    }
+    ++pending_;
+    queue_.push(std::make_unique<LogLine>(data, len));
+    sem_.post();
+    return true;
+  }
+
+  // Waits until the lines queued so far are written, for at most `timeout`.
+  void flush(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (pending_.load() > 0 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+ private:
+  void mainLoop() {
+    ThreadID::set(ThreadID::Type::UTILITY, "ld:log-writer");
+    std::string batch;
+    while (true) {
+      sem_.wait();
+      // Write everything that's queued with one write() call.
+      size_t n = sem_.tryWait(kBatchSize) + 1;
+      batch.clear();
+      for (size_t i = 0; i < n; ++i) {
+        auto line = queue_.pop();
+        ld_check(line);
+        batch += line->line;
+      }
+      writeAll(batch.data(), batch.size());
+      pending_ -= n;
+    }
+  }
+
+  static void writeAll(const char* ptr, size_t len) {
+    while (len > 0) {
+      ssize_t rv = write(logFD, ptr, len);
+      if (rv < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          ++writesFailedWouldblock;
+        } else {
+          ++writesFailedOther;
+        }
+        return;
+      }
+      ptr += rv;
+      len -= rv;
+    }
+  }
+
+  static constexpr size_t kBatchSize = 256;
+
+  std::thread thread_;
+  MPSCQueue<LogLine, &LogLine::hook_> queue_;
+  folly::LifoSem sem_;
+  std::atomic<size_t> pending_{0};
+};
+
+// Leaked so that log() can be called during static destruction.
+std::atomic<BackgroundWriter*> backgroundWriter{nullptr};
+
 } // namespace
 
 static folly::Singleton<BackgroundLogger, BackgroundLoggerTag> the_logger([]() {
@@ -406,6 +494,11 @@ int getFD() {
   return logFD;
 }
 
+void enableAsyncWrites() {
+  static std::once_flag once;
+  std::call_once(once, [] { backgroundWriter.store(new BackgroundWriter()); });
+}
+
 void useCallback(logging_fn_t fn) {
   // makes sure the singleton gets created
   BackgroundLogger::getInstance();
@@ -450,6 +543,7 @@ void log(const char* cluster,
     };
     report(writesFailedWouldblock, "log pipe was full");
     report(writesFailedOther, "write() failed");
+    report(writesDroppedAsync, "the background log writer was behind");
   }
 
   // Prepare the message.
@@ -523,6 +617,16 @@ void log(const char* cluster,
     external_logger_plugin->log(cluster, static_cast<int>(level), log_line);
   }
 
+  // Hand the message to the background writer, if there is one.
+  BackgroundWriter* writer = backgroundWriter.load(std::memory_order_acquire);
+  if (writer != nullptr) {
+    nested_ok = writer->push(record, reclen);
+    if (!nested_ok && !nested_call) {
+      ++writesDroppedAsync;
+    }
+    return;
+  }
+
   // Write the message to logFD.
   auto before_write_time = std::chrono::steady_clock::now();
 
@@ -640,6 +744,12 @@ void ld_check_fail_impl(CheckType type,
       break;
   }
   if (should_abort) {
+    BackgroundWriter* writer = backgroundWriter.load();
+    if (writer != nullptr) {
+      // Give the background writer a chance to write the last messages,
+      // including the one above.
+      writer->flush(std::chrono::seconds(1));
+    }
     std::abort();
   }
 }
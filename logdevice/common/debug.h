@@ -54,6 +54,16 @@ std::string& thisThreadClusterName();
  */
 void enableNonblockingPipe();
 
+/**
+ * Makes log() hand formatted messages to a background thread that writes
+ * them to the log file descriptor in batches, instead of calling write()
+ * on the calling thread. If the background thread falls behind by more than
+ * maxBufferedLogMsg messages, new messages are dropped and the number of
+ * dropped messages is logged later. Cannot be undone; meant to be called
+ * once at startup.
+ */
+void enableAsyncWrites();
+
 /**
  * Default logging implementation, used if useCallback() was not called by the
  * client.  Writes a message to the error file descriptor if logging is
@@ -921,7 +921,7 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
     node_index_t nidx,
     std::chrono::milliseconds timestamp,
     NodeInfo& node_info,
-    std::unordered_set<node_index_t> potential_donors,
+    const std::unordered_set<node_index_t>& storage_nodes,
     std::string* out_comment) const {
   ld_check(out_comment);
   node_info.donors_remaining.clear();
@@ -958,10 +958,19 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
     }
   }
 
+  // Storage nodes that are not potential donors. Only nodes that appear in
+  // the rebuilding set can be excluded, so this stays small in large clusters.
+  std::unordered_set<node_index_t> excluded;
+  auto exclude = [&](node_index_t n) {
+    if (storage_nodes.count(n)) {
+      excluded.insert(n);
+    }
+  };
+
   // Exclude authoritatively completed donors.
   for (auto& n : node_info.donors_complete_authoritatively) {
     if (n.second >= min_auth_complete_version) {
-      potential_donors.erase(n.first);
+      exclude(n.first);
     }
   }
 
@@ -976,7 +985,7 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
          (!n.second.acked || n.second.ack_lsn > node_info.version)) ||
         (n.second.mode == RebuildingMode::RELOCATE &&
          n.second.auth_status == AuthoritativeStatus::AUTHORITATIVE_EMPTY)) {
-      potential_donors.erase(n.first);
+      exclude(n.first);
     }
   }
 
@@ -984,14 +993,18 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
   // This excludes nodes restoring a time-range that would otherwise be
   // missed by the loop above.
   if (node_info.mode == RebuildingMode::RESTORE) {
-    ld_check(potential_donors.count(nidx) == 0 ||
+    ld_check(excluded.count(nidx) || !storage_nodes.count(nidx) ||
              !node_info.dc_dirty_ranges.empty());
-    potential_donors.erase(nidx);
+    exclude(nidx);
   }
+  const bool no_donors_left = excluded.size() == storage_nodes.size();
 
   // Find all nodes that still have not rebuilt authoritatively and also have
   // not rebuilt for the current version.
-  for (node_index_t n : potential_donors) {
+  for (node_index_t n : storage_nodes) {
+    if (excluded.count(n)) {
+      continue;
+    }
     auto it = node_info.donors_complete.find(n);
     if (it == node_info.donors_complete.end() ||
         it->second < shard_info.version) {
@@ -1011,7 +1024,7 @@ void EventLogRebuildingSet::recomputeShardAuthoritativeStatus(
     return;
   }
 
-  if (potential_donors.empty()) {
+  if (no_donors_left) {
     node_info.rebuilding_completed_ts = timestamp;
     node_info.auth_status = AuthoritativeStatus::AUTHORITATIVE_EMPTY;
     *out_comment = "all donors completed authoritatively";
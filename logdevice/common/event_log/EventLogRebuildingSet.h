@@ -371,6 +371,10 @@ class EventLogRebuildingSet {
   folly::Optional<NodeID> my_node_id_{folly::none};
 
   // Recomputes `NodeInfo::auth_status` and `NodeInfo::donors_remaining`.
+  // @param storage_nodes
+  //   Storage nodes of the cluster that are potential donors. Not copied, so
+  //   the cost of excluding nodes is proportional to the size of the
+  //   rebuilding set rather than to the size of the cluster.
   // @param out_comment
   //   A human-readable explanation for this transition.
   //   Should fit in the sentence:
@@ -380,7 +384,7 @@ class EventLogRebuildingSet {
       node_index_t nidx,
       std::chrono::milliseconds timestamp,
       NodeInfo& node_info,
-      std::unordered_set<node_index_t> storage_nodes,
+      const std::unordered_set<node_index_t>& storage_nodes,
       std::string* out_comment) const;
 
   int onShardNeedsRebuild(
@@ -28,6 +28,7 @@ EventLogStateMachine::EventLogStateMachine(
 
   handle_ = subscribe(cb);
   setSnapshottingGracePeriod(settings_->eventlog_snapshotting_period);
+  setMaxDeltaSnapshots(settings_->rsm_max_delta_snapshots);
 }
 
 bool EventLogStateMachine::thisNodeCanTrimAndSnapshot() const {
@@ -205,10 +206,17 @@ void EventLogStateMachine::postWriteDeltaRequest(
 }
 
 void EventLogStateMachine::onUpdate(const EventLogRebuildingSet& set,
-                                    const EventLogRecord* /*delta*/,
+                                    const EventLogRecord* delta,
                                     lsn_t version) {
   if (update_workers_) {
-    gracePeriodTimer_.activate(settings_->event_log_grace_period);
+    // Donor progress only moves rebuilding windows and never changes the
+    // authoritative status of a shard. These are the most frequent records
+    // while shards are rebuilding; re-arming the timer for them would keep
+    // pushing back the broadcast of status changes.
+    if (delta == nullptr ||
+        delta->getType() != EventType::SHARD_DONOR_PROGRESS) {
+      gracePeriodTimer_.activate(settings_->event_log_grace_period);
+    }
     publishRebuildingSet();
   }
 
@@ -170,6 +170,7 @@ APPENDED_Message::getDebugInfo() const {
     FLAG(INCLUDES_SEQ_BATCHING_OFFSET)
     FLAG(NOT_REPLICATED)
     FLAG(REDIRECT_NOT_ALIVE)
+    FLAG(REDIRECT_HANDOFF)
 #undef FLAG
     return folly::join('|', strings);
   };
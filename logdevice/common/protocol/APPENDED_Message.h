@@ -80,6 +80,10 @@ struct APPENDED_Header {
   // preemptor doesn't seem to be alive. In that case clients need to retry the
   // append rather than follow the redirect.
   static const APPENDED_flags_t REDIRECT_NOT_ALIVE = 4;
+  // If set, the log was handed off to the `redirect' node to shed load from
+  // the replying node. Clients should resend with NO_REDIRECT so that the
+  // `redirect' node keeps the log instead of sending it back.
+  static const APPENDED_flags_t REDIRECT_HANDOFF = 8;
 
   const APPENDED_Header& operator=(const Legacy_APPENDED_Header&);
 };
@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/CHECKSUM_FAIL_Message.h"
+
+#include <cstdlib>
+
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+CHECKSUM_FAIL_Message::CHECKSUM_FAIL_Message(
+    const CHECKSUM_FAIL_Header& header)
+    : Message(MessageType::CHECKSUM_FAIL, TrafficClass::HANDSHAKE),
+      header_(header) {}
+
+void CHECKSUM_FAIL_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+}
+
+MessageReadResult CHECKSUM_FAIL_Message::deserialize(ProtocolReader& reader) {
+  CHECKSUM_FAIL_Header hdr;
+  reader.read(&hdr);
+  return reader.result([&] { return new CHECKSUM_FAIL_Message(hdr); });
+}
+
+Message::Disposition CHECKSUM_FAIL_Message::onReceived(const Address&) {
+  // Receipt handler is CHECKSUM_FAIL_onReceived(); this should
+  // never get called.
+  std::abort();
+}
+
+}} // namespace facebook::logdevice
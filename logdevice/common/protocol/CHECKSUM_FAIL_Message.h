@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file CHECKSUM_FAIL is sent by readers to tell a storage node that a record
+ *       it shipped failed payload checksum verification on the reader.
+ *
+ *       Storage nodes don't verify payload checksums when reading; they ship
+ *       the stored checksum along with the payload and readers verify it (see
+ *       RECORD_Message::verifyChecksum()). A reader that finds a mismatch
+ *       reports it with this message so that the storage node can check
+ *       whether its copy of the record is corrupt.
+ */
+
+struct CHECKSUM_FAIL_Header {
+  logid_t log_id;
+  lsn_t lsn;
+  read_stream_id_t read_stream_id; // read stream that got the record
+  shard_index_t shard;             // shard the record was read from
+} __attribute__((__packed__));
+
+class CHECKSUM_FAIL_Message : public Message {
+ public:
+  explicit CHECKSUM_FAIL_Message(const CHECKSUM_FAIL_Header& header);
+
+  CHECKSUM_FAIL_Message(const CHECKSUM_FAIL_Message&) = delete;
+  CHECKSUM_FAIL_Message& operator=(const CHECKSUM_FAIL_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::CHECKSUM_FAIL_SUPPORT;
+  }
+
+  // Older storage nodes simply don't get the report.
+  bool warnAboutOldProtocol() const override {
+    return false;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address&) override;
+  static Message::deserializer_t deserialize;
+
+  const CHECKSUM_FAIL_Header& getHeader() const {
+    return header_;
+  }
+
+ private:
+  CHECKSUM_FAIL_Header header_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/protocol/FixedSizeMessage.h"
+#include "logdevice/common/protocol/MessageType.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Message sent by a client to a node that answered its
+ *       GET_CLUSTER_STATE, to have the node push its view of the cluster
+ *       state over the same connection whenever its failure detector sees a
+ *       node change state. Pushes are GET_CLUSTER_STATE_REPLY messages with
+ *       an invalid client_rqid. The subscription lasts until the client
+ *       unsubscribes or the connection is closed.
+ *
+ *       Only sent to nodes whose connection negotiated
+ *       Compatibility::CLUSTER_STATE_PUSH_SUPPORT.
+ */
+
+struct CLUSTER_STATE_SUBSCRIBE_Header {
+  uint8_t flags;
+
+  // cancel the subscription instead of creating it
+  static constexpr uint8_t UNSUBSCRIBE = 1 << 0;
+} __attribute__((__packed__));
+
+using CLUSTER_STATE_SUBSCRIBE_Message =
+    FixedSizeMessage<CLUSTER_STATE_SUBSCRIBE_Header,
+                     MessageType::CLUSTER_STATE_SUBSCRIBE,
+                     TrafficClass::FAILURE_DETECTOR>;
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/COMPRESSED_FRAME_Message.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+COMPRESSED_FRAME_Message::COMPRESSED_FRAME_Message(
+    const COMPRESSED_FRAME_Header& header,
+    std::string compressed)
+    : Message(MessageType::COMPRESSED_FRAME, TrafficClass::READ_BACKLOG),
+      header_(header),
+      compressed_(std::move(compressed)) {}
+
+void COMPRESSED_FRAME_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+  writer.write(compressed_.data(), compressed_.size());
+}
+
+MessageReadResult
+COMPRESSED_FRAME_Message::deserialize(ProtocolReader& reader) {
+  COMPRESSED_FRAME_Header header;
+  reader.read(&header);
+  if (reader.ok() &&
+      (header.uncompressed_len == 0 || reader.bytesRemaining() == 0)) {
+    ld_error("Bad COMPRESSED_FRAME message: %u bytes compressed into %zu",
+             header.uncompressed_len,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::string compressed(reader.bytesRemaining(), '\0');
+  reader.read(&compressed[0], compressed.size());
+  return reader.result([&] {
+    return new COMPRESSED_FRAME_Message(header, std::move(compressed));
+  });
+}
+
+Message::Disposition
+COMPRESSED_FRAME_Message::onReceived(const Address& from) {
+  // Frames are unwrapped by Socket::onCompressedFrameReceived() and never
+  // dispatched.
+  RATELIMIT_CRITICAL(std::chrono::seconds(10),
+                     1,
+                     "INTERNAL ERROR: COMPRESSED_FRAME from %s was dispatched",
+                     Sender::describeConnection(from).c_str());
+  ld_check(false);
+  err = E::PROTO;
+  return Disposition::ERROR;
+}
+
+}} // namespace facebook::logdevice
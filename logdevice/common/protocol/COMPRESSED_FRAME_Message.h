@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of messages, each with its own ProtocolHeader, compressed
+ *       with zstd by the sending Socket. Sockets whose peer is farther away
+ *       than --socket-compression-boundary wrap the messages they coalesce
+ *       within an event loop iteration into one of these. Each Socket keeps
+ *       a streaming compression context per direction, so a frame may refer
+ *       to data in earlier frames on the same connection and has to be
+ *       decompressed in order by the receiving Socket.
+ *
+ *       The receiving Socket unwraps frames itself and processes the inner
+ *       messages as if they had been read from the connection; the frame is
+ *       never dispatched.
+ *
+ *       Wire format:
+ *         COMPRESSED_FRAME_Header
+ *         compressed bytes up to the end of the message
+ */
+
+struct COMPRESSED_FRAME_Header {
+  // Size of the batch of messages once decompressed
+  uint32_t uncompressed_len;
+} __attribute__((__packed__));
+
+class COMPRESSED_FRAME_Message : public Message {
+ public:
+  COMPRESSED_FRAME_Message(const COMPRESSED_FRAME_Header& header,
+                           std::string compressed);
+
+  COMPRESSED_FRAME_Message(const COMPRESSED_FRAME_Message&) = delete;
+  COMPRESSED_FRAME_Message& operator=(const COMPRESSED_FRAME_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::COMPRESSED_FRAME_SUPPORT;
+  }
+
+  const COMPRESSED_FRAME_Header& getHeader() const {
+    return header_;
+  }
+
+  const std::string& getCompressed() const {
+    return compressed_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+  static Message::deserializer_t deserialize;
+
+ private:
+  COMPRESSED_FRAME_Header header_;
+  std::string compressed_;
+};
+
+}} // namespace facebook::logdevice
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "logdevice/common/ResourceBudget.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/SimpleMessage.h"
@@ -148,6 +149,12 @@ class CONFIG_CHANGED_Message : public Message {
     return config_str_;
   }
 
+  // Holds @param token until the message is destroyed, i.e. until it's sent
+  // or dropped. See Processor::config_changed_budget_.
+  void setBudgetToken(ResourceBudget::Token token) {
+    budget_token_ = std::move(token);
+  }
+
  private:
   Disposition handleCallbackAction(const Address& from);
   Disposition handleReloadAction(const Address& from);
@@ -156,6 +163,7 @@ class CONFIG_CHANGED_Message : public Message {
  private:
   CONFIG_CHANGED_Header header_;
   std::string config_str_;
+  ResourceBudget::Token budget_token_;
 };
 
 }} // namespace facebook::logdevice
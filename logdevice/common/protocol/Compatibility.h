@@ -95,6 +95,62 @@ enum ProtocolVersion : uint16_t {
   // SEALED message will include trim point for the given shard of the log
   TRIM_POINT_IN_SEALED, // == 95
 
+  // Sequencers may coalesce STOREs to the same storage node into a
+  // MULTI_STORE message
+  MULTI_STORE_SUPPORT, // == 96
+
+  // Sequencers running log recovery may coalesce SEALs to the same storage
+  // node into a MULTI_SEAL message
+  MULTI_SEAL_SUPPORT, // == 97
+
+  // GOSSIP messages encode the node list with varints and deltas instead of
+  // an array of fixed size GOSSIP_Node structs
+  COMPACT_GOSSIP_NODE_LIST, // == 98
+
+  // Sequencers may coalesce RELEASEs for different logs to the same storage
+  // node into a MULTI_RELEASE message
+  MULTI_RELEASE_SUPPORT, // == 99
+
+  // Sockets may wrap batches of messages into zstd-compressed
+  // COMPRESSED_FRAME messages
+  COMPRESSED_FRAME_SUPPORT, // == 100
+
+  // GET_SEQ_STATEs for different logs to the same sequencer node may be
+  // coalesced into a MULTI_GET_SEQ_STATE message
+  MULTI_GET_SEQ_STATE_SUPPORT, // == 101
+
+  // TRIMs for different logs to the same storage node may be coalesced into
+  // a MULTI_TRIM message
+  MULTI_TRIM_SUPPORT, // == 102
+
+  // IS_LOG_EMPTY and DATA_SIZE messages for different logs to the same
+  // storage node may be coalesced into MULTI_IS_LOG_EMPTY and MULTI_DATA_SIZE
+  // messages
+  MULTI_LOG_QUERY_SUPPORT, // == 103
+
+  // Clients may send CLUSTER_STATE_SUBSCRIBE to get the cluster state pushed
+  // to them in GET_CLUSTER_STATE_REPLY messages when it changes
+  CLUSTER_STATE_PUSH_SUPPORT, // == 104
+
+  // Storage nodes may send records of a catching up read stream in
+  // RECORD_BATCH messages
+  RECORD_BATCH_SUPPORT, // == 105
+
+  // Readers may report records that failed checksum verification with a
+  // CHECKSUM_FAIL message
+  CHECKSUM_FAIL_SUPPORT, // == 106
+
+  // Storage nodes may push trim point advances to sequencer nodes in
+  // TRIM_POINT_UPDATE messages
+  TRIM_POINT_UPDATE_SUPPORT, // == 107
+
+  // Storage nodes may batch MUTATED replies in MULTI_MUTATED messages
+  MULTI_MUTATED_SUPPORT, // == 108
+
+  // START messages may ask for
+  // SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION
+  SCD_LSN_BLOCK_ROTATION_SUPPORT, // == 109
+
   // NOTE: insert new protocol versions here
 
   // Maximum version number of the protocol this version of LogDevice
@@ -135,6 +191,20 @@ static_assert(HASHMAP_SUPPORT_IN_GOSSIP == 92, "");
 static_assert(RID_IN_CONFIG_MESSAGES == 93, "");
 static_assert(WAVE_IN_MUTATED == 94, "");
 static_assert(TRIM_POINT_IN_SEALED == 95, "");
+static_assert(MULTI_STORE_SUPPORT == 96, "");
+static_assert(MULTI_SEAL_SUPPORT == 97, "");
+static_assert(COMPACT_GOSSIP_NODE_LIST == 98, "");
+static_assert(MULTI_RELEASE_SUPPORT == 99, "");
+static_assert(COMPRESSED_FRAME_SUPPORT == 100, "");
+static_assert(MULTI_GET_SEQ_STATE_SUPPORT == 101, "");
+static_assert(MULTI_TRIM_SUPPORT == 102, "");
+static_assert(MULTI_LOG_QUERY_SUPPORT == 103, "");
+static_assert(CLUSTER_STATE_PUSH_SUPPORT == 104, "");
+static_assert(RECORD_BATCH_SUPPORT == 105, "");
+static_assert(CHECKSUM_FAIL_SUPPORT == 106, "");
+static_assert(TRIM_POINT_UPDATE_SUPPORT == 107, "");
+static_assert(MULTI_MUTATED_SUPPORT == 108, "");
+static_assert(SCD_LSN_BLOCK_ROTATION_SUPPORT == 109, "");
 
 constexpr uint16_t MIN_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_LOWER_BOUND + 1;
 constexpr uint16_t MAX_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_UPPER_BOUND - 1;
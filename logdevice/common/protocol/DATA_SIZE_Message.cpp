@@ -38,15 +38,21 @@ Message::Disposition DATA_SIZE_Message::onReceived(const Address& /*from*/) {
 }
 
 void DATA_SIZE_Message::onSent(Status status, const Address& to) const {
+  onSentCommon(header_, status, to);
+}
+
+void DATA_SIZE_Message::onSentCommon(const DATA_SIZE_Header& header,
+                                     Status status,
+                                     const Address& to) {
   ld_debug(": message=DATA_SIZE st=%s to=%s",
            error_name(status),
            Sender::describeConnection(to).c_str());
 
   // Inform the DataSizeRequest of the outcome of sending the message
   auto& rqmap = Worker::onThisThread()->runningDataSize().map;
-  auto it = rqmap.find(header_.client_rqid);
+  auto it = rqmap.find(header.client_rqid);
   if (it != rqmap.end()) {
-    ShardID shard(to.id_.node_.index(), header_.shard);
+    ShardID shard(to.id_.node_.index(), header.shard);
     it->second->onMessageSent(shard, status);
   }
 }
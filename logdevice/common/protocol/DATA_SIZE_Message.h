@@ -45,6 +45,13 @@ class DATA_SIZE_Message : public Message {
   // see Message.h
   void serialize(ProtocolWriter&) const override;
   void onSent(Status st, const Address& to) const override;
+
+  // Reports the outcome of sending the request described by `header` to its
+  // DataSizeRequest. Also used for requests sent as part of a MULTI_DATA_SIZE.
+  static void onSentCommon(const DATA_SIZE_Header& header,
+                           Status st,
+                           const Address& to);
+
   Disposition onReceived(const Address&) override;
   static Message::deserializer_t deserialize;
 
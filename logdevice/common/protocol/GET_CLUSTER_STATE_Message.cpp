@@ -7,10 +7,12 @@
  */
 #include "logdevice/common/protocol/GET_CLUSTER_STATE_Message.h"
 
+#include "logdevice/common/ClusterStatePublisher.h"
 #include "logdevice/common/GetClusterStateRequest.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/CLUSTER_STATE_SUBSCRIBE_Message.h"
 #include "logdevice/common/protocol/GET_CLUSTER_STATE_REPLY_Message.h"
 
 namespace facebook { namespace logdevice {
@@ -18,46 +20,17 @@ namespace facebook { namespace logdevice {
 template <>
 Message::Disposition
 GET_CLUSTER_STATE_Message::onReceived(const Address& from) {
-  Status status = E::OK;
   std::vector<uint8_t> nodes_state;
   std::vector<node_index_t> boycotted_nodes;
-  Worker* w = Worker::onThisThread();
-
-  // check if cluster state is enabled
-  auto cs = Worker::getClusterState();
-  if (!cs) {
+  Status status =
+      ClusterStatePublisher::getClusterState(&nodes_state, &boycotted_nodes);
+  if (status == E::NOTSUPPORTED) {
     RATELIMIT_INFO(std::chrono::seconds(10),
                    1,
                    "Cluster state requested by %s is not available",
                    Sender::describeConnection(from).c_str());
-    status = E::NOTSUPPORTED;
-  } else if (!(w && w->processor_ &&
-               w->processor_->isFailureDetectorRunning())) {
-    RATELIMIT_INFO(std::chrono::seconds(10),
-                   1,
-                   "FailureDetector is not running on this node, "
-                   "returning E::NOTSUPPORTED");
-    status = E::NOTSUPPORTED;
-  } else {
-    auto my_node_id = Worker::onThisThread()->processor_->getMyNodeID();
-    auto config = Worker::getConfig();
-
-    if (!cs->isNodeAlive(my_node_id.index())) {
-      RATELIMIT_INFO(
-          std::chrono::seconds(5), 1, "Failure detector is not ready");
-      status = E::NOTREADY;
-    } else {
-      size_t count = config->serverConfig()->getMaxNodeIdx() + 1;
-      nodes_state.resize(count);
-
-      for (node_index_t i = 0; i < count; i++) {
-        nodes_state[i] = cs->getNodeState(i);
-
-        if (cs->isNodeBoycotted(i)) {
-          boycotted_nodes.emplace_back(i);
-        }
-      }
-    }
+  } else if (status == E::NOTREADY) {
+    RATELIMIT_INFO(std::chrono::seconds(5), 1, "Failure detector is not ready");
   }
 
   GET_CLUSTER_STATE_REPLY_Header hdr({header_.client_rqid, status});
@@ -79,4 +52,27 @@ void GET_CLUSTER_STATE_Message::onSent(Status st, const Address& /*to*/) const {
   }
 }
 
+template <>
+Message::Disposition
+CLUSTER_STATE_SUBSCRIBE_Message::onReceived(const Address& from) {
+  if (!from.isClientAddress()) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Got CLUSTER_STATE_SUBSCRIBE from %s, which is not a "
+                    "client connection",
+                    Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  ClusterStatePublisher& publisher =
+      Worker::onThisThread()->clusterStatePublisher();
+  if (header_.flags & CLUSTER_STATE_SUBSCRIBE_Header::UNSUBSCRIBE) {
+    publisher.unsubscribe(from.asClientID());
+  } else {
+    publisher.subscribe(from.asClientID());
+  }
+  return Disposition::NORMAL;
+}
+
 }} // namespace facebook::logdevice
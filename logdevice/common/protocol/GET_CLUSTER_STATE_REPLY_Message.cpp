@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/protocol/GET_CLUSTER_STATE_REPLY_Message.h"
 
+#include "logdevice/common/ClusterState.h"
 #include "logdevice/common/GetClusterStateRequest.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
@@ -16,6 +17,15 @@ namespace facebook { namespace logdevice {
 
 Message::Disposition
 GET_CLUSTER_STATE_REPLY_Message::onReceived(const Address& from) {
+  if (header_.client_rqid == REQUEST_ID_INVALID) {
+    // Pushed by a node this client subscribed to with CLUSTER_STATE_SUBSCRIBE
+    ClusterState* cs = Worker::getClusterState();
+    if (cs && header_.status == E::OK) {
+      cs->onClusterStatePushed(from, nodes_state_, std::move(boycotted_nodes_));
+    }
+    return Disposition::NORMAL;
+  }
+
   auto& rqmap = Worker::onThisThread()->runningGetClusterState().map;
   auto it = rqmap.find(header_.client_rqid);
   if (it != rqmap.end()) {
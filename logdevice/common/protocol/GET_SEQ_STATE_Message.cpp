@@ -714,7 +714,7 @@ bool GET_SEQ_STATE_Message::shouldRedirectOnPreemption(
 
 bool GET_SEQ_STATE_Message::shouldRedirectOrFail(logid_t datalog_id,
                                                  Status& status_out,
-                                                 NodeID seq_node,
+                                                 NodeID& seq_node,
                                                  const Address& from) {
   Worker* w = Worker::onThisThread();
   auto failure_detector_running = w->processor_->isFailureDetectorRunning();
@@ -766,6 +766,23 @@ bool GET_SEQ_STATE_Message::shouldRedirectOrFail(logid_t datalog_id,
     return true;
   }
 
+  auto sequencer = w->processor_->allSequencers().findSequencer(datalog_id);
+  if (sequencer) {
+    NodeID handoff_target = sequencer->getHandoffTarget();
+    if (handoff_target.isNodeID() &&
+        w->processor_->isNodeAlive(handoff_target.index()) &&
+        !w->processor_->isNodeBoycotted(handoff_target.index())) {
+      // this node handed the log off to shed load, don't take it back
+      seq_node = handoff_target;
+    } else if (sequencer->getState() == Sequencer::State::ACTIVE &&
+               sequencer->checkNoRedirectUntil()) {
+      // same as for appends, keep serving the log for a little longer after
+      // a client asked this node not to redirect (e.g. because the log was
+      // handed off here)
+      return false;
+    }
+  }
+
   // does FD think that this node should be running the sequencer
   ld_check(seq_node.isNodeID());
   if (seq_node.index() == w->processor_->getMyNodeID().index()) {
@@ -144,7 +144,9 @@ class GET_SEQ_STATE_Message : public Message {
    *                     E::REDIRECTED
    *
    * @param seq_node     Node which should handle this request according
-   *                     to the sequencer locator.
+   *                     to the sequencer locator. Replaced with the node the
+   *                     log was handed off to if this node handed it off
+   *                     (see Sequencer::handOff()).
    *
    * @param from         Address of client which sent this request.
    *                     This is useful for debugging purpose only.
@@ -155,6 +157,8 @@ class GET_SEQ_STATE_Message : public Message {
    *                  is already a sequencer present for 'datalog_id'
    *                - If the primary sequencer node is not alive according to
    *                  this node's FailureDetector.
+   *                - If this node runs an active sequencer for 'datalog_id'
+   *                  and its no_redirect_until hasn't expired.
    *
    *          true: - If lazy sequencer placement is not being used and this
    *                  node doesn't already have a sequencer for 'datalog_id'.
@@ -165,7 +169,7 @@ class GET_SEQ_STATE_Message : public Message {
    */
   bool shouldRedirectOrFail(logid_t datalog_id,
                             Status& status_out,
-                            NodeID seq_node,
+                            NodeID& seq_node,
                             const Address& from);
 
   /**
@@ -9,6 +9,8 @@
 
 #include <memory>
 
+#include <folly/Range.h>
+#include <folly/Varint.h>
 #include <folly/small_vector.h>
 
 #include "logdevice/common/Processor.h"
@@ -112,7 +114,10 @@ void GOSSIP_Message::serialize(ProtocolWriter& writer) const {
     }
   }
   if (writer.proto() >=
-      Compatibility::ProtocolVersion::HASHMAP_SUPPORT_IN_GOSSIP) {
+      Compatibility::ProtocolVersion::COMPACT_GOSSIP_NODE_LIST) {
+    writeCompactNodeList(writer);
+  } else if (writer.proto() >=
+             Compatibility::ProtocolVersion::HASHMAP_SUPPORT_IN_GOSSIP) {
     writer.writeVector(node_list_);
   }
 }
@@ -171,7 +176,10 @@ MessageReadResult GOSSIP_Message::deserialize(ProtocolReader& reader) {
   }
 
   if (reader.proto() >=
-      Compatibility::ProtocolVersion::HASHMAP_SUPPORT_IN_GOSSIP) {
+      Compatibility::ProtocolVersion::COMPACT_GOSSIP_NODE_LIST) {
+    msg->readCompactNodeList(reader, num_nodes);
+  } else if (reader.proto() >=
+             Compatibility::ProtocolVersion::HASHMAP_SUPPORT_IN_GOSSIP) {
     reader.readVector(&msg->node_list_, num_nodes);
   } else {
     // In case of protocol before HASHMAP_SUPPORT_IN_GOSSIP,
@@ -251,4 +259,99 @@ void GOSSIP_Message::readBoycottDurations(ProtocolReader& reader) {
   }
 }
 
+namespace {
+
+// Bits in the low bits of the varint holding gossip_ in the compact node list.
+constexpr uint64_t COMPACT_NODE_STARTING = 1 << 0;
+constexpr uint64_t COMPACT_NODE_HAS_FAILOVER = 1 << 1;
+constexpr int COMPACT_NODE_FLAG_BITS = 2;
+
+void putVarint(uint64_t val, std::string* out) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  size_t len = folly::encodeVarint(val, buf);
+  out->append(reinterpret_cast<const char*>(buf), len);
+}
+
+} // namespace
+
+// A GOSSIP_Node struct takes 40 bytes on the wire, most of which are zeroes
+// or the same as in the previous node. In the compact format, nodes are
+// sorted by id, and for each node we write these unsigned varints:
+//  - node id minus the previous node's id (or 0 for the first one);
+//  - gossip_, shifted left by COMPACT_NODE_FLAG_BITS, the low bits being
+//    COMPACT_NODE_* flags;
+//  - zigzagged gossip_ts_ minus the previous node's gossip_ts_ (or 0);
+//  - if COMPACT_NODE_HAS_FAILOVER, zigzagged failover_ minus gossip_ts_
+//    (failover_ is usually either 0 or gossip_ts_).
+// That's usually around 8 bytes per node. The whole thing is written as a
+// length-prefixed blob.
+void GOSSIP_Message::writeCompactNodeList(ProtocolWriter& writer) const {
+  node_list_t sorted_node_list = node_list_;
+  std::sort(sorted_node_list.begin(), sorted_node_list.end());
+
+  std::string buf;
+  buf.reserve(sorted_node_list.size() * 8);
+  size_t prev_id = 0;
+  int64_t prev_ts = 0;
+  for (const GOSSIP_Node& n : sorted_node_list) {
+    const bool has_failover = n.failover_ != std::chrono::milliseconds::zero();
+    putVarint(n.node_id_ - prev_id, &buf);
+    putVarint((uint64_t(n.gossip_) << COMPACT_NODE_FLAG_BITS) |
+                  (n.is_node_starting_ ? COMPACT_NODE_STARTING : 0) |
+                  (has_failover ? COMPACT_NODE_HAS_FAILOVER : 0),
+              &buf);
+    putVarint(folly::encodeZigZag(n.gossip_ts_.count() - prev_ts), &buf);
+    if (has_failover) {
+      putVarint(
+          folly::encodeZigZag(n.failover_.count() - n.gossip_ts_.count()),
+          &buf);
+    }
+    prev_id = n.node_id_;
+    prev_ts = n.gossip_ts_.count();
+  }
+  writer.writeLengthPrefixedVector(buf);
+}
+
+void GOSSIP_Message::readCompactNodeList(ProtocolReader& reader,
+                                         uint16_t num_nodes) {
+  std::string buf;
+  reader.readLengthPrefixedVector(&buf);
+  if (!reader.ok()) {
+    return;
+  }
+
+  folly::ByteRange range(
+      reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
+  node_list_.clear();
+  node_list_.reserve(num_nodes);
+  size_t id = 0;
+  int64_t ts = 0;
+  try {
+    for (uint16_t i = 0; i < num_nodes; ++i) {
+      GOSSIP_Node n;
+      id += folly::decodeVarint(range);
+      const uint64_t gossip_and_flags = folly::decodeVarint(range);
+      ts += folly::decodeZigZag(folly::decodeVarint(range));
+      n.node_id_ = id;
+      n.gossip_ = gossip_and_flags >> COMPACT_NODE_FLAG_BITS;
+      n.gossip_ts_ = std::chrono::milliseconds(ts);
+      n.is_node_starting_ = gossip_and_flags & COMPACT_NODE_STARTING;
+      n.failover_ = std::chrono::milliseconds::zero();
+      if (gossip_and_flags & COMPACT_NODE_HAS_FAILOVER) {
+        n.failover_ = std::chrono::milliseconds(
+            ts + folly::decodeZigZag(folly::decodeVarint(range)));
+      }
+      node_list_.push_back(n);
+    }
+  } catch (...) {
+    // Truncated or invalid varint.
+    range.clear();
+    reader.setError(E::BADMSG);
+    return;
+  }
+  if (!range.empty()) {
+    reader.setError(E::BADMSG);
+  }
+}
+
 }} // namespace facebook::logdevice
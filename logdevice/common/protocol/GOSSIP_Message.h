@@ -142,5 +142,9 @@ class GOSSIP_Message : public Message {
 
   void writeStartingList(ProtocolWriter& writer) const;
   void readStartingList(ProtocolReader& reader);
+
+  // Node list format for protocol >= COMPACT_GOSSIP_NODE_LIST, see .cpp
+  void writeCompactNodeList(ProtocolWriter& writer) const;
+  void readCompactNodeList(ProtocolReader& reader, uint16_t num_nodes);
 };
 }} // namespace facebook::logdevice
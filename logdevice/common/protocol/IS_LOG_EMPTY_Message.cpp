@@ -38,15 +38,21 @@ Message::Disposition IS_LOG_EMPTY_Message::onReceived(const Address& /*from*/) {
 }
 
 void IS_LOG_EMPTY_Message::onSent(Status status, const Address& to) const {
+  onSentCommon(header_, status, to);
+}
+
+void IS_LOG_EMPTY_Message::onSentCommon(const IS_LOG_EMPTY_Header& header,
+                                        Status status,
+                                        const Address& to) {
   ld_debug(": message=IS_LOG_EMPTY st=%s to=%s",
            error_name(status),
            Sender::describeConnection(to).c_str());
 
   // Inform the IsLogEmptyRequest of the outcome of sending the message
   auto& rqmap = Worker::onThisThread()->runningIsLogEmpty().map;
-  auto it = rqmap.find(header_.client_rqid);
+  auto it = rqmap.find(header.client_rqid);
   if (it != rqmap.end()) {
-    ShardID shard(to.id_.node_.index(), header_.shard);
+    ShardID shard(to.id_.node_.index(), header.shard);
     it->second->onMessageSent(shard, status);
   }
 }
@@ -42,6 +42,14 @@ class IS_LOG_EMPTY_Message : public Message {
   // see Message.h
   void serialize(ProtocolWriter&) const override;
   void onSent(Status st, const Address& to) const override;
+
+  // Reports the outcome of sending the request described by `header` to its
+  // IsLogEmptyRequest. Also used for requests sent as part of a
+  // MULTI_IS_LOG_EMPTY.
+  static void onSentCommon(const IS_LOG_EMPTY_Header& header,
+                           Status st,
+                           const Address& to);
+
   Disposition onReceived(const Address&) override;
   static Message::deserializer_t deserialize;
 
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_DATA_SIZE_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_DATA_SIZE_Message::MULTI_DATA_SIZE_Message(
+    std::vector<DATA_SIZE_Header> requests)
+    : Message(MessageType::MULTI_DATA_SIZE, TrafficClass::READ_BACKLOG),
+      requests_(std::move(requests)) {
+  ld_check(!requests_.empty());
+}
+
+void MULTI_DATA_SIZE_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_requests = requests_.size();
+  writer.write(num_requests);
+  writer.writeVector(requests_);
+}
+
+MessageReadResult MULTI_DATA_SIZE_Message::deserialize(ProtocolReader& reader) {
+  uint32_t num_requests = 0;
+  reader.read(&num_requests);
+  if (reader.ok() &&
+      (num_requests == 0 ||
+       num_requests > reader.bytesRemaining() / sizeof(DATA_SIZE_Header))) {
+    ld_error("Bad MULTI_DATA_SIZE message: %u requests in %zu bytes",
+             num_requests,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<DATA_SIZE_Header> requests;
+  reader.readVector(&requests, num_requests);
+  return reader.result(
+      [&] { return new MULTI_DATA_SIZE_Message(std::move(requests)); });
+}
+
+Message::Disposition
+MULTI_DATA_SIZE_Message::onReceived(const Address& /*from*/) {
+  // Receipt handler lives in server/DATA_SIZE_onReceived.cpp; this should
+  // never get called.
+  std::abort();
+}
+
+void MULTI_DATA_SIZE_Message::onSent(Status st, const Address& to) const {
+  for (const DATA_SIZE_Header& header : requests_) {
+    DATA_SIZE_Message::onSentCommon(header, st, to);
+  }
+}
+
+bool MULTI_DATA_SIZE_Message::warnAboutOldProtocol() const {
+  return false;
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+MULTI_DATA_SIZE_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("num_requests", requests_.size());
+  folly::dynamic logs = folly::dynamic::array;
+  for (const DATA_SIZE_Header& header : requests_) {
+    logs.push_back(header.log_id.val_);
+  }
+  res.emplace_back("logs", std::move(logs));
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/DATA_SIZE_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of DATA_SIZE messages that a client sends to the same storage
+ *       node, for different logs. Client::dataSizeBatch() starts a
+ *       DataSizeRequest per log, all on the same Worker, and those hand their
+ *       DATA_SIZEs to the LogQueryBatcher of the Worker, which coalesces the
+ *       ones headed to the same node within --log-query-batching-window into
+ *       a single MULTI_DATA_SIZE.
+ *
+ *       The recipient answers each request exactly as if it arrived in a
+ *       separate DATA_SIZE message, with its own DATA_SIZE_REPLY.
+ *
+ *       Wire format:
+ *         uint32_t num_requests
+ *         num_requests x DATA_SIZE_Header
+ */
+
+class MULTI_DATA_SIZE_Message : public Message {
+ public:
+  explicit MULTI_DATA_SIZE_Message(std::vector<DATA_SIZE_Header> requests);
+
+  MULTI_DATA_SIZE_Message(const MULTI_DATA_SIZE_Message&) = delete;
+  MULTI_DATA_SIZE_Message& operator=(const MULTI_DATA_SIZE_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_LOG_QUERY_SUPPORT;
+  }
+
+  const std::vector<DATA_SIZE_Header>& getRequests() const {
+    return requests_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  static Message::deserializer_t deserialize;
+
+  bool warnAboutOldProtocol() const override;
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+ private:
+  std::vector<DATA_SIZE_Header> requests_;
+};
+
+}} // namespace facebook::logdevice
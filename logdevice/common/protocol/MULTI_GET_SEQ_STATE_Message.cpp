@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_GET_SEQ_STATE_Message.h"
+
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_GET_SEQ_STATE_Message::MULTI_GET_SEQ_STATE_Message(
+    std::vector<std::unique_ptr<GET_SEQ_STATE_Message>> requests)
+    : Message(MessageType::MULTI_GET_SEQ_STATE, TrafficClass::RECOVERY),
+      requests_(std::move(requests)) {
+  ld_check(!requests_.empty());
+}
+
+void MULTI_GET_SEQ_STATE_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_requests = requests_.size();
+  writer.write(num_requests);
+  for (const auto& rq : requests_) {
+    writer.write(rq->log_id_);
+    writer.write(rq->request_id_);
+    writer.write(rq->flags_);
+    writer.write(rq->calling_ctx_);
+    if (rq->flags_ & GET_SEQ_STATE_Message::MIN_EPOCH) {
+      ld_check(rq->min_epoch_.hasValue());
+      writer.write(rq->min_epoch_.value());
+    }
+  }
+}
+
+MessageReadResult
+MULTI_GET_SEQ_STATE_Message::deserialize(ProtocolReader& reader) {
+  constexpr size_t min_entry_size = sizeof(logid_t) + sizeof(request_id_t) +
+      sizeof(GET_SEQ_STATE_flags_t) + sizeof(GetSeqStateRequest::Context);
+
+  uint32_t num_requests = 0;
+  reader.read(&num_requests);
+  if (reader.ok() &&
+      (num_requests == 0 ||
+       num_requests > reader.bytesRemaining() / min_entry_size)) {
+    ld_error("Bad MULTI_GET_SEQ_STATE message: %u requests in %zu bytes",
+             num_requests,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<std::unique_ptr<GET_SEQ_STATE_Message>> requests;
+  requests.reserve(num_requests);
+  for (uint32_t i = 0; i < num_requests && reader.ok(); ++i) {
+    logid_t log_id;
+    request_id_t request_id(-1);
+    GET_SEQ_STATE_flags_t flags = 0;
+    GetSeqStateRequest::Context calling_ctx{
+        GetSeqStateRequest::Context::UNKNOWN};
+    folly::Optional<epoch_t> min_epoch;
+
+    reader.read(&log_id);
+    reader.read(&request_id);
+    reader.read(&flags);
+    reader.read(&calling_ctx);
+    if (flags & GET_SEQ_STATE_Message::MIN_EPOCH) {
+      epoch_t read_min_epoch;
+      reader.read(&read_min_epoch);
+      min_epoch.assign(read_min_epoch);
+    }
+    requests.push_back(std::make_unique<GET_SEQ_STATE_Message>(
+        log_id, request_id, flags, calling_ctx, min_epoch));
+  }
+
+  return reader.result(
+      [&] { return new MULTI_GET_SEQ_STATE_Message(std::move(requests)); });
+}
+
+Message::Disposition
+MULTI_GET_SEQ_STATE_Message::onReceived(const Address& from) {
+  WORKER_STAT_INCR(multi_get_seq_state_received);
+  WORKER_STAT_ADD(multi_get_seq_state_requests_received, requests_.size());
+
+  for (auto& rq : requests_) {
+    // Each GET_SEQ_STATE_Message either finishes synchronously or takes
+    // ownership of itself until it sends its reply.
+    if (rq->onReceived(from) == Disposition::KEEP) {
+      rq.release();
+    }
+  }
+  requests_.clear();
+  return Disposition::NORMAL;
+}
+
+void MULTI_GET_SEQ_STATE_Message::onSent(Status st, const Address& to) const {
+  for (const auto& rq : requests_) {
+    rq->onSent(st, to);
+  }
+}
+
+bool MULTI_GET_SEQ_STATE_Message::warnAboutOldProtocol() const {
+  return false;
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+MULTI_GET_SEQ_STATE_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("num_requests", requests_.size());
+  folly::dynamic logs = folly::dynamic::array;
+  for (const auto& rq : requests_) {
+    logs.push_back(rq->log_id_.val_);
+  }
+  res.emplace_back("logs", std::move(logs));
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/protocol/GET_SEQ_STATE_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of GET_SEQ_STATE messages sent to the same sequencer node,
+ *       for different logs. A rebuilding donor needs the sequencer state of
+ *       every log it holds before it can start re-replicating records, which
+ *       for a shard with hundreds of thousands of logs means as many
+ *       GET_SEQ_STATE round trips. GetSeqStateRequests issued by the
+ *       rebuilding planner hand their GET_SEQ_STATEs to the GetSeqStateBatcher
+ *       of their Worker, which coalesces the ones headed to the same node
+ *       within --seq-state-batching-window into a single MULTI_GET_SEQ_STATE.
+ *
+ *       The recipient processes each entry exactly as if it arrived in a
+ *       separate GET_SEQ_STATE message, and replies to each with its own
+ *       GET_SEQ_STATE_REPLY.
+ *
+ *       Wire format:
+ *         uint32_t num_requests
+ *         num_requests x {
+ *           logid_t log_id
+ *           request_id_t request_id
+ *           GET_SEQ_STATE_flags_t flags
+ *           GetSeqStateRequest::Context calling_ctx
+ *           epoch_t min_epoch      (only if flags has MIN_EPOCH)
+ *         }
+ */
+
+class MULTI_GET_SEQ_STATE_Message : public Message {
+ public:
+  explicit MULTI_GET_SEQ_STATE_Message(
+      std::vector<std::unique_ptr<GET_SEQ_STATE_Message>> requests);
+
+  MULTI_GET_SEQ_STATE_Message(const MULTI_GET_SEQ_STATE_Message&) = delete;
+  MULTI_GET_SEQ_STATE_Message&
+  operator=(const MULTI_GET_SEQ_STATE_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_GET_SEQ_STATE_SUPPORT;
+  }
+
+  const std::vector<std::unique_ptr<GET_SEQ_STATE_Message>>&
+  getRequests() const {
+    return requests_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address& from) override;
+  static Message::deserializer_t deserialize;
+
+  bool warnAboutOldProtocol() const override;
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+ private:
+  std::vector<std::unique_ptr<GET_SEQ_STATE_Message>> requests_;
+};
+
+}} // namespace facebook::logdevice
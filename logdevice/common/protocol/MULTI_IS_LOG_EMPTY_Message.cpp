@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_IS_LOG_EMPTY_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_IS_LOG_EMPTY_Message::MULTI_IS_LOG_EMPTY_Message(
+    std::vector<IS_LOG_EMPTY_Header> requests)
+    : Message(MessageType::MULTI_IS_LOG_EMPTY, TrafficClass::READ_BACKLOG),
+      requests_(std::move(requests)) {
+  ld_check(!requests_.empty());
+}
+
+void MULTI_IS_LOG_EMPTY_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_requests = requests_.size();
+  writer.write(num_requests);
+  writer.writeVector(requests_);
+}
+
+MessageReadResult
+MULTI_IS_LOG_EMPTY_Message::deserialize(ProtocolReader& reader) {
+  uint32_t num_requests = 0;
+  reader.read(&num_requests);
+  if (reader.ok() &&
+      (num_requests == 0 ||
+       num_requests > reader.bytesRemaining() / sizeof(IS_LOG_EMPTY_Header))) {
+    ld_error("Bad MULTI_IS_LOG_EMPTY message: %u requests in %zu bytes",
+             num_requests,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<IS_LOG_EMPTY_Header> requests;
+  reader.readVector(&requests, num_requests);
+  return reader.result(
+      [&] { return new MULTI_IS_LOG_EMPTY_Message(std::move(requests)); });
+}
+
+Message::Disposition
+MULTI_IS_LOG_EMPTY_Message::onReceived(const Address& /*from*/) {
+  // Receipt handler lives in server/IS_LOG_EMPTY_onReceived.cpp; this should
+  // never get called.
+  std::abort();
+}
+
+void MULTI_IS_LOG_EMPTY_Message::onSent(Status st, const Address& to) const {
+  for (const IS_LOG_EMPTY_Header& header : requests_) {
+    IS_LOG_EMPTY_Message::onSentCommon(header, st, to);
+  }
+}
+
+bool MULTI_IS_LOG_EMPTY_Message::warnAboutOldProtocol() const {
+  return false;
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+MULTI_IS_LOG_EMPTY_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("num_requests", requests_.size());
+  folly::dynamic logs = folly::dynamic::array;
+  for (const IS_LOG_EMPTY_Header& header : requests_) {
+    logs.push_back(header.log_id.val_);
+  }
+  res.emplace_back("logs", std::move(logs));
+  return res;
+}
+
+}} // namespace facebook::logdevice
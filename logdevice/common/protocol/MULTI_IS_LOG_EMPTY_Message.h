@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/IS_LOG_EMPTY_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of IS_LOG_EMPTY messages that a client sends to the same
+ *       storage node, for different logs. Client::isLogEmptyBatch() starts an
+ *       IsLogEmptyRequest per log, all on the same Worker, and those hand
+ *       their IS_LOG_EMPTYs to the LogQueryBatcher of the Worker, which
+ *       coalesces the ones headed to the same node within
+ *       --log-query-batching-window into a single MULTI_IS_LOG_EMPTY.
+ *
+ *       The recipient checks permissions and answers each request exactly as
+ *       if it arrived in a separate IS_LOG_EMPTY message, with its own
+ *       IS_LOG_EMPTY_REPLY.
+ *
+ *       Wire format:
+ *         uint32_t num_requests
+ *         num_requests x IS_LOG_EMPTY_Header
+ */
+
+class MULTI_IS_LOG_EMPTY_Message : public Message {
+ public:
+  explicit MULTI_IS_LOG_EMPTY_Message(
+      std::vector<IS_LOG_EMPTY_Header> requests);
+
+  MULTI_IS_LOG_EMPTY_Message(const MULTI_IS_LOG_EMPTY_Message&) = delete;
+  MULTI_IS_LOG_EMPTY_Message&
+  operator=(const MULTI_IS_LOG_EMPTY_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_LOG_QUERY_SUPPORT;
+  }
+
+  const std::vector<IS_LOG_EMPTY_Header>& getRequests() const {
+    return requests_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  static Message::deserializer_t deserialize;
+
+  bool warnAboutOldProtocol() const override;
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+ private:
+  std::vector<IS_LOG_EMPTY_Header> requests_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_MUTATED_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_MUTATED_Message::MULTI_MUTATED_Message(
+    std::vector<MUTATED_Header> replies)
+    : Message(MessageType::MULTI_MUTATED, TrafficClass::RECOVERY),
+      replies_(std::move(replies)) {
+  ld_check(!replies_.empty());
+}
+
+void MULTI_MUTATED_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_replies = replies_.size();
+  writer.write(num_replies);
+  writer.writeVector(replies_);
+}
+
+MessageReadResult MULTI_MUTATED_Message::deserialize(ProtocolReader& reader) {
+  uint32_t num_replies = 0;
+  reader.read(&num_replies);
+  if (reader.ok() &&
+      (num_replies == 0 ||
+       num_replies > reader.bytesRemaining() / sizeof(MUTATED_Header))) {
+    ld_error("Bad MULTI_MUTATED message: %u replies in %zu bytes",
+             num_replies,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<MUTATED_Header> replies;
+  reader.readVector(&replies, num_replies);
+  return reader.result(
+      [&] { return new MULTI_MUTATED_Message(std::move(replies)); });
+}
+
+Message::Disposition MULTI_MUTATED_Message::onReceived(const Address& from) {
+  for (const MUTATED_Header& header : replies_) {
+    // Each reply may complete a Mutator, and even restart the EpochRecovery;
+    // the EpochRecovery is looked up again for every reply.
+    Disposition disp = MUTATED_Message::onReceivedCommon(header, from);
+    if (disp != Disposition::NORMAL) {
+      return disp;
+    }
+  }
+  return Disposition::NORMAL;
+}
+
+bool MULTI_MUTATED_Message::warnAboutOldProtocol() const {
+  return false;
+}
+
+}} // namespace facebook::logdevice
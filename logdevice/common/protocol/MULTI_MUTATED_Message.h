@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/MUTATED_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of MUTATED replies that a storage node sends to the same
+ *       sequencer node, usually for the mutations of a MULTI_STORE sent
+ *       during epoch recovery. See MutatedBatcher.
+ *
+ *       Each reply is processed by the recipient exactly as if it arrived in
+ *       a separate MUTATED message.
+ *
+ *       Wire format:
+ *         uint32_t num_replies
+ *         num_replies x MUTATED_Header
+ */
+
+class MULTI_MUTATED_Message : public Message {
+ public:
+  explicit MULTI_MUTATED_Message(std::vector<MUTATED_Header> replies);
+
+  MULTI_MUTATED_Message(const MULTI_MUTATED_Message&) = delete;
+  MULTI_MUTATED_Message& operator=(const MULTI_MUTATED_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_MUTATED_SUPPORT;
+  }
+
+  const std::vector<MUTATED_Header>& getReplies() const {
+    return replies_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+  static Message::deserializer_t deserialize;
+
+  // MutatedBatcher falls back to MUTATED for older sequencers.
+  bool warnAboutOldProtocol() const override;
+
+ private:
+  std::vector<MUTATED_Header> replies_;
+};
+
+}} // namespace facebook::logdevice
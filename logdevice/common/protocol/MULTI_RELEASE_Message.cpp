@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_RELEASE_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_RELEASE_Message::MULTI_RELEASE_Message(
+    std::vector<RELEASE_Header> releases)
+    : Message(MessageType::MULTI_RELEASE, TrafficClass::READ_TAIL),
+      releases_(std::move(releases)) {
+  ld_check(!releases_.empty());
+}
+
+void MULTI_RELEASE_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_releases = releases_.size();
+  writer.write(num_releases);
+  writer.writeVector(releases_);
+}
+
+MessageReadResult MULTI_RELEASE_Message::deserialize(ProtocolReader& reader) {
+  uint32_t num_releases = 0;
+  reader.read(&num_releases);
+  if (reader.ok() &&
+      (num_releases == 0 ||
+       num_releases > reader.bytesRemaining() / sizeof(RELEASE_Header))) {
+    ld_error("Bad MULTI_RELEASE message: %u releases in %zu bytes",
+             num_releases,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<RELEASE_Header> releases;
+  reader.readVector(&releases, num_releases);
+  return reader.result(
+      [&] { return new MULTI_RELEASE_Message(std::move(releases)); });
+}
+
+Message::Disposition
+MULTI_RELEASE_Message::onReceived(const Address& /*from*/) {
+  // Receipt handler lives in PurgeCoordinator::onReceived(); this should
+  // never get called.
+  std::abort();
+}
+
+void MULTI_RELEASE_Message::onSent(Status st, const Address& to) const {
+  for (const RELEASE_Header& header : releases_) {
+    RELEASE_Message::onSentCommon(header, st, to);
+  }
+}
+
+bool MULTI_RELEASE_Message::warnAboutOldProtocol() const {
+  return false;
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+MULTI_RELEASE_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("num_releases", releases_.size());
+  folly::dynamic logs = folly::dynamic::array;
+  for (const RELEASE_Header& header : releases_) {
+    logs.push_back(header.rid.logid.val_);
+  }
+  res.emplace_back("logs", std::move(logs));
+  return res;
+}
+
+}} // namespace facebook::logdevice
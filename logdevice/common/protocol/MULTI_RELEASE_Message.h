@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RELEASE_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of RELEASE messages that a sequencer node sends to the same
+ *       storage node, usually for many different logs. A sequencer node
+ *       running sequencers for many logs sends a RELEASE to every storage
+ *       shard of a log's nodeset whenever the last released LSN of the log
+ *       advances. Sequencers hand these RELEASEs to the ReleaseBatcher of
+ *       their Worker, which coalesces the ones headed to the same node within
+ *       --release-batching-window into a single MULTI_RELEASE.
+ *
+ *       Each RELEASE is processed by the recipient exactly as if it arrived
+ *       in a separate RELEASE message, but the checks that only depend on the
+ *       connection are done once per batch.
+ *
+ *       Wire format:
+ *         uint32_t num_releases
+ *         num_releases x RELEASE_Header
+ */
+
+class MULTI_RELEASE_Message : public Message {
+ public:
+  explicit MULTI_RELEASE_Message(std::vector<RELEASE_Header> releases);
+
+  MULTI_RELEASE_Message(const MULTI_RELEASE_Message&) = delete;
+  MULTI_RELEASE_Message& operator=(const MULTI_RELEASE_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_RELEASE_SUPPORT;
+  }
+
+  const std::vector<RELEASE_Header>& getReleases() const {
+    return releases_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  static Message::deserializer_t deserialize;
+
+  bool warnAboutOldProtocol() const override;
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+ private:
+  std::vector<RELEASE_Header> releases_;
+};
+
+}} // namespace facebook::logdevice
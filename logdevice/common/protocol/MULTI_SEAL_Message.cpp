@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_SEAL_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_SEAL_Message::MULTI_SEAL_Message(std::vector<SEAL_Header> seals)
+    : Message(MessageType::MULTI_SEAL, TrafficClass::RECOVERY),
+      seals_(std::move(seals)) {
+  ld_check(!seals_.empty());
+}
+
+void MULTI_SEAL_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_seals = seals_.size();
+  writer.write(num_seals);
+  writer.writeVector(seals_);
+}
+
+MessageReadResult MULTI_SEAL_Message::deserialize(ProtocolReader& reader) {
+  uint32_t num_seals = 0;
+  reader.read(&num_seals);
+  if (reader.ok() &&
+      (num_seals == 0 ||
+       num_seals > reader.bytesRemaining() / sizeof(SEAL_Header))) {
+    ld_error("Bad MULTI_SEAL message: %u seals in %zu bytes",
+             num_seals,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<SEAL_Header> seals;
+  reader.readVector(&seals, num_seals);
+  return reader.result(
+      [&] { return new MULTI_SEAL_Message(std::move(seals)); });
+}
+
+Message::Disposition MULTI_SEAL_Message::onReceived(const Address& /*from*/) {
+  // Receipt handler lives in server/SEAL_onReceived.cpp; this should never
+  // get called.
+  std::abort();
+}
+
+void MULTI_SEAL_Message::onSent(Status status, const Address& to) const {
+  for (const SEAL_Header& header : seals_) {
+    SEAL_Message::onSentCommon(header, status, to);
+  }
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+MULTI_SEAL_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("num_seals", seals_.size());
+  folly::dynamic logs = folly::dynamic::array;
+  for (const SEAL_Header& header : seals_) {
+    logs.push_back(header.log_id.val_);
+  }
+  res.emplace_back("logs", std::move(logs));
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/SEAL_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of SEAL messages that a sequencer node sends to the same
+ *       storage node. When a sequencer node takes over many logs at once
+ *       (e.g. after another node was replaced), it runs a LogRecoveryRequest
+ *       per log, each of which seals every shard of its nodeset. The
+ *       LogRecoveryRequests of a Worker hand their SEALs to SealBatcher,
+ *       which coalesces the ones headed to the same node within
+ *       --seal-batching-window into a single MULTI_SEAL.
+ *
+ *       Each SEAL is processed by the recipient exactly as if it arrived in
+ *       a separate SEAL message and is replied to with its own SEALED, but
+ *       the SEALs for the same shard are executed by a single storage task.
+ *
+ *       Wire format:
+ *         uint32_t num_seals
+ *         num_seals x SEAL_Header
+ */
+
+class MULTI_SEAL_Message : public Message {
+ public:
+  explicit MULTI_SEAL_Message(std::vector<SEAL_Header> seals);
+
+  MULTI_SEAL_Message(const MULTI_SEAL_Message&) = delete;
+  MULTI_SEAL_Message& operator=(const MULTI_SEAL_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_SEAL_SUPPORT;
+  }
+
+  const std::vector<SEAL_Header>& getSeals() const {
+    return seals_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  static Message::deserializer_t deserialize;
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+ private:
+  std::vector<SEAL_Header> seals_;
+};
+
+}} // namespace facebook::logdevice
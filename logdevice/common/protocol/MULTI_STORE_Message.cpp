@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
+
+#include <algorithm>
+
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/settings/Settings.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_STORE_Message::MULTI_STORE_Message(
+    std::vector<std::unique_ptr<STORE_Message>> stores,
+    TrafficClass tc)
+    : Message(MessageType::MULTI_STORE, tc),
+      stores_(std::move(stores)) {
+  ld_check(!stores_.empty());
+}
+
+bool MULTI_STORE_Message::cancelled() const {
+  return std::all_of(stores_.begin(), stores_.end(), [](const auto& store) {
+    return store->cancelled();
+  });
+}
+
+void MULTI_STORE_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_records = stores_.size();
+  writer.write(num_records);
+  for (const auto& store : stores_) {
+    // Measure the record first, the recipient needs to know where its payload
+    // ends.
+    ProtocolWriter size_writer(MessageType::STORE, nullptr, writer.proto());
+    store->serialize(size_writer);
+    const ssize_t size = size_writer.result();
+    if (size < 0) {
+      writer.setError(size_writer.status());
+      return;
+    }
+    const uint32_t record_size = size;
+    writer.write(record_size);
+    store->serialize(writer);
+  }
+}
+
+MessageReadResult MULTI_STORE_Message::deserialize(ProtocolReader& reader) {
+  return deserialize(reader, Worker::settings().max_payload_inline);
+}
+
+MessageReadResult MULTI_STORE_Message::deserialize(ProtocolReader& reader,
+                                                   size_t max_payload_inline) {
+  uint32_t num_records = 0;
+  reader.read(&num_records);
+  if (reader.ok() &&
+      (num_records == 0 || num_records > reader.bytesRemaining())) {
+    ld_error("Bad MULTI_STORE message: %u records in %zu bytes",
+             num_records,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<std::unique_ptr<STORE_Message>> stores;
+  for (uint32_t i = 0; i < num_records && reader.ok(); ++i) {
+    uint32_t record_size = 0;
+    reader.read(&record_size);
+    if (reader.ok() && record_size > reader.bytesRemaining()) {
+      ld_error("Bad MULTI_STORE message: record %u of %u has %u bytes, only "
+               "%zu bytes left",
+               i,
+               num_records,
+               record_size,
+               reader.bytesRemaining());
+      return reader.errorResult(E::BADMSG);
+    }
+    auto store = STORE_Message::deserializeRecord(
+        reader, max_payload_inline, record_size);
+    if (store) {
+      stores.push_back(std::move(store));
+    }
+  }
+
+  return reader.result(
+      [&] { return new MULTI_STORE_Message(std::move(stores)); });
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+MULTI_STORE_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("num_records", stores_.size());
+  folly::dynamic records = folly::dynamic::array;
+  for (const auto& store : stores_) {
+    records.push_back(store->getHeader().rid.toString());
+  }
+  res.emplace_back("records", std::move(records));
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of STORE messages that a sequencer node sends to the same
+ *       storage node. Appenders of a Worker hand their STOREs to
+ *       StoreBatcher, which coalesces the ones headed to the same node within
+ *       --store-batching-window into a single MULTI_STORE. This saves a
+ *       message header, a socket write and an event loop iteration per
+ *       record on both sides, and lets the storage node put the whole batch on
+ *       its write queue at once, so that a single WriteBatchStorageTask
+ *       usually writes all of it.
+ *
+ *       Each record is a complete STORE (with its own header, copyset and
+ *       payload), and is processed by the recipient exactly as if it arrived
+ *       in a separate STORE message: it's checked, forwarded along its chain
+ *       and replied to with its own STORED.
+ *
+ *       Wire format:
+ *         uint32_t num_records
+ *         num_records x (uint32_t record_size, STORE of record_size bytes)
+ */
+
+class MULTI_STORE_Message : public Message {
+ public:
+  /**
+   * @param tc  traffic class of the records: APPEND for StoreBatcher,
+   *            RECOVERY for MutationStoreBatch
+   */
+  explicit MULTI_STORE_Message(
+      std::vector<std::unique_ptr<STORE_Message>> stores,
+      TrafficClass tc = TrafficClass::APPEND);
+
+  MULTI_STORE_Message(const MULTI_STORE_Message&) = delete;
+  MULTI_STORE_Message& operator=(const MULTI_STORE_Message&) = delete;
+
+  // MULTI_STOREs carry appends and mutations, same as
+  // STORE_Message::getExecutorPriority() for non-rebuilding stores.
+  int8_t getExecutorPriority() const override {
+    return folly::Executor::HI_PRI;
+  }
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_STORE_SUPPORT;
+  }
+
+  // Cancelled if all of the records are cancelled.
+  bool cancelled() const override;
+  void serialize(ProtocolWriter& writer) const override;
+
+  void onSent(Status, const Address& /* to */) const override {
+    // Handler lives in ServerMessageDispatch (server) or
+    // ClientMessageDispatch (client), which call the STORE handlers for each
+    // record. This should never get called.
+    std::abort();
+  }
+  Disposition onReceived(const Address&) override {
+    // Receipt handler lives in StoreStateMachine::onReceived(); this should
+    // never get called.
+    std::abort();
+  }
+  static Message::deserializer_t deserialize;
+  // Overload of deserialize that does not need to run on a Worker thread.
+  static MessageReadResult deserialize(ProtocolReader&,
+                                       size_t max_payload_inline);
+
+  std::vector<std::unique_ptr<STORE_Message>>& getStores() {
+    return stores_;
+  }
+  const std::vector<std::unique_ptr<STORE_Message>>& getStores() const {
+    return stores_;
+  }
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+ private:
+  std::vector<std::unique_ptr<STORE_Message>> stores_;
+};
+
+}} // namespace facebook::logdevice
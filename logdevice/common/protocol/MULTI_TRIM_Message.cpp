@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MULTI_TRIM_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+MULTI_TRIM_Message::MULTI_TRIM_Message(std::vector<TRIM_Header> trims)
+    : Message(MessageType::MULTI_TRIM, TrafficClass::TRIM),
+      trims_(std::move(trims)) {
+  ld_check(!trims_.empty());
+}
+
+void MULTI_TRIM_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_trims = trims_.size();
+  writer.write(num_trims);
+  writer.writeVector(trims_);
+}
+
+MessageReadResult MULTI_TRIM_Message::deserialize(ProtocolReader& reader) {
+  uint32_t num_trims = 0;
+  reader.read(&num_trims);
+  if (reader.ok() &&
+      (num_trims == 0 ||
+       num_trims > reader.bytesRemaining() / sizeof(TRIM_Header))) {
+    ld_error("Bad MULTI_TRIM message: %u trims in %zu bytes",
+             num_trims,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<TRIM_Header> trims;
+  reader.readVector(&trims, num_trims);
+  return reader.result(
+      [&] { return new MULTI_TRIM_Message(std::move(trims)); });
+}
+
+Message::Disposition MULTI_TRIM_Message::onReceived(const Address& /*from*/) {
+  // Receipt handler lives in server/TRIM_onReceived.cpp; this should never
+  // get called.
+  std::abort();
+}
+
+void MULTI_TRIM_Message::onSent(Status st, const Address& to) const {
+  for (const TRIM_Header& header : trims_) {
+    TRIM_Message::onSentCommon(header, st, to);
+  }
+}
+
+bool MULTI_TRIM_Message::warnAboutOldProtocol() const {
+  return false;
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+MULTI_TRIM_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("num_trims", trims_.size());
+  folly::dynamic logs = folly::dynamic::array;
+  for (const TRIM_Header& header : trims_) {
+    logs.push_back(header.log_id.val_);
+  }
+  res.emplace_back("logs", std::move(logs));
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/TRIM_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of TRIM messages that a client sends to the same storage
+ *       node, for different logs. Client::trimBatch() starts a TrimRequest
+ *       per log, all on the same Worker, and those hand their TRIMs to the
+ *       TrimBatcher of the Worker, which coalesces the ones headed to the
+ *       same node within --trim-batching-window into a single MULTI_TRIM.
+ *
+ *       The recipient checks permissions and validates each TRIM exactly as
+ *       if it arrived in a separate TRIM message, writes the trim points of
+ *       each shard with a single storage task, and replies to each TRIM with
+ *       its own TRIMMED.
+ *
+ *       Wire format:
+ *         uint32_t num_trims
+ *         num_trims x TRIM_Header
+ */
+
+class MULTI_TRIM_Message : public Message {
+ public:
+  explicit MULTI_TRIM_Message(std::vector<TRIM_Header> trims);
+
+  MULTI_TRIM_Message(const MULTI_TRIM_Message&) = delete;
+  MULTI_TRIM_Message& operator=(const MULTI_TRIM_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::MULTI_TRIM_SUPPORT;
+  }
+
+  const std::vector<TRIM_Header>& getTrims() const {
+    return trims_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  void onSent(Status st, const Address& to) const override;
+  Disposition onReceived(const Address&) override;
+  static Message::deserializer_t deserialize;
+
+  bool warnAboutOldProtocol() const override;
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+ private:
+  std::vector<TRIM_Header> trims_;
+};
+
+}} // namespace facebook::logdevice
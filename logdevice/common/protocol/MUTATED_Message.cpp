@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "logdevice/common/EpochRecovery.h"
+#include "logdevice/common/MutatedBatcher.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
@@ -22,12 +23,18 @@ MUTATED_Message::MUTATED_Message(const MUTATED_Header& header)
     : Message(MessageType::MUTATED, TrafficClass::RECOVERY), header_(header) {}
 
 Message::Disposition MUTATED_Message::onReceived(const Address& from) {
+  return onReceivedCommon(header_, from);
+}
+
+Message::Disposition
+MUTATED_Message::onReceivedCommon(const MUTATED_Header& header,
+                                  const Address& from) {
   if (from.isClientAddress()) {
     RATELIMIT_ERROR(std::chrono::seconds(10),
                     10,
                     "PROTOCOL ERROR: got a MUTATED message for %s from client "
                     "%s. MUTATED can only arrive from servers.",
-                    header_.rid.toString().c_str(),
+                    header.rid.toString().c_str(),
                     Sender::describeConnection(from).c_str());
     err = E::PROTO;
     return Disposition::ERROR;
@@ -35,34 +42,34 @@ Message::Disposition MUTATED_Message::onReceived(const Address& from) {
 
   Worker* w = Worker::onThisThread();
 
-  ld_check(header_.shard != -1);
-  ShardID shard(from.id_.node_.index(), header_.shard);
+  ld_check(header.shard != -1);
+  ShardID shard(from.id_.node_.index(), header.shard);
 
   // If the mutation was initiated by something other than EpochRecovery,
   // route the response to the callback.
-  auto it = w->customMutationCallbacks_.find(header_.recovery_id);
+  auto it = w->customMutationCallbacks_.find(header.recovery_id);
   if (it != w->customMutationCallbacks_.end()) {
     auto cb = it->second;
-    cb(header_, shard);
+    cb(header, shard);
     return Disposition::NORMAL;
   }
 
-  EpochRecovery* recovery = w->findActiveEpochRecovery(header_.rid.logid);
+  EpochRecovery* recovery = w->findActiveEpochRecovery(header.rid.logid);
 
-  if (!recovery || recovery->id_ != header_.recovery_id) {
+  if (!recovery || recovery->id_ != header.recovery_id) {
     RATELIMIT_INFO(std::chrono::seconds(10),
                    10,
                    "Got a MUTATED message for record %s (recovery id %lu) "
                    "from %s, but no EpochRecovery machine with the given id "
                    "is active. Probably from a previous mutation attempt. "
                    "Ignoring.",
-                   header_.rid.toString().c_str(),
-                   header_.recovery_id.val_,
+                   header.rid.toString().c_str(),
+                   header.recovery_id.val_,
                    shard.toString().c_str());
     return Disposition::NORMAL;
   }
 
-  recovery->onMutated(shard, header_);
+  recovery->onMutated(shard, header);
   return Disposition::NORMAL;
 }
 
@@ -86,6 +93,12 @@ void MUTATED_Message::createAndSend(const MUTATED_Header& header, ClientID to) {
   // Mutations are always sent directly (i.e. not through chains), so replies
   // are sent by workers which received the STORE.
 
+  if (Worker::onThisThread()->mutatedBatcher().add(header, to)) {
+    // Will be sent shortly, together with other MUTATED replies to the same
+    // sequencer node.
+    return;
+  }
+
   auto msg = std::make_unique<MUTATED_Message>(header);
   int rv = Worker::onThisThread()->sender().sendMessage(std::move(msg), to);
   if (rv != 0) {
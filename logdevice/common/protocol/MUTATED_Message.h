@@ -73,6 +73,13 @@ class MUTATED_Message : public Message {
    */
   static void createAndSend(const MUTATED_Header& header, ClientID send_to);
 
+  /**
+   * Routes a MUTATED reply to the Mutator it's for. Shared with
+   * MULTI_MUTATED_Message.
+   */
+  static Disposition onReceivedCommon(const MUTATED_Header& header,
+                                      const Address& from);
+
   MUTATED_Header header_;
 };
 
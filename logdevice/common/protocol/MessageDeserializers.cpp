@@ -12,12 +12,15 @@
 #include "logdevice/common/protocol/APPEND_Message.h"
 #include "logdevice/common/protocol/APPEND_PROBE_Message.h"
 #include "logdevice/common/protocol/APPEND_PROBE_REPLY_Message.h"
+#include "logdevice/common/protocol/CHECKSUM_FAIL_Message.h"
 #include "logdevice/common/protocol/CHECK_NODE_HEALTH_Message.h"
 #include "logdevice/common/protocol/CHECK_NODE_HEALTH_REPLY_Message.h"
 #include "logdevice/common/protocol/CHECK_SEAL_Message.h"
 #include "logdevice/common/protocol/CHECK_SEAL_REPLY_Message.h"
 #include "logdevice/common/protocol/CLEANED_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
+#include "logdevice/common/protocol/CLUSTER_STATE_SUBSCRIBE_Message.h"
+#include "logdevice/common/protocol/COMPRESSED_FRAME_Message.h"
 #include "logdevice/common/protocol/CONFIG_ADVISORY_Message.h"
 #include "logdevice/common/protocol/CONFIG_CHANGED_Message.h"
 #include "logdevice/common/protocol/CONFIG_FETCH_Message.h"
@@ -48,11 +51,20 @@
 #include "logdevice/common/protocol/LOGS_CONFIG_API_Message.h"
 #include "logdevice/common/protocol/LOGS_CONFIG_API_REPLY_Message.h"
 #include "logdevice/common/protocol/MEMTABLE_FLUSHED_Message.h"
+#include "logdevice/common/protocol/MULTI_DATA_SIZE_Message.h"
+#include "logdevice/common/protocol/MULTI_GET_SEQ_STATE_Message.h"
+#include "logdevice/common/protocol/MULTI_IS_LOG_EMPTY_Message.h"
+#include "logdevice/common/protocol/MULTI_MUTATED_Message.h"
+#include "logdevice/common/protocol/MULTI_RELEASE_Message.h"
+#include "logdevice/common/protocol/MULTI_SEAL_Message.h"
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
+#include "logdevice/common/protocol/MULTI_TRIM_Message.h"
 #include "logdevice/common/protocol/MUTATED_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_AGGREGATE_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_AGGREGATE_REPLY_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_REPLY_Message.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/SEALED_Message.h"
@@ -67,6 +79,7 @@
 #include "logdevice/common/protocol/TEST_Message.h"
 #include "logdevice/common/protocol/TRIMMED_Message.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
+#include "logdevice/common/protocol/TRIM_POINT_UPDATE_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
 
 namespace facebook { namespace logdevice {
@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/protocol/ProtocolReader.h"
 
+#include <folly/small_vector.h>
+
 #include "event2/buffer.h"
 #include "logdevice/common/Checksum.h"
 #include "logdevice/common/debug.h"
@@ -73,12 +75,28 @@ class EvbufferSource : public ProtocolReader::Source {
     ld_check(msg_len <= len);
 
     len = std::min(len, msg_len);
-    std::string data(len, 0);
-    ev_ssize_t nbytes = LD_EV(evbuffer_copyout)(src_, &data[0], len);
-    ld_check(nbytes == len);
+    if (len == 0) {
+      return checksum_64bit(Slice("", 0));
+    }
 
-    Slice slice(&data[0], len);
-    checksum_bytes(slice, 64, (char*)&checksum);
+    // Hash the first `len` bytes of the evbuffer chains in place instead of
+    // copying them out.
+    const int nchains = LD_EV(evbuffer_peek)(src_, len, nullptr, nullptr, 0);
+    ld_check(nchains > 0);
+    folly::small_vector<evbuffer_iovec, 8> iov(nchains);
+    const int n =
+        LD_EV(evbuffer_peek)(src_, len, nullptr, iov.data(), nchains);
+    ld_check(n == nchains);
+    folly::small_vector<Slice, 8> slices;
+    slices.reserve(n);
+    size_t remaining = len;
+    for (int i = 0; i < n && remaining > 0; ++i) {
+      const size_t chunk = std::min(remaining, (size_t)iov[i].iov_len);
+      slices.emplace_back(iov[i].iov_base, chunk);
+      remaining -= chunk;
+    }
+    ld_check(remaining == 0);
+    checksum = checksum_64bit(slices.data(), slices.size());
     return checksum;
   }
 
@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/protocol/ProtocolWriter.h"
 
+#include <folly/small_vector.h>
+
 #include "event2/buffer.h"
 #include "event2/event.h"
 #include "logdevice/common/Checksum.h"
@@ -63,12 +65,23 @@ class EvbufferDestination : public ProtocolWriter::Destination {
     uint64_t checksum = 0;
     ld_check(dest_evbuf_);
 
-    const size_t len = LD_EV(evbuffer_get_length)(dest_evbuf_);
-    std::string data(len, 0);
-    ev_ssize_t nbytes = LD_EV(evbuffer_copyout)(dest_evbuf_, &data[0], len);
-    ld_check(nbytes == len);
-    Slice slice(&data[0], nbytes);
-    checksum_bytes(slice, 64, (char*)&checksum);
+    // Hash the evbuffer chains in place instead of linearizing them into a
+    // temporary copy.
+    const int nchains =
+        LD_EV(evbuffer_peek)(dest_evbuf_, -1, nullptr, nullptr, 0);
+    if (nchains <= 0) {
+      return checksum_64bit(Slice("", 0));
+    }
+    folly::small_vector<evbuffer_iovec, 8> iov(nchains);
+    const int n = LD_EV(evbuffer_peek)(
+        dest_evbuf_, -1, nullptr, iov.data(), nchains);
+    ld_check(n == nchains);
+    folly::small_vector<Slice, 8> slices;
+    slices.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      slices.emplace_back(iov[i].iov_base, iov[i].iov_len);
+    }
+    checksum = checksum_64bit(slices.data(), slices.size());
 
     return checksum;
   }
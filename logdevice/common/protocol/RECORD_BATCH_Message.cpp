@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
+
+#include <folly/Varint.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+void putVarint(uint64_t val, std::string* out) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  size_t len = folly::encodeVarint(val, buf);
+  out->append(reinterpret_cast<const char*>(buf), len);
+}
+
+} // namespace
+
+RECORD_BATCH_Message::RECORD_BATCH_Message(
+    std::vector<std::unique_ptr<RECORD_Message>> records,
+    TrafficClass tc)
+    : Message(MessageType::RECORD_BATCH, tc), records_(std::move(records)) {
+  ld_check(!records_.empty());
+  const RECORD_Header& first = records_.front()->header_;
+  header_ = RECORD_BATCH_Header{first.log_id,
+                                first.read_stream_id,
+                                first.shard,
+                                static_cast<uint32_t>(records_.size())};
+}
+
+bool RECORD_BATCH_Message::canBatch(const RECORD_Message& record) {
+  return !record.extra_metadata_ && !record.offsets_.isValid() &&
+      !(record.header_.flags &
+        (RECORD_Header::INCLUDES_EXTRA_METADATA | RECORD_Header::DIGEST |
+         RECORD_Header::INCLUDE_BYTE_OFFSET |
+         RECORD_Header::INCLUDE_OFFSET_WITHIN_EPOCH));
+}
+
+void RECORD_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+
+  std::string headers;
+  headers.reserve(records_.size() * 8);
+  lsn_t prev_lsn = LSN_INVALID;
+  int64_t prev_ts = 0;
+  for (const auto& record : records_) {
+    const RECORD_Header& h = record->header_;
+    ld_check(h.log_id == header_.log_id);
+    ld_check(h.read_stream_id == header_.read_stream_id);
+    ld_check(h.lsn > prev_lsn);
+    ld_check(canBatch(*record));
+    putVarint(h.lsn - prev_lsn, &headers);
+    putVarint(folly::encodeZigZag(int64_t(h.timestamp) - prev_ts), &headers);
+    putVarint(h.flags, &headers);
+    putVarint(record->payload_.size(), &headers);
+    prev_lsn = h.lsn;
+    prev_ts = h.timestamp;
+  }
+  writer.writeLengthPrefixedVector(headers);
+
+  for (const auto& record : records_) {
+    const Payload& payload = record->payload_;
+    if (payload.size() <= MAX_COPY_TO_EVBUFFER_PAYLOAD_SIZE) {
+      writer.write(payload.data(), payload.size());
+    } else {
+      writer.writeWithoutCopy(payload.data(), payload.size());
+    }
+  }
+}
+
+MessageReadResult RECORD_BATCH_Message::deserialize(ProtocolReader& reader) {
+  RECORD_BATCH_Header header;
+  reader.read(&header);
+  std::string headers;
+  reader.readLengthPrefixedVector(&headers);
+  if (reader.ok() &&
+      (header.num_records == 0 || header.num_records > headers.size())) {
+    ld_error("Bad RECORD_BATCH message: %u records in %zu bytes of headers",
+             header.num_records,
+             headers.size());
+    return reader.errorResult(E::BADMSG);
+  }
+  if (!reader.ok()) {
+    return reader.errorResult();
+  }
+
+  struct EncodedRecord {
+    RECORD_Header header;
+    size_t size;
+  };
+  std::vector<EncodedRecord> encoded;
+  encoded.reserve(header.num_records);
+  folly::ByteRange range(
+      reinterpret_cast<const uint8_t*>(headers.data()), headers.size());
+  lsn_t lsn = LSN_INVALID;
+  int64_t ts = 0;
+  try {
+    for (uint32_t i = 0; i < header.num_records; ++i) {
+      lsn += folly::decodeVarint(range);
+      ts += folly::decodeZigZag(folly::decodeVarint(range));
+      const uint64_t flags = folly::decodeVarint(range);
+      const uint64_t size = folly::decodeVarint(range);
+      encoded.push_back(EncodedRecord{RECORD_Header{header.log_id,
+                                                    header.read_stream_id,
+                                                    lsn,
+                                                    static_cast<uint64_t>(ts),
+                                                    RECORD_flags_t(flags),
+                                                    header.shard},
+                                      size});
+    }
+  } catch (...) {
+    // Truncated or invalid varint.
+    range.clear();
+  }
+  if (encoded.size() != header.num_records || !range.empty()) {
+    ld_error("Bad RECORD_BATCH message: malformed record headers");
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<std::unique_ptr<RECORD_Message>> records;
+  records.reserve(encoded.size());
+  for (const EncodedRecord& e : encoded) {
+    if (e.size > reader.bytesRemaining()) {
+      ld_error("Bad RECORD_BATCH message: record %s has %zu bytes, only %zu "
+               "bytes left",
+               lsn_to_string(e.header.lsn).c_str(),
+               e.size,
+               reader.bytesRemaining());
+      return reader.errorResult(E::BADMSG);
+    }
+    records.push_back(RECORD_Message::deserializePayload(
+        reader, e.header, TrafficClass::READ_BACKLOG, e.size));
+    if (!reader.ok()) {
+      break;
+    }
+  }
+
+  return reader.result([&] {
+    return new RECORD_BATCH_Message(
+        std::move(records), TrafficClass::READ_BACKLOG);
+  });
+}
+
+Message::Disposition RECORD_BATCH_Message::onReceived(const Address& from) {
+  for (auto& record : records_) {
+    Disposition disposition = record->onReceived(from);
+    if (disposition != Disposition::NORMAL) {
+      return disposition;
+    }
+  }
+  return Disposition::NORMAL;
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+RECORD_BATCH_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  res.emplace_back("log_id", toString(header_.log_id));
+  res.emplace_back("shard", header_.shard);
+  res.emplace_back("read_stream_id", header_.read_stream_id.val());
+  res.emplace_back("num_records", header_.num_records);
+  res.emplace_back("first_lsn", lsn_to_string(records_.front()->header_.lsn));
+  res.emplace_back("last_lsn", lsn_to_string(records_.back()->header_.lsn));
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RECORD_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A batch of records of one read stream, sent by a storage node while
+ *       the stream is catching up, see --record-batch-max-bytes. A RECORD
+ *       header takes about 40 bytes, which is a lot of framing for small
+ *       records. In a batch, the log, read stream and shard are sent once and
+ *       each record gets a few bytes of varints instead of a RECORD_Header.
+ *
+ *       Only records without extra metadata and byte offsets can be batched.
+ *       Each record keeps the checksum it was stored with, and is processed by
+ *       the reader exactly as if it arrived in a separate RECORD message.
+ *
+ *       Wire format:
+ *         RECORD_BATCH_Header
+ *         length-prefixed blob with these unsigned varints for each record:
+ *           - lsn minus the previous record's lsn (or 0);
+ *           - zigzagged timestamp minus the previous record's timestamp
+ *             (or 0);
+ *           - RECORD_Header flags;
+ *           - size of the checksum and payload.
+ *         checksums and payloads of all records, back to back
+ */
+
+struct RECORD_BATCH_Header {
+  logid_t log_id;
+  read_stream_id_t read_stream_id;
+  shard_index_t shard;
+  uint32_t num_records;
+} __attribute__((__packed__));
+
+class RECORD_BATCH_Message : public Message {
+ public:
+  // `records` must be non-empty, belong to the same read stream, be in
+  // increasing LSN order and satisfy canBatch().
+  RECORD_BATCH_Message(std::vector<std::unique_ptr<RECORD_Message>> records,
+                       TrafficClass tc);
+
+  RECORD_BATCH_Message(const RECORD_BATCH_Message&) = delete;
+  RECORD_BATCH_Message& operator=(const RECORD_BATCH_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::RECORD_BATCH_SUPPORT;
+  }
+
+  void serialize(ProtocolWriter& writer) const override;
+  Disposition onReceived(const Address& from) override;
+  static Message::deserializer_t deserialize;
+  // onSent() handler lives in server/RECORD_onSent.cpp
+
+  /**
+   * @return  true if the record can be sent in a RECORD_BATCH, i.e. it has
+   *          no extra metadata and no byte offsets, and is not a digest
+   *          record.
+   */
+  static bool canBatch(const RECORD_Message& record);
+
+  const std::vector<std::unique_ptr<RECORD_Message>>& getRecords() const {
+    return records_;
+  }
+
+  virtual std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+  RECORD_BATCH_Header header_;
+
+ private:
+  std::vector<std::unique_ptr<RECORD_Message>> records_;
+};
+
+}} // namespace facebook::logdevice
@@ -52,7 +52,11 @@ RECORD_Message::RECORD_Message(const RECORD_Header& header,
       log_group_path_(std::move(log_group_path)) {}
 
 RECORD_Message::~RECORD_Message() {
-  free(const_cast<void*>(payload_.data()));
+  if (payload_owner_) {
+    return;
+  }
+  free(payload_buffer_ ? payload_buffer_
+                       : const_cast<void*>(payload_.data()));
 }
 
 void RECORD_Message::serialize(ProtocolWriter& writer) const {
@@ -111,6 +115,21 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
     tc = TrafficClass::REBUILD;
   }
 
+  auto m = deserializePayload(
+      reader, header, tc, reader.ok() ? reader.bytesRemaining() : 0);
+
+  return reader.result([&] {
+    m->extra_metadata_ = std::move(extra_metadata);
+    m->offsets_ = std::move(offsets);
+    return std::move(m);
+  });
+}
+
+std::unique_ptr<RECORD_Message>
+RECORD_Message::deserializePayload(ProtocolReader& reader,
+                                   const RECORD_Header& header,
+                                   TrafficClass tc,
+                                   size_t size) {
   // If flags indicate that the payload includes a checksum, strip it now.
   // The payload size reported to the client will be just the actual client
   // payload.
@@ -130,14 +149,14 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
       checksum_size = sizeof u.c32;
     }
 
-    if (reader.bytesRemaining() < checksum_size) {
+    if (size < checksum_size) {
       RATELIMIT_ERROR(
           std::chrono::seconds(10),
           10,
           "Malformed RECORD message: ran out of bytes while reading "
           "checksum (expected %zu, got %zu); log: %lu lsn: %s rsid: %lu",
           checksum_size,
-          reader.bytesRemaining(),
+          size,
           header.log_id.val_,
           lsn_to_string(header.lsn).c_str(),
           header.read_stream_id.val_);
@@ -147,12 +166,13 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
       expected_checksum = 0x5000b4df00f00f00ul;
     } else {
       reader.read(ptr, checksum_size);
+      size -= checksum_size;
       expected_checksum =
           (header.flags & RECORD_Header::CHECKSUM_64BIT) ? u.c64 : u.c32;
     }
   }
 
-  size_t payload_size = reader.ok() ? reader.bytesRemaining() : 0;
+  size_t payload_size = reader.ok() ? size : 0;
   ld_check(payload_size < Message::MAX_LEN);
 
   void* payload = nullptr;
@@ -164,13 +184,10 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
     reader.read(payload, payload_size);
   }
 
-  return reader.result([&] {
-    auto m = std::make_unique<RECORD_Message>(
-        header, tc, Payload(payload, payload_size), std::move(extra_metadata));
-    m->expected_checksum_ = expected_checksum;
-    m->offsets_ = std::move(offsets);
-    return m;
-  });
+  auto m = std::make_unique<RECORD_Message>(
+      header, tc, Payload(payload, payload_size), nullptr);
+  m->expected_checksum_ = expected_checksum;
+  return m;
 }
 
 std::string RECORD_Message::identify() const {
@@ -13,6 +13,7 @@
 
 #include "logdevice/common/CopySet.h"
 #include "logdevice/common/OffsetMap.h"
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Record.h"
@@ -119,7 +120,9 @@ struct ExtraMetadata {
   OffsetMap offsets_within_epoch;
 };
 
-class RECORD_Message : public Message, boost::noncopyable {
+class RECORD_Message : public Message,
+                       public ThreadCachedAllocation<RECORD_Message>,
+                       boost::noncopyable {
  public:
   // identifies the origin of the record
   enum class Source { LOCAL_LOG_STORE, CACHED_DIGEST, UNKNOWN };
@@ -164,6 +167,17 @@ class RECORD_Message : public Message, boost::noncopyable {
   static Message::deserializer_t deserialize;
   // onSent() handler lives in server/RECORD_onSent.cpp
 
+  /**
+   * Reads the checksum, if header.flags say there is one, and the payload
+   * of a record, which together take the next `size` bytes of `reader`.
+   * Used by deserialize() and for the records of a RECORD_BATCH message.
+   */
+  static std::unique_ptr<RECORD_Message>
+  deserializePayload(ProtocolReader& reader,
+                     const RECORD_Header& header,
+                     TrafficClass tc,
+                     size_t size);
+
   /**
    * @return a human-readable string with the record's log id, epoch, and ESN
    *         for use in error messages
@@ -172,6 +186,32 @@ class RECORD_Message : public Message, boost::noncopyable {
 
   ~RECORD_Message() override;
 
+  /**
+   * Tells the message that payload_ points somewhere inside `buffer', a
+   * malloc'd allocation which the message now owns. The destructor will free
+   * `buffer' instead of payload_.data(). Lets the read path hand over the
+   * buffer a record was read into instead of copying the payload out.
+   */
+  void setPayloadBuffer(void* buffer) {
+    ld_check(buffer);
+    ld_check(!payload_buffer_);
+    ld_check(!payload_owner_);
+    payload_buffer_ = buffer;
+  }
+
+  /**
+   * Tells the message that payload_ points into memory kept alive by `owner',
+   * e.g. a copy of the payload that RECORD messages of other read streams
+   * reference too. The message doesn't free payload_, it holds a reference to
+   * `owner' until it's destroyed.
+   */
+  void setPayloadOwner(std::shared_ptr<const void> owner) {
+    ld_check(owner);
+    ld_check(!payload_buffer_);
+    ld_check(!payload_owner_);
+    payload_owner_ = std::move(owner);
+  }
+
   /**
    * Pretty-prints flags.
    */
@@ -192,6 +232,13 @@ class RECORD_Message : public Message, boost::noncopyable {
   //   memory will get freed later when it is no longer needed.
   Payload payload_;
 
+  // If set, the allocation payload_ points into. See setPayloadBuffer().
+  void* payload_buffer_ = nullptr;
+
+  // If set, keeps the memory payload_ points into alive. See
+  // setPayloadOwner().
+  std::shared_ptr<const void> payload_owner_;
+
   // If non-null:
   // - On the send path, the structure will be embedded in the RECORD
   //   message
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "logdevice/common/RecordID.h"
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/FixedSizeMessage.h"
 
@@ -41,7 +42,8 @@ struct RELEASE_Header {
   }
 } __attribute__((__packed__));
 
-class RELEASE_Message : public Message {
+class RELEASE_Message : public Message,
+                        public ThreadCachedAllocation<RELEASE_Message> {
  public:
   explicit RELEASE_Message(const RELEASE_Header& header);
 
@@ -59,6 +61,14 @@ class RELEASE_Message : public Message {
   }
 
   void onSent(Status st, const Address& to) const override;
+
+  // Reports the outcome of sending the RELEASE described by `header' to `to'
+  // to the Sequencer of the log. Also used for RELEASEs batched in a
+  // MULTI_RELEASE.
+  static void onSentCommon(const RELEASE_Header& header,
+                           Status st,
+                           const Address& to);
+
   static Message::deserializer_t deserialize;
 
   bool warnAboutOldProtocol() const override;
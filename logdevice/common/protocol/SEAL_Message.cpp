@@ -34,15 +34,21 @@ Message::Disposition SEAL_Message::onReceived(const Address& /*from*/) {
 }
 
 void SEAL_Message::onSent(Status status, const Address& to) const {
+  onSentCommon(header_, status, to);
+}
+
+void SEAL_Message::onSentCommon(const SEAL_Header& header,
+                                Status status,
+                                const Address& to) {
   auto& rqmap = Worker::onThisThread()->runningLogRecoveries().map;
-  auto it = rqmap.find(header_.log_id);
+  auto it = rqmap.find(header.log_id);
   if (it == rqmap.end()) {
     return;
   }
 
-  ld_check(header_.shard != -1);
+  ld_check(header.shard != -1);
   it->second->onSealMessageSent(
-      ShardID(to.id_.node_.index(), header_.shard), header_.seal_epoch, status);
+      ShardID(to.id_.node_.index(), header.shard), header.seal_epoch, status);
 }
 
 }} // namespace facebook::logdevice
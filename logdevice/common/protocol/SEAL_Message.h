@@ -55,6 +55,14 @@ class SEAL_Message : public Message {
   void serialize(ProtocolWriter&) const override;
   void onSent(Status st, const Address& to) const override;
   Disposition onReceived(const Address&) override;
+
+  // Reports the outcome of sending the SEAL described by `header' to `to' to
+  // the LogRecoveryRequest that sent it. Also used for SEALs batched in a
+  // MULTI_SEAL.
+  static void onSentCommon(const SEAL_Header& header,
+                           Status st,
+                           const Address& to);
+
   static Message::deserializer_t deserialize;
 
   SEAL_Header header_;
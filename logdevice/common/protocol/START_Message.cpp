@@ -93,6 +93,13 @@ void START_Message::serialize(ProtocolWriter& writer) const {
     }
     hdr.num_filtered_out = filtered_out_.size();
   }
+  if (writer.proto() < Compatibility::SCD_LSN_BLOCK_ROTATION_SUPPORT &&
+      hdr.scd_copyset_reordering ==
+          SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION) {
+    // Older servers would reject the START message. Fall back to the closest
+    // reordering they know of.
+    hdr.scd_copyset_reordering = SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED;
+  }
 
   writer.write(hdr);
 
@@ -108,7 +115,9 @@ void START_Message::serialize(ProtocolWriter& writer) const {
 
   if (writer.proto() >= Compatibility::SERVER_CAN_PROCESS_CSID) {
     if (hdr.scd_copyset_reordering ==
-        SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED) {
+            SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED ||
+        hdr.scd_copyset_reordering ==
+            SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION) {
       // Randomly generated seeds for SpookyHash
       // same as in LocalLogStoreReadFilter::applyCopysetReordering
       uint64_t h1 = 0x59d2d101d78f02ad, h2 = 0x430bfb34b1cd41e1;
@@ -118,6 +127,12 @@ void START_Message::serialize(ProtocolWriter& writer) const {
           client_session_id_.length() * sizeof(char),
           &h1,
           &h2);
+      if (hdr.scd_copyset_reordering ==
+          SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION) {
+        // The seed is specific to the read stream.
+        folly::hash::SpookyHashV2::Hash128(
+            &hdr.read_stream_id, sizeof(hdr.read_stream_id), &h1, &h2);
+      }
       writer.write(h1);
       writer.write(h2);
     }
@@ -167,7 +182,9 @@ MessageReadResult START_Message::deserialize(ProtocolReader& reader) {
 
     if (proto >= Compatibility::SERVER_CAN_PROCESS_CSID) {
       if (m->header_.scd_copyset_reordering ==
-          SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED) {
+              SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED ||
+          m->header_.scd_copyset_reordering ==
+              SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION) {
         reader.read(&m->csid_hash_pt1, sizeof(m->csid_hash_pt1));
         reader.read(&m->csid_hash_pt2, sizeof(m->csid_hash_pt2));
       }
@@ -13,6 +13,7 @@
 #include "logdevice/common/NodeID.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/ShardID.h"
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/include/Err.h"
@@ -84,8 +85,10 @@ struct STORED_Header {
 
   // the write was part of a batch that was synced
   static const STORED_flags_t SYNCED = 1ul << 0; //=1
-  // worker's storage task queue is overloaded
+  // worker's storage task queue is overloaded, or the local log store is
+  // pacing or throttling writes
   // @see PerWorkerStorageTaskQueue::isOverloaded()
+  // @see LocalLogStore::getWriteThrottleState()
   static const STORED_flags_t OVERLOADED = 1ul << 1; //=2
   // This flag is ignored. It used to tell whether this record can be amended
   // later. Now everything is amendable.
@@ -99,7 +102,8 @@ struct STORED_Header {
   static const STORED_flags_t LOW_WATERMARK_NOSPC = 1ul << 5; //=32
 } __attribute__((__packed__));
 
-class STORED_Message : public Message {
+class STORED_Message : public Message,
+                       public ThreadCachedAllocation<STORED_Message> {
  public:
   static TrafficClass calcTrafficClass(const STORED_Header& header) {
     return (header.flags & STORED_Header::REBUILDING) ? TrafficClass::REBUILD
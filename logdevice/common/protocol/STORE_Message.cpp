@@ -224,7 +224,10 @@ void STORE_Message::serialize(ProtocolWriter& writer) const {
   }
 
   if (payload_ && !(header_.flags & STORE_Header::AMEND)) {
-    payload_->serialize(writer);
+    // payload_ is shared with the Appender and the other STOREs of the wave
+    // and lives at least as long as this message, which is destroyed only
+    // once the evbuffer is drained.
+    payload_->serializeWithoutCopy(writer);
   }
 }
 
@@ -234,7 +237,17 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader) {
 
 MessageReadResult STORE_Message::deserialize(ProtocolReader& reader,
                                              size_t max_payload_inline) {
+  std::unique_ptr<STORE_Message> m =
+      deserializeRecord(reader, max_payload_inline, reader.bytesRemaining());
+  return reader.result([&] { return std::move(m); });
+}
+
+std::unique_ptr<STORE_Message>
+STORE_Message::deserializeRecord(ProtocolReader& reader,
+                                 size_t max_payload_inline,
+                                 size_t size) {
   const auto proto = reader.proto();
+  const size_t start = reader.bytesRead();
   STORE_Header hdr;
   STORE_Extra extra;
 
@@ -272,7 +285,8 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader,
              "range [1..%zu]",
              hdr.copyset_size,
              COPYSET_SIZE_MAX);
-    return reader.errorResult(E::BADMSG);
+    reader.setError(E::BADMSG);
+    return nullptr;
   }
 
   folly::small_vector<StoreChainLink, 6> copyset;
@@ -310,25 +324,38 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader,
     reader.readLengthPrefixedVector(&tracing_context);
   }
 
-  const size_t payload_size = reader.bytesRemaining();
+  // The payload takes the rest of the record.
+  const size_t header_size = reader.bytesRead() - start;
+  if (reader.ok() && header_size > size) {
+    ld_error("Bad STORE message: %zu bytes of header don't fit in a record "
+             "of %zu bytes",
+             header_size,
+             size);
+    reader.setError(E::BADMSG);
+  }
+  if (!reader.ok()) {
+    return nullptr;
+  }
+  const size_t payload_size = size - header_size;
   auto payload = PayloadHolder::deserialize(
       reader,
       payload_size,
       /*zero_copy*/ payload_size > max_payload_inline);
+  if (!reader.ok()) {
+    return nullptr;
+  }
 
   auto payload_holder = std::make_shared<PayloadHolder>(std::move(payload));
 
-  return reader.result([&] {
-    // No, you can't replace this with make_unique. The constructor is private.
-    std::unique_ptr<STORE_Message> m(
-        new STORE_Message(hdr, std::move(payload_holder)));
-    m->copyset_ = std::move(copyset);
-    m->block_starting_lsn_ = block_starting_lsn;
-    m->extra_ = std::move(extra);
-    m->optional_keys_ = std::move(optional_keys);
-    m->e2e_tracing_context_ = std::move(tracing_context);
-    return m;
-  });
+  // No, you can't replace this with make_unique. The constructor is private.
+  std::unique_ptr<STORE_Message> m(
+      new STORE_Message(hdr, std::move(payload_holder)));
+  m->copyset_ = std::move(copyset);
+  m->block_starting_lsn_ = block_starting_lsn;
+  m->extra_ = std::move(extra);
+  m->optional_keys_ = std::move(optional_keys);
+  m->e2e_tracing_context_ = std::move(tracing_context);
+  return m;
 }
 
 void STORE_Message::onSentCommon(Status st, const Address& to) const {
@@ -24,6 +24,7 @@
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/Seal.h"
 #include "logdevice/common/ShardID.h"
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/settings/Durability.h"
@@ -242,7 +243,8 @@ struct STORE_Extra {
   }
 };
 
-class STORE_Message : public Message {
+class STORE_Message : public Message,
+                      public ThreadCachedAllocation<STORE_Message> {
  public:
   /**
    * Appender and Mutator use this constructor when composing STORE messages to
@@ -323,6 +325,11 @@ class STORE_Message : public Message {
   // Overload of deserialize that does not need to run on a Worker thread.
   static MessageReadResult deserialize(ProtocolReader&,
                                        size_t max_payload_inline);
+  // Reads a STORE that takes the next `size` bytes of the input, rather than
+  // all of the remaining input. Used for records of a MULTI_STORE message.
+  // Returns nullptr if the reader ended up in an error state.
+  static std::unique_ptr<STORE_Message>
+  deserializeRecord(ProtocolReader&, size_t max_payload_inline, size_t size);
 
   /**
    * @return a human-readable representation of copyset_
@@ -10,6 +10,7 @@
 #include <string>
 #include <type_traits>
 
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/MessageType.h"
@@ -28,13 +29,20 @@ namespace facebook { namespace logdevice {
  *                      the type of message represented by this class
  * @param include_blob  set to true if the message will have a variable-size
  *                      blob.
+ *
+ * Instances are served from per-thread free lists (see
+ * ThreadCachedAllocation.h), so receiving one of these small messages on a
+ * Worker doesn't normally touch the global allocator.
  */
 
 template <class Header,
           MessageType MESSAGE_TYPE,
           TrafficClass TRAFFIC_CLASS,
           bool include_blob = true>
-class SimpleMessage : public Message {
+class SimpleMessage
+    : public Message,
+      public ThreadCachedAllocation<
+          SimpleMessage<Header, MESSAGE_TYPE, TRAFFIC_CLASS, include_blob>> {
   typedef uint32_t blob_size_t;
   // TODO: uncomment this whenever gcc ships it.
   // static_assert(std::is_trivially_copyable<Header>::value,
@@ -31,10 +31,16 @@ Message::Disposition TRIM_Message::onReceived(const Address& /*from*/) {
 }
 
 void TRIM_Message::onSent(Status status, const Address& to) const {
+  onSentCommon(header_, status, to);
+}
+
+void TRIM_Message::onSentCommon(const TRIM_Header& header,
+                                Status status,
+                                const Address& to) {
   TrimRequestMap& rqmap = Worker::onThisThread()->runningTrimRequests();
-  auto it = rqmap.map.find(header_.client_rqid);
+  auto it = rqmap.map.find(header.client_rqid);
   if (it != rqmap.map.end()) {
-    ShardID shard(to.id_.node_.index(), header_.shard);
+    ShardID shard(to.id_.node_.index(), header.shard);
     it->second->onMessageSent(shard, status);
   }
 }
@@ -39,6 +39,12 @@ class TRIM_Message : public Message {
   Disposition onReceived(const Address&) override;
   void onSent(Status st, const Address& to) const override;
 
+  // Reports the outcome of sending the TRIM described by `header` to its
+  // TrimRequest. Also used for TRIMs sent as part of a MULTI_TRIM.
+  static void onSentCommon(const TRIM_Header& header,
+                           Status st,
+                           const Address& to);
+
   const TRIM_Header& getHeader() const {
     return header_;
   }
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/TRIM_POINT_UPDATE_Message.h"
+
+#include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Sequencer.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+TRIM_POINT_UPDATE_Message::TRIM_POINT_UPDATE_Message(
+    std::vector<TRIM_POINT_UPDATE_Entry> updates)
+    : Message(MessageType::TRIM_POINT_UPDATE, TrafficClass::READ_BACKLOG),
+      updates_(std::move(updates)) {
+  ld_check(!updates_.empty());
+}
+
+void TRIM_POINT_UPDATE_Message::serialize(ProtocolWriter& writer) const {
+  const uint32_t num_updates = updates_.size();
+  writer.write(num_updates);
+  writer.writeVector(updates_);
+}
+
+MessageReadResult
+TRIM_POINT_UPDATE_Message::deserialize(ProtocolReader& reader) {
+  uint32_t num_updates = 0;
+  reader.read(&num_updates);
+  if (reader.ok() &&
+      (num_updates == 0 ||
+       num_updates >
+           reader.bytesRemaining() / sizeof(TRIM_POINT_UPDATE_Entry))) {
+    ld_error("Bad TRIM_POINT_UPDATE message: %u updates in %zu bytes",
+             num_updates,
+             reader.bytesRemaining());
+    return reader.errorResult(E::BADMSG);
+  }
+
+  std::vector<TRIM_POINT_UPDATE_Entry> updates;
+  reader.readVector(&updates, num_updates);
+  return reader.result(
+      [&] { return new TRIM_POINT_UPDATE_Message(std::move(updates)); });
+}
+
+Message::Disposition
+TRIM_POINT_UPDATE_Message::onReceived(const Address& from) {
+  ld_debug("Received TRIM_POINT_UPDATE with %zu updates from %s",
+           updates_.size(),
+           Sender::describeConnection(from).c_str());
+
+  WORKER_STAT_ADD(trim_point_updates_received, updates_.size());
+  auto& sequencers = Worker::onThisThread()->processor_->allSequencers();
+  for (const TRIM_POINT_UPDATE_Entry& update : updates_) {
+    auto sequencer = sequencers.findSequencer(update.log_id);
+    // Like GetTrimPointRequest, only active sequencers track the trim point.
+    // A sequencer that moved to another node gets the updates once the new
+    // node asks for the trim point.
+    if (sequencer != nullptr &&
+        sequencer->getState() == Sequencer::State::ACTIVE) {
+      sequencer->updateTrimPoint(E::OK, update.trim_point);
+    }
+  }
+  return Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file TRIM_POINT_UPDATE is sent by storage nodes with --push-trim-points to
+ *       the node whose sequencer last asked them for the trim point of a log
+ *       (with GET_TRIM_POINT), whenever the trim point of the log advances.
+ *       Updates for all logs headed to the same node are batched together.
+ *       The recipient updates the trim point of its sequencers, exactly as
+ *       if it got the same trim points in GET_TRIM_POINT_REPLYs.
+ *
+ *       Wire format:
+ *         uint32_t num_updates
+ *         num_updates x TRIM_POINT_UPDATE_Entry
+ */
+
+struct TRIM_POINT_UPDATE_Entry {
+  logid_t log_id;
+  lsn_t trim_point;
+} __attribute__((__packed__));
+
+class TRIM_POINT_UPDATE_Message : public Message {
+ public:
+  explicit TRIM_POINT_UPDATE_Message(
+      std::vector<TRIM_POINT_UPDATE_Entry> updates);
+
+  TRIM_POINT_UPDATE_Message(const TRIM_POINT_UPDATE_Message&) = delete;
+  TRIM_POINT_UPDATE_Message&
+  operator=(const TRIM_POINT_UPDATE_Message&) = delete;
+
+  uint16_t getMinProtocolVersion() const override {
+    return Compatibility::TRIM_POINT_UPDATE_SUPPORT;
+  }
+
+  // Older sequencer nodes keep polling for trim points.
+  bool warnAboutOldProtocol() const override {
+    return false;
+  }
+
+  const std::vector<TRIM_POINT_UPDATE_Entry>& getUpdates() const {
+    return updates_;
+  }
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address&) override;
+  static Message::deserializer_t deserialize;
+
+ private:
+  std::vector<TRIM_POINT_UPDATE_Entry> updates_;
+};
+
+}} // namespace facebook::logdevice
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/types.h"
@@ -33,7 +34,8 @@ struct WINDOW_Header {
                                    // protocol.
 } __attribute__((__packed__));
 
-class WINDOW_Message : public Message {
+class WINDOW_Message : public Message,
+                       public ThreadCachedAllocation<WINDOW_Message> {
  public:
   /**
    * Construct a WINDOW message.
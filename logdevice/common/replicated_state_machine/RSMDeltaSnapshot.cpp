@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/replicated_state_machine/RSMDeltaSnapshot.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+void RSMDeltaSnapshot::serialize(std::string& out) const {
+  out.clear();
+  ProtocolWriter writer(&out, "RSMDeltaSnapshot::serialize");
+  writer.write(prev_delta_log_read_ptr);
+  writer.write(static_cast<uint32_t>(deltas.size()));
+  for (const Delta& delta : deltas) {
+    writer.write(delta.lsn);
+    writer.write(static_cast<int64_t>(delta.timestamp.count()));
+    writer.writeLengthPrefixedVector(delta.payload);
+  }
+  ld_check(!writer.error());
+}
+
+int RSMDeltaSnapshot::deserialize(Payload payload, RSMDeltaSnapshot& out) {
+  ProtocolReader reader(
+      {payload.data(), payload.size()}, "RSMDeltaSnapshot::deserialize");
+  uint32_t count = 0;
+  reader.read(&out.prev_delta_log_read_ptr);
+  reader.read(&count);
+  out.deltas.clear();
+  for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+    Delta delta;
+    int64_t timestamp = 0;
+    reader.read(&delta.lsn);
+    reader.read(&timestamp);
+    reader.readLengthPrefixedVector(&delta.payload);
+    delta.timestamp = std::chrono::milliseconds(timestamp);
+    if (reader.ok() && !out.deltas.empty() &&
+        delta.lsn <= out.deltas.back().lsn) {
+      err = E::BADMSG;
+      return -1;
+    }
+    out.deltas.push_back(std::move(delta));
+  }
+
+  if (reader.error()) {
+    err = E::BADMSG;
+    return -1;
+  }
+  return 0;
+}
+
+bool RSMDeltaSnapshot::operator==(const RSMDeltaSnapshot& other) const {
+  if (prev_delta_log_read_ptr != other.prev_delta_log_read_ptr ||
+      deltas.size() != other.deltas.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < deltas.size(); ++i) {
+    if (deltas[i].lsn != other.deltas[i].lsn ||
+        deltas[i].timestamp != other.deltas[i].timestamp ||
+        deltas[i].payload != other.deltas[i].payload) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "logdevice/include/Err.h"
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * Body of a snapshot record with the RSMSnapshotHeader::DELTA_SNAPSHOT flag.
+ *
+ * Instead of the full serialized state, a delta snapshot contains the delta
+ * records read from the delta log since the snapshot it extends, identified by
+ * the delta log read pointer of that snapshot. The state is rebuilt by
+ * applying the deltas, in order, on top of the state of the previous snapshot,
+ * so the chain of snapshots starting at the last full (base) snapshot
+ * describes the same state as a full snapshot would.
+ *
+ * The deltas are kept as they appear in the delta log (with their header), so
+ * this does not depend on the type of the state machine.
+ */
+struct RSMDeltaSnapshot {
+  struct Delta {
+    lsn_t lsn;
+    std::chrono::milliseconds timestamp;
+    // Payload of the delta record, including its DeltaHeader.
+    std::string payload;
+  };
+
+  // Delta log read pointer of the snapshot this one extends. Contains all
+  // deltas after that read pointer, up to the read pointer in the header of
+  // this snapshot.
+  lsn_t prev_delta_log_read_ptr{LSN_INVALID};
+
+  // In LSN order.
+  std::vector<Delta> deltas;
+
+  /**
+   * Serialize onto `out', replacing its content.
+   */
+  void serialize(std::string& out) const;
+
+  /**
+   * @return 0 on success, or -1 and err is set to E::BADMSG if the payload is
+   *         not a valid delta snapshot body.
+   */
+  static int deserialize(Payload payload, RSMDeltaSnapshot& out);
+
+  bool operator==(const RSMDeltaSnapshot&) const;
+};
+
+}} // namespace facebook::logdevice
@@ -47,6 +47,18 @@ struct RSMSnapshotHeader : public SerializableData {
   // If this flag is set, use ZSTD to compress / decompress the snapshot
   // payload.
   static const uint32_t ZSTD_COMPRESSION = 1 << 0; //=1
+  // If this flag is set, the snapshot payload is a RSMDeltaSnapshot that
+  // extends the previous snapshot rather than the full serialized state.
+  // Requires format_version >= CONTAINS_DELTA_LOG_READ_PTR_AND_LENGTH.
+  static const uint32_t DELTA_SNAPSHOT = 1 << 1; //=2
+  // If this flag is set, the record is one chunk of a snapshot that didn't fit
+  // in one record, see RSMSnapshotManifest. The other fields are those of the
+  // snapshot. Not a snapshot on its own.
+  static const uint32_t SNAPSHOT_CHUNK = 1 << 2; //=4
+  // If this flag is set, the snapshot payload is a RSMSnapshotManifest listing
+  // the chunk records that hold the actual snapshot body. The other flags
+  // describe that body.
+  static const uint32_t CHUNKED = 1 << 3; //=8
 
   /**
    * Deserialize a RSMSnapshotHeader from a payload.
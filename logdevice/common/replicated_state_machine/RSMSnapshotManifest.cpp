@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/replicated_state_machine/RSMSnapshotManifest.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+std::string serializeWithHeader(const RSMSnapshotHeader& header, Slice body) {
+  const int header_sz = RSMSnapshotHeader::computeLengthInBytes(header);
+  ld_check(header_sz > 0);
+  std::string buf;
+  buf.resize(header_sz + body.size);
+  int rv = RSMSnapshotHeader::serialize(header, &buf[0], header_sz);
+  ld_check(rv == header_sz);
+  if (body.size > 0) {
+    memcpy(&buf[header_sz], body.data, body.size);
+  }
+  return buf;
+}
+
+} // namespace
+
+void RSMSnapshotManifest::serialize(std::string& out) const {
+  out.clear();
+  ProtocolWriter writer(&out, "RSMSnapshotManifest::serialize");
+  writer.write(static_cast<uint32_t>(chunks.size()));
+  for (const Chunk& chunk : chunks) {
+    writer.write(chunk.lsn);
+    writer.write(chunk.size);
+    writer.write(chunk.checksum);
+  }
+  ld_check(!writer.error());
+}
+
+int RSMSnapshotManifest::deserialize(Payload payload,
+                                     RSMSnapshotManifest& out) {
+  ProtocolReader reader(
+      {payload.data(), payload.size()}, "RSMSnapshotManifest::deserialize");
+  uint32_t count = 0;
+  reader.read(&count);
+  out.chunks.clear();
+  for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+    Chunk chunk;
+    reader.read(&chunk.lsn);
+    reader.read(&chunk.size);
+    reader.read(&chunk.checksum);
+    if (reader.ok() && !out.chunks.empty() &&
+        chunk.lsn <= out.chunks.back().lsn) {
+      err = E::BADMSG;
+      return -1;
+    }
+    out.chunks.push_back(chunk);
+  }
+
+  if (reader.error() || out.chunks.empty()) {
+    err = E::BADMSG;
+    return -1;
+  }
+  return 0;
+}
+
+std::string RSMSnapshotManifest::createChunkPayload(RSMSnapshotHeader header,
+                                                    Slice body) {
+  header.flags = RSMSnapshotHeader::SNAPSHOT_CHUNK;
+  return serializeWithHeader(header, body);
+}
+
+std::string
+RSMSnapshotManifest::createManifestPayload(RSMSnapshotHeader header) const {
+  header.flags |= RSMSnapshotHeader::CHUNKED;
+  std::string body;
+  serialize(body);
+  return serializeWithHeader(header, Slice::fromString(body));
+}
+
+int RSMSnapshotManifest::getChunkBody(Payload payload, Slice& body_out) {
+  RSMSnapshotHeader header;
+  const int header_sz = RSMSnapshotHeader::deserialize(payload, header);
+  if (header_sz < 0 || !(header.flags & RSMSnapshotHeader::SNAPSHOT_CHUNK)) {
+    err = E::BADMSG;
+    return -1;
+  }
+  body_out = Slice(static_cast<const char*>(payload.data()) + header_sz,
+                   payload.size() - header_sz);
+  return 0;
+}
+
+bool RSMSnapshotManifest::operator==(const RSMSnapshotManifest& other) const {
+  return chunks == other.chunks;
+}
+
+}} // namespace facebook::logdevice
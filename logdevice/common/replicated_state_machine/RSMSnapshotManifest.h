@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "logdevice/common/replicated_state_machine/RSMSnapshotHeader.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * Body of a snapshot record with the RSMSnapshotHeader::CHUNKED flag.
+ *
+ * A snapshot too big for one record (see --rsm-snapshot-chunk-size) is written
+ * as several chunk records, with the RSMSnapshotHeader::SNAPSHOT_CHUNK flag,
+ * each holding a slice of the snapshot body (after compression, if any),
+ * followed by a manifest record listing them. The header of the manifest is
+ * the header of the snapshot itself plus the CHUNKED flag, so readers can tell
+ * what the snapshot is without looking at the chunks. A reader buffers chunk
+ * records and, when it reads the manifest, concatenates the chunks it lists to
+ * get back the snapshot as if it had been written as a single record.
+ *
+ * A chunk that is not listed by any manifest, e.g. because the writer failed
+ * half-way through, is ignored.
+ */
+struct RSMSnapshotManifest {
+  struct Chunk {
+    lsn_t lsn;
+    // Size of the slice of the snapshot body in that chunk.
+    uint64_t size;
+    // checksum_32bit() of that slice.
+    uint32_t checksum;
+
+    bool operator==(const Chunk& other) const {
+      return lsn == other.lsn && size == other.size &&
+          checksum == other.checksum;
+    }
+  };
+
+  // In the order the slices appear in the snapshot body, which is also LSN
+  // order.
+  std::vector<Chunk> chunks;
+
+  /**
+   * Serialize onto `out', replacing its content.
+   */
+  void serialize(std::string& out) const;
+
+  /**
+   * @return 0 on success, or -1 and err is set to E::BADMSG if the payload is
+   *         not a valid manifest body.
+   */
+  static int deserialize(Payload payload, RSMSnapshotManifest& out);
+
+  /**
+   * @return Payload of a chunk record holding `body', a slice of the body of
+   *         the snapshot with header `header'.
+   */
+  static std::string createChunkPayload(RSMSnapshotHeader header, Slice body);
+
+  /**
+   * @return Payload of the manifest record of the snapshot with header
+   *         `header'.
+   */
+  std::string createManifestPayload(RSMSnapshotHeader header) const;
+
+  /**
+   * Finds the slice of the snapshot body in the payload of a chunk record.
+   *
+   * @return 0 on success, or -1 and err is set to E::BADMSG if the payload is
+   *         not a chunk.
+   */
+  static int getChunkBody(Payload payload, Slice& body_out);
+
+  bool operator==(const RSMSnapshotManifest&) const;
+};
+
+}} // namespace facebook::logdevice
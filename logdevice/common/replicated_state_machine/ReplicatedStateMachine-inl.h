@@ -29,10 +29,14 @@ void ReplicatedStateMachine<T, D>::start() {
   // Initialize `data_` with a default value that we'll use if the snapshot
   // log is empty.
   data_ = makeDefaultState(version_);
+  start_time_ = SteadyTimestamp::now();
 
   if (snapshot_log_id_ == LOGID_INVALID) {
     onBaseSnapshotRetrieved();
   } else {
+    // Look up the tail of the delta log while we're reading the snapshot log.
+    delta_tail_prefetch_in_flight_ = true;
+    getDeltaLogTailLSN();
     getSnapshotLogTailLSN();
   }
   stopped_ = false;
@@ -175,10 +179,11 @@ void ReplicatedStateMachine<T, D>::onGotSnapshotLogTailLSN(Status st,
 }
 
 template <typename T, typename D>
-int ReplicatedStateMachine<T, D>::deserializeSnapshot(
+int ReplicatedStateMachine<T, D>::decodeSnapshotPayload(
     const DataRecord& record,
-    std::unique_ptr<T>& out,
-    RSMSnapshotHeader& header_out) const {
+    RSMSnapshotHeader& header_out,
+    std::unique_ptr<uint8_t[]>& buf_decompressed,
+    Payload& out) const {
   const auto header_sz =
       RSMSnapshotHeader::deserialize(record.payload, header_out);
   if (header_sz < 0) {
@@ -192,7 +197,6 @@ int ReplicatedStateMachine<T, D>::deserializeSnapshot(
   const uint8_t* ptr = reinterpret_cast<const uint8_t*>(record.payload.data());
   ptr += header_sz;
 
-  std::unique_ptr<uint8_t[]> buf_decompressed;
   Payload p(ptr, record.payload.size() - header_sz);
 
   if (header_out.flags & RSMSnapshotHeader::ZSTD_COMPRESSION) {
@@ -225,6 +229,28 @@ int ReplicatedStateMachine<T, D>::deserializeSnapshot(
     p = Payload(buf_decompressed.get(), uncompressed_size);
   }
 
+  out = p;
+  return 0;
+}
+
+template <typename T, typename D>
+bool ReplicatedStateMachine<T, D>::isDeltaSnapshot(const DataRecord& record) {
+  RSMSnapshotHeader header;
+  return RSMSnapshotHeader::deserialize(record.payload, header) >= 0 &&
+      (header.flags & RSMSnapshotHeader::DELTA_SNAPSHOT);
+}
+
+template <typename T, typename D>
+int ReplicatedStateMachine<T, D>::deserializeSnapshot(
+    const DataRecord& record,
+    std::unique_ptr<T>& out,
+    RSMSnapshotHeader& header_out) const {
+  std::unique_ptr<uint8_t[]> buf_decompressed;
+  Payload p;
+  if (decodeSnapshotPayload(record, header_out, buf_decompressed, p) != 0) {
+    return -1;
+  }
+
   std::chrono::milliseconds timestamp = record.attrs.timestamp;
   auto new_val = deserializeState(p, header_out.base_version, timestamp);
   if (new_val) {
@@ -236,6 +262,24 @@ int ReplicatedStateMachine<T, D>::deserializeSnapshot(
   }
 }
 
+template <typename T, typename D>
+int ReplicatedStateMachine<T, D>::deserializeDeltaSnapshot(
+    const DataRecord& record,
+    RSMDeltaSnapshot& out,
+    RSMSnapshotHeader& header_out) const {
+  std::unique_ptr<uint8_t[]> buf_decompressed;
+  Payload p;
+  if (decodeSnapshotPayload(record, header_out, buf_decompressed, p) != 0) {
+    return -1;
+  }
+  if (header_out.format_version <
+      RSMSnapshotHeader::CONTAINS_DELTA_LOG_READ_PTR_AND_LENGTH) {
+    err = E::BADMSG;
+    return -1;
+  }
+  return RSMDeltaSnapshot::deserialize(p, out);
+}
+
 template <typename T, typename D>
 bool ReplicatedStateMachine<T, D>::canFastForward(lsn_t lsn) {
   if (isGracePeriodForFastForwardActive()) {
@@ -260,36 +304,206 @@ bool ReplicatedStateMachine<T, D>::canFastForward(lsn_t lsn) {
 template <typename T, typename D>
 bool ReplicatedStateMachine<T, D>::onSnapshotRecord(
     std::unique_ptr<DataRecord>& record) {
+  RSMSnapshotHeader header;
+  if (RSMSnapshotHeader::deserialize(record->payload, header) >= 0) {
+    if (header.flags & RSMSnapshotHeader::SNAPSHOT_CHUNK) {
+      // Keep the chunk until we read the manifest that lists it.
+      if (!onNonSnapshotRecord(*record)) {
+        return false;
+      }
+      const lsn_t lsn = record->attrs.lsn;
+      snapshot_chunks_[lsn] = std::move(record);
+      return true;
+    }
+    if (header.flags & RSMSnapshotHeader::CHUNKED) {
+      // The chunks are dropped only once the reassembled snapshot is
+      // accepted, as the manifest is redelivered if we return false.
+      RSMSnapshotManifest manifest;
+      if (reassembleChunkedSnapshot(record, manifest)
+              ? !onSnapshotRecord(record)
+              : !onNonSnapshotRecord(*record)) {
+        return false;
+      }
+      dropSnapshotChunks(manifest);
+      return true;
+    }
+  }
+
+  const bool is_delta = isDeltaSnapshot(*record);
+
   if (sync_state_ == SyncState::SYNC_SNAPSHOT &&
       record->attrs.lsn < snapshot_sync_) {
     // Do not deserialize this snapshot just yet. We'll look at it only when we
-    // know that it was the last snapshot, inside ::onSnapshotGap().
-    last_snapshot_record_ = std::move(record);
+    // know that it was the last base snapshot, inside ::onSnapshotGap(). Delta
+    // snapshots are kept until the next base snapshot as they need to be
+    // applied on top of it.
+    if (is_delta) {
+      buffered_delta_snapshots_.push_back(std::move(record));
+    } else {
+      last_snapshot_record_ = std::move(record);
+      buffered_delta_snapshots_.clear();
+    }
     return true;
   }
 
-  last_snapshot_record_.reset();
+  if (is_delta) {
+    // This delta snapshot extends the snapshots we buffered.
+    if (!processBufferedSnapshots()) {
+      return false;
+    }
+  } else {
+    last_snapshot_record_.reset();
+    buffered_delta_snapshots_.clear();
+  }
   return processSnapshot(record);
 }
 
 template <typename T, typename D>
-bool ReplicatedStateMachine<T, D>::processSnapshot(
-    std::unique_ptr<DataRecord>& record) {
-  std::unique_ptr<T> data;
+bool ReplicatedStateMachine<T, D>::onNonSnapshotRecord(
+    const DataRecord& record) {
+  if (sync_state_ == SyncState::SYNC_SNAPSHOT &&
+      record.attrs.lsn >= snapshot_sync_) {
+    if (!processBufferedSnapshots()) {
+      return false;
+    }
+    onBaseSnapshotRetrieved();
+  }
+  return true;
+}
+
+template <typename T, typename D>
+bool ReplicatedStateMachine<T, D>::reassembleChunkedSnapshot(
+    std::unique_ptr<DataRecord>& record,
+    RSMSnapshotManifest& manifest) {
+  const lsn_t lsn = record->attrs.lsn;
   RSMSnapshotHeader header;
-  const int rv = deserializeSnapshot(*record, data, header);
+  const int header_sz = RSMSnapshotHeader::deserialize(record->payload, header);
+  ld_check(header_sz >= 0);
+  if (RSMSnapshotManifest::deserialize(
+          Payload(static_cast<const char*>(record->payload.data()) + header_sz,
+                  record->payload.size() - header_sz),
+          manifest) != 0) {
+    rsm_critical(rsm_type_,
+                 "Could not deserialize the manifest of chunked snapshot "
+                 "record with lsn %s",
+                 lsn_to_string(lsn).c_str());
+    manifest.chunks.clear();
+    return false;
+  }
 
-  if (rv != 0) {
+  header.flags &= ~RSMSnapshotHeader::CHUNKED;
+  const int new_header_sz = RSMSnapshotHeader::computeLengthInBytes(header);
+  ld_check(new_header_sz > 0);
+  size_t size = new_header_sz;
+  for (const RSMSnapshotManifest::Chunk& chunk : manifest.chunks) {
+    size += chunk.size;
+  }
+
+  // The reassembled payload is left compressed, it gets decompressed only if
+  // it is the snapshot we end up applying.
+  void* buf = malloc(size);
+  if (!buf) {
+    throw std::bad_alloc();
+  }
+  int rv = RSMSnapshotHeader::serialize(
+      header, static_cast<char*>(buf), new_header_sz);
+  ld_check(rv == new_header_sz);
+  size_t offset = new_header_sz;
+  bool ok = true;
+  for (const RSMSnapshotManifest::Chunk& chunk : manifest.chunks) {
+    auto it = snapshot_chunks_.find(chunk.lsn);
+    Slice body;
+    if (it == snapshot_chunks_.end() ||
+        RSMSnapshotManifest::getChunkBody(it->second->payload, body) != 0 ||
+        body.size != chunk.size || checksum_32bit(body) != chunk.checksum) {
+      rsm_critical(rsm_type_,
+                   "Chunk with lsn %s of snapshot record with lsn %s is %s",
+                   lsn_to_string(chunk.lsn).c_str(),
+                   lsn_to_string(lsn).c_str(),
+                   it == snapshot_chunks_.end() ? "missing" : "corrupted");
+      ok = false;
+      break;
+    }
+    memcpy(static_cast<char*>(buf) + offset, body.data, body.size);
+    offset += body.size;
+  }
+
+  if (!ok) {
+    free(buf);
+    return false;
+  }
+
+  ld_check(offset == size);
+  rsm_info(rsm_type_,
+           "Reassembled snapshot record with lsn %s from %lu chunks "
+           "(%lu bytes)",
+           lsn_to_string(lsn).c_str(),
+           manifest.chunks.size(),
+           size);
+  record = std::make_unique<DataRecordOwnsPayload>(record->logid,
+                                                   Payload(buf, size),
+                                                   lsn,
+                                                   record->attrs.timestamp,
+                                                   0 // flags
+  );
+  return true;
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::dropSnapshotChunks(
+    const RSMSnapshotManifest& manifest) {
+  if (manifest.chunks.empty()) {
+    return;
+  }
+  for (const RSMSnapshotManifest::Chunk& chunk : manifest.chunks) {
+    snapshot_chunks_.erase(chunk.lsn);
+  }
+  // Chunks older than this snapshot are leftovers from a snapshot whose
+  // manifest was never written.
+  snapshot_chunks_.erase(
+      snapshot_chunks_.begin(),
+      snapshot_chunks_.lower_bound(manifest.chunks.front().lsn));
+}
+
+template <typename T, typename D>
+bool ReplicatedStateMachine<T, D>::processBufferedSnapshots() {
+  if (last_snapshot_record_) {
+    if (!processSnapshot(last_snapshot_record_)) {
+      return false;
+    }
+    last_snapshot_record_.reset();
+  }
+  while (!buffered_delta_snapshots_.empty()) {
+    if (!processSnapshot(buffered_delta_snapshots_.front())) {
+      return false;
+    }
+    buffered_delta_snapshots_.erase(buffered_delta_snapshots_.begin());
+  }
+  return true;
+}
+
+template <typename T, typename D>
+bool ReplicatedStateMachine<T, D>::applyBaseSnapshot(const DataRecord& record,
+                                                     RSMSnapshotHeader& header,
+                                                     bool& ok) {
+  std::unique_ptr<T> data;
+  ok = deserializeSnapshot(record, data, header) == 0;
+
+  if (!ok) {
     // NOTE: We cannot make progress if this is the last snapshot and it's bad,
     // this means that the RSM will stall unless a newer snapshot is written.
     rsm_critical(rsm_type_,
                  "Could not deserialize snapshot record with lsn %s: %s",
-                 lsn_to_string(record->attrs.lsn).c_str(),
+                 lsn_to_string(record.attrs.lsn).c_str(),
                  error_name(err));
-    if (!can_skip_bad_snapshot_) {
-      return false;
-    }
-  } else if (header.base_version > version_) {
+    return can_skip_bad_snapshot_;
+  }
+
+  num_delta_snapshots_since_base_ = 0;
+  delta_snapshot_bytes_since_base_ = 0;
+  last_base_snapshot_size_ = record.payload.size();
+
+  if (header.base_version > version_) {
     // Return false if we should not be fast forwarding right now, in that case
     // the grace period timer is activated. @see canFastForward().
     if (sync_state_ == SyncState::TAILING &&
@@ -310,7 +524,9 @@ bool ReplicatedStateMachine<T, D>::processSnapshot(
     }
     delta_log_byte_offset_ = header.byte_offset;
     delta_log_offset_ = header.offset;
-    snapshot_log_timestamp_ = record->attrs.timestamp;
+    snapshot_log_timestamp_ = record.attrs.timestamp;
+    onStateAdvancedBySnapshot(
+        std::max(header.base_version, last_snapshot_last_read_ptr_));
 
     if (sync_state_ == SyncState::TAILING || deliver_while_replaying_) {
       notifySubscribers();
@@ -319,13 +535,143 @@ bool ReplicatedStateMachine<T, D>::processSnapshot(
     rsm_info(rsm_type_,
              "Applied snapshot record with lsn %s timestamp %lu "
              "and base version %s (serialization format version was %d)",
-             lsn_to_string(record->attrs.lsn).c_str(),
-             record->attrs.timestamp.count(),
+             lsn_to_string(record.attrs.lsn).c_str(),
+             record.attrs.timestamp.count(),
              lsn_to_string(header.base_version).c_str(),
              header.format_version);
   }
+  return true;
+}
 
-  if (rv == 0) {
+template <typename T, typename D>
+bool ReplicatedStateMachine<T, D>::applyDeltaSnapshot(
+    const DataRecord& record,
+    RSMSnapshotHeader& header,
+    bool& ok) {
+  RSMDeltaSnapshot snapshot;
+  ok = deserializeDeltaSnapshot(record, snapshot, header) == 0;
+
+  if (!ok) {
+    rsm_critical(rsm_type_,
+                 "Could not deserialize delta snapshot record with lsn %s: %s",
+                 lsn_to_string(record.attrs.lsn).c_str(),
+                 error_name(err));
+    return can_skip_bad_snapshot_;
+  }
+
+  ++num_delta_snapshots_since_base_;
+  delta_snapshot_bytes_since_base_ += record.payload.size();
+
+  if (header.delta_log_read_ptr <= state_delta_read_ptr_) {
+    // We already have all the deltas in this snapshot.
+    return true;
+  }
+
+  if (snapshot.prev_delta_log_read_ptr > state_delta_read_ptr_) {
+    // This snapshot extends a snapshot we did not apply (e.g. the base it
+    // builds on was trimmed or could not be read). Applying it would skip the
+    // deltas in between.
+    rsm_error(rsm_type_,
+              "Cannot apply delta snapshot record with lsn %s: it extends a "
+              "snapshot with delta log read pointer %s but our state only "
+              "accounts for deltas up to %s",
+              lsn_to_string(record.attrs.lsn).c_str(),
+              lsn_to_string(snapshot.prev_delta_log_read_ptr).c_str(),
+              lsn_to_string(state_delta_read_ptr_).c_str());
+    return true;
+  }
+
+  if (sync_state_ == SyncState::TAILING &&
+      waiting_for_snapshot_ == LSN_INVALID &&
+      !canFastForward(header.base_version)) {
+    return false;
+  }
+
+  // Apply the deltas the same way onDeltaRecord() would have.
+  ld_check(data_);
+  size_t applied = 0;
+  for (const RSMDeltaSnapshot::Delta& d : snapshot.deltas) {
+    if (d.lsn <= state_delta_read_ptr_) {
+      continue;
+    }
+    DataRecord delta_record(delta_log_id_,
+                            Payload(d.payload.data(), d.payload.size()),
+                            d.lsn,
+                            d.timestamp);
+    DeltaHeader delta_header;
+    std::unique_ptr<D> delta;
+    std::string failure_reason;
+    if (deserializeDelta(delta_record, delta, delta_header) == 0 &&
+        applyDelta(*delta, *data_, d.lsn, d.timestamp, failure_reason) == 0) {
+      version_ = d.lsn;
+      ++applied;
+    }
+  }
+
+  version_ = std::max(version_, header.base_version);
+  last_snapshot_version_ = header.base_version;
+  last_snapshot_last_read_ptr_ = header.delta_log_read_ptr;
+  delta_log_byte_offset_ = header.byte_offset;
+  delta_log_offset_ = header.offset;
+  snapshot_log_timestamp_ = record.attrs.timestamp;
+  onStateAdvancedBySnapshot(header.delta_log_read_ptr);
+
+  if (sync_state_ == SyncState::TAILING || deliver_while_replaying_) {
+    notifySubscribers();
+  }
+
+  rsm_info(rsm_type_,
+           "Applied delta snapshot record with lsn %s timestamp %lu "
+           "(%zu of %zu deltas), version is now %s",
+           lsn_to_string(record.attrs.lsn).c_str(),
+           record.attrs.timestamp.count(),
+           applied,
+           snapshot.deltas.size(),
+           lsn_to_string(version_).c_str());
+  return true;
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::onStateAdvancedBySnapshot(lsn_t read_ptr) {
+  state_delta_read_ptr_ = std::max(state_delta_read_ptr_, read_ptr);
+  // Whatever we retained is now in the snapshot log.
+  retained_deltas_.clear();
+  retained_deltas_from_ = state_delta_read_ptr_;
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::pruneRetainedDeltas() {
+  ld_check(chain_delta_log_read_ptr_ != LSN_INVALID);
+  while (!retained_deltas_.empty() &&
+         retained_deltas_.front().lsn <= chain_delta_log_read_ptr_) {
+    retained_deltas_.pop_front();
+  }
+  if (retained_deltas_from_ != LSN_INVALID) {
+    retained_deltas_from_ =
+        std::max(retained_deltas_from_, chain_delta_log_read_ptr_);
+  }
+}
+
+template <typename T, typename D>
+bool ReplicatedStateMachine<T, D>::processSnapshot(
+    std::unique_ptr<DataRecord>& record) {
+  RSMSnapshotHeader header;
+  bool ok = false;
+  const bool proceed = isDeltaSnapshot(*record)
+      ? applyDeltaSnapshot(*record, header, ok)
+      : applyBaseSnapshot(*record, header, ok);
+  if (!proceed) {
+    return false;
+  }
+
+  if (ok) {
+    if (header.format_version >=
+        RSMSnapshotHeader::CONTAINS_DELTA_LOG_READ_PTR_AND_LENGTH) {
+      chain_delta_log_read_ptr_ = chain_delta_log_read_ptr_ == LSN_INVALID
+          ? header.delta_log_read_ptr
+          : std::max(chain_delta_log_read_ptr_, header.delta_log_read_ptr);
+      pruneRetainedDeltas();
+    }
     // Using max() here because these values may already be higher as they can
     // be set by the snapshot() function, and also because snapshots can be
     // unordered.
@@ -387,13 +733,10 @@ bool ReplicatedStateMachine<T, D>::onSnapshotGap(const GapRecord& gap) {
   }
 
   if (sync_state_ == SyncState::SYNC_SNAPSHOT && gap.hi >= snapshot_sync_) {
-    if (last_snapshot_record_) {
-      // We found a snapshot record and deferred its serialization until we know
-      // it's the last one. Do it now.
-      if (!processSnapshot(last_snapshot_record_)) {
-        return false;
-      }
-      last_snapshot_record_.reset();
+    // We found snapshot records and deferred their deserialization until we
+    // know which one is the last base snapshot. Do it now.
+    if (!processBufferedSnapshots()) {
+      return false;
     }
     onBaseSnapshotRetrieved();
   }
@@ -403,13 +746,24 @@ bool ReplicatedStateMachine<T, D>::onSnapshotGap(const GapRecord& gap) {
 
 template <typename T, typename D>
 void ReplicatedStateMachine<T, D>::onBaseSnapshotRetrieved() {
+  snapshot_sync_duration_ =
+      (SteadyTimestamp::now() - start_time_).toMilliseconds();
   rsm_info(rsm_type_,
-           "Base snapshot has version %s",
-           lsn_to_string(version_).c_str());
+           "Base snapshot has version %s, took %ldms",
+           lsn_to_string(version_).c_str(),
+           snapshot_sync_duration_.count());
   activateGracePeriodForSnapshotting();
   gotInitialState(*data_);
   sync_state_ = SyncState::SYNC_DELTAS;
-  getDeltaLogTailLSN();
+  if (prefetched_delta_sync_ != LSN_INVALID) {
+    const lsn_t lsn = prefetched_delta_sync_;
+    prefetched_delta_sync_ = LSN_INVALID;
+    onGotDeltaLogTailLSN(E::OK, lsn);
+  } else if (!delta_tail_prefetch_in_flight_) {
+    getDeltaLogTailLSN();
+  } else {
+    // onGotDeltaLogTailLSN() will be called when the lookup completes.
+  }
 }
 
 template <typename T, typename D>
@@ -444,10 +798,18 @@ void ReplicatedStateMachine<T, D>::onGotDeltaLogTailLSN(Status st, lsn_t lsn) {
   // Because we use SyncSequencerRequest without a timeout and don't cancel that
   // request, the request has to complete Successfully.
   ld_check(st == E::OK);
+  delta_tail_prefetch_in_flight_ = false;
 
   rsm_info(
       rsm_type_, "Tail lsn of delta log is %s", lsn_to_string(lsn).c_str());
 
+  if (sync_state_ == SyncState::SYNC_SNAPSHOT) {
+    // Looked up by start(). We'll start reading the delta log once we have the
+    // base snapshot.
+    prefetched_delta_sync_ = lsn;
+    return;
+  }
+
   // We will notifier subscribers of the initial state machine's state only
   // after we sync up to that lsn.
   ld_check(lsn != LSN_INVALID);
@@ -513,6 +875,21 @@ bool ReplicatedStateMachine<T, D>::onDeltaRecord(
   // keep track of the last records received
   ld_check(record->attrs.lsn > delta_read_ptr_);
   delta_read_ptr_ = record->attrs.lsn;
+  if (sync_state_ == SyncState::SYNC_DELTAS) {
+    ++deltas_replayed_;
+  }
+
+  if (record->attrs.lsn > state_delta_read_ptr_) {
+    state_delta_read_ptr_ = record->attrs.lsn;
+    if (max_delta_snapshots_ > 0 && retained_deltas_from_ != LSN_INVALID) {
+      // Keep the delta for the next delta snapshot.
+      retained_deltas_.push_back(RSMDeltaSnapshot::Delta{
+          record->attrs.lsn,
+          record->attrs.timestamp,
+          std::string(static_cast<const char*>(record->payload.data()),
+                      record->payload.size())});
+    }
+  }
 
   // If the timer for fast forwarding with a snapshot is active, let's restart
   // it.
@@ -559,10 +936,14 @@ bool ReplicatedStateMachine<T, D>::onDeltaRecord(
                failure_reason.c_str());
       st = err;
     } else {
-      rsm_info(rsm_type_,
-               "Applied delta record with lsn=%s ts=%s",
-               lsn_to_string(record->attrs.lsn).c_str(),
-               format_time(record->attrs.timestamp).c_str());
+      // Don't log every delta of the backlog, onReachedDeltaLogTailLSN() logs
+      // a summary.
+      rsm_log(sync_state_ == SyncState::TAILING ? dbg::Level::INFO
+                                                : dbg::Level::DEBUG,
+              rsm_type_,
+              "Applied delta record with lsn=%s ts=%s",
+              lsn_to_string(record->attrs.lsn).c_str(),
+              format_time(record->attrs.timestamp).c_str());
 
       // Only update the version if the delta was successfully applied.
       // This ensures that the replicated state machine version is the version
@@ -730,9 +1111,16 @@ bool ReplicatedStateMachine<T, D>::onDeltaGap(const GapRecord& gap) {
       // If this does not get resolved in a timely manner, we'll bump a stat so
       // that an oncall can be notified and manually write a snapshot.
       activateStallGracePeriod();
+      // The deltas we retained for the next delta snapshot have a hole.
+      retained_deltas_.clear();
+      retained_deltas_from_ = LSN_INVALID;
     }
   }
 
+  if (waiting_for_snapshot_ == LSN_INVALID) {
+    state_delta_read_ptr_ = std::max(state_delta_read_ptr_, gap.hi);
+  }
+
   if (sync_state_ == SyncState::SYNC_DELTAS && gap.hi >= delta_sync_) {
     onReachedDeltaLogTailLSN();
   }
@@ -744,7 +1132,18 @@ template <typename T, typename D>
 void ReplicatedStateMachine<T, D>::onReachedDeltaLogTailLSN() {
   sync_state_ = SyncState::TAILING;
 
-  rsm_info(rsm_type_, "Reached tail of delta log");
+  if (delta_sync_duration_ == std::chrono::milliseconds::max()) {
+    // First time since start().
+    delta_sync_duration_ =
+        (SteadyTimestamp::now() - start_time_).toMilliseconds() -
+        snapshot_sync_duration_;
+    rsm_info(rsm_type_,
+             "Reached tail of delta log, replayed %lu deltas in %ldms",
+             deltas_replayed_,
+             delta_sync_duration_.count());
+  } else {
+    rsm_info(rsm_type_, "Reached tail of delta log");
+  }
 
   // If we were not already delivering updates while we were replaying the
   // backlog, now is the time to deliver the first update to subscribers.
@@ -1102,7 +1501,8 @@ template <typename T, typename D>
 std::string ReplicatedStateMachine<T, D>::createSnapshotPayload(
     const T& data,
     lsn_t version,
-    bool rsm_include_read_pointer_in_snapshot) {
+    bool rsm_include_read_pointer_in_snapshot,
+    bool compress) {
   RSMSnapshotHeader header{
       /*format_version=*/rsm_include_read_pointer_in_snapshot
           ? RSMSnapshotHeader::CONTAINS_DELTA_LOG_READ_PTR_AND_LENGTH
@@ -1113,13 +1513,50 @@ std::string ReplicatedStateMachine<T, D>::createSnapshotPayload(
       /*base_version=*/version,
       /*delta_log_read_ptr=*/delta_read_ptr_};
 
+  // Determine the size of the uncompressed payload.
+  const size_t uncompressed_payload_size = serializeState(data, nullptr, 0);
+
+  return encodeSnapshotPayload(
+      header,
+      uncompressed_payload_size,
+      [&](uint8_t* ptr) {
+        auto rv = serializeState(data, ptr, uncompressed_payload_size);
+        ld_check(rv == uncompressed_payload_size);
+      },
+      compress);
+}
+
+template <typename T, typename D>
+std::string ReplicatedStateMachine<T, D>::createDeltaSnapshotPayload(
+    const RSMDeltaSnapshot& snapshot,
+    lsn_t version,
+    lsn_t delta_log_read_ptr) {
+  RSMSnapshotHeader header{
+      /*format_version=*/RSMSnapshotHeader::
+          CONTAINS_DELTA_LOG_READ_PTR_AND_LENGTH,
+      /*flags=*/RSMSnapshotHeader::DELTA_SNAPSHOT,
+      /*byte_offset=*/delta_log_byte_offset_,
+      /*offset=*/delta_log_offset_,
+      /*base_version=*/version,
+      /*delta_log_read_ptr=*/delta_log_read_ptr};
+
+  std::string body;
+  snapshot.serialize(body);
+  return encodeSnapshotPayload(header, body.size(), [&](uint8_t* ptr) {
+    memcpy(ptr, body.data(), body.size());
+  });
+}
+
+template <typename T, typename D>
+std::string ReplicatedStateMachine<T, D>::encodeSnapshotPayload(
+    RSMSnapshotHeader header,
+    size_t uncompressed_payload_size,
+    folly::FunctionRef<void(uint8_t* buf)> write_body,
+    bool compress) {
   // Determine the size of the header.
   const size_t header_sz = RSMSnapshotHeader::computeLengthInBytes(header);
   ld_check(header_sz > 0);
 
-  // Determine the size of the uncompressed payload.
-  const size_t uncompressed_payload_size = serializeState(data, nullptr, 0);
-
   // Serialize both header and uncompressed payload onto a buffer.
   std::string buf;
   {
@@ -1128,46 +1565,59 @@ std::string ReplicatedStateMachine<T, D>::createSnapshotPayload(
     auto rv = RSMSnapshotHeader::serialize(header, ptr, header_sz);
     ld_check(rv == header_sz);
     ptr += header_sz;
-    rv = serializeState(data, ptr, uncompressed_payload_size);
-    ld_check(rv == uncompressed_payload_size);
+    write_body(ptr);
   }
 
-  if (snapshot_compression_) {
-    header.flags |= RSMSnapshotHeader::ZSTD_COMPRESSION;
+  if (snapshot_compression_ && compress) {
+    return compressSnapshotPayload(rsm_type_, buf);
+  }
 
-    // Allocate a new buffer to hold the header and compressed payload.
-    const size_t compressed_data_bound =
-        ZSTD_compressBound(uncompressed_payload_size);
-    ld_check(compressed_data_bound > 0);
-    std::string compressed_buf;
-    compressed_buf.resize(header_sz + compressed_data_bound);
+  return buf;
+}
 
-    // Serialize the header.
-    uint8_t* ptr = reinterpret_cast<uint8_t*>(&compressed_buf[0]);
-    auto rv = RSMSnapshotHeader::serialize(header, ptr, header_sz);
-    ld_check(rv == header_sz);
-    ptr += header_sz;
+template <typename T, typename D>
+std::string
+ReplicatedStateMachine<T, D>::compressSnapshotPayload(RSMType rsm_type,
+                                                      const std::string& buf) {
+  RSMSnapshotHeader header;
+  const int rv = RSMSnapshotHeader::deserialize(
+      Payload(buf.data(), buf.size()), header);
+  ld_check(rv > 0);
+  const size_t header_sz = rv;
+  const size_t uncompressed_payload_size = buf.size() - header_sz;
+  header.flags |= RSMSnapshotHeader::ZSTD_COMPRESSION;
+
+  // Allocate a new buffer to hold the header and compressed payload.
+  const size_t compressed_data_bound =
+      ZSTD_compressBound(uncompressed_payload_size);
+  ld_check(compressed_data_bound > 0);
+  std::string compressed_buf;
+  compressed_buf.resize(header_sz + compressed_data_bound);
+
+  // Serialize the header.
+  uint8_t* ptr = reinterpret_cast<uint8_t*>(&compressed_buf[0]);
+  auto sz = RSMSnapshotHeader::serialize(header, ptr, header_sz);
+  ld_check(sz == header_sz);
+  ptr += header_sz;
 
-    // Compress the paylaod.
-    const uint8_t* ptr_src = reinterpret_cast<uint8_t*>(&buf[0]) + header_sz;
-    const int ZSTD_LEVEL = 5;
-    auto compressed_size = ZSTD_compress(ptr,                   // dst
-                                         compressed_data_bound, // dstCapacity
-                                         ptr_src,               // src
-                                         uncompressed_payload_size, // srcSize
-                                         ZSTD_LEVEL);               // level
-    if (ZSTD_isError(compressed_size)) {
-      rsm_error(rsm_type_,
-                "ZSTD_compress() failed: %s",
-                ZSTD_getErrorName(compressed_size));
-      ld_check(false);
-      return std::string();
-    }
-    compressed_buf.resize(header_sz + compressed_size);
-    return compressed_buf;
+  // Compress the paylaod.
+  const uint8_t* ptr_src =
+      reinterpret_cast<const uint8_t*>(&buf[0]) + header_sz;
+  const int ZSTD_LEVEL = 5;
+  auto compressed_size = ZSTD_compress(ptr,                   // dst
+                                       compressed_data_bound, // dstCapacity
+                                       ptr_src,               // src
+                                       uncompressed_payload_size, // srcSize
+                                       ZSTD_LEVEL);               // level
+  if (ZSTD_isError(compressed_size)) {
+    rsm_error(rsm_type,
+              "ZSTD_compress() failed: %s",
+              ZSTD_getErrorName(compressed_size));
+    ld_check(false);
+    return std::string();
   }
-
-  return buf;
+  compressed_buf.resize(header_sz + compressed_size);
+  return compressed_buf;
 }
 
 template <typename T, typename D>
@@ -1198,20 +1648,85 @@ void ReplicatedStateMachine<T, D>::snapshot(std::function<void(Status st)> cb) {
     return;
   }
 
+  const bool include_read_ptr =
+      Worker::settings().rsm_include_read_pointer_in_snapshot;
+  std::string payload = maybeCreateDeltaSnapshotPayload(include_read_ptr);
+  const bool is_delta = !payload.empty();
   rsm_info(rsm_type_,
-           "Creating snapshot with version %s (compression %s)",
+           "Creating %s snapshot with version %s (compression %s)",
+           is_delta ? "delta" : "base",
            lsn_to_string(version_).c_str(),
            snapshot_compression_ ? "enabled" : "disabled");
-  std::string payload = createSnapshotPayload(
-      *data_,
-      version_,
-      Worker::settings().rsm_include_read_pointer_in_snapshot);
+  // Base snapshots get compressed on the CPU offload pool, if any, see below.
+  const bool offload_compression = !is_delta && snapshot_compression_;
+  if (!is_delta) {
+    payload = createSnapshotPayload(
+        *data_, version_, include_read_ptr, !offload_compression);
+  }
 
-  // We'll capture these in the lambda below.
+  // State of the delta log that the snapshot accounts for.
   const size_t byte_offset_at_time_of_snapshot = delta_log_byte_offset_;
   const size_t offset_at_time_of_snapshot = delta_log_offset_;
+  const lsn_t read_ptr_at_time_of_snapshot =
+      is_delta ? state_delta_read_ptr_ : delta_read_ptr_;
 
+  snapshot_in_flight_ = true;
+
+  if (offload_compression) {
+    auto ref = callbackHelper_.getHolder().ref();
+    auto compressed = std::make_shared<std::string>();
+    Worker::onThisThread()->offloadCPUWork(
+        [rsm_type = rsm_type_, payload = std::move(payload), compressed] {
+          *compressed = compressSnapshotPayload(rsm_type, payload);
+        },
+        [=] {
+          if (!ref) {
+            // `this` is gone.
+            return;
+          }
+          appendSnapshot(std::move(*compressed),
+                         include_read_ptr,
+                         byte_offset_at_time_of_snapshot,
+                         offset_at_time_of_snapshot,
+                         read_ptr_at_time_of_snapshot,
+                         cb);
+        });
+    return;
+  }
+
+  appendSnapshot(std::move(payload),
+                 include_read_ptr,
+                 byte_offset_at_time_of_snapshot,
+                 offset_at_time_of_snapshot,
+                 read_ptr_at_time_of_snapshot,
+                 cb);
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::appendSnapshot(
+    std::string payload,
+    bool include_read_ptr,
+    size_t byte_offset_at_time_of_snapshot,
+    size_t offset_at_time_of_snapshot,
+    lsn_t read_ptr_at_time_of_snapshot,
+    std::function<void(Status st)> cb) {
+  ld_check(snapshot_in_flight_);
+  auto cb_or_noop = [=](Status st) {
+    if (cb) {
+      cb(st);
+    }
+  };
+
+  const size_t payload_size = payload.size();
   auto append_cb = [=](Status st, lsn_t /*lsn*/) {
+    if (st == E::OK && include_read_ptr) {
+      // Next delta snapshot extends this one, no need to wait until we read
+      // it.
+      chain_delta_log_read_ptr_ = chain_delta_log_read_ptr_ == LSN_INVALID
+          ? read_ptr_at_time_of_snapshot
+          : std::max(chain_delta_log_read_ptr_, read_ptr_at_time_of_snapshot);
+      pruneRetainedDeltas();
+    }
     if (st == E::OK) {
       // We don't want to wait for the snapshot to be read before
       // last_snapshot_* members are modified otherwise
@@ -1225,15 +1740,105 @@ void ReplicatedStateMachine<T, D>::snapshot(std::function<void(Status st)> cb) {
     }
     snapshot_in_flight_ = false;
 
-    onSnapshotCreated(st, payload.size());
+    onSnapshotCreated(st, payload_size);
 
     cb_or_noop(st);
   };
 
-  postAppendRequest(
-      snapshot_log_id_, payload, snapshot_append_timeout_, append_cb);
+  const size_t chunk_size = Worker::settings().rsm_snapshot_chunk_size;
+  if (chunk_size > 0 && payload.size() > chunk_size) {
+    auto write = std::make_shared<ChunkedSnapshotWrite>();
+    const int header_sz = RSMSnapshotHeader::deserialize(
+        Payload(payload.data(), payload.size()), write->header);
+    ld_check(header_sz > 0);
+    write->body = payload.substr(header_sz);
+    write->chunk_size = chunk_size;
+    write->cb = std::move(append_cb);
+    writeSnapshotChunks(std::move(write));
+  } else {
+    postAppendRequest(snapshot_log_id_,
+                      std::move(payload),
+                      snapshot_append_timeout_,
+                      append_cb);
+  }
+}
 
-  snapshot_in_flight_ = true;
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::writeSnapshotChunks(
+    std::shared_ptr<ChunkedSnapshotWrite> write) {
+  if (write->next_offset >= write->body.size()) {
+    rsm_info(rsm_type_,
+             "Appending manifest of snapshot written as %lu chunks",
+             write->manifest.chunks.size());
+    postAppendRequest(snapshot_log_id_,
+                      write->manifest.createManifestPayload(write->header),
+                      snapshot_append_timeout_,
+                      write->cb);
+    return;
+  }
+
+  const Slice body(write->body.data() + write->next_offset,
+                   std::min(write->chunk_size,
+                            write->body.size() - write->next_offset));
+  RSMSnapshotManifest::Chunk chunk;
+  chunk.size = body.size;
+  chunk.checksum = checksum_32bit(body);
+  write->next_offset += body.size;
+  auto cb = [this, write, chunk](Status st, lsn_t lsn) mutable {
+    if (st != E::OK) {
+      rsm_error(rsm_type_,
+                "Could not append snapshot chunk: %s",
+                error_name(st));
+      write->cb(st, LSN_INVALID);
+      return;
+    }
+    chunk.lsn = lsn;
+    write->manifest.chunks.push_back(chunk);
+    writeSnapshotChunks(std::move(write));
+  };
+  std::string payload =
+      RSMSnapshotManifest::createChunkPayload(write->header, body);
+  postAppendRequest(snapshot_log_id_,
+                    std::move(payload),
+                    snapshot_append_timeout_,
+                    std::move(cb));
+}
+
+template <typename T, typename D>
+std::string ReplicatedStateMachine<T, D>::maybeCreateDeltaSnapshotPayload(
+    bool rsm_include_read_pointer_in_snapshot) {
+  if (max_delta_snapshots_ == 0 || !rsm_include_read_pointer_in_snapshot) {
+    return std::string();
+  }
+  if (chain_delta_log_read_ptr_ == LSN_INVALID ||
+      num_delta_snapshots_since_base_ >= max_delta_snapshots_) {
+    // No snapshot to extend, or time to compact the chain into a new base.
+    return std::string();
+  }
+  if (retained_deltas_from_ == LSN_INVALID ||
+      retained_deltas_from_ > chain_delta_log_read_ptr_ ||
+      state_delta_read_ptr_ < chain_delta_log_read_ptr_ ||
+      waiting_for_snapshot_ != LSN_INVALID) {
+    // We don't have all the deltas since the last snapshot.
+    return std::string();
+  }
+
+  RSMDeltaSnapshot snapshot;
+  snapshot.prev_delta_log_read_ptr = chain_delta_log_read_ptr_;
+  for (const RSMDeltaSnapshot::Delta& d : retained_deltas_) {
+    if (d.lsn > chain_delta_log_read_ptr_) {
+      snapshot.deltas.push_back(d);
+    }
+  }
+
+  std::string payload =
+      createDeltaSnapshotPayload(snapshot, version_, state_delta_read_ptr_);
+  if (delta_snapshot_bytes_since_base_ + payload.size() >=
+      last_base_snapshot_size_) {
+    // Reading the chain would cost more than reading a new base.
+    return std::string();
+  }
+  return payload;
 }
 
 template <typename T, typename D>
@@ -1263,6 +1868,13 @@ void ReplicatedStateMachine<T, D>::getDebugInfo(
   table.set<11>(numBytesSinceLastSnapshot());
   table.set<12>(numDeltaRecordsSinceLastSnapshot());
   table.set<13>(delta_read_stream_is_healthy_);
+  if (snapshot_sync_duration_ != std::chrono::milliseconds::max()) {
+    table.set<14>(snapshot_sync_duration_.count());
+  }
+  if (delta_sync_duration_ != std::chrono::milliseconds::max()) {
+    table.set<15>(delta_sync_duration_.count());
+  }
+  table.set<16>(deltas_replayed_);
 }
 
 }} // namespace facebook::logdevice
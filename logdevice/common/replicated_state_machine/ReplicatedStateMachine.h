@@ -8,14 +8,18 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
 #include <list>
+#include <map>
 #include <memory>
+#include <vector>
 #include <zstd.h>
 
 #include <boost/functional/hash.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/Function.h>
 #include <folly/IntrusiveList.h>
 #include <folly/Memory.h>
 #include <folly/Optional.h>
@@ -27,6 +31,7 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Semaphore.h"
 #include "logdevice/common/SyncSequencerRequest.h"
+#include "logdevice/common/Timestamp.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/WorkerCallbackHelper.h"
 #include "logdevice/common/client_read_stream/AllClientReadStreams.h"
@@ -35,7 +40,9 @@
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/replicated_state_machine/RSMDeltaSnapshot.h"
 #include "logdevice/common/replicated_state_machine/RSMSnapshotHeader.h"
+#include "logdevice/common/replicated_state_machine/RSMSnapshotManifest.h"
 #include "logdevice/common/replicated_state_machine/ReplicatedStateMachine-enum.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/types_internal.h"
@@ -85,6 +92,13 @@
  * records/bytes that are in the delta log but have never been snapshotted. The
  * user relies on this information to decide when to create a new snapshot.
  *
+ * Snapshots may be full (base) snapshots or delta snapshots (see
+ * setMaxDeltaSnapshots()). A delta snapshot only contains the delta records
+ * read since the previous snapshot, so that state machines with a large state
+ * but a small update rate don't write the whole state each time. On startup,
+ * the last base snapshot and the delta snapshots written after it are
+ * applied in order.
+ *
  * If this state machine misses data when reading the delta log (because it sees
  * a DATALOSS or TRIM gap), it will stall until a snapshot record is received
  * for a version past the higher end of that gap. If the gap was a TRIM gap,
@@ -250,6 +264,23 @@ class ReplicatedStateMachine {
     can_skip_bad_snapshot_ = val;
   }
 
+  /**
+   * Allow snapshot() to write up to `max' delta snapshots (see
+   * RSMDeltaSnapshot) after each base snapshot. A base snapshot is written
+   * instead if the delta snapshots written since the last base would add up to
+   * more bytes than it, or if this state machine doesn't have all the deltas
+   * since the last snapshot (e.g. because it just started). 0 (the default)
+   * means only base snapshots are written. Requires the
+   * rsm-include-read-pointer-in-snapshot setting.
+   *
+   * Delta snapshots are always understood when reading, regardless of this
+   * option. Older binaries that don't understand them should be upgraded
+   * before using it.
+   */
+  void setMaxDeltaSnapshots(size_t max) {
+    max_delta_snapshots_ = max;
+  }
+
   /**
    * Start reading the snapshot and delta logs.
    * Must be called on a worker thread.
@@ -421,10 +452,20 @@ class ReplicatedStateMachine {
   void onGotSnapshotLogTailLSN(Status st, lsn_t start, lsn_t lsn);
 
   // Create a payload for a snapshot. The payload includes `data` serialized as
-  // well as the version of that snapshot.
+  // well as the version of that snapshot. If `compress` is false, the payload
+  // is left uncompressed even if snapshot compression is enabled, for the
+  // caller to pass to compressSnapshotPayload().
   std::string createSnapshotPayload(const T& data,
                                     lsn_t version,
-                                    bool rsm_include_read_pointer_in_snapshot);
+                                    bool rsm_include_read_pointer_in_snapshot,
+                                    bool compress = true);
+
+  // Create a payload for a delta snapshot containing `snapshot', which brings
+  // the state to `version' and accounts for the delta log up to
+  // `delta_log_read_ptr'.
+  std::string createDeltaSnapshotPayload(const RSMDeltaSnapshot& snapshot,
+                                         lsn_t version,
+                                         lsn_t delta_log_read_ptr);
 
   // Some metadata included inside delta records.
   struct DeltaHeader {
@@ -477,8 +518,9 @@ class ReplicatedStateMachine {
   // Start a SyncSequencerRequest to find the tail lsn of the snapshot log.
   virtual void getSnapshotLogTailLSN();
 
-  // Called once we have retrieved the base snapshot to apply delta onto. Issues
-  // a SyncSequencerRequest to find the tail lsn of the delta log.
+  // Issues a SyncSequencerRequest to find the tail lsn of the delta log. On
+  // startup this is done while the snapshot log is being read, see
+  // prefetched_delta_sync_.
   virtual void getDeltaLogTailLSN();
 
   // Utility function for creating a read stream for the delta and snapshot
@@ -612,6 +654,7 @@ class ReplicatedStateMachine {
   std::chrono::milliseconds confirm_timeout_{std::chrono::seconds{5}};
   bool snapshot_compression_{false};
   bool can_skip_bad_snapshot_{false};
+  size_t max_delta_snapshots_{0};
   std::chrono::milliseconds stalled_grace_period_{std::chrono::seconds{30}};
   std::chrono::milliseconds snapshotting_grace_period_{
       std::chrono::minutes{10}};
@@ -626,11 +669,117 @@ class ReplicatedStateMachine {
                           std::unique_ptr<T>& out,
                           RSMSnapshotHeader& header) const;
 
+  // Same for a delta snapshot record.
+  int deserializeDeltaSnapshot(const DataRecord& record,
+                               RSMDeltaSnapshot& out,
+                               RSMSnapshotHeader& header) const;
+
+  // Deserialize the header of a snapshot record and decompress its payload if
+  // needed. `out' points either inside the record or inside `buf'.
+  int decodeSnapshotPayload(const DataRecord& record,
+                            RSMSnapshotHeader& header,
+                            std::unique_ptr<uint8_t[]>& buf,
+                            Payload& out) const;
+
+  // Serialize `header' followed by a body of `body_size' bytes written by
+  // `write_body', compressed if both snapshot_compression_ and `compress' are
+  // set.
+  std::string
+  encodeSnapshotPayload(RSMSnapshotHeader header,
+                        size_t body_size,
+                        folly::FunctionRef<void(uint8_t* buf)> write_body,
+                        bool compress = true);
+
+  // Compress the body of `payload', a snapshot record encoded without
+  // compression, and set the ZSTD_COMPRESSION flag in its header. Returns an
+  // empty string on error. Doesn't touch the state machine, so that snapshot()
+  // can run it on the CPU offload pool.
+  static std::string compressSnapshotPayload(RSMType rsm_type,
+                                             const std::string& payload);
+
+  // Returns true if `record' is a snapshot record with the DELTA_SNAPSHOT
+  // flag, without deserializing the payload.
+  static bool isDeltaSnapshot(const DataRecord& record);
+
+  // Called by processSnapshot() for delta snapshots. Applies the deltas it
+  // contains if it extends a state we have and brings it further. Returns
+  // false if we should not be fast forwarding right now. Sets `ok' to whether
+  // the record could be deserialized.
+  bool applyDeltaSnapshot(const DataRecord& record,
+                          RSMSnapshotHeader& header,
+                          bool& ok);
+
+  // Called by processSnapshot() for base snapshots, same contract as
+  // applyDeltaSnapshot().
+  bool applyBaseSnapshot(const DataRecord& record,
+                         RSMSnapshotHeader& header,
+                         bool& ok);
+
+  // Process the snapshot records buffered while syncing the snapshot log: the
+  // last base snapshot and the delta snapshots after it.
+  bool processBufferedSnapshots();
+
+  // Called by onSnapshotRecord() for a chunk record or a manifest record that
+  // could not be reassembled. Such a record is not a snapshot but may still be
+  // the last record before snapshot_sync_.
+  bool onNonSnapshotRecord(const DataRecord& record);
+
+  // Replaces `record', the manifest of a chunked snapshot, with a record
+  // holding the snapshot it describes, built from snapshot_chunks_, and sets
+  // `manifest'. Returns false if some chunks are missing or corrupted.
+  bool reassembleChunkedSnapshot(std::unique_ptr<DataRecord>& record,
+                                 RSMSnapshotManifest& manifest);
+
+  // Removes from snapshot_chunks_ the chunks listed by `manifest' and older
+  // ones.
+  void dropSnapshotChunks(const RSMSnapshotManifest& manifest);
+
+  // State of a snapshot being written as chunks.
+  struct ChunkedSnapshotWrite {
+    RSMSnapshotHeader header;
+    // Body of the snapshot, after compression if any.
+    std::string body;
+    size_t chunk_size;
+    // Offset in `body' of the next chunk to append.
+    size_t next_offset{0};
+    RSMSnapshotManifest manifest;
+    // Called with the status and lsn of the manifest record.
+    std::function<void(Status, lsn_t)> cb;
+  };
+
+  // Appends the next chunk of `write', or its manifest if all chunks have been
+  // appended.
+  void writeSnapshotChunks(std::shared_ptr<ChunkedSnapshotWrite> write);
+
+  // Called once data_ accounts for the delta log up to `read_ptr' thanks to a
+  // snapshot. Deltas retained for the next delta snapshot are dropped as the
+  // snapshot has them.
+  void onStateAdvancedBySnapshot(lsn_t read_ptr);
+
+  // Second half of snapshot(): appends `payload', once compressed if needed,
+  // to the snapshot log. The other arguments are the state of the delta log
+  // when snapshot() was called.
+  void appendSnapshot(std::string payload,
+                      bool include_read_ptr,
+                      size_t byte_offset_at_time_of_snapshot,
+                      size_t offset_at_time_of_snapshot,
+                      lsn_t read_ptr_at_time_of_snapshot,
+                      std::function<void(Status st)> cb);
+
+  // Builds the payload of a delta snapshot extending the last snapshot, or
+  // returns an empty string if a base snapshot should be written instead.
+  std::string
+  maybeCreateDeltaSnapshotPayload(bool rsm_include_read_pointer_in_snapshot);
+
+  // Called when chain_delta_log_read_ptr_ moves forward. Drops the retained
+  // deltas that the snapshot log already has.
+  void pruneRetainedDeltas();
+
   // Called by `onSnapshotRecord()` or `onSnapshotGap()` when we have reached
   // the tail lsn `snapshot_sync_` of the snapshot log. When this
   // function is called, we have the base snapshot to apply deltas onto, so it's
   // time to read the delta log.
-  // Calls getDeltaLogTailLSN().
+  // Uses the delta log tail lsn fetched by start() if we already have it.
   void onBaseSnapshotRetrieved();
 
   // When we are tailing, we may receive a new snapshot record. Applying that
@@ -692,6 +841,14 @@ class ReplicatedStateMachine {
   // snapshot log reaches snapshot_sync_.
   std::unique_ptr<DataRecord> last_snapshot_record_;
 
+  // Delta snapshot records read after last_snapshot_record_ while syncing the
+  // snapshot log, processed after it.
+  std::vector<std::unique_ptr<DataRecord>> buffered_delta_snapshots_;
+
+  // Chunk records of snapshots written with --rsm-snapshot-chunk-size, kept
+  // until we read the manifest listing them.
+  std::map<lsn_t, std::unique_ptr<DataRecord>> snapshot_chunks_;
+
   // LSN of the tail of the delta log computed once we have found the base
   // snapshot (if any). We notify subscribers of the initial state once we have
   // read the delta log past this lsn.
@@ -707,6 +864,29 @@ class ReplicatedStateMachine {
   // skip reading deltas already applied and skip gaps).
   lsn_t last_snapshot_last_read_ptr_{LSN_OLDEST};
 
+  // Delta log read pointer up to which `data_' accounts for every delta. Same
+  // as delta_read_ptr_ unless we are stalling because we skipped data, or a
+  // snapshot got us past it.
+  lsn_t state_delta_read_ptr_{LSN_OLDEST};
+
+  // The following are used to decide whether snapshot() can write a delta
+  // snapshot, @see setMaxDeltaSnapshots():
+  // - Delta log read pointer of the most recent snapshot (base or delta) seen
+  //   in the snapshot log or written by us, LSN_INVALID if none. A new delta
+  //   snapshot extends that snapshot.
+  lsn_t chain_delta_log_read_ptr_{LSN_INVALID};
+  // - Number of delta snapshots after the last base snapshot, and their size.
+  size_t num_delta_snapshots_since_base_{0};
+  size_t delta_snapshot_bytes_since_base_{0};
+  // - Size of the last base snapshot.
+  size_t last_base_snapshot_size_{0};
+  // - Deltas read from the delta log after retained_deltas_from_, up to
+  //   state_delta_read_ptr_. Only kept if max_delta_snapshots_ > 0.
+  //   retained_deltas_from_ is LSN_INVALID if we skipped some deltas and
+  //   cannot write a delta snapshot until a snapshot gets us past them.
+  std::deque<RSMDeltaSnapshot::Delta> retained_deltas_;
+  lsn_t retained_deltas_from_{LSN_OLDEST};
+
   // Current state of the process of syncing our local version to the last
   // version prior to this state machine starting.
   // SYNC_SNAPSHOT: we are issuing a SyncSequencerRequest to find the tail LSN
@@ -722,6 +902,25 @@ class ReplicatedStateMachine {
   enum SyncState { SYNC_SNAPSHOT, SYNC_DELTAS, TAILING };
   SyncState sync_state_{SyncState::SYNC_SNAPSHOT};
 
+  // The tail lsn of the delta log doesn't depend on the snapshot, so start()
+  // looks it up while the snapshot log is being read, saving a sequencer round
+  // trip (possibly including a sequencer activation) on startup. If it comes
+  // back before we're done with the snapshot log, it's kept here until
+  // onBaseSnapshotRetrieved().
+  bool delta_tail_prefetch_in_flight_{false};
+  lsn_t prefetched_delta_sync_{LSN_INVALID};
+
+  // Startup profiling, reported by getDebugInfo().
+  SteadyTimestamp start_time_;
+  // How long it took to get the base snapshot and then to replay the delta log
+  // up to delta_sync_. max() until the stage completes.
+  std::chrono::milliseconds snapshot_sync_duration_{
+      std::chrono::milliseconds::max()};
+  std::chrono::milliseconds delta_sync_duration_{
+      std::chrono::milliseconds::max()};
+  // Number of deltas read while in SYNC_DELTAS.
+  size_t deltas_replayed_{0};
+
   // Local copy of the state. Updated when we receive a new snapshot with
   // version greater than `version_` or when we receive a new delta and that
   // delta can be applied.
@@ -19,6 +19,7 @@
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamBufferFactory.h"
 #include "logdevice/common/replicated_state_machine/RSMSnapshotHeader.h"
+#include "logdevice/common/replicated_state_machine/RSMSnapshotManifest.h"
 #include "logdevice/common/replicated_state_machine/logging.h"
 
 namespace facebook { namespace logdevice {
@@ -139,7 +140,26 @@ void TrimRSMRequest::snapshotFindTimeCallback(Status st, lsn_t lsn) {
   auto record_callback = [&](std::unique_ptr<DataRecord>& record) {
     // We want to find the last snapshot record in the snapshot log.
     // We will keep that last snapshot and trim everything that is older than
-    // it.
+    // it, or than the base snapshot it builds upon if it's a delta snapshot.
+    // For a snapshot written in chunks, the manifest stands for the snapshot
+    // but its chunks need to be kept along with it.
+    RSMSnapshotHeader hdr;
+    const int hdr_sz = RSMSnapshotHeader::deserialize(record->payload, hdr);
+    if (hdr_sz >= 0 && (hdr.flags & RSMSnapshotHeader::SNAPSHOT_CHUNK)) {
+      return true;
+    }
+    if (hdr_sz < 0 || !(hdr.flags & RSMSnapshotHeader::DELTA_SNAPSHOT)) {
+      last_seen_base_snapshot_lsn_ = record->attrs.lsn;
+      RSMSnapshotManifest manifest;
+      if (hdr_sz >= 0 && (hdr.flags & RSMSnapshotHeader::CHUNKED) &&
+          RSMSnapshotManifest::deserialize(
+              Payload(static_cast<const char*>(record->payload.data()) +
+                          hdr_sz,
+                      record->payload.size() - hdr_sz),
+              manifest) == 0) {
+        last_seen_base_snapshot_lsn_ = manifest.chunks.front().lsn;
+      }
+    }
     last_seen_snapshot_ = std::move(record);
     return true;
   };
@@ -219,6 +239,19 @@ void TrimRSMRequest::snapshotFindTimeCallback(Status st, lsn_t lsn) {
 void TrimRSMRequest::trimSnapshotLog() {
   ld_check(last_seen_snapshot_);
   min_snapshot_lsn_ = last_seen_snapshot_->attrs.lsn;
+  if (!trim_everything_ && last_seen_base_snapshot_lsn_ != min_snapshot_lsn_) {
+    if (last_seen_base_snapshot_lsn_ == LSN_INVALID) {
+      // Only delta snapshots, whose base was already trimmed. Be conservative
+      // and don't trim more of the snapshot log.
+      rsm_warning(rsm_type_,
+                  "Last snapshot with lsn %s is a delta snapshot but no base "
+                  "snapshot was found before it. Not trimming snapshot log.",
+                  lsn_to_string(min_snapshot_lsn_).c_str());
+      min_snapshot_lsn_ = LSN_OLDEST;
+    } else {
+      min_snapshot_lsn_ = last_seen_base_snapshot_lsn_;
+    }
+  }
   if (trim_everything_) {
     min_snapshot_version_ = LSN_MAX;
     snapshot_delta_read_ptr_ = LSN_MAX;
@@ -33,7 +33,9 @@
  *      - min_snapshot_lsn_ is the lsn of the last snapshot;
  *      - snapshot_read_ptr_ is the delta log read pointer at the time we took
  *        a snapshot;
- * 3/ trim snapshot log up to min_snapshot_lsn_ - 1
+ * 3/ trim snapshot log up to min_snapshot_lsn_ - 1. If the last snapshot is a
+ *    delta snapshot, min_snapshot_lsn_ is the lsn of the base snapshot it
+ *    builds upon instead so that the chain remains readable.
  * 4/ f=findTime(delta_log_id, NOW-retention)
  * 5/ trim delta log up to min(f - 1, snapshot_read_ptr_ - 1)
  */
@@ -118,8 +120,12 @@ class TrimRSMRequest : public Request {
   const std::chrono::milliseconds findtime_timeout_;
   const std::chrono::milliseconds trim_timeout_;
 
-  // Oldest snapshot we want to keep.
+  // Last snapshot, its delta log read pointer says which deltas we can trim.
   std::unique_ptr<DataRecord> last_seen_snapshot_;
+  // Lsn of the last base (not delta) snapshot seen while reading the snapshot
+  // log, or of its first chunk if it was written in chunks. This is the oldest
+  // snapshot we want to keep.
+  lsn_t last_seen_base_snapshot_lsn_{LSN_INVALID};
   // Lsn of the oldest snapshot we want to keep.
   lsn_t min_snapshot_lsn_{LSN_INVALID};
   // Version of the oldest snapshot we want to keep.
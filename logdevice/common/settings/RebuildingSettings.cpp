@@ -112,6 +112,24 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "locality of rebuilding writes.",
        SERVER | EXPERIMENTAL,
        SettingsCategory::Rebuilding);
+  init("rebuilding-donor-takeover-lag",
+       &donor_takeover_lag,
+       "max",
+       [](std::chrono::milliseconds val) {
+         if (val.count() <= 0) {
+           throw boost::program_options::error(
+               "rebuilding-donor-takeover-lag must be positive");
+         }
+       },
+       "If a donor's progress reported in the event log is more than this far "
+       "behind the timestamp of a record it is the first donor for, the next "
+       "donor in the record's copyset rebuilds the record instead, and the "
+       "lagging donor skips it once it sees that the other donor got past "
+       "it. Lets fast donors take work from the slowest one. Only has effect "
+       "when --rebuilding-global-window is set, since donors don't report "
+       "progress otherwise, and should be smaller than it. 'max' disables.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Rebuilding);
   init("rebuilding-max-batch-bytes",
        &max_batch_bytes,
        "10M",
@@ -170,7 +188,7 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
   init(
       "rebuilding-max-get-seq-state-in-flight",
       &max_get_seq_state_in_flight,
-      "100",
+      "1000",
       [](size_t val) {
         if ((ssize_t)val <= 0) {
           throw boost::program_options::error("rebuilding-max-get-seq-state-in-"
@@ -181,7 +199,9 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
       "donor node can have in flight at the same time. Every storage node "
       "participating in rebuilding gets the sequencer state for all logs "
       "residing on that node before beginning to re-replicate records. This is "
-      "done in order to determine the LSN at which to stop rebuilding the log.",
+      "done in order to determine the LSN at which to stop rebuilding the log. "
+      "Requests headed to the same sequencer node are batched, see "
+      "--seq-state-batching-window.",
       SERVER,
       SettingsCategory::Rebuilding);
   init("rebuilding-planner-sync-seq-retry-interval",
@@ -214,6 +234,26 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "for rebuilding v1, disable for rebuilding v2.",
        SERVER,
        SettingsCategory::Rebuilding);
+  init("rebuilding-readahead-size",
+       &readahead_size,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If positive, iterators used by rebuilding reads read this many bytes "
+       "ahead from SST files instead of one block at a time. 0 leaves "
+       "readahead up to RocksDB.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-read-parallelism",
+       &read_parallelism,
+       "1",
+       parse_positive<size_t>(),
+       "Number of independent read pipelines (iterator, storage task and read "
+       "buffer) a donor shard uses in rebuilding v2. Logs of the shard are "
+       "split among the pipelines, and all of them feed the same set of chunk "
+       "rebuildings, subject to the same local window, rate limit and "
+       "in-flight limits. Takes effect for new shard rebuildings.",
+       SERVER,
+       SettingsCategory::Rebuilding);
   init("rebuilding-checkpoint-interval-mb",
        &checkpoint_interval_mb,
        "100",
@@ -423,7 +463,8 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        },
        "Time for which LogRebuilding/RebuidlingCoordinator will wait for "
        "pending records to be durable before restarting the rebuilding for "
-       "the log.",
+       "the log. Also used by ChunkRebuilding, which rebuilds the chunk "
+       "again if its records aren't durable in time.",
        SERVER | EXPERIMENTAL,
        SettingsCategory::Rebuilding);
   init(
@@ -513,6 +554,29 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "Enables a new implementation of rebuilding. The old one is deprecated.",
        SERVER,
        SettingsCategory::Rebuilding);
+  init("rebuilding-block-stores",
+       &block_stores,
+       "false",
+       nullptr,
+       "If true, rebuilding sends the STOREs for a chunk of consecutive "
+       "records written with the same sticky copyset, to each recipient "
+       "together, in MULTI_STORE messages of up to --store-batching-max-bytes, "
+       "instead of one STORE per record. The recipient usually writes such a "
+       "batch in a single local log store write batch. Only used for nodes "
+       "that support it. Rebuilding v2 only.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-block-amends",
+       &block_amends,
+       "false",
+       nullptr,
+       "Same as --rebuilding-block-stores but for the amends that rebuilding "
+       "sends to the other members of the new copyset once a record is "
+       "stored. The amends of a chunk are sent once the STOREs of all its "
+       "records have succeeded, grouped by recipient into MULTI_STORE "
+       "messages. Retries are still per record. Rebuilding v2 only.",
+       SERVER,
+       SettingsCategory::Rebuilding);
   init("rebuilding-rate-limit",
        &rate_limit,
        "unlimited",
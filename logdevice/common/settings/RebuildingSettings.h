@@ -40,6 +40,7 @@ struct RebuildingSettings : public SettingsBundle {
   std::chrono::milliseconds local_window;
   bool local_window_uses_partition_boundary;
   std::chrono::milliseconds global_window;
+  std::chrono::milliseconds donor_takeover_lag;
   std::chrono::milliseconds planner_scheduling_delay;
   size_t max_batch_bytes;
   std::chrono::milliseconds max_batch_time;
@@ -48,6 +49,8 @@ struct RebuildingSettings : public SettingsBundle {
   size_t max_amends_in_flight;
   size_t max_logs_in_flight;
   bool use_rocksdb_cache;
+  size_t readahead_size;
+  size_t read_parallelism;
   RebuildingReadOnlyOption read_only;
   size_t checkpoint_interval_mb;
   double total_log_rebuilding_size_per_shard_mb;
@@ -69,6 +72,8 @@ struct RebuildingSettings : public SettingsBundle {
   bool allow_conditional_rebuilding_restarts;
   bool test_stall_rebuilding;
   bool enable_v2;
+  bool block_stores;
+  bool block_amends;
   std::chrono::milliseconds rebuilding_restarts_grace_period;
   std::chrono::seconds record_durability_timeout;
   std::chrono::milliseconds auto_mark_unrecoverable_timeout;
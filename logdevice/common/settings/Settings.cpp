@@ -126,6 +126,16 @@ static std::unordered_set<logid_t> parse_log_set(const std::string& value) {
   return res;
 }
 
+static std::vector<logid_t> parse_log_intervals(const std::string& value) {
+  std::vector<logid_t> res;
+  if (parse_logid_intervals(value.c_str(), &res) != 0) {
+    throw boost::program_options::error(
+        "Invalid list of log IDs \"" + value +
+        "\", expected a comma-separated list of IDs and ranges like 1..10");
+  }
+  return res;
+}
+
 static Status validate_reject_hello(const std::string& value) {
   if (value == "ACCESS") {
     return E::ACCESS;
@@ -240,12 +250,15 @@ static int parse_scd_copyset_reordering(const std::string& val) {
     return 1;
   } else if (val == "hash-shuffle-client-seed") {
     return 2;
+  } else if (val == "hash-shuffle-lsn-block-rotation") {
+    return 3;
   } else {
     std::array<char, 1024> buf;
     snprintf(buf.data(),
              buf.size(),
              "Invalid value for --scd-copyset-ordering-max: %s. "
-             "Expected one of: none, hash-shuffle, hash-shuffle-client-seed",
+             "Expected one of: none, hash-shuffle, hash-shuffle-client-seed, "
+             "hash-shuffle-lsn-block-rotation",
              val.c_str());
     throw boost::program_options::error(std::string(buf.data()));
   }
@@ -451,6 +464,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "per CPU core",
        SERVER | CLIENT | REQUIRES_RESTART /* used in Processor ctor */,
        SettingsCategory::Execution);
+  init("numa-aware-placement",
+       &numa_aware_placement,
+       "false",
+       nullptr, // no validation
+       "(server-only setting) Pin the storage threads of each shard to the "
+       "CPUs of the NUMA node that the shard's disk is attached to, and "
+       "spread worker threads evenly across NUMA nodes, so that the memory "
+       "they allocate stays local. No effect on hosts with a single NUMA "
+       "node.",
+       SERVER | REQUIRES_RESTART /* used in Processor and
+                                    ShardedStorageThreadPool ctors */,
+       SettingsCategory::Execution);
   init("trace-db-shard",
        &trace_db_shard,
        "-1",
@@ -465,6 +490,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "enable I/O tracing on all database shards",
        SERVER | REQUIRES_RESTART, /* used in ShardedRocksDBLocalLogStore ctor */
        SettingsCategory::Monitoring);
+  init("enable-perf-counters",
+       &enable_perf_counters,
+       "false",
+       nullptr, // no validation
+       "Read hardware and kernel performance counters (cycles, instructions, "
+       "last level cache misses, context switches) with perf_event_open() "
+       "around every request, message callback and storage task, and add "
+       "them up in perf_* stats by kind of work. Shown by the 'stats perf' "
+       "admin command. Costs two read() syscalls per unit of work.",
+       SERVER | CLIENT | REQUIRES_RESTART /* opened when threads start */,
+       SettingsCategory::Monitoring);
   init("msg-error-injection-chance",
        &message_error_injection_chance_percent,
        "0",
@@ -505,6 +541,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "apply it to existing sockets, only to newly created ones",
        SERVER | CLIENT,
        SettingsCategory::Network);
+  init("sendbuf-adaptive",
+       &tcp_sendbuf_adaptive,
+       "false",
+       nullptr, // no validation
+       "Resize the sendbuf of each TCP connection, at most once a second, to "
+       "twice its bandwidth-delay product as estimated by the kernel "
+       "(congestion window times MSS). Bounded by --sendbuf-kb if set, and "
+       "by 4MB otherwise. Works best with --notsent-lowat-kb.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
   init(
       "rcvbuf-kb",
       &tcp_rcvbuf_kb,
@@ -524,6 +570,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "ones",
       SERVER | CLIENT,
       SettingsCategory::Network);
+  init("notsent-lowat-kb",
+       &tcp_notsent_lowat_kb,
+       "-1",
+       parse_validate_lower_bound<ssize_t>(-1),
+       "TCP_NOTSENT_LOWAT of TCP sockets in KB: limit on unsent bytes in the "
+       "kernel send buffer, so that the rest stays in the output evbuffer "
+       "and high-priority messages don't wait behind bulk data already "
+       "handed to the kernel. -1 keeps the system default. Changing this "
+       "setting on-the-fly will not apply it to existing sockets, only to "
+       "newly created ones",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
   init(
       "outbuf-kb",
       &outbuf_overflow_kb,
@@ -534,6 +592,44 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "only to newly created ones", // TODO (t13429319): fix this
       SERVER | CLIENT,
       SettingsCategory::Network);
+  init("socket-coalesce-max-message-size",
+       &socket_coalesce_max_message_size,
+       "0",
+       nullptr, // no validation
+       "If positive, messages of at most this many bytes (including the "
+       "protocol header) are serialized back-to-back into a contiguous "
+       "per-socket buffer, with the checksum computed on that copy, and "
+       "moved into the socket's output buffer together at the end of the "
+       "event loop iteration. Saves the per-message evbuffer allocations when "
+       "many small messages such as STORED, WINDOW or RELEASE go to the same "
+       "peer. 0 disables coalescing.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("socket-compression-boundary",
+       &socket_compression_boundary,
+       "none",
+       nullptr, // no validation
+       "Compress cross-X traffic on data connections, where X is the "
+       "setting. Example: if set to \"region\", messages sent to peers in "
+       "other regions are batched once per event loop iteration and "
+       "compressed with zstd, using a streaming context per connection. Can "
+       "be one of \"none\", \"node\", \"rack\", \"row\", \"cluster\", "
+       "\"data_center\" or \"region\". Both ends must support the "
+       "protocol version introducing compressed frames. Clients need "
+       "--my-location for their connections to be compressed. See the "
+       "compression stats of the flow group with the peer's scope to check "
+       "the CPU spent per byte saved.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("socket-compression-level",
+       &socket_compression_level,
+       "1",
+       nullptr, // no validation
+       "zstd compression level for connections compressed because of "
+       "--socket-compression-boundary. Applies to connections established "
+       "after the change.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
   init("output-max-records-kb",
        &output_max_records_kb,
        "1024",
@@ -573,6 +669,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "amount of RECORD data to read from local log store at once",
        SERVER,
        SettingsCategory::ReadPath);
+  init("read-storage-task-max-batch-size",
+       &read_storage_task_max_batch_size,
+       "1",
+       parse_positive<ssize_t>(),
+       "Maximum number of read storage tasks of different read streams on the "
+       "same shard that a worker groups into a single storage task. The reads "
+       "of a batch are done back to back on one storage thread, in the order "
+       "of the (log id, lsn) keys they start at. Tasks are only batched with "
+       "tasks created in the same event loop iteration. 1 disables batching.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("max-record-read-execution-time",
        &max_record_read_execution_time,
        "1s",
@@ -580,6 +687,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Maximum execution time for reading records. 'max' means no limit.",
        SERVER | EXPERIMENTAL,
        SettingsCategory::ResourceManagement);
+  init("read-storage-tasks-preempt-after",
+       &read_storage_tasks_preempt_after,
+       "max",
+       validate_nonnegative<ssize_t>(),
+       "A read storage task (e.g. catch-up reads) that has been reading for "
+       "at least this long stops at the next record boundary if tasks of "
+       "higher priority (e.g. findKey) are waiting for the same storage "
+       "threads, and returns a partial batch. The read continues in a new "
+       "task. This bounds head-of-line blocking of urgent tasks behind big "
+       "read batches. 'max' disables preemption.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ResourceManagement);
   init("read-requests",
        &requests_from_pipe,
        "128",
@@ -634,6 +753,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "a request to run FlowGroups and Sender::runFlowGroups() executing.",
        SERVER,
        SettingsCategory::ResourceManagement);
+  init("traffic-shaping-adaptive",
+       &traffic_shaping_adaptive,
+       "false",
+       nullptr, // no validation
+       "If true, the bandwidth of the shared priority queue bucket of each "
+       "traffic shaping scope is lent to priorities that have messages "
+       "waiting for bandwidth while the scope has unused bandwidth, and "
+       "taken back when higher priorities need it. Each priority still gets "
+       "at least its configured guaranteed bandwidth and at most its "
+       "configured maximum bandwidth.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ResourceManagement);
   init("read-messages",
        &incoming_messages_max_per_socket,
        "128",
@@ -685,6 +816,20 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "(max_record_cache_snapshot_bytes / num_shards).",
        SERVER,
        SettingsCategory::Recovery);
+  init("record-cache-inline-payload-max-bytes",
+       &record_cache_inline_payload_max_bytes,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "Records whose payload is at most this many bytes are copied into the "
+       "same allocation as their record cache entry, instead of keeping a "
+       "reference to the payload of the STORE message. This avoids a separate "
+       "payload holder and its reference count per cached record, and keeps "
+       "small records from pinning the larger network buffers they arrived "
+       "in, so the record cache budget is not used up by bookkeeping for logs "
+       "with small records. Such entries are freed in one deallocation when "
+       "evicted. 0 disables inlining.",
+       SERVER,
+       SettingsCategory::Recovery);
   init("record-cache-monitor-interval",
        &record_cache_monitor_interval,
        // use 2s by default since we can only receive 2.5GB in 2 sec over a
@@ -696,6 +841,29 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "size of the record cache.",
        SERVER,
        SettingsCategory::Recovery);
+  init("record-cache-snapshot-file",
+       &record_cache_snapshot_file,
+       "false",
+       nullptr, // no validation
+       "On shutdown, persist record caches to a file in the shard's directory "
+       "instead of to snapshot blobs in the local log store. On startup the "
+       "file is mmap'ed and cached payloads reference it directly instead of "
+       "being copied, which makes repopulating large record caches faster and "
+       "lets the kernel page out payloads that are not being read.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Recovery);
+  init("recovery-digest-prefetch-max-bytes",
+       &recovery_digest_prefetch_max_bytes,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If positive, when the failure detector declares a node dead, each "
+       "storage shard reads ahead up to this many bytes of the unclean records "
+       "of logs whose sequencer was running on that node, so that the SEALs "
+       "and digests of the log recoveries that follow find them in the local "
+       "log store's caches. Logs whose unclean epoch is in the record cache "
+       "are skipped. 0 disables prefetching.",
+       SERVER,
+       SettingsCategory::Recovery);
 
   init("abort-on-failed-check",
        &abort_on_failed_check,
@@ -736,6 +904,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Should we print backtrace of stalled workers.",
        SERVER | CLIENT,
        SettingsCategory::Monitoring);
+  init("watchdog-stall-samples",
+       &watchdog_stall_samples,
+       "4",
+       nullptr, // no validation
+       "Number of stack traces to sample from each stalled worker thread "
+       "every time watchdog finds it stalled, along with the request or "
+       "message it was processing. The samples are kept in memory and shown "
+       "by the 'info stalls' admin command. 0 disables sampling.",
+       SERVER,
+       SettingsCategory::Monitoring);
   init("watchdog-bt-ratelimit",
        &watchdog_bt_ratelimit,
        "10/120s",
@@ -834,6 +1012,37 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "never send a wave of STORE messages through a chain",
        SERVER,
        SettingsCategory::WritePath);
+  init("store-batching-window",
+       &store_batching_window,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, sequencers hold STORE messages for up to this long and "
+       "send the ones headed to the same storage node together, in one "
+       "MULTI_STORE message. Only used for nodes that support it. Trades a "
+       "little append latency for fewer messages and write batches under "
+       "high append rates. 0 disables batching.",
+       SERVER,
+       SettingsCategory::WritePath);
+  init("store-batching-max-bytes",
+       &store_batching_max_bytes,
+       "256K",
+       parse_validate_range<size_t>(1, MAX_PAYLOAD_SIZE_PUBLIC / 4),
+       "When --store-batching-window is enabled, STOREs of at least this "
+       "many bytes are sent right away, and a batch of STOREs to a storage "
+       "node is sent as soon as it reaches this size.",
+       SERVER,
+       SettingsCategory::WritePath);
+  init("sequencer-admission-batch-size",
+       &sequencer_admission_batch_size,
+       "1",
+       parse_positive<size_t>(),
+       "If greater than 1, appends to the same log that a Worker receives in "
+       "one event loop iteration are given a range of consecutive LSNs at "
+       "once, up to this many per range, instead of one by one. Reduces "
+       "contention between Workers on the sequencer of a log with a very "
+       "high append rate. 1 disables batching.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("sbr-low-watermark-check-interval",
        &sbr_low_watermark_check_interval,
        "60s",
@@ -1027,6 +1236,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Use DRR for scheduling read IO's.",
        SERVER | REQUIRES_RESTART,
        SettingsCategory::Storage);
+  init("storage-tasks-work-stealing",
+       &storage_tasks_work_stealing,
+       "false",
+       nullptr,
+       "Allow idle storage threads to execute tasks queued for other thread "
+       "types. 'slow' threads may pick up tasks queued for 'fast' and "
+       "'default' threads, and 'default' threads may pick up tasks queued for "
+       "'fast' threads. 'fast' threads never run tasks of other types, so "
+       "they never block on reads.",
+       SERVER,
+       SettingsCategory::Storage);
+  init("storage-tasks-steal-min-backlog",
+       &storage_tasks_steal_min_backlog,
+       "2",
+       parse_positive<size_t>(),
+       "When storage-tasks-work-stealing is enabled, idle storage threads "
+       "only pick up tasks from another queue if at least this many tasks are "
+       "waiting in it.",
+       SERVER,
+       SettingsCategory::Storage);
   init("storage-tasks-drr-quanta",
        &storage_tasks_drr_quanta,
        "1",
@@ -1088,6 +1317,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
                                     Worker/AppenderBuffer ctors */
        ,
        SettingsCategory::WritePath);
+  init("appender-buffer-max-bytes",
+       &appender_buffer_max_bytes,
+       "104857600", // 100MB
+       parse_nonnegative<ssize_t>(),
+       "total size in bytes of pending writes that can be buffered across all "
+       "workers while sequencers are initializing or activating. A log can "
+       "only grow its queue while it holds less than what is left of the "
+       "budget, so that one log cannot take more than its fair share. Writes "
+       "over budget are rejected with E::SEQNOBUFS. 0 means no limit.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("appender-buffer-process-batch",
        &appender_buffer_process_batch,
        "20",
@@ -1127,6 +1367,29 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "apply to new reader instances",
        SERVER | CLIENT,
        SettingsCategory::ReadPath);
+  init("client-read-batch-handoff",
+       &client_read_batch_handoff,
+       "false",
+       nullptr, // no validation
+       "If true, read streams of a Reader hand the records they can deliver "
+       "in one go over to the Reader as a single queue entry instead of one "
+       "entry per record, and Reader::read() moves them into the output "
+       "vector together. This reduces the synchronization between worker "
+       "threads and the reading thread for high throughput readers. Gaps are "
+       "reported the same way as without it. If this setting is changed "
+       "on-the-fly, the change applies to records delivered after the change.",
+       SERVER | CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-buffered-bytes-limit",
+       &client_read_buffered_bytes_limit,
+       "0",
+       nullptr, // no validation
+       "Maximum total size of record payloads that the read streams running "
+       "on one worker thread can buffer. When it is exceeded, read streams "
+       "halve their windows every time they slide them until the total drops "
+       "below the limit. 0 means no limit.",
+       SERVER | CLIENT,
+       SettingsCategory::ReadPath);
   init("client-read-flow-control-threshold",
        &client_read_flow_control_threshold,
        "0.7",
@@ -1135,6 +1398,46 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "window update messages (less means more often)",
        CLIENT | SERVER /* for event log reads */,
        SettingsCategory::ReadPath);
+  init("client-read-window-autotune",
+       &client_read_window_autotune,
+       "false",
+       nullptr, // no validation
+       "If true, read streams size their windows to the number of records "
+       "the application consumes during the round trip of a WINDOW message to "
+       "storage nodes and back, so that slow readers don't buffer more than "
+       "they need and fast readers on high latency links don't wait for "
+       "records. Windows never grow past client-read-buffer-size. The round "
+       "trip time of the slowest storage node is used.",
+       SERVER | CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-rewind-spread",
+       &client_read_rewind_spread,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "When a storage node comes back after being down or not sending "
+       "records, all read streams that stopped reading from it rewind to "
+       "read from it again, each sending START to all storage shards of its "
+       "log. If this is positive, these rewinds are spread over this much "
+       "time at random, except for the first one of each node in that "
+       "interval, and a rewind that is no longer needed once its time comes "
+       "(e.g. because the node went down again) is skipped. Rewinds that are "
+       "needed for reading to make progress are not delayed. 0 rewinds "
+       "right away.",
+       CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-stream-sharing",
+       &client_read_stream_sharing,
+       "false",
+       nullptr, // no validation
+       "If true, AsyncReaders of the same log that read to the end of the log "
+       "with the same options are served by one read stream to storage nodes "
+       "and get records and gaps fanned out inside the client, instead of "
+       "each reader receiving its own copy of the records from storage nodes. "
+       "A reader that rejects a record, or starts before what the shared "
+       "stream has already delivered, reads through a private stream. Only "
+       "applies to readers started after the change.",
+       CLIENT | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
   init("client-epoch-metadata-cache-size",
        &client_epoch_metadata_cache_size,
        "50000",
@@ -1143,6 +1446,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Set it to 0 to disable the epoch metadata cache.",
        CLIENT | REQUIRES_RESTART,
        SettingsCategory::ReadPath);
+  init("client-share-epoch-metadata-fetches",
+       &client_share_epoch_metadata_fetches,
+       "true",
+       nullptr, // no validation
+       "If true, when several read streams of the same log need historical "
+       "epoch metadata that is not in the epoch metadata cache, only one of "
+       "them reads the metadata log and the others wait for it and then get "
+       "the metadata from the cache, which keeps the whole history read from "
+       "the metadata log. Has no effect if the epoch metadata cache is "
+       "disabled.",
+       CLIENT,
+       SettingsCategory::ReadPath);
   init("client-readers-flow-tracer-period",
        &client_readers_flow_tracer_period,
        "0s",
@@ -1235,6 +1550,27 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "logs, currently the event logs and logsconfig logs",
        SERVER,
        SettingsCategory::WritePath);
+  init("release-batching-window",
+       &release_batching_window,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, sequencers hold RELEASE messages for up to this long and "
+       "send the ones headed to the same storage node together, in one "
+       "MULTI_RELEASE message, which the storage node processes as a batch. "
+       "Only used for nodes that support it. Reduces the number of messages "
+       "on nodes that sequence many logs, at the cost of delaying delivery "
+       "of released records to readers by up to this long. 0 disables "
+       "batching.",
+       SERVER,
+       SettingsCategory::WritePath);
+  init("release-batching-max-releases",
+       &release_batching_max_releases,
+       "1000",
+       parse_validate_range<size_t>(1, 100000),
+       "When --release-batching-window is enabled, a batch of RELEASEs to a "
+       "storage node is sent as soon as it has this many RELEASEs.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("recovery-grace-period",
        &recovery_grace_period,
        "100ms",
@@ -1244,6 +1580,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "an authoritative complete digest. Millisecond granularity. Can be 0. ",
        SERVER,
        SettingsCategory::Recovery);
+  init("recovery-skip-digest-of-drained-epochs",
+       &recovery_skip_digest_of_drained_epochs,
+       "false",
+       nullptr, // no validation
+       "If true, epoch recovery doesn't start digest read streams on storage "
+       "shards whose SEALED replies show that they store no records past the "
+       "last known good ESN and the tail record is already known. This is the "
+       "case for epochs that were drained by their sequencer before it moved "
+       "to another node, so such recoveries go straight to the mutation and "
+       "cleaning phase.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Recovery);
   init("event-log-grace-period",
        &event_log_grace_period,
        "10s",
@@ -1258,6 +1606,25 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "epoch recovery timeout. Millisecond granularity.",
        SERVER,
        SettingsCategory::Recovery);
+  init("seal-batching-window",
+       &seal_batching_window,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, log recoveries hold SEAL messages for up to this long and "
+       "send the ones headed to the same storage node together, in one "
+       "MULTI_SEAL message, which the storage node seals with one storage "
+       "task per shard. Only used for nodes that support it. Speeds up "
+       "failovers that recover many logs at once. 0 disables batching.",
+       SERVER,
+       SettingsCategory::Recovery);
+  init("seal-batching-max-seals",
+       &seal_batching_max_seals,
+       "1000",
+       parse_validate_range<size_t>(1, 100000),
+       "When --seal-batching-window is enabled, a batch of SEALs to a storage "
+       "node is sent as soon as it has this many SEALs.",
+       SERVER,
+       SettingsCategory::Recovery);
   init("gap-grace-period",
        &gap_grace_period,
        "100ms",
@@ -1322,6 +1689,20 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "log's sequencer over the network.",
       SERVER | REQUIRES_RESTART /* init'ed with this in Procesor's ctor */,
       SettingsCategory::ReadPath);
+  init("log-storage-state-dense-logs",
+       &log_storage_state_dense_logs,
+       "0",
+       nullptr,
+       "If positive, the in-memory state of data logs with IDs below this "
+       "value, and of their metadata logs, is kept in arrays indexed by log ID "
+       "instead of a hash map. This makes the lookups done for every STORE, "
+       "RELEASE and START cheaper when there are many logs. Memory for the "
+       "arrays is allocated in blocks of 64 consecutive logs the first time "
+       "one of them is used, so set this to just above the highest log ID in "
+       "the config when log IDs are mostly contiguous. Logs with higher IDs "
+       "still work and go to the hash map.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::ReadPath);
   init("seq-state-reply-timeout",
        &get_seq_state_reply_timeout,
        "2s",
@@ -1339,6 +1720,27 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "a timeout.",
       SERVER | CLIENT,
       SettingsCategory::Sequencer);
+  init("seq-state-batching-window",
+       &seq_state_batching_window,
+       "5ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, 'get sequencer state' requests that rebuilding sends "
+       "while planning which logs to rebuild are held for up to this long, "
+       "and the ones headed to the same sequencer node are sent together in "
+       "one MULTI_GET_SEQ_STATE message. Only used for nodes that support it. "
+       "Cuts the number of messages a rebuilding donor exchanges with "
+       "sequencer nodes when its shards hold many logs. 0 disables batching.",
+       SERVER,
+       SettingsCategory::Sequencer);
+  init("seq-state-batching-max-requests",
+       &seq_state_batching_max_requests,
+       "1000",
+       parse_validate_range<size_t>(1, 100000),
+       "When --seq-state-batching-window is enabled, a batch of 'get "
+       "sequencer state' requests to a node is sent as soon as it has this "
+       "many requests.",
+       SERVER,
+       SettingsCategory::Sequencer);
   init("check-seal-req-min-timeout",
        &check_seal_req_min_timeout,
        "500ms",
@@ -1386,6 +1788,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "cluster as soon as the client is created",
       CLIENT,
       SettingsCategory::FailureDetector);
+  init("enable-cluster-state-push",
+       &enable_cluster_state_push,
+       "false",
+       nullptr,
+       "Ask the node that answers a cluster state refresh to push the cluster "
+       "state to this client whenever its failure detector sees a node change "
+       "state, so that appends and reads react to node failures within a "
+       "gossip interval rather than on the next refresh. Only one node pushes "
+       "to a client at a time.",
+       CLIENT,
+       SettingsCategory::FailureDetector);
+  init("cluster-state-push-delay",
+       &cluster_state_push_delay,
+       "50ms",
+       validate_nonnegative<ssize_t>(),
+       "Changes of the cluster state that happen within this delay of each "
+       "other are pushed together to clients that enabled "
+       "--enable-cluster-state-push.",
+       SERVER,
+       SettingsCategory::FailureDetector);
   init("test-get-cluster-state-recipients",
        &test_get_cluster_state_recipients_,
        "",
@@ -1411,6 +1833,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "enough copies of a record or a hole plug",
       SERVER,
       SettingsCategory::Recovery);
+  init("recovery-mutation-batching",
+       &recovery_mutation_batching,
+       "false",
+       nullptr, // no validation
+       "If true, epoch recovery sends the first wave of mutations (re-"
+       "replicated records, hole plugs and bridge records) to each storage "
+       "node in as few MULTI_STORE messages as --store-batching-max-bytes "
+       "allows, instead of one STORE per record, and storage nodes coalesce "
+       "the MUTATED replies to the same sequencer node into MULTI_MUTATED "
+       "messages. Speeds up the recovery of epochs with many records to "
+       "mutate.",
+       SERVER,
+       SettingsCategory::Recovery);
   init("write-sticky-copysets",
        &write_sticky_copysets_deprecated,
        "true",
@@ -1462,6 +1897,28 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "expiration time of idle RocksDB iterators in the iterator cache.",
        SERVER,
        SettingsCategory::RocksDB);
+  init("share-read-iterators",
+       &share_read_iterators,
+       "false",
+       nullptr, // no validation
+       "If true, read streams on the same worker that read the same log from "
+       "the same shard share cached iterators instead of each caching its "
+       "own. Every read re-seeks the iterator, so streams can take turns using "
+       "it. This reduces the memory pinned by iterators and how often they "
+       "are created. Only affects read streams created after the change.",
+       SERVER,
+       SettingsCategory::RocksDB);
+  init("server-read-stream-hibernate-after",
+       &server_read_stream_hibernate_after,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "Read streams that are caught up and have had nothing to read for this "
+       "long are hibernated: they release their iterator cache and record "
+       "buffers, which are recreated when a RELEASE or WINDOW gives the stream "
+       "something to read. Checked every --iterator-cache-ttl. 0 disables "
+       "hibernation.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("max-protocol",
        &max_protocol,
        std::to_string(Compatibility::MAX_PROTOCOL_SUPPORTED).c_str(),
@@ -1563,6 +2020,20 @@ void Settings::defineSettings(SettingEasyInit& init) {
            .c_str(),
        SERVER | CLIENT /* Exposed via Client::getMaxPayloadSize() */,
        SettingsCategory::ResourceManagement);
+  init("worker-load-rebalancing-ratio",
+       &worker_load_rebalancing_ratio,
+       "0",
+       validate_nonnegative<double>(),
+       "If positive, a worker whose CPU load is at least this many times the "
+       "average load of all workers closes the connection of the client with "
+       "the most read streams on it, once per load report (every 10s), "
+       "provided it has at least two clients reading from it. The client "
+       "reconnects and restarts its read streams from where they were. New "
+       "data connections are then assigned to workers based on load instead "
+       "of at random, so the client is likely to land on a less loaded "
+       "worker. 0 disables this.",
+       SERVER,
+       SettingsCategory::Performance);
   init("write-find-time-index",
        &write_find_time_index,
        "false",
@@ -1643,6 +2114,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Evenly divided among shards.",
        SERVER,
        SettingsCategory::ResourceManagement);
+  init("memory-governor-limit-bytes",
+       &memory_governor_limit_bytes,
+       "0",
+       parse_nonnegative<size_t>(),
+       "Limit on the combined memory used by read storage tasks, in-flight "
+       "stores and socket output buffers. When exceeded, the limits of read "
+       "storage tasks and stores are lowered until usage drops. Checked every "
+       "--logstore-monitoring-interval. 0 means no combined limit.",
+       SERVER,
+       SettingsCategory::ResourceManagement);
   init("initial-config-load-timeout",
        &initial_config_load_timeout,
        "15s",
@@ -1659,6 +2140,21 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "externally before logdevice can do any ZooKeeper epoch store operations",
       SERVER | EXPERIMENTAL,
       SettingsCategory::Core);
+  init("zk-epoch-store-write-batch-max-ops",
+       &zk_epoch_store_write_batch_max_ops,
+       "1",
+       [](size_t val) {
+         if (val < 1 || val > 1000) {
+           throw boost::program_options::error(
+               "zk-epoch-store-write-batch-max-ops must be between 1 and 1000");
+         }
+       },
+       "Maximum number of epoch store znode writes (epoch bumps and LCE "
+       "updates for different logs) that are grouped into one ZooKeeper "
+       "multi-op transaction while a previous write batch is in flight. 1 "
+       "disables batching.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Core);
   init("ssl-load-client-cert",
        &ssl_load_client_cert,
        "false",
@@ -1694,6 +2190,43 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "TTL for an SSL certificate that we have loaded from disk.",
        SERVER | CLIENT | REQUIRES_RESTART /* used in Worker ctor */,
        SettingsCategory::Security);
+  init("ssl-kernel-tls",
+       &ssl_kernel_tls,
+       "false",
+       nullptr, // no validation
+       "If true, once the SSL handshake completes, hand the symmetric keys "
+       "of the connection to the kernel (kTLS) so that encryption and "
+       "decryption happen in the kernel instead of in OpenSSL's userspace "
+       "buffers. Requires OpenSSL 3.0 or later built with kTLS support, and "
+       "the tls kernel module. Connections for which kTLS can't be enabled "
+       "(e.g. because of the negotiated cipher) silently keep using "
+       "userspace encryption; see the num_ktls_connections stat.",
+       SERVER | CLIENT | REQUIRES_RESTART /* used in Worker ctor */ |
+           EXPERIMENTAL,
+       SettingsCategory::Security);
+  init("ssl-session-resumption",
+       &ssl_session_resumption,
+       "false",
+       nullptr, // no validation
+       "If true, SSL connections to servers cache their TLS session and "
+       "resume it when reconnecting to the same address, skipping the "
+       "certificate exchange and key agreement of a full handshake. Servers "
+       "issue stateless session tickets; see --ssl-session-ticket-key-path. "
+       "See the ssl_handshakes_resumed stat.",
+       SERVER | CLIENT | REQUIRES_RESTART /* used in Worker ctor */,
+       SettingsCategory::Security);
+  init("ssl-session-ticket-key-path",
+       &ssl_session_ticket_key_path,
+       "",
+       nullptr, // no validation
+       "Path to a file with the 48 bytes of key material used to encrypt TLS "
+       "session tickets. All servers of a cluster should use the same file, "
+       "so that a client can resume its session on any of them. If empty, "
+       "each server uses a random key, and sessions can only be resumed on "
+       "the server that issued them, until it restarts. Only used with "
+       "--ssl-session-resumption.",
+       SERVER | REQUIRES_RESTART /* used in Worker ctor */,
+       SettingsCategory::Security);
   init("ssl-boundary",
        &ssl_boundary,
        "none",
@@ -1750,6 +2283,43 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "\"any\" or \"\" to keep the default.",
        SERVER | REQUIRES_RESTART /* used once when ExecStorageThread starts */,
        SettingsCategory::ResourceManagement);
+  init("fast-ioprio",
+       &fast_ioprio,
+       "",
+       [](const std::string& val) -> folly::Optional<std::pair<int, int>> {
+         folly::Optional<std::pair<int, int>> res;
+         if (parse_ioprio(val, &res) != 0) {
+           throw boost::program_options::error(
+               "value of --fast-ioprio must be of the form "
+               "<class>,<data> e.g. 2,0; " +
+               val + " given.");
+         }
+         return res;
+       },
+       "IO priority to request for 'fast' storage threads, which handle "
+       "writes and latency-sensitive reads. See --slow-ioprio. "
+       "\"any\" or \"\" to keep the default.",
+       SERVER | REQUIRES_RESTART /* used once when ExecStorageThread starts */,
+       SettingsCategory::ResourceManagement);
+  init("rebuilding-ioprio",
+       &rebuilding_ioprio,
+       "",
+       [](const std::string& val) -> folly::Optional<std::pair<int, int>> {
+         folly::Optional<std::pair<int, int>> res;
+         if (parse_ioprio(val, &res) != 0) {
+           throw boost::program_options::error(
+               "value of --rebuilding-ioprio must be of the form "
+               "<class>,<data> e.g. 3,0; " +
+               val + " given.");
+         }
+         return res;
+       },
+       "IO priority that storage threads switch to while running rebuilding "
+       "storage tasks, so that rebuilding reads can be put below regular "
+       "backlog reads of the same 'slow' threads. See --slow-ioprio. "
+       "\"any\" or \"\" to use the priority of the thread.",
+       SERVER,
+       SettingsCategory::ResourceManagement);
 
   init("checksumming-enabled",
        &checksumming_enabled,
@@ -1880,6 +2450,29 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "fetch.",
        CLIENT | SERVER,
        SettingsCategory::Configuration);
+  init("client-bootstrap-cache-dir",
+       &client_bootstrap_cache_dir,
+       "",
+       nullptr,
+       "If not empty, the client saves the last nodes configuration and "
+       "LogsConfig it saw in this directory, and the next client of the same "
+       "cluster starts with them instead of waiting to fetch them. Cached "
+       "configs are replaced in the background as soon as newer versions are "
+       "fetched. The nodes configuration is only cached when it is fetched "
+       "with --nodes-configuration-seed-servers and the nodes configuration "
+       "manager is enabled; the LogsConfig only when it comes from the "
+       "internal logs config replicated state machine.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Configuration);
+  init("prewarm-connections-for-logs",
+       &prewarm_connections_for_logs,
+       "",
+       parse_log_intervals,
+       "Comma-separated list of log IDs and ranges (e.g. 1,10..20) whose "
+       "sequencer nodes the client connects to right after it is created, so "
+       "that the first appends to these logs don't wait for a connection.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Configuration);
   init("use-tcp-keep-alive",
        &use_tcp_keep_alive,
        "true",
@@ -2042,6 +2635,104 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "benefit of batching and recompressing would be small.",
       SERVER,
       SettingsCategory::Batching);
+  init("sequencer-batching-auto-threshold",
+       &sequencer_batching_auto_threshold,
+       "0",
+       nullptr, // no validation
+       "If positive, logs that don't have sequencer batching enabled get "
+       "their small appends batched anyway while their sequencer receives at "
+       "least this many appends per second. 0 disables automatic batching. "
+       "The usual caveats of sequencer batching apply: batched appends share "
+       "an LSN.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("sequencer-batching-auto-max-payload-size",
+       &sequencer_batching_auto_max_payload_size,
+       "1024",
+       nullptr, // no validation
+       "Automatic sequencer batching (see sequencer-batching-auto-threshold) "
+       "only batches appends with payloads of at most this many bytes.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("sequencer-batching-auto-time-trigger",
+       &sequencer_batching_auto_time_trigger,
+       "5ms",
+       validate_positive<ssize_t>(),
+       "Automatic sequencer batching (see sequencer-batching-auto-threshold) "
+       "flushes buffered appends for a log when the oldest buffered append "
+       "is this old.",
+       SERVER | REQUIRES_RESTART /* used in SequencerBatching ctor */,
+       SettingsCategory::Batching);
+  init("sequencer-batching-adaptive",
+       &sequencer_batching_adaptive,
+       "false",
+       nullptr, // no validation
+       "Tune sequencer batching of each log to its recent append rate: flush "
+       "batches within sequencer-batching-adaptive-latency-budget, make them "
+       "as large as the log's rate allows within that time, compress only "
+       "batches expected to reach "
+       "sequencer-batching-adaptive-compression-threshold bytes, and pass "
+       "through appends to logs too slow for batches to form.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("sequencer-batching-adaptive-latency-budget",
+       &sequencer_batching_adaptive_latency_budget,
+       "20ms",
+       validate_positive<ssize_t>(),
+       "Maximum latency adaptive sequencer batching (see "
+       "sequencer-batching-adaptive) may add to an append by buffering it.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("sequencer-batching-adaptive-compression-threshold",
+       &sequencer_batching_adaptive_compression_threshold,
+       "4096",
+       nullptr, // no validation
+       "Adaptive sequencer batching (see sequencer-batching-adaptive) leaves "
+       "batches uncompressed if they are expected to be smaller than this "
+       "many bytes.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("trim-batching-window",
+       &trim_batching_window,
+       "1ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, TRIM messages of logs trimmed together with "
+       "Client::trimBatch() are held for up to this long, and the ones headed "
+       "to the same storage node are sent together in one MULTI_TRIM "
+       "message. Only used for nodes that support it. 0 disables batching. "
+       "Trims issued with Client::trim() are never delayed.",
+       CLIENT,
+       SettingsCategory::Batching);
+  init("trim-batching-max-trims",
+       &trim_batching_max_trims,
+       "1000",
+       parse_validate_range<size_t>(1, 100000),
+       "When --trim-batching-window is enabled, a batch of TRIMs to a storage "
+       "node is sent as soon as it has this many trims.",
+       CLIENT,
+       SettingsCategory::Batching);
+  init("log-query-batching-window",
+       &log_query_batching_window,
+       "1ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, IS_LOG_EMPTY and DATA_SIZE messages of logs queried "
+       "together with Client::isLogEmptyBatch() or Client::dataSizeBatch() "
+       "are held for up to this long, and the ones headed to the same storage "
+       "node are sent together in one MULTI_IS_LOG_EMPTY or MULTI_DATA_SIZE "
+       "message. Only used for nodes that support it. 0 disables batching. "
+       "Queries issued with Client::isLogEmpty() or Client::dataSize() are "
+       "never delayed.",
+       CLIENT,
+       SettingsCategory::Batching);
+  init("log-query-batching-max-queries",
+       &log_query_batching_max_queries,
+       "1000",
+       parse_validate_range<size_t>(1, 100000),
+       "When --log-query-batching-window is enabled, a batch of IS_LOG_EMPTY "
+       "or DATA_SIZE messages to a storage node is sent as soon as it has "
+       "this many queries.",
+       CLIENT,
+       SettingsCategory::Batching);
   init("num-processor-background-threads",
        &num_processor_background_threads,
        "0",
@@ -2051,6 +2742,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "large batches.  If 0 (default), use num-workers.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Execution);
+  init("cpu-offload-threads",
+       &cpu_offload_threads,
+       "0",
+       validate_nonnegative<ssize_t>(),
+       "Number of threads that Workers hand CPU-heavy work to, such as "
+       "compressing replicated state machine snapshots, so that it does not "
+       "delay message processing. Results are handed back to the Worker in "
+       "the order the work was submitted. If 0 (default), that work runs "
+       "inline on Workers.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Execution);
+  init("cpu-offload-queue-size",
+       &cpu_offload_queue_size,
+       "10000",
+       validate_positive<ssize_t>(),
+       "Maximum number of pieces of work waiting for a thread of the CPU "
+       "offload pool (see --cpu-offload-threads). When the queue is full, "
+       "Workers run the work inline.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Execution);
   init("buffered-writer-bg-thread-bytes-threshold",
        &buffered_writer_bg_thread_bytes_threshold,
        "4096",
@@ -2063,6 +2774,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "thread.",
        SERVER | CLIENT,
        SettingsCategory::Batching);
+  init("buffered-writer-decode-bg-thread-bytes-threshold",
+       &buffered_writer_decode_bg_thread_bytes_threshold,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If positive, AsyncReader decompresses records written by "
+       "BufferedWriter whose compressed size is at least this many bytes on "
+       "the Processor's background threads instead of the Worker thread. "
+       "Several such records of one log are decompressed in parallel and "
+       "delivered in LSN order.  While a record is being decompressed, "
+       "delivery for its log is paused, but other logs on the same Worker "
+       "are not held up.  0 disables.",
+       CLIENT,
+       SettingsCategory::Batching);
   init("buffered-writer-zstd-level",
        &buffered_writer_zstd_level,
        "1",
@@ -2070,6 +2794,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Zstd compression level to use in BufferedWriter.",
        SERVER | CLIENT,
        SettingsCategory::Batching);
+  init("zstd-dictionaries-dir",
+       &zstd_dictionaries_dir,
+       "",
+       nullptr, // no validation
+       "Directory containing trained zstd dictionaries (as produced by "
+       "'zstd --train'). Every file in it is registered on startup and can be "
+       "used by BufferedWriter and sequencer batching to compress batches. "
+       "Readers need the same dictionaries to decode such batches.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Batching);
+  init("sequencer-batching-zstd-dictionary-id",
+       &sequencer_batching_zstd_dictionary_id,
+       "0",
+       parse_validate_range<size_t>(0, std::numeric_limits<uint32_t>::max()),
+       "ID of the zstd dictionary to use for sequencer batching when "
+       "sequencer batching compression is zstd. 0 means no dictionary. The "
+       "dictionary must be registered via --zstd-dictionaries-dir on "
+       "sequencers and on all readers.",
+       SERVER,
+       SettingsCategory::Batching);
   init("background-queue-size",
        &background_queue_size,
        "100000",
@@ -2161,6 +2905,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "version.",
        SERVER | CLIENT | DEPRECATED,
        SettingsCategory::Configuration);
+  init("max-config-changed-in-flight",
+       &max_config_changed_in_flight,
+       "128",
+       parse_positive<ssize_t>(),
+       "Maximum number of CONFIG_CHANGED messages with the full config that "
+       "may be queued or in flight at the same time to clients with a stale "
+       "config. Limits the burst of outgoing traffic when the config changes "
+       "and many clients are connected. The config is sent to the remaining "
+       "clients with a later message on their connections.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Configuration);
   init("get-erm-for-empty-epoch",
        &get_erm_for_empty_epoch,
        "true",
@@ -2188,6 +2943,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "server.",
       SERVER | CLIENT,
       SettingsCategory::Configuration);
+  init("logsconfig-lazy-materialization",
+       &logsconfig_lazy_materialization,
+       "false",
+       nullptr,
+       "If true, the client keeps the LogsConfig snapshot it reads from the "
+       "snapshot log in its serialized form and only deserializes the log "
+       "groups it looks up by id or by name, which makes loading a large logs "
+       "config much faster and cheaper in memory. The whole tree is "
+       "deserialized the first time a delta needs to be applied on top of the "
+       "snapshot or some code needs all the log groups (e.g. to iterate over "
+       "them).",
+       CLIENT,
+       SettingsCategory::Configuration);
   init("logsconfig-snapshotting",
        &logsconfig_snapshotting,
        "true",
@@ -2445,7 +3213,8 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "SCDCopysetReordering values that clients may ask servers to "
        "use.  "
        "Currently available options: "
-       "none, hash-shuffle (default), hash-shuffle-client-seed. "
+       "none, hash-shuffle (default), hash-shuffle-client-seed, "
+       "hash-shuffle-lsn-block-rotation. "
        "hash-shuffle results in only one storage node reading a record "
        "block "
        "from disk, and then serving it to multiple readers from the "
@@ -2453,7 +3222,11 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "hash-shuffle-client-seed enables multiple storage nodes to "
        "participate "
        "in reading the log, which can be benefit non-disk-bound "
-       "workloads.",
+       "workloads. "
+       "hash-shuffle-lsn-block-rotation also rotates which storage node "
+       "serves each block of 1024 LSNs to a read stream, so that a single "
+       "hot reader spreads its load across the copyset; only use it once "
+       "all storage nodes support it.",
        SERVER | CLIENT,
        SettingsCategory::ReadPath);
 
@@ -2525,6 +3298,60 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::WritePath);
 
+  init("adaptive-copyset-selection",
+       &adaptive_copyset_selection,
+       "false",
+       nullptr, // no validation
+       "If true, copyset selection keeps, per worker, a moving average of "
+       "STORE latency and the number of outstanding STOREs for every shard, "
+       "and within the replication constraints replaces copyset members with "
+       "proportionally faster shards of the same domain. Unlike graylisting, "
+       "a slow shard gets gradually less traffic instead of none.",
+       SERVER,
+       SettingsCategory::WritePath);
+
+  init("adaptive-copyset-selection-half-life",
+       &adaptive_copyset_selection_half_life,
+       "2s",
+       validate_positive<ssize_t>(),
+       "Half-life of the per-shard STORE latency averages used by "
+       "--adaptive-copyset-selection. An estimate that hasn't been updated "
+       "decays toward the average of all shards with the same half-life.",
+       SERVER,
+       SettingsCategory::WritePath);
+
+  init("store-hedging",
+       &store_hedging,
+       "false",
+       nullptr, // no validation
+       "If true, an Appender that has all but one of the copies it needs, and "
+       "whose wave has been outstanding for longer than "
+       "--store-hedging-latency-multiplier times the median STORE latency "
+       "seen by this worker, sends a new wave right away instead of waiting "
+       "for the store timeout. The shard that didn't reply is graylisted, so "
+       "the new wave goes elsewhere. Requires "
+       "--enable-store-histogram-calculations.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::WritePath);
+
+  init("store-hedging-latency-multiplier",
+       &store_hedging_latency_multiplier,
+       "4",
+       validate_lower_bound<double>(1),
+       "How many times the median STORE latency a wave can take before "
+       "--store-hedging gives up on its last outstanding copy.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::WritePath);
+
+  init("store-hedging-min-delay",
+       &store_hedging_min_delay,
+       "10ms",
+       validate_nonnegative<ssize_t>(),
+       "--store-hedging never sends a new wave sooner than this after the "
+       "previous one.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::WritePath);
+
   init("test-do-not-pick-in-copysets",
        &test_do_not_pick_in_copysets,
        "",
@@ -2567,6 +3394,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        CLIENT,
        SettingsCategory::Monitoring);
 
+  init("shadow-append-queue-size",
+       &shadow_append_queue_size,
+       "10000",
+       parse_validate_range<size_t>(1, 10000000),
+       "Maximum number of shadow appends waiting to be sent to shadow "
+       "clusters. Shadow appends are copied and queued without blocking the "
+       "original append; when the queue is full they are dropped. See "
+       "traffic-shadow-enabled.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Monitoring);
+
+  init("shadow-append-threads",
+       &shadow_append_threads,
+       "1",
+       parse_validate_range<size_t>(1, 64),
+       "Number of threads sending queued shadow appends to shadow clusters. "
+       "See shadow-append-queue-size.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Monitoring);
+
   init("enable-nodes-configuration-manager",
        &enable_nodes_configuration_manager,
        "false", // defaults to false
@@ -2721,6 +3568,41 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "When the real time buffer reaches this size, we evict entries.",
        SERVER | REQUIRES_RESTART | EXPERIMENTAL,
        SettingsCategory::ReadPath);
+  init("real-time-tail-bytes-per-log",
+       &real_time_tail_bytes_per_log,
+       "0",
+       nullptr, // no validation
+       "If positive, each worker keeps up to this many bytes of the most "
+       "recently released records of every log it has readers for, even after "
+       "they have been handed to the read streams. Readers that are slightly "
+       "behind the tail are then served from memory instead of the local log "
+       "store. Counts against real-time-max-bytes. 0 disables it.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
+  init("catchup-readahead-size",
+       &catchup_readahead_size,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If positive, iterators used by catching up readers on storage threads "
+       "read this many bytes ahead from SST files instead of one block at a "
+       "time. Helps sequential reads of cold data on HDDs. 0 leaves "
+       "readahead up to RocksDB, which ramps it up on its own after a few "
+       "sequential reads.",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("record-batch-max-bytes",
+       &record_batch_max_bytes,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If positive, records read on storage threads for catching up "
+       "readers are sent in RECORD_BATCH messages of about this many bytes "
+       "of payload instead of one RECORD message per record. Saves most of "
+       "the ~40 bytes of framing per record, which matters for small "
+       "records. Records with extra metadata or byte offsets, and records "
+       "for readers too old to support RECORD_BATCH, are still sent one by "
+       "one. 0 disables batching.",
+       SERVER,
+       SettingsCategory::ReadPath);
 
   init("test-timestamp-linear-transform",
        &test_timestamp_linear_transform,
@@ -2790,6 +3672,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER | EXPERIMENTAL,
        SettingsCategory::WritePath);
 
+  init("write-record-format-v2",
+       &write_record_format_v2,
+       "false",
+       nullptr,
+       "Write records in the v2 on-disk format, whose header fields are at "
+       "fixed offsets and which readers parse without branching on every "
+       "optional field. Records written in this format can't be read by "
+       "versions of LogDevice that don't know about it, so only enable this "
+       "once all nodes of the cluster support it, and don't downgrade after.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::WritePath);
+
   init("epoch-metadata-use-new-storage-set-format",
        &epoch_metadata_use_new_storage_set_format,
        "false",
@@ -2933,6 +3827,35 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER | CLIENT,
        SettingsCategory::Core);
 
+  init("rsm-max-delta-snapshots",
+       &rsm_max_delta_snapshots,
+       "0",
+       nullptr,
+       "Maximum number of consecutive delta snapshots a replicated state "
+       "machine writes after a full snapshot. A delta snapshot only contains "
+       "the deltas since the previous snapshot, which makes snapshotting "
+       "large state machines cheaper. A full snapshot is also written once "
+       "the delta snapshots since the last one are larger than it. Only used "
+       "if --rsm-include-read-pointer-in-snapshot is true. 0 disables delta "
+       "snapshots. All readers of the state machine need to be able to read "
+       "delta snapshots before this is enabled.",
+       SERVER | CLIENT,
+       SettingsCategory::Core);
+
+  init("rsm-snapshot-chunk-size",
+       &rsm_snapshot_chunk_size,
+       "0",
+       nullptr,
+       "If positive, replicated state machine snapshots larger than this many "
+       "bytes (after compression) are written as several chunk records of at "
+       "most this size followed by a small manifest record listing them, "
+       "instead of a single record. Keep this below --max-payload-size. 0 "
+       "writes every snapshot as a single record. All readers of the state "
+       "machine need to be able to read chunked snapshots before this is "
+       "enabled.",
+       SERVER | CLIENT,
+       SettingsCategory::Core);
+
   init("eventlog-snapshotting-period",
        &eventlog_snapshotting_period,
        "1h",
@@ -2959,6 +3882,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "storage nodes",
        SERVER,
        SettingsCategory::Sequencer);
+  init("push-trim-points",
+       &push_trim_points,
+       "false",
+       nullptr, // no validation
+       "If true, storage nodes send advances of the trim point of a log to "
+       "the node whose sequencer last polled them for it (see "
+       "--get-trimpoint-interval), batching the updates for all logs headed "
+       "to the same node. Sequencers then learn trim points as soon as they "
+       "advance, and --get-trimpoint-interval can be raised, since polling "
+       "is then only needed to pick up the sequencer's initial trim point and "
+       "to subscribe to the updates.",
+       SERVER,
+       SettingsCategory::Sequencer);
   init("disable-trim-past-tail-check",
        &disable_trim_past_tail_check,
        "false",
@@ -2992,6 +3928,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Timeout for appends. If omitted the client timeout will be used.",
        CLIENT,
        SettingsCategory::Core);
+  init("append-workers-per-sequencer",
+       &append_workers_per_sequencer,
+       "0",
+       nullptr, // no validation
+       "If positive, appends are routed to Workers by the sequencer node that "
+       "the log maps to (assuming all sequencer nodes are available), using "
+       "this many Workers per sequencer node. Appends to the same sequencer "
+       "then share fewer Workers and sockets, and form bigger batches. 0 "
+       "routes appends by posting thread and log id.",
+       CLIENT,
+       SettingsCategory::WritePath);
   init("logsconfig-timeout",
        &logsconfig_timeout,
        "",
@@ -3027,6 +3974,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "and use HHWheelTimer backend.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Core);
+  init("enable-worker-timer-wheel",
+       &enable_worker_timer_wheel,
+       "false",
+       nullptr, // no validation
+       "Run timers of worker threads on a per-worker hierarchical timing "
+       "wheel with 1ms ticks instead of libevent's timer heap. Arming and "
+       "cancelling timers is O(1) and timers expiring in the same tick share "
+       "a wakeup. Takes precedence over enable-hh-wheel-backed-timers.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Core);
   init("enable-store-histograms-calculations",
        &enable_store_histogram_calculations,
        "false",
@@ -3135,6 +4092,59 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::Sequencer);
 
+  init("sequencer-placement-max-node-bytes-per-sec",
+       &sequencer_placement_max_node_bytes_per_sec,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If not zero, a node whose sequencers receive more than this many bytes "
+       "of appends per second in total hands some of its hottest logs off to "
+       "other sequencer nodes. Each log goes to the node it would be placed on "
+       "if this node were down. Appends for a handed-off log that reach this "
+       "node are redirected there. Only logs whose sequencer this node is the "
+       "primary for are handed off, so load is never shed twice. "
+       "Zero disables load-based placement.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Sequencer);
+
+  init("sequencer-placement-period",
+       &sequencer_placement_period,
+       "10s",
+       validate_positive<ssize_t>(),
+       "How often to compare the append throughput of this node's sequencers "
+       "against --sequencer-placement-max-node-bytes-per-sec.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Sequencer);
+
+  init("sequencer-placement-overloaded-periods",
+       &sequencer_placement_overloaded_periods,
+       "3",
+       validate_positive<ssize_t>(),
+       "Hand logs off only after the node was over "
+       "--sequencer-placement-max-node-bytes-per-sec for this many consecutive "
+       "--sequencer-placement-period, so that short bursts don't move logs.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Sequencer);
+
+  init("sequencer-placement-max-handoffs",
+       &sequencer_placement_max_handoffs,
+       "2",
+       validate_positive<ssize_t>(),
+       "Maximum number of logs to hand off at a time when a node is "
+       "overloaded.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Sequencer);
+
+  init("sequencer-placement-hold",
+       &sequencer_placement_hold,
+       "10min",
+       validate_positive<ssize_t>(),
+       "How long a handed-off log stays on the node it was handed off to. The "
+       "handoff is renewed while taking the log back would put this node "
+       "close to --sequencer-placement-max-node-bytes-per-sec again; "
+       "otherwise the log returns when the handoff expires.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Sequencer);
+
   sequencer_boycotting.defineSettings(init);
 
   init("require-permission-message-types",
@@ -3148,5 +4158,15 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "messages of all types except WINDOW and RELEASE.",
        SERVER,
        SettingsCategory::Security);
+  init("permission-decision-cache-size",
+       &permission_decision_cache_size,
+       "10000",
+       nullptr, // no validation
+       "Maximum number of decisions of the config-based permission checker "
+       "each worker caches, keyed by log, action and the identities of the "
+       "principal. The cache is emptied when the server config or the logs "
+       "config changes, or when it's full. 0 disables the cache.",
+       SERVER,
+       SettingsCategory::Security);
 }
 }} // namespace facebook::logdevice
@@ -78,6 +78,12 @@ struct Settings : public SettingsBundle {
   // number of worker threads to run
   int num_workers;
 
+  // see --worker-load-rebalancing-ratio
+  double worker_load_rebalancing_ratio;
+
+  // pin workers and storage threads to NUMA nodes, see NumaTopology.h
+  bool numa_aware_placement;
+
   // Time interval after which watchdog wakes up and detects stalls
   std::chrono::milliseconds watchdog_poll_interval_ms;
 
@@ -91,6 +97,10 @@ struct Settings : public SettingsBundle {
   // enable I/O tracing on all database shards
   bool trace_all_db_shards;
 
+  // count cycles, instructions etc. on workers and storage threads, see
+  // PerfCounters.h
+  bool enable_perf_counters;
+
   // If true, turn off TraceLogger by using NoopTraceLogger implementation
   bool trace_logger_disabled;
 
@@ -117,6 +127,22 @@ struct Settings : public SettingsBundle {
   // If -1, system default will be used instead (setsockopt not called).
   int tcp_sendbuf_kb;
 
+  // If true, periodically resize SO_SNDBUF of each TCP connection to twice
+  // its bandwidth-delay product as estimated by the kernel (congestion
+  // window times MSS, from TCP_INFO), so that long-RTT links aren't
+  // throttled and short ones don't queue much in the kernel. tcp_sendbuf_kb,
+  // if set, is the upper bound.
+  bool tcp_sendbuf_adaptive;
+
+  // Set TCP_NOTSENT_LOWAT of all new TCP sockets to this number of KILOBYTES:
+  // the socket only becomes writable when fewer unsent bytes than that are
+  // in its send buffer. Keeps most of the queueing in the Socket's output
+  // buffer, where high-priority messages aren't stuck behind bulk data
+  // already handed to the kernel.
+  //
+  // If -1, system default will be used instead (setsockopt not called).
+  int tcp_notsent_lowat_kb;
+
   // Set SO_RCVBUF of all new TCP sockets to this number of KILOBYTES.  Note
   // that this makes Linux bypass its autotuning logic for the buffer size.
   // Importantly, it will never increase the buffer size for high-throughput
@@ -135,6 +161,19 @@ struct Settings : public SettingsBundle {
   // KILOBYTES. See Socket.h.
   size_t outbuf_overflow_kb;
 
+  // Messages up to this size (including ProtocolHeader) are coalesced into a
+  // contiguous per-socket buffer and flushed once per event loop iteration.
+  // 0 disables coalescing.
+  size_t socket_coalesce_max_message_size;
+
+  // Data connections to peers that don't share this location scope with us
+  // send their messages in zstd-compressed COMPRESSED_FRAMEs. The default
+  // ROOT disables compression.
+  NodeLocationScope socket_compression_boundary;
+
+  // zstd compression level used for COMPRESSED_FRAMEs
+  int socket_compression_level;
+
   // If socket is running out of buffers and it is not draining for a while
   // there is less value in maintaining it's socket buffers. This setting
   // decides how long will we allow the socket to drain before we close it.
@@ -148,9 +187,18 @@ struct Settings : public SettingsBundle {
   // Similar to output_max_records_kb but is applied *before* filtering records.
   int64_t max_record_bytes_read_at_once;
 
+  // Maximum number of ReadStorageTasks of different read streams on the same
+  // shard that a worker executes as a single batched storage task. 1 disables
+  // batching.
+  size_t read_storage_task_max_batch_size;
+
   // Maximum execution time for reading records
   std::chrono::milliseconds max_record_read_execution_time;
 
+  // A ReadStorageTask that has been reading for this long stops at the next
+  // record if higher priority tasks are waiting for its storage threads
+  std::chrono::milliseconds read_storage_tasks_preempt_after;
+
   // @deprecated
   unsigned requests_from_pipe;
 
@@ -237,10 +285,23 @@ struct Settings : public SettingsBundle {
   // in record cache snapshots
   size_t record_cache_max_size;
 
+  // records with payloads up to this size are copied into the allocation of
+  // their record cache entry instead of referencing the STORE's payload
+  size_t record_cache_inline_payload_max_bytes;
+
   // polling interval for the record cache eviction thread for monitoring the
   // size of the record cache
   std::chrono::seconds record_cache_monitor_interval;
 
+  // persist record caches on shutdown to a file that is mmap'ed on startup,
+  // instead of to log snapshot blobs in the local log store
+  bool record_cache_snapshot_file;
+
+  // if positive, when a node is declared dead, storage nodes read up to this
+  // many bytes per shard of the unclean records of logs whose sequencer ran on
+  // that node and that miss the record cache, ahead of log recovery
+  size_t recovery_digest_prefetch_max_bytes;
+
   // When an ld_check() fails, call abort().  If not, just continue
   // executing.  We'll log either way.
   bool abort_on_failed_check;
@@ -257,6 +318,10 @@ struct Settings : public SettingsBundle {
   // stalled thread(s) will be logged into the log file.
   bool watchdog_print_bt_on_stall;
 
+  // Number of stack samples that watchdog takes of each stalled worker
+  // thread every time it finds it stalled. See WatchDogThread.
+  size_t watchdog_stall_samples;
+
   // If true, the NodeSetFinder within PurgeUncleanEpochs will use
   // only the metadata log as source for fetching historical metadata.
   // TODO: T28014582
@@ -315,6 +380,18 @@ struct Settings : public SettingsBundle {
   // chain.
   bool disable_chain_sending;
 
+  // If positive, STOREs that Appenders on a Worker send to the same storage
+  // node within this window are coalesced into a MULTI_STORE message.
+  std::chrono::microseconds store_batching_window;
+
+  // STOREs at least this big are never batched, and a batch is sent right
+  // away once it reaches this size.
+  size_t store_batching_max_bytes;
+
+  // If greater than 1, appends to the same log received by a Worker in one
+  // event loop iteration are given LSNs together, up to this many at a time.
+  size_t sequencer_admission_batch_size;
+
   // Time interval that a node health check probe is sent if there is
   // an outstanding probe from the same node in nodeset
   std::chrono::seconds node_health_check_retry_interval;
@@ -389,6 +466,14 @@ struct Settings : public SettingsBundle {
   // Quanta for the DRR scheduler.
   uint64_t storage_tasks_drr_quanta = 1;
 
+  // If true, idle storage threads may pick up tasks from the queues of other
+  // storage thread types (see StorageThreadPool::trySteal()).
+  bool storage_tasks_work_stealing;
+
+  // Idle storage threads only steal from a queue that has at least this many
+  // tasks waiting.
+  size_t storage_tasks_steal_min_backlog;
+
   // Shares for StorageTask principals.
   std::array<StorageTaskShare, (uint64_t)StorageTaskPrincipal::NUM_PRINCIPALS>
       storage_task_shares;
@@ -425,6 +510,13 @@ struct Settings : public SettingsBundle {
   chrono_expbackoff_t<std::chrono::milliseconds>
       release_broadcast_interval_internal_logs;
 
+  // If positive, RELEASEs that sequencers on a Worker send to the same storage
+  // node within this window are coalesced into a MULTI_RELEASE message.
+  std::chrono::microseconds release_batching_window;
+
+  // A batch of RELEASEs is sent right away once it has this many RELEASEs.
+  size_t release_batching_max_releases;
+
   bool skip_recovery;
 
   // Maximum number of LogRecoveryRequests for data logs that can be running
@@ -445,6 +537,11 @@ struct Settings : public SettingsBundle {
   // participate in epoch recovery
   std::chrono::milliseconds recovery_grace_period;
 
+  // If true, epoch recovery doesn't read the digest from storage shards whose
+  // SEALED replies show that they store nothing past the last known good
+  // record, e.g. because the previous sequencer drained the epoch.
+  bool recovery_skip_digest_of_drained_epochs;
+
   // Amount of time we wait before we report a read stream that is
   // considered stuck.
   std::chrono::milliseconds reader_stuck_threshold;
@@ -462,6 +559,13 @@ struct Settings : public SettingsBundle {
   // procedure is restarted from scratch.
   std::chrono::seconds recovery_timeout;
 
+  // If positive, SEALs that log recoveries on a Worker send to the same
+  // storage node within this window are coalesced into a MULTI_SEAL message.
+  std::chrono::microseconds seal_batching_window;
+
+  // A batch of SEALs is sent right away once it has this many SEALs.
+  size_t seal_batching_max_seals;
+
   // Initial retry timeout used for checking if the latest metadata log record
   // is fully replicated during log recovery.
   chrono_expbackoff_t<std::chrono::milliseconds> recovery_seq_metadata_timeout;
@@ -475,6 +579,11 @@ struct Settings : public SettingsBundle {
   // reactivation
   size_t appender_buffer_queue_cap;
 
+  // Total size in bytes of the Appender objects buffered in AppenderBuffer
+  // across all workers. Each log can use at most a fair share of it.
+  // 0 means no limit.
+  size_t appender_buffer_max_bytes;
+
   // In case AppenderBuffer is sufficiently large, we need to process Appenders
   // in batch and periodically return to libevent to prevent running out of
   // send buffers. This indicates the batch size of number of Appenders to be
@@ -514,12 +623,25 @@ struct Settings : public SettingsBundle {
   // log store and the sequencer
   std::chrono::microseconds log_state_recovery_interval;
 
+  // Data logs with IDs below this, and their metadata logs, have their
+  // LogStorageStates in a dense array instead of a hash map.
+  size_t log_storage_state_dense_logs;
+
   // how long to wait for a single node to respond to the GET_SEQ_STATE message
   std::chrono::milliseconds get_seq_state_reply_timeout;
 
   // Exponential Backoff Timer for GET_SEQ_STATE request.
   chrono_expbackoff_t<std::chrono::milliseconds> seq_state_backoff_time;
 
+  // If positive, GET_SEQ_STATEs of batchable GetSeqStateRequests that a Worker
+  // sends to the same sequencer node within this window are coalesced into a
+  // MULTI_GET_SEQ_STATE message.
+  std::chrono::microseconds seq_state_batching_window;
+
+  // A batch of GET_SEQ_STATEs is sent right away once it has this many
+  // requests.
+  size_t seq_state_batching_max_requests;
+
   // Minium timeout for a CheckSealRequest
   std::chrono::milliseconds check_seal_req_min_timeout;
 
@@ -539,6 +661,14 @@ struct Settings : public SettingsBundle {
   // (client-only setting) If true, executes a GetClusterState at Processor
   // creation
   bool enable_initial_get_cluster_state;
+
+  // (client-only setting) If true, the client asks the node that answers its
+  // GET_CLUSTER_STATE to push it the cluster state whenever it changes.
+  bool enable_cluster_state_push;
+
+  // (server-only setting) Changes of the cluster state that happen within
+  // this delay of each other are pushed to subscribed clients together.
+  std::chrono::milliseconds cluster_state_push_delay;
   std::vector<node_index_t> test_get_cluster_state_recipients_;
 
   // (client-only setting) Determines how long before a request to fetch the
@@ -560,10 +690,36 @@ struct Settings : public SettingsBundle {
   // but also wire chatter.
   double client_read_flow_control_threshold;
 
+  // size read stream windows to the drain rate of the application times the
+  // round trip time of WINDOW messages instead of growing them up to
+  // client_read_buffer_size
+  bool client_read_window_autotune;
+
+  // payload bytes that read streams of a worker can buffer before they start
+  // shrinking their windows; 0 means no limit
+  size_t client_read_buffered_bytes_limit;
+
+  // hand records over from read streams to Reader in batches instead of one
+  // queue entry per record
+  bool client_read_batch_handoff;
+
+  // see --client-read-rewind-spread
+  std::chrono::milliseconds client_read_rewind_spread;
+
+  // (client-only setting) If true, AsyncReaders of the same log in one client
+  // that read with the same options share one read stream to storage shards
+  // and get records fanned out locally. See AllClientReadStreams.
+  bool client_read_stream_sharing;
+
   // (client-only setting) maximum number of epoch metadata entries cached in
   // the client. Set it to 0 to disable epoch metadata caching
   size_t client_epoch_metadata_cache_size;
 
+  // (client-only setting) If true, read streams of the same log that miss
+  // the epoch metadata cache at the same time share one read of the metadata
+  // log
+  bool client_share_epoch_metadata_fetches;
+
   // (client-only setting) Period for logging in logdevice_readers_flow scuba
   // table. Set it to 0 to disable feature.
   std::chrono::milliseconds client_readers_flow_tracer_period;
@@ -607,6 +763,11 @@ struct Settings : public SettingsBundle {
   // mutations to.
   std::chrono::milliseconds mutation_timeout;
 
+  // If true, the first wave of mutations of an epoch recovery is sent to each
+  // node in MULTI_STORE messages, and storage nodes batch their MUTATED
+  // replies in MULTI_MUTATED messages
+  bool recovery_mutation_batching;
+
   // DEPRECATED. Can be removed when all configs use --enable-sticky-copysets
   // and --write-copyset-index instead
   bool write_sticky_copysets_deprecated;
@@ -627,6 +788,15 @@ struct Settings : public SettingsBundle {
   // invalidating them.
   std::chrono::milliseconds iterator_cache_ttl;
 
+  // If true, read streams of a worker that read the same log from the same
+  // shard share an IteratorCache.
+  bool share_read_iterators;
+
+  // Read streams that are caught up and have had nothing to read for this
+  // long release their iterator cache and record buffers until a RELEASE or
+  // WINDOW wakes them up. 0 disables hibernation.
+  std::chrono::milliseconds server_read_stream_hibernate_after;
+
   // Maximum version of the protocol to use on this client/server.
   // Intented to be used for testing.
   uint16_t max_protocol;
@@ -722,12 +892,19 @@ struct Settings : public SettingsBundle {
   // the root znodes should be created by external tooling.
   bool zk_create_root_znodes;
 
+  // Maximum number of conditional znode writes that ZookeeperEpochStore
+  // groups into a single ZooKeeper multi-op transaction. 1 disables batching.
+  size_t zk_epoch_store_write_batch_max_ops;
+
   // Maximum amount of memory that can be allocated by read storage tasks.
   size_t read_storage_tasks_max_mem_bytes;
 
   size_t append_stores_max_mem_bytes;
   size_t rebuilding_stores_max_mem_bytes;
 
+  // Limit on the total memory tracked by MemoryGovernor. 0 means no limit.
+  size_t memory_governor_limit_bytes;
+
   // Path to LD SSL-certificate
   std::string ssl_cert_path;
 
@@ -742,6 +919,19 @@ struct Settings : public SettingsBundle {
   // TTL for the cert loaded from file
   std::chrono::seconds ssl_cert_refresh_interval;
 
+  // If true, SSL connections hand their keys to kernel TLS after the
+  // handshake, when supported
+  bool ssl_kernel_tls;
+
+  // If true, outgoing SSL connections try to resume the TLS session of the
+  // previous connection to the same address, and servers issue session
+  // tickets encrypted with the key in ssl_session_ticket_key_path
+  bool ssl_session_resumption;
+
+  // File with the 48-byte session ticket key shared by all servers of the
+  // cluster. If empty, every server generates its own key
+  std::string ssl_session_ticket_key_path;
+
   // Sets the boundary which triggers enabling SSL. Communication that crosses
   // this boundary will be encrypted; communication that doesn't will not.
   // For instance, if set to NodeLocationScope::RACK, all cross-rack traffic
@@ -760,6 +950,13 @@ struct Settings : public SettingsBundle {
   // See man ioprio_set for possible values.
   folly::Optional<std::pair<int, int>> slow_ioprio;
 
+  // IO priority to request for 'fast' storage threads.
+  folly::Optional<std::pair<int, int>> fast_ioprio;
+
+  // IO priority that a storage thread switches to while it's running a
+  // rebuilding storage task.
+  folly::Optional<std::pair<int, int>> rebuilding_ioprio;
+
   // (client-only setting) Timeout after which ClientReadStream considers a
   // storage node down if it does not send any data for some time but the socket
   // to it remains open. This can happen if:
@@ -824,6 +1021,14 @@ struct Settings : public SettingsBundle {
   // fetch
   std::chrono::milliseconds nodes_configuration_init_timeout;
 
+  // If not empty, clients keep the last NodesConfiguration and LogsConfig they
+  // saw in this directory and start with them, see ClientBootstrapCache.
+  std::string client_bootstrap_cache_dir;
+
+  // Logs whose sequencer nodes clients connect to as soon as they start, so
+  // that the first appends don't wait for connections to be established.
+  std::vector<logid_t> prewarm_connections_for_logs;
+
   // Flag indicating whether tcp keep alive should be on.
   bool use_tcp_keep_alive;
 
@@ -903,11 +1108,58 @@ struct Settings : public SettingsBundle {
   // batching and recompressing would be small.
   ssize_t sequencer_batching_passthru_threshold;
 
+  // If positive, sequencer batching is also used for logs that don't have it
+  // enabled, while their sequencer receives at least this many appends per
+  // second.  Only appends with payloads of at most
+  // sequencer_batching_auto_max_payload_size bytes are batched; such batches
+  // are flushed after sequencer_batching_auto_time_trigger.  This amortizes
+  // the per-Appender costs (timers, sliding window slot, wave of STOREs)
+  // for logs with many tiny appends.
+  size_t sequencer_batching_auto_threshold;
+  size_t sequencer_batching_auto_max_payload_size;
+  std::chrono::milliseconds sequencer_batching_auto_time_trigger;
+
+  // If true, sequencer batching tunes the options of each log's batches to
+  // the log's recent append rate: the time trigger is capped at
+  // sequencer_batching_adaptive_latency_budget, the size trigger is what the
+  // log is expected to receive within that time, and compression is turned
+  // off for batches expected to be smaller than
+  // sequencer_batching_adaptive_compression_threshold bytes.  Appends to logs
+  // too slow for batches to form within the budget are passed through.
+  bool sequencer_batching_adaptive;
+  std::chrono::milliseconds sequencer_batching_adaptive_latency_budget;
+  size_t sequencer_batching_adaptive_compression_threshold;
+
+  // If positive, TRIMs of TrimRequests issued by Client::trimBatch() that a
+  // Worker sends to the same storage node within this window are coalesced
+  // into a MULTI_TRIM message.
+  std::chrono::microseconds trim_batching_window;
+
+  // A batch of TRIMs is sent right away once it has this many trims.
+  size_t trim_batching_max_trims;
+
+  // If positive, IS_LOG_EMPTYs and DATA_SIZEs of requests issued by
+  // Client::isLogEmptyBatch() and Client::dataSizeBatch() that a Worker sends
+  // to the same storage node within this window are coalesced into a
+  // MULTI_IS_LOG_EMPTY or MULTI_DATA_SIZE message.
+  std::chrono::microseconds log_query_batching_window;
+
+  // A batch of IS_LOG_EMPTYs or DATA_SIZEs is sent right away once it has
+  // this many queries.
+  size_t log_query_batching_max_queries;
+
   // Number of background threads.  Currently, background threads are used by
   // BufferedWriter to construct/compress large batches.  If 0 (the default),
   // use num_workers.
   int num_processor_background_threads;
 
+  // Number of threads in the pool that storage node Workers hand CPU-bound
+  // work to (see CPUOffloadPool). 0 runs that work inline on Workers.
+  int cpu_offload_threads;
+
+  // Maximum number of pieces of work waiting for a CPU offload thread.
+  size_t cpu_offload_queue_size;
+
   // BufferedWriter can send batches to a background thread.  For small batches,
   // where the overhead dominates, this will just slow things down.  If the
   // total size of the batch is less than this, it will constructed / compressed
@@ -915,9 +1167,21 @@ struct Settings : public SettingsBundle {
   // larger, it will be enqueued to a helper thread.
   size_t buffered_writer_bg_thread_bytes_threshold;
 
+  // AsyncReader decompresses buffered writes at least this large on a
+  // background thread instead of the Worker thread.  0 disables.
+  size_t buffered_writer_decode_bg_thread_bytes_threshold;
+
   // Zstd compression level to use in BufferedWriter
   size_t buffered_writer_zstd_level;
 
+  // Directory with trained zstd dictionaries to register with
+  // ZstdDictionaries on startup.  Empty for none.
+  std::string zstd_dictionaries_dir;
+
+  // ID of the zstd dictionary sequencer batching compresses with, if
+  // sequencer_batching_compression is zstd.  0 for none.
+  size_t sequencer_batching_zstd_dictionary_id;
+
   // Maximum number of tasks we can queue to a Processor's background thread
   // pool.  A single queue is shared by all threads in a single Processor's
   // pool.
@@ -941,6 +1205,10 @@ struct Settings : public SettingsBundle {
   // a request to run FlowGroups and Sender::runFlowGroups() executing.
   std::chrono::microseconds flow_groups_run_deadline;
 
+  // If true, the TrafficShaper moves bandwidth between priorities of a
+  // FlowGroup based on their backlog, see AdaptiveFlowGroupPolicy.
+  bool traffic_shaping_adaptive;
+
   // TODO T29642728, DEPRECATED and will remove finally
   // How often the sequencer sends byte offsets to storage nodes. Measured in
   // bytes. This option will be ignored if byte_offsets feature is disabled.
@@ -958,6 +1226,11 @@ struct Settings : public SettingsBundle {
   // and use HHWheelTimer backend.
   bool enable_hh_wheel_backed_timers;
 
+  // If true, Timers created on Workers run on a per-Worker hierarchical timing
+  // wheel (see TimerWheel) instead of libevent's timer heap.  Takes
+  // precedence over enable_hh_wheel_backed_timers.
+  bool enable_worker_timer_wheel;
+
   // If true, use the new version of timers which run on a different thread
   // and use HHWheelTimer backend.
   bool enable_store_histogram_calculations;
@@ -971,6 +1244,11 @@ struct Settings : public SettingsBundle {
   // version
   bool enable_config_synchronization;
 
+  // (server-only setting) Maximum number of CONFIG_CHANGED messages with the
+  // full config that may be queued or in flight to clients with a stale
+  // config at the same time. Clients over the limit get the config later.
+  size_t max_config_changed_in_flight;
+
   // If true, servers will be allowed to fetch configs from the client side of
   // a connection.
   bool client_config_fetch_allowed;
@@ -1094,6 +1372,9 @@ struct Settings : public SettingsBundle {
   bool enable_logsconfig_manager;
   // Grace period before populating new LogsConfigTree upon receiving RSM delta
   std::chrono::milliseconds logsconfig_manager_grace_period;
+  // Keep the LogsConfig snapshot serialized on clients and only deserialize
+  // the log groups that are looked up
+  bool logsconfig_lazy_materialization;
 
   // Enable automatic snapshotting of LogsConfig in the replicated state machine
   bool logsconfig_snapshotting;
@@ -1138,6 +1419,27 @@ struct Settings : public SettingsBundle {
 
   NodeLocationScope copyset_locality_min_scope;
 
+  // If true, WeightedCopySetSelector steers copies away from shards whose
+  // recent STORE latency and queue depth, as seen by this worker, are worse
+  // than those of their peers. See ShardLatencyTracker.
+  bool adaptive_copyset_selection;
+
+  // Half-life of the latency averages used by adaptive copyset selection, and
+  // of their decay back to the average of all shards when a shard stops
+  // getting replies.
+  std::chrono::milliseconds adaptive_copyset_selection_half_life;
+
+  // If true, an Appender missing only one copy sends a new wave once its
+  // current one is late by the standards of WorkerTimeoutStats, instead of
+  // waiting for the store timeout.
+  bool store_hedging;
+
+  // Multiple of the median STORE latency after which store hedging kicks in.
+  double store_hedging_latency_multiplier;
+
+  // Lower bound on how long store hedging waits for the last copy.
+  std::chrono::milliseconds store_hedging_min_delay;
+
   // Defaults to false, allows clients to opt-in to traffic shadowing
   bool traffic_shadow_enabled;
 
@@ -1148,6 +1450,13 @@ struct Settings : public SettingsBundle {
   // See .cpp
   std::chrono::milliseconds shadow_client_timeout;
 
+  // Maximum number of shadow appends waiting to be posted to shadow clients.
+  // Shadow appends that don't fit are dropped.
+  size_t shadow_append_queue_size;
+
+  // Number of threads posting shadow appends to shadow clients.
+  size_t shadow_append_threads;
+
   // Defaults to false, should only be set by traffic shadowing framework
   bool shadow_client;
 
@@ -1207,6 +1516,21 @@ struct Settings : public SettingsBundle {
   // entries.
   size_t real_time_eviction_threshold_bytes;
 
+  // (server-only setting) Per log and per worker, keep up to this many bytes
+  // of the most recently released records after they have been handed to
+  // read streams, so that readers slightly behind the tail can be served
+  // from memory.  Counts against real_time_max_bytes.  0 disables the tier.
+  size_t real_time_tail_bytes_per_log;
+
+  // (server-only setting) Readahead size for the iterators that catch-up
+  // readers use on storage threads. 0 leaves readahead up to RocksDB.
+  size_t catchup_readahead_size;
+
+  // (server-only setting) If positive, records that catching up readers read
+  // on storage threads are sent in RECORD_BATCH messages of about this many
+  // bytes of payload. 0 sends every record in its own RECORD message.
+  size_t record_batch_max_bytes;
+
   // Test Options:
 
   // This option should only be used in tests. This is used to linerarly
@@ -1219,6 +1543,8 @@ struct Settings : public SettingsBundle {
 
   // When set, serialize ShardIDs instead of node_index_t on disk.
   bool write_shard_id_in_copyset;
+  // When set, records are written in the v2 on-disk format.
+  bool write_record_format_v2;
   // When set, new EpochMetaData is serialized using the new copyset
   // serialization format for Flexible Log Sharding.
   // TODO(T15517759): once all clusters are configured to use this option,
@@ -1240,16 +1566,26 @@ struct Settings : public SettingsBundle {
   SockaddrSet message_tracing_peers;
   dbg::Level message_tracing_log_level;
   bool rsm_include_read_pointer_in_snapshot;
+  size_t rsm_max_delta_snapshots;
+  size_t rsm_snapshot_chunk_size;
   std::chrono::milliseconds eventlog_snapshotting_period;
   std::chrono::milliseconds logsconfig_snapshotting_period;
 
   // polling interval for fetching trim point from historical node set
   std::chrono::seconds get_trimpoint_interval;
 
+  // storage nodes push trim point advances to sequencer nodes
+  bool push_trim_points;
+
   folly::Optional<std::chrono::milliseconds> findkey_timeout;
 
   folly::Optional<std::chrono::milliseconds> append_timeout;
 
+  // If positive, appends are routed to Workers by the node that
+  // HashBasedSequencerLocator maps the log to, each sequencer node getting
+  // this many Workers. 0 routes appends by posting thread and log id.
+  size_t append_workers_per_sequencer;
+
   folly::Optional<std::chrono::milliseconds> logsconfig_timeout;
 
   folly::Optional<std::chrono::milliseconds> meta_api_timeout;
@@ -1269,6 +1605,13 @@ struct Settings : public SettingsBundle {
   std::chrono::milliseconds nodeset_adjustment_min_window;
   size_t nodeset_max_randomizations;
 
+  // Load-based sequencer placement, see SequencerBackgroundActivator.
+  std::chrono::milliseconds sequencer_placement_period;
+  size_t sequencer_placement_max_node_bytes_per_sec;
+  size_t sequencer_placement_overloaded_periods;
+  size_t sequencer_placement_max_handoffs;
+  std::chrono::milliseconds sequencer_placement_hold;
+
   // Use metadata logs in NodeSetFinder if true, otherwise use sequencers
   // (metadata logs v2) and fallback to metadata logs if needed.
   // TODO: set default to false (or remove option) when 2.35 is deployed
@@ -1281,6 +1624,9 @@ struct Settings : public SettingsBundle {
   // enforcing permissions on the given message types if supported.
   std::unordered_set<MessageType> require_permission_message_types;
 
+  // maximum number of permission decisions cached per worker
+  size_t permission_decision_cache_size;
+
  protected:
   // Only UpdateableSettings can create this bundle to ensure defaults are
   // populated.
@@ -23,6 +23,7 @@
 #include <folly/Conv.h>
 #include <folly/Format.h>
 #include <folly/Likely.h>
+#include <folly/lang/Bits.h>
 #include <folly/small_vector.h>
 #include <folly/stats/Histogram.h>
 
@@ -248,6 +249,26 @@ class LockGuardPair {
  private:
   std::lock_guard<std::mutex> g1_, g2_;
 };
+
+// Formats `value' using the largest unit in `scale' that is not bigger than
+// it, e.g. "1.500 ms".
+std::string formatValue(int64_t value,
+                        const std::vector<MultiScaleHistogram::Scale>& scale) {
+  const MultiScaleHistogram::Scale* found = nullptr;
+  for (auto& i : scale) {
+    if (value < i.unit && i.unit > 1) {
+      break;
+    }
+    found = &i;
+  }
+  const double d = found ? 1. * value / found->unit : 1. * value;
+  std::string s = value < 0 ? "< 0" : folly::sformat("{:.3f}", d);
+  if (found && found->unit_name[0] != '\0') {
+    s += " ";
+    s += found->unit_name;
+  }
+  return s;
+}
 } // namespace
 
 MultiScaleHistogram::~MultiScaleHistogram() = default;
@@ -492,20 +513,7 @@ std::string MultiScaleHistogram::getUnitName() const {
 }
 
 std::string MultiScaleHistogram::valueToString(int64_t value) const {
-  const Scale* found = nullptr;
-  for (auto& i : *scale_) {
-    if (value < i.unit && i.unit > 1) {
-      break;
-    }
-    found = &i;
-  }
-  const double d = found ? 1. * value / found->unit : 1. * value;
-  std::string s = value < 0 ? "< 0" : folly::sformat("{:.3f}", d);
-  if (found && found->unit_name[0] != '\0') {
-    s += " ";
-    s += found->unit_name;
-  }
-  return s;
+  return formatValue(value, *scale_);
 }
 
 std::map<std::string, std::string>
@@ -736,4 +744,218 @@ void MultiScaleHistogram::mergeStagedValues() {
     }
   });
 }
+
+namespace {
+// Subtracts `value' from `counter' without going below zero, like
+// MultiScaleHistogram::subtract() does.
+template <typename T>
+void subtractSaturating(std::atomic<T>& counter, T value) {
+  T cur = counter.load(std::memory_order_relaxed);
+  while (!counter.compare_exchange_weak(
+      cur, cur - std::min(value, cur), std::memory_order_relaxed)) {
+  }
+}
+} // namespace
+
+CompactHistogram::CompactHistogram(
+    const std::vector<MultiScaleHistogram::Scale>* scale)
+    : scale_(scale) {
+  clear();
+}
+
+CompactHistogram::CompactHistogram(const CompactHistogram& rhs)
+    : scale_(rhs.scale_) {
+  assign(rhs);
+}
+
+CompactHistogram& CompactHistogram::operator=(const CompactHistogram& rhs) {
+  if (this != &rhs) {
+    assign(rhs);
+  }
+  return *this;
+}
+
+size_t CompactHistogram::bucketIndex(int64_t value) {
+  if (value < static_cast<int64_t>(SUB_BUCKETS)) {
+    return value < 0 ? 0 : value;
+  }
+  // Keep the SUB_BUCKET_BITS bits following the most significant one.
+  const size_t shift =
+      folly::findLastSet(static_cast<uint64_t>(value)) - 1 - SUB_BUCKET_BITS;
+  return (shift + 1) * SUB_BUCKETS +
+      ((static_cast<uint64_t>(value) >> shift) & (SUB_BUCKETS - 1));
+}
+
+int64_t CompactHistogram::bucketMin(size_t idx) {
+  ld_check(idx < NUM_BUCKETS);
+  if (idx < SUB_BUCKETS) {
+    return idx;
+  }
+  const size_t shift = idx / SUB_BUCKETS - 1;
+  return static_cast<int64_t>(SUB_BUCKETS + idx % SUB_BUCKETS) << shift;
+}
+
+int64_t CompactHistogram::bucketWidth(size_t idx) {
+  ld_check(idx < NUM_BUCKETS);
+  return idx < SUB_BUCKETS ? 1 : int64_t(1) << (idx / SUB_BUCKETS - 1);
+}
+
+void CompactHistogram::clear() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+}
+
+void CompactHistogram::add(int64_t value) {
+  buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+void CompactHistogram::assign(const HistogramInterface& other_if) {
+  auto& other = dynamic_cast<const CompactHistogram&>(other_if);
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    buckets_[i].store(other.buckets_[i].load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+  }
+  count_.store(
+      other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  sum_.store(
+      other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  scale_ = other.scale_;
+}
+
+void CompactHistogram::merge(const HistogramInterface& other_if) {
+  auto& other = dynamic_cast<const CompactHistogram&>(other_if);
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    // Most buckets are usually empty. Skipping them saves an atomic
+    // read-modify-write and keeps the cache lines of this histogram clean.
+    const uint64_t n = other.buckets_[i].load(std::memory_order_relaxed);
+    if (n != 0) {
+      buckets_[i].fetch_add(n, std::memory_order_relaxed);
+    }
+  }
+  count_.fetch_add(
+      other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  sum_.fetch_add(
+      other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void CompactHistogram::subtract(const HistogramInterface& other_if) {
+  auto& other = dynamic_cast<const CompactHistogram&>(other_if);
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    const uint64_t n = other.buckets_[i].load(std::memory_order_relaxed);
+    if (n != 0) {
+      subtractSaturating(buckets_[i], n);
+    }
+  }
+  subtractSaturating(count_, other.count_.load(std::memory_order_relaxed));
+  subtractSaturating(sum_, other.sum_.load(std::memory_order_relaxed));
+}
+
+uint64_t CompactHistogram::snapshotBuckets(Buckets& out) const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    out[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += out[i];
+  }
+  return total;
+}
+
+void CompactHistogram::estimatePercentiles(const double* percentiles,
+                                           size_t npercentiles,
+                                           int64_t* samples_out,
+                                           uint64_t* count_out,
+                                           int64_t* sum_out) const {
+  if (count_out) {
+    *count_out = count_.load(std::memory_order_relaxed);
+  }
+  if (sum_out) {
+    *sum_out = sum_.load(std::memory_order_relaxed);
+  }
+
+  if (npercentiles == 0) {
+    return;
+  }
+
+  // Input percentiles must be sorted and in valid range [0.0, 1.0].
+  ld_check(std::is_sorted(percentiles, percentiles + npercentiles));
+  ld_check(std::all_of(percentiles, percentiles + npercentiles, [](double p) {
+    return p >= 0.0 && p <= 1.0;
+  }));
+
+  // Work on a copy of the buckets so that concurrent add()s don't make the
+  // counts inconsistent with the total. count_ can't be used as the total
+  // for the same reason.
+  Buckets counts;
+  const uint64_t total = snapshotBuckets(counts);
+  if (total == 0) {
+    std::fill_n(samples_out, npercentiles, 0);
+    return;
+  }
+  size_t last = NUM_BUCKETS - 1;
+  while (counts[last] == 0) {
+    --last;
+  }
+
+  // Walk the buckets once, stopping at the first non-empty bucket where the
+  // cumulative count reaches the rank of each percentile, and interpolate
+  // linearly inside that bucket.
+  size_t idx = 0;
+  uint64_t below = 0;
+  for (size_t pct_idx = 0; pct_idx < npercentiles; ++pct_idx) {
+    const double rank = percentiles[pct_idx] * total;
+    while (idx < last && (counts[idx] == 0 || below + counts[idx] < rank)) {
+      below += counts[idx];
+      ++idx;
+    }
+    const double frac = std::max(
+        0.0, std::min(1.0, (rank - below) / static_cast<double>(counts[idx])));
+    samples_out[pct_idx] = bucketMin(idx) +
+        static_cast<int64_t>(frac * (bucketWidth(idx) - 1));
+  }
+}
+
+void CompactHistogram::print(std::ostream& out) const {
+  std::vector<Percentile> percentiles{
+      {0.5, 0, -1}, {0.75, 0, -1}, {0.95, 0, -1}, {0.99, 0, -1}};
+
+  Buckets counts;
+  const uint64_t total = snapshotBuckets(counts);
+
+  uint64_t cumulative = 0;
+  size_t pct_idx = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    if (counts[i] == 0) {
+      continue;
+    }
+
+    cumulative += counts[i];
+    while (pct_idx < percentiles.size() &&
+           cumulative >= percentiles[pct_idx].pct * total) {
+      percentiles[pct_idx++].bucket = i;
+    }
+
+    const int64_t lo = bucketMin(i);
+    const int64_t width = bucketWidth(i);
+    std::string label = valueToString(lo);
+    if (width > 1) {
+      label += " .. " + valueToString(lo + (width - 1));
+    }
+    out << std::setw(30) << std::right << label << std::setw(1) << " : "
+        << std::setw(10) << std::left << counts[i] << std::setw(1)
+        << percentilesInBucketStr(percentiles, 0, i) << std::endl;
+  }
+}
+
+std::string CompactHistogram::getUnitName() const {
+  return scale_->empty() ? "" : (*scale_)[0].unit_name;
+}
+
+std::string CompactHistogram::valueToString(int64_t value) const {
+  return formatValue(value, *scale_);
+}
+
 }} // namespace facebook::logdevice
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <iosfwd>
@@ -29,8 +30,12 @@ namespace facebook { namespace logdevice {
  *
  * HistogramInterface is a common interface for the histograms, allowing to
  * add values, merge/subtract histograms and get percentiles.
- * For now MultiScaleHistogram is the only implementation, but I'm going to
- * add another one very soon.
+ * There are two implementations:
+ *  - MultiScaleHistogram, a collection of folly::Histogram's with
+ *    configurable boundaries, which can be converted to and from a map
+ *    (see toMap()) for persistence,
+ *  - CompactHistogram, a log-linear histogram with a fixed array of atomic
+ *    counters, which is cheaper to add to and to merge.
  *
  * Each implementation has multiple subclasses for different units
  * of measurement. They define how the histograms are presented
@@ -337,10 +342,11 @@ class LatencyHistogram final : public MultiScaleHistogram {
                    const std::string& prefix,
                    int64_t usec_max = USEC_MAX);
 
+  // Also used by CompactLatencyHistogram.
+  static const std::vector<Scale>* getScales();
+
  private:
   static std::vector<LinearHistogram> createHistograms(int64_t usec_max);
-
-  static const std::vector<Scale>* getScales();
 };
 
 // Histogram for tracking sizes. Bucket sizes are
@@ -358,10 +364,11 @@ class SizeHistogram final : public MultiScaleHistogram {
                 const std::string& prefix,
                 int64_t bytes_max = BYTES_MAX);
 
+  // Also used by CompactSizeHistogram.
+  static const std::vector<Scale>* getScales();
+
  private:
   static std::vector<LinearHistogram> createHistograms(int64_t bytes_max);
-
-  static const std::vector<Scale>* getScales();
 };
 
 // Histogram for trimmed record age in seconds. Bucket sizes are
@@ -403,4 +410,99 @@ class NoUnitHistogram final : public MultiScaleHistogram {
   static const std::vector<Scale>* getScales();
 };
 
+/**
+ * A log-linear histogram in the spirit of HdrHistogram: each power of two is
+ * divided into SUB_BUCKETS equal buckets, which bounds the relative error of
+ * percentile estimates by 1/SUB_BUCKETS while covering the whole range of
+ * int64_t with a fixed number of buckets. Negative values are counted in the
+ * first bucket.
+ *
+ * Unlike MultiScaleHistogram, all methods are lock-free: buckets, count and
+ * sum are relaxed atomic counters. add() is a handful of instructions and
+ * can be called by multiple threads concurrently. merge() is a single pass
+ * over the bucket array. Readers see every value added before the read
+ * started, but a value added concurrently may be reflected in some counters
+ * and not yet in others.
+ *
+ * All CompactHistograms have the same bucket layout, so they can be merged
+ * with each other regardless of the subclass; the subclass only defines how
+ * values are presented.
+ */
+class CompactHistogram : public HistogramInterface {
+ public:
+  static constexpr size_t SUB_BUCKET_BITS = 4;
+  static constexpr size_t SUB_BUCKETS = 1ul << SUB_BUCKET_BITS;
+  // Values below SUB_BUCKETS get one bucket each; each following power of
+  // two up to 2^62 gets SUB_BUCKETS buckets.
+  static constexpr size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+  /**
+   * Copy constructor and copy assignment. Thread-safe.
+   */
+  CompactHistogram(const CompactHistogram& rhs);
+  CompactHistogram& operator=(const CompactHistogram& rhs);
+
+  /**
+   * @return  Index of the bucket `value' falls in.
+   */
+  static size_t bucketIndex(int64_t value);
+
+  /**
+   * @return  Smallest value counted in bucket `idx'.
+   */
+  static int64_t bucketMin(size_t idx);
+
+  /**
+   * @return  Number of distinct values counted in bucket `idx'.
+   */
+  static int64_t bucketWidth(size_t idx);
+
+  // HistogramInterface implementation.
+  void clear() override;
+  void add(int64_t value) override;
+  void assign(const HistogramInterface& other) override;
+  void merge(const HistogramInterface& other) override;
+  void subtract(const HistogramInterface& other) override;
+  void estimatePercentiles(const double* percentiles,
+                           size_t npercentiles,
+                           int64_t* samples_out,
+                           uint64_t* count_out = nullptr,
+                           int64_t* sum_out = nullptr) const override;
+  void print(std::ostream& out) const override;
+  std::string getUnitName() const override;
+  std::string valueToString(int64_t value) const override;
+
+ protected:
+  explicit CompactHistogram(
+      const std::vector<MultiScaleHistogram::Scale>* scale);
+
+ private:
+  using Buckets = std::array<uint64_t, NUM_BUCKETS>;
+
+  /**
+   * Copies bucket counters into `out' and returns their sum.
+   */
+  uint64_t snapshotBuckets(Buckets& out) const;
+
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<int64_t> sum_{0};
+
+  // Used for presentation only, see MultiScaleHistogram::Scale.
+  const std::vector<MultiScaleHistogram::Scale>* scale_;
+};
+
+// CompactHistogram of latencies in microseconds.
+class CompactLatencyHistogram final : public CompactHistogram {
+ public:
+  CompactLatencyHistogram()
+      : CompactHistogram(LatencyHistogram::getScales()) {}
+};
+
+// CompactHistogram of sizes in bytes.
+class CompactSizeHistogram final : public CompactHistogram {
+ public:
+  CompactSizeHistogram() : CompactHistogram(SizeHistogram::getScales()) {}
+};
+
 }} // namespace facebook::logdevice
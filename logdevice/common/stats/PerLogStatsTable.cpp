@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/PerLogStatsTable.h"
+
+#include <folly/lang/Bits.h>
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+void PerLogCounters::reset() {
+#define STAT_DEFINE(name, _) name = 0;
+#include "logdevice/common/stats/per_log_stats.inc" // nolint
+}
+
+PerLogStatsTable::PerLogStatsTable() {
+  for (auto& chunk : chunks_) {
+    chunk.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+PerLogStatsTable::~PerLogStatsTable() {
+  for (auto& chunk : chunks_) {
+    delete[] chunk.load(std::memory_order_relaxed);
+  }
+}
+
+size_t PerLogStatsTable::chunkIndex(size_t group_idx, size_t* idx_in_chunk) {
+  // Chunk i starts at group kFirstChunkSize * (2^i - 1).
+  const size_t q = group_idx / kFirstChunkSize + 1;
+  const size_t chunk = folly::findLastSet(q) - 1;
+  *idx_in_chunk = group_idx - kFirstChunkSize * ((size_t(1) << chunk) - 1);
+  return chunk;
+}
+
+PerLogCounters*
+PerLogStatsTable::getSlow(logid_t log,
+                          uint64_t config_version,
+                          folly::Optional<std::string> log_group) {
+  if (config_version != configVersion_) {
+    // The logs config changed, logs may have moved between log groups.
+    index_.clear();
+    configVersion_ = config_version;
+  }
+  if (!log_group.hasValue()) {
+    return nullptr;
+  }
+
+  auto it = groupsByName_.find(log_group.value());
+  if (it == groupsByName_.end()) {
+    const size_t idx = numGroups_.load(std::memory_order_relaxed);
+    size_t idx_in_chunk;
+    const size_t chunk_idx = chunkIndex(idx, &idx_in_chunk);
+    ld_check(chunk_idx < kMaxChunks);
+    Group* chunk = chunks_[chunk_idx].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+      chunk = new Group[kFirstChunkSize << chunk_idx];
+      chunks_[chunk_idx].store(chunk, std::memory_order_release);
+    }
+    Group& group = chunk[idx_in_chunk];
+    group.name = log_group.value();
+    // Publish the group, including its name.
+    numGroups_.store(idx + 1, std::memory_order_release);
+    it = groupsByName_.emplace(std::move(log_group.value()), &group.counters)
+             .first;
+  }
+  index_.emplace(log.val_, it->second);
+  return it->second;
+}
+
+void PerLogStatsTable::forEach(
+    folly::FunctionRef<void(const std::string& log_group,
+                            const PerLogCounters& counters)> cb) const {
+  const size_t n = numGroups_.load(std::memory_order_acquire);
+  for (size_t idx = 0; idx < n; ++idx) {
+    size_t idx_in_chunk;
+    const size_t chunk_idx = chunkIndex(idx, &idx_in_chunk);
+    const Group* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+    ld_check(chunk != nullptr);
+    const Group& group = chunk[idx_in_chunk];
+    cb(group.name, group.counters);
+  }
+}
+
+void PerLogStatsTable::reset() {
+  // Counters are atomic, so the owner thread may keep bumping them meanwhile.
+  const size_t n = numGroups_.load(std::memory_order_acquire);
+  for (size_t idx = 0; idx < n; ++idx) {
+    size_t idx_in_chunk;
+    const size_t chunk_idx = chunkIndex(idx, &idx_in_chunk);
+    Group* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+    ld_check(chunk != nullptr);
+    chunk[idx_in_chunk].counters.reset();
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+
+#include <folly/Function.h>
+#include <folly/Likely.h>
+#include <folly/Optional.h>
+#include <folly/container/F14Map.h>
+#include <folly/lang/Align.h>
+
+#include "logdevice/common/stats/StatsCounter.h"
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Per-log-group counters of one thread-local Stats object that can be
+ *       bumped by log ID without taking any locks.
+ *
+ *       Stats::per_log_stats is keyed by log group name, so every
+ *       LOG_STAT_ADD() used to look up the log group path of the log in the
+ *       config, take the upgrade lock of the map and hash the path. Instead,
+ *       the owning thread keeps a private log ID -> counters index in front of
+ *       an append-only array of per-log-group counters, and only resolves the
+ *       log group path the first time it sees a log (and again after the
+ *       logs config changes). Readers (Stats::aggregate()) walk the array
+ *       concurrently with the owner thread appending to it, and fold the
+ *       counters into per_log_stats of the aggregated Stats object.
+ *
+ *       Each log group's counters occupy their own cache lines, so readers
+ *       and the owner thread don't false-share with neighbouring groups.
+ *
+ *       Only the owning thread may call get(); forEach() and reset() can be
+ *       called from any thread.
+ */
+
+/**
+ * Counters from per_log_stats.inc, for one log group.
+ */
+struct PerLogCounters {
+#define STAT_DEFINE(name, _) StatsCounter name{};
+#include "logdevice/common/stats/per_log_stats.inc" // nolint
+
+  void reset();
+};
+
+class PerLogStatsTable {
+ public:
+  PerLogStatsTable();
+  ~PerLogStatsTable();
+
+  PerLogStatsTable(const PerLogStatsTable&) = delete;
+  PerLogStatsTable& operator=(const PerLogStatsTable&) = delete;
+
+  /**
+   * @param config_version  Version of the logs config `resolve` uses. When
+   *                        it changes, the log ID -> log group mapping is
+   *                        forgotten and resolved again.
+   * @param resolve         Returns the log group path of `log`, or
+   *                        folly::none if it's unknown. Called only on index
+   *                        misses.
+   * @return counters of the log group of `log`, or nullptr if the log group
+   *         is unknown.
+   */
+  template <typename ResolveFn>
+  PerLogCounters*
+  get(logid_t log, uint64_t config_version, ResolveFn&& resolve);
+
+  /**
+   * Calls `cb` for each log group that has counters in this table. The
+   * callback may see counters of a group whose counts are all zero.
+   */
+  void forEach(
+      folly::FunctionRef<void(const std::string& log_group,
+                              const PerLogCounters& counters)> cb) const;
+
+  /**
+   * Sets all counters to zero. Log groups and the index are kept.
+   */
+  void reset();
+
+ private:
+  struct alignas(folly::hardware_destructive_interference_size) Group {
+    // Written before the group is published and never modified afterwards.
+    std::string name;
+    PerLogCounters counters;
+  };
+
+  // Groups are stored in chunks of geometrically growing size, so that
+  // appending never moves existing groups. Chunk i holds
+  // (kFirstChunkSize << i) groups.
+  static constexpr size_t kFirstChunkSize = 8;
+  static constexpr size_t kMaxChunks = 32;
+
+  static size_t chunkIndex(size_t group_idx, size_t* idx_in_chunk);
+
+  PerLogCounters* getSlow(logid_t log,
+                          uint64_t config_version,
+                          folly::Optional<std::string> log_group);
+
+  std::array<std::atomic<Group*>, kMaxChunks> chunks_;
+  // Number of published groups.
+  std::atomic<size_t> numGroups_{0};
+
+  // The rest is only accessed by the owner thread.
+  folly::F14FastMap<logid_t::raw_type, PerLogCounters*> index_;
+  std::unordered_map<std::string, PerLogCounters*> groupsByName_;
+  uint64_t configVersion_{0};
+};
+
+template <typename ResolveFn>
+PerLogCounters* PerLogStatsTable::get(logid_t log,
+                                      uint64_t config_version,
+                                      ResolveFn&& resolve) {
+  if (LIKELY(config_version == configVersion_)) {
+    auto it = index_.find(log.val_);
+    if (LIKELY(it != index_.end())) {
+      return it->second;
+    }
+  }
+  return getSlow(log, config_version, resolve());
+}
+
+}} // namespace facebook::logdevice
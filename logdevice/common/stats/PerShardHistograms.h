@@ -55,6 +55,11 @@ struct PerShardHistograms : public PerShardHistogramBundle {
         {"log_rebuilding_num_batches_per_window",
          &log_rebuilding_num_batches_per_window},
 
+        // Read path stages.
+        {"read_nonblocking", &read_nonblocking},
+        {"read_storage_task_round_trip", &read_storage_task_round_trip},
+        {"read_throttled", &read_throttled},
+
         // Queuing latencies for storage threads, one histogram per type of
         // storage thread.
         {"fast_storage_thread_queue_time",
@@ -77,6 +82,13 @@ struct PerShardHistograms : public PerShardHistogramBundle {
       {"queue_time." class_name,                                         \
        &storage_task_queue_time[static_cast<int>(StorageTaskType::name)]},
 #include "logdevice/common/storage_task_types.inc"
+
+    // Queueing latencies for storage tasks, by priority.
+#define STORAGE_TASK_PRIORITY(name, class_name)         \
+  {"queue_time_priority." class_name,                   \
+   &storage_task_priority_queue_time[static_cast<int>( \
+       StorageTaskPriority::name)]},
+#include "logdevice/common/storage_task_priorities.inc"
     };
   }
 
@@ -133,6 +145,15 @@ struct PerShardHistograms : public PerShardHistogramBundle {
   // Amount of batches read per local window in LogRebuilding.
   no_unit_histogram_t log_rebuilding_num_batches_per_window;
 
+  // Duration of non-blocking reads done by CatchupOneStream on workers.
+  latency_histogram_t read_nonblocking;
+  // Time from creating a ReadStorageTask to processing its result on the
+  // worker: storage task queueing, execution and the way back to the worker.
+  latency_histogram_t read_storage_task_round_trip;
+  // How long read streams stay throttled by read traffic shaping, waiting for
+  // bandwidth in ReadIoShapingCallback.
+  latency_histogram_t read_throttled;
+
   // Execution latencies for storage tasks (by storage task type)
   latency_histogram_t storage_tasks[static_cast<size_t>(StorageTaskType::MAX)];
   // Queueing latencies for storage tasks (by storage task type)
@@ -141,6 +162,9 @@ struct PerShardHistograms : public PerShardHistogramBundle {
   // Queueing latencies for storage threads (by storage thread type)
   latency_histogram_t storage_threads_queue_time[static_cast<size_t>(
       StorageTaskThreadType::MAX)];
+  // Queueing latencies for storage tasks (by storage task priority)
+  latency_histogram_t storage_task_priority_queue_time[static_cast<size_t>(
+      StorageTaskPriority::NUM_PRIORITIES)];
 };
 
 }} // namespace facebook::logdevice
@@ -24,6 +24,9 @@ struct ServerHistograms : public HistogramBundle {
   HistogramBundle::MapType getMap() override {
     return {
         {"append_latency", &append_latency},
+        {"append_start_latency", &append_start_latency},
+        {"append_retry_latency", &append_retry_latency},
+        {"append_wave_latency", &append_wave_latency},
         {"store_bw_wait_latency", &store_bw_wait_latency},
         {"write_to_read_latency", &write_to_read_latency},
         {"store_timeouts", &store_timeouts},
@@ -50,6 +53,9 @@ struct ServerHistograms : public HistogramBundle {
         {"logsconfig_manager_delta_apply_latency",
          &logsconfig_manager_delta_apply_latency},
         {"background_thread_duration", &background_thread_duration},
+        {"cpu_offload_task_duration", &cpu_offload_task_duration},
+        {"cpu_offload_queue_latency", &cpu_offload_queue_latency},
+        {"worker_event_loop_utilization", &worker_event_loop_utilization},
         {"nodes_configuration_manager_propagation_latency",
          &nodes_configuration_manager_propagation_latency},
 #define REQUEST_TYPE(name)              \
@@ -71,6 +77,15 @@ struct ServerHistograms : public HistogramBundle {
   // Latency of appends as seen by the sequencer
   LatencyHistogram append_latency;
 
+  // Breakdown of append_latency of successful appends into: time before the
+  // Appender is started (waiting in AppenderBuffer or for the sliding
+  // window), time between starting and sending the wave that succeeded
+  // (previous waves timing out or failing), and the duration of that last
+  // wave (STOREs in flight, storage nodes, STOREDs in flight).
+  LatencyHistogram append_start_latency;
+  LatencyHistogram append_retry_latency;
+  LatencyHistogram append_wave_latency;
+
   LatencyHistogram write_to_read_latency;
 
   LatencyHistogram store_bw_wait_latency;
@@ -134,6 +149,16 @@ struct ServerHistograms : public HistogramBundle {
 
   LatencyHistogram background_thread_duration;
 
+  // How long work handed to the CPU offload pool (see --cpu-offload-threads)
+  // took to run, and how long it waited for a thread.
+  LatencyHistogram cpu_offload_task_duration;
+  LatencyHistogram cpu_offload_queue_latency;
+
+  // Percentage of time that a general worker's event loop spent running
+  // requests and callbacks, sampled every 10 seconds for every worker. High
+  // percentiles show the busiest workers.
+  NoUnitHistogram worker_event_loop_utilization;
+
   // How long did it take between when the config is published and when it
   // was received on the server in msec.
   LatencyHistogram nodes_configuration_manager_propagation_latency;
@@ -257,6 +257,10 @@ Stats::Stats(const FastUpdateableSharedPtr<StatsParams>* params)
           params->get()->node_stats_retention_time_on_nodes}),
       params(params),
       worker_id(-1) {
+  per_log_stats_table = std::make_unique<PerLogStatsTable>();
+#define TIME_SERIES_DEFINE(name, _, __, ___) \
+  top_log_groups_##name = std::make_unique<TopLogGroups>();
+#include "logdevice/common/stats/per_log_time_series.inc" // nolint
   if (params->get()->is_server) {
     server_histograms = std::make_unique<ServerHistograms>();
     per_shard_histograms = std::make_unique<PerShardHistograms>();
@@ -423,6 +427,30 @@ void Stats::aggregateCompoundStats(Stats const& other,
         }
       });
 
+  // Fold other's lock-free per-log-group counters into per_log_stats.
+  if (other.per_log_stats_table) {
+    auto locked_per_log_stats = per_log_stats.wlock();
+    other.per_log_stats_table->forEach(
+        [&](const std::string& log_group, const PerLogCounters& counters) {
+          auto& stats_ptr = (*locked_per_log_stats)[log_group];
+          if (stats_ptr == nullptr) {
+            stats_ptr = std::make_shared<PerLogStats>();
+          }
+#define STAT_DEFINE(name, agg) \
+  aggregateStat(StatsAgg::agg, agg_override, stats_ptr->name, counters.name);
+#include "logdevice/common/stats/per_log_stats.inc" // nolint
+        });
+  }
+
+  // Top N throughput queries look at the time series of dead threads too, so
+  // keep their heavy log groups discoverable. Other aggregated Stats objects
+  // are never queried for throughput.
+  if (destroyed_threads) {
+#define TIME_SERIES_DEFINE(name, _, __, ___) \
+  top_log_groups_##name->merge(*other.top_log_groups_##name);
+#include "logdevice/common/stats/per_log_time_series.inc" // nolint
+  }
+
   // Aggregate per worker stats. Also use synchronizedCopy()
   this->per_worker_stats.withWLock(
       [&agg_override,
@@ -512,6 +540,11 @@ void Stats::reset() {
       per_worker_stats.wlock()->clear();
 
       per_log_stats.wlock()->clear();
+      if (per_log_stats_table) {
+        per_log_stats_table->reset();
+      }
+#define TIME_SERIES_DEFINE(name, _, __, ___) top_log_groups_##name->reset();
+#include "logdevice/common/stats/per_log_time_series.inc" // nolint
       break;
     case StatsParams::StatsSet::LDBENCH_WORKER:
 #define STAT_DEFINE(name, _) ldbench->name = {};
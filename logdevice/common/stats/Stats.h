@@ -31,7 +31,9 @@
 #include "logdevice/common/configuration/NodeLocation.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/MessageType.h"
+#include "logdevice/common/stats/PerLogStatsTable.h"
 #include "logdevice/common/stats/StatsCounter.h"
+#include "logdevice/common/stats/TopLogGroups.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/common/util.h"
 // Think twice before adding new includes here!  This file is included in many
@@ -857,6 +859,17 @@ struct Stats final {
       std::unordered_map<std::string, std::shared_ptr<PerLogStats>>>
       per_log_stats;
 
+  // Lock-free per-log-group counters updated by LOG_ID_STAT_ADD() on the
+  // owning thread. aggregate() folds them into per_log_stats of the result,
+  // so this is always empty in aggregated Stats objects.
+  std::unique_ptr<PerLogStatsTable> per_log_stats_table;
+
+  // Heaviest log groups of each per-log time series. Lets top N throughput
+  // queries skip most of per_log_stats. Never null.
+#define TIME_SERIES_DEFINE(name, _, __, ___) \
+  std::unique_ptr<TopLogGroups> top_log_groups_##name;
+#include "logdevice/common/stats/per_log_time_series.inc" // nolint
+
   // Server histograms. Initialized only on servers.
   std::unique_ptr<ServerHistograms> server_histograms;
 
@@ -1208,6 +1221,23 @@ class PerShardStatToken {
     }                                                                    \
   } while (0)
 
+// Same as LOG_GROUP_STAT_ADD() but looks up the log group by log ID in
+// Stats::per_log_stats_table without taking locks. `resolve` returns the log
+// group path of `log_id` (folly::Optional<std::string>) and is only called the
+// first time the thread sees the log after a logs config change.
+#define LOG_ID_STAT_ADD(                                               \
+    stats_struct, log_id, config_version, resolve, name, val)          \
+  do {                                                                 \
+    if (stats_struct) {                                                \
+      auto& table_ = *(stats_struct)->get().per_log_stats_table;       \
+      PerLogCounters* counters_ =                                      \
+          table_.get((log_id), (config_version), resolve);             \
+      if (counters_) {                                                 \
+        counters_->name += (val);                                      \
+      }                                                                \
+    }                                                                  \
+  } while (0)
+
 #define LOG_GROUP_TIME_SERIES_ADD(stats_struct, stat_name, log_name, val)      \
   do {                                                                         \
     if (stats_struct) {                                                        \
@@ -1238,6 +1268,10 @@ class PerShardStatToken {
         }                                                                      \
         stats_it->second->stat_name->addValue(val);                            \
       }                                                                        \
+      const auto window_ =                                                     \
+          (stats_struct)->params_.get()->time_intervals_##stat_name.back();    \
+      (stats_struct)->get().top_log_groups_##stat_name->add(                   \
+          (log_name), (val), window_);                                         \
     }                                                                          \
   } while (0)
 
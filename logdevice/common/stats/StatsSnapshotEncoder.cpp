@@ -0,0 +1,317 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/StatsSnapshotEncoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <folly/Format.h>
+#include <folly/Varint.h>
+
+#include "logdevice/common/PriorityMap.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/stats/Histogram.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+const char MAGIC[4] = {'L', 'D', 'S', 'T'};
+constexpr uint64_t FORMAT_VERSION = 1;
+
+void putVarint(uint64_t val, std::string* out) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  size_t len = folly::encodeVarint(val, buf);
+  out->append(reinterpret_cast<const char*>(buf), len);
+}
+
+// Collects (name, value) pairs, naming stats the same way as the `stats`
+// admin command does.
+class Collector : public Stats::EnumerationCallbacks {
+ public:
+  Collector(bool include_log_groups,
+            std::vector<std::pair<std::string, int64_t>>* out)
+      : includeLogGroups_(include_log_groups), out_(out) {}
+
+  void stat(const std::string& name, int64_t val) override {
+    add(name, val);
+  }
+  void stat(const std::string& name, MessageType msg, int64_t val) override {
+    add(name + "." + messageTypeNames()[msg], val);
+  }
+  void stat(const std::string& name,
+            shard_index_t shard,
+            int64_t val) override {
+    add(folly::sformat("{}.shard{}", name, shard), val);
+  }
+  void stat(const std::string& name, TrafficClass tc, int64_t val) override {
+    add(name + "." + trafficClasses()[tc], val);
+  }
+  void stat(const std::string& name,
+            NodeLocationScope flow_group,
+            int64_t val) override {
+    add(name + "." + NodeLocation::scopeNames()[flow_group], val);
+  }
+  void stat(const std::string& name,
+            NodeLocationScope flow_group,
+            Priority pri,
+            int64_t val) override {
+    add(name + "." + NodeLocation::scopeNames()[flow_group] + "." +
+            PriorityMap::toName()[pri],
+        val);
+  }
+  void stat(const std::string& name, Priority pri, int64_t val) override {
+    add(name + "." + PriorityMap::toName()[pri], val);
+  }
+  void stat(const std::string& name, RequestType rq, int64_t val) override {
+    add(name + "." + requestTypeNames[rq], val);
+  }
+  void stat(const std::string& name,
+            StorageTaskType type,
+            int64_t val) override {
+    add(name + "." + storageTaskTypeNames[type], val);
+  }
+  void stat(const std::string& name,
+            worker_id_t worker_id,
+            uint64_t load) override {
+    add(folly::sformat("{}_{}", name, worker_id.val()), (int64_t)load);
+  }
+  void stat(const char* name,
+            const std::string& log_group,
+            int64_t val) override {
+    if (!includeLogGroups_) {
+      return;
+    }
+    std::string key = log_group;
+    std::replace(key.begin(), key.end(), ' ', '_');
+    key += '.';
+    key += name;
+    add(std::move(key), val);
+  }
+
+  void histogram(const std::string& name,
+                 const HistogramInterface& hist) override {
+    addHistogram(name, hist);
+  }
+  void histogram(const std::string& name,
+                 shard_index_t shard,
+                 const HistogramInterface& hist) override {
+    addHistogram(folly::sformat("{}.shard{}", name, shard), hist);
+  }
+
+ private:
+  void add(std::string name, int64_t val) {
+    out_->emplace_back(std::move(name), val);
+  }
+
+  void addHistogram(const std::string& prefix,
+                    const HistogramInterface& hist) {
+    static const std::array<double, 3> percentiles = {0.5, 0.9, 0.99};
+    static const std::array<const char*, 3> suffixes = {
+        ".p50", ".p90", ".p99"};
+    std::array<int64_t, 3> samples;
+    uint64_t count;
+    int64_t sum;
+    hist.estimatePercentiles(
+        percentiles.data(), percentiles.size(), samples.data(), &count, &sum);
+    add(prefix + ".count", (int64_t)count);
+    add(prefix + ".sum", sum);
+    for (size_t i = 0; i < samples.size(); ++i) {
+      add(prefix + suffixes[i], samples[i]);
+    }
+  }
+
+  const bool includeLogGroups_;
+  std::vector<std::pair<std::string, int64_t>>* out_;
+};
+
+} // namespace
+
+StatsSnapshotEncoder::StatsSnapshotEncoder(bool include_log_groups,
+                                           size_t max_snapshots)
+    : includeLogGroups_(include_log_groups),
+      maxSnapshots_(std::max(max_snapshots, size_t(1))) {}
+
+uint32_t StatsSnapshotEncoder::getOrAssignID(const std::string& name) {
+  auto ins = ids_.emplace(name, (uint32_t)names_.size());
+  if (ins.second) {
+    names_.push_back(name);
+  }
+  return ins.first->second;
+}
+
+uint64_t StatsSnapshotEncoder::encode(const Stats& stats,
+                                      uint64_t cursor,
+                                      std::string* out) {
+  ld_check(out != nullptr);
+
+  // Enumerate outside the lock, it's the expensive part.
+  std::vector<std::pair<std::string, int64_t>> current;
+  Collector collector(includeLogGroups_, &current);
+  stats.enumerate(&collector, /* list_all */ true);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const Snapshot* base = nullptr;
+  if (cursor != 0) {
+    for (const Snapshot& s : snapshots_) {
+      if (s.cursor == cursor) {
+        base = &s;
+        break;
+      }
+    }
+  }
+
+  Snapshot snapshot;
+  snapshot.cursor = nextCursor_++;
+  if (base != nullptr) {
+    snapshot.values = base->values;
+  }
+  const size_t first_new_id = base != nullptr ? base->values.size() : 0;
+  for (auto& kv : current) {
+    uint32_t id = getOrAssignID(kv.first);
+    if (id >= snapshot.values.size()) {
+      snapshot.values.resize(names_.size(), 0);
+    }
+    snapshot.values[id] = kv.second;
+  }
+  snapshot.values.resize(names_.size(), 0);
+
+  out->append(MAGIC, sizeof(MAGIC));
+  putVarint(FORMAT_VERSION, out);
+  putVarint(snapshot.cursor, out);
+  putVarint(base != nullptr ? base->cursor : 0, out);
+
+  putVarint(first_new_id, out);
+  putVarint(names_.size() - first_new_id, out);
+  for (size_t id = first_new_id; id < names_.size(); ++id) {
+    putVarint(names_[id].size(), out);
+    out->append(names_[id]);
+  }
+
+  std::vector<uint32_t> changed;
+  for (uint32_t id = 0; id < snapshot.values.size(); ++id) {
+    int64_t old_val = id < first_new_id ? base->values[id] : 0;
+    if (snapshot.values[id] != old_val) {
+      changed.push_back(id);
+    }
+  }
+
+  // Columnar: all ids first, then all values, so that each column consists of
+  // similar small numbers.
+  putVarint(changed.size(), out);
+  int64_t prev_id = -1;
+  for (uint32_t id : changed) {
+    putVarint(id - prev_id - 1, out);
+    prev_id = id;
+  }
+  for (uint32_t id : changed) {
+    int64_t old_val = id < first_new_id ? base->values[id] : 0;
+    putVarint(folly::encodeZigZag(snapshot.values[id] - old_val), out);
+  }
+
+  const uint64_t new_cursor = snapshot.cursor;
+  snapshots_.push_back(std::move(snapshot));
+  // Note that `base` may be invalidated here.
+  while (snapshots_.size() > maxSnapshots_) {
+    snapshots_.pop_front();
+  }
+  return new_cursor;
+}
+
+int StatsSnapshotDecoder::apply(Slice data) {
+  folly::ByteRange range(reinterpret_cast<const uint8_t*>(data.data),
+                         data.size);
+  if (range.size() < sizeof(MAGIC) ||
+      memcmp(range.data(), MAGIC, sizeof(MAGIC)) != 0) {
+    err = E::BADMSG;
+    return -1;
+  }
+  range.advance(sizeof(MAGIC));
+
+  try {
+    if (folly::decodeVarint(range) != FORMAT_VERSION) {
+      err = E::BADMSG;
+      return -1;
+    }
+    const uint64_t new_cursor = folly::decodeVarint(range);
+    const uint64_t base_cursor = folly::decodeVarint(range);
+    if (base_cursor != 0 && base_cursor != cursor_) {
+      err = E::STALE;
+      return -1;
+    }
+
+    // Decode into copies so that a malformed message doesn't leave us with
+    // half-applied state.
+    std::vector<std::string> names;
+    std::vector<int64_t> values;
+    if (base_cursor != 0) {
+      names = names_;
+      values = values_;
+    }
+
+    const uint64_t first_new_id = folly::decodeVarint(range);
+    const uint64_t num_new_names = folly::decodeVarint(range);
+    if (first_new_id != names.size() || num_new_names > range.size()) {
+      err = E::BADMSG;
+      return -1;
+    }
+    for (uint64_t i = 0; i < num_new_names; ++i) {
+      const uint64_t len = folly::decodeVarint(range);
+      if (len > range.size()) {
+        err = E::BADMSG;
+        return -1;
+      }
+      names.emplace_back(reinterpret_cast<const char*>(range.data()), len);
+      range.advance(len);
+    }
+    values.resize(names.size(), 0);
+
+    const uint64_t num_changed = folly::decodeVarint(range);
+    if (num_changed > values.size()) {
+      err = E::BADMSG;
+      return -1;
+    }
+    std::vector<uint64_t> ids(num_changed);
+    uint64_t next_id = 0;
+    for (uint64_t i = 0; i < num_changed; ++i) {
+      ids[i] = next_id + folly::decodeVarint(range);
+      if (ids[i] >= values.size()) {
+        err = E::BADMSG;
+        return -1;
+      }
+      next_id = ids[i] + 1;
+    }
+    for (uint64_t id : ids) {
+      values[id] += folly::decodeZigZag(folly::decodeVarint(range));
+    }
+    if (!range.empty()) {
+      err = E::BADMSG;
+      return -1;
+    }
+
+    cursor_ = new_cursor;
+    names_ = std::move(names);
+    values_ = std::move(values);
+  } catch (...) {
+    // Truncated or invalid varint.
+    err = E::BADMSG;
+    return -1;
+  }
+  return 0;
+}
+
+int64_t StatsSnapshotDecoder::get(const std::string& name) const {
+  auto it = std::find(names_.begin(), names_.end(), name);
+  return it == names_.end() ? 0 : values_[it - names_.begin()];
+}
+
+}} // namespace facebook::logdevice
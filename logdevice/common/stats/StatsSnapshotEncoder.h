@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Compact binary encoding of an aggregated Stats object, meant for
+ *       collectors that poll stats of many nodes every few seconds.
+ *
+ *       The text `stats` admin command formats every counter (including all
+ *       per-log ones) as a line of text on every poll, and the collector has
+ *       to parse it back. Instead, StatsSnapshotEncoder keeps a dictionary of
+ *       stat names and a few recent snapshots of values. Each encoded snapshot
+ *       gets a cursor; a client that passes back the cursor of the previous
+ *       snapshot it received only gets names it hasn't seen yet and the stats
+ *       whose values changed, delta-encoded against the values it has.
+ *
+ *       Stat names are the same as in the text `stats` command. Histograms
+ *       are exported as <name>.count, <name>.sum, <name>.p50, <name>.p90 and
+ *       <name>.p99 (with a .shardN infix for per-shard histograms).
+ *
+ *       Format (all integers are unsigned varints, signed values zigzagged):
+ *         "LDST" version cursor base_cursor
+ *         first_new_id num_new_names (name_len name_bytes)*
+ *         num_changed (id_gap)* (value_delta)*
+ *       where base_cursor is 0 if this is a full snapshot (client must drop
+ *       its state), new names get consecutive ids starting at first_new_id,
+ *       id_gap is the difference between consecutive changed ids minus one
+ *       (the first one is the id itself) and value_delta is the difference
+ *       between the new value and the value at base_cursor (0 for stats the
+ *       client doesn't have yet). Stats that disappear (e.g. a removed log
+ *       group) keep their last value.
+ */
+
+class StatsSnapshotEncoder {
+ public:
+  /**
+   * @param include_log_groups  Whether to include per-log-group stats.
+   * @param max_snapshots       How many recent snapshots to keep as possible
+   *                            bases for deltas. Clients with an older cursor
+   *                            get a full snapshot.
+   */
+  explicit StatsSnapshotEncoder(bool include_log_groups,
+                                size_t max_snapshots = 16);
+
+  /**
+   * Appends an encoding of `stats` to *out, as a delta against the snapshot
+   * with the given cursor if it's still known, and as a full snapshot
+   * otherwise. Thread-safe.
+   *
+   * @return  cursor of the new snapshot, to be passed to the next call.
+   */
+  uint64_t encode(const Stats& stats, uint64_t cursor, std::string* out);
+
+ private:
+  struct Snapshot {
+    uint64_t cursor;
+    // Indexed by stat id. The size is the number of names known at the time.
+    std::vector<int64_t> values;
+  };
+
+  uint32_t getOrAssignID(const std::string& name);
+
+  const bool includeLogGroups_;
+  const size_t maxSnapshots_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::vector<std::string> names_;
+  std::deque<Snapshot> snapshots_;
+  uint64_t nextCursor_ = 1;
+};
+
+/**
+ * Client side of StatsSnapshotEncoder: keeps the names and values received so
+ * far and applies new snapshots to them.
+ */
+class StatsSnapshotDecoder {
+ public:
+  /**
+   * @return 0 on success, -1 on failure and err is set to:
+   *         - E::BADMSG: `data` is malformed,
+   *         - E::STALE:  `data` is a delta against a cursor other than
+   *                      cursor(); state is unchanged.
+   */
+  int apply(Slice data);
+
+  // Cursor to pass to the server on the next poll, 0 if nothing was received.
+  uint64_t cursor() const {
+    return cursor_;
+  }
+
+  const std::vector<std::string>& names() const {
+    return names_;
+  }
+  const std::vector<int64_t>& values() const {
+    return values_;
+  }
+
+  // Value of the given stat, 0 if unknown. Linear in the number of stats.
+  int64_t get(const std::string& name) const;
+
+ private:
+  uint64_t cursor_ = 0;
+  std::vector<std::string> names_;
+  std::vector<int64_t> values_;
+};
+
+}} // namespace facebook::logdevice
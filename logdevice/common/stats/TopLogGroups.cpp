@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/TopLogGroups.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+TopLogGroups::TopLogGroups(size_t capacity) : capacity_(capacity) {
+  ld_check(capacity_ > 0);
+  current_.start = std::chrono::steady_clock::now();
+}
+
+void TopLogGroups::Generation::add(const std::string& log_group,
+                                   uint64_t value,
+                                   size_t capacity) {
+  auto it = counts.find(log_group);
+  if (it != counts.end()) {
+    it->second += value;
+    return;
+  }
+  counts.emplace(log_group, floor + value);
+  if (counts.size() < capacity * 2) {
+    return;
+  }
+
+  // Keep the `capacity' heaviest log groups.
+  std::vector<std::pair<uint64_t, std::string>> sorted;
+  sorted.reserve(counts.size());
+  for (auto& kv : counts) {
+    sorted.emplace_back(kv.second, kv.first);
+  }
+  std::nth_element(
+      sorted.begin(),
+      sorted.begin() + capacity,
+      sorted.end(),
+      [](const auto& a, const auto& b) { return a.first > b.first; });
+  counts.clear();
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    if (i < capacity) {
+      counts.emplace(std::move(sorted[i].second), sorted[i].first);
+    } else {
+      floor = std::max(floor, sorted[i].first);
+    }
+  }
+}
+
+void TopLogGroups::add(const std::string& log_group,
+                       uint64_t value,
+                       std::chrono::milliseconds window) {
+  const auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (now - current_.start >= window) {
+    previous_ = std::move(current_);
+    current_ = Generation();
+    current_.start = now;
+  }
+  current_.add(log_group, value, capacity_);
+}
+
+void TopLogGroups::merge(const TopLogGroups& other) {
+  if (&other == this) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock1(mutex_, std::defer_lock);
+  std::unique_lock<std::mutex> lock2(other.mutex_, std::defer_lock);
+  std::lock(lock1, lock2);
+  for (const Generation* gen : {&other.previous_, &other.current_}) {
+    for (const auto& kv : gen->counts) {
+      current_.add(kv.first, kv.second, capacity_);
+    }
+  }
+}
+
+void TopLogGroups::getCandidates(std::unordered_set<std::string>& out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Generation* gen : {&previous_, &current_}) {
+    for (const auto& kv : gen->counts) {
+      out.insert(kv.first);
+    }
+  }
+}
+
+void TopLogGroups::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  previous_ = Generation();
+  current_ = Generation();
+  current_.start = std::chrono::steady_clock::now();
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Sketch of the heaviest log groups of one per-log time series in one
+ *       thread-local Stats object, so that "top N log groups" queries (e.g.
+ *       'stats throughput appends --top 10') only need to look at the time
+ *       series of a few candidates instead of every log group on every
+ *       thread.
+ *
+ *       This is a Space-Saving heavy hitters sketch with batched eviction:
+ *       up to 2 * capacity log groups are tracked; when that limit is
+ *       reached, all but the `capacity` heaviest are dropped, and log groups
+ *       seen for the first time afterwards start from the largest dropped
+ *       count. Any log group whose total exceeds that floor is guaranteed to
+ *       be tracked.
+ *
+ *       To follow changes in traffic, the sketch keeps two generations and
+ *       starts a new one every `window` (the longest interval of the time
+ *       series); candidates are taken from both. The sketch only picks
+ *       candidates, exact rates still come from the time series.
+ *
+ *       Thread-safe. The mutex is uncontended except while a query runs.
+ */
+class TopLogGroups {
+ public:
+  static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+  explicit TopLogGroups(size_t capacity = DEFAULT_CAPACITY);
+
+  /**
+   * Accounts `value' to `log_group'.
+   *
+   * @param window  Lifetime of a generation.
+   */
+  void add(const std::string& log_group,
+           uint64_t value,
+           std::chrono::milliseconds window);
+
+  /**
+   * Adds the log groups tracked by `other' to this sketch. Used when
+   * aggregating Stats objects.
+   */
+  void merge(const TopLogGroups& other);
+
+  /**
+   * Adds the log groups that may be among the `capacity' heaviest to `out'.
+   */
+  void getCandidates(std::unordered_set<std::string>& out) const;
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  void reset();
+
+ private:
+  struct Generation {
+    std::unordered_map<std::string, uint64_t> counts;
+    // Count new log groups start from, i.e. the largest count evicted.
+    uint64_t floor{0};
+    std::chrono::steady_clock::time_point start;
+
+    void add(const std::string& log_group, uint64_t value, size_t capacity);
+  };
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  Generation current_;
+  Generation previous_;
+};
+
+}} // namespace facebook::logdevice
@@ -332,7 +332,10 @@ class MockAppenderPrep : public AppenderPrep {
   void sendError(Appender*, Status st) const override {
     results_.push_back(std::make_pair(st, NodeID()));
   }
-  void sendRedirect(Appender*, NodeID node, Status st) const override {
+  void sendRedirect(Appender*,
+                    NodeID node,
+                    Status st,
+                    APPENDED_flags_t /*flags*/) const override {
     results_.push_back(std::make_pair(st, node));
   }
   StatsHolder* stats() const override {
@@ -714,6 +717,54 @@ TEST_F(APPEND_MessageTest, NoRedirectUntil) {
   }
 }
 
+// Tests that appends for a log handed off to another node are redirected there
+// unless the target is dead or the client insists on this node.
+TEST_F(APPEND_MessageTest, Handoff) {
+  const logid_t log(1);
+  const NodeID N1(0, 1), N2(1, 1);
+
+  sequencer_->handoff_target_ = N2;
+  sequencer_->handoff_until_ = std::chrono::steady_clock::duration::max();
+
+  {
+    std::unique_ptr<Appender> appender(new MockAppender);
+    auto prep = create(log);
+    prep->my_node_id_ = N1;
+    prep->setSequencer(log, N1);
+    prep->setAlive({N1, N2});
+
+    // N1 is where `log' hashes to, but it handed the log off to N2
+    prep->execute(std::move(appender));
+    ASSERT_RESULTS(prep, std::make_pair(E::REDIRECTED, N2));
+  }
+  {
+    std::unique_ptr<Appender> appender(new MockAppender);
+    Appender* raw = appender.get();
+    auto prep = create(log);
+    prep->my_node_id_ = N1;
+    prep->setSequencer(log, N1);
+    prep->setAlive({N1});
+
+    // N2 is dead, N1 keeps the log
+    prep->execute(std::move(appender));
+    ASSERT_RUNNING(prep, {raw});
+  }
+  {
+    STORE_flags_t flags =
+        APPEND_Header::NO_REDIRECT | APPEND_Header::CHECKSUM_PARITY;
+    std::unique_ptr<Appender> appender(new MockAppender(flags));
+    Appender* raw = appender.get();
+    auto prep = create(log, flags);
+    prep->my_node_id_ = N1;
+    prep->setSequencer(log, N1);
+    prep->setAlive({N1, N2});
+
+    // the client couldn't follow the redirect
+    prep->execute(std::move(appender));
+    ASSERT_RUNNING(prep, {raw});
+  }
+}
+
 // Verifies that APPEND messages with `seen' greater than sequencer's current
 // epoch cause a reactivation.
 TEST_F(APPEND_MessageTest, SeenEpoch) {
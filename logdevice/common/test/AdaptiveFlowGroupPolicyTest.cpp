@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AdaptiveFlowGroupPolicy.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+const Priority HIGH = Priority::MAX;
+const Priority LOW = priorityAbove(Priority::NUM_PRIORITIES);
+
+FlowGroupPolicy makePolicy() {
+  FlowGroupPolicy policy;
+  policy.setEnabled(true);
+  for (Priority p = Priority::MAX; p < Priority::NUM_PRIORITIES;
+       p = priorityBelow(p)) {
+    policy.set(p, /*capacity=*/1000, /*guaranteed_bw=*/100, /*max_bw=*/500);
+  }
+  policy.set(Priority::NUM_PRIORITIES, 1000, /*guaranteed_bw=*/1600);
+  return policy;
+}
+
+AdaptiveFlowGroupPolicy::BackloggedPriorities backlogged(Priority p) {
+  AdaptiveFlowGroupPolicy::BackloggedPriorities res{};
+  res[asInt(p)] = true;
+  return res;
+}
+
+} // namespace
+
+TEST(AdaptiveFlowGroupPolicyTest, IncreaseWhenIdle) {
+  FlowGroupPolicy configured = makePolicy();
+  AdaptiveFlowGroupPolicy adaptive;
+
+  // No feedback, nothing changes.
+  adaptive.adjust(configured);
+  FlowGroupPolicy policy = adaptive.apply(configured);
+  EXPECT_EQ(100, policy.entries[asInt(LOW)].guaranteed_bw);
+  EXPECT_EQ(1600, policy.priorityQEntry().guaranteed_bw);
+
+  // LOW is backlogged while bandwidth is discarded: additive increase,
+  // taken from the priority queue bucket.
+  adaptive.addFeedback(backlogged(LOW), /*idle=*/true);
+  adaptive.adjust(configured);
+  EXPECT_EQ(100, adaptive.extraBandwidth(LOW));
+  policy = adaptive.apply(configured);
+  EXPECT_EQ(200, policy.entries[asInt(LOW)].guaranteed_bw);
+  EXPECT_EQ(1000, policy.entries[asInt(LOW)].capacity);
+  EXPECT_EQ(1500, policy.priorityQEntry().guaranteed_bw);
+  EXPECT_EQ(100, policy.entries[asInt(HIGH)].guaranteed_bw);
+
+  // Capped by max_bw.
+  for (int i = 0; i < 10; ++i) {
+    adaptive.addFeedback(backlogged(LOW), /*idle=*/true);
+    adaptive.adjust(configured);
+  }
+  EXPECT_EQ(400, adaptive.extraBandwidth(LOW));
+  EXPECT_EQ(500, adaptive.apply(configured).entries[asInt(LOW)].guaranteed_bw);
+}
+
+TEST(AdaptiveFlowGroupPolicyTest, DecreaseWhenHigherPriorityNeedsIt) {
+  FlowGroupPolicy configured = makePolicy();
+  AdaptiveFlowGroupPolicy adaptive;
+  for (int i = 0; i < 4; ++i) {
+    adaptive.addFeedback(backlogged(LOW), /*idle=*/true);
+    adaptive.adjust(configured);
+  }
+  EXPECT_EQ(400, adaptive.extraBandwidth(LOW));
+
+  // Both are backlogged and nothing is discarded: LOW gives its extra
+  // bandwidth back, HIGH doesn't get more.
+  auto both = backlogged(LOW);
+  both[asInt(HIGH)] = true;
+  adaptive.addFeedback(both, /*idle=*/false);
+  adaptive.adjust(configured);
+  EXPECT_EQ(200, adaptive.extraBandwidth(LOW));
+  EXPECT_EQ(0, adaptive.extraBandwidth(HIGH));
+
+  // LOW isn't backlogged anymore.
+  adaptive.addFeedback({}, /*idle=*/true);
+  adaptive.adjust(configured);
+  EXPECT_EQ(100, adaptive.extraBandwidth(LOW));
+
+  // Disabling the policy resets everything.
+  configured.setEnabled(false);
+  adaptive.adjust(configured);
+  EXPECT_EQ(0, adaptive.extraBandwidth(LOW));
+}
+
+TEST(AdaptiveFlowGroupPolicyTest, BoundedByPriorityQueueBandwidth) {
+  FlowGroupPolicy configured = makePolicy();
+  AdaptiveFlowGroupPolicy adaptive;
+  AdaptiveFlowGroupPolicy::BackloggedPriorities all;
+  all.fill(true);
+  for (int i = 0; i < 100; ++i) {
+    adaptive.addFeedback(all, /*idle=*/true);
+    adaptive.adjust(configured);
+  }
+
+  // Config changed to a smaller priority queue bucket: higher priorities
+  // keep their extra bandwidth first.
+  configured.set(Priority::NUM_PRIORITIES, 1000, /*guaranteed_bw=*/500);
+  FlowGroupPolicy policy = adaptive.apply(configured);
+  EXPECT_EQ(500, policy.entries[asInt(HIGH)].guaranteed_bw);
+  EXPECT_EQ(100, policy.entries[asInt(LOW)].guaranteed_bw);
+  EXPECT_EQ(0, policy.priorityQEntry().guaranteed_bw);
+  int64_t total = 0;
+  for (const auto& e : policy.entries) {
+    total += e.guaranteed_bw;
+  }
+  int64_t configured_total = 0;
+  for (const auto& e : configured.entries) {
+    configured_total += e.guaranteed_bw;
+  }
+  EXPECT_EQ(configured_total, total);
+}
@@ -129,6 +129,11 @@ class AppenderTest : public ::testing::Test {
   // through calls to activateStoreTimer() and activateRetryTimer(), and
   bool store_timer_active_{false};
   bool retry_timer_active_{false};
+  // Delay passed to the last activateStoreTimer() call.
+  std::chrono::milliseconds store_timer_delay_{0};
+
+  // Value returned by selectStoreHedgeThreshold().
+  folly::Optional<std::chrono::milliseconds> hedge_threshold_;
 
   // Keep track of which nodes are not available following Appender calling
   // setNotAvailableUntil(). Used by checkNotAvailableUntil() to inform the
@@ -495,12 +500,17 @@ class AppenderTest::MockAppender : public Appender {
   void activateRetryTimer() override {
     test_->retry_timer_active_ = true;
   }
-  void activateStoreTimer(std::chrono::milliseconds) override {
+  void activateStoreTimer(std::chrono::milliseconds delay) override {
     test_->store_timer_active_ = true;
+    test_->store_timer_delay_ = delay;
   }
   bool retryTimerIsActive() override {
     return test_->retry_timer_active_;
   }
+  folly::Optional<std::chrono::milliseconds>
+  selectStoreHedgeThreshold() override {
+    return test_->hedge_threshold_;
+  }
   bool isNodeAlive(NodeID node) override {
     // if we can't find the node in dead_nodes_, it is alive.
     return test_->dead_nodes_.find(node) == test_->dead_nodes_.end();
@@ -1110,6 +1120,45 @@ TEST_F(AppenderTest, StoreTimeoutTryNewWave) {
   CHECK_RELEASE_MSG(N7S0, N5S0, N6S0);
 }
 
+// With store hedging, once all but one copy are stored the store timer is
+// moved up to the hedging threshold. When it fires, the late shard is
+// graylisted and a new wave is sent.
+TEST_F(AppenderTest, StoreHedging) {
+  settings_.store_hedging = true;
+  hedge_threshold_ = std::chrono::milliseconds(0);
+  updateConfig();
+  first_candidate_idx_ = 0;
+  start();
+  CHECK_STORE_MSG_AND_TRIGGER_ON_SENT(E::OK, 1, N0S0, N1S0, N2S0, N3S0, N4S0);
+  CHECK_NO_STORE_MSG();
+
+  // Two copies are still missing, nothing to hedge yet.
+  ON_STORED_SENT(E::OK, 1, N0S0);
+  ASSERT_EQ(0, appender_->getStats()->aggregate().appender_wave_hedged);
+
+  // Only one copy is missing: the store timer now fires at the threshold.
+  ON_STORED_SENT(E::OK, 1, N1S0);
+  ASSERT_TRUE(store_timer_active_);
+  ASSERT_EQ(std::chrono::milliseconds(0), store_timer_delay_);
+
+  first_candidate_idx_ = 5;
+  triggerTimeout();
+  ASSERT_EQ(1, appender_->getStats()->aggregate().appender_wave_hedged);
+  ASSERT_EQ(0, appender_->getStats()->aggregate().appender_wave_timedout);
+  ASSERT_EQ(1, not_available_nodes_.size());
+  ASSERT_EQ(NodeSetState::NotAvailableReason::SLOW,
+            not_available_nodes_.begin()->second);
+
+  CHECK_STORE_MSG_AND_TRIGGER_ON_SENT(E::OK, 2, N5S0, N6S0, N7S0, N8S0, N0S0);
+  CHECK_NO_STORE_MSG();
+  ON_STORED_SENT(E::OK, 2, N7S0, N5S0, N6S0);
+  CHECK_APPENDED(E::OK);
+  CHECK_DELETE_MSG(N8S0, N0S0);
+  ASSERT_TRUE(retired_);
+  Appender::Reaper()(appender_);
+  CHECK_RELEASE_MSG(N7S0, N5S0, N6S0);
+}
+
 // If all receiving nodes respond negatively, none will be greylisted.
 TEST_F(AppenderTest, StoreTimeoutRelaxedGraylisting) {
   updateConfig();
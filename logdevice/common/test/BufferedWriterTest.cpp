@@ -8,9 +8,11 @@
 #include "logdevice/include/BufferedWriter.h"
 
 #include <random>
+#include <thread>
 
 #include <folly/Memory.h>
 #include <gtest/gtest.h>
+#include <zdict.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/Processor.h"
@@ -18,6 +20,7 @@
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterSingleLog.h"
+#include "logdevice/common/buffered_writer/ZstdDictionaries.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/settings/Settings.h"
@@ -330,7 +333,9 @@ class BufferedWriterTest : public ::testing::Test {
 
   void explicitFlushTest(BufferedWriter::Options::Mode,
                          size_t numAppendsBeforePosting);
-  void roundTripTest(Compression, bool payloads_compressible);
+  void roundTripTest(Compression,
+                     bool payloads_compressible,
+                     bool lengths_column = false);
   void bigPayloadFlushesTest(size_t);
 
  protected:
@@ -401,13 +406,63 @@ TEST_F(BufferedWriterTest, ExplicitFlushOneAtATimeUseBackgroundThread) {
   this->explicitFlushTest(BufferedWriter::Options::Mode::ONE_AT_A_TIME, 0);
 }
 
+// Appends go through per-thread staging buffers before being handed to the
+// Worker.  Each producer thread's appends to a log must still land in the
+// order they were made, whichever append() variant was used.
+TEST_F(BufferedWriterTest, StagedAppendsKeepPerThreadOrder) {
+  TestCallback cb;
+  auto writer = this->createWriter(&cb);
+  const logid_t LOG_ID(1);
+  const int nthreads = 4;
+  const int appends_per_thread = 300;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; ++t) {
+    threads.emplace_back([&, t] {
+      auto payload = [t](int i) {
+        return std::to_string(t) + ":" + std::to_string(i);
+      };
+      for (int i = 0; i < appends_per_thread; i += 3) {
+        ASSERT_EQ(0, writer->append(LOG_ID, payload(i), NULL_CONTEXT));
+        std::vector<BufferedWriter::Append> v;
+        v.emplace_back(LOG_ID, payload(i + 1), NULL_CONTEXT);
+        ASSERT_EQ(std::vector<Status>(1, E::OK), writer->append(std::move(v)));
+        std::vector<BufferedWriter::Append> atomic;
+        atomic.emplace_back(LOG_ID, payload(i + 2), NULL_CONTEXT);
+        ASSERT_EQ(0, writer->appendAtomic(LOG_ID, std::move(atomic)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, writer->flushAll());
+
+  std::vector<std::string> read_payloads;
+  wait_until("BufferedWriter has flushed everything", [&]() {
+    read_payloads = sink_->getFlushedOriginalPayloads(LOG_ID);
+    return read_payloads.size() == size_t(nthreads * appends_per_thread);
+  });
+
+  std::vector<int> next(nthreads, 0);
+  for (const std::string& p : read_payloads) {
+    size_t colon = p.find(':');
+    int t = std::stoi(p.substr(0, colon));
+    int i = std::stoi(p.substr(colon + 1));
+    ASSERT_EQ(next[t], i);
+    ++next[t];
+  }
+}
+
 // Round-trip test for compression with manual decoding to track compression
 // ratio.  Parametrized by compression mode.
 void BufferedWriterTest::roundTripTest(Compression compression,
-                                       bool payloads_compressible) {
+                                       bool payloads_compressible,
+                                       bool lengths_column) {
   TestCallback cb;
   BufferedWriter::Options opts;
   opts.compression = compression;
+  opts.payload_lengths_column = lengths_column;
   auto writer = this->createWriter(&cb, opts);
   const logid_t LOG_ID(1);
 
@@ -497,6 +552,115 @@ TEST_F(BufferedWriterTest, RoundTripLZ4NotCompressible) {
   this->roundTripTest(Compression::LZ4, false);
 }
 
+TEST_F(BufferedWriterTest, RoundTripLengthsColumn) {
+  this->roundTripTest(Compression::NONE, true, /* lengths_column */ true);
+}
+
+TEST_F(BufferedWriterTest, RoundTripLengthsColumnZstd) {
+  this->roundTripTest(Compression::ZSTD, true, /* lengths_column */ true);
+}
+
+// Batches compressed with a registered zstd dictionary round-trip and come
+// out smaller than without it for small, repetitive payloads.
+TEST_F(BufferedWriterTest, RoundTripZstdDictionary) {
+  std::mt19937_64 rnd(0xd1c7);
+  auto gen_payload = [&](int i) {
+    return "{\"user_id\": " + std::to_string(rnd() % 100000) +
+        ", \"event\": \"page_view\", \"seq\": " + std::to_string(i) + "}";
+  };
+
+  // Train a dictionary on samples shaped like the payloads.
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (int i = 0; i < 2000; ++i) {
+    std::string p = gen_payload(i);
+    samples += p;
+    sample_sizes.push_back(p.size());
+  }
+  std::string dict(4096, '\0');
+  size_t dict_size = ZDICT_trainFromBuffer(&dict[0],
+                                           dict.size(),
+                                           samples.data(),
+                                           sample_sizes.data(),
+                                           sample_sizes.size());
+  ASSERT_FALSE(ZDICT_isError(dict_size)) << ZDICT_getErrorName(dict_size);
+  dict.resize(dict_size);
+  const uint32_t dict_id = ZDICT_getDictID(dict.data(), dict.size());
+  ASSERT_NE(0, dict_id);
+  ASSERT_EQ(0, ZstdDictionaries::get().add(dict));
+  ASSERT_NE(nullptr, ZstdDictionaries::get().find(dict_id));
+
+  auto write_and_measure = [&](uint32_t id, logid_t log_id) {
+    TestCallback cb;
+    BufferedWriter::Options opts;
+    opts.compression = Compression::ZSTD;
+    opts.zstd_dictionary_id = id;
+    auto writer = this->createWriter(&cb, opts);
+    std::vector<std::string> orig_payloads;
+    for (int i = 0; i < 20; ++i) {
+      std::string p = gen_payload(i);
+      orig_payloads.push_back(p);
+      EXPECT_EQ(0, writer->append(log_id, std::move(p), NULL_CONTEXT));
+    }
+    writer->flushAll();
+    std::vector<std::string> read_payloads;
+    wait_until("BufferedWriter has flushed everything", [&]() {
+      read_payloads = sink_->getFlushedOriginalPayloads(log_id);
+      return read_payloads.size() == orig_payloads.size() &&
+          orig_payloads.size() == cb.getNumSucceeded();
+    });
+    EXPECT_EQ(orig_payloads, read_payloads);
+    size_t bytes = 0;
+    for (const std::string& blob : sink_->getFlushedBlobs(log_id)) {
+      bytes += blob.size();
+    }
+    return bytes;
+  };
+
+  const size_t without_dict = write_and_measure(0, logid_t(1));
+  const size_t with_dict = write_and_measure(dict_id, logid_t(2));
+  ld_info("zstd batch size without dictionary %zu, with %zu",
+          without_dict,
+          with_dict);
+  EXPECT_LT(with_dict, without_dict);
+}
+
+// The lengths column must round-trip empty payloads and batches mixing
+// very different payload sizes (where the writer may fall back to varints).
+TEST_F(BufferedWriterTest, LengthsColumnMixedSizes) {
+  TestCallback cb;
+  BufferedWriter::Options opts;
+  opts.compression = Compression::NONE;
+  opts.payload_lengths_column = true;
+  auto writer = this->createWriter(&cb, opts);
+  const logid_t LOG_ID(1);
+
+  std::vector<std::string> orig_payloads;
+  // Batch of equally sized payloads, uses the column.
+  for (int i = 0; i < 50; ++i) {
+    orig_payloads.push_back(std::string(i % 4 == 0 ? 0 : 100, 'x'));
+  }
+  // Batch with one big payload among tiny ones, falls back to varints.
+  for (int i = 0; i < 50; ++i) {
+    orig_payloads.push_back(std::string(i == 25 ? 100000 : 1, 'y'));
+  }
+  for (size_t i = 0; i < orig_payloads.size(); ++i) {
+    std::string copy = orig_payloads[i];
+    ASSERT_EQ(0, writer->append(LOG_ID, std::move(copy), NULL_CONTEXT));
+    if (i == 49 || i + 1 == orig_payloads.size()) {
+      writer->flushAll();
+    }
+  }
+
+  std::vector<std::string> read_payloads;
+  wait_until("BufferedWriter has flushed everything", [&]() {
+    read_payloads = sink_->getFlushedOriginalPayloads(LOG_ID);
+    return read_payloads.size() == orig_payloads.size() &&
+        orig_payloads.size() == cb.getNumSucceeded();
+  });
+  ASSERT_EQ(orig_payloads, read_payloads);
+}
+
 // Test Options::size_trigger.
 TEST_F(BufferedWriterTest, SizeTrigger) {
   TestCallback cb;
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/work_model/CPUOffloadPool.h"
+
+#include <atomic>
+#include <thread>
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+TEST(CPUOffloadPoolTest, RunsAllWork) {
+  std::atomic<int> ran{0};
+  {
+    CPUOffloadPool pool(4, 1000, nullptr);
+    EXPECT_EQ(4, pool.numThreads());
+    for (int i = 0; i < 1000; ++i) {
+      pool.add([&] { ++ran; });
+    }
+    // Shutting down runs what's queued.
+    pool.shutdown();
+    EXPECT_EQ(1000, ran.load());
+    EXPECT_EQ(0, pool.queueSize());
+  }
+  EXPECT_EQ(1000, ran.load());
+}
+
+TEST(CPUOffloadPoolTest, RunsInlineWhenFull) {
+  CPUOffloadPool pool(1, 1, nullptr);
+  folly::Baton<> started;
+  folly::Baton<> unblock;
+  pool.add([&] {
+    started.post();
+    unblock.wait();
+  });
+  started.wait();
+
+  // The only thread is busy. This fills the queue...
+  std::atomic<bool> queued_ran{false};
+  pool.add([&] { queued_ran = true; });
+  EXPECT_EQ(1, pool.queueSize());
+
+  // ... so this runs inline.
+  const auto caller = std::this_thread::get_id();
+  std::thread::id ran_on;
+  pool.add([&] { ran_on = std::this_thread::get_id(); });
+  EXPECT_EQ(caller, ran_on);
+  EXPECT_FALSE(queued_ran.load());
+
+  unblock.post();
+  pool.shutdown();
+  EXPECT_TRUE(queued_ran.load());
+
+  // After shutdown everything runs inline.
+  ran_on = std::thread::id();
+  pool.add([&] { ran_on = std::this_thread::get_id(); });
+  EXPECT_EQ(caller, ran_on);
+}
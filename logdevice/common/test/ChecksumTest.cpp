@@ -9,6 +9,7 @@
 
 #include <memory>
 
+#include <folly/Conv.h>
 #include <folly/ScopeGuard.h>
 #include <gtest/gtest.h>
 
@@ -60,6 +61,52 @@ TEST_F(ChecksumTest, Invariable) {
   EXPECT_EQ(0xf8e4f0d10bd88705, checksum_64bit(data));
 }
 
+// Scatter-gather and batch variants must produce exactly the same checksums
+// as the contiguous versions.
+TEST_F(ChecksumTest, ScatterGatherMatchesContiguous) {
+  std::string blob;
+  for (int i = 0; i < 1000; ++i) {
+    blob += folly::to<std::string>(i * 7919);
+  }
+  const Slice whole = Slice::fromString(blob);
+
+  for (size_t nparts : {1, 2, 3, 7, 64}) {
+    std::vector<Slice> parts;
+    size_t pos = 0;
+    for (size_t i = 0; i < nparts; ++i) {
+      const size_t end = blob.size() * (i + 1) / nparts;
+      parts.emplace_back(blob.data() + pos, end - pos);
+      pos = end;
+    }
+    EXPECT_EQ(checksum_32bit(whole), checksum_32bit(parts.data(), nparts));
+    EXPECT_EQ(checksum_64bit(whole), checksum_64bit(parts.data(), nparts));
+  }
+
+  // Empty parts are allowed.
+  std::vector<Slice> parts = {Slice("", 0), whole, Slice("", 0)};
+  EXPECT_EQ(checksum_32bit(whole), checksum_32bit(parts.data(), parts.size()));
+  EXPECT_EQ(checksum_64bit(whole), checksum_64bit(parts.data(), parts.size()));
+}
+
+TEST_F(ChecksumTest, Batch) {
+  const std::vector<std::string> payloads = {
+      "", "1", "123456789", std::string(300, 'x'), std::string(5000, 'y')};
+  std::vector<Slice> slices;
+  for (const auto& p : payloads) {
+    slices.push_back(Slice::fromString(p));
+  }
+  std::vector<uint64_t> out(slices.size());
+
+  checksum_batch(slices.data(), slices.size(), 32, out.data());
+  for (size_t i = 0; i < slices.size(); ++i) {
+    EXPECT_EQ(checksum_32bit(slices[i]), out[i]);
+  }
+  checksum_batch(slices.data(), slices.size(), 64, out.data());
+  for (size_t i = 0; i < slices.size(); ++i) {
+    EXPECT_EQ(checksum_64bit(slices[i]), out[i]);
+  }
+}
+
 std::unique_ptr<RECORD_Message> ChecksumTest::roundTrip(
     APPEND_flags_t checksum_flags,
     std::function<void(RECORD_flags_t&, Payload&)> mutation) {
@@ -7,8 +7,10 @@
  */
 #include "logdevice/common/ClientIdxAllocator.h"
 
+#include <atomic>
 #include <iterator>
 #include <set>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -105,3 +107,62 @@ TEST(ClientIdxAllocatorTest, MultiWorkerStress) {
   ld_info("exhaust_count = %d", exhaust_count);
   EXPECT_GT(exhaust_count, 0);
 }
+
+// Workers issuing, looking up and releasing indexes concurrently must never
+// be handed the same index, and must see their own indexes as in use.
+TEST(ClientIdxAllocatorTest, ConcurrentWorkers) {
+  const int num_workers = 8;
+  const int max_idx = 1000;
+  const int ops = 20000;
+
+  ClientIdxAllocator alloc;
+  alloc.setMaxClientIdx(max_idx);
+
+  std::vector<std::atomic<int>> owner(max_idx + 1);
+  for (auto& o : owner) {
+    o.store(-1);
+  }
+  std::atomic<int> failures{0};
+
+  std::vector<std::thread> threads;
+  for (int w = 0; w < num_workers; ++w) {
+    threads.emplace_back([&, w] {
+      std::vector<int> held;
+      std::mt19937_64 rng(w);
+      for (int i = 0; i < ops; ++i) {
+        if (held.size() < max_idx / num_workers / 2 &&
+            (held.empty() || folly::Random::oneIn(2, rng))) {
+          int idx =
+              alloc.issueClientIdx(WorkerType::GENERAL, worker_id_t(w))
+                  .getIdx();
+          int expected = -1;
+          if (!owner[idx].compare_exchange_strong(expected, w)) {
+            ++failures;
+          }
+          held.push_back(idx);
+        } else {
+          int j = folly::Random::rand32(held.size(), rng);
+          int idx = held[j];
+          std::swap(held[j], held.back());
+          held.pop_back();
+          if (alloc.getWorkerId(ClientID(idx)) !=
+              std::make_pair(WorkerType::GENERAL, worker_id_t(w))) {
+            ++failures;
+          }
+          owner[idx].store(-1);
+          alloc.releaseClientIdx(ClientID(idx));
+        }
+      }
+      for (int idx : held) {
+        owner[idx].store(-1);
+        alloc.releaseClientIdx(ClientID(idx));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(0, failures.load());
+  EXPECT_EQ(WorkerType::MAX, alloc.getWorkerId(ClientID(1)).first);
+}
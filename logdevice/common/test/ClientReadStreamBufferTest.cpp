@@ -39,11 +39,7 @@ class ClientReadStreamBufferTest
     : public ::testing::TestWithParam<ClientReadStreamBufferType> {
  public:
   void SetUp() override {
-    if (GetParam() == ClientReadStreamBufferType::CIRCULAR) {
-      buf = std::make_unique<ClientReadStreamCircularBuffer>(10, 100);
-    } else {
-      buf = std::make_unique<ClientReadStreamOrderedMapBuffer>(10, 100);
-    }
+    buf = ClientReadStreamBufferFactory::create(GetParam(), 10, 100);
   }
   std::unique_ptr<ClientReadStreamBuffer> buf;
 };
@@ -145,10 +141,58 @@ TEST_P(ClientReadStreamBufferTest, ForEachBackwardEmpty) {
   ASSERT_TRUE(true);
 }
 
+TEST_P(ClientReadStreamBufferTest, FindFirstMarkerAcrossWrap) {
+  // ordered map creates an entry for every createOrGet() and treats it as a
+  // marker
+  if (GetParam() == ClientReadStreamBufferType::ORDERED_MAP) {
+    return;
+  }
+  auto pair = buf->findFirstMarker();
+  ASSERT_EQ(nullptr, pair.first);
+
+  // a slot handed out by createOrGet() that is not turned into a marker is
+  // not reported
+  buf->createOrGet(lsn_t{101});
+  ASSERT_EQ(nullptr, buf->find(lsn_t{101}));
+
+  buf->createOrGet(lsn_t{103})->gap = true;
+  pair = buf->findFirstMarker();
+  ASSERT_EQ(lsn_t{103}, pair.second);
+  ASSERT_EQ(buf->find(lsn_t{103}), pair.first);
+  pair.first->gap = false;
+
+  // move the head so that the buffer wraps around the end of the ring
+  buf->advanceBufferHead(7);
+  ASSERT_EQ(lsn_t{107}, buf->getBufferHead());
+  ASSERT_EQ(nullptr, buf->front());
+  ASSERT_EQ(nullptr, buf->findFirstMarker().first);
+
+  buf->createOrGet(lsn_t{115})->filtered_out = true;
+  buf->createOrGet(lsn_t{112})->gap = true;
+  pair = buf->findFirstMarker();
+  ASSERT_EQ(lsn_t{112}, pair.second);
+  pair.first->gap = false;
+  pair = buf->findFirstMarker();
+  ASSERT_EQ(lsn_t{115}, pair.second);
+  pair.first->filtered_out = false;
+  ASSERT_EQ(nullptr, buf->findFirstMarker().first);
+
+  buf->createOrGet(lsn_t{107})->gap = true;
+  ASSERT_NE(nullptr, buf->front());
+  buf->front()->gap = false;
+  buf->popFront();
+  ASSERT_EQ(nullptr, buf->front());
+
+  buf->createOrGet(lsn_t{110})->gap = true;
+  buf->clear();
+  ASSERT_EQ(nullptr, buf->findFirstMarker().first);
+}
+
 INSTANTIATE_TEST_CASE_P(
     ClientReadStreamBufferTest,
     ClientReadStreamBufferTest,
     ::testing::Values(ClientReadStreamBufferType::CIRCULAR,
-                      ClientReadStreamBufferType::ORDERED_MAP));
+                      ClientReadStreamBufferType::ORDERED_MAP,
+                      ClientReadStreamBufferType::PACKED));
 
 }} // namespace facebook::logdevice
@@ -152,6 +152,25 @@ TEST_F(ClientReadStreamScd_FilteredOutTest, ApplyDeferredChangesBasic) {
   assert_shards({}, {}, {}, {});
 }
 
+TEST_F(ClientReadStreamScd_FilteredOutTest, HasDeferredChanges) {
+  ASSERT_FALSE(filtered_out.hasDeferredChanges());
+  ASSERT_TRUE(filtered_out.deferredAddShardDown(N0));
+  ASSERT_TRUE(filtered_out.hasDeferredChanges());
+  // Doesn't apply anything.
+  assert_shards({N0}, {}, {}, {});
+  ASSERT_TRUE(filtered_out.applyDeferredChanges());
+  ASSERT_FALSE(filtered_out.hasDeferredChanges());
+
+  // The shard comes back up, then goes down again before the changes are
+  // applied: nothing to apply.
+  ASSERT_TRUE(filtered_out.deferredRemoveShardDown(N0));
+  ASSERT_TRUE(filtered_out.hasDeferredChanges());
+  ASSERT_TRUE(filtered_out.deferredAddShardDown(N0));
+  ASSERT_FALSE(filtered_out.hasDeferredChanges());
+  ASSERT_FALSE(filtered_out.applyDeferredChanges());
+  assert_shards({N0}, {}, {N0}, {});
+}
+
 TEST_F(ClientReadStreamScd_FilteredOutTest, Clear) {
   assert_shards({}, {}, {}, {});
   // clear when is clear already, nothing happens
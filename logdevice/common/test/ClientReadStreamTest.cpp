@@ -166,6 +166,7 @@ struct TestState {
   std::vector<StartMessage> start;
   std::vector<ShardID> stop;
   std::vector<WindowMessage> window;
+  std::vector<std::pair<ShardID, lsn_t>> checksum_fail;
   std::vector<GapMessage> gap;
 
   std::unordered_map<ShardID, SocketCallback*, ShardID::Hash> on_close;
@@ -173,6 +174,10 @@ struct TestState {
   std::vector<epoch_t> metadata_req;
   bool callbacks_accepting = true;
   bool disposed = false;
+  // If set, records are delivered through recordBatchCallback(), and the size
+  // of each batch is appended to `batches`.
+  bool batch_callback = false;
+  std::vector<size_t> batches;
 
   // default metadata to be delivered when epoch metadata is requested
   EpochMetaData default_metadata;
@@ -299,11 +304,29 @@ class MockClientReadStreamDependencies : public ClientReadStreamDependencies {
     return 0;
   }
 
+  int sendChecksumFailMessage(ShardID shard, lsn_t lsn) override {
+    state_.checksum_fail.emplace_back(shard, lsn);
+    return 0;
+  }
+
   bool recordCallback(std::unique_ptr<DataRecord>& record) override {
     state_.recv.push_back(record->attrs.lsn);
     return state_.callbacks_accepting;
   }
 
+  bool hasRecordBatchCallback() const override {
+    return state_.batch_callback;
+  }
+
+  size_t recordBatchCallback(
+      std::vector<std::unique_ptr<DataRecord>>& records) override {
+    for (const auto& record : records) {
+      state_.recv.push_back(record->attrs.lsn);
+    }
+    state_.batches.push_back(records.size());
+    return state_.callbacks_accepting ? records.size() : 0;
+  }
+
   bool gapCallback(const GapRecord& gap) override {
     state_.gap.push_back(GapMessage{gap.type, gap.lo, gap.hi});
     return state_.callbacks_accepting;
@@ -505,6 +528,10 @@ class ClientReadStreamTest
     return read_stream_->reconnectTimerIsActive(shard);
   }
 
+  size_t numSenderTimers(ShardID shard) const {
+    return read_stream_->storage_set_states_.at(shard).numTimersAllocated();
+  }
+
   void fireReadMetadataRetryTimer() {
     ASSERT_NE(nullptr, read_stream_->retry_read_metadata_);
     ASSERT_TRUE(read_stream_->retry_read_metadata_->isActive());
@@ -870,7 +897,8 @@ INSTANTIATE_TEST_CASE_P(
     ClientReadStreamTest,
     ClientReadStreamTest,
     ::testing::Values(ClientReadStreamBufferType::CIRCULAR,
-                      ClientReadStreamBufferType::ORDERED_MAP));
+                      ClientReadStreamBufferType::ORDERED_MAP,
+                      ClientReadStreamBufferType::PACKED));
 
 /**
  * Simple test where records come in order from different nodes.
@@ -887,6 +915,22 @@ TEST_P(ClientReadStreamTest, Simple) {
   ASSERT_RECV(lsn(1, 4));
 }
 
+/**
+ * Records that fail checksum verification are reported to the shard that
+ * sent them.
+ */
+TEST_P(ClientReadStreamTest, ChecksumFailReported) {
+  start();
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1));
+  auto record = mockRecord(lsn(1, 2));
+  record->invalid_checksum_ = true;
+  onDataRecord(N1, std::move(record));
+  ASSERT_EQ(1, state_.checksum_fail.size());
+  EXPECT_EQ(N1, state_.checksum_fail[0].first);
+  EXPECT_EQ(lsn(1, 2), state_.checksum_fail[0].second);
+}
+
 /**
  * Buffering and delivering records that are received out of order.
  */
@@ -1922,6 +1966,23 @@ TEST_P(ClientReadStreamTest, STARTED_Syslimit) {
   ASSERT_TRUE(reconnectTimerIsActive(N0));
 }
 
+// Sender timers are only allocated while the shard is connecting and are
+// freed once it's READING.
+TEST_P(ClientReadStreamTest, SenderTimersReleasedWhenReading) {
+  start_lsn_ = lsn(1, 1);
+  until_lsn_ = lsn(1, 100);
+  start();
+
+  overrideConnectionStates(ConnectionState::START_SENT);
+  ON_STARTED_SYSLIMIT(filter_version_t{1}, N0);
+  ASSERT_TRUE(reconnectTimerIsActive(N0));
+  ASSERT_GT(numSenderTimers(N0), 0);
+
+  ON_STARTED(filter_version_t{1}, N0);
+  ASSERT_FALSE(reconnectTimerIsActive(N0));
+  ASSERT_EQ(0, numSenderTimers(N0));
+}
+
 // Ensures that Access Gaps are being sent even if client can not accept
 // gap records for a period of time
 TEST_P(ClientReadStreamTest, AccessGapRedelivery) {
@@ -4962,6 +5023,46 @@ TEST_P(ClientReadStreamTest, Redelivery) {
   ASSERT_WINDOW_MESSAGES(lsn(1, 5), lsn(1, 6), N0);
 }
 
+// With a batch callback, records that become deliverable at once are handed
+// over in one call.
+TEST_P(ClientReadStreamTest, BatchDelivery) {
+  state_.batch_callback = true;
+  buffer_size_ = 3;
+  start();
+  onDataRecord(N0, mockRecord(lsn(1, 2)));
+  onDataRecord(N0, mockRecord(lsn(1, 3)));
+  ASSERT_RECV();
+  onDataRecord(N1, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1), lsn(1, 2), lsn(1, 3));
+  EXPECT_EQ(std::vector<size_t>({3}), state_.batches);
+}
+
+// Rejected batches are redelivered, and the window isn't slid until they're
+// accepted.
+TEST_P(ClientReadStreamTest, BatchRedelivery) {
+  state_.shards.resize(1);
+  state_.batch_callback = true;
+  buffer_size_ = 2;
+  flow_control_threshold_ = 1.0;
+  start();
+
+  state_.callbacks_accepting = false;
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1));
+  ASSERT_TRUE(getRedeliveryTimer()->isActive());
+  ASSERT_NO_WINDOW_MESSAGES();
+
+  // Not delivered while waiting for the timer.
+  onDataRecord(N0, mockRecord(lsn(1, 2)));
+  ASSERT_RECV();
+
+  state_.callbacks_accepting = true;
+  dynamic_cast<MockBackoffTimer*>(getRedeliveryTimer())->trigger();
+  ASSERT_RECV(lsn(1, 1), lsn(1, 2));
+  ASSERT_FALSE(getRedeliveryTimer() && getRedeliveryTimer()->isActive());
+  ASSERT_WINDOW_MESSAGES(lsn(1, 3), lsn(1, 4), N0);
+}
+
 // If callbacks reject data, but client receives a TRIM gap in the meantime,
 // it should still redeliver the record.
 TEST_P(ClientReadStreamTest, NoFastForwardWhileRedelivering) {
@@ -7701,4 +7802,30 @@ TEST_P(ClientReadStreamTest, UnderReplicatedRecord2) {
   ASSERT_GAP_MESSAGES();
 }
 
+TEST(ClientReadStreamWindowTest, WindowSizeForBandwidthDelay) {
+  using std::chrono::microseconds;
+  using std::chrono::milliseconds;
+  // 10k records/s over a 10ms round trip is 100 records in flight, which
+  // must fit in the 30% of the window left when it slides, twice.
+  EXPECT_EQ(666,
+            ClientReadStream::windowSizeForBandwidthDelay(
+                10000, milliseconds(10), 0.7, 4096));
+  // Capped by the buffer.
+  EXPECT_EQ(512,
+            ClientReadStream::windowSizeForBandwidthDelay(
+                10000, milliseconds(10), 0.7, 512));
+  // Slow consumers get a small window, but not a tiny one.
+  EXPECT_EQ(16,
+            ClientReadStream::windowSizeForBandwidthDelay(
+                10, milliseconds(1), 0.7, 4096));
+  EXPECT_EQ(8,
+            ClientReadStream::windowSizeForBandwidthDelay(
+                10, microseconds(100), 0.7, 8));
+  // A threshold of 1 slides the window when it's all delivered.
+  EXPECT_NEAR(4000,
+              ClientReadStream::windowSizeForBandwidthDelay(
+                  1000, milliseconds(100), 1, 4096),
+              1);
+}
+
 }} // namespace facebook::logdevice
@@ -250,6 +250,9 @@ TEST(ConfigurationTest, SimpleValid) {
   EXPECT_DOUBLE_EQ(
       15.4,
       config->serverConfig()->getTracerSamplePercentage("appender").value());
+  EXPECT_EQ(100, config->serverConfig()->getTracerMaxSamplesPerSec("appender"));
+  EXPECT_EQ(
+      0, config->serverConfig()->getTracerMaxSamplesPerSec("UNKNOWN_TRACER"));
 
   char buf[256];
 
@@ -33,6 +33,14 @@ class TestCopySetSelectorDeps : public CopySetSelectorDependencies,
     return this;
   }
 
+  const ShardLatencyTracker* getShardLatencyTracker() const override {
+    return latency_tracker_;
+  }
+
+  void setShardLatencyTracker(const ShardLatencyTracker* tracker) {
+    latency_tracker_ = tracker;
+  }
+
   NodeAvailabilityChecker::NodeStatus getNodeStatus(NodeID node) const {
     return getNodeEntry(node).status_;
   }
@@ -84,6 +92,8 @@ class TestCopySetSelectorDeps : public CopySetSelectorDependencies,
 
   // For nodes that are not in the map status is AVAILABLE.
   std::unordered_map<NodeID, Entry, NodeID::Hash> node_status_;
+
+  const ShardLatencyTracker* latency_tracker_ = nullptr;
 };
 
 }} // namespace facebook::logdevice
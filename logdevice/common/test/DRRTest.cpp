@@ -455,3 +455,31 @@ TEST_F(DRRIntegrationTest, ByteBasedSmallQuantaVariableSize) {
   while ((task = params.q->dequeue()))
     ;
 }
+
+// Tenants of one principal share it in proportion to their weights
+TEST_F(DRRIntegrationTest, TenantWeights) {
+  std::vector<DRRPrincipal> shares{{"DRR-principal-0", 1}};
+  DRRScheduler<TestTask, &TestTask::schedulerQHook_> ioq;
+  ioq.initShares("unit-test-q", 1, shares);
+
+  // Tenant 1 has a deep queue, tenant 2 has twice its weight.
+  std::vector<std::unique_ptr<TestTask>> tasks;
+  for (int i = 0; i < 300; i++) {
+    uint64_t tenant = i < 200 ? 1 : 2;
+    tasks.push_back(std::make_unique<TestTask>(1));
+    tasks.back()->id_ = tenant;
+    ioq.enqueue(tasks.back().get(), 0, tenant, /*tenantWeight=*/tenant);
+  }
+
+  int count[3] = {0, 0, 0};
+  for (int i = 0; i < 150; i++) {
+    TestTask* task = ioq.dequeue();
+    ASSERT_NE(nullptr, task);
+    count[task->id_]++;
+  }
+  EXPECT_EQ(50, count[1]);
+  EXPECT_EQ(100, count[2]);
+
+  while (ioq.dequeue())
+    ;
+}
@@ -9,11 +9,14 @@
 
 #include <cstdio>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 #include <folly/Memory.h>
 #include <gtest/gtest.h>
 
 #include "logdevice/common/EpochMetaData.h"
+#include "logdevice/common/EpochMetaDataMap.h"
 #include "logdevice/common/MetaDataLogReader.h"
 
 #define N3 ShardID(3, 0)
@@ -155,6 +158,124 @@ TEST_F(EpochMetaDataCacheTest, Overwrite) {
   ASSERT_EQ(expected, result_);
 }
 
-// TODO: add test(s) for eviction
+TEST_F(EpochMetaDataCacheTest, Eviction) {
+  capacity_ = 40;
+  setUp();
+  for (epoch_t::raw_type e = 1; e <= 1000; ++e) {
+    cache_->setMetaData(LOG_ID,
+                        epoch_t(e),
+                        epoch_t(e),
+                        RecordSource::CACHED_CONSISTENT,
+                        genEpochMetaData(epoch_t(e)));
+  }
+  size_t hits = 0;
+  for (epoch_t::raw_type e = 1; e <= 1000; ++e) {
+    hits += getNoPromotion(epoch_t(e), true);
+  }
+  ASSERT_LE(hits, capacity_);
+  ASSERT_GT(hits, 0);
+  // the most recently inserted entry is always kept
+  ASSERT_TRUE(getNoPromotion(epoch_t(1000), true));
+}
+
+// Workers read and write the cache concurrently, including the same entries.
+// Every hit must return the entry set for the key.
+TEST_F(EpochMetaDataCacheTest, ConcurrentAccess) {
+  capacity_ = 64;
+  setUp();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i < 2000; ++i) {
+        const epoch_t epoch(1 + (i * 7 + t) % 100);
+        if (i % 3 == 0) {
+          cache_->setMetaData(LOG_ID,
+                              epoch,
+                              epoch_t(epoch.val_ + 10),
+                              RecordSource::CACHED_CONSISTENT,
+                              genEpochMetaData(epoch));
+          continue;
+        }
+        epoch_t until;
+        EpochMetaData metadata;
+        RecordSource source;
+        if (cache_->getMetaData(
+                LOG_ID, epoch, &until, &metadata, &source, true)) {
+          EXPECT_EQ(epoch_t(epoch.val_ + 10), until);
+          EXPECT_EQ(RecordSource::CACHED_CONSISTENT, source);
+          EXPECT_EQ(genEpochMetaData(epoch), metadata);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+// A cached EpochMetaDataMap answers lookups of every epoch it covers that
+// doesn't have an entry of its own.
+TEST_F(EpochMetaDataCacheTest, MetaDataMap) {
+  setUp();
+  auto epoch_map = std::make_shared<EpochMetaDataMap::Map>();
+  for (epoch_t::raw_type e : {1, 5, 9}) {
+    epoch_map->emplace(epoch_t(e), genEpochMetaData(epoch_t(e)));
+  }
+  cache_->setMetaDataMap(
+      LOG_ID, EpochMetaDataMap::create(std::move(epoch_map), epoch_t(12)));
+
+  Result expected{epoch_t(4),
+                  RecordSource::CACHED_CONSISTENT,
+                  genEpochMetaData(epoch_t(1))};
+  ASSERT_TRUE(get(epoch_t(3), true));
+  ASSERT_EQ(expected, result_);
+  Result expected2{epoch_t(12),
+                   RecordSource::CACHED_CONSISTENT,
+                   genEpochMetaData(epoch_t(9))};
+  ASSERT_TRUE(getNoPromotion(epoch_t(10), true));
+  ASSERT_EQ(expected2, result_);
+  // past the effective until of the map
+  ASSERT_FALSE(get(epoch_t(13), false));
+
+  // a soft entry doesn't hide the map from readers that need consistent
+  // metadata
+  cache_->setMetaData(LOG_ID,
+                      epoch_t(5),
+                      epoch_t(6),
+                      RecordSource::CACHED_SOFT,
+                      genEpochMetaData(epoch_t(5)));
+  Result expected3{epoch_t(8),
+                   RecordSource::CACHED_CONSISTENT,
+                   genEpochMetaData(epoch_t(5))};
+  ASSERT_TRUE(get(epoch_t(5), true));
+  ASSERT_EQ(expected3, result_);
+
+  // an older map doesn't replace a newer one
+  auto old_map = std::make_shared<EpochMetaDataMap::Map>();
+  old_map->emplace(epoch_t(1), genEpochMetaData(epoch_t(1)));
+  cache_->setMetaDataMap(
+      LOG_ID, EpochMetaDataMap::create(std::move(old_map), epoch_t(2)));
+  ASSERT_TRUE(get(epoch_t(10), true));
+  ASSERT_EQ(expected2, result_);
+}
+
+TEST_F(EpochMetaDataCacheTest, SharedFetch) {
+  setUp();
+  int notified = 0;
+  ASSERT_TRUE(cache_->startFetch(LOG_ID, [] { ADD_FAILURE(); }));
+  ASSERT_FALSE(cache_->startFetch(LOG_ID, [&] { ++notified; }));
+  ASSERT_FALSE(cache_->startFetch(LOG_ID, [&] { ++notified; }));
+  // fetches of other logs are independent
+  ASSERT_TRUE(cache_->startFetch(logid_t(LOG_ID.val_ + 1), [] {}));
+  ASSERT_EQ(0, notified);
+
+  cache_->finishFetch(LOG_ID);
+  ASSERT_EQ(2, notified);
+  // the next reader to miss the cache fetches again
+  ASSERT_TRUE(cache_->startFetch(LOG_ID, [] {}));
+  cache_->finishFetch(LOG_ID);
+  cache_->finishFetch(logid_t(LOG_ID.val_ + 1));
+  ASSERT_EQ(2, notified);
+}
 
 } // namespace
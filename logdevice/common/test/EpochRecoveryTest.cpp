@@ -543,6 +543,60 @@ TEST_F(EpochRecoveryTest, Basic) {
   ASSERT_TRUE(lce_tail_.sameContent(result_.tail));
 }
 
+// the previous sequencer drained the epoch before handing the log over:
+// - esn 1 was fully replicated on N1 and N2 and released, local LNG == 1
+// - N1 and N2 report the tail record at esn 1 and no records past it
+// - epoch recovery skips the digest and goes straight to plugging the bridge
+TEST_F(EpochRecoveryTest, SkipDigestOfDrainedEpoch) {
+  settings_.recovery_skip_digest_of_drained_epochs = true;
+  setUp();
+  OffsetMap om;
+  om.setCounter(BYTE_OFFSET, 19);
+  TailRecord tail(
+      {LOG_ID,
+       lsn(epoch_, 1),
+       9,
+       {BYTE_OFFSET_INVALID /* deprecated, use OffsetMap instead */},
+       TailRecordHeader::CHECKSUM_PARITY |
+           TailRecordHeader::OFFSET_WITHIN_EPOCH,
+       {}},
+      OffsetMap(om),
+      std::shared_ptr<PayloadHolder>());
+  erm_->activate(prev_tail_);
+  erm_->onSealed(N1, esn_t(1), esn_t(1), om, tail);
+  checkRecoveryState(ERMState::SEAL_OR_INACTIVE);
+  erm_->onSealed(N2, esn_t(1), esn_t(1), om, tail);
+  ASSERT_EQ(esn_t(2), erm_->getDigestStart());
+  ASSERT_NODE_STATE(NState::DIGESTING);
+  ASSERT_NODE_STATE(NState::MUTATABLE, N1, N2);
+  ASSERT_NODE_STATE(NState::SEALING, N3);
+
+  ASSERT_TRUE(erm_->getGracePeriodTimer()->isActive());
+  static_cast<MockTimer*>(erm_->getGracePeriodTimer())->trigger();
+  checkRecoveryState(ERMState::MUTATION);
+  ASSERT_EQ(1, erm_->getMutators().size());
+  ASSERT_TRUE(erm_->getMutators().at(esn_t(2))->getStoreHeader().flags &
+              STORE_Header::BRIDGE);
+
+  erm_->onMutationComplete(esn_t(2), E::OK, ShardID());
+  checkRecoveryState(ERMState::CLEAN);
+  erm_->onMessageSent(N1, MessageType::CLEAN, E::OK);
+  erm_->onMessageSent(N2, MessageType::CLEAN, E::OK);
+  erm_->onCleaned(N1, E::OK, Seal());
+  erm_->onCleaned(N2, E::OK, Seal());
+  checkRecoveryState(ERMState::ADVANCE_LCE);
+
+  // tail record is the one from SEALED replies
+  ASSERT_EQ(lsn(epoch_, 1), lce_tail_.header.lsn);
+  ASSERT_EQ(9, lce_tail_.header.timestamp);
+  ASSERT_EQ(OffsetMap::mergeOffsets(prev_tail_.offsets_map_, om),
+            lce_tail_.offsets_map_);
+
+  erm_->onLastCleanEpochUpdated(E::OK, epoch_, lce_tail_);
+  ASSERT_TRUE(finished_);
+  ASSERT_EQ(E::OK, result_.st);
+}
+
 // similar to the basic test, but node changes authoritative status
 // causing state machine to be restarted
 TEST_F(EpochRecoveryTest, RestartWhenAuthoritativeStatusChanges) {
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 
+#include "logdevice/common/Checksum.h"
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/configuration/InternalLogs.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
@@ -1633,6 +1634,128 @@ TEST_P(EventLogTest, TimeBasedSnapsho) {
   subscriber_->assertNoUpdate();
 }
 
+// A delta snapshot extends the base snapshot before it with the deltas read
+// since then. Both are needed to rebuild the state.
+TEST_P(EventLogTest, DeltaSnapshot) {
+  delta_log_tail_lsn_ = lsn_t{42};
+  snapshot_log_tail_lsn_ = lsn_t{5};
+  settings_updater_->setFromCLI(
+      {{"event-log-snapshotting", "true"},
+       {"rsm-include-read-pointer-in-snapshot", "true"}});
+  init();
+  evlog_->start();
+
+  // Base snapshot where N2 is rebuilding.
+  EventLogRebuildingSet set;
+  UPDATE(set, lsn_t{33}, SHARD_NEEDS_REBUILD, node_index_t{2}, uint32_t{0});
+  SNAPSHOT(set, lsn_t{33}, lsn_t{4});
+  subscriber_->assertNoUpdate();
+
+  // Delta snapshot with the delta at lsn 40 where N3 is added to the
+  // rebuilding set.
+  RSMDeltaSnapshot delta_snapshot;
+  delta_snapshot.prev_delta_log_read_ptr = lsn_t{33};
+  {
+    SHARD_NEEDS_REBUILD_Event e(node_index_t{3}, uint32_t{0});
+    auto r = genDeltaRecord(e, lsn_t{40});
+    delta_snapshot.deltas.push_back(
+        {lsn_t{40},
+         r->attrs.timestamp,
+         std::string(reinterpret_cast<const char*>(r->payload.data()),
+                     r->payload.size())});
+  }
+  auto buf = evlog_->createDeltaSnapshotPayload(
+      delta_snapshot, lsn_t{40}, /*delta_log_read_ptr=*/lsn_t{41});
+  void* malloced = malloc(buf.size());
+  memcpy(malloced, &buf[0], buf.size());
+  std::unique_ptr<DataRecord> p = std::make_unique<DataRecordOwnsPayload>(
+      configuration::InternalLogs::EVENT_LOG_SNAPSHOTS,
+      Payload(malloced, buf.size()),
+      lsn_t{5},
+      std::chrono::milliseconds{100},
+      0 // flags
+  );
+  evlog_->onSnapshotRecord(p);
+  subscriber_->assertNoUpdate();
+
+  DELTA_GAP(BRIDGE, LSN_OLDEST, lsn_t{41});
+  subscriber_->assertNoUpdate();
+
+  DELTA(lsn_t{42}, SHARD_NEEDS_REBUILD, node_index_t{1}, uint32_t{0});
+  auto u = subscriber_->retrieveNextUpdate();
+  ASSERT_EQ(lsn_t{42}, u.version);
+  ASSERT_SHARD_STATUS(u.state, node_index_t{1}, uint32_t{0}, UNAVAILABLE);
+  ASSERT_SHARD_STATUS(u.state, node_index_t{2}, uint32_t{0}, UNAVAILABLE);
+  ASSERT_SHARD_STATUS(u.state, node_index_t{3}, uint32_t{0}, UNAVAILABLE);
+  ASSERT_EQ(nullptr, u.delta);
+  subscriber_->assertNoUpdate();
+}
+
+// A snapshot written as chunk records followed by a manifest is read back as
+// if it had been written as a single record.
+TEST_P(EventLogTest, ChunkedSnapshot) {
+  delta_log_tail_lsn_ = lsn_t{42};
+  snapshot_log_tail_lsn_ = lsn_t{5};
+  init();
+  evlog_->start();
+
+  EventLogRebuildingSet set;
+  UPDATE(set, lsn_t{33}, SHARD_NEEDS_REBUILD, node_index_t{2}, uint32_t{0});
+  auto buf = evlog_->createSnapshotPayload(
+      set, lsn_t{33}, settings_->rsm_include_read_pointer_in_snapshot);
+  RSMSnapshotHeader header;
+  const int header_sz =
+      RSMSnapshotHeader::deserialize(Payload(buf.data(), buf.size()), header);
+  ASSERT_GT(header_sz, 0);
+  const std::string body = buf.substr(header_sz);
+
+  auto make_record = [](const std::string& payload, lsn_t lsn) {
+    void* malloced = malloc(payload.size());
+    memcpy(malloced, &payload[0], payload.size());
+    return std::unique_ptr<DataRecord>(std::make_unique<DataRecordOwnsPayload>(
+        configuration::InternalLogs::EVENT_LOG_SNAPSHOTS,
+        Payload(malloced, payload.size()),
+        lsn,
+        std::chrono::milliseconds{100},
+        0 // flags
+        ));
+  };
+
+  // Split the body in two chunks at lsns 2 and 4. The chunk at lsn 1 is a
+  // leftover of a snapshot whose manifest was never written.
+  RSMSnapshotManifest manifest;
+  const size_t half = body.size() / 2;
+  const Slice slices[] = {
+      Slice(body.data(), half), Slice(body.data() + half, body.size() - half)};
+  const lsn_t lsns[] = {lsn_t{2}, lsn_t{4}};
+  auto r = make_record(
+      RSMSnapshotManifest::createChunkPayload(header, slices[0]), lsn_t{1});
+  ASSERT_TRUE(evlog_->onSnapshotRecord(r));
+  for (int i = 0; i < 2; ++i) {
+    manifest.chunks.push_back(
+        {lsns[i], slices[i].size, checksum_32bit(slices[i])});
+    r = make_record(
+        RSMSnapshotManifest::createChunkPayload(header, slices[i]), lsns[i]);
+    ASSERT_TRUE(evlog_->onSnapshotRecord(r));
+  }
+  subscriber_->assertNoUpdate();
+
+  r = make_record(manifest.createManifestPayload(header), lsn_t{5});
+  ASSERT_TRUE(evlog_->onSnapshotRecord(r));
+  subscriber_->assertNoUpdate();
+
+  DELTA_GAP(BRIDGE, LSN_OLDEST, lsn_t{41});
+  subscriber_->assertNoUpdate();
+
+  DELTA(lsn_t{42}, SHARD_NEEDS_REBUILD, node_index_t{1}, uint32_t{0});
+  auto u = subscriber_->retrieveNextUpdate();
+  ASSERT_EQ(lsn_t{42}, u.version);
+  ASSERT_SHARD_STATUS(u.state, node_index_t{1}, uint32_t{0}, UNAVAILABLE);
+  ASSERT_SHARD_STATUS(u.state, node_index_t{2}, uint32_t{0}, UNAVAILABLE);
+  ASSERT_EQ(nullptr, u.delta);
+  subscriber_->assertNoUpdate();
+}
+
 // Run all tests with and without snapshot compression.
 INSTANTIATE_TEST_CASE_P(T, EventLogTest, ::testing::Values(false, true));
 
@@ -8,6 +8,8 @@
 #include "logdevice/common/EventLoopTaskQueue.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <folly/Executor.h>
 #include <gtest/gtest.h>
@@ -94,3 +96,45 @@ TEST(EventLoopTaskQueue, PostPrioritizedWork) {
   EXPECT_EQ(num_mid_pri_task, num_mid_pri_executed);
   EXPECT_EQ(num_lo_pri_task, num_lo_pri_executed);
 }
+
+TEST(EventLoopTaskQueue, AddBatch) {
+  auto el = std::make_unique<EventLoop>();
+  std::vector<int> hi_executed;
+  std::vector<int> lo_executed;
+
+  Semaphore block, ready;
+  el->add([&block, &ready] {
+    ready.post();
+    block.wait();
+  });
+  ready.wait();
+
+  constexpr int kBatchSize = 100;
+  std::vector<std::pair<Func, int8_t>> funcs;
+  for (int i = 0; i < kBatchSize; ++i) {
+    if (i % 2) {
+      funcs.emplace_back(
+          [&hi_executed, i] { hi_executed.push_back(i); },
+          folly::Executor::HI_PRI);
+    } else {
+      funcs.emplace_back(
+          [&lo_executed, i] { lo_executed.push_back(i); },
+          folly::Executor::LO_PRI);
+    }
+  }
+  ASSERT_EQ(0, el->getTaskQueue().addBatch(std::move(funcs)));
+  ASSERT_EQ(0, el->getTaskQueue().addBatch({}));
+  block.post();
+
+  Semaphore gate;
+  el->add([&gate] { gate.post(); });
+  gate.wait();
+
+  ASSERT_EQ(kBatchSize / 2, hi_executed.size());
+  ASSERT_EQ(kBatchSize / 2, lo_executed.size());
+  // Order within a priority is preserved.
+  for (int i = 0; i < kBatchSize / 2; ++i) {
+    EXPECT_EQ(2 * i + 1, hi_executed[i]);
+    EXPECT_EQ(2 * i, lo_executed[i]);
+  }
+}
@@ -7,6 +7,7 @@
  */
 #include <numeric>
 
+#include <folly/Format.h>
 #include <folly/Memory.h>
 #include <gtest/gtest.h>
 
@@ -70,6 +71,7 @@ class FailureDomainTest : public ::testing::Test {
   void setUpWithMultiScopes();
   void setUpWithShards();
   void setUpWithShardsAndOnlyRackReplication();
+  void setUpWithWideRacks();
   void setShardsAttr(TestAttr attr, const StorageSet& shards);
   void setAllShardsAttr(TestAttr attr);
   void setShardAuthoritativeStatus(AuthoritativeStatus st,
@@ -238,6 +240,38 @@ void FailureDomainTest::setUpWithShardsAndOnlyRackReplication() {
   failure_set_->fullConsistencyCheck();
 }
 
+void FailureDomainTest::setUpWithWideRacks() {
+  dbg::assertOnData = true;
+
+  // 100 nodes in 10 racks, so that racks span the words of the bitsets.
+  configuration::Nodes nodes;
+  for (int rack = 0; rack < 10; ++rack) {
+    addNodes(&nodes, 10, 1, folly::sformat("rg0.dc0.cl0.ro0.rk{}", rack), 1);
+  }
+
+  for (node_index_t nid = 0; nid < nodes.size(); ++nid) {
+    storage_set_.push_back(ShardID(nid, 0));
+  }
+
+  Configuration::NodesConfig nodes_config;
+  const size_t nodeset_size = nodes.size();
+  nodes_config.setNodes(std::move(nodes));
+
+  auto logs_config = std::make_shared<configuration::LocalLogsConfig>();
+  addLog(logs_config.get(), LOG_ID, replication_, 0, nodeset_size, {});
+
+  config_ = std::make_shared<Configuration>(
+      ServerConfig::fromDataTest(
+          "failure_domain_test", std::move(nodes_config)),
+      std::move(logs_config));
+
+  failure_set_ = std::make_unique<FailureDomainTestSet>(
+      storage_set_,
+      *config_->serverConfig()->getNodesConfigurationFromServerConfigSource(),
+      ReplicationProperty(replication_, NodeLocationScope::RACK));
+  failure_set_->fullConsistencyCheck();
+}
+
 void FailureDomainTest::setShardsAttr(TestAttr attr, const StorageSet& shards) {
   for (const auto shard : shards) {
     failure_set_->setShardAttribute(shard, attr);
@@ -915,4 +949,76 @@ TEST_F(FailureDomainTest, T30067676) {
   ASSERT_EQ(FmajorityResult::AUTHORITATIVE_INCOMPLETE, ret);
 }
 
+TEST_F(FailureDomainTest, Layout) {
+  setUpWithMultiScopes();
+
+  ReplicationProperty rep;
+  rep.setReplication(NodeLocationScope::NODE, 3);
+  rep.setReplication(NodeLocationScope::RACK, 3);
+  rep.setReplication(NodeLocationScope::REGION, 2);
+  auto layout = FailureDomainLayout::compute(
+      storage_set_,
+      *config_->serverConfig()->getNodesConfigurationFromServerConfigSource(),
+      rep);
+
+  EXPECT_EQ(storage_set_, layout->shards);
+  EXPECT_EQ(3, layout->shard_replication);
+  // NODE scope doesn't require more than RACK scope and is omitted.
+  ASSERT_EQ(2, layout->scopes.size());
+
+  const FailureDomainLayout::Scope& region = layout->scopes[0];
+  EXPECT_EQ(NodeLocationScope::REGION, region.scope);
+  EXPECT_EQ(2, region.replication);
+  EXPECT_EQ(2, region.num_domains);
+  const FailureDomainLayout::Scope& rack = layout->scopes[1];
+  EXPECT_EQ(NodeLocationScope::RACK, rack.scope);
+  EXPECT_EQ(3, rack.replication);
+  EXPECT_EQ(6, rack.num_domains);
+
+  ASSERT_EQ(storage_set_.size(), region.shard_domains.size());
+  ASSERT_EQ(storage_set_.size(), rack.shard_domains.size());
+  for (size_t i = 0; i < storage_set_.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(i / 12), region.shard_domains[i]);
+    EXPECT_EQ(static_cast<int>(i / 4), rack.shard_domains[i]);
+  }
+}
+
+TEST_F(FailureDomainTest, FmajorityPredicateWideStorageSet) {
+  replication_ = 3;
+  setUpWithWideRacks();
+
+  auto shards = [&](size_t begin, size_t end) {
+    return StorageSet(storage_set_.begin() + begin, storage_set_.begin() + end);
+  };
+  auto a_or_b = [](TestAttr attr) {
+    return attr == TestAttr::A || attr == TestAttr::B;
+  };
+
+  // Racks 0-6 have all their shards tagged with either A or B.
+  for (size_t i = 0; i < 70; ++i) {
+    failure_set_->setShardAttribute(
+        storage_set_[i], i % 2 ? TestAttr::A : TestAttr::B);
+  }
+  ASSERT_EQ(F::NONE, failure_set_->isFmajority(a_or_b));
+
+  // With rack 7 we have 8 racks out of 10.
+  setShardsAttr(TestAttr::B, shards(70, 80));
+  ASSERT_EQ(F::AUTHORITATIVE_INCOMPLETE, failure_set_->isFmajority(a_or_b));
+  ASSERT_EQ(F::NONE, failure_set_->isFmajority(TestAttr::A));
+
+  // The remaining racks are empty.
+  setShardAuthoritativeStatus(
+      AuthoritativeStatus::AUTHORITATIVE_EMPTY, shards(80, 100));
+  ASSERT_EQ(F::AUTHORITATIVE_COMPLETE, failure_set_->isFmajority(a_or_b));
+
+  // Rack 6 straddles the first two words of the bitsets.
+  setShardsAttr(TestAttr::C, {ShardID(65, 0)});
+  ASSERT_EQ(F::AUTHORITATIVE_INCOMPLETE, failure_set_->isFmajority(a_or_b));
+  ASSERT_FALSE(failure_set_->isCompleteSet(a_or_b));
+
+  setShardAuthoritativeStatus(
+      AuthoritativeStatus::AUTHORITATIVE_EMPTY, {ShardID(65, 0)});
+  ASSERT_EQ(F::AUTHORITATIVE_COMPLETE, failure_set_->isFmajority(a_or_b));
+}
+
 } // anonymous namespace
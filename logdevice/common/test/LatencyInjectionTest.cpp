@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/LatencyInjection.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using std::chrono::milliseconds;
+using Type = LatencyDistribution::Type;
+
+TEST(LatencyInjectionTest, Fixed) {
+  LatencyDistribution d(milliseconds(7));
+  EXPECT_FALSE(d.zero());
+  for (uint64_t n = 0; n < 10; ++n) {
+    EXPECT_EQ(milliseconds(7), d.sample(n));
+  }
+  EXPECT_TRUE(LatencyDistribution().zero());
+}
+
+TEST(LatencyInjectionTest, UniformIsBoundedAndReproducible) {
+  LatencyDistribution d(milliseconds(10), Type::UNIFORM, milliseconds(20), 42);
+  LatencyDistribution same(
+      milliseconds(10), Type::UNIFORM, milliseconds(20), 42);
+  milliseconds lo(1000), hi(0);
+  for (uint64_t n = 0; n < 1000; ++n) {
+    auto v = d.sample(n);
+    EXPECT_EQ(v, same.sample(n));
+    lo = std::min(lo, v);
+    hi = std::max(hi, v);
+  }
+  EXPECT_EQ(milliseconds(10), lo);
+  EXPECT_EQ(milliseconds(20), hi);
+}
+
+TEST(LatencyInjectionTest, ExponentialMeanAndCap) {
+  LatencyDistribution d(
+      milliseconds(10), Type::EXPONENTIAL, milliseconds(0), 1);
+  const int kSamples = 100000;
+  double sum = 0;
+  for (uint64_t n = 0; n < kSamples; ++n) {
+    sum += d.sample(n).count();
+  }
+  EXPECT_NEAR(10.0, sum / kSamples, 0.5);
+
+  LatencyDistribution capped(
+      milliseconds(10), Type::EXPONENTIAL, milliseconds(15), 1);
+  for (uint64_t n = 0; n < 1000; ++n) {
+    EXPECT_LE(capped.sample(n), milliseconds(15));
+  }
+}
+
+TEST(LatencyInjectionTest, ParseType) {
+  EXPECT_EQ(Type::FIXED, LatencyDistribution::parseType("fixed").value());
+  EXPECT_EQ(Type::EXPONENTIAL,
+            LatencyDistribution::parseType("exponential").value());
+  EXPECT_FALSE(LatencyDistribution::parseType("normal").hasValue());
+}
+
+TEST(LatencyInjectionTest, MessageLatencyInjection) {
+  auto& injection = MessageLatencyInjection::instance();
+  EXPECT_EQ(milliseconds(0), injection.getLatencyToInject(MessageType::STORE));
+
+  injection.set(MessageType::STORE, LatencyDistribution(milliseconds(5)), 100);
+  EXPECT_EQ(milliseconds(5), injection.getLatencyToInject(MessageType::STORE));
+  EXPECT_EQ(milliseconds(0), injection.getLatencyToInject(MessageType::STORED));
+  ASSERT_EQ(1u, injection.describe().size());
+  EXPECT_EQ(MessageType::STORE, injection.describe()[0].first);
+
+  injection.set(folly::none, LatencyDistribution(milliseconds(3)), 100);
+  EXPECT_EQ(milliseconds(3), injection.getLatencyToInject(MessageType::STORE));
+  EXPECT_EQ(milliseconds(3), injection.getLatencyToInject(MessageType::STORED));
+
+  // Zero chance never injects.
+  injection.set(MessageType::STORED, LatencyDistribution(milliseconds(3)), 0);
+  EXPECT_EQ(milliseconds(0), injection.getLatencyToInject(MessageType::STORED));
+
+  injection.clear();
+  EXPECT_EQ(milliseconds(0), injection.getLatencyToInject(MessageType::STORE));
+  EXPECT_TRUE(injection.describe().empty());
+}
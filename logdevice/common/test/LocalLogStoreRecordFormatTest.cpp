@@ -175,6 +175,17 @@ TEST_P(LocalLogStoreRecordFormatTest, RoundTrip) {
   }
   ASSERT_EQ(optional_keys.at(KeyType::FILTERABLE),
             optional_keys_read.at(KeyType::FILTERABLE));
+
+  // Only the FILTERABLE key, as server-side filtering does.
+  LocalLogStoreRecordFormat::flags_t filterable_flags;
+  folly::Optional<folly::StringPiece> filterable_key;
+  rv = LocalLogStoreRecordFormat::parseFilterableKey(
+      log_store_blob, &filterable_flags, &filterable_key);
+  ASSERT_EQ(0, rv);
+  ASSERT_EQ(expected_flags, filterable_flags);
+  ASSERT_TRUE(filterable_key.hasValue());
+  ASSERT_EQ("abcd", filterable_key.value());
+
   // Now get the copyset
   ShardID copyset_read[copyset_size_read];
   rv = LocalLogStoreRecordFormat::parse(log_store_blob,
@@ -273,6 +284,205 @@ TEST_P(LocalLogStoreRecordFormatTest, CSIRoundTrip) {
   ASSERT_EQ(rec_2, copyset_read[1]);
 }
 
+TEST(LocalLogStoreRecordFormatFilterableKeyTest, NoFilterableKey) {
+  STORE_Header header;
+  header.rid = {esn_t(1), epoch_t(2), logid_t(3)};
+  header.timestamp = 1000;
+  header.last_known_good = esn_t(0);
+  header.wave = 1;
+  header.flags = 0;
+  header.copyset_size = 1;
+  const StoreChainLink copyset[] = {{ShardID(1, 0), ClientID()}};
+
+  for (bool with_findkey : {false, true}) {
+    std::map<KeyType, std::string> optional_keys;
+    if (with_findkey) {
+      optional_keys[KeyType::FINDKEY] = "12345678";
+    }
+    std::string buf;
+    Slice blob = LocalLogStoreRecordFormat::formRecordHeader(
+        header, copyset, &buf, true, optional_keys, STORE_Extra());
+
+    LocalLogStoreRecordFormat::flags_t flags;
+    folly::Optional<folly::StringPiece> key = folly::StringPiece("garbage");
+    ASSERT_EQ(
+        0, LocalLogStoreRecordFormat::parseFilterableKey(blob, &flags, &key));
+    EXPECT_FALSE(key.hasValue());
+    EXPECT_EQ(with_findkey,
+              bool(flags & LocalLogStoreRecordFormat::FLAG_OPTIONAL_KEYS));
+  }
+
+  // Truncated record.
+  LocalLogStoreRecordFormat::flags_t flags;
+  folly::Optional<folly::StringPiece> key;
+  EXPECT_EQ(-1,
+            LocalLogStoreRecordFormat::parseFilterableKey(
+                Slice("ab", 2), &flags, &key));
+  EXPECT_EQ(E::MALFORMED_RECORD, err);
+}
+
+TEST(LocalLogStoreRecordFormatV2Test, RoundTrip) {
+  using namespace LocalLogStoreRecordFormat;
+  const ShardID copyset[] = {ShardID(88, 3), ShardID(99, 64)};
+  OffsetMap om;
+  om.setCounter(BYTE_OFFSET, 34);
+
+  for (bool with_offsets : {false, true}) {
+    for (bool with_keys : {false, true}) {
+      for (bool by_recovery : {false, true}) {
+        flags_t flags = FLAG_FORMAT_V2 | FLAG_CHECKSUM;
+        std::map<KeyType, std::string> optional_keys;
+        if (with_offsets) {
+          flags |= FLAG_OFFSET_WITHIN_EPOCH;
+        }
+        if (with_keys) {
+          flags |= FLAG_CUSTOM_KEY | FLAG_OPTIONAL_KEYS;
+          optional_keys[KeyType::FINDKEY] = "1234567";
+          optional_keys[KeyType::FILTERABLE] = "abcd";
+        }
+        if (by_recovery) {
+          flags |= FLAG_WRITTEN_BY_RECOVERY;
+        }
+        std::string buf;
+        Slice header_blob = formRecordHeader(496152000000,
+                                             esn_t(100),
+                                             flags,
+                                             4321,
+                                             folly::range(copyset),
+                                             om,
+                                             optional_keys,
+                                             &buf);
+        buf.append("data");
+        Slice blob(buf.data(), buf.size());
+        // Timestamp, lng, padded flags, wave, copyset size, copyset.
+        EXPECT_LE(8 + 4 + 4 + 4 + 1 + 2 * sizeof(ShardID), header_blob.size);
+
+        std::chrono::milliseconds timestamp_read;
+        esn_t lng_read;
+        flags_t flags_read;
+        uint32_t wave_read;
+        copyset_size_t copyset_size_read;
+        ShardID copyset_read[2];
+        OffsetMap offsets_read;
+        std::map<KeyType, std::string> keys_read;
+        Payload payload_read;
+        ASSERT_EQ(0,
+                  parse(blob,
+                        &timestamp_read,
+                        &lng_read,
+                        &flags_read,
+                        &wave_read,
+                        &copyset_size_read,
+                        copyset_read,
+                        2,
+                        &offsets_read,
+                        &keys_read,
+                        &payload_read,
+                        -1 /* unused */));
+        EXPECT_EQ(std::chrono::milliseconds(496152000000), timestamp_read);
+        EXPECT_EQ(esn_t(100), lng_read);
+        EXPECT_EQ(flags | FLAG_SHARD_ID |
+                      (with_offsets ? FLAG_OFFSET_MAP : flags_t(0)),
+                  flags_read);
+        EXPECT_EQ(4321, wave_read);
+        ASSERT_EQ(2, copyset_size_read);
+        EXPECT_EQ(copyset[0], copyset_read[0]);
+        EXPECT_EQ(copyset[1], copyset_read[1]);
+        if (with_offsets) {
+          EXPECT_EQ(om, offsets_read);
+        } else {
+          EXPECT_FALSE(offsets_read.isValid());
+        }
+        EXPECT_EQ(optional_keys, keys_read);
+        EXPECT_EQ("data", payload_read.toString());
+
+        // Too small array for the copyset.
+        EXPECT_EQ(-1,
+                  parse(blob,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        copyset_read,
+                        1,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        -1 /* unused */));
+        EXPECT_EQ(E::NOBUFS, err);
+
+        bool written_by_recovery;
+        ASSERT_EQ(0, isWrittenByRecovery(blob, &written_by_recovery));
+        EXPECT_EQ(by_recovery, written_by_recovery);
+
+        flags_t filterable_flags;
+        folly::Optional<folly::StringPiece> key;
+        ASSERT_EQ(0, parseFilterableKey(blob, &filterable_flags, &key));
+        EXPECT_EQ(flags_read, filterable_flags);
+        EXPECT_EQ(with_keys, key.hasValue());
+        if (with_keys) {
+          EXPECT_EQ("abcd", key.value());
+        }
+
+        size_t hash;
+        ASSERT_EQ(0, getCopysetHash(blob, &hash));
+
+        // Truncating the fixed part or the variable sections is detected.
+        for (size_t size : {size_t(10), header_blob.size - 1}) {
+          EXPECT_EQ(-1,
+                    parse(Slice(buf.data(), size),
+                          nullptr,
+                          nullptr,
+                          nullptr,
+                          nullptr,
+                          nullptr,
+                          nullptr,
+                          0,
+                          nullptr,
+                          nullptr,
+                          nullptr,
+                          -1 /* unused */));
+          EXPECT_EQ(E::MALFORMED_RECORD, err);
+        }
+      }
+    }
+  }
+}
+
+TEST(LocalLogStoreRecordFormatV2Test, FromStoreHeader) {
+  STORE_Header header;
+  header.rid = {esn_t(1), epoch_t(2), logid_t(3)};
+  header.timestamp = 1000;
+  header.last_known_good = esn_t(0);
+  header.wave = 1;
+  header.flags = 0;
+  header.copyset_size = 1;
+  const StoreChainLink copyset[] = {{ShardID(1, 2), ClientID()}};
+
+  std::string buf;
+  Slice blob = LocalLogStoreRecordFormat::formRecordHeader(
+      header, copyset, &buf, false, {}, STORE_Extra(), true);
+  LocalLogStoreRecordFormat::flags_t flags;
+  ShardID copyset_read;
+  ASSERT_EQ(0,
+            LocalLogStoreRecordFormat::parse(blob,
+                                             nullptr,
+                                             nullptr,
+                                             &flags,
+                                             nullptr,
+                                             nullptr,
+                                             &copyset_read,
+                                             1,
+                                             nullptr,
+                                             nullptr,
+                                             nullptr,
+                                             -1 /* unused */));
+  EXPECT_TRUE(flags & LocalLogStoreRecordFormat::FLAG_FORMAT_V2);
+  EXPECT_TRUE(flags & LocalLogStoreRecordFormat::FLAG_SHARD_ID);
+  EXPECT_EQ(ShardID(1, 2), copyset_read);
+}
+
 INSTANTIATE_TEST_CASE_P(LocalLogStoreRecordFormatTest,
                         LocalLogStoreRecordFormatTest,
                         ::testing::Combine(::testing::Bool(),
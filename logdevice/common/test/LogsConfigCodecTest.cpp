@@ -13,6 +13,7 @@
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/SecurityInformation.h"
 #include "logdevice/common/configuration/logs/FBuffersLogsConfigCodec.h"
+#include "logdevice/common/configuration/logs/LazyLogsConfigTree.h"
 #include "logdevice/include/LogAttributes.h"
 
 using namespace facebook::logdevice::logsconfig;
@@ -512,6 +513,88 @@ TEST(LogsConfigCodecTest, LogsConfigTreeCodecTest3) {
   ASSERT_FALSE(lg2->attrs().scdEnabled().value());
 }
 
+TEST(LogsConfigCodecTest, LazyLogsConfigTree) {
+  auto defaults = DefaultLogAttributes().with_replicationFactor(2);
+  auto tree = LogsConfigTree::create("/", defaults);
+  tree->setVersion(lsn_t(42));
+  ASSERT_NE(nullptr,
+            tree->addLogGroup("/dir1/log1",
+                              logid_range_t{logid_t(1), logid_t(10)},
+                              LogAttributes(),
+                              true));
+  ASSERT_NE(nullptr,
+            tree->addDirectory(tree->root(),
+                               "dir2",
+                               LogAttributes().with_replicationFactor(3)));
+  ASSERT_NE(nullptr,
+            tree->addLogGroup("/dir2/dir3/log2",
+                              logid_range_t{logid_t(20), logid_t(20)},
+                              LogAttributes().with_extraCopies(1),
+                              true));
+  ASSERT_NE(nullptr,
+            tree->addLogGroup("/log3",
+                              logid_range_t{logid_t(11), logid_t(15)},
+                              LogAttributes().with_replicationFactor(4),
+                              true));
+
+  PayloadHolder payload = FBuffersLogsConfigCodec::serialize(*tree, false);
+  ASSERT_TRUE(payload.valid());
+  std::shared_ptr<LazyLogsConfigTree> lazy =
+      LazyLogsConfigTree::create(payload.getPayload(), "/", lsn_t(42));
+  ASSERT_NE(nullptr, lazy);
+  ASSERT_EQ(3, lazy->numLogGroups());
+
+  for (const char* path : {"/dir1/log1", "dir2/dir3/log2/", "/log3"}) {
+    auto expected = tree->findLogGroup(path);
+    auto lg = lazy->findLogGroup(path);
+    ASSERT_NE(nullptr, lg);
+    ASSERT_EQ(*expected, *lg);
+    // cached
+    ASSERT_EQ(lg, lazy->findLogGroup(path));
+  }
+  ASSERT_EQ(nullptr, lazy->findLogGroup("/dir1"));
+  ASSERT_EQ(E::NOTFOUND, err);
+
+  for (logid_t::raw_type id = 0; id <= 21; ++id) {
+    const LogGroupInDirectory* expected = tree->getLogGroupByID(logid_t(id));
+    std::string path;
+    auto lg = lazy->getLogGroupByID(logid_t(id), &path);
+    ASSERT_EQ(expected != nullptr, lazy->logExists(logid_t(id)));
+    if (!expected) {
+      ASSERT_EQ(nullptr, lg);
+      continue;
+    }
+    ASSERT_NE(nullptr, lg);
+    ASSERT_EQ(*expected->log_group, *lg);
+    ASSERT_EQ(expected->getFullyQualifiedName(), path);
+  }
+  auto log1 = lazy->findLogGroup("/dir1/log1");
+  ASSERT_EQ(2, log1->attrs().replicationFactor().value());
+  auto log2 = lazy->findLogGroup("/dir2/dir3/log2");
+  ASSERT_EQ(3, log2->attrs().replicationFactor().value());
+  ASSERT_TRUE(log2->attrs().replicationFactor().isInherited());
+  ASSERT_EQ(1, log2->attrs().extraCopies().value());
+
+  auto placeholder = LogsConfigTree::createLazy(lazy);
+  ASSERT_TRUE(placeholder->isLazy());
+  ASSERT_EQ(lsn_t(42), placeholder->version());
+  auto copy = placeholder->copy();
+  ASSERT_TRUE(copy->isLazy());
+  placeholder->materialize();
+  ASSERT_FALSE(placeholder->isLazy());
+  ASSERT_TRUE(copy->isLazy());
+  ASSERT_EQ(lsn_t(42), placeholder->version());
+  ASSERT_EQ(tree->size(), placeholder->size());
+  for (logid_t::raw_type id = 0; id <= 21; ++id) {
+    const LogGroupInDirectory* expected = tree->getLogGroupByID(logid_t(id));
+    const LogGroupInDirectory* lg = placeholder->getLogGroupByID(logid_t(id));
+    ASSERT_EQ(expected == nullptr, lg == nullptr);
+    if (expected) {
+      ASSERT_EQ(*expected, *lg);
+    }
+  }
+}
+
 // This is disabled as it's covered by an assertion in the code
 TEST(LogsConfigCodecTest, DISABLED_InvalidPayload) {
   std::string invalid_payload = "BAD DATA IN PAYLOAD";
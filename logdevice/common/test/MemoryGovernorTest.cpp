@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/common/MemoryGovernor.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+class MemoryGovernorTest : public ::testing::Test {
+ protected:
+  MemoryGovernor governor_;
+  ResourceBudget a_{0};
+  ResourceBudget b_{0};
+  uint64_t other_usage_{200};
+};
+
+} // namespace
+
+// Limits are lowered below usage while over the global limit, and raised back
+// once usage goes down.
+TEST_F(MemoryGovernorTest, Rebalance) {
+  auto ha = governor_.registerBudget("a", &a_, 100);
+  auto hb = governor_.registerBudget("b", &b_, 300);
+  auto ho = governor_.registerUsage("other", [&] { return other_usage_; });
+  ASSERT_TRUE(a_.acquire(50));
+  ASSERT_TRUE(b_.acquire(150));
+  EXPECT_EQ(400, governor_.getTotalUsage());
+
+  // Enough headroom, base limits stay.
+  governor_.rebalance(1000);
+  EXPECT_EQ(100, a_.getLimit());
+  EXPECT_EQ(300, b_.getLimit());
+
+  // 100 over the limit. The excess is taken from budgets in proportion to
+  // their usage.
+  governor_.rebalance(300);
+  EXPECT_EQ(25, a_.getLimit());
+  EXPECT_EQ(75, b_.getLimit());
+  EXPECT_FALSE(a_.acquire(1));
+  EXPECT_FALSE(b_.acquire(1));
+
+  // Usage went down. Headroom is shared in proportion to base limits.
+  a_.release(50);
+  b_.release(150);
+  governor_.rebalance(300);
+  EXPECT_EQ(25, a_.getLimit());
+  EXPECT_EQ(75, b_.getLimit());
+
+  other_usage_ = 0;
+  governor_.rebalance(300);
+  EXPECT_EQ(75, a_.getLimit());
+  EXPECT_EQ(225, b_.getLimit());
+
+  // No global limit.
+  governor_.rebalance(0);
+  EXPECT_EQ(100, a_.getLimit());
+  EXPECT_EQ(300, b_.getLimit());
+}
+
+TEST_F(MemoryGovernorTest, SetBaseLimit) {
+  auto ha = governor_.registerBudget("a", &a_, 100);
+  auto hb = governor_.registerBudget("b", &b_, 100);
+  ASSERT_TRUE(a_.acquire(100));
+  governor_.rebalance(50);
+  EXPECT_EQ(50, a_.getLimit());
+  EXPECT_EQ(0, b_.getLimit());
+
+  // A lowered limit stays lowered, an unaffected one follows the base limit.
+  ha.setBaseLimit(200);
+  EXPECT_EQ(50, a_.getLimit());
+  ha.setBaseLimit(20);
+  EXPECT_EQ(20, a_.getLimit());
+
+  a_.release(100);
+  governor_.rebalance(0);
+  EXPECT_EQ(20, a_.getLimit());
+  hb.setBaseLimit(200);
+  EXPECT_EQ(200, b_.getLimit());
+}
+
+TEST_F(MemoryGovernorTest, Consumers) {
+  ResourceBudget c{0};
+  auto ha = governor_.registerBudget("x", &a_, 100);
+  auto hc = governor_.registerBudget("x", &c, 50);
+  auto ho = governor_.registerUsage("other", [&] { return other_usage_; });
+  ASSERT_TRUE(a_.acquire(10));
+  ASSERT_TRUE(c.acquire(5));
+
+  auto consumers = governor_.getConsumers();
+  ASSERT_EQ(2, consumers.size());
+  EXPECT_EQ("other", consumers[0].name);
+  EXPECT_EQ(1, consumers[0].count);
+  EXPECT_EQ(200, consumers[0].used);
+  EXPECT_FALSE(consumers[0].elastic);
+  EXPECT_EQ("x", consumers[1].name);
+  EXPECT_EQ(2, consumers[1].count);
+  EXPECT_EQ(15, consumers[1].used);
+  EXPECT_EQ(150, consumers[1].limit);
+  EXPECT_EQ(150, consumers[1].base_limit);
+  EXPECT_TRUE(consumers[1].elastic);
+
+  ho.reset();
+  hc.reset();
+  c.release(5);
+  consumers = governor_.getConsumers();
+  ASSERT_EQ(1, consumers.size());
+  EXPECT_EQ(1, consumers[0].count);
+  EXPECT_EQ(10, governor_.getTotalUsage());
+}
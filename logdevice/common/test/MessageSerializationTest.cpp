@@ -19,16 +19,27 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/libevent/compat.h"
 #include "logdevice/common/protocol/APPEND_Message.h"
+#include "logdevice/common/protocol/CHECKSUM_FAIL_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
 #include "logdevice/common/protocol/DELETE_Message.h"
+#include "logdevice/common/protocol/COMPRESSED_FRAME_Message.h"
 #include "logdevice/common/protocol/GET_EPOCH_RECOVERY_METADATA_Message.h"
 #include "logdevice/common/protocol/GET_EPOCH_RECOVERY_METADATA_REPLY_Message.h"
 #include "logdevice/common/protocol/HELLO_Message.h"
+#include "logdevice/common/protocol/MULTI_DATA_SIZE_Message.h"
+#include "logdevice/common/protocol/MULTI_GET_SEQ_STATE_Message.h"
+#include "logdevice/common/protocol/MULTI_IS_LOG_EMPTY_Message.h"
+#include "logdevice/common/protocol/MULTI_MUTATED_Message.h"
+#include "logdevice/common/protocol/MULTI_RELEASE_Message.h"
+#include "logdevice/common/protocol/MULTI_SEAL_Message.h"
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
+#include "logdevice/common/protocol/MULTI_TRIM_Message.h"
 #include "logdevice/common/protocol/MUTATED_Message.h"
 #include "logdevice/common/protocol/MessageDeserializers.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/SEALED_Message.h"
 #include "logdevice/common/protocol/SHUTDOWN_Message.h"
@@ -36,6 +47,7 @@
 #include "logdevice/common/protocol/START_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/protocol/TRIM_POINT_UPDATE_Message.h"
 #include "logdevice/common/request_util.h"
 #include "logdevice/common/test/TestUtil.h"
 #include "logdevice/common/util.h"
@@ -513,6 +525,36 @@ TEST_F(MessageSerializationTest, STORE) {
           [](ProtocolReader& r) { return STORE_Message::deserialize(r, 128); });
 }
 
+// Large owned payloads are added to the evbuffer by reference, others are
+// copied.
+TEST_F(MessageSerializationTest, PayloadHolderSerializeWithoutCopy) {
+  const size_t size = MAX_COPY_TO_EVBUFFER_PAYLOAD_SIZE + 1;
+  void* buf = malloc(size);
+  memset(buf, 'x', size);
+  PayloadHolder owned(buf, size);
+  std::string data(size, 'y');
+  PayloadHolder unowned(
+      Payload(data.data(), data.size()), PayloadHolder::UNOWNED);
+
+  for (const PayloadHolder* h : {&owned, &unowned}) {
+    struct evbuffer* evbuf = LD_EV(evbuffer_new)();
+    SCOPE_EXIT {
+      LD_EV(evbuffer_free)(evbuf);
+    };
+    ProtocolWriter writer(
+        MessageType::STORE, evbuf, Compatibility::MAX_PROTOCOL_SUPPORTED);
+    h->serializeWithoutCopy(writer);
+    ASSERT_EQ(size, static_cast<size_t>(writer.result()));
+
+    struct evbuffer_iovec vec;
+    ASSERT_EQ(1, LD_EV(evbuffer_peek)(evbuf, -1, nullptr, &vec, 1));
+    EXPECT_EQ(size, vec.iov_len);
+    EXPECT_EQ(h == &owned, vec.iov_base == buf);
+    EXPECT_EQ(h == &owned ? std::string(size, 'x') : data,
+              std::string(static_cast<const char*>(vec.iov_base), size));
+  }
+}
+
 TEST_F(MessageSerializationTest, STORE_WithKey) {
   TestStoreMessageFactory factory;
   std::map<KeyType, std::string> optional_keys;
@@ -553,6 +595,393 @@ TEST_F(MessageSerializationTest, STORE_WithFilterableKey) {
           [](ProtocolReader& r) { return STORE_Message::deserialize(r, 128); });
 }
 
+TEST_F(MessageSerializationTest, MULTI_SEAL) {
+  std::vector<SEAL_Header> seals(2);
+  seals[0].rqid = request_id_t(0x0102030405060708);
+  seals[0].log_id = logid_t(0xBBC18E8AA44783D3);
+  seals[0].seal_epoch = epoch_t(2823409157);
+  seals[0].last_clean_epoch = epoch_t(123);
+  seals[0].sealed_by = NodeID(3, 2);
+  seals[0].shard = 7;
+  seals[1] = seals[0];
+  seals[1].log_id = logid_t(42);
+  seals[1].shard = 0;
+  MULTI_SEAL_Message m(seals);
+
+  auto check = [&](const MULTI_SEAL_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getSeals().size());
+    for (size_t i = 0; i < 2; ++i) {
+      const SEAL_Header& h = m.getSeals()[i];
+      const SEAL_Header& h2 = m2.getSeals()[i];
+      EXPECT_EQ(h.rqid, h2.rqid);
+      EXPECT_EQ(h.log_id, h2.log_id);
+      EXPECT_EQ(h.seal_epoch, h2.seal_epoch);
+      EXPECT_EQ(h.last_clean_epoch, h2.last_clean_epoch);
+      EXPECT_EQ(h.sealed_by, h2.sealed_by);
+      EXPECT_EQ(h.shard, h2.shard);
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_seals = 2;
+    return hexdump_buf(&num_seals, sizeof(num_seals)) +
+        hexdump_buf(seals.data(), seals.size() * sizeof(SEAL_Header));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_SEAL_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, MULTI_RELEASE) {
+  std::vector<RELEASE_Header> releases(2);
+  releases[0].rid = RecordID(esn_t(42), epoch_t(2823409157), logid_t(13));
+  releases[0].release_type = ReleaseType::GLOBAL;
+  releases[0].shard = 7;
+  releases[1].rid = RecordID(esn_t(1), epoch_t(3), logid_t(0xBBC18E8AA4));
+  releases[1].release_type = ReleaseType::PER_EPOCH;
+  releases[1].shard = 0;
+  MULTI_RELEASE_Message m(releases);
+
+  auto check = [&](const MULTI_RELEASE_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getReleases().size());
+    for (size_t i = 0; i < 2; ++i) {
+      const RELEASE_Header& h = m.getReleases()[i];
+      const RELEASE_Header& h2 = m2.getReleases()[i];
+      // RELEASE_Header is packed, copy the fields before comparing them
+      const RecordID rid = h.rid, rid2 = h2.rid;
+      const shard_index_t shard = h.shard, shard2 = h2.shard;
+      EXPECT_EQ(rid, rid2);
+      EXPECT_EQ(h.release_type, h2.release_type);
+      EXPECT_EQ(shard, shard2);
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_releases = 2;
+    return hexdump_buf(&num_releases, sizeof(num_releases)) +
+        hexdump_buf(releases.data(), releases.size() * sizeof(RELEASE_Header));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_RELEASE_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, MULTI_MUTATED) {
+  std::vector<MUTATED_Header> replies(2);
+  replies[0] = {recovery_id_t(1),
+                RecordID(esn_t(2), epoch_t(3), logid_t(4)),
+                Status::OK,
+                Seal(),
+                shard_index_t(7),
+                8};
+  replies[1] = {recovery_id_t(1),
+                RecordID(esn_t(3), epoch_t(3), logid_t(4)),
+                Status::PREEMPTED,
+                Seal(epoch_t(5), NodeID(node_index_t(6))),
+                shard_index_t(0),
+                9};
+  MULTI_MUTATED_Message m(replies);
+
+  auto check = [&](const MULTI_MUTATED_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getReplies().size());
+    for (size_t i = 0; i < 2; ++i) {
+      EXPECT_EQ(0,
+                memcmp(&m.getReplies()[i],
+                       &m2.getReplies()[i],
+                       sizeof(MUTATED_Header)));
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_replies = 2;
+    return hexdump_buf(&num_replies, sizeof(num_replies)) +
+        hexdump_buf(replies.data(), replies.size() * sizeof(MUTATED_Header));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_MUTATED_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, MULTI_TRIM) {
+  std::vector<TRIM_Header> trims(2);
+  trims[0] = {request_id_t(3), logid_t(13), lsn_t(0x1234567890), 5};
+  trims[1] = {request_id_t(4), logid_t(0xBBC18E8AA4), LSN_MAX - 1, 0};
+  MULTI_TRIM_Message m(trims);
+
+  auto check = [&](const MULTI_TRIM_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getTrims().size());
+    for (size_t i = 0; i < 2; ++i) {
+      const TRIM_Header& h = m.getTrims()[i];
+      const TRIM_Header& h2 = m2.getTrims()[i];
+      // TRIM_Header is packed, copy the fields before comparing them
+      const request_id_t rqid = h.client_rqid, rqid2 = h2.client_rqid;
+      const logid_t log = h.log_id, log2 = h2.log_id;
+      const lsn_t trim_point = h.trim_point, trim_point2 = h2.trim_point;
+      const shard_index_t shard = h.shard, shard2 = h2.shard;
+      EXPECT_EQ(rqid, rqid2);
+      EXPECT_EQ(log, log2);
+      EXPECT_EQ(trim_point, trim_point2);
+      EXPECT_EQ(shard, shard2);
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_trims = 2;
+    return hexdump_buf(&num_trims, sizeof(num_trims)) +
+        hexdump_buf(trims.data(), trims.size() * sizeof(TRIM_Header));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_TRIM_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, CHECKSUM_FAIL) {
+  CHECKSUM_FAIL_Header h = {
+      logid_t(13), lsn_t(0x1234567890), read_stream_id_t(7), 5};
+  CHECKSUM_FAIL_Message m(h);
+
+  auto check = [&](const CHECKSUM_FAIL_Message& m2, uint16_t /*proto*/) {
+    // CHECKSUM_FAIL_Header is packed, copy the fields before comparing them
+    const CHECKSUM_FAIL_Header h2 = m2.getHeader();
+    EXPECT_EQ(logid_t(13), logid_t(h2.log_id));
+    EXPECT_EQ(lsn_t(0x1234567890), lsn_t(h2.lsn));
+    EXPECT_EQ(read_stream_id_t(7), read_stream_id_t(h2.read_stream_id));
+    EXPECT_EQ(5, shard_index_t(h2.shard));
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    return hexdump_buf(&h, sizeof(h));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::CHECKSUM_FAIL_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, TRIM_POINT_UPDATE) {
+  std::vector<TRIM_POINT_UPDATE_Entry> updates = {
+      {logid_t(13), lsn_t(0x1234567890)}, {logid_t(0xBBC18E8AA4), lsn_t(42)}};
+  TRIM_POINT_UPDATE_Message m(updates);
+
+  auto check = [&](const TRIM_POINT_UPDATE_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getUpdates().size());
+    for (size_t i = 0; i < 2; ++i) {
+      // TRIM_POINT_UPDATE_Entry is packed, copy the fields before comparing
+      const logid_t log = updates[i].log_id, log2 = m2.getUpdates()[i].log_id;
+      const lsn_t tp = updates[i].trim_point,
+                  tp2 = m2.getUpdates()[i].trim_point;
+      EXPECT_EQ(log, log2);
+      EXPECT_EQ(tp, tp2);
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_updates = 2;
+    return hexdump_buf(&num_updates, sizeof(num_updates)) +
+        hexdump_buf(updates.data(),
+                    updates.size() * sizeof(TRIM_POINT_UPDATE_Entry));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::TRIM_POINT_UPDATE_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, MULTI_IS_LOG_EMPTY) {
+  std::vector<IS_LOG_EMPTY_Header> requests(2);
+  requests[0] = {request_id_t(3), logid_t(13), 5};
+  requests[1] = {request_id_t(4), logid_t(0xBBC18E8AA4), 0};
+  MULTI_IS_LOG_EMPTY_Message m(requests);
+
+  auto check = [&](const MULTI_IS_LOG_EMPTY_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getRequests().size());
+    for (size_t i = 0; i < 2; ++i) {
+      const IS_LOG_EMPTY_Header& h = m.getRequests()[i];
+      const IS_LOG_EMPTY_Header& h2 = m2.getRequests()[i];
+      // IS_LOG_EMPTY_Header is packed, copy the fields before comparing them
+      const request_id_t rqid = h.client_rqid, rqid2 = h2.client_rqid;
+      const logid_t log = h.log_id, log2 = h2.log_id;
+      const shard_index_t shard = h.shard, shard2 = h2.shard;
+      EXPECT_EQ(rqid, rqid2);
+      EXPECT_EQ(log, log2);
+      EXPECT_EQ(shard, shard2);
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_requests = 2;
+    return hexdump_buf(&num_requests, sizeof(num_requests)) +
+        hexdump_buf(
+               requests.data(), requests.size() * sizeof(IS_LOG_EMPTY_Header));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_LOG_QUERY_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, MULTI_DATA_SIZE) {
+  std::vector<DATA_SIZE_Header> requests(2);
+  requests[0] = {request_id_t(3), logid_t(13), 5, 1000, 2000};
+  requests[1] = {request_id_t(4), logid_t(0xBBC18E8AA4), 0, 0, INT64_MAX};
+  MULTI_DATA_SIZE_Message m(requests);
+
+  auto check = [&](const MULTI_DATA_SIZE_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getRequests().size());
+    for (size_t i = 0; i < 2; ++i) {
+      const DATA_SIZE_Header& h = m.getRequests()[i];
+      const DATA_SIZE_Header& h2 = m2.getRequests()[i];
+      // DATA_SIZE_Header is packed, copy the fields before comparing them
+      const request_id_t rqid = h.client_rqid, rqid2 = h2.client_rqid;
+      const logid_t log = h.log_id, log2 = h2.log_id;
+      const shard_index_t shard = h.shard, shard2 = h2.shard;
+      const int64_t lo = h.lo_timestamp_ms, lo2 = h2.lo_timestamp_ms;
+      const int64_t hi = h.hi_timestamp_ms, hi2 = h2.hi_timestamp_ms;
+      EXPECT_EQ(rqid, rqid2);
+      EXPECT_EQ(log, log2);
+      EXPECT_EQ(shard, shard2);
+      EXPECT_EQ(lo, lo2);
+      EXPECT_EQ(hi, hi2);
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_requests = 2;
+    return hexdump_buf(&num_requests, sizeof(num_requests)) +
+        hexdump_buf(
+               requests.data(), requests.size() * sizeof(DATA_SIZE_Header));
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_LOG_QUERY_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, MULTI_GET_SEQ_STATE) {
+  std::vector<std::unique_ptr<GET_SEQ_STATE_Message>> requests;
+  requests.push_back(std::make_unique<GET_SEQ_STATE_Message>(
+      logid_t(13),
+      request_id_t(7),
+      GET_SEQ_STATE_Message::INCLUDE_HISTORICAL_METADATA,
+      GetSeqStateRequest::Context::REBUILDING_PLANNER));
+  requests.push_back(std::make_unique<GET_SEQ_STATE_Message>(
+      logid_t(0xBBC18E8AA4),
+      request_id_t(8),
+      GET_SEQ_STATE_Message::MIN_EPOCH | GET_SEQ_STATE_Message::NO_REDIRECT,
+      GetSeqStateRequest::Context::REBUILDING_PLANNER,
+      epoch_t(42)));
+  MULTI_GET_SEQ_STATE_Message m(std::move(requests));
+
+  auto check = [&](const MULTI_GET_SEQ_STATE_Message& m2,
+                   uint16_t /*proto*/) {
+    ASSERT_EQ(2, m2.getRequests().size());
+    for (size_t i = 0; i < 2; ++i) {
+      const GET_SEQ_STATE_Message& r = *m.getRequests()[i];
+      const GET_SEQ_STATE_Message& r2 = *m2.getRequests()[i];
+      EXPECT_EQ(r.log_id_, r2.log_id_);
+      EXPECT_EQ(r.request_id_, r2.request_id_);
+      EXPECT_EQ(r.flags_, r2.flags_);
+      EXPECT_EQ(r.calling_ctx_, r2.calling_ctx_);
+      EXPECT_EQ(r.min_epoch_, r2.min_epoch_);
+    }
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    const uint32_t num_requests = 2;
+    std::string rv = hexdump_buf(&num_requests, sizeof(num_requests));
+    for (const auto& r : m.getRequests()) {
+      rv += hexdump_buf(&r->log_id_, sizeof(r->log_id_)) +
+          hexdump_buf(&r->request_id_, sizeof(r->request_id_)) +
+          hexdump_buf(&r->flags_, sizeof(r->flags_)) +
+          hexdump_buf(&r->calling_ctx_, sizeof(r->calling_ctx_));
+      if (r->min_epoch_.hasValue()) {
+        rv += hexdump_buf(&r->min_epoch_.value(), sizeof(epoch_t));
+      }
+    }
+    return rv;
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_GET_SEQ_STATE_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, COMPRESSED_FRAME) {
+  COMPRESSED_FRAME_Header header;
+  header.uncompressed_len = 1234;
+  const std::string compressed("\x28\xb5\x2f\xfd compressed bytes", 21);
+  COMPRESSED_FRAME_Message m(header, compressed);
+
+  auto check = [&](const COMPRESSED_FRAME_Message& m2, uint16_t /*proto*/) {
+    // COMPRESSED_FRAME_Header is packed, copy the field before comparing it
+    const uint32_t uncompressed_len = m2.getHeader().uncompressed_len;
+    EXPECT_EQ(1234, uncompressed_len);
+    EXPECT_EQ(compressed, m2.getCompressed());
+  };
+  auto expected = [&](uint16_t /*proto*/) {
+    return hexdump_buf(&header, sizeof(header)) +
+        hexdump_buf(compressed.data(), compressed.size());
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::COMPRESSED_FRAME_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, MULTI_STORE) {
+  TestStoreMessageFactory factory1;
+  TestStoreMessageFactory factory2;
+  std::map<KeyType, std::string> optional_keys;
+  optional_keys.insert(
+      std::make_pair(KeyType::FINDKEY, std::string("abcdefgh")));
+  factory2.setFlags(STORE_Header::CUSTOM_KEY);
+  factory2.setKey(optional_keys, "08006162636465666768");
+
+  std::vector<std::unique_ptr<STORE_Message>> stores;
+  stores.push_back(std::make_unique<STORE_Message>(factory1.message()));
+  stores.push_back(std::make_unique<STORE_Message>(factory2.message()));
+  MULTI_STORE_Message m(std::move(stores));
+
+  auto check = [&](const MULTI_STORE_Message& m2, uint16_t proto) {
+    ASSERT_EQ(2, m2.getStores().size());
+    for (size_t i = 0; i < 2; ++i) {
+      checkSTORE(*m.getStores()[i], *m2.getStores()[i], proto);
+    }
+  };
+  auto expected = [&](uint16_t proto) {
+    std::string rv = TestStoreMessageFactory::hex(uint32_t(2));
+    for (const auto* factory : {&factory1, &factory2}) {
+      std::string record = factory->serialized(proto);
+      rv += TestStoreMessageFactory::hex(uint32_t(record.size() / 2));
+      rv += record;
+    }
+    return rv;
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MULTI_STORE_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected,
+          [](ProtocolReader& r) {
+            return MULTI_STORE_Message::deserialize(r, 128);
+          });
+}
+
 TEST_F(MessageSerializationTest, STORE_WithRebuildingInfo2) {
   STORE_Extra extra;
   extra.rebuilding_version = 42;
@@ -1043,6 +1472,69 @@ TEST_F(MessageSerializationTest, RECORD) {
           deserializer);
 }
 
+TEST_F(MessageSerializationTest, RECORD_BATCH) {
+  const lsn_t lsn = compose_lsn(epoch_t(5), esn_t(10));
+  std::vector<std::string> payloads = {"foo", "barbaz"};
+  std::vector<RECORD_Header> headers = {
+      {logid_t(0x1234),
+       read_stream_id_t(0x56),
+       lsn,
+       1000,
+       RECORD_Header::CHECKSUM_PARITY,
+       shard_index_t(2)},
+      {logid_t(0x1234),
+       read_stream_id_t(0x56),
+       lsn + 3,
+       998,
+       RECORD_Header::CHECKSUM_PARITY,
+       shard_index_t(2)},
+  };
+  std::vector<std::unique_ptr<RECORD_Message>> records;
+  for (size_t i = 0; i < headers.size(); ++i) {
+    records.push_back(std::make_unique<RECORD_Message>(
+        headers[i],
+        TrafficClass::READ_BACKLOG,
+        Payload(payloads[i].data(), payloads[i].size()).dup(),
+        nullptr));
+  }
+  RECORD_BATCH_Message m(std::move(records), TrafficClass::READ_BACKLOG);
+
+  auto check = [&](const RECORD_BATCH_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(m.header_.log_id, m2.header_.log_id);
+    ASSERT_EQ(m.header_.read_stream_id, m2.header_.read_stream_id);
+    ASSERT_EQ(m.header_.shard, m2.header_.shard);
+    ASSERT_EQ(m.header_.num_records, m2.header_.num_records);
+    ASSERT_EQ(headers.size(), m2.getRecords().size());
+    for (size_t i = 0; i < headers.size(); ++i) {
+      const RECORD_Message& r = *m2.getRecords()[i];
+      ASSERT_EQ(headers[i].log_id, r.header_.log_id);
+      ASSERT_EQ(headers[i].read_stream_id, r.header_.read_stream_id);
+      ASSERT_EQ(headers[i].lsn, r.header_.lsn);
+      ASSERT_EQ(headers[i].timestamp, r.header_.timestamp);
+      ASSERT_EQ(headers[i].flags, r.header_.flags);
+      ASSERT_EQ(headers[i].shard, r.header_.shard);
+      ASSERT_EQ(payloads[i], getPayload(r.payload_));
+      ASSERT_EQ(nullptr, r.extra_metadata_);
+    }
+  };
+
+  auto deserializer = [](ProtocolReader& reader) {
+    return RECORD_BATCH_Message::deserialize(reader);
+  };
+
+  auto expected_fn = [](uint16_t /*proto*/) {
+    return "341200000000000056000000000000000200020000000D000000000000008A8080"
+           "8050D00F100303031006666F6F62617262617A";
+  };
+
+  DO_TEST(m,
+          check,
+          Compatibility::RECORD_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected_fn,
+          deserializer);
+}
+
 namespace {
 TailRecord genTailRecord(bool include_payload) {
   TailRecordHeader::flags_t flags =
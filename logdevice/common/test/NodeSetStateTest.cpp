@@ -276,4 +276,50 @@ TEST_F(NodeSetStateTest, SlowStateTransitionTestWithProbingEnabled) {
   }
 }
 
+TEST_F(NodeSetStateTest, AllShardsAvailable) {
+  // More shards than fit in one word of the bitset.
+  storage_set_.clear();
+  for (node_index_t i = 0; i < 100; ++i) {
+    storage_set_.push_back(ShardID(i, 0));
+  }
+  auto storage_set_state = std::make_unique<MyNodeSetState>(
+      storage_set_, LOG_ID, NodeSetState::HealthCheck::DISABLED);
+  EXPECT_TRUE(storage_set_state->allShardsAvailable());
+
+  // Low watermark doesn't make a shard unavailable.
+  storage_set_state->setNotAvailableUntil(
+      storage_set_[70],
+      std::chrono::steady_clock::now() + std::chrono::seconds(10),
+      NodeSetState::NotAvailableReason::LOW_WATERMARK_NOSPC);
+  EXPECT_TRUE(storage_set_state->allShardsAvailable());
+
+  storage_set_state->setNotAvailableUntil(
+      storage_set_[70],
+      std::chrono::steady_clock::now() + std::chrono::seconds(10),
+      NodeSetState::NotAvailableReason::OVERLOADED);
+  EXPECT_FALSE(storage_set_state->allShardsAvailable());
+  EXPECT_NE(storage_set_state->checkNotAvailableUntil(
+                storage_set_[70], std::chrono::steady_clock::now()),
+            std::chrono::steady_clock::time_point::min());
+  EXPECT_EQ(storage_set_state->checkNotAvailableUntil(
+                storage_set_[3], std::chrono::steady_clock::now()),
+            std::chrono::steady_clock::time_point::min());
+
+  // Expired deadline clears the state.
+  EXPECT_EQ(
+      storage_set_state->checkNotAvailableUntil(
+          storage_set_[70],
+          std::chrono::steady_clock::now() + std::chrono::seconds(20)),
+      std::chrono::steady_clock::time_point::min());
+  EXPECT_TRUE(storage_set_state->allShardsAvailable());
+
+  storage_set_state->setNotAvailableUntil(
+      storage_set_[5],
+      std::chrono::steady_clock::now() + std::chrono::seconds(10),
+      NodeSetState::NotAvailableReason::SLOW);
+  EXPECT_FALSE(storage_set_state->allShardsAvailable());
+  storage_set_state->clearNotAvailableUntil(storage_set_[5]);
+  EXPECT_TRUE(storage_set_state->allShardsAvailable());
+}
+
 }} // namespace facebook::logdevice
@@ -375,6 +375,35 @@ TEST_F(NodesConfigurationTest, ChangingAttributes) {
   checkCodecSerialization(*new_config);
 }
 
+TEST_F(NodesConfigurationTest, IncrementalUpdatesShareSubConfigs) {
+  auto config = provisionNodes();
+  ASSERT_TRUE(config->validate());
+
+  // adding a node changes every sub-config but the metadata logs replication
+  auto config2 = config->applyUpdate(addNewNodeUpdate(
+      *config, {17, both_role, "aa.bb.cc.dd.ee", 0.0, 1, false}));
+  ASSERT_NE(nullptr, config2);
+  EXPECT_EQ(config->getMetaDataLogsReplication(),
+            config2->getMetaDataLogsReplication());
+  EXPECT_NE(config->getStorageNodesHash(), config2->getStorageNodesHash());
+  EXPECT_EQ(17, config2->getMaxNodeIndex());
+  checkCodecSerialization(*config2);
+
+  // a storage membership update doesn't copy service discovery, the sequencer
+  // config or the storage attributes, and doesn't change the storage nodes
+  // hash
+  auto config3 = config2->applyUpdate(
+      disablingWriteUpdate(config2->getStorageMembership()->getVersion()));
+  ASSERT_NE(nullptr, config3);
+  EXPECT_EQ(config2->getServiceDiscovery(), config3->getServiceDiscovery());
+  EXPECT_EQ(config2->getSequencerConfig(), config3->getSequencerConfig());
+  EXPECT_EQ(config2->getStorageAttributes(), config3->getStorageAttributes());
+  EXPECT_NE(config2->getStorageMembership(), config3->getStorageMembership());
+  EXPECT_EQ(config2->getStorageNodesHash(), config3->getStorageNodesHash());
+  EXPECT_EQ(config2->getSequencersConfig(), config3->getSequencersConfig());
+  checkCodecSerialization(*config3);
+}
+
 TEST_F(NodesConfigurationTest, AddingNodeWithoutServiceDiscoveryOrAttribute) {
   auto config = provisionNodes();
   ASSERT_TRUE(config->validate());
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/NumaTopology.h"
+
+#include <sys/sysmacros.h>
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/test/TestUtil.h"
+
+using namespace facebook::logdevice;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+class NumaTopologyTest : public ::testing::Test {
+ public:
+  NumaTopologyTest()
+      : temp_dir_(createTemporaryDir("NumaTopologyTest", false)),
+        root_(temp_dir_->path().string()) {}
+
+  void writeFile(const std::string& rel_path, const std::string& contents) {
+    const fs::path path = fs::path(root_) / rel_path;
+    fs::create_directories(path.parent_path());
+    ASSERT_TRUE(folly::writeFile(contents, path.c_str()));
+  }
+
+  std::unique_ptr<folly::test::TemporaryDirectory> temp_dir_;
+  const std::string root_;
+};
+
+} // namespace
+
+TEST(NumaTopologyParseTest, ParseCPUList) {
+  std::vector<int> cpus;
+  ASSERT_EQ(0, NumaTopology::parseCPUList("0-3,8,10-11", &cpus));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), cpus);
+
+  ASSERT_EQ(0, NumaTopology::parseCPUList("5", &cpus));
+  EXPECT_EQ(std::vector<int>({5}), cpus);
+
+  ASSERT_EQ(0, NumaTopology::parseCPUList("", &cpus));
+  EXPECT_TRUE(cpus.empty());
+
+  EXPECT_EQ(-1, NumaTopology::parseCPUList("3-1", &cpus));
+  EXPECT_EQ(-1, NumaTopology::parseCPUList("a-b", &cpus));
+  EXPECT_EQ(-1, NumaTopology::parseCPUList("1,-2", &cpus));
+}
+
+TEST_F(NumaTopologyTest, Detect) {
+  writeFile("devices/system/node/node0/cpulist", "0-1,4-5\n");
+  writeFile("devices/system/node/node1/cpulist", "2-3,6-7\n");
+  // Memory-only node, ignored.
+  writeFile("devices/system/node/node2/cpulist", "\n");
+  // Not a node.
+  writeFile("devices/system/node/possible", "0-2\n");
+
+  NumaTopology topology = NumaTopology::detect(root_);
+  EXPECT_EQ(2, topology.numNodes());
+  EXPECT_EQ(std::vector<int>({0, 1}), topology.nodes());
+  EXPECT_EQ(std::vector<int>({0, 1, 4, 5}), topology.cpusOfNode(0));
+  EXPECT_EQ(std::vector<int>({2, 3, 6, 7}), topology.cpusOfNode(1));
+  EXPECT_TRUE(topology.cpusOfNode(2).empty());
+}
+
+TEST_F(NumaTopologyTest, NoNumaInformation) {
+  NumaTopology topology = NumaTopology::detect(root_);
+  EXPECT_EQ(0, topology.numNodes());
+  EXPECT_EQ(-1, topology.nodeOfBlockDevice(makedev(8, 0)));
+  EXPECT_FALSE(topology.readNodeStats(0).hasValue());
+}
+
+TEST_F(NumaTopologyTest, NodeOfBlockDevice) {
+  // SATA disk and its partition.
+  writeFile("dev/block/8:0/device/numa_node", "1\n");
+  writeFile("dev/block/8:0/8:1/dummy", "");
+  // NVMe namespace: the PCI device is the parent of the controller.
+  writeFile("dev/block/259:0/device/device/numa_node", "0\n");
+  // No affinity.
+  writeFile("dev/block/8:16/device/numa_node", "-1\n");
+
+  // Partitions are subdirectories of their disk in the real sysfs, and
+  // dev/block/<major>:<minor> is a symlink to them.
+  fs::create_symlink(fs::path(root_) / "dev/block/8:0/8:1",
+                     fs::path(root_) / "dev/block/8:1");
+
+  NumaTopology topology = NumaTopology::detect(root_);
+  EXPECT_EQ(1, topology.nodeOfBlockDevice(makedev(8, 0)));
+  EXPECT_EQ(1, topology.nodeOfBlockDevice(makedev(8, 1)));
+  EXPECT_EQ(0, topology.nodeOfBlockDevice(makedev(259, 0)));
+  EXPECT_EQ(-1, topology.nodeOfBlockDevice(makedev(8, 16)));
+  EXPECT_EQ(-1, topology.nodeOfBlockDevice(makedev(8, 32)));
+}
+
+TEST_F(NumaTopologyTest, ReadNodeStats) {
+  writeFile("devices/system/node/node1/cpulist", "0-3\n");
+  writeFile("devices/system/node/node1/numastat",
+            "numa_hit 1000\n"
+            "numa_miss 20\n"
+            "numa_foreign 30\n"
+            "interleave_hit 40\n"
+            "local_node 900\n"
+            "other_node 120\n");
+
+  NumaTopology topology = NumaTopology::detect(root_);
+  auto stats = topology.readNodeStats(1);
+  ASSERT_TRUE(stats.hasValue());
+  EXPECT_EQ(1000, stats->numa_hit);
+  EXPECT_EQ(20, stats->numa_miss);
+  EXPECT_EQ(30, stats->numa_foreign);
+  EXPECT_EQ(40, stats->interleave_hit);
+  EXPECT_EQ(900, stats->local_node);
+  EXPECT_EQ(120, stats->other_node);
+}
@@ -10,6 +10,8 @@
 #include <gtest/gtest.h>
 
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/replicated_state_machine/RSMDeltaSnapshot.h"
+#include "logdevice/common/replicated_state_machine/RSMSnapshotManifest.h"
 
 using namespace facebook::logdevice;
 using namespace testing;
@@ -141,3 +143,97 @@ TEST(RSMSnapshotHeaderTest, ForwardsCompatibility) {
               0);
   }
 }
+
+TEST(RSMSnapshotHeaderTest, DeltaSnapshotSerialization) {
+  RSMDeltaSnapshot snapshot;
+  snapshot.prev_delta_log_read_ptr = lsn_t{41};
+  snapshot.deltas.push_back({lsn_t{42}, std::chrono::milliseconds{10}, "a"});
+  snapshot.deltas.push_back({lsn_t{45}, std::chrono::milliseconds{11}, ""});
+  snapshot.deltas.push_back(
+      {lsn_t{46}, std::chrono::milliseconds{12}, std::string(1000, 'b')});
+
+  std::string buf;
+  snapshot.serialize(buf);
+
+  RSMDeltaSnapshot out;
+  ASSERT_EQ(
+      0, RSMDeltaSnapshot::deserialize(Payload(buf.data(), buf.size()), out));
+  EXPECT_EQ(snapshot, out);
+
+  // Truncated payload.
+  ASSERT_EQ(-1,
+            RSMDeltaSnapshot::deserialize(
+                Payload(buf.data(), buf.size() - 1), out));
+  EXPECT_EQ(E::BADMSG, err);
+
+  // Deltas must be in LSN order.
+  std::swap(snapshot.deltas[0], snapshot.deltas[1]);
+  snapshot.serialize(buf);
+  ASSERT_EQ(
+      -1, RSMDeltaSnapshot::deserialize(Payload(buf.data(), buf.size()), out));
+  EXPECT_EQ(E::BADMSG, err);
+}
+
+TEST(RSMSnapshotHeaderTest, ManifestSerialization) {
+  RSMSnapshotManifest manifest;
+  manifest.chunks.push_back({lsn_t{10}, 1000, 0x1234u});
+  manifest.chunks.push_back({lsn_t{12}, 1000, 0x5678u});
+  manifest.chunks.push_back({lsn_t{13}, 42, 0x9abcu});
+
+  std::string buf;
+  manifest.serialize(buf);
+
+  RSMSnapshotManifest out;
+  ASSERT_EQ(0,
+            RSMSnapshotManifest::deserialize(
+                Payload(buf.data(), buf.size()), out));
+  EXPECT_EQ(manifest, out);
+
+  // Truncated payload.
+  ASSERT_EQ(-1,
+            RSMSnapshotManifest::deserialize(
+                Payload(buf.data(), buf.size() - 1), out));
+  EXPECT_EQ(E::BADMSG, err);
+
+  // Chunks must be in LSN order.
+  std::swap(manifest.chunks[0], manifest.chunks[1]);
+  manifest.serialize(buf);
+  ASSERT_EQ(-1,
+            RSMSnapshotManifest::deserialize(
+                Payload(buf.data(), buf.size()), out));
+  EXPECT_EQ(E::BADMSG, err);
+
+  // A manifest lists at least one chunk.
+  manifest.chunks.clear();
+  manifest.serialize(buf);
+  ASSERT_EQ(-1,
+            RSMSnapshotManifest::deserialize(
+                Payload(buf.data(), buf.size()), out));
+  EXPECT_EQ(E::BADMSG, err);
+
+  // The header of a chunk is followed by its slice of the snapshot body.
+  RSMSnapshotHeader header = headerv1;
+  header.flags = RSMSnapshotHeader::ZSTD_COMPRESSION;
+  const std::string body = "chunk body";
+  buf =
+      RSMSnapshotManifest::createChunkPayload(header, Slice::fromString(body));
+  Slice body_out;
+  ASSERT_EQ(0,
+            RSMSnapshotManifest::getChunkBody(
+                Payload(buf.data(), buf.size()), body_out));
+  EXPECT_EQ(body, std::string(body_out.ptr(), body_out.size));
+
+  // A manifest keeps the flags of the snapshot.
+  manifest.chunks.push_back({lsn_t{10}, body.size(), 0x1234u});
+  buf = manifest.createManifestPayload(header);
+  RSMSnapshotHeader header_out;
+  ASSERT_GT(RSMSnapshotHeader::deserialize(
+                Payload(buf.data(), buf.size()), header_out),
+            0);
+  EXPECT_EQ(RSMSnapshotHeader::ZSTD_COMPRESSION | RSMSnapshotHeader::CHUNKED,
+            header_out.flags);
+  ASSERT_EQ(-1,
+            RSMSnapshotManifest::getChunkBody(
+                Payload(buf.data(), buf.size()), body_out));
+  EXPECT_EQ(E::BADMSG, err);
+}
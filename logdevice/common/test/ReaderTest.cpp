@@ -290,6 +290,63 @@ TEST_F(ReaderTestSingleLog, Gap) {
   ASSERT_STREQ("record 8", (const char*)records_out[2]->payload.data());
 }
 
+/**
+ * Records handed over in batches come out in order, a batch that doesn't fit
+ * in one read() call is split, and gaps between batches behave the same as
+ * with single records.
+ */
+TEST_F(ReaderTestSingleLog, Batches) {
+  std::vector<std::unique_ptr<DataRecord>> records_out;
+  GapRecord gap_out;
+
+  auto make_batch = [&](lsn_t first, lsn_t last) {
+    std::vector<std::unique_ptr<DataRecord>> batch;
+    for (lsn_t lsn = first; lsn <= last; ++lsn) {
+      batch.push_back(make_record(LOG_ID, lsn));
+    }
+    return batch;
+  };
+
+  auto batch = make_batch(lsn_t(1), lsn_t(3));
+  ASSERT_EQ(0, bridge_->onDataRecords(rsid_, batch, false));
+  ASSERT_TRUE(batch.empty());
+  batch = make_batch(lsn_t(4), lsn_t(5));
+  ASSERT_EQ(0, bridge_->onDataRecords(rsid_, batch, false));
+  bridge_->onGapRecord(
+      rsid_, GapRecord(LOG_ID, GapType::DATALOSS, lsn_t(6), lsn_t(7)), false);
+  batch = make_batch(lsn_t(8), lsn_t(9));
+  ASSERT_EQ(0, bridge_->onDataRecords(rsid_, batch, false));
+
+  reader_->setTimeout(std::chrono::milliseconds::zero());
+
+  ssize_t nread;
+  // The first batch is split between two read() calls.
+  nread = reader_->read(2, &records_out, &gap_out);
+  ASSERT_EQ(2, nread);
+  ASSERT_STREQ("record 1", (const char*)records_out[0]->payload.data());
+  ASSERT_STREQ("record 2", (const char*)records_out[1]->payload.data());
+  records_out.clear();
+
+  // The rest of it and the whole second batch, then stop before the gap.
+  nread = reader_->read(100, &records_out, &gap_out);
+  ASSERT_EQ(3, nread);
+  ASSERT_STREQ("record 3", (const char*)records_out[0]->payload.data());
+  ASSERT_STREQ("record 4", (const char*)records_out[1]->payload.data());
+  ASSERT_STREQ("record 5", (const char*)records_out[2]->payload.data());
+  records_out.clear();
+
+  nread = reader_->read(100, &records_out, &gap_out);
+  ASSERT_EQ(-1, nread);
+  ASSERT_EQ(E::GAP, err);
+  ASSERT_EQ(lsn_t(6), gap_out.lo);
+  ASSERT_EQ(lsn_t(7), gap_out.hi);
+
+  nread = reader_->read(100, &records_out, &gap_out);
+  ASSERT_EQ(2, nread);
+  ASSERT_STREQ("record 8", (const char*)records_out[0]->payload.data());
+  ASSERT_STREQ("record 9", (const char*)records_out[1]->payload.data());
+}
+
 /**
  * If a client stops reading a log, any buffered records should be discarded
  */
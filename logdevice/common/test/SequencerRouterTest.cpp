@@ -174,6 +174,24 @@ TEST_F(SequencerRouterTest, PreemptedByDeadNode) {
   EXPECT_EQ(E::NOSEQUENCER, status_);
 }
 
+// Tests that a node the log was handed off to is asked not to redirect back.
+TEST_F(SequencerRouterTest, HandedOff) {
+  const NodeID N0(0, 1), N1(1, 1);
+  std::shared_ptr<const Configuration> config = createSimpleConfig(4, 1);
+
+  // N0 takes care of all logs by default
+  locator_ = std::make_shared<StaticLocator>(N0);
+
+  auto router = createRouter(logid_t(1), std::move(config));
+  router->start();
+  ASSERT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+
+  // N0 handed the log off to N1
+  router->onHandedOff(N0, N1);
+  SequencerRouter::flags_t expected_flags = SequencerRouter::REDIRECT_CYCLE;
+  ASSERT_EQ(std::make_pair(N1, expected_flags), next_node_);
+}
+
 // Tests if the node with the location matching the sequencerAffinity is chosen
 // as the sequencer. If there are none, it makes sure the SequencerLocator
 // still picks something.
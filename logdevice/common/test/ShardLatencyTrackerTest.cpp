@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ShardLatencyTracker.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using namespace std::chrono;
+
+namespace {
+
+const ShardID N1(1, 0);
+const ShardID N2(2, 0);
+const ShardID N3(3, 0);
+
+STORE_Header makeHeader(lsn_t lsn, uint32_t wave = 1) {
+  STORE_Header header;
+  header.rid = RecordID(lsn, logid_t(1));
+  header.wave = wave;
+  return header;
+}
+
+class ShardLatencyTrackerTest : public ::testing::Test {
+ public:
+  // Sends a STORE to `shard` at t0_ + `at` and gets a reply `latency` later.
+  void roundTrip(ShardID shard, milliseconds at, milliseconds latency) {
+    auto header = makeHeader(++lsn_);
+    tracker_.onCopySent(E::OK, shard, header, t0_ + at);
+    tracker_.onReply(shard, header, t0_ + at + latency);
+  }
+
+  ShardLatencyTracker tracker_{seconds(1)};
+  const ShardLatencyTracker::Clock::time_point t0_ =
+      ShardLatencyTracker::Clock::now();
+  lsn_t lsn_ = 0;
+};
+
+} // namespace
+
+TEST_F(ShardLatencyTrackerTest, NoSamples) {
+  EXPECT_EQ(0, tracker_.getCost(N1, t0_));
+  EXPECT_EQ(0, tracker_.numOutstanding(N1));
+}
+
+TEST_F(ShardLatencyTrackerTest, CostIncludesOutstanding) {
+  roundTrip(N1, milliseconds(0), milliseconds(2));
+  EXPECT_DOUBLE_EQ(2000, tracker_.getCost(N1, t0_ + milliseconds(2)));
+
+  // Shards without samples get the overall average.
+  EXPECT_DOUBLE_EQ(2000, tracker_.getCost(N2, t0_ + milliseconds(2)));
+
+  // Two STOREs waiting for a reply triple the expected wait.
+  tracker_.onCopySent(E::OK, N1, makeHeader(100), t0_ + milliseconds(2));
+  tracker_.onCopySent(E::OK, N1, makeHeader(101), t0_ + milliseconds(2));
+  // Failed sends aren't outstanding.
+  tracker_.onCopySent(E::NOBUFS, N1, makeHeader(102), t0_ + milliseconds(2));
+  EXPECT_EQ(2, tracker_.numOutstanding(N1));
+  EXPECT_DOUBLE_EQ(6000, tracker_.getCost(N1, t0_ + milliseconds(2)));
+
+  // Replies to unknown STOREs are ignored.
+  tracker_.onReply(N1, makeHeader(100, 2), t0_ + milliseconds(3));
+  EXPECT_EQ(2, tracker_.numOutstanding(N1));
+  tracker_.onReply(N1, makeHeader(100), t0_ + milliseconds(3));
+  EXPECT_EQ(1, tracker_.numOutstanding(N1));
+}
+
+TEST_F(ShardLatencyTrackerTest, MovingAverage) {
+  roundTrip(N1, milliseconds(0), milliseconds(1));
+  // One half-life later, the new sample and the old average weigh the same.
+  roundTrip(N1, milliseconds(999), milliseconds(1) + milliseconds(4));
+  EXPECT_NEAR(3000, tracker_.getCost(N1, t0_ + milliseconds(1004)), 10);
+}
+
+TEST_F(ShardLatencyTrackerTest, DecaysTowardsAverage) {
+  roundTrip(N1, milliseconds(0), milliseconds(10));
+  roundTrip(N2, milliseconds(0), milliseconds(10));
+  // N3 is fast and keeps getting replies, pulling the overall average down.
+  for (int i = 0; i < 100; ++i) {
+    roundTrip(N3, milliseconds(i * 100), milliseconds(1));
+  }
+  const auto now = t0_ + seconds(10);
+  const double average = tracker_.getCost(ShardID(4, 0), now);
+  EXPECT_LT(average, 1100);
+
+  // N1 hasn't had a reply in 10 half-lives, so it's close to the overall
+  // average again.
+  EXPECT_NEAR(average, tracker_.getCost(N1, now), 20);
+  // Right after its slow reply it was much more expensive.
+  EXPECT_GT(tracker_.getCost(N2, t0_ + milliseconds(10)), 5000);
+}
+
+TEST_F(ShardLatencyTrackerTest, ForgetsOldOutstanding) {
+  tracker_.onCopySent(E::OK, N1, makeHeader(1), t0_);
+  EXPECT_EQ(1, tracker_.numOutstanding(N1));
+  // Many half-lives later, the STORE that never got a reply stops counting.
+  tracker_.onCopySent(E::OK, N2, makeHeader(2), t0_ + seconds(60));
+  EXPECT_EQ(0, tracker_.numOutstanding(N1));
+  EXPECT_EQ(1, tracker_.numOutstanding(N2));
+}
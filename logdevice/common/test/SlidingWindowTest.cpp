@@ -465,3 +465,57 @@ TEST(SlidingWindowTest, ConditionalInsert2) {
   n_reaped = window.retire(compose_lsn(epoch_t(5), esn_t(1)), deleter);
   ASSERT_EQ(2, n_reaped);
 }
+
+TEST(SlidingWindowTest, GrowMany) {
+  Stats stats;
+  const epoch_t epoch(3);
+  SlidingWindowSingleEpoch<Item, Item::Deleter> window(epoch, 8, esn_t(10));
+  Item::Deleter::initLastReaped(compose_lsn(epoch, ESN_MIN));
+  Item::Deleter deleter(&stats);
+
+  std::vector<Item*> items;
+  for (int i = 0; i < 5; ++i) {
+    items.push_back(new Item(0));
+  }
+  lsn_t lsn = window.growMany(items.data(), 5);
+  ASSERT_EQ(compose_lsn(epoch, ESN_MIN), lsn);
+  for (int i = 0; i < 5; ++i) {
+    items[i]->id_ = lsn + i;
+  }
+  EXPECT_EQ(5, window.size());
+  EXPECT_EQ(lsn + 5, window.next());
+
+  // Only 3 slots left: a range of 4 doesn't fit, and nothing is inserted.
+  std::vector<Item*> more{new Item(0), new Item(0), new Item(0), new Item(0)};
+  ASSERT_EQ(LSN_INVALID, window.growMany(more.data(), 4));
+  ASSERT_EQ(E::NOBUFS, err);
+  EXPECT_EQ(5, window.size());
+  EXPECT_EQ(lsn + 5, window.next());
+
+  // Range members are retired and reaped individually, in LSN order.
+  EXPECT_EQ(0, window.retire(items[1]->id_, deleter));
+  EXPECT_EQ(2, window.retire(items[0]->id_, deleter));
+  for (int i = 2; i < 5; ++i) {
+    EXPECT_EQ(1, window.retire(items[i]->id_, deleter));
+  }
+  EXPECT_EQ(0, window.size());
+
+  // 5 ESNs are left in the epoch.
+  std::vector<Item*> too_many(6, more[0]);
+  ASSERT_EQ(LSN_INVALID, window.growMany(too_many.data(), 6));
+  ASSERT_EQ(E::TOOBIG, err);
+
+  lsn = window.growMany(more.data(), 4);
+  ASSERT_EQ(compose_lsn(epoch, esn_t(6)), lsn);
+  for (int i = 0; i < 4; ++i) {
+    more[i]->id_ = lsn + i;
+    EXPECT_EQ(1, window.retire(more[i]->id_, deleter));
+  }
+  EXPECT_EQ(9, stats.n_reaped);
+
+  window.disable();
+  Item* last = new Item(0);
+  ASSERT_EQ(LSN_INVALID, window.growMany(&last, 1));
+  ASSERT_EQ(E::DISABLED, err);
+  delete last;
+}
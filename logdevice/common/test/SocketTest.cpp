@@ -6,7 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 #include <gtest/gtest.h>
+#include <zstd.h>
 
+#include "logdevice/common/protocol/COMPRESSED_FRAME_Message.h"
 #include "logdevice/common/protocol/GET_SEQ_STATE_Message.h"
 #include "logdevice/common/test/SocketTest_fixtures.h"
 
@@ -114,6 +116,35 @@ TEST_F(ClientSocketTest, GetDscp) {
   EXPECT_EQ(4 << 2, SocketTest::getDscp());
 }
 
+// With --sendbuf-adaptive, the send buffer is resized to twice the
+// bandwidth-delay product from TCP_INFO once bytes are passed to TCP, and at
+// most once a second.
+TEST_F(ClientSocketTest, AdaptiveSendBuf) {
+  settings_.tcp_sendbuf_adaptive = true;
+  tcp_info_.tcpi_snd_cwnd = 100;
+  tcp_info_.tcpi_snd_mss = 1448;
+
+  int rv = socket_->connect();
+  ASSERT_EQ(0, rv);
+  auto envelope = create_message(*socket_);
+  ASSERT_NE(envelope, nullptr);
+  socket_->releaseMessage(*envelope);
+
+  triggerEventConnected();
+  flushOutputEvBuffer();
+  CHECK_ON_SENT(MessageType::HELLO, E::OK);
+  EXPECT_EQ(2 * 100 * 1448, sndbuf_size_set_);
+  EXPECT_EQ(size_t(2 * 100 * 1448), socket_->getTcpSendBufSize());
+
+  // The window grew, but the buffer was just resized.
+  tcp_info_.tcpi_snd_cwnd = 1000;
+  ACK_Header ackhdr{0, request_id_t(0), client_id_, max_proto_, E::OK};
+  receiveMsg(new TestACK_Message(ackhdr));
+  flushOutputEvBuffer();
+  CHECK_ON_SENT(MessageType::GET_SEQ_STATE, E::OK);
+  EXPECT_EQ(2 * 100 * 1448, sndbuf_size_set_);
+}
+
 // Verify that PEER CLOSED on server socket is translated to
 // E::SHUTDOWN when peer_shuttingdown flag is set.
 TEST_F(ClientSocketTest, PeerShutdown) {
@@ -463,6 +494,130 @@ TEST_F(ClientSocketTest, DrainPosAccounting) {
   CHECK_ON_SENT(MessageType::GET_SEQ_STATE, E::OK);
 }
 
+// With coalescing enabled, small messages are serialized into the Socket's
+// coalesced output buffer and only reach the output evbuffer once the end of
+// the event loop iteration is simulated. Drain positions are unaffected.
+TEST_F(ClientSocketTest, CoalescedOutput) {
+  settings_.socket_coalesce_max_message_size = 1024;
+  int rv = socket_->connect();
+  ASSERT_EQ(0, rv);
+
+  auto envelope = create_message(*socket_);
+  ASSERT_NE(envelope, nullptr);
+  size_t get_seq_state_sz = envelope->message().size(max_proto_) -
+      (ProtocolHeader::needChecksumInHeader(
+           MessageType::GET_SEQ_STATE, max_proto_)
+           ? 0
+           : sizeof(ProtocolHeader::cksum));
+  socket_->releaseMessage(*envelope);
+  envelope = create_message(*socket_);
+  ASSERT_NE(envelope, nullptr);
+  socket_->releaseMessage(*envelope);
+
+  // HELLO is coalesced too.
+  triggerEventConnected();
+  CHECK_SENDQ(MessageType::HELLO);
+  ASSERT_EQ(0, LD_EV(evbuffer_get_length)(output_));
+  ASSERT_GT(getTotalOutbufLength(), 0);
+  flushCoalescedOutput();
+  flushOutputEvBuffer();
+  CHECK_ON_SENT(MessageType::HELLO, E::OK);
+  ACK_Header ackhdr{0, request_id_t(0), client_id_, max_proto_, E::OK};
+  receiveMsg(new TestACK_Message(ackhdr));
+
+  // Both GET_SEQ_STATE messages are serialized but not yet in the output
+  // evbuffer.
+  CHECK_SERIALIZEQ();
+  CHECK_SENDQ(MessageType::GET_SEQ_STATE, MessageType::GET_SEQ_STATE);
+  ASSERT_EQ(0, LD_EV(evbuffer_get_length)(output_));
+  ASSERT_EQ(2 * get_seq_state_sz, getTotalOutbufLength());
+
+  flushCoalescedOutput();
+  ASSERT_EQ(2 * get_seq_state_sz, LD_EV(evbuffer_get_length)(output_));
+  dequeueBytesFromOutputEvbuffer(get_seq_state_sz - 1);
+  CHECK_NO_MESSAGE_SENT();
+  dequeueBytesFromOutputEvbuffer(1);
+  CHECK_ON_SENT(MessageType::GET_SEQ_STATE, E::OK);
+  dequeueBytesFromOutputEvbuffer(get_seq_state_sz);
+  CHECK_ON_SENT(MessageType::GET_SEQ_STATE, E::OK);
+}
+
+// Messages to a peer beyond --socket-compression-boundary are coalesced into
+// a single COMPRESSED_FRAME, which decompresses to the serialized messages.
+// They are all sent once the last byte of the frame is passed to TCP.
+TEST_F(ClientSocketTest, CompressedOutput) {
+  settings_.socket_compression_boundary = NodeLocationScope::REGION;
+  socket_->peer_scope_ = NodeLocationScope::ROOT;
+  int rv = socket_->connect();
+  ASSERT_EQ(0, rv);
+
+  auto envelope = create_message(*socket_);
+  ASSERT_NE(envelope, nullptr);
+  size_t get_seq_state_sz = envelope->message().size(max_proto_) -
+      (ProtocolHeader::needChecksumInHeader(
+           MessageType::GET_SEQ_STATE, max_proto_)
+           ? 0
+           : sizeof(ProtocolHeader::cksum));
+  socket_->releaseMessage(*envelope);
+  envelope = create_message(*socket_);
+  ASSERT_NE(envelope, nullptr);
+  socket_->releaseMessage(*envelope);
+
+  // HELLO is never compressed.
+  triggerEventConnected();
+  flushOutputEvBuffer();
+  CHECK_ON_SENT(MessageType::HELLO, E::OK);
+  ACK_Header ackhdr{0, request_id_t(0), client_id_, max_proto_, E::OK};
+  receiveMsg(new TestACK_Message(ackhdr));
+
+  CHECK_SERIALIZEQ();
+  CHECK_SENDQ(MessageType::GET_SEQ_STATE, MessageType::GET_SEQ_STATE);
+  ASSERT_EQ(0, LD_EV(evbuffer_get_length)(output_));
+  flushCoalescedOutput();
+
+  const size_t frame_len = LD_EV(evbuffer_get_length)(output_);
+  ASSERT_GT(frame_len, 0);
+  std::string frame(frame_len, '\0');
+  ASSERT_EQ(frame_len,
+            static_cast<size_t>(
+                LD_EV(evbuffer_copyout)(output_, &frame[0], frame_len)));
+  ProtocolHeader ph;
+  const size_t protohdr_bytes =
+      ProtocolHeader::bytesNeeded(MessageType::COMPRESSED_FRAME, max_proto_);
+  memcpy(&ph, frame.data(), protohdr_bytes);
+  // ProtocolHeader is packed, copy the fields before comparing them
+  MessageType type = ph.type;
+  size_t len = ph.len;
+  ASSERT_EQ(MessageType::COMPRESSED_FRAME, type);
+  ASSERT_EQ(frame_len, len);
+  COMPRESSED_FRAME_Header framehdr;
+  memcpy(&framehdr, frame.data() + protohdr_bytes, sizeof(framehdr));
+  const uint32_t uncompressed_len = framehdr.uncompressed_len;
+  ASSERT_EQ(2 * get_seq_state_sz, uncompressed_len);
+
+  std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> dctx(
+      ZSTD_createDCtx(), ZSTD_freeDCtx);
+  std::string uncompressed(uncompressed_len, '\0');
+  ZSTD_inBuffer in = {frame.data() + protohdr_bytes + sizeof(framehdr),
+                      frame_len - protohdr_bytes - sizeof(framehdr),
+                      0};
+  ZSTD_outBuffer out = {&uncompressed[0], uncompressed.size(), 0};
+  ASSERT_FALSE(ZSTD_isError(ZSTD_decompressStream(dctx.get(), &out, &in)));
+  ASSERT_EQ(in.size, in.pos);
+  ASSERT_EQ(uncompressed.size(), out.pos);
+  memcpy(&ph, uncompressed.data(), sizeof(ph.len) + sizeof(ph.type));
+  type = ph.type;
+  len = ph.len;
+  ASSERT_EQ(MessageType::GET_SEQ_STATE, type);
+  ASSERT_EQ(get_seq_state_sz, len);
+
+  dequeueBytesFromOutputEvbuffer(frame_len - 1);
+  CHECK_NO_MESSAGE_SENT();
+  dequeueBytesFromOutputEvbuffer(1);
+  CHECK_ON_SENT(MessageType::GET_SEQ_STATE, E::OK);
+  CHECK_ON_SENT(MessageType::GET_SEQ_STATE, E::OK);
+}
+
 TEST_F(ClientSocketTest, DownRevEvbufferAccounting) {
   // Verify that sending down-protocol messages does not break
   // evbuffer space accounting.
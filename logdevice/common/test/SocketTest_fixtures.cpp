@@ -172,6 +172,28 @@ void TestSocketDependencies::buffereventShutDownSSL(
   // Ignored.
 }
 
+bool TestSocketDependencies::buffereventKernelTLSEnabled(
+    struct bufferevent* /*bev*/) {
+  return false;
+}
+
+void TestSocketDependencies::buffereventResumeSSLSession(
+    struct bufferevent* /*bev*/,
+    const Sockaddr& /*peer*/) {
+  // Ignored.
+}
+
+void TestSocketDependencies::buffereventSaveSSLSession(
+    struct bufferevent* /*bev*/,
+    const Sockaddr& /*peer*/) {
+  // Ignored.
+}
+
+bool TestSocketDependencies::buffereventSSLSessionReused(
+    struct bufferevent* /*bev*/) {
+  return false;
+}
+
 void TestSocketDependencies::buffereventFree(struct bufferevent* /*bev*/) {
   // Ignored.
 }
@@ -232,6 +254,16 @@ void TestSocketDependencies::configureSocket(bool /*is_tcp*/,
                                              sa_family_t /*sa_family*/,
                                              const uint8_t /*default_dscp*/) {}
 
+int TestSocketDependencies::getTCPInfo(int /*fd*/, struct tcp_info* info) {
+  *info = owner_->tcp_info_;
+  return 0;
+}
+
+int TestSocketDependencies::setSendBufSize(int /*fd*/, int size) {
+  owner_->sndbuf_size_set_ = size;
+  return 0;
+}
+
 ResourceBudget& TestSocketDependencies::getConnBudgetExternal() {
   return owner_->conn_budget_external_;
 }
@@ -10,6 +10,7 @@
 #include <queue>
 
 #include <gtest/gtest.h>
+#include <netinet/tcp.h>
 
 #include "event2/buffer.h"
 #include "event2/bufferevent.h"
@@ -92,6 +93,12 @@ class TestSocketDependencies : public SocketDependencies {
                                 bufferevent_event_cb eventcb,
                                 void* cbarg) override;
   virtual void buffereventShutDownSSL(struct bufferevent* bev) override;
+  virtual bool buffereventKernelTLSEnabled(struct bufferevent* bev) override;
+  virtual void buffereventResumeSSLSession(struct bufferevent* bev,
+                                           const Sockaddr& peer) override;
+  virtual void buffereventSaveSSLSession(struct bufferevent* bev,
+                                         const Sockaddr& peer) override;
+  virtual bool buffereventSSLSessionReused(struct bufferevent* bev) override;
   virtual void buffereventFree(struct bufferevent* bev) override;
   virtual int evUtilMakeSocketNonBlocking(int sfd) override;
   virtual int buffereventSetMaxSingleWrite(struct bufferevent* bev,
@@ -116,6 +123,8 @@ class TestSocketDependencies : public SocketDependencies {
                                int* rcv_out,
                                sa_family_t sa_family,
                                const uint8_t default_dscp) override;
+  virtual int getTCPInfo(int fd, struct tcp_info* info) override;
+  virtual int setSendBufSize(int fd, int size) override;
   virtual ResourceBudget& getConnBudgetExternal() override;
   virtual std::string getClusterName() override;
   virtual const std::string& getHELLOCredentials() override;
@@ -274,10 +283,22 @@ class SocketTest : public ::testing::Test {
       socket_->flushBufferedOutput();
     } else if (ev == &socket_->deferred_event_queue_event_) {
       socket_->processDeferredEventQueue();
+    } else if (ev == &socket_->coalesced_output_flush_event_) {
+      coalesced_output_flush_scheduled_ = true;
     }
     return 0;
   }
 
+  // Simulate the end of the event loop iteration for coalesced output: move
+  // what the Socket coalesced into its output evbuffer.
+  void flushCoalescedOutput() {
+    ASSERT_TRUE(coalesced_output_flush_scheduled_);
+    coalesced_output_flush_scheduled_ = false;
+    socket_->flushCoalescedOutput();
+  }
+
+  bool coalesced_output_flush_scheduled_{false};
+
   const Socket::EnvelopeQueue& getSerializeq() const {
     return socket_->serializeq_;
   }
@@ -333,6 +354,11 @@ class SocketTest : public ::testing::Test {
 
   ResourceBudget conn_budget_external_{std::numeric_limits<uint64_t>::max()};
 
+  // Returned by getTCPInfo().
+  struct tcp_info tcp_info_ {};
+  // Last size passed to setSendBufSize(), -1 if it wasn't called.
+  int sndbuf_size_set_{-1};
+
   std::unique_ptr<Socket> socket_;
 };
 
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/StatsSnapshotEncoder.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+int apply(StatsSnapshotDecoder& decoder, const std::string& data) {
+  return decoder.apply(Slice::fromString(data));
+}
+
+} // namespace
+
+TEST(StatsSnapshotEncoderTest, Deltas) {
+  StatsHolder holder(StatsParams().setIsServer(false));
+  StatsSnapshotEncoder encoder(/* include_log_groups */ false);
+  StatsSnapshotDecoder decoder;
+
+  STAT_ADD(&holder, post_request_total, 5);
+  std::string full;
+  uint64_t c1 = encoder.encode(holder.aggregate(), decoder.cursor(), &full);
+  ASSERT_EQ(0, apply(decoder, full));
+  EXPECT_EQ(c1, decoder.cursor());
+  EXPECT_EQ(5, decoder.get("post_request_total"));
+  const size_t num_stats = decoder.names().size();
+  EXPECT_GT(num_stats, 1);
+
+  // Only the changed stat is sent, without any names.
+  STAT_ADD(&holder, post_request_total, 2);
+  std::string delta;
+  uint64_t c2 = encoder.encode(holder.aggregate(), decoder.cursor(), &delta);
+  EXPECT_GT(c2, c1);
+  EXPECT_LT(delta.size(), full.size() / 10);
+  ASSERT_EQ(0, apply(decoder, delta));
+  EXPECT_EQ(c2, decoder.cursor());
+  EXPECT_EQ(7, decoder.get("post_request_total"));
+  EXPECT_EQ(num_stats, decoder.names().size());
+
+  // Nothing changed.
+  std::string empty_delta;
+  encoder.encode(holder.aggregate(), decoder.cursor(), &empty_delta);
+  EXPECT_LT(empty_delta.size(), delta.size());
+  ASSERT_EQ(0, apply(decoder, empty_delta));
+  EXPECT_EQ(7, decoder.get("post_request_total"));
+
+  // A delta against a cursor the decoder is not at is rejected.
+  ASSERT_EQ(-1, apply(decoder, delta));
+  EXPECT_EQ(E::STALE, err);
+  EXPECT_EQ(7, decoder.get("post_request_total"));
+
+  // The decoder's state matches a fresh full snapshot.
+  StatsSnapshotDecoder fresh;
+  std::string full2;
+  encoder.encode(holder.aggregate(), 0, &full2);
+  ASSERT_EQ(0, apply(fresh, full2));
+  EXPECT_EQ(fresh.names(), decoder.names());
+  EXPECT_EQ(fresh.values(), decoder.values());
+}
+
+TEST(StatsSnapshotEncoderTest, ForgottenCursor) {
+  StatsHolder holder(StatsParams().setIsServer(false));
+  StatsSnapshotEncoder encoder(
+      /* include_log_groups */ false, /* max_snapshots */ 2);
+  StatsSnapshotDecoder decoder;
+
+  std::string data;
+  uint64_t old_cursor = encoder.encode(holder.aggregate(), 0, &data);
+  ASSERT_EQ(0, apply(decoder, data));
+  const size_t full_size = data.size();
+
+  // Push the decoder's cursor out of the encoder's history.
+  for (int i = 0; i < 2; ++i) {
+    std::string unused;
+    encoder.encode(holder.aggregate(), 0, &unused);
+  }
+
+  STAT_ADD(&holder, post_request_total, 3);
+  data.clear();
+  encoder.encode(holder.aggregate(), old_cursor, &data);
+  // Got a full snapshot back, which the decoder accepts.
+  EXPECT_GE(data.size(), full_size);
+  ASSERT_EQ(0, apply(decoder, data));
+  EXPECT_EQ(3, decoder.get("post_request_total"));
+}
+
+TEST(StatsSnapshotEncoderTest, Malformed) {
+  StatsHolder holder(StatsParams().setIsServer(false));
+  StatsSnapshotEncoder encoder(/* include_log_groups */ false);
+  StatsSnapshotDecoder decoder;
+
+  STAT_ADD(&holder, post_request_total, 5);
+  std::string data;
+  encoder.encode(holder.aggregate(), 0, &data);
+
+  for (size_t len : {size_t(0), size_t(3), data.size() / 2, data.size() - 1}) {
+    ASSERT_EQ(-1, apply(decoder, data.substr(0, len)));
+    EXPECT_EQ(E::BADMSG, err);
+    EXPECT_EQ(0, decoder.cursor());
+    EXPECT_TRUE(decoder.names().empty());
+  }
+
+  ASSERT_EQ(-1, apply(decoder, data + "x"));
+  EXPECT_EQ(E::BADMSG, err);
+
+  ASSERT_EQ(0, apply(decoder, data));
+  EXPECT_EQ(5, decoder.get("post_request_total"));
+}
@@ -10,9 +10,13 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <folly/Benchmark.h>
@@ -248,6 +252,93 @@ TEST(StatsTest, HistogramConcurrencyTest) {
   }
 }
 
+TEST(StatsTest, CompactHistogramTest) {
+  // Bucket boundaries are contiguous and every value falls into the bucket
+  // whose range covers it.
+  for (size_t i = 0; i + 1 < CompactHistogram::NUM_BUCKETS; ++i) {
+    EXPECT_EQ(CompactHistogram::bucketMin(i) + CompactHistogram::bucketWidth(i),
+              CompactHistogram::bucketMin(i + 1));
+  }
+  for (int64_t v : {int64_t(0),
+                    int64_t(15),
+                    int64_t(16),
+                    int64_t(1000),
+                    int64_t(123456789),
+                    std::numeric_limits<int64_t>::max()}) {
+    size_t idx = CompactHistogram::bucketIndex(v);
+    ASSERT_LT(idx, CompactHistogram::NUM_BUCKETS);
+    EXPECT_LE(CompactHistogram::bucketMin(idx), v);
+    EXPECT_LE(v - CompactHistogram::bucketMin(idx),
+              CompactHistogram::bucketWidth(idx) - 1);
+  }
+  EXPECT_EQ(0u, CompactHistogram::bucketIndex(-5));
+
+  CompactLatencyHistogram h;
+  for (int64_t v = 1; v <= 1000; ++v) {
+    h.add(v * 1000);
+  }
+  auto cs = h.getCountAndSum();
+  EXPECT_EQ(1000u, cs.first);
+  EXPECT_EQ(500500000, cs.second);
+
+  // Estimates are within the relative error of a bucket.
+  const double pcts[] = {0.0, 0.5, 0.99, 1.0};
+  const int64_t expected[] = {1000, 500000, 990000, 1000000};
+  int64_t samples[4];
+  h.estimatePercentiles(pcts, 4, samples);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_NEAR(expected[i],
+                samples[i],
+                expected[i] / CompactHistogram::SUB_BUCKETS + 1);
+  }
+
+  CompactLatencyHistogram h2;
+  h2.add(5000000);
+  h2.merge(h);
+  EXPECT_EQ(1001u, h2.getCountAndSum().first);
+  EXPECT_NEAR(5000000,
+              h2.estimatePercentile(1.0),
+              5000000 / CompactHistogram::SUB_BUCKETS);
+  h2.subtract(h);
+  EXPECT_EQ(1u, h2.getCountAndSum().first);
+  EXPECT_EQ(5000000, h2.getCountAndSum().second);
+  EXPECT_NEAR(5000000,
+              h2.estimatePercentile(0.5),
+              5000000 / CompactHistogram::SUB_BUCKETS);
+
+  // Subtracting more than there is saturates at zero.
+  h2.subtract(h);
+  EXPECT_EQ(0u, h2.getCountAndSum().first);
+  EXPECT_EQ(0, h2.getCountAndSum().second);
+
+  CompactLatencyHistogram copy(h);
+  EXPECT_EQ(cs, copy.getCountAndSum());
+  h.clear();
+  EXPECT_EQ(0u, h.getCountAndSum().first);
+  EXPECT_EQ(0, h.estimatePercentile(0.5));
+  EXPECT_EQ(cs, copy.getCountAndSum());
+
+  // Unlike MultiScaleHistogram, add() may be called by multiple threads.
+  static constexpr size_t NUM_THREADS = 8;
+  static constexpr size_t ADDS_PER_THREAD = 100'000;
+  CompactSizeHistogram shared;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([&shared] {
+      for (size_t i = 0; i < ADDS_PER_THREAD; ++i) {
+        shared.add(i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  cs = shared.getCountAndSum();
+  EXPECT_EQ(NUM_THREADS * ADDS_PER_THREAD, cs.first);
+  EXPECT_EQ(NUM_THREADS * ADDS_PER_THREAD * (ADDS_PER_THREAD - 1) / 2,
+            cs.second);
+}
+
 TEST(StatsTest, PerNodeTimeSeriesSingleThread) {
   StatsHolder holder(
       StatsParams().setIsServer(false).setNodeStatsRetentionTimeOnClients(
@@ -666,6 +757,60 @@ TEST(StatsTest, PerClientNodeTimeSeries_UpdateAggregationTimeDecreaseDuration) {
   EXPECT_EQ(updated_retention_time, per_client_stats.timeseries()->duration());
 }
 
+TEST(StatsTest, PerLogStatsTable) {
+  StatsHolder holder(StatsParams().setIsServer(true));
+  int resolved = 0;
+  auto resolve = [&](logid_t log) {
+    return [&resolved, log]() -> folly::Optional<std::string> {
+      ++resolved;
+      if (log == logid_t(3)) {
+        return folly::none;
+      }
+      return std::string(log.val_ % 2 ? "/odd" : "/even");
+    };
+  };
+
+  LOG_ID_STAT_ADD(&holder, logid_t(1), 1, resolve(logid_t(1)), records_sent, 2);
+  LOG_ID_STAT_ADD(&holder, logid_t(1), 1, resolve(logid_t(1)), records_sent, 3);
+  LOG_ID_STAT_ADD(&holder, logid_t(5), 1, resolve(logid_t(5)), records_sent, 1);
+  LOG_ID_STAT_ADD(
+      &holder, logid_t(2), 1, resolve(logid_t(2)), trim_received, 1);
+  // Unknown log group.
+  LOG_ID_STAT_ADD(&holder, logid_t(3), 1, resolve(logid_t(3)), records_sent, 1);
+  EXPECT_EQ(4, resolved);
+
+  // Stats from another thread are added up.
+  std::thread([&] {
+    LOG_ID_STAT_ADD(
+        &holder, logid_t(7), 1, resolve(logid_t(7)), records_sent, 10);
+  }).join();
+  EXPECT_EQ(5, resolved);
+
+  {
+    Stats total = holder.aggregate();
+    auto per_log = total.per_log_stats.rlock();
+    ASSERT_EQ(2, per_log->size());
+    EXPECT_EQ(16, per_log->at("/odd")->records_sent);
+    EXPECT_EQ(0, per_log->at("/odd")->trim_received);
+    EXPECT_EQ(1, per_log->at("/even")->trim_received);
+  }
+
+  // A new logs config version causes log groups to be resolved again.
+  LOG_ID_STAT_ADD(&holder, logid_t(1), 2, resolve(logid_t(1)), records_sent, 1);
+  LOG_ID_STAT_ADD(&holder, logid_t(1), 2, resolve(logid_t(1)), records_sent, 1);
+  EXPECT_EQ(6, resolved);
+
+  holder.reset();
+  {
+    Stats total = holder.aggregate();
+    auto per_log = total.per_log_stats.rlock();
+    for (const auto& kv : *per_log) {
+      EXPECT_EQ(0, kv.second->records_sent);
+      EXPECT_EQ(0, kv.second->trim_received);
+    }
+  }
+}
+
 // benchmarks for a few different stats implementations (only multithreaded
 // increments are used)
 
@@ -712,6 +857,81 @@ BENCHMARK_RELATIVE(BM_stats_atomic_increment, iters) {
 
 BENCHMARK_DRAW_LINE();
 
+// Stats bumped by each append on a worker: a global counter and, if per-log
+// stats are on, append_payload_bytes of the log's log group. "by name" is the
+// old path of LOG_STAT_ADD(): look up the log group path (a string copy, as
+// Configuration::getLogGroupPath() does) and bump it under the per_log_stats
+// upgrade lock. "by log ID" is LOG_ID_STAT_ADD().
+
+namespace {
+constexpr uint64_t kBenchLogs = 1000;
+constexpr uint64_t kBenchLogsPerGroup = 10;
+
+const std::unordered_map<logid_t::raw_type, std::string>& benchLogGroups() {
+  static auto groups = [] {
+    std::unordered_map<logid_t::raw_type, std::string> m;
+    for (uint64_t log = 1; log <= kBenchLogs; ++log) {
+      m[log] = "/bench/group" + std::to_string(log / kBenchLogsPerGroup);
+    }
+    return m;
+  }();
+  return groups;
+}
+
+folly::Optional<std::string> benchLogGroupPath(logid_t log) {
+  auto it = benchLogGroups().find(log.val_);
+  if (it == benchLogGroups().end()) {
+    return folly::none;
+  }
+  return it->second;
+}
+} // namespace
+
+BENCHMARK(BM_append_stats_per_log_off, iters) {
+  const int pt = iters / FLAGS_num_threads;
+  StatsHolder stats(StatsParams().setIsServer(true));
+
+  stats_benchmark(FLAGS_num_threads, pt, [&stats]() {
+    STAT_ADD(&stats, append_received, 1);
+  });
+}
+
+BENCHMARK_RELATIVE(BM_append_stats_per_log_by_name, iters) {
+  const int pt = iters / FLAGS_num_threads;
+  StatsHolder stats(StatsParams().setIsServer(true));
+  benchLogGroups();
+
+  stats_benchmark(FLAGS_num_threads, pt, [&stats]() {
+    thread_local uint64_t i = 0;
+    logid_t log(++i % kBenchLogs + 1);
+    STAT_ADD(&stats, append_received, 1);
+    auto path = benchLogGroupPath(log);
+    if (path) {
+      LOG_GROUP_STAT_ADD(&stats, path.value(), append_payload_bytes, 100);
+    }
+  });
+}
+
+BENCHMARK_RELATIVE(BM_append_stats_per_log_by_log_id, iters) {
+  const int pt = iters / FLAGS_num_threads;
+  StatsHolder stats(StatsParams().setIsServer(true));
+  benchLogGroups();
+
+  stats_benchmark(FLAGS_num_threads, pt, [&stats]() {
+    thread_local uint64_t i = 0;
+    logid_t log(++i % kBenchLogs + 1);
+    STAT_ADD(&stats, append_received, 1);
+    LOG_ID_STAT_ADD(&stats,
+                    log,
+                    1,
+                    [log] { return benchLogGroupPath(log); },
+                    append_payload_bytes,
+                    100);
+  });
+}
+
+BENCHMARK_DRAW_LINE();
+
 #if 0
 #include <folly/experimental/symbolizer/SignalHandler.h>
 
@@ -729,3 +949,57 @@ int main(int argc, char *argv[]) {
   return RUN_ALL_TESTS();
 }
 #endif
+
+TEST(StatsTest, TopLogGroups) {
+  const std::chrono::milliseconds window = std::chrono::hours(1);
+  TopLogGroups top(4);
+
+  // A few heavy log groups among many light ones.
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      top.add("/light" + std::to_string(i), 1, window);
+    }
+    for (int i = 0; i < 3; ++i) {
+      top.add("/heavy" + std::to_string(i), 1000, window);
+    }
+  }
+
+  std::unordered_set<std::string> candidates;
+  top.getCandidates(candidates);
+  EXPECT_LT(candidates.size(), 2 * top.capacity());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(1, candidates.count("/heavy" + std::to_string(i)));
+  }
+
+  // Merging keeps the heavy log groups of the other sketch.
+  TopLogGroups other(4);
+  other.add("/other", 1000000, window);
+  top.merge(other);
+  candidates.clear();
+  top.getCandidates(candidates);
+  EXPECT_EQ(1, candidates.count("/other"));
+  EXPECT_EQ(1, candidates.count("/heavy0"));
+
+  // Log groups are forgotten two windows after they were last heavy.
+  top.add("/new", 1, std::chrono::milliseconds(0));
+  top.add("/newer", 1, std::chrono::milliseconds(0));
+  candidates.clear();
+  top.getCandidates(candidates);
+  EXPECT_EQ(std::unordered_set<std::string>({"/new", "/newer"}), candidates);
+
+  // Time series updates feed the sketch of the thread's Stats, and sketches
+  // of dead threads are kept.
+  StatsHolder holder(StatsParams().setIsServer(true));
+  LOG_GROUP_TIME_SERIES_ADD(&holder, append_in_bytes, "/a", 100);
+  std::thread([&] {
+    LOG_GROUP_TIME_SERIES_ADD(&holder, append_in_bytes, "/b", 100);
+  }).join();
+  candidates.clear();
+  holder.runForEach([&](Stats& s) {
+    s.top_log_groups_append_in_bytes->getCandidates(candidates);
+    std::unordered_set<std::string> other_series;
+    s.top_log_groups_record_bytes->getCandidates(other_series);
+    EXPECT_TRUE(other_series.empty());
+  });
+  EXPECT_EQ(std::unordered_set<std::string>({"/a", "/b"}), candidates);
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ThreadCachedAllocation.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/protocol/RELEASE_Message.h"
+#include "logdevice/common/protocol/TEST_Message.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+struct Base {
+  virtual ~Base() = default;
+};
+
+struct Pooled : public Base, public ThreadCachedAllocation<Pooled, 4> {
+  explicit Pooled(int v) : value(v) {}
+  int value;
+};
+
+// Bigger than Pooled, so it must bypass the free list.
+struct PooledSubclass : public Pooled {
+  PooledSubclass() : Pooled(0) {}
+  char padding[128];
+};
+
+} // namespace
+
+TEST(ThreadCachedAllocationTest, Basic) {
+  auto before = Pooled::getStats();
+
+  Base* a = new Pooled(1);
+  delete a;
+  // The block freed above should be reused.
+  std::unique_ptr<Base> b = std::make_unique<Pooled>(2);
+  EXPECT_EQ(a, b.get());
+  EXPECT_EQ(2, static_cast<Pooled*>(b.get())->value);
+  b.reset();
+
+  auto after = Pooled::getStats();
+  EXPECT_EQ(before.cache_hits + before.cache_misses + 2,
+            after.cache_hits + after.cache_misses);
+  EXPECT_GE(after.cache_hits, before.cache_hits + 1);
+  EXPECT_GE(after.cached, 1);
+
+  // Subclasses of a different size don't touch the free list.
+  std::unique_ptr<Base> s = std::make_unique<PooledSubclass>();
+  s.reset();
+  auto sub = Pooled::getStats();
+  EXPECT_EQ(after.cache_hits, sub.cache_hits);
+  EXPECT_EQ(after.cache_misses, sub.cache_misses);
+  EXPECT_EQ(after.cached, sub.cached);
+
+  bool found = false;
+  forEachThreadCachedAllocation(
+      [&](const std::string& name, const ThreadCachedAllocationStats&) {
+        found |= name.find("Pooled") != std::string::npos;
+      });
+  EXPECT_TRUE(found);
+}
+
+TEST(ThreadCachedAllocationTest, BoundedAndThreadLocal) {
+  std::thread t([] {
+    auto before = Pooled::getStats();
+    std::vector<std::unique_ptr<Pooled>> v;
+    for (int i = 0; i < 10; ++i) {
+      v.push_back(std::make_unique<Pooled>(i));
+    }
+    v.clear();
+    auto after = Pooled::getStats();
+    // Free list holds at most 4 blocks per thread.
+    EXPECT_EQ(before.cache_overflows + 6, after.cache_overflows);
+    EXPECT_EQ(before.cached + 4, after.cached);
+  });
+  t.join();
+  // The exited thread's free list was released, its counters were kept.
+  auto stats = Pooled::getStats();
+  EXPECT_LE(stats.cached, 4);
+  EXPECT_GE(stats.cache_overflows, 6);
+}
+
+TEST(ThreadCachedAllocationTest, SmallMessages) {
+  // Messages that are received at a high rate and freed right after dispatch
+  // reuse blocks freed by the same thread.
+  std::unique_ptr<Message> m = std::make_unique<RELEASE_Message>(
+      RELEASE_Header{RecordID(esn_t(1), epoch_t(1), logid_t(1)),
+                     ReleaseType::GLOBAL,
+                     0});
+  Message* p = m.get();
+  m.reset();
+  m = std::make_unique<RELEASE_Message>(RELEASE_Header{
+      RecordID(esn_t(2), epoch_t(1), logid_t(2)), ReleaseType::GLOBAL, 0});
+  EXPECT_EQ(p, m.get());
+
+  // Same for all instantiations of SimpleMessage.
+  m = std::make_unique<TEST_Message>(TEST_Message_Header{});
+  p = m.get();
+  m.reset();
+  m = std::make_unique<TEST_Message>(TEST_Message_Header{});
+  EXPECT_EQ(p, m.get());
+}
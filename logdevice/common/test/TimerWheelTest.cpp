@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TimerWheel.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using namespace std::chrono_literals;
+
+namespace {
+
+class TestCallback : public TimerWheel::Callback {
+ public:
+  explicit TestCallback(std::function<void()> f = nullptr)
+      : f_(std::move(f)) {}
+
+  void timeoutExpired() override {
+    ++fired;
+    if (f_) {
+      f_();
+    }
+  }
+
+  int fired = 0;
+
+ private:
+  std::function<void()> f_;
+};
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  TimerWheelTest()
+      : start_(TimerWheel::Clock::now()),
+        wheel_(1ms,
+               [this](TimerWheel::Clock::time_point t) {
+                 wakeups_.push_back(t);
+               },
+               start_) {}
+
+  TimerWheel::Clock::time_point at(std::chrono::microseconds d) const {
+    return start_ + d;
+  }
+
+  const TimerWheel::Clock::time_point start_;
+  std::vector<TimerWheel::Clock::time_point> wakeups_;
+  TimerWheel wheel_;
+};
+
+} // namespace
+
+TEST_F(TimerWheelTest, FiresOnTime) {
+  TestCallback cb;
+  wheel_.schedule(&cb, 10ms, at(0ms));
+  EXPECT_TRUE(cb.isScheduled());
+  EXPECT_EQ(1, wheel_.size());
+  ASSERT_EQ(1, wakeups_.size());
+  EXPECT_EQ(at(10ms), wakeups_.back());
+
+  wheel_.advance(at(9ms));
+  EXPECT_EQ(0, cb.fired);
+  wheel_.advance(at(10ms));
+  EXPECT_EQ(1, cb.fired);
+  EXPECT_FALSE(cb.isScheduled());
+  EXPECT_EQ(0, wheel_.size());
+  EXPECT_FALSE(wheel_.nextWakeup().hasValue());
+}
+
+TEST_F(TimerWheelTest, NeverEarly) {
+  TestCallback cb;
+  // 5.5ms after a tick boundary; must not fire before 15.5ms.
+  wheel_.schedule(&cb, 10ms, at(5500us));
+  wheel_.advance(at(15ms));
+  EXPECT_EQ(0, cb.fired);
+  wheel_.advance(at(16ms));
+  EXPECT_EQ(1, cb.fired);
+}
+
+TEST_F(TimerWheelTest, ZeroDelayFiresOnNextAdvance) {
+  TestCallback cb;
+  wheel_.advance(at(3300us));
+  wheel_.schedule(&cb, 0ms, at(3300us));
+  // Asks for a wakeup right away, even though tick 3 was already processed.
+  EXPECT_LE(wakeups_.back(), at(3300us));
+  wheel_.advance(at(3300us));
+  EXPECT_EQ(1, cb.fired);
+}
+
+TEST_F(TimerWheelTest, Cancel) {
+  TestCallback a;
+  TestCallback b;
+  wheel_.schedule(&a, 5ms, at(0ms));
+  wheel_.schedule(&b, 5ms, at(0ms));
+  a.cancel();
+  EXPECT_FALSE(a.isScheduled());
+  EXPECT_EQ(1, wheel_.size());
+  wheel_.advance(at(100ms));
+  EXPECT_EQ(0, a.fired);
+  EXPECT_EQ(1, b.fired);
+}
+
+TEST_F(TimerWheelTest, DestroyingCallbackCancels) {
+  auto cb = std::make_unique<TestCallback>();
+  wheel_.schedule(cb.get(), 5ms, at(0ms));
+  cb.reset();
+  EXPECT_EQ(0, wheel_.size());
+  wheel_.advance(at(100ms));
+}
+
+TEST_F(TimerWheelTest, Reschedule) {
+  TestCallback cb;
+  wheel_.schedule(&cb, 5ms, at(0ms));
+  wheel_.schedule(&cb, 50ms, at(0ms));
+  EXPECT_EQ(1, wheel_.size());
+  wheel_.advance(at(49ms));
+  EXPECT_EQ(0, cb.fired);
+  wheel_.advance(at(50ms));
+  EXPECT_EQ(1, cb.fired);
+}
+
+// Timers beyond the first level are cascaded down and still fire exactly on
+// their tick, including ones beyond the range of the whole wheel.
+TEST_F(TimerWheelTest, Cascade) {
+  const std::vector<std::chrono::milliseconds> delays = {
+      255ms, 256ms, 257ms, 1000ms, 65535ms, 65536ms, 70000ms, 20000000ms};
+  std::vector<std::unique_ptr<TestCallback>> cbs;
+  for (auto d : delays) {
+    cbs.push_back(std::make_unique<TestCallback>());
+    wheel_.schedule(cbs.back().get(), d, at(7ms));
+  }
+  for (size_t i = 0; i < delays.size(); ++i) {
+    wheel_.advance(at(7ms + delays[i] - 1ms));
+    EXPECT_EQ(0, cbs[i]->fired) << delays[i].count();
+    wheel_.advance(at(7ms + delays[i]));
+    EXPECT_EQ(1, cbs[i]->fired) << delays[i].count();
+  }
+  EXPECT_EQ(0, wheel_.size());
+}
+
+// Beyond kSlots^kLevels ticks, timers wait in the top level and still fire
+// on time.
+TEST_F(TimerWheelTest, BeyondRange) {
+  const auto delay = std::chrono::hours(24 * 60);
+  TestCallback cb;
+  wheel_.schedule(&cb, delay, at(0ms));
+  wheel_.advance(at(delay - 1ms));
+  EXPECT_EQ(0, cb.fired);
+  wheel_.advance(at(delay));
+  EXPECT_EQ(1, cb.fired);
+}
+
+TEST_F(TimerWheelTest, CallbackReschedulesAndCancels) {
+  TestCallback victim;
+  TestCallback* self_ptr = nullptr;
+  TestCallback self([&] {
+    victim.cancel();
+    if (self_ptr->fired < 3) {
+      wheel_.schedule(self_ptr, 0ms, at(10ms));
+    }
+  });
+  self_ptr = &self;
+  wheel_.schedule(&self, 10ms, at(0ms));
+  wheel_.schedule(&victim, 10ms, at(0ms));
+  // A timer rescheduled from its callback with no delay waits for the next
+  // advance().
+  wheel_.advance(at(10ms));
+  EXPECT_EQ(1, self.fired);
+  EXPECT_EQ(0, victim.fired);
+  wheel_.advance(at(10ms));
+  EXPECT_EQ(2, self.fired);
+  wheel_.advance(at(10ms));
+  EXPECT_EQ(3, self.fired);
+  EXPECT_EQ(0, wheel_.size());
+}
+
+TEST_F(TimerWheelTest, CoalescedWakeups) {
+  std::vector<std::unique_ptr<TestCallback>> cbs;
+  for (int i = 0; i < 1000; ++i) {
+    cbs.push_back(std::make_unique<TestCallback>());
+    wheel_.schedule(cbs.back().get(), 20ms, at(0ms));
+  }
+  // Only the first timer moved the wakeup earlier.
+  EXPECT_EQ(1, wakeups_.size());
+  wheel_.advance(at(20ms));
+  for (auto& cb : cbs) {
+    EXPECT_EQ(1, cb->fired);
+  }
+}
@@ -11,6 +11,7 @@
 #include <logdevice/common/FailureDomainNodeSet.h>
 #include <logdevice/common/HashBasedSequencerLocator.h>
 
+#include "logdevice/common/ShardLatencyTracker.h"
 #include "logdevice/common/configuration/ServerConfig.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/test/CopySetSelectorTestUtil.h"
@@ -896,3 +897,53 @@ TEST_F(WeightedCopySetSelectorTest, NotEnoughLocalNodes) {
   std::vector<ShardID> cs;
   EXPECT_EQ(CopySetSelector::Result::SUCCESS, select(cs, selector));
 }
+
+TEST_F(WeightedCopySetSelectorTest, AdaptiveAvoidsSlowShard) {
+  addNodes("rg.dc.cl.ro.rk0", {1, 1, 1});
+  addNodes("rg.dc.cl.ro.rk1", {1, 1, 1});
+  addNodes("rg.dc.cl.ro.rk2", {1, 1, 1});
+  replication_ = ReplicationProperty({{S::RACK, 2}, {S::NODE, 3}});
+
+  // Long half-life so that estimates don't decay during the test.
+  ShardLatencyTracker tracker(std::chrono::hours(1));
+  const auto now = ShardLatencyTracker::Clock::now();
+  for (ShardID shard : nodeset_indices_) {
+    STORE_Header header;
+    header.rid = RecordID(lsn_t(1), LOG_ID);
+    header.wave = 1;
+    tracker.onCopySent(E::OK, shard, header, now);
+    // N0 is 10x slower than everyone else.
+    tracker.onReply(shard,
+                    header,
+                    now + std::chrono::milliseconds(shard == N0 ? 10 : 1));
+  }
+
+  auto count_copies = [&](size_t num_copysets) {
+    std::map<ShardID, size_t> copies;
+    std::vector<ShardID> cs;
+    for (size_t i = 0; i < num_copysets; ++i) {
+      EXPECT_EQ(CopySetSelector::Result::SUCCESS, select(cs));
+      for (ShardID shard : cs) {
+        ++copies[shard];
+      }
+    }
+    return copies;
+  };
+
+  const size_t num_copysets = 3000;
+  auto baseline = count_copies(num_copysets);
+  // All 9 shards get their share of copies.
+  EXPECT_GT(baseline[N0], num_copysets * 3 / 9 / 2);
+  EXPECT_EQ(0, stats.get().copyset_adaptive_replacements);
+
+  deps_.setShardLatencyTracker(&tracker);
+  auto adaptive = count_copies(num_copysets);
+  deps_.setShardLatencyTracker(nullptr);
+
+  // N0 gets a small fraction of copies, but not none, and the rest of
+  // the load is spread over the other shards.
+  EXPECT_GT(adaptive[N0], 0);
+  EXPECT_LT(adaptive[N0], baseline[N0] / 3);
+  EXPECT_GT(adaptive[N1], baseline[N1] * 9 / 10);
+  EXPECT_GT(stats.get().copyset_adaptive_replacements, 0);
+}
@@ -42,6 +42,16 @@ TEST(WorkerLoadBalancingTest, TwoWorkersUnbalanced) {
   ASSERT_GE(count, 99);
 }
 
+TEST(WorkerLoadBalancingTest, RelativeLoad) {
+  WorkerLoadBalancing balancer(2);
+  // Nothing reported yet
+  ASSERT_EQ(0, balancer.getRelativeLoad(W0));
+  balancer.reportLoad(W0, 300);
+  balancer.reportLoad(W1, 100);
+  ASSERT_DOUBLE_EQ(1.5, balancer.getRelativeLoad(W0));
+  ASSERT_DOUBLE_EQ(0.5, balancer.getRelativeLoad(W1));
+}
+
 // With many workers and random loads, if we add as much work as is already
 // there, we expect new work to be assigned so that load mostly balances out
 // (this is without reporting updated load to the balancer).
@@ -199,6 +199,20 @@ int ZookeeperClientInMemory::multiOp(int count,
     }
     return rv;
   };
+  // Like ZooKeeper, reports the error on the op that failed, ZOK for the ops
+  // before it and ZRUNTIMEINCONSISTENCY for the ops after it. None of them is
+  // applied.
+  auto fail_op = [&](int failed, int rv) {
+    fill_result(rv);
+    for (int i = 0; i < count; ++i) {
+      if (i < failed) {
+        results[i].err = ZOK;
+      } else if (i > failed) {
+        results[i].err = ZRUNTIMEINCONSISTENCY;
+      }
+    }
+    return rv;
+  };
 
   auto locked_operations = [&]() {
     std::lock_guard<std::mutex> guard(mutex_);
@@ -214,10 +228,10 @@ int ZookeeperClientInMemory::multiOp(int count,
         // Checking the input and verifying that the node exist
         const auto& op = ops[i].create_op;
         if (!mapContainsParents(new_map, op.path)) {
-          return fill_result(ZNONODE);
+          return fail_op(i, ZNONODE);
         }
         if (new_map.find(op.path) != new_map.end()) {
-          return fill_result(ZNODEEXISTS);
+          return fail_op(i, ZNODEEXISTS);
         }
         new_map[op.path] =
             std::make_pair(std::string(op.data, op.datalen),
@@ -226,16 +240,31 @@ int ZookeeperClientInMemory::multiOp(int count,
       } else if (ops[i].type == ZOO_DELETE_OP) {
         const auto& op = ops[i].delete_op;
         if (!mapContainsParents(new_map, op.path)) {
-          return fill_result(ZNONODE);
+          return fail_op(i, ZNONODE);
         }
         if (new_map.find(op.path) != new_map.end()) {
           new_map.erase(op.path);
         } else {
-          return fill_result(ZNONODE);
+          return fail_op(i, ZNONODE);
+        }
+      } else if (ops[i].type == ZOO_SETDATA_OP) {
+        const auto& op = ops[i].set_op;
+        auto it = new_map.find(op.path);
+        if (it == new_map.end()) {
+          return fail_op(i, ZNONODE);
+        }
+        auto old_version = it->second.second.version_;
+        if (old_version != op.version && op.version != -1) {
+          // conditional update
+          return fail_op(i, ZBADVERSION);
         }
+        it->second.first = std::string(op.data, op.datalen);
+        it->second.second =
+            zk::Stat{.version_ = old_version + 1, .mtime_ = mtime};
       } else {
         // no other ops supported currently
-        ld_critical("Only create/delete operations supported in multi-ops");
+        ld_critical("Only create/delete/set operations supported in "
+                    "multi-ops");
         ld_check(false);
         return -1;
       }
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <folly/Benchmark.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Counts heap allocations made by a benchmark, so that it can report
+ *       allocations per operation next to its throughput.
+ *
+ *       AllocationCounter.cpp replaces the global operator new, so it has to
+ *       be linked into the benchmark binary for counts to be nonzero. Only
+ *       allocations made while the counter is running are counted: stop it
+ *       around BENCHMARK_SUSPEND blocks that set up the next operation.
+ */
+
+class AllocationCounter {
+ public:
+  // Number of calls to operator new made by the process so far, on all
+  // threads.
+  static uint64_t total();
+
+  void start() {
+    start_ = total();
+  }
+
+  void stop() {
+    count_ += total() - start_;
+  }
+
+  uint64_t count() const {
+    return count_;
+  }
+
+  // Reports the allocations per operation as the "allocs_per_op" counter of
+  // a BENCHMARK_COUNTERS benchmark.
+  void report(folly::UserCounters& counters, size_t ops) const {
+    counters["allocs_per_op"] = ops ? (count_ + ops / 2) / ops : 0;
+  }
+
+ private:
+  uint64_t start_{0};
+  uint64_t count_{0};
+};
+
+}} // namespace facebook::logdevice
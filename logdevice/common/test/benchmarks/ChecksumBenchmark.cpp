@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <folly/hash/Checksum.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/Checksum.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file Benchmarks comparing the per-payload checksum calls with the
+ *       scatter-gather and multi-buffer APIs in Checksum.h.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+const size_t PAYLOAD_SIZE = 1024;
+const size_t BATCH_SIZE = 64;
+
+struct Payloads {
+  Payloads() {
+    data.reserve(BATCH_SIZE);
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+      data.emplace_back(PAYLOAD_SIZE, char('a' + i % 26));
+      slices.push_back(Slice::fromString(data.back()));
+    }
+  }
+  std::vector<std::string> data;
+  std::vector<Slice> slices;
+};
+
+const Payloads& payloads() {
+  static Payloads p;
+  return p;
+}
+
+} // namespace
+
+// Baseline: what callers did before, one call per payload going through
+// folly's dispatching crc32c().
+BENCHMARK(Crc32cFollyPerPayload, n) {
+  const auto& p = payloads();
+  for (unsigned i = 0; i < n; ++i) {
+    for (const Slice& s : p.slices) {
+      folly::doNotOptimizeAway(
+          folly::crc32c((const uint8_t*)s.data, s.size));
+    }
+  }
+}
+
+BENCHMARK_RELATIVE(Crc32cPerPayload, n) {
+  const auto& p = payloads();
+  for (unsigned i = 0; i < n; ++i) {
+    for (const Slice& s : p.slices) {
+      folly::doNotOptimizeAway(checksum_32bit(s));
+    }
+  }
+}
+
+BENCHMARK_RELATIVE(Crc32cBatch, n) {
+  const auto& p = payloads();
+  std::vector<uint64_t> out(BATCH_SIZE);
+  for (unsigned i = 0; i < n; ++i) {
+    checksum_batch(p.slices.data(), p.slices.size(), 32, out.data());
+    folly::doNotOptimizeAway(out);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(Hash64PerPayload, n) {
+  const auto& p = payloads();
+  for (unsigned i = 0; i < n; ++i) {
+    for (const Slice& s : p.slices) {
+      folly::doNotOptimizeAway(checksum_64bit(s));
+    }
+  }
+}
+
+BENCHMARK_RELATIVE(Hash64Batch, n) {
+  const auto& p = payloads();
+  std::vector<uint64_t> out(BATCH_SIZE);
+  for (unsigned i = 0; i < n; ++i) {
+    checksum_batch(p.slices.data(), p.slices.size(), 64, out.data());
+    folly::doNotOptimizeAway(out);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+// Checksumming a message spread over several evbuffer chains: copying it
+// into a contiguous buffer first (old ProtocolWriter behaviour) versus
+// hashing the chains in place.
+BENCHMARK(Hash64CopyThenHash, n) {
+  const auto& p = payloads();
+  for (unsigned i = 0; i < n; ++i) {
+    std::string buf;
+    buf.reserve(PAYLOAD_SIZE * BATCH_SIZE);
+    for (const Slice& s : p.slices) {
+      buf.append(s.ptr(), s.size);
+    }
+    folly::doNotOptimizeAway(checksum_64bit(Slice::fromString(buf)));
+  }
+}
+
+BENCHMARK_RELATIVE(Hash64ScatterGather, n) {
+  const auto& p = payloads();
+  for (unsigned i = 0; i < n; ++i) {
+    folly::doNotOptimizeAway(
+        checksum_64bit(p.slices.data(), p.slices.size()));
+  }
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/SharedMutex.h>
+#include <folly/Singleton.h>
+#include <folly/hash/Hash.h>
+#include <google/dense_hash_map>
+
+#include "logdevice/common/ClientIdxAllocator.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+/**
+ * @file Benchmark comparing ClientIdxAllocator with the allocator it
+ *       replaced, a dense_hash_map protected by a SharedMutex, when all
+ *       Workers connect and disconnect clients at the same time, as in a
+ *       reconnect storm. Every Worker also looks up the Worker of a few
+ *       clients per connection, like STORED and Sender::describeConnection()
+ *       do.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+constexpr int kWorkers = 16;
+constexpr int kConnectionsPerWorker = 1000;
+constexpr int kLookupsPerConnection = 4;
+
+class LockedClientIdxAllocator {
+ public:
+  LockedClientIdxAllocator() {
+    idx_in_use_.set_empty_key(-1);
+    idx_in_use_.set_deleted_key(-2);
+  }
+
+  ClientID issueClientIdx(WorkerType worker_type, worker_id_t worker_idx) {
+    folly::SharedMutex::WriteHolder write_lock(mutex_);
+    int32_t client_idx;
+    do {
+      client_idx = next_idx_;
+      next_idx_ = next_idx_ == std::numeric_limits<int32_t>::max()
+          ? 1
+          : next_idx_ + 1;
+    } while (idx_in_use_.find(client_idx) != idx_in_use_.end());
+    idx_in_use_[client_idx] = std::make_pair(worker_type, worker_idx);
+    return ClientID(client_idx);
+  }
+
+  void releaseClientIdx(ClientID client_idx) {
+    folly::SharedMutex::WriteHolder write_lock(mutex_);
+    idx_in_use_.erase(client_idx.getIdx());
+  }
+
+  std::pair<WorkerType, worker_id_t> getWorkerId(ClientID client_idx) {
+    folly::SharedMutex::ReadHolder read_lock(mutex_);
+    auto it = idx_in_use_.find(client_idx.getIdx());
+    return it == idx_in_use_.end()
+        ? std::make_pair(WorkerType::MAX, worker_id_t(-1))
+        : it->second;
+  }
+
+ private:
+  int32_t next_idx_ = 1;
+  google::
+      dense_hash_map<int32_t, std::pair<WorkerType, worker_id_t>, folly::Hash>
+          idx_in_use_;
+  folly::SharedMutex mutex_;
+};
+
+template <typename Allocator>
+void reconnectStorm(Allocator& alloc, int iters) {
+  std::vector<std::thread> threads;
+  for (int w = 0; w < kWorkers; ++w) {
+    threads.emplace_back([&alloc, iters, w] {
+      std::vector<ClientID> clients;
+      clients.reserve(kConnectionsPerWorker);
+      for (int i = 0; i < iters; ++i) {
+        for (int c = 0; c < kConnectionsPerWorker; ++c) {
+          clients.push_back(
+              alloc.issueClientIdx(WorkerType::GENERAL, worker_id_t(w)));
+          for (int l = 0; l < kLookupsPerConnection; ++l) {
+            auto worker = alloc.getWorkerId(clients[(c * 7 + l) % (c + 1)]);
+            folly::doNotOptimizeAway(worker);
+          }
+        }
+        for (ClientID client : clients) {
+          alloc.releaseClientIdx(client);
+        }
+        clients.clear();
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+} // namespace
+
+BENCHMARK(LockedClientIdxAllocatorStorm, n) {
+  LockedClientIdxAllocator alloc;
+  reconnectStorm(alloc, n);
+}
+
+BENCHMARK_RELATIVE(ClientIdxAllocatorStorm, n) {
+  ClientIdxAllocator alloc;
+  reconnectStorm(alloc, n);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
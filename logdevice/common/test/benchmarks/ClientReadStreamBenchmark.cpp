@@ -0,0 +1,383 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/client_read_stream/ClientReadStreamBufferFactory.h"
+#include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
+#include "logdevice/common/configuration/UpdateableConfig.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/STARTED_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/test/MockBackoffTimer.h"
+#include "logdevice/common/test/MockTimer.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/common/test/benchmarks/AllocationCounter.h"
+
+/**
+ * @file Benchmarks ClientReadStream end to end: a stream reading from 6
+ *       storage shards with a replication factor of 3 is fed records the way
+ *       storage shards would send them, and delivers them to a callback that
+ *       accepts everything. Messages the stream sends are dropped and timers
+ *       never fire, so this measures only the bookkeeping of the stream.
+ *
+ *       Every record is sent by the 3 shards of its copyset. Scenarios:
+ *       - InOrderRecords: one record per LSN;
+ *       - HolesAndBridges: epochs of 64 LSNs where every 4th LSN is a hole
+ *         plug and the last one is a bridge record, so the stream delivers
+ *         as many gaps as records;
+ *       - Rewinds: like InOrderRecords, but the stream rewinds every 256
+ *         LSNs and all shards acknowledge the new START.
+ *
+ *       An operation is one LSN delivered. Records are created in
+ *       BENCHMARK_SUSPEND blocks and their allocations are not counted.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+const logid_t LOG_ID(1);
+const int NUM_SHARDS = 6;
+const int REPLICATION = 3;
+const size_t BUFFER_SIZE = 4096;
+const size_t PAYLOAD_SIZE = 128;
+// LSNs per epoch in the HolesAndBridges scenario.
+const esn_t::raw_type EPOCH_SIZE = 64;
+// Records created per BENCHMARK_SUSPEND block, and LSNs between two rewinds
+// in the Rewinds scenario.
+const size_t BATCH_SIZE = 256;
+
+enum class Scenario { IN_ORDER, HOLES_AND_BRIDGES, REWINDS };
+
+} // namespace
+
+/**
+ * Owns the ClientReadStream being benchmarked and plays its storage shards.
+ * Friend of ClientReadStream so that it can rewind the stream.
+ */
+class ClientReadStreamBenchmark {
+ public:
+  using Batch =
+      std::vector<std::pair<ShardID, std::unique_ptr<DataRecordOwnsPayload>>>;
+
+  ClientReadStreamBenchmark();
+
+  // Creates the stream and has all shards acknowledge the first START.
+  void start();
+
+  // Creates the copies of the next `num_lsns' LSNs, in the order storage
+  // shards would send them.
+  Batch makeBatch(size_t num_lsns, Scenario scenario);
+
+  void deliver(Batch& batch) {
+    for (auto& copy : batch) {
+      stream_->onDataRecord(copy.first, std::move(copy.second));
+    }
+  }
+
+  void rewind() {
+    stream_->rewind("benchmark");
+    acknowledgeStart();
+  }
+
+ private:
+  class Deps;
+
+  void acknowledgeStart();
+
+  Settings settings_;
+  std::shared_ptr<UpdateableConfig> config_;
+  EpochMetaData metadata_;
+  std::unique_ptr<ClientReadStream> stream_;
+  filter_version_t filter_version_{0};
+  lsn_t next_lsn_{compose_lsn(EPOCH_MIN, ESN_MIN)};
+  size_t next_copyset_{0};
+};
+
+class ClientReadStreamBenchmark::Deps : public ClientReadStreamDependencies {
+ public:
+  explicit Deps(ClientReadStreamBenchmark* owner) : owner_(owner) {}
+
+  void getMetaDataForEpoch(read_stream_id_t /*rsid*/,
+                           epoch_t epoch,
+                           MetaDataLogReader::Callback cb,
+                           bool /*allow_from_cache*/,
+                           bool /*require_consistent_from_cache*/) override {
+    // The same storage set for all epochs.
+    cb(E::OK,
+       MetaDataLogReader::Result{
+           LOG_ID,
+           epoch,
+           lsn_to_epoch(LSN_MAX),
+           MetaDataLogReader::RecordSource::LAST,
+           compose_lsn(epoch, ESN_MIN),
+           std::chrono::milliseconds(0),
+           std::make_unique<EpochMetaData>(owner_->metadata_)});
+  }
+
+  void updateEpochMetaDataCache(
+      epoch_t /*epoch*/,
+      epoch_t /*until*/,
+      const EpochMetaData& /*metadata*/,
+      MetaDataLogReader::RecordSource /*source*/) override {}
+
+  int sendStartMessage(ShardID /*shard*/,
+                       SocketCallback* /*onclose*/,
+                       START_Header header,
+                       const small_shardset_t& /*filtered_out*/,
+                       const ReadStreamAttributes* /*attrs*/) override {
+    owner_->filter_version_ = header.filter_version;
+    return 0;
+  }
+
+  int sendStopMessage(ShardID /*shard*/) override {
+    return 0;
+  }
+
+  int sendWindowMessage(ShardID /*shard*/,
+                        lsn_t /*window_low*/,
+                        lsn_t /*window_high*/) override {
+    return 0;
+  }
+
+  int sendChecksumFailMessage(ShardID /*shard*/, lsn_t /*lsn*/) override {
+    return 0;
+  }
+
+  bool recordCallback(std::unique_ptr<DataRecord>& /*record*/) override {
+    return true;
+  }
+
+  bool gapCallback(const GapRecord& /*gap*/) override {
+    return true;
+  }
+
+  void healthCallback(bool /*is_healthy*/) override {}
+
+  void dispose() override {}
+
+  std::unique_ptr<BackoffTimer>
+  createBackoffTimer(std::chrono::milliseconds,
+                     std::chrono::milliseconds) override {
+    return std::make_unique<MockBackoffTimer>();
+  }
+
+  std::unique_ptr<BackoffTimer> createBackoffTimer(
+      const chrono_expbackoff_t<std::chrono::milliseconds>&) override {
+    return std::make_unique<MockBackoffTimer>();
+  }
+
+  std::unique_ptr<Timer> createTimer(std::function<void()> cb) override {
+    return std::make_unique<MockTimer>(std::move(cb));
+  }
+
+  std::function<ClientReadStream*(read_stream_id_t)>
+  getStreamByIDCallback() override {
+    ClientReadStreamBenchmark* owner = owner_;
+    return [owner](read_stream_id_t) { return owner->stream_.get(); };
+  }
+
+  const Settings& getSettings() const override {
+    return owner_->settings_;
+  }
+
+  ShardAuthoritativeStatusMap getShardStatus() const override {
+    return ShardAuthoritativeStatusMap();
+  }
+
+  void refreshClusterState() override {}
+
+  folly::Optional<uint16_t>
+  getSocketProtocolVersion(node_index_t /*nid*/) const override {
+    return Compatibility::MAX_PROTOCOL_SUPPORTED;
+  }
+
+  bool hasMemoryPressure() const override {
+    return false;
+  }
+
+ private:
+  ClientReadStreamBenchmark* const owner_;
+};
+
+ClientReadStreamBenchmark::ClientReadStreamBenchmark()
+    : settings_(create_default_settings<Settings>()),
+      config_(std::make_shared<UpdateableConfig>()) {
+  configuration::Nodes nodes;
+  StorageSet shards;
+  for (node_index_t nid = 0; nid < NUM_SHARDS; ++nid) {
+    Configuration::Node& node = nodes[nid];
+    node.address = Sockaddr("::1", folly::to<std::string>(4440 + nid));
+    node.generation = 1;
+    node.addSequencerRole();
+    node.addStorageRole();
+    shards.push_back(ShardID(nid, 0));
+  }
+
+  logsconfig::LogAttributes log_attrs;
+  log_attrs.set_replicationFactor(REPLICATION);
+  log_attrs.set_scdEnabled(false);
+  Configuration::NodesConfig nodes_config(std::move(nodes));
+  auto logs_config = std::make_shared<configuration::LocalLogsConfig>();
+  logs_config->insert(boost::icl::right_open_interval<logid_t::raw_type>(
+                          LOG_ID.val_, LOG_ID.val_ + 1),
+                      "log",
+                      log_attrs);
+  Configuration::MetaDataLogsConfig meta_config =
+      createMetaDataLogsConfig(nodes_config, NUM_SHARDS, REPLICATION);
+  config_->updateableServerConfig()->update(
+      ServerConfig::fromDataTest(__FILE__, nodes_config, meta_config));
+  config_->updateableLogsConfig()->update(std::move(logs_config));
+
+  metadata_ = EpochMetaData(
+      shards,
+      ReplicationProperty(REPLICATION, NodeLocationScope::NODE),
+      EPOCH_MIN,
+      EPOCH_MIN);
+}
+
+void ClientReadStreamBenchmark::start() {
+  stream_ = std::make_unique<ClientReadStream>(
+      read_stream_id_t(1),
+      LOG_ID,
+      next_lsn_,
+      LSN_MAX,
+      /*flow_control_threshold=*/0.5,
+      ClientReadStreamBufferType::CIRCULAR,
+      BUFFER_SIZE,
+      std::make_unique<Deps>(this),
+      config_);
+  stream_->start();
+  acknowledgeStart();
+}
+
+void ClientReadStreamBenchmark::acknowledgeStart() {
+  STARTED_Header header{LOG_ID,
+                        read_stream_id_t(1),
+                        E::OK,
+                        filter_version_,
+                        LSN_INVALID,
+                        /*shard_idx=*/0};
+  for (node_index_t nid = 0; nid < NUM_SHARDS; ++nid) {
+    stream_->onStartSent(ShardID(nid, 0), E::OK);
+    stream_->onStarted(
+        ShardID(nid, 0), STARTED_Message(header, TrafficClass::READ_BACKLOG));
+  }
+}
+
+ClientReadStreamBenchmark::Batch
+ClientReadStreamBenchmark::makeBatch(size_t num_lsns, Scenario scenario) {
+  Batch batch;
+  batch.reserve(num_lsns * REPLICATION);
+  for (size_t i = 0; i < num_lsns; ++i) {
+    const lsn_t lsn = next_lsn_;
+    const esn_t::raw_type esn = lsn_to_esn(lsn).val_;
+    RECORD_flags_t flags = 0;
+    if (scenario == Scenario::HOLES_AND_BRIDGES && esn == EPOCH_SIZE) {
+      flags = RECORD_Header::HOLE | RECORD_Header::BRIDGE;
+      next_lsn_ = compose_lsn(epoch_t(lsn_to_epoch(lsn).val_ + 1), ESN_MIN);
+    } else {
+      if (scenario == Scenario::HOLES_AND_BRIDGES && esn % 4 == 0) {
+        flags = RECORD_Header::HOLE;
+      }
+      next_lsn_ = lsn + 1;
+    }
+
+    for (int r = 0; r < REPLICATION; ++r) {
+      Payload payload;
+      if (!(flags & RECORD_Header::HOLE)) {
+        void* data = malloc(PAYLOAD_SIZE);
+        memset(data, 'x', PAYLOAD_SIZE);
+        payload = Payload(data, PAYLOAD_SIZE);
+      }
+      const node_index_t nid = (next_copyset_ + r) % NUM_SHARDS;
+      batch.emplace_back(
+          ShardID(nid, 0),
+          std::make_unique<DataRecordOwnsPayload>(LOG_ID,
+                                                  std::move(payload),
+                                                  lsn,
+                                                  std::chrono::milliseconds(0),
+                                                  flags));
+    }
+    ++next_copyset_;
+  }
+  return batch;
+}
+
+namespace {
+
+void readLog(folly::UserCounters& counters, size_t n, Scenario scenario) {
+  std::unique_ptr<ClientReadStreamBenchmark> bench;
+  BENCHMARK_SUSPEND {
+    bench = std::make_unique<ClientReadStreamBenchmark>();
+    bench->start();
+  }
+
+  AllocationCounter allocs;
+  ClientReadStreamBenchmark::Batch batch;
+  for (size_t done = 0; done < n;) {
+    const size_t num_lsns = std::min(BATCH_SIZE, n - done);
+    BENCHMARK_SUSPEND {
+      batch = bench->makeBatch(num_lsns, scenario);
+    }
+    allocs.start();
+    bench->deliver(batch);
+    if (scenario == Scenario::REWINDS) {
+      bench->rewind();
+    }
+    allocs.stop();
+    done += num_lsns;
+  }
+
+  BENCHMARK_SUSPEND {
+    bench.reset();
+  }
+  allocs.report(counters, n);
+}
+
+} // namespace
+
+}} // namespace facebook::logdevice
+
+using namespace facebook::logdevice;
+
+BENCHMARK_COUNTERS(InOrderRecords, counters, n) {
+  readLog(counters, n, Scenario::IN_ORDER);
+}
+
+BENCHMARK_COUNTERS(HolesAndBridges, counters, n) {
+  readLog(counters, n, Scenario::HOLES_AND_BRIDGES);
+}
+
+BENCHMARK_COUNTERS(Rewinds, counters, n) {
+  readLog(counters, n, Scenario::REWINDS);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <memory>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/client_read_stream/ClientReadStreamBufferFactory.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file Benchmarks comparing ClientReadStreamBuffer implementations on the
+ *       operations ClientReadStream does most: looking for the first marker of
+ *       a mostly empty buffer and delivering in order from the front.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+const size_t CAPACITY = 4096;
+const lsn_t BUFFER_HEAD = 1000;
+
+// Only the last slot of the buffer has a marker, as when a read stream waits
+// for a record while storage shards already sent gaps up to the window end.
+void findFirstMarker(ClientReadStreamBufferType type, unsigned n) {
+  std::unique_ptr<ClientReadStreamBuffer> buffer;
+  BENCHMARK_SUSPEND {
+    buffer = ClientReadStreamBufferFactory::create(type, CAPACITY, BUFFER_HEAD);
+    buffer->createOrGet(BUFFER_HEAD + CAPACITY - 1)->gap = true;
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    folly::doNotOptimizeAway(buffer->findFirstMarker());
+  }
+  BENCHMARK_SUSPEND {
+    buffer->clear();
+  }
+}
+
+void deliverFromFront(ClientReadStreamBufferType type, unsigned n) {
+  std::unique_ptr<ClientReadStreamBuffer> buffer;
+  BENCHMARK_SUSPEND {
+    buffer = ClientReadStreamBufferFactory::create(type, CAPACITY, BUFFER_HEAD);
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    buffer->createOrGet(buffer->getBufferHead())->filtered_out = true;
+    ClientReadStreamRecordState* rstate = buffer->front();
+    folly::doNotOptimizeAway(rstate);
+    rstate->filtered_out = false;
+    buffer->popFront();
+    buffer->advanceBufferHead();
+  }
+}
+
+} // namespace
+
+BENCHMARK(FindFirstMarkerCircular, n) {
+  findFirstMarker(ClientReadStreamBufferType::CIRCULAR, n);
+}
+
+BENCHMARK_RELATIVE(FindFirstMarkerOrderedMap, n) {
+  findFirstMarker(ClientReadStreamBufferType::ORDERED_MAP, n);
+}
+
+BENCHMARK_RELATIVE(FindFirstMarkerPacked, n) {
+  findFirstMarker(ClientReadStreamBufferType::PACKED, n);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(DeliverFromFrontCircular, n) {
+  deliverFromFront(ClientReadStreamBufferType::CIRCULAR, n);
+}
+
+BENCHMARK_RELATIVE(DeliverFromFrontOrderedMap, n) {
+  deliverFromFront(ClientReadStreamBufferType::ORDERED_MAP, n);
+}
+
+BENCHMARK_RELATIVE(DeliverFromFrontPacked, n) {
+  deliverFromFront(ClientReadStreamBufferType::PACKED, n);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <memory>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/EventLoop.h"
+#include "logdevice/common/Semaphore.h"
+#include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/client_read_stream/ClientReadStreamSenderState.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/settings/util.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file Benchmarks setting up the sender states of many tailing read streams,
+ *       as a client that reads from many logs does at startup. The eager
+ *       variant allocates the three timers of each sender up front, which is
+ *       what ClientReadStream used to do. The lazy variant goes through what
+ *       a successful START/STARTED exchange does to the timers of a sender,
+ *       after which the sender holds no timers at all.
+ *
+ *       Each benchmark sets up the given number of read streams, each reading
+ *       from SHARDS_PER_STREAM shards. Besides being faster, the lazy variant
+ *       ends up with no timers allocated against 3 * SHARDS_PER_STREAM per
+ *       stream for the eager one. Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+const int SHARDS_PER_STREAM = 10;
+
+class BenchmarkDependencies : public ClientReadStreamDependencies {
+ public:
+  const Settings& getSettings() const override {
+    return settings_;
+  }
+
+ private:
+  Settings settings_ = create_default_settings<Settings>();
+};
+
+// Timers need an event loop, so run `fn` on one and wait for it.
+template <typename Fn>
+void runOnEventLoop(EventLoop& ev_loop, Fn fn) {
+  Semaphore sem;
+  ev_loop.add([&] {
+    fn();
+    sem.post();
+  });
+  sem.wait();
+}
+
+void createSenderStates(size_t iters, size_t streams, bool eager) {
+  std::unique_ptr<EventLoop> ev_loop;
+  BenchmarkDependencies deps;
+  std::vector<std::unique_ptr<ClientReadStreamSenderState>> states;
+  std::vector<std::unique_ptr<BackoffTimer>> timers;
+  BENCHMARK_SUSPEND {
+    ev_loop = std::make_unique<EventLoop>();
+  }
+
+  const Settings& settings = deps.getSettings();
+  for (size_t iter = 0; iter < iters; ++iter) {
+    BENCHMARK_SUSPEND {
+      states.reserve(streams * SHARDS_PER_STREAM);
+      if (eager) {
+        timers.reserve(3 * streams * SHARDS_PER_STREAM);
+      }
+    }
+
+    runOnEventLoop(*ev_loop, [&] {
+      for (size_t i = 0; i < streams * SHARDS_PER_STREAM; ++i) {
+        states.push_back(std::make_unique<ClientReadStreamSenderState>(
+            nullptr, ShardID(i % SHARDS_PER_STREAM, 0), &deps));
+        if (eager) {
+          timers.push_back(
+              deps.createBackoffTimer(settings.reader_reconnect_delay));
+          timers.push_back(
+              deps.createBackoffTimer(settings.reader_started_timeout));
+          timers.push_back(
+              deps.createBackoffTimer(settings.reader_retry_window_delay));
+        } else {
+          // START sent, STARTED received.
+          auto& state = *states.back();
+          state.activateStartedTimer();
+          state.resetStartedTimer();
+          state.releaseConnectionTimers();
+        }
+      }
+    });
+
+    BENCHMARK_SUSPEND {
+      runOnEventLoop(*ev_loop, [&] {
+        timers.clear();
+        states.clear();
+      });
+    }
+  }
+
+  BENCHMARK_SUSPEND {
+    ev_loop.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(createSenderStates, 1k_streams_eager, 1000, true)
+BENCHMARK_RELATIVE_NAMED_PARAM(createSenderStates,
+                               1k_streams_lazy,
+                               1000,
+                               false)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(createSenderStates, 100k_streams_eager, 100000, true)
+BENCHMARK_RELATIVE_NAMED_PARAM(createSenderStates,
+                               100k_streams_lazy,
+                               100000,
+                               false)
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -5,8 +5,11 @@
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include <fcntl.h>
 #include <iostream>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 #include <folly/Benchmark.h>
 #include <folly/Singleton.h>
@@ -63,6 +66,44 @@ BENCHMARK(LoggingOverridesMulti, n) {
   }
 }
 
+// Logs from several threads to /dev/null, writing on the calling threads.
+void callLoggingWrite(int n) {
+  const int nthreads = 4;
+  int fd;
+  int prev_fd;
+  BENCHMARK_SUSPEND {
+    fd = open("/dev/null", O_WRONLY);
+    prev_fd = dbg::useFD(fd);
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; ++t) {
+    threads.emplace_back([n] {
+      for (int i = 0; i < n / nthreads; ++i) {
+        ld_info("item #%d", i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BENCHMARK_SUSPEND {
+    dbg::useFD(prev_fd);
+    close(fd);
+  }
+}
+
+BENCHMARK(LoggingWriteSync, n) {
+  callLoggingWrite(n);
+}
+
+// Must run after LoggingWriteSync, since async writes can't be disabled.
+BENCHMARK_RELATIVE(LoggingWriteAsync, n) {
+  BENCHMARK_SUSPEND {
+    dbg::enableAsyncWrites();
+  }
+  callLoggingWrite(n);
+}
+
 #ifndef BENCHMARK_BUNDLE
 int main(int argc, char** argv) {
   folly::SingletonVault::singleton()->registrationComplete();
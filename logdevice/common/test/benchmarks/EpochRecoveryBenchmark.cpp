@@ -0,0 +1,389 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/EpochRecovery.h"
+#include "logdevice/common/Mutator.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
+#include "logdevice/common/configuration/UpdateableConfig.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/START_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/test/DigestTestUtil.h"
+#include "logdevice/common/test/MockBackoffTimer.h"
+#include "logdevice/common/test/MockTimer.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/common/test/benchmarks/AllocationCounter.h"
+
+using namespace facebook::logdevice;
+using namespace facebook::logdevice::DigestTestUtil;
+
+/**
+ * @file Benchmarks EpochRecovery recovering one epoch from start to finish:
+ *       sealing, digesting, mutating, cleaning and advancing LCE. The nodeset
+ *       is {N1, N2, N3} with a replication of 2. N1 stores every record of
+ *       the epoch, N2 every other one and N3 none, so the records missing
+ *       from N2 need to be re-replicated and recovery plugs a bridge at the
+ *       end of the epoch.
+ *
+ *       Storage nodes are simulated: messages EpochRecovery sends are
+ *       dropped and the benchmark calls the callbacks their replies would
+ *       trigger. Mutators don't send anything and are completed right after
+ *       the digest, so this measures the digest and the mutation planning,
+ *       not the STORE path.
+ *
+ *       An operation is the recovery of one epoch. Records are created in
+ *       BENCHMARK_SUSPEND blocks and their allocations are not counted.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+using DigestRecords =
+    std::vector<std::pair<ShardID, std::unique_ptr<DataRecordOwnsPayload>>>;
+
+const logid_t LOG_ID(23333);
+const epoch_t EPOCH(23);
+const epoch_t SEAL_EPOCH(27);
+const ShardID N1(1, 0);
+const ShardID N2(2, 0);
+const ShardID N3(3, 0);
+
+class NoopMutator : public Mutator {
+ public:
+  using Mutator::Mutator;
+  void start() override {}
+};
+
+class EpochRecoveryBenchmark {
+ public:
+  EpochRecoveryBenchmark();
+
+  // Creates the EpochRecovery machine and the records storage shards will
+  // send in the digest of an epoch of `epoch_size' records.
+  void setUp(esn_t::raw_type epoch_size);
+
+  // Recovers the epoch.
+  void recover();
+
+  bool finished() const {
+    return finished_;
+  }
+
+ private:
+  class Deps;
+
+  Settings settings_;
+  StatsHolder stats_;
+  std::shared_ptr<UpdateableConfig> config_;
+  const StorageSet storage_set_{N1, N2, N3};
+
+  std::unique_ptr<EpochRecovery> erm_;
+  DigestRecords records_;
+  // First LSN of the gap each shard sends at the end of its digest.
+  std::map<ShardID, lsn_t> gap_lo_;
+  read_stream_id_t::raw_type next_rsid_{0};
+  std::map<ShardID, read_stream_id_t> digest_rsids_;
+  TailRecord lce_tail_;
+  bool finished_{false};
+};
+
+class EpochRecoveryBenchmark::Deps : public EpochRecoveryDependencies {
+  using MockSender = SenderTestProxy<Deps>;
+
+ public:
+  explicit Deps(EpochRecoveryBenchmark* owner)
+      : EpochRecoveryDependencies(/*driver=*/nullptr), owner_(owner) {
+    sender_ = std::make_unique<MockSender>(this);
+  }
+
+  int sendMessageImpl(std::unique_ptr<Message>&& msg,
+                      const Address& addr,
+                      BWAvailableCallback*,
+                      SocketCallback*) {
+    // Remember digest read stream ids to tag records with.
+    auto start = dynamic_cast<START_Message*>(msg.get());
+    if (start) {
+      ShardID shard(addr.asNodeID().index(), start->header_.shard);
+      owner_->digest_rsids_[shard] = start->header_.read_stream_id;
+    }
+    return 0;
+  }
+
+  bool canSendToImpl(const Address&, TrafficClass, BWAvailableCallback&) {
+    return true;
+  }
+
+  epoch_t getSealEpoch() const override {
+    return SEAL_EPOCH;
+  }
+
+  epoch_t getLogRecoveryNextEpoch() const override {
+    return epoch_t(SEAL_EPOCH.val_ + 1);
+  }
+
+  void onEpochRecovered(epoch_t /*epoch*/,
+                        TailRecord /*epoch_tail*/,
+                        Status status,
+                        Seal /*seal*/) override {
+    ld_check(status == E::OK);
+    owner_->finished_ = true;
+  }
+
+  void onShardRemovedFromConfig(ShardID) override {}
+
+  bool canMutateShard(ShardID) const override {
+    return true;
+  }
+
+  NodeID getMyNodeID() const override {
+    return NodeID(0, 1);
+  }
+
+  read_stream_id_t issueReadStreamID() override {
+    return read_stream_id_t(++owner_->next_rsid_);
+  }
+
+  void noteMutationsCompleted(const EpochRecovery&) override {}
+
+  std::unique_ptr<BackoffTimer>
+  createBackoffTimer(const chrono_expbackoff_t<std::chrono::milliseconds>&,
+                     std::function<void()> callback) override {
+    auto timer = std::make_unique<MockBackoffTimer>();
+    if (callback) {
+      timer->setCallback(std::move(callback));
+    }
+    return std::move(timer);
+  }
+
+  std::unique_ptr<Timer> createTimer(std::function<void()> cb) override {
+    return std::make_unique<MockTimer>(std::move(cb));
+  }
+
+  int registerOnSocketClosed(const Address&, SocketCallback&) override {
+    return 0;
+  }
+
+  int setLastCleanEpoch(logid_t,
+                        epoch_t,
+                        const TailRecord& tail_record,
+                        EpochStore::CompletionLCE) override {
+    owner_->lce_tail_ = tail_record;
+    return 0;
+  }
+
+  std::unique_ptr<Mutator>
+  createMutator(const STORE_Header& header,
+                const STORE_Extra& extra,
+                Payload payload,
+                StorageSet mutation_set,
+                ReplicationProperty replication,
+                std::set<ShardID> amend_metadata,
+                std::set<ShardID> conflict_copies,
+                EpochRecovery* epoch_recovery) override {
+    return std::make_unique<NoopMutator>(header,
+                                         extra,
+                                         payload,
+                                         std::move(mutation_set),
+                                         std::move(replication),
+                                         std::move(amend_metadata),
+                                         std::move(conflict_copies),
+                                         epoch_recovery);
+  }
+
+  const Settings& getSettings() const override {
+    return owner_->settings_;
+  }
+
+  StatsHolder* getStats() const override {
+    return &owner_->stats_;
+  }
+
+  logid_t getLogID() const override {
+    return LOG_ID;
+  }
+
+ private:
+  EpochRecoveryBenchmark* const owner_;
+};
+
+EpochRecoveryBenchmark::EpochRecoveryBenchmark()
+    : settings_(create_default_settings<Settings>()),
+      stats_(StatsParams().setIsServer(true)),
+      config_(std::make_shared<UpdateableConfig>()) {
+  configuration::Nodes nodes;
+  for (node_index_t nid = 0; nid <= N3.node(); ++nid) {
+    Configuration::Node& node = nodes[nid];
+    node.address = Sockaddr("::1", folly::to<std::string>(4440 + nid));
+    node.generation = 1;
+    node.addSequencerRole();
+    node.addStorageRole();
+  }
+
+  logsconfig::LogAttributes log_attrs;
+  log_attrs.set_replicationFactor(2);
+  Configuration::NodesConfig nodes_config(std::move(nodes));
+  auto logs_config = std::make_shared<configuration::LocalLogsConfig>();
+  logs_config->insert(boost::icl::right_open_interval<logid_t::raw_type>(
+                          LOG_ID.val_, LOG_ID.val_ + 1),
+                      "log",
+                      log_attrs);
+  Configuration::MetaDataLogsConfig meta_config =
+      createMetaDataLogsConfig(nodes_config, nodes_config.getNodes().size(), 3);
+  config_->updateableServerConfig()->update(
+      ServerConfig::fromDataTest(__FILE__, nodes_config, meta_config));
+  config_->updateableLogsConfig()->update(std::move(logs_config));
+}
+
+void EpochRecoveryBenchmark::setUp(esn_t::raw_type epoch_size) {
+  const EpochMetaData metadata(
+      storage_set_, ReplicationProperty({{NodeLocationScope::NODE, 2}}));
+  erm_ = std::make_unique<EpochRecovery>(LOG_ID,
+                                         EPOCH,
+                                         metadata,
+                                         config_->get(),
+                                         std::make_unique<Deps>(this),
+                                         /*tail_optimized=*/false);
+  digest_rsids_.clear();
+  finished_ = false;
+
+  records_.clear();
+  for (ShardID shard : storage_set_) {
+    gap_lo_[shard] = lsn(EPOCH, ESN_MIN);
+  }
+  for (esn_t::raw_type esn = 1; esn <= epoch_size; ++esn) {
+    for (ShardID shard : {N1, N2}) {
+      if (shard == N2 && esn % 2 == 0) {
+        continue;
+      }
+      gap_lo_[shard] = lsn(EPOCH, esn + 1);
+      records_.emplace_back(
+          shard,
+          create_record(LOG_ID,
+                        lsn(EPOCH, esn),
+                        RecordType::NORMAL,
+                        /*wave=*/1,
+                        std::chrono::milliseconds(esn)));
+    }
+  }
+}
+
+void EpochRecoveryBenchmark::recover() {
+  TailRecord prev_tail(
+      {LOG_ID,
+       lsn(21, 7),
+       3432,
+       {BYTE_OFFSET_INVALID /* deprecated, use OffsetMap instead */},
+       TailRecordHeader::CHECKSUM_PARITY,
+       {}},
+      OffsetMap({{BYTE_OFFSET, 237419}}),
+      std::shared_ptr<PayloadHolder>());
+  for (ShardID shard : storage_set_) {
+    erm_->onSealed(shard, ESN_INVALID, ESN_INVALID, OffsetMap(), folly::none);
+  }
+  erm_->activate(prev_tail);
+
+  // All shards sealed, digest starts.
+  for (ShardID shard : storage_set_) {
+    const read_stream_id_t rsid = digest_rsids_.at(shard);
+    erm_->onMessageSent(shard, MessageType::START, E::OK, rsid);
+    erm_->onDigestStreamStarted(shard, rsid, lsn(EPOCH, ESN_INVALID), E::OK);
+  }
+  for (auto& record : records_) {
+    erm_->onDigestRecord(record.first,
+                         digest_rsids_.at(record.first),
+                         std::move(record.second));
+  }
+  for (ShardID shard : storage_set_) {
+    erm_->onDigestGap(shard,
+                      GAP_Header{LOG_ID,
+                                 digest_rsids_.at(shard),
+                                 gap_lo_.at(shard),
+                                 lsn(EPOCH, ESN_MAX),
+                                 GapReason::NO_RECORDS,
+                                 GAP_Header::DIGEST,
+                                 shard.shard()});
+  }
+
+  // The digest is complete, mutate.
+  std::vector<esn_t> mutations;
+  for (const auto& mutator : erm_->getMutators()) {
+    mutations.push_back(mutator.first);
+  }
+  for (esn_t esn : mutations) {
+    erm_->onMutationComplete(esn, E::OK, ShardID());
+  }
+
+  // Clean, then advance LCE.
+  for (ShardID shard : storage_set_) {
+    erm_->onMessageSent(shard, MessageType::CLEAN, E::OK);
+  }
+  for (ShardID shard : storage_set_) {
+    erm_->onCleaned(shard, E::OK, Seal());
+  }
+  erm_->onLastCleanEpochUpdated(E::OK, EPOCH, lce_tail_);
+}
+
+void recoverEpochs(folly::UserCounters& counters,
+                   size_t n,
+                   esn_t::raw_type epoch_size) {
+  std::unique_ptr<EpochRecoveryBenchmark> bench;
+  BENCHMARK_SUSPEND {
+    dbg::currentLevel = dbg::Level::ERROR;
+    bench = std::make_unique<EpochRecoveryBenchmark>();
+  }
+
+  AllocationCounter allocs;
+  for (size_t i = 0; i < n; ++i) {
+    BENCHMARK_SUSPEND {
+      bench->setUp(epoch_size);
+    }
+    allocs.start();
+    bench->recover();
+    allocs.stop();
+    BENCHMARK_SUSPEND {
+      ld_check(bench->finished());
+    }
+  }
+  allocs.report(counters, n);
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(RecoverEpoch_10_Records, counters, n) {
+  recoverEpochs(counters, n, 10);
+}
+
+BENCHMARK_COUNTERS(RecoverEpoch_100_Records, counters, n) {
+  recoverEpochs(counters, n, 100);
+}
+
+BENCHMARK_COUNTERS(RecoverEpoch_1000_Records, counters, n) {
+  recoverEpochs(counters, n, 1000);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <memory>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/FailureDomainNodeSet.h"
+#include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/test/NodesConfigurationTestUtil.h"
+
+using namespace facebook::logdevice;
+using namespace facebook::logdevice::NodesConfigurationTestUtil;
+
+/**
+ * @file Benchmarks the f-majority checks ClientReadStream runs every time it
+ *       looks for a gap (see ClientReadStream::checkFMajority()), for storage
+ *       sets of various sizes spread across racks of 10 nodes, with a
+ *       replication of 3 across racks.
+ *
+ *       All shards but the last one of each rack reported a gap, which is
+ *       the worst case: neither check finds an f-majority, so
+ *       ClientReadStream runs both. One shard in 10 is under-replicated, which
+ *       only the predicate check counts. The attribute variant is answered
+ *       from counters; the predicate variant walks the bitsets of the shards
+ *       of every domain.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+using GapState = ClientReadStreamSenderState::GapState;
+using GapFailureDomain = ClientReadStream::GapFailureDomain;
+
+struct GapFailureDomainFixture {
+  std::shared_ptr<const configuration::nodes::NodesConfiguration> nodes;
+  std::unique_ptr<GapFailureDomain> domain;
+};
+
+GapFailureDomainFixture makeFixture(size_t nodeset_size) {
+  std::vector<NodeTemplate> templates;
+  StorageSet storage_set;
+  for (size_t i = 0; i < nodeset_size; ++i) {
+    templates.push_back(
+        {static_cast<node_index_t>(i),
+         storage_role,
+         folly::sformat("rg0.dc0.cl0.ro0.rk{}", i / 10),
+         0.0,
+         /*num_shards=*/1});
+    storage_set.push_back(ShardID(static_cast<node_index_t>(i), 0));
+  }
+
+  GapFailureDomainFixture fixture;
+  fixture.nodes = provisionNodes(initialProvisionUpdate(std::move(templates)));
+  fixture.domain = std::make_unique<GapFailureDomain>(
+      storage_set,
+      *fixture.nodes,
+      ReplicationProperty(3, NodeLocationScope::RACK));
+  for (size_t i = 0; i < nodeset_size; ++i) {
+    if (i % 10 == 9) {
+      continue;
+    }
+    fixture.domain->setShardAttribute(
+        storage_set[i],
+        i % 10 == 5 ? GapState::UNDER_REPLICATED : GapState::GAP);
+  }
+  return fixture;
+}
+
+void isFmajorityAttr(size_t iters, size_t nodeset_size) {
+  GapFailureDomainFixture fixture;
+  BENCHMARK_SUSPEND {
+    fixture = makeFixture(nodeset_size);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    auto result = fixture.domain->isFmajority(GapState::GAP);
+    folly::doNotOptimizeAway(result);
+  }
+}
+
+void isFmajorityPredicate(size_t iters, size_t nodeset_size) {
+  GapFailureDomainFixture fixture;
+  BENCHMARK_SUSPEND {
+    fixture = makeFixture(nodeset_size);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    auto result = fixture.domain->isFmajority(
+        [](const GapState& gs) { return gs != GapState::NONE; });
+    folly::doNotOptimizeAway(result);
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(isFmajorityAttr, 20_shards, 20)
+BENCHMARK_RELATIVE_NAMED_PARAM(isFmajorityPredicate, 20_shards, 20)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(isFmajorityAttr, 50_shards, 50)
+BENCHMARK_RELATIVE_NAMED_PARAM(isFmajorityPredicate, 50_shards, 50)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(isFmajorityAttr, 100_shards, 100)
+BENCHMARK_RELATIVE_NAMED_PARAM(isFmajorityPredicate, 100_shards, 100)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(isFmajorityAttr, 250_shards, 250)
+BENCHMARK_RELATIVE_NAMED_PARAM(isFmajorityPredicate, 250_shards, 250)
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/stats/Histogram.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file Benchmarks comparing the cost of add() and merge() for
+ *       MultiScaleHistogram and CompactHistogram.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+const size_t NUM_VALUES = 4096;
+
+// Latencies spread over a few orders of magnitude, as seen by most latency
+// stats.
+const std::vector<int64_t>& values() {
+  static std::vector<int64_t> v = [] {
+    std::vector<int64_t> res;
+    folly::Random::DefaultGenerator rng(42);
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+      res.push_back(folly::Random::rand64(10, 100000000, rng));
+    }
+    return res;
+  }();
+  return v;
+}
+
+template <typename H>
+void addValues(H& h, size_t n) {
+  const auto& v = values();
+  for (size_t i = 0; i < n; ++i) {
+    h.add(v[i % NUM_VALUES]);
+  }
+}
+
+template <typename H>
+void benchAdd(size_t n) {
+  H h;
+  addValues(h, n);
+  folly::doNotOptimizeAway(h.getCountAndSum());
+}
+
+// Merging the per-thread histograms of one stat into the aggregate, as
+// done by the stats thread for every Worker.
+template <typename H>
+void benchMerge(size_t n) {
+  H src, dst;
+  BENCHMARK_SUSPEND {
+    addValues(src, NUM_VALUES);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    dst.merge(src);
+  }
+  folly::doNotOptimizeAway(dst.getCountAndSum());
+}
+
+} // namespace
+
+BENCHMARK(MultiScaleHistogramAdd, n) {
+  benchAdd<LatencyHistogram>(n);
+}
+
+BENCHMARK_RELATIVE(CompactHistogramAdd, n) {
+  benchAdd<CompactLatencyHistogram>(n);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(MultiScaleHistogramMerge, n) {
+  benchMerge<LatencyHistogram>(n);
+}
+
+BENCHMARK_RELATIVE(CompactHistogramMerge, n) {
+  benchMerge<CompactLatencyHistogram>(n);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+
+#include "logdevice/common/NodeSetState.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Benchmark of NodeSetState::checkNotAvailableUntil() called for every
+ *       shard of a nodeset, as copyset selectors do when picking copysets.
+ *       Compares a nodeset with all shards available, which takes the fast
+ *       path, with one where a single shard is overloaded, which looks up
+ *       the state of every shard.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+class BenchmarkNodeSetState : public NodeSetState {
+ public:
+  explicit BenchmarkNodeSetState(const StorageSet& shards)
+      : NodeSetState(shards, logid_t(1), HealthCheck::DISABLED) {}
+
+  std::chrono::steady_clock::time_point
+  getDeadline(NotAvailableReason /* unused */) const override {
+    return std::chrono::steady_clock::now() + std::chrono::hours(1);
+  }
+
+  const Settings* getSettings() const override {
+    return nullptr;
+  }
+};
+
+void do_benchmark(unsigned iterations, bool one_unavailable) {
+  std::unique_ptr<BenchmarkNodeSetState> state;
+  StorageSet shards;
+  BENCHMARK_SUSPEND {
+    for (node_index_t i = 0; i < 60; ++i) {
+      shards.push_back(ShardID(i, 0));
+    }
+    state = std::make_unique<BenchmarkNodeSetState>(shards);
+    if (one_unavailable) {
+      state->setNotAvailableUntil(
+          shards[17], NodeSetState::NotAvailableReason::OVERLOADED);
+    }
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < iterations; ++i) {
+    for (ShardID shard : shards) {
+      auto until = state->checkNotAvailableUntil(shard, now);
+      folly::doNotOptimizeAway(until);
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(NodeSetStateOneUnavailable, n) {
+  do_benchmark(n, true);
+}
+
+BENCHMARK_RELATIVE(NodeSetStateAllAvailable, n) {
+  do_benchmark(n, false);
+}
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,284 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/configuration/InternalLogs.h"
+#include "logdevice/common/configuration/UpdateableConfig.h"
+#include "logdevice/common/configuration/logs/LogsConfigStateMachine.h"
+#include "logdevice/common/settings/SettingsUpdater.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/common/test/benchmarks/AllocationCounter.h"
+
+using namespace facebook::logdevice;
+using namespace facebook::logdevice::logsconfig;
+
+/**
+ * @file Benchmarks replaying a LogsConfigStateMachine from its snapshot and
+ *       delta logs, which is what every server and client does when it
+ *       starts. The snapshot holds a tree of 1k or 10k log groups of 10 logs
+ *       each, spread across directories of 100 log groups; deltas each create
+ *       one more log group.
+ *
+ *       The state machine is read-only, as on clients, and reads from no
+ *       actual log: records are handed to it directly. Lazy variants enable
+ *       --logsconfig-lazy-materialization, with which the snapshot is only
+ *       parsed when the first delta is applied.
+ *
+ *       An operation is one full replay, from start() to the state machine
+ *       having applied the last delta. Records are created in
+ *       BENCHMARK_SUSPEND blocks and their allocations are not counted.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+const size_t LOG_GROUPS_PER_DIRECTORY = 100;
+const size_t LOGS_PER_LOG_GROUP = 10;
+// Version of the snapshot, i.e. the last delta it includes.
+const lsn_t SNAPSHOT_VERSION = lsn_t{100000};
+const lsn_t SNAPSHOT_LSN = lsn_t{1};
+
+std::shared_ptr<UpdateableServerConfig> buildConfig() {
+  configuration::Nodes nodes;
+  Configuration::Node& node = nodes[0];
+  node.address = Sockaddr("::1", "4440");
+  node.generation = 1;
+  node.addSequencerRole();
+  node.addStorageRole();
+  Configuration::NodesConfig nodes_config(std::move(nodes));
+  Configuration::MetaDataLogsConfig meta_config =
+      createMetaDataLogsConfig(nodes_config, 1, 1);
+  auto config = std::make_shared<UpdateableServerConfig>();
+  config->update(
+      ServerConfig::fromDataTest(__FILE__, nodes_config, meta_config));
+  return config;
+}
+
+// Reads the snapshot and delta logs from records the benchmark hands it, and
+// never talks to the cluster.
+class ReplayLogsConfigStateMachine : public LogsConfigStateMachine {
+ public:
+  ReplayLogsConfigStateMachine(
+      UpdateableSettings<Settings> settings,
+      std::shared_ptr<UpdateableServerConfig> config,
+      lsn_t delta_log_tail)
+      : LogsConfigStateMachine(std::move(settings),
+                               std::move(config),
+                               /*is_writable=*/false),
+        delta_log_tail_(delta_log_tail) {}
+
+  void getDeltaLogTailLSN() override {
+    onGotDeltaLogTailLSN(E::OK, delta_log_tail_);
+  }
+
+  void getSnapshotLogTailLSN() override {
+    onGotSnapshotLogTailLSN(E::OK, delta_log_tail_, SNAPSHOT_LSN);
+  }
+
+  read_stream_id_t createBasicReadStream(
+      logid_t /*logid*/,
+      lsn_t /*start_lsn*/,
+      lsn_t /*until_lsn*/,
+      ClientReadStreamDependencies::record_cb_t /*on_record*/,
+      ClientReadStreamDependencies::gap_cb_t /*on_gap*/,
+      ClientReadStreamDependencies::health_cb_t /*health_cb*/) override {
+    return read_stream_id_t{1};
+  }
+
+  void resumeReadStream(read_stream_id_t /*id*/) override {}
+  void postRequestWithRetrying(std::unique_ptr<Request>& /*rq*/) override {}
+  void postAppendRequest(
+      logid_t /*logid*/,
+      std::string /*payload*/,
+      std::chrono::milliseconds /*timeout*/,
+      std::function<void(Status st, lsn_t lsn)> /*cb*/) override {}
+  void activateGracePeriodForFastForward() override {}
+  void cancelGracePeriodForFastForward() override {}
+  bool isGracePeriodForFastForwardActive() override {
+    return false;
+  }
+  void activateStallGracePeriod() override {}
+  void cancelStallGracePeriod() override {}
+  void activateConfirmTimer(boost::uuids::uuid /*uuid*/) override {}
+  void activateGracePeriodForSnapshotting() override {}
+  void cancelGracePeriodForSnapshotting() override {}
+  bool isGracePeriodForSnapshottingActive() override {
+    return false;
+  }
+
+ private:
+  const lsn_t delta_log_tail_;
+};
+
+struct ReplayInput {
+  std::string snapshot;
+  std::vector<std::string> deltas;
+};
+
+LogAttributes logGroupAttributes() {
+  return LogAttributes()
+      .with_replicationFactor(3)
+      .with_backlogDuration(std::chrono::seconds(7 * 24 * 3600))
+      .with_maxWritesInFlight(1000);
+}
+
+ReplayInput makeInput(ReplayLogsConfigStateMachine& rsm,
+                      size_t num_log_groups,
+                      size_t num_deltas) {
+  auto tree = LogsConfigTree::create();
+  const LogAttributes attrs = logGroupAttributes();
+  logid_t::raw_type next_log = 1;
+  auto add_range = [&] {
+    logid_range_t range(
+        logid_t(next_log), logid_t(next_log + LOGS_PER_LOG_GROUP - 1));
+    next_log += LOGS_PER_LOG_GROUP;
+    return range;
+  };
+  for (size_t i = 0; i < num_log_groups; ++i) {
+    std::string path =
+        folly::sformat("/dir{}/log_group{}", i / LOG_GROUPS_PER_DIRECTORY, i);
+    auto lg = tree->addLogGroup(path, add_range(), attrs, true);
+    ld_check(lg != nullptr);
+  }
+  tree->setVersion(SNAPSHOT_VERSION);
+
+  ReplayInput input;
+  input.snapshot = rsm.createSnapshotPayload(
+      *tree, SNAPSHOT_VERSION, /*rsm_include_read_pointer_in_snapshot=*/true);
+  for (size_t i = 0; i < num_deltas; ++i) {
+    DeltaHeader header{config_version_t(SNAPSHOT_VERSION + i),
+                       ConflictResolutionMode::AUTO};
+    MkLogGroupDelta delta{header,
+                          folly::sformat("/new/log_group{}", i),
+                          add_range(),
+                          /*make_intermediates=*/true,
+                          attrs};
+    input.deltas.push_back(rsm.createDeltaPayload(
+        FBuffersLogsConfigCodec::serialize(delta, false).toString(),
+        ReplayLogsConfigStateMachine::DeltaHeader()));
+  }
+  return input;
+}
+
+std::unique_ptr<DataRecord> makeRecord(logid_t logid,
+                                       const std::string& payload,
+                                       lsn_t lsn) {
+  void* data = malloc(payload.size());
+  memcpy(data, payload.data(), payload.size());
+  return std::make_unique<DataRecordOwnsPayload>(
+      logid,
+      Payload(data, payload.size()),
+      lsn,
+      std::chrono::milliseconds{100},
+      0 // flags
+  );
+}
+
+void replay(folly::UserCounters& counters,
+            size_t n,
+            size_t num_log_groups,
+            size_t num_deltas,
+            bool lazy) {
+  UpdateableSettings<Settings> settings;
+  std::unique_ptr<SettingsUpdater> settings_updater;
+  std::shared_ptr<UpdateableServerConfig> config;
+  const lsn_t delta_log_tail = SNAPSHOT_VERSION + num_deltas;
+  ReplayInput input;
+  BENCHMARK_SUSPEND {
+    settings_updater = std::make_unique<SettingsUpdater>();
+    settings_updater->registerSettings(settings);
+    settings_updater->setFromCLI(
+        {{"logsconfig-lazy-materialization", lazy ? "true" : "false"}});
+    config = buildConfig();
+    ReplayLogsConfigStateMachine rsm(settings, config, delta_log_tail);
+    input = makeInput(rsm, num_log_groups, num_deltas);
+  }
+
+  AllocationCounter allocs;
+  for (size_t i = 0; i < n; ++i) {
+    std::unique_ptr<ReplayLogsConfigStateMachine> rsm;
+    std::unique_ptr<DataRecord> snapshot;
+    std::vector<std::unique_ptr<DataRecord>> deltas;
+    BENCHMARK_SUSPEND {
+      rsm = std::make_unique<ReplayLogsConfigStateMachine>(
+          settings, config, delta_log_tail);
+      snapshot = makeRecord(configuration::InternalLogs::CONFIG_LOG_SNAPSHOTS,
+                            input.snapshot,
+                            SNAPSHOT_LSN);
+      for (size_t j = 0; j < num_deltas; ++j) {
+        deltas.push_back(
+            makeRecord(configuration::InternalLogs::CONFIG_LOG_DELTAS,
+                       input.deltas[j],
+                       SNAPSHOT_VERSION + j + 1));
+      }
+    }
+
+    allocs.start();
+    rsm->start();
+    rsm->onSnapshotRecord(snapshot);
+    for (auto& delta : deltas) {
+      rsm->onDeltaRecord(delta);
+    }
+    allocs.stop();
+
+    BENCHMARK_SUSPEND {
+      ld_check(rsm->getVersion() == delta_log_tail);
+      rsm.reset();
+    }
+  }
+  allocs.report(counters, n);
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(Snapshot_1k_LogGroups, counters, n) {
+  replay(counters, n, 1000, 0, /*lazy=*/false);
+}
+
+BENCHMARK_COUNTERS(SnapshotLazy_1k_LogGroups, counters, n) {
+  replay(counters, n, 1000, 0, /*lazy=*/true);
+}
+
+BENCHMARK_COUNTERS(SnapshotAnd100Deltas_1k_LogGroups, counters, n) {
+  replay(counters, n, 1000, 100, /*lazy=*/false);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_COUNTERS(Snapshot_10k_LogGroups, counters, n) {
+  replay(counters, n, 10000, 0, /*lazy=*/false);
+}
+
+BENCHMARK_COUNTERS(SnapshotLazy_10k_LogGroups, counters, n) {
+  replay(counters, n, 10000, 0, /*lazy=*/true);
+}
+
+BENCHMARK_COUNTERS(SnapshotAnd100Deltas_10k_LogGroups, counters, n) {
+  replay(counters, n, 10000, 100, /*lazy=*/false);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <map>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+
+using namespace facebook::logdevice;
+using namespace facebook::logdevice::LocalLogStoreRecordFormat;
+
+/**
+ * @file Benchmarks parsing records in the original and the v2 on-disk
+ *       formats (see FLAG_FORMAT_V2), the way read streams do: everything but
+ *       the optional keys.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+const size_t NUM_RECORDS = 1024;
+
+// Records with a copyset of 3, an OffsetMap, and, for every other record, a
+// FILTERABLE key.
+std::vector<std::string> makeRecords(bool v2) {
+  const ShardID copyset[] = {ShardID(1, 0), ShardID(2, 0), ShardID(3, 0)};
+  OffsetMap offsets;
+  offsets.setCounter(BYTE_OFFSET, 12345);
+  std::vector<std::string> records(NUM_RECORDS);
+  for (size_t i = 0; i < NUM_RECORDS; ++i) {
+    flags_t flags = FLAG_CHECKSUM | FLAG_CHECKSUM_64BIT | FLAG_SHARD_ID |
+        FLAG_OFFSET_WITHIN_EPOCH | FLAG_OFFSET_MAP;
+    std::map<KeyType, std::string> keys;
+    if (i % 2) {
+      flags |= FLAG_CUSTOM_KEY | FLAG_OPTIONAL_KEYS;
+      keys[KeyType::FILTERABLE] = "key" + std::to_string(i);
+    }
+    if (v2) {
+      flags |= FLAG_FORMAT_V2;
+    }
+    formRecordHeader(1000 + i,
+                     esn_t(i),
+                     flags,
+                     1,
+                     folly::range(copyset),
+                     offsets,
+                     keys,
+                     &records[i]);
+    records[i].append(100, 'x');
+  }
+  return records;
+}
+
+void parseRecords(unsigned n, const std::vector<std::string>& records) {
+  std::chrono::milliseconds timestamp;
+  esn_t lng;
+  flags_t flags;
+  uint32_t wave;
+  copyset_size_t copyset_size;
+  ShardID copyset[COPYSET_SIZE_MAX];
+  OffsetMap offsets;
+  Payload payload;
+  for (unsigned i = 0; i < n; ++i) {
+    for (const std::string& record : records) {
+      int rv = parse(Slice::fromString(record),
+                     &timestamp,
+                     &lng,
+                     &flags,
+                     &wave,
+                     &copyset_size,
+                     copyset,
+                     COPYSET_SIZE_MAX,
+                     &offsets,
+                     nullptr,
+                     &payload,
+                     0);
+      folly::doNotOptimizeAway(rv);
+      folly::doNotOptimizeAway(payload);
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(ParseV1, n) {
+  std::vector<std::string> records;
+  BENCHMARK_SUSPEND {
+    records = makeRecords(false);
+  }
+  parseRecords(n, records);
+}
+
+BENCHMARK_RELATIVE(ParseV2, n) {
+  std::vector<std::string> records;
+  BENCHMARK_SUSPEND {
+    records = makeRecords(true);
+  }
+  parseRecords(n, records);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
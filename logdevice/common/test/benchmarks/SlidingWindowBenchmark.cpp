@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/SlidingWindowSingleEpoch.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Err.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+/**
+ * @file Benchmark of the per-epoch sequencer hot path under contention on a
+ *       single log: a number of threads (standing in for Workers) admit
+ *       Appenders into the same SlidingWindowSingleEpoch with grow() and
+ *       retire them, out of order across threads, with retire(). Each thread
+ *       keeps a few appends in flight, like a Worker waiting for STOREDs.
+ *
+ *       Reported time is per grow()+retire() pair, summed over all threads.
+ *       The growMany() variants admit Appenders in batches of
+ *       --grow_batch_size, as Workers do with --sequencer-admission-batch-size.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+DEFINE_int32(in_flight_per_thread,
+             8,
+             "Number of appends each thread keeps in the window before "
+             "retiring the oldest one.");
+DEFINE_int32(grow_batch_size,
+             8,
+             "Number of appends admitted with one growMany() call in the "
+             "batched benchmarks.");
+
+struct alignas(4) Item {
+  char unused;
+};
+
+// Items are owned by the benchmark threads; reaping them is a no-op, but the
+// number of reaped entries is tracked to keep the work from being optimized
+// away.
+class NoopDeleter {
+ public:
+  void operator()(Item*) {
+    ++reaped_;
+  }
+  size_t reaped_{0};
+};
+
+using Window = SlidingWindowSingleEpoch<Item, NoopDeleter>;
+
+constexpr int kWindowCapacity = 128 * 1024;
+
+void runThread(Window& window, int n, int batch, std::atomic<bool>& start) {
+  std::vector<Item> items(std::max(FLAGS_in_flight_per_thread, batch));
+  std::vector<Item*> to_grow(batch);
+  std::deque<lsn_t> in_flight;
+  NoopDeleter deleter;
+
+  while (!start.load()) {
+    std::this_thread::yield();
+  }
+
+  for (int i = 0; i < n; i += batch) {
+    while (in_flight.size() + batch > items.size()) {
+      window.retire(in_flight.front(), deleter);
+      in_flight.pop_front();
+    }
+    lsn_t lsn;
+    if (batch == 1) {
+      lsn = window.grow(&items[i % items.size()]);
+    } else {
+      for (int j = 0; j < batch; ++j) {
+        to_grow[j] = &items[(i + j) % items.size()];
+      }
+      lsn = window.growMany(to_grow.data(), batch);
+    }
+    if (lsn == LSN_INVALID) {
+      // The window is full or out of ESNs. Retire everything this thread has
+      // in flight and go on; this keeps the benchmark running with many
+      // threads at the cost of a few lost iterations.
+      while (!in_flight.empty()) {
+        window.retire(in_flight.front(), deleter);
+        in_flight.pop_front();
+      }
+      continue;
+    }
+    for (int j = 0; j < batch; ++j) {
+      in_flight.push_back(lsn + j);
+    }
+  }
+
+  while (!in_flight.empty()) {
+    window.retire(in_flight.front(), deleter);
+    in_flight.pop_front();
+  }
+  folly::doNotOptimizeAway(deleter.reaped_);
+}
+
+void runBenchmark(int n, int nthreads, int batch) {
+  std::unique_ptr<Window> window;
+  std::vector<std::thread> threads;
+  std::atomic<bool> start{false};
+
+  BENCHMARK_SUSPEND {
+    window = std::make_unique<Window>(epoch_t(1), kWindowCapacity);
+    for (int t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&window, &start, n, nthreads, batch] {
+        runThread(*window, n / nthreads, batch, start);
+      });
+    }
+  }
+
+  start.store(true);
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  BENCHMARK_SUSPEND {
+    window.reset();
+  }
+}
+
+void benchGrowRetire(int n, int nthreads) {
+  runBenchmark(n, nthreads, 1);
+}
+
+void benchGrowManyRetire(int n, int nthreads) {
+  runBenchmark(n, nthreads, FLAGS_grow_batch_size);
+}
+
+BENCHMARK_NAMED_PARAM(benchGrowRetire, 1_thread, 1)
+BENCHMARK_RELATIVE_NAMED_PARAM(benchGrowRetire, 4_threads, 4)
+BENCHMARK_RELATIVE_NAMED_PARAM(benchGrowRetire, 16_threads, 16)
+BENCHMARK_RELATIVE_NAMED_PARAM(benchGrowRetire, 32_threads, 32)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(benchGrowManyRetire, 1_thread, 1)
+BENCHMARK_RELATIVE_NAMED_PARAM(benchGrowManyRetire, 4_threads, 4)
+BENCHMARK_RELATIVE_NAMED_PARAM(benchGrowManyRetire, 16_threads, 16)
+BENCHMARK_RELATIVE_NAMED_PARAM(benchGrowManyRetire, 32_threads, 32)
+
+} // namespace
+
+#ifndef BENCHMARK_BUNDLE
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
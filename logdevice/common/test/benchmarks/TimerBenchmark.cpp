@@ -16,6 +16,7 @@
 
 #include "event2/event.h"
 #include "logdevice/common/LibeventTimer.h"
+#include "logdevice/common/TimerWheel.h"
 #include "logdevice/common/WheelTimer.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/libevent/compat.h"
@@ -74,3 +75,80 @@ BENCHMARK_RELATIVE(LibeventTimerParallel, n) {
   while (nfired != n) {
   }
 }
+
+BENCHMARK_DRAW_LINE();
+
+// Arming and cancelling one timer while many others are live, which is what
+// Appenders and read streams do on a busy Worker.
+namespace {
+constexpr int kLiveTimers = 100000;
+
+std::chrono::milliseconds liveTimerDelay(int i) {
+  return std::chrono::milliseconds(1 + (i * 7919) % 60000);
+}
+
+class NoopCallback : public TimerWheel::Callback {
+ public:
+  void timeoutExpired() override {}
+};
+} // namespace
+
+BENCHMARK(LibeventTimerArmCancel, n) {
+  dbg::currentLevel = dbg::Level::NONE;
+  struct event_base* base;
+  std::vector<std::unique_ptr<LibeventTimer>> live;
+  std::unique_ptr<LibeventTimer> timer;
+  BENCHMARK_SUSPEND {
+    base = LD_EV(event_base_new)();
+    live.reserve(kLiveTimers);
+    for (int i = 0; i < kLiveTimers; ++i) {
+      live.emplace_back(std::make_unique<LibeventTimer>(base, [] {}));
+      live.back()->activate(liveTimerDelay(i));
+    }
+    timer = std::make_unique<LibeventTimer>(base, [] {});
+  }
+  SCOPE_EXIT {
+    live.clear();
+    timer.reset();
+    LD_EV(event_base_free)(base);
+  };
+
+  for (int i = 0; i < n; ++i) {
+    timer->activate(liveTimerDelay(i));
+    timer->cancel();
+  }
+}
+
+BENCHMARK_RELATIVE(TimerWheelArmCancel, n) {
+  std::unique_ptr<TimerWheel> wheel;
+  std::vector<NoopCallback> live(kLiveTimers);
+  NoopCallback timer;
+  BENCHMARK_SUSPEND {
+    wheel = std::make_unique<TimerWheel>(1ms);
+    for (int i = 0; i < kLiveTimers; ++i) {
+      wheel->schedule(&live[i], liveTimerDelay(i));
+    }
+  }
+  auto now = TimerWheel::Clock::now();
+  for (int i = 0; i < n; ++i) {
+    wheel->schedule(&timer, liveTimerDelay(i), now);
+    timer.cancel();
+  }
+}
+
+// Firing n timers spread over 100ms.
+BENCHMARK(TimerWheelFire, n) {
+  std::unique_ptr<TimerWheel> wheel;
+  std::vector<NoopCallback> timers(n);
+  TimerWheel::Clock::time_point start;
+  BENCHMARK_SUSPEND {
+    start = TimerWheel::Clock::now();
+    wheel = std::make_unique<TimerWheel>(1ms, nullptr, start);
+    for (int i = 0; i < n; ++i) {
+      wheel->schedule(&timers[i], std::chrono::milliseconds(i % 100), start);
+    }
+  }
+  for (int ms = 0; ms <= 100; ++ms) {
+    wheel->advance(start + std::chrono::milliseconds(ms));
+  }
+}
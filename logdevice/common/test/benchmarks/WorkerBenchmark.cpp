@@ -241,6 +241,86 @@ BENCHMARK_RELATIVE(RequestPumpFunctionBenchmarkOnEventBase, n) {
   }
 }
 
+// Many producers hammering a single EventLoop, posting either one function at
+// a time or in batches of `batch_size' through EventLoopTaskQueue::addBatch().
+static void runContendedTaskQueueBenchmark(int n,
+                                           int num_producers,
+                                           size_t batch_size) {
+  std::condition_variable producers_sem;
+  std::mutex producers_sem_mtx;
+  Semaphore sem;
+  std::atomic<int> executed_count{0};
+  std::unique_ptr<EventLoop> loop;
+  std::vector<std::thread> producers;
+  BENCHMARK_SUSPEND {
+    loop = std::make_unique<EventLoop>();
+    loop->getTaskQueue().add([&sem]() { sem.post(); });
+    sem.wait();
+
+    for (int i = 0; i < num_producers; ++i) {
+      producers.emplace_back(
+          [&](int request_count) {
+            {
+              std::unique_lock<std::mutex> _(producers_sem_mtx);
+              sem.post();
+              producers_sem.wait(_);
+            }
+            auto make_func = [&sem, &executed_count, n]() -> Func {
+              return [&sem, &executed_count, n]() {
+                int count = executed_count.fetch_add(
+                    1, std::memory_order::memory_order_relaxed);
+                if (count + 1 == n) {
+                  sem.post();
+                }
+              };
+            };
+            auto& queue = loop->getTaskQueue();
+            if (batch_size <= 1) {
+              for (int j = 0; j < request_count; ++j) {
+                queue.add(make_func());
+              }
+              return;
+            }
+            std::vector<std::pair<Func, int8_t>> batch;
+            for (int j = 0; j < request_count; ++j) {
+              batch.emplace_back(make_func(), folly::Executor::LO_PRI);
+              if (batch.size() == batch_size || j + 1 == request_count) {
+                queue.addBatch(std::move(batch));
+                batch.clear();
+              }
+            }
+          },
+          n / num_producers + (i < (n % num_producers)));
+      sem.wait();
+    }
+  }
+  {
+    std::unique_lock<std::mutex> _(producers_sem_mtx);
+    producers_sem.notify_all();
+  }
+  if (n > 0) {
+    sem.wait();
+  }
+  BENCHMARK_SUSPEND {
+    for (auto& t : producers) {
+      t.join();
+    }
+    loop.reset();
+  }
+}
+
+BENCHMARK(RequestPumpFunction64Producers, n) {
+  runContendedTaskQueueBenchmark(n, 64, 1);
+}
+
+BENCHMARK_RELATIVE(RequestPumpFunction64ProducersBatch16, n) {
+  runContendedTaskQueueBenchmark(n, 64, 16);
+}
+
+BENCHMARK_RELATIVE(RequestPumpFunction64ProducersBatch128, n) {
+  runContendedTaskQueueBenchmark(n, 64, 128);
+}
+
 BENCHMARK(RequestPumpFunctionBenchmarkSequential, n) {
   std::unique_ptr<EventLoop> loop;
   BENCHMARK_SUSPEND {
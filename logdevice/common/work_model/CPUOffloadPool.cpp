@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/work_model/CPUOffloadPool.h"
+
+#include <folly/Conv.h>
+
+#include "logdevice/common/Thread.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/ServerHistograms.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+class CPUOffloadPool::OffloadThread : public Thread {
+ public:
+  OffloadThread(CPUOffloadPool* pool, int num) : pool_(pool), num_(num) {}
+
+ protected:
+  void run() override {
+    pool_->run();
+  }
+
+  std::string threadName() override {
+    return "ld:offload" + folly::to<std::string>(num_);
+  }
+
+ private:
+  CPUOffloadPool* const pool_;
+  const int num_;
+};
+
+CPUOffloadPool::CPUOffloadPool(size_t num_threads,
+                               size_t queue_size,
+                               StatsHolder* stats)
+    : queue_size_(queue_size), stats_(stats) {
+  ld_check(num_threads > 0);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(new OffloadThread(this, i));
+    int rv = threads_.back()->start();
+    ld_check(rv == 0);
+  }
+  ld_info("Started %zu CPU offload threads", num_threads);
+}
+
+CPUOffloadPool::~CPUOffloadPool() {
+  shutdown();
+}
+
+void CPUOffloadPool::add(folly::Func func) {
+  ld_check(func);
+  STAT_INCR(stats_, cpu_offload_tasks_submitted);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shutdown_ && queue_.size() < queue_size_) {
+      queue_.push_back(Task{std::move(func), std::chrono::steady_clock::now()});
+      STAT_INCR(stats_, cpu_offload_tasks_queued);
+    }
+  }
+  if (func) {
+    // Didn't get queued.
+    STAT_INCR(stats_, cpu_offload_tasks_run_inline);
+    execute(func);
+    return;
+  }
+  cv_.notify_one();
+}
+
+void CPUOffloadPool::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      return;
+    }
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+size_t CPUOffloadPool::queueSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+void CPUOffloadPool::run() {
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return shutdown_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        // Shutting down and nothing left to run.
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    STAT_DECR(stats_, cpu_offload_tasks_queued);
+    auto queued_for = std::chrono::steady_clock::now() - task.enqueue_time;
+    HISTOGRAM_ADD(
+        stats_,
+        cpu_offload_queue_latency,
+        std::chrono::duration_cast<std::chrono::microseconds>(queued_for)
+            .count());
+    execute(task.func);
+  }
+}
+
+void CPUOffloadPool::execute(folly::Func& func) {
+  using namespace std::chrono;
+  STAT_INCR(stats_, cpu_offload_tasks_running);
+  auto start_time = steady_clock::now();
+  func();
+  auto usec =
+      duration_cast<microseconds>(steady_clock::now() - start_time).count();
+  STAT_DECR(stats_, cpu_offload_tasks_running);
+  STAT_INCR(stats_, cpu_offload_tasks_executed);
+  STAT_ADD(stats_, cpu_offload_busy_usec, usec);
+  HISTOGRAM_ADD(stats_, cpu_offload_task_duration, usec);
+}
+
+}} // namespace facebook::logdevice
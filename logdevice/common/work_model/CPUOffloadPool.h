@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <folly/Executor.h>
+
+namespace facebook { namespace logdevice {
+
+class StatsHolder;
+
+/**
+ * @file An Executor backed by a small pool of threads dedicated to CPU-bound
+ *       work that Workers would otherwise do inline on their event loop:
+ *       compression, checksumming, serialization of large buffers. Work added
+ *       here must not block or touch Worker state; Workers normally go
+ *       through Worker::offloadCPUWork(), which hands the result back to the
+ *       Worker in submission order.
+ *
+ *       Work that can't be queued, because the queue is full or the pool is
+ *       shutting down, runs inline on the calling thread instead, so add()
+ *       never blocks and never drops work.
+ */
+
+class CPUOffloadPool : public folly::Executor {
+ public:
+  /**
+   * Starts `num_threads' threads.
+   *
+   * @param queue_size  maximum number of pieces of work waiting for a thread
+   */
+  CPUOffloadPool(size_t num_threads, size_t queue_size, StatsHolder* stats);
+
+  ~CPUOffloadPool() override;
+
+  void add(folly::Func func) override;
+
+  /**
+   * Runs the work already queued, then joins the threads. Work added
+   * afterwards runs inline.
+   */
+  void shutdown();
+
+  size_t numThreads() const {
+    return threads_.size();
+  }
+
+  // Number of pieces of work waiting for a thread.
+  size_t queueSize() const;
+
+ private:
+  class OffloadThread;
+
+  struct Task {
+    folly::Func func;
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
+  void run();
+
+  // Runs `func' on the calling thread, timing it like queued work.
+  void execute(folly::Func& func);
+
+  const size_t queue_size_;
+  StatsHolder* stats_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Task> queue_;
+  bool shutdown_{false};
+
+  std::vector<std::unique_ptr<OffloadThread>> threads_;
+};
+
+}} // namespace facebook::logdevice
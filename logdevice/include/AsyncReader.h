@@ -9,6 +9,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "logdevice/include/Record.h"
 #include "logdevice/include/types.h"
@@ -57,6 +58,29 @@ class AsyncReader {
   virtual void
   setRecordCallback(std::function<bool(std::unique_ptr<DataRecord>&)>) = 0;
 
+  /**
+   * Sets a callback that the LogDevice client library will call with batches
+   * of records instead of calling the record callback once per record. Each
+   * batch contains consecutive records of one log, in LSN order, and holds
+   * at most one read window's worth of records (see the
+   * client-read-buffer-size setting). The read window is only slid, letting
+   * storage nodes send more records, after a batch has been accepted.
+   *
+   * The callback should return true if all records of the batch were
+   * consumed; it may move them out of the vector. If it returns false, it
+   * must leave the vector intact (this is asserted in debug builds), and
+   * delivery of the whole batch will be retried after some time or on a
+   * resumeReading() call.
+   *
+   * If set, the callback passed to setRecordCallback() is not called, and
+   * doesn't need to be set. Records written with BufferedWriter are decoded
+   * into individual records (unless doNotDecodeBufferedWrites() is called).
+   *
+   * Only affects subsequent startReading() calls.
+   */
+  virtual void setRecordBatchCallback(
+      std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)>) = 0;
+
   /**
    * Sets a callback that the LogDevice client library will call when a gap
    * record is delivered for this log. A gap record informs the reader about
@@ -185,6 +185,20 @@ class BufferedWriter {
     // will not contain payloads.
     bool destroy_payloads = false;
 
+    // If set to true, batches store all payload lengths in a bit-packed
+    // column ahead of the payloads instead of a varint before each payload.
+    // This makes decoding batches of many small records considerably
+    // cheaper.  Readers older than this option cannot decode such batches,
+    // so only enable it once all consumers of the log have been upgraded.
+    bool payload_lengths_column = false;
+
+    // If non-zero and compression is ZSTD, compress batches with the trained
+    // zstd dictionary that has this ID.  The dictionary must be registered
+    // in every process that writes or reads the log, see the
+    // zstd-dictionaries-dir setting.  If it is not registered in the writer,
+    // batches are compressed without a dictionary.
+    uint32_t zstd_dictionary_id = 0;
+
     // Returns "independent" or "one_at_a_time".
     static std::string modeToString(Mode mode);
     // Returns 0 on success, -1 on error.
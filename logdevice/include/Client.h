@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "logdevice/include/AsyncReader.h"
 #include "logdevice/include/ClientFactory.h"
@@ -99,6 +100,14 @@ typedef std::function<void(Status, uint64_t result)> byte_offset_callback_t;
  */
 typedef std::function<void(Status)> trim_callback_t;
 
+/**
+ * Type of callback that is called once for every log of a non-blocking
+ * trimBatch() request, when trimming that log completes.
+ *
+ * See trimBatch() for docs.
+ */
+typedef std::function<void(logid_t logid, Status)> trim_batch_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking isLogEmpty() request
  * completes.
@@ -107,6 +116,15 @@ typedef std::function<void(Status)> trim_callback_t;
  */
 typedef std::function<void(Status status, bool empty)> is_empty_callback_t;
 
+/**
+ * Type of callback that is called once for every log of a non-blocking
+ * isLogEmptyBatch() request, when the state of that log is determined.
+ *
+ * See isLogEmptyBatch() for docs.
+ */
+typedef std::function<void(logid_t logid, Status status, bool empty)>
+    is_empty_batch_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking dataSize() request
  * completes.
@@ -115,6 +133,15 @@ typedef std::function<void(Status status, bool empty)> is_empty_callback_t;
  */
 typedef std::function<void(Status status, size_t size)> data_size_callback_t;
 
+/**
+ * Type of callback that is called once for every log of a non-blocking
+ * dataSizeBatch() request, when the size of that log's data is determined.
+ *
+ * See dataSizeBatch() for docs.
+ */
+typedef std::function<void(logid_t logid, Status status, size_t size)>
+    data_size_batch_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking getTailLSN() request
  * completes.
@@ -388,6 +415,38 @@ class Client {
                      append_callback_t cb,
                      AppendAttributes attrs = AppendAttributes()) noexcept = 0;
 
+  /**
+   * Appends a batch of records to the same log without blocking. Unlike
+   * BufferedWriter, every payload is stored as its own record with its own
+   * LSN, so readers do not need to decode batches.
+   *
+   * All payloads are validated before anything is sent: if any of them is
+   * rejected, none of the records are appended. Records are handed to the
+   * same client thread and sent in order, so if they all succeed they are
+   * assigned increasing LSNs in the order of `payloads`. The LSNs are not
+   * guaranteed to be contiguous.
+   *
+   * @param logid     unique id of the log to which to append the records
+   *
+   * @param payloads  record payloads, in the order they should be appended
+   *
+   * @param cb        the callback to call; it is called once per record
+   *
+   * @param attrs     additional append attributes, applied to every record.
+   *                  See AppendAttributes
+   *
+   * @return  0 if all records were successfully enqueued for delivery. On
+   *          failure -1 is returned and logdevice::err is set to one of the
+   *          error codes of append(string, ...). If the failure happened
+   *          while enqueueing the records (NOBUFS, SHUTDOWN), callbacks for
+   *          records that were already enqueued are still called.
+   */
+  virtual int
+  appendBatch(logid_t logid,
+              std::vector<std::string> payloads,
+              append_callback_t cb,
+              AppendAttributes attrs = AppendAttributes()) noexcept = 0;
+
   /**
    * Creates a Reader object that can be used to read from one or more logs.
    *
@@ -472,6 +531,31 @@ class Client {
    */
   virtual int trim(logid_t logid, lsn_t lsn, trim_callback_t cb) noexcept = 0;
 
+  /**
+   * Trims many logs at once without blocking. Equivalent to calling trim()
+   * for every (log, lsn) pair, except that TRIM messages for different logs
+   * headed to the same storage node are sent together, and storage nodes
+   * persist the trim points of a batch with one write per shard. Use this
+   * instead of many trim() calls when trimming thousands of logs, e.g. for
+   * retention enforcement driven by the application.
+   *
+   * @param trim_points  logs to trim and the LSN to trim each of them up to
+   *                     (inclusive), see trimSync()
+   * @param cb           called once for every element of `trim_points`, with
+   *                     the log ID and the outcome of trimming that log. See
+   *                     trimSync() for the possible statuses. Callbacks are
+   *                     called one at a time, on the same thread.
+   *
+   * @return  0 if all trims were successfully submitted for processing. On
+   *          failure returns -1 and sets err to INVALID_PARAM if any of the
+   *          log IDs or LSNs is invalid (nothing is trimmed in that case), or
+   *          to NOBUFS or SHUTDOWN if a trim couldn't be submitted. In the
+   *          latter case callbacks for trims that were already submitted are
+   *          still called.
+   */
+  virtual int trimBatch(std::vector<std::pair<logid_t, lsn_t>> trim_points,
+                        trim_batch_callback_t cb) noexcept = 0;
+
   /**
    * Supply a write token.  Without this, writes to any logs configured to
    * require a write token will fail.
@@ -702,6 +786,29 @@ class Client {
    */
   virtual int isLogEmpty(logid_t logid, is_empty_callback_t cb) noexcept = 0;
 
+  /**
+   * Checks whether many logs are empty at once without blocking. Equivalent
+   * to calling isLogEmpty() for every log, except that IS_LOG_EMPTY messages
+   * for different logs headed to the same storage node are sent together.
+   * Use this instead of many isLogEmpty() calls when checking thousands of
+   * logs.
+   *
+   * @param logids  IDs of the logs to check
+   * @param cb      called once for every element of `logids`, with the log
+   *                ID and the outcome for that log. See isLogEmptySync() for
+   *                the possible statuses. Callbacks are called one at a time,
+   *                on the same thread.
+   *
+   * @return  0 if all requests were successfully submitted for processing.
+   *          On failure returns -1 and sets err to INVALID_PARAM if any of the
+   *          log IDs is invalid (nothing is checked in that case), or to
+   *          NOBUFS or SHUTDOWN if a request couldn't be submitted. In the
+   *          latter case callbacks for requests that were already submitted
+   *          are still called.
+   */
+  virtual int isLogEmptyBatch(std::vector<logid_t> logids,
+                              is_empty_batch_callback_t cb) noexcept = 0;
+
   /**
    * Finds the size of stored data for the given log in the given time range,
    * with accuracy as requested. Please note: this is post-batching and
@@ -758,6 +865,33 @@ class Client {
                        DataSizeAccuracy accuracy,
                        data_size_callback_t cb) noexcept = 0;
 
+  /**
+   * Finds the size of stored data of many logs in the same time range at
+   * once without blocking. Equivalent to calling dataSize() for every log,
+   * except that DATA_SIZE messages for different logs headed to the same
+   * storage node are sent together.
+   *
+   * @param logids  IDs of the logs to examine
+   * @param cb      called once for every element of `logids`, with the log
+   *                ID and the outcome for that log. See dataSizeSync() for
+   *                the possible statuses. Callbacks are called one at a time,
+   *                on the same thread.
+   *
+   * See dataSizeSync() for the other parameters.
+   *
+   * @return  0 if all requests were successfully submitted for processing.
+   *          On failure returns -1 and sets err to INVALID_PARAM if any of the
+   *          log IDs is invalid (nothing is examined in that case), or to
+   *          NOBUFS or SHUTDOWN if a request couldn't be submitted. In the
+   *          latter case callbacks for requests that were already submitted
+   *          are still called.
+   */
+  virtual int dataSizeBatch(std::vector<logid_t> logids,
+                            std::chrono::milliseconds start,
+                            std::chrono::milliseconds end,
+                            DataSizeAccuracy accuracy,
+                            data_size_batch_callback_t cb) noexcept = 0;
+
   /**
    * Return the sequence number that points to the tail of log `logid`. The
    * returned LSN is guaranteed to be higher or equal than the LSN of any record
@@ -125,6 +125,24 @@ class ClientFactory {
   // have to call it again before each subsequent call to create().
   ClientFactory& setClientSettings(std::unique_ptr<ClientSettings> v);
 
+  /**
+   * If true, create() returns an existing Client of this process instead of
+   * creating a new one, if there is one created with this option and the same
+   * config URL, cluster name, credentials, timeout, settings and explicit
+   * CSID. Such Clients share worker threads, connections to the cluster,
+   * config subscriptions and stats, which matters for processes that create
+   * many Clients for the same cluster.
+   *
+   * Clients with different credentials or settings never share: credentials
+   * are tied to connections, and most settings to worker threads. Changing
+   * the settings of a shared Client through Client::settings() affects all
+   * its users.
+   */
+  ClientFactory& setSharedRuntime(bool v) {
+    shared_runtime_ = v;
+    return *this;
+  }
+
  private:
   std::string cluster_name_;
   std::chrono::milliseconds timeout_{60000};
@@ -132,6 +150,7 @@ class ClientFactory {
   std::unique_ptr<ClientSettings> client_settings_;
   std::unordered_map<std::string, std::string> string_settings_;
   std::string csid_;
+  bool shared_runtime_{false};
 };
 
 }} // namespace facebook::logdevice
@@ -7,9 +7,11 @@
  */
 #include "logdevice/lib/AsyncReaderImpl.h"
 
+#include <iterator>
 #include <thread>
 
 #include <folly/Memory.h>
+#include <folly/hash/Hash.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/Processor.h"
@@ -31,6 +33,54 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// Decodes buffered write `blob' of record `lsn' into its individual records,
+// appending them to `out'. Doesn't take ownership of `blob'.
+int decodeBlob(Slice blob,
+               logid_t log_id,
+               lsn_t lsn,
+               std::chrono::milliseconds timestamp,
+               RECORD_flags_t flags,
+               const RecordOffset& offsets,
+               std::vector<std::unique_ptr<DataRecord>>* out) {
+  auto decoder = std::make_shared<BufferedWriteDecoderImpl>();
+  std::vector<Payload> payloads;
+  // We use an overload of BufferedWriteDecoderImpl that does not claim
+  // ownership of the input DataRecord, in case the client rejects delivery
+  // and we need to return the record to ClientReadStream intact.
+  int rv = decoder->decodeOne(blob,
+                              payloads,
+                              nullptr,
+                              /* copy_blob_if_uncompressed */ true);
+  if (rv != 0) {
+    err = E::BADMSG;
+    return rv;
+  }
+
+  // Decoding succeeded. Now we need to create a DataRecordOwnsPayload for
+  // each original record.
+  int batch_offset = 0;
+  for (Payload& payload : payloads) {
+    out->emplace_back(new DataRecordOwnsPayload(
+        log_id,
+        std::move(payload),
+        lsn,
+        timestamp,
+        flags & ~RECORD_Header::BUFFERED_WRITER_BLOB,
+        nullptr, // no rebuilding metadata
+        decoder, // shared ownership of the decoder
+        batch_offset++,
+        // Report the same offsets for all subrecords. This may be
+        // confusing but we don't have better options since offsets
+        // currently count the bytes of compressed batches.
+        offsets));
+  }
+  return 0;
+}
+
+} // namespace
+
 AsyncReaderImpl::AsyncReaderImpl(std::shared_ptr<ClientImpl> client,
                                  ssize_t buffer_size)
     : client_(std::move(client)),
@@ -93,6 +143,11 @@ void AsyncReaderImpl::setRecordCallback(
   record_callback_ = std::move(cb);
 }
 
+void AsyncReaderImpl::setRecordBatchCallback(
+    std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)> cb) {
+  record_batch_callback_ = std::move(cb);
+}
+
 void AsyncReaderImpl::setGapCallback(std::function<bool(const GapRecord&)> cb) {
   gap_callback_ = std::move(cb);
 }
@@ -215,10 +270,7 @@ bool AsyncReaderImpl::recordCallbackWrapper(
     }
   }
 
-  DataRecordOwnsPayload* record_with_attributes =
-      static_cast<DataRecordOwnsPayload*>(record.get());
-  if ((record_with_attributes->flags_ & RECORD_Header::BUFFERED_WRITER_BLOB) &&
-      decode_buffered_writes_ && !without_payload_) {
+  if (isBufferedWriteToDecode(*record)) {
     return handleBufferedWrite(record);
   } else {
     bool rv = record_callback_(record);
@@ -233,6 +285,73 @@ bool AsyncReaderImpl::recordCallbackWrapper(
   }
 }
 
+size_t AsyncReaderImpl::recordBatchCallbackWrapper(
+    std::vector<std::unique_ptr<DataRecord>>& records) {
+  if (!record_batch_callback_) {
+    return records.size();
+  }
+
+  // The batch handed to the application, with buffered writes decoded.
+  // Decoded records are new objects; other records are moved from `records'
+  // and need to be moved back if the application rejects the batch.
+  std::vector<std::unique_ptr<DataRecord>> batch;
+  // (index in `batch', index in `records') of the records moved.
+  std::vector<std::pair<size_t, size_t>> moved;
+  batch.reserve(records.size());
+  // Have all large buffered writes in the batch decoded in parallel.
+  prefetchBufferedWrites(records);
+  bool in_progress = false;
+  size_t n = 0;
+  for (; n < records.size(); ++n) {
+    ld_assert(dynamic_cast<DataRecordOwnsPayload*>(records[n].get()) !=
+              nullptr);
+    if (!isBufferedWriteToDecode(*records[n])) {
+      moved.emplace_back(batch.size(), n);
+      batch.push_back(std::move(records[n]));
+    } else if (decodeBufferedWrite(*records[n], &batch) != 0) {
+      // Deliver the records before it first, then the DATALOSS gap for it,
+      // as handleBufferedWrite() does.  If it is still being decoded on a
+      // background thread, we'll get it again once that's done.
+      in_progress = err == E::INPROGRESS;
+      break;
+    }
+  }
+
+  if (n == 0 && in_progress) {
+    return 0;
+  }
+
+  if (n == 0) {
+    ld_check(!records.empty());
+    const DataRecord& record = *records.front();
+    if (!gap_callback_) {
+      return 1;
+    }
+    GapRecord gap(
+        record.logid, GapType::DATALOSS, record.attrs.lsn, record.attrs.lsn);
+    return gap_callback_(gap) ? 1 : 0;
+  }
+
+  if (batch.empty() || record_batch_callback_(batch)) {
+    return n;
+  }
+
+  RATELIMIT_DEBUG(std::chrono::seconds(10),
+                  10,
+                  "Record batch callback rejected %zu records of log %lu "
+                  "starting at %s",
+                  n,
+                  records.front() ? records.front()->logid.val_
+                                  : batch.front()->logid.val_,
+                  lsn_to_string(batch.front()->attrs.lsn).c_str());
+  for (const auto& p : moved) {
+    // Application must not drain the records when it rejects
+    ld_check(batch[p.first] != nullptr);
+    records[p.second] = std::move(batch[p.first]);
+  }
+  return 0;
+}
+
 int AsyncReaderImpl::startReading(logid_t log_id,
                                   lsn_t from,
                                   lsn_t until,
@@ -253,7 +372,7 @@ int AsyncReaderImpl::startReading(logid_t log_id,
     return -1;
   }
 
-  if (!record_callback_) {
+  if (!record_callback_ && !record_batch_callback_) {
     ld_error("called without specifying record callback for log_id %lu",
              log_id.val_);
     err = E::INVALID_PARAM;
@@ -317,6 +436,10 @@ int AsyncReaderImpl::startReading(logid_t log_id,
                                           : HealthChangeType::LOG_UNHEALTHY);
         }
       });
+  if (record_batch_callback_) {
+    deps->setRecordBatchCallback(std::bind(
+        &AsyncReaderImpl::recordBatchCallbackWrapper, this, arg::_1));
+  }
   auto read_stream = std::make_unique<ClientReadStream>(
       rsid,
       log_id,
@@ -355,8 +478,12 @@ int AsyncReaderImpl::startReading(logid_t log_id,
   // thread.
   //
   // Use load-aware worker assignment to avoid pathological cases like
-  // #7621815.
-  worker_id_t worker_id = processor_->selectWorkerLoadAware();
+  // #7621815. With --client-read-stream-sharing, all readers of a log go to
+  // the same worker so that they can share a read stream.
+  worker_id_t worker_id = settings->client_read_stream_sharing
+      ? worker_id_t(folly::hash::twang_mix64(log_id.val_) %
+                    processor_->getWorkerCount(WorkerType::GENERAL))
+      : processor_->selectWorkerLoadAware();
   ReadingHandle handle = {worker_id, rsid};
 
   {
@@ -446,35 +573,186 @@ int AsyncReaderImpl::isConnectionHealthy(logid_t log_id) const {
   return it->second.healthy.load() ? 1 : 0;
 }
 
+bool AsyncReaderImpl::isBufferedWriteToDecode(const DataRecord& record) const {
+  // We know the DataRecord comes from ClientReadStream::deliverRecord() and
+  // must be a DataRecordOwnsPayload.
+  const DataRecordOwnsPayload& record_with_attributes =
+      static_cast<const DataRecordOwnsPayload&>(record);
+  return (record_with_attributes.flags_ &
+          RECORD_Header::BUFFERED_WRITER_BLOB) &&
+      decode_buffered_writes_ && !without_payload_;
+}
+
+int AsyncReaderImpl::decodeBufferedWrite(
+    const DataRecord& record,
+    std::vector<std::unique_ptr<DataRecord>>* out) {
+  if (shouldDecodeInBackground(record)) {
+    int rv = decodeBufferedWriteInBackground(record, out);
+    if (rv <= 0) {
+      return rv;
+    }
+    // Couldn't hand it to a background thread, decode inline.
+  }
+
+  const DataRecordOwnsPayload& record_with_attributes =
+      static_cast<const DataRecordOwnsPayload&>(record);
+  return decodeBlob(Slice(record.payload),
+                    record.logid,
+                    record.attrs.lsn,
+                    record.attrs.timestamp,
+                    record_with_attributes.flags_,
+                    record.attrs.offsets,
+                    out);
+}
+
+bool AsyncReaderImpl::shouldDecodeInBackground(const DataRecord& record) const {
+  const size_t threshold =
+      Worker::settings().buffered_writer_decode_bg_thread_bytes_threshold;
+  if (threshold == 0 || record.payload.size() < threshold) {
+    return false;
+  }
+  // An uncompressed blob would just be copied twice.
+  Compression compression;
+  return BufferedWriteDecoderImpl::getCompression(record, &compression) == 0 &&
+      compression != Compression::NONE;
+}
+
+bool AsyncReaderImpl::startBackgroundDecode(LogState& state,
+                                            const DataRecord& record) {
+  const DataRecordOwnsPayload& record_with_attributes =
+      static_cast<const DataRecordOwnsPayload&>(record);
+  auto decode = std::make_shared<BackgroundDecode>();
+  // The record stays with ClientReadStream, which may free it if reading is
+  // stopped, so the background thread gets its own copy of the blob.
+  bool enqueued = processor_->enqueueToBackground(
+      [decode,
+       processor = processor_,
+       handle = state.handle,
+       log_id = record.logid,
+       lsn = record.attrs.lsn,
+       timestamp = record.attrs.timestamp,
+       flags = record_with_attributes.flags_,
+       offsets = record.attrs.offsets,
+       blob = std::string(static_cast<const char*>(record.payload.data()),
+                          record.payload.size())]() {
+        decode->rv = decodeBlob(Slice(blob.data(), blob.size()),
+                                log_id,
+                                lsn,
+                                timestamp,
+                                flags,
+                                offsets,
+                                &decode->records);
+        decode->done.store(true);
+        // Have ClientReadStream redeliver the record now. If this fails,
+        // the redelivery timer will.
+        std::unique_ptr<Request> req =
+            std::make_unique<ResumeReadingRequest>(handle);
+        processor->postRequest(req);
+      });
+  if (!enqueued) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "Background queue is full, decoding record %lu%s inline",
+                   record.logid.val_,
+                   lsn_to_string(record.attrs.lsn).c_str());
+    return false;
+  }
+  state.background_decodes.emplace(record.attrs.lsn, std::move(decode));
+  WORKER_STAT_INCR(client.buffered_writes_decoded_in_background);
+  return true;
+}
+
+int AsyncReaderImpl::decodeBufferedWriteInBackground(
+    const DataRecord& record,
+    std::vector<std::unique_ptr<DataRecord>>* out) {
+  folly::SharedMutex::ReadHolder guard(log_state_mutex_);
+  auto it = log_states_.find(record.logid);
+  if (it == log_states_.end() ||
+      it->second.handle.worker_id != Worker::onThisThread()->idx_) {
+    // Must have stopped reading the log but word hasn't reached
+    // ClientReadStream yet.  There will be nothing to resume.
+    return 1;
+  }
+  LogState& state = it->second;
+
+  auto decode_it = state.background_decodes.find(record.attrs.lsn);
+  if (decode_it == state.background_decodes.end()) {
+    if (!startBackgroundDecode(state, record)) {
+      return 1;
+    }
+    err = E::INPROGRESS;
+    return -1;
+  }
+  if (!decode_it->second->done.load()) {
+    err = E::INPROGRESS;
+    return -1;
+  }
+
+  std::shared_ptr<BackgroundDecode> decode = std::move(decode_it->second);
+  state.background_decodes.erase(decode_it);
+  if (decode->rv != 0) {
+    err = E::BADMSG;
+    return -1;
+  }
+  std::move(decode->records.begin(),
+            decode->records.end(),
+            std::back_inserter(*out));
+  return 0;
+}
+
+void AsyncReaderImpl::prefetchBufferedWrites(
+    const std::vector<std::unique_ptr<DataRecord>>& records) {
+  if (Worker::settings().buffered_writer_decode_bg_thread_bytes_threshold ==
+      0) {
+    return;
+  }
+
+  folly::SharedMutex::ReadHolder guard(log_state_mutex_);
+  LogState* state = nullptr;
+  for (const auto& record : records) {
+    if (!isBufferedWriteToDecode(*record) ||
+        !shouldDecodeInBackground(*record)) {
+      continue;
+    }
+    if (state == nullptr) {
+      auto it = log_states_.find(record->logid);
+      if (it == log_states_.end() ||
+          it->second.handle.worker_id != Worker::onThisThread()->idx_) {
+        return;
+      }
+      state = &it->second;
+    }
+    if (state->background_decodes.count(record->attrs.lsn) == 0 &&
+        !startBackgroundDecode(*state, *record)) {
+      return;
+    }
+  }
+}
+
 bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
   // Make a copy of attributes, we'll need them after we pass
   // ownership of `record'.
-  DataRecordOwnsPayload* record_with_attributes =
-      static_cast<DataRecordOwnsPayload*>(record.get());
-  const logid_t log_id = record_with_attributes->logid;
-  const DataRecordAttributes attrs = record_with_attributes->attrs;
-  const RECORD_flags_t flags = record_with_attributes->flags_;
-  record_with_attributes = nullptr; // no longer safe
-
-  auto decoder = std::make_shared<BufferedWriteDecoderImpl>();
-  std::vector<Payload> payloads;
-  // We use an overload of BufferedWriteDecoderImpl that does not claim
-  // ownership of the input DataRecord, in case the client rejects delivery
-  // and we need to return the record to ClientReadStream intact.
-  int rv = decoder->decodeOne(*record, payloads);
+  const logid_t log_id = record->logid;
+  const lsn_t lsn = record->attrs.lsn;
+
+  std::vector<std::unique_ptr<DataRecord>> sub_records;
+  int rv = decodeBufferedWrite(*record, &sub_records);
+  if (rv != 0 && err == E::INPROGRESS) {
+    // Being decoded on a background thread, which will resume reading when
+    // done.
+    return false;
+  }
   if (rv != 0) {
     // Whoops, decoding failed. This is tragic and unlikely with checksums
     // but let's generate a DATALOSS gap to inform the client.
     if (!gap_callback_) {
       return true;
     }
-    GapRecord gap(log_id, GapType::DATALOSS, attrs.lsn, attrs.lsn);
+    GapRecord gap(log_id, GapType::DATALOSS, lsn, lsn);
     return gap_callback_(gap);
   }
 
-  // Decoding succeeded. Now we need to create a DataRecordOwnsPayload for
-  // each original record, and call the callback for each one.
-  int batch_offset = 0;
+  // Call the callback for each original record.
   // If the client callback starts rejecting delivery halfway through the
   // batch, we buffer the rest of the batch for redelivery next time
   // ClientReadStream pokes us.
@@ -484,20 +762,7 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
   folly::SharedMutex::ReadHolder guard_map(nullptr);
   LogState* log_state = nullptr;
 
-  for (Payload& payload : payloads) {
-    std::unique_ptr<DataRecord> sub_record(new DataRecordOwnsPayload(
-        log_id,
-        std::move(payload),
-        attrs.lsn,
-        attrs.timestamp,
-        flags & ~RECORD_Header::BUFFERED_WRITER_BLOB,
-        nullptr, // no rebuilding metadata
-        decoder, // shared ownership of the decoder
-        batch_offset++,
-        // Report the same offsets for all subrecords. This may be
-        // confusing but we don't have better options since offsets
-        // currently count the bytes of compressed batches.
-        attrs.offsets));
+  for (std::unique_ptr<DataRecord>& sub_record : sub_records) {
     if (buffer_rest) {
       // The application already rejected a previous record in this batch,
       // just buffer for later redelivery
@@ -509,7 +774,7 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
                       10,
                       "Record callback rejected sub-record of record %lu%s",
                       log_id.val_,
-                      lsn_to_string(attrs.lsn).c_str());
+                      lsn_to_string(lsn).c_str());
       // We'll buffer the rest.
       buffered_delivery_failed_.store(true);
       buffer_rest = true;
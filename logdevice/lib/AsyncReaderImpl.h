@@ -8,6 +8,7 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -30,6 +31,8 @@ class AsyncReaderImpl : public AsyncReader {
   // see AsyncReader.h for all of these functions:
   void
   setRecordCallback(std::function<bool(std::unique_ptr<DataRecord>&)>) override;
+  void setRecordBatchCallback(
+      std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)>) override;
   void setGapCallback(std::function<bool(const GapRecord&)>) override;
   void setDoneCallback(std::function<void(logid_t)>) override;
   void setHealthChangeCallback(
@@ -68,9 +71,46 @@ class AsyncReaderImpl : public AsyncReader {
   // automatic decoding of buffered writes
   bool recordCallbackWrapper(std::unique_ptr<DataRecord>& record);
 
+  // Wrapper around the application-provided batch callback that performs
+  // automatic decoding of buffered writes. Returns the number of records
+  // consumed from the front of `records'.
+  size_t
+  recordBatchCallbackWrapper(std::vector<std::unique_ptr<DataRecord>>& records);
+
   // Handles a record that is a buffered write and needs automatic decoding
   bool handleBufferedWrite(std::unique_ptr<DataRecord>& record);
 
+  // Decodes a buffered write into its individual records, appending them to
+  // `out'. Doesn't take ownership of `record'. Large compressed buffered
+  // writes may be decoded on a background thread (see
+  // decodeBufferedWriteInBackground()); until that is done, this returns -1
+  // with err set to E::INPROGRESS.
+  int decodeBufferedWrite(const DataRecord& record,
+                          std::vector<std::unique_ptr<DataRecord>>* out);
+
+  // Starts decoding `record' on a background thread, or collects the result
+  // of a previously started decoding. Reading is resumed when the decoding
+  // finishes so that ClientReadStream redelivers the record. Returns 1 if the
+  // record should be decoded inline instead.
+  int decodeBufferedWriteInBackground(
+      const DataRecord& record,
+      std::vector<std::unique_ptr<DataRecord>>* out);
+
+  // Starts background decoding of all records in `records' that qualify for
+  // it, so that they are decoded in parallel.
+  void prefetchBufferedWrites(
+      const std::vector<std::unique_ptr<DataRecord>>& records);
+
+  // Does `record' qualify for decoding on a background thread?
+  bool shouldDecodeInBackground(const DataRecord& record) const;
+
+  struct LogState;
+  // Enqueues decoding of `record' to a background thread. Returns false if
+  // the background queue is full.
+  bool startBackgroundDecode(LogState& state, const DataRecord& record);
+
+  bool isBufferedWriteToDecode(const DataRecord& record) const;
+
   // Drains any BufferedWriter-originated records that were decoded by
   // handleBufferedWrite() but not successfully delivered to the application.
   // If there are such records, `batch' is expected to be the full batch
@@ -87,6 +127,8 @@ class AsyncReaderImpl : public AsyncReader {
   Processor* processor_;
 
   std::function<bool(std::unique_ptr<DataRecord>&)> record_callback_;
+  std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)>
+      record_batch_callback_;
   std::function<bool(const GapRecord&)> gap_callback_;
   std::function<void(logid_t)> done_callback_;
   std::function<void(logid_t, HealthChangeType)> health_change_callback_;
@@ -118,6 +160,15 @@ class AsyncReaderImpl : public AsyncReader {
   // linear buffer
   ClientReadStreamBufferType buffer_type_{ClientReadStreamBufferType::CIRCULAR};
 
+  // A buffered write being decoded on a background thread, see
+  // --buffered-writer-decode-bg-thread-bytes-threshold.
+  struct BackgroundDecode {
+    // Set by the background thread after `rv' and `records' are filled in.
+    std::atomic<bool> done{false};
+    int rv = 0;
+    std::vector<std::unique_ptr<DataRecord>> records;
+  };
+
   struct LogState {
     explicit LogState(ReadingHandle handle) : handle(handle) {}
     // ReadingHandle generated when we started reading, used to stop reading
@@ -130,6 +181,9 @@ class AsyncReaderImpl : public AsyncReader {
     // Records that were decoded from a buffered write but could not be
     // immediately delivered (application callback rejected them).
     std::deque<std::unique_ptr<DataRecord>> pre_queue;
+    // Buffered writes being decoded on background threads, by LSN. Only
+    // accessed on the Worker thread reading the log.
+    std::map<lsn_t, std::shared_ptr<BackgroundDecode>> background_decodes;
   };
   // Logs currently being read from
   std::unordered_map<logid_t, LogState, logid_t::Hash> log_states_;
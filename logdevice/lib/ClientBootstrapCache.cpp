@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/lib/ClientBootstrapCache.h"
+
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+
+#include "logdevice/common/configuration/logs/FBuffersLogsConfigCodec.h"
+#include "logdevice/common/configuration/logs/LazyLogsConfigTree.h"
+#include "logdevice/common/configuration/nodes/NodesConfigurationCodec.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+using configuration::nodes::NodesConfiguration;
+using configuration::nodes::NodesConfigurationCodec;
+using logsconfig::FBuffersLogsConfigCodec;
+using logsconfig::LogsConfigTree;
+
+namespace {
+
+bool writeCacheFile(const std::string& path, const std::string& data) {
+  try {
+    boost::filesystem::create_directories(
+        boost::filesystem::path(path).parent_path());
+    // Writes a temporary file and renames it.
+    folly::writeFileAtomic(path, data);
+  } catch (const std::exception& ex) {
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      1,
+                      "Failed to write client bootstrap cache %s: %s",
+                      path.c_str(),
+                      folly::exceptionStr(ex).c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+ClientBootstrapCache::ClientBootstrapCache(const std::string& dir,
+                                           const std::string& cluster_name)
+    : nodes_configuration_path_(dir + "/" + cluster_name + ".nodes"),
+      logs_config_path_(dir + "/" + cluster_name + ".logs") {}
+
+std::shared_ptr<const NodesConfiguration>
+ClientBootstrapCache::loadNodesConfiguration() {
+  std::string data;
+  if (!folly::readFile(nodes_configuration_path_.c_str(), data)) {
+    return nullptr;
+  }
+  auto config = NodesConfigurationCodec::deserialize(folly::StringPiece(data));
+  if (!config) {
+    ld_warning("Ignoring unreadable NodesConfiguration cached in %s",
+               nodes_configuration_path_.c_str());
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  nodes_configuration_version_ =
+      std::max(nodes_configuration_version_, config->getVersion().val());
+  return config;
+}
+
+std::unique_ptr<LogsConfigTree>
+ClientBootstrapCache::loadLogsConfigTree(const std::string& delimiter) {
+  // The version of the tree followed by the tree as serialized in snapshots.
+  std::string data;
+  lsn_t version;
+  if (!folly::readFile(logs_config_path_.c_str(), data) ||
+      data.size() < sizeof(version)) {
+    return nullptr;
+  }
+  memcpy(&version, data.data(), sizeof(version));
+  auto tree = FBuffersLogsConfigCodec::deserialize<LogsConfigTree>(
+      Payload(data.data() + sizeof(version), data.size() - sizeof(version)),
+      delimiter);
+  if (!tree) {
+    ld_warning("Ignoring unreadable LogsConfig cached in %s",
+               logs_config_path_.c_str());
+    return nullptr;
+  }
+  tree->setVersion(version);
+  std::lock_guard<std::mutex> lock(mutex_);
+  logs_config_version_ = std::max(logs_config_version_, version);
+  return tree;
+}
+
+void ClientBootstrapCache::storeNodesConfiguration(
+    const NodesConfiguration& config) {
+  const uint64_t version = config.getVersion().val();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (version <= nodes_configuration_version_) {
+    return;
+  }
+  std::string data = NodesConfigurationCodec::serialize(config);
+  if (!data.empty() && writeCacheFile(nodes_configuration_path_, data)) {
+    nodes_configuration_version_ = version;
+  }
+}
+
+void ClientBootstrapCache::storeLogsConfigTree(const LogsConfigTree& tree) {
+  const lsn_t version = tree.version();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (version <= logs_config_version_) {
+    return;
+  }
+  std::unique_ptr<LogsConfigTree> materialized;
+  if (tree.isLazy()) {
+    materialized = tree.getLazyTree()->materialize();
+  }
+  PayloadHolder payload = FBuffersLogsConfigCodec::serialize(
+      materialized ? *materialized : tree, false);
+  if (!payload.valid()) {
+    return;
+  }
+  std::string data(sizeof(version), '\0');
+  memcpy(&data[0], &version, sizeof(version));
+  Payload p = payload.getPayload();
+  data.append(static_cast<const char*>(p.data()), p.size());
+  if (writeCacheFile(logs_config_path_, data)) {
+    logs_config_version_ = version;
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "logdevice/common/configuration/logs/LogsConfigTree.h"
+#include "logdevice/common/configuration/nodes/NodesConfiguration.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * On-disk cache of the last NodesConfiguration and LogsConfig tree a client
+ * saw for a cluster, see --client-bootstrap-cache-dir. A client that finds
+ * them there starts with them instead of waiting for them to be fetched.
+ * NodesConfigurationManager and LogsConfigManager then replace them with the
+ * current versions in the background.
+ *
+ * Files are replaced atomically, so clients of the same cluster sharing the
+ * directory, even in different processes, at worst overwrite each other's
+ * update with an older one.
+ */
+class ClientBootstrapCache {
+ public:
+  ClientBootstrapCache(const std::string& dir, const std::string& cluster_name);
+
+  // @return nullptr if nothing is cached or the file can't be parsed.
+  std::shared_ptr<const configuration::nodes::NodesConfiguration>
+  loadNodesConfiguration();
+
+  // @return nullptr if nothing is cached or the file can't be parsed.
+  std::unique_ptr<logsconfig::LogsConfigTree>
+  loadLogsConfigTree(const std::string& delimiter);
+
+  // These do nothing if a version at least as new was loaded or stored by
+  // this object. Thread safe.
+  void storeNodesConfiguration(
+      const configuration::nodes::NodesConfiguration& config);
+  void storeLogsConfigTree(const logsconfig::LogsConfigTree& tree);
+
+ private:
+  const std::string nodes_configuration_path_;
+  const std::string logs_config_path_;
+
+  std::mutex mutex_;
+  uint64_t nodes_configuration_version_{0};
+  lsn_t logs_config_version_{LSN_INVALID};
+};
+
+}} // namespace facebook::logdevice
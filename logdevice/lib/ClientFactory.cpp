@@ -7,9 +7,12 @@
  */
 #include "logdevice/include/ClientFactory.h"
 
+#include <mutex>
+
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/String.h>
 
 #include "logdevice/common/ConfigInit.h"
 #include "logdevice/common/NodesConfigurationInit.h"
@@ -20,6 +23,7 @@
 #include "logdevice/common/configuration/nodes/NodesConfigurationManagerFactory.h"
 #include "logdevice/common/protocol/HELLO_Message.h"
 #include "logdevice/common/settings/SSLSettingValidation.h"
+#include "logdevice/lib/ClientBootstrapCache.h"
 #include "logdevice/lib/ClientImpl.h"
 #include "logdevice/lib/ClientPluginHelper.h"
 #include "logdevice/lib/ClientProcessor.h"
@@ -30,6 +34,49 @@ namespace facebook { namespace logdevice {
 
 namespace {
 
+// Clients created with ClientFactory::setSharedRuntime(true), by the key that
+// create() computes from everything they were created with. Expired entries
+// are replaced on the next create() with the same key.
+struct SharedClients {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::weak_ptr<Client>> clients;
+};
+
+SharedClients& sharedClients() {
+  // Leaked, so that Clients destroyed during static destruction don't
+  // outlive it.
+  static SharedClients* shared = new SharedClients();
+  return *shared;
+}
+
+std::shared_ptr<Client> findSharedClient(const std::string& key) {
+  auto& shared = sharedClients();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  auto it = shared.clients.find(key);
+  if (it == shared.clients.end()) {
+    return nullptr;
+  }
+  auto client = it->second.lock();
+  if (!client) {
+    shared.clients.erase(it);
+  }
+  return client;
+}
+
+// Registers `client' unless another thread registered one with the same key
+// in the meantime, in which case that one is returned instead.
+std::shared_ptr<Client> registerSharedClient(const std::string& key,
+                                             std::shared_ptr<Client> client) {
+  auto& shared = sharedClients();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  auto& entry = shared.clients[key];
+  if (auto existing = entry.lock()) {
+    return existing;
+  }
+  entry = client;
+  return client;
+}
+
 bool validateSSLSettings(
     std::shared_ptr<const NodesConfiguration> nodes_configuration,
     std::shared_ptr<const Settings> settings) {
@@ -117,6 +164,9 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
   auto settings_updater = impl_settings->getSettingsUpdater();
 
   auto plugin_registry = impl_settings->getPluginRegistry();
+  // Clients with plugins supplied by the caller only share with each other.
+  const uintptr_t caller_plugins =
+      reinterpret_cast<uintptr_t>(plugin_registry.get());
   if (!plugin_registry) {
     plugin_registry =
         std::make_shared<PluginRegistry>(getClientPluginProviders());
@@ -131,6 +181,25 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
     return nullptr;
   }
 
+  std::string shared_key;
+  if (shared_runtime_) {
+    // An empty CSID is generated below, so it doesn't prevent sharing.
+    std::vector<std::string> parts{config_url,
+                                   cluster_name_,
+                                   credentials_,
+                                   csid_,
+                                   std::to_string(timeout_.count()),
+                                   std::to_string(caller_plugins)};
+    for (auto& kv : impl_settings->getAll()) {
+      parts.push_back(kv.first + "=" + kv.second);
+    }
+    shared_key = folly::join('\0', parts);
+    if (auto client = findSharedClient(shared_key)) {
+      ld_info("Reusing shared Client for config %s", config_url.c_str());
+      return client;
+    }
+  }
+
   auto update_settings = [settings_updater](ServerConfig& config) -> bool {
     auto settings = config.getClientSettingsConfig();
 
@@ -199,13 +268,31 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
     NodesConfigurationInit nodes_cfg_init(
         std::move(ncs), impl_settings->getSettings());
     bool success = false;
-    if (use_server_ncs) {
+    const auto& cache_dir =
+        impl_settings->getSettings()->client_bootstrap_cache_dir;
+    if (use_server_ncs && !cache_dir.empty() &&
+        impl_settings->getSettings()->enable_nodes_configuration_manager) {
+      // NodesConfigurationManager will replace the cached NodesConfiguration
+      // with the current one in the background.
+      auto cached =
+          ClientBootstrapCache(
+              cache_dir, config->getServerConfig()->getClusterName())
+              .loadNodesConfiguration();
+      if (cached) {
+        ld_info("Starting with NodesConfiguration version %lu from the "
+                "bootstrap cache",
+                cached->getVersion().val());
+        config->updateableNCMNodesConfiguration()->update(std::move(cached));
+        success = true;
+      }
+    }
+    if (!success && use_server_ncs) {
       ld_info("Trying to obtain initial NodesConfiguration from a LogDevice "
               "server...");
       success = nodes_cfg_init.init(config->updateableNCMNodesConfiguration(),
                                     plugin_registry,
                                     nodes_configuration_seed);
-    } else if (use_zk_ncs) {
+    } else if (!success && use_zk_ncs) {
       ld_info("Trying to obtain initial NodesConfiguration from Zookeeper...");
       success = nodes_cfg_init.initWithoutProcessor(
           config->updateableNCMNodesConfiguration());
@@ -287,6 +374,9 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
               : cluster_name_.c_str(),
           config_url.c_str());
 
+  if (shared_runtime_) {
+    return registerSharedClient(shared_key, std::shared_ptr<Client>(impl));
+  }
   return std::shared_ptr<Client>(impl);
 }
 
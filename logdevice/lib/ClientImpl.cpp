@@ -13,6 +13,8 @@
 #include <boost/algorithm/string.hpp>
 #include <folly/Memory.h>
 #include <folly/Random.h>
+#include <folly/executors/GlobalExecutor.h>
+#include <folly/hash/Hash.h>
 
 #include "logdevice/common/AppendRequest.h"
 #include "logdevice/common/ClientAPIHitsTracer.h"
@@ -25,20 +27,24 @@
 #include "logdevice/common/EpochMetaDataMap.h"
 #include "logdevice/common/FindKeyRequest.h"
 #include "logdevice/common/GetHeadAttributesRequest.h"
+#include "logdevice/common/HashBasedSequencerLocator.h"
 #include "logdevice/common/IsLogEmptyRequest.h"
 #include "logdevice/common/LogsConfigApiRequest.h"
 #include "logdevice/common/NoopTraceLogger.h"
 #include "logdevice/common/PrincipalParser.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/ReaderImpl.h"
+#include "logdevice/common/Sender.h"
 #include "logdevice/common/Semaphore.h"
 #include "logdevice/common/StatsCollectionThread.h"
 #include "logdevice/common/SyncSequencerRequest.h"
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/ThreadID.h"
 #include "logdevice/common/TrimRequest.h"
+#include "logdevice/common/Worker.h"
 #include "logdevice/common/client_read_stream/AllClientReadStreams.h"
 #include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
 #include "logdevice/common/configuration/TextConfigUpdater.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/configuration/logs/LogsConfigDeltaTypes.h"
@@ -49,6 +55,7 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/plugin/TraceLoggerFactory.h"
 #include "logdevice/common/plugin/ZookeeperClientFactory.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/common/settings/UpdateableSettings.h"
 #include "logdevice/common/stats/Stats.h"
@@ -57,6 +64,7 @@
 #include "logdevice/include/Err.h"
 #include "logdevice/include/Record.h"
 #include "logdevice/lib/AsyncReaderImpl.h"
+#include "logdevice/lib/ClientBootstrapCache.h"
 #include "logdevice/lib/ClientProcessor.h"
 #include "logdevice/lib/ClientSettingsImpl.h"
 #include "logdevice/lib/ClusterAttributesImpl.h"
@@ -244,6 +252,8 @@ ClientImpl::ClientImpl(std::string cluster_name,
     }
   }
 
+  initBootstrapCache();
+
   if (!LogsConfigManager::createAndAttach(
           *processor_, false /* is_writable */)) {
     err = E::INVALID_CONFIG;
@@ -309,6 +319,8 @@ ClientImpl::ClientImpl(std::string cluster_name,
 
   settings_subscription_handle_ =
       settings.subscribeToUpdates([this] { this->updateStatsSettings(); });
+
+  prewarmConnections();
 }
 
 ClientImpl::~ClientImpl() {
@@ -404,6 +416,37 @@ std::pair<Status, NodeID> ClientImpl::appendBuffered(
   return std::make_pair(rv == 0 ? E::OK : err, NodeID());
 }
 
+worker_id_t ClientImpl::selectAppendWorker(logid_t logid) const {
+  const size_t per_sequencer =
+      settings_->getSettings()->append_workers_per_sequencer;
+  if (per_sequencer == 0) {
+    return worker_id_t{-1};
+  }
+
+  // Use the sequencer that the log maps to when all sequencer nodes are up,
+  // ignoring sequencer affinity, which would need the log's attributes.
+  // Getting it wrong only costs batching efficiency: AppendRequest locates
+  // the actual sequencer on the Worker either way.
+  auto nodes_configuration = processor_->getNodesConfiguration();
+  NodeID sequencer;
+  if (!nodes_configuration ||
+      HashBasedSequencerLocator::locateSequencer(logid,
+                                                 nodes_configuration.get(),
+                                                 /* log_attrs */ nullptr,
+                                                 /* cs */ nullptr,
+                                                 &sequencer) != 0) {
+    return worker_id_t{-1};
+  }
+
+  const int nworkers = processor_->getWorkerCount(WorkerType::GENERAL);
+  ld_check(nworkers > 0);
+  const uint64_t first =
+      folly::hash::twang_mix64(static_cast<uint64_t>(sequencer.index()));
+  const uint64_t offset =
+      logid.val_ % std::min<uint64_t>(per_sequencer, nworkers);
+  return worker_id_t((first + offset) % nworkers);
+}
+
 int ClientImpl::postAppend(std::unique_ptr<AppendRequest> req_append) {
   if (append_error_injector_) {
     // with the set probability of the error injector, maybe replace the request
@@ -538,6 +581,53 @@ int ClientImpl::append(logid_t logid,
                 nullptr);
 }
 
+int ClientImpl::appendBatch(logid_t logid,
+                            std::vector<std::string> payloads,
+                            append_callback_t cb,
+                            AppendAttributes attrs) noexcept {
+  if (payloads.empty()) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+
+  // Validate every payload before posting anything so that the batch is
+  // either enqueued in full or rejected in full.
+  for (const auto& payload : payloads) {
+    if (!checkAppend(logid, payload.size())) {
+      return -1;
+    }
+  }
+
+  std::vector<std::unique_ptr<AppendRequest>> reqs;
+  reqs.reserve(payloads.size());
+  const worker_id_t worker = selectAppendWorker(logid);
+  for (auto& payload : payloads) {
+    auto req =
+        prepareRequest(logid, std::move(payload), cb, attrs, worker, nullptr);
+    if (!req) {
+      return -1;
+    }
+    reqs.push_back(std::move(req));
+  }
+
+  // All requests are posted from this thread for the same log, so they map
+  // to the same Worker (see AppendRequest::getThreadAffinity() and
+  // selectAppendWorker()) and are sent to the sequencer in order.
+  for (auto& req : reqs) {
+    if (postAppend(std::move(req)) != 0) {
+      // err set by postAppend(). Requests that were not posted are destroyed
+      // without invoking the callback.
+      for (auto& unposted : reqs) {
+        if (unposted) {
+          unposted->setFailedToPost();
+        }
+      }
+      return -1;
+    }
+  }
+  return 0;
+}
+
 lsn_t ClientImpl::appendSync(logid_t logid,
                              const Payload& payload,
                              AppendAttributes attrs,
@@ -751,16 +841,18 @@ void ClientImpl::getLocalLogGroupById(const logid_t logid,
   ld_assert(hasFullyLoadedLocalLogsConfig());
   auto logs_config = config_->getLocalLogsConfig();
 
-  auto lid = logs_config->getLogGroupInDirectoryByIDRaw(logid);
-  if (lid == nullptr) {
+  // Doesn't deserialize the LogsConfigTree if it is lazy.
+  auto group = logs_config->getLogGroupByIDShared(logid);
+  folly::Optional<std::string> full_ns = logs_config->getLogGroupPath(logid);
+  if (group == nullptr || !full_ns.hasValue()) {
     cb(Status::NOTFOUND, nullptr);
     return;
   }
 
-  std::string full_ns = lid->getFullyQualifiedName();
   std::unique_ptr<client::LogGroupImpl> lg =
       std::make_unique<client::LogGroupImpl>(
-          lid->log_group, std::move(full_ns), logs_config->getVersion());
+          std::move(group), std::move(full_ns.value()),
+          logs_config->getVersion());
   cb(Status::OK, std::move(lg));
 }
 
@@ -1521,6 +1613,57 @@ int ClientImpl::trim(logid_t logid, lsn_t lsn, trim_callback_t cb) noexcept {
   ;
 }
 
+int ClientImpl::trimBatch(std::vector<std::pair<logid_t, lsn_t>> trim_points,
+                          trim_batch_callback_t cb) noexcept {
+  if (trim_points.empty()) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  for (const auto& trim_point : trim_points) {
+    if (trim_point.first == LOGID_INVALID ||
+        trim_point.second == LSN_INVALID || trim_point.second >= LSN_MAX) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+  }
+
+  // Run all TrimRequests on the same Worker, so that its TrimBatcher can
+  // send the TRIMs headed to the same storage node together.
+  const worker_id_t worker = processor_->selectWorkerLoadAware();
+  const auto timeout =
+      settings_->getSettings()->meta_api_timeout.value_or(timeout_);
+
+  std::vector<std::unique_ptr<Request>> reqs;
+  reqs.reserve(trim_points.size());
+  for (const auto& trim_point : trim_points) {
+    const logid_t logid = trim_point.first;
+    const lsn_t lsn = trim_point.second;
+    auto cb_wrapper = [logid, lsn, cb, start = SteadyClock::now()](
+                          const TrimRequest& req, Status st) {
+      Worker* w = Worker::onThisThread();
+      if (w) {
+        w->processor_->api_hits_tracer_->traceTrim(
+            msec_since(start), logid, lsn, req.getFailedShards(st), st);
+      }
+      cb(logid, st);
+    };
+    auto req = std::make_unique<TrimRequest>(
+        bridge_.get(), logid, lsn, timeout, cb_wrapper);
+    req->setTargetWorker(worker);
+    req->setBatchable();
+    reqs.push_back(std::move(req));
+  }
+
+  for (auto& req : reqs) {
+    if (processor_->postRequest(req) != 0) {
+      // err set by postRequest(). Requests that were not posted are
+      // destroyed without invoking the callback.
+      return -1;
+    }
+  }
+  return 0;
+}
+
 struct FindTimeGate {
   // called by FindKeyRequest when request processing completes or
   // timeout expires
@@ -1719,6 +1862,58 @@ int ClientImpl::isLogEmpty(logid_t logid, is_empty_callback_t cb) noexcept {
   return processor_->postRequest(req);
 }
 
+int ClientImpl::isLogEmptyBatch(std::vector<logid_t> logids,
+                                is_empty_batch_callback_t cb) noexcept {
+  if (logids.empty()) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  for (logid_t logid : logids) {
+    if (logid == LOGID_INVALID) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+  }
+
+  // Run all IsLogEmptyRequests on the same Worker, so that its
+  // LogQueryBatcher can send the IS_LOG_EMPTYs headed to the same storage
+  // node together.
+  const worker_id_t worker = processor_->selectWorkerLoadAware();
+  const auto settings = settings_->getSettings();
+  const auto timeout = settings->meta_api_timeout.value_or(timeout_);
+
+  std::vector<std::unique_ptr<Request>> reqs;
+  reqs.reserve(logids.size());
+  for (logid_t logid : logids) {
+    auto cb_wrapper = [cb, logid, start = SteadyClock::now()](
+                          const IsLogEmptyRequest& req, Status st, bool empty) {
+      Worker* w = Worker::onThisThread();
+      if (w) {
+        w->processor_->api_hits_tracer_->traceIsLogEmpty(
+            msec_since(start), logid, req.getFailedShards(st), st, empty);
+      }
+      cb(logid, st, empty);
+    };
+    auto req = std::make_unique<IsLogEmptyRequest>(
+        logid,
+        timeout,
+        cb_wrapper,
+        settings->client_is_log_empty_grace_period);
+    req->setWorkerThread(worker);
+    req->setBatchable();
+    reqs.push_back(std::move(req));
+  }
+
+  for (auto& req : reqs) {
+    if (processor_->postRequest(req) != 0) {
+      // err set by postRequest(). Requests that were not posted are
+      // destroyed without invoking the callback.
+      return -1;
+    }
+  }
+  return 0;
+}
+
 namespace {
 struct DataSizeGate {
   void operator()(Status status, size_t size) {
@@ -1798,6 +1993,69 @@ int ClientImpl::dataSize(logid_t logid,
   return processor_->postRequest(req);
 }
 
+int ClientImpl::dataSizeBatch(std::vector<logid_t> logids,
+                              std::chrono::milliseconds start,
+                              std::chrono::milliseconds end,
+                              DataSizeAccuracy accuracy,
+                              data_size_batch_callback_t cb) noexcept {
+  if (logids.empty()) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  for (logid_t logid : logids) {
+    if (logid == LOGID_INVALID) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+  }
+
+  // Run all DataSizeRequests on the same Worker, so that its LogQueryBatcher
+  // can send the DATA_SIZEs headed to the same storage node together.
+  const worker_id_t worker = processor_->selectWorkerLoadAware();
+  const auto timeout =
+      settings_->getSettings()->meta_api_timeout.value_or(timeout_);
+
+  std::vector<std::unique_ptr<Request>> reqs;
+  reqs.reserve(logids.size());
+  for (logid_t logid : logids) {
+    auto cb_wrapper = [cb,
+                       logid,
+                       start,
+                       end,
+                       accuracy,
+                       request_start_time = SteadyClock::now()](
+                          const DataSizeRequest& req, Status st, size_t size) {
+      Worker* w = Worker::onThisThread();
+      if (w) {
+        w->processor_->api_hits_tracer_->traceDataSize(
+            msec_since(request_start_time),
+            logid,
+            start,
+            end,
+            accuracy,
+            req.getFailedShards(st),
+            st,
+            size);
+      }
+      cb(logid, st, size);
+    };
+    auto req = std::make_unique<DataSizeRequest>(
+        logid, start, end, accuracy, cb_wrapper, timeout);
+    req->setWorkerThread(worker);
+    req->setBatchable();
+    reqs.push_back(std::move(req));
+  }
+
+  for (auto& req : reqs) {
+    if (processor_->postRequest(req) != 0) {
+      // err set by postRequest(). Requests that were not posted are
+      // destroyed without invoking the callback.
+      return -1;
+    }
+  }
+  return 0;
+}
+
 lsn_t ClientImpl::getTailLSNSync(logid_t logid) noexcept {
   lsn_t tail_lsn = LSN_INVALID;
   Status status = E::OK;
@@ -2208,6 +2466,9 @@ ClientImpl::prepareRequest(logid_t logid,
       settings_->getSettings()->append_timeout.value_or(timeout_),
       std::move(cb));
 
+  if (target_worker.val_ < 0) {
+    target_worker = selectAppendWorker(logid);
+  }
   if (target_worker.val_ > -1) {
     ld_check(target_worker.val_ <
              processor_->getWorkerCount(WorkerType::GENERAL));
@@ -2251,6 +2512,101 @@ void ClientImpl::updateStatsSettings() {
   }
 }
 
+void ClientImpl::initBootstrapCache() {
+  const Settings& settings = *settings_->getSettings();
+  if (settings.client_bootstrap_cache_dir.empty()) {
+    return;
+  }
+  auto server_config = config_->getServerConfig();
+  const std::string& delimiter = server_config->getNamespaceDelimiter();
+  bootstrap_cache_ = std::make_shared<ClientBootstrapCache>(
+      settings.client_bootstrap_cache_dir, server_config->getClusterName());
+
+  const bool use_logsconfig_manager = settings.enable_logsconfig_manager &&
+      !settings.on_demand_logs_config && !settings.force_on_demand_logs_config;
+  if (use_logsconfig_manager && !config_->getLogsConfig()) {
+    auto tree = bootstrap_cache_->loadLogsConfigTree(delimiter);
+    if (tree) {
+      // Published the same way as by LogsConfigManager, which replaces it
+      // once it has read the current version.
+      auto logs_config = std::make_shared<LocalLogsConfig>();
+      logs_config->setInternalLogsConfig(
+          server_config->getInternalLogsConfig());
+      logs_config->setNamespaceDelimiter(delimiter);
+      logs_config->markAsFullyLoaded();
+      logs_config->setLogsConfigTree(std::move(tree));
+      ld_info("Starting with LogsConfig version %lu from the bootstrap cache",
+              logs_config->getVersion());
+      config_->updateableLogsConfig()->update(std::move(logs_config));
+    }
+  }
+
+  // Configs are written to disk on the global CPU executor rather than on
+  // the thread publishing them. The callbacks must not hold a reference to
+  // the UpdateableConfig they are subscribed to.
+  auto cache = bootstrap_cache_;
+  auto updateable_nodes_config = config_->updateableNCMNodesConfiguration();
+  UpdateableNodesConfiguration* raw_nodes_config =
+      updateable_nodes_config.get();
+  bootstrap_cache_nodes_subscription_ =
+      updateable_nodes_config->subscribeToUpdates([cache, raw_nodes_config] {
+        auto nodes_config = raw_nodes_config->get();
+        if (nodes_config) {
+          folly::getCPUExecutor()->add([cache, nodes_config] {
+            cache->storeNodesConfiguration(*nodes_config);
+          });
+        }
+      });
+  auto updateable_logs_config = config_->updateableLogsConfig();
+  UpdateableLogsConfig* raw_logs_config = updateable_logs_config.get();
+  bootstrap_cache_logs_subscription_ =
+      updateable_logs_config->subscribeToUpdates([cache, raw_logs_config] {
+        auto logs_config =
+            std::dynamic_pointer_cast<LocalLogsConfig>(raw_logs_config->get());
+        if (logs_config && logs_config->isFullyLoaded() &&
+            logs_config->hasLogsConfigTree()) {
+          folly::getCPUExecutor()->add([cache, logs_config] {
+            cache->storeLogsConfigTree(logs_config->getLogsConfigTree());
+          });
+        }
+      });
+}
+
+void ClientImpl::prewarmConnections() {
+  const auto& logs = settings_->getSettings()->prewarm_connections_for_logs;
+  auto nodes_configuration = processor_->getNodesConfiguration();
+  if (logs.empty() || !nodes_configuration) {
+    return;
+  }
+  const int nworkers = processor_->getWorkerCount(WorkerType::GENERAL);
+  for (logid_t logid : logs) {
+    NodeID sequencer;
+    if (HashBasedSequencerLocator::locateSequencer(logid,
+                                                   nodes_configuration.get(),
+                                                   /* log_attrs */ nullptr,
+                                                   /* cs */ nullptr,
+                                                   &sequencer) != 0) {
+      continue;
+    }
+    // Connections are per Worker, so connect from the Worker(s) that appends
+    // to this log will be posted to.
+    worker_id_t worker = selectAppendWorker(logid);
+    for (int i = 0; i < nworkers; ++i) {
+      if (worker.val_ >= 0 && worker.val_ != i) {
+        continue;
+      }
+      std::unique_ptr<Request> req = FuncRequest::make(
+          worker_id_t(i), WorkerType::GENERAL, RequestType::MISC, [sequencer] {
+            // Errors are ignored: the first append will retry the connection.
+            Worker::onThisThread()->sender().connect(
+                sequencer, /* allow_unencrypted */ false);
+          });
+      processor_->postRequest(req);
+    }
+  }
+  ld_info("Prewarming connections to sequencers of %zu logs", logs.size());
+}
+
 void ClientImpl::setAppendErrorInjector(
     folly::Optional<AppendErrorInjector> injector) {
   append_error_injector_ = injector;
@@ -26,6 +26,7 @@
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Client.h"
+#include "logdevice/include/ConfigSubscriptionHandle.h"
 #include "logdevice/include/types.h"
 #include "logdevice/lib/AppendErrorInjector.h"
 
@@ -41,6 +42,7 @@ class NodesConfigurationManager;
 
 class AppendRequest;
 class ClientAPIHitsTracer;
+class ClientBootstrapCache;
 class ClientBridgeImpl;
 class ClientEventTracer;
 class ClientProcessor;
@@ -109,6 +111,12 @@ class ClientImpl : public Client,
              append_callback_t cb,
              AppendAttributes attrs = AppendAttributes()) noexcept override;
 
+  int
+  appendBatch(logid_t logid,
+              std::vector<std::string> payloads,
+              append_callback_t cb,
+              AppendAttributes attrs = AppendAttributes()) noexcept override;
+
   int append(logid_t logid,
              std::string payload,
              append_callback_t cb,
@@ -166,6 +174,9 @@ class ClientImpl : public Client,
 
   int trim(logid_t logid, lsn_t lsn, trim_callback_t cb) noexcept override;
 
+  int trimBatch(std::vector<std::pair<logid_t, lsn_t>> trim_points,
+                trim_batch_callback_t cb) noexcept override;
+
   void addWriteToken(std::string token) noexcept override {
     folly::SharedMutex::WriteHolder guard(write_tokens_mutex_);
     write_tokens_.insert(token);
@@ -193,6 +204,9 @@ class ClientImpl : public Client,
 
   int isLogEmpty(logid_t logid, is_empty_callback_t cb) noexcept override;
 
+  int isLogEmptyBatch(std::vector<logid_t> logids,
+                      is_empty_batch_callback_t cb) noexcept override;
+
   int dataSizeSync(logid_t logid,
                    std::chrono::milliseconds start,
                    std::chrono::milliseconds end,
@@ -203,6 +217,11 @@ class ClientImpl : public Client,
                std::chrono::milliseconds end,
                DataSizeAccuracy accuracy,
                data_size_callback_t cb) noexcept override;
+  int dataSizeBatch(std::vector<logid_t> logids,
+                    std::chrono::milliseconds start,
+                    std::chrono::milliseconds end,
+                    DataSizeAccuracy accuracy,
+                    data_size_batch_callback_t cb) noexcept override;
 
   lsn_t getTailLSNSync(logid_t logid) noexcept override;
 
@@ -454,6 +473,11 @@ class ClientImpl : public Client,
   // Proxy for Processor::postRequest() with careful error handling
   int postAppend(std::unique_ptr<AppendRequest> req);
 
+  // With --append-workers-per-sequencer, picks the Worker that appends to
+  // `logid` are posted to. Returns worker_id_t{-1} to leave the choice to
+  // AppendRequest::getThreadAffinity().
+  worker_id_t selectAppendWorker(logid_t logid) const;
+
  private:
   // Used to validate that the `cluster_name` does not change across updates to
   // the config.
@@ -466,6 +490,14 @@ class ClientImpl : public Client,
 
   void updateStatsSettings();
 
+  // Starts from the configs cached in --client-bootstrap-cache-dir, if any,
+  // and keeps the cache up to date. Must be called before LogsConfigManager
+  // is started.
+  void initBootstrapCache();
+
+  // Connects to the sequencer nodes of --prewarm-connections-for-logs.
+  void prewarmConnections();
+
   int getLocalDirectory(const std::string& path,
                         get_directory_callback_t cb) noexcept;
 
@@ -531,6 +563,11 @@ class ClientImpl : public Client,
   UpdateableSettings<Settings>::SubscriptionHandle
       settings_subscription_handle_;
 
+  // see initBootstrapCache()
+  std::shared_ptr<ClientBootstrapCache> bootstrap_cache_;
+  ConfigSubscriptionHandle bootstrap_cache_nodes_subscription_;
+  ConfigSubscriptionHandle bootstrap_cache_logs_subscription_;
+
   folly::Optional<AppendErrorInjector> append_error_injector_;
 
   // OpenTracing tracer for client operations (append)
@@ -8,6 +8,7 @@
 #include "logdevice/lib/ClientMessageDispatch.h"
 
 #include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
 #include "logdevice/common/protocol/STORED_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
@@ -27,9 +28,11 @@ ClientMessageDispatch::onReceivedImpl(Message* msg,
           checked_downcast<NODE_STATS_REPLY_Message*>(msg), from);
     case MessageType::STORED:
       return checked_downcast<STORED_Message*>(msg)->onReceivedCommon(from);
+    case MessageType::CHECKSUM_FAIL:
     case MessageType::CHECK_NODE_HEALTH:
     case MessageType::CHECK_SEAL:
     case MessageType::CLEAN:
+    case MessageType::CLUSTER_STATE_SUBSCRIBE:
     case MessageType::DELETE:
     case MessageType::FINDKEY:
     case MessageType::GET_EPOCH_RECOVERY_METADATA:
@@ -39,12 +42,19 @@ ClientMessageDispatch::onReceivedImpl(Message* msg,
     case MessageType::NODE_STATS_AGGREGATE:
     case MessageType::NODE_STATS_AGGREGATE_REPLY:
     case MessageType::IS_LOG_EMPTY:
+    case MessageType::MULTI_DATA_SIZE:
+    case MessageType::MULTI_IS_LOG_EMPTY:
+    case MessageType::MULTI_RELEASE:
+    case MessageType::MULTI_SEAL:
+    case MessageType::MULTI_STORE:
+    case MessageType::MULTI_TRIM:
     case MessageType::RELEASE:
     case MessageType::SEAL:
     case MessageType::START:
     case MessageType::STOP:
     case MessageType::STORE:
     case MessageType::TRIM:
+    case MessageType::TRIM_POINT_UPDATE:
     case MessageType::WINDOW:
       RATELIMIT_ERROR(
           std::chrono::seconds(60),
@@ -76,11 +86,19 @@ void ClientMessageDispatch::onSentImpl(const Message& msg,
       checked_downcast<const STORE_Message&>(msg).onSentCommon(st, to);
       return;
 
+    case MessageType::MULTI_STORE:
+      for (const auto& store :
+           checked_downcast<const MULTI_STORE_Message&>(msg).getStores()) {
+        store->onSentCommon(st, to);
+      }
+      return;
+
     case MessageType::GET_EPOCH_RECOVERY_METADATA:
     case MessageType::NODE_STATS_AGGREGATE:
     case MessageType::NODE_STATS_AGGREGATE_REPLY:
     case MessageType::NODE_STATS_REPLY:
     case MessageType::RECORD:
+    case MessageType::RECORD_BATCH:
     case MessageType::SHARD_STATUS_UPDATE:
       RATELIMIT_ERROR(std::chrono::seconds(60),
                       1,
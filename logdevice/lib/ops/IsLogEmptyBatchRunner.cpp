@@ -46,6 +46,7 @@ void IsLogEmptyBatchRunner::scheduleForLog(logid_t logid) {
   std::unique_ptr<IsLogEmptyRequest> is_log_empty_req(
       new IsLogEmptyRequest(logid, std::chrono::seconds{10}, cb));
   is_log_empty_req->setWorkerThread(Worker::onThisThread()->idx_);
+  is_log_empty_req->setBatchable();
   std::unique_ptr<Request> request = std::move(is_log_empty_req);
   ClientImpl* client = static_cast<ClientImpl*>(client_.get());
   client->getProcessor().postImportant(request);
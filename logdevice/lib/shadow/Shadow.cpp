@@ -10,6 +10,7 @@
 #include <algorithm>
 
 #include "logdevice/common/AppendRequest.h"
+#include "logdevice/lib/shadow/ShadowAppendQueue.h"
 #include "logdevice/lib/shadow/ShadowClient.h"
 
 namespace facebook { namespace logdevice {
@@ -39,7 +40,10 @@ Shadow::Shadow(std::string origin_name,
       origin_config_(std::move(origin_config)),
       client_settings_(std::move(client_settings)),
       stats_(stats),
-      shadow_factory_(std::move(shadow_factory)) {
+      shadow_factory_(std::move(shadow_factory)),
+      append_queue_(std::make_unique<ShadowAppendQueue>(
+          client_settings_->shadow_append_queue_size,
+          stats)) {
   // Subscribe to updates
   settings_sub_handle_ =
       client_settings_.subscribeToUpdates([this] { onSettingsUpdate(); });
@@ -81,13 +85,12 @@ int Shadow::appendShadow(const AppendRequest& req) {
   AppendAttributes req_attrs;
   std::tie(payload, req_attrs) = req.getShadowData();
 
-  int rv = shadow_client->append(
-      logid, payload, req_attrs, req.getBufferedWriterBlobFlag());
-  if (rv == -1) {
-    // TODO detailed scuba stats T20416930 including error code
-    STAT_INCR(stats_, client.shadow_append_failed);
-  }
-  return rv;
+  // Failures to post the append are counted by the queue's threads
+  return append_queue_->push(std::move(shadow_client),
+                             logid,
+                             payload,
+                             std::move(req_attrs),
+                             req.getBufferedWriterBlobFlag());
 }
 
 Shadow::Attrs Shadow::checkShadowConfig(logid_t logid) {
@@ -147,7 +150,11 @@ Shadow::Attrs Shadow::checkShadowConfig(logid_t logid) {
 }
 
 // ShadowClientFactory::reset will also shut down helper thread
+// **NOTE** Also stops the threads of the shadow append queue; appends still
+//          in the queue are dropped
 void Shadow::reset() {
+  append_queue_->stop();
+
   std::lock_guard<Mutex> range_cache_lock(shadow_mutex_);
   last_used_range_.clear();
   range_cache_.clear();
@@ -228,6 +235,7 @@ void Shadow::onSettingsUpdate() {
     reset();
     if (client_shadow_enabled_) {
       shadow_factory_->start(client_timeout_);
+      append_queue_->start(client_settings_->shadow_append_threads);
     }
     ld_info(LD_SHADOW_PREFIX
             "Traffic shadowing %s, shadow client timeout: %ldms",
@@ -48,6 +48,7 @@ namespace facebook { namespace logdevice {
 
 class AppendRequest;
 class MockShadow;
+class ShadowAppendQueue;
 class ShadowClientFactory;
 
 class Shadow {
@@ -77,10 +78,13 @@ class Shadow {
   /**
    * Takes an append request and shadows it to the configured shadow cluster,
    * if applicable for the given log id. The provided AppendRequest is not
-   * used for processing, just for convenience.
+   * used for processing, just for convenience. Never blocks: the payload is
+   * copied and queued in a ShadowAppendQueue, whose threads post the shadow
+   * append.
    *
    * @return 0 if shadowing was performed, -1 otherwise with err set to one of
-   *         E::SHADOW_* (not necessarily a failure)
+   *         E::SHADOW_* (not necessarily a failure), e.g. E::SHADOW_BUSY if
+   *         the shadow append queue is full
    */
   int appendShadow(const AppendRequest& req);
 
@@ -136,6 +140,10 @@ class Shadow {
   UpdateableSettings<Settings> client_settings_;
   StatsHolder* stats_;
   std::unique_ptr<ShadowClientFactory> shadow_factory_;
+  // Posts shadow appends off the appending threads. Its threads only run
+  // while shadowing is enabled. Declared before the subscription handles, so
+  // that settings updates can't restart the threads while it's destroyed.
+  std::unique_ptr<ShadowAppendQueue> append_queue_;
 
   UpdateableSettings<Settings>::SubscriptionHandle settings_sub_handle_;
   ConfigSubscriptionHandle logsconfig_sub_handle_;
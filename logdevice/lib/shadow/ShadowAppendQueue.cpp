@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/lib/shadow/ShadowAppendQueue.h"
+
+#include <folly/Format.h>
+
+#include "logdevice/common/ThreadID.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/lib/shadow/ShadowClient.h"
+
+namespace facebook { namespace logdevice {
+
+ShadowAppendQueue::ShadowAppendQueue(size_t capacity, StatsHolder* stats)
+    : capacity_(capacity), stats_(stats), queue_(capacity) {
+  ld_check(capacity_ > 0);
+}
+
+ShadowAppendQueue::~ShadowAppendQueue() {
+  stop();
+}
+
+void ShadowAppendQueue::start(size_t nthreads) {
+  ld_check(threads_.empty());
+  for (size_t i = 0; i < nthreads; ++i) {
+    threads_.emplace_back(&ShadowAppendQueue::threadMain, this, i);
+  }
+}
+
+void ShadowAppendQueue::stop() {
+  if (threads_.empty()) {
+    return;
+  }
+  ld_debug(LD_SHADOW_PREFIX "Stopping %zu shadow append threads",
+           threads_.size());
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    queue_.blockingWrite(nullptr);
+  }
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  drain();
+}
+
+void ShadowAppendQueue::drain() {
+  std::unique_ptr<Item> item;
+  while (queue_.read(item)) {
+    if (item) {
+      --size_;
+      STAT_INCR(stats_, client.shadow_append_dropped);
+    }
+  }
+}
+
+int ShadowAppendQueue::push(std::shared_ptr<ShadowClient> client,
+                            logid_t logid,
+                            const Payload& payload,
+                            AppendAttributes attrs,
+                            bool buffered_writer_blob) {
+  if (++size_ > capacity_) {
+    --size_;
+    STAT_INCR(stats_, client.shadow_append_dropped);
+    RATELIMIT_WARNING(std::chrono::seconds(1),
+                      1,
+                      LD_SHADOW_PREFIX "Shadow append queue is full (%zu "
+                                       "appends), dropping shadow append",
+                      capacity_);
+    err = E::SHADOW_BUSY;
+    return -1;
+  }
+
+  // The original payload is owned by the application and only valid until
+  // the original append completes, so it has to be copied. The copy is then
+  // moved all the way into the shadow AppendRequest.
+  std::unique_ptr<Item> item;
+  try {
+    item = std::make_unique<Item>(
+        Item{std::move(client),
+             logid,
+             std::string(static_cast<const char*>(payload.data()),
+                         payload.size()),
+             std::move(attrs),
+             buffered_writer_blob});
+  } catch (const std::bad_alloc&) {
+    --size_;
+    STAT_INCR(stats_, client.shadow_payload_alloc_failed);
+    ld_warning(LD_SHADOW_PREFIX
+               "Failed to allocate memory for duplicating shadow payload");
+    err = E::NOMEM;
+    return -1;
+  }
+
+  if (!queue_.write(std::move(item))) {
+    // Only possible while stop() is queueing the items that stop the threads.
+    --size_;
+    STAT_INCR(stats_, client.shadow_append_dropped);
+    err = E::SHADOW_BUSY;
+    return -1;
+  }
+  return 0;
+}
+
+void ShadowAppendQueue::threadMain(size_t idx) {
+  ThreadID::set(ThreadID::UTILITY, folly::sformat("shadow:A{}", idx));
+  while (true) {
+    std::unique_ptr<Item> item;
+    queue_.blockingRead(item);
+    if (!item) {
+      break;
+    }
+    --size_;
+    int rv = item->client->append(item->logid,
+                                  std::move(item->payload),
+                                  std::move(item->attrs),
+                                  item->buffered_writer_blob);
+    if (rv == -1) {
+      // TODO detailed scuba stats T20416930 including error code
+      STAT_INCR(stats_, client.shadow_append_failed);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
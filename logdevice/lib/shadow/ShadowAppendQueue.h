@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/MPMCQueue.h>
+
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+
+/**
+ * @file Bounded queue of shadow appends, served by its own threads.
+ *
+ *       Shadow::appendShadow() runs on the thread that submits the original
+ *       append. It only copies the payload and pushes it here without
+ *       blocking; preparing and posting the AppendRequest to the shadow
+ *       cluster's client happens on the queue's threads. If the queue is full
+ *       (e.g. because the shadow cluster is slow and its client stopped
+ *       accepting requests), the shadow append is dropped, so shadowing never
+ *       holds up or grows memory for the original appends.
+ */
+
+namespace facebook { namespace logdevice {
+
+class ShadowClient;
+class StatsHolder;
+
+class ShadowAppendQueue {
+ public:
+  /**
+   * @param capacity  maximum number of shadow appends waiting to be posted
+   */
+  ShadowAppendQueue(size_t capacity, StatsHolder* stats);
+
+  ~ShadowAppendQueue();
+
+  ShadowAppendQueue(const ShadowAppendQueue&) = delete;
+  ShadowAppendQueue& operator=(const ShadowAppendQueue&) = delete;
+
+  /**
+   * Starts `nthreads` threads posting queued appends to shadow clients.
+   * Must not be called again before stop().
+   */
+  void start(size_t nthreads);
+
+  /**
+   * Stops the threads. Appends that are still queued are dropped.
+   */
+  void stop();
+
+  /**
+   * Copies `payload` and queues an append of it to `client`. Never blocks.
+   *
+   * @return 0 on success, -1 with err set to E::SHADOW_BUSY if the queue is
+   *         full, or to E::NOMEM if the payload couldn't be copied
+   */
+  int push(std::shared_ptr<ShadowClient> client,
+           logid_t logid,
+           const Payload& payload,
+           AppendAttributes attrs,
+           bool buffered_writer_blob);
+
+  // Number of appends waiting to be posted.
+  size_t size() const {
+    return size_.load();
+  }
+
+ private:
+  struct Item {
+    std::shared_ptr<ShadowClient> client;
+    logid_t logid;
+    std::string payload;
+    AppendAttributes attrs;
+    bool buffered_writer_blob;
+  };
+
+  void threadMain(size_t idx);
+
+  // Drops all queued appends.
+  void drain();
+
+  const size_t capacity_;
+  StatsHolder* const stats_;
+
+  // A null item tells a thread to exit.
+  folly::MPMCQueue<std::unique_ptr<Item>> queue_;
+  // Number of appends in queue_ or about to be pushed to it. Slots are
+  // reserved before copying the payload, so that appends that will be
+  // dropped don't pay for the copy.
+  std::atomic<size_t> size_{0};
+
+  std::vector<std::thread> threads_;
+};
+
+}} // namespace facebook::logdevice
@@ -208,15 +208,11 @@ int ShadowClient::append(logid_t logid,
                          const Payload& payload,
                          AppendAttributes attrs,
                          bool buffered_writer_blob) noexcept {
-  auto callback = [&](auto a, const auto& b) { this->appendCallback(a, b); };
-
   // Need to copy payload, since it is technically owned by the client
-  // This will likely be a performance impact, so care should be taken
-  // to keep the ratio low and only enable shadowing on clients that
-  // can handle the impact (TODO better alternative t19772899)
-  Payload payload_copy;
+  std::string payload_copy;
   try {
-    payload_copy = payload.dup();
+    payload_copy.assign(
+        static_cast<const char*>(payload.data()), payload.size());
   } catch (const std::bad_alloc& e) {
     // TODO scuba detailed stats T20416930 about which origin and shadow
     STAT_INCR(stats_, client.shadow_payload_alloc_failed);
@@ -225,9 +221,20 @@ int ShadowClient::append(logid_t logid,
     err = E::NOMEM;
     return -1;
   }
+  return append(logid,
+                std::move(payload_copy),
+                std::move(attrs),
+                buffered_writer_blob);
+}
+
+int ShadowClient::append(logid_t logid,
+                         std::string payload,
+                         AppendAttributes attrs,
+                         bool buffered_writer_blob) noexcept {
+  auto callback = [&](auto a, const auto& b) { this->appendCallback(a, b); };
 
   ld_spew(LD_SHADOW_PREFIX "Shadowing payload of size %zu to shadow '%s'",
-          payload_copy.size(),
+          payload.size(),
           shadow_attrs_->destination().c_str()); // TODO replace with stats
 
   // Downcast client in order to use lower level API. The reason is we need
@@ -236,8 +243,13 @@ int ShadowClient::append(logid_t logid,
   // flag so readers can detect buffered writer batches and unpack them.
   ClientImpl* client_impl = checked_downcast<ClientImpl*>(client_.get());
   int rv = -1;
-  auto req = client_impl->prepareRequest(
-      logid, payload_copy, callback, attrs, worker_id_t{-1}, nullptr);
+  // The AppendRequest takes ownership of the payload.
+  auto req = client_impl->prepareRequest(logid,
+                                         std::move(payload),
+                                         callback,
+                                         std::move(attrs),
+                                         worker_id_t{-1},
+                                         nullptr);
   if (req) {
     if (buffered_writer_blob) {
       req->setBufferedWriterBlobFlag();
@@ -246,8 +258,6 @@ int ShadowClient::append(logid_t logid,
   }
 
   if (rv == -1) {
-    // Payload was created via Payload.dup() which uses malloc()
-    free(const_cast<void*>(payload_copy.data()));
     RATELIMIT_WARNING(1s,
                       1,
                       LD_SHADOW_PREFIX "Shadow append failed with '%s'",
@@ -272,9 +282,6 @@ void ShadowClient::appendCallback(Status status, const DataRecord& record) {
                       record.logid.val(),
                       error_description(status));
   }
-
-  // Payload was created via Payload.dup() which uses malloc()
-  free(const_cast<void*>(record.payload.data()));
 }
 
 }} // namespace facebook::logdevice
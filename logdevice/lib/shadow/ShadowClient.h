@@ -119,11 +119,23 @@ class ShadowClient {
 
   ~ShadowClient();
 
+  /**
+   * Posts an append of a copy of `payload` to the shadow cluster.
+   */
   int append(logid_t logid,
              const Payload& payload,
              AppendAttributes attrs,
              bool buffered_writer_blob) noexcept;
 
+  /**
+   * Posts an append of `payload` to the shadow cluster, without copying it.
+   * Used by ShadowAppendQueue.
+   */
+  int append(logid_t logid,
+             std::string payload,
+             AppendAttributes attrs,
+             bool buffered_writer_blob) noexcept;
+
  private:
   ShadowClient(std::shared_ptr<Client> client,
                const Shadow::Attrs& attrs,
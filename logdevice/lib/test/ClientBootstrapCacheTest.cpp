@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/lib/ClientBootstrapCache.h"
+
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/test/NodesConfigurationTestUtil.h"
+#include "logdevice/common/test/TestUtil.h"
+
+using namespace facebook::logdevice;
+using namespace facebook::logdevice::logsconfig;
+
+TEST(ClientBootstrapCacheTest, NodesConfiguration) {
+  auto dir = createTemporaryDir("ClientBootstrapCacheTest");
+  const std::string path = dir->path().string() + "/cache";
+  auto config = NodesConfigurationTestUtil::provisionNodes();
+  ASSERT_NE(nullptr, config);
+
+  ClientBootstrapCache cache(path, "test_cluster");
+  EXPECT_EQ(nullptr, cache.loadNodesConfiguration());
+  cache.storeNodesConfiguration(*config);
+
+  auto loaded =
+      ClientBootstrapCache(path, "test_cluster").loadNodesConfiguration();
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(config->getVersion(), loaded->getVersion());
+  EXPECT_EQ(*config, *loaded);
+
+  // Other clusters don't share the cached config.
+  EXPECT_EQ(nullptr,
+            ClientBootstrapCache(path, "other").loadNodesConfiguration());
+}
+
+TEST(ClientBootstrapCacheTest, LogsConfigTree) {
+  auto dir = createTemporaryDir("ClientBootstrapCacheTest");
+  const std::string path = dir->path().string();
+  auto tree = LogsConfigTree::create();
+  tree->addLogGroup(tree->root(),
+                    "log1",
+                    logid_range_t{logid_t(1), logid_t(10)},
+                    LogAttributes().with_replicationFactor(2));
+  tree->setVersion(lsn_t(42));
+
+  ClientBootstrapCache(path, "test_cluster").storeLogsConfigTree(*tree);
+
+  ClientBootstrapCache cache(path, "test_cluster");
+  auto loaded = cache.loadLogsConfigTree("/");
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(lsn_t(42), loaded->version());
+  EXPECT_NE(nullptr, loaded->getLogGroupByID(logid_t(5)));
+
+  // Older versions than the one loaded don't overwrite the cache.
+  auto older = LogsConfigTree::create();
+  older->setVersion(lsn_t(41));
+  cache.storeLogsConfigTree(*older);
+  loaded = cache.loadLogsConfigTree("/");
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(lsn_t(42), loaded->version());
+}
+
+TEST(ClientBootstrapCacheTest, CorruptFile) {
+  auto dir = createTemporaryDir("ClientBootstrapCacheTest");
+  const std::string path = dir->path().string();
+  ASSERT_TRUE(folly::writeFile(std::string("garbage"),
+                               (path + "/test_cluster.nodes").c_str()));
+  ASSERT_TRUE(folly::writeFile(std::string("garbage garbage"),
+                               (path + "/test_cluster.logs").c_str()));
+  ClientBootstrapCache cache(path, "test_cluster");
+  EXPECT_EQ(nullptr, cache.loadNodesConfiguration());
+  EXPECT_EQ(nullptr, cache.loadLogsConfigTree("/"));
+}
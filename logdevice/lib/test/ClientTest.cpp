@@ -90,6 +90,36 @@ TEST_F(ClientTest, Configuration) {
   EXPECT_EQ(nonExistentCustomField, "");
 }
 
+TEST_F(ClientTest, SharedRuntime) {
+  std::string config_path =
+      std::string("file:") + TEST_CONFIG_FILE("sample_no_ssl.conf");
+  auto create = [&](std::string credentials, bool shared) {
+    return ClientFactory()
+        .setCredentials(std::move(credentials))
+        .setSharedRuntime(shared)
+        .create(config_path);
+  };
+  std::shared_ptr<Client> a = create("tenant1", true);
+  ASSERT_NE(nullptr, a);
+  // Same credentials and settings share, anything else doesn't.
+  EXPECT_EQ(a, create("tenant1", true));
+  EXPECT_NE(a, create("tenant2", true));
+  EXPECT_NE(a, create("tenant1", false));
+  auto other_settings = ClientFactory()
+                            .setCredentials("tenant1")
+                            .setSharedRuntime(true)
+                            .setSetting("num-workers", 2)
+                            .create(config_path);
+  EXPECT_NE(a, other_settings);
+
+  // Once all users are gone a new Client is created.
+  std::weak_ptr<Client> weak = a;
+  a.reset();
+  EXPECT_TRUE(weak.expired());
+  auto b = create("tenant1", true);
+  ASSERT_NE(nullptr, b);
+}
+
 TEST_F(ClientTest, OnDemandLogsConfigShutdown) {
   std::string config_path =
       std::string("file:") + TEST_CONFIG_FILE("sample_no_ssl.conf");
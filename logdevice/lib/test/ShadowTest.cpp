@@ -23,6 +23,7 @@
 #include "logdevice/include/LogAttributes.h"
 #include "logdevice/include/debug.h"
 #include "logdevice/lib/ClientSettingsImpl.h"
+#include "logdevice/lib/shadow/ShadowAppendQueue.h"
 #include "logdevice/lib/shadow/ShadowClient.h"
 
 namespace facebook { namespace logdevice {
@@ -295,4 +296,17 @@ TEST(ShadowClientTest, ShadowClientInitAppend) {
   ASSERT_EQ(rv, 0);
 }
 
+// Shadow appends that don't fit in the queue are dropped without blocking
+TEST(ShadowAppendQueueTest, DropsWhenFull) {
+  // No threads are started, so queued appends stay in the queue
+  ShadowAppendQueue queue(2, nullptr);
+  std::string payload_str = "test";
+  Payload payload{payload_str.data(), payload_str.size()};
+  ASSERT_EQ(0, queue.push(nullptr, logid_t{1}, payload, {}, false));
+  ASSERT_EQ(0, queue.push(nullptr, logid_t{1}, payload, {}, false));
+  ASSERT_EQ(-1, queue.push(nullptr, logid_t{1}, payload, {}, false));
+  ASSERT_EQ(E::SHADOW_BUSY, err);
+  ASSERT_EQ(2, queue.size());
+}
+
 }} // namespace facebook::logdevice
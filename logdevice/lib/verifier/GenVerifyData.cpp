@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <exception>
+#include <iterator>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
@@ -25,7 +26,12 @@
 
 namespace facebook { namespace logdevice {
 
-GenVerifyData::GenVerifyData(uint64_t wid) : writer_id_(wid) {}
+GenVerifyData::GenVerifyData(uint64_t wid,
+                             VerificationMode mode,
+                             double checksum_sample_rate)
+    : writer_id_(wid),
+      mode_(mode),
+      checksum_sample_rate_(checksum_sample_rate) {}
 
 // Generates a VerificationData instance to be serialized.
 VerificationData
@@ -49,6 +55,50 @@ GenVerifyData::generateVerificationData(logid_t log_id,
   return vd;
 }
 
+CompactVerificationTrailer
+GenVerifyData::generateCompactTrailer(logid_t log_id,
+                                      const std::string& payload) {
+  auto& log_state = log_states_[log_id];
+  CompactVerificationTrailer trailer;
+  trailer.writer_id = writer_id_;
+  trailer.sequence_num = log_state.next_seq_num++;
+  trailer.oldest_in_flight = log_state.in_flight.empty()
+      ? trailer.sequence_num
+      : *log_state.in_flight.begin();
+
+  // All appends below the oldest in flight have completed, so the failures
+  // among them are final.
+  auto failed_end = log_state.failed.lower_bound(trailer.oldest_in_flight);
+  log_state.num_failed_before_oldest +=
+      std::distance(log_state.failed.begin(), failed_end);
+  log_state.failed.erase(log_state.failed.begin(), failed_end);
+  trailer.num_failed_before = log_state.num_failed_before_oldest;
+
+  trailer.flags = 0;
+  trailer.payload_checksum = 0;
+  if (checksum_sample_rate_ >= 1.0 ||
+      folly::Random::randDouble01() < checksum_sample_rate_) {
+    trailer.flags |= CompactVerificationTrailer::CHECKSUM_PRESENT;
+    trailer.payload_checksum = folly::hash::fnv32(payload);
+  }
+  return trailer;
+}
+
+void GenVerifyData::compactAppendUpdateOnCallback(logid_t log_id,
+                                                  vsn_t appended_seq_num,
+                                                  lsn_t appended_lsn) {
+  WriterVerificationData& log_state = log_states_[log_id];
+  auto it = log_state.in_flight.find(appended_seq_num);
+  if (it == log_state.in_flight.end()) {
+    ld_check(false);
+    return;
+  }
+  log_state.in_flight.erase(it);
+  if (appended_lsn == LSN_INVALID) {
+    log_state.failed.insert(appended_seq_num);
+  }
+}
+
 void GenVerifyData::appendUpdateOnCallback(
     logid_t log_id,
     vsn_t appended_seq_num,
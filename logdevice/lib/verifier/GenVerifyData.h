@@ -36,13 +36,27 @@ class GenVerifyData {
     std::set<vsn_t> in_flight;
     // TODO: use struct
     std::set<std::pair<vsn_t, lsn_t>> to_ack_list;
+
+    // VerificationMode::COMPACT: sequence numbers of failed appends that
+    // are not below the oldest in-flight append yet, and the number of those
+    // that are
+    std::set<vsn_t> failed;
+    uint64_t num_failed_before_oldest = 0;
   };
 
-  GenVerifyData(uint64_t wid = folly::Random::rand64());
+  // @param checksum_sample_rate  in COMPACT mode, fraction of records whose
+  //                              payload checksum is included in the trailer
+  GenVerifyData(uint64_t wid = folly::Random::rand64(),
+                VerificationMode mode = VerificationMode::FULL,
+                double checksum_sample_rate = 1.0);
 
   VerificationData generateVerificationData(logid_t log_id,
                                             const std::string& payload);
 
+  // VerificationMode::COMPACT counterpart of generateVerificationData().
+  CompactVerificationTrailer generateCompactTrailer(logid_t log_id,
+                                                    const std::string& payload);
+
   // Public because we need to frequently modify log_states_ anyway by
   // inserting into in_flight whenever an append is called.
   std::map<logid_t, WriterVerificationData> log_states_;
@@ -55,7 +69,19 @@ class GenVerifyData {
       lsn_t appended_lsn,
       const std::vector<std::pair<vsn_t, lsn_t>>& appended_ack_list);
 
+  // VerificationMode::COMPACT counterpart of appendUpdateOnCallback();
+  // appended_lsn is LSN_INVALID if the append failed.
+  void compactAppendUpdateOnCallback(logid_t log_id,
+                                     vsn_t appended_seq_num,
+                                     lsn_t appended_lsn);
+
+  VerificationMode getMode() const {
+    return mode_;
+  }
+
  private:
   uint64_t writer_id_;
+  VerificationMode mode_;
+  double checksum_sample_rate_;
 };
 }} // namespace facebook::logdevice
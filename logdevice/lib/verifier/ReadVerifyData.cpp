@@ -31,7 +31,10 @@
 
 namespace facebook { namespace logdevice {
 
-ReadVerifyData::ReadVerifyData() {}
+constexpr size_t ReadVerifyData::CompactStreamState::kWindow;
+
+ReadVerifyData::ReadVerifyData(size_t max_compact_streams)
+    : compact_streams_(max_compact_streams) {}
 
 // Checks the data verification parameters for errors, and if it finds any,
 // reports them. Will eventually use Scuba, but using returned error codes
@@ -222,6 +225,116 @@ void ReadVerifyData::checkForErrors(
   }
 }
 
+void ReadVerifyData::checkCompactForErrors(
+    logid_t log_id,
+    const Payload& user_payload,
+    const CompactVerificationTrailer& trailer,
+    VerificationAppendInfo vai,
+    std::vector<VerificationFoundError>& errors_out) {
+  using State = CompactStreamState;
+  const vsn_t seq = trailer.sequence_num;
+
+  VerificationFoundError vfe;
+  if ((trailer.flags & CompactVerificationTrailer::CHECKSUM_PRESENT) &&
+      trailer.payload_checksum !=
+          folly::hash::fnv32_buf(user_payload.data(), user_payload.size())) {
+    vfe.vrs = VerificationRecordStatus::CHECKSUM_MISMATCH;
+    vfe.error_record = std::make_pair(seq, vai);
+    errors_out.push_back(vfe);
+    return;
+  }
+
+  const auto key = std::make_pair(trailer.writer_id, log_id);
+  auto it = compact_streams_.find(key);
+  if (it == compact_streams_.end()) {
+    // First record of the writer and log that we read, or the state was
+    // evicted. Appends below its oldest in flight may have been written
+    // before we started reading, so checks start there.
+    State state;
+    state.base = state.settled = trailer.oldest_in_flight;
+    state.num_failed_before = trailer.num_failed_before;
+    compact_streams_.set(key, std::move(state));
+    it = compact_streams_.find(key);
+  }
+  State& state = it->second;
+
+  if (seq >= state.base + State::kWindow) {
+    const vsn_t new_base = seq - State::kWindow + 1;
+    if (new_base > state.settled) {
+      // More appends were in flight than the window covers. Appends that
+      // would drop out of it before completing can't be checked; start over
+      // from this record.
+      state.seen.reset();
+      state.base = state.settled = trailer.oldest_in_flight;
+      state.num_failed_before = trailer.num_failed_before;
+      if (seq >= state.base + State::kWindow) {
+        return;
+      }
+    } else if (new_base - state.base >= State::kWindow) {
+      state.seen.reset();
+      state.base = new_base;
+    } else {
+      for (; state.base < new_base; ++state.base) {
+        state.seen.reset(state.base % State::kWindow);
+      }
+    }
+  }
+
+  if (seq < state.base) {
+    // too old to tell whether it's a duplicate or a reordering
+    return;
+  }
+
+  if (state.seen.test(seq % State::kWindow)) {
+    vfe.vrs = VerificationRecordStatus::DUPLICATE;
+    vfe.error_record = std::make_pair(seq, vai);
+    errors_out.push_back(vfe);
+    return;
+  }
+  state.seen.set(seq % State::kWindow);
+
+  if (seq < state.settled) {
+    // Some record read before this one was appended after this record's
+    // append completed.
+    vfe.vrs = VerificationRecordStatus::REORDERING;
+    vfe.error_record = std::make_pair(seq, vai);
+    errors_out.push_back(vfe);
+  }
+
+  if (trailer.oldest_in_flight <= state.settled) {
+    return;
+  }
+
+  // Every append in [settled, oldest_in_flight) had completed when this
+  // record was appended, so the successful ones must have been read already.
+  // The window covers the range since oldest_in_flight <= seq.
+  const vsn_t settle_until = trailer.oldest_in_flight;
+  const uint64_t num_failed =
+      trailer.num_failed_before >= state.num_failed_before
+      ? trailer.num_failed_before - state.num_failed_before
+      : 0;
+  uint64_t num_unread = 0;
+  for (vsn_t s = state.settled; s < settle_until; ++s) {
+    num_unread += !state.seen.test(s % State::kWindow);
+  }
+  if (num_unread > num_failed) {
+    uint64_t num_lost = num_unread - num_failed;
+    VerificationAppendInfo lost_vai;
+    lost_vai.lsn = LSN_INVALID;
+    vfe.vrs = VerificationRecordStatus::DATALOSS;
+    vfe.error_discovery_record = std::make_pair(seq, vai);
+    for (vsn_t s = state.settled; s < settle_until && num_lost > 0; ++s) {
+      if (!state.seen.test(s % State::kWindow)) {
+        vfe.error_record = std::make_pair(s, lost_vai);
+        errors_out.push_back(vfe);
+        --num_lost;
+      }
+    }
+  }
+  state.settled = settle_until;
+  state.num_failed_before = trailer.num_failed_before;
+}
+
 // Note that the unique_ptr to DataRecord that is passed to this function will
 // actually point to an instance of DataRecordOwnsPayload.
 // Returns a VerificationResult.
@@ -236,14 +349,33 @@ std::unique_ptr<DataRecord> ReadVerifyData::verifyRestoreRecordPayload(
   VerExtractionResult ver =
       VerificationDataStructures::extractVerificationData(dr->payload);
 
-  if (ver.ves == VerExtractionStatus::NO_VERIFICATION) {
-    return dr;
-  }
-
   VerificationAppendInfo vai;
   vai.lsn = dr->attrs.lsn;
   // Later, insert other info gotten from Reader::read() into vai here.
 
+  if (ver.ves == VerExtractionStatus::NO_VERIFICATION) {
+    CompactVerificationTrailer trailer;
+    VerExtractionStatus ves = VerificationDataStructures::extractCompactTrailer(
+        dr->payload, &trailer);
+    if (ves == VerExtractionStatus::NO_VERIFICATION) {
+      return dr;
+    }
+    if (ves == VerExtractionStatus::MALFORMED_VER_DATA) {
+      VerificationFoundError vfe;
+      vfe.vrs = VerificationRecordStatus::MALFORMED_VER_DATA;
+      vfe.error_record = std::make_pair(trailer.sequence_num, vai);
+      errors_out.push_back(vfe);
+      return dr;
+    }
+    Payload user_payload(
+        dr->payload.data(), dr->payload.size() - sizeof(trailer));
+    checkCompactForErrors(log_id, user_payload, trailer, vai, errors_out);
+    // The customer's payload is a prefix of the record's, so the record can
+    // keep owning it.
+    dr->payload = user_payload;
+    return dr;
+  }
+
   if (ver.ves == VerExtractionStatus::MALFORMED_VER_DATA) {
     VerificationFoundError vfe;
     vfe.vrs = VerificationRecordStatus::MALFORMED_VER_DATA;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <atomic>
+#include <bitset>
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -17,6 +18,7 @@
 #include <utility>
 
 #include <folly/SharedMutex.h>
+#include <folly/container/EvictingCacheMap.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/toString.h"
@@ -41,11 +43,17 @@ class ReadVerifyData {
   // will be reported by each of those records).
   // Note that if called on the return values of read(), then
   // given_dr will actually be pointing to an instance of DataRecordOwnsPayload.
+  // Records written in VerificationMode::COMPACT are checked with
+  // checkCompactForErrors() instead, and dr is returned with the trailer cut
+  // off its payload, without copying it.
   std::unique_ptr<DataRecord>
   verifyRestoreRecordPayload(std::unique_ptr<DataRecord> dr,
                              std::vector<VerificationFoundError>& errors_out);
 
-  ReadVerifyData();
+  // @param max_compact_streams  number of writer-log pairs written in
+  //                             VerificationMode::COMPACT to keep state for;
+  //                             the least recently read ones are forgotten
+  explicit ReadVerifyData(size_t max_compact_streams = 1024);
 
  private:
   // Checks a payload and verification data for errors. If any errors are
@@ -58,6 +66,43 @@ class ReadVerifyData {
                       VerificationAppendInfo vai,
                       std::vector<VerificationFoundError>& errors_out);
 
+  // VerificationMode::COMPACT counterpart of checkForErrors(). Detects, using
+  // constant memory per writer-log pair:
+  //  - CHECKSUM_MISMATCH, for records whose checksum was sampled;
+  //  - DUPLICATE and REORDERING, for records within the window of the last
+  //    CompactStreamState::kWindow sequence numbers;
+  //  - DATALOSS: once a record says that all appends below some sequence
+  //    number had completed, the unread ones among them must be failed
+  //    appends, and the trailer has the number of those. Each unread sequence
+  //    number is reported if none failed; otherwise as many of them as are
+  //    missing are reported, and they may not be the lost ones.
+  // LSN_MISMATCH and LOST_ACK are not detected, as the trailer carries no
+  // acks.
+  void checkCompactForErrors(logid_t log_id,
+                             const Payload& user_payload,
+                             const CompactVerificationTrailer& trailer,
+                             VerificationAppendInfo vai,
+                             std::vector<VerificationFoundError>& errors_out);
+
+  // State of a writer-log pair written in VerificationMode::COMPACT.
+  struct CompactStreamState {
+    static constexpr size_t kWindow = 1 << 14;
+
+    // Whether sequence number s was read, at s % kWindow, for s in
+    // [base, base + kWindow). Records below base are not checked.
+    std::bitset<kWindow> seen;
+    vsn_t base;
+    // All appends below settled had completed when a record that was already
+    // read was appended. Unread ones below it were reported as lost (or
+    // counted as failed), and reading them now is a reordering.
+    vsn_t settled;
+    // Number of failed appends below settled, from the trailer.
+    uint64_t num_failed_before;
+  };
+
+  folly::EvictingCacheMap<std::pair<uint64_t, logid_t>, CompactStreamState>
+      compact_streams_;
+
   // The reader will maintain a separate state for each Client-log pair. Hence
   // the identifier used in this unordered map is a pair of uint64_t (for the
   // Client's writer ID) and log ID. Each Client-log pair is mapped to an
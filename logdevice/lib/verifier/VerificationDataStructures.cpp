@@ -16,6 +16,8 @@
 
 #include "logdevice/lib/verifier/VerificationDataStructures.h"
 
+#include <cstring>
+
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
 #include "logdevice/common/toString.h"
@@ -96,4 +98,28 @@ VerificationDataStructures::extractVerificationData(const Payload& p) {
   return ver;
 }
 
+void VerificationDataStructures::appendCompactTrailer(
+    const CompactVerificationTrailer& trailer,
+    std::string* payload) {
+  payload->append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+}
+
+VerExtractionStatus VerificationDataStructures::extractCompactTrailer(
+    const Payload& p,
+    CompactVerificationTrailer* trailer_out) {
+  if (p.size() < sizeof(CompactVerificationTrailer)) {
+    return VerExtractionStatus::NO_VERIFICATION;
+  }
+  const char* trailer_pos = static_cast<const char*>(p.data()) + p.size() -
+      sizeof(CompactVerificationTrailer);
+  memcpy(trailer_out, trailer_pos, sizeof(CompactVerificationTrailer));
+  if (trailer_out->magic_number != vtrailer_flag_) {
+    return VerExtractionStatus::NO_VERIFICATION;
+  }
+  if (trailer_out->version != 0) {
+    return VerExtractionStatus::MALFORMED_VER_DATA;
+  }
+  return VerExtractionStatus::OK;
+}
+
 }} // namespace facebook::logdevice
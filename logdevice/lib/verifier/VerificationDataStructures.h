@@ -50,6 +50,40 @@ struct VerificationDataHeader {
   uint32_t dummyfield; // To get multiple of 8 bytes.
 };
 
+// Verification data formats a VerificationWriter can write.
+enum class VerificationMode {
+  // VerificationData with the ack list of the writer is prepended to every
+  // payload, and the reader tracks every record it has read.
+  FULL,
+  // A fixed-size CompactVerificationTrailer is appended to every payload,
+  // payload checksums are sampled, and the reader keeps a fixed-size window
+  // of recently read sequence numbers per writer and log. Cheap enough to run
+  // on production traffic; see ReadVerifyData for what it detects.
+  COMPACT,
+};
+
+const uint64_t vtrailer_flag_ = 11400714819323198485ull;
+
+// Appended to the payload in VerificationMode::COMPACT. The magic number is
+// last so that the reader finds it at the end of the payload.
+struct CompactVerificationTrailer {
+  static constexpr uint16_t CHECKSUM_PRESENT = 1u << 0;
+
+  uint64_t writer_id;
+  vsn_t sequence_num;
+  // Every append of the log with a lower sequence number had completed when
+  // this one was issued.
+  vsn_t oldest_in_flight;
+  // Number of those appends that failed.
+  uint64_t num_failed_before;
+  uint32_t payload_checksum; // only valid with CHECKSUM_PRESENT
+  uint16_t flags;
+  uint16_t version = 0;
+  uint64_t magic_number = vtrailer_flag_;
+};
+static_assert(sizeof(CompactVerificationTrailer) == 48,
+              "CompactVerificationTrailer must be packed");
+
 struct VerificationData {
   VerificationDataHeader vdh;
   std::vector<std::pair<vsn_t, lsn_t>> ack_list;
@@ -150,5 +184,17 @@ class VerificationDataStructures {
   // simply point to the same location as the original Payload p if verification
   // is not being used, or if verification data is malformed).
   static VerExtractionResult extractVerificationData(const Payload& p);
+
+  // Appends the trailer to the payload string.
+  static void appendCompactTrailer(const CompactVerificationTrailer& trailer,
+                                   std::string* payload);
+
+  // Reads the CompactVerificationTrailer at the end of p into trailer_out.
+  // Returns NO_VERIFICATION if p doesn't end with one, MALFORMED_VER_DATA if
+  // its version is unknown, and OK otherwise, in which case the user's payload
+  // is the first p.size() - sizeof(CompactVerificationTrailer) bytes of p.
+  static VerExtractionStatus
+  extractCompactTrailer(const Payload& p,
+                        CompactVerificationTrailer* trailer_out);
 };
 }} // namespace facebook::logdevice
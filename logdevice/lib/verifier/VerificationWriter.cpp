@@ -30,6 +30,11 @@ int VerificationWriter::append(logid_t logid,
                                std::string payload,
                                append_callback_t cb,
                                AppendAttributes attrs) {
+  if (gvd_->getMode() == VerificationMode::COMPACT) {
+    return appendCompact(
+        logid, std::move(payload), std::move(cb), std::move(attrs));
+  }
+
   VerificationData vd = gvd_->generateVerificationData(logid, payload);
   std::string new_payload_buffer;
   VerificationDataStructures::serializeVerificationData(
@@ -62,4 +67,34 @@ int VerificationWriter::append(logid_t logid,
   return ds_->append(logid, std::move(new_payload_buffer), mod_cb, attrs);
 }
 
+int VerificationWriter::appendCompact(logid_t logid,
+                                      std::string payload,
+                                      append_callback_t cb,
+                                      AppendAttributes attrs) {
+  CompactVerificationTrailer trailer =
+      gvd_->generateCompactTrailer(logid, payload);
+  vsn_t appended_seq_num = trailer.sequence_num;
+  size_t payload_size = payload.size();
+
+  auto mod_cb = [=](Status st, const DataRecord& r) {
+    gvd_->compactAppendUpdateOnCallback(
+        logid, appended_seq_num, st == E::OK ? r.attrs.lsn : LSN_INVALID);
+
+    // The customer's payload is the record's payload without the trailer.
+    cb(st,
+       DataRecord(
+           logid, Payload(r.payload.data(), payload_size), r.attrs.lsn));
+  };
+
+  gvd_->log_states_[logid].in_flight.insert(appended_seq_num);
+  VerificationDataStructures::appendCompactTrailer(trailer, &payload);
+  int rv = ds_->append(logid, std::move(payload), mod_cb, attrs);
+  if (rv != 0) {
+    // The callback won't be called. Count the append as failed, or the
+    // oldest in-flight append would never advance.
+    gvd_->compactAppendUpdateOnCallback(logid, appended_seq_num, LSN_INVALID);
+  }
+  return rv;
+}
+
 }} // namespace facebook::logdevice
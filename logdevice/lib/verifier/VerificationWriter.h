@@ -38,5 +38,12 @@ class VerificationWriter {
 
   std::unique_ptr<DataSourceWriter> ds_;
   std::unique_ptr<GenVerifyData> gvd_;
+
+ private:
+  // append() in VerificationMode::COMPACT
+  int appendCompact(logid_t logid,
+                    std::string payload,
+                    append_callback_t cb,
+                    AppendAttributes attrs);
 };
 }} // namespace facebook::logdevice
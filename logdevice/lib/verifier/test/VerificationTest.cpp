@@ -9,6 +9,7 @@
 #include <chrono>
 
 #include <folly/Random.h>
+#include <folly/hash/Hash.h>
 #include <folly/synchronization/Baton.h>
 #include <gtest/gtest.h>
 
@@ -611,3 +612,239 @@ TEST(VerificationTest, ReorderingDetectionTest) {
     EXPECT_EQ(reordered_vai, verified_reordered_records);
   }
 }
+
+TEST(VerificationTest, CompactTrailerTest) {
+  GenVerifyData gvd(folly::Random::rand64(), VerificationMode::COMPACT);
+  logid_t curr_logid = logid_t(folly::Random::rand64());
+  auto& log_state = gvd.log_states_[curr_logid];
+  log_state.in_flight = {3, 5};
+  log_state.failed = {1, 4};
+  log_state.next_seq_num = 6;
+
+  std::string ps = toString(folly::Random::rand64());
+  CompactVerificationTrailer trailer =
+      gvd.generateCompactTrailer(curr_logid, ps);
+  EXPECT_EQ(6, trailer.sequence_num);
+  EXPECT_EQ(3, trailer.oldest_in_flight);
+  // 1 is below the oldest append in flight, 4 isn't yet
+  EXPECT_EQ(1, trailer.num_failed_before);
+  EXPECT_EQ(std::set<vsn_t>({4}), log_state.failed);
+
+  std::string s = ps;
+  VerificationDataStructures::appendCompactTrailer(trailer, &s);
+  EXPECT_EQ(ps.size() + sizeof(CompactVerificationTrailer), s.size());
+
+  CompactVerificationTrailer extracted;
+  EXPECT_EQ(VerExtractionStatus::OK,
+            VerificationDataStructures::extractCompactTrailer(
+                Payload(s.data(), s.size()), &extracted));
+  EXPECT_EQ(trailer.writer_id, extracted.writer_id);
+  EXPECT_EQ(trailer.sequence_num, extracted.sequence_num);
+  EXPECT_EQ(trailer.oldest_in_flight, extracted.oldest_in_flight);
+  EXPECT_EQ(trailer.num_failed_before, extracted.num_failed_before);
+  EXPECT_EQ(folly::hash::fnv32(ps), extracted.payload_checksum);
+  EXPECT_TRUE(extracted.flags & CompactVerificationTrailer::CHECKSUM_PRESENT);
+
+  EXPECT_EQ(VerExtractionStatus::NO_VERIFICATION,
+            VerificationDataStructures::extractCompactTrailer(
+                Payload(ps.data(), ps.size()), &extracted));
+}
+
+TEST(VerificationTest, CompactDataLossDetectionTest) {
+  VerificationWriter vw = VerificationWriter(
+      std::make_unique<MockDataSourceWriter>(),
+      std::make_unique<GenVerifyData>(
+          folly::Random::rand64(), VerificationMode::COMPACT));
+  logid_t curr_logid = logid_t(folly::Random::rand64());
+
+  std::vector<std::string> all_payload_strings;
+  for (int i = 0; i < 100; i++) {
+    all_payload_strings.push_back(toString(folly::Random::rand64()));
+  }
+
+  std::map<int, int> overall_append_order;
+
+  initializeAndAppend(
+      vw, curr_logid, all_payload_strings, overall_append_order);
+
+  VerificationReader vr =
+      VerificationReader(std::make_unique<MockDataSourceReader>(),
+                         std::make_unique<ReadVerifyData>());
+
+  MockDataSourceWriter* write_mdptr =
+      static_cast<MockDataSourceWriter*>(vw.ds_.get());
+
+  MockDataSourceReader* read_mdptr =
+      static_cast<MockDataSourceReader*>(vr.ds_.get());
+
+  read_mdptr->records_ = std::move(write_mdptr->records_);
+  auto& log_records = read_mdptr->records_[curr_logid];
+
+  // Sequence numbers are assigned in append order, so the sequence number of
+  // a record is its index in records_. Loss of any record but the last one
+  // is detected once the last one is read, since all other appends had
+  // completed when it was issued.
+  std::set<vsn_t> deleted_record_indices;
+  for (int i = 0; i < 10; i++) {
+    deleted_record_indices.insert(folly::Random::rand64(1, 98));
+  }
+  for (auto it = deleted_record_indices.rbegin();
+       it != deleted_record_indices.rend();
+       it++) {
+    log_records.erase(log_records.begin() + *it);
+  }
+
+  std::vector<std::unique_ptr<DataRecord>> data_out;
+  GapRecord g;
+  std::set<vsn_t> lost_records;
+  error_callback_t ecb = [&](const VerificationFoundError& vfe) {
+    EXPECT_EQ(VerificationRecordStatus::DATALOSS, vfe.vrs);
+    lost_records.insert(vfe.error_record.first);
+  };
+
+  vr.startReading(curr_logid, lsn_t(1), lsn_t(100));
+  vr.read(100, &data_out, &g, ecb);
+
+  EXPECT_EQ(data_out.size(),
+            all_payload_strings.size() - deleted_record_indices.size());
+  EXPECT_EQ(deleted_record_indices, lost_records);
+  for (int x = 0; x < all_payload_strings.size(); x++) {
+    int i = overall_append_order[x];
+    if (deleted_record_indices.count(i) == 0) {
+      int idx_after_deletion = i -
+          std::distance(deleted_record_indices.begin(),
+                        deleted_record_indices.lower_bound(i));
+      EXPECT_EQ(all_payload_strings[x],
+                data_out.at(idx_after_deletion)->payload.toString());
+    }
+  }
+}
+
+TEST(VerificationTest, CompactFailedAppendsTest) {
+  VerificationWriter vw = VerificationWriter(
+      std::make_unique<MockDataSourceWriter>(),
+      std::make_unique<GenVerifyData>(
+          folly::Random::rand64(), VerificationMode::COMPACT));
+  logid_t curr_logid = logid_t(folly::Random::rand64());
+  MockDataSourceWriter* write_mdptr =
+      static_cast<MockDataSourceWriter*>(vw.ds_.get());
+  auto& written = write_mdptr->records_[curr_logid];
+
+  // Append 10 records one at a time; the append of the 4th one fails.
+  for (int i = 0; i < 10; i++) {
+    vw.append(curr_logid,
+              toString(folly::Random::rand64()),
+              [](Status, const DataRecord&) {});
+    written.back().first(i == 3 ? E::FAILED : E::OK, *written.back().second);
+  }
+  written.erase(written.begin() + 3);
+  // ... and the record with sequence number 6 is lost.
+  written.erase(written.begin() + 5);
+
+  VerificationReader vr =
+      VerificationReader(std::make_unique<MockDataSourceReader>(),
+                         std::make_unique<ReadVerifyData>());
+  MockDataSourceReader* read_mdptr =
+      static_cast<MockDataSourceReader*>(vr.ds_.get());
+  read_mdptr->records_ = std::move(write_mdptr->records_);
+
+  std::vector<std::unique_ptr<DataRecord>> data_out;
+  GapRecord g;
+  std::vector<VerificationFoundError> errors;
+  error_callback_t ecb = [&](const VerificationFoundError& vfe) {
+    errors.push_back(vfe);
+  };
+
+  vr.startReading(curr_logid, lsn_t(1), lsn_t(10));
+  vr.read(10, &data_out, &g, ecb);
+
+  EXPECT_EQ(8, data_out.size());
+  ASSERT_EQ(1, errors.size());
+  EXPECT_EQ(VerificationRecordStatus::DATALOSS, errors[0].vrs);
+  EXPECT_EQ(6, errors[0].error_record.first);
+  // discovered when reading the record with sequence number 7
+  EXPECT_EQ(7, errors[0].error_discovery_record.first);
+}
+
+TEST(VerificationTest, CompactDuplicateAndReorderingDetectionTest) {
+  VerificationWriter vw = VerificationWriter(
+      std::make_unique<MockDataSourceWriter>(),
+      std::make_unique<GenVerifyData>(
+          folly::Random::rand64(), VerificationMode::COMPACT));
+  logid_t curr_logid = logid_t(folly::Random::rand64());
+
+  std::vector<std::string> all_payload_strings;
+  for (int i = 0; i < 100; i++) {
+    all_payload_strings.push_back(toString(folly::Random::rand64()));
+  }
+
+  std::map<int, int> overall_append_order;
+
+  initializeAndAppend(
+      vw, curr_logid, all_payload_strings, overall_append_order);
+
+  VerificationReader vr =
+      VerificationReader(std::make_unique<MockDataSourceReader>(),
+                         std::make_unique<ReadVerifyData>());
+
+  MockDataSourceWriter* write_mdptr =
+      static_cast<MockDataSourceWriter*>(vw.ds_.get());
+
+  MockDataSourceReader* read_mdptr =
+      static_cast<MockDataSourceReader*>(vr.ds_.get());
+
+  read_mdptr->records_ = std::move(write_mdptr->records_);
+  auto& log_records = read_mdptr->records_[curr_logid];
+
+  auto copy_record = [&](int idx) {
+    const auto& record = log_records[idx].second;
+    return std::make_pair(
+        log_records[idx].first,
+        std::make_unique<DataRecordOwnsPayload>(record->logid,
+                                                record->payload.dup(),
+                                                record->attrs.lsn,
+                                                record->attrs.timestamp,
+                                                record->flags_));
+  };
+
+  // Move the record with sequence number 10 after the one with sequence
+  // number 60, which was appended long after it completed.
+  log_records.insert(log_records.begin() + 61, copy_record(10));
+  log_records.erase(log_records.begin() + 10);
+
+  // Duplicate records right after the originals. Sequence numbers equal
+  // indices in records_ after 60 only.
+  std::set<vsn_t> duplicated_record_indices;
+  for (int i = 0; i < 5; i++) {
+    duplicated_record_indices.insert(folly::Random::rand64(61, 98));
+  }
+  for (auto it = duplicated_record_indices.rbegin();
+       it != duplicated_record_indices.rend();
+       it++) {
+    log_records.insert(log_records.begin() + *it, copy_record(*it));
+  }
+
+  std::vector<std::unique_ptr<DataRecord>> data_out;
+  GapRecord g;
+  std::set<vsn_t> duplicate_records;
+  std::set<vsn_t> reordered_records;
+  std::set<vsn_t> lost_records;
+  error_callback_t ecb = [&](const VerificationFoundError& vfe) {
+    if (vfe.vrs == VerificationRecordStatus::DUPLICATE) {
+      duplicate_records.insert(vfe.error_record.first);
+    } else if (vfe.vrs == VerificationRecordStatus::REORDERING) {
+      reordered_records.insert(vfe.error_record.first);
+    } else if (vfe.vrs == VerificationRecordStatus::DATALOSS) {
+      lost_records.insert(vfe.error_record.first);
+    }
+  };
+
+  vr.startReading(curr_logid, lsn_t(1), lsn_t(100));
+  vr.read(200, &data_out, &g, ecb);
+
+  EXPECT_EQ(100 + duplicated_record_indices.size(), data_out.size());
+  EXPECT_EQ(duplicated_record_indices, duplicate_records);
+  EXPECT_EQ(std::set<vsn_t>({10}), reordered_records);
+  // The reordered record is reported as lost before it is read.
+  EXPECT_EQ(std::set<vsn_t>({10}), lost_records);
+}
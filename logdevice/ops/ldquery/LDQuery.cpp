@@ -50,6 +50,7 @@
 #include "tables/Shards.h"
 #include "tables/Sockets.h"
 #include "tables/Stats.h"
+#include "tables/StatsPerf.h"
 #include "tables/StatsRocksdb.h"
 #include "tables/StorageTasks.h"
 #include "tables/StoredLogs.h"
@@ -179,6 +180,7 @@ LDQuery::LDQuery(std::string config_path,
   table_registry_.registerTable<tables::Shards>(ctx_);
   table_registry_.registerTable<tables::Sockets>(ctx_);
   table_registry_.registerTable<tables::Stats>(ctx_);
+  table_registry_.registerTable<tables::StatsPerf>(ctx_);
   table_registry_.registerTable<tables::StatsRocksdb>(ctx_);
   table_registry_.registerTable<tables::StorageTasks>(ctx_);
   table_registry_.registerTable<tables::StoredLogs>(ctx_);
@@ -85,6 +85,20 @@ class EventLog : public AdminCommandTable {
          "log reports itself as healthy, ie it has enough healthy connections "
          "to the storage nodes in the delta log's storage set such that it "
          "should be able to not miss any delta."},
+        {"snapshot_sync_ms",
+         DataType::BIGINT,
+         "How long it took on startup to read the snapshot log up to "
+         "snapshot_replay_tail and get the base snapshot, in milliseconds. "
+         "Null if not done yet."},
+        {"delta_sync_ms",
+         DataType::BIGINT,
+         "How long it took on startup, after getting the base snapshot, to "
+         "read the delta log up to delta_replay_tail, in milliseconds. Null if "
+         "not done yet."},
+        {"deltas_replayed",
+         DataType::BIGINT,
+         "Number of delta records read while catching up to the tail of the "
+         "delta log, on startup or after the read stream was unhealthy."},
         {"propagated_version",
          DataType::LSN,
          "Version of the last state that was fully propagated to all state "
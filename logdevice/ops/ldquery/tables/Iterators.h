@@ -69,6 +69,12 @@ class Iterators : public AdminCommandTable {
         {"version",
          DataType::BIGINT,
          "RocksDB superversion that this iterator points to."},
+        {"age_ms",
+         DataType::BIGINT,
+         "How long ago the iterator was created, in milliseconds. An iterator "
+         "keeps the memtables and table files it reads from pinned in memory "
+         "while it's alive. Read streams that share iterators (see "
+         "--share-read-iterators) create fewer, longer-lived iterators."},
     };
   }
   std::string getCommandToSend(QueryContext& /*ctx*/) const override {
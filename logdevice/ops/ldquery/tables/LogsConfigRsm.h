@@ -77,6 +77,20 @@ class LogsConfigRsm : public AdminCommandTable {
         {"delta_log_records",
          DataType::BIGINT,
          "Number of delta records that are past the last snapshot."},
+        {"snapshot_sync_ms",
+         DataType::BIGINT,
+         "How long it took on startup to read the snapshot log up to "
+         "snapshot_replay_tail and get the base snapshot, in milliseconds. "
+         "Null if not done yet."},
+        {"delta_sync_ms",
+         DataType::BIGINT,
+         "How long it took on startup, after getting the base snapshot, to "
+         "read the delta log up to delta_replay_tail, in milliseconds. Null if "
+         "not done yet."},
+        {"deltas_replayed",
+         DataType::BIGINT,
+         "Number of delta records read while catching up to the tail of the "
+         "delta log, on startup or after the read stream was unhealthy."},
     };
   }
   std::string getCommandToSend(QueryContext& /*ctx*/) const override {
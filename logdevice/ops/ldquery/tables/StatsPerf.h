@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "../Context.h"
+#include "AdminCommandTable.h"
+
+namespace facebook {
+  namespace logdevice {
+    namespace ldquery {
+      namespace tables {
+
+class StatsPerf : public AdminCommandTable {
+ public:
+  explicit StatsPerf(std::shared_ptr<Context> ctx) : AdminCommandTable(ctx) {}
+  static std::string getName() {
+    return "stats_perf";
+  }
+  std::string getDescription() override {
+    return "Hardware and kernel performance counters of worker and storage "
+           "threads, by kind of work. Only collected on nodes running with "
+           "--enable-perf-counters. Counters the host doesn't support (e.g. "
+           "hardware counters in most VMs) are 0.";
+  }
+  TableColumns getFetchableColumns() const override {
+    return {
+        {"worker",
+         DataType::BIGINT,
+         "Index of the general worker, or -1 for storage threads and other "
+         "threads."},
+        {"kind",
+         DataType::TEXT,
+         "What the thread was doing: \"messages\", \"requests\", "
+         "\"storage_task_responses\" or \"other\" (mostly timers) on workers, "
+         "\"storage_tasks\" on storage threads."},
+        {"cycles", DataType::BIGINT, "CPU cycles, in user space."},
+        {"instructions",
+         DataType::BIGINT,
+         "Instructions retired, in user space."},
+        {"ipc",
+         DataType::REAL,
+         "Instructions per cycle. A drop with the same instruction count "
+         "points at stalls, e.g. cache misses."},
+        {"llc_misses", DataType::BIGINT, "Last level cache misses."},
+        {"context_switches",
+         DataType::BIGINT,
+         "Context switches, i.e. how often the thread blocked or was "
+         "preempted."},
+    };
+  }
+  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+    return std::string("stats perf --json\n");
+  }
+};
+
+}}}} // namespace facebook::logdevice::ldquery::tables
@@ -51,8 +51,23 @@ class StoredLogs : public AdminCommandTable {
          "non-decreasing with LSN in this log.  Can be overestimated by up to "
          "\"rocksdb-partition-duration\" setting."}};
   }
-  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
-    return std::string("info stored_logs --extended --json\n");
+  std::string getCommandToSend(QueryContext& ctx) const override {
+    // Push equality constraints on log_id and shard down to the server, so
+    // querying a single log doesn't transfer the list of all logs.
+    std::string log_constraint;
+    logid_t logid;
+    if (columnHasEqualityConstraintOnLogid(1, ctx, logid)) {
+      log_constraint = " --logid=" + std::to_string(logid.val_);
+    }
+
+    std::string shard_constraint;
+    std::string shard_expr;
+    if (columnHasEqualityConstraint(2, ctx, shard_expr)) {
+      shard_constraint = " --shard=" + shard_expr;
+    }
+
+    return std::string("info stored_logs --extended --json") + log_constraint +
+        shard_constraint + "\n";
   }
 };
 
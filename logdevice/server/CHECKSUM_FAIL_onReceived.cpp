@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/CHECKSUM_FAIL_onReceived.h"
+
+#include "logdevice/common/configuration/ServerConfig.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
+#include "logdevice/server/storage_tasks/VerifyRecordStorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+Message::Disposition CHECKSUM_FAIL_onReceived(CHECKSUM_FAIL_Message* msg,
+                                              const Address& from) {
+  if (!from.isClientAddress()) {
+    ld_error("got CHECKSUM_FAIL message from non-client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Message::Disposition::ERROR;
+  }
+
+  const CHECKSUM_FAIL_Header& header = msg->getHeader();
+  ServerWorker* w = ServerWorker::onThisThread();
+  if (!w->processor_->runningOnStorageNode()) {
+    return Message::Disposition::NORMAL;
+  }
+
+  const shard_size_t n_shards = w->getServerConfig()->getNumShards();
+  shard_index_t shard_idx = header.shard;
+  if (shard_idx < 0 || shard_idx >= n_shards) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Got CHECKSUM_FAIL message from client %s with invalid "
+                    "shard %d, this node only has %u shards",
+                    Sender::describeConnection(from).c_str(),
+                    shard_idx,
+                    n_shards);
+    return Message::Disposition::NORMAL;
+  }
+
+  WORKER_STAT_INCR(checksum_fail_reports);
+  w->getStorageTaskQueueForShard(shard_idx)->putTask(
+      std::make_unique<VerifyRecordStorageTask>(
+          header.log_id, header.lsn, Sender::describeConnection(from)));
+  return Message::Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
@@ -34,12 +34,15 @@ ConnectionListener::ConnectionListener(
     KeepAlive loop,
     std::shared_ptr<SharedState> shared_state,
     ListenerType listener_type,
-    ResourceBudget& connection_backlog_budget)
-    : Listener(std::move(iface), loop),
+    ResourceBudget& connection_backlog_budget,
+    worker_id_t worker)
+    : Listener(std::move(iface), loop, /*reuse_port=*/worker.val_ >= 0),
       connection_backlog_budget_(connection_backlog_budget),
       shared_state_(shared_state),
-      listener_type_(listener_type) {
+      listener_type_(listener_type),
+      worker_(worker) {
   ld_check(shared_state);
+  ld_check(worker_.val_ < 0 || listener_type_ != ListenerType::GOSSIP);
 }
 
 const SimpleEnumMap<ConnectionListener::ListenerType, std::string>&
@@ -61,9 +64,9 @@ void ConnectionListener::acceptCallback(evutil_socket_t sock,
   ServerProcessor* processor = checked_downcast<ServerProcessor*>(processor_);
   Sockaddr sockaddr(addr, len);
 
-  // Check if accepting this connection pushed us over the limit.  Since there's
-  // only one ConnectionListener thread, and this is called soon after accept(),
-  // we're able to react promptly in case there's a burst of new connections.
+  // Check if accepting this connection pushed us over the limit.  Since this
+  // is called soon after accept(), we're able to react promptly in case
+  // there's a burst of new connections.
   auto token = processor->conn_budget_incoming_.acquireToken();
   if (!token) {
     STAT_INCR(processor->stats_, dropped_connection_limit);
@@ -87,8 +90,12 @@ void ConnectionListener::acceptCallback(evutil_socket_t sock,
     LD_EV(evutil_closesocket)(sock);
     return;
   }
-  // By default we want the processor to select a worker thread for us.
-  worker_id_t wid{-1};
+  // By default we want the processor to select a worker thread for us. A
+  // listener running on a Worker keeps its connections. They still go through
+  // the Worker's request queue rather than being set up right here, so that a
+  // burst of accepts is interleaved with the Worker's other work and is
+  // bounded by the Worker's own connection_backlog_budget_.
+  worker_id_t wid = worker_;
   SocketType sock_type;
   WorkerType target_worker_type = WorkerType::GENERAL;
 
@@ -98,6 +105,11 @@ void ConnectionListener::acceptCallback(evutil_socket_t sock,
     target_worker_type = WorkerType::FAILURE_DETECTOR;
   } else {
     sock_type = SocketType::DATA;
+    if (wid.val_ < 0 &&
+        processor->settings()->worker_load_rebalancing_ratio > 0) {
+      // Overloaded workers close connections for them to land elsewhere.
+      wid = processor->selectWorkerLoadAware();
+    }
   }
 
   std::unique_ptr<Request> request = std::make_unique<NewConnectionRequest>(
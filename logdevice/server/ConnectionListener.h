@@ -18,6 +18,14 @@ namespace facebook { namespace logdevice {
 /**
  * @file Listens to incoming connections and hands them off to Processor
  *       threads.
+ *
+ *       Normally a single ConnectionListener per port runs on its own thread
+ *       and spreads connections over all Workers. With --accept-on-workers,
+ *       every GENERAL Worker runs its own ConnectionListener on its event
+ *       loop, listening on the same port with SO_REUSEPORT, and keeps the
+ *       connections it accepts. The kernel balances connections between
+ *       Workers, so there is no single accept thread to become a bottleneck
+ *       during reconnection storms.
  */
 
 class ConnectionListener : public Listener {
@@ -38,11 +46,19 @@ class ConnectionListener : public Listener {
 
   static const SimpleEnumMap<ListenerType, std::string>& listenerTypeNames();
 
+  /**
+   * @param worker  if valid, `loop` is the event loop of this GENERAL Worker,
+   *                the listening socket is opened with SO_REUSEPORT and all
+   *                accepted connections are handed to this Worker.
+   *                `connection_backlog_budget` is then expected to be this
+   *                Worker's own budget.
+   */
   explicit ConnectionListener(Listener::InterfaceDef iface,
                               KeepAlive loop,
                               std::shared_ptr<SharedState> shared_state,
                               ListenerType listener_type,
-                              ResourceBudget& connection_backlog_budget);
+                              ResourceBudget& connection_backlog_budget,
+                              worker_id_t worker = worker_id_t(-1));
 
   void setProcessor(Processor* processor) {
     processor_ = processor;
@@ -63,6 +79,8 @@ class ConnectionListener : public Listener {
   Processor* processor_ = nullptr;
   std::shared_ptr<SharedState> shared_state_;
   ListenerType listener_type_;
+  // Worker this listener accepts connections for, or -1 if any Worker.
+  const worker_id_t worker_;
 };
 
 }} // namespace facebook::logdevice
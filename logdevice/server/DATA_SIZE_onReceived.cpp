@@ -40,21 +40,22 @@ static void send_reply(const Address& to,
   Worker::onThisThread()->sender().sendMessage(std::move(msg), to);
 }
 
-Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
-                                          const Address& from) {
-  const DATA_SIZE_Header& header = msg->getHeader();
+// Answers a single DATA_SIZE request, either from a DATA_SIZE or from a
+// MULTI_DATA_SIZE message.
+static void handle_request(const DATA_SIZE_Header& header,
+                           const Address& from) {
 
   if (header.log_id == LOGID_INVALID) {
     ld_error("got DATA_SIZE message from %s with invalid log ID, ignoring",
              Sender::describeConnection(from).c_str());
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   ServerWorker* worker = ServerWorker::onThisThread();
   if (!worker->isAcceptingWork()) {
     ld_debug("Ignoring DATA_SIZE message: not accepting more work");
     send_reply(from, header, E::SHUTDOWN, 0);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   WORKER_LOG_STAT_INCR(header.log_id, data_size_received);
@@ -62,7 +63,7 @@ Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
   ServerProcessor* processor = worker->processor_;
   if (!processor->runningOnStorageNode()) {
     send_reply(from, header, E::NOTSTORAGE, 0);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   auto scfg = worker->getServerConfig();
@@ -76,19 +77,19 @@ Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
                     Sender::describeConnection(from).c_str(),
                     shard_idx,
                     n_shards);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   if (processor->isDataMissingFromShard(shard_idx)) {
     send_reply(from, header, E::REBUILDING, 0);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   LogStorageStateMap& map = processor->getLogStorageStateMap();
   LogStorageState* log_state = map.insertOrGet(header.log_id, shard_idx);
   if (log_state == nullptr || log_state->hasPermanentError()) {
     send_reply(from, header, E::FAILED, 0);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   ShardedStorageThreadPool* sstp = processor->sharded_storage_thread_pool_;
@@ -98,6 +99,7 @@ Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
   if (!partitioned_store) {
     // Only supported on partitioned, rocksdb-based stores
     send_reply(from, header, E::NOTSUPPORTED, 0);
+    return;
   }
 
   ld_debug("DATA_SIZE: log %lu in range [%lu,%lu]",
@@ -112,7 +114,7 @@ Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
                     "reporting transient rebuilding state",
                     header.log_id.val_);
     send_reply(from, header, E::REBUILDING, 0);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   size_t size = 0;
@@ -122,6 +124,22 @@ Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
       std::chrono::milliseconds(header.hi_timestamp_ms),
       &size);
   send_reply(from, header, rv == 0 ? E::OK : E::FAILED, size);
+}
+
+Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
+                                          const Address& from) {
+  handle_request(msg->getHeader(), from);
+  return Message::Disposition::NORMAL;
+}
+
+Message::Disposition MULTI_DATA_SIZE_onReceived(MULTI_DATA_SIZE_Message* msg,
+                                                const Address& from) {
+  const std::vector<DATA_SIZE_Header>& requests = msg->getRequests();
+  WORKER_STAT_INCR(multi_data_size_received);
+  WORKER_STAT_ADD(multi_data_size_requests_received, requests.size());
+  for (const DATA_SIZE_Header& header : requests) {
+    handle_request(header, from);
+  }
   return Message::Disposition::NORMAL;
 }
 
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "logdevice/common/protocol/DATA_SIZE_Message.h"
+#include "logdevice/common/protocol/MULTI_DATA_SIZE_Message.h"
 #include "logdevice/common/protocol/Message.h"
 
 namespace facebook { namespace logdevice {
@@ -16,4 +17,9 @@ struct Address;
 
 Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
                                           const Address& from);
+
+// Answers every request of a MULTI_DATA_SIZE as if it came in its own
+// DATA_SIZE message.
+Message::Disposition MULTI_DATA_SIZE_onReceived(MULTI_DATA_SIZE_Message* msg,
+                                                const Address& from);
 }} // namespace facebook::logdevice
@@ -269,17 +269,29 @@ int EpochRecordCache::putRecord(
 
   // it is likely that the record will be stored in cache, pre-allocate
   // its entry
+  const bool inline_payload = payload_raw.size > 0 &&
+      payload_raw.size <= deps_->getInlinePayloadMaxBytes();
   auto entry = std::shared_ptr<EpochRecordCacheEntry>(
-      new EpochRecordCacheEntry(rid.lsn(),
-                                flags,
-                                timestamp,
-                                lng,
-                                wave_or_recovery_epoch,
-                                copyset,
-                                offsets_within_epoch,
-                                std::move(keys),
-                                payload_raw,
-                                payload_holder),
+      inline_payload ? EpochRecordCacheEntry::createWithInlinePayload(
+                           rid.lsn(),
+                           flags,
+                           timestamp,
+                           lng,
+                           wave_or_recovery_epoch,
+                           copyset,
+                           offsets_within_epoch,
+                           std::move(keys),
+                           payload_raw)
+                     : new EpochRecordCacheEntry(rid.lsn(),
+                                                 flags,
+                                                 timestamp,
+                                                 lng,
+                                                 wave_or_recovery_epoch,
+                                                 copyset,
+                                                 offsets_within_epoch,
+                                                 std::move(keys),
+                                                 payload_raw,
+                                                 payload_holder),
       EpochRecordCacheEntry::Disposer(deps_));
 
   ReleasedVector entries_to_drop;
@@ -664,7 +676,8 @@ EpochRecordCache::Snapshot::createFromLinearBuffer(
     const char* buffer,
     size_t size,
     EpochRecordCacheDependencies* deps,
-    size_t* result_size) {
+    size_t* result_size,
+    std::shared_ptr<const void> buffer_owner) {
   ld_check(buffer);
   if (result_size != nullptr) {
     *result_size = 0;
@@ -790,7 +803,8 @@ EpochRecordCache::Snapshot::createFromLinearBuffer(
         buffer + cumulative_size,
         size - cumulative_size,
         EpochRecordCacheEntry::Disposer(deps),
-        &entry_size);
+        &entry_size,
+        buffer_owner);
     if (entry == nullptr) {
       return nullptr;
     }
@@ -863,9 +877,10 @@ EpochRecordCache::fromLinearBuffer(logid_t log_id,
                                    const char* buffer,
                                    size_t size,
                                    EpochRecordCacheDependencies* deps,
-                                   size_t* result_size) {
-  auto snapshot =
-      Snapshot::createFromLinearBuffer(buffer, size, deps, result_size);
+                                   size_t* result_size,
+                                   std::shared_ptr<const void> buffer_owner) {
+  auto snapshot = Snapshot::createFromLinearBuffer(
+      buffer, size, deps, result_size, std::move(buffer_owner));
   if (!snapshot) {
     return nullptr;
   }
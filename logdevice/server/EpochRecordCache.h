@@ -282,12 +282,14 @@ class EpochRecordCache {
     /**
      * Creates a Snapshot from linear memory. If result_size is not nullptr, it
      * will be set to the number of bytes that were used to create the Snapshot.
+     * See EpochRecordCacheEntry::createFromLinearBuffer() for buffer_owner.
      */
     static std::unique_ptr<Snapshot>
     createFromLinearBuffer(const char* buffer,
                            size_t size,
                            EpochRecordCacheDependencies* deps,
-                           size_t* result_size = nullptr);
+                           size_t* result_size = nullptr,
+                           std::shared_ptr<const void> buffer_owner = nullptr);
 
     // for reading the snapshot randomly
     std::pair<bool, Record> getRecord(esn_t esn) const;
@@ -398,7 +400,8 @@ class EpochRecordCache {
   /**
    * Creates an EpochRecordCache from linear memory. If result_size is not
    * nullptr, it will be set to the number of bytes that were used to create
-   * the EpochRecordCache.
+   * the EpochRecordCache. See EpochRecordCacheEntry::createFromLinearBuffer()
+   * for buffer_owner.
    */
   static std::unique_ptr<EpochRecordCache>
   fromLinearBuffer(logid_t log_id,
@@ -406,7 +409,8 @@ class EpochRecordCache {
                    const char* buffer,
                    size_t size,
                    EpochRecordCacheDependencies* deps,
-                   size_t* result_size = nullptr);
+                   size_t* result_size = nullptr,
+                   std::shared_ptr<const void> buffer_owner = nullptr);
 
   static std::unique_ptr<EpochRecordCache>
   createFromSnapshot(logid_t log_id,
@@ -46,9 +46,58 @@ EpochRecordCacheEntry::EpochRecordCacheEntry(
                        payload_raw,
                        std::move(payload_holder)) {}
 
-int EpochRecordCacheEntry::fromLinearBuffer(lsn_t lsn,
-                                            const char* buffer,
-                                            size_t size) {
+EpochRecordCacheEntry* EpochRecordCacheEntry::createWithInlinePayload(
+    lsn_t lsn,
+    STORE_flags_t flags,
+    uint64_t timestamp,
+    esn_t last_known_good,
+    uint32_t wave_or_recovery_epoch,
+    const copyset_t& copyset,
+    OffsetMap offsets_within_epoch,
+    std::map<KeyType, std::string>&& keys,
+    Slice payload_raw) {
+  auto entry = new (InlinePayload{payload_raw.size})
+      EpochRecordCacheEntry(lsn,
+                            flags,
+                            timestamp,
+                            last_known_good,
+                            wave_or_recovery_epoch,
+                            copyset,
+                            std::move(offsets_within_epoch),
+                            std::move(keys),
+                            Slice(nullptr, 0),
+                            nullptr);
+  if (payload_raw.size > 0) {
+    char* inline_payload = reinterpret_cast<char*>(entry + 1);
+    memcpy(inline_payload, payload_raw.data, payload_raw.size);
+    entry->payload_raw = Slice(inline_payload, payload_raw.size);
+  }
+  return entry;
+}
+
+void* EpochRecordCacheEntry::operator new(size_t size,
+                                          InlinePayload inline_payload) {
+  return ::operator new(size + inline_payload.bytes);
+}
+
+void EpochRecordCacheEntry::operator delete(void* ptr,
+                                            InlinePayload /* unused */) {
+  ::operator delete(ptr);
+}
+
+void* EpochRecordCacheEntry::operator new(size_t size) {
+  return ::operator new(size);
+}
+
+void EpochRecordCacheEntry::operator delete(void* ptr) {
+  ::operator delete(ptr);
+}
+
+int EpochRecordCacheEntry::fromLinearBuffer(
+    lsn_t lsn,
+    const char* buffer,
+    size_t size,
+    std::shared_ptr<const void> buffer_owner) {
   this->lsn = lsn;
   if (sizeof(EntryHeader) > size) {
     RATELIMIT_ERROR(std::chrono::seconds(10),
@@ -99,7 +148,21 @@ int EpochRecordCacheEntry::fromLinearBuffer(lsn_t lsn,
   }
 
   // reconstruct payload
-  if (header.payload_size > 0) {
+  if (header.payload_size > 0 && buffer_owner) {
+    // Reference the payload in the buffer. The PayloadHolder doesn't own it,
+    // keep it alongside something that keeps the buffer alive.
+    struct BufferPayloadHolder {
+      std::shared_ptr<const void> owner;
+      PayloadHolder holder;
+    };
+    payload_raw = Slice(buffer + current_size, header.payload_size);
+    auto holder = std::make_shared<BufferPayloadHolder>(BufferPayloadHolder{
+        std::move(buffer_owner),
+        PayloadHolder(Payload(payload_raw.data, payload_raw.size),
+                      PayloadHolder::UNOWNED)});
+    payload_holder_ = std::shared_ptr<PayloadHolder>(holder, &holder->holder);
+    current_size += header.payload_size;
+  } else if (header.payload_size > 0) {
     void* data = malloc(header.payload_size);
     memcpy(data, buffer + current_size, header.payload_size);
     // Copy payload size to local var since it's in a packed struct; else we'd
@@ -186,14 +249,17 @@ ssize_t EpochRecordCacheEntry::toLinearBuffer(char* buffer, size_t size) const {
 }
 
 std::shared_ptr<EpochRecordCacheEntry>
-EpochRecordCacheEntry::createFromLinearBuffer(lsn_t lsn,
-                                              const char* buffer,
-                                              size_t size,
-                                              Disposer disposer,
-                                              size_t* result_size) {
+EpochRecordCacheEntry::createFromLinearBuffer(
+    lsn_t lsn,
+    const char* buffer,
+    size_t size,
+    Disposer disposer,
+    size_t* result_size,
+    std::shared_ptr<const void> buffer_owner) {
   auto result = std::shared_ptr<EpochRecordCacheEntry>(
       new EpochRecordCacheEntry(), disposer);
-  ssize_t linear_size = result->fromLinearBuffer(lsn, buffer, size);
+  ssize_t linear_size =
+      result->fromLinearBuffer(lsn, buffer, size, std::move(buffer_owner));
   if (result_size != nullptr) {
     *result_size = linear_size;
   }
@@ -41,13 +41,17 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
    *
    * If result_size is not nullptr, it will be set to the size in the buffer
    * that the reconstructed entry was using, or 0 if the buffer is too small.
+   *
+   * If buffer_owner is not nullptr, the payload is not copied: the entry
+   * references it in `buffer' and keeps buffer_owner alive.
    */
   static std::shared_ptr<EpochRecordCacheEntry>
   createFromLinearBuffer(lsn_t lsn,
                          const char* buffer,
                          size_t size,
                          Disposer disposer,
-                         size_t* result_size = nullptr);
+                         size_t* result_size = nullptr,
+                         std::shared_ptr<const void> buffer_owner = nullptr);
 
   /**
    * Calculate the size that this cache, in its current state, would have in
@@ -61,6 +65,31 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
    */
   ssize_t toLinearBuffer(char* buffer, size_t size) const;
 
+  /**
+   * Creates an entry whose payload is copied right after the entry object,
+   * in the same allocation, instead of being referenced through a
+   * PayloadHolder. Used for small payloads, for which the holder, its
+   * control block and the (possibly much larger) buffer it pins would take
+   * more memory than the payload itself. The entry has no PayloadHolder and
+   * is freed with a single deallocation.
+   *
+   * The returned pointer is owned by the caller, same as `new'.
+   */
+  static EpochRecordCacheEntry*
+  createWithInlinePayload(lsn_t lsn,
+                          STORE_flags_t flags,
+                          uint64_t timestamp,
+                          esn_t last_known_good,
+                          uint32_t wave_or_recovery_epoch,
+                          const copyset_t& copyset,
+                          OffsetMap offsets_within_epoch,
+                          std::map<KeyType, std::string>&& keys,
+                          Slice payload_raw);
+
+  // Declared because the placement forms below would hide the global ones.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+
   EpochRecordCacheEntry();
 
   EpochRecordCacheEntry(lsn_t lsn,
@@ -75,7 +104,18 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
                         std::shared_ptr<PayloadHolder> payload_holder);
 
  private:
-  int fromLinearBuffer(lsn_t lsn, const char* buffer, size_t size);
+  // Allocates `bytes' extra bytes after the object for the payload of
+  // createWithInlinePayload().
+  struct InlinePayload {
+    size_t bytes;
+  };
+  static void* operator new(size_t size, InlinePayload inline_payload);
+  static void operator delete(void* ptr, InlinePayload inline_payload);
+
+  int fromLinearBuffer(lsn_t lsn,
+                       const char* buffer,
+                       size_t size,
+                       std::shared_ptr<const void> buffer_owner);
 
   friend class ZeroCopiedRecord;
   friend class EpochRecordCacheSerializer::EpochRecordCacheCompare;
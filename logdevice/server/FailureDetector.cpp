@@ -22,6 +22,10 @@
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/util.h"
 #include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/storage_tasks/DigestPrefetchStorageTask.h"
+#include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
+#include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
 namespace facebook { namespace logdevice {
 
@@ -980,6 +984,10 @@ void FailureDetector::updateDependencies(node_index_t idx,
     }
   }
 
+  if (is_dead && cs->isNodeAlive(idx)) {
+    prefetchRecoveryDigests(idx);
+  }
+
   ClusterState::NodeState state;
   if (is_dead) {
     state = failover ? ClusterState::NodeState::FAILING_OVER
@@ -992,6 +1000,21 @@ void FailureDetector::updateDependencies(node_index_t idx,
   cs->setNodeState(idx, state);
 }
 
+void FailureDetector::prefetchRecoveryDigests(node_index_t idx) {
+  const size_t max_bytes =
+      processor_->settings()->recovery_digest_prefetch_max_bytes;
+  ShardedStorageThreadPool* pool = processor_->sharded_storage_thread_pool_;
+  ServerWorker* w = ServerWorker::onThisThread(false);
+  if (max_bytes == 0 || pool == nullptr || w == nullptr) {
+    // disabled, not a storage node, or not on a worker (in tests)
+    return;
+  }
+  for (shard_index_t shard = 0; shard < pool->numShards(); ++shard) {
+    w->getStorageTaskQueueForShard(shard)->putTask(
+        std::make_unique<DigestPrefetchStorageTask>(idx, max_bytes));
+  }
+}
+
 void FailureDetector::updateNodeState(node_index_t idx,
                                       bool dead,
                                       bool self,
@@ -385,6 +385,10 @@ class FailureDetector {
                           bool failover,
                           bool starting);
 
+  // Called when node `idx` is declared dead. On storage nodes, schedules
+  // DigestPrefetchStorageTasks for the logs whose sequencer ran on it.
+  void prefetchRecoveryDigests(node_index_t idx);
+
   // Monotonically increasing instance ID of logdeviced
   // This is used to distinguish b/w server instances across restarts.
   std::chrono::milliseconds instance_id_;
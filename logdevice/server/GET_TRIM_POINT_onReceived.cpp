@@ -89,6 +89,15 @@ Message::Disposition GET_TRIM_POINT_onReceived(GET_TRIM_POINT_Message* msg,
     return Message::Disposition::NORMAL;
   }
 
+  if (Worker::settings().push_trim_points) {
+    // Only sequencers ask for trim points. Push later advances to the node
+    // that asked last, which runs the current sequencer of the log.
+    NodeID node = worker->sender().getNodeID(from);
+    if (node.isNodeID()) {
+      log_state->setTrimPointSubscriber(node.index());
+    }
+  }
+
   folly::Optional<lsn_t> trim_point = log_state->getTrimPoint();
   if (!trim_point.hasValue()) {
     // Trim point is unknown. Try to find it...
@@ -92,7 +92,7 @@ void IOFaultInjection::setFaultInjection(shard_index_t shard_idx,
                                          FaultType fault_type,
                                          InjectMode mode,
                                          double percent_chance,
-                                         std::chrono::milliseconds latency) {
+                                         LatencyDistribution latency) {
   uint32_t chance =
       std::min((double)UINT32_MAX, percent_chance / 100 * UINT32_MAX);
 
@@ -119,7 +119,8 @@ IOFaultInjection::getLatencyToInject(shard_index_t shard_idx) {
     return std::chrono::milliseconds(0);
   }
   ld_check(shard_idx < shard_settings_.size());
-  return shard_settings_[shard_idx]->latency();
+  return shard_settings_[shard_idx].rlock()->latency().sample(
+      latency_samples_.fetch_add(1, std::memory_order_relaxed));
 }
 
 template <>
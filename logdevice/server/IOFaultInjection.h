@@ -12,6 +12,7 @@
 #include <folly/Random.h>
 #include <folly/Synchronized.h>
 
+#include "logdevice/common/LatencyInjection.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Err.h"
 
@@ -53,13 +54,20 @@ class IOFaultInjection {
              FaultType f,
              InjectMode m,
              uint32_t c,
-             std::chrono::milliseconds l)
+             LatencyDistribution l)
         : data_type_(d),
           io_type_(i),
           fault_type_(f),
           mode_(m),
           chance_(c),
           latency_(l) {}
+    Settings(DataType d,
+             IOType i,
+             FaultType f,
+             InjectMode m,
+             uint32_t c,
+             std::chrono::milliseconds l)
+        : Settings(d, i, f, m, c, LatencyDistribution(l)) {}
 
     DataType dataType() const {
       return data_type_;
@@ -76,7 +84,7 @@ class IOFaultInjection {
     uint32_t chance() const {
       return chance_;
     }
-    std::chrono::milliseconds latency() const {
+    const LatencyDistribution& latency() const {
       return latency_;
     }
 
@@ -90,17 +98,18 @@ class IOFaultInjection {
     FaultType fault_type_{FaultType::NONE};
     InjectMode mode_{InjectMode::OFF};
     uint32_t chance_{UINT32_MAX};
-    std::chrono::milliseconds latency_{std::chrono::milliseconds(0)};
+    LatencyDistribution latency_;
   };
 
-  // Configure fault injection to occur on one or all shards.
+  // Configure fault injection to occur on one or all shards. `latency' is
+  // only used with FaultType::LATENCY.
   void setFaultInjection(shard_index_t shard_idx,
                          DataType d_type,
                          IOType io_type,
                          FaultType fault_type,
                          InjectMode mode,
                          double percent_chance,
-                         std::chrono::milliseconds latency);
+                         LatencyDistribution latency);
 
   // @param  fault_types    a bitset containing all FaultTypes injectable at
   //                        the callsite
@@ -118,11 +127,14 @@ class IOFaultInjection {
                              FaultTypeBitSet fault_types,
                              DataType d_type = DataType::ALL);
 
+  // @return a sample of the latency distribution configured for the shard.
   std::chrono::milliseconds getLatencyToInject(shard_index_t shard_idx);
 
  private:
   std::vector<folly::Synchronized<Settings>> shard_settings_;
   std::atomic<bool> enable_fault_injection_{false};
+  // Index of the next latency sample, see LatencyDistribution::sample().
+  std::atomic<uint64_t> latency_samples_{0};
 };
 
 extern EnumMap<IOFaultInjection::FaultType, std::string> fault_type_names;
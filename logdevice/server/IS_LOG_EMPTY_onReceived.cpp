@@ -44,11 +44,11 @@ static void send_reply(const Address& to,
   Worker::onThisThread()->sender().sendMessage(std::move(msg), to);
 }
 
-Message::Disposition
-IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
-                        const Address& from,
-                        PermissionCheckStatus permission_status) {
-  const IS_LOG_EMPTY_Header& header = msg->getHeader();
+// Answers a single IS_LOG_EMPTY request, either from an IS_LOG_EMPTY or from
+// a MULTI_IS_LOG_EMPTY message.
+static void handle_request(const IS_LOG_EMPTY_Header& header,
+                           const Address& from,
+                           PermissionCheckStatus permission_status) {
 
   Status status = PermissionChecker::toStatus(permission_status);
   if (status != E::OK) {
@@ -62,20 +62,20 @@ IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
         error_description(status));
 
     send_reply(from, header, status, false);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   if (header.log_id == LOGID_INVALID) {
     ld_error("got IS_LOG_EMPTY message from %s with invalid log ID, ignoring",
              Sender::describeConnection(from).c_str());
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   ServerWorker* worker = ServerWorker::onThisThread();
   if (!worker->isAcceptingWork()) {
     ld_debug("Ignoring IS_LOG_EMPTY message: not accepting more work");
     send_reply(from, header, E::SHUTDOWN, false);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   WORKER_LOG_STAT_INCR(header.log_id, is_log_empty_received);
@@ -83,7 +83,7 @@ IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
   ServerProcessor* processor = worker->processor_;
   if (!processor->runningOnStorageNode()) {
     send_reply(from, header, E::NOTSTORAGE, false);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   auto scfg = worker->getServerConfig();
@@ -97,19 +97,19 @@ IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
                     Sender::describeConnection(from).c_str(),
                     shard_idx,
                     n_shards);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   if (processor->isDataMissingFromShard(shard_idx)) {
     send_reply(from, header, E::REBUILDING, false);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   LogStorageStateMap& map = processor->getLogStorageStateMap();
   LogStorageState* log_state = map.insertOrGet(header.log_id, shard_idx);
   if (log_state == nullptr || log_state->hasPermanentError()) {
     send_reply(from, header, E::FAILED, false);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   folly::Optional<lsn_t> trim_point = log_state->getTrimPoint();
@@ -122,7 +122,7 @@ IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
 
     // And in the meantime tell the client to try again in a bit
     send_reply(from, header, rv == 0 ? E::AGAIN : E::FAILED, false);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   ShardedStorageThreadPool* sstp = processor->sharded_storage_thread_pool_;
@@ -145,7 +145,7 @@ IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
                     error_description(err));
     // an error occurred, reply to the client
     send_reply(from, header, err, false);
-    return Message::Disposition::NORMAL;
+    return;
   }
 
   ld_debug("IS_LOG_EMPTY(%lu): last_lsn=%lu, trim_point=%lu",
@@ -166,7 +166,7 @@ IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
                       "partitions, reporting non-empty",
                       header.log_id.val_);
       send_reply(from, header, E::REBUILDING, false);
-      return Message::Disposition::NORMAL;
+      return;
     }
   } else {
     // Make sure it's not just pseudorecords, such as bridge records.
@@ -176,6 +176,27 @@ IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
   }
 
   send_reply(from, header, E::OK, empty);
+}
+
+Message::Disposition
+IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
+                        const Address& from,
+                        PermissionCheckStatus permission_status) {
+  handle_request(msg->getHeader(), from, permission_status);
+  return Message::Disposition::NORMAL;
+}
+
+Message::Disposition MULTI_IS_LOG_EMPTY_onReceived(
+    MULTI_IS_LOG_EMPTY_Message* msg,
+    const Address& from,
+    const std::vector<PermissionCheckStatus>& permission_statuses) {
+  const std::vector<IS_LOG_EMPTY_Header>& requests = msg->getRequests();
+  ld_check(permission_statuses.size() == requests.size());
+  WORKER_STAT_INCR(multi_is_log_empty_received);
+  WORKER_STAT_ADD(multi_is_log_empty_requests_received, requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    handle_request(requests[i], from, permission_statuses[i]);
+  }
   return Message::Disposition::NORMAL;
 }
 
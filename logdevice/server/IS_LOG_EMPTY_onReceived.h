@@ -7,8 +7,11 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "logdevice/common/PermissionChecker.h"
 #include "logdevice/common/protocol/IS_LOG_EMPTY_Message.h"
+#include "logdevice/common/protocol/MULTI_IS_LOG_EMPTY_Message.h"
 #include "logdevice/common/protocol/Message.h"
 
 namespace facebook { namespace logdevice {
@@ -19,4 +22,14 @@ Message::Disposition
 IS_LOG_EMPTY_onReceived(IS_LOG_EMPTY_Message* msg,
                         const Address& from,
                         PermissionCheckStatus permission_status);
+
+/**
+ * Answers every request of a MULTI_IS_LOG_EMPTY as if it came in its own
+ * IS_LOG_EMPTY message. `permission_statuses` has the outcome of the READ
+ * permission check of each request, in the same order.
+ */
+Message::Disposition MULTI_IS_LOG_EMPTY_onReceived(
+    MULTI_IS_LOG_EMPTY_Message* msg,
+    const Address& from,
+    const std::vector<PermissionCheckStatus>& permission_statuses);
 }} // namespace facebook::logdevice
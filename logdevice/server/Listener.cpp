@@ -31,7 +31,9 @@ namespace {
  * on the specified address.  Mostly copied from evconnlistener_new_bind()
  * implementation, with the addition of making ipv6 addresses ipv6-only.
  */
-int new_listener_socket(const struct sockaddr* sa, int socklen) {
+int new_listener_socket(const struct sockaddr* sa,
+                        int socklen,
+                        bool reuse_port) {
   int family = sa->sa_family;
   int fd = socket(family, SOCK_STREAM, 0);
   int off = 0, on = 1;
@@ -65,6 +67,15 @@ int new_listener_socket(const struct sockaddr* sa, int socklen) {
     }
   }
 
+  if (reuse_port && (family == AF_INET6 || family == AF_INET)) {
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (void*)&on, sizeof on) != 0) {
+      ld_error("setsockopt() failed to set SO_REUSEPORT, errno=%d (%s)",
+               errno,
+               strerror(errno));
+      goto err;
+    }
+  }
+
   if (family == AF_INET6) {
     // Make sure ipv6 sockets are ipv6-only
     if (setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, (void*)&on, sizeof on) != 0) {
@@ -89,6 +100,7 @@ err:
 }
 
 int setupTcpSockets(const Listener::InterfaceDef& iface,
+                    bool reuse_port,
                     std::vector<int>& fds_out) {
   ld_check(iface.isPort());
   struct addrinfo hints;
@@ -111,7 +123,7 @@ int setupTcpSockets(const Listener::InterfaceDef& iface,
   };
 
   for (struct addrinfo* ai = result; ai != nullptr; ai = ai->ai_next) {
-    int fd = new_listener_socket(ai->ai_addr, ai->ai_addrlen);
+    int fd = new_listener_socket(ai->ai_addr, ai->ai_addrlen, reuse_port);
     if (fd == -1) {
       return -1;
     }
@@ -129,7 +141,8 @@ int setupUnixSocket(const Listener::InterfaceDef& iface,
   Sockaddr addr(iface.path());
   struct sockaddr_storage ss;
   int len = addr.toStructSockaddr(&ss);
-  int fd = new_listener_socket(reinterpret_cast<struct sockaddr*>(&ss), len);
+  int fd = new_listener_socket(
+      reinterpret_cast<struct sockaddr*>(&ss), len, /*reuse_port=*/false);
   if (fd == -1) {
     return -1;
   }
@@ -150,8 +163,10 @@ void accept_error_callback(struct evconnlistener* /*listener*/, void* /*arg*/) {
 
 } // namespace
 
-Listener::Listener(InterfaceDef iface, KeepAlive loop)
-    : iface_(std::move(iface)), loop_(loop) {}
+Listener::Listener(InterfaceDef iface, KeepAlive loop, bool reuse_port)
+    : iface_(std::move(iface)), loop_(loop), reuse_port_(reuse_port) {
+  ld_check(!reuse_port_ || iface_.isPort());
+}
 
 Listener::~Listener() {
   stopAcceptingConnections().wait();
@@ -191,7 +206,7 @@ bool Listener::setupEvConnListeners() {
     return true;
   }
   std::vector<int> fds;
-  int rv = iface_.isPort() ? setupTcpSockets(iface_, fds)
+  int rv = iface_.isPort() ? setupTcpSockets(iface_, reuse_port_, fds)
                            : setupUnixSocket(iface_, fds);
   if (rv != 0) {
     for (auto fd : fds) {
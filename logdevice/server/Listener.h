@@ -73,7 +73,16 @@ class Listener {
     bool ssl_;
   };
 
-  explicit Listener(InterfaceDef iface, KeepAlive loop);
+  /**
+   * @param reuse_port  if true, TCP listening sockets are created with
+   *                    SO_REUSEPORT, so that several Listeners can listen on
+   *                    the same port and have the kernel spread incoming
+   *                    connections among them. Not supported for unix
+   *                    domain sockets.
+   */
+  explicit Listener(InterfaceDef iface,
+                    KeepAlive loop,
+                    bool reuse_port = false);
 
   virtual ~Listener();
 
@@ -88,6 +97,10 @@ class Listener {
    */
   folly::SemiFuture<folly::Unit> stopAcceptingConnections();
 
+  const InterfaceDef& getInterface() const {
+    return iface_;
+  }
+
  protected:
   /**
    * Triggered by libevent when there is a new incoming connection.
@@ -112,6 +125,9 @@ class Listener {
   // EventLoop on which listener is running
   KeepAlive loop_;
 
+  // Set SO_REUSEPORT on listening sockets.
+  const bool reuse_port_;
+
   // list of pointers to evconnlistener structs, used to ensure they're properly
   // released when this object is destroyed
   typedef std::unique_ptr<evconnlistener, std::function<void(evconnlistener*)>>
@@ -8,8 +8,31 @@
 
 #include "logdevice/server/LocalLogFile.h"
 
+#include "logdevice/common/ThreadID.h"
+#include "logdevice/common/stats/Stats.h"
+
 namespace facebook { namespace logdevice {
 
+LocalLogFile::LocalLogFile(size_t queue_size,
+                           std::chrono::milliseconds fsync_interval,
+                           StatsHolder* stats)
+    : queue_size_(queue_size), fsync_interval_(fsync_interval), stats_(stats) {
+  if (queue_size_ > 0) {
+    thread_ = std::thread([this] { threadMain(); });
+  }
+}
+
+LocalLogFile::~LocalLogFile() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+}
+
 int LocalLogFile::open(const std::string& path) {
   return file_.open(path.c_str(),
                     O_APPEND | O_CREAT | O_WRONLY,
@@ -19,7 +42,92 @@ int LocalLogFile::open(const std::string& path) {
   );
 }
 
+void LocalLogFile::close() {
+  file_.close();
+}
+
 void LocalLogFile::reopen() {
   file_.reopen();
 }
+
+size_t LocalLogFile::writeEntry(const char* buf, size_t size) {
+  if (queue_size_ == 0) {
+    return file_.write(buf, size);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= queue_size_) {
+      STAT_INCR(stats_, local_log_file_entries_dropped);
+      return 0;
+    }
+    queue_.emplace_back(buf, size);
+  }
+  cv_.notify_one();
+  return size;
+}
+
+void LocalLogFile::threadMain() {
+  ThreadID::set(ThreadID::Type::UTILITY, "ld:local-log");
+
+  using Clock = std::chrono::steady_clock;
+  // Whether data was written since the last fsync, and when to fsync it.
+  bool fsync_pending = false;
+  Clock::time_point next_fsync;
+  std::vector<std::string> entries;
+  std::string batch;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    auto ready = [&] { return shutdown_ || !queue_.empty(); };
+    if (fsync_pending) {
+      cv_.wait_until(lock, next_fsync, ready);
+    } else {
+      cv_.wait(lock, ready);
+    }
+    entries.swap(queue_);
+    const bool shutdown = shutdown_;
+    lock.unlock();
+
+    if (!entries.empty()) {
+      batch.clear();
+      for (const std::string& entry : entries) {
+        batch += entry;
+      }
+      ssize_t rv = file_.write(batch.data(), batch.size());
+      if (rv < 0 || size_t(rv) != batch.size()) {
+        STAT_INCR(stats_, local_log_file_write_errors);
+        RATELIMIT_ERROR(std::chrono::seconds(10),
+                        1,
+                        "Failed to write %zu entries to a local log file: %s",
+                        entries.size(),
+                        rv < 0 ? strerror(errno) : "short write");
+      } else {
+        STAT_INCR(stats_, local_log_file_batches_written);
+        STAT_ADD(stats_, local_log_file_entries_written, entries.size());
+      }
+      entries.clear();
+      if (fsync_interval_.count() > 0 && !fsync_pending) {
+        fsync_pending = true;
+        next_fsync = Clock::now() + fsync_interval_;
+      }
+    }
+
+    if (fsync_pending && (shutdown || Clock::now() >= next_fsync)) {
+      if (file_.fsync() != 0) {
+        STAT_INCR(stats_, local_log_file_write_errors);
+        RATELIMIT_ERROR(std::chrono::seconds(10),
+                        1,
+                        "Failed to fsync a local log file: %s",
+                        strerror(errno));
+      }
+      fsync_pending = false;
+    }
+
+    lock.lock();
+    if (shutdown && queue_.empty()) {
+      break;
+    }
+  }
+}
+
 }} // namespace facebook::logdevice
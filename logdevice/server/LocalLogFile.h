@@ -7,13 +7,21 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "logdevice/server/RotatingFile.h"
 
 namespace facebook { namespace logdevice {
 
+class StatsHolder;
+
 /**
  * @file
  *
@@ -23,10 +31,34 @@ namespace facebook { namespace logdevice {
  *
  * Reopen funtionality provides ability to reopen a file without blocking
  * writers. Reopen process is seamless to writers.
+ *
+ * If created with a non-zero queue size, entries are instead handed to a
+ * background thread, which writes them in batches and fdatasync()s the file
+ * every fsync_interval, so that a slow disk never blocks the writers. Entries
+ * that don't fit in the queue are dropped (see the
+ * local_log_file_entries_dropped stat).
  */
 
 class LocalLogFile {
  public:
+  /**
+   * @param queue_size      maximum number of entries waiting to be written by
+   *                        the background thread; 0 to write synchronously
+   *                        from the calling thread
+   * @param fsync_interval  how often the background thread flushes the file
+   *                        to disk; 0 to never fsync
+   * @param stats           for the local_log_file_* stats, can be nullptr
+   */
+  explicit LocalLogFile(
+      size_t queue_size = 0,
+      std::chrono::milliseconds fsync_interval = std::chrono::milliseconds(0),
+      StatsHolder* stats = nullptr);
+
+  /**
+   * Writes all queued entries before returning.
+   */
+  ~LocalLogFile();
+
   /**
    * Opens a file with O_APPEND | O_CREAT | O_WRONLY. Result is propagated from
    * underlying call to ::open(const char* path, int flags) and error handling
@@ -60,6 +92,23 @@ class LocalLogFile {
 
  private:
   RotatingFile file_;
+
+  const size_t queue_size_;
+  const std::chrono::milliseconds fsync_interval_;
+  StatsHolder* const stats_;
+
+  // Protects all the members below.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Entries waiting for the background thread, already serialized.
+  std::vector<std::string> queue_;
+  bool shutdown_{false};
+  std::thread thread_;
+
+  // Writes the entry, or queues it for the background thread.
+  size_t writeEntry(const char* buf, size_t size);
+
+  void threadMain();
 };
 
 template <typename T>
@@ -67,6 +116,7 @@ size_t LocalLogFile::write(const T& data) {
   constexpr int BUFSIZE = 2048;
   std::array<char, BUFSIZE> buf;
   size_t size = to_log_entry(data, &buf.front(), buf.size());
-  return file_.write(&buf.front(), size);
+  // snprintf() returns the size the entry would have had if it's truncated
+  return writeEntry(&buf.front(), std::min(size, buf.size() - 1));
 }
 }} // namespace facebook::logdevice
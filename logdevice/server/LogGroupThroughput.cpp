@@ -20,10 +20,12 @@ namespace facebook { namespace logdevice {
 
 // Accesses thread-local per-log-group stats and aggregates them all into a
 // big map
-AggregateMap doAggregate(StatsHolder* stats,
-                         std::string time_series_,
-                         const std::vector<Duration>& intervals,
-                         std::shared_ptr<LogsConfig> logs_config) {
+AggregateMap
+doAggregate(StatsHolder* stats,
+            std::string time_series_,
+            const std::vector<Duration>& intervals,
+            std::shared_ptr<LogsConfig> logs_config,
+            const std::unordered_set<std::string>* only_log_groups) {
   // Okay...  For each thread, for each log group in the thread-local
   // PerLogStats, for each query interval, calculate the rate in B/s and
   // aggregate.  Output is a map (log group, query interval) -> (sum of
@@ -44,51 +46,105 @@ AggregateMap doAggregate(StatsHolder* stats,
 #include "logdevice/common/stats/per_log_time_series.inc" // nolint
   ld_check(member_ptr != nullptr);
 
+  auto aggregate_one = [&](const std::string& clean_name, PerLogStats& entry) {
+    std::lock_guard<std::mutex> guard(entry.mutex);
+
+    auto stat = entry.*member_ptr;
+    if (!stat) {
+      return;
+    }
+
+    auto& time_series = *stat->timeSeries_;
+    // NOTE: It might be tempting to pull `now' out of the loops but
+    // folly::MultiLevelTimeSeries barfs if we ask it for data that is
+    // too old.  Keep it under the lock for now, optimize if necessary.
+    //
+    // TODO: Constructing the TimePoint is slightly awkward at the moment
+    // as the folly stats code is being cleaned up to better support real
+    // clock types.  appendBytesTimeSeries_ should simply be changed to
+    // use std::steady_clock as it's clock type.  I'll do that in a
+    // separate diff for now, though.
+    const TimePoint now{std::chrono::duration_cast<Duration>(
+        std::chrono::steady_clock::now().time_since_epoch())};
+    // Flush any cached updates and discard any stale data
+    time_series.update(now);
+
+    auto& aggregate_vector = output[clean_name];
+    aggregate_vector.resize(intervals.size());
+    // For each query interval, make a MultiLevelTimeSeries::rate() call
+    // to find the approximate rate over that interval
+    for (int i = 0; i < intervals.size(); ++i) {
+      auto rate_per_time_type =
+          time_series.rate<RateType>(now - intervals[i], now);
+      // Duration may not be seconds, convert to seconds
+      aggregate_vector[i] +=
+          rate_per_time_type * Duration::period::den / Duration::period::num;
+    }
+  };
+
   stats->runForEach([&](facebook::logdevice::Stats& s) {
+    if (only_log_groups) {
+      // Look up the few requested log groups rather than copying the whole
+      // map.
+      std::vector<std::pair<std::string, std::shared_ptr<PerLogStats>>>
+          entries;
+      s.per_log_stats.withRLock([&](const auto& per_log_stats) {
+        for (const std::string& log_group : *only_log_groups) {
+          auto it = per_log_stats.find(log_group);
+          if (it != per_log_stats.end()) {
+            entries.emplace_back(*it);
+          }
+        }
+      });
+      for (auto& entry : entries) {
+        aggregate_one(entry.first, *entry.second);
+      }
+      return;
+    }
+
     // Use synchronizedCopy() so we do not have to hold a read lock on
     // per_log_stats map while we iterate over individual entries.
     for (auto& entry :
          s.synchronizedCopy(&facebook::logdevice::Stats::per_log_stats)) {
-      std::lock_guard<std::mutex> guard(entry.second->mutex);
-      std::string& clean_name = entry.first;
-
-      auto stat = entry.second.get()->*member_ptr;
-      if (!stat) {
-        continue;
-      }
-
-      auto& time_series = *stat->timeSeries_;
-      // NOTE: It might be tempting to pull `now' out of the loops but
-      // folly::MultiLevelTimeSeries barfs if we ask it for data that is
-      // too old.  Keep it under the lock for now, optimize if necessary.
-      //
-      // TODO: Constructing the TimePoint is slightly awkward at the moment
-      // as the folly stats code is being cleaned up to better support real
-      // clock types.  appendBytesTimeSeries_ should simply be changed to
-      // use std::steady_clock as it's clock type.  I'll do that in a
-      // separate diff for now, though.
-      const TimePoint now{std::chrono::duration_cast<Duration>(
-          std::chrono::steady_clock::now().time_since_epoch())};
-      // Flush any cached updates and discard any stale data
-      time_series.update(now);
-
-      auto& aggregate_vector = output[clean_name];
-      aggregate_vector.resize(intervals.size());
-      // For each query interval, make a MultiLevelTimeSeries::rate() call
-      // to find the approximate rate over that interval
-      for (int i = 0; i < intervals.size(); ++i) {
-        auto rate_per_time_type =
-            time_series.rate<RateType>(now - intervals[i], now);
-        // Duration may not be seconds, convert to seconds
-        aggregate_vector[i] +=
-            rate_per_time_type * Duration::period::den / Duration::period::num;
-      }
+      aggregate_one(entry.first, *entry.second);
     }
   });
 
   return output;
 }
 
+folly::Optional<std::unordered_set<std::string>>
+getTopLogGroupCandidates(StatsHolder* stats,
+                         std::string time_series,
+                         size_t top) {
+  std::unique_ptr<TopLogGroups> facebook::logdevice::Stats::*member_ptr =
+      nullptr;
+#define TIME_SERIES_DEFINE(name, strings, _, __)                       \
+  for (const std::string& str : strings) {                             \
+    if (str == time_series) {                                          \
+      member_ptr = &facebook::logdevice::Stats::top_log_groups_##name; \
+      break;                                                           \
+    }                                                                  \
+  }
+#include "logdevice/common/stats/per_log_time_series.inc" // nolint
+  ld_check(member_ptr != nullptr);
+
+  bool too_many = false;
+  std::unordered_set<std::string> candidates;
+  stats->runForEach([&](facebook::logdevice::Stats& s) {
+    const TopLogGroups& sketch = *(s.*member_ptr);
+    if (top > sketch.capacity()) {
+      too_many = true;
+      return;
+    }
+    sketch.getCandidates(candidates);
+  });
+  if (too_many) {
+    return folly::none;
+  }
+  return candidates;
+}
+
 Duration getMaxInterval(StatsHolder* stats_holder, std::string time_series) {
 #define TIME_SERIES_DEFINE(name, strings, _, __)                        \
   for (const std::string& str : strings) {                              \
@@ -7,6 +7,9 @@
  */
 #pragma once
 
+#include <unordered_set>
+
+#include <folly/Optional.h>
 #include <folly/experimental/StringKeyedUnorderedMap.h>
 #include <folly/small_vector.h>
 #include <folly/stats/MultiLevelTimeSeries.h>
@@ -28,10 +31,26 @@ using TimePoint = PerLogTimeSeries::TimeSeries::TimePoint;
 
 using AggregateMap = folly::StringKeyedUnorderedMap<OneGroupResults>;
 
-AggregateMap doAggregate(StatsHolder* stats,
-                         std::string time_series_,
-                         const std::vector<Duration>& intervals,
-                         std::shared_ptr<LogsConfig> logs_config);
+/**
+ * @param only_log_groups  If not null, only these log groups are aggregated.
+ */
+AggregateMap
+doAggregate(StatsHolder* stats,
+            std::string time_series_,
+            const std::vector<Duration>& intervals,
+            std::shared_ptr<LogsConfig> logs_config,
+            const std::unordered_set<std::string>* only_log_groups = nullptr);
+
+/**
+ * Returns the log groups that may be among the `top' with the highest
+ * throughput in `time_series', according to the TopLogGroups sketch of each
+ * thread, or folly::none if `top' is too big for the sketches. A log group
+ * whose traffic is spread thinly over many threads may be missed.
+ */
+folly::Optional<std::unordered_set<std::string>>
+getTopLogGroupCandidates(StatsHolder* stats,
+                         std::string time_series,
+                         size_t top);
 
 Duration getMaxInterval(StatsHolder* stats_holder, std::string time_series);
 
@@ -10,6 +10,7 @@
 #include <boost/filesystem.hpp>
 #include <folly/Memory.h>
 
+#include "logdevice/common/MemoryGovernor.h"
 #include "logdevice/common/ThreadID.h"
 #include "logdevice/server/RebuildingSupervisor.h"
 #include "logdevice/server/ServerProcessor.h"
@@ -405,6 +406,9 @@ void LogStoreMonitor::threadMain() {
     checkFreeSpace();
     // request rebuilding if needed
     checkNeedRebuilding();
+    // shrink memory budgets if the process uses too much memory
+    MemoryGovernor::get()->rebalance(
+        processor_->settings()->memory_governor_limit_bytes);
 
     // sleep for a certain interval before the next iteration
     std::unique_lock<std::mutex> lock(mutex_);
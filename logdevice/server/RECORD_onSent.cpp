@@ -17,6 +17,28 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// Bumps the per-traffic-class, per-log and per-log-group stats for a record
+// that was sent, either alone or as part of a RECORD_BATCH.
+void noteRecordSent(const RECORD_Message& msg) {
+  WORKER_TRAFFIC_CLASS_STAT_INCR(msg.tc_, record_messages_sent);
+  WORKER_TRAFFIC_CLASS_STAT_ADD(
+      msg.tc_, record_payload_bytes, msg.payload_.size());
+  WORKER_LOG_STAT_ADD(
+      msg.header_.log_id, record_payload_bytes, msg.payload_.size());
+  WORKER_LOG_STAT_INCR(msg.header_.log_id, records_sent);
+  // Bump the per-log-group stats
+  if (msg.log_group_path_) {
+    LOG_GROUP_TIME_SERIES_ADD(Worker::stats(),
+                              record_bytes,
+                              *msg.log_group_path_,
+                              msg.payload_.size());
+  }
+}
+
+} // namespace
+
 void RECORD_onSent(const RECORD_Message& msg,
                    Status st,
                    const Address& to,
@@ -31,12 +53,7 @@ void RECORD_onSent(const RECORD_Message& msg,
   }
 
   ServerWorker* w = ServerWorker::onThisThread();
-  WORKER_TRAFFIC_CLASS_STAT_INCR(msg.tc_, record_messages_sent);
-  WORKER_TRAFFIC_CLASS_STAT_ADD(
-      msg.tc_, record_payload_bytes, msg.payload_.size());
-  WORKER_LOG_STAT_ADD(
-      msg.header_.log_id, record_payload_bytes, msg.payload_.size());
-  WORKER_LOG_STAT_INCR(msg.header_.log_id, records_sent);
+  noteRecordSent(msg);
 
   if (msg.source_ == RECORD_Message::Source::CACHED_DIGEST) {
     // TODO 10173692: handle E::NOBUFS w/ traffic shaping
@@ -47,13 +64,26 @@ void RECORD_onSent(const RECORD_Message& msg,
   } else {
     w->serverReadStreams().onRecordSent(to.id_.client_, msg, enqueue_time);
   }
-  // Bump the per-log-group stats
-  if (msg.log_group_path_) {
-    LOG_GROUP_TIME_SERIES_ADD(Worker::stats(),
-                              record_bytes,
-                              *msg.log_group_path_,
-                              msg.payload_.size());
+}
+
+void RECORD_BATCH_onSent(const RECORD_BATCH_Message& msg,
+                         Status st,
+                         const Address& to,
+                         const SteadyTimestamp enqueue_time) {
+  if (st != E::OK) {
+    ld_debug("RECORD_BATCH message to %s failed to send: %s",
+             Sender::describeConnection(to).c_str(),
+             error_description(st));
+    return;
+  }
+
+  for (const auto& record : msg.getRecords()) {
+    noteRecordSent(*record);
   }
+  WORKER_STAT_INCR(record_batches_sent);
+  WORKER_STAT_ADD(record_batched_records_sent, msg.getRecords().size());
+  ServerWorker::onThisThread()->serverReadStreams().onRecordBatchSent(
+      to.id_.client_, msg, enqueue_time);
 }
 
 }} // namespace facebook::logdevice
@@ -512,6 +512,8 @@ void RebuildingCoordinator::trySlideGlobalWindow(
   const auto* rsi = set.getForShardOffset(shard);
   ld_check(rsi);
 
+  notifyShardRebuildingDonorProgress(shard, set);
+
   // Recompute the minimum next timestamp across all nodes.
   RecordTimestamp min_next_timestamp = RecordTimestamp::max();
   for (auto& n : rsi->donor_progress) {
@@ -1721,6 +1723,12 @@ void RebuildingCoordinator::notifyShardDonorProgress(uint32_t shard,
   }
 
   shard_state.lastReportedProgress = shard_state.myProgress;
+  if (shard_state.shardRebuilding != nullptr) {
+    // Other donors may act on this progress as soon as they see the event,
+    // so let our own readers know about it first.
+    shard_state.shardRebuilding->noteMyReportedProgress(
+        shard_state.lastReportedProgress);
+  }
 
   auto event = std::make_unique<SHARD_DONOR_PROGRESS_Event>(
       myNodeId_,
@@ -1730,6 +1738,34 @@ void RebuildingCoordinator::notifyShardDonorProgress(uint32_t shard,
   writer_->writeEvent(std::move(event));
 }
 
+void RebuildingCoordinator::notifyShardRebuildingDonorProgress(
+    uint32_t shard,
+    const EventLogRebuildingSet& set) {
+  auto& shard_state = getShardState(shard);
+  if (shard_state.shardRebuilding == nullptr ||
+      rebuildingSettings_->donor_takeover_lag ==
+          std::chrono::milliseconds::max()) {
+    return;
+  }
+
+  const auto* rsi = set.getForShardOffset(shard);
+  ld_check(rsi);
+
+  std::unordered_map<node_index_t, RecordTimestamp> donor_progress;
+  for (auto& n : rsi->donor_progress) {
+    donor_progress.emplace(n.first, RecordTimestamp(n.second));
+  }
+  // Our own progress may be ahead of what's in event log, e.g. if we've just
+  // written a SHARD_DONOR_PROGRESS event.
+  RecordTimestamp my_progress = shard_state.lastReportedProgress;
+  auto it = donor_progress.find(myNodeId_);
+  if (it != donor_progress.end()) {
+    my_progress = std::max(my_progress, it->second);
+  }
+  shard_state.shardRebuilding->noteDonorProgress(std::move(donor_progress));
+  shard_state.shardRebuilding->noteMyReportedProgress(my_progress);
+}
+
 bool RebuildingCoordinator::myShardHasDataIntact(uint32_t shard) const {
   LocalLogStore* store = shardedStore_->getByIndex(shard);
   return !processor_->isDataMissingFromShard(shard) &&
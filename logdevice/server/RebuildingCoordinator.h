@@ -705,6 +705,13 @@ class RebuildingCoordinator : public RebuildingPlanner::Listener,
    */
   void trySlideGlobalWindow(uint32_t shard, const EventLogRebuildingSet& set);
 
+  /**
+   * Pass the progress of all donors of shard `shard` to its ShardRebuilding,
+   * for --rebuilding-donor-takeover-lag. No-op if that setting is disabled.
+   */
+  void notifyShardRebuildingDonorProgress(uint32_t shard,
+                                          const EventLogRebuildingSet& set);
+
   /**
    * Return a reference to the ShardState object for shard `shard_idx`.
    * This function asserts that the ShardState object exists in
@@ -520,7 +520,8 @@ std::unique_ptr<RecordCache>
 RecordCache::fromLinearBuffer(const char* buffer,
                               size_t size,
                               RecordCacheDependencies* deps,
-                              shard_index_t shard) {
+                              shard_index_t shard,
+                              std::shared_ptr<const void> buffer_owner) {
   size_t cumulative_size = sizeof(CacheHeader);
   if (size < cumulative_size) {
     RATELIMIT_ERROR(std::chrono::seconds(30),
@@ -576,7 +577,8 @@ RecordCache::fromLinearBuffer(const char* buffer,
                                            buffer + cumulative_size,
                                            size - cumulative_size,
                                            deps,
-                                           &epoch_record_cache_size));
+                                           &epoch_record_cache_size,
+                                           buffer_owner));
     if (epoch_record_cache == nullptr) {
       RATELIMIT_ERROR(std::chrono::seconds(30),
                       5,
@@ -207,12 +207,17 @@ class RecordCache {
   /**
    * Construct a RecordCache from a linearized representation in the given
    * buffer. Will return nullptr if it failed.
+   *
+   * If buffer_owner is not nullptr, payloads are not copied: the cache
+   * references them in `buffer' and keeps buffer_owner alive for as long as
+   * any of them is cached.
    */
   static std::unique_ptr<RecordCache>
   fromLinearBuffer(const char* buffer,
                    size_t size,
                    RecordCacheDependencies* deps,
-                   shard_index_t shard);
+                   shard_index_t shard,
+                   std::shared_ptr<const void> buffer_owner = nullptr);
 
   // NOTE Should only be used for deserialization of record caches, left public
   // only for testing. ONLY to be called when head != EPOCH_INVALID. If
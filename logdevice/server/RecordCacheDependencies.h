@@ -46,6 +46,14 @@ class EpochRecordCacheDependencies {
     return nullptr;
   }
 
+  /**
+   * Records with payloads up to this size are copied inline into their cache
+   * entry. See EpochRecordCacheEntry::createWithInlinePayload().
+   */
+  virtual size_t getInlinePayloadMaxBytes() const {
+    return 0;
+  }
+
   /**
    * Called, with lock held, whenever entries are removed from the cache because
    * they've been released.  Not called when they're evicted due to memory
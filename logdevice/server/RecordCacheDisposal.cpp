@@ -139,4 +139,8 @@ StatsHolder* RecordCacheDisposal::getStatsHolder() const {
   return processor_->stats_;
 }
 
+size_t RecordCacheDisposal::getInlinePayloadMaxBytes() const {
+  return processor_->settings()->record_cache_inline_payload_max_bytes;
+}
+
 }} // namespace facebook::logdevice
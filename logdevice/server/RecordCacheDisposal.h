@@ -48,6 +48,8 @@ class RecordCacheDisposal : public RecordCacheDependencies {
 
   StatsHolder* getStatsHolder() const override;
 
+  size_t getInlinePayloadMaxBytes() const override;
+
  private:
   ServerProcessor* const processor_;
 };
@@ -9,7 +9,9 @@
 
 #include "logdevice/common/Worker.h"
 #include "logdevice/server/RecordCache.h"
+#include "logdevice/server/RecordCacheSnapshotFile.h"
 #include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/locallogstore/RocksDBLogStoreBase.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 #include "logdevice/server/storage_tasks/ExecStorageThread.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
@@ -20,6 +22,15 @@ namespace facebook { namespace logdevice { namespace RecordCachePersistence {
 // Write in batches of 10Mib
 static const size_t SNAPSHOT_BATCH_SIZE_LIMIT = 10 * 1024 * 1024;
 
+std::string snapshotFilePath(LocalLogStore& shard) {
+  // RocksDB ignores files it doesn't know in its directory.
+  auto rocksdb_shard = dynamic_cast<RocksDBLogStoreBase*>(&shard);
+  if (!rocksdb_shard) {
+    return "";
+  }
+  return rocksdb_shard->getDBPath() + "/LOGDEVICE_RECORD_CACHE_SNAPSHOT";
+}
+
 void persistRecordCaches(shard_index_t shard_idx,
                          StorageThreadPool* storage_thread_pool) {
   LocalLogStore& shard = storage_thread_pool->getLocalLogStore();
@@ -42,6 +53,18 @@ void persistRecordCaches(shard_index_t shard_idx,
       storage_thread_pool->getProcessor().settings()->record_cache_max_size /
       sharded_store->numShards();
 
+  // If enabled, write all record caches to a RecordCacheSnapshotFile instead
+  // of log snapshot blobs. Fall back to blobs if we can't create the file.
+  std::unique_ptr<RecordCacheSnapshotFileWriter> file_writer;
+  if (storage_thread_pool->getProcessor()
+          .settings()
+          ->record_cache_snapshot_file) {
+    std::string path = snapshotFilePath(shard);
+    if (!path.empty()) {
+      file_writer = RecordCacheSnapshotFileWriter::create(path);
+    }
+  }
+
   // Keep owners of RecordCache blobs in memory so contents aren't freed
   std::vector<std::unique_ptr<uint8_t[]>> record_cache_snapshot_owners;
   std::vector<std::pair<logid_t, Slice>> record_cache_snapshot_batch;
@@ -49,6 +72,7 @@ void persistRecordCaches(shard_index_t shard_idx,
   size_t total_persisted_logs = 0;
   size_t bytes_in_current_batch = 0;
   size_t total_bytes = 0;
+  bool limit_reached = false;
 
   auto commit_batch = [&]() -> int {
     int rv = shard.writeLogSnapshotBlobs(
@@ -91,9 +115,9 @@ void persistRecordCaches(shard_index_t shard_idx,
 
     if (bytes_limit_per_shard > 0 &&
         total_bytes + bytes_in_current_batch + size >= bytes_limit_per_shard) {
-      // the snapshot is about to exceed the byte limit, commit the current
-      // batch and abort the operation
-      commit_batch();
+      // the snapshot is about to exceed the byte limit, abort the operation
+      // and commit what we have so far
+      limit_reached = true;
       ld_error("Snapshot of record cache on shard %d reached the byte limit of "
                "%lu bytes per-shard. Already persisted %lu, current batch %lu. "
                "Stop persisting record caches on this shard.",
@@ -113,6 +137,15 @@ void persistRecordCaches(shard_index_t shard_idx,
       return -1;
     }
 
+    if (file_writer) {
+      if (file_writer->add(log_id, Slice(buffer.get(), linear_size)) != 0) {
+        return -1;
+      }
+      total_bytes += linear_size;
+      total_persisted_logs++;
+      return 0;
+    }
+
     // Add serialized representation to batch. If the batch's size now exceeds
     // the batch limit, write it and start a new one.
     // TODO 12730327: make code cleaner without sharing states between two
@@ -132,8 +165,15 @@ void persistRecordCaches(shard_index_t shard_idx,
   int rv = log_storage_state_map.forEachLogOnShard(shard_idx, callback);
 
   // Write the last batch, unless we've previously encountered an error
-  if (rv == 0) {
-    commit_batch();
+  if (rv == 0 || limit_reached) {
+    if (!file_writer) {
+      commit_batch();
+    } else if (file_writer->finish() != 0) {
+      ld_error("Failed to write record cache snapshot file on shard %d, not "
+               "persisting record caches",
+               shard_idx);
+      total_persisted_logs = total_bytes = 0;
+    }
   }
 
   ld_info("Persisted record caches for %ju logs on shard %d, totaling %ju "
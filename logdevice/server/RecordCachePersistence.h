@@ -7,12 +7,14 @@
  */
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "logdevice/common/types_internal.h"
 
 namespace facebook { namespace logdevice {
 
+class LocalLogStore;
 class StorageThreadPool;
 
 /**
@@ -24,6 +26,10 @@ class StorageThreadPool;
 namespace RecordCachePersistence {
 
 void persistRecordCaches(shard_index_t, StorageThreadPool*);
+
+// Path of the RecordCacheSnapshotFile of the given shard, or an empty string
+// if the shard doesn't have a directory to put it in.
+std::string snapshotFilePath(LocalLogStore& shard);
 }
 
 }} // namespace facebook::logdevice
@@ -0,0 +1,362 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/RecordCacheSnapshotFile.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <folly/hash/Checksum.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+// Appends are buffered and written in chunks of about this size.
+static constexpr size_t WRITE_BUFFER_SIZE = 4 * 1024 * 1024;
+
+static uint32_t checksum(const void* data, size_t size) {
+  return folly::crc32c(static_cast<const uint8_t*>(data), size);
+}
+
+constexpr uint64_t RecordCacheSnapshotFile::MAGIC;
+constexpr uint32_t RecordCacheSnapshotFile::FORMAT_VERSION;
+constexpr size_t RecordCacheSnapshotFile::HEADER_SIZE;
+constexpr size_t RecordCacheSnapshotFile::CHECKSUM_PAGE_SIZE;
+
+static_assert(sizeof(RecordCacheSnapshotFile::Header) <=
+                  RecordCacheSnapshotFile::HEADER_SIZE,
+              "");
+
+std::shared_ptr<RecordCacheSnapshotFile>
+RecordCacheSnapshotFile::open(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      err = E::NOTFOUND;
+    } else {
+      ld_error("Failed to open record cache snapshot file %s: %s",
+               path.c_str(),
+               strerror(errno));
+      err = E::FAILED;
+    }
+    return nullptr;
+  }
+  // The mapping doesn't need the descriptor.
+  SCOPE_EXIT {
+    folly::closeNoInt(fd);
+  };
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ld_error("fstat() failed on record cache snapshot file %s: %s",
+             path.c_str(),
+             strerror(errno));
+    err = E::FAILED;
+    return nullptr;
+  }
+  if (st.st_size < static_cast<off_t>(HEADER_SIZE)) {
+    ld_error("Record cache snapshot file %s is too small: %ld bytes",
+             path.c_str(),
+             st.st_size);
+    err = E::BADMSG;
+    return nullptr;
+  }
+
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr == MAP_FAILED) {
+    ld_error("Failed to mmap record cache snapshot file %s: %s",
+             path.c_str(),
+             strerror(errno));
+    err = E::FAILED;
+    return nullptr;
+  }
+
+  std::shared_ptr<RecordCacheSnapshotFile> file(
+      new RecordCacheSnapshotFile(static_cast<const char*>(addr), st.st_size));
+  if (!file->init()) {
+    ld_error("Record cache snapshot file %s is invalid: %s",
+             path.c_str(),
+             error_name(err));
+    return nullptr;
+  }
+  return file;
+}
+
+RecordCacheSnapshotFile::RecordCacheSnapshotFile(const char* data,
+                                                 size_t size)
+    : data_(data), size_(size) {}
+
+RecordCacheSnapshotFile::~RecordCacheSnapshotFile() {
+  munmap(const_cast<char*>(data_), size_);
+}
+
+bool RecordCacheSnapshotFile::init() {
+  header_ = reinterpret_cast<const Header*>(data_);
+  if (header_->magic != MAGIC) {
+    err = E::BADMSG;
+    return false;
+  }
+  if (checksum(header_, offsetof(Header, header_checksum)) !=
+      header_->header_checksum) {
+    err = E::CHECKSUM_MISMATCH;
+    return false;
+  }
+  if (header_->format_version != FORMAT_VERSION || header_->page_size == 0 ||
+      header_->file_size != size_) {
+    err = E::BADMSG;
+    return false;
+  }
+
+  const uint64_t index_offset = header_->index_offset;
+  const uint64_t checksums_offset = header_->checksums_offset;
+  if (index_offset < HEADER_SIZE || index_offset > size_ ||
+      header_->num_logs > (size_ - index_offset) / sizeof(IndexEntry) ||
+      checksums_offset !=
+          index_offset + header_->num_logs * sizeof(IndexEntry)) {
+    err = E::BADMSG;
+    return false;
+  }
+  const size_t num_pages =
+      (checksums_offset - HEADER_SIZE + header_->page_size - 1) /
+      header_->page_size;
+  if (checksums_offset + num_pages * sizeof(uint32_t) != size_) {
+    err = E::BADMSG;
+    return false;
+  }
+
+  num_logs_ = header_->num_logs;
+  index_ = reinterpret_cast<const IndexEntry*>(data_ + index_offset);
+  checksums_ = data_ + checksums_offset;
+  if (checksum(checksums_, num_pages * sizeof(uint32_t)) !=
+      header_->checksums_checksum) {
+    err = E::CHECKSUM_MISMATCH;
+    return false;
+  }
+  verified_.assign(num_pages, false);
+
+  if (!verifyRange(index_offset, num_logs_ * sizeof(IndexEntry))) {
+    err = E::CHECKSUM_MISMATCH;
+    return false;
+  }
+  for (size_t i = 0; i < num_logs_; ++i) {
+    const IndexEntry& entry = index_[i];
+    if (entry.offset < HEADER_SIZE || entry.offset > index_offset ||
+        entry.size > index_offset - entry.offset) {
+      err = E::BADMSG;
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t RecordCacheSnapshotFile::pageChecksum(size_t page) const {
+  uint32_t res;
+  memcpy(&res, checksums_ + page * sizeof(uint32_t), sizeof(uint32_t));
+  return res;
+}
+
+bool RecordCacheSnapshotFile::verifyRange(uint64_t offset, uint64_t size) {
+  if (size == 0) {
+    return true;
+  }
+  ld_check(offset >= HEADER_SIZE);
+  ld_check(offset + size <= header_->checksums_offset);
+  const size_t page_size = header_->page_size;
+  const size_t first = (offset - HEADER_SIZE) / page_size;
+  const size_t last = (offset + size - 1 - HEADER_SIZE) / page_size;
+  for (size_t page = first; page <= last; ++page) {
+    if (verified_[page]) {
+      continue;
+    }
+    const uint64_t start = HEADER_SIZE + page * page_size;
+    const size_t len =
+        std::min<uint64_t>(page_size, header_->checksums_offset - start);
+    if (checksum(data_ + start, len) != pageChecksum(page)) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      5,
+                      "Checksum mismatch in page %lu of record cache snapshot "
+                      "file",
+                      page);
+      return false;
+    }
+    verified_[page] = true;
+  }
+  return true;
+}
+
+int RecordCacheSnapshotFile::forEachLog(
+    const std::function<int(logid_t, Slice)>& cb) {
+  size_t skipped = 0;
+  for (size_t i = 0; i < num_logs_; ++i) {
+    const IndexEntry& entry = index_[i];
+    if (!verifyRange(entry.offset, entry.size)) {
+      ++skipped;
+      continue;
+    }
+    int rv = cb(logid_t(entry.log_id), Slice(data_ + entry.offset, entry.size));
+    if (rv != 0) {
+      return -1;
+    }
+  }
+  if (skipped > 0) {
+    ld_error("Skipped %lu of %lu logs in record cache snapshot file because "
+             "of checksum mismatches",
+             skipped,
+             num_logs_);
+    err = E::CHECKSUM_MISMATCH;
+    return -1;
+  }
+  return 0;
+}
+
+std::unique_ptr<RecordCacheSnapshotFileWriter>
+RecordCacheSnapshotFileWriter::create(const std::string& path) {
+  std::string tmp_path = path + ".tmp";
+  int fd =
+      ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    ld_error("Failed to create record cache snapshot file %s: %s",
+             tmp_path.c_str(),
+             strerror(errno));
+    err = E::FAILED;
+    return nullptr;
+  }
+  return std::unique_ptr<RecordCacheSnapshotFileWriter>(
+      new RecordCacheSnapshotFileWriter(path, fd));
+}
+
+RecordCacheSnapshotFileWriter::RecordCacheSnapshotFileWriter(std::string path,
+                                                             int fd)
+    : path_(std::move(path)),
+      tmp_path_(path_ + ".tmp"),
+      fd_(fd) {}
+
+RecordCacheSnapshotFileWriter::~RecordCacheSnapshotFileWriter() {
+  if (fd_ >= 0) {
+    folly::closeNoInt(fd_);
+  }
+  if (!finished_) {
+    unlink(tmp_path_.c_str());
+  }
+}
+
+int RecordCacheSnapshotFileWriter::flushBuffer() {
+  ld_check(fd_ >= 0);
+  ssize_t rv = folly::pwriteFull(
+      fd_, buffer_.data(), buffer_.size(), offset_ - buffer_.size());
+  if (rv != static_cast<ssize_t>(buffer_.size())) {
+    ld_error("Failed to write to record cache snapshot file %s: %s",
+             tmp_path_.c_str(),
+             strerror(errno));
+    err = E::FAILED;
+    return -1;
+  }
+  buffer_.clear();
+  return 0;
+}
+
+int RecordCacheSnapshotFileWriter::append(const void* data, size_t size) {
+  const size_t page_size = RecordCacheSnapshotFile::CHECKSUM_PAGE_SIZE;
+  const char* ptr = static_cast<const char*>(data);
+  while (size > 0) {
+    const size_t page_offset =
+        (offset_ - RecordCacheSnapshotFile::HEADER_SIZE) % page_size;
+    const size_t n = std::min(size, page_size - page_offset);
+    page_checksum_ = folly::crc32c(
+        reinterpret_cast<const uint8_t*>(ptr), n, page_checksum_);
+    buffer_.append(ptr, n);
+    offset_ += n;
+    ptr += n;
+    size -= n;
+    if (page_offset + n == page_size) {
+      checksums_.push_back(page_checksum_);
+      page_checksum_ = ~0U;
+    }
+  }
+  return buffer_.size() >= WRITE_BUFFER_SIZE ? flushBuffer() : 0;
+}
+
+int RecordCacheSnapshotFileWriter::add(logid_t log_id, Slice data) {
+  ld_check(!finished_);
+  index_.push_back(RecordCacheSnapshotFile::IndexEntry{
+      log_id.val_, offset_, data.size});
+  return append(data.data, data.size);
+}
+
+int RecordCacheSnapshotFileWriter::finish() {
+  ld_check(!finished_);
+  using Header = RecordCacheSnapshotFile::Header;
+
+  Header header{};
+  header.magic = RecordCacheSnapshotFile::MAGIC;
+  header.format_version = RecordCacheSnapshotFile::FORMAT_VERSION;
+  header.page_size = RecordCacheSnapshotFile::CHECKSUM_PAGE_SIZE;
+  header.num_logs = index_.size();
+  header.index_offset = offset_;
+
+  if (append(index_.data(),
+             index_.size() * sizeof(RecordCacheSnapshotFile::IndexEntry)) !=
+      0) {
+    return -1;
+  }
+  if ((offset_ - RecordCacheSnapshotFile::HEADER_SIZE) %
+          RecordCacheSnapshotFile::CHECKSUM_PAGE_SIZE !=
+      0) {
+    // last, partial page
+    checksums_.push_back(page_checksum_);
+  }
+  header.checksums_offset = offset_;
+
+  // The checksum table isn't covered by page checksums, bypass append().
+  const size_t checksums_size = checksums_.size() * sizeof(uint32_t);
+  buffer_.append(reinterpret_cast<const char*>(checksums_.data()),
+                 checksums_size);
+  offset_ += checksums_size;
+  if (flushBuffer() != 0) {
+    return -1;
+  }
+  header.file_size = offset_;
+  header.checksums_checksum = checksum(checksums_.data(), checksums_size);
+  header.header_checksum = checksum(&header, offsetof(Header, header_checksum));
+
+  std::string header_page(RecordCacheSnapshotFile::HEADER_SIZE, '\0');
+  memcpy(&header_page[0], &header, sizeof(header));
+  if (folly::pwriteFull(fd_, header_page.data(), header_page.size(), 0) !=
+          static_cast<ssize_t>(header_page.size()) ||
+      folly::fsyncNoInt(fd_) != 0) {
+    ld_error("Failed to write record cache snapshot file %s: %s",
+             tmp_path_.c_str(),
+             strerror(errno));
+    err = E::FAILED;
+    return -1;
+  }
+  folly::closeNoInt(fd_);
+  fd_ = -1;
+
+  if (rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+    ld_error("Failed to rename record cache snapshot file %s to %s: %s",
+             tmp_path_.c_str(),
+             path_.c_str(),
+             strerror(errno));
+    err = E::FAILED;
+    return -1;
+  }
+  finished_ = true;
+  return 0;
+}
+
+}} // namespace facebook::logdevice
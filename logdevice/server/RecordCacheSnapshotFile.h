@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A file containing the linearized RecordCaches (see
+ *       RecordCache::toLinearBuffer()) of all logs on a shard, written on
+ *       shutdown and read back on startup, as an alternative to storing them
+ *       as log snapshot blobs in the local log store.
+ *
+ *       The file is meant to be mmap'ed: nothing in it depends on where it is
+ *       mapped, and RecordCaches created from it reference payloads directly
+ *       in the mapping instead of copying them (see
+ *       RecordCache::fromLinearBuffer()). The mapping stays alive as long as
+ *       any such payload is in the cache. Since the pages are clean and
+ *       file-backed, the kernel is free to evict them under memory pressure
+ *       and page them back in when the records are read.
+ *
+ *       Layout:
+ *         - header, padded to HEADER_SIZE bytes;
+ *         - linearized RecordCaches, one after another;
+ *         - index: for each log, its log id, offset and size;
+ *         - checksum table: crc32c of each CHECKSUM_PAGE_SIZE bytes page of
+ *           the data and the index (the last page may be shorter).
+ *       The header has a checksum of itself and of the checksum table.
+ *       Page checksums are verified the first time a log touching the page
+ *       is read.
+ */
+
+class RecordCacheSnapshotFile {
+ public:
+  static constexpr uint64_t MAGIC = 0x504e53434352444cull; // "LDRCCSNP"
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  static constexpr size_t HEADER_SIZE = 4096;
+  static constexpr size_t CHECKSUM_PAGE_SIZE = 64 * 1024;
+
+  struct Header {
+    uint64_t magic;
+    uint32_t format_version;
+    uint32_t page_size;
+    uint64_t num_logs;
+    uint64_t index_offset;
+    uint64_t checksums_offset;
+    uint64_t file_size;
+    // crc32c of the checksum table
+    uint32_t checksums_checksum;
+    // crc32c of the header up to this field
+    uint32_t header_checksum;
+  } __attribute__((__packed__));
+
+  struct IndexEntry {
+    uint64_t log_id;
+    uint64_t offset;
+    uint64_t size;
+  } __attribute__((__packed__));
+
+  /**
+   * Maps the file at `path' and checks its header and index.
+   *
+   * @return the file, or nullptr and err is set to:
+   *           NOTFOUND           if there is no such file,
+   *           BADMSG             if the header or index is invalid,
+   *           CHECKSUM_MISMATCH  if the header or index is corrupted,
+   *           FAILED             if the file could not be opened or mapped.
+   */
+  static std::shared_ptr<RecordCacheSnapshotFile>
+  open(const std::string& path);
+
+  ~RecordCacheSnapshotFile();
+
+  size_t numLogs() const {
+    return num_logs_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  /**
+   * Calls `cb' with the linearized RecordCache of each log in the file. The
+   * Slice points into the mapping, which is only guaranteed to stay valid
+   * while the caller holds a reference to this object.
+   *
+   * Logs whose data fails checksum verification are skipped.
+   *
+   * @return 0 on success. -1 if `cb' returned non-zero, in which case we stop
+   *         and err is left as `cb' set it, or if some logs were skipped, in
+   *         which case err is set to CHECKSUM_MISMATCH.
+   */
+  int forEachLog(const std::function<int(logid_t, Slice)>& cb);
+
+  RecordCacheSnapshotFile(const RecordCacheSnapshotFile&) = delete;
+  RecordCacheSnapshotFile& operator=(const RecordCacheSnapshotFile&) = delete;
+
+ private:
+  RecordCacheSnapshotFile(const char* data, size_t size);
+
+  // Checks the header and the index. Sets err on failure.
+  bool init();
+
+  // Verifies checksums of the pages overlapping [offset, offset + size),
+  // skipping the ones verified before.
+  bool verifyRange(uint64_t offset, uint64_t size);
+
+  uint32_t pageChecksum(size_t page) const;
+
+  const char* const data_;
+  const size_t size_;
+  size_t num_logs_ = 0;
+  const Header* header_ = nullptr;
+  const IndexEntry* index_ = nullptr;
+  // Not necessarily aligned, see pageChecksum().
+  const char* checksums_ = nullptr;
+  // verified_[i] is true if page i of the checksummed region was verified
+  std::vector<bool> verified_;
+};
+
+/**
+ * Writes a RecordCacheSnapshotFile. The file is written under a temporary
+ * name and renamed once finish() succeeds, so a crash while writing doesn't
+ * leave a truncated snapshot behind.
+ */
+class RecordCacheSnapshotFileWriter {
+ public:
+  /**
+   * @return the writer, or nullptr and err is set to FAILED if the file could
+   *         not be created.
+   */
+  static std::unique_ptr<RecordCacheSnapshotFileWriter>
+  create(const std::string& path);
+
+  // Deletes the temporary file if finish() wasn't called or failed.
+  ~RecordCacheSnapshotFileWriter();
+
+  /**
+   * Appends the linearized RecordCache of a log.
+   *
+   * @return 0 on success, -1 and err is set to FAILED if the write failed.
+   */
+  int add(logid_t log_id, Slice data);
+
+  /**
+   * Writes the index, checksums and header, syncs the file and renames it.
+   *
+   * @return 0 on success, -1 and err is set to FAILED.
+   */
+  int finish();
+
+ private:
+  RecordCacheSnapshotFileWriter(std::string path, int fd);
+
+  // Appends to the file, updating page checksums as we go.
+  int append(const void* data, size_t size);
+  int flushBuffer();
+
+  const std::string path_;
+  const std::string tmp_path_;
+  int fd_;
+  bool finished_ = false;
+
+  // Offset in the file of the end of what we've appended so far.
+  uint64_t offset_ = RecordCacheSnapshotFile::HEADER_SIZE;
+  std::string buffer_;
+  // crc32c of the current page so far
+  uint32_t page_checksum_ = ~0U;
+  std::vector<uint32_t> checksums_;
+  std::vector<RecordCacheSnapshotFile::IndexEntry> index_;
+};
+
+}} // namespace facebook::logdevice
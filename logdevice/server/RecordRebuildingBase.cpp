@@ -15,6 +15,7 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/stats/PerShardHistograms.h"
 #include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/rebuilding/RebuildingStoreBatch.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
@@ -282,6 +283,14 @@ int RecordRebuildingBase::sendStore(StageRecipients::Type type,
 
   auto message = buildStoreMessage(recipient.shard_, amend);
 
+  RebuildingStoreBatch* batch = owner_->getStoreBatch();
+  if (batch &&
+      batch->add(
+          message, recipient.shard_.asNodeID(), recipient.on_socket_close)) {
+    ld_check(recipient.isStoreInFlight());
+    return 0;
+  }
+
   ld_spew("sending STORE%s %lu%s to %s",
           amend ? " (amend)" : "",
           owner_->getLogID().val_,
@@ -39,6 +39,7 @@
 namespace facebook { namespace logdevice {
 
 class CopySetSelector;
+class RebuildingStoreBatch;
 struct RebuildingSet;
 
 using NodeIndexServerInstancePair = std::pair<node_index_t, ServerInstanceId>;
@@ -155,6 +156,12 @@ class RecordRebuildingOwner {
   virtual void
   onAllAmendsReceived(lsn_t lsn,
                       std::unique_ptr<FlushTokenMap> flushTokenMap) = 0;
+
+  // If not nullptr, STOREs and amends should be handed to this batch instead
+  // of being sent right away.
+  virtual RebuildingStoreBatch* getStoreBatch() {
+    return nullptr;
+  }
 };
 
 class RecordRebuildingBase : public RecordRebuildingInterface {
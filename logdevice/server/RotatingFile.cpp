@@ -50,6 +50,15 @@ ssize_t RotatingFile::write(const void* buf, size_t count) {
   return write_(descriptor->getDescriptor(), buf, count);
 }
 
+int RotatingFile::fsync() {
+  auto descriptor = descriptor_.get();
+  if (!descriptor) {
+    errno = EBADF;
+    return -1;
+  }
+  return fsync_(descriptor->getDescriptor());
+}
+
 void RotatingFile::close_() {
   descriptor_.update(nullptr);
   path_.clear();
@@ -62,4 +71,8 @@ ssize_t RotatingFile::write_(int fd, const void* buf, size_t count) {
   return ::write(fd, buf, count);
 }
 
+int RotatingFile::fsync_(int fd) {
+  return ::fdatasync(fd);
+}
+
 }} // namespace facebook::logdevice
@@ -58,12 +58,19 @@ class RotatingFile : private boost::noncopyable {
   int reopen();
   ssize_t write(const void* buf, size_t count);
 
+  /**
+   * Flushes the data written to the current file descriptor to disk, with
+   * fdatasync(). Returns 0 on success or -1 with errno set.
+   */
+  int fsync();
+
  protected:
   /**
    * Wrapers around system calls to make mocking of sys calls available.
    */
   virtual int open_(const char* path, int flags, mode_t mode);
   virtual ssize_t write_(int fd, const void* buf, size_t count);
+  virtual int fsync_(int fd);
 
  private:
   void close_();
@@ -7,6 +7,10 @@
  */
 #include "logdevice/server/SEAL_onReceived.h"
 
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "logdevice/common/Seal.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/configuration/ServerConfig.h"
@@ -14,14 +18,22 @@
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
+#include "logdevice/server/storage/SealBatchStorageTask.h"
 #include "logdevice/server/storage/SealStorageTask.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
 namespace facebook { namespace logdevice {
 
-Message::Disposition SEAL_onReceived(SEAL_Message* msg, const Address& from) {
-  const SEAL_Header& header = msg->getHeader();
+namespace {
+
+// Checks a SEAL. Either replies to it right away, or sets `task_out` to the
+// SealStorageTask that will seal the log and reply, and `shard_out` to the
+// shard it must run on.
+Message::Disposition processSeal(const SEAL_Header& header,
+                                 const Address& from,
+                                 std::unique_ptr<SealStorageTask>& task_out,
+                                 shard_index_t& shard_out) {
   ServerWorker* worker = ServerWorker::onThisThread();
 
   if (header.log_id == LOGID_INVALID || !epoch_valid(header.seal_epoch)) {
@@ -137,10 +149,57 @@ Message::Disposition SEAL_onReceived(SEAL_Message* msg, const Address& from) {
     tail_optimized = log->attrs().tailOptimized().value();
   }
 
-  auto task = std::make_unique<SealStorageTask>(
+  task_out = std::make_unique<SealStorageTask>(
       header.log_id, header.last_clean_epoch, seal, from, tail_optimized);
-  worker->getStorageTaskQueueForShard(shard_idx)->putTask(std::move(task));
+  shard_out = shard_idx;
+  return Message::Disposition::NORMAL;
+}
+
+} // namespace
 
+Message::Disposition SEAL_onReceived(SEAL_Message* msg, const Address& from) {
+  std::unique_ptr<SealStorageTask> task;
+  shard_index_t shard_idx = -1;
+  Message::Disposition disp =
+      processSeal(msg->getHeader(), from, task, shard_idx);
+  if (task) {
+    ServerWorker::onThisThread()
+        ->getStorageTaskQueueForShard(shard_idx)
+        ->putTask(std::move(task));
+  }
+  return disp;
+}
+
+Message::Disposition MULTI_SEAL_onReceived(MULTI_SEAL_Message* msg,
+                                           const Address& from) {
+  // SEALs that need a storage task, by shard
+  std::map<shard_index_t, std::vector<std::unique_ptr<SealStorageTask>>>
+      tasks;
+  for (const SEAL_Header& header : msg->getSeals()) {
+    std::unique_ptr<SealStorageTask> task;
+    shard_index_t shard_idx = -1;
+    Message::Disposition disp = processSeal(header, from, task, shard_idx);
+    if (disp != Message::Disposition::NORMAL) {
+      // tasks for the SEALs before this one are dropped, the sequencer will
+      // retry all of them once the connection is closed
+      return disp;
+    }
+    if (task) {
+      tasks[shard_idx].push_back(std::move(task));
+    }
+  }
+
+  ServerWorker* worker = ServerWorker::onThisThread();
+  for (auto& kv : tasks) {
+    std::unique_ptr<StorageTask> task;
+    if (kv.second.size() == 1) {
+      task = std::move(kv.second.front());
+    } else {
+      task = std::make_unique<SealBatchStorageTask>(std::move(kv.second));
+    }
+    worker->getStorageTaskQueueForShard(kv.first)->putTask(std::move(task));
+  }
   return Message::Disposition::NORMAL;
 }
+
 }} // namespace facebook::logdevice
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "logdevice/common/protocol/MULTI_SEAL_Message.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/SEAL_Message.h"
 
@@ -15,4 +16,9 @@ namespace facebook { namespace logdevice {
 struct Address;
 
 Message::Disposition SEAL_onReceived(SEAL_Message* msg, const Address& from);
+
+// Handles each SEAL in the batch like SEAL_onReceived(), but executes the ones
+// for the same shard in a single SealBatchStorageTask.
+Message::Disposition MULTI_SEAL_onReceived(MULTI_SEAL_Message* msg,
+                                           const Address& from);
 }} // namespace facebook::logdevice
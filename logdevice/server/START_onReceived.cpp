@@ -456,6 +456,21 @@ Message::Disposition START_onReceived(START_Message* msg,
     stream->setTrafficClass(tc);
   }
 
+  stream->read_tenant_ = 0;
+  stream->read_tenant_weight_ = 1;
+  if (const PrincipalIdentity* identity = w->sender().getPrincipal(from)) {
+    // Like for the traffic class, the first identity that has a principal
+    // configured determines the stream's share of storage threads.
+    for (const auto& id : identity->identities) {
+      auto principal = scfg->getPrincipalByName(&id.second);
+      if (principal != nullptr) {
+        stream->read_tenant_ = std::hash<std::string>()(principal->name);
+        stream->read_tenant_weight_ = principal->read_weight;
+        break;
+      }
+    }
+  }
+
   stream->setSCDCopysetReordering(
       header.scd_copyset_reordering, msg->csid_hash_pt1, msg->csid_hash_pt2);
 
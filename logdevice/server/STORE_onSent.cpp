@@ -87,4 +87,13 @@ void STORE_onSent(const STORE_Message& msg,
   msg.onSentCommon(st, to);
 }
 
+void MULTI_STORE_onSent(const MULTI_STORE_Message& msg,
+                        Status st,
+                        const Address& to,
+                        const SteadyTimestamp enqueue_time) {
+  for (const auto& store : msg.getStores()) {
+    STORE_onSent(*store, st, to, enqueue_time);
+  }
+}
+
 }} // namespace facebook::logdevice
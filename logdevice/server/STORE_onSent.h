@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 
 namespace facebook { namespace logdevice {
@@ -14,4 +15,10 @@ void STORE_onSent(const STORE_Message& msg,
                   Status st,
                   const Address& to,
                   const SteadyTimestamp enqueue_time);
+
+// Calls STORE_onSent() for each record of the batch.
+void MULTI_STORE_onSent(const MULTI_STORE_Message& msg,
+                        Status st,
+                        const Address& to,
+                        const SteadyTimestamp enqueue_time);
 }} // namespace facebook::logdevice
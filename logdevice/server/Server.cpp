@@ -7,6 +7,9 @@
  */
 #include "logdevice/server/Server.h"
 
+#include <algorithm>
+
+
 #include "logdevice/admin/SimpleAdminServer.h"
 #include "logdevice/admin/maintenance/ClusterMaintenanceStateMachine.h"
 #include "logdevice/common/ConfigInit.h"
@@ -378,7 +381,10 @@ ServerParameters::ServerParameters(
     throw ConstructorFailed();
   }
   if (!server_settings_->audit_log.empty()) {
-    audit_log_ = std::make_shared<LocalLogFile>();
+    audit_log_ = std::make_shared<LocalLogFile>(
+        server_settings_->audit_log_queue_size,
+        server_settings_->audit_log_fsync_interval,
+        &server_stats_);
     if (audit_log_->open(server_settings_->audit_log) < 0) {
       ld_error("Could not open audit log \"%s\": %s",
                server_settings_->audit_log.c_str(),
@@ -1108,6 +1114,48 @@ bool Server::startConnectionListener(std::unique_ptr<Listener>& handle) {
   return listener->startAcceptingConnections().wait().value();
 }
 
+bool Server::startDataConnectionListener(
+    std::unique_ptr<Listener>& handle,
+    ConnectionListener::ListenerType type) {
+  const Listener::InterfaceDef& iface = handle->getInterface();
+  if (!server_settings_->accept_on_workers || !iface.isPort()) {
+    return startConnectionListener(handle);
+  }
+
+  const int nworkers = processor_->getWorkerCount(WorkerType::GENERAL);
+  ld_check(nworkers > 0);
+  if (worker_conn_budgets_backlog_.empty()) {
+    const uint64_t per_worker_backlog = std::max<uint64_t>(
+        1, server_settings_->connection_backlog / nworkers);
+    for (int i = 0; i < nworkers; ++i) {
+      worker_conn_budgets_backlog_.push_back(
+          std::make_unique<ResourceBudget>(per_worker_backlog));
+    }
+  }
+
+  auto shared_state = std::make_shared<ConnectionListener::SharedState>();
+  for (int i = 0; i < nworkers; ++i) {
+    Worker& worker = processor_->getWorker(worker_id_t(i), WorkerType::GENERAL);
+    auto listener = std::make_unique<ConnectionListener>(
+        iface,
+        folly::getKeepAliveToken(
+            checked_downcast<EventLoop*>(worker.getExecutor())),
+        shared_state,
+        type,
+        *worker_conn_budgets_backlog_[i],
+        worker_id_t(i));
+    listener->setProcessor(processor_.get());
+    if (!listener->startAcceptingConnections().wait().value()) {
+      return false;
+    }
+    worker_connection_listeners_.push_back(std::move(listener));
+  }
+  ld_info("Accepting connections on %s on %d workers",
+          iface.describe().c_str(),
+          nworkers);
+  return true;
+}
+
 bool Server::initLogsConfigManager() {
   return LogsConfigManager::createAndAttach(
       *processor_, true /* is_writable */);
@@ -1158,7 +1206,8 @@ bool Server::initAdminServer() {
 
 bool Server::startListening() {
   // start accepting new connections
-  if (!startConnectionListener(connection_listener_)) {
+  if (!startDataConnectionListener(
+          connection_listener_, ConnectionListener::ListenerType::DATA)) {
     return false;
   }
 
@@ -1167,7 +1216,9 @@ bool Server::startListening() {
   }
 
   if (ssl_connection_listener_loop_ &&
-      !startConnectionListener(ssl_connection_listener_)) {
+      !startDataConnectionListener(
+          ssl_connection_listener_,
+          ConnectionListener::ListenerType::DATA_SSL)) {
     return false;
   }
 
@@ -1198,6 +1249,7 @@ void Server::gracefulShutdown() {
                   command_listener_,
                   gossip_listener_,
                   ssl_connection_listener_,
+                  worker_connection_listeners_,
                   connection_listener_loop_,
                   command_listener_loop_,
                   gossip_listener_loop_,
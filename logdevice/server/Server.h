@@ -229,12 +229,19 @@ class Server {
 
   // For tests, to help simulate various forms of network partition.
   void acceptNewConnections(bool accept) {
-    if (accept) {
-      connection_listener_->startAcceptingConnections().wait();
-      ssl_connection_listener_->startAcceptingConnections().wait();
-    } else {
-      connection_listener_->stopAcceptingConnections().wait();
-      ssl_connection_listener_->stopAcceptingConnections().wait();
+    std::vector<Listener*> listeners;
+    if (worker_connection_listeners_.empty()) {
+      listeners = {connection_listener_.get(), ssl_connection_listener_.get()};
+    }
+    for (auto& listener : worker_connection_listeners_) {
+      listeners.push_back(listener.get());
+    }
+    for (Listener* listener : listeners) {
+      if (accept) {
+        listener->startAcceptingConnections().wait();
+      } else {
+        listener->stopAcceptingConnections().wait();
+      }
     }
   }
 
@@ -262,6 +269,11 @@ class Server {
   std::unique_ptr<Listener> command_listener_;
   std::unique_ptr<Listener> gossip_listener_;
 
+  // startListening() with --accept-on-workers: ConnectionListeners running on
+  // GENERAL Workers, used instead of connection_listener_ and
+  // ssl_connection_listener_ for data ports.
+  std::vector<std::unique_ptr<Listener>> worker_connection_listeners_;
+
   // initStore()
   std::unique_ptr<ShardedRocksDBLocalLogStore> sharded_store_;
   std::unique_ptr<ShardedStorageThreadPool> sharded_storage_thread_pool_;
@@ -308,6 +320,10 @@ class Server {
   // Similar to above but we don't want to limit for some listeners.
   ResourceBudget conn_budget_backlog_unlimited_;
 
+  // With --accept-on-workers, each GENERAL Worker's share of
+  // conn_budget_backlog_, indexed by worker id.
+  std::vector<std::unique_ptr<ResourceBudget>> worker_conn_budgets_backlog_;
+
   // These methods should be called in this order.
   // In case of error, log it and return false.
   bool initListeners();
@@ -332,6 +348,10 @@ class Server {
 
   bool startCommandListener(std::unique_ptr<Listener>& handle);
   bool startConnectionListener(std::unique_ptr<Listener>& handle);
+  // Starts `handle`, or with --accept-on-workers, a ConnectionListener for
+  // the same port on every GENERAL Worker.
+  bool startDataConnectionListener(std::unique_ptr<Listener>& handle,
+                                   ConnectionListener::ListenerType type);
 
   void updateStatsSettings();
 };
@@ -11,13 +11,20 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/UpdateableSecurityInfo.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/CHECKSUM_FAIL_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
+#include "logdevice/common/protocol/MULTI_DATA_SIZE_Message.h"
+#include "logdevice/common/protocol/MULTI_IS_LOG_EMPTY_Message.h"
+#include "logdevice/common/protocol/MULTI_RELEASE_Message.h"
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
+#include "logdevice/common/protocol/MULTI_TRIM_Message.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
 #include "logdevice/common/util.h"
+#include "logdevice/server/CHECKSUM_FAIL_onReceived.h"
 #include "logdevice/server/CHECK_NODE_HEALTH_onReceived.h"
 #include "logdevice/server/CHECK_SEAL_onReceived.h"
 #include "logdevice/server/DATA_SIZE_onReceived.h"
@@ -58,6 +65,41 @@ Message::Disposition
 ServerMessageDispatch::onReceivedImpl(Message* msg,
                                       const Address& from,
                                       const PrincipalIdentity& principal) {
+  if (msg->type_ == MessageType::MULTI_TRIM) {
+    auto multi = checked_downcast<MULTI_TRIM_Message*>(msg);
+    std::vector<logid_t> log_ids;
+    for (const TRIM_Header& header : multi->getTrims()) {
+      log_ids.push_back(header.log_id);
+    }
+    return onMultiLogReceived(
+        msg,
+        principal,
+        MessageType::TRIM,
+        ACTION::TRIM,
+        log_ids,
+        [from](Message* m, const std::vector<PermissionCheckStatus>& st) {
+          return MULTI_TRIM_onReceived(
+              checked_downcast<MULTI_TRIM_Message*>(m), from, st);
+        });
+  }
+  if (msg->type_ == MessageType::MULTI_IS_LOG_EMPTY) {
+    auto multi = checked_downcast<MULTI_IS_LOG_EMPTY_Message*>(msg);
+    std::vector<logid_t> log_ids;
+    for (const IS_LOG_EMPTY_Header& header : multi->getRequests()) {
+      log_ids.push_back(header.log_id);
+    }
+    return onMultiLogReceived(
+        msg,
+        principal,
+        MessageType::IS_LOG_EMPTY,
+        ACTION::READ,
+        log_ids,
+        [from](Message* m, const std::vector<PermissionCheckStatus>& st) {
+          return MULTI_IS_LOG_EMPTY_onReceived(
+              checked_downcast<MULTI_IS_LOG_EMPTY_Message*>(m), from, st);
+        });
+  }
+
   auto params = ServerMessagePermission::computePermissionParams(msg);
 
   std::shared_ptr<PermissionChecker> permission_checker =
@@ -104,11 +146,73 @@ ServerMessageDispatch::onReceivedImpl(Message* msg,
   }
 }
 
+Message::Disposition ServerMessageDispatch::onMultiLogReceived(
+    Message* msg,
+    const PrincipalIdentity& principal,
+    MessageType single_type,
+    ACTION action,
+    const std::vector<logid_t>& log_ids,
+    multi_log_handler_t handler) {
+  const size_t num_logs = log_ids.size();
+  std::shared_ptr<PermissionChecker> permission_checker =
+      processor_->security_info_->getPermissionChecker();
+
+  // Each entry in the batch needs the same permission as a `single_type`
+  // message, and 'require-permission-message-types' applies to it as if it
+  // was one.
+  bool check_permissions = permission_checker != nullptr;
+  if (check_permissions &&
+      processor_->settings()->require_permission_message_types.count(
+          single_type) == 0) {
+    check_permissions = false;
+    STAT_INCR(processor_->stats_, server_message_dispatch_bypass_permission);
+  }
+
+  if (!check_permissions) {
+    STAT_INCR(processor_->stats_, server_message_dispatch_skip_permission);
+    return handler(msg,
+                   std::vector<PermissionCheckStatus>(
+                       num_logs, PermissionCheckStatus::NONE));
+  }
+
+  STAT_INCR(processor_->stats_, server_message_dispatch_check_permission);
+  // Permission checks may complete asynchronously (on this worker thread),
+  // so the message is kept alive until all of them are done.
+  struct PendingChecks {
+    std::unique_ptr<Message> msg;
+    std::vector<PermissionCheckStatus> statuses;
+    size_t remaining;
+    multi_log_handler_t handler;
+  };
+  auto pending = std::make_shared<PendingChecks>();
+  pending->msg.reset(msg);
+  pending->statuses.resize(num_logs, PermissionCheckStatus::NONE);
+  pending->remaining = num_logs;
+  pending->handler = std::move(handler);
+  for (size_t i = 0; i < num_logs; ++i) {
+    permission_checker->isAllowed(
+        action,
+        principal,
+        log_ids[i],
+        [pending, i](PermissionCheckStatus permission_status) {
+          pending->statuses[i] = permission_status;
+          if (--pending->remaining == 0) {
+            pending->handler(pending->msg.get(), pending->statuses);
+          }
+        });
+  }
+  return Message::Disposition::KEEP;
+}
+
 Message::Disposition ServerMessageDispatch::onReceivedHandler(
     Message* msg,
     const Address& from,
     PermissionCheckStatus permission_status) const {
   switch (msg->type_) {
+    case MessageType::CHECKSUM_FAIL:
+      return CHECKSUM_FAIL_onReceived(
+          checked_downcast<CHECKSUM_FAIL_Message*>(msg), from);
+
     case MessageType::CHECK_NODE_HEALTH:
       return CHECK_NODE_HEALTH_onReceived(
           checked_downcast<CHECK_NODE_HEALTH_Message*>(msg), from);
@@ -166,6 +270,22 @@ Message::Disposition ServerMessageDispatch::onReceivedHandler(
       return MEMTABLE_FLUSHED_onReceived(
           checked_downcast<MEMTABLE_FLUSHED_Message*>(msg), from);
 
+    case MessageType::MULTI_DATA_SIZE:
+      return MULTI_DATA_SIZE_onReceived(
+          checked_downcast<MULTI_DATA_SIZE_Message*>(msg), from);
+
+    case MessageType::MULTI_RELEASE:
+      return PurgeCoordinator::onReceived(
+          checked_downcast<MULTI_RELEASE_Message*>(msg), from);
+
+    case MessageType::MULTI_SEAL:
+      return MULTI_SEAL_onReceived(
+          checked_downcast<MULTI_SEAL_Message*>(msg), from);
+
+    case MessageType::MULTI_STORE:
+      return StoreStateMachine::onReceived(
+          checked_downcast<MULTI_STORE_Message*>(msg), from);
+
     case MessageType::NODE_STATS_AGGREGATE:
       return NODE_STATS_AGGREGATE_onReceived(
           checked_downcast<NODE_STATS_AGGREGATE_Message*>(msg), from);
@@ -245,6 +365,13 @@ void ServerMessageDispatch::onSentImpl(const Message& msg,
       return GOSSIP_onSent(
           checked_downcast<const GOSSIP_Message&>(msg), st, to, enqueue_time);
 
+    case MessageType::MULTI_STORE:
+      return MULTI_STORE_onSent(
+          checked_downcast<const MULTI_STORE_Message&>(msg),
+          st,
+          to,
+          enqueue_time);
+
     case MessageType::NODE_STATS:
       RATELIMIT_ERROR(std::chrono::seconds(60),
                       1,
@@ -258,6 +385,13 @@ void ServerMessageDispatch::onSentImpl(const Message& msg,
       return RECORD_onSent(
           checked_downcast<const RECORD_Message&>(msg), st, to, enqueue_time);
 
+    case MessageType::RECORD_BATCH:
+      return RECORD_BATCH_onSent(
+          checked_downcast<const RECORD_BATCH_Message&>(msg),
+          st,
+          to,
+          enqueue_time);
+
     case MessageType::SHARD_STATUS_UPDATE:
       return ServerWorker::onThisThread()
           ->serverReadStreams()
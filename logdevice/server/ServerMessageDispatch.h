@@ -7,6 +7,9 @@
  */
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "logdevice/common/PermissionChecker.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/MessageDispatch.h"
@@ -40,6 +43,23 @@ class ServerMessageDispatch : public MessageDispatch {
                     PermissionCheckStatus permission_status) const;
 
  private:
+  // Handles a message that batches requests for several logs, given the
+  // outcome of the permission check of each log.
+  using multi_log_handler_t = std::function<Message::Disposition(
+      Message*,
+      const std::vector<PermissionCheckStatus>&)>;
+
+  // Checks the permission that a `single_type` message needs for every log in
+  // `log_ids` (the logs of the requests batched in `msg`, in order), then
+  // hands the message and the results to `handler`. Used for MULTI_TRIM and
+  // MULTI_IS_LOG_EMPTY.
+  Message::Disposition onMultiLogReceived(Message* msg,
+                                          const PrincipalIdentity& principal,
+                                          MessageType single_type,
+                                          ACTION action,
+                                          const std::vector<logid_t>& log_ids,
+                                          multi_log_handler_t handler);
+
   Processor* processor_;
 };
 }} // namespace facebook::logdevice
@@ -40,7 +40,10 @@ void ServerProcessor::maybeCreateLogStorageStateMap() {
         ? sharded_storage_thread_pool_->numShards()
         : 1;
     log_storage_state_map_ = std::make_unique<LogStorageStateMap>(
-        num_shards, updateableSettings()->log_state_recovery_interval, this);
+        num_shards,
+        updateableSettings()->log_state_recovery_interval,
+        this,
+        updateableSettings()->log_storage_state_dense_logs);
   }
 }
 
@@ -41,6 +41,15 @@ class ServerRecordEqualityFilter final : public ServerRecordFilter {
     return record_key == filter_key_;
   }
 
+  void filterBatch(const folly::StringPiece* keys,
+                   size_t n,
+                   bool* passed) override {
+    // Final class, so the calls below are inlined.
+    for (size_t i = 0; i < n; ++i) {
+      passed[i] = (*this)(keys[i]);
+    }
+  }
+
   /**
    *  @return             A human-readable string which describes this
    *                      server-side filter.
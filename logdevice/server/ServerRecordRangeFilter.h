@@ -38,6 +38,15 @@ class ServerRecordRangeFilter final : public ServerRecordFilter {
     return record_key >= low_limit_ && record_key <= high_limit_;
   }
 
+  void filterBatch(const folly::StringPiece* keys,
+                   size_t n,
+                   bool* passed) override {
+    // Final class, so the calls below are inlined.
+    for (size_t i = 0; i < n; ++i) {
+      passed[i] = (*this)(keys[i]);
+    }
+  }
+
   /**
    *  @return             A human-readable string which describes this
    *                      server-side filter.
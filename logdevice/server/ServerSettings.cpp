@@ -183,6 +183,15 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER,
      SettingsCategory::Core)
 
+    ("log-async", &log_async, "false",
+     nullptr,
+     "write the server error log from a background thread, so that threads "
+     "logging a lot don't block on writing to the log file or stderr. If the "
+     "background thread falls behind, messages are dropped and the number of "
+     "dropped messages is logged",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::Core)
+
     // TODO: this option is required.
     ("config-path", &config_path, "",
      nullptr,
@@ -284,6 +293,22 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER,
      SettingsCategory::Storage)
 
+    ("storage-thread-sync-latency-target",
+     &storage_thread_sync_latency_target,
+     "0ms",
+     validate_nonnegative<ssize_t>(),
+     "If nonzero, the delay before syncing delayable storage tasks is chosen "
+     "adaptively: the syncing thread tracks how long syncs take and how "
+     "often tasks needing a sync arrive, syncs right away if no other task "
+     "is expected to join the batch in time, and otherwise waits for as "
+     "long as it can while still syncing each task within this target. It "
+     "also gives writes already waiting in the storage threads' write "
+     "queues a chance to join the sync. "
+     "--storage-thread-delaying-sync-interval stays an upper bound on the "
+     "delay. 0 always waits for --storage-thread-delaying-sync-interval.",
+     SERVER,
+     SettingsCategory::Storage)
+
     ("fd-limit", &fd_limit, "0",
      [](int val) -> void {
        if (val < 0) {
@@ -368,6 +393,23 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER | REQUIRES_RESTART,
      SettingsCategory::Security)
 
+    ("audit-log-queue-size", &audit_log_queue_size, "10000", nullptr,
+     "Maximum number of entries waiting to be written to --audit-log by a "
+     "background thread, in batches. Entries are dropped when the queue is "
+     "full, so that a slow disk doesn't block the threads that change trim "
+     "points; see the local_log_file_entries_dropped stat. If 0, entries are "
+     "written synchronously by the thread that logs them.",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::Security)
+
+    ("audit-log-fsync-interval", &audit_log_fsync_interval, "1s",
+     validate_nonnegative<ssize_t>(),
+     "How often the audit log is flushed to disk with fdatasync() after "
+     "entries are written to it. 0 means the audit log is never explicitly "
+     "flushed. Only used if --audit-log-queue-size is positive.",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::Security)
+
     ("connection-backlog", &connection_backlog, "2000",
      parse_positive<ssize_t>(),
      "(server-only setting) Maximum number of incoming connections that have "
@@ -376,6 +418,17 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER | REQUIRES_RESTART,
      SettingsCategory::Network)
 
+    ("accept-on-workers", &accept_on_workers, "false", nullptr,
+     "(server-only setting) If true, instead of a single listener thread "
+     "accepting data connections (plain and SSL) and handing them off to "
+     "workers, every worker listens on the data ports with its own "
+     "SO_REUSEPORT socket and takes the connections it accepts; the kernel "
+     "balances new connections between workers. --connection-backlog is then "
+     "split evenly between workers. Helps when many clients reconnect at "
+     "once. Ignored for unix domain sockets.",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::Network)
+
     ;
   // clang-format on
 
@@ -56,6 +56,7 @@ struct ServerSettings : public SettingsBundle {
   // number of background workers
   int num_background_workers;
   std::string log_file;
+  bool log_async;
   std::string config_path;
   std::string epoch_store_path;
   StoragePoolParams storage_pool_params;
@@ -63,6 +64,11 @@ struct ServerSettings : public SettingsBundle {
   // Interval between invoking syncs for delayable storage tasks.
   // Ignored when undelayable task is being enqueued.
   std::chrono::milliseconds storage_thread_delaying_sync_interval;
+  // If nonzero, the syncing thread adapts the delay to the observed sync
+  // latency and task arrival rate, trying to sync every delayable task
+  // within this much time. storage_thread_delaying_sync_interval is then
+  // only an upper bound on the delay.
+  std::chrono::milliseconds storage_thread_sync_latency_target;
   int fd_limit;
   bool eagerly_allocate_fdtable;
   int num_reserved_fds;
@@ -76,12 +82,22 @@ struct ServerSettings : public SettingsBundle {
   // When set represents the file where trim actions will be logged.
   // All changes to Trim points are stored in this log.
   std::string audit_log;
+  // Maximum number of audit log entries queued for the background writer.
+  // 0 means write synchronously.
+  size_t audit_log_queue_size;
+  // How often the audit log is flushed to disk. 0 means never.
+  std::chrono::milliseconds audit_log_fsync_interval;
 
   // (server-only setting) Maximum number of incoming connections that have been
   // accepted by listener (have an open FD) but have not been processed by
   // workers (made logdevice protocol handshake)
   size_t connection_backlog;
 
+  // If true, every GENERAL Worker accepts data connections on its own
+  // SO_REUSEPORT listening socket instead of a dedicated listener thread
+  // spreading them over Workers.
+  bool accept_on_workers;
+
   bool test_mode;
 
   int deprecated_ssl_port;
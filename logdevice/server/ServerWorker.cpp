@@ -186,6 +186,32 @@ void ServerWorker::onSettingsUpdated() {
   }
 }
 
+void ServerWorker::rebalanceLoad() {
+  const double ratio = settings().worker_load_rebalancing_ratio;
+  if (ratio <= 0 || worker_type_ != WorkerType::GENERAL ||
+      processor_->getWorkerCount(worker_type_) < 2) {
+    return;
+  }
+  const double relative_load = processor_->getRelativeLoad(idx_);
+  if (relative_load < ratio) {
+    return;
+  }
+  const ClientID client = server_read_streams_->getBusiestClient();
+  if (!client.valid()) {
+    return;
+  }
+  // The client will reconnect, likely to a less loaded worker, and restart
+  // its read streams from where they were.
+  ld_info("Closing connection of %s to move its read streams off %s, whose "
+          "load is %.2f times the average",
+          client.toString().c_str(),
+          getName().c_str(),
+          relative_load);
+  if (sender().closeClientSocket(client, E::SHUTDOWN) == 0) {
+    WORKER_STAT_INCR(worker_load_rebalancing_connections_closed);
+  }
+}
+
 void ServerWorker::onServerConfigUpdated() {
   ld_check(ServerWorker::onThisThread() == this);
   auto p = processor_;
@@ -122,6 +122,10 @@ class ServerWorker : public Worker {
   void noteShuttingDownNoPendingRequests() override;
   void initializeNodeStatsController();
 
+  // Closes the connection of the busiest reading client if this worker is
+  // overloaded. See --worker-load-rebalancing-ratio.
+  void rebalanceLoad() override;
+
   // Coordinator for tasks to storage threads to read from the local log store
   // and their replies, sharded by log ID to match ShardedStorageThreadPool
   // sharding
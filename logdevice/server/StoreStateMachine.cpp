@@ -14,6 +14,7 @@
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/event_log/EventLogRebuildingSet.h"
+#include "logdevice/common/protocol/MULTI_STORE_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/STORED_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
@@ -282,6 +283,27 @@ Message::Disposition StoreStateMachine::onReceived(STORE_Message* msg,
   return Message::Disposition::KEEP;
 }
 
+Message::Disposition StoreStateMachine::onReceived(MULTI_STORE_Message* msg,
+                                                   const Address& from) {
+  for (auto& store : msg->getStores()) {
+    Message::Disposition disp = onReceived(store.get(), from);
+    switch (disp) {
+      case Message::Disposition::KEEP:
+        // A StoreStateMachine took ownership of the record.
+        store.release();
+        break;
+      case Message::Disposition::NORMAL:
+        break;
+      case Message::Disposition::ERROR:
+        // Protocol violation, the connection is going to be closed. The rest
+        // of the records are dropped, same as messages that come after the
+        // bad one in the socket.
+        return disp;
+    }
+  }
+  return Message::Disposition::NORMAL;
+}
+
 // Check if a node index is being rebuilt in RELOCATE mode. If that's the
 // case, we will deny the STORE with E::REBUILDING.
 static bool destIsRebuilding(ShardID dest,
@@ -669,7 +691,8 @@ void StoreStateMachine::storeAndForward() {
       durability_,
       worker_settings.write_find_time_index,
       merge_mutable_per_epoch_log_metadata,
-      worker_settings.write_shard_id_in_copyset);
+      worker_settings.write_shard_id_in_copyset,
+      worker_settings.write_record_format_v2);
 
   // Forward to next node in chain
   if (header.flags & STORE_Header::CHAIN) {
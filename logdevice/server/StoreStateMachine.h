@@ -17,6 +17,7 @@
 
 namespace facebook { namespace logdevice {
 
+class MULTI_STORE_Message;
 class STORE_Message;
 
 /**
@@ -35,6 +36,14 @@ class StoreStateMachine {
    */
   static Message::Disposition onReceived(STORE_Message* msg,
                                          const Address& from);
+  /**
+   * Handles each record of a MULTI_STORE as if it arrived in a separate STORE
+   * message. Records are processed in order, so that the storage tasks of
+   * the ones that don't need to wait for the seal to be recovered end up on
+   * the write queue back to back and are written in one batch.
+   */
+  static Message::Disposition onReceived(MULTI_STORE_Message* msg,
+                                         const Address& from);
   /**
    * Check if the copyset of an incoming STORE message is valid.
    *
@@ -43,7 +43,8 @@ StoreStorageTask::StoreStorageTask(
     Durability durability,
     bool write_find_time_index,
     bool merge_mutable_per_epoch_log_metadata,
-    bool write_shard_id_in_copyset)
+    bool write_shard_id_in_copyset,
+    bool write_record_format_v2)
     : WriteStorageTask(StorageTask::Type::STORE),
       payload_holder_(payload_holder),
       timestamp_(store_header.timestamp),
@@ -68,7 +69,8 @@ StoreStorageTask::StoreStorageTask(
                                                       &record_header_buf_,
                                                       write_shard_id_in_copyset,
                                                       optional_keys,
-                                                      extra_),
+                                                      extra_,
+                                                      write_record_format_v2),
           payload_raw_,
           rebuilding_ ? copyset[0].destination.node()
                       : (store_header.sequencer_node_id.isNodeID()
@@ -308,9 +310,26 @@ void StoreStorageTask::sendReply(Status status) const {
 
   const ShardedStorageThreadPool* sharded_pool =
       worker->processor_->sharded_storage_thread_pool_;
-  Status st = sharded_pool->getByIndex(reply_shard_idx_)
-                  .getLocalLogStore()
-                  .acceptingWrites();
+  LocalLogStore& store =
+      sharded_pool->getByIndex(reply_shard_idx_).getLocalLogStore();
+  if (!(flags & STORED_Header::OVERLOADED) && store.isPacingWrites()) {
+    // Writes are coming in faster than the store can flush them. Ask the
+    // sequencer to prefer other nodes for a while.
+    flags |= STORED_Header::OVERLOADED;
+    WORKER_STAT_INCR(node_overloaded_sent);
+  }
+  if (!(flags & STORED_Header::OVERLOADED) &&
+      store.getWriteThrottleState() !=
+          LocalLogStore::WriteThrottleState::NONE) {
+    // Memtables are filling up faster than they are flushed. Writes will
+    // soon be rejected; tell the sequencer before that happens rather than
+    // after, so that it steers appends away instead of retrying into
+    // DROPPED replies.
+    flags |= STORED_Header::OVERLOADED;
+    WORKER_STAT_INCR(node_overloaded_sent);
+    WORKER_STAT_INCR(node_overloaded_sent_memtables);
+  }
+  Status st = store.acceptingWrites();
   if (st == E::LOW_ON_SPC) {
     flags |= STORED_Header::LOW_WATERMARK_NOSPC;
     WORKER_STAT_INCR(node_stored_low_on_space_sent);
@@ -8,6 +8,8 @@
 #include "logdevice/server/TRIM_onReceived.h"
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "logdevice/common/Metadata.h"
 #include "logdevice/common/PermissionChecker.h"
@@ -16,6 +18,7 @@
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/UpdateableSecurityInfo.h"
 #include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/protocol/MULTI_TRIM_Message.h"
 #include "logdevice/common/protocol/TRIMMED_Message.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/AuditLogFile.h"
@@ -38,85 +41,102 @@ static void send_reply(const Address& to,
 }
 
 namespace {
-// A task to write the trim point to local log store
+// A task to write the trim points of one or more logs to local log store.
+// Trim points received in the same MULTI_TRIM for the same shard are written
+// by a single task, and synced once.
 class WriteTrimMetadataTask : public StorageTask {
  public:
-  explicit WriteTrimMetadataTask(logid_t log_id,
-                                 lsn_t trim_point,
+  struct Trim {
+    logid_t log_id;
+    lsn_t trim_point;
+    request_id_t client_rqid;
+    Status status;
+  };
+
+  explicit WriteTrimMetadataTask(std::vector<Trim> trims,
                                  const Address& reply_to,
-                                 request_id_t client_rqid,
                                  std::string client_name,
                                  std::string client_address,
                                  PrincipalIdentity identity)
       : StorageTask(StorageTask::Type::WRITE_TRIM_METADATA),
-        log_id_(log_id),
-        trim_point_(trim_point),
+        trims_(std::move(trims)),
         reply_to_(reply_to),
-        client_rqid_(client_rqid),
-        status_(E::OK),
         client_name_(std::move(client_name)),
         client_address_(std::move(client_address)),
-        identity_(std::move(identity)) {}
+        identity_(std::move(identity)) {
+    ld_check(!trims_.empty());
+  }
 
   Principal getPrincipal() const override {
     return Principal::METADATA;
   }
 
   void execute() override {
+    for (Trim& trim : trims_) {
+      trim.status = writeTrimPoint(trim.log_id, trim.trim_point);
+    }
+  }
+
+  Durability durability() const override {
+    return durability_;
+  }
+
+  void onDone() override {
+    for (const Trim& trim : trims_) {
+      send_reply(reply_to_,
+                 trim.client_rqid,
+                 trim.status,
+                 storageThreadPool_->getShardIdx());
+    }
+  }
+
+  void onDropped() override {
+    for (const Trim& trim : trims_) {
+      send_reply(reply_to_,
+                 trim.client_rqid,
+                 E::FAILED,
+                 storageThreadPool_->getShardIdx());
+    }
+  }
+
+ private:
+  Status writeTrimPoint(logid_t log_id, lsn_t trim_point) {
     LocalLogStore& store = storageThreadPool_->getLocalLogStore();
     LogStorageStateMap& map =
         storageThreadPool_->getProcessor().getLogStorageStateMap();
 
-    TrimMetadata trim_metadata{trim_point_};
+    TrimMetadata trim_metadata{trim_point};
     LocalLogStore::WriteOptions options;
-    int rv = store.updateLogMetadata(log_id_, trim_metadata, options);
+    int rv = store.updateLogMetadata(log_id, trim_metadata, options);
     if (rv != 0) {
       // if local log store already contained a trim point with a higher LSN,
       // report it as a success to the client
-      status_ = (err == E::UPTODATE ? E::OK : E::FAILED);
-      return;
+      return err == E::UPTODATE ? E::OK : E::FAILED;
     }
     auto processor =
         checked_downcast<ServerProcessor*>(&storageThreadPool_->getProcessor());
     log_trim_movement(*processor,
                       store,
-                      log_id_,
-                      trim_point_,
+                      log_id,
+                      trim_point,
                       client_name_,
                       client_address_,
                       identity_);
 
     LogStorageState* log_state =
-        map.insertOrGet(log_id_, storageThreadPool_->getShardIdx());
+        map.insertOrGet(log_id, storageThreadPool_->getShardIdx());
     if (log_state == nullptr) {
-      status_ = E::FAILED;
-      return;
+      return E::FAILED;
     }
 
-    log_state->updateTrimPoint(trim_point_);
+    log_state->updateTrimPoint(trim_point);
+    // a single sync covers the trim points of all logs in the task
     durability_ = Durability::SYNC_WRITE;
+    return E::OK;
   }
 
-  Durability durability() const override {
-    return durability_;
-  }
-
-  void onDone() override {
-    send_reply(
-        reply_to_, client_rqid_, status_, storageThreadPool_->getShardIdx());
-  }
-
-  void onDropped() override {
-    send_reply(
-        reply_to_, client_rqid_, E::FAILED, storageThreadPool_->getShardIdx());
-  }
-
- private:
-  logid_t log_id_;
-  lsn_t trim_point_;
+  std::vector<Trim> trims_;
   Address reply_to_;
-  request_id_t client_rqid_;
-  Status status_;
   Durability durability_ = Durability::INVALID;
   std::string client_name_;
   std::string client_address_;
@@ -124,14 +144,12 @@ class WriteTrimMetadataTask : public StorageTask {
 };
 } // namespace
 
-static Message::Disposition
-send_reply(TRIM_Message* msg,
-           const Address& from,
-           shard_index_t shard_idx,
-           PermissionCheckStatus permission_status) {
-  const TRIM_Header& header = msg->getHeader();
-  ServerWorker* worker = ServerWorker::onThisThread();
-
+// Replies to a TRIM that failed the permission check.
+// @return  true if the TRIM is allowed
+static bool check_permission(const TRIM_Header& header,
+                             const Address& from,
+                             shard_index_t shard_idx,
+                             PermissionCheckStatus permission_status) {
   Status st = PermissionChecker::toStatus(permission_status);
   if (st != E::OK) {
     RATELIMIT_LEVEL(st == E::ACCESS ? dbg::Level::WARNING : dbg::Level::INFO,
@@ -142,6 +160,58 @@ send_reply(TRIM_Message* msg,
                     header.log_id.val_,
                     error_description(st));
     send_reply(from, header.client_rqid, st, shard_idx);
+    return false;
+  }
+  return true;
+}
+
+// Replies to a TRIM with an invalid log ID or trim point.
+// @return  true if the TRIM is valid
+static bool check_trim_point(const TRIM_Header& header,
+                             const Address& from,
+                             shard_index_t shard_idx) {
+  WORKER_LOG_STAT_INCR(header.log_id, trim_received);
+
+  if (header.log_id == LOGID_INVALID || header.trim_point == LSN_INVALID ||
+      !epoch_valid_or_unset(lsn_to_epoch(header.trim_point))) {
+    ld_error("Received an invalid TRIM message from %s: "
+             "log id %lu, trim point %lu",
+             Sender::describeConnection(from).c_str(),
+             header.log_id.val_,
+             header.trim_point);
+
+    send_reply(from, header.client_rqid, E::INVALID_PARAM, shard_idx);
+    return false;
+  }
+  return true;
+}
+
+// @return  true if `shard_idx` is a valid shard of this node
+static bool check_shard(shard_index_t shard_idx, const Address& from) {
+  auto scfg = ServerWorker::onThisThread()->getServerConfig();
+  const shard_size_t n_shards = scfg->getNumShards();
+  if (shard_idx >= n_shards) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Got TRIM message from client %s with "
+                    "invalid shard %u, this node only has %u shards",
+                    Sender::describeConnection(from).c_str(),
+                    shard_idx,
+                    n_shards);
+    return false;
+  }
+  return true;
+}
+
+static Message::Disposition
+send_reply(TRIM_Message* msg,
+           const Address& from,
+           shard_index_t shard_idx,
+           PermissionCheckStatus permission_status) {
+  const TRIM_Header& header = msg->getHeader();
+  ServerWorker* worker = ServerWorker::onThisThread();
+
+  if (!check_permission(header, from, shard_idx, permission_status)) {
     return Message::Disposition::NORMAL;
   }
 
@@ -165,27 +235,17 @@ send_reply(TRIM_Message* msg,
     return Message::Disposition::NORMAL;
   }
 
-  WORKER_LOG_STAT_INCR(header.log_id, trim_received);
-
-  if (header.log_id == LOGID_INVALID || header.trim_point == LSN_INVALID ||
-      !epoch_valid_or_unset(lsn_to_epoch(header.trim_point))) {
-    ld_error("Received an invalid TRIM message from %s: "
-             "log id %lu, trim point %lu",
-             Sender::describeConnection(from).c_str(),
-             header.log_id.val_,
-             header.trim_point);
-
-    send_reply(from, header.client_rqid, E::INVALID_PARAM, shard_idx);
+  if (!check_trim_point(header, from, shard_idx)) {
     return Message::Disposition::NORMAL;
   }
 
   // queue a task that'll write trim_point to the log store, update the
   // state map and send a reply to the client
+  std::vector<WriteTrimMetadataTask::Trim> trims{
+      {header.log_id, header.trim_point, header.client_rqid, E::OK}};
   auto task =
-      std::make_unique<WriteTrimMetadataTask>(header.log_id,
-                                              header.trim_point,
+      std::make_unique<WriteTrimMetadataTask>(std::move(trims),
                                               from,
-                                              header.client_rqid,
                                               Sender::describeConnection(from),
                                               sock_addr.toStringNoPort(),
                                               *identity);
@@ -207,17 +267,8 @@ Message::Disposition TRIM_onReceived(TRIM_Message* msg,
   const TRIM_Header& header = msg->getHeader();
   ServerWorker* worker = ServerWorker::onThisThread();
 
-  auto scfg = worker->getServerConfig();
-  const shard_size_t n_shards = scfg->getNumShards();
   shard_index_t shard_idx = header.shard;
-  if (shard_idx >= n_shards) {
-    RATELIMIT_ERROR(std::chrono::seconds(10),
-                    10,
-                    "Got TRIM message from client %s with "
-                    "invalid shard %u, this node only has %u shards",
-                    Sender::describeConnection(from).c_str(),
-                    shard_idx,
-                    n_shards);
+  if (!check_shard(shard_idx, from)) {
     return Message::Disposition::NORMAL;
   }
 
@@ -232,4 +283,83 @@ Message::Disposition TRIM_onReceived(TRIM_Message* msg,
 
   return send_reply(msg, from, shard_idx, permission_status);
 }
+
+Message::Disposition MULTI_TRIM_onReceived(
+    MULTI_TRIM_Message* msg,
+    const Address& from,
+    const std::vector<PermissionCheckStatus>& permission_statuses) {
+  if (!from.isClientAddress()) {
+    ld_error("Received MULTI_TRIM message from non-client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Message::Disposition::ERROR;
+  }
+
+  const std::vector<TRIM_Header>& headers = msg->getTrims();
+  ld_check(permission_statuses.size() == headers.size());
+  ServerWorker* worker = ServerWorker::onThisThread();
+  WORKER_STAT_INCR(multi_trim_received);
+  WORKER_STAT_ADD(multi_trim_trims_received, headers.size());
+
+  // Replies to all TRIMs of the message with `st`. TRIMs for invalid shards
+  // are dropped, same as when they come in separate messages.
+  auto reply_all = [&](Status st) {
+    for (const TRIM_Header& header : headers) {
+      if (check_shard(header.shard, from)) {
+        send_reply(from, header.client_rqid, st, header.shard);
+      }
+    }
+    return Message::Disposition::NORMAL;
+  };
+
+  if (!worker->processor_->runningOnStorageNode()) {
+    ld_warning("Received a MULTI_TRIM message from %s, but not a storage node",
+               Sender::describeConnection(from).c_str());
+    return reply_all(E::NOTSTORAGE);
+  }
+
+  if (!worker->isAcceptingWork()) {
+    ld_debug("Ignoring MULTI_TRIM message: not accepting more work");
+    return reply_all(E::SHUTDOWN);
+  }
+
+  // Check if socket still exists.
+  const auto identity = worker->sender().getPrincipal(from);
+  auto sock_addr = worker->sender().getSockaddr(from);
+  if (!identity || sock_addr == Sockaddr::INVALID) {
+    RATELIMIT_INFO(std::chrono::seconds(1),
+                   3,
+                   "Got MULTI_TRIM_Message with %zu trims but socket was "
+                   "closed while message was waiting in task queue to get "
+                   "processed.",
+                   headers.size());
+    return reply_all(E::AGAIN);
+  }
+
+  std::unordered_map<shard_index_t, std::vector<WriteTrimMetadataTask::Trim>>
+      trims_by_shard;
+  for (size_t i = 0; i < headers.size(); ++i) {
+    const TRIM_Header& header = headers[i];
+    const shard_index_t shard_idx = header.shard;
+    if (!check_shard(shard_idx, from) ||
+        !check_permission(header, from, shard_idx, permission_statuses[i]) ||
+        !check_trim_point(header, from, shard_idx)) {
+      continue;
+    }
+    trims_by_shard[shard_idx].push_back(
+        {header.log_id, header.trim_point, header.client_rqid, E::OK});
+  }
+
+  for (auto& kv : trims_by_shard) {
+    auto task = std::make_unique<WriteTrimMetadataTask>(
+        std::move(kv.second),
+        from,
+        Sender::describeConnection(from),
+        sock_addr.toStringNoPort(),
+        *identity);
+    worker->getStorageTaskQueueForShard(kv.first)->putTask(std::move(task));
+  }
+
+  return Message::Disposition::NORMAL;
+}
 }} // namespace facebook::logdevice
@@ -7,7 +7,10 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "logdevice/common/PermissionChecker.h"
+#include "logdevice/common/protocol/MULTI_TRIM_Message.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
 
@@ -18,4 +21,13 @@ struct Address;
 Message::Disposition TRIM_onReceived(TRIM_Message* msg,
                                      const Address& from,
                                      PermissionCheckStatus permission_status);
+
+// Handles the TRIMs of a MULTI_TRIM the same way as separate TRIM messages,
+// except that the trim points for each shard are written by a single storage
+// task. `permission_statuses` has the outcome of the permission check of each
+// TRIM, in the same order as MULTI_TRIM_Message::getTrims().
+Message::Disposition MULTI_TRIM_onReceived(
+    MULTI_TRIM_Message* msg,
+    const Address& from,
+    const std::vector<PermissionCheckStatus>& permission_statuses);
 }} // namespace facebook::logdevice
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/TrimPointPusher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/TRIM_POINT_UPDATE_Message.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+
+namespace facebook { namespace logdevice {
+
+TrimPointPusher::TrimPointPusher(ServerProcessor* processor)
+    : processor_(processor) {
+  ld_check(processor_);
+}
+
+void TrimPointPusher::push(node_index_t to, logid_t log_id, lsn_t trim_point) {
+  if (!processor_->settings()->push_trim_points) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  lsn_t& pending = pending_[to][log_id];
+  pending = std::max(pending, trim_point);
+  if (!flush_posted_) {
+    // If posting fails, the next push() tries again.
+    flush_posted_ = run_on_worker_nonblocking(processor_,
+                                              worker_id_t(-1),
+                                              WorkerType::GENERAL,
+                                              RequestType::MISC,
+                                              [this] { flush(); });
+  }
+}
+
+void TrimPointPusher::flush() {
+  decltype(pending_) pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending.swap(pending_);
+    flush_posted_ = false;
+  }
+
+  Sender& sender = ServerWorker::onThisThread()->sender();
+  for (auto& node_updates : pending) {
+    const NodeID to(node_updates.first);
+    auto it = node_updates.second.begin();
+    while (it != node_updates.second.end()) {
+      std::vector<TRIM_POINT_UPDATE_Entry> updates;
+      for (; it != node_updates.second.end() &&
+           updates.size() < MAX_UPDATES_PER_MESSAGE;
+           ++it) {
+        updates.push_back({it->first, it->second});
+      }
+      const size_t num_updates = updates.size();
+      auto msg =
+          std::make_unique<TRIM_POINT_UPDATE_Message>(std::move(updates));
+      if (sender.sendMessage(std::move(msg), to) != 0) {
+        // The sequencer node still gets the trim points by polling.
+        RATELIMIT_DEBUG(std::chrono::seconds(10),
+                        2,
+                        "Failed to send TRIM_POINT_UPDATE with %zu trim "
+                        "points to %s: %s",
+                        num_updates,
+                        to.toString().c_str(),
+                        error_description(err));
+        break;
+      }
+      WORKER_STAT_INCR(trim_point_update_messages_sent);
+      WORKER_STAT_ADD(trim_point_updates_sent, num_updates);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+class ServerProcessor;
+
+/**
+ * @file With --push-trim-points, storage nodes push trim point advances to
+ *       the nodes running the sequencers of the logs, instead of having
+ *       sequencers learn them only by polling with GET_TRIM_POINT every
+ *       --get-trimpoint-interval. A sequencer node subscribes to a log by
+ *       polling it (see LogStorageState::setTrimPointSubscriber()).
+ *
+ *       Trim points often advance for many logs at once (e.g. when
+ *       time-based trimming drops a partition). Advances are collected here
+ *       from whatever thread updates the trim point and sent from a worker
+ *       in one TRIM_POINT_UPDATE message per sequencer node.
+ */
+
+class TrimPointPusher {
+ public:
+  explicit TrimPointPusher(ServerProcessor* processor);
+
+  /**
+   * Queues an advance of the trim point of `log_id` to be sent to `to`.
+   * Thread safe.
+   */
+  void push(node_index_t to, logid_t log_id, lsn_t trim_point);
+
+  // Maximum number of trim points sent in one TRIM_POINT_UPDATE message.
+  static constexpr size_t MAX_UPDATES_PER_MESSAGE = 8192;
+
+ private:
+  // Sends all queued trim points. Runs on a worker.
+  void flush();
+
+  ServerProcessor* const processor_;
+
+  std::mutex mutex_;
+  // Trim points waiting to be sent, by node, at most one per log.
+  std::unordered_map<node_index_t,
+                     std::unordered_map<logid_t, lsn_t, logid_t::Hash>>
+      pending_;
+  // Whether a request to flush() was posted and hasn't run yet.
+  bool flush_posted_{false};
+};
+
+}} // namespace facebook::logdevice
@@ -7,7 +7,9 @@
  */
 #include "logdevice/server/ZookeeperEpochStore.h"
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 
 #include <boost/filesystem.hpp>
 #include <folly/Memory.h>
@@ -355,14 +357,10 @@ void ZookeeperEpochStore::onGetZnodeComplete(
       // number of znode on every write to that znode. If the versions do not
       // match zkSetCf() will be called with status ZBADVERSION. This ensures
       // that if our read-modify-write of znode_path succeeds, it was atomic.
-      std::shared_ptr<ZookeeperClientBase> zkclient = zkclient_.load();
-      auto cb = [this, req = std::move(zrq)](int res, zk::Stat) mutable {
-        postRequestCompletion(res, std::move(req));
-      };
-      zkclient->setData(std::move(znode_path),
-                        std::move(znode_value_str),
-                        std::move(cb),
-                        stat.version_);
+      writeZnode(std::move(zrq),
+                 std::move(znode_path),
+                 std::move(znode_value_str),
+                 stat.version_);
       return;
     }
   }
@@ -381,6 +379,170 @@ done:
   }
 }
 
+void ZookeeperEpochStore::writeZnode(
+    std::unique_ptr<ZookeeperEpochStoreRequest> zrq,
+    std::string znode_path,
+    std::string znode_value,
+    zk::version_t version) {
+  PendingWrite write{
+      std::move(znode_path), std::move(znode_value), version, std::move(zrq)};
+
+  const size_t max_ops = settings_->zk_epoch_store_write_batch_max_ops;
+  if (max_ops <= 1) {
+    setZnode(std::move(write));
+    return;
+  }
+
+  std::vector<PendingWrite> batch;
+  bool send_alone = false;
+  {
+    std::lock_guard<std::mutex> lock(write_batch_mutex_);
+    // Two writes to the same znode can't both succeed, and a failed op
+    // aborts the whole multi-op. Send the second one on its own.
+    send_alone = std::any_of(pending_writes_.begin(),
+                             pending_writes_.end(),
+                             [&](const PendingWrite& pending) {
+                               return pending.znode_path == write.znode_path;
+                             });
+    if (!send_alone) {
+      pending_writes_.push_back(std::move(write));
+      // Writes are batched while another batch is in flight: if ZooKeeper is
+      // idle, a lone write goes out right away.
+      if (write_batches_in_flight_ == 0 || pending_writes_.size() >= max_ops) {
+        batch.swap(pending_writes_);
+        ++write_batches_in_flight_;
+      }
+    }
+  }
+
+  if (send_alone) {
+    setZnode(std::move(write));
+  } else if (!batch.empty()) {
+    sendWriteBatch(std::move(batch));
+  }
+}
+
+void ZookeeperEpochStore::setZnode(PendingWrite write) {
+  std::shared_ptr<ZookeeperClientBase> zkclient = zkclient_.load();
+  auto cb = [this, req = std::move(write.zrq)](int res, zk::Stat) mutable {
+    postRequestCompletion(res, std::move(req));
+  };
+  zkclient->setData(std::move(write.znode_path),
+                    std::move(write.znode_value),
+                    std::move(cb),
+                    write.version);
+}
+
+void ZookeeperEpochStore::sendWriteBatch(std::vector<PendingWrite> batch) {
+  ld_check(!batch.empty());
+  std::shared_ptr<ZookeeperClientBase> zkclient = zkclient_.load();
+
+  if (batch.size() == 1) {
+    // no need for a multi-op
+    auto cb = [this, req = std::move(batch[0].zrq)](int res, zk::Stat) mutable {
+      postRequestCompletion(res, std::move(req));
+      onWriteBatchDone();
+    };
+    zkclient->setData(std::move(batch[0].znode_path),
+                      std::move(batch[0].znode_value),
+                      std::move(cb),
+                      batch[0].version);
+    return;
+  }
+
+  std::vector<zk::Op> ops;
+  ops.reserve(batch.size());
+  for (const PendingWrite& write : batch) {
+    ops.emplace_back(ZookeeperClientBase::makeSetOp(
+        write.znode_path, write.znode_value, write.version));
+  }
+
+  STAT_INCR(processor_->stats_, zookeeper_epoch_store_write_batches);
+  STAT_ADD(processor_->stats_,
+           zookeeper_epoch_store_batched_writes,
+           batch.size());
+  STAT_ADD(processor_->stats_,
+           zookeeper_epoch_store_write_round_trips_saved,
+           batch.size() - 1);
+
+  auto cb = [this, batch = std::move(batch)](
+                int rc, std::vector<zk::OpResponse> results) mutable {
+    onWriteBatchResult(rc, std::move(results), std::move(batch));
+    onWriteBatchDone();
+  };
+  zkclient->multiOp(std::move(ops), std::move(cb));
+}
+
+void ZookeeperEpochStore::onWriteBatchResult(
+    int rc,
+    std::vector<zk::OpResponse> results,
+    std::vector<PendingWrite> batch) {
+  if (rc == ZOK) {
+    for (PendingWrite& write : batch) {
+      postRequestCompletion(ZOK, std::move(write.zrq));
+    }
+    return;
+  }
+
+  // The multi-op was rolled back. If ZooKeeper attributed the failure to one
+  // of the ops (e.g. ZBADVERSION because another node bumped the epoch of
+  // that log), only that request fails. Ops before it report ZOK and ops
+  // after it ZRUNTIMEINCONSISTENCY, but none of them was applied: send them
+  // again on their own.
+  folly::Optional<size_t> failed_op;
+  if (results.size() == batch.size()) {
+    for (size_t i = 0; i < results.size(); ++i) {
+      if (results[i].rc_ != ZOK && results[i].rc_ != ZRUNTIMEINCONSISTENCY) {
+        failed_op = i;
+        break;
+      }
+    }
+  }
+
+  if (!failed_op.hasValue()) {
+    // session or connection level failure, all requests fail with it
+    for (PendingWrite& write : batch) {
+      postRequestCompletion(rc, std::move(write.zrq));
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (i == failed_op.value()) {
+      postRequestCompletion(results[i].rc_, std::move(batch[i].zrq));
+    } else {
+      STAT_INCR(processor_->stats_,
+                zookeeper_epoch_store_batched_writes_retried);
+      setZnode(std::move(batch[i]));
+    }
+  }
+}
+
+void ZookeeperEpochStore::onWriteBatchDone() {
+  std::vector<PendingWrite> batch;
+  {
+    std::lock_guard<std::mutex> lock(write_batch_mutex_);
+    ld_check(write_batches_in_flight_ > 0);
+    --write_batches_in_flight_;
+    if (pending_writes_.empty()) {
+      return;
+    }
+    const size_t max_ops =
+        std::max<size_t>(settings_->zk_epoch_store_write_batch_max_ops, 1);
+    if (pending_writes_.size() <= max_ops) {
+      batch.swap(pending_writes_);
+    } else {
+      std::move(pending_writes_.begin(),
+                pending_writes_.begin() + max_ops,
+                std::back_inserter(batch));
+      pending_writes_.erase(
+          pending_writes_.begin(), pending_writes_.begin() + max_ops);
+    }
+    ++write_batches_in_flight_;
+  }
+  sendWriteBatch(std::move(batch));
+}
+
 void ZookeeperEpochStore::postRequestCompletion(
     int rc,
     std::unique_ptr<ZookeeperEpochStoreRequest> zrq) {
@@ -9,7 +9,9 @@
 
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
@@ -198,6 +200,49 @@ class ZookeeperEpochStore : public EpochStore, boost::noncopyable {
    */
   void provisionLogZnodes(std::unique_ptr<ZookeeperEpochStoreRequest> zrq,
                           std::string znode_value);
+
+  // A conditional znode write waiting to be sent in a multi-op.
+  struct PendingWrite {
+    std::string znode_path;
+    std::string znode_value;
+    zk::version_t version;
+    std::unique_ptr<ZookeeperEpochStoreRequest> zrq;
+  };
+
+  /**
+   * Writes `znode_value` into `znode_path` if the znode is still at
+   * `version`, then posts the completion of zrq.
+   *
+   * If zk-epoch-store-write-batch-max-ops is greater than 1 and another
+   * batch of writes is in flight, the write is queued and sent together with
+   * the other writes queued in the meantime in a single multi-op. This turns
+   * the epoch bumps and LCE updates of a mass recovery into a few ZooKeeper
+   * transactions instead of one round trip per log.
+   */
+  void writeZnode(std::unique_ptr<ZookeeperEpochStoreRequest> zrq,
+                  std::string znode_path,
+                  std::string znode_value,
+                  zk::version_t version);
+
+  // Sends a single, non-batched, conditional write.
+  void setZnode(PendingWrite write);
+
+  // Sends `batch` as a multi-op and demultiplexes the per-op results.
+  void sendWriteBatch(std::vector<PendingWrite> batch);
+
+  void onWriteBatchResult(int rc,
+                          std::vector<zk::OpResponse> results,
+                          std::vector<PendingWrite> batch);
+
+  // Called when a batch completes. Sends the writes queued in the meantime.
+  void onWriteBatchDone();
+
+  // Protects pending_writes_ and write_batches_in_flight_. ZooKeeper
+  // callbacks that issue writes may run on different threads.
+  std::mutex write_batch_mutex_;
+  // writes waiting for the in-flight batch to complete
+  std::vector<PendingWrite> pending_writes_;
+  size_t write_batches_in_flight_{0};
 };
 
 }} // namespace facebook::logdevice
@@ -35,6 +35,8 @@
 #include "logdevice/server/admincommands/InfoIterators.h"
 #include "logdevice/server/admincommands/InfoLogsConfigRsm.h"
 #include "logdevice/server/admincommands/InfoLogsDBMetadata.h"
+#include "logdevice/server/admincommands/InfoMemory.h"
+#include "logdevice/server/admincommands/InfoNuma.h"
 #include "logdevice/server/admincommands/InfoPartitions.h"
 #include "logdevice/server/admincommands/InfoPurges.h"
 #include "logdevice/server/admincommands/InfoReaders.h"
@@ -50,8 +52,10 @@
 #include "logdevice/server/admincommands/InfoShards.h"
 #include "logdevice/server/admincommands/InfoSockets.h"
 #include "logdevice/server/admincommands/InfoStorageTasks.h"
+#include "logdevice/server/admincommands/InfoStalls.h"
 #include "logdevice/server/admincommands/InfoStoredLogs.h"
 #include "logdevice/server/admincommands/InfoSyncSequencerRequests.h"
+#include "logdevice/server/admincommands/InjectMessageLatency.h"
 #include "logdevice/server/admincommands/InjectShardFault.h"
 #include "logdevice/server/admincommands/ListOrEraseMetadata.h"
 #include "logdevice/server/admincommands/LogStorageStateCommand.h"
@@ -68,6 +72,7 @@
 #include "logdevice/server/admincommands/Stats.h"
 #include "logdevice/server/admincommands/StatsHistogram.h"
 #include "logdevice/server/admincommands/StatsJemalloc.h"
+#include "logdevice/server/admincommands/StatsPerf.h"
 #include "logdevice/server/admincommands/StatsRocks.h"
 #include "logdevice/server/admincommands/StatsThroughput.h"
 #include "logdevice/server/admincommands/Stop.h"
@@ -120,10 +125,13 @@ AdminCommandFactory::AdminCommandFactory() {
                                                /* erase */ true);
   selector_.add<commands::InfoIterators>("info iterators");
   selector_.add<commands::InfoShards>("info shards");
+  selector_.add<commands::InfoNuma>("info numa");
+  selector_.add<commands::InfoMemory>("info memory");
   selector_.add<commands::InfoSettings>("info settings");
   selector_.add<commands::InfoRecordCache>("info record_cache");
   selector_.add<commands::InfoStorageTasks>("info storage_tasks");
   selector_.add<commands::InfoStoredLogs>("info stored_logs");
+  selector_.add<commands::InfoStalls>("info stalls");
   selector_.add<commands::InfoReplication>("info replication");
   selector_.add<commands::InfoShardOperationalState>("info shardopstate");
 
@@ -151,8 +159,10 @@ AdminCommandFactory::AdminCommandFactory() {
 
   selector_.add<commands::Stats>("stats2");
   selector_.add<commands::StatsWorker>("stats worker");
+  selector_.add<commands::StatsBinary>("stats binary");
   selector_.add<commands::StatsReset>("stats reset");
   selector_.add<commands::StatsRocks>("stats rocksdb");
+  selector_.add<commands::StatsPerf>("stats perf");
 
   selector_.add<commands::StatsHistogram>("stats2 histogram");
   selector_.add<commands::TrafficShapingHistogram>("stats2 shaping");
@@ -177,6 +187,7 @@ AdminCommandFactory::AdminCommandFactory() {
 
   // Not restricting to localhost to be able to run from ldops and tests
   selector_.add<commands::InjectShardFault>("inject shard_fault");
+  selector_.add<commands::InjectMessageLatency>("inject message_latency");
 
   selector_.add<commands::BlockCatchupQueue>(
       "block catchup_queue", Restriction::LOCALHOST_ONLY);
@@ -191,6 +202,8 @@ AdminCommandFactory::AdminCommandFactory() {
   selector_.add<commands::Down>("down", Restriction::LOCALHOST_ONLY);
   selector_.add<commands::DeactivateSequencer>(
       "sequencer_stop", Restriction::LOCALHOST_ONLY);
+  selector_.add<commands::ActivateSequencers>(
+      "sequencer_start", Restriction::LOCALHOST_ONLY);
   selector_.add<commands::CloseSocket>(
       "close_socket", Restriction::LOCALHOST_ONLY);
   selector_.add<commands::GossipBlacklist, bool>(
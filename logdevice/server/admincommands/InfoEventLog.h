@@ -55,6 +55,9 @@ class InfoEventLog : public AdminCommand {
                                           "Delta log bytes",
                                           "Delta log records",
                                           "Delta log healthy",
+                                          "Snapshot sync ms",
+                                          "Delta sync ms",
+                                          "Deltas replayed",
                                           "Propagated version");
 
     std::atomic<lsn_t> min_propagated_version{LSN_MAX};
@@ -85,7 +88,7 @@ class InfoEventLog : public AdminCommand {
 
     ld_check_eq(1ul, table.numRows());
     ld_check(min_propagated_version.load() < LSN_MAX);
-    table.set<14>(min_propagated_version.load());
+    table.set<17>(min_propagated_version.load());
     json_ ? table.printJson(out_) : table.printRowVertically(0, out_);
   }
 };
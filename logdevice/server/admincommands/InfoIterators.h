@@ -50,9 +50,11 @@ class InfoIterators : public AdminCommand {
                              "More context",
                              "Last seek LSN",
                              "Last seek timestamp",
-                             "Version");
+                             "Version",
+                             "Age ms");
 
     auto info = IteratorTracker::get()->getDebugInfo();
+    const auto now = RecordTimestamp::now();
 
     auto type_to_string = [](TrackableIterator::IteratorType v) -> std::string {
       switch (v) {
@@ -80,7 +82,12 @@ class InfoIterators : public AdminCommand {
           .set<4>(type_to_string(row.imm.type))
           .set<5>(row.imm.created_by_rebuilding)
           .set<6>(row.imm.high_level_id)
-          .set<7>(row.imm.created.toMilliseconds().count());
+          .set<7>(row.imm.created.toMilliseconds().count())
+          .set<12>(std::max<int64_t>(
+              0,
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  now - row.imm.created)
+                  .count()));
       if (row.mut.more_context) {
         table.set<8>(std::string(row.mut.more_context));
       }
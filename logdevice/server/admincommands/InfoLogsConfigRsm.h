@@ -55,6 +55,9 @@ class InfoLogsConfigRsm : public AdminCommand {
                                           "Delta log bytes",
                                           "Delta log records",
                                           "Delta log healthy",
+                                          "Snapshot sync ms",
+                                          "Delta sync ms",
+                                          "Deltas replayed",
                                           "Propagated version");
 
     auto tables = run_on_all_workers(server_->getProcessor(), [&]() {
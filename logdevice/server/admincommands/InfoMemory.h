@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/MemoryGovernor.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Lists the memory consumers tracked by MemoryGovernor, with the current
+ * usage and limits of each. Consumers with the same name (e.g. the read
+ * storage task budgets of all workers) are summed up in one row. "Limit" is
+ * below "Base limit" while the governor is shrinking the budget because of
+ * --memory-governor-limit-bytes.
+ */
+class InfoMemory : public AdminCommand {
+ private:
+  bool json_ = false;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()("json",
+                              boost::program_options::bool_switch(&json_));
+  }
+  std::string getUsage() override {
+    return "info memory [--json]";
+  }
+
+  void run() override {
+    InfoMemoryTable table(!json_,
+                          "Consumer",
+                          "Count",
+                          "Used",
+                          "Limit",
+                          "Base limit",
+                          "Elastic");
+
+    for (const auto& c : MemoryGovernor::get()->getConsumers()) {
+      table.next()
+          .set<0>(c.name)
+          .set<1>(c.count)
+          .set<2>(c.used)
+          .set<5>(c.elastic);
+      if (c.elastic) {
+        table.set<3>(c.limit).set<4>(c.base_limit);
+      }
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
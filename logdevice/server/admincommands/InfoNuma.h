@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <folly/String.h>
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/NumaTopology.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+#include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Lists NUMA nodes of the host with the shards whose storage threads are
+ * pinned to them (see --numa-aware-placement) and the kernel's counters of
+ * pages allocated on and off each node. A growing numa_miss/other_node means
+ * threads keep allocating memory away from the node they run on.
+ */
+class InfoNuma : public AdminCommand {
+ private:
+  bool json_ = false;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()("json",
+                              boost::program_options::bool_switch(&json_));
+  }
+  std::string getUsage() override {
+    return "info numa [--json]";
+  }
+
+  void run() override {
+    InfoNumaTable table(!json_,
+                        "Node",
+                        "CPUs",
+                        "Shards",
+                        "numa_hit",
+                        "numa_miss",
+                        "numa_foreign",
+                        "local_node",
+                        "other_node");
+
+    const NumaTopology topology = NumaTopology::detect();
+    auto pool = server_->getServerProcessor()->sharded_storage_thread_pool_;
+
+    for (int node : topology.nodes()) {
+      std::vector<int> shards;
+      if (pool) {
+        for (shard_index_t shard_idx = 0; shard_idx < pool->numShards();
+             ++shard_idx) {
+          if (pool->getNumaNode(shard_idx) == node) {
+            shards.push_back(shard_idx);
+          }
+        }
+      }
+
+      table.next()
+          .set<0>(node)
+          .set<1>(folly::join(',', topology.cpusOfNode(node)))
+          .set<2>(folly::join(',', shards));
+      auto stats = topology.readNodeStats(node);
+      if (stats.hasValue()) {
+        table.set<3>(stats->numa_hit)
+            .set<4>(stats->numa_miss)
+            .set<5>(stats->numa_foreign)
+            .set<6>(stats->local_node)
+            .set<7>(stats->other_node);
+      }
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Timestamp.h"
+#include "logdevice/common/WatchDogThread.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Prints the stack samples that watchdog took of Workers it found stalled,
+ * see --watchdog-stall-samples. Doesn't need the Workers, so it works while
+ * they are stalled.
+ */
+class InfoStalls : public AdminCommand {
+ private:
+  bool json_ = false;
+
+ public:
+  using InfoStallsTable = AdminCommandTable<std::string, // Time
+                                            std::string, // Worker
+                                            std::chrono::milliseconds,
+                                            size_t,      // Samples
+                                            std::string, // Running
+                                            std::string  // Stack
+                                            >;
+
+  void getOptions(boost::program_options::options_description& opts) override {
+    opts.add_options()("json", boost::program_options::bool_switch(&json_));
+  }
+
+  std::string getUsage() override {
+    return "info stalls [--json]";
+  }
+
+  void run() override {
+    WatchDogThread* watchdog = server_->getProcessor()->watchdog_thread_.get();
+    if (watchdog == nullptr) {
+      out_.printf("Watchdog is not running\r\n");
+      return;
+    }
+    auto reports = watchdog->getStallReports();
+
+    if (!json_) {
+      for (const auto& report : reports) {
+        out_.printf("%s: %s stalled for %s\r\n",
+                    format_time(report.time).c_str(),
+                    report.worker.c_str(),
+                    format_time(report.stalled_for).c_str());
+        for (const auto& stack : report.stacks) {
+          out_.printf("  %zu samples, running %s\r\n%s\r\n",
+                      stack.count,
+                      stack.running.c_str(),
+                      stack.trace.c_str());
+        }
+      }
+      return;
+    }
+
+    InfoStallsTable table(false,
+                          "Time",
+                          "Worker",
+                          "Stalled for",
+                          "Samples",
+                          "Running",
+                          "Stack");
+    for (const auto& report : reports) {
+      for (const auto& stack : report.stacks) {
+        table.next()
+            .set<0>(format_time(report.time))
+            .set<1>(report.worker)
+            .set<2>(report.stalled_for)
+            .set<3>(stack.count)
+            .set<4>(stack.running)
+            .set<5>(stack.trace);
+      }
+    }
+    table.printJson(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
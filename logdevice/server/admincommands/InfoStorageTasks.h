@@ -8,6 +8,7 @@
 #pragma once
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
@@ -88,6 +89,31 @@ class InfoStorageTasks : public AdminCommand {
       table.printJson(out_, table.numCols());
     } else {
       table.print(out_, table.numCols());
+      printStolenTasks(shard_lo, shard_hi);
+    }
+  }
+
+ private:
+  // With storage-tasks-work-stealing, reports how many tasks of each thread
+  // type's queue were executed by idle threads of other types.
+  void printStolenTasks(shard_index_t shard_lo, shard_index_t shard_hi) {
+    if (!server_->getProcessor()->settings()->storage_tasks_work_stealing) {
+      return;
+    }
+    out_.printf("Work stealing (tasks taken by threads of other types):\r\n");
+    for (shard_index_t shard_idx = shard_lo; shard_idx <= shard_hi;
+         ++shard_idx) {
+      StorageThreadPool& pool =
+          server_->getServerProcessor()
+              ->sharded_storage_thread_pool_->getByIndex(shard_idx);
+      out_.printf("  shard %d:", shard_idx);
+      for (int type = 0; type < (int)StorageTask::ThreadType::MAX; ++type) {
+        const auto t = static_cast<StorageTask::ThreadType>(type);
+        out_.printf(" %s=%lu",
+                    storageTaskThreadTypeName(t).c_str(),
+                    pool.getNumTasksStolen(t));
+      }
+      out_.printf("\r\n");
     }
   }
 };
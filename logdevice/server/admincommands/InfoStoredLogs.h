@@ -27,19 +27,26 @@ class InfoStoredLogs : public AdminCommand {
  private:
   bool extended_ = false;
   bool json_ = false;
+  folly::Optional<logid_t> logid_;
+  shard_index_t shard_ = -1;
 
  public:
   void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
         "extended", boost::program_options::bool_switch(&extended_))(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "logid",
+        boost::program_options::value<logid_t::raw_type>()->notifier(
+            [this](logid_t::raw_type id) { logid_ = logid_t(id); }))(
+        "shard", boost::program_options::value<shard_index_t>(&shard_));
   }
   void getPositionalOptions(
       boost::program_options::positional_options_description& /*out_options*/)
       override {}
   std::string getUsage() override {
-    return "info stored_logs [--extended] [--json]";
+    return "info stored_logs [--extended] [--json] [--logid <logid>] "
+           "[--shard <shard>]";
   }
 
   void run() override {
@@ -54,6 +61,9 @@ class InfoStoredLogs : public AdminCommand {
       auto sharded_store = server_->getShardedLocalLogStore();
 
       for (int shard = 0; shard < sharded_store->numShards(); ++shard) {
+        if (shard_ != -1 && shard != shard_) {
+          continue;
+        }
         auto store = sharded_store->getByIndex(shard);
         auto partitioned_store = dynamic_cast<PartitionedRocksDBStore*>(store);
         if (partitioned_store == nullptr) {
@@ -77,7 +87,8 @@ class InfoStoredLogs : public AdminCommand {
                     .set<4>(highest_timestamp_approx.toMilliseconds());
               }
             },
-            /* only_log_ids */ !extended_);
+            /* only_log_ids */ !extended_,
+            logid_);
       }
     }
 
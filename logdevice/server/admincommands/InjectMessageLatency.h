@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <folly/Optional.h>
+
+#include "logdevice/common/LatencyInjection.h"
+#include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Delays messages of a given type sent by this node, to simulate a slow node
+ * or a slow network. See MessageLatencyInjection.
+ */
+class InjectMessageLatency : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  std::string type_name_;
+  uint32_t latency_ms_{0};
+  LatencyDistribution::Type distribution_{LatencyDistribution::Type::FIXED};
+  uint32_t latency_max_ms_{0};
+  uint64_t seed_{0};
+  double percent_chance_ = 100;
+  bool force_{false};
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    // clang-format off
+    out_options.add_options()
+      ("type", boost::program_options::value<std::string>(&type_name_)
+        ->required())
+      ("latency", boost::program_options::value<uint32_t>(&latency_ms_))
+      ("distribution", boost::program_options::value<std::string>()
+        ->notifier([this](const std::string &value) {
+          auto type = LatencyDistribution::parseType(value);
+          if (!type.hasValue()) {
+            throw boost::program_options::error(
+              "value of 'distribution' must be either 'fixed', 'uniform' "
+              "or 'exponential'; " + value + " given.");
+          }
+          distribution_ = type.value();
+        })
+      )
+      ("latency_max",
+        boost::program_options::value<uint32_t>(&latency_max_ms_))
+      ("seed", boost::program_options::value<uint64_t>(&seed_))
+      ("chance", boost::program_options::value<double>(&percent_chance_)
+        ->notifier([this](const double& value) {
+          if (value < 0 || value > 100) {
+            throw boost::program_options::error(
+              "'chance' must be between 0 and 100.'; " +
+              std::to_string(value) + " given.");
+          }
+        })
+      )
+      ("force", boost::program_options::bool_switch(&force_));
+    // clang-format on
+  }
+
+  void getPositionalOptions(
+      boost::program_options::positional_options_description& out_options)
+      override {
+    out_options.add("type", 1);
+    out_options.add("latency", 1);
+  }
+
+  std::string getUsage() override {
+    return "inject message_latency "
+           "<MESSAGE_TYPE|all|none> "
+           "[LATENCY_MS] "
+           "[--distribution=fixed|uniform|exponential] "
+           "[--latency_max=LATENCY_MS] "
+           "[--chance=PERCENT] "
+           "[--seed=SEED]";
+  }
+
+  void run() override {
+    // If this is a production build, require passing --force.
+    if (!folly::kIsDebug) {
+      if (!force_) {
+        out_.write("inject: Production build."
+                   "Use --force to proceed anyway.\r\n");
+        return;
+      }
+    }
+
+    auto& injection = MessageLatencyInjection::instance();
+    if (type_name_ == "none") {
+      injection.clear();
+    } else {
+      folly::Optional<MessageType> type;
+      if (type_name_ != "all") {
+        type = messageTypeNames().reverseLookup(type_name_);
+        if (type.value() == MessageType::INVALID) {
+          out_.printf("Error: unknown message type %s\r\n", type_name_.c_str());
+          return;
+        }
+      }
+      injection.set(type,
+                    LatencyDistribution(std::chrono::milliseconds(latency_ms_),
+                                        distribution_,
+                                        std::chrono::milliseconds(
+                                            latency_max_ms_),
+                                        seed_),
+                    percent_chance_);
+    }
+
+    for (const auto& entry : injection.describe()) {
+      out_.printf("%s: %s\r\n",
+                  messageTypeNames()[entry.first].c_str(),
+                  entry.second.c_str());
+    }
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
@@ -34,6 +34,10 @@ class InjectShardFault : public AdminCommand {
   bool single_shot_ = false;
   double percent_chance_ = 100;
   uint32_t latency_ms_{0};
+  LatencyDistribution::Type latency_distribution_{
+      LatencyDistribution::Type::FIXED};
+  uint32_t latency_max_ms_{0};
+  uint64_t seed_{0};
   bool force_{false};
 
  public:
@@ -93,6 +97,20 @@ class InjectShardFault : public AdminCommand {
       )
       ("single_shot", boost::program_options::bool_switch(&single_shot_))
       ("latency",  boost::program_options::value<uint32_t>(&latency_ms_))
+      ("latency_distribution", boost::program_options::value<std::string>()
+        ->notifier([this](const std::string &value) {
+          auto type = LatencyDistribution::parseType(value);
+          if (!type.hasValue()) {
+            throw boost::program_options::error(
+              "value of 'latency_distribution' must be either 'fixed', "
+              "'uniform' or 'exponential'; " + value + " given.");
+          }
+          latency_distribution_ = type.value();
+        })
+      )
+      ("latency_max",
+        boost::program_options::value<uint32_t>(&latency_max_ms_))
+      ("seed", boost::program_options::value<uint64_t>(&seed_))
       ("chance", boost::program_options::value<double>(&percent_chance_)
         ->notifier([this](const double& value) {
           if (value < 0 || value > 100) {
@@ -122,8 +140,11 @@ class InjectShardFault : public AdminCommand {
            "<r|read|w|write|a|all|n|none> "
            "<io_error|corruption|latency|none> "
            "[--single_shot] "
-           "[--chance=PERCENT]"
-           "[--latency=LATENCY_MS]";
+           "[--chance=PERCENT] "
+           "[--latency=LATENCY_MS] "
+           "[--latency_distribution=fixed|uniform|exponential] "
+           "[--latency_max=LATENCY_MS] "
+           "[--seed=SEED]";
   }
 
   void run() override {
@@ -173,7 +194,10 @@ class InjectShardFault : public AdminCommand {
           fault_type_,
           single_shot_ ? InjectMode::SINGLE_SHOT : InjectMode::PERSISTENT,
           percent_chance_,
-          std::chrono::milliseconds(latency_ms_));
+          LatencyDistribution(std::chrono::milliseconds(latency_ms_),
+                              latency_distribution_,
+                              std::chrono::milliseconds(latency_max_ms_),
+                              seed_));
     }
   }
 };
@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/server/admincommands/SequencerActivationRequest.h"
+
+#include <algorithm>
+
+#include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Sequencer.h"
+#include "logdevice/common/SequencerLocator.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+void SequencerActivationRequest::pruneInFlight() {
+  auto& seqmap = Worker::onThisThread()->processor_->allSequencers();
+  in_flight_.erase(std::remove_if(in_flight_.begin(),
+                                  in_flight_.end(),
+                                  [&](logid_t log_id) {
+                                    auto seq = seqmap.findSequencer(log_id);
+                                    return !seq ||
+                                        seq->getState() !=
+                                        Sequencer::State::ACTIVATING;
+                                  }),
+                   in_flight_.end());
+}
+
+void SequencerActivationRequest::activate(logid_t log_id) {
+  auto& seqmap = Worker::onThisThread()->processor_->allSequencers();
+  int rv = seqmap.activateSequencerIfNotActive(log_id, "bulk activation");
+  if (rv == 0) {
+    in_flight_.push_back(log_id);
+    ++n_started_;
+    return;
+  }
+  switch (err) {
+    case E::EXISTS:
+    case E::INPROGRESS:
+      // already active or activated by an append in the meantime
+      ++n_skipped_;
+      break;
+    case E::FAILED:
+    case E::TOOMANY:
+      // transient, the first append will retry
+      ld_warning("Failed to activate sequencer for log %lu: %s",
+                 log_id.val_,
+                 error_name(err));
+      ++n_skipped_;
+      break;
+    default:
+      ld_error("Failed to activate sequencer for log %lu: %s",
+               log_id.val_,
+               error_name(err));
+      ++n_skipped_;
+      break;
+  }
+}
+
+void SequencerActivationRequest::onSequencerNodeFound(Status st,
+                                                      logid_t log_id,
+                                                      NodeID node_id) {
+  ld_check(pending_locates_ > 0);
+  --pending_locates_;
+  Processor* processor = Worker::onThisThread()->processor_;
+  if (st == E::OK && node_id.isNodeID() &&
+      node_id.index() == processor->getMyNodeID().index()) {
+    activate(log_id);
+  } else {
+    ++n_skipped_;
+  }
+}
+
+void SequencerActivationRequest::onTimeout() {
+  pruneInFlight();
+
+  auto& locator = *Worker::onThisThread()->processor_->sequencer_locator_;
+  while (!logs_.empty() &&
+         in_flight_.size() + pending_locates_ < static_cast<size_t>(batch_)) {
+    logid_t log_id = logs_.front();
+    logs_.pop();
+    if (!all_logs_) {
+      activate(log_id);
+      continue;
+    }
+    ++pending_locates_;
+    auto cb = [ref = ref_holder_.ref()](
+                  Status st, logid_t log, NodeID node_id) {
+      if (ref) {
+        ref->onSequencerNodeFound(st, log, node_id);
+      }
+    };
+    if (locator.locateSequencer(log_id, cb) != 0) {
+      --pending_locates_;
+      ++n_skipped_;
+    }
+  }
+
+  if (!logs_.empty() || !in_flight_.empty() || pending_locates_ > 0) {
+    setupTimer();
+  } else {
+    ld_info("Bulk sequencer activation done: started %lu activations, "
+            "skipped %lu logs",
+            n_started_,
+            n_skipped_);
+    destroy();
+  }
+}
+
+void SequencerActivationRequest::setupTimer() {
+  timer_.assign([this] { onTimeout(); });
+  timer_.activate(timer_wait_);
+}
+
+void SequencerActivationRequest::executionBody() {
+  ld_check(batch_ > 0);
+  if (all_logs_) {
+    auto logs_config = Worker::onThisThread()->getConfig()->localLogsConfig();
+    ld_check(logs_config);
+    logs_ = std::queue<logid_t>();
+    for (auto it = logs_config->logsBegin(); it != logs_config->logsEnd();
+         ++it) {
+      logs_.push(logid_t(it->first));
+    }
+  }
+  ld_info("Starting bulk activation of sequencers for %lu%s logs, "
+          "%d at a time",
+          logs_.size(),
+          all_logs_ ? " (all)" : "",
+          batch_);
+  onTimeout();
+}
+
+WorkerType SequencerActivationRequest::getWorkerTypeAffinity() {
+  return WorkerType::BACKGROUND;
+}
+
+}} // namespace facebook::logdevice
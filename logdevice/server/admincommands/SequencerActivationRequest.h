@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <queue>
+#include <vector>
+
+#include "logdevice/common/FireAndForgetRequest.h"
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Request.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/WeakRefHolder.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file SequencerActivationRequest.h
+ *
+ * Activates sequencers for many logs ahead of the first appends, e.g. right
+ * after a failover. Without it, every log is activated by the first
+ * GET_SEQ_STATE or append that reaches this node, and the resulting wave of
+ * activations hits the epoch store all at once.
+ *
+ * Keeps up to `batch` activations in flight: their epoch store requests are
+ * pipelined to the epoch store, and a new activation starts as soon as one
+ * of them completes. Since it is fire and forget - user is not blocked.
+ */
+class SequencerActivationRequest : public FireAndForgetRequest {
+ public:
+  /**
+   * @param logs       logs to activate sequencers for
+   * @param batch      maximum number of activations in flight
+   * @param all_logs   if true, `logs` is ignored and all logs in the config
+   *                   for which the sequencer locator picks this node are
+   *                   activated
+   */
+  SequencerActivationRequest(std::queue<logid_t> logs,
+                             int batch,
+                             bool all_logs)
+      : FireAndForgetRequest(RequestType::ACTIVATE_SEQUENCERS),
+        logs_(std::move(logs)),
+        batch_(batch),
+        all_logs_(all_logs),
+        ref_holder_(this) {}
+
+  // see FireAndForgetRequest.h
+  void executionBody() override;
+
+ protected:
+  void onTimeout();
+
+  void setupTimer();
+
+  WorkerType getWorkerTypeAffinity() override;
+
+ private:
+  // Starts the activation of a sequencer for `log_id` if it isn't active.
+  void activate(logid_t log_id);
+
+  // Called when the sequencer locator found the node that should run the
+  // sequencer for `log_id`.
+  void onSequencerNodeFound(Status st, logid_t log_id, NodeID node_id);
+
+  // Removes the logs whose activation completed from in_flight_.
+  void pruneInFlight();
+
+  Timer timer_;
+  std::queue<logid_t> logs_;
+  // logs whose sequencer was in ACTIVATING state when last checked
+  std::vector<logid_t> in_flight_;
+  // number of outstanding SequencerLocator::locateSequencer() calls
+  size_t pending_locates_{0};
+  // wait time for timer is 20ms
+  std::chrono::milliseconds timer_wait_{20};
+  int batch_;
+  bool all_logs_;
+
+  size_t n_started_{0};
+  size_t n_skipped_{0};
+
+  WeakRefHolder<SequencerActivationRequest> ref_holder_;
+};
+
+}} // namespace facebook::logdevice
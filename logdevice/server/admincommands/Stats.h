@@ -11,6 +11,7 @@
 
 #include "logdevice/common/PriorityMap.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/stats/StatsSnapshotEncoder.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
 
@@ -230,6 +231,50 @@ class StatsWorker : public AdminCommand {
   }
 };
 
+// Binary, delta-encoded equivalent of `stats` for collectors polling many
+// nodes. See StatsSnapshotEncoder for the format. The output is
+// "BINARY <len>\r\n" followed by <len> bytes of encoded snapshot and
+// "\r\n". The cursor of the returned snapshot should be passed as --cursor
+// in the next call to only get stats that changed since then.
+class StatsBinary : public AdminCommand {
+ private:
+  bool include_log_groups_;
+  uint64_t cursor_ = 0;
+
+ public:
+  std::string getUsage() override {
+    return "stats binary [--cursor=<cursor>] [--include-log-groups]";
+  }
+
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    // clang-format off
+    out_options.add_options()
+      ("cursor", boost::program_options::value<uint64_t>(&cursor_))
+      ("include-log-groups",
+        boost::program_options::bool_switch(&include_log_groups_));
+    // clang-format on
+  }
+
+  void run() override {
+    if (!server_->getParameters()->getStats()) {
+      return;
+    }
+    // Stats names and recent snapshots are shared by all clients.
+    static StatsSnapshotEncoder without_log_groups(false);
+    static StatsSnapshotEncoder with_log_groups(true);
+    StatsSnapshotEncoder& encoder =
+        include_log_groups_ ? with_log_groups : without_log_groups;
+
+    std::string data;
+    encoder.encode(
+        server_->getParameters()->getStats()->aggregate(), cursor_, &data);
+    out_.printf("BINARY %zu\r\n", data.size());
+    out_.write(data.data(), data.size());
+    out_.printf("\r\n");
+  }
+};
+
 class StatsReset : public AdminCommand {
   void run() override {
     if (server_->getParameters()->getStats()) {
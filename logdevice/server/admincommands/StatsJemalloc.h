@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "logdevice/common/ThreadCachedAllocation.h"
 #include "logdevice/common/config.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 
@@ -38,6 +39,23 @@ inline void statsJemallocPrint(EvbufferTextOutput& out, const char* opt) {
   }
 }
 
+// Objects allocated through ThreadCachedAllocation mostly bypass jemalloc;
+// print how many allocations were served from the per-thread free lists
+// (hits) versus passed through to jemalloc (misses + overflows on free).
+inline void threadCachedAllocationPrint(EvbufferTextOutput& out) {
+  out.write("--- Thread-cached allocations\r\n");
+  forEachThreadCachedAllocation(
+      [&](const std::string& name, const ThreadCachedAllocationStats& st) {
+        out.printf("%s: cache_hits=%lu jemalloc_allocs=%lu "
+                   "jemalloc_frees_on_overflow=%lu cached=%lu\r\n",
+                   name.c_str(),
+                   st.cache_hits,
+                   st.cache_misses,
+                   st.cache_overflows,
+                   st.cached);
+      });
+}
+
 class StatsJemalloc : public AdminCommand {
  public:
   void run() override {
@@ -47,6 +65,7 @@ class StatsJemalloc : public AdminCommand {
      * 'b': omit per size class statistics for bins;
      * 'l': omit per size class statistics for large objects. */
     statsJemallocPrint(out_, "mabl");
+    threadCachedAllocationPrint(out_);
   }
 };
 
@@ -54,6 +73,7 @@ class StatsJemallocFull : public AdminCommand {
  public:
   void run() override {
     statsJemallocPrint(out_, nullptr);
+    threadCachedAllocationPrint(out_);
   }
 };
 
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <map>
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/PerfCounters.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Performance counters collected with --enable-perf-counters, per general
+ * worker and kind of work. Storage threads and other non-worker threads are
+ * reported with worker -1.
+ */
+class StatsPerf : public AdminCommand {
+ private:
+  bool json_ = false;
+
+  enum Kind {
+    MESSAGES = 0,
+    REQUESTS,
+    STORAGE_TASK_RESPONSES,
+    OTHER,
+    STORAGE_TASKS,
+    NUM_KINDS
+  };
+
+  static const char* kindName(int kind) {
+    static const char* names[NUM_KINDS] = {"messages",
+                                           "requests",
+                                           "storage_task_responses",
+                                           "other",
+                                           "storage_tasks"};
+    return names[kind];
+  }
+
+  static std::array<PerfCounterValues, NUM_KINDS> read(const Stats& s) {
+    std::array<PerfCounterValues, NUM_KINDS> res;
+#define READ_KIND(kind, name)                                          \
+  res[kind].cycles = s.perf_cycles_##name;                             \
+  res[kind].instructions = s.perf_instructions_##name;                 \
+  res[kind].llc_misses = s.perf_llc_misses_##name;                     \
+  res[kind].context_switches = s.perf_context_switches_##name;
+    READ_KIND(MESSAGES, messages)
+    READ_KIND(REQUESTS, requests)
+    READ_KIND(STORAGE_TASK_RESPONSES, storage_task_responses)
+    READ_KIND(OTHER, other)
+    READ_KIND(STORAGE_TASKS, storage_tasks)
+#undef READ_KIND
+    return res;
+  }
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()("json",
+                              boost::program_options::bool_switch(&json_));
+  }
+  std::string getUsage() override {
+    return "stats perf [--json]";
+  }
+
+  void run() override {
+    StatsHolder* stats = server_->getParameters()->getStats();
+    if (!stats) {
+      return;
+    }
+
+    std::map<int64_t, std::array<PerfCounterValues, NUM_KINDS>> per_worker;
+    stats->runForEach([&](Stats& s) {
+      const auto values = read(s);
+      auto& sum = per_worker[s.worker_id.val_ >= 0 ? s.worker_id.val_ : -1];
+      for (int kind = 0; kind < NUM_KINDS; ++kind) {
+        sum[kind] += values[kind];
+      }
+    });
+
+    StatsPerfTable table(!json_,
+                         "Worker",
+                         "Kind",
+                         "Cycles",
+                         "Instructions",
+                         "IPC",
+                         "LLC misses",
+                         "Context switches");
+    for (const auto& kv : per_worker) {
+      for (int kind = 0; kind < NUM_KINDS; ++kind) {
+        const PerfCounterValues& v = kv.second[kind];
+        if (v.cycles == 0 && v.instructions == 0 && v.llc_misses == 0 &&
+            v.context_switches == 0) {
+          continue;
+        }
+        table.next()
+            .set<0>(kv.first)
+            .set<1>(kindName(kind))
+            .set<2>(v.cycles)
+            .set<3>(v.instructions)
+            .set<5>(v.llc_misses)
+            .set<6>(v.context_switches);
+        if (v.cycles > 0) {
+          table.set<4>(static_cast<double>(v.instructions) / v.cycles);
+        }
+      }
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
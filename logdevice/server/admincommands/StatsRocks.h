@@ -12,6 +12,7 @@
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
+#include "logdevice/server/locallogstore/RocksDBCache.h"
 #include "logdevice/server/locallogstore/RocksDBLogStoreBase.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
@@ -89,6 +90,19 @@ class StatsRocks : public AdminCommand {
           "STAT %s.shard%i %" PRId64 "\r\n", ticker.second.c_str(), shard, val);
     }
 
+    auto& persistent_cache =
+        store->getRocksDBLogStoreConfig().table_options_.persistent_cache;
+    if (persistent_cache) {
+      for (const auto& tier_stats : persistent_cache->Stats()) {
+        for (const auto& stat : tier_stats) {
+          out_.printf("STAT rocksdb.persistent_cache.%s.shard%i %.0f\r\n",
+                      stat.first.c_str(),
+                      shard,
+                      stat.second);
+        }
+      }
+    }
+
     std::vector<PartitionedRocksDBStore::PartitionPtr> partitions;
 
     if (auto partitioned_store =
@@ -171,6 +185,32 @@ class StatsRocks : public AdminCommand {
                   key.c_str(),
                   cache->GetPinnedUsage());
     }
+    if (auto logdevice_cache = dynamic_cast<RocksDBCache*>(cache)) {
+      printCacheHitRatios(logdevice_cache, key);
+    }
+  }
+
+  void printCacheHitRatios(RocksDBCache* cache, const std::string& key) {
+    for (size_t i = 0; i < RocksDBCache::kNumReadClasses; ++i) {
+      auto principal = static_cast<StorageTaskPrincipal>(i);
+      const std::string name = principal == StorageTaskPrincipal::NUM_PRINCIPALS
+          ? "other"
+          : toString(principal);
+      const uint64_t hits = cache->getHits(principal);
+      const uint64_t misses = cache->getMisses(principal);
+      out_.printf("STAT rocksdb.%s.%s.hits %" PRIu64 "\r\n",
+                  key.c_str(),
+                  name.c_str(),
+                  hits);
+      out_.printf("STAT rocksdb.%s.%s.misses %" PRIu64 "\r\n",
+                  key.c_str(),
+                  name.c_str(),
+                  misses);
+      out_.printf("STAT rocksdb.%s.%s.hit_ratio %.3f\r\n",
+                  key.c_str(),
+                  name.c_str(),
+                  hits + misses > 0 ? double(hits) / (hits + misses) : 0.0);
+    }
   }
 };
 
@@ -8,6 +8,7 @@
 #include "logdevice/server/admincommands/StatsThroughput.h"
 
 #include <chrono>
+#include <unordered_set>
 #include <vector>
 
 #include "logdevice/common/commandline_util_chrono.h"
@@ -152,11 +153,18 @@ void StatsThroughput::run() {
     return;
   }
   if (stats) {
+    // For top N queries, only look at the log groups the per-thread sketches
+    // consider heavy instead of every log group.
+    folly::Optional<std::unordered_set<std::string>> candidates;
+    if (top_ > 0) {
+      candidates = getTopLogGroupCandidates(stats, time_series_, top_);
+    }
     AggregateMap agg = doAggregate(
         stats,
         time_series_,
         query_intervals_,
-        server_->getParameters()->getUpdateableConfig()->getLogsConfig());
+        server_->getParameters()->getUpdateableConfig()->getLogsConfig(),
+        candidates.get_pointer());
     if (top_ > 0) {
       reportTop(out_, agg, threshold_, top_);
     } else {
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "logdevice/server/admincommands/AdminCommand.h"
+#include "logdevice/server/admincommands/SequencerActivationRequest.h"
 #include "logdevice/server/admincommands/SequencerDeactivationRequest.h"
 
 namespace facebook { namespace logdevice { namespace commands {
@@ -221,4 +222,89 @@ class DeactivateSequencer : public AdminCommand {
   }
 };
 
+class ActivateSequencers : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  std::queue<logid_t> logs_;
+  int batch_{100};
+  bool all_{false};
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    // clang-format off
+    out_options.add_options()(
+    "logs",
+    boost::program_options::value<std::string>()->notifier(
+        [&](std::string val) {
+          if (lowerCase(val) == "all") {
+            all_ = true;
+            return;
+          }
+          std::vector<std::string> tokens;
+          folly::split(',', val, tokens);
+          for (const std::string& token : tokens) {
+            try {
+              logid_t log(folly::to<logid_t::raw_type>(token));
+              logs_.push(log);
+            } catch (std::range_error&) {
+              throw boost::program_options::error(
+                  "invalid value of --logs option: " + val);
+            }
+          }
+        }))(
+        "batch",
+        boost::program_options::value<int>(&batch_)
+            ->required());
+    // clang-format on
+  }
+  void getPositionalOptions(
+      boost::program_options::positional_options_description& out_options)
+      override {
+    out_options.add("logs", 1);
+    out_options.add("batch", 2);
+  }
+  std::string getUsage() override {
+    return "sequencer_start "
+           "<'all'|comma-separated list of logs> <batch>";
+  }
+
+  void run() override {
+    if (!server_->getParameters()->isSequencingEnabled()) {
+      out_.printf("This node does not run sequencers.\r\n");
+      return;
+    }
+    if (batch_ <= 0) {
+      out_.printf("Batch size must be positive, terminating this command\r\n");
+      return;
+    }
+    if (!all_ && logs_.empty()) {
+      out_.printf(
+          "There are no logs to activate, terminating this command\r\n");
+      return;
+    }
+
+    if (all_) {
+      out_.printf("Will activate sequencers for all logs this node is the "
+                  "sequencer node for, %d at a time\r\n",
+                  batch_);
+    } else {
+      out_.printf("Will activate sequencers for %d logs, %d at a time\r\n",
+                  (int)logs_.size(),
+                  batch_);
+    }
+
+    // Post a request to activate sequencers with bounded concurrency
+    std::unique_ptr<Request> req = std::make_unique<SequencerActivationRequest>(
+        std::move(logs_), batch_, all_);
+    if (server_->getServerProcessor()->postImportant(req) != 0) {
+      out_.printf("Failed to post SequencerActivationRequest, error: %s.\r\n",
+                  error_name(err));
+      ld_error("Failed to post SequencerActivationRequest, error: %s.",
+               error_name(err));
+    }
+  }
+};
+
 }}} // namespace facebook::logdevice::commands
@@ -169,6 +169,7 @@ int IteratorSearch::executeWithIndex(lsn_t* result_lo, lsn_t* result_hi) {
   rocksdb::ReadOptions ropt = RocksDBLogStoreBase::getReadOptionsSinglePrefix();
   ropt.read_tier =
       (allow_blocking_io_ ? rocksdb::kReadAllTier : rocksdb::kBlockCacheTier);
+  store_->setTableFilterForLog(ropt, log_id_);
   RocksDBIterator it = store_->newIterator(ropt, cf_);
 
   auto it_error = [&] {
@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 
+#include <folly/hash/Hash.h>
 #include <folly/hash/SpookyHashV2.h>
 
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
@@ -81,7 +82,7 @@ void LocalLogStore::broadcastFlushEvent(FlushToken flushedUpTo) {
 }
 
 bool LocalLogStoreReadFilter::operator()(logid_t,
-                                         lsn_t,
+                                         lsn_t lsn,
                                          const ShardID* const copyset_original,
                                          const copyset_size_t copyset_size,
                                          const csi_flags_t flags,
@@ -150,7 +151,7 @@ bool LocalLogStoreReadFilter::operator()(logid_t,
     copyset = copyset_original;
   } else {
     copyset_reordered.assign(copyset_original, copyset_original + copyset_size);
-    applyCopysetReordering(copyset_reordered.data(), copyset_size);
+    applyCopysetReordering(copyset_reordered.data(), copyset_size, lsn);
     copyset = copyset_reordered.data();
   }
 
@@ -249,7 +250,8 @@ bool LocalLogStoreReadFilter::operator()(logid_t,
 
 void LocalLogStoreReadFilter::applyCopysetReordering(
     ShardID* copyset,
-    copyset_size_t copyset_size) const {
+    copyset_size_t copyset_size,
+    lsn_t lsn) const {
   // NOTE: It is unsafe to change an algorithm when it is already deployed.
   // The correctness of SCD depends on servers' shuffling being in sync.  Add
   // a new version instead.
@@ -284,6 +286,20 @@ void LocalLogStoreReadFilter::applyCopysetReordering(
       copysetShuffle(copyset, copyset_size, csid_hash_pt1, csid_hash_pt2);
       break;
     }
+    case SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION: {
+      // Shuffle as in HASH_SHUFFLE_CLIENT_SEED, with a seed that is specific
+      // to the read stream. Then rotate the copyset by an offset derived from
+      // the block of LSNs the record is in, so that consecutive blocks with
+      // the same copyset are shipped by different storage nodes.
+      copysetShuffle(copyset, copyset_size, csid_hash_pt1, csid_hash_pt2);
+      if (copyset_size > 1) {
+        const uint64_t block = lsn / SCD_ROTATION_LSN_BLOCK_SIZE;
+        const size_t offset =
+            folly::hash::twang_mix64(block ^ csid_hash_pt2) % copyset_size;
+        std::rotate(copyset, copyset + offset, copyset + copyset_size);
+      }
+      break;
+    }
     case SCDCopysetReordering::NONE:
       // Asserting because we don't expect to get called but just returning in
       // release builds is fine
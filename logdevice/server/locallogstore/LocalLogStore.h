@@ -9,6 +9,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -395,6 +396,12 @@ class LocalLogStore : boost::noncopyable {
     // data it may be preferable to set this to false to suppress caching.
     bool fill_cache = true;
 
+    // If positive, the backing store reads this many bytes ahead of the
+    // cursor in one I/O, instead of one block at a time. Useful for long
+    // sequential scans of data that is unlikely to be in cache, e.g.
+    // catch-up reads and rebuilding. 0 leaves it up to the backing store.
+    size_t readahead_size = 0;
+
     // If true, attempts to use the copyset index for skipping records with
     // copysets that don't match the filter. NB: this can be overridden by
     // RocksDBSettings::use_copyset_index, see `shouldUseCSIIterator()` in
@@ -440,6 +447,12 @@ class LocalLogStore : boost::noncopyable {
     std::chrono::milliseconds max_execution_time{
         std::chrono::milliseconds::max()};
 
+    // If set, once the read has been running for preempt_after, it stops at
+    // the next record boundary if should_preempt() returns true, e.g. because
+    // more urgent tasks are waiting for the storage thread.
+    std::function<bool()> should_preempt;
+    std::chrono::milliseconds preempt_after{std::chrono::milliseconds::max()};
+
     // Max lsn to read. Not supported by AllLogsIterator.
     std::pair<logid_t, lsn_t> stop_reading_after{
         logid_t(std::numeric_limits<logid_t::raw_type>::max()),
@@ -470,7 +483,11 @@ class LocalLogStore : boost::noncopyable {
     bool softLimitReached() {
       return read_record_bytes + read_csi_bytes >= max_bytes_to_read ||
           (max_execution_time != std::chrono::milliseconds::max() &&
-           msec_since(read_start_time) >= max_execution_time.count());
+           msec_since(read_start_time) >= max_execution_time.count()) ||
+          (should_preempt &&
+           preempt_after != std::chrono::milliseconds::max() &&
+           msec_since(read_start_time) >= preempt_after.count() &&
+           should_preempt());
     }
 
     bool readLimitReached() {
@@ -614,6 +631,22 @@ class LocalLogStore : boost::noncopyable {
    */
   virtual void disableWriteStalling() {}
 
+  /**
+   * Called by storage threads before writing `bytes` bytes of records. If
+   * the store currently limits the rate of writes (--rocksdb-write-pacing),
+   * sleeps for as long as needed to keep writes within that rate.
+   */
+  virtual void paceWrite(size_t /*bytes*/) {}
+
+  /**
+   * @return  true if writes are being paced below the rate at which the store
+   *          can currently persist them, i.e. the store would like writers to
+   *          slow down.
+   */
+  virtual bool isPacingWrites() const {
+    return false;
+  }
+
   /**
    * Performs multiple writes in an atomic batch.  The operations may be
    * writes, deletes or both.
@@ -1136,7 +1169,9 @@ class LocalLogStoreReadFilter : public LocalLogStore::ReadFilter {
   SCDCopysetReordering scd_copyset_reordering_{SCDCopysetReordering::NONE};
   // Hashed session id (128 bits in total) of client initiating the read.
   // Used as the seed for scd copyset shuffling
-  // when SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED is the active mode
+  // when SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED or
+  // HASH_SHUFFLE_LSN_BLOCK_ROTATION is the active mode. For the latter, the
+  // client also hashed the read stream id into it.
   uint64_t csid_hash_pt1 = 0;
   uint64_t csid_hash_pt2 = 0;
   // If not null, this is the location of the client and local scd should be
@@ -1144,9 +1179,11 @@ class LocalLogStoreReadFilter : public LocalLogStore::ReadFilter {
   std::unique_ptr<NodeLocation> client_location_;
 
   // When `scd_copyset_reordering_' != NONE, reorder the copyset using the
-  // chosen algorithm.  Public for testing.
+  // chosen algorithm.  @param lsn is the LSN of the record, only used by
+  // HASH_SHUFFLE_LSN_BLOCK_ROTATION.  Public for testing.
   void applyCopysetReordering(ShardID* copyset,
-                              copyset_size_t copyset_size) const;
+                              copyset_size_t copyset_size,
+                              lsn_t lsn = LSN_INVALID) const;
 
   // Used for local scd filtering.
   void setUpdateableConfig(std::shared_ptr<UpdateableConfig> config);
@@ -1180,6 +1217,17 @@ class ShardedLocalLogStore {
    */
   virtual void setSequencerInitiatedSpaceBasedRetention(int /* shard_idx */) {}
 
+  /**
+   * Looks up the device that holds the given shard's data, e.g. to find the
+   * NUMA node it's attached to.
+   *
+   * @return 0 and sets *out to the st_dev of the shard's directory, or -1 if
+   *         the shard isn't backed by a local device.
+   */
+  virtual int getShardDevice(int /* shard_idx */, dev_t* /* out */) const {
+    return -1;
+  }
+
   virtual ~ShardedLocalLogStore() {}
 };
 
@@ -11,6 +11,7 @@
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/rebuilding/ChunkRebuilding.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
 namespace facebook { namespace logdevice {
@@ -51,7 +52,7 @@ void MemtableFlushedRequest::broadcast() {
 }
 
 void MemtableFlushedRequest::applyFlush() {
-  // send an update to all LogRebuilding state machines
+  // send an update to all LogRebuilding and ChunkRebuilding state machines
   // whose log maps to the shard on which memtable was flushed.
   ServerWorker* w = ServerWorker::onThisThread();
   for (const auto& lr : w->runningLogRebuildings().map) {
@@ -60,6 +61,23 @@ void MemtableFlushedRequest::applyFlush() {
           node_index_, server_instance_id_, flushToken_);
     }
   }
+
+  // ChunkRebuilding::onMemtableFlushed() may complete the chunk and remove it
+  // from the map, so collect the ids first.
+  auto& chunks = w->runningChunkRebuildings().map;
+  std::vector<log_rebuilding_id_t> chunk_ids;
+  for (const auto& cr : chunks) {
+    if (cr.second->getShard() == shard_idx_) {
+      chunk_ids.push_back(cr.first);
+    }
+  }
+  for (log_rebuilding_id_t id : chunk_ids) {
+    auto it = chunks.find(id);
+    if (it != chunks.end()) {
+      it->second->onMemtableFlushed(
+          node_index_, server_instance_id_, flushToken_);
+    }
+  }
 }
 
 NodeID MemtableFlushedRequest::getMyNodeID() const {
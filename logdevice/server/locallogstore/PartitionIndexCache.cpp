@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/PartitionIndexCache.h"
+
+#include <algorithm>
+
+#include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
+#include "logdevice/server/locallogstore/RocksDBLogStoreBase.h"
+
+namespace facebook { namespace logdevice {
+
+int PartitionIndexCache::LogIndex::load(const RocksDBLogStoreBase* store,
+                                        rocksdb::ColumnFamilyHandle* cf,
+                                        logid_t log_id,
+                                        char index_type,
+                                        size_t max_entries,
+                                        bool allow_blocking_io,
+                                        uint64_t generation,
+                                        std::shared_ptr<const LogIndex>* out) {
+  ld_check(out != nullptr);
+  *out = nullptr;
+
+  auto first_key =
+      RocksDBKeyFormat::IndexKey::create(log_id, index_type, std::string(), 0);
+
+  rocksdb::ReadOptions ropt = RocksDBLogStoreBase::getReadOptionsSinglePrefix();
+  ropt.read_tier =
+      (allow_blocking_io ? rocksdb::kReadAllTier : rocksdb::kBlockCacheTier);
+  // Not worth polluting the block cache with a one-off scan.
+  ropt.fill_cache = false;
+  RocksDBIterator it = store->newIterator(ropt, cf);
+
+  auto index = std::make_shared<LogIndex>();
+  index->generation_ = generation;
+
+  for (it.Seek(rocksdb::Slice(first_key.data(), first_key.size()));
+       it.status().ok() && it.Valid();
+       it.Next()) {
+    rocksdb::Slice key = it.key();
+    if (!RocksDBKeyFormat::IndexKey::valid(key.data(), key.size()) ||
+        RocksDBKeyFormat::IndexKey::getLogID(key.data()) != log_id ||
+        RocksDBKeyFormat::IndexKey::getIndexType(key.data()) != index_type) {
+      break;
+    }
+    if (index->size() >= max_entries) {
+      // Too big to be worth keeping in memory.
+      return 0;
+    }
+    index->data_.append(key.data(), key.size());
+    index->offsets_.push_back(index->data_.size());
+  }
+
+  rocksdb::Status status = it.status();
+  if (!status.ok()) {
+    err = status.IsIncomplete() ? E::WOULDBLOCK : E::FAILED;
+    return -1;
+  }
+
+  index->data_.shrink_to_fit();
+  index->offsets_.shrink_to_fit();
+  *out = std::move(index);
+  return 0;
+}
+
+void PartitionIndexCache::LogIndex::search(rocksdb::Slice target,
+                                           lsn_t* lo,
+                                           lsn_t* hi) const {
+  // First entry that is >= target, in the same bytewise order RocksDB uses.
+  size_t left = 0;
+  size_t right = size();
+  while (left < right) {
+    size_t mid = left + (right - left) / 2;
+    if (key(mid).compare(target) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+
+  if (left < size()) {
+    rocksdb::Slice k = key(left);
+    *hi = RocksDBKeyFormat::IndexKey::getLSN(k.data(), k.size());
+  }
+  if (left > 0) {
+    rocksdb::Slice k = key(left - 1);
+    *lo = RocksDBKeyFormat::IndexKey::getLSN(k.data(), k.size());
+  }
+}
+
+std::shared_ptr<const PartitionIndexCache::LogIndex>
+PartitionIndexCache::get(logid_t log_id,
+                         char index_type,
+                         uint64_t generation) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = indexes_.find(std::make_pair(log_id, index_type));
+  if (it == indexes_.end() || it->second->generation() != generation) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+void PartitionIndexCache::put(logid_t log_id,
+                              char index_type,
+                              std::shared_ptr<const LogIndex> index) {
+  ld_check(index != nullptr);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = indexes_[std::make_pair(log_id, index_type)];
+  if (slot == nullptr || slot->generation() <= index->generation()) {
+    slot = std::move(index);
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <rocksdb/slice.h>
+
+#include "logdevice/common/types_internal.h"
+
+namespace rocksdb {
+class ColumnFamilyHandle;
+}
+
+namespace facebook { namespace logdevice {
+
+class RocksDBLogStoreBase;
+
+/**
+ * @file In-memory copies of the findTime and findKey indexes (IndexKey
+ *       entries) of a single partition, one per (log, index type).
+ *
+ *       Replay tooling issues findTime/findKey for the same logs over and over
+ *       again, and each call normally seeks a RocksDB iterator inside a
+ *       partition, costing a few SST block reads. Partitions that no longer
+ *       receive appends hardly ever change, so the first search of a log in
+ *       such a partition copies all of the log's index entries into a compact
+ *       sorted array and later searches are binary searches in memory.
+ *
+ *       Every copy remembers RocksDBColumnFamily::write_generation_ at the
+ *       time it was built; any write into the partition bumps the generation
+ *       and makes the copies stale.
+ */
+
+class PartitionIndexCache {
+ public:
+  // Sorted IndexKeys of one log and one index type in a partition.
+  class LogIndex {
+   public:
+    /**
+     * Reads all index entries of the given log and index type from `cf`.
+     *
+     * @param out  Set to the loaded index, or to nullptr if the log has more
+     *             than `max_entries` entries in this partition.
+     * @return 0 on success, -1 on failure and err is set to:
+     *         - E::FAILED:     there was an error reading from the database.
+     *         - E::WOULDBLOCK: !allow_blocking_io and the entries are not in
+     *                          block cache.
+     */
+    static int load(const RocksDBLogStoreBase* store,
+                    rocksdb::ColumnFamilyHandle* cf,
+                    logid_t log_id,
+                    char index_type,
+                    size_t max_entries,
+                    bool allow_blocking_io,
+                    uint64_t generation,
+                    std::shared_ptr<const LogIndex>* out);
+
+    /**
+     * Equivalent of a RocksDB Seek() to `target` followed by a Prev(): sets
+     * *hi to the LSN of the first entry >= `target` and *lo to the LSN of the
+     * entry before it. Leaves *lo or *hi untouched if there's no such entry.
+     *
+     * @param target  An IndexKey, normally created with LSN 0.
+     */
+    void search(rocksdb::Slice target, lsn_t* lo, lsn_t* hi) const;
+
+    size_t size() const {
+      return offsets_.size() - 1;
+    }
+
+    uint64_t generation() const {
+      return generation_;
+    }
+
+   private:
+    rocksdb::Slice key(size_t i) const {
+      return rocksdb::Slice(
+          data_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+    // Concatenated keys; the i-th key spans [offsets_[i], offsets_[i + 1]).
+    std::string data_;
+    std::vector<uint32_t> offsets_{0};
+    uint64_t generation_{0};
+  };
+
+  /**
+   * @return the cached index of the given log and index type if it was built
+   *         at write generation `generation`, nullptr otherwise.
+   */
+  std::shared_ptr<const LogIndex>
+  get(logid_t log_id, char index_type, uint64_t generation) const;
+
+  void put(logid_t log_id, char index_type, std::shared_ptr<const LogIndex> i);
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::pair<logid_t, char>, std::shared_ptr<const LogIndex>> indexes_;
+};
+
+}} // namespace facebook::logdevice
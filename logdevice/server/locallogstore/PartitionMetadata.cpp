@@ -13,9 +13,12 @@
 
 namespace facebook { namespace logdevice {
 
-PartitionDirtyMetadata::PartitionDirtyMetadata(const DirtiedByMap& dbm,
-                                               bool under_replicated)
-    : under_replicated_(under_replicated) {
+PartitionDirtyMetadata::PartitionDirtyMetadata(
+    const DirtiedByMap& dbm,
+    bool under_replicated,
+    RecordTimestamp min_append_timestamp)
+    : under_replicated_(under_replicated),
+      min_append_timestamp_(min_append_timestamp) {
   for (const auto& kv : dbm) {
     if (kv.second.dirtyUntil() != FlushToken_INVALID) {
       node_index_t nidx;
@@ -38,6 +41,7 @@ Slice PartitionDirtyMetadata::serialize() const {
   h.flags = under_replicated_ ? Header::UNDER_REPLICATED : 0;
   h.dnc_array_offset = 0;
   h.dnc_array_len = 0;
+  h.min_append_timestamp = min_append_timestamp_.toMilliseconds().count();
   for (auto& dv : dirtied_by_) {
     if (!dv.empty()) {
       h.dnc_array_len += sizeof(DirtyNodesForClass);
@@ -84,17 +88,18 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
   for (auto& dv : dirtied_by_) {
     dv.clear();
   }
+  min_append_timestamp_ = RecordTimestamp::max();
 
   Header h;
   const uint8_t* data = static_cast<const uint8_t*>(blob.data);
-  if (blob.size < sizeof(h)) {
+  if (blob.size < LEGACY_HEADER_LEN) {
     ld_check(false);
     err = E::MALFORMED_RECORD;
     return -1;
   }
 
-  memcpy(&h, data, sizeof(h));
-  if (h.len < sizeof(h) || h.len > blob.size ||
+  memcpy(&h, data, LEGACY_HEADER_LEN);
+  if (h.len < LEGACY_HEADER_LEN || h.len > blob.size ||
       (h.dnc_array_len != 0 &&
        (h.dnc_array_offset < h.len || h.dnc_array_offset > blob.size))) {
     ld_check(false);
@@ -103,6 +108,11 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
   }
 
   under_replicated_ = (h.flags & Header::UNDER_REPLICATED) != 0;
+  if (h.len >= sizeof(h)) {
+    memcpy(&h, data, sizeof(h));
+    min_append_timestamp_ = RecordTimestamp::from(
+        std::chrono::milliseconds(h.min_append_timestamp));
+  }
 
   uint32_t dnc_offset = h.dnc_array_offset;
   uint32_t data_offset = dnc_offset + h.dnc_array_len;
@@ -164,6 +174,11 @@ std::string PartitionDirtyMetadata::toString() const {
     }
     dci++;
   }
+  if (min_append_timestamp_ != RecordTimestamp::max()) {
+    str += "{min_append_ts:";
+    str += format_time(min_append_timestamp_.toMilliseconds());
+    str += "}";
+  }
   str += ")";
   return str;
 }
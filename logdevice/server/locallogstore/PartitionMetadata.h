@@ -110,7 +110,10 @@ class PartitionDirtyMetadata : public PartitionMetadata {
   using DirtyNodeVectors = std::array<DirtyNodeVector, (size_t)DataClass::MAX>;
 
   explicit PartitionDirtyMetadata() {}
-  explicit PartitionDirtyMetadata(const DirtiedByMap&, bool under_replicated);
+  explicit PartitionDirtyMetadata(
+      const DirtiedByMap&,
+      bool under_replicated,
+      RecordTimestamp min_append_timestamp = RecordTimestamp::max());
 
   PartitionMetadataType getType() const override {
     return PartitionMetadataType::DIRTY;
@@ -133,6 +136,13 @@ class PartitionDirtyMetadata : public PartitionMetadata {
     return dirtied_by_;
   }
 
+  // Lower bound on the timestamps of the append records that may not have
+  // been flushed yet. RecordTimestamp::max() if unknown, e.g. if the
+  // metadata was written by an older version.
+  RecordTimestamp getMinAppendTimestamp() const {
+    return min_append_timestamp_;
+  }
+
  private:
   // Offsets are from the beginning of the metadata record.
   // Both offsets and lengths are in terms of bytes.
@@ -164,9 +174,14 @@ class PartitionDirtyMetadata : public PartitionMetadata {
     // Offset to DirtyNodeForClass elements
     uint32_t dnc_array_offset;
     uint32_t dnc_array_len;
+    uint32_t pad2 = 0;
+    // See getMinAppendTimestamp(). Absent in records written by older
+    // versions, which had a 12-byte header.
+    int64_t min_append_timestamp;
   };
-  static_assert(sizeof(Header) == 12,
+  static_assert(sizeof(Header) == 24,
                 "PartitionDirtyMetadata::Header is not packed.");
+  static constexpr size_t LEGACY_HEADER_LEN = 12;
 
   DirtyNodeVectors dirtied_by_;
 
@@ -174,6 +189,8 @@ class PartitionDirtyMetadata : public PartitionMetadata {
   // rebuilding.
   bool under_replicated_ = false;
 
+  RecordTimestamp min_append_timestamp_ = RecordTimestamp::max();
+
   mutable std::vector<uint8_t> serialize_buffer_;
 };
 
@@ -12,8 +12,10 @@
 #include <cstdlib>
 #include <iterator>
 #include <list>
+#include <map>
 
 #include <folly/Conv.h>
+#include <folly/Format.h>
 #include <folly/Likely.h>
 #include <folly/Optional.h>
 #include <folly/hash/Hash.h>
@@ -413,14 +415,32 @@ void PartitionedRocksDBStore::init(const Configuration* config) {
 
   ld_spew("Found %zd column families", column_families.size());
 
-  if (!open(column_families, meta_cf_options, config) || !readDirectories()) {
+  // Time spent in each phase of opening the shard, for figuring out what
+  // makes restarts slow.
+  SteadyTimestamp phase_start = SteadyTimestamp::now();
+  auto end_phase = [&]() {
+    SteadyTimestamp now = SteadyTimestamp::now();
+    int64_t ms = (now - phase_start).toMilliseconds().count();
+    phase_start = now;
+    return ms;
+  };
+
+  if (!open(column_families, meta_cf_options, config)) {
+    throw ConstructorFailed();
+  }
+  const int64_t open_ms = end_phase();
+  if (!readDirectories()) {
     throw ConstructorFailed();
   }
+  const int64_t read_directories_ms = end_phase();
+  PER_SHARD_STAT_ADD(
+      stats_, startup_read_directories_ms, shard_idx_, read_directories_ms);
   if (!getSettings()->read_only) {
     if (!finishInterruptedDrops() || !convertDataKeyFormat()) {
       throw ConstructorFailed();
     }
   }
+  const int64_t finish_drops_ms = end_phase();
 
   if (!getSettings()->read_only) {
     startBackgroundThreads();
@@ -434,6 +454,21 @@ void PartitionedRocksDBStore::init(const Configuration* config) {
     // slate and is ready to accept writes.
     flushAllMemtables(/*wait*/ true);
   }
+  const int64_t flush_ms = end_phase();
+  PER_SHARD_STAT_ADD(stats_, startup_flush_ms, shard_idx_, flush_ms);
+
+  ld_info("Opened shard %u with %lu partitions and %lu logs. Time spent: "
+          "open and read partition metadata: %ldms (of which rocksdb open: "
+          "%ldms), read directories: %ldms, finish interrupted drops: %ldms, "
+          "flush: %ldms",
+          shard_idx_,
+          partitions_.size(),
+          logs_.size(),
+          open_ms,
+          startup_rocksdb_open_ms_,
+          read_directories_ms,
+          finish_drops_ms,
+          flush_ms);
 }
 
 PartitionedRocksDBStore::~PartitionedRocksDBStore() {
@@ -614,6 +649,7 @@ bool PartitionedRocksDBStore::open(
 
   rocksdb::Status status;
   bool read_only = getSettings()->read_only;
+  SteadyTimestamp open_start = SteadyTimestamp::now();
   if (read_only) {
     status = rocksdb::DB::OpenForReadOnly(rocksdb_config_.options_,
                                           db_path_,
@@ -628,6 +664,11 @@ bool PartitionedRocksDBStore::open(
                                &db);
   }
 
+  startup_rocksdb_open_ms_ =
+      (SteadyTimestamp::now() - open_start).toMilliseconds().count();
+  PER_SHARD_STAT_ADD(
+      stats_, startup_rocksdb_open_ms, shard_idx_, startup_rocksdb_open_ms_);
+
   if (!status.ok()) {
     ld_error("Couldn't open the partitioned db \"%s\"%s: %s",
              read_only ? " (read only)" : "",
@@ -735,17 +776,28 @@ bool PartitionedRocksDBStore::open(
 
   // Read per-partition metadata. We'll need it below to decide if we need
   // to create more partitions.
-  rocksdb::WriteBatch partition_updates;
+  SteadyTimestamp read_metadata_start = SteadyTimestamp::now();
+  std::vector<PartitionPtr> partitions_to_read;
   for (partition_id_t id = oldest_partition_id; id <= latest_partition_id;
        ++id) {
     PartitionPtr partition = partitions_.get(id);
-    if (!partition) {
-      // Can have gaps in partition numbering because of interrupted drops.
-      continue;
+    // Can have gaps in partition numbering because of interrupted drops.
+    if (partition) {
+      partitions_to_read.push_back(partition);
     }
+  }
+  std::vector<std::pair<bool, E>> timestamps_read =
+      readPartitionTimestampsInParallel(partitions_to_read);
 
-    if (!readPartitionTimestamps(partition)) {
-      if (id != latest_partition_id || err != E::NOTFOUND) {
+  rocksdb::WriteBatch partition_updates;
+  for (size_t idx = 0; idx < partitions_to_read.size(); ++idx) {
+    PartitionPtr partition = partitions_to_read[idx];
+    const partition_id_t id = partition->id_;
+
+    if (!timestamps_read[idx].first) {
+      if (id != latest_partition_id ||
+          timestamps_read[idx].second != E::NOTFOUND) {
+        err = timestamps_read[idx].second;
         return false;
       } else {
         // We were probably adding a new latest partition, had created the CF,
@@ -796,6 +848,19 @@ bool PartitionedRocksDBStore::open(
         setUnderReplicated(partition);
         auto dti =
             partition->dirtyTimeInterval(*getSettings(), latest_partition_id);
+        // Records that were flushed before the partition last became dirty
+        // for appends aren't lost. Narrow the range to the timestamps of the
+        // appends that may have been in memtables.
+        RecordTimestamp min_append_ts =
+            partition->dirty_state_.min_append_timestamp;
+        if (min_append_ts != RecordTimestamp::max()) {
+          RecordTimestamp lower = min_append_ts -
+              std::min(min_append_ts.time_since_epoch(),
+                       getSettings()->partition_timestamp_granularity_);
+          if (lower > dti.lower()) {
+            dti = RecordTimeInterval(std::min(lower, dti.upper()), dti.upper());
+          }
+        }
         ld_info("Partition s%u:%lu found dirty: %s",
                 shard_idx_,
                 partition->id_,
@@ -844,6 +909,7 @@ bool PartitionedRocksDBStore::open(
     // instance of LogDevice. Now that the ranges are accounted for in
     // range_meta, allow the partition to be cleaned by the cleaner.
     partition->dirty_state_.dirtied_by_nodes.clear();
+    partition->dirty_state_.min_append_timestamp = RecordTimestamp::max();
 
     if (partition->isUnderReplicated()) {
       ld_info("Partition s%u:%lu is under-replicated: "
@@ -856,6 +922,12 @@ bool PartitionedRocksDBStore::open(
     }
   }
 
+  PER_SHARD_STAT_ADD(
+      stats_,
+      startup_read_partition_metadata_ms,
+      shard_idx_,
+      (SteadyTimestamp::now() - read_metadata_start).toMilliseconds().count());
+
   ld_info("Shard[%u] dirty ranges: %s",
           shard_idx_,
           logdevice::toString(range_meta).c_str());
@@ -1291,6 +1363,45 @@ bool PartitionedRocksDBStore::prependPartitionsIfNeeded(
   return !created.empty();
 }
 
+std::shared_ptr<const PartitionIndexCache::LogIndex>
+PartitionedRocksDBStore::getPartitionIndex(const PartitionPtr& partition,
+                                           logid_t log_id,
+                                           char index_type,
+                                           bool allow_blocking_io) const {
+  const size_t max_entries =
+      getSettings()->partition_index_cache_max_entries;
+  if (max_entries == 0 || partition->id_ >= latest_.get()->id_) {
+    // Disabled, or the partition is still receiving appends and any copy
+    // would be made stale right away.
+    return nullptr;
+  }
+
+  const uint64_t generation = partition->cf_->write_generation_.load();
+  auto index = partition->index_cache_.get(log_id, index_type, generation);
+  if (index != nullptr) {
+    STAT_INCR(stats_, logsdb_partition_index_cache_hits);
+    return index;
+  }
+  if (!allow_blocking_io) {
+    return nullptr;
+  }
+
+  int rv = PartitionIndexCache::LogIndex::load(this,
+                                               partition->cf_->get(),
+                                               log_id,
+                                               index_type,
+                                               max_entries,
+                                               allow_blocking_io,
+                                               generation,
+                                               &index);
+  if (rv != 0 || index == nullptr) {
+    return nullptr;
+  }
+  STAT_INCR(stats_, logsdb_partition_index_cache_builds);
+  partition->index_cache_.put(log_id, index_type, index);
+  return index;
+}
+
 int PartitionedRocksDBStore::seekToLastInDirectory(
     RocksDBIterator* it,
     logid_t log_id,
@@ -1607,7 +1718,9 @@ bool PartitionedRocksDBStore::readDirectories() {
     if (directory_entry.fromIterator(&it, current_log_id) != 0) {
       return false;
     }
-    log_state->directory.emplace(directory_entry.first_lsn, directory_entry);
+    log_state->directory.insert(
+        std::make_pair(directory_entry.first_lsn, directory_entry));
+    log_state->approximate_size_bytes += directory_entry.approximate_size_bytes;
 
     // Update latest_partition
     latest_partition = directory_entry.id;
@@ -1673,6 +1786,36 @@ bool PartitionedRocksDBStore::readPartitionTimestamps(PartitionPtr partition) {
   return true;
 }
 
+std::vector<std::pair<bool, E>>
+PartitionedRocksDBStore::readPartitionTimestampsInParallel(
+    const std::vector<PartitionPtr>& partitions) {
+  std::vector<std::pair<bool, E>> res(partitions.size());
+  // Each thread reads every num_threads-th partition.
+  auto read = [&](size_t first, size_t step) {
+    for (size_t i = first; i < partitions.size(); i += step) {
+      res[i].first = readPartitionTimestamps(partitions[i]);
+      res[i].second = res[i].first ? E::OK : err;
+    }
+  };
+
+  size_t num_threads =
+      std::min(std::max(getSettings()->partition_metadata_read_threads, 1ul),
+               std::max(partitions.size(), 1ul));
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      ThreadID::set(
+          ThreadID::UTILITY, folly::sformat("ld:open-meta{}", shard_idx_));
+      read(t, num_threads);
+    });
+  }
+  read(0, num_threads);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return res;
+}
+
 bool PartitionedRocksDBStore::readPartitionDirtyState(PartitionPtr partition) {
   ld_check(partition->dirty_state_.dirtied_by_nodes.empty());
 
@@ -1702,6 +1845,7 @@ bool PartitionedRocksDBStore::readPartitionDirtyState(PartitionPtr partition) {
     }
     dci++;
   };
+  partition->dirty_state_.min_append_timestamp = meta.getMinAppendTimestamp();
   return true;
 }
 
@@ -1830,7 +1974,7 @@ PartitionedRocksDBStore::getWritePartition(
   DirectoryEntry* current_partition = nullptr;
 
   // Iterators to lower and upper bound of allowed target partition, if found
-  std::map<partition_id_t, DirectoryEntry>::iterator current_it, next_it;
+  LogDirectory::iterator current_it, next_it;
 
   // Find first partition with first_lsn > lsn (next); then previous, if any,
   // is last partition with first_lsn <= lsn (current)
@@ -1894,6 +2038,7 @@ PartitionedRocksDBStore::getWritePartition(
 
     // Update data size
     current_partition->approximate_size_bytes += payload_size_bytes;
+    log_state->approximate_size_bytes += payload_size_bytes;
 
     // Unset PSEUDORECORDS_ONLY flag if we're writing the first real record to
     // the given partition for this log.
@@ -1938,6 +2083,7 @@ PartitionedRocksDBStore::getWritePartition(
     new_next_partition.first_lsn = lsn;
     // Update data size
     new_next_partition.approximate_size_bytes += payload_size_bytes;
+    log_state->approximate_size_bytes += payload_size_bytes;
     new_next_partition.doPut(
         log_id, Durability::ASYNC_WRITE, metadata_cf_->get(), durable_batch);
     STAT_INCR(stats_, logsdb_writes_dir_key_decrease);
@@ -1945,7 +2091,8 @@ PartitionedRocksDBStore::getWritePartition(
     // Apply same as above in in-memory directory metadata
     auto hint_it = log_directory.erase(next_it);
     current_partition =
-        &log_directory.emplace_hint(hint_it, lsn, new_next_partition)->second;
+        &log_directory.insert(hint_it, std::make_pair(lsn, new_next_partition))
+             ->second;
     if (current_partition->id == max_used_partition) {
       // New first lsn of latest partition, update LogState
       log_state->latest_partition.store(
@@ -1972,10 +2119,12 @@ PartitionedRocksDBStore::getWritePartition(
     };
     new_partition.doPut(log_id, durability, metadata_cf_->get(), rocksdb_batch);
     STAT_INCR(stats_, logsdb_writes_dir_key_add);
+    log_state->approximate_size_bytes += payload_size_bytes;
 
     // Add to in-memory directory metadata
     current_partition =
-        &log_directory.emplace_hint(next_it, lsn, new_partition)->second;
+        &log_directory.insert(next_it, std::make_pair(lsn, new_partition))
+             ->second;
     if (target_partition > max_used_partition) {
       // New latest partition, update LogState
       log_state->latest_partition.store(target_partition, lsn, lsn);
@@ -2271,6 +2420,18 @@ int PartitionedRocksDBStore::dataSize(logid_t log_id,
   }
   auto partitions = getPartitionList();
 
+  if (hi_timestamp == now) {
+    PartitionPtr first_partition =
+        partitions->get(log_directory.cbegin()->second.id);
+    ld_check(first_partition != nullptr);
+    if (lo_timestamp <= first_partition->starting_timestamp) {
+      // The range covers every partition that has data for this log, e.g.
+      // when asking for the size of the whole log.
+      *out = log_state->approximate_size_bytes;
+      return 0;
+    }
+  }
+
   // Find the directory entry for the first partition which spans any
   // timestamps >= lo_timestamp -- that's our starting point.
   // Use lower_bound to binary search on LSN.
@@ -2782,8 +2943,13 @@ int PartitionedRocksDBStore::writeMultiImpl(
 
   // If a log has dir_updates_pending[log] > dir_updates_flushed, the log may
   // have some directory updates in rocksdb_batch. We need to flush these
-  // updates before calling getWritePartition() again for this log.
+  // updates before calling getWritePartition() again for this log, unless
+  // both the pending updates and the new ones go to wal_batch: updates of the
+  // same WriteBatch are applied in order, so they can be coalesced into one
+  // write. mem_dir_updates_pending[log] > dir_updates_flushed if some of the
+  // pending updates of the log may be in mem_batch.
   FixedKeysMap<logid_t, int> dir_updates_pending(log_locks.keys());
+  FixedKeysMap<logid_t, int> mem_dir_updates_pending(log_locks.keys());
   int dir_updates_flushed = 0;
 
   bool unpartitioned_dirtied = false;
@@ -2891,7 +3057,12 @@ int PartitionedRocksDBStore::writeMultiImpl(
         }
 
         if (dir_updates_pending[op->log_id] > dir_updates_flushed) {
-          if (!flush_dir_updates()) {
+          if (op->durability() > Durability::MEMORY &&
+              mem_dir_updates_pending[op->log_id] <= dir_updates_flushed) {
+            // All directory updates of this log, pending and new, are in
+            // wal_batch.
+            STAT_INCR(stats_, logsdb_directory_updates_coalesced);
+          } else if (!flush_dir_updates()) {
             return -1;
           }
         }
@@ -3021,6 +3192,9 @@ int PartitionedRocksDBStore::writeMultiImpl(
         // Pessimistically assume getWritePartition() always updates directory.
         // It indeed does when the writes arrive in order of increasing LSN.
         dir_updates_pending[op->log_id] = dir_updates_flushed + 1;
+        if (op->durability() <= Durability::MEMORY) {
+          mem_dir_updates_pending[op->log_id] = dir_updates_flushed + 1;
+        }
 
         cf_ptr = partition->cf_;
 
@@ -3202,6 +3376,17 @@ int PartitionedRocksDBStore::writeMultiImpl(
       auto& dirty_state = cur_partition->dirty_state_;
       dirty_state.noteDirtied(flush_token, now);
 
+      // Lowest timestamp among the appends of this node to this partition.
+      RecordTimestamp min_append_ts = RecordTimestamp::max();
+      if (op->data_class == DataClass::APPEND) {
+        for (auto it = op; it != dirty_ops.end() && op->canMergeWith(*it);
+             ++it) {
+          min_append_ts = std::min(min_append_ts, it->timestamp);
+        }
+      }
+      bool lower_min_append_ts =
+          min_append_ts < dirty_state.min_append_timestamp;
+
       // To simplify some logic, use the result type from emplace() to
       // track lookup/update/emplace operations on the node dirty data.
       DirtiedByKey key(op->node_idx, op->data_class);
@@ -3211,7 +3396,7 @@ int PartitionedRocksDBStore::writeMultiImpl(
       ndd_kv = dirty_state.dirtied_by_nodes.find(key);
       emplaced = false;
 
-      if (ndd_kv == dirty_state.dirtied_by_nodes.end()) {
+      if (ndd_kv == dirty_state.dirtied_by_nodes.end() || lower_min_append_ts) {
         bool clean_partition;
         if (dirtied_partitions.empty() ||
             cur_partition->id_ != dirtied_partitions.back().first->id_) {
@@ -3236,7 +3421,11 @@ int PartitionedRocksDBStore::writeMultiImpl(
               std::piecewise_construct,
               std::forward_as_tuple(op->node_idx, op->data_class),
               std::forward_as_tuple());
-          if (!emplaced) {
+          // Another thread may have lowered the bound while we were
+          // upgrading the lock.
+          lower_min_append_ts =
+              min_append_ts < dirty_state.min_append_timestamp;
+          if (!emplaced && !lower_min_append_ts) {
             // Another thread has created the node. Proceed in shared mode.
             ld_spew("Partition s%u:%ld lost race to mark N%d dirty",
                     getShardIdx(),
@@ -3246,11 +3435,13 @@ int PartitionedRocksDBStore::writeMultiImpl(
           } else {
             dirtied_partitions.emplace_back(
                 op->partition, std::move(partition_lock));
-            ld_spew("Partition s%u:%ld marked N%d:%s dirty",
-                    getShardIdx(),
-                    op->partition->id_,
-                    op->node_idx,
-                    toString(op->data_class).c_str());
+            if (emplaced) {
+              ld_spew("Partition s%u:%ld marked N%d:%s dirty",
+                      getShardIdx(),
+                      op->partition->id_,
+                      op->node_idx,
+                      toString(op->data_class).c_str());
+            }
           }
         } else {
           // A previous iteration of this loop locked and dirtied this
@@ -3262,7 +3453,7 @@ int PartitionedRocksDBStore::writeMultiImpl(
               std::piecewise_construct,
               std::forward_as_tuple(op->node_idx, op->data_class),
               std::forward_as_tuple());
-          ld_check(emplaced);
+          ld_check(emplaced || lower_min_append_ts);
         }
         if (clean_partition) {
           ld_spew("Partition s%u:%ld first marked dirty by N%d",
@@ -3276,6 +3467,14 @@ int PartitionedRocksDBStore::writeMultiImpl(
       op->newly_dirtied = ndd_kv->second.markDirtyUntil(flush_token);
       ld_check_eq(op->newly_dirtied, emplaced);
 
+      if (lower_min_append_ts) {
+        // Partition is locked in write mode and will have its
+        // PartitionDirtyMetadata rewritten below.
+        ld_check(!dirtied_partitions.empty() &&
+                 dirtied_partitions.back().first->id_ == cur_partition->id_);
+        dirty_state.min_append_timestamp.storeMin(min_append_ts);
+      }
+
       // If the write op has to wait for updated PartitionDirtyMetadata
       // to sync out, the caller must treat it as a synchronous write
       // and wait for a WAL sync to make our metadata durable.
@@ -3284,10 +3483,15 @@ int PartitionedRocksDBStore::writeMultiImpl(
       switch (op->data_class) {
         case DataClass::APPEND:
           // Any node that is dirty for appends is enough to ensure
-          // that we rebuild all append data for the partition.
+          // that we rebuild all append data for the partition, as long as
+          // the timestamp is above the persisted min_append_timestamp.
           min_sync_token = dirty_state.append_dirtied_wal_token.load();
-          if (min_sync_token == FlushToken_MAX) {
+          if (min_sync_token == FlushToken_MAX || lower_min_append_ts) {
             // Unconditional sync and wait.
+            if (lower_min_append_ts && !op->newly_dirtied) {
+              STAT_INCR(stats_,
+                        partition_sync_write_promotion_for_min_append_ts);
+            }
             min_sync_token = FlushToken_INVALID;
             min_durability = Durability::SYNC_WRITE;
           } else if (min_sync_token > walSyncedUpThrough()) {
@@ -3790,6 +3994,7 @@ void PartitionedRocksDBStore::updatePartitionDirtyState(
     if (update_partition_dirty_state) {
       if (!append_dirtied) {
         dirty_state.append_dirtied_wal_token = FlushToken_MAX;
+        dirty_state.min_append_timestamp = RecordTimestamp::max();
       }
 
       // We don't batch to minimize partition lock hold time.
@@ -4183,6 +4388,225 @@ void PartitionedRocksDBStore::getPartitionsForProactiveCompaction(
   }
 }
 
+void PartitionedRocksDBStore::prioritizePartialCompactions(
+    std::vector<PartitionToCompact>* ps) {
+  ld_check(ps);
+  const partition_id_t latest = latest_.get()->id_;
+  const std::chrono::milliseconds hot_period =
+      getSettings()->partition_hot_read_period_;
+  const SteadyTimestamp now = currentSteadyTime();
+  auto priority = [&](const PartitionToCompact& p) {
+    if (p.partition->id_ + 1 >= latest) {
+      return 0;
+    }
+    SteadyTimestamp last_read = p.partition->last_read_time;
+    if (hot_period.count() > 0 && last_read != SteadyTimestamp::min() &&
+        now - last_read <= hot_period) {
+      return 1;
+    }
+    return 2;
+  };
+  std::stable_sort(
+      ps->begin(),
+      ps->end(),
+      [&](const PartitionToCompact& a, const PartitionToCompact& b) {
+        return priority(a) < priority(b);
+      });
+}
+
+bool PartitionedRocksDBStore::isColdPartition(const PartitionPtr& partition) {
+  return isPartitionOlderThan(
+      partition, getSettings()->partition_cold_compression_age_);
+}
+
+bool PartitionedRocksDBStore::isPartitionOlderThan(
+    const PartitionPtr& partition,
+    std::chrono::hours age) {
+  if (age.count() == 0 || partition->id_ + 1 >= latest_.get()->id_) {
+    return false;
+  }
+  RecordTimestamp max_timestamp = partition->max_timestamp;
+  if (max_timestamp == RecordTimestamp::min()) {
+    // Empty partition.
+    max_timestamp = partition->starting_timestamp;
+  }
+  return currentTime() - max_timestamp >= age;
+}
+
+namespace {
+// Same names as rocksdb puts in TableProperties::compression_name.
+const char* compressionName(rocksdb::CompressionType type) {
+  switch (type) {
+    case rocksdb::kNoCompression:
+      return "NoCompression";
+    case rocksdb::kSnappyCompression:
+      return "Snappy";
+    case rocksdb::kZlibCompression:
+      return "Zlib";
+    case rocksdb::kBZip2Compression:
+      return "BZip2";
+    case rocksdb::kLZ4Compression:
+      return "LZ4";
+    case rocksdb::kLZ4HCCompression:
+      return "LZ4HC";
+    case rocksdb::kXpressCompression:
+      return "Xpress";
+    case rocksdb::kZSTD:
+      return "ZSTD";
+    default:
+      return "";
+  }
+}
+} // namespace
+
+void PartitionedRocksDBStore::getPartitionsForColdCompression(
+    std::vector<PartitionToCompact>* out_to_compact) {
+  ld_check(out_to_compact);
+  if (getSettings()->partition_cold_compression_age_.count() == 0) {
+    return;
+  }
+  const std::string cold_name =
+      compressionName(getSettings()->partition_cold_compression_);
+
+  auto partitions = getPartitionList();
+  for (PartitionPtr partition : *partitions) {
+    if (!isColdPartition(partition)) {
+      // Partitions are ordered by time, so the rest are even newer.
+      break;
+    }
+    if (partition->cold_compressed.load()) {
+      continue;
+    }
+
+    rocksdb::TablePropertiesCollection props;
+    rocksdb::Status status =
+        db_->GetPropertiesOfAllTables(partition->cf_->get(), &props);
+    if (!status.ok()) {
+      ld_warning("Failed to get properties of sst files in partition %lu: %s",
+                 partition->id_,
+                 status.ToString().c_str());
+      enterFailSafeIfFailed(status, "GetPropertiesOfAllTables()");
+      return;
+    }
+    bool all_cold = true;
+    for (const auto& it : props) {
+      if (it.second->compression_name != cold_name) {
+        all_cold = false;
+        break;
+      }
+    }
+    if (all_cold) {
+      // Already rewritten before a restart, or by some other full
+      // compaction. Just make sure new files are written with the cold
+      // codec too.
+      if (applyColdCompressionOptions(partition)) {
+        partition->cold_compressed.store(true);
+      }
+      continue;
+    }
+
+    // One at a time: recompressing a partition is as expensive as any other
+    // full compaction.
+    out_to_compact->emplace_back(partition, PartitionToCompact::Reason::COLD);
+    break;
+  }
+}
+
+bool PartitionedRocksDBStore::applyColdCompressionOptions(
+    const PartitionPtr& partition) {
+  auto settings = getSettings();
+  std::string type_str;
+  rocksdb::Status status = rocksdb::GetStringFromCompressionType(
+      &type_str, settings->partition_cold_compression_);
+  if (status.ok()) {
+    std::unordered_map<std::string, std::string> opts{
+        {"compression", type_str}};
+    if (settings->partition_cold_compression_level_ != 0) {
+      // window_bits:level:strategy
+      opts["compression_opts"] = "-14:" +
+          std::to_string(settings->partition_cold_compression_level_) + ":0";
+    }
+    status = db_->SetOptions(partition->cf_->get(), opts);
+  }
+  if (!status.ok()) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    2,
+                    "Failed to switch partition %lu to cold compression: %s",
+                    partition->id_,
+                    status.ToString().c_str());
+    return false;
+  }
+  return true;
+}
+
+bool PartitionedRocksDBStore::offloadOldPartitions(SystemTimestamp deadline) {
+  auto settings = getSettings();
+  auto env = dynamic_cast<RocksDBEnv*>(rocksdb_config_.options_.env);
+  if (settings->partition_offload_path_.empty() ||
+      settings->partition_offload_age_.count() == 0 || env == nullptr) {
+    return false;
+  }
+
+  auto partitions = getPartitionList();
+  for (PartitionPtr partition : *partitions) {
+    if (!isPartitionOlderThan(partition, settings->partition_offload_age_)) {
+      break;
+    }
+    if (partition->offloaded.load()) {
+      continue;
+    }
+    if (isColdPartition(partition) && !partition->cold_compressed.load()) {
+      // Let the cold recompression rewrite it locally first, instead of
+      // reading it back from the offload path.
+      continue;
+    }
+
+    rocksdb::ColumnFamilyMetaData cf_meta;
+    db_->GetColumnFamilyMetaData(partition->cf_->get(), &cf_meta);
+    bool all_offloaded = true;
+    for (const auto& level : cf_meta.levels) {
+      for (const auto& f : level.files) {
+        if (currentTime() >= deadline || shutdown_event_.signaled()) {
+          return true;
+        }
+        // SstFileMetaData::name starts with a '/'.
+        const std::string path = f.db_path + f.name;
+        if (env->isOffloaded(path)) {
+          continue;
+        }
+        uint64_t bytes = 0;
+        rocksdb::Status status = env->offloadFile(path, &bytes);
+        if (status.IsNotFound()) {
+          // Compacted away meanwhile.
+          all_offloaded = false;
+          continue;
+        }
+        if (!status.ok()) {
+          RATELIMIT_ERROR(std::chrono::seconds(10),
+                          2,
+                          "Failed to offload file %s of partition %lu to "
+                          "%s: %s",
+                          path.c_str(),
+                          partition->id_,
+                          settings->partition_offload_path_.c_str(),
+                          status.ToString().c_str());
+          return false;
+        }
+        STAT_INCR(stats_, partition_offloaded_files);
+        STAT_ADD(stats_, partition_offloaded_bytes, bytes);
+      }
+    }
+    if (all_offloaded) {
+      ld_info("Offloaded partition %lu of shard %u to %s",
+              partition->id_,
+              shard_idx_,
+              settings->partition_offload_path_.c_str());
+      partition->offloaded.store(true);
+    }
+  }
+  return false;
+}
+
 bool PartitionedRocksDBStore::getPartitionsForManualCompaction(
     std::vector<PartitionToCompact>* out_to_compact,
     size_t count,
@@ -4734,6 +5158,7 @@ void PartitionedRocksDBStore::performCompactionInternal(
     CompactionContext context;
     context.reason = to_compact.reason;
     rocksdb::Status status;
+    bool recompressed = false;
 
     {
       // This will wait for other compactions to finish.
@@ -4745,13 +5170,19 @@ void PartitionedRocksDBStore::performCompactionInternal(
 
       if (to_compact.reason == PartitionToCompact::Reason::PARTIAL) {
         rocksdb::CompactionOptions options;
-        options.compression = rocksdb_config_.options_.compression;
+        options.compression = partition->cold_compressed.load()
+            ? getSettings()->partition_cold_compression_
+            : rocksdb_config_.options_.compression;
 
         status = db_->CompactFiles(options,
                                    partition->cf_->get(),
                                    to_compact.partial_compaction_filenames,
                                    0 /* L0 */);
       } else {
+        // A full compaction of an old partition rewrites all of it anyway, so
+        // it might as well use the cold codec.
+        recompressed = isColdPartition(partition) &&
+            applyColdCompressionOptions(partition);
         status = db_->CompactRange(rocksdb::CompactRangeOptions(),
                                    partition->cf_->get(),
                                    nullptr,
@@ -4763,6 +5194,12 @@ void PartitionedRocksDBStore::performCompactionInternal(
       enterFailSafeIfFailed(status, "CompactRange()/CompactFiles()");
       return;
     }
+    if (recompressed) {
+      partition->cold_compressed.store(true);
+      STAT_INCR(stats_, partition_cold_compressions);
+    }
+    // Compaction wrote new files locally.
+    partition->offloaded.store(false);
   }
 
   if (to_compact.reason != PartitionToCompact::Reason::PARTIAL) {
@@ -5008,7 +5445,7 @@ void PartitionedRocksDBStore::cleanUpDirectory(
   };
 
   RocksDBIterator it = createMetadataIterator();
-  std::map<lsn_t, DirectoryEntry>::const_iterator in_memory_directory_it;
+  LogDirectory::const_iterator in_memory_directory_it;
   std::unordered_set<logid_t> seen_logids;
 
   auto it_error = [&] {
@@ -5165,6 +5602,10 @@ void PartitionedRocksDBStore::cleanUpDirectory(
         // Delete the directory entry.
         batch.Delete(metadata_cf_->get(), it.key());
         // From in-memory directory as well
+        ld_check_ge(log_state->approximate_size_bytes,
+                    in_memory_directory_it->second.approximate_size_bytes);
+        log_state->approximate_size_bytes -=
+            in_memory_directory_it->second.approximate_size_bytes;
         in_memory_directory_it =
             log_state->directory.erase(in_memory_directory_it);
 
@@ -5436,6 +5877,102 @@ void PartitionedRocksDBStore::compactMetadataCFIfNeeded() {
   }
 }
 
+void PartitionedRocksDBStore::dropTrimmedUnpartitionedFilesIfNeeded() {
+  ld_check(!getSettings()->read_only);
+  ld_check(!immutable_.load());
+  auto period = getSettings()->unpartitioned_drop_trimmed_files_period;
+  auto now = currentSteadyTime();
+  if (period.count() > 0 &&
+      last_unpartitioned_trimmed_files_drop_time_ < (now - period)) {
+    dropTrimmedUnpartitionedFiles();
+    last_unpartitioned_trimmed_files_drop_time_ = now;
+  }
+}
+
+void PartitionedRocksDBStore::dropTrimmedUnpartitionedFiles() {
+  ServerProcessor* processor = processor_.load();
+  if (!processor) {
+    // We're not fully initialized yet.
+    return;
+  }
+  LogStorageStateMap& state_map = processor->getLogStorageStateMap();
+  rocksdb::ColumnFamilyHandle* cf = unpartitioned_cf_->get();
+
+  rocksdb::TablePropertiesCollection props;
+  rocksdb::Status status = db_->GetPropertiesOfAllTables(cf, &props);
+  if (!status.ok()) {
+    ld_warning("Failed to get properties of sst files in unpartitioned CF: %s",
+               status.ToString().c_str());
+    enterFailSafeIfFailed(status, "GetPropertiesOfAllTables()");
+    return;
+  }
+
+  // Trim points of logs that have at least one fully trimmed file.
+  std::map<logid_t, lsn_t> logs_to_drop;
+  for (const auto& it : props) {
+    auto range = RocksDBTablePropertiesCollector::extractRecordRange(
+        it.second->user_collected_properties);
+    if (!range.hasValue() || range->has_other_keys ||
+        range->min_log_id != range->max_log_id) {
+      continue;
+    }
+    const logid_t log_id = range->min_log_id;
+    LogStorageState* log_state = state_map.find(log_id, getShardIdx());
+    if (!log_state) {
+      continue;
+    }
+    folly::Optional<lsn_t> trim_point = log_state->getTrimPoint();
+    if (trim_point.hasValue() && range->max_lsn <= trim_point.value()) {
+      logs_to_drop[log_id] = trim_point.value();
+    }
+  }
+  if (logs_to_drop.empty()) {
+    return;
+  }
+
+  rocksdb::ColumnFamilyMetaData meta_before;
+  db_->GetColumnFamilyMetaData(cf, &meta_before);
+
+  for (const auto& it : logs_to_drop) {
+    if (shutdown_event_.signaled()) {
+      return;
+    }
+    DataKey first_key(it.first, LSN_INVALID);
+    DataKey last_key(it.first, it.second);
+    rocksdb::Slice begin = first_key.sliceForForwardSeek();
+    rocksdb::Slice end = last_key.sliceForBackwardSeek();
+    status = rocksdb::DeleteFilesInRange(db_.get(), cf, &begin, &end);
+    if (!status.ok()) {
+      ld_warning("Failed to delete trimmed sst files of log %lu in "
+                 "unpartitioned CF: %s",
+                 it.first.val_,
+                 status.ToString().c_str());
+      enterFailSafeIfFailed(status, "DeleteFilesInRange()");
+      return;
+    }
+  }
+
+  rocksdb::ColumnFamilyMetaData meta_after;
+  db_->GetColumnFamilyMetaData(cf, &meta_after);
+  // Approximate, flushes and compactions may run concurrently.
+  if (meta_after.file_count < meta_before.file_count) {
+    const size_t files = meta_before.file_count - meta_after.file_count;
+    const uint64_t bytes = meta_before.size > meta_after.size
+        ? meta_before.size - meta_after.size
+        : 0;
+    PER_SHARD_STAT_ADD(
+        stats_, unpartitioned_trimmed_files_dropped, shard_idx_, files);
+    PER_SHARD_STAT_ADD(
+        stats_, unpartitioned_trimmed_bytes_dropped, shard_idx_, bytes);
+    ld_info("Shard %d: deleted %lu fully trimmed sst files (%lu bytes) of %lu "
+            "logs in unpartitioned CF",
+            getShardIdx(),
+            files,
+            bytes,
+            logs_to_drop.size());
+  }
+}
+
 void PartitionedRocksDBStore::performCompaction(partition_id_t partition) {
   ld_check(!getSettings()->read_only);
   ld_check(!immutable_.load());
@@ -5742,21 +6279,19 @@ void PartitionedRocksDBStore::listLogs(
                        lsn_t highest_lsn,
                        uint64_t highest_partition_id,
                        RecordTimestamp highest_timestamp_approx)> cb,
-    bool only_log_ids) {
+    bool only_log_ids,
+    folly::Optional<logid_t> log_id) {
   auto partitions = partitions_.getVersion();
-  for (auto p = logs_.cbegin(); p != logs_.cend(); ++p) {
-    logid_t log(p->first);
-    LogState* state = p->second.get();
-
+  auto process_log = [&](logid_t log, LogState* state) {
     partition_id_t highest_partition =
         state->latest_partition.latest_partition.load();
     if (highest_partition == PARTITION_INVALID) {
-      continue;
+      return;
     }
 
     if (only_log_ids) {
       cb(log, LSN_INVALID, PARTITION_INVALID, RecordTimestamp::zero());
-      continue;
+      return;
     }
 
     lsn_t max_lsn_in_latest = state->latest_partition.max_lsn_in_latest.load();
@@ -5774,6 +6309,17 @@ void PartitionedRocksDBStore::listLogs(
     }
 
     cb(log, max_lsn_in_latest, highest_partition, highest_timestamp);
+  };
+
+  if (log_id.hasValue()) {
+    auto it = logs_.find(log_id->val_);
+    if (it != logs_.cend()) {
+      process_log(log_id.value(), it->second.get());
+    }
+    return;
+  }
+  for (auto p = logs_.cbegin(); p != logs_.cend(); ++p) {
+    process_log(logid_t(p->first), p->second.get());
   }
 }
 
@@ -5909,12 +6455,21 @@ void PartitionedRocksDBStore::hiPriBackgroundThreadRun() {
       createPartition();
     }
 
-    if (last_broadcast_flush_ < flushedUpThrough()) {
+    // Coalesce flush notifications to at most one per
+    // --rocksdb-flush-notification-interval. A deferred one is sent by a
+    // later iteration, within --rocksdb-partition-hi-pri-check-period after the
+    // interval ends.
+    if (last_broadcast_flush_ < flushedUpThrough() &&
+        (last_broadcast_flush_time_ == SteadyTimestamp::min() ||
+         currentSteadyTime() - last_broadcast_flush_time_ >=
+             getSettings()->flush_notification_interval)) {
       ld_debug("Shard %d: Flushed up through now %ju.",
                getShardIdx(),
                (uintmax_t)flushedUpThrough());
       last_broadcast_flush_ = flushedUpThrough();
+      last_broadcast_flush_time_ = currentSteadyTime();
       broadcastFlushEvent(last_broadcast_flush_);
+      STAT_INCR(stats_, memtable_flush_notifications);
       cleaner_pass_requested_.store(true);
     }
 
@@ -6058,6 +6613,8 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
       }
     }
 
+    prioritizePartialCompactions(&partial_compactions);
+
     size_t num_partial_compactions_postponed = 0;
     if (partial_compactions.size() >=
         partition_partial_compaction_max_num_per_loop) {
@@ -6075,6 +6632,7 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
               std::back_inserter(to_compact));
 
     getPartitionsForProactiveCompaction(&to_compact);
+    getPartitionsForColdCompression(&to_compact);
 
     // We only get lo-pri manual compactions if there are no other compactions
     // pending. But, we skip the delay if there are pending lo-pri manual
@@ -6112,6 +6670,7 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
     auto compactions_start_time = currentTime();
 
     compactMetadataCFIfNeeded();
+    dropTrimmedUnpartitionedFilesIfNeeded();
 
     bool first = true;
     for (auto p : to_compact) {
@@ -6138,6 +6697,12 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
       }
     }
 
+    if (!shutdown_event_.signaled() && !inFailSafeMode() &&
+        offloadOldPartitions(currentTime() +
+                             getSettings()->partition_lo_pri_check_period_)) {
+      skip_sleep = true;
+    }
+
     // Update stats for total trash size and the rate limit on its deletion
     PER_SHARD_STAT_SET(stats_, trash_size, shard_idx_, getTotalTrashSize());
     PER_SHARD_STAT_SET(stats_,
@@ -6294,6 +6859,7 @@ void PartitionedRocksDBStore::flushBackgroundThreadRun() {
       last_flush_eval_stats_ = buf_stats;
       throttleIOIfNeeded(buf_stats, memory_limit);
     }
+    updateWritePacingRate(buf_stats, memory_limit);
 
     update_stats(buf_stats);
 
@@ -6411,11 +6977,12 @@ void EnumMap<PartitionedRocksDBStore::PartitionToCompact::Reason,
   using Reason = PartitionedRocksDBStore::PartitionToCompact::Reason;
   set(Reason::INVALID, "INVALID");
   set(Reason::PARTIAL, "PARTIAL");
+  set(Reason::COLD, "COLD");
   set(Reason::RETENTION, "RETENTION");
   set(Reason::PROACTIVE, "PROACTIVE");
   set(Reason::MANUAL, "MANUAL");
   static_assert(
-      (size_t)Reason::MAX == 5,
+      (size_t)Reason::MAX == 6,
       "Added more values to the enum? Add them above and update this assert.");
 }
 
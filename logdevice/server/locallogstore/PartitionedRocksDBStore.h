@@ -20,6 +20,7 @@
 #include <folly/SharedMutex.h>
 #include <folly/ThreadLocal.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
+#include <folly/sorted_vector_types.h>
 #include <rocksdb/db.h>
 #include <rocksdb/iterator.h>
 #include <rocksdb/merge_operator.h>
@@ -36,6 +37,7 @@
 #include "logdevice/common/util.h"
 #include "logdevice/server/FixedKeysMap.h"
 #include "logdevice/server/locallogstore/NodeDirtyData.h"
+#include "logdevice/server/locallogstore/PartitionIndexCache.h"
 #include "logdevice/server/locallogstore/RocksDBLogStoreBase.h"
 #include "logdevice/server/locallogstore/RocksDBWriter.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
@@ -106,6 +108,7 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
               src.append_dirtied_wal_token.load(std::memory_order_relaxed)),
           latest_dirty_time(src.latest_dirty_time.timePoint()),
           oldest_dirty_time(src.oldest_dirty_time.timePoint()),
+          min_append_timestamp(src.min_append_timestamp.timePoint()),
           under_replicated(false) {}
 
     const DirtyState& operator=(const DirtyState& rhs) {
@@ -116,6 +119,7 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
           rhs.append_dirtied_wal_token.load(std::memory_order_relaxed);
       latest_dirty_time = rhs.latest_dirty_time.timePoint();
       oldest_dirty_time = rhs.oldest_dirty_time.timePoint();
+      min_append_timestamp = rhs.min_append_timestamp.timePoint();
       under_replicated.store(false, std::memory_order_relaxed);
       return *this;
     }
@@ -172,7 +176,9 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
     PartitionDirtyMetadata metadata() const {
       return PartitionDirtyMetadata(
-          dirtied_by_nodes, under_replicated.load(std::memory_order_relaxed));
+          dirtied_by_nodes,
+          under_replicated.load(std::memory_order_relaxed),
+          min_append_timestamp);
     }
 
     // Key used for the special DirtiedByMap entry signifying that a
@@ -224,6 +230,19 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     AtomicSteadyTimestamp latest_dirty_time{SteadyTimestamp::min()};
     AtomicSteadyTimestamp oldest_dirty_time{SteadyTimestamp::max()};
 
+    // Lower bound on the record timestamps of appends written to this
+    // partition since it was last clean for appends. Persisted as part of
+    // PartitionDirtyMetadata, so that after an unclean shutdown only the
+    // records with timestamps above it need to be rebuilt, rather than
+    // the whole partition. An append with a lower timestamp lowers the
+    // bound and waits for the updated metadata to be synced, the same way
+    // as a write from a newly dirtying node does. RecordTimestamp::max()
+    // if no appends are outstanding.
+    //
+    // Lowered under mutex_ held in write mode. Reset under mutex_ held in
+    // write mode when the partition becomes clean for appends.
+    AtomicRecordTimestamp min_append_timestamp{RecordTimestamp::max()};
+
     // Report that this partition has lost records that have not yet been
     // restored by rebuilding.
     std::atomic<bool> under_replicated{false};
@@ -280,6 +299,31 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     std::atomic<std::chrono::seconds> compacted_retention{
         std::chrono::seconds::min()};
 
+    // Whether all SST files of this partition were rewritten with
+    // --rocksdb-partition-cold-compression-type and the column family was
+    // switched to it. Not persisted; rechecked after restart.
+    std::atomic<bool> cold_compressed{false};
+
+    // Whether all SST files of this partition were moved to
+    // --rocksdb-partition-offload-path. Not persisted; rechecked after
+    // restart. New files written by compactions reset it.
+    std::atomic<bool> offloaded{false};
+
+    // Last time a log reader created an iterator in this partition, as
+    // currentSteadyTime(). Rebuilding's all-logs iterators don't update it.
+    // Used for ordering partial compactions.
+    AtomicSteadyTimestamp last_read_time{SteadyTimestamp::min()};
+
+    // Updates last_read_time, but not more often than once a second so that
+    // readers don't keep writing the same cache line.
+    void noteRead(SteadyTimestamp now) {
+      SteadyTimestamp prev = last_read_time;
+      if (prev == SteadyTimestamp::min() ||
+          now - prev >= std::chrono::seconds(1)) {
+        last_read_time = now;
+      }
+    }
+
     DirtyState dirty_state_;
 
     // Whether cf_ is dropped. A dropped column family is readable but not
@@ -287,6 +331,10 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     // exclusively locked mutex_.
     bool is_dropped{false};
 
+    // In-memory copies of this partition's findTime/findKey indexes. Only
+    // populated for partitions older than the latest one.
+    PartitionIndexCache index_cache_;
+
     Partition(partition_id_t id,
               RocksDBCFPtr cf,
               RecordTimestamp starting_timestamp,
@@ -353,6 +401,13 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     std::string flagsToString() const;
   };
 
+  // Directory entries of a log, keyed by first_lsn. Entries are appended at
+  // the end and dropped from the front, a few hundred at most per log, so a
+  // sorted vector costs nothing in lookups compared to a tree, while using
+  // about half the memory and no allocation per entry. With millions of logs
+  // the directory is a sizable part of the resident set.
+  using LogDirectory = folly::sorted_vector_map<lsn_t, DirectoryEntry>;
+
   class MemtableFlushCallback : public FlushCallback {
    public:
     void operator()(LocalLogStore* store, FlushToken token) const override;
@@ -610,6 +665,14 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // trimming and updating trim points for per-epoch log metadata.
   void performMetadataCompaction();
 
+  // Deletes the sst files of the unpartitioned column family that only hold
+  // records of a single log below its trim point (according to the table
+  // properties collected by RocksDBTablePropertiesCollector), using
+  // rocksdb::DeleteFilesInRange() on the trimmed key range of the log.
+  // Any file inside this range only holds trimmed records, so files created
+  // concurrently are fine.
+  void dropTrimmedUnpartitionedFiles();
+
   // Size in bytes of column family data.
   uint64_t getApproximatePartitionSize(rocksdb::ColumnFamilyHandle* cf) const;
 
@@ -679,12 +742,15 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   //
   // @param only_log_ids  if true, only the first argument of cb will have the
   //                      correct value, others will be zeros. Slightly cheaper.
+  // @param log_id        if set, only this log is considered (a single hash
+  //                      lookup instead of a scan of all logs).
   void
   listLogs(std::function<void(logid_t,
                               lsn_t highest_lsn,
                               uint64_t highest_partition,
                               RecordTimestamp highest_timestamp_approx)> cb,
-           bool only_log_ids = false);
+           bool only_log_ids = false,
+           folly::Optional<logid_t> log_id = folly::none);
 
   bool supportsNonBlockingFindTime() const override {
     return true;
@@ -787,6 +853,9 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     enum class Reason {
       INVALID = 0,
       PARTIAL, // this is first, for lowest priority when deduplicating
+      // Rewrite an old partition with the cold compression codec. Any other
+      // full compaction of an old partition does that as well.
+      COLD,
       RETENTION,
       PROACTIVE,
       MANUAL,
@@ -1225,7 +1294,12 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     LatestPartitionInfo latest_partition;
 
     // Information about partitions used by this log, keyed by their first_lsn
-    std::map<lsn_t, DirectoryEntry> directory;
+    LogDirectory directory;
+
+    // Sum of approximate_size_bytes over all entries of `directory`. Lets
+    // dataSize() answer queries covering all of the log's data without
+    // walking the directory.
+    uint64_t approximate_size_bytes = 0;
   };
 
   using LogStateMap = folly::ConcurrentHashMap<logid_t::raw_type,
@@ -1299,6 +1373,12 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // Reads timestamps metadata for the given partition.
   bool readPartitionTimestamps(PartitionPtr partition);
 
+  // Called by open(). Calls readPartitionTimestamps() for each of the given
+  // partitions, using up to RocksDBSettings::partition_metadata_read_threads
+  // threads. Returns whether each call succeeded and, if not, the err it set.
+  std::vector<std::pair<bool, E>> readPartitionTimestampsInParallel(
+      const std::vector<PartitionPtr>& partitions);
+
   // Called by the constructor.
   // Reads persisted dirty metadata for the given partition.
   bool readPartitionDirtyState(PartitionPtr partition);
@@ -1463,6 +1543,41 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   void getPartitionsForProactiveCompaction(
       std::vector<PartitionToCompact>* out_to_compact);
 
+  // Gets at most one partition older than
+  // --rocksdb-partition-cold-compression-age that hasn't been rewritten with
+  // the cold compression codec yet.
+  void getPartitionsForColdCompression(
+      std::vector<PartitionToCompact>* out_to_compact);
+
+  // @return  true if newest record of `partition` is at least `age` old and
+  //          `partition` isn't one of the two latest partitions. Always
+  //          false if `age` is zero.
+  bool isPartitionOlderThan(const PartitionPtr& partition,
+                            std::chrono::hours age);
+
+  // @return  true if `partition` is older than
+  //          --rocksdb-partition-cold-compression-age and isn't one of the
+  //          two latest partitions.
+  bool isColdPartition(const PartitionPtr& partition);
+
+  // Stable-sorts partial compactions by the priority of their partitions:
+  // the two latest partitions (appends and tailing reads), then partitions
+  // read within --rocksdb-partition-hot-read-period, then the rest. Applied
+  // before the number of partial compactions per loop is capped, so that
+  // compactions of cold partitions are the ones deferred.
+  void prioritizePartialCompactions(std::vector<PartitionToCompact>* ps);
+
+  // Moves SST files of partitions older than --rocksdb-partition-offload-age
+  // to --rocksdb-partition-offload-path, oldest partitions first, until
+  // `deadline`.
+  // @return  true if there's more to offload
+  bool offloadOldPartitions(SystemTimestamp deadline);
+
+  // Switches the column family of `partition` to the cold compression codec,
+  // so that subsequent compactions write SSTs with it.
+  // @return  true on success
+  bool applyColdCompressionOptions(const PartitionPtr& partition);
+
   // Gets partitions for partial compaction. Returns true if there are more
   // partial compactions to be done than the results added
   bool getPartitionsForPartialCompaction(
@@ -1595,6 +1710,9 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // Applies RocksDBSettings::metadata_compaction_period.
   void compactMetadataCFIfNeeded();
 
+  // Applies RocksDBSettings::unpartitioned_drop_trimmed_files_period.
+  void dropTrimmedUnpartitionedFilesIfNeeded();
+
   typedef std::function<void(logid_t log_id,
                              partition_id_t partition_id,
                              bool& remove_entry,
@@ -1611,6 +1729,17 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
   void flushBackgroundThreadRun();
 
+  // Returns the in-memory copy of `partition`'s findTime or findKey index
+  // (depending on `index_type`) for the given log, building it if needed.
+  // Returns nullptr if the copy is disabled in settings, not applicable to
+  // this partition, too big, or can't be built without blocking; the caller
+  // should then search the partition in RocksDB.
+  std::shared_ptr<const PartitionIndexCache::LogIndex>
+  getPartitionIndex(const PartitionPtr& partition,
+                    logid_t log_id,
+                    char index_type,
+                    bool allow_blocking_io) const;
+
   // A helper function used to position the iterator at the last directory entry
   // for a given log that's <= lsn. If no such entry exists, iterator will point
   // to the smallest entry for log_id instead. If next_log_out is not null, it
@@ -1700,6 +1829,12 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // Approximate time when "metadata" CF was last compacted.
   SteadyTimestamp last_metadata_manual_compaction_time_;
 
+  // How long rocksdb::DB::Open() took in open(), for logging.
+  int64_t startup_rocksdb_open_ms_ = 0;
+
+  // Approximate time when dropTrimmedUnpartitionedFiles() last ran.
+  SteadyTimestamp last_unpartitioned_trimmed_files_drop_time_;
+
   // Approximate time when cleanUpDirectory last verified consistency of all
   // entries in on-disk directory with in-memory directory
   AtomicSteadyTimestamp last_directory_consistency_check_time_{
@@ -1738,6 +1873,8 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // write penalty for updating dirty state durably.
   std::deque<std::pair<SteadyTimestamp, FlushToken>> cleaner_work_queue_;
   FlushToken last_broadcast_flush_{FlushToken_INVALID};
+  // When last_broadcast_flush_ was last broadcast.
+  SteadyTimestamp last_broadcast_flush_time_{SteadyTimestamp::min()};
   std::atomic<bool> cleaner_pass_requested_{false};
 
   // Set to valid partition ids if rebuilding has yet to restore data in one
@@ -152,9 +152,21 @@ int PartitionedRocksDBStore::FindKey::findPreciseBound(PartitionPtr partition) {
   folly::small_vector<char, 26> key =
       RocksDBKeyFormat::IndexKey::create(logid_, FIND_KEY_INDEX, key_, 0);
 
+  auto index = store_.getPartitionIndex(
+      partition, logid_, FIND_KEY_INDEX, allow_blocking_io_);
+  if (index) {
+    lsn_t new_lo = LSN_INVALID;
+    lsn_t new_hi = LSN_MAX;
+    index->search(rocksdb::Slice(key.data(), key.size()), &new_lo, &new_hi);
+    *lo_ = std::max(*lo_, new_lo);
+    *hi_ = std::min(*hi_, new_hi);
+    return 0;
+  }
+
   auto options = RocksDBLogStoreBase::getReadOptionsSinglePrefix();
   options.read_tier =
       (allow_blocking_io_ ? rocksdb::kReadAllTier : rocksdb::kBlockCacheTier);
+  store_.setTableFilterForLog(options, logid_);
 
   RocksDBIterator it = store_.newIterator(options, partition->cf_->get());
   auto it_error = [&] {
@@ -56,8 +56,9 @@ class PartitionedRocksDBStore::FindKey {
   int findPartitionLo(PartitionPtr* out_partition_lo);
 
   /**
-   * Use the in-partition index to find the precise lower and upper bounds for
-   * the findKey result.
+   * Use the in-partition index, or its in-memory copy if there is one (see
+   * PartitionIndexCache), to find the precise lower and upper bounds for the
+   * findKey result.
    *
    * @param partition   The PartitionPtr corresponding to the partition that
    *                    contains the lower bound.
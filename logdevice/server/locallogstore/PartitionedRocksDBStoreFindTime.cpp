@@ -140,7 +140,7 @@ int PartitionedRocksDBStore::FindTime::execute(lsn_t* lo, lsn_t* hi) {
 
   // Do a search on the found column family.
   if (cf) {
-    int rv = partitionSearch(cf);
+    int rv = partitionSearch(cf, p);
     if (rv != 0) {
       if (err == E::WOULDBLOCK) {
         ld_check(!allow_blocking_io_);
@@ -429,7 +429,37 @@ int PartitionedRocksDBStore::FindTime::findPartition(
 }
 
 int PartitionedRocksDBStore::FindTime::partitionSearch(
-    rocksdb::ColumnFamilyHandle* cf) const {
+    rocksdb::ColumnFamilyHandle* cf,
+    const PartitionPtr& partition) const {
+  std::shared_ptr<const PartitionIndexCache::LogIndex> index;
+  if (use_index_ && partition) {
+    index = store_.getPartitionIndex(
+        partition, logid_, FIND_TIME_INDEX, allow_blocking_io_);
+  }
+  if (index) {
+    uint64_t timestamp_big_endian =
+        htobe64(timestamp_.toMilliseconds().count());
+    auto key = RocksDBKeyFormat::IndexKey::create(
+        logid_,
+        FIND_TIME_INDEX,
+        std::string(reinterpret_cast<const char*>(&timestamp_big_endian),
+                    sizeof(timestamp_big_endian)),
+        0);
+
+    lsn_t new_lo = LSN_INVALID;
+    lsn_t new_hi = LSN_MAX;
+    index->search(rocksdb::Slice(key.data(), key.size()), &new_lo, &new_hi);
+    if (new_lo >= new_hi) {
+      // Same handling of inversions as in IteratorSearch::executeWithIndex().
+      new_lo = min_lo_;
+      new_hi = std::max(new_hi, new_lo + 1);
+    }
+
+    *lo_ = std::max(*lo_, new_lo);
+    *hi_ = std::min(*hi_, new_hi);
+    return 0;
+  }
+
   IteratorSearch search(&store_,
                         cf,
                         FIND_TIME_INDEX,
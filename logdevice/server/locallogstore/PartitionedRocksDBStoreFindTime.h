@@ -70,11 +70,16 @@ class PartitionedRocksDBStore::FindTime {
    * column family, and update *lo_ and *hi_ with the result. Only one of *lo_
    * and *hi_ may be updated, or none of them if the search is unable to find
    * both a record stamped before `timestamp_` and a record stamped at or after.
+   * If the findTime index is used and `partition` has an in-memory copy of it
+   * (see PartitionIndexCache), searches the copy instead of RocksDB.
    *
-   * @param cf Column family on which to search.
+   * @param cf        Column family on which to search.
+   * @param partition Partition that `cf` belongs to, nullptr for the
+   *                  unpartitioned column family.
    * @return 0 on success or -1 if there is an error reading from rocksdb.
    */
-  int partitionSearch(rocksdb::ColumnFamilyHandle* cf) const;
+  int partitionSearch(rocksdb::ColumnFamilyHandle* cf,
+                      const PartitionPtr& partition) const;
 
   bool isTimedOut() const {
     return std::chrono::steady_clock::now() >= deadline_;
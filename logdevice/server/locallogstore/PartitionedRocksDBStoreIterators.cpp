@@ -32,6 +32,7 @@ void PartitionedRocksDBStore::Iterator::setDataIteratorFromCurrent(
     if (data_iterator_ == nullptr) {
       data_iterator_ = std::make_unique<RocksDBLocalLogStore::CSIWrapper>(
           pstore_, log_id_, options_, current_.partition_->cf_->get());
+      current_.partition_->noteRead(pstore_->currentSteadyTime());
     }
     data_iterator_->min_ts_ = min_ts;
     data_iterator_->max_ts_ = max_ts;
@@ -9,6 +9,9 @@
 
 namespace facebook { namespace logdevice {
 
+thread_local StorageTaskPrincipal RocksDBCache::current_principal_ =
+    StorageTaskPrincipal::UNKNOWN;
+
 RocksDBCache::RocksDBCache(UpdateableSettings<RocksDBSettings> rocksdb_settings)
     : rocksdb_settings_(rocksdb_settings) {
   rocksdb::LRUCacheOptions opt;
@@ -29,19 +32,50 @@ rocksdb::Status RocksDBCache::Insert(const rocksdb::Slice& key,
                                                      void* value),
                                      Handle** handle,
                                      Priority priority) {
-  if (charge <
-      rocksdb_settings_->cache_small_block_threshold_for_high_priority_) {
+  if (rocksdb_settings_->cache_scan_resistant_ &&
+      current_principal_ != StorageTaskPrincipal::UNKNOWN) {
+    // Blocks of scans only get into the protected part of the cache if they
+    // are hit again before being evicted.
+    priority = isScan(current_principal_) ? Priority::LOW : Priority::HIGH;
+  } else if (charge < rocksdb_settings_
+                          ->cache_small_block_threshold_for_high_priority_) {
     priority = Priority::HIGH;
   }
   return cache_->Insert(key, value, charge, deleter, handle, priority);
 }
 
-// Everything below is trivially passed through to cache_.
-
 RocksDBCache::Handle* RocksDBCache::Lookup(const rocksdb::Slice& key,
                                            rocksdb::Statistics* stats) {
-  return cache_->Lookup(key, stats);
+  Handle* handle = cache_->Lookup(key, stats);
+  ReadClassCounters& counters = counters_[readClass(current_principal_)];
+  (handle ? counters.hits : counters.misses)
+      .fetch_add(1, std::memory_order_relaxed);
+  return handle;
+}
+
+uint64_t RocksDBCache::getHits(StorageTaskPrincipal principal) const {
+  return counters_[readClass(principal)].hits.load(std::memory_order_relaxed);
+}
+
+uint64_t RocksDBCache::getMisses(StorageTaskPrincipal principal) const {
+  return counters_[readClass(principal)].misses.load(
+      std::memory_order_relaxed);
 }
+
+bool RocksDBCache::isScan(StorageTaskPrincipal principal) {
+  switch (principal) {
+    case StorageTaskPrincipal::READ_BACKLOG:
+    case StorageTaskPrincipal::REBUILD:
+    case StorageTaskPrincipal::COMPACTION_PARTIAL:
+    case StorageTaskPrincipal::COMPACTION_RETENTION:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Everything below is trivially passed through to cache_.
+
 bool RocksDBCache::Ref(Handle* handle) {
   return cache_->Ref(handle);
 }
@@ -7,20 +7,67 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+
 #include <rocksdb/cache.h>
 
+#include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/server/locallogstore/RocksDBSettings.h"
 
 namespace facebook { namespace logdevice {
 
 // Custom cache policy used for block cache.
-// Currently it just wraps the default LRU cache implementation,
-// with small tweaks.
+// Wraps the default LRU cache implementation, with small tweaks.
+//
+// With a positive --rocksdb-cache-high-pri-pool-ratio, RocksDB's LRU cache is
+// a segmented LRU: low priority blocks are inserted in the middle of the LRU
+// list and only move to the protected high priority part when they are hit
+// again. With --rocksdb-cache-scan-resistant, the priority is picked by the
+// principal of the storage task doing the read (see ReadClassGuard), so that
+// one reader scanning a backlog can't evict the blocks that tail readers and
+// findTime keep hitting.
+//
+// Also counts lookup hits and misses per storage task principal; they are
+// reported by the "stats rocksdb" admin command.
 
 class RocksDBCache : public rocksdb::Cache {
  public:
+  // Sets the principal of the block reads made by this thread for as long as
+  // it lives. ExecStorageThread holds one while running a StorageTask.
+  class ReadClassGuard {
+   public:
+    explicit ReadClassGuard(StorageTaskPrincipal principal)
+        : prev_(current_principal_) {
+      current_principal_ = principal;
+    }
+    ~ReadClassGuard() {
+      current_principal_ = prev_;
+    }
+
+   private:
+    StorageTaskPrincipal prev_;
+  };
+
+  // @return  principal of the storage task this thread is running, or
+  //          UNKNOWN if it's not running one
+  static StorageTaskPrincipal currentPrincipal() {
+    return current_principal_;
+  }
+
+  // Blocks read outside of storage tasks (e.g. by RocksDB's own threads) are
+  // counted under NUM_PRINCIPALS.
+  static constexpr size_t kNumReadClasses =
+      static_cast<size_t>(StorageTaskPrincipal::NUM_PRINCIPALS) + 1;
+
   explicit RocksDBCache(UpdateableSettings<RocksDBSettings> rocksdb_settings);
 
+  // Lookup hits and misses so far of blocks read by tasks of the given
+  // principal.
+  uint64_t getHits(StorageTaskPrincipal principal) const;
+  uint64_t getMisses(StorageTaskPrincipal principal) const;
+
   const char* Name() const override;
   rocksdb::Status Insert(const rocksdb::Slice& key,
                          void* value,
@@ -50,8 +97,24 @@ class RocksDBCache : public rocksdb::Cache {
   std::string GetPrintableOptions() const override;
 
  private:
+  struct alignas(64) ReadClassCounters {
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+  };
+
+  static size_t readClass(StorageTaskPrincipal principal) {
+    return std::min(static_cast<size_t>(principal), kNumReadClasses - 1);
+  }
+
+  // Does the principal read large ranges of records, most of which won't be
+  // read again soon?
+  static bool isScan(StorageTaskPrincipal principal);
+
   std::shared_ptr<rocksdb::Cache> cache_;
   UpdateableSettings<RocksDBSettings> rocksdb_settings_;
+  std::array<ReadClassCounters, kNumReadClasses> counters_;
+
+  static thread_local StorageTaskPrincipal current_principal_;
 };
 
 }} // namespace facebook::logdevice
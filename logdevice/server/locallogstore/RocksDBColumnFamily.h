@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <list>
 
 #include <folly/Synchronized.h>
@@ -132,6 +133,11 @@ struct RocksDBColumnFamily {
   // memtable. If current active memtable is empty, min().
   AtomicSteadyTimestamp first_dirtied_time_{SteadyTimestamp::min()};
 
+  // Incremented after every write into this column family. Used to tell
+  // whether a PartitionIndexCache entry built from this column family is
+  // still up to date.
+  std::atomic<uint64_t> write_generation_{0};
+
   RocksDBColumnFamily(rocksdb::ColumnFamilyHandle* cf) : cf_(cf) {}
 
   uint32_t getID() {
@@ -238,6 +244,7 @@ struct RocksDBColumnFamily {
 
       flush_token = locked.recent_memtable;
     });
+    write_generation_.fetch_add(1);
 
     return flush_token;
   }
@@ -16,6 +16,7 @@
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/util.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/locallogstore/RocksDBCache.h"
 
 namespace facebook { namespace logdevice {
 
@@ -102,12 +103,16 @@ RocksDBEnv::NewRandomAccessFile(const std::string& f,
                                 std::unique_ptr<rocksdb::RandomAccessFile>* r,
                                 const rocksdb::EnvOptions& options) {
   std::unique_ptr<rocksdb::RandomAccessFile> file;
-  auto status = rocksdb::EnvWrapper::NewRandomAccessFile(f, &file, options);
+  const std::string path = resolvePath(f);
+  auto status = rocksdb::EnvWrapper::NewRandomAccessFile(path, &file, options);
   if (!status.ok()) {
     return status;
   }
-  ld_debug("Wrapping random access file %s", f.c_str());
-  r->reset(new RocksDBRandomAccessFile(f, std::move(file)));
+  if (path != f) {
+    STAT_INCR(stats_, offloaded_sst_file_opens);
+  }
+  ld_debug("Wrapping random access file %s", path.c_str());
+  r->reset(new RocksDBRandomAccessFile(f, std::move(file), settings_));
   return rocksdb::Status::OK();
 }
 
@@ -134,6 +139,136 @@ RocksDBEnv::NewWritableFile(const std::string& f,
 }
 
 rocksdb::Status RocksDBEnv::DeleteFile(const std::string& fname) {
+  rocksdb::Status status = deleteLocalFile(fname);
+  const std::string remote = offloadedPath(fname);
+  if (remote.empty() || !rocksdb::EnvWrapper::FileExists(remote).ok()) {
+    return status;
+  }
+  rocksdb::Status remote_status = rocksdb::EnvWrapper::DeleteFile(remote);
+  if (!remote_status.ok()) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    2,
+                    "Failed to delete offloaded file %s: %s",
+                    remote.c_str(),
+                    remote_status.ToString().c_str());
+  }
+  // If the file was offloaded, there was no local copy to delete.
+  return status.ok() ? status : remote_status;
+}
+
+rocksdb::Status RocksDBEnv::GetFileSize(const std::string& fname,
+                                        uint64_t* file_size) {
+  return rocksdb::EnvWrapper::GetFileSize(resolvePath(fname), file_size);
+}
+
+rocksdb::Status RocksDBEnv::FileExists(const std::string& fname) {
+  return rocksdb::EnvWrapper::FileExists(resolvePath(fname));
+}
+
+std::string RocksDBEnv::offloadedPath(const std::string& fname) const {
+  const std::string& root = settings_->partition_offload_path_;
+  if (root.empty() || fname.size() < 4 ||
+      fname.compare(fname.size() - 4, 4, ".sst") != 0) {
+    return "";
+  }
+  // "/path/to/shard3/000123.sst" -> "<root>/shard3/000123.sst"
+  size_t name_pos = fname.find_last_of('/');
+  if (name_pos == std::string::npos || name_pos == 0) {
+    return "";
+  }
+  size_t dir_pos = fname.find_last_of('/', name_pos - 1);
+  dir_pos = dir_pos == std::string::npos ? 0 : dir_pos + 1;
+  return root + "/" + fname.substr(dir_pos);
+}
+
+std::string RocksDBEnv::resolvePath(const std::string& fname) {
+  const std::string remote = offloadedPath(fname);
+  if (remote.empty() || rocksdb::EnvWrapper::FileExists(fname).ok() ||
+      !rocksdb::EnvWrapper::FileExists(remote).ok()) {
+    return fname;
+  }
+  return remote;
+}
+
+bool RocksDBEnv::isOffloaded(const std::string& fname) {
+  return resolvePath(fname) != fname;
+}
+
+rocksdb::Status RocksDBEnv::offloadFile(const std::string& fname,
+                                        uint64_t* bytes_out) {
+  const std::string remote = offloadedPath(fname);
+  if (remote.empty()) {
+    return rocksdb::Status::NotSupported();
+  }
+  rocksdb::Status status = rocksdb::EnvWrapper::CreateDirIfMissing(
+      settings_->partition_offload_path_);
+  if (status.ok()) {
+    status = rocksdb::EnvWrapper::CreateDirIfMissing(
+        remote.substr(0, remote.find_last_of('/')));
+  }
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Copy to a temporary file and rename it, so that a partially copied file
+  // is never mistaken for the offloaded copy.
+  const std::string tmp = remote + ".tmp";
+  const rocksdb::EnvOptions env_options;
+  std::unique_ptr<rocksdb::SequentialFile> src;
+  status = rocksdb::EnvWrapper::NewSequentialFile(fname, &src, env_options);
+  if (!status.ok()) {
+    return status;
+  }
+  std::unique_ptr<rocksdb::WritableFile> dst;
+  status = rocksdb::EnvWrapper::NewWritableFile(tmp, &dst, env_options);
+  if (!status.ok()) {
+    return status;
+  }
+  const size_t kBufSize = 1 << 20;
+  std::unique_ptr<char[]> buf(new char[kBufSize]);
+  uint64_t bytes = 0;
+  while (status.ok()) {
+    rocksdb::Slice data;
+    status = src->Read(kBufSize, &data, buf.get());
+    if (!status.ok() || data.empty()) {
+      break;
+    }
+    status = dst->Append(data);
+    bytes += data.size();
+  }
+  if (status.ok()) {
+    status = dst->Sync();
+  }
+  if (status.ok()) {
+    status = dst->Close();
+  }
+  if (status.ok()) {
+    status = rocksdb::EnvWrapper::RenameFile(tmp, remote);
+  }
+  if (!status.ok()) {
+    rocksdb::EnvWrapper::DeleteFile(tmp);
+    return status;
+  }
+
+  // If rocksdb deleted the file while we were copying it, it didn't know
+  // about the offloaded copy yet. Once the offloaded copy exists, DeleteFile()
+  // takes care of both.
+  status = rocksdb::EnvWrapper::FileExists(fname);
+  if (!status.ok()) {
+    rocksdb::EnvWrapper::DeleteFile(remote);
+    return status.IsNotFound() ? status : rocksdb::Status::NotFound();
+  }
+  // Readers that already have the file open keep reading the unlinked local
+  // copy; new ones open the offloaded copy.
+  status = rocksdb::EnvWrapper::DeleteFile(fname);
+  if (!status.ok() && rocksdb::EnvWrapper::FileExists(fname).ok()) {
+    return status;
+  }
+  *bytes_out = bytes;
+  return rocksdb::Status::OK();
+}
+
+rocksdb::Status RocksDBEnv::deleteLocalFile(const std::string& fname) {
   Worker* w = Worker::onThisThread(false);
   if (!w) {
     return rocksdb::EnvWrapper::DeleteFile(fname);
@@ -230,19 +365,34 @@ RocksDBRandomAccessFile::RocksDBReadTracer::~RocksDBReadTracer() {
 
 RocksDBRandomAccessFile::RocksDBRandomAccessFile(
     const std::string& f,
-    std::unique_ptr<rocksdb::RandomAccessFile> file)
+    std::unique_ptr<rocksdb::RandomAccessFile> file,
+    UpdateableSettings<RocksDBSettings> settings)
     : RocksDBRandomAccessFileWrapper(file.get()),
       file(std::move(file)),
       file_name(f),
       file_offset(~0),
-      file_name_hash(f) {}
+      file_name_hash(f),
+      settings_(std::move(settings)) {}
 
 rocksdb::Status RocksDBRandomAccessFile::Read(uint64_t offset,
                                               size_t n,
                                               rocksdb::Slice* result,
                                               char* scratch) const {
-  auto tracer = RocksDBReadTracer(this, offset, n);
-  return RocksDBRandomAccessFileWrapper::Read(offset, n, result, scratch);
+  rocksdb::Status status;
+  {
+    auto tracer = RocksDBReadTracer(this, offset, n);
+    status = RocksDBRandomAccessFileWrapper::Read(offset, n, result, scratch);
+  }
+  if (status.ok() &&
+      RocksDBCache::currentPrincipal() == StorageTaskPrincipal::REBUILD &&
+      settings_->rebuilding_reads_drop_page_cache &&
+      !settings_->use_direct_reads) {
+    // rocksdb decides about O_DIRECT per DB, and table readers are shared
+    // between rebuilding and everything else, so rebuilding can't just open
+    // files with O_DIRECT. Dropping the pages it read is the next best thing.
+    file->InvalidateCache(offset, n);
+  }
+  return status;
 }
 
 rocksdb::Status RocksDBBackgroundSyncFile::Close() {
@@ -28,6 +28,13 @@ class StatsHolder;
  * background threads. The current rocksdb's implementation of
  * rocksdb::Env::LowerThreadPoolIOPriority() does pretty much the same but
  * only allows lowering it to IOPRIO_CLASS_IDLE which can be too low.
+ *
+ * Also implements offloading of SST files to --rocksdb-partition-offload-path:
+ * an offloaded file is moved from <shard dir>/<name>.sst to
+ * <offload path>/<shard dir name>/<name>.sst, and rocksdb keeps referring to
+ * it by its original path. Opening, getting the size of and deleting an SST
+ * file that is not in the shard directory transparently go to the offloaded
+ * copy.
  */
 class RocksDBEnv : public rocksdb::EnvWrapper {
  public:
@@ -57,9 +64,40 @@ class RocksDBEnv : public rocksdb::EnvWrapper {
                                   std::unique_ptr<rocksdb::WritableFile>* r,
                                   const rocksdb::EnvOptions& options) override;
 
+  // Deletes the offloaded copy of the file as well, if there is one.
   rocksdb::Status DeleteFile(const std::string& fname) override;
 
+  rocksdb::Status GetFileSize(const std::string& fname,
+                              uint64_t* file_size) override;
+
+  rocksdb::Status FileExists(const std::string& fname) override;
+
+  /**
+   * Moves an SST file to --rocksdb-partition-offload-path. The file must not
+   * be written to anymore. Safe to call concurrently with rocksdb deleting
+   * the file.
+   *
+   * @param bytes_out  set to the size of the file on success
+   * @return  OK on success, NotFound if the file was deleted meanwhile,
+   *          NotSupported if offloading is disabled or the file is not an SST
+   */
+  rocksdb::Status offloadFile(const std::string& fname, uint64_t* bytes_out);
+
+  // @return  whether `fname` is an SST file that was offloaded and no longer
+  //          has a local copy
+  bool isOffloaded(const std::string& fname);
+
  private:
+  // @return  path of the offloaded copy of `fname`, or empty string if
+  //          offloading is disabled or `fname` is not an SST file
+  std::string offloadedPath(const std::string& fname) const;
+
+  // If `fname` is an offloaded SST file, returns the path of its offloaded
+  // copy, otherwise returns `fname`.
+  std::string resolvePath(const std::string& fname);
+
+  rocksdb::Status deleteLocalFile(const std::string& fname);
+
   struct Callback {
     typedef void (*function_t)(void*);
     function_t function;
@@ -171,7 +209,8 @@ class RocksDBRandomAccessFile : public RocksDBRandomAccessFileWrapper {
   };
 
   RocksDBRandomAccessFile(const std::string& f,
-                          std::unique_ptr<rocksdb::RandomAccessFile> file);
+                          std::unique_ptr<rocksdb::RandomAccessFile> file,
+                          UpdateableSettings<RocksDBSettings> settings);
 
   rocksdb::Status Read(uint64_t offset,
                        size_t n,
@@ -182,6 +221,9 @@ class RocksDBRandomAccessFile : public RocksDBRandomAccessFileWrapper {
   const std::string file_name;
   mutable uint64_t file_offset;
   FileNameHash file_name_hash;
+
+ private:
+  UpdateableSettings<RocksDBSettings> settings_;
 };
 
 // A wrapper around rocksdb::WritableFile intended for WAL files.
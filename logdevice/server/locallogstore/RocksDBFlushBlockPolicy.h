@@ -43,13 +43,20 @@ class RocksDBFlushBlockPolicy : public rocksdb::FlushBlockPolicy {
         (g != cur_group_ && cur_block_bytes_ >= opts_.min_block_size) ||
         ((g.log == LOGID_INVALID) != (cur_group_.log == LOGID_INVALID) &&
          cur_block_bytes_ != 0)) {
-      STAT_INCR(opts_.stats, sst_blocks_written);
-      STAT_ADD(opts_.stats, sst_blocks_bytes, cur_block_bytes_);
+      bumpBlockStats();
       cur_group_ = g;
       cur_block_bytes_ = 0;
+      cur_block_logs_ = 0;
       ret = true;
     }
 
+    if (g.log != LOGID_INVALID &&
+        (cur_block_logs_ == 0 || g.log != last_log_)) {
+      // Keys are sorted by log, so each log has at most one run of records
+      // in the block.
+      ++cur_block_logs_;
+    }
+    last_log_ = g.log;
     cur_block_bytes_ += std::max(1ul, key.size() + value.size());
 
     return ret;
@@ -61,8 +68,7 @@ class RocksDBFlushBlockPolicy : public rocksdb::FlushBlockPolicy {
     if (cur_block_bytes_ == 0) {
       return;
     }
-    STAT_INCR(opts_.stats, sst_blocks_written);
-    STAT_ADD(opts_.stats, sst_blocks_bytes, cur_block_bytes_);
+    bumpBlockStats();
   }
 
  private:
@@ -80,8 +86,23 @@ class RocksDBFlushBlockPolicy : public rocksdb::FlushBlockPolicy {
   const Options opts_;
 
   size_t cur_block_bytes_ = 0;
+  // Number of different logs whose records are in the current block.
+  size_t cur_block_logs_ = 0;
+  // Log of the previous record passed to Update().
+  logid_t last_log_{LOGID_INVALID};
   Group cur_group_;
 
+  void bumpBlockStats() {
+    STAT_INCR(opts_.stats, sst_blocks_written);
+    STAT_ADD(opts_.stats, sst_blocks_bytes, cur_block_bytes_);
+    STAT_ADD(opts_.stats, sst_block_log_runs, cur_block_logs_);
+    if (cur_block_logs_ > 1) {
+      // A reader of any one of these logs also reads the others' records.
+      STAT_INCR(opts_.stats, sst_blocks_multi_log);
+      STAT_ADD(opts_.stats, sst_blocks_multi_log_bytes, cur_block_bytes_);
+    }
+  }
+
   Group getGroup(const rocksdb::Slice& key, const rocksdb::Slice& value) {
     Group g;
     if (!RocksDBKeyFormat::DataKey::valid(key.data(), key.size())) {
@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/locallogstore/RocksDBListener.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <set>
 
 #include <folly/Conv.h>
@@ -22,6 +24,12 @@ using namespace RocksDBKeyFormat;
 
 static const char* LOGS_OF_SIZE_PREFIX = "ld.logs_of_size.";
 static const char* BYTES_WITH_RETENTION_PREFIX = "ld.bytes_with_retention.";
+static const char* MIN_LOG_ID = "ld.min_log_id";
+static const char* MAX_LOG_ID = "ld.max_log_id";
+static const char* MIN_LSN = "ld.min_lsn";
+static const char* MAX_LSN = "ld.max_lsn";
+static const char* HAS_OTHER_KEYS = "ld.has_other_keys";
+static const char* LOG_IDS = "ld.log_ids";
 
 void RocksDBListener::OnTableFileCreated(
     const rocksdb::TableFileCreationInfo& info) {
@@ -104,12 +112,30 @@ RocksDBTablePropertiesCollector::AddUserKey(const rocksdb::Slice& key,
                                             uint64_t /*file_size*/) {
   size_t key_value_size = key.size() + value.size();
 
+  if (DataKey::valid(key.data(), key.size())) {
+    logid_t log = DataKey::getLogID(key.data());
+    lsn_t lsn = DataKey::getLSN(key.data());
+    if (!record_range_.hasValue()) {
+      record_range_ = RecordRange{log, log, lsn, lsn, false};
+    } else {
+      record_range_->min_log_id = std::min(record_range_->min_log_id, log);
+      record_range_->max_log_id = std::max(record_range_->max_log_id, log);
+      record_range_->min_lsn = std::min(record_range_->min_lsn, lsn);
+      record_range_->max_lsn = std::max(record_range_->max_lsn, lsn);
+    }
+    noteLogID(log);
+  } else {
+    has_other_keys_ = true;
+  }
+
   if (IndexKey::valid(key.data(), key.size())) {
+    noteLogID(IndexKey::getLogID(key.data()));
     data_size_per_kind_[(int)DataKind::INDEX] += key_value_size;
     return rocksdb::Status::OK();
   }
 
   if (CopySetIndexKey::valid(key.data(), key.size())) {
+    noteLogID(CopySetIndexKey::getLogID(key.data()));
     data_size_per_kind_[(int)DataKind::CSI] += key_value_size;
     return rocksdb::Status::OK();
   }
@@ -242,6 +268,40 @@ rocksdb::Status RocksDBTablePropertiesCollector::Finish(
   return rocksdb::Status::OK();
 }
 
+void RocksDBTablePropertiesCollector::noteLogID(logid_t log) {
+  if (log_ids_.empty() || log_ids_.back() != log) {
+    log_ids_.push_back(log);
+  }
+}
+
+std::string RocksDBTablePropertiesCollector::logIDRanges() const {
+  std::vector<logid_t> logs = log_ids_;
+  std::sort(logs.begin(), logs.end());
+  logs.erase(std::unique(logs.begin(), logs.end()), logs.end());
+
+  std::string res;
+  size_t num_ranges = 0;
+  for (size_t i = 0; i < logs.size();) {
+    size_t j = i;
+    while (j + 1 < logs.size() && logs[j + 1].val_ == logs[j].val_ + 1) {
+      ++j;
+    }
+    if (++num_ranges > MAX_LOG_ID_RANGES) {
+      return "";
+    }
+    if (!res.empty()) {
+      res += ',';
+    }
+    res += std::to_string(logs[i].val_);
+    if (j != i) {
+      res += '-';
+      res += std::to_string(logs[j].val_);
+    }
+    i = j + 1;
+  }
+  return res;
+}
+
 void RocksDBTablePropertiesCollector::flushCurrentLog() {
   if (current_size_ == 0) {
     return;
@@ -277,9 +337,93 @@ RocksDBTablePropertiesCollector::GetReadableProperties() const {
         std::to_string(data_size_per_kind_[kind]);
   }
 
+  if (record_range_.hasValue()) {
+    res[MIN_LOG_ID] = std::to_string(record_range_->min_log_id.val_);
+    res[MAX_LOG_ID] = std::to_string(record_range_->max_log_id.val_);
+    res[MIN_LSN] = std::to_string(record_range_->min_lsn);
+    res[MAX_LSN] = std::to_string(record_range_->max_lsn);
+    res[HAS_OTHER_KEYS] = has_other_keys_ ? "1" : "0";
+  }
+
+  std::string log_ids = logIDRanges();
+  if (!log_ids.empty()) {
+    res[LOG_IDS] = std::move(log_ids);
+  }
+
   return res;
 }
 
+folly::Optional<RocksDBTablePropertiesCollector::RecordRange>
+RocksDBTablePropertiesCollector::extractRecordRange(
+    const std::map<std::string, std::string>& table_properties) {
+  auto get = [&](const char* name) -> folly::Optional<uint64_t> {
+    auto it = table_properties.find(name);
+    if (it == table_properties.end()) {
+      return folly::none;
+    }
+    try {
+      return folly::to<uint64_t>(it->second);
+    } catch (std::range_error&) {
+      ld_warning("Invalid value in table properties for %s: %s",
+                 name,
+                 it->second.c_str());
+      return folly::none;
+    }
+  };
+
+  auto min_log_id = get(MIN_LOG_ID);
+  auto max_log_id = get(MAX_LOG_ID);
+  auto min_lsn = get(MIN_LSN);
+  auto max_lsn = get(MAX_LSN);
+  auto has_other_keys = get(HAS_OTHER_KEYS);
+  if (!min_log_id || !max_log_id || !min_lsn || !max_lsn || !has_other_keys) {
+    return folly::none;
+  }
+  return RecordRange{logid_t(min_log_id.value()),
+                     logid_t(max_log_id.value()),
+                     min_lsn.value(),
+                     max_lsn.value(),
+                     has_other_keys.value() != 0};
+}
+
+bool RocksDBTablePropertiesCollector::mayContainLog(
+    const std::map<std::string, std::string>& table_properties,
+    logid_t log_id) {
+  auto it = table_properties.find(LOG_IDS);
+  if (it == table_properties.end()) {
+    return true;
+  }
+  // Ranges are sorted, stop at the first one that ends at or after log_id.
+  const char* p = it->second.c_str();
+  while (*p != '\0') {
+    char* end;
+    const uint64_t from = strtoull(p, &end, 10);
+    uint64_t to = from;
+    if (end == p) {
+      // Malformed.
+      return true;
+    }
+    p = end;
+    if (*p == '-') {
+      ++p;
+      to = strtoull(p, &end, 10);
+      if (end == p) {
+        return true;
+      }
+      p = end;
+    }
+    if (log_id.val_ <= to) {
+      return log_id.val_ >= from;
+    }
+    if (*p == ',') {
+      ++p;
+    } else if (*p != '\0') {
+      return true;
+    }
+  }
+  return false;
+}
+
 void RocksDBTablePropertiesCollector::extractRetentionSizeMap(
     const std::map<std::string, std::string>& table_properties,
     RetentionSizeMap& inout_map) {
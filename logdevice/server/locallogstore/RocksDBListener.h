@@ -8,7 +8,9 @@
 #pragma once
 
 #include <queue>
+#include <vector>
 
+#include <folly/Optional.h>
 #include <folly/ThreadLocal.h>
 #include <rocksdb/listener.h>
 #include <rocksdb/version.h>
@@ -27,7 +29,14 @@ namespace facebook { namespace logdevice {
  *  - the histogram of the amount of data each log has in table file,
  *  - the amount of data for each backlog duration in each table file; this
  *    is used by RocksDBLocalLogStore to estimate the amount of space a
- *    compaction can reclaim.
+ *    compaction can reclaim,
+ *  - the range of log ids and LSNs of records in each table file; this is
+ *    used by PartitionedRocksDBStore to find files of the unpartitioned
+ *    column family that only contain trimmed records and can be deleted
+ *    without compacting them,
+ *  - the set of logs that have records, CSI entries or findTime/findKey index
+ *    entries in each table file; used by single-log iterators to skip table
+ *    files without opening their index and filter blocks.
  * Note that rocksdb allows registering multiple listeners, and RocksDBListener
  * is not the only one used by logdevice.
  */
@@ -75,6 +84,36 @@ class RocksDBTablePropertiesCollector
       const std::map<std::string, std::string>& table_properties,
       RetentionSizeMap& inout_map);
 
+  // Range of records (DataKeys) in a table file.
+  struct RecordRange {
+    logid_t min_log_id;
+    logid_t max_log_id;
+    // min and max LSN of records of any log in the file
+    lsn_t min_lsn;
+    lsn_t max_lsn;
+    // true if the file also has keys other than DataKeys, e.g. copyset
+    // index, findTime index or metadata
+    bool has_other_keys;
+  };
+
+  // Parses the properties with the record range of a table file. Returns
+  // folly::none if the file has no records or was written without these
+  // properties.
+  static folly::Optional<RecordRange> extractRecordRange(
+      const std::map<std::string, std::string>& table_properties);
+
+  // The set of logs is written as ranges of consecutive log ids, e.g.
+  // "1-10,15,20-21". Files with more than this number of ranges don't get the
+  // property; for them, rocksdb bloom filters do the job.
+  static constexpr size_t MAX_LOG_ID_RANGES = 256;
+
+  // Returns false if the properties say that the table file has no keys of
+  // the given log. Returns true otherwise, including if the file was written
+  // without the set of logs.
+  static bool mayContainLog(
+      const std::map<std::string, std::string>& table_properties,
+      logid_t log_id);
+
  private:
   enum class DataKind {
     PAYLOAD = 0,
@@ -101,6 +140,18 @@ class RocksDBTablePropertiesCollector
   // Approximate number of bytes used for various types of data.
   std::array<size_t, (int)DataKind::MAX> data_size_per_kind_{};
 
+  // Range of records seen so far, see RecordRange.
+  folly::Optional<RecordRange> record_range_;
+  bool has_other_keys_ = false;
+
+  // Logs that have keys in the file, in the order they were seen. Keys of the
+  // same type are sorted by log, so a log only appears once per key type.
+  std::vector<logid_t> log_ids_;
+  void noteLogID(logid_t log);
+
+  // "1-10,15,20-21", or empty if there are more than MAX_LOG_ID_RANGES ranges.
+  std::string logIDRanges() const;
+
   static DataKindNamesEnumMap& dataKindNames();
 
   void flushCurrentLog();
@@ -1009,6 +1009,10 @@ RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator::CopySetIndexIterator(
   }
   rocks_options_ = translateReadOptions(
       parent_->read_opts_, parent_->log_id_.hasValue(), &upper_bound_);
+  if (parent_->log_id_.hasValue()) {
+    parent_->getRocksDBStore()->setTableFilterForLog(
+        rocks_options_, parent_->log_id_.value());
+  }
   registerTracking(parent_->cf_->GetName(),
                    parent_->log_id_.value_or(LOGID_INVALID),
                    rocks_options_.tailing,
@@ -1248,6 +1252,10 @@ RocksDBLocalLogStore::CSIWrapper::DataIterator::DataIterator(
       rocks_options_(translateReadOptions(parent_->read_opts_,
                                           parent_->log_id_.hasValue(),
                                           &upper_bound_.upper_bound)) {
+  if (parent_->log_id_.hasValue()) {
+    parent_->getRocksDBStore()->setTableFilterForLog(
+        rocks_options_, parent_->log_id_.value());
+  }
   registerTracking(parent_->cf_->GetName(),
                    parent_->log_id_.value_or(LOGID_INVALID),
                    rocks_options_.tailing,
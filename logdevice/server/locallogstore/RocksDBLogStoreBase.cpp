@@ -7,10 +7,14 @@
  */
 #include "logdevice/server/locallogstore/RocksDBLogStoreBase.h"
 
+#include <thread>
+
 #include <rocksdb/iostats_context.h>
 
 #include "logdevice/common/stats/PerShardHistograms.h"
+#include "logdevice/server/locallogstore/RocksDBListener.h"
 #include "logdevice/server/locallogstore/RocksDBMemTableRep.h"
+#include "logdevice/server/locallogstore/RocksDBPerLogMemTableRep.h"
 #include "logdevice/server/locallogstore/RocksDBSettings.h"
 #include "logdevice/server/locallogstore/RocksDBWriter.h"
 
@@ -126,10 +130,18 @@ int RocksDBLogStoreBase::isCFEmpty(rocksdb::ColumnFamilyHandle* cf) const {
 
 void RocksDBLogStoreBase::installMemTableRep() {
   auto create_memtable_factory = [this]() {
-    mtr_factory_ = std::make_shared<RocksDBMemTableRepFactory>(
-        this,
+    std::unique_ptr<rocksdb::MemTableRepFactory> factory =
         std::make_unique<rocksdb::SkipListFactory>(
-            getSettings()->skip_list_lookahead));
+            getSettings()->skip_list_lookahead);
+    if (getSettings()->memtable_rep ==
+        RocksDBSettings::MemTableRepType::PER_LOG) {
+      factory =
+          std::make_unique<RocksDBPerLogMemTableRepFactory>(std::move(factory));
+      // RocksDBPerLogMemTableRep doesn't support concurrent inserts.
+      rocksdb_config_.options_.allow_concurrent_memtable_write = false;
+    }
+    mtr_factory_ = std::make_shared<RocksDBMemTableRepFactory>(
+        this, std::move(factory));
   };
 
   if (!rocksdb_config_.options_.memtable_factory) {
@@ -284,6 +296,89 @@ void RocksDBLogStoreBase::throttleIOIfNeeded(WriteBufStats buf_stats,
   }
 }
 
+void RocksDBLogStoreBase::updateWritePacingRate(WriteBufStats buf_stats,
+                                                uint64_t memory_limit) {
+  if (!getSettings()->write_pacing) {
+    pacing_rate_.store(0);
+    pacing_overloaded_.store(false);
+    return;
+  }
+
+  // Estimate how fast flushes drain memtables: whatever was written since
+  // the previous call and didn't make memtables bigger was flushed.
+  const auto now = SteadyTimestamp::now();
+  const uint64_t usage =
+      buf_stats.active_memory_usage + buf_stats.memory_being_flushed;
+  const uint64_t written = total_bytes_written_.load();
+  if (pacing_eval_time_ != SteadyTimestamp::min()) {
+    const double dt = to_sec_double(now - pacing_eval_time_);
+    if (dt > 0) {
+      const double drained = double(written - pacing_eval_bytes_written_) -
+          (double(usage) - double(pacing_eval_memory_usage_));
+      const double sample = std::max(0., drained / dt);
+      drain_rate_avg_ = drain_rate_avg_ == 0
+          ? sample
+          : 0.8 * drain_rate_avg_ + 0.2 * sample;
+    }
+  }
+  pacing_eval_time_ = now;
+  pacing_eval_bytes_written_ = written;
+  pacing_eval_memory_usage_ = usage;
+
+  // Below half of the limit writes are not paced. Between half and the full
+  // limit (where writes get rejected) the allowed rate goes down linearly
+  // from twice the flush rate to zero, so that it matches the flush rate in
+  // the middle of that range.
+  const uint64_t low = memory_limit / 2;
+  if (usage <= low || memory_limit <= low || drain_rate_avg_ <= 0) {
+    pacing_rate_.store(0);
+    pacing_overloaded_.store(false);
+    return;
+  }
+  const double x =
+      std::min(1., double(usage - low) / double(memory_limit - low));
+  const double min_rate = 1e6;
+  const double rate = std::max(min_rate, drain_rate_avg_ * 2 * (1 - x));
+  pacing_rate_.store(rate);
+  pacing_overloaded_.store(x > .5);
+  PER_SHARD_STAT_SET(
+      stats_, write_pacing_rate, shard_idx_, static_cast<int64_t>(rate));
+}
+
+void RocksDBLogStoreBase::paceWrite(size_t bytes) {
+  const double rate = pacing_rate_.load();
+  if (rate <= 0) {
+    return;
+  }
+
+  double wait_sec;
+  {
+    std::lock_guard<std::mutex> lock(pacing_mutex_);
+    auto now = SteadyTimestamp::now();
+    if (pacing_refill_time_ != SteadyTimestamp::min()) {
+      pacing_tokens_ += rate * to_sec_double(now - pacing_refill_time_);
+    }
+    pacing_refill_time_ = now;
+    // Allow bursts of up to 100ms worth of writes.
+    pacing_tokens_ = std::min(pacing_tokens_, rate * .1);
+    pacing_tokens_ -= bytes;
+    if (pacing_tokens_ >= 0) {
+      return;
+    }
+    wait_sec = -pacing_tokens_ / rate;
+  }
+
+  // Don't hold a storage thread for too long in one go; if writers keep
+  // outpacing the rate, the bucket stays in debt and the next writes wait
+  // too. Memtable limits still reject writes if that's not enough.
+  auto wait = std::min(
+      std::chrono::microseconds(static_cast<int64_t>(wait_sec * 1e6)),
+      std::chrono::microseconds(std::chrono::milliseconds(100)));
+  PER_SHARD_STAT_ADD(stats_, write_pacing_microsec, shard_idx_, wait.count());
+  /* sleep override */
+  std::this_thread::sleep_for(wait);
+}
+
 void RocksDBLogStoreBase::disableWriteStalling() {
   {
     std::lock_guard<std::mutex> lock(throttle_state_mutex_);
@@ -343,6 +438,7 @@ rocksdb::ReadOptions RocksDBLogStoreBase::translateReadOptions(
       : RocksDBLogStoreBase::getDefaultReadOptions();
 
   rocks_options.fill_cache = opts.fill_cache;
+  rocks_options.readahead_size = opts.readahead_size;
   rocks_options.read_tier =
       opts.allow_blocking_io ? rocksdb::kReadAllTier : rocksdb::kBlockCacheTier;
 
@@ -360,6 +456,23 @@ rocksdb::ReadOptions RocksDBLogStoreBase::translateReadOptions(
   return rocks_options;
 }
 
+void RocksDBLogStoreBase::setTableFilterForLog(rocksdb::ReadOptions& options,
+                                               logid_t log_id) const {
+  if (!getSettings()->skip_sst_files_without_log) {
+    return;
+  }
+  StatsHolder* stats = getStatsHolder();
+  options.table_filter = [stats,
+                          log_id](const rocksdb::TableProperties& props) {
+    if (RocksDBTablePropertiesCollector::mayContainLog(
+            props.user_collected_properties, log_id)) {
+      return true;
+    }
+    STAT_INCR(stats, sst_files_skipped_by_log_filter);
+    return false;
+  };
+}
+
 int RocksDBLogStoreBase::syncWAL() {
   rocksdb::Status status = writer_->syncWAL();
   if (!status.ok()) {
@@ -476,6 +589,8 @@ RocksDBLogStoreBase::writeBatch(const rocksdb::WriteOptions& options,
   using IOType = IOFaultInjection::IOType;
   using FaultType = IOFaultInjection::FaultType;
 
+  total_bytes_written_.fetch_add(batch->GetDataSize());
+
   auto* perf_context = rocksdb::get_perf_context();
   auto* iostats_context = rocksdb::get_iostats_context();
   uint64_t wal_start = perf_context->write_wal_time;
@@ -341,6 +341,13 @@ class RocksDBLogStoreBase : public LocalLogStore {
                        bool single_log,
                        rocksdb::Slice* upper_bound);
 
+  // Sets rocksdb::ReadOptions::table_filter to skip sst files that have no
+  // keys of the given log, according to the set of logs recorded in their
+  // table properties by RocksDBTablePropertiesCollector. Only use for
+  // iterators that only need keys of this log.
+  void setTableFilterForLog(rocksdb::ReadOptions& options,
+                            logid_t log_id) const;
+
   // Default implementation of metadata operations. Thin wrappers around
   // RocksDBWriter methods.
   // The separation between RocksDBWriter and RocksDBLogStoreBase is unclear;
@@ -407,6 +414,16 @@ class RocksDBLogStoreBase : public LocalLogStore {
     return write_throttle_state_.load();
   }
 
+  // Recalculates the allowed write rate for --rocksdb-write-pacing. Should be
+  // called periodically with the current memtable stats.
+  void updateWritePacingRate(WriteBufStats buf_stats, uint64_t memory_limit);
+
+  void paceWrite(size_t bytes) override;
+
+  bool isPacingWrites() const override {
+    return pacing_overloaded_.load();
+  }
+
   // A wrapper around rocksdb::DB::Write() which also updates stats and injects
   // IO errors if needed. Subclasses can override it to add some hooks to all
   // rocksdb writes.
@@ -600,6 +617,27 @@ class RocksDBLogStoreBase : public LocalLogStore {
   // When write_throttle_state_ was recalculated.
   SteadyTimestamp last_throttle_update_time_{SteadyTimestamp::min()};
 
+  // Proportional write pacing, see updateWritePacingRate().
+
+  // Allowed write rate in bytes per second. 0 means unlimited.
+  std::atomic<double> pacing_rate_{0};
+  // Whether pacing_rate_ is below the estimated flush rate.
+  std::atomic<bool> pacing_overloaded_{false};
+  // Bytes passed to writeBatch() since startup.
+  std::atomic<uint64_t> total_bytes_written_{0};
+  // Token bucket of paceWrite(), in bytes. Negative when writers have to
+  // wait. Protected by pacing_mutex_.
+  std::mutex pacing_mutex_;
+  double pacing_tokens_{0};
+  SteadyTimestamp pacing_refill_time_{SteadyTimestamp::min()};
+  // State of the previous updateWritePacingRate() call, for estimating how
+  // fast flushes drain memtables. Only accessed by the thread calling
+  // updateWritePacingRate().
+  SteadyTimestamp pacing_eval_time_{SteadyTimestamp::min()};
+  uint64_t pacing_eval_bytes_written_{0};
+  uint64_t pacing_eval_memory_usage_{0};
+  double drain_rate_avg_{0};
+
   // Installs a MemTableRepFactory so that LogDevice's MemTabelRep is
   // used when constructing all MemTables.
   void installMemTableRep();
@@ -7,9 +7,11 @@
  */
 #include "logdevice/server/locallogstore/RocksDBLogStoreConfig.h"
 
+#include <folly/Format.h>
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/options.h>
+#include <rocksdb/persistent_cache.h>
 #include <rocksdb/slice_transform.h>
 #include <rocksdb/sst_file_manager.h>
 #include <rocksdb/statistics.h>
@@ -28,6 +30,21 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+// Filter over the prefix of keys that identifies the log (see
+// options_.prefix_extractor), bloom or ribbon depending on settings.
+const rocksdb::FilterPolicy* newFilterPolicy(const RocksDBSettings& settings,
+                                             int bits_per_key) {
+#ifdef LOGDEVICE_ROCKSDB_HAS_RIBBON_FILTER
+  if (settings.ribbon_filter_ && !settings.bloom_block_based_) {
+    return rocksdb::NewRibbonFilterPolicy(bits_per_key);
+  }
+#endif
+  return rocksdb::NewBloomFilterPolicy(
+      bits_per_key, settings.bloom_block_based_);
+}
+} // namespace
+
 RocksDBLogStoreConfig::RocksDBLogStoreConfig(
     UpdateableSettings<RocksDBSettings> rocksdb_settings,
     UpdateableSettings<RebuildingSettings> rebuilding_settings,
@@ -110,9 +127,8 @@ RocksDBLogStoreConfig::RocksDBLogStoreConfig(
       rocksdb_settings_->read_amp_bytes_per_bit_;
 
   if (rocksdb_settings_->bloom_bits_per_key_ > 0) {
-    table_options_.filter_policy.reset(
-        rocksdb::NewBloomFilterPolicy(rocksdb_settings_->bloom_bits_per_key_,
-                                      rocksdb_settings_->bloom_block_based_));
+    table_options_.filter_policy.reset(newFilterPolicy(
+        *rocksdb_settings_.get(), rocksdb_settings_->bloom_bits_per_key_));
   }
 
   options_.table_factory.reset(
@@ -154,9 +170,8 @@ RocksDBLogStoreConfig::RocksDBLogStoreConfig(
       changed = true;
       if (rocksdb_settings_->metadata_bloom_bits_per_key_ > 0) {
         metadata_table_options_.filter_policy.reset(
-            rocksdb::NewBloomFilterPolicy(
-                rocksdb_settings_->metadata_bloom_bits_per_key_,
-                rocksdb_settings_->bloom_block_based_));
+            newFilterPolicy(*rocksdb_settings_.get(),
+                            rocksdb_settings_->metadata_bloom_bits_per_key_));
       } else {
         metadata_table_options_.filter_policy = nullptr;
       }
@@ -246,4 +261,49 @@ void RocksDBLogStoreConfig::addSstFileManagerForShard() {
   }
 }
 
+void RocksDBLogStoreConfig::addPersistentCacheForShard(
+    shard_index_t this_shard) {
+  const std::string& base_path = rocksdb_settings_->persistent_cache_path_;
+  if (base_path.empty()) {
+    return;
+  }
+  if (!options_.env) {
+    ld_error("Can't create persistent cache: no env");
+    return;
+  }
+
+  const std::string path = folly::sformat("{}/shard{}", base_path, this_shard);
+  rocksdb::Status status = options_.env->CreateDirIfMissing(base_path);
+  if (status.ok()) {
+    status = options_.env->CreateDirIfMissing(path);
+  }
+
+  std::shared_ptr<rocksdb::PersistentCache> cache;
+  if (status.ok()) {
+    std::shared_ptr<rocksdb::Logger> logger =
+        std::make_shared<RocksDBLogger>(dbg::currentLevel);
+    status = rocksdb::NewPersistentCache(
+        options_.env,
+        path,
+        rocksdb_settings_->persistent_cache_size_per_shard_,
+        std::move(logger),
+        /* optimized_for_nvm */ true,
+        &cache);
+  }
+  if (!status.ok()) {
+    // Not fatal, the shard just runs without the secondary cache.
+    ld_error("Failed to create persistent cache for shard %d in %s: %s",
+             this_shard,
+             path.c_str(),
+             status.ToString().c_str());
+    return;
+  }
+
+  // Only data column families get the persistent cache; metadata is small
+  // and is read through metadata_table_options_.
+  table_options_.persistent_cache = std::move(cache);
+  options_.table_factory.reset(
+      rocksdb::NewBlockBasedTableFactory(table_options_));
+}
+
 }} // namespace facebook::logdevice
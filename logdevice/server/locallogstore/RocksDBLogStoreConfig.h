@@ -89,6 +89,11 @@ struct RocksDBLogStoreConfig {
   // Create an SstFileManager, used to ratelimit deletes. This should only be
   // called on a copy that has been created for a particular shard.
   void addSstFileManagerForShard();
+
+  // Create the persistent block cache of a shard, if
+  // --rocksdb-persistent-cache-path is set. Like addSstFileManagerForShard(),
+  // this should only be called on a copy created for a particular shard.
+  void addPersistentCacheForShard(shard_index_t this_shard);
 };
 
 }} // namespace facebook::logdevice
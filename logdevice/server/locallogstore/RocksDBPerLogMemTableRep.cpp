@@ -0,0 +1,301 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/RocksDBPerLogMemTableRep.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+// Rough size of a node of runs_ plus a node of index_.
+static constexpr size_t RUN_OVERHEAD_BYTES = 160;
+
+class RocksDBPerLogMemTableRep::Iterator
+    : public rocksdb::MemTableRep::Iterator {
+ public:
+  Iterator(RocksDBPerLogMemTableRep* rep, bool pooled)
+      : rep_(rep), pooled_(pooled), run_(rep->runs_.end()) {}
+
+  ~Iterator() override {
+    if (pooled_) {
+      rep_->releaseIteratorStorage(this);
+    }
+  }
+
+  bool Valid() const override {
+    return entry_ != nullptr;
+  }
+
+  const char* key() const override {
+    ld_check(Valid());
+    return entry_;
+  }
+
+  void Next() override {
+    ld_check(Valid());
+    auto lock = rep_->lockShared();
+    locate();
+    if (++pos_ < run_->second.size()) {
+      entry_ = run_->second[pos_];
+      return;
+    }
+    ++run_;
+    setToFrontOfRun();
+  }
+
+  void Prev() override {
+    ld_check(Valid());
+    auto lock = rep_->lockShared();
+    locate();
+    if (pos_ > 0) {
+      entry_ = run_->second[--pos_];
+      return;
+    }
+    if (run_ == rep_->runs_.begin()) {
+      entry_ = nullptr;
+      return;
+    }
+    --run_;
+    pos_ = run_->second.size() - 1;
+    entry_ = run_->second[pos_];
+  }
+
+  void Seek(const rocksdb::Slice& internal_key,
+            const char* /* memtable_key */) override {
+    auto lock = rep_->lockShared();
+    rocksdb::Slice prefix = rep_->prefixOfInternalKey(internal_key);
+    run_ = rep_->runs_.lower_bound(prefix.ToString());
+    if (run_ != rep_->runs_.end() && rocksdb::Slice(run_->first) == prefix) {
+      const Run& run = run_->second;
+      pos_ = std::lower_bound(run.begin(),
+                              run.end(),
+                              internal_key,
+                              [this](const char* a, const rocksdb::Slice& b) {
+                                return rep_->cmp_(a, b) < 0;
+                              }) -
+          run.begin();
+      if (pos_ < run.size()) {
+        entry_ = run[pos_];
+        return;
+      }
+      ++run_;
+    }
+    setToFrontOfRun();
+  }
+
+  void SeekForPrev(const rocksdb::Slice& internal_key,
+                   const char* memtable_key) override {
+    Seek(internal_key, memtable_key);
+    if (!Valid()) {
+      SeekToLast();
+    } else if (rep_->cmp_(entry_, internal_key) > 0) {
+      Prev();
+    }
+  }
+
+  void SeekToFirst() override {
+    auto lock = rep_->lockShared();
+    run_ = rep_->runs_.begin();
+    setToFrontOfRun();
+  }
+
+  void SeekToLast() override {
+    auto lock = rep_->lockShared();
+    if (rep_->runs_.empty()) {
+      entry_ = nullptr;
+      return;
+    }
+    run_ = std::prev(rep_->runs_.end());
+    pos_ = run_->second.size() - 1;
+    entry_ = run_->second[pos_];
+  }
+
+ private:
+  RocksDBPerLogMemTableRep* rep_;
+  const bool pooled_;
+
+  // Current entry, nullptr if not valid.
+  const char* entry_ = nullptr;
+  RunMap::const_iterator run_;
+  // Index of entry_ in its run, as of when we last looked. Out of order
+  // inserts may have shifted it since then, see locate().
+  size_t pos_ = 0;
+
+  // Updates pos_ to point to entry_. Requires the lock.
+  void locate() {
+    const Run& run = run_->second;
+    if (pos_ < run.size() && run[pos_] == entry_) {
+      return;
+    }
+    pos_ = std::lower_bound(run.begin(),
+                            run.end(),
+                            entry_,
+                            [this](const char* a, const char* b) {
+                              return rep_->cmp_(a, b) < 0;
+                            }) -
+        run.begin();
+    ld_check(pos_ < run.size() && run[pos_] == entry_);
+  }
+
+  // Moves to the first entry of run_. Requires the lock.
+  void setToFrontOfRun() {
+    if (run_ == rep_->runs_.end()) {
+      entry_ = nullptr;
+      return;
+    }
+    // Runs are never empty.
+    ld_check(!run_->second.empty());
+    pos_ = 0;
+    entry_ = run_->second[0];
+  }
+};
+
+RocksDBPerLogMemTableRep::RocksDBPerLogMemTableRep(
+    const rocksdb::MemTableRep::KeyComparator& cmp,
+    rocksdb::Allocator* allocator,
+    const rocksdb::SliceTransform* prefix_extractor)
+    : rocksdb::MemTableRep(allocator),
+      cmp_(cmp),
+      prefix_extractor_(prefix_extractor),
+      last_run_(runs_.end()) {
+  ld_check(prefix_extractor_ != nullptr);
+}
+
+RocksDBPerLogMemTableRep::~RocksDBPerLogMemTableRep() {
+  // rocksdb destroys all iterators before the memtable.
+  ld_check(free_iterator_storage_.size() == iterator_storage_.size());
+}
+
+rocksdb::Slice
+RocksDBPerLogMemTableRep::prefixOfEntry(const char* entry) const {
+  return prefix_extractor_->Transform(UserKey(entry));
+}
+
+rocksdb::Slice RocksDBPerLogMemTableRep::prefixOfInternalKey(
+    const rocksdb::Slice& internal_key) const {
+  // Internal key is the user key followed by 8 bytes of sequence number and
+  // type.
+  ld_check(internal_key.size() >= 8);
+  return prefix_extractor_->Transform(
+      rocksdb::Slice(internal_key.data(), internal_key.size() - 8));
+}
+
+folly::SharedMutex::ReadHolder RocksDBPerLogMemTableRep::lockShared() const {
+  return folly::SharedMutex::ReadHolder(
+      read_only_.load(std::memory_order_acquire) ? nullptr : &mutex_);
+}
+
+const RocksDBPerLogMemTableRep::Run*
+RocksDBPerLogMemTableRep::findRun(const rocksdb::Slice& prefix) const {
+  auto it = index_.find(std::string(prefix.data(), prefix.size()));
+  return it == index_.end() ? nullptr : &it->second->second;
+}
+
+void RocksDBPerLogMemTableRep::Insert(rocksdb::KeyHandle handle) {
+  const char* entry = static_cast<const char*>(handle);
+  rocksdb::Slice prefix = prefixOfEntry(entry);
+
+  folly::SharedMutex::WriteHolder lock(mutex_);
+  ld_check(!read_only_.load());
+
+  if (last_run_ == runs_.end() || rocksdb::Slice(last_run_->first) != prefix) {
+    std::string key(prefix.data(), prefix.size());
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      last_run_ = it->second;
+    } else {
+      last_run_ = runs_.emplace(key, Run()).first;
+      index_.emplace(std::move(key), last_run_);
+      memory_usage_ += RUN_OVERHEAD_BYTES;
+    }
+  }
+
+  Run& run = last_run_->second;
+  const size_t capacity_before = run.capacity();
+  if (run.empty() || cmp_(run.back(), entry) < 0) {
+    // Fast path: the new entry goes after all entries of its log.
+    run.push_back(entry);
+  } else {
+    auto pos = std::upper_bound(
+        run.begin(), run.end(), entry, [this](const char* a, const char* b) {
+          return cmp_(a, b) < 0;
+        });
+    run.insert(pos, entry);
+  }
+  memory_usage_ += (run.capacity() - capacity_before) * sizeof(const char*);
+}
+
+bool RocksDBPerLogMemTableRep::Contains(const char* key) const {
+  rocksdb::Slice prefix = prefixOfEntry(key);
+  auto lock = lockShared();
+  const Run* run = findRun(prefix);
+  if (run == nullptr) {
+    return false;
+  }
+  auto pos = std::lower_bound(
+      run->begin(), run->end(), key, [this](const char* a, const char* b) {
+        return cmp_(a, b) < 0;
+      });
+  return pos != run->end() && cmp_(*pos, key) == 0;
+}
+
+void RocksDBPerLogMemTableRep::MarkReadOnly() {
+  folly::SharedMutex::WriteHolder lock(mutex_);
+  read_only_.store(true, std::memory_order_release);
+}
+
+size_t RocksDBPerLogMemTableRep::ApproximateMemoryUsage() {
+  return memory_usage_.load();
+}
+
+rocksdb::MemTableRep::Iterator*
+RocksDBPerLogMemTableRep::GetIterator(rocksdb::Arena* arena) {
+  if (arena == nullptr) {
+    return new Iterator(this, /* pooled */ false);
+  }
+  return new (allocateIteratorStorage()) Iterator(this, /* pooled */ true);
+}
+
+void* RocksDBPerLogMemTableRep::allocateIteratorStorage() {
+  std::lock_guard<std::mutex> lock(iterator_storage_mutex_);
+  if (!free_iterator_storage_.empty()) {
+    void* storage = free_iterator_storage_.back();
+    free_iterator_storage_.pop_back();
+    return storage;
+  }
+  iterator_storage_.emplace_back(new char[sizeof(Iterator)]);
+  memory_usage_ += sizeof(Iterator);
+  return iterator_storage_.back().get();
+}
+
+void RocksDBPerLogMemTableRep::releaseIteratorStorage(void* storage) {
+  std::lock_guard<std::mutex> lock(iterator_storage_mutex_);
+  free_iterator_storage_.push_back(storage);
+}
+
+rocksdb::MemTableRep* RocksDBPerLogMemTableRepFactory::CreateMemTableRep(
+    const rocksdb::MemTableRep::KeyComparator& cmp,
+    rocksdb::Allocator* allocator,
+    const rocksdb::SliceTransform* prefix_extractor,
+    rocksdb::Logger* logger) {
+  // Runs are ordered by prefix, which is only the order of keys if the
+  // prefix is the first N bytes of the key (and the comparator is bytewise,
+  // which is always the case in LogDevice).
+  static const char* CAPPED_PREFIX = "rocksdb.CappedPrefix.";
+  if (prefix_extractor != nullptr &&
+      strncmp(prefix_extractor->Name(),
+              CAPPED_PREFIX,
+              strlen(CAPPED_PREFIX)) == 0) {
+    return new RocksDBPerLogMemTableRep(cmp, allocator, prefix_extractor);
+  }
+  return fallback_->CreateMemTableRep(cmp, allocator, prefix_extractor, logger);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/SharedMutex.h>
+#include <rocksdb/memtablerep.h>
+#include <rocksdb/slice_transform.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A MemTableRep that keeps a sorted vector of entries for each key
+ *       prefix (i.e. for each log, see the prefix extractor installed by
+ *       RocksDBLogStoreConfig), instead of a single skiplist.
+ *
+ *       Records of a log are mostly written in LSN order, so in the common
+ *       case an insert is a hash lookup, one key comparison and a push_back.
+ *       Out of order inserts (e.g. a newer wave of an old record, or
+ *       rebuilding) fall back to a binary search and vector insert within the
+ *       log's run only.
+ *
+ *       Iteration is in key order: runs are ordered by prefix, which, with a
+ *       bytewise comparator and a capped prefix extractor, is the order of
+ *       the keys themselves. A flush just walks the runs one after another.
+ *
+ *       Unlike the skiplist, readers take a shared lock while the memtable is
+ *       mutable. Once the memtable is marked read-only (e.g. while it's
+ *       being flushed) reads don't lock. Concurrent inserts are not
+ *       supported.
+ */
+
+class RocksDBPerLogMemTableRep : public rocksdb::MemTableRep {
+ public:
+  RocksDBPerLogMemTableRep(const rocksdb::MemTableRep::KeyComparator& cmp,
+                           rocksdb::Allocator* allocator,
+                           const rocksdb::SliceTransform* prefix_extractor);
+
+  ~RocksDBPerLogMemTableRep() override;
+
+  void Insert(rocksdb::KeyHandle handle) override;
+
+  bool Contains(const char* key) const override;
+
+  void MarkReadOnly() override;
+
+  // Get() uses the default implementation, which seeks an iterator.
+
+  size_t ApproximateMemoryUsage() override;
+
+  rocksdb::MemTableRep::Iterator*
+  GetIterator(rocksdb::Arena* arena = nullptr) override;
+
+ private:
+  class Iterator;
+
+  // Entries with the same prefix, sorted by comparator.
+  using Run = std::vector<const char*>;
+  // Ordered by prefix. Nodes of std::map are stable, so iterators and index_
+  // can point to them.
+  using RunMap = std::map<std::string, Run>;
+
+  const rocksdb::MemTableRep::KeyComparator& cmp_;
+  const rocksdb::SliceTransform* prefix_extractor_;
+
+  // Protects runs_, index_ and contents of runs. Not locked by readers once
+  // read_only_ is set.
+  mutable folly::SharedMutex mutex_;
+  std::atomic<bool> read_only_{false};
+
+  RunMap runs_;
+  std::unordered_map<std::string, RunMap::iterator> index_;
+  // Run of the last insert, consecutive inserts are usually for the same log.
+  RunMap::iterator last_run_;
+
+  std::atomic<size_t> memory_usage_{0};
+
+  // rocksdb doesn't free iterators it asks to allocate in its arena, it only
+  // calls their destructor. We don't have access to the arena, so keep the
+  // storage of such iterators here and reuse it once they're destroyed.
+  std::mutex iterator_storage_mutex_;
+  std::vector<std::unique_ptr<char[]>> iterator_storage_;
+  std::vector<void*> free_iterator_storage_;
+
+  void* allocateIteratorStorage();
+  void releaseIteratorStorage(void* storage);
+
+  rocksdb::Slice prefixOfEntry(const char* entry) const;
+  rocksdb::Slice prefixOfInternalKey(const rocksdb::Slice& internal_key) const;
+
+  // Returns the lock guard for readers: an unlocked one if read-only.
+  folly::SharedMutex::ReadHolder lockShared() const;
+
+  // nullptr if there are no entries with this prefix. Requires the lock.
+  const Run* findRun(const rocksdb::Slice& prefix) const;
+};
+
+// Creates RocksDBPerLogMemTableReps, or skiplist ones for column families
+// whose prefix extractor doesn't order keys the way
+// RocksDBPerLogMemTableRep needs.
+class RocksDBPerLogMemTableRepFactory : public rocksdb::MemTableRepFactory {
+ public:
+  explicit RocksDBPerLogMemTableRepFactory(
+      std::unique_ptr<rocksdb::MemTableRepFactory> fallback)
+      : fallback_(std::move(fallback)) {}
+
+  rocksdb::MemTableRep*
+  CreateMemTableRep(const rocksdb::MemTableRep::KeyComparator& cmp,
+                    rocksdb::Allocator* allocator,
+                    const rocksdb::SliceTransform* prefix_extractor,
+                    rocksdb::Logger* logger) override;
+
+  const char* Name() const override {
+    return "logdevice::RocksDBPerLogMemTableRepFactory";
+  }
+
+  bool IsInsertConcurrentlySupported() const override {
+    return false;
+  }
+
+ private:
+  std::unique_ptr<rocksdb::MemTableRepFactory> fallback_;
+};
+
+}} // namespace facebook::logdevice
@@ -32,6 +32,30 @@ using namespace facebook::logdevice::setting_validators;
 
 namespace facebook { namespace logdevice {
 
+static rocksdb::CompressionType parse_compression_type(const char* option,
+                                                       const std::string& val) {
+  if (val == "snappy") {
+    return rocksdb::kSnappyCompression;
+  } else if (val == "none") {
+    return rocksdb::kNoCompression;
+  } else if (val == "zlib") {
+    return rocksdb::kZlibCompression;
+  } else if (val == "bzip2") {
+    return rocksdb::kBZip2Compression;
+  } else if (val == "lz4") {
+    return rocksdb::kLZ4Compression;
+  } else if (val == "lz4hc") {
+    return rocksdb::kLZ4HCCompression;
+  } else if (val == "xpress") {
+    return rocksdb::kXpressCompression;
+  } else if (val == "zstd") {
+    return rocksdb::kZSTD;
+  } else {
+    throw boost::program_options::error("invalid value '" + val +
+                                        "' for option --" + option);
+  }
+}
+
 void RocksDBSettings::defineSettings(SettingEasyInit& init) {
   using namespace SettingFlag;
 
@@ -59,27 +83,7 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        &compression,
        "none",
        [](const std::string& val) {
-         if (val == "snappy") {
-           return rocksdb::kSnappyCompression;
-         } else if (val == "none") {
-           return rocksdb::kNoCompression;
-         } else if (val == "zlib") {
-           return rocksdb::kZlibCompression;
-         } else if (val == "bzip2") {
-           return rocksdb::kBZip2Compression;
-         } else if (val == "lz4") {
-           return rocksdb::kLZ4Compression;
-         } else if (val == "lz4hc") {
-           return rocksdb::kLZ4HCCompression;
-         } else if (val == "xpress") {
-           return rocksdb::kXpressCompression;
-         } else if (val == "zstd") {
-           return rocksdb::kZSTD;
-         } else {
-           throw boost::program_options::error(
-               "invalid value '" + val +
-               "' for option --rocksdb-compression-type");
-         }
+         return parse_compression_type("rocksdb-compression-type", val);
        },
        "compression algorithm: 'snappy' (default), 'none', 'zlib', 'bzip2', "
        "'lz4', 'lz4hc', 'zstd'",
@@ -237,6 +241,19 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-cache-scan-resistant",
+       &cache_scan_resistant_,
+       "false",
+       nullptr,
+       "If true, blocks read by backlog reads, rebuilding and compactions are "
+       "inserted into the block cache with low priority, and blocks read by "
+       "everything else (e.g. tail reads and findTime) with high priority. A "
+       "large scan then only evicts blocks that were not used since they were "
+       "read. Has no effect unless --rocksdb-cache-high-pri-pool-ratio is "
+       "positive.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-read-amp-bytes-per-bit",
        &read_amp_bytes_per_bit_,
        "32",
@@ -296,6 +313,78 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-partition-cold-compression-age",
+       &partition_cold_compression_age_,
+       "0h",
+       [](std::chrono::hours val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-partition-cold-compression-age must be "
+               "non-negative; " +
+               std::to_string(val.count()) + "hrs given.");
+         }
+       },
+       "If positive, partitions (besides two latest) whose newest record is "
+       "older than this are compacted once more in the low priority "
+       "background thread, rewriting them with "
+       "--rocksdb-partition-cold-compression-type. 0 disables recompression "
+       "of cold partitions.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-cold-compression-type",
+       &partition_cold_compression_,
+       "zstd",
+       [](const std::string& val) {
+         return parse_compression_type(
+             "rocksdb-partition-cold-compression-type", val);
+       },
+       "compression algorithm for partitions older than "
+       "--rocksdb-partition-cold-compression-age; same values as "
+       "--rocksdb-compression-type",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-cold-compression-level",
+       &partition_cold_compression_level_,
+       "0",
+       nullptr,
+       "compression level for --rocksdb-partition-cold-compression-type. 0 "
+       "uses the algorithm's default level.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-offload-path",
+       &partition_offload_path_,
+       "",
+       nullptr,
+       "If not empty, SST files of partitions older than "
+       "--rocksdb-partition-offload-age are moved to this directory, which "
+       "is meant to be a mount of cheaper, possibly remote, storage (e.g. a "
+       "network filesystem or an object store exposed as a filesystem). "
+       "Only the partition directory and other metadata stay on the shard. "
+       "Files are read from this directory on demand when the local copy is "
+       "gone. Each shard gets its own subdirectory.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-offload-age",
+       &partition_offload_age_,
+       "0h",
+       [](std::chrono::hours val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-partition-offload-age must be "
+               "non-negative; " +
+               std::to_string(val.count()) + "hrs given.");
+         }
+       },
+       "Partitions (besides two latest) whose newest record is older than "
+       "this have their SST files moved to --rocksdb-partition-offload-path "
+       "by the low priority background thread. 0 disables offloading.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-disable-iterate-upper-bound",
        &disable_iterate_upper_bound,
        "false",
@@ -304,6 +393,19 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-skip-sst-files-without-log",
+       &skip_sst_files_without_log,
+       "true",
+       nullptr,
+       "If true, iterators reading a single log skip sst files whose table "
+       "properties say that they have no records, copyset index or "
+       "findTime/findKey index entries of that log, without looking at the "
+       "files' index and bloom filter blocks. The set of logs is only "
+       "recorded for files with a few hundred ranges of consecutive log ids "
+       "or less.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-partition-duration",
        &partition_duration_,
        "15min",
@@ -456,6 +558,19 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-partition-hot-read-period",
+       &partition_hot_read_period_,
+       "10min",
+       nullptr,
+       "Partial compactions are done in order of priority: first in the two "
+       "latest partitions, then in partitions that a reader started reading "
+       "within this period, then in the remaining cold partitions. Partial "
+       "compactions of cold partitions are deferred when there are more than "
+       "--rocksdb-partition-partial-compaction-max-num-per-loop pending. 0 "
+       "means no partitions other than the latest ones are prioritized.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-partition-partial-compaction-stall-trigger",
        &partition_partial_compaction_stall_trigger_,
        "50",
@@ -486,6 +601,17 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
       SERVER,
       SettingsCategory::LogsDB);
 
+  init("rocksdb-partition-metadata-read-threads",
+       &partition_metadata_read_threads,
+       "8",
+       parse_positive<ssize_t>(),
+       "Number of threads each shard uses to read the metadata (timestamps) "
+       "of its partitions on startup. Shards are already opened in parallel; "
+       "this also parallelizes the reads within a shard, which helps when a "
+       "shard has many partitions and the metadata is not in cache.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-partition-timestamp-granularity",
        &partition_timestamp_granularity_,
        "5s",
@@ -658,6 +784,28 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-flush-notification-interval",
+       &flush_notification_interval,
+       "0ms",
+       [](std::chrono::milliseconds val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-flush-notification-interval must be "
+               "non-negative; " +
+               std::to_string(val.count()) + "ms given.");
+         }
+       },
+       "Minimum time between two MEMTABLE_FLUSHED notifications sent to "
+       "other nodes (and to local rebuilding state machines) for a shard. "
+       "Flushes that happen in between are coalesced: the next notification "
+       "carries the latest flushed-up-through token. The partition cleaner "
+       "is delayed the same way. Reduces the number of messages and dirty "
+       "state updates when memtables are flushed very often, at the cost of "
+       "rebuilding donors learning about flushes later. 0 sends a "
+       "notification after every flush.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-metadata-compaction-period",
        &metadata_compaction_period,
        "1h",
@@ -682,6 +830,25 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-unpartitioned-drop-trimmed-files-period",
+       &unpartitioned_drop_trimmed_files_period,
+       "10min",
+       [](std::chrono::milliseconds val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-unpartitioned-drop-trimmed-files-period "
+               "must be non-negative; " +
+               std::to_string(val.count()) + "ms given.");
+         }
+       },
+       "How often to look for sst files in the unpartitioned column family "
+       "that only contain records of one log below its trim point, and delete "
+       "them without compacting them. Such files are otherwise rewritten by "
+       "compactions only for the compaction filter to drop every record. 0 "
+       "disables it.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-directory-consistency-check-period",
        &directory_consistency_check_period,
        "5min",
@@ -735,6 +902,20 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-put-first-wave-records",
+       &put_first_wave_records,
+       "false",
+       nullptr,
+       "If true, records stored for the first time (first wave, not an amend, "
+       "not written by recovery or rebuilding) are written to RocksDB as plain "
+       "values instead of merge operands, so that reads and compactions don't "
+       "need to run the merge operator for them. Amends and later waves are "
+       "still merged on top. A first-wave store that arrives after a later "
+       "version of the same record overwrites it instead of being merged "
+       "with it.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-low-ioprio",
        &low_ioprio,
        "3,0",
@@ -814,6 +995,19 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-partition-index-cache-max-entries",
+       &partition_index_cache_max_entries,
+       "0",
+       nullptr,
+       "If positive, findTime and findKey keep in-memory copies of the "
+       "findTime/findKey index entries of partitions older than the latest "
+       "one, so that repeated searches in the same partition don't read the "
+       "index from RocksDB. A copy is made per log and partition on the first "
+       "search, and only if the log has at most this many index entries in "
+       "the partition. Any write into the partition invalidates its copies.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-read-only",
        &read_only,
        "false",
@@ -968,6 +1162,22 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::RocksDB);
 
+#ifdef LOGDEVICE_ROCKSDB_HAS_RIBBON_FILTER
+  init("rocksdb-ribbon-filter",
+       &ribbon_filter_,
+       "false",
+       nullptr,
+       "If true, use ribbon filters instead of bloom filters in sst files, "
+       "with the same false positive rate as a bloom filter with "
+       "--rocksdb-bloom-bits-per-key bits per key. Ribbon filters take about "
+       "30% less space, which lets more of them stay in block cache when "
+       "there are many logs per partition, at the cost of more CPU time "
+       "spent building them in flushes and compactions. Ignored if "
+       "--rocksdb-bloom-block-based is set.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+#endif
+
   init("rocksdb-partition-size-limit",
        &partition_size_limit_,
        "6G",
@@ -1059,6 +1269,28 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-persistent-cache-path",
+       &persistent_cache_path_,
+       "",
+       nullptr,
+       "If not empty, data blocks read from SST files are also cached in a "
+       "persistent cache in this directory, which should be on a device "
+       "faster than the one the shards are on (e.g. flash for shards on "
+       "HDDs). Each shard gets its own subdirectory and "
+       "--rocksdb-persistent-cache-size-per-shard bytes. Block cache misses "
+       "are then served from the persistent cache when possible.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-persistent-cache-size-per-shard",
+       &persistent_cache_size_per_shard_,
+       "10G",
+       parse_memory_budget(),
+       "size of the persistent cache of each shard, see "
+       "--rocksdb-persistent-cache-path",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-cache-numshardbits",
        &cache_numshardbits_,
        "4",
@@ -1140,6 +1372,31 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-memtable-rep",
+       &memtable_rep,
+       "skiplist",
+       [](const std::string& val) {
+         if (val == "skiplist") {
+           return RocksDBSettings::MemTableRepType::SKIPLIST;
+         } else if (val == "per_log") {
+           return RocksDBSettings::MemTableRepType::PER_LOG;
+         } else {
+           throw boost::program_options::error(
+               "invalid value '" + val +
+               "'for option --rocksdb-memtable-rep. Expected 'skiplist' or "
+               "'per_log'");
+         }
+       },
+       "Data structure of memtables. 'skiplist' is the standard RocksDB "
+       "skiplist. 'per_log' keeps a sorted vector of keys for each log, which "
+       "makes inserts of records in LSN order (the common case) a hash lookup "
+       "and an append. Out of order inserts are slower than with the skiplist "
+       "for logs with many records in the memtable, and reads of the mutable "
+       "memtable take a shared lock. 'per_log' disables concurrent memtable "
+       "writes.",
+       SERVER | REQUIRES_RESTART | EXPERIMENTAL,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-max-open-files",
        &max_open_files,
        "10000",
@@ -1400,6 +1657,21 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-write-pacing",
+       &write_pacing,
+       "false",
+       nullptr,
+       "If true, once the memtables of a shard use more than half of the "
+       "per-shard memory limit, storage threads pace writes to a rate derived "
+       "from how fast memtables are being flushed: twice the flush rate at "
+       "half the limit, going down linearly to zero at the limit, where "
+       "writes start being rejected. Past three quarters of the limit, "
+       "STORED replies also carry the OVERLOADED flag, so that sequencers "
+       "send fewer writes to the node. This slows writers down gradually "
+       "instead of switching between full speed and rejecting writes.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-pinned-memtables-limit-percent",
        &pinned_memtables_limit_percent,
        "50",
@@ -1437,6 +1709,18 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-rebuilding-reads-drop-page-cache",
+       &rebuilding_reads_drop_page_cache,
+       "false",
+       nullptr,
+       "If true, file ranges read by rebuilding storage tasks are dropped "
+       "from the OS page cache right after being read (with "
+       "posix_fadvise(POSIX_FADV_DONTNEED)), so that rebuilding a shard "
+       "doesn't evict pages that other reads need. Has no effect with "
+       "--rocksdb-use-direct-reads.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-print-details",
        &print_details,
        "false",
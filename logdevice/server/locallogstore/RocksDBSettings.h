@@ -44,6 +44,10 @@ static_assert(ROCKSDB_MAJOR > 5 || (ROCKSDB_MAJOR == 5 && ROCKSDB_MINOR >= 7),
 #define LOGDEVICE_ROCKSDB_HAS_INDEX_SHORTENING_MODE
 #endif
 
+#if ROCKSDB_MAJOR > 6 || (ROCKSDB_MAJOR == 6 && ROCKSDB_MINOR >= 21)
+#define LOGDEVICE_ROCKSDB_HAS_RIBBON_FILTER
+#endif
+
 namespace boost { namespace program_options {
 class options_description;
 }} // namespace boost::program_options
@@ -85,6 +89,14 @@ class RocksDBSettings : public SettingsBundle {
   // position.
   int skip_list_lookahead;
 
+  enum class MemTableRepType {
+    SKIPLIST,
+    // see RocksDBPerLogMemTableRep.h
+    PER_LOG,
+  };
+
+  MemTableRepType memtable_rep;
+
   // Do RangeSync() for WAL files in a background thread.
   bool background_wal_sync;
 
@@ -122,6 +134,19 @@ class RocksDBSettings : public SettingsBundle {
   // Compacting will be done in low priority background thread
   bool proactive_compaction_enabled;
 
+  // Partitions (besides two latest) whose newest record is older than this
+  // are recompacted with partition_cold_compression_ (and
+  // partition_cold_compression_level_ if nonzero). 0 disables it.
+  std::chrono::hours partition_cold_compression_age_;
+  rocksdb::CompressionType partition_cold_compression_;
+  int partition_cold_compression_level_;
+
+  // If partition_offload_path_ is not empty, SST files of partitions
+  // (besides two latest) whose newest record is older than
+  // partition_offload_age_ are moved there. RocksDBEnv reads them from there.
+  std::string partition_offload_path_;
+  std::chrono::hours partition_offload_age_;
+
   // A new partition is created every time one of the following thresholds
   // reached hit for the latest partition:
   //  * age,
@@ -155,6 +180,8 @@ class RocksDBSettings : public SettingsBundle {
   size_t partition_partial_compaction_max_files_;
 
   size_t partition_partial_compaction_max_num_per_loop_;
+  // See .cpp
+  std::chrono::milliseconds partition_hot_read_period_;
   size_t partition_partial_compaction_stall_trigger_;
 
   // The largest l0 files that it is beneficial to compact on their own. note
@@ -176,6 +203,10 @@ class RocksDBSettings : public SettingsBundle {
   // See .cpp
   size_t partition_count_soft_limit_;
 
+  // Number of threads to read partition metadata with when opening the
+  // shard.
+  size_t partition_metadata_read_threads;
+
   // Granularity of min and max timestamps for partitions.
   // This is how often timestamps for partition are updated.
   // This is also the duration by which time-based trimming lags because of
@@ -215,11 +246,18 @@ class RocksDBSettings : public SettingsBundle {
   // update the partition dirty metadata
   std::chrono::milliseconds partition_redirty_grace_period;
 
+  // Minimum time between two notifications to other nodes that memtables of
+  // this shard were flushed. 0 means notify after every flush.
+  std::chrono::milliseconds flush_notification_interval;
+
   uint64_t bytes_written_since_throttle_eval_trigger;
 
   // See .cpp
   std::chrono::milliseconds metadata_compaction_period;
 
+  // See .cpp
+  std::chrono::milliseconds unpartitioned_drop_trimmed_files_period;
+
   // See .cpp
   std::chrono::milliseconds directory_consistency_check_period;
 
@@ -230,10 +268,16 @@ class RocksDBSettings : public SettingsBundle {
   // Verify checksum on each store, reject with error if it fails (see .cpp)
   bool verify_checksum_during_store{true};
 
+  // Write first-wave records with Put() instead of Merge() (see .cpp)
+  bool put_first_wave_records{false};
+
   // Disable the iterate_upper_bound optimization.
   // TODO(#8945358): Remove this option once #8945358 is fixed.
   bool disable_iterate_upper_bound;
 
+  // Use the set of logs in table properties to skip sst files (see .cpp)
+  bool skip_sst_files_without_log;
+
   // When set to true, the read path will use the copyset index to skip records
   // that do not pass copyset filters
   bool use_copyset_index;
@@ -242,6 +286,11 @@ class RocksDBSettings : public SettingsBundle {
   // instead of doing a binary search in the relevant partition.
   bool read_find_time_index;
 
+  // Maximum number of findTime/findKey index entries of one log in one
+  // partition that findTime/findKey will copy into memory, see
+  // PartitionIndexCache. 0 disables the in-memory copies.
+  size_t partition_index_cache_max_entries;
+
   // If true, PartitionedRocksDBStore will be opened in read only mode.
   bool read_only;
 
@@ -282,6 +331,19 @@ class RocksDBSettings : public SettingsBundle {
 
   size_t cache_small_block_threshold_for_high_priority_;
 
+  // If true, blocks read by scanning storage tasks (backlog reads, rebuilding,
+  // compactions) are inserted into the block cache with low priority and all
+  // other blocks with high priority. See RocksDBCache.
+  bool cache_scan_resistant_;
+
+  // Directory for RocksDB's persistent secondary block cache, e.g. on a
+  // flash device when shards are on HDDs. Each shard gets a subdirectory.
+  // Empty disables the persistent cache.
+  std::string persistent_cache_path_;
+
+  // Size of the persistent cache of each shard.
+  size_t persistent_cache_size_per_shard_;
+
   // size of compressed block cache (disabled by default)
   size_t compressed_cache_size_;
 
@@ -338,6 +400,10 @@ class RocksDBSettings : public SettingsBundle {
 
   // See .cpp
   double low_pri_write_stall_threshold_percent;
+
+  // Pace writes proportionally to the memtable flush rate when memtables
+  // approach their memory limit. See .cpp
+  bool write_pacing;
   double pinned_memtables_limit_percent;
 
   // See .cpp
@@ -363,6 +429,9 @@ class RocksDBSettings : public SettingsBundle {
   int bloom_bits_per_key_;
   int metadata_bloom_bits_per_key_;
   bool bloom_block_based_;
+#ifdef LOGDEVICE_ROCKSDB_HAS_RIBBON_FILTER
+  bool ribbon_filter_;
+#endif
 
   std::chrono::seconds test_clamp_backlog;
 
@@ -383,6 +452,9 @@ class RocksDBSettings : public SettingsBundle {
   bool auto_create_shards;
   bool use_direct_reads;
   bool use_direct_io_for_flush_and_compaction;
+
+  // Drop the pages read by rebuilding storage tasks from the OS page cache.
+  bool rebuilding_reads_drop_page_cache;
   int max_open_files;
   uint64_t compaction_max_bytes_at_once;
   uint64_t bytes_per_sync;
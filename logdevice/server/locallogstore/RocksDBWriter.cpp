@@ -116,21 +116,35 @@ int RocksDBWriter::writeMulti(
 
         folly::small_vector<rocksdb::Slice, 3> value_slices;
 
-        // NOTE: At least RocksDBWriterMergeOperator and
-        // RocksDBCompactionFilter expect this format (header byte then same
-        // as normal non-merge stores).
-        value_slices.emplace_back(
-            &RocksDBWriterMergeOperator::DATA_MERGE_HEADER, 1);
+        const bool use_put = store_->getSettings()->put_first_wave_records &&
+            detail::isFirstWriteOfRecord(*op);
+        if (!use_put) {
+          // NOTE: At least RocksDBWriterMergeOperator and
+          // RocksDBCompactionFilter expect this format (header byte then same
+          // as normal non-merge stores).
+          value_slices.emplace_back(
+              &RocksDBWriterMergeOperator::DATA_MERGE_HEADER, 1);
+        }
         value_slices.emplace_back(
             reinterpret_cast<const char*>(op->record_header.data),
             op->record_header.size);
         value_slices.emplace_back(
             reinterpret_cast<const char*>(op->data.data), op->data.size);
 
-        rocksdb_batch.Merge(
-            data_cf,
-            rocksdb::SliceParts(&key_slice, 1),
-            rocksdb::SliceParts(value_slices.data(), value_slices.size()));
+        if (use_put) {
+          // A plain value has the same format as the result of a full merge,
+          // so later amends and rewrites are merged on top of it as usual.
+          rocksdb_batch.Put(
+              data_cf,
+              rocksdb::SliceParts(&key_slice, 1),
+              rocksdb::SliceParts(value_slices.data(), value_slices.size()));
+          STAT_INCR(store_->getStatsHolder(), record_writes_without_merge);
+        } else {
+          rocksdb_batch.Merge(
+              data_cf,
+              rocksdb::SliceParts(&key_slice, 1),
+              rocksdb::SliceParts(value_slices.data(), value_slices.size()));
+        }
 
         record_bytes += key_slice.size();
         for (const auto& s : value_slices) {
@@ -156,7 +170,11 @@ int RocksDBWriter::writeMulti(
               reinterpret_cast<const char*>(&key), sizeof key);
           rocksdb::Slice value_slice(
               reinterpret_cast<const char*>(value.data), value.size);
-          rocksdb_batch.Merge(data_cf, csi_key_slice, value_slice);
+          if (use_put) {
+            rocksdb_batch.Put(data_cf, csi_key_slice, value_slice);
+          } else {
+            rocksdb_batch.Merge(data_cf, csi_key_slice, value_slice);
+          }
 
           csi_bytes += csi_key_slice.size() + value_slice.size();
         }
@@ -930,6 +948,37 @@ bool useMerge(const LogMetadata& /*metadata*/) {
   // be migrated to use merge operator instead of mutexes.
   return false;
 }
+
+bool isFirstWriteOfRecord(const PutWriteOp& op) {
+  if (op.isRebuilding()) {
+    return false;
+  }
+  LocalLogStoreRecordFormat::flags_t flags;
+  uint32_t wave;
+  int rv = LocalLogStoreRecordFormat::parse(op.record_header,
+                                            nullptr,
+                                            nullptr,
+                                            &flags,
+                                            &wave,
+                                            nullptr,
+                                            nullptr,
+                                            0,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            -1 /* unused */);
+  if (rv != 0) {
+    return false;
+  }
+  // For records written by recovery `wave` is the recovery epoch instead.
+  const LocalLogStoreRecordFormat::flags_t rewrite_flags =
+      LocalLogStoreRecordFormat::FLAG_AMEND |
+      LocalLogStoreRecordFormat::FLAG_WRITTEN_BY_RECOVERY |
+      LocalLogStoreRecordFormat::FLAG_WRITTEN_BY_REBUILDING |
+      LocalLogStoreRecordFormat::FLAG_HOLE |
+      LocalLogStoreRecordFormat::FLAG_DRAINED;
+  return wave == 1 && !(flags & rewrite_flags);
+}
 } // namespace detail
 
 }} // namespace facebook::logdevice
@@ -43,6 +43,7 @@ namespace facebook { namespace logdevice {
 
 class ComparableLogMetadata;
 class LogMetadata;
+struct PutWriteOp;
 class StoreMetadata;
 class WriteOp;
 
@@ -56,6 +57,12 @@ inline bool useMerge(const MutablePerEpochLogMetadata&) {
   return true;
 }
 bool useMerge(const LogMetadata& metadata);
+
+// Is this the first write of the record, i.e. a first-wave store that is not
+// an amend and not written by recovery or rebuilding? Such records may be
+// written with Put() instead of Merge() if --rocksdb-put-first-wave-records
+// is set, so that reads don't have to resolve a merge operand.
+bool isFirstWriteOfRecord(const PutWriteOp& op);
 } // namespace detail
 
 class RocksDBWriter {
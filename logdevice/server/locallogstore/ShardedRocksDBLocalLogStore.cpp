@@ -172,6 +172,9 @@ ShardedRocksDBLocalLogStore::ShardedRocksDBLocalLogStore(
       // Create SstFileManager for this shard
       shard_config.addSstFileManagerForShard();
 
+      // Create the persistent secondary block cache for this shard, if any
+      shard_config.addPersistentCacheForShard(shard_idx);
+
       // If rocksdb statistics are enabled, create a Statistics object for
       // each shard.
       if (db_settings->statistics) {
@@ -668,6 +671,16 @@ void ShardedRocksDBLocalLogStore::setSequencerInitiatedSpaceBasedRetention(
   }
 }
 
+int ShardedRocksDBLocalLogStore::getShardDevice(int shard_idx,
+                                                dev_t* out) const {
+  ld_check(out);
+  if (shard_idx < 0 || shard_idx >= shard_to_devt_.size()) {
+    return -1;
+  }
+  *out = shard_to_devt_[shard_idx];
+  return 0;
+}
+
 void ShardedRocksDBLocalLogStore::setShardedStorageThreadPool(
     const ShardedStorageThreadPool* sharded_pool) {
   for (size_t i = 0; i < shards_.size(); ++i) {
@@ -136,6 +136,8 @@ class ShardedRocksDBLocalLogStore : public ShardedLocalLogStore {
    */
   void setSequencerInitiatedSpaceBasedRetention(int shard_idx) override;
 
+  int getShardDevice(int shard_idx, dev_t* out) const override;
+
   struct DiskInfo {
     DiskInfo() : sequencer_initiated_space_based_retention(false), shards() {}
     std::atomic<bool> sequencer_initiated_space_based_retention;
@@ -66,7 +66,8 @@ LocalLogStoreTestReader::process(const TemporaryRocksDBStore* store,
                                        filter_,
                                        CatchupEventTrigger::OTHER);
 
-  Status st = LocalLogStoreReader::read(*it, cb, &ctx, nullptr, settings_);
+  Status st = LocalLogStoreReader::read(
+      *it, cb, &ctx, nullptr, settings_, should_preempt_);
   records = std::move(cb.getRecords());
   read_ptr_ = ctx.read_ptr_;
 
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <functional>
+
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
 #include "logdevice/server/read_path/LocalLogStoreReader.h"
@@ -60,6 +62,14 @@ class LocalLogStoreTestReader {
     settings_.max_record_read_execution_time = v;
     return *this;
   }
+  LocalLogStoreTestReader& preempt_after(std::chrono::milliseconds v) {
+    settings_.read_storage_tasks_preempt_after = v;
+    return *this;
+  }
+  LocalLogStoreTestReader& should_preempt(std::function<bool()> f) {
+    should_preempt_ = std::move(f);
+    return *this;
+  }
   LocalLogStoreTestReader& filter(std::shared_ptr<LocalLogStoreReadFilter> f) {
     filter_ = std::move(f);
     return *this;
@@ -89,6 +99,7 @@ class LocalLogStoreTestReader {
   int fail_after_ = -1;
   bool use_csi_ = false;
   bool csi_only_ = false;
+  std::function<bool()> should_preempt_;
   Settings settings_;
 };
 
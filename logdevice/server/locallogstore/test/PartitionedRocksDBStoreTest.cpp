@@ -36,6 +36,7 @@
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 #include "logdevice/server/locallogstore/RocksDBListener.h"
 #include "logdevice/server/locallogstore/RocksDBMemTableRep.h"
+#include "logdevice/server/locallogstore/RocksDBPerLogMemTableRep.h"
 #include "logdevice/server/locallogstore/RocksDBWriterMergeOperator.h"
 #include "logdevice/server/locallogstore/WriteOps.h"
 #include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
@@ -887,9 +888,17 @@ class PartitionedRocksDBStoreTest : public ::testing::Test {
         &time_, log_store_config.rocksdb_settings_);
     log_store_config.options_.compaction_filter_factory = filter_factory_;
 
-    mtr_factory_ = std::make_shared<TestRocksDBMemTableRepFactory>(
+    std::unique_ptr<rocksdb::MemTableRepFactory> rep_factory =
         std::make_unique<rocksdb::SkipListFactory>(
-            rocksdb_settings_->skip_list_lookahead));
+            rocksdb_settings_->skip_list_lookahead);
+    if (rocksdb_settings_->memtable_rep ==
+        RocksDBSettings::MemTableRepType::PER_LOG) {
+      rep_factory = std::make_unique<RocksDBPerLogMemTableRepFactory>(
+          std::move(rep_factory));
+      log_store_config.options_.allow_concurrent_memtable_write = false;
+    }
+    mtr_factory_ = std::make_shared<TestRocksDBMemTableRepFactory>(
+        std::move(rep_factory));
 
     log_store_config.options_.memtable_factory =
         log_store_config.metadata_options_.memtable_factory = mtr_factory_;
@@ -3596,6 +3605,44 @@ TEST_F(PartitionedRocksDBStoreTest, FindTimeWithIndex) {
   FINDTIME(logid, BASE_TIME + 3, 31, 42, 31, 32);
 }
 
+TEST_F(PartitionedRocksDBStoreTest, FindTimeWithPartitionIndexCache) {
+  logid_t logid(3);
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-read-find-time-index"] = "true";
+  s["rocksdb-partition-index-cache-max-entries"] = "100";
+  openStore(s);
+
+  // partition 0
+  put({TestRecord(logid, 10, /*index=*/true, BASE_TIME)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME));
+  store_->createPartition();
+  // partition 1
+  put({TestRecord(logid, 20, /*index=*/true, BASE_TIME + 1)});
+  put({TestRecord(logid, 30, /*index=*/true, BASE_TIME + 3)});
+  put({TestRecord(logid, 40, /*index=*/true, BASE_TIME + 5)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + 6));
+  store_->createPartition();
+  // partition 2
+  put({TestRecord(logid, 50, /*index=*/true, BASE_TIME + 7)});
+
+  // The first search in partition 1 copies its index into memory, the
+  // following ones use the copy.
+  FINDTIME(logid, BASE_TIME + 3, LSN_INVALID, LSN_MAX, 20, 30);
+  FINDTIME(logid, BASE_TIME + 4, LSN_INVALID, LSN_MAX, 30, 40);
+  FINDTIME(logid, BASE_TIME + 5, LSN_INVALID, LSN_MAX, 30, 40);
+  Stats stats = stats_.aggregate();
+  EXPECT_EQ(1, stats.logsdb_partition_index_cache_builds);
+  EXPECT_EQ(2, stats.logsdb_partition_index_cache_hits);
+
+  // A write into partition 1 invalidates the copy.
+  put({TestRecord(logid, 35, /*index=*/true, BASE_TIME + 4)});
+  FINDTIME(logid, BASE_TIME + 4, LSN_INVALID, LSN_MAX, 30, 35);
+  stats = stats_.aggregate();
+  EXPECT_EQ(2, stats.logsdb_partition_index_cache_builds);
+  EXPECT_EQ(2, stats.logsdb_partition_index_cache_hits);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, FindTimeUnpartitionedInternalLog) {
   // Perform findtime on an internal log, which should be in the unpartitioned
   // column family.
@@ -5042,12 +5089,14 @@ TEST_F(PartitionedRocksDBStoreTest, WritePathCases) {
   EXPECT_EQ(0, stats.logsdb_directory_premature_flushes);
 
   // Records with smaller LSNs that want to be in partition 0.
-  // Two dependent writes in a batch.
+  // Two dependent writes in a batch. Their directory updates all go to the
+  // WAL batch, so they get coalesced into one write.
   put({TestRecord(log, 30, BASE_TIME + 30 * MINUTE),   // partition 0
        TestRecord(log, 40, BASE_TIME + 40 * MINUTE)}); // partition 0
   stats = stats_.aggregate();
   EXPECT_EQ(2, stats.logsdb_writes_dir_key_add);
-  EXPECT_EQ(1, stats.logsdb_directory_premature_flushes);
+  EXPECT_EQ(0, stats.logsdb_directory_premature_flushes);
+  EXPECT_EQ(1, stats.logsdb_directory_updates_coalesced);
 
   // A record in between that wants to be in partition 1.
   put({TestRecord(log, 65, BASE_TIME + HOUR + 5 * MINUTE)}); // partition 1
@@ -5332,6 +5381,188 @@ TEST_F(PartitionedRocksDBStoreTest, ObsoleteDataEstimate) {
   EXPECT_GT(store_->getApproximateObsoleteBytes(ID0), 100);
 }
 
+TEST_F(PartitionedRocksDBStoreTest, DropTrimmedUnpartitionedFiles) {
+  auto customize_fn = [&](RocksDBLogStoreConfig& cfg) {
+    cfg.options_.table_properties_collector_factories.push_back(
+        std::make_shared<RocksDBTablePropertiesCollectorFactory>(
+            processor_->config_, nullptr /* stats */));
+  };
+  readAndCheck();
+  openStore(ServerConfig::SettingsConfig(), customize_fn);
+
+  const logid_t meta_log1 = MetaDataLog::metaDataLogID(logid_t(1));
+  const logid_t meta_log2 = MetaDataLog::metaDataLogID(logid_t(2));
+  rocksdb::ColumnFamilyHandle* cf = store_->getUnpartitionedCFHandle();
+  auto file_count = [&] {
+    rocksdb::ColumnFamilyMetaData meta;
+    store_->getDB().GetColumnFamilyMetaData(cf, &meta);
+    return meta.file_count;
+  };
+  // DeleteFilesInRange() doesn't touch L0, so compact each file to L1.
+  auto flush_and_compact = [&](std::vector<TestRecord> records) {
+    put(std::move(records));
+    EXPECT_EQ(0, store_->flushUnpartitionedMemtables());
+    rocksdb::CompactRangeOptions options;
+    options.change_level = true;
+    options.target_level = 1;
+    ASSERT_TRUE(
+        store_->getDB().CompactRange(options, cf, nullptr, nullptr).ok());
+  };
+
+  // A file with only records of meta_log1.
+  flush_and_compact({TestRecord(meta_log1, 10), TestRecord(meta_log1, 20)});
+  size_t files = file_count();
+  ASSERT_GT(files, 0);
+
+  // Nothing is trimmed yet.
+  store_->dropTrimmedUnpartitionedFiles();
+  EXPECT_EQ(files, file_count());
+
+  // Trim point is below the last record of the file.
+  ASSERT_EQ(0, updateTrimPoint(meta_log1, 15));
+  store_->dropTrimmedUnpartitionedFiles();
+  EXPECT_EQ(files, file_count());
+
+  ASSERT_EQ(0, updateTrimPoint(meta_log1, 20));
+  store_->dropTrimmedUnpartitionedFiles();
+  EXPECT_EQ(0, file_count());
+  Stats stats = stats_.aggregate();
+  EXPECT_EQ(files,
+            stats.per_shard_stats->get(0)->unpartitioned_trimmed_files_dropped);
+
+  // A file with records of two logs is left to compaction filter.
+  flush_and_compact({TestRecord(meta_log1, 30), TestRecord(meta_log2, 10)});
+  files = file_count();
+  ASSERT_GT(files, 0);
+  ASSERT_EQ(0, updateTrimPoint(meta_log1, 30));
+  ASSERT_EQ(0, updateTrimPoint(meta_log2, 10));
+  store_->dropTrimmedUnpartitionedFiles();
+  EXPECT_EQ(files, file_count());
+}
+
+TEST_F(PartitionedRocksDBStoreTest, SkipSstFilesWithoutLog) {
+  auto customize_fn = [&](RocksDBLogStoreConfig& cfg) {
+    cfg.options_.table_properties_collector_factories.push_back(
+        std::make_shared<RocksDBTablePropertiesCollectorFactory>(
+            processor_->config_, nullptr /* stats */));
+  };
+  readAndCheck();
+  openStore(ServerConfig::SettingsConfig(), customize_fn);
+
+  // Two sst files in the same partition: one with logs 1 and 3, one with
+  // log 2.
+  put({TestRecord(logid_t(1), 10), TestRecord(logid_t(3), 10)});
+  EXPECT_TRUE(store_->flushMemtable(store_->getPartitionList()->get(ID0)->cf_));
+  put({TestRecord(logid_t(2), 20)});
+  EXPECT_TRUE(store_->flushMemtable(store_->getPartitionList()->get(ID0)->cf_));
+
+  auto read_log = [&](logid_t log) {
+    std::vector<lsn_t> lsns;
+    auto it = store_->read(
+        log, LocalLogStore::ReadOptions("SkipSstFilesWithoutLog"));
+    for (it->seek(LSN_OLDEST); it->state() == IteratorState::AT_RECORD;
+         it->next()) {
+      lsns.push_back(it->getLSN());
+    }
+    EXPECT_EQ(IteratorState::AT_END, it->state());
+    return lsns;
+  };
+
+  EXPECT_EQ(std::vector<lsn_t>({20}), read_log(logid_t(2)));
+  EXPECT_GT(stats_.aggregate().sst_files_skipped_by_log_filter, 0);
+  EXPECT_EQ(std::vector<lsn_t>({10}), read_log(logid_t(1)));
+  EXPECT_EQ(std::vector<lsn_t>({10}), read_log(logid_t(3)));
+  EXPECT_EQ(std::vector<lsn_t>(), read_log(logid_t(4)));
+
+  // Same reads with the filter disabled.
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-skip-sst-files-without-log"] = "false";
+  openStore(s, customize_fn);
+  EXPECT_EQ(std::vector<lsn_t>({20}), read_log(logid_t(2)));
+  EXPECT_EQ(std::vector<lsn_t>({10}), read_log(logid_t(1)));
+}
+
+TEST_F(PartitionedRocksDBStoreTest, PerLogMemTableRep) {
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-memtable-rep"] = "per_log";
+  openStore(s);
+
+  // Mostly in order, with some out of order inserts and interleaved logs.
+  put({TestRecord(logid_t(2), 10), TestRecord(logid_t(1), 10)});
+  put({TestRecord(logid_t(1), 30), TestRecord(logid_t(1), 20)});
+  put({TestRecord(logid_t(3), 10), TestRecord(logid_t(1), 40)});
+  put({TestRecord(logid_t(2), 5), TestRecord(logid_t(1), 15)});
+
+  auto check = [&] {
+    auto it =
+        store_->read(logid_t(1), LocalLogStore::ReadOptions("PerLogMemTable"));
+    std::vector<lsn_t> lsns;
+    for (it->seek(LSN_OLDEST); it->state() == IteratorState::AT_RECORD;
+         it->next()) {
+      lsns.push_back(it->getLSN());
+    }
+    EXPECT_EQ(std::vector<lsn_t>({10, 15, 20, 30, 40}), lsns);
+
+    lsns.clear();
+    for (it->seekForPrev(35); it->state() == IteratorState::AT_RECORD;
+         it->prev()) {
+      lsns.push_back(it->getLSN());
+    }
+    EXPECT_EQ(std::vector<lsn_t>({30, 20, 15, 10}), lsns);
+
+    it = store_->read(logid_t(2), LocalLogStore::ReadOptions("PerLogMemTable"));
+    it->seek(6);
+    ASSERT_EQ(IteratorState::AT_RECORD, it->state());
+    EXPECT_EQ(10, it->getLSN());
+    it->prev();
+    ASSERT_EQ(IteratorState::AT_RECORD, it->state());
+    EXPECT_EQ(5, it->getLSN());
+  };
+
+  // Read from the mutable memtable, then from sst files.
+  check();
+  EXPECT_EQ(0, store_->flushAllMemtables());
+  check();
+  readAndCheck();
+}
+
+TEST_F(PartitionedRocksDBStoreTest, ParallelPartitionMetadataRead) {
+  increasing_lsns_ = false;
+  logid_t logid(1);
+  uint64_t g = RocksDBSettings::defaultTestSettings()
+                   .partition_timestamp_granularity_.count();
+  const auto t0 = FUTURE;
+  const int num_partitions = 7;
+
+  for (int i = 0; i < num_partitions; ++i) {
+    if (i > 0) {
+      store_->createPartition();
+    }
+    put({TestRecord(logid, 10 * (i + 1), t0 + 100 * i * g)});
+  }
+
+  // More partitions than threads, and more threads than partitions.
+  for (std::string threads : {"3", "20"}) {
+    closeStore();
+    ServerConfig::SettingsConfig s;
+    s["rocksdb-partition-metadata-read-threads"] = threads;
+    openStore(s);
+
+    auto partitions = store_->getPartitionList();
+    ASSERT_EQ(num_partitions, partitions->size());
+    for (int i = 0; i < num_partitions; ++i) {
+      EXPECT_EQ(
+          t0 + 100 * i * g - g,
+          partitions->get(ID0 + i)->min_timestamp.toMilliseconds().count());
+      EXPECT_EQ(
+          t0 + 100 * i * g + g,
+          partitions->get(ID0 + i)->max_timestamp.toMilliseconds().count());
+    }
+  }
+}
+
 TEST_F(PartitionedRocksDBStoreTest, MonotonicIteratorStressTest) {
   // Move iterators while writing new records. The concurrent writes used to
   // sometimes cause e.g. seek(`lsn`) to seek to an LSN smaller than `lsn`.
@@ -6814,6 +7045,75 @@ TEST_F(PartitionedRocksDBStoreTest, AnticipatoryDirty) {
   readAndCheck();
 }
 
+TEST_F(PartitionedRocksDBStoreTest, MinAppendTimestamp) {
+  logid_t logid(1);
+  lsn_t lsn = 1;
+
+  auto promotions = [this]() {
+    return stats_.aggregate().partition_sync_write_promotion_for_min_append_ts;
+  };
+  auto base_promotions = promotions();
+
+  auto latest_partition = store_->getLatestPartition();
+  auto& dirty_state = latest_partition->dirty_state_;
+  EXPECT_EQ(RecordTimestamp::max(),
+            RecordTimestamp(dirty_state.min_append_timestamp));
+
+  // The first append sets the bound. Rebuilding stores don't affect it.
+  put({TestRecord(logid,
+                  lsn++,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::APPEND,
+                  BASE_TIME + 20)});
+  EXPECT_EQ(RecordTimestamp::from(std::chrono::milliseconds(BASE_TIME + 20)),
+            RecordTimestamp(dirty_state.min_append_timestamp));
+  put({TestRecord(logid,
+                  lsn++,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::REBUILD,
+                  BASE_TIME + 5)});
+  put({TestRecord(logid,
+                  lsn++,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::APPEND,
+                  BASE_TIME + 30)});
+  EXPECT_EQ(RecordTimestamp::from(std::chrono::milliseconds(BASE_TIME + 20)),
+            RecordTimestamp(dirty_state.min_append_timestamp));
+  EXPECT_EQ(base_promotions, promotions());
+
+  // An older append lowers it.
+  put({TestRecord(logid,
+                  lsn++,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::APPEND,
+                  BASE_TIME + 10)});
+  EXPECT_EQ(RecordTimestamp::from(std::chrono::milliseconds(BASE_TIME + 10)),
+            RecordTimestamp(dirty_state.min_append_timestamp));
+  EXPECT_EQ(base_promotions + 1, promotions());
+
+  // The bound survives a round trip through PartitionDirtyMetadata.
+  PartitionDirtyMetadata meta = dirty_state.metadata();
+  Slice blob = meta.serialize();
+  PartitionDirtyMetadata read_meta;
+  ASSERT_EQ(0, read_meta.deserialize(blob));
+  EXPECT_EQ(RecordTimestamp::from(std::chrono::milliseconds(BASE_TIME + 10)),
+            read_meta.getMinAppendTimestamp());
+  EXPECT_EQ(meta.getAllDirtiedBy(), read_meta.getAllDirtiedBy());
+
+  // Metadata written by older versions has a 12-byte header and no bound.
+  std::vector<uint8_t> legacy(blob.size);
+  memcpy(legacy.data(), blob.data, blob.size);
+  uint16_t legacy_len = 12;
+  memcpy(legacy.data(), &legacy_len, sizeof(legacy_len));
+  PartitionDirtyMetadata legacy_meta;
+  ASSERT_EQ(
+      0, legacy_meta.deserialize(Slice(legacy.data(), legacy.size())));
+  EXPECT_EQ(RecordTimestamp::max(), legacy_meta.getMinAppendTimestamp());
+  EXPECT_EQ(meta.getAllDirtiedBy(), legacy_meta.getAllDirtiedBy());
+
+  latest_partition.reset();
+}
+
 TEST_F(PartitionedRocksDBStoreTest, DirectoryCleanupAfterCompaction) {
   ServerConfig::SettingsConfig s;
   s["rocksdb-partition-duration"] = "8h";
@@ -8969,6 +9269,43 @@ TEST_F(PartitionedRocksDBStoreTest, DataSizeOnRestart) {
   ASSERT_EQ(result, old_size);
 }
 
+// The size of a whole log is kept as a running total. Check that it follows
+// dropped partitions and survives a restart.
+TEST_F(PartitionedRocksDBStoreTest, DataSizeAfterDrop) {
+  const logid_t logid(1);
+  size_t result = 0;
+  auto dataSize = [&](RecordTimestamp lo, RecordTimestamp hi) {
+    EXPECT_EQ(0, store_->dataSize(logid, lo, hi, &result));
+    return result;
+  };
+  auto wholeLogSize = [&] {
+    return dataSize(RecordTimestamp::min(), RecordTimestamp::max());
+  };
+
+  put({TestRecord(logid, 10, BASE_TIME, std::string(1000, 'x'))});
+  setTime(BASE_TIME + 10 * MINUTE);
+  auto p2 = store_->createPartition();
+  put({TestRecord(
+      logid, 20, BASE_TIME + 10 * MINUTE, std::string(300, 'x'))});
+  setTime(BASE_TIME + 20 * MINUTE);
+  auto p3 = store_->createPartition();
+  put({TestRecord(logid, 30, BASE_TIME + 20 * MINUTE, std::string(50, 'x'))});
+
+  // Sizes of partitions 2 and 3 by walking the directory.
+  const size_t tail_size =
+      dataSize(p2->starting_timestamp, p3->starting_timestamp) +
+      dataSize(p3->starting_timestamp, RecordTimestamp::max());
+  ASSERT_GT(tail_size, 350);
+  ASSERT_GE(wholeLogSize(), tail_size + 1000);
+
+  store_->dropPartitionsUpTo(p2->id_);
+  EXPECT_EQ(tail_size, wholeLogSize());
+
+  closeStore();
+  openStore();
+  EXPECT_EQ(tail_size, wholeLogSize());
+}
+
 TEST_F(PartitionedRocksDBStoreTest, IteratorStaleMaxLsnBug) {
   logid_t logid(3);
 
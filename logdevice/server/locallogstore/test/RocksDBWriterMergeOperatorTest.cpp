@@ -75,6 +75,9 @@ ParseResult parse(const RawRecord& rec) {
 
 class RocksDBWriterMergeOperatorTest : public ::testing::Test {
  public:
+  explicit RocksDBWriterMergeOperatorTest(bool put_first_wave_records = false)
+      : store_(/* read_find_time_index */ false, put_first_wave_records) {}
+
   void storeRecords(const std::vector<TestRecord>& records) {
     store_fill(store_, records);
   }
@@ -607,4 +610,62 @@ TEST_F(RocksDBWriterMergeOperatorTest, CumulativeFlags) {
       });
 }
 
+// Like RocksDBWriterMergeOperatorTest but with first-wave records written as plain values rather
+// than merge operands.
+class RocksDBWriterPutFirstWaveTest : public RocksDBWriterMergeOperatorTest {
+ public:
+  RocksDBWriterPutFirstWaveTest() : RocksDBWriterMergeOperatorTest(true) {}
+};
+
+TEST_F(RocksDBWriterPutFirstWaveTest, SingleWave) {
+  storeRecords({TestRecord(LOG_ID, lsn_t(1), esn_t(0))
+                    .wave(1)
+                    .copyset({N1, N2, N3})
+                    .payload(Payload("foo", 3))});
+  verify(
+      [](const std::vector<RawRecord>& rec) {
+        ASSERT_EQ(1, rec.size());
+        ASSERT_EQ(1, parse(rec[0]).wave);
+        ASSERT_EQ(std::vector<ShardID>({N1, N2, N3}), parse(rec[0]).copyset);
+      },
+      [](const std::vector<RawRecord>& rec) {
+        ASSERT_EQ("foo", parse(rec[0]).payload);
+      });
+}
+
+// Amends and later waves are merged on top of a record written with Put(),
+// both in memtable and after the record was flushed.
+TEST_F(RocksDBWriterPutFirstWaveTest, AmendOnTopOfPut) {
+  for (int flush = 0; flush <= 1; ++flush) {
+    SCOPED_TRACE("flush = " + std::to_string(flush));
+    const lsn_t lsn = flush + 1;
+    storeRecords({TestRecord(LOG_ID, lsn, esn_t(0))
+                      .wave(1)
+                      .copyset({N1, N2, N3})
+                      .payload(Payload("foo", 3))});
+    if (flush) {
+      getStore().sync(Durability::MEMORY);
+    }
+    storeRecords({TestRecord(LOG_ID, lsn, esn_t(0))
+                      .wave(2)
+                      .copyset({N4, N5, N6, N7})
+                      .flagAmend()
+                      .payload(Payload())});
+  }
+  verify(
+      [](const std::vector<RawRecord>& rec) {
+        ASSERT_EQ(2, rec.size());
+        for (const RawRecord& r : rec) {
+          ASSERT_FALSE(parse(r).flags & FLAG_AMEND);
+          ASSERT_EQ(2, parse(r).wave);
+          ASSERT_EQ(std::vector<ShardID>({N4, N5, N6, N7}), parse(r).copyset);
+        }
+      },
+      [](const std::vector<RawRecord>& rec) {
+        for (const RawRecord& r : rec) {
+          ASSERT_EQ("foo", parse(r).payload);
+        }
+      });
+}
+
 } // namespace
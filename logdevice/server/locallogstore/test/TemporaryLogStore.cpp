@@ -215,14 +215,17 @@ int TemporaryLogStore::deleteAllLogSnapshotBlobs() {
   return db_->deleteAllLogSnapshotBlobs();
 }
 
-TemporaryRocksDBStore::TemporaryRocksDBStore(bool read_find_time_index)
-    : TemporaryLogStore([read_find_time_index](const std::string& path) {
+TemporaryRocksDBStore::TemporaryRocksDBStore(bool read_find_time_index,
+                                             bool put_first_wave_records)
+    : TemporaryLogStore([read_find_time_index,
+                         put_first_wave_records](const std::string& path) {
         // All tests should assume this is shard 0.
         shard_index_t shard_idx = 0;
 
         RocksDBSettings raw_settings = RocksDBSettings::defaultTestSettings();
         raw_settings.use_copyset_index = true;
         raw_settings.read_find_time_index = read_find_time_index;
+        raw_settings.put_first_wave_records = put_first_wave_records;
 
         UpdateableSettings<RocksDBSettings> settings(raw_settings);
         UpdateableSettings<RebuildingSettings> rebuilding_settings;
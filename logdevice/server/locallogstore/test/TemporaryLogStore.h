@@ -152,7 +152,8 @@ class TemporaryLogStore : public LocalLogStore {
 };
 
 struct TemporaryRocksDBStore : public TemporaryLogStore {
-  explicit TemporaryRocksDBStore(bool read_find_time_index = false);
+  explicit TemporaryRocksDBStore(bool read_find_time_index = false,
+                                 bool put_first_wave_records = false);
 };
 
 // A temporary logsdb store with fake clock.
@@ -377,6 +377,10 @@ int main(int argc, const char** argv) {
   auto server_settings_subscription = server_settings.callAndSubscribeToUpdates(
       std::bind(on_server_settings_changed, server_settings));
 
+  if (server_settings->log_async) {
+    dbg::enableAsyncWrites();
+  }
+
   // Now that the logging framework is initialised, log plugin info
   ld_info(
       "Plugins loaded: %s", plugin_registry->getStateDescriptionStr().c_str());
@@ -19,6 +19,7 @@
 #include "logdevice/common/configuration/ServerConfig.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/SHARD_STATUS_UPDATE_Message.h"
@@ -30,6 +31,7 @@
 #include "logdevice/server/read_path/IteratorCache.h"
 #include "logdevice/server/storage_tasks/EpochOffsetStorageTask.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
+#include "logdevice/server/storage_tasks/ReadBatchStorageTask.h"
 #include "logdevice/server/storage_tasks/ReadStorageTask.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
@@ -51,6 +53,10 @@ AllServerReadStreams::AllServerReadStreams(
       stats_(stats),
       settings_(settings),
       memory_budget_(max_read_storage_tasks_mem),
+      memory_budget_handle_(
+          MemoryGovernor::get()->registerBudget("read_storage_tasks",
+                                                &memory_budget_,
+                                                max_read_storage_tasks_mem)),
       worker_id_(worker_id),
       log_storage_state_map_(log_storage_state_map),
       on_worker_thread_(on_worker_thread) {}
@@ -132,11 +138,7 @@ AllServerReadStreams::insertOrGet(ClientID client_id,
     if (on_worker_thread_) {
       // initialize the iterator cache
       deref(insert_result.first).iterator_cache_ =
-          std::make_shared<IteratorCache>(
-              &processor_->sharded_storage_thread_pool_->getByIndex(shard)
-                   .getLocalLogStore(),
-              log_id,
-              false /* created_for_rebuilding */);
+          makeIteratorCache(log_id, shard);
     }
   } else {
     deref(insert_result.first).log_group_path_ = log_group_path;
@@ -145,6 +147,27 @@ AllServerReadStreams::insertOrGet(ClientID client_id,
   return std::make_pair(&deref(insert_result.first), insert_result.second);
 }
 
+std::shared_ptr<IteratorCache>
+AllServerReadStreams::makeIteratorCache(logid_t log_id, shard_index_t shard) {
+  const bool share_iterators = settings_->share_read_iterators;
+  if (share_iterators) {
+    // Use the same cache as other streams reading this log from this shard.
+    const auto& log_index = streams_.get<LogShardIndex>();
+    auto range = log_index.equal_range(boost::make_tuple(log_id, shard));
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->iterator_cache_ && it->iterator_cache_->isShared()) {
+        return it->iterator_cache_;
+      }
+    }
+  }
+  return std::make_shared<IteratorCache>(
+      &processor_->sharded_storage_thread_pool_->getByIndex(shard)
+           .getLocalLogStore(),
+      log_id,
+      false /* created_for_rebuilding */,
+      share_iterators);
+}
+
 ServerReadStream* AllServerReadStreams::get(ClientID client_id,
                                             logid_t log_id,
                                             read_stream_id_t read_stream_id,
@@ -196,6 +219,23 @@ void AllServerReadStreams::eraseAllForClient(ClientID client_id) {
   }
 }
 
+ClientID AllServerReadStreams::getBusiestClient() const {
+  if (client_states_.size() < 2) {
+    return ClientID::INVALID;
+  }
+  const auto& client_index = streams_.get<ClientIndex>();
+  ClientID busiest = ClientID::INVALID;
+  size_t busiest_streams = 0;
+  for (const auto& kv : client_states_) {
+    const size_t n = client_index.count(kv.first);
+    if (n > busiest_streams) {
+      busiest = kv.first;
+      busiest_streams = n;
+    }
+  }
+  return busiest;
+}
+
 void AllServerReadStreams::notifyNeedsCatchup(ServerReadStream& stream,
                                               bool allow_delay) {
   if (canScheduleForCatchup(stream)) {
@@ -225,6 +265,12 @@ void AllServerReadStreams::scheduleForCatchup(
     ServerReadStream& stream,
     bool allow_delay,
     CatchupEventTrigger catchup_reason) {
+  if (stream.isHibernated()) {
+    stream.wakeUp(on_worker_thread_
+                      ? makeIteratorCache(stream.log_id_, stream.shard_)
+                      : nullptr);
+  }
+
   // This should be called after insertOrGet() so there should be an
   // entry in client_states_.
   auto it = client_states_.find(stream.client_id_);
@@ -260,11 +306,23 @@ void AllServerReadStreams::invalidateIterators(ClientID client_id) {
   auto range = streams_.get<ClientIndex>().equal_range(client_id);
   auto now = std::chrono::steady_clock::now();
   auto ttl = Worker::settings().iterator_cache_ttl;
+  auto hibernate_after = settings_->server_read_stream_hibernate_after;
 
   for (auto it = range.first; it != range.second; ++it) {
+    if (it->isHibernated()) {
+      continue;
+    }
     ld_check(it->iterator_cache_ && "IteratorCache not set");
 
     it->iterator_cache_->invalidateIfUnused(now, ttl);
+
+    // Hibernate streams that are caught up and haven't had anything to read
+    // for a while. They'll be woken up by scheduleForCatchup() when a RELEASE
+    // or WINDOW gives them something to read.
+    if (hibernate_after.count() > 0 &&
+        it->canHibernate(now, hibernate_after)) {
+      deref(it).hibernate();
+    }
   }
 }
 
@@ -300,6 +358,23 @@ void AllServerReadStreams::onRecordSent(ClientID client_id,
   }
 }
 
+void AllServerReadStreams::onRecordBatchSent(
+    ClientID client_id,
+    const RECORD_BATCH_Message& msg,
+    const SteadyTimestamp enqueue_time) {
+  auto it = client_states_.find(client_id);
+  if (it != client_states_.end()) {
+    ld_check(it->second.catchup_queue);
+    auto* stream = get(client_id,
+                       msg.header_.log_id,
+                       msg.header_.read_stream_id,
+                       msg.header_.shard);
+    it->second.catchup_queue->onRecordBatchSent(msg, stream, enqueue_time);
+  } else {
+    // Client disconnected, nothing to do.
+  }
+}
+
 void AllServerReadStreams::onStartedSent(ClientID client_id,
                                          const STARTED_Message& msg,
                                          const SteadyTimestamp enqueue_time) {
@@ -331,6 +406,11 @@ void AllServerReadStreams::onEpochOffsetTask(EpochOffsetStorageTask& task) {
   if (task.status_ == E::OK) {
     task.stream_.get()->epoch_offsets_ =
         std::make_pair(task.epoch_, task.result_offsets_);
+    LogStorageState* log_state =
+        log_storage_state_map_->find(task.log_id_, stream->shard_);
+    if (log_state) {
+      log_state->noteEpochStartOffsets(task.epoch_, task.result_offsets_);
+    }
   } else {
     ld_error("Got error while executing EpochOffsetStorageTask for epoch %u "
              "in log %ld with status=%s",
@@ -355,6 +435,12 @@ void AllServerReadStreams::onReadTaskDone(ReadStorageTask& task) {
 void AllServerReadStreams::onReadTaskDropped(ReadStorageTask& task) {
   ld_check(read_storage_tasks_in_flight_ > 0);
   read_storage_tasks_in_flight_--;
+  ServerReadStream* stream = task.stream_.get();
+  if (stream && stream->iterator_cache_) {
+    // The task didn't get to use the iterator it may have leased.
+    stream->iterator_cache_->release(
+        task.options_, task.iterator_from_cache_.lock().get());
+  }
   if (task.catchup_queue_) {
     task.catchup_queue_->onStorageTaskDropped(task.stream_.get());
   } else {
@@ -688,8 +774,53 @@ void AllServerReadStreams::sendStorageTask(
     shard_index_t shard) {
   ServerWorker* worker = ServerWorker::onThisThread();
   ld_check(worker);
-  auto task_queue = worker->getStorageTaskQueueForShard(shard);
-  task_queue->putTask(std::move(task));
+  const size_t max_batch_size = settings_->read_storage_task_max_batch_size;
+  if (max_batch_size <= 1) {
+    auto task_queue = worker->getStorageTaskQueueForShard(shard);
+    task_queue->putTask(std::move(task));
+    return;
+  }
+
+  ReadTaskBatchKey key{shard,
+                       task->getThreadType(),
+                       task->getPriority(),
+                       task->getPrincipal(),
+                       task->reqTenant()};
+  auto& batch = read_task_batches_[key];
+  batch.push_back(std::move(task));
+  if (batch.size() < max_batch_size) {
+    // Wait for more tasks until the end of this event loop iteration.
+    if (!send_read_task_batches_timer_.isAssigned()) {
+      send_read_task_batches_timer_.assign([this] { sendReadTaskBatches(); });
+    }
+    send_read_task_batches_timer_.activate(std::chrono::microseconds(0));
+    return;
+  }
+
+  std::vector<std::unique_ptr<ReadStorageTask>> tasks = std::move(batch);
+  read_task_batches_.erase(key);
+  STAT_INCR(stats_, read_storage_task_batches);
+  worker->getStorageTaskQueueForShard(shard)->putTask(
+      std::make_unique<ReadBatchStorageTask>(std::move(tasks)));
+}
+
+void AllServerReadStreams::sendReadTaskBatches() {
+  ServerWorker* worker = ServerWorker::onThisThread();
+  ld_check(worker);
+  auto batches = std::move(read_task_batches_);
+  read_task_batches_.clear();
+  for (auto& kv : batches) {
+    const shard_index_t shard = std::get<0>(kv.first);
+    auto task_queue = worker->getStorageTaskQueueForShard(shard);
+    auto& tasks = kv.second;
+    if (tasks.size() == 1) {
+      task_queue->putTask(std::move(tasks.front()));
+    } else if (!tasks.empty()) {
+      STAT_INCR(stats_, read_storage_task_batches);
+      task_queue->putTask(
+          std::make_unique<ReadBatchStorageTask>(std::move(tasks)));
+    }
+  }
 }
 
 ResourceBudget& AllServerReadStreams::getMemoryBudget() {
@@ -724,10 +855,12 @@ void AllServerReadStreams::evictRealTimeLog(logid_t logid) {
   ld_check(logid != LOGID_INVALID2);
 
   auto range = streams_.get<LogIndex>().equal_range(logid);
+  const bool had_tail = tail_records_.erase(logid) > 0;
   // Items can only ever come off on this thread, so nothing should have
   // removed entries / read streams between the "toEvict()' call above and the
-  // "equal_range' call.
-  ld_check(range.first != range.second);
+  // "equal_range' call.  The only other thing holding on to released records
+  // is the tail tier, which may outlive the log's last stream.
+  ld_check(range.first != range.second || had_tail);
   for (auto it = range.first; it != range.second; ++it) {
     auto recs = deref(it).giveReleasedRecords();
     STAT_ADD(stats_, real_time_record_buffer_eviction, recs.size());
@@ -870,12 +1003,41 @@ void AllServerReadStreams::distributeNewlyReleasedRecords() {
         real_time_record_buffer_.addToLRU(records->logid_);
         std::shared_ptr<ReleasedRecords> ptr{records.release()};
         auto range = streams_.get<LogIndex>().equal_range(ptr->logid_);
+        if (range.first == range.second) {
+          return;
+        }
         for (auto it = range.first; it != range.second; ++it) {
           deref(it).addReleasedRecords(ptr);
         }
+        const size_t tail_budget = settings_->real_time_tail_bytes_per_log;
+        if (tail_budget > 0) {
+          TailRecords& tail = tail_records_[ptr->logid_];
+          tail.bytes += ptr->getBytesEstimate();
+          tail.records.push_back(std::move(ptr));
+          while (tail.bytes > tail_budget && tail.records.size() > 1) {
+            tail.bytes -= tail.records.front()->getBytesEstimate();
+            tail.records.pop_front();
+            STAT_INCR(stats_, real_time_tail_tier_evictions);
+          }
+        }
       });
 }
 
+std::vector<std::shared_ptr<ReleasedRecords>>
+AllServerReadStreams::getTailRecords(logid_t logid, lsn_t from) {
+  std::vector<std::shared_ptr<ReleasedRecords>> res;
+  auto it = tail_records_.find(logid);
+  if (it == tail_records_.end()) {
+    return res;
+  }
+  for (const auto& recs : it->second.records) {
+    if (!(*recs < from)) {
+      res.push_back(recs);
+    }
+  }
+  return res;
+}
+
 Request::Execution EvictRealTimeRequest::execute() {
   ServerWorker::onThisThread()->serverReadStreams().evictRealTime();
   return Request::Execution::COMPLETE;
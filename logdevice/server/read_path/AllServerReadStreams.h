@@ -7,9 +7,12 @@
  */
 #pragma once
 
+#include <deque>
 #include <map>
 #include <queue>
 #include <set>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include <boost/multi_index/composite_key.hpp>
@@ -21,10 +24,12 @@
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
 #include "logdevice/common/FlowGroup.h"
+#include "logdevice/common/MemoryGovernor.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/ResourceBudget.h"
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
 #include "logdevice/common/SocketCallback.h"
+#include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
@@ -37,6 +42,7 @@
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 #include "logdevice/server/read_path/ReadIoShapingCallback.h"
 #include "logdevice/server/read_path/ServerReadStream.h"
+#include "logdevice/server/read_path/SharedRecordPayloads.h"
 
 namespace facebook { namespace logdevice {
 
@@ -50,7 +56,9 @@ namespace facebook { namespace logdevice {
  */
 
 class EpochOffsetStorageTask;
+class IteratorCache;
 class ReadStorageTask;
+class RECORD_BATCH_Message;
 class RECORD_Message;
 class StatsHolder;
 class ServerProcessor;
@@ -138,6 +146,14 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
    */
   void eraseAllForClient(ClientID client_id);
 
+  /**
+   * @return  the client with the most read streams on this worker, or an
+   *          invalid ClientID if fewer than two clients are reading. Used to
+   *          pick a connection to move off an overloaded worker, see
+   *          --worker-load-rebalancing-ratio.
+   */
+  ClientID getBusiestClient() const;
+
   /**
    * Called when reading starts or when a new record is released for delivery,
    * effectively notifying this class that the read stream is behind and needs
@@ -155,7 +171,8 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   /**
    * Walks through the list of all read streams for the given client ID and
    * invalidate cached iterators which haven't been used in the last
-   * Settings::iterator_cache_ttl milliseconds.
+   * Settings::iterator_cache_ttl milliseconds. Also hibernates streams that
+   * have been idle for Settings::server_read_stream_hibernate_after.
    */
   void invalidateIterators(ClientID client_id);
 
@@ -176,6 +193,13 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
                     const RECORD_Message& msg,
                     const SteadyTimestamp enqueue_time);
 
+  /**
+   * Same as onRecordSent() for a RECORD_BATCH message.
+   */
+  void onRecordBatchSent(ClientID client_id,
+                         const RECORD_BATCH_Message& msg,
+                         const SteadyTimestamp enqueue_time);
+
   /**
    * Called when the messaging layer drains a STARTED message from the output
    * evbuffer.
@@ -260,6 +284,8 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
 
     streams_.clear();
     client_states_.clear();
+    tail_records_.clear();
+    shared_record_payloads_.clear();
     // Free all released records that we didn't get around to sending.
     // This moves EpochRecordCacheEntrys to various workers, so
     // must be run before the Worker::~Worker() is called.
@@ -286,7 +312,7 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
    * settings are updated).
    */
   void setMemoryBudget(uint64_t max_read_storage_tasks_mem) {
-    memory_budget_.setLimit(max_read_storage_tasks_mem);
+    memory_budget_handle_.setBaseLimit(max_read_storage_tasks_mem);
   }
 
   ResourceBudget& getMemoryBudget();
@@ -295,6 +321,10 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
     return real_time_record_buffer_;
   }
 
+  SharedRecordPayloads& getSharedRecordPayloads() {
+    return shared_record_payloads_;
+  }
+
   /**
    * This method can be called from any thread, including storage threads.  It's
    * called with the EpochRecordCache rw lock held, so it should be as fast as
@@ -315,6 +345,14 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
    */
   void distributeNewlyReleasedRecords();
 
+  /**
+   * Returns the groups of released records for `logid' kept in the tail tier
+   * (see Settings::real_time_tail_bytes_per_log) that contain records at or
+   * after `from', oldest first.
+   */
+  std::vector<std::shared_ptr<ReleasedRecords>> getTailRecords(logid_t logid,
+                                                               lsn_t from);
+
   /**
    * Tell the real time record cache that we recently used the records from a
    * given log, so it can take this information into account in its eviction
@@ -372,6 +410,9 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // event loop iteration.
   virtual void scheduleSendDelayedStorageTasks();
 
+  // Sends all ReadStorageTasks accumulated in read_task_batches_.
+  void sendReadTaskBatches();
+
  protected:
   //
   // Main data structure containing ServerReadStream instances.  We use a
@@ -440,6 +481,22 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
 
   RealTimeRecordBuffer real_time_record_buffer_;
 
+  // Tail tier: the most recently released records of each log with readers
+  // on this worker, kept after distributeNewlyReleasedRecords() handed them to
+  // the streams. Streams that fell slightly behind can still be served from
+  // memory. The ReleasedRecords are the same objects the streams get, so the
+  // memory is accounted for by real_time_record_buffer_, and evicting a log
+  // from it also drops the log's tail.
+  struct TailRecords {
+    std::deque<std::shared_ptr<ReleasedRecords>> records;
+    size_t bytes{0};
+  };
+  std::unordered_map<logid_t, TailRecords, logid_t::Hash> tail_records_;
+
+  // Payload copies shared by RECORD messages of real time reads, see
+  // SharedRecordPayloads.
+  SharedRecordPayloads shared_record_payloads_;
+
   /**
    * Retrieve a ServerReadStream behind an iterator. boost::multi_index does not
    * allow retrieving a non const ServerReadStream because modifying its
@@ -457,6 +514,14 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
    */
   void evictRealTimeLog(logid_t);
 
+  /**
+   * Creates the IteratorCache for a new or woken up read stream, or returns
+   * the cache shared by other streams of the log if --share-read-iterators
+   * is set.
+   */
+  std::shared_ptr<IteratorCache> makeIteratorCache(logid_t log_id,
+                                                   shard_index_t shard);
+
   /**
    * Wake up all the read streams for which `pred` returns true in the specified
    * range.
@@ -529,6 +594,10 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
 
   ResourceBudget memory_budget_;
 
+  // Registers memory_budget_ with MemoryGovernor, which may lower its limit
+  // when the process as a whole uses too much memory.
+  MemoryGovernor::Handle memory_budget_handle_;
+
   // Current number of ReadStorageTasks in flight.
   // Used for assertions.
   size_t read_storage_tasks_in_flight_{0};
@@ -547,6 +616,23 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // away because it's not nice to post more tasks from onDropped() callback.
   Timer send_delayed_storage_tasks_timer_;
 
+  // ReadStorageTasks created during the current event loop iteration that
+  // will be sent to storage threads together in ReadBatchStorageTasks, see
+  // --read-storage-task-max-batch-size. Tasks can only be batched if they
+  // go to the same shard and the same storage thread queue, and are
+  // accounted to the same principal and read tenant.
+  using ReadTaskBatchKey = std::tuple<shard_index_t,
+                                      StorageTaskThreadType,
+                                      StorageTaskPriority,
+                                      StorageTaskPrincipal,
+                                      uint64_t>;
+  std::map<ReadTaskBatchKey, std::vector<std::unique_ptr<ReadStorageTask>>>
+      read_task_batches_;
+
+  // A zero-delay timer to send what's left in read_task_batches_ at the end
+  // of the event loop iteration.
+  Timer send_read_task_batches_timer_;
+
   // Worker ID we are on, used to manage subscriptions for RELEASE messages.
   // In production, this is always equal to Worker::onThisThread()->idx_.  In
   // unit tests where there is no Worker, the test supplies a fake value.
@@ -15,6 +15,7 @@
 
 #include <folly/CppAttributes.h>
 #include <folly/Optional.h>
+#include <folly/ScopeGuard.h>
 
 #include "logdevice/common/BWAvailableCallback.h"
 #include "logdevice/common/Checksum.h"
@@ -24,6 +25,7 @@
 #include "logdevice/common/ServerRecordFilter.h"
 #include "logdevice/common/configuration/InternalLogs.h"
 #include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/stats/Histogram.h"
@@ -180,8 +182,58 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
         source_(source),
         catchup_reason_(reason) {}
 
+  ~ReadingCallback() override {
+    ld_check(batch_.empty());
+  }
+
+  // Result of evaluating the stream's server-side filter on a record.
+  struct FilterResult {
+    bool filtered_out = false;
+    // Valid if filtered_out is true.
+    LocalLogStoreRecordFormat::flags_t flags = 0;
+  };
+
   int processRecord(const RawRecord& record) override;
 
+  // Same as processRecord() but, if the record's blob is owned, allows its
+  // buffer to be handed over to the RECORD message instead of copying the
+  // payload out of it. `filter` is the result of filterRecords() for this
+  // record.
+  int processOwnedRecord(RawRecord& record, FilterResult filter);
+
+  // Processes an entry of the real time record buffer. Instead of a private
+  // copy of the payload, the RECORD message references a copy shared with
+  // RECORDs of the same record for other streams on this Worker (see
+  // SharedRecordPayloads).
+  int processRealTimeRecord(const ZeroCopiedRecord& entry);
+
+  /**
+   * Evaluates the stream's server-side filter on the FILTERABLE keys of a
+   * batch of records in one pass, looking only at the headers of the
+   * records. Records that are rejected don't need to be parsed any further:
+   * processOwnedRecord() only accounts for them in the FILTERED_OUT gap.
+   */
+  std::vector<FilterResult>
+  filterRecords(const std::vector<RawRecord>& records) const;
+
+  /**
+   * Makes shipRecord() hold back records that RECORD_BATCH_Message::canBatch()
+   * and send them together in RECORD_BATCH messages of about `max_bytes`
+   * bytes of payload. flushBatch() must be called after the last record.
+   */
+  void enableBatching(size_t max_bytes) {
+    batch_max_bytes_ = max_bytes;
+  }
+
+  /**
+   * Sends the records held back by shipRecord(), if any. On failure, rolls
+   * the stream back to before the first of them, so that they get read and
+   * shipped again.
+   *
+   * @return 0 on success, -1 on failure, with err set as in shipRecord().
+   */
+  int flushBatch();
+
   int nrecords_ = 0;
 
   int processRecord(const lsn_t lsn,
@@ -196,6 +248,19 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
                     const OffsetMap& offsets_within_epoch);
 
  private:
+  int processRecord(const RawRecord& record, FilterResult filter);
+
+  int processRecord(const lsn_t lsn,
+                    const bool filtered_out,
+                    const std::chrono::milliseconds timestamp,
+                    const LocalLogStoreRecordFormat::flags_t flags,
+                    const Payload& payload,
+                    const uint32_t wave,
+                    const esn_t last_known_good,
+                    const copyset_size_t copyset_size,
+                    const ShardID* const copyset,
+                    const OffsetMap& offsets_within_epoch);
+
   // Sends a RECORD_Message for the given record over the wire
   int shipRecord(lsn_t lsn,
                  std::chrono::milliseconds timestamp,
@@ -221,16 +286,146 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
   LocalLogStore* store_;
   ServerReadStream::RecordSource source_;
   CatchupEventTrigger catchup_reason_;
+
+  // See enableBatching(). 0 if batching is disabled.
+  size_t batch_max_bytes_ = 0;
+
+  // Records held back by shipRecord(), and the size of their payloads.
+  std::vector<std::unique_ptr<RECORD_Message>> batch_;
+  size_t batch_bytes_ = 0;
+
+  // State of the stream before the first record of batch_ was shipped,
+  // restored if flushBatch() fails.
+  lsn_t batch_prev_last_delivered_lsn_ = LSN_INVALID;
+  lsn_t batch_prev_last_delivered_record_ = LSN_INVALID;
+  LocalLogStoreReader::ReadPointer batch_prev_read_ptr_{LSN_INVALID};
+
+  // Record currently being processed by processOwnedRecord(), if any.
+  RawRecord* adoptable_record_ = nullptr;
+
+  // True while processRealTimeRecord() is running.
+  bool real_time_record_ = false;
 };
 
+int ReadingCallback::processOwnedRecord(RawRecord& record,
+                                        FilterResult filter) {
+  adoptable_record_ = &record;
+  SCOPE_EXIT {
+    adoptable_record_ = nullptr;
+  };
+  return processRecord(record, filter);
+}
+
+int ReadingCallback::processRealTimeRecord(const ZeroCopiedRecord& entry) {
+  real_time_record_ = true;
+  SCOPE_EXIT {
+    real_time_record_ = false;
+  };
+  return processRecord(
+      entry.lsn,
+      std::chrono::milliseconds(entry.timestamp),
+      entry.flags,
+      entry.keys,
+      Payload(entry.payload_raw.data, entry.payload_raw.size),
+      entry.wave_or_recovery_epoch,
+      entry.last_known_good,
+      entry.copyset.size(),
+      entry.copyset.data(),
+      entry.offsets_within_epoch);
+}
+
+std::vector<ReadingCallback::FilterResult>
+ReadingCallback::filterRecords(const std::vector<RawRecord>& records) const {
+  std::vector<FilterResult> results(records.size());
+  if (stream_->filter_pred_ == nullptr) {
+    return results;
+  }
+
+  // Keys of the records that have one, and the indices of these records.
+  std::vector<folly::StringPiece> keys;
+  std::vector<size_t> key_records;
+  keys.reserve(records.size());
+  key_records.reserve(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    folly::Optional<folly::StringPiece> key;
+    if (LocalLogStoreRecordFormat::parseFilterableKey(
+            records[i].blob, &results[i].flags, &key) != 0) {
+      // Let the full parse in processRecord() deal with it.
+      continue;
+    }
+    if (key.hasValue()) {
+      keys.push_back(key.value());
+      key_records.push_back(i);
+    }
+  }
+  if (keys.empty()) {
+    return results;
+  }
+
+  std::unique_ptr<bool[]> passed(new bool[keys.size()]);
+  stream_->filter_pred_->filterBatch(keys.data(), keys.size(), passed.get());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    results[key_records[i]].filtered_out = !passed[i];
+  }
+  return results;
+}
+
 int ReadingCallback::processRecord(const RawRecord& record) {
+  FilterResult filter;
+  if (stream_->filter_pred_ != nullptr) {
+    folly::Optional<folly::StringPiece> key;
+    if (LocalLogStoreRecordFormat::parseFilterableKey(
+            record.blob, &filter.flags, &key) == 0 &&
+        key.hasValue()) {
+      filter.filtered_out = !(*stream_->filter_pred_)(key.value());
+    }
+  }
+  return processRecord(record, filter);
+}
+
+int ReadingCallback::processRecord(const RawRecord& record,
+                                   FilterResult filter) {
   const lsn_t lsn = record.lsn;
 
+  // NOTE: record.from_under_replicated_region reflects the sticky state
+  //       of our read iterator, not the absolute state of the partition
+  //       the record came from. This ensures that any implied gaps in
+  //       the record stream properly reflect any under-replication.
+  //
+  //       However, this isn't quite enough to ensure implied gaps are
+  //       properly classified. Consider two back to back reads, the
+  //       first ending at the boundary of an under-replicated region
+  //       and the next read starting in a fully-replicated region. Any
+  //       implied gap between these two reads must be reported as
+  //       under-replicated. In most cases, CatchupOneStream will
+  //       issue explicit gaps between reads when necessary. But it doesn't
+  //       do this if the reads are for the same "logical read": the first
+  //       read attempt being non-blocking, the second blocking. To ensure
+  //       under-replication is never under-estimated in this scenario,
+  //       we treat the stream under-replication state as sticky too. It
+  //       is only reset at the end of each read if the read only accessed
+  //       fully replicated portions of the LocalLogStore.
+  stream_->in_under_replicated_region_ |= record.from_under_replicated_region;
+
+  if (filter.filtered_out) {
+    // We already know the record won't be shipped, no need to parse the rest
+    // of it.
+    return processRecord(lsn,
+                         /*filtered_out=*/true,
+                         std::chrono::milliseconds(0),
+                         filter.flags,
+                         Payload(),
+                         0,
+                         ESN_INVALID,
+                         0,
+                         nullptr,
+                         OffsetMap());
+  }
+
   // Parse the local log store blob
   std::chrono::milliseconds timestamp;
   Payload payload;
   LocalLogStoreRecordFormat::flags_t flags;
-  std::map<KeyType, std::string> optional_keys;
   copyset_size_t copyset_size;
   esn_t last_known_good;
   ShardID* copyset = nullptr;
@@ -250,7 +445,7 @@ int ReadingCallback::processRecord(const RawRecord& record) {
       stream_->include_extra_metadata_ ? copyset : nullptr,
       COPYSET_SIZE_MAX,
       &offsets_within_epoch,
-      stream_->filter_pred_ != nullptr ? &optional_keys : nullptr,
+      nullptr,
       &payload,
       stream_->shard_);
 
@@ -259,29 +454,10 @@ int ReadingCallback::processRecord(const RawRecord& record) {
     return -1;
   }
 
-  // NOTE: record.from_under_replicated_region reflects the sticky state
-  //       of our read iterator, not the absolute state of the partition
-  //       the record came from. This ensures that any implied gaps in
-  //       the record stream properly reflect any under-replication.
-  //
-  //       However, this isn't quite enough to ensure implied gaps are
-  //       properly classified. Consider two back to back reads, the
-  //       first ending at the boundary of an under-replicated region
-  //       and the next read starting in a fully-replicated region. Any
-  //       implied gap between these two reads must be reported as
-  //       under-replicated. In most cases, CatchupOneStream will
-  //       issue explicit gaps between reads when necessary. But it doesn't
-  //       do this if the reads are for the same "logical read": the first
-  //       read attempt being non-blocking, the second blocking. To ensure
-  //       under-replication is never under-estimated in this scenario,
-  //       we treat the stream under-replication state as sticky too. It
-  //       is only reset at the end of each read if the read only accessed
-  //       fully replicated portions of the LocalLogStore.
-  stream_->in_under_replicated_region_ |= record.from_under_replicated_region;
   return processRecord(lsn,
+                       /*filtered_out=*/false,
                        timestamp,
                        flags,
-                       optional_keys,
                        payload,
                        wave,
                        last_known_good,
@@ -301,8 +477,6 @@ int ReadingCallback::processRecord(
     const copyset_size_t copyset_size,
     const ShardID* const copyset,
     const OffsetMap& offsets_within_epoch) {
-  ld_check(lsn > stream_->last_delivered_lsn_);
-
   // [Experimental Feature] If server-side filtering is enabled, we should
   // do filtering here. If record key can not pass record filter,
   // filtered_out will be set to be true. A gap message with reason
@@ -319,6 +493,31 @@ int ReadingCallback::processRecord(
     }
   }
 
+  return processRecord(lsn,
+                       filtered_out,
+                       timestamp,
+                       flags,
+                       payload,
+                       wave,
+                       last_known_good,
+                       copyset_size,
+                       copyset,
+                       offsets_within_epoch);
+}
+
+int ReadingCallback::processRecord(
+    const lsn_t lsn,
+    const bool filtered_out,
+    const std::chrono::milliseconds timestamp,
+    const LocalLogStoreRecordFormat::flags_t flags,
+    const Payload& payload,
+    const uint32_t wave,
+    const esn_t last_known_good,
+    const copyset_size_t copyset_size,
+    const ShardID* const copyset,
+    const OffsetMap& offsets_within_epoch) {
+  ld_check(lsn > stream_->last_delivered_lsn_);
+
   // Insert a TRIM gap for any records before this one that have been trimmed
   // between the time the read for this record was scheduled (pushRecords()
   // with its trim check) and read completed. This ensures that the client can
@@ -343,6 +542,10 @@ int ReadingCallback::processRecord(
   if (trim_point.hasValue() &&
       stream_->last_delivered_lsn_ < trim_point.value() &&
       lsn > stream_->last_delivered_lsn_ + 1) {
+    // Records held back for a RECORD_BATCH must reach the client first.
+    if (flushBatch() != 0) {
+      return -1;
+    }
     int rv = catchup_->sendGAP(
         std::min(trim_point.value(), lsn - 1), GapReason::TRIM);
 
@@ -361,24 +564,14 @@ int ReadingCallback::processRecord(
   // Iterators are expected to skip amends that don't correspond to any record.
   ld_check(!(flags & LocalLogStoreRecordFormat::FLAG_AMEND));
 
-  std::unique_ptr<ExtraMetadata> extra_metadata;
-  if (stream_->include_extra_metadata_) {
-    DCHECK_NOTNULL(copyset);
-    extra_metadata = this->prepareExtraMetadata(
-        last_known_good, wave, copyset, copyset_size, offsets_within_epoch);
-  }
-
-  OffsetMap offsets;
-  if (stream_->include_byte_offset_ && offsets_within_epoch.isValid()) {
-    // epoch OffsetMap value has to be known to determine global OffsetMap.
-    OffsetMap epoch_offsets = getEpochOffsets(lsn_to_epoch(lsn), log_state);
-    if (epoch_offsets.isValid()) {
-      offsets = OffsetMap::mergeOffsets(
-          std::move(epoch_offsets), offsets_within_epoch);
+  if (filtered_out) {
+    // Records held back for a RECORD_BATCH must reach the client before the
+    // FILTERED_OUT gap. Flushing here also keeps batches free of filtered
+    // out records, which flushBatch() couldn't roll back.
+    if (flushBatch() != 0) {
+      return -1;
     }
-  }
 
-  if (filtered_out) {
     // If filtered_out_end_lsn_ is not lsn - 1, FILTERED_OUT gap is not
     // continuous between filtered_out_end_lsn_ and lsn. We deliver last
     // FILTERED_OUT gap and set filtered_out_end_lsn_ to current lsn.
@@ -403,6 +596,23 @@ int ReadingCallback::processRecord(
       return -1;
     }
 
+    std::unique_ptr<ExtraMetadata> extra_metadata;
+    if (stream_->include_extra_metadata_) {
+      DCHECK_NOTNULL(copyset);
+      extra_metadata = this->prepareExtraMetadata(
+          last_known_good, wave, copyset, copyset_size, offsets_within_epoch);
+    }
+
+    OffsetMap offsets;
+    if (stream_->include_byte_offset_ && offsets_within_epoch.isValid()) {
+      // epoch OffsetMap value has to be known to determine global OffsetMap.
+      OffsetMap epoch_offsets = getEpochOffsets(lsn_to_epoch(lsn), log_state);
+      if (epoch_offsets.isValid()) {
+        offsets = OffsetMap::mergeOffsets(
+            std::move(epoch_offsets), offsets_within_epoch);
+      }
+    }
+
     int rv = shipRecord(lsn,
                         timestamp,
                         flags,
@@ -433,9 +643,11 @@ int ReadingCallback::processRecord(
     stream_->setReadPtr(lsn + 1);
   }
 
-  stream_->noteSent(catchup_->deps_.getStatsHolder(),
-                    source_,
-                    RECORD_Message::expectedSize(payload.size()));
+  // Payloads of filtered out records aren't parsed, let alone sent.
+  stream_->noteSent(
+      catchup_->deps_.getStatsHolder(),
+      source_,
+      RECORD_Message::expectedSize(filtered_out ? 0 : payload.size()));
 
   return 0;
 }
@@ -471,6 +683,14 @@ OffsetMap ReadingCallback::getEpochOffsets(epoch_t record_epoch,
     return epoch_offsets_from_metadata.value().second;
   }
 
+  // Another read stream of the log may have looked them up already.
+  folly::Optional<OffsetMap> epoch_start_offsets =
+      log_state.getEpochStartOffsets(record_epoch);
+  if (epoch_start_offsets.hasValue()) {
+    STAT_INCR(catchup_->deps_.getStatsHolder(), epoch_offset_index_hits);
+    return std::move(epoch_start_offsets.value());
+  }
+
   // PerEpochLogMetadata is written on node after epoch recovery.
   // So, PerEpochLogMetadata for record_epoch is already stored on node if
   // record_epoch is not active epoch which sequencer use.
@@ -492,6 +712,8 @@ OffsetMap ReadingCallback::getEpochOffsets(epoch_t record_epoch,
     if (rv == 0) {
       ld_check(metadata.header_.epoch_end_offset ==
                metadata.epoch_end_offsets_.getCounter(BYTE_OFFSET));
+      log_state.noteEpochStartOffsets(record_epoch,
+                                      metadata.epoch_end_offsets_);
       return metadata.epoch_end_offsets_;
     } else if (rv != 0 && err == E::LOCAL_LOG_STORE_READ) {
       ld_error("Error while reading PerEpochLogMetadata for epoch %u",
@@ -516,8 +738,10 @@ OffsetMap ReadingCallback::getEpochOffsets(epoch_t record_epoch,
       if (rv == 0) {
         ld_check(metadata_.header_.epoch_end_offset ==
                  metadata_.epoch_end_offsets_.getCounter(BYTE_OFFSET));
-        return OffsetMap::getOffsetsDifference(
+        OffsetMap epoch_offsets = OffsetMap::getOffsetsDifference(
             std::move(metadata_.epoch_end_offsets_), metadata_.epoch_size_map_);
+        log_state.noteEpochStartOffsets(record_epoch, epoch_offsets);
+        return epoch_offsets;
       }
       ld_check(rv == -1);
       if (err == E::NOTFOUND) {
@@ -601,6 +825,11 @@ int ReadingCallback::shipRecord(lsn_t lsn,
                           wire_flags,
                           stream_->shard_};
 
+  // Set if the message takes over the record's buffer instead of a copy.
+  void* payload_buffer = nullptr;
+  // Set if the message references a payload copy shared with other messages.
+  std::shared_ptr<const void> payload_owner;
+
   if (stream_->no_payload_ || stream_->csi_data_only_) {
     payload = Payload(nullptr, 0);
     // Clear checksum flags if we don't ship payload
@@ -636,6 +865,27 @@ int ReadingCallback::shipRecord(lsn_t lsn,
     h.length = static_cast<uint32_t>(payload.size());
     h.hash = checksum_32bit(Slice(payload));
     payload = Payload(&h, sizeof(h)).dup();
+  } else if (adoptable_record_ && payload.size() > 0 &&
+             payload.data() >= adoptable_record_->blob.data &&
+             (const char*)payload.data() + payload.size() <=
+                 adoptable_record_->blob.ptr() +
+                     adoptable_record_->blob.size &&
+             (payload_buffer = adoptable_record_->releaseBlob()) != nullptr) {
+    // The payload lives in a buffer that the storage task allocated for this
+    // record and nobody else needs. Hand the buffer over to the RECORD
+    // message instead of copying it; it stays stable for the lifetime of the,
+    // possibly deferred on transmission, message.
+  } else if (real_time_record_ && payload.size() > 0) {
+    // Other streams tailing the log are likely to ship this record too.
+    // Reference a copy of the payload that their RECORD messages share.
+    bool shared = false;
+    payload_owner = catchup_->deps_.getSharedRecordPayloads().get(
+        stream_->log_id_, lsn, payload, &shared);
+    payload = Payload(payload_owner.get(), payload.size());
+    if (shared) {
+      STAT_INCR(
+          catchup_->deps_.getStatsHolder(), real_time_record_payloads_shared);
+    }
   } else {
     // Make private copy of the data so it is stable for the lifetime of
     // the, possibly deferred on transmission, RECORD message.
@@ -658,6 +908,13 @@ int ReadingCallback::shipRecord(lsn_t lsn,
                                        RECORD_Message::Source::LOCAL_LOG_STORE,
                                        std::move(offsets),
                                        stream_->log_group_path_);
+  if (payload_buffer) {
+    msg->setPayloadBuffer(payload_buffer);
+    STAT_INCR(
+        catchup_->deps_.getStatsHolder(), read_path_record_copies_avoided);
+  } else if (payload_owner) {
+    msg->setPayloadOwner(std::move(payload_owner));
+  }
 
   if (lsn <= stream_->last_delivered_lsn_) {
     RATELIMIT_CRITICAL(std::chrono::seconds(10),
@@ -669,33 +926,60 @@ int ReadingCallback::shipRecord(lsn_t lsn,
                        toString(*stream_).c_str());
   }
 
-  // Remember how much space we will take in the output evbuffer
-  const auto msg_size = msg->size();
+  if (batch_max_bytes_ > 0 && RECORD_BATCH_Message::canBatch(*msg)) {
+    if (batch_.empty()) {
+      batch_prev_last_delivered_lsn_ = stream_->last_delivered_lsn_;
+      batch_prev_last_delivered_record_ = stream_->last_delivered_record_;
+      batch_prev_read_ptr_ = stream_->getReadPtr();
+    }
+    batch_bytes_ += msg->payload_.size();
+    batch_.push_back(std::move(msg));
+    if (batch_bytes_ >= batch_max_bytes_ && flushBatch() != 0) {
+      return -1;
+    }
+  } else {
+    // Records held back for a RECORD_BATCH must reach the client first.
+    if (flushBatch() != 0) {
+      return -1;
+    }
 
-  // Let the Sender deal with any traffic shaping induced deferral.
-  // We don't want to have to read the data again just because traffic
-  // shaping is pacing data.
-  int rv =
-      catchup_->deps_.sender_->sendMessage(std::move(msg), stream_->client_id_);
+    // Remember how much space we will take in the output evbuffer
+    const auto msg_size = msg->size();
 
-  if (rv != 0) {
-    ld_check(err != E::CBREGISTERED);
-    if (err == E::NOBUFS || err == E::SHUTDOWN) {
+    // Let the Sender deal with any traffic shaping induced deferral.
+    // We don't want to have to read the data again just because traffic
+    // shaping is pacing data.
+    int rv = catchup_->deps_.sender_->sendMessage(
+        std::move(msg), stream_->client_id_);
+
+    if (rv != 0) {
+      ld_check(err != E::CBREGISTERED);
+      if (err == E::NOBUFS || err == E::SHUTDOWN) {
+        return -1;
+      }
+      // None of the other error conditions are expected or recoverable when
+      // the target is a ClientID:
+      //
+      // - UNREACHABLE means the client went away, but then this object should
+      //   not exist
+      // - some of the codes apply only when the target is a NodeID (ours is a
+      //   ClientID)
+      // - the rest are unrecoverable
+
+      ld_check(false);
+      ld_error("got unexpected error from sender::sendMessage(): %s",
+               error_description(err));
       return -1;
     }
-    // None of the other error conditions are expected or recoverable when
-    // the target is a ClientID:
-    //
-    // - UNREACHABLE means the client went away, but then this object should
-    //   not exist
-    // - some of the codes apply only when the target is a NodeID (ours is a
-    //   ClientID)
-    // - the rest are unrecoverable
 
-    ld_check(false);
-    ld_error("got unexpected error from sender::sendMessage(): %s",
-             error_description(err));
-    return -1;
+    size_t& bytes_queued = catchup_->record_bytes_queued_;
+    ld_check(bytes_queued <= std::numeric_limits<size_t>::max() - msg_size);
+    bytes_queued += msg_size;
+    ld_spew("record %lu%s queued, msg_size:%zu, record_bytes_queued_ = %zu",
+            header.log_id.val_,
+            lsn_to_string(header.lsn).c_str(),
+            msg_size,
+            bytes_queued);
   }
 
   if (catchup_reason_ == CatchupEventTrigger::RELEASE) {
@@ -708,12 +992,57 @@ int ReadingCallback::shipRecord(lsn_t lsn,
     HISTOGRAM_ADD(Worker::stats(), write_to_read_latency, latency);
   }
 
+  return 0;
+}
+
+int ReadingCallback::flushBatch() {
+  if (batch_.empty()) {
+    return 0;
+  }
+
+  const size_t nrecords = batch_.size();
+  const lsn_t first_lsn = batch_.front()->header_.lsn;
+  const lsn_t last_lsn = batch_.back()->header_.lsn;
+  std::unique_ptr<Message> msg;
+  if (nrecords == 1) {
+    // Not worth a batch.
+    msg = std::move(batch_.front());
+  } else {
+    msg = std::make_unique<RECORD_BATCH_Message>(
+        std::move(batch_), stream_->trafficClass());
+  }
+  batch_.clear();
+  batch_bytes_ = 0;
+
+  const auto msg_size = msg->size();
+  int rv =
+      catchup_->deps_.sender_->sendMessage(std::move(msg), stream_->client_id_);
+  if (rv != 0) {
+    ld_check(err != E::CBREGISTERED);
+    // The records were accounted as delivered when they were added to the
+    // batch. Rewind the stream so that they are read again.
+    stream_->last_delivered_lsn_ = batch_prev_last_delivered_lsn_;
+    stream_->last_delivered_record_ = batch_prev_last_delivered_record_;
+    stream_->setReadPtr(batch_prev_read_ptr_);
+    if (err == E::NOBUFS || err == E::SHUTDOWN) {
+      return -1;
+    }
+    // See shipRecord().
+    ld_check(false);
+    ld_error("got unexpected error from sender::sendMessage(): %s",
+             error_description(err));
+    return -1;
+  }
+
   size_t& bytes_queued = catchup_->record_bytes_queued_;
   ld_check(bytes_queued <= std::numeric_limits<size_t>::max() - msg_size);
   bytes_queued += msg_size;
-  ld_spew("record %lu%s queued, msg_size:%zu, record_bytes_queued_ = %zu",
-          header.log_id.val_,
-          lsn_to_string(header.lsn).c_str(),
+  ld_spew("%zu records %lu[%s, %s] queued, msg_size:%zu, "
+          "record_bytes_queued_ = %zu",
+          nrecords,
+          stream_->log_id_.val_,
+          lsn_to_string(first_lsn).c_str(),
+          lsn_to_string(last_lsn).c_str(),
           msg_size,
           bytes_queued);
   return 0;
@@ -1012,6 +1341,26 @@ CatchupOneStream::startRead(WeakRef<CatchupQueue> catchup_queue,
   deps_.distributeNewlyReleasedRecords();
   auto released_records = stream_->giveReleasedRecords();
 
+  if (deps_.getSettings().real_time_tail_bytes_per_log > 0 &&
+      (released_records.empty() ||
+       *released_records.front() > read_ctx.read_ptr_.lsn)) {
+    // The stream is behind the records it was just handed, if any.  The tail
+    // tier may still have the records it needs.
+    auto tail =
+        deps_.getTailRecords(stream_->log_id_, read_ctx.read_ptr_.lsn);
+    if (!tail.empty() && !(*tail.front() > read_ctx.read_ptr_.lsn)) {
+      // The tail tier holds the same groups that get handed to streams, so
+      // only keep the stream's groups that are newer than the whole tail.
+      for (auto& recs : released_records) {
+        if (*tail.back() < recs->begin_lsn_) {
+          tail.push_back(std::move(recs));
+        }
+      }
+      released_records = std::move(tail);
+      STAT_INCR(deps_.getStatsHolder(), real_time_tail_tier_hits);
+    }
+  }
+
   ld_spew("Real time reads: log id %s read ptr %s first real time record %s",
           toString(stream_->log_id_).c_str(),
           lsn_to_string(read_ctx.read_ptr_.lsn).c_str(),
@@ -1243,17 +1592,7 @@ CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
 
       nrecords++;
 
-      int rv = callback.processRecord(
-          entry->lsn,
-          std::chrono::milliseconds(entry->timestamp),
-          entry->flags,
-          entry->keys,
-          Payload(entry->payload_raw.data, entry->payload_raw.size),
-          entry->wave_or_recovery_epoch,
-          entry->last_known_good,
-          entry->copyset.size(),
-          entry->copyset.data(),
-          entry->offsets_within_epoch);
+      int rv = callback.processRealTimeRecord(*entry);
       if (rv != 0) {
         ld_check_ne(err, E::CBREGISTERED);
         status = E::ABORTED;
@@ -1315,7 +1654,12 @@ CatchupOneStream::readNonBlocking(WeakRef<CatchupQueue> /*catchup_queue*/,
                            stream_,
                            ServerReadStream::RecordSource::NON_BLOCKING,
                            read_ctx.catchup_reason_);
+  auto read_start_time = std::chrono::steady_clock::now();
   Status status = deps_.read(read_iterator.get(), callback, &read_ctx);
+  PER_SHARD_HISTOGRAM_ADD(deps_.getStatsHolder(),
+                          read_nonblocking,
+                          stream_->shard_,
+                          usec_since(read_start_time));
 
   stream_ld_debug(*stream_,
                   "got %d records without blocking, status=%s",
@@ -1382,6 +1726,7 @@ void CatchupOneStream::readOnStorageThread(
   options.allow_copyset_index = true;
   options.csi_data_only = stream_->csi_data_only_;
   options.inject_latency = inject_latency;
+  options.readahead_size = deps_.getSettings().catchup_readahead_size;
 
   std::weak_ptr<LocalLogStore::ReadIterator> read_iterator;
   if (stream_->iterator_cache_ && stream_->iterator_cache_->valid(options)) {
@@ -1413,6 +1758,7 @@ void CatchupOneStream::readOnStorageThread(
                                                      std::get<2>(prio),
                                                      std::get<3>(prio),
                                                      client_address);
+  task_uniq->reqTenant(stream_->read_tenant_, stream_->read_tenant_weight_);
   deps_.putStorageTask(std::move(task_uniq), stream_->shard_);
   STAT_INCR(deps_.getStatsHolder(), read_requests_to_storage);
 
@@ -1444,7 +1790,7 @@ CatchupOneStream::read(CatchupQueueDependencies& deps,
 std::pair<CatchupOneStream::Action, size_t>
 CatchupOneStream::onReadTaskDone(CatchupQueueDependencies& deps,
                                  ServerReadStream* stream,
-                                 const ReadStorageTask& task) {
+                                 ReadStorageTask& task) {
   auto& resume_cb = task.catchup_queue_->resumeCallback();
   CatchupOneStream catchup(deps, stream, resume_cb);
   Action action = catchup.processTask(task);
@@ -1452,13 +1798,17 @@ CatchupOneStream::onReadTaskDone(CatchupQueueDependencies& deps,
 }
 
 CatchupOneStream::Action
-CatchupOneStream::processTask(const ReadStorageTask& task) {
+CatchupOneStream::processTask(ReadStorageTask& task) {
   stream_ld_debug(*stream_,
                   "got %zu records, status=%s",
                   task.records_.size(),
                   error_description(task.status_));
 
   ld_check(task.status_ != E::UNKNOWN);
+  PER_SHARD_HISTOGRAM_ADD(deps_.getStatsHolder(),
+                          read_storage_task_round_trip,
+                          stream_->shard_,
+                          usec_since(task.creation_time_));
 
   bool accessed_under_replicated_region =
       task.owned_iterator_ && // May be null in tests.
@@ -1645,7 +1995,7 @@ int CatchupOneStream::sendGapFilteredOutIfNeeded(
 }
 
 CatchupOneStream::Action CatchupOneStream::processRecords(
-    const std::vector<RawRecord>& records,
+    std::vector<RawRecord>& records,
     server_read_stream_version_t version,
     const LocalLogStoreReader::ReadPointer& read_ptr,
     bool accessed_under_replicated_region,
@@ -1655,8 +2005,16 @@ CatchupOneStream::Action CatchupOneStream::processRecords(
   // in the non-blocking read path.
   ReadingCallback callback(
       this, stream_, ServerReadStream::RecordSource::BLOCKING, catchup_reason);
-  for (const RawRecord& record : records) {
-    if (callback.processRecord(record) != 0) {
+  const size_t batch_max_bytes = deps_.getSettings().record_batch_max_bytes;
+  if (batch_max_bytes > 0 &&
+      stream_->proto_ >= Compatibility::RECORD_BATCH_SUPPORT) {
+    callback.enableBatching(batch_max_bytes);
+  }
+  const std::vector<ReadingCallback::FilterResult> filter =
+      callback.filterRecords(records);
+  for (size_t i = 0; i < records.size(); ++i) {
+    RawRecord& record = records[i];
+    if (callback.processOwnedRecord(record, filter[i]) != 0) {
       ld_check(err != E::CBREGISTERED);
       stream_ld_debug(*stream_,
                       "Could not process record with lsn %s. Aborting.",
@@ -1665,6 +2023,13 @@ CatchupOneStream::Action CatchupOneStream::processRecords(
       break;
     }
   }
+  // Even if we aborted, the records processed before that may be waiting
+  // in a batch.
+  if (callback.flushBatch() != 0) {
+    ld_check(err != E::CBREGISTERED);
+    stream_ld_debug(*stream_, "Could not send a batch of records. Aborting.");
+    status = E::ABORTED;
+  }
 
   stream_->in_under_replicated_region_ = accessed_under_replicated_region;
 
@@ -164,7 +164,7 @@ class CatchupOneStream {
   static std::pair<Action, size_t>
   onReadTaskDone(CatchupQueueDependencies& deps,
                  ServerReadStream* stream,
-                 const ReadStorageTask& task);
+                 ReadStorageTask& task);
 
  private:
   CatchupOneStream(CatchupQueueDependencies& deps,
@@ -182,9 +182,10 @@ class CatchupOneStream {
   Action pushReleasedRecords(std::vector<std::shared_ptr<ReleasedRecords>>&,
                              LocalLogStoreReader::ReadContext& read_ctx);
 
-  Action processTask(const ReadStorageTask& task);
+  // Buffers of records in `task' may be handed over to RECORD messages.
+  Action processTask(ReadStorageTask& task);
 
-  Action processRecords(const std::vector<RawRecord>& records,
+  Action processRecords(std::vector<RawRecord>& records,
                         server_read_stream_version_t version,
                         const LocalLogStoreReader::ReadPointer& read_ptr,
                         bool accessed_under_replicated_region,
@@ -19,6 +19,7 @@
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RECORD_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/include/Err.h"
@@ -432,6 +433,34 @@ void CatchupQueue::onRecordSent(const RECORD_Message& msg,
     }
   };
 
+  checkRecordSent(msg, stream, enqueue_time);
+}
+
+void CatchupQueue::onRecordBatchSent(const RECORD_BATCH_Message& msg,
+                                     ServerReadStream* stream,
+                                     const SteadyTimestamp enqueue_time) {
+  const auto msg_size = msg.size();
+  ld_check(record_bytes_queued_ >= msg_size);
+  record_bytes_queued_ -= msg_size;
+  ld_spew("record batch drained, record_bytes_queued_ = %zu",
+          record_bytes_queued_);
+
+  // See onRecordSent().
+  SCOPE_EXIT {
+    if (record_bytes_queued_ == 0) {
+      catchup_queue_ld_debug("Output evbuffer drained");
+      pushRecords();
+    }
+  };
+
+  for (const auto& record : msg.getRecords()) {
+    checkRecordSent(*record, stream, enqueue_time);
+  }
+}
+
+void CatchupQueue::checkRecordSent(const RECORD_Message& msg,
+                                   ServerReadStream* stream,
+                                   const SteadyTimestamp enqueue_time) {
   if (stream == nullptr) {
     // Stream has been reaped. Nothing to validate.
     return;
@@ -680,10 +709,19 @@ void CatchupQueueDependencies::distributeNewlyReleasedRecords() {
   all_server_read_streams_->distributeNewlyReleasedRecords();
 }
 
+std::vector<std::shared_ptr<ReleasedRecords>>
+CatchupQueueDependencies::getTailRecords(logid_t logid, lsn_t from) {
+  return all_server_read_streams_->getTailRecords(logid, from);
+}
+
 void CatchupQueueDependencies::used(logid_t logid) {
   all_server_read_streams_->used(logid);
 }
 
+SharedRecordPayloads& CatchupQueueDependencies::getSharedRecordPayloads() {
+  return all_server_read_streams_->getSharedRecordPayloads();
+}
+
 void CatchupQueueDependencies::invalidateIterators(ClientID client_id) {
   all_server_read_streams_->invalidateIterators(client_id);
 }
@@ -835,7 +873,7 @@ void CatchupQueue::readThrottlingOnReadTaskDone(const ReadStorageTask& task) {
   }
 }
 
-void CatchupQueue::onReadTaskDone(const ReadStorageTask& task) {
+void CatchupQueue::onReadTaskDone(ReadStorageTask& task) {
   ld_spew("Got %zu records, status=%s",
           task.records_.size(),
           error_description(task.status_));
@@ -13,6 +13,7 @@
 #include <mutex>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include <boost/intrusive/set.hpp>
 #include <folly/IntrusiveList.h>
@@ -51,10 +52,12 @@ class Timer;
 class LogStorageStateMap;
 class ReadIoShapingCallback;
 class ReadStorageTask;
+class RECORD_BATCH_Message;
 class RECORD_Message;
 class SenderBase;
 class SenderProxy;
 class ServerReadStream;
+class SharedRecordPayloads;
 class StatsHolder;
 
 /**
@@ -86,11 +89,22 @@ class CatchupQueueDependencies {
    */
   virtual void distributeNewlyReleasedRecords();
 
+  /**
+   * Proxy for AllServerReadStreams::getTailRecords().
+   */
+  virtual std::vector<std::shared_ptr<ReleasedRecords>>
+  getTailRecords(logid_t logid, lsn_t from);
+
   /**
    * Proxy for AllServerReadStreams::used().
    */
   virtual void used(logid_t logid);
 
+  /**
+   * Proxy for AllServerReadStreams::getSharedRecordPayloads().
+   */
+  virtual SharedRecordPayloads& getSharedRecordPayloads();
+
   /**
    * If specified in the configuration for a log, return how much is allowed to
    * artificially delay delivery of newly released records in order to improve
@@ -234,6 +248,13 @@ class CatchupQueue {
                     ServerReadStream*,
                     const SteadyTimestamp enqueue_time);
 
+  /**
+   * Same as onRecordSent() for a RECORD_BATCH message.
+   */
+  void onRecordBatchSent(const RECORD_BATCH_Message& msg,
+                         ServerReadStream*,
+                         const SteadyTimestamp enqueue_time);
+
   /**
    * Called when a gap message is drained from the output evbuffer and
    * sent over the network.
@@ -254,7 +275,7 @@ class CatchupQueue {
    * Called after a ReadStorageTask completes on a storage thread.  The
    * docblock for LocalLogStoreReader::read() explains the output.
    */
-  void onReadTaskDone(const ReadStorageTask& task);
+  void onReadTaskDone(ReadStorageTask& task);
 
   /**
    * Called after a ReadLngTask completes on a storage thread.
@@ -350,6 +371,14 @@ class CatchupQueue {
 
   void onBatchComplete(ServerReadStream* stream);
 
+  /**
+   * Checks that a record sent alone or in a RECORD_BATCH doesn't violate the
+   * order of the stream's records and gaps, and updates stream->sent_state.
+   */
+  void checkRecordSent(const RECORD_Message& msg,
+                       ServerReadStream* stream,
+                       const SteadyTimestamp enqueue_time);
+
   void onStorageTaskStopped(const ServerReadStream* stream);
 
   /**
@@ -18,18 +18,26 @@ namespace facebook { namespace logdevice {
 std::shared_ptr<LocalLogStore::ReadIterator>
 IteratorCache::createOrGet(const LocalLogStore::ReadOptions& options) {
   auto& wrapper = getWrapper(options);
-  if (!wrapper.iterator) {
+  if (!wrapper.iterator || wrapper.leased) {
+    // If the cached iterator is leased out, the caller gets a new iterator,
+    // which replaces the leased one in the cache.
     wrapper.iterator = store_->read(log_id_, options);
+    wrapper.leased = false;
+    WORKER_STAT_INCR(read_iterators_created);
   } else {
     wrapper.iterator->setContextString(options.tracking_ctx.more_context);
   }
   wrapper.last_used = std::chrono::steady_clock::now();
+  if (shared_ && options.allow_blocking_io) {
+    wrapper.leased = true;
+  }
 
   return wrapper.iterator;
 }
 
 bool IteratorCache::valid(const LocalLogStore::ReadOptions& options) {
-  return getWrapper(options).iterator != nullptr;
+  auto& wrapper = getWrapper(options);
+  return wrapper.iterator != nullptr && !wrapper.leased;
 }
 
 void IteratorCache::set(const LocalLogStore::ReadOptions& options,
@@ -37,14 +45,28 @@ void IteratorCache::set(const LocalLogStore::ReadOptions& options,
   auto& wrapper = getWrapper(options);
   wrapper.iterator = iter;
   wrapper.last_used = std::chrono::steady_clock::now();
+  // Either this is the leased iterator coming back from a ReadStorageTask,
+  // or an iterator that a ReadStorageTask created and no longer uses.
+  wrapper.leased = false;
+}
+
+void IteratorCache::release(const LocalLogStore::ReadOptions& options,
+                            const LocalLogStore::ReadIterator* iter) {
+  auto& wrapper = getWrapper(options);
+  if (iter != nullptr && wrapper.iterator.get() == iter) {
+    wrapper.leased = false;
+  }
 }
 
 void IteratorCache::invalidateIfUnused(
     std::chrono::steady_clock::time_point now,
     std::chrono::milliseconds ttl) {
-  for (auto wrapper : {&blocking_, &nonblocking_}) {
-    if (wrapper->iterator && now - wrapper->last_used > ttl) {
-      wrapper->iterator.reset();
+  for (auto& wrapper : wrappers_) {
+    if (wrapper.iterator && now - wrapper.last_used > ttl) {
+      // If the iterator is leased out, the ReadStorageTask using it keeps it
+      // alive until it's done.
+      wrapper.iterator.reset();
+      wrapper.leased = false;
       WORKER_STAT_INCR(iterator_invalidations);
     }
   }
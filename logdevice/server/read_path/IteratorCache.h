@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -20,15 +21,26 @@ namespace facebook { namespace logdevice {
  * @file  IteratorCache provides a way to get a read iterator for a particular
  *        log. The iterator will be created lazily the first time it's
  *        requested; future calls to getIterator() will return the cached value.
+ *
+ *        A shared IteratorCache is used by all read streams of a worker that
+ *        read the same log from the same shard (see --share-read-iterators).
+ *        Since every read re-seeks the iterator, streams can take turns
+ *        reading through the same iterator, which saves both the cost of
+ *        creating iterators and the memory they pin (memtables, table
+ *        readers, blocks). Blocking iterators are used on storage threads,
+ *        so while a ReadStorageTask reads through the cached blocking
+ *        iterator, the iterator is leased out and other streams don't get it.
  */
 
 class IteratorCache {
  public:
   explicit IteratorCache(LocalLogStore* store,
                          logid_t log_id,
-                         bool created_by_rebuilding)
+                         bool created_by_rebuilding,
+                         bool shared = false)
       : store_(store),
         log_id_(log_id),
+        shared_(shared),
         created_by_rebuilding_(created_by_rebuilding) {}
 
   /**
@@ -42,12 +54,16 @@ class IteratorCache {
    *       operation. Therefore, CatchupQueue will only call it if it's cached
    *       (valid() returns true). Otherwise ReadStorageTask will create a new
    *       iterator (on a storage thread) and call set() later.
+   * @note If the cache is shared, a blocking iterator returned by this method
+   *       is leased out until set() or release() is called for it, or until
+   *       it is invalidated.
    */
   std::shared_ptr<LocalLogStore::ReadIterator>
   createOrGet(const LocalLogStore::ReadOptions&);
 
   /**
    * @return  true if a valid iterator exists for the specified ReadOptions
+   *          and is not leased out
    */
   bool valid(const LocalLogStore::ReadOptions&);
 
@@ -57,6 +73,14 @@ class IteratorCache {
   void set(const LocalLogStore::ReadOptions&,
            std::shared_ptr<LocalLogStore::ReadIterator>);
 
+  /**
+   * Ends the lease of `iter` if it is the cached iterator for the specified
+   * ReadOptions. Called when a ReadStorageTask that was given the cached
+   * iterator is dropped without reading.
+   */
+  void release(const LocalLogStore::ReadOptions&,
+               const LocalLogStore::ReadIterator* iter);
+
   /**
    * Release iterators which haven't been used recently.
    *
@@ -73,6 +97,13 @@ class IteratorCache {
     return store_;
   }
 
+  /**
+   * @return  true if this cache is shared by multiple read streams.
+   */
+  bool isShared() const {
+    return shared_;
+  }
+
  private:
   struct IterWrapper {
     IterWrapper()
@@ -84,20 +115,29 @@ class IteratorCache {
     std::shared_ptr<LocalLogStore::ReadIterator> iterator;
 
     std::chrono::steady_clock::time_point last_used;
+
+    // True while `iterator` is used by a ReadStorageTask. Only set if the
+    // cache is shared.
+    bool leased{false};
   };
 
   IterWrapper& getWrapper(const LocalLogStore::ReadOptions& options) {
     // Iterator must not snapshot for caching to work correctly
     ld_check(options.tailing);
 
-    return options.allow_blocking_io ? blocking_ : nonblocking_;
+    // Streams sharing the cache may create their iterators with different
+    // options. A single stream always uses the same fill_cache and
+    // csi_data_only, so it only ever uses two of these.
+    return wrappers_[(options.allow_blocking_io ? 1 : 0) |
+                     (options.fill_cache ? 2 : 0) |
+                     (options.csi_data_only ? 4 : 0)];
   }
 
   LocalLogStore* store_;
   logid_t log_id_;
+  const bool shared_;
 
-  IterWrapper blocking_;
-  IterWrapper nonblocking_;
+  std::array<IterWrapper, 8> wrappers_;
 
  public:
   // Context for tracking iterators
@@ -267,9 +267,15 @@ Status read(LocalLogStore::ReadIterator& read_iterator,
             Callback& callback,
             ReadContext* read_ctx,
             StatsHolder* stats,
-            const Settings& settings) {
+            const Settings& settings,
+            std::function<bool()> should_preempt) {
   // Reset the iterator stats.
   read_ctx->it_stats_ = decltype(read_ctx->it_stats_)();
+  if (should_preempt) {
+    read_ctx->it_stats_.should_preempt = std::move(should_preempt);
+    read_ctx->it_stats_.preempt_after =
+        settings.read_storage_tasks_preempt_after;
+  }
 
   Status st = readImpl(read_iterator, callback, read_ctx, stats, settings);
 
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 
 #include <boost/noncopyable.hpp>
 
@@ -72,6 +73,20 @@ class RawRecord : boost::noncopyable {
     other.from_under_replicated_region = false;
   }
 
+  /**
+   * Gives up ownership of the blob: the caller becomes responsible for
+   * free()ing it. `blob' stays valid so it can still be parsed.
+   *
+   * @return the malloc'd buffer, or nullptr if the blob wasn't owned.
+   */
+  void* releaseBlob() {
+    if (!owned) {
+      return nullptr;
+    }
+    owned = false;
+    return const_cast<void*>(blob.data);
+  }
+
   lsn_t lsn;
   Slice blob;
   bool owned;
@@ -234,6 +249,12 @@ class Callback {
  *                                 1 but can be greater than that if we
  *                                 determine for sure that there are no more
  *                                 records up to a certain lsn.
+ * @param should_preempt           if set, checked once the read has been
+ *                                 running for
+ *                                 settings.read_storage_tasks_preempt_after;
+ *                                 if it returns true the read stops with
+ *                                 E::PARTIAL, as if it hit the execution time
+ *                                 limit
  *
  * @return
  * Status will be one of:
@@ -268,7 +289,8 @@ Status read(LocalLogStore::ReadIterator& iterator,
             Callback& callback,
             ReadContext* read_ctx,
             StatsHolder* stats,
-            const Settings& settings);
+            const Settings& settings,
+            std::function<bool()> should_preempt = nullptr);
 
 /**
  * Utility function that finds the last known good ESN for a given epoch by
@@ -23,6 +23,7 @@
 #include "logdevice/server/ReleaseRequest.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/TrimPointPusher.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
@@ -148,6 +149,28 @@ LogStorageState::getEpochOffsetMap() const {
   return latest_epoch_offsets_;
 }
 
+folly::Optional<OffsetMap>
+LogStorageState::getEpochStartOffsets(epoch_t epoch) const {
+  RWLock::ReadHolder read_guard(rw_lock_);
+  auto it = epoch_start_offsets_.find(epoch);
+  if (it == epoch_start_offsets_.end()) {
+    return folly::none;
+  }
+  return it->second;
+}
+
+void LogStorageState::noteEpochStartOffsets(epoch_t epoch,
+                                            OffsetMap offsets) {
+  if (!offsets.isValid()) {
+    return;
+  }
+  RWLock::WriteHolder write_guard(rw_lock_);
+  epoch_start_offsets_[epoch] = std::move(offsets);
+  while (epoch_start_offsets_.size() > MAX_EPOCH_START_OFFSETS) {
+    epoch_start_offsets_.erase(epoch_start_offsets_.begin());
+  }
+}
+
 void LogStorageState::updateLastCleanEpoch(epoch_t epoch) {
   last_clean_epoch_.fetchMax(epoch.val_);
 }
@@ -170,6 +193,10 @@ int LogStorageState::updateTrimPoint(lsn_t new_val) {
     err = E::UPTODATE;
     return -1;
   }
+  const node_index_t subscriber = trim_point_subscriber_.load();
+  if (subscriber != NODE_INDEX_INVALID && owner_->trim_point_pusher_) {
+    owner_->trim_point_pusher_->push(subscriber, log_id_, new_val);
+  }
   return 0;
 }
 
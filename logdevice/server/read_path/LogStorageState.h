@@ -7,7 +7,9 @@
  */
 #pragma once
 
+#include <atomic>
 #include <bitset>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -19,6 +21,7 @@
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/AtomicOptional.h"
 #include "logdevice/common/GetSeqStateRequest-fwd.h"
+#include "logdevice/common/NodeID.h"
 #include "logdevice/common/OffsetMap.h"
 #include "logdevice/common/Seal.h"
 #include "logdevice/common/types_internal.h"
@@ -196,6 +199,14 @@ class LogStorageState {
   const folly::Optional<std::pair<epoch_t, OffsetMap>>&
   getEpochOffsetMap() const;
 
+  /**
+   * Offsets of the log at the start of `epoch` (i.e. at the end of the
+   * previous epoch), if some read stream of the log already looked them up.
+   * Records carry their offsets within their epoch, so this is all that's
+   * needed to compute the offsets of any record of the epoch.
+   */
+  folly::Optional<OffsetMap> getEpochStartOffsets(epoch_t epoch) const;
+
   std::chrono::seconds getLogRemovalTime() const {
     return log_removal_time_.load();
   }
@@ -239,6 +250,19 @@ class LogStorageState {
    */
   int updateTrimPoint(lsn_t trim_point);
 
+  /**
+   * Sets the node that advances of the trim point are pushed to with
+   * --push-trim-points: the node whose sequencer last asked for the trim
+   * point. NODE_INDEX_INVALID stops the pushes.
+   */
+  void setTrimPointSubscriber(node_index_t node) {
+    trim_point_subscriber_.store(node);
+  }
+
+  node_index_t getTrimPointSubscriber() const {
+    return trim_point_subscriber_.load();
+  }
+
   /**
    * Updates the trim point of the per-epoch log metadata.
    *
@@ -259,6 +283,15 @@ class LogStorageState {
 
   void updateEpochOffsetMap(std::pair<epoch_t, OffsetMap>);
 
+  /**
+   * Remembers the offsets of the log at the start of `epoch`, for
+   * getEpochStartOffsets(). Only the MAX_EPOCH_START_OFFSETS most recent
+   * epochs are kept.
+   */
+  void noteEpochStartOffsets(epoch_t epoch, OffsetMap offsets);
+
+  static constexpr size_t MAX_EPOCH_START_OFFSETS = 16;
+
   /**
    * Looks up the worker in the set of workers subscribed to the log.
    */
@@ -341,6 +374,10 @@ class LogStorageState {
   // @return whether the permanent error flag is set
   bool hasPermanentError();
 
+  logid_t getLogID() const {
+    return log_id_;
+  }
+
   shard_index_t getShardIdx() const {
     return shard_;
   }
@@ -403,6 +440,9 @@ class LogStorageState {
   //     section
   AtomicOptional<lsn_t> trim_point_{LSN_INVALID, EMPTY_OPTIONAL};
 
+  // See setTrimPointSubscriber().
+  std::atomic<node_index_t> trim_point_subscriber_{NODE_INDEX_INVALID};
+
   // Trim point of per-epoch log metadata. This is of type epoch_t instead
   // of lsn_t since these metadata are stored per-epoch. PerEpochLogMetadata
   // whose epoch is smaller or equal than the trim point should be trimmed.
@@ -446,13 +486,18 @@ class LogStorageState {
   std::atomic<std::chrono::seconds> log_removal_time_{std::chrono::seconds(0)};
 
   using RWLock = folly::SharedMutexWritePriority;
-  // Lock to update and read latest_epoch_offsets_ safely.
+  // Lock to update and read latest_epoch_offsets_ and epoch_start_offsets_
+  // safely.
   mutable RWLock rw_lock_;
   // Pair of latest updated epoch and corresponding epoch offsets.
   // This value get updated from sequencer once recover() get triggered.
   // It is not updated with RELEASE messages, so epoch of last_released_lsn_
   // can be different from epoch in latest_epoch_offsets_ pair.
   folly::Optional<std::pair<epoch_t, OffsetMap>> latest_epoch_offsets_;
+  // Offsets at the start of recently read epochs, shared by all read streams
+  // of the log so that only the first one to read an epoch needs to look them
+  // up in PerEpochLogMetadata. Protected by rw_lock_.
+  std::map<epoch_t, OffsetMap> epoch_start_offsets_;
 
   // Data needed to manage retrying sending ReleaseRequests to workers.
   struct RetryRelease {
@@ -22,15 +22,30 @@ namespace facebook { namespace logdevice {
 LogStorageStateMap::LogStorageStateMap(
     shard_size_t num_shards,
     std::chrono::microseconds recovery_interval,
-    ServerProcessor* processor)
+    ServerProcessor* processor,
+    size_t dense_logs)
     : cache_disposal_(processor != nullptr &&
                               processor->settings()->enable_record_cache
                           ? std::make_unique<RecordCacheDisposal>(processor)
                           : nullptr),
+      trim_point_pusher_(processor != nullptr
+                             ? std::make_unique<TrimPointPusher>(processor)
+                             : nullptr),
       num_shards_(num_shards),
       processor_(processor),
       shard_map_(makeMap(num_shards)),
+      dense_logs_(std::min(dense_logs, size_t(LOGID_MAX.val_) + 1)),
       state_recovery_interval_(recovery_interval) {
+  if (dense_logs_ > 0) {
+    const size_t num_slabs =
+        (2 * dense_logs_ + kDenseSlabSize - 1) / kDenseSlabSize;
+    for (shard_index_t s = 0; s < num_shards; ++s) {
+      dense_shards_.emplace_back(num_slabs);
+      for (auto& slab : dense_shards_.back()) {
+        slab.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+  }
   if (processor != nullptr && processor->settings()->enable_record_cache &&
       processor->runningOnStorageNode()) {
     // only starts the record cache monitor thread if record cache
@@ -40,8 +55,61 @@ LogStorageStateMap::LogStorageStateMap(
   }
 }
 
+LogStorageStateMap::~LogStorageStateMap() {
+  // Stop the monitor before destroying the states whose caches it looks at.
+  record_cache_monitor_.reset();
+  clear();
+}
+
+LogStorageStateMap::DenseSlab::~DenseSlab() {
+  for (DenseSlot& slot : slots) {
+    LogStorageState* state = slot.state.load(std::memory_order_relaxed);
+    if (state != nullptr) {
+      state->~LogStorageState();
+    }
+  }
+}
+
+LogStorageState*
+LogStorageStateMap::insertOrGetDense(logid_t log_id,
+                                     size_t idx,
+                                     shard_index_t shard_idx) {
+  std::atomic<DenseSlab*>& slab_ptr =
+      dense_shards_[shard_idx][idx / kDenseSlabSize];
+  DenseSlab* slab = slab_ptr.load(std::memory_order_acquire);
+  if (slab == nullptr) {
+    auto new_slab = std::make_unique<DenseSlab>();
+    if (slab_ptr.compare_exchange_strong(
+            slab, new_slab.get(), std::memory_order_acq_rel)) {
+      slab = new_slab.release();
+    }
+    // Otherwise another thread installed a slab first; `slab` now points
+    // to it and ours is freed.
+  }
+
+  DenseSlot& slot = slab->slots[idx % kDenseSlabSize];
+  LogStorageState* state = slot.state.load(std::memory_order_acquire);
+  if (state != nullptr) {
+    return state;
+  }
+  std::lock_guard<std::mutex> lock(slab->mutex);
+  state = slot.state.load(std::memory_order_relaxed);
+  if (state == nullptr) {
+    state = new (&slot.storage)
+        LogStorageState(log_id, shard_idx, this, cache_disposal_.get());
+    slot.state.store(state, std::memory_order_release);
+  }
+  return state;
+}
+
 LogStorageState* LogStorageStateMap::insertOrGet(logid_t log_id,
                                                  shard_index_t shard_idx) {
+  const ssize_t dense_idx = denseIndex(log_id);
+  if (dense_idx >= 0) {
+    LogStorageState* state = findDense(dense_idx, shard_idx);
+    return state ? state : insertOrGetDense(log_id, dense_idx, shard_idx);
+  }
+
   Map& map = *shard_map_[shard_idx];
 
   // First try a lookup to avoid memory allocation in the common case
@@ -64,6 +132,10 @@ LogStorageState* LogStorageStateMap::insertOrGet(logid_t log_id,
 LogStorageState* LogStorageStateMap::find(logid_t log_id,
                                           shard_index_t shard_idx) {
   ld_check(shard_idx < shard_map_.size());
+  const ssize_t dense_idx = denseIndex(log_id);
+  if (dense_idx >= 0) {
+    return findDense(dense_idx, shard_idx);
+  }
   Map& map = *shard_map_[shard_idx];
   auto it = map.find(log_id.val_);
   return it != map.cend() ? it->second.get() : nullptr;
@@ -72,6 +144,12 @@ LogStorageState* LogStorageStateMap::find(logid_t log_id,
 LogStorageState& LogStorageStateMap::get(logid_t log_id,
                                          shard_index_t shard_idx) {
   ld_check(shard_idx < shard_map_.size());
+  const ssize_t dense_idx = denseIndex(log_id);
+  if (dense_idx >= 0) {
+    LogStorageState* state = findDense(dense_idx, shard_idx);
+    ld_check(state != nullptr);
+    return *state;
+  }
   Map& map = *shard_map_[shard_idx];
   auto it = map.find(log_id.val_);
   ld_check(it != map.cend());
@@ -83,15 +161,21 @@ void LogStorageStateMap::clear() {
     Map& map = *shard_map_[s];
     map.clear();
   }
+  for (DenseShard& shard : dense_shards_) {
+    for (auto& slab : shard) {
+      delete slab.exchange(nullptr);
+    }
+  }
 }
 
 int LogStorageStateMap::repopulateRecordCacheFromLinearBuffer(
     logid_t log_id,
     shard_index_t shard,
     const char* buffer,
-    size_t size) {
-  std::unique_ptr<RecordCache> record_cache =
-      RecordCache::fromLinearBuffer(buffer, size, cache_disposal_.get(), shard);
+    size_t size,
+    std::shared_ptr<const void> buffer_owner) {
+  std::unique_ptr<RecordCache> record_cache = RecordCache::fromLinearBuffer(
+      buffer, size, cache_disposal_.get(), shard, std::move(buffer_owner));
   if (!record_cache) {
     return -1;
   }
@@ -112,15 +196,15 @@ LogStorageStateMap::ReleaseStates
 LogStorageStateMap::getAllLastReleasedLSNs(shard_index_t shard) const {
   ReleaseStates states;
 
-  for (auto entry = shard_map_[shard]->cbegin();
-       entry != shard_map_[shard]->cend();
-       ++entry) {
-    LogStorageState::LastReleasedLSN last_released =
-        entry->second->getLastReleasedLSN();
-    if (last_released.hasValue()) {
-      states.emplace_back(logid_t(entry->first), last_released.value());
-    }
-  }
+  forEachLogOnShard(
+      shard, [&](logid_t log_id, const LogStorageState& state) {
+        LogStorageState::LastReleasedLSN last_released =
+            state.getLastReleasedLSN();
+        if (last_released.hasValue()) {
+          states.emplace_back(log_id, last_released.value());
+        }
+        return 0;
+      });
 
   return states;
 }
@@ -142,14 +226,12 @@ void LogStorageStateMap::shutdownRecordCaches() {
   if (cache_disposal_ == nullptr) {
     return;
   }
-  for (shard_index_t i = 0; i < num_shards_; ++i) {
-    for (auto entry = shard_map_[i]->cbegin(); entry != shard_map_[i]->cend();
-         ++entry) {
-      if (entry->second->record_cache_ != nullptr) {
-        entry->second->record_cache_->shutdown();
-      }
+  forEachLog([](logid_t, const LogStorageState& state) {
+    if (state.record_cache_ != nullptr) {
+      state.record_cache_->shutdown();
     }
-  }
+    return 0;
+  });
 }
 
 void LogStorageStateMap::shutdownRecordCacheMonitor() {
@@ -10,16 +10,21 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 
+#include <folly/concurrency/CacheLocality.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
 
+#include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/common/util.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/types.h"
 #include "logdevice/server/RecordCacheDisposal.h"
 #include "logdevice/server/RecordCacheMonitorThread.h"
+#include "logdevice/server/TrimPointPusher.h"
 #include "logdevice/server/read_path/LogStorageState.h"
 
 namespace facebook { namespace logdevice {
@@ -28,6 +33,13 @@ namespace facebook { namespace logdevice {
  * @file
  * On storage nodes, maps log IDs to LogStorageState instances, state that we
  * need to keep in memory for fast access.
+ *
+ * Optionally, data logs with IDs below a bound (--log-storage-state-dense-logs)
+ * and their metadata logs are kept in a dense layout instead of the hash map:
+ * the log ID itself is the index into a per-shard array of slabs of
+ * cache-line-aligned slots, each holding a LogStorageState in place. Lookups
+ * of these logs don't hash and touch one slab pointer and one slot. Other logs
+ * (e.g. internal logs) always go to the hash map.
  */
 
 class LogStorageStateMap {
@@ -38,11 +50,17 @@ class LogStorageStateMap {
    * @param recovery_interval  interval between consecutive attempts to recover
    *                           log state
    * @param processor          may be null in tests
+   * @param dense_logs         data logs with IDs below this, and their
+   *                           metadata logs, use the dense layout; 0 to
+   *                           keep all logs in the hash map
    */
   explicit LogStorageStateMap(shard_size_t num_shards,
                               std::chrono::microseconds recovery_interval =
                                   std::chrono::microseconds(500000),
-                              ServerProcessor* processor = nullptr);
+                              ServerProcessor* processor = nullptr,
+                              size_t dense_logs = 0);
+
+  ~LogStorageStateMap();
 
   LogStorageStateMap(const LogStorageStateMap&) = delete;
   LogStorageStateMap& operator=(const LogStorageStateMap&) = delete;
@@ -69,7 +87,7 @@ class LogStorageStateMap {
   LogStorageState& get(logid_t log_id, shard_index_t shard_idx);
 
   /**
-   * Used in tests.
+   * Used in tests. Not safe to call while other threads use the map.
    */
   void clear();
 
@@ -82,13 +100,17 @@ class LogStorageStateMap {
    * NOTE this is not threadsafe; should only be called when no other thread
    * is accessing the record caches, e.g. during startup.
    *
+   * See RecordCache::fromLinearBuffer() for buffer_owner.
+   *
    * @return -1 if there's no LogStorageState for that log id, or if
    *         deserialization of the record cache failed.
    */
-  int repopulateRecordCacheFromLinearBuffer(logid_t log_id,
-                                            shard_index_t shard,
-                                            const char* buffer,
-                                            size_t size);
+  int repopulateRecordCacheFromLinearBuffer(
+      logid_t log_id,
+      shard_index_t shard,
+      const char* buffer,
+      size_t size,
+      std::shared_ptr<const void> buffer_owner = nullptr);
 
   /**
    * Returns the contents of the map as a vector of (log id, lsn) pairs.
@@ -161,6 +183,12 @@ class LogStorageStateMap {
    */
   std::unique_ptr<RecordCacheDisposal> cache_disposal_;
 
+  /**
+   * Sends trim point advances to subscribed sequencer nodes, see
+   * LogStorageState::setTrimPointSubscriber(). nullptr in tests.
+   */
+  std::unique_ptr<TrimPointPusher> trim_point_pusher_;
+
  private:
   shard_size_t num_shards_;
 
@@ -176,6 +204,56 @@ class LogStorageStateMap {
 
   static std::vector<std::unique_ptr<Map>> makeMap(shard_size_t num_shards);
 
+  // A slot of the dense layout. `state` is either nullptr or points to
+  // `storage`, where the LogStorageState was constructed.
+  struct alignas(folly::hardware_destructive_interference_size) DenseSlot {
+    std::atomic<LogStorageState*> state{nullptr};
+    typename std::aligned_storage<sizeof(LogStorageState),
+                                  alignof(LogStorageState)>::type storage;
+  };
+
+  // Slabs are allocated when the first log in them is inserted.
+  static constexpr size_t kDenseSlabSize = 64;
+  struct DenseSlab {
+    ~DenseSlab();
+    std::mutex mutex; // serializes construction of states in the slab
+    DenseSlot slots[kDenseSlabSize];
+  };
+  using DenseShard = std::vector<std::atomic<DenseSlab*>>;
+
+  // Data logs in [0, dense_logs_) and their metadata logs use the dense
+  // layout. Data log L has index L, its metadata log has dense_logs_ + L.
+  const size_t dense_logs_;
+
+  // One vector of ceil(2 * dense_logs_ / kDenseSlabSize) slab pointers per
+  // shard. Empty if dense_logs_ is 0.
+  std::vector<DenseShard> dense_shards_;
+
+  // @return  index of the log's slot in the dense layout, or -1 if the log
+  //          is in the hash map
+  ssize_t denseIndex(logid_t log_id) const {
+    if (log_id.val_ < dense_logs_) {
+      return log_id.val_;
+    }
+    if (MetaDataLog::isMetaDataLog(log_id) &&
+        MetaDataLog::dataLogID(log_id).val_ < dense_logs_) {
+      return dense_logs_ + MetaDataLog::dataLogID(log_id).val_;
+    }
+    return -1;
+  }
+
+  LogStorageState* findDense(size_t idx, shard_index_t shard_idx) const {
+    DenseSlab* slab = dense_shards_[shard_idx][idx / kDenseSlabSize].load(
+        std::memory_order_acquire);
+    return slab ? slab->slots[idx % kDenseSlabSize].state.load(
+                      std::memory_order_acquire)
+                : nullptr;
+  }
+
+  LogStorageState* insertOrGetDense(logid_t log_id,
+                                    size_t idx,
+                                    shard_index_t shard_idx);
+
   // Attempt to recover log state only once this many usecs.
   std::chrono::microseconds state_recovery_interval_;
 
@@ -190,6 +268,21 @@ template <typename Func>
 int LogStorageStateMap::forEachLogOnShard(shard_index_t shard,
                                           const Func& func) const {
   ld_check(shard < shard_map_.size());
+  if (!dense_shards_.empty()) {
+    for (const auto& slab_ptr : dense_shards_[shard]) {
+      const DenseSlab* slab = slab_ptr.load(std::memory_order_acquire);
+      if (slab == nullptr) {
+        continue;
+      }
+      for (const DenseSlot& slot : slab->slots) {
+        const LogStorageState* state =
+            slot.state.load(std::memory_order_acquire);
+        if (state != nullptr && func(state->getLogID(), *state) != 0) {
+          return -1;
+        }
+      }
+    }
+  }
   for (auto kv = shard_map_[shard]->cbegin(); kv != shard_map_[shard]->cend();
        ++kv) {
     if (kv->second != nullptr) {
@@ -10,6 +10,8 @@
 
 #include "logdevice/common/FlowGroup.h"
 #include "logdevice/common/checks.h"
+#include "logdevice/common/stats/PerShardHistograms.h"
+#include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/read_path/CatchupQueue.h"
 #include "logdevice/server/read_path/ServerReadStream.h"
 
@@ -41,6 +43,12 @@ void ReadIoShapingCallback::operator()(FlowGroup&, std::mutex&) {
   }
 
   ld_spew("Unthrottled: log:%lu, cb:%p", stream_ptr->getLogId().val_, this);
+  if (stream_ptr->isThrottled()) {
+    PER_SHARD_HISTOGRAM_ADD(Worker::stats(),
+                            read_throttled,
+                            stream_ptr->shard_,
+                            usec_since(stream_ptr->getThrottlingStartTime()));
+  }
   stream_->markThrottled(false);
 
   auto cq_ptr = catchup_queue_.get();
@@ -78,6 +78,40 @@ ServerReadStream::~ServerReadStream() {
   if (is_throttled_) {
     STAT_INCR(stats_, read_throttling_num_streams_closed_in_throttle);
   }
+  if (hibernated_) {
+    STAT_DECR(stats_, server_read_streams_hibernated);
+  }
+}
+
+void ServerReadStream::hibernate() {
+  ld_check(!hibernated_);
+  ld_check(!isCatchingUp());
+  ld_check(!storage_task_in_flight_);
+  ld_check(released_records_.empty());
+
+  iterator_cache_.reset();
+  // Free the capacity of the vector too.
+  std::vector<std::shared_ptr<ReleasedRecords>>().swap(released_records_);
+  hibernated_ = true;
+  STAT_INCR(stats_, server_read_streams_hibernated);
+}
+
+bool ServerReadStream::canHibernate(SteadyTimestamp now,
+                                    std::chrono::milliseconds idle_time) const {
+  if (hibernated_ || isCatchingUp() || storage_task_in_flight_ ||
+      epoch_task_in_flight || needs_started_message_ ||
+      !released_records_.empty()) {
+    return false;
+  }
+  return now - std::max(last_enqueued_time_, created_) > idle_time;
+}
+
+void ServerReadStream::wakeUp(std::shared_ptr<IteratorCache> iterator_cache) {
+  ld_check(hibernated_);
+  iterator_cache_ = std::move(iterator_cache);
+  hibernated_ = false;
+  STAT_DECR(stats_, server_read_streams_hibernated);
+  STAT_INCR(stats_, server_read_streams_woken_up);
 }
 
 const SimpleEnumMap<ServerReadStream::RecordSource, const char*>
@@ -164,7 +164,9 @@ class ServerReadStream : boost::noncopyable {
     scd_copyset_reordering_ = val;
 
     if (scd_copyset_reordering_ ==
-        SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED) {
+            SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED ||
+        scd_copyset_reordering_ ==
+            SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION) {
       csid_hash_pt1 = csid_hash_pt1_;
       csid_hash_pt2 = csid_hash_pt2_;
     }
@@ -205,6 +207,34 @@ class ServerReadStream : boost::noncopyable {
     return log_id_;
   }
 
+  /**
+   * Releases the state of an idle, caught up stream that can be recreated
+   * once the stream has something to read again: the iterator cache and the
+   * buffer of released records. See --server-read-stream-hibernate-after.
+   * AllServerReadStreams wakes the stream up before scheduling it for
+   * catchup.
+   */
+  void hibernate();
+
+  /**
+   * @return  true if the stream is caught up, has no work in flight and
+   *          hasn't been scheduled for catchup for more than `idle_time`.
+   */
+  bool canHibernate(SteadyTimestamp now,
+                    std::chrono::milliseconds idle_time) const;
+
+  /**
+   * Undoes hibernate().
+   *
+   * @param iterator_cache  Iterator cache to use from now on. Can be nullptr
+   *                        in tests.
+   */
+  void wakeUp(std::shared_ptr<IteratorCache> iterator_cache);
+
+  bool isHibernated() const {
+    return hibernated_;
+  }
+
   // These update per traffic class stats. setTrafficClass() has to unupdate
   // all these stats for the old class and update them for the new class.
   // Make sure to keep stats logic in setTrafficClass() in sync with these.
@@ -454,6 +484,15 @@ class ServerReadStream : boost::noncopyable {
    */
   bool is_internal_ = false;
 
+  /**
+   * Tenant of this stream's ReadStorageTasks in storage thread scheduling:
+   * a hash of the name of the reader's principal from the "principals"
+   * section of the config, and that principal's read_weight. Readers
+   * without a configured principal share tenant 0. See DRRScheduler.h.
+   */
+  uint64_t read_tenant_ = 0;
+  uint32_t read_tenant_weight_ = 1;
+
   /**
    * Indicate that EpochOffsetTask was sent and still in process.
    * This flag helps to prevent creating more than one task at the time.
@@ -461,9 +500,13 @@ class ServerReadStream : boost::noncopyable {
   bool epoch_task_in_flight = false;
 
   // Iterators used for this read stream. Created once and reused. Periodically
-  // invalidated (if unused) to avoid pinning resources.
+  // invalidated (if unused) to avoid pinning resources. nullptr while the
+  // stream is hibernated.
   std::shared_ptr<IteratorCache> iterator_cache_;
 
+  // True if hibernate() was called and the stream hasn't been woken up since.
+  bool hibernated_ = false;
+
   // Protocol used to communicate with the client.
   uint16_t proto_;
 
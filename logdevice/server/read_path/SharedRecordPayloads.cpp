@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/read_path/SharedRecordPayloads.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+std::shared_ptr<const void> SharedRecordPayloads::get(logid_t log_id,
+                                                      lsn_t lsn,
+                                                      const Payload& payload,
+                                                      bool* shared) {
+  ld_check(payload.size() > 0);
+  ld_check(shared);
+
+  Entry& entry = buffers_[std::make_pair(log_id, lsn)];
+  std::shared_ptr<const void> buffer = entry.buffer.lock();
+  if (buffer && entry.size == payload.size()) {
+    *shared = true;
+    return buffer;
+  }
+
+  void* data = malloc(payload.size());
+  if (!data) {
+    throw std::bad_alloc();
+  }
+  memcpy(data, payload.data(), payload.size());
+  buffer = std::shared_ptr<const void>(data, [](const void* p) {
+    free(const_cast<void*>(p));
+  });
+  entry.buffer = buffer;
+  entry.size = payload.size();
+  *shared = false;
+
+  if (buffers_.size() > sweep_threshold_) {
+    sweep();
+  }
+  return buffer;
+}
+
+void SharedRecordPayloads::sweep() {
+  for (auto it = buffers_.begin(); it != buffers_.end();) {
+    if (it->second.buffer.expired()) {
+      it = buffers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // Keep the amortized cost of sweeping constant per get() even if many
+  // buffers stay referenced, e.g. by messages queued for slow clients.
+  sweep_threshold_ = std::max(kMinSweepThreshold, buffers_.size() * 2);
+}
+
+}} // namespace facebook::logdevice
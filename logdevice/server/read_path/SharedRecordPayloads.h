@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include <folly/hash/Hash.h>
+
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file SharedRecordPayloads lets RECORD messages that several read streams
+ *       of the same Worker send for the same record reference a single copy
+ *       of the payload instead of each making its own.
+ *
+ *       When many readers tail a log, distributeNewlyReleasedRecords() hands
+ *       every newly released record to all of their streams, and each
+ *       RECORD_Message used to copy the payload so that it stays stable until
+ *       the message is sent. Only the payload can be shared: the rest of the
+ *       message (read stream id, flags, extra metadata) differs per stream.
+ *
+ *       The copies are plain malloc'd buffers owned by the messages
+ *       referencing them. This class only keeps weak references, so a buffer
+ *       is freed as soon as the last message is sent or dropped.
+ *
+ *       Not thread safe, each Worker has its own instance owned by
+ *       AllServerReadStreams.
+ */
+
+class SharedRecordPayloads {
+ public:
+  /**
+   * @param shared  set to true if the returned buffer was already made for
+   *                another message, false if this call made a new copy
+   *
+   * @return  a buffer with a copy of `payload', the record at `lsn' of
+   *          `log_id'. payload.size() must be positive.
+   */
+  std::shared_ptr<const void>
+  get(logid_t log_id, lsn_t lsn, const Payload& payload, bool* shared);
+
+  // Number of buffers tracked, including ones no longer referenced by any
+  // message that haven't been swept yet.
+  size_t size() const {
+    return buffers_.size();
+  }
+
+  void clear() {
+    buffers_.clear();
+  }
+
+ private:
+  // Forgets buffers no longer referenced by any message.
+  void sweep();
+
+  struct Entry {
+    std::weak_ptr<const void> buffer;
+    size_t size;
+  };
+
+  using Key = std::pair<logid_t, lsn_t>;
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(key.first.val_, key.second);
+    }
+  };
+
+  std::unordered_map<Key, Entry, KeyHash> buffers_;
+
+  // sweep() runs when buffers_ grows past this many entries
+  size_t sweep_threshold_{kMinSweepThreshold};
+  static constexpr size_t kMinSweepThreshold = 1024;
+};
+
+}} // namespace facebook::logdevice
@@ -10,6 +10,7 @@
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/rebuilding/RebuildingStoreBatch.h"
 #include "logdevice/server/rebuilding/ShardRebuildingV2.h"
 
 namespace facebook { namespace logdevice {
@@ -75,9 +76,29 @@ void ChunkRebuilding::start() {
             data_, data_->getUninitializedPayloadHolder(i)));
   }
   numInFlight_ = rrStores_.size();
+  numStoresInFlight_ = rrStores_.size();
+  deferredAmends_.clear();
+  blockAmends_ = rebuildingSettings_->block_amends && !readOnly_ &&
+      rrStores_.size() > 1;
+
+  if (!rebuildingSettings_->block_stores || readOnly_ ||
+      rrStores_.size() == 1) {
+    for (size_t i = 0; i < rrStores_.size(); ++i) {
+      rrStores_[i]->start(readOnly_);
+    }
+    return;
+  }
+
+  // Records of a chunk share the sticky copyset block they were written in,
+  // so they usually pick the same new copyset too. Send the STOREs of the
+  // whole block to each recipient together.
+  RebuildingStoreBatch batch;
+  storeBatch_ = &batch;
   for (size_t i = 0; i < rrStores_.size(); ++i) {
     rrStores_[i]->start(readOnly_);
   }
+  storeBatch_ = nullptr;
+  batch.flush();
 }
 
 bool ChunkRebuilding::onStoreSent(Status st,
@@ -159,10 +180,7 @@ bool ChunkRebuilding::onStored(const STORED_Header& header,
 void ChunkRebuilding::onAllStoresReceived(
     lsn_t lsn,
     std::unique_ptr<FlushTokenMap> flushTokenMap) {
-  if (!flushTokenMap->empty()) {
-    // TODO (#24665001): Wait for flushes. For now, setting
-    // rebuild-store-durability=memory just loses memtables on crash.
-  }
+  noteFlushTokens(*flushTokenMap);
   ld_check(numInFlight_ > 0);
   ssize_t idx = data_->findLSN(lsn);
   ld_check(idx != -1);
@@ -184,20 +202,97 @@ void ChunkRebuilding::onAllStoresReceived(
                                                   amend_state->newCopyset_,
                                                   amend_state->amendRecipients_,
                                                   amend_state->rebuildingWave_);
+  ld_check(numStoresInFlight_ > 0);
+  --numStoresInFlight_;
+  if (blockAmends_) {
+    deferredAmends_.push_back(idx);
+    if (numStoresInFlight_ == 0) {
+      startDeferredAmends();
+    }
+    return;
+  }
   amend->start(readOnly_);
 }
+
+void ChunkRebuilding::startDeferredAmends() {
+  ld_check_eq(numStoresInFlight_, 0);
+  auto to_start = std::move(deferredAmends_);
+  deferredAmends_.clear();
+
+  // Records of a chunk usually have the same new copyset, so each recipient
+  // gets the amends of the whole chunk in one or a few MULTI_STOREs.
+  // An amend with nothing to send completes synchronously; hold an extra
+  // in-flight count so that `this` isn't destroyed in the middle of the loop.
+  ++numInFlight_;
+  RebuildingStoreBatch batch;
+  storeBatch_ = &batch;
+  for (size_t idx : to_start) {
+    ld_check(rrAmends_.at(idx) != nullptr);
+    rrAmends_[idx]->start(readOnly_);
+  }
+  storeBatch_ = nullptr;
+  batch.flush();
+  --numInFlight_;
+  finishIfDone();
+  // `this` may be destroyed here.
+}
+
 void ChunkRebuilding::onCopysetInvalid(lsn_t lsn) {
   onAmendDone(lsn);
 }
 void ChunkRebuilding::onAllAmendsReceived(
     lsn_t lsn,
     std::unique_ptr<FlushTokenMap> flushTokenMap) {
-  if (!flushTokenMap->empty()) {
-    // TODO (#24665001): Wait for flushes.
-  }
+  noteFlushTokens(*flushTokenMap);
   onAmendDone(lsn);
 }
 
+void ChunkRebuilding::noteFlushTokens(const FlushTokenMap& tokens) {
+  for (const auto& kv : tokens) {
+    ld_check(kv.second != FlushToken_INVALID);
+    auto flushed_it = flushedUpTo_.find(kv.first);
+    if (flushed_it != flushedUpTo_.end() && flushed_it->second >= kv.second) {
+      continue;
+    }
+    FlushToken& pending = pendingFlushes_[kv.first];
+    pending = std::max(pending, kv.second);
+  }
+}
+
+void ChunkRebuilding::onMemtableFlushed(node_index_t node_index,
+                                        ServerInstanceId server_instance_id,
+                                        FlushToken flushed_upto) {
+  auto key = std::make_pair(node_index, server_instance_id);
+  FlushToken& flushed = flushedUpTo_[key];
+  flushed = std::max(flushed, flushed_upto);
+
+  auto it = pendingFlushes_.find(key);
+  if (it == pendingFlushes_.end() || it->second > flushed_upto) {
+    return;
+  }
+  pendingFlushes_.erase(it);
+  finishIfDone();
+  // `this` may be destroyed here.
+}
+
+void ChunkRebuilding::onDurabilityTimeout() {
+  RATELIMIT_INFO(std::chrono::seconds(10),
+                 1,
+                 "Rebuilt records of log %lu in [%s, %s] were not flushed by "
+                 "%lu recipients within %lds. Rebuilding the chunk again.",
+                 data_->address.log.val_,
+                 lsn_to_string(data_->address.min_lsn).c_str(),
+                 lsn_to_string(data_->address.max_lsn).c_str(),
+                 pendingFlushes_.size(),
+                 rebuildingSettings_->record_durability_timeout.count());
+  STAT_INCR(Worker::stats(), chunk_rebuilding_record_durability_timeout);
+  ld_check_eq(numInFlight_, 0);
+  pendingFlushes_.clear();
+  rrStores_.clear();
+  rrAmends_.clear();
+  start();
+}
+
 void ChunkRebuilding::onAmendDone(lsn_t lsn) {
   ld_check(numInFlight_ > 0);
   ssize_t idx = data_->findLSN(lsn);
@@ -208,22 +303,40 @@ void ChunkRebuilding::onAmendDone(lsn_t lsn) {
   amend.reset();
   --numInFlight_;
 
-  if (numInFlight_ == 0) {
-    owner_.postCallbackRequest([chunk_id = chunkID_,
-                                oldest_timestamp = data_->oldestTimestamp](
-                                   ShardRebuildingV2* shard_rebuilding) {
-      if (!shard_rebuilding) {
-        RATELIMIT_INFO(
-            std::chrono::seconds(10),
-            1,
-            "ShardRebuildingV2 went away while ChunkRebuilding was in flight.");
-        return;
-      }
-      shard_rebuilding->onChunkRebuildingDone(chunk_id, oldest_timestamp);
-    });
+  finishIfDone();
+  // `this` may be destroyed here.
+}
 
-    deleteThis();
+void ChunkRebuilding::finishIfDone() {
+  if (numInFlight_ != 0) {
+    return;
+  }
+  if (!pendingFlushes_.empty()) {
+    if (!durabilityTimer_) {
+      durabilityTimer_ =
+          std::make_unique<Timer>([this] { onDurabilityTimeout(); });
+    }
+    if (!durabilityTimer_->isActive()) {
+      durabilityTimer_->activate(
+          rebuildingSettings_->record_durability_timeout);
+    }
+    return;
   }
+
+  owner_.postCallbackRequest([chunk_id = chunkID_,
+                              oldest_timestamp = data_->oldestTimestamp](
+                                 ShardRebuildingV2* shard_rebuilding) {
+    if (!shard_rebuilding) {
+      RATELIMIT_INFO(
+          std::chrono::seconds(10),
+          1,
+          "ShardRebuildingV2 went away while ChunkRebuilding was in flight.");
+      return;
+    }
+    shard_rebuilding->onChunkRebuildingDone(chunk_id, oldest_timestamp);
+  });
+
+  deleteThis();
 }
 
 void ChunkRebuilding::deleteThis() {
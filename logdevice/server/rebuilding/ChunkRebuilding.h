@@ -9,6 +9,7 @@
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/PayloadHolder.h"
+#include "logdevice/common/Timer.h"
 #include "logdevice/server/RecordRebuildingStore.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 
@@ -120,6 +121,9 @@ class ChunkRebuilding : public RecordRebuildingOwner {
   lsn_t getRebuildingVersion() const override;
   lsn_t getRestartVersion() const override;
   log_rebuilding_id_t getLogRebuildingId() const override;
+  uint32_t getShard() const {
+    return shard_;
+  }
   ServerInstanceId getServerInstanceId() const override;
   UpdateableSettings<RebuildingSettings> getRebuildingSettings() const override;
 
@@ -147,6 +151,17 @@ class ChunkRebuilding : public RecordRebuildingOwner {
   void
   onAllAmendsReceived(lsn_t lsn,
                       std::unique_ptr<FlushTokenMap> flushTokenMap) override;
+  RebuildingStoreBatch* getStoreBatch() override {
+    return storeBatch_;
+  }
+
+  // Called when a recipient of our STOREs/amends reports that its memtables
+  // up to `flushed_upto` were flushed. Only matters with
+  // --rebuild-store-durability=memory, when the STOREs bypass the WAL and the
+  // chunk isn't done until the memtables holding them are flushed.
+  void onMemtableFlushed(node_index_t node_index,
+                         ServerInstanceId server_instance_id,
+                         FlushToken flushed_upto);
 
   // Unregisters itself from ServerWorker's ChunkRebuildingMap.
   void deleteThis();
@@ -170,10 +185,39 @@ class ChunkRebuilding : public RecordRebuildingOwner {
   std::vector<std::unique_ptr<RecordRebuildingAmend>> rrAmends_;
 
   size_t numInFlight_ = 0;
+  // Number of records still in the STORE stage.
+  size_t numStoresInFlight_ = 0;
+  // With --rebuilding-block-amends, indexes of records whose amends wait
+  // for the STOREs of the other records to complete.
+  std::vector<size_t> deferredAmends_;
 
   bool readOnly_ = false;
 
+  // Set during start() if --rebuilding-block-stores is enabled, so that the
+  // first wave of STOREs of all records goes out in MULTI_STOREs.
+  RebuildingStoreBatch* storeBatch_ = nullptr;
+  // Whether amends of this chunk are started all together, see
+  // --rebuilding-block-amends.
+  bool blockAmends_ = false;
+
+  // For each recipient that acked a write with a memtable FlushToken, the
+  // highest such token not yet reported as flushed.
+  FlushTokenMap pendingFlushes_;
+  // Highest FlushToken reported flushed by each recipient. A MEMTABLE_FLUSHED
+  // may arrive before the STORED it covers.
+  FlushTokenMap flushedUpTo_;
+  // If the writes are not flushed within --record-durability-timeout, e.g.
+  // because the recipient restarted and lost its memtables, the chunk is
+  // rebuilt again.
+  std::unique_ptr<Timer> durabilityTimer_;
+
   void onAmendDone(lsn_t lsn);
+  // Starts the amends in deferredAmends_, batched by recipient.
+  void startDeferredAmends();
+  void noteFlushTokens(const FlushTokenMap& tokens);
+  // Reports the chunk as done if all records are rebuilt and durable.
+  void finishIfDone();
+  void onDurabilityTimeout();
 };
 
 class StartChunkRebuildingRequest : public Request {
@@ -77,7 +77,8 @@ namespace facebook { namespace logdevice {
  * all shards at the beginning of rebuilding.
  */
 
-// Schedule a SyncSequencerRequest for all the given logs.
+// Schedule a SyncSequencerRequest for all the given logs. Their GET_SEQ_STATE
+// messages are coalesced per sequencer node by GetSeqStateBatcher.
 // Lives on the worker thread on which constructor was called.
 class RebuildingPlanner : public RebuildingLogEnumerator::Listener {
  public:
@@ -50,6 +50,7 @@ void RebuildingReadStorageTaskV2::execute() {
     LocalLogStore::ReadOptions opts(
         "RebuildingReadStorageTaskV2", /* rebuilding */ true);
     opts.fill_cache = context->rebuildingSettings->use_rocksdb_cache;
+    opts.readahead_size = context->rebuildingSettings->readahead_size;
     opts.allow_copyset_index = true;
 
     std::unordered_map<logid_t, std::pair<lsn_t, lsn_t>> logs;
@@ -124,12 +125,19 @@ void RebuildingReadStorageTaskV2::execute() {
       STAT_ADD(stats,
                read_streams_num_records_late_filtered_rebuilding,
                context->filter->nRecordsLateFiltered);
+      STAT_ADD(stats,
+               rebuilding_donor_records_taken_over,
+               context->filter->nRecordsTakenOver);
+      STAT_ADD(stats,
+               rebuilding_donor_records_handed_over,
+               context->filter->nRecordsTakenOverFiltered);
 
       size_t tot_skipped = context->filter->nRecordsSCDFiltered +
           context->filter->nRecordsNotDirtyFiltered +
           context->filter->nRecordsTimestampFiltered +
           context->filter->nRecordsDrainedFiltered +
-          context->filter->nRecordsEpochRangeFiltered;
+          context->filter->nRecordsEpochRangeFiltered +
+          context->filter->nRecordsTakenOverFiltered;
 
       auto end_time = SteadyTimestamp::now();
 
@@ -138,7 +146,7 @@ void RebuildingReadStorageTaskV2::execute() {
           1,
           "Rebuilding has read a batch of records in %.3fs. Got %lu records "
           "(%lu bytes) in %lu chunks. Skipped %lu records (SCD: %lu, ND: %lu, "
-          "DRAINED: %lu, TS: %lu, EPOCH: %lu; LATE: %lu).",
+          "DRAINED: %lu, TS: %lu, EPOCH: %lu, TAKEN OVER: %lu; LATE: %lu).",
           std::chrono::duration_cast<std::chrono::duration<double>>(end_time -
                                                                     start_time)
               .count(),
@@ -151,6 +159,7 @@ void RebuildingReadStorageTaskV2::execute() {
           context->filter->nRecordsDrainedFiltered,
           context->filter->nRecordsTimestampFiltered,
           context->filter->nRecordsEpochRangeFiltered,
+          context->filter->nRecordsTakenOverFiltered,
           context->filter->nRecordsLateFiltered);
     }
   };
@@ -536,6 +545,8 @@ void RebuildingReadStorageTaskV2::Filter::clearStats() {
   nRecordsDrainedFiltered = 0;
   nRecordsTimestampFiltered = 0;
   nRecordsEpochRangeFiltered = 0;
+  nRecordsTakenOverFiltered = 0;
+  nRecordsTakenOver = 0;
 }
 
 bool RebuildingReadStorageTaskV2::Filter::shouldProcessTimeRange(
@@ -797,6 +808,10 @@ operator()(logid_t log,
 
   // Perform SCD copyset filtering.
   bool result = !required_in_copyset_.empty();
+  if (result && !applyDonorTakeover(copyset, copyset_size, min_ts, max_ts)) {
+    filtered_reason = FilteredReason::TAKEN_OVER;
+    result = false;
+  }
   if (result) {
     filtered_reason = FilteredReason::SCD;
     result = LocalLogStoreReadFilter::operator()(
@@ -808,6 +823,73 @@ operator()(logid_t log,
   return result;
 }
 
+bool RebuildingReadStorageTaskV2::Filter::applyDonorTakeover(
+    const ShardID* copyset,
+    copyset_size_t copyset_size,
+    RecordTimestamp min_ts,
+    RecordTimestamp max_ts) {
+  const std::chrono::milliseconds lag =
+      context->rebuildingSettings->donor_takeover_lag;
+  // Extra copies are shipped by SCD regardless of the first donor, see
+  // LocalLogStoreReadFilter. Leave such records alone.
+  if (lag == std::chrono::milliseconds::max() ||
+      copyset_size > scd_replication_ || context->donorProgress.empty()) {
+    return true;
+  }
+
+  auto is_down = [&](ShardID shard) {
+    return std::find(scd_known_down_.begin(), scd_known_down_.end(), shard) !=
+        scd_known_down_.end();
+  };
+  if (is_down(scd_my_shard_id_)) {
+    return true;
+  }
+
+  // The first two shards that SCD would pick, in order.
+  copyset_off_t first = -1;
+  copyset_off_t second = -1;
+  for (copyset_off_t i = 0; i < copyset_size && second < 0; ++i) {
+    if (is_down(copyset[i])) {
+      continue;
+    }
+    (first < 0 ? first : second) = i;
+  }
+  if (second < 0) {
+    return true;
+  }
+
+  // True if a donor that reported `progress` is more than `lag` behind `ts`.
+  // A donor that hasn't reported anything yet counts as lagging.
+  auto lags_behind = [&](RecordTimestamp progress, RecordTimestamp ts) {
+    return progress < ts &&
+        (progress == RecordTimestamp::min() ||
+         ts.toMilliseconds() - progress.toMilliseconds() > lag);
+  };
+
+  // The two rules below agree with each other as long as each donor's view of
+  // another donor's progress never exceeds what that donor has reported, and
+  // the progress a donor reports only covers records it has fully rebuilt.
+  // If we skip a record because ts > our progress + lag, the second donor saw
+  // our progress at most as high when it read the record, so it took the
+  // record over. The second donor uses the high end of the record's time
+  // range and we use the low end, so this holds when only a range is known.
+  if (copyset[first] == scd_my_shard_id_) {
+    auto it = context->donorProgress.find(copyset[second].node());
+    if (it != context->donorProgress.end() && it->second > max_ts &&
+        lags_behind(RecordTimestamp(context->myReportedProgress), min_ts)) {
+      return false;
+    }
+  } else if (copyset[second] == scd_my_shard_id_) {
+    auto it = context->donorProgress.find(copyset[first].node());
+    if (it != context->donorProgress.end() &&
+        lags_behind(it->second, max_ts)) {
+      scd_known_down_.push_back(copyset[first]);
+      ++nRecordsTakenOver;
+    }
+  }
+  return true;
+}
+
 bool RebuildingReadStorageTaskV2::Filter::lookUpLogState(logid_t log) {
   if (log == currentLog) {
     return currentLogState != nullptr;
@@ -844,6 +926,9 @@ void RebuildingReadStorageTaskV2::Filter::noteRecordFiltered(
     case FilteredReason::EPOCH_RANGE:
       ++nRecordsEpochRangeFiltered;
       break;
+    case FilteredReason::TAKEN_OVER:
+      ++nRecordsTakenOverFiltered;
+      break;
   }
   if (late) {
     ++nRecordsLateFiltered;
@@ -113,6 +113,15 @@ class RebuildingReadStorageTaskV2 : public StorageTask {
     // true if we're not going to be able to read everything we need.
     bool persistentError = false;
 
+    // For --rebuilding-donor-takeover-lag. Progress of the donors as last
+    // seen in the event log.
+    std::unordered_map<node_index_t, RecordTimestamp> donorProgress;
+    // The highest progress we have written to the event log. Unlike the other
+    // mutable fields, it is updated by ShardRebuilding even while a storage
+    // task is in flight, because it must never be behind what other donors
+    // may have seen.
+    AtomicRecordTimestamp myReportedProgress{RecordTimestamp::min()};
+
     void getLogsDebugInfo(InfoRebuildingLogsTable& table) const;
 
    private:
@@ -182,7 +191,8 @@ class RebuildingReadStorageTaskV2 : public StorageTask {
       NOT_DIRTY,
       DRAINED,
       TIMESTAMP,
-      EPOCH_RANGE
+      EPOCH_RANGE,
+      TAKEN_OVER
     };
 
     explicit Filter(Context* context);
@@ -210,6 +220,17 @@ class RebuildingReadStorageTaskV2 : public StorageTask {
     // and returns false.
     bool lookUpLogState(logid_t log);
 
+    // Applies --rebuilding-donor-takeover-lag to a record that passed the
+    // rebuilding set checks, with scd_known_down_ already filled in.
+    // If the first donor in the copyset lags behind and we're the second, adds
+    // the first one to scd_known_down_ so that we ship the record. If we're
+    // the first and the second one has already gone past this record after
+    // deciding to take it over from us, returns false.
+    bool applyDonorTakeover(const ShardID* copyset,
+                            copyset_size_t copyset_size,
+                            RecordTimestamp min_ts,
+                            RecordTimestamp max_ts);
+
     // Update stats regarding skipped records.
     // @param late  true if the filter was called on the full record rather
     // than CSI entry.
@@ -259,6 +280,9 @@ class RebuildingReadStorageTaskV2 : public StorageTask {
     size_t nRecordsDrainedFiltered{std::numeric_limits<size_t>::max() / 2};
     size_t nRecordsTimestampFiltered{std::numeric_limits<size_t>::max() / 2};
     size_t nRecordsEpochRangeFiltered{std::numeric_limits<size_t>::max() / 2};
+    size_t nRecordsTakenOverFiltered{std::numeric_limits<size_t>::max() / 2};
+    // Records we shipped on behalf of a lagging donor.
+    size_t nRecordsTakenOver{std::numeric_limits<size_t>::max() / 2};
   };
 
   std::weak_ptr<Context> context_;
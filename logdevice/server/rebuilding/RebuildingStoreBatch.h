@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/SocketCallback.h"
+
+namespace facebook { namespace logdevice {
+
+class STORE_Message;
+
+/**
+ * @file Collects the STOREs that the RecordRebuildingStores of a
+ *       ChunkRebuilding send in their first wave, grouped by destination
+ *       node, and sends them as MULTI_STORE messages once all records of the
+ *       chunk have picked their copysets. With --rebuilding-block-amends the
+ *       same is done for the chunk's amends.
+ *
+ *       A chunk is a run of consecutive records of a log that were written
+ *       with the same sticky copyset, and the copyset selector is seeded with
+ *       the chunk's block ID, so all records of a chunk usually go to the same
+ *       recipients. With --rebuilding-block-stores each recipient then gets
+ *       the whole block in one or a few messages instead of one STORE per
+ *       record, and writes the block with one WriteBatchStorageTask.
+ *
+ *       Lives on the stack of ChunkRebuilding::start() (or
+ *       startDeferredAmends()). Retries and STOREs to nodes that don't
+ *       support MULTI_STORE are sent directly.
+ */
+
+class RebuildingStoreBatch {
+ public:
+  RebuildingStoreBatch();
+  ~RebuildingStoreBatch();
+
+  RebuildingStoreBatch(const RebuildingStoreBatch&) = delete;
+  RebuildingStoreBatch& operator=(const RebuildingStoreBatch&) = delete;
+
+  /**
+   * Takes a STORE for `to`, if it can be batched. On success `onclose` is
+   * registered with the socket to `to`, exactly as if `msg` was passed to
+   * Sender::sendMessage().
+   *
+   * @return  true if `msg` was taken. false if `to` has no connection that
+   *          supports MULTI_STORE, or the record is too big to be batched;
+   *          `msg` is left untouched and the caller should send it directly.
+   */
+  bool add(std::unique_ptr<STORE_Message>& msg,
+           NodeID to,
+           SocketCallback& onclose);
+
+  // Sends everything collected so far. The outcome of sending each STORE is
+  // reported through STORE_onSent(), same as for STOREs sent directly.
+  void flush();
+
+ private:
+  struct Batch {
+    NodeID to;
+    std::vector<std::unique_ptr<STORE_Message>> stores;
+    // Approximate size of the records in the batch.
+    size_t bytes = 0;
+  };
+
+  void send(Batch batch);
+
+  std::unordered_map<node_index_t, Batch> batches_;
+  // Batches that reached --store-batching-max-bytes, waiting for flush().
+  std::vector<Batch> full_batches_;
+};
+
+}} // namespace facebook::logdevice
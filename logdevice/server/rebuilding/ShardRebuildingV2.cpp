@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/rebuilding/ShardRebuildingV2.h"
 
+#include <folly/hash/Hash.h>
+
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
@@ -60,19 +62,35 @@ void ShardRebuildingV2::start(
   numLogs_ = plan.size();
   startTime_ = SteadyTimestamp::now();
   readRateLimiter_ = RateLimiter(rebuildingSettings_->rate_limit);
-  readContext_ = std::make_shared<RebuildingReadStorageTaskV2::Context>();
-  readContext_->onDone = [this, this_ref = callbackHelper_.getHolder().ref()](
-                             std::vector<std::unique_ptr<ChunkData>> chunks) {
-    if (this_ref.get() != nullptr) {
-      onReadTaskDone(std::move(chunks));
-    }
-  };
-  readContext_->rebuildingSet = rebuildingSet_;
-  readContext_->rebuildingSettings = rebuildingSettings_;
-  readContext_->myShardID = ShardID(getMyNodeIndex(), shard_);
+
+  // Don't create readers that would have no logs to read.
+  const size_t num_readers = std::max(
+      size_t(1), std::min(rebuildingSettings_->read_parallelism, plan.size()));
+  readers_.resize(num_readers);
+  for (size_t idx = 0; idx < num_readers; ++idx) {
+    auto context = std::make_shared<RebuildingReadStorageTaskV2::Context>();
+    context->onDone = [this,
+                       idx,
+                       this_ref = callbackHelper_.getHolder().ref()](
+                          std::vector<std::unique_ptr<ChunkData>> chunks) {
+      if (this_ref.get() != nullptr) {
+        onReadTaskDone(idx, std::move(chunks));
+      }
+    };
+    context->rebuildingSet = rebuildingSet_;
+    context->rebuildingSettings = rebuildingSettings_;
+    context->myShardID = ShardID(getMyNodeIndex(), shard_);
+    context->donorProgress = donorProgress_;
+    context->myReportedProgress = myReportedProgress_;
+    readers_[idx].context = std::move(context);
+    readers_[idx].iteratorInvalidationTimer =
+        createTimer([this, idx] { invalidateIterator(idx); });
+  }
 
   for (const auto& log_plan : plan) {
-    auto ins = readContext_->logs.emplace(
+    const size_t idx =
+        folly::hash::twang_mix64(log_plan.first.val_) % num_readers;
+    auto ins = readers_[idx].context->logs.emplace(
         std::piecewise_construct,
         std::forward_as_tuple(log_plan.first),
         std::forward_as_tuple(std::move(*log_plan.second)));
@@ -80,7 +98,6 @@ void ShardRebuildingV2::start(
   }
 
   delayedReadTimer_ = createTimer([this] { tryMakeProgress(); });
-  iteratorInvalidationTimer_ = createTimer([this] { invalidateIterator(); });
   profilingTimer_ = createTimer([this] {
     profilingTimer_->activate(PROFILING_TIMER_PERIOD);
     flushCurrentStateTime();
@@ -93,25 +110,41 @@ void ShardRebuildingV2::start(
 
 void ShardRebuildingV2::advanceGlobalWindow(RecordTimestamp new_window_end) {
   globalWindowEnd_ = new_window_end;
-  if (readContext_ != nullptr) {
+  if (!readers_.empty()) {
     tryMakeProgress();
   } else {
     // start() hasn't been called yet.
   }
 }
 
-void ShardRebuildingV2::sendStorageTaskIfNeeded() {
+void ShardRebuildingV2::noteDonorProgress(
+    std::unordered_map<node_index_t, RecordTimestamp> donor_progress) {
+  // Readers pick it up when they send their next storage task.
+  donorProgress_ = std::move(donor_progress);
+}
+
+void ShardRebuildingV2::noteMyReportedProgress(RecordTimestamp progress) {
+  myReportedProgress_.storeMax(progress);
+  // This one is atomic and can be updated while a storage task is in flight.
+  // It must never be lower than what other donors may have seen in event log.
+  for (Reader& reader : readers_) {
+    reader.context->myReportedProgress.storeMax(progress);
+  }
+}
+
+void ShardRebuildingV2::sendStorageTaskIfNeeded(size_t reader_idx) {
+  Reader& reader = readers_[reader_idx];
   const size_t read_batch_size = rebuildingSettings_->max_batch_bytes;
-  // Hard code max size of readBuffer_ as 3x max read batch size.
+  // Hard code max size of each reader's readBuffer as 3x max read batch size.
   // This could be a separate setting, but that doesn't seem very useful.
   const size_t max_read_buffer_size = read_batch_size * 3;
 
   // Note that reading is not affected by global window or
-  // max_record_bytes_in_flight. Reading just tries to keep readBuffer_
+  // max_record_bytes_in_flight. Reading just tries to keep readBuffer
   // reasonably full.
-  if (completed_ || storageTaskInFlight_ || readContext_->reachedEnd ||
-      readContext_->persistentError ||
-      bytesInReadBuffer_ + read_batch_size > max_read_buffer_size ||
+  if (completed_ || reader.storageTaskInFlight || reader.context->reachedEnd ||
+      reader.context->persistentError ||
+      reader.bytesInReadBuffer + read_batch_size > max_read_buffer_size ||
       rebuildingSettings_->test_stall_rebuilding) {
     return;
   }
@@ -129,15 +162,17 @@ void ShardRebuildingV2::sendStorageTaskIfNeeded() {
     return;
   }
 
-  if (readContext_->iterator != nullptr) {
-    iteratorInvalidationTimer_->cancel();
+  if (reader.context->iterator != nullptr) {
+    reader.iteratorInvalidationTimer->cancel();
   }
-  storageTaskInFlight_ = true;
-  putStorageTask();
+  reader.storageTaskInFlight = true;
+  reader.context->donorProgress = donorProgress_;
+  putStorageTask(reader_idx);
 }
 
-void ShardRebuildingV2::putStorageTask() {
-  auto task = std::make_unique<RebuildingReadStorageTaskV2>(readContext_);
+void ShardRebuildingV2::putStorageTask(size_t reader_idx) {
+  auto task = std::make_unique<RebuildingReadStorageTaskV2>(
+      readers_[reader_idx].context);
   auto task_queue =
       ServerWorker::onThisThread()->getStorageTaskQueueForShard(shard_);
   task_queue->putTask(std::move(task));
@@ -152,62 +187,124 @@ ShardRebuildingV2::createTimer(std::function<void()> cb) {
   return std::make_unique<Timer>(cb);
 }
 
-void ShardRebuildingV2::invalidateIterator() {
-  ld_info("Invalidating rebuilding iterator in shard %u", shard_);
-  ld_check(!storageTaskInFlight_);
-  ld_check(readContext_->iterator != nullptr);
-  readContext_->iterator->invalidate();
+void ShardRebuildingV2::invalidateIterator(size_t reader_idx) {
+  Reader& reader = readers_[reader_idx];
+  ld_info("Invalidating rebuilding iterator %lu in shard %u",
+          reader_idx,
+          shard_);
+  ld_check(!reader.storageTaskInFlight);
+  ld_check(reader.context->iterator != nullptr);
+  reader.context->iterator->invalidate();
 }
 
 void ShardRebuildingV2::onReadTaskDone(
+    size_t reader_idx,
     std::vector<std::unique_ptr<ChunkData>> chunks) {
+  Reader& reader = readers_[reader_idx];
   // Report the cost of this read task to rate limiter.
   std::chrono::steady_clock::duration unused;
-  readRateLimiter_.isAllowed(readContext_->bytesRead, &unused);
+  readRateLimiter_.isAllowed(reader.context->bytesRead, &unused);
 
   for (auto& c : chunks) {
+    reader.bytesInReadBuffer += c->totalBytes();
     bytesInReadBuffer_ += c->totalBytes();
   }
-  readBuffer_.insert(readBuffer_.end(),
-                     std::make_move_iterator(chunks.begin()),
-                     std::make_move_iterator(chunks.end()));
-  storageTaskInFlight_ = false;
+  reader.readBuffer.insert(reader.readBuffer.end(),
+                           std::make_move_iterator(chunks.begin()),
+                           std::make_move_iterator(chunks.end()));
+  reader.storageTaskInFlight = false;
   ++readTasksDone_;
-  nextLocation_ = readContext_->nextLocation;
-  readingProgressTimestamp_ = readContext_->progressTimestamp;
-  readingProgress_ = readContext_->progress;
-  if (readContext_->iterator != nullptr) {
-    iteratorInvalidationTimer_->activate(getIteratorTTL());
+  reader.nextLocation = reader.context->nextLocation;
+  reader.readingProgressTimestamp = reader.context->progressTimestamp;
+  reader.readingProgress = reader.context->progress;
+  updateReadingProgress();
+  if (reader.context->iterator != nullptr) {
+    reader.iteratorInvalidationTimer->activate(getIteratorTTL());
   }
   tryMakeProgress();
 }
 
+void ShardRebuildingV2::updateReadingProgress() {
+  // A reader that has reached the end doesn't hold back the others, unless
+  // all of them have.
+  RecordTimestamp min_unfinished = RecordTimestamp::max();
+  RecordTimestamp max_finished = RecordTimestamp::min();
+  double progress_sum = 0;
+  bool progress_supported = true;
+  for (const Reader& reader : readers_) {
+    if (reader.context->reachedEnd) {
+      max_finished = std::max(max_finished, reader.readingProgressTimestamp);
+    } else {
+      min_unfinished =
+          std::min(min_unfinished, reader.readingProgressTimestamp);
+    }
+    if (reader.readingProgress < 0) {
+      progress_supported = false;
+    }
+    progress_sum += reader.readingProgress;
+  }
+  readingProgressTimestamp_ =
+      min_unfinished != RecordTimestamp::max() ? min_unfinished : max_finished;
+  readingProgress_ =
+      progress_supported ? progress_sum / readers_.size() : -1;
+}
+
+size_t ShardRebuildingV2::readerWithOldestChunk() const {
+  size_t res = readers_.size();
+  for (size_t idx = 0; idx < readers_.size(); ++idx) {
+    const auto& buffer = readers_[idx].readBuffer;
+    if (!buffer.empty() &&
+        (res == readers_.size() ||
+         buffer.front()->oldestTimestamp <
+             readers_[res].readBuffer.front()->oldestTimestamp)) {
+      res = idx;
+    }
+  }
+  return res;
+}
+
+bool ShardRebuildingV2::anyStorageTaskInFlight() const {
+  for (const Reader& reader : readers_) {
+    if (reader.storageTaskInFlight) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ShardRebuildingV2::startSomeChunkRebuildingsIfNeeded() {
   const size_t max_records_in_flight =
       rebuildingSettings_->max_records_in_flight;
   const size_t max_bytes_in_flight =
       rebuildingSettings_->max_record_bytes_in_flight;
 
-  auto record_rebuildings_are_too_spread_out = [&] {
+  auto record_rebuildings_are_too_spread_out = [&](const Reader& reader) {
     const std::chrono::milliseconds local_window =
         rebuildingSettings_->local_window;
     return !chunkRebuildings_.empty() &&
-        readBuffer_.front()->oldestTimestamp -
+        reader.readBuffer.front()->oldestTimestamp -
             chunkRebuildings_.begin()->first.oldestTimestamp >
         local_window;
   };
 
-  while (!readBuffer_.empty() &&
-         chunkRebuildingRecordsInFlight_ < max_records_in_flight &&
-         chunkRebuildingBytesInFlight_ < max_bytes_in_flight &&
-         !record_rebuildings_are_too_spread_out()) {
-    if (readBuffer_.front()->oldestTimestamp > globalWindowEnd_) {
+  // Merge the read buffers of all readers in timestamp order.
+  while (chunkRebuildingRecordsInFlight_ < max_records_in_flight &&
+         chunkRebuildingBytesInFlight_ < max_bytes_in_flight) {
+    const size_t idx = readerWithOldestChunk();
+    if (idx == readers_.size()) {
+      break;
+    }
+    Reader* reader = &readers_[idx];
+    if (record_rebuildings_are_too_spread_out(*reader) ||
+        reader->readBuffer.front()->oldestTimestamp > globalWindowEnd_) {
       break;
     }
 
     log_rebuilding_id_t chunk_id{++nextChunkID_};
-    std::unique_ptr<ChunkData> chunk = std::move(readBuffer_.front());
-    readBuffer_.pop_front();
+    std::unique_ptr<ChunkData> chunk = std::move(reader->readBuffer.front());
+    reader->readBuffer.pop_front();
+    ld_check_ge(reader->bytesInReadBuffer, chunk->totalBytes());
+    reader->bytesInReadBuffer -= chunk->totalBytes();
     ld_check_ge(bytesInReadBuffer_, chunk->totalBytes());
     bytesInReadBuffer_ -= chunk->totalBytes();
 
@@ -236,12 +333,14 @@ void ShardRebuildingV2::startSomeChunkRebuildingsIfNeeded() {
   // haven't rebuilt yet, and publish this timestamp for other donors to slide
   // global window based on it.
   RecordTimestamp oldest_timestamp;
+  const size_t oldest_reader = readerWithOldestChunk();
   if (!chunkRebuildings_.empty()) {
     // If there are some records in flight, use the oldest one.
     oldest_timestamp = chunkRebuildings_.begin()->first.oldestTimestamp;
-  } else if (!readBuffer_.empty()) {
+  } else if (oldest_reader < readers_.size()) {
     // If there are some records in buffer, use the first one.
-    oldest_timestamp = readBuffer_.front()->oldestTimestamp;
+    oldest_timestamp =
+        readers_[oldest_reader].readBuffer.front()->oldestTimestamp;
   } else {
     // Otherwise, either we're just starting, or we're filtering everything we
     // read. In the latter case it's useful to report the approximate progress
@@ -250,6 +349,16 @@ void ShardRebuildingV2::startSomeChunkRebuildingsIfNeeded() {
     // window is enabled), and keeps progress stat up to date.
     oldest_timestamp = readingProgressTimestamp_;
   }
+  if (readers_.size() > 1) {
+    // A reader with an empty buffer may still produce chunks older than the
+    // ones buffered by other readers.
+    for (const Reader& r : readers_) {
+      if (r.readBuffer.empty() && !r.context->reachedEnd) {
+        oldest_timestamp =
+            std::min(oldest_timestamp, r.readingProgressTimestamp);
+      }
+    }
+  }
   listener_->notifyShardDonorProgress(
       shard_, oldest_timestamp, rebuildingVersion_, readingProgress_);
 }
@@ -311,11 +420,15 @@ void ShardRebuildingV2::finalizeIfNeeded() {
   // ShardRebuilding indefinitely; usually this happens if our own disk is
   // broken, in which case self-initiated rebuilding will soon request a
   // rebuilding, and this ShardRebuilding will be aborted.
-  if (completed_ || storageTaskInFlight_ || !readContext_->reachedEnd ||
-      readContext_->persistentError || !readBuffer_.empty() ||
-      !chunkRebuildings_.empty()) {
+  if (completed_ || !chunkRebuildings_.empty()) {
     return;
   }
+  for (const Reader& reader : readers_) {
+    if (reader.storageTaskInFlight || !reader.context->reachedEnd ||
+        reader.context->persistentError || !reader.readBuffer.empty()) {
+      return;
+    }
+  }
   completed_ = true;
   ld_info("Rebuilt shard %u in %.3fs (%s). Rebuilt %lu chunks, %lu records, "
           "%lu bytes. Executed %lu read storage tasks.",
@@ -333,7 +446,9 @@ void ShardRebuildingV2::finalizeIfNeeded() {
 
 void ShardRebuildingV2::tryMakeProgress() {
   startSomeChunkRebuildingsIfNeeded();
-  sendStorageTaskIfNeeded();
+  for (size_t idx = 0; idx < readers_.size(); ++idx) {
+    sendStorageTaskIfNeeded(idx);
+  }
   updateProfilingState();
   finalizeIfNeeded();
 }
@@ -354,11 +469,14 @@ void ShardRebuildingV2::getDebugInfo(InfoRebuildingShardsTable& table) const {
   // TODO (#24665001):
   //   This doesn't match the current column name is "local_window_end".
   //   When rebuilding v2 becomes the default, rename the column.
+  const size_t oldest_reader = readerWithOldestChunk();
   if (!chunkRebuildings_.empty()) {
     table.set<4>(
         chunkRebuildings_.begin()->first.oldestTimestamp.toMilliseconds());
-  } else if (!readBuffer_.empty()) {
-    table.set<4>(readBuffer_.front()->oldestTimestamp.toMilliseconds());
+  } else if (oldest_reader < readers_.size()) {
+    table.set<4>(readers_[oldest_reader]
+                     .readBuffer.front()
+                     ->oldestTimestamp.toMilliseconds());
   } else {
     table.set<4>(readingProgressTimestamp_.toMilliseconds());
   }
@@ -366,26 +484,48 @@ void ShardRebuildingV2::getDebugInfo(InfoRebuildingShardsTable& table) const {
   table.set<9>(bytesInReadBuffer_ + chunkRebuildingBytesInFlight_);
   table.set<12>(numLogs_);
   table.set<14>(describeTimeByState());
-  table.set<15>(storageTaskInFlight_);
-  if (!storageTaskInFlight_) {
-    table.set<16>(readContext_->persistentError);
+  table.set<15>(anyStorageTaskInFlight());
+  bool persistent_error = false;
+  bool persistent_error_known = true;
+  std::string locations;
+  for (const Reader& reader : readers_) {
+    if (reader.storageTaskInFlight) {
+      persistent_error_known = false;
+    } else {
+      persistent_error |= reader.context->persistentError;
+    }
+    if (reader.nextLocation != nullptr) {
+      if (!locations.empty()) {
+        locations += "; ";
+      }
+      locations += reader.nextLocation->toString();
+    }
+  }
+  if (persistent_error_known || persistent_error) {
+    table.set<16>(persistent_error);
   }
   table.set<17>(bytesInReadBuffer_);
   // TODO (#24665001):
   //   When ChunkRebuilding gets reimplemented to process all records at once,
   //   change this into number of chunks in flight.
   table.set<18>(chunkRebuildingRecordsInFlight_);
-  if (nextLocation_ != nullptr) {
-    table.set<19>(nextLocation_->toString());
+  if (!locations.empty()) {
+    table.set<19>(locations);
   }
   table.set<20>(readingProgress_);
 }
 
 std::function<void(InfoRebuildingLogsTable&)>
 ShardRebuildingV2::beginGetLogsDebugInfo() const {
-  ld_check(readContext_ != nullptr);
-  return [context = readContext_](InfoRebuildingLogsTable& table) {
-    context->getLogsDebugInfo(table);
+  ld_check(!readers_.empty());
+  std::vector<std::shared_ptr<RebuildingReadStorageTaskV2::Context>> contexts;
+  for (const Reader& reader : readers_) {
+    contexts.push_back(reader.context);
+  }
+  return [contexts = std::move(contexts)](InfoRebuildingLogsTable& table) {
+    for (const auto& context : contexts) {
+      context->getLogsDebugInfo(table);
+    }
   };
 }
 
@@ -439,22 +579,29 @@ void ShardRebuildingV2::flushCurrentStateTime() {
 }
 void ShardRebuildingV2::updateProfilingState() {
   ProfilingState new_state;
+  const bool task_in_flight = anyStorageTaskInFlight();
+  const size_t oldest_reader = readerWithOldestChunk();
   if (chunkRebuildings_.empty()) {
-    if (storageTaskInFlight_) {
+    if (task_in_flight) {
       new_state = ProfilingState::WAITING_FOR_READ;
-    } else if (readBuffer_.empty()) {
+    } else if (oldest_reader == readers_.size()) {
       new_state = ProfilingState::RATE_LIMITED;
     } else {
       new_state = ProfilingState::STALLED;
     }
   } else {
-    new_state = storageTaskInFlight_
+    new_state = task_in_flight
         ? ProfilingState::FULLY_OCCUPIED
         : ProfilingState::WAITING_FOR_REREPLICATION;
   }
   if (new_state != profilingState_) {
     // Log a message if we started or stopped waiting on global window.
-    if (storageTaskInFlight_ || !readContext_->persistentError) {
+    bool persistent_error = false;
+    for (const Reader& reader : readers_) {
+      persistent_error |=
+          !reader.storageTaskInFlight && reader.context->persistentError;
+    }
+    if (!persistent_error) {
       if (new_state == ProfilingState::STALLED) {
         PER_SHARD_STAT_SET(
             getStats(), rebuilding_global_window_waiting_flag, shard_, 1);
@@ -462,9 +609,12 @@ void ShardRebuildingV2::updateProfilingState() {
                 "slide. Next timestamp to rebuild: %s, global window end: %s, "
                 "total wait time so far: %.3fs",
                 shard_,
-                readBuffer_.empty()
+                oldest_reader == readers_.size()
                     ? "none"
-                    : readBuffer_.front()->oldestTimestamp.toString().c_str(),
+                    : readers_[oldest_reader]
+                          .readBuffer.front()
+                          ->oldestTimestamp.toString()
+                          .c_str(),
                 globalWindowEnd_.toString().c_str(),
                 totalTimeByState_[(int)ProfilingState::STALLED].count() / 1e3);
       } else if (profilingState_ == ProfilingState::STALLED) {
@@ -32,10 +32,14 @@ class ShardRebuildingV2 : public ShardRebuildingInterface {
   void start(std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan)
       override;
   void advanceGlobalWindow(RecordTimestamp new_window_end) override;
+  void noteDonorProgress(std::unordered_map<node_index_t, RecordTimestamp>
+                             donor_progress) override;
+  void noteMyReportedProgress(RecordTimestamp progress) override;
   void noteConfigurationChanged() override;
   void noteRebuildingSettingsChanged() override;
 
-  void onReadTaskDone(std::vector<std::unique_ptr<ChunkData>> chunks);
+  void onReadTaskDone(size_t reader_idx,
+                      std::vector<std::unique_ptr<ChunkData>> chunks);
   void onChunkRebuildingDone(log_rebuilding_id_t chunk_id,
                              RecordTimestamp oldest_timestamp);
 
@@ -55,7 +59,7 @@ class ShardRebuildingV2 : public ShardRebuildingInterface {
   virtual worker_id_t startChunkRebuilding(std::unique_ptr<ChunkData> chunk,
                                            log_rebuilding_id_t chunk_id);
   virtual std::chrono::milliseconds getIteratorTTL();
-  virtual void putStorageTask();
+  virtual void putStorageTask(size_t reader_idx);
   virtual std::unique_ptr<TimerInterface> createTimer(std::function<void()> cb);
 
  protected:
@@ -92,18 +96,48 @@ class ShardRebuildingV2 : public ShardRebuildingInterface {
 
   RecordTimestamp globalWindowEnd_{RecordTimestamp::max()};
 
-  // There's at most one RebuildingReadStorageTaskV2 in flight at any time.
-  bool storageTaskInFlight_ = false;
-  // The reading context is shared between us and the storage task.
-  // When a storage task is in flight, we're not allowed to access the context.
-  std::shared_ptr<RebuildingReadStorageTaskV2::Context> readContext_;
+  // Last known progress of all donors, as seen in event log, and the highest
+  // progress we've reported ourselves. Used by
+  // --rebuilding-donor-takeover-lag. Copied into readers' contexts.
+  std::unordered_map<node_index_t, RecordTimestamp> donorProgress_;
+  RecordTimestamp myReportedProgress_{RecordTimestamp::min()};
+
+  // An independent reading pipeline. The logs of the shard are split among
+  // rebuilding-read-parallelism readers by log ID; each reader has its own
+  // iterator, storage task and read buffer, and they all feed the same set of
+  // ChunkRebuildings.
+  struct Reader {
+    // There's at most one RebuildingReadStorageTaskV2 in flight per reader.
+    bool storageTaskInFlight = false;
+    // The reading context is shared between us and the storage task.
+    // When a storage task is in flight, we're not allowed to access the
+    // context.
+    std::shared_ptr<RebuildingReadStorageTaskV2::Context> context;
+
+    // Records we've read but haven't started ChunkRebuilding yet.
+    std::deque<std::unique_ptr<ChunkData>> readBuffer;
+    size_t bytesInReadBuffer = 0;
+
+    // If iterator doesn't get seeked for some time, this timer fires and
+    // invalidates it. For rocksdb-based LocalLogStore implementations the
+    // invalidation prevents the iterator from pinning old versions of
+    // data indefinitely.
+    std::unique_ptr<TimerInterface> iteratorInvalidationTimer;
+
+    // These are duplicated from context to make sure we always have
+    // lock-free access to them. See readingProgressTimestamp_ and
+    // readingProgress_.
+    std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation;
+    RecordTimestamp readingProgressTimestamp = RecordTimestamp::min();
+    double readingProgress = 0;
+  };
+  std::vector<Reader> readers_;
 
   RateLimiter readRateLimiter_;
   // The timer is used when readRateLimiter_ tells us to wait before reading.
   std::unique_ptr<TimerInterface> delayedReadTimer_;
 
-  // Records we've read but haven't started ChunkRebuilding yet.
-  std::deque<std::unique_ptr<ChunkData>> readBuffer_;
+  // Sum of bytesInReadBuffer over readers_.
   size_t bytesInReadBuffer_ = 0;
 
   // Information about in-flight ChunkRebuildings.
@@ -117,12 +151,6 @@ class ShardRebuildingV2 : public ShardRebuildingInterface {
   size_t chunkRebuildingRecordsInFlight_ = 0;
   size_t chunkRebuildingBytesInFlight_ = 0;
 
-  // If iterator doesn't get seeked for some time, this timer fires and
-  // invalidates it. For rocksdb-based LocalLogStore implementations the
-  // invalidation prevents the iterator from pinning old versions of
-  // data indefinitely.
-  std::unique_ptr<TimerInterface> iteratorInvalidationTimer_;
-
   WorkerCallbackHelper<ShardRebuildingV2> callbackHelper_;
 
   static std::atomic<log_rebuilding_id_t::raw_type> nextChunkID_;
@@ -130,11 +158,16 @@ class ShardRebuildingV2 : public ShardRebuildingInterface {
   // Posts requests to abort state machines listed in chunkRebuildings_.
   void abortChunkRebuildings();
 
-  void sendStorageTaskIfNeeded();
+  void sendStorageTaskIfNeeded(size_t reader_idx);
   void startSomeChunkRebuildingsIfNeeded();
   void finalizeIfNeeded();
 
-  void invalidateIterator();
+  void invalidateIterator(size_t reader_idx);
+
+  // Index of the reader whose read buffer starts with the oldest chunk, or
+  // readers_.size() if all read buffers are empty.
+  size_t readerWithOldestChunk() const;
+  bool anyStorageTaskInFlight() const;
 
   void tryMakeProgress();
 
@@ -175,15 +208,12 @@ class ShardRebuildingV2 : public ShardRebuildingInterface {
   size_t recordsRebuilt_ = 0;
   size_t bytesRebuilt_ = 0;
   size_t readTasksDone_ = 0;
-  // These are duplicated from readContext_ to make sure we always have
-  // lock-free access to them.
   size_t numLogs_;
-  std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation_;
   // Calls flushCurrentStateTime() every minute, to make sure we're publishing
   // accurate time spent in each state even when state doesn't change often.
   std::unique_ptr<TimerInterface> profilingTimer_;
 
-  // How far the iterator has read, approximately.
+  // How far the iterators have read, approximately, combined over readers_.
   // Note that this may not correspond to any record.
   // In particular, if we're filtering out very long ranges of data, this
   // iterator will show progress of the filtering, while any record-based
@@ -193,6 +223,9 @@ class ShardRebuildingV2 : public ShardRebuildingInterface {
   // we have read. -1 means not supported.
   double readingProgress_ = 0;
 
+  // Recomputes readingProgressTimestamp_ and readingProgress_ from readers_.
+  void updateReadingProgress();
+
   // Advances currentStateStartTime_ to current time, updating totalTimeByState_
   // and stats as needed.
   void flushCurrentStateTime();
@@ -134,6 +134,7 @@ void shutdown_server(
     std::unique_ptr<Listener>& command_listener,
     std::unique_ptr<Listener>& gossip_listener,
     std::unique_ptr<Listener>& ssl_connection_listener,
+    std::vector<std::unique_ptr<Listener>>& worker_connection_listeners,
     std::unique_ptr<EventLoop>& connection_listener_loop,
     std::unique_ptr<EventLoop>& command_listener_loop,
     std::unique_ptr<EventLoop>& gossip_listener_loop,
@@ -209,8 +210,13 @@ void shutdown_server(
     listeners_closed.emplace_back(
         ssl_connection_listener->stopAcceptingConnections());
   }
+  for (auto& listener : worker_connection_listeners) {
+    listeners_closed.emplace_back(listener->stopAcceptingConnections());
+  }
   folly::collectAll(listeners_closed.begin(), listeners_closed.end()).wait();
 
+  // Must be destroyed while Workers are still running their event loops.
+  worker_connection_listeners.clear();
   connection_listener.reset();
   connection_listener_loop.reset();
   gossip_listener.reset();
@@ -9,6 +9,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "logdevice/common/WorkerType.h"
 
@@ -43,8 +44,8 @@ class ClusterMaintenanceStateMachine;
  *      SequencerPlacement object to failover currently handled shards to a
  *      different server.
  *   2. Destroys ConnectionListener, CommandListener, GossipListener,
- *      SSL connection and command listeners to stop accepting new
- *      connections.
+ *      SSL connection and command listeners, and ConnectionListeners running
+ *      on Workers, to stop accepting new connections.
  *   3. accepting_work_ is set to false on all Workers. This prevents worker
  *      threads from taking new work.
  *   4. ShardedStorageThreadPool's shutdown() method is called. All queued tasks
@@ -60,6 +61,7 @@ void shutdown_server(
     std::unique_ptr<Listener>& command_listener,
     std::unique_ptr<Listener>& gossip_listener,
     std::unique_ptr<Listener>& ssl_connection_listener,
+    std::vector<std::unique_ptr<Listener>>& worker_connection_listeners,
     std::unique_ptr<EventLoop>& connection_listener_loop,
     std::unique_ptr<EventLoop>& command_listener_loop,
     std::unique_ptr<EventLoop>& gossip_listener_loop,
@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/storage/PurgeCoordinator.h"
 
+#include <folly/Format.h>
+
 #include "logdevice/common/Metadata.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/RequestType.h"
@@ -16,6 +18,7 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/CLEANED_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
+#include "logdevice/common/protocol/MULTI_RELEASE_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/CleanedResponseRequest.h"
@@ -227,11 +230,88 @@ Message::Disposition PurgeCoordinator::onReceived(CLEAN_Message* msg,
   return Message::Disposition::KEEP;
 }
 
-Message::Disposition PurgeCoordinator::onReceived(RELEASE_Message* msg,
-                                                  const Address& from) {
+namespace {
+
+// Checks of an incoming RELEASE or MULTI_RELEASE that only depend on the
+// connection it came from. Returns false if the message should be ignored,
+// otherwise sets `peer_node_id' to the sequencer node that sent it.
+// `what' describes the message for logging.
+bool checkReleaseSender(const Address& from,
+                        const std::string& what,
+                        NodeID* peer_node_id) {
   ServerWorker* w = ServerWorker::onThisThread();
 
+  // Ignore the message during shutdown.
+  if (!w->isAcceptingWork()) {
+    return false;
+  }
+
+  if (!w->processor_->runningOnStorageNode()) {
+    RATELIMIT_ERROR(
+        std::chrono::seconds(1),
+        10,
+        "Got RELEASE %s from %s but not configured as a storage node",
+        what.c_str(),
+        Sender::describeConnection(from).c_str());
+    err = E::NOTSTORAGE;
+    return false;
+  }
+
+  *peer_node_id = w->sender().getNodeID(from);
+  if (!peer_node_id->isNodeID()) {
+    RATELIMIT_INFO(
+        std::chrono::seconds(1),
+        10,
+        "got RELEASE %s but the socket to the node but socket was closed "
+        "while message was waiting in the queue to be processed.",
+        what.c_str());
+    err = E::AGAIN;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+Message::Disposition PurgeCoordinator::onReceived(RELEASE_Message* msg,
+                                                  const Address& from) {
   const RELEASE_Header& header = msg->getHeader();
+  NodeID peer_node_id;
+  if (!checkReleaseSender(from, header.rid.toString(), &peer_node_id)) {
+    return Message::Disposition::NORMAL;
+  }
+  return processRelease(header, from, peer_node_id);
+}
+
+Message::Disposition PurgeCoordinator::onReceived(MULTI_RELEASE_Message* msg,
+                                                  const Address& from) {
+  const std::vector<RELEASE_Header>& releases = msg->getReleases();
+  STAT_INCR(Worker::stats(), multi_release_received);
+  STAT_ADD(Worker::stats(), multi_release_releases_received, releases.size());
+
+  NodeID peer_node_id;
+  if (!checkReleaseSender(
+          from,
+          folly::sformat("batch of {} RELEASEs", releases.size()),
+          &peer_node_id)) {
+    return Message::Disposition::NORMAL;
+  }
+  for (const RELEASE_Header& header : releases) {
+    Message::Disposition disp = processRelease(header, from, peer_node_id);
+    if (disp != Message::Disposition::NORMAL) {
+      // The RELEASEs after this one are dropped along with the connection.
+      // The sequencer will resend them.
+      return disp;
+    }
+  }
+  return Message::Disposition::NORMAL;
+}
+
+Message::Disposition
+PurgeCoordinator::processRelease(const RELEASE_Header& header,
+                                 const Address& from,
+                                 NodeID peer_node_id) {
+  ServerWorker* w = ServerWorker::onThisThread();
 
   const shard_size_t n_shards = w->getServerConfig()->getNumShards();
   shard_index_t shard = header.shard;
@@ -260,23 +340,6 @@ Message::Disposition PurgeCoordinator::onReceived(RELEASE_Message* msg,
     return Message::Disposition::ERROR;
   }
 
-  // Ignore the message during shutdown.
-  if (!w->isAcceptingWork()) {
-    return Message::Disposition::NORMAL;
-  }
-
-  ServerProcessor* const processor = w->processor_;
-  if (!processor->runningOnStorageNode()) {
-    RATELIMIT_ERROR(
-        std::chrono::seconds(1),
-        10,
-        "Got RELEASE %s from %s but not configured as a storage node",
-        header.rid.toString().c_str(),
-        Sender::describeConnection(from).c_str());
-    err = E::NOTSTORAGE;
-    return Message::Disposition::NORMAL;
-  }
-
   // We cannot proceed reading this log unless it's an internal log!
   if (!w->getLogsConfig()->isFullyLoaded() &&
       !w->getLogsConfig()->isInternalLogID(header.rid.logid) &&
@@ -290,17 +353,7 @@ Message::Disposition PurgeCoordinator::onReceived(RELEASE_Message* msg,
     return Message::Disposition::NORMAL;
   }
 
-  auto peer_node_id = w->sender().getNodeID(from);
-  if (!peer_node_id.isNodeID()) {
-    RATELIMIT_INFO(
-        std::chrono::seconds(1),
-        10,
-        "got RELEASE %s but the socket to the node but socket was closed "
-        "while message was waiting in the queue to be processed.",
-        header.rid.toString().c_str());
-    err = E::AGAIN;
-    return Message::Disposition::NORMAL;
-  }
+  ServerProcessor* const processor = w->processor_;
 
   LogStorageState* log_state =
       processor->getLogStorageStateMap().insertOrGet(header.rid.logid, shard);
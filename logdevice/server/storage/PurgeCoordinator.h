@@ -29,8 +29,10 @@ namespace facebook { namespace logdevice {
 
 class CLEAN_Message;
 class LogStorageState;
+class MULTI_RELEASE_Message;
 class PurgeUncleanEpochs;
 class RELEASE_Message;
+struct RELEASE_Header;
 enum class ReleaseType : uint8_t;
 
 /**
@@ -64,6 +66,9 @@ class PurgeCoordinator : public LogStorageState_PurgeCoordinator_Bridge {
                                          const Address& from);
   static Message::Disposition onReceived(RELEASE_Message* msg,
                                          const Address& from);
+  // Processes each RELEASE of the batch as if it came in its own message.
+  static Message::Disposition onReceived(MULTI_RELEASE_Message* msg,
+                                         const Address& from);
 
   //
   // NOTE: all public methods expect the mutex *not* to be held
@@ -180,6 +185,12 @@ class PurgeCoordinator : public LogStorageState_PurgeCoordinator_Bridge {
 
   std::vector<BufferedClean> buffered_clean_;
 
+  // Validates a RELEASE received from `peer_node_id' and hands it over to the
+  // PurgeCoordinator of the log. Common to RELEASE and MULTI_RELEASE.
+  static Message::Disposition processRelease(const RELEASE_Header& header,
+                                             const Address& from,
+                                             NodeID peer_node_id);
+
   // Part of the lock-free path of processing RELEASE messages, called after
   // onReleaseMessage() has ascertained that all earlier epochs are clean and
   // we can process the RELEASE.  Updates the LogStorageStateMap and
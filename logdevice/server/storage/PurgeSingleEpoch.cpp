@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/storage/PurgeSingleEpoch.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <folly/Memory.h>
@@ -233,8 +234,14 @@ void PurgeSingleEpoch::purgeRecords() {
                                      : "n/a");
 
   // delete every record in [start, end] in this epoch
-  startStorageTask(std::make_unique<PurgeDeleteRecordsStorageTask>(
-      log_id_, epoch_, start_esn, end_esn, ref_holder_.ref()));
+  if (end_esn.val_ - start_esn.val_ <=
+      PurgeDeleteRecordsStorageTask::PURGE_DELETE_BY_KEY_THRESHOLD - 1) {
+    startStorageTask(std::make_unique<PurgeDeleteKeysStorageTask>(
+        log_id_, epoch_, start_esn, end_esn, ref_holder_.ref()));
+  } else {
+    startStorageTask(std::make_unique<PurgeDeleteRecordsStorageTask>(
+        log_id_, epoch_, start_esn, end_esn, ref_holder_.ref()));
+  }
 }
 
 void PurgeSingleEpoch::onPurgeRecordsTaskDone(Status status) {
@@ -522,6 +529,81 @@ void PurgeDeleteRecordsStorageTask::executeImpl(LocalLogStore& store,
   STAT_INCR(stats, purging_delete_done);
 }
 
+///////// PurgeDeleteKeysStorageTask
+
+PurgeDeleteKeysStorageTask::PurgeDeleteKeysStorageTask(
+    logid_t log_id,
+    epoch_t epoch,
+    esn_t start_esn,
+    esn_t end_esn,
+    WeakRef<PurgeSingleEpoch> driver)
+    : WriteStorageTask(StorageTask::Type::PURGE_DELETE_KEYS),
+      log_id_(log_id),
+      epoch_(epoch),
+      start_esn_(start_esn),
+      end_esn_(end_esn),
+      driver_(std::move(driver)) {
+  ld_check(start_esn_ <= end_esn_);
+  ld_check(end_esn_.val_ - start_esn_.val_ <
+           PurgeDeleteRecordsStorageTask::PURGE_DELETE_BY_KEY_THRESHOLD);
+
+  const size_t num_keys = end_esn_.val_ - start_esn_.val_ + 1;
+  deletes_.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    esn_t::raw_type esn = start_esn_.val_ + static_cast<esn_t::raw_type>(i);
+    deletes_.emplace_back(log_id_, compose_lsn(epoch_, esn_t(esn)));
+  }
+}
+
+size_t PurgeDeleteKeysStorageTask::getWriteOps(const WriteOp** write_ops,
+                                               size_t write_ops_len) const {
+  size_t n = std::min(write_ops_len, deletes_.size());
+  for (size_t i = 0; i < n; ++i) {
+    write_ops[i] = &deletes_[i];
+  }
+  return n;
+}
+
+void PurgeDeleteKeysStorageTask::onDone() {
+  PurgeSingleEpoch* driver = driver_.get();
+  if (driver == nullptr) {
+    return;
+  }
+  STAT_INCR(driver->getStats(), purging_v2_delete_by_keys);
+  if (status_ == E::OK) {
+    STAT_INCR(driver->getStats(), purging_delete_done);
+    if (MetaDataLog::isMetaDataLog(log_id_)) {
+      ld_info("Maybe deleted metadata log records; log: %lu epoch: %u "
+              "start esn: %u end esn: %u",
+              log_id_.val_,
+              epoch_.val_,
+              start_esn_.val_,
+              end_esn_.val_);
+    }
+    PurgingTracer::traceRecordPurge(
+        ServerWorker::onThisThread()->processor_->getTraceLogger().get(),
+        log_id_,
+        epoch_,
+        ESN_INVALID,
+        start_esn_,
+        end_esn_,
+        true);
+  }
+  // E::DROPPED means the local log store was throttling writes and is retried
+  // by PurgeSingleEpoch. Any other error is a failed write, same as in
+  // PurgeDeleteRecordsStorageTask.
+  driver->onPurgeRecordsTaskDone(
+      status_ == E::OK || status_ == E::DROPPED ? status_ : E::FAILED);
+}
+
+void PurgeDeleteKeysStorageTask::onDropped() {
+  PurgeSingleEpoch* driver = driver_.get();
+  if (driver != nullptr) {
+    STAT_INCR(driver->getStats(), purging_task_dropped);
+    driver->onPurgeRecordsTaskDone(E::DROPPED);
+  }
+}
+
 void PurgeDeleteRecordsStorageTask::onDone() {
   PurgeSingleEpoch* driver = driver_.get();
   if (driver != nullptr) {
@@ -15,7 +15,9 @@
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
 #include "logdevice/common/WeakRefHolder.h"
 #include "logdevice/common/WorkerCallbackHelper.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
 #include "logdevice/server/storage/SealStorageTask.h"
+#include "logdevice/server/storage_tasks/WriteStorageTask.h"
 
 namespace facebook { namespace logdevice {
 
@@ -158,6 +160,11 @@ class PurgeDeleteRecordsStorageTask : public StorageTask {
     return Durability::ASYNC_WRITE;
   }
 
+  // if the ESN range contains less or equal number of records than this
+  // threshold, delete key by key directly. Otherwise, create an iterator
+  // to read actual records for deletion
+  static const size_t PURGE_DELETE_BY_KEY_THRESHOLD = 4096;
+
  private:
   const logid_t log_id_;
   const epoch_t epoch_;
@@ -165,11 +172,59 @@ class PurgeDeleteRecordsStorageTask : public StorageTask {
   const esn_t end_esn_;
   WeakRef<PurgeSingleEpoch> driver_;
   Status status_;
+};
 
-  // if the ESN range contains less or equal number of records than this
-  // threshold, delete key by key directly. Otherwise, create an iterator
-  // to read actual records for deletion
-  static const size_t PURGE_DELETE_BY_KEY_THRESHOLD = 4096;
+/**
+ * Deletes every possible key in an ESN range of at most
+ * PURGE_DELETE_BY_KEY_THRESHOLD records, without reading the data key space.
+ * Unlike PurgeDeleteRecordsStorageTask this is a WriteStorageTask, so the
+ * deletes of purgings of different logs and epochs queued on the same shard
+ * are picked up by one WriteBatchStorageTask and written in a single local
+ * log store write batch, bounded by --write-batch-size and
+ * --write-batch-bytes.
+ */
+class PurgeDeleteKeysStorageTask : public WriteStorageTask {
+ public:
+  PurgeDeleteKeysStorageTask(logid_t log_id,
+                             epoch_t epoch,
+                             esn_t start_esn,
+                             esn_t end_esn,
+                             WeakRef<PurgeSingleEpoch> driver);
+
+  void onDone() override;
+  void onDropped() override;
+  StorageTaskPriority getPriority() const override {
+    return StorageTaskPriority::HIGH;
+  }
+
+  size_t getNumWriteOps() const override {
+    return deletes_.size();
+  }
+
+  size_t getWriteOps(const WriteOp** write_ops,
+                     size_t write_ops_len) const override;
+
+  // Deletes carry no payload. Report the memory held by the write ops
+  // instead, so that they count against --write-batch-bytes and a write batch
+  // doesn't pick up an unbounded number of them.
+  size_t getPayloadSize() const override {
+    return deletes_.size() * sizeof(DeleteWriteOp);
+  }
+
+  // Purging always ran its deletes regardless of the state of the local log
+  // store; deleting records frees space. If the store is disabled the write
+  // fails and purging gives up, as before.
+  bool allowIfStoreIsNotAcceptingWrites(Status /*status*/) const override {
+    return true;
+  }
+
+ private:
+  const logid_t log_id_;
+  const epoch_t epoch_;
+  const esn_t start_esn_;
+  const esn_t end_esn_;
+  WeakRef<PurgeSingleEpoch> driver_;
+  std::vector<DeleteWriteOp> deletes_;
 };
 
 class PurgeWriteEpochRecoveryMetadataStorageTask : public StorageTask {
@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/storage/SealBatchStorageTask.h"
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+SealBatchStorageTask::SealBatchStorageTask(
+    std::vector<std::unique_ptr<SealStorageTask>> tasks)
+    : StorageTask(StorageTask::Type::SEAL_BATCH), tasks_(std::move(tasks)) {
+  ld_check(!tasks_.empty());
+}
+
+void SealBatchStorageTask::setUpTasks() {
+  ld_check(storageThreadPool_);
+  for (auto& task : tasks_) {
+    task->setStorageThreadPool(storageThreadPool_);
+    task->setStorageThread(storageThread_);
+  }
+}
+
+void SealBatchStorageTask::execute() {
+  setUpTasks();
+  for (auto& task : tasks_) {
+    task->execute();
+  }
+}
+
+Durability SealBatchStorageTask::durability() const {
+  Durability max_durability = Durability::INVALID;
+  for (const auto& task : tasks_) {
+    const Durability d = task->durability();
+    if (d != Durability::INVALID &&
+        (max_durability == Durability::INVALID || d > max_durability)) {
+      max_durability = d;
+    }
+  }
+  return max_durability;
+}
+
+void SealBatchStorageTask::onDone() {
+  for (auto& task : tasks_) {
+    task->onDone();
+  }
+}
+
+void SealBatchStorageTask::onDropped() {
+  setUpTasks();
+  for (auto& task : tasks_) {
+    task->onDropped();
+  }
+}
+
+}} // namespace facebook::logdevice
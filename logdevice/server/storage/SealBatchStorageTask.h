@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/server/storage/SealStorageTask.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  Executes the SealStorageTasks for the SEALs of a MULTI_SEAL message
+ *        that go to the same shard in a single storage task. Each log is
+ *        sealed and replied to exactly as by a separate SealStorageTask, but
+ *        the batch takes a single slot in the storage task queues and, if any
+ *        of the seals changed the local log store, a single sync.
+ */
+
+class SealBatchStorageTask : public StorageTask {
+ public:
+  explicit SealBatchStorageTask(
+      std::vector<std::unique_ptr<SealStorageTask>> tasks);
+
+  // see StorageTask.h
+  void execute() override;
+
+  // SYNC_WRITE if any of the seals needs a sync
+  Durability durability() const override;
+
+  void onDone() override;
+  void onDropped() override;
+
+  StorageTaskPriority getPriority() const override {
+    return StorageTaskPriority::HIGH;
+  }
+
+  const std::vector<std::unique_ptr<SealStorageTask>>& getTasks() const {
+    return tasks_;
+  }
+
+ private:
+  // Gives the tasks of the batch access to the storage thread pool.
+  void setUpTasks();
+
+  std::vector<std::unique_ptr<SealStorageTask>> tasks_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/storage_tasks/DigestPrefetchStorageTask.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/RecordCache.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/read_path/LogStorageStateMap.h"
+#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+lsn_t DigestPrefetchStorageTask::prefetchStart(const LogStorageState& log_state,
+                                               epoch_t seal_epoch) {
+  folly::Optional<epoch_t> lce = log_state.getLastCleanEpoch();
+  epoch_t first_unclean =
+      lce.hasValue() ? epoch_t(lce.value().val_ + 1) : EPOCH_MIN;
+  if (first_unclean > seal_epoch) {
+    // the dead sequencer's epochs are already clean
+    return LSN_INVALID;
+  }
+
+  RecordCache* cache = log_state.record_cache_.get();
+  if (cache != nullptr && cache->getEpochRecordCache(seal_epoch).first !=
+          RecordCache::Result::MISS) {
+    // The digest of the epoch the sequencer was writing to will be served
+    // from the record cache. Earlier unclean epochs are rare enough not to
+    // bother.
+    return LSN_INVALID;
+  }
+
+  // Records up to the last released LSN are fully replicated and recovery
+  // starts its digest after them.
+  return std::max(compose_lsn(first_unclean, ESN_MIN),
+                  log_state.getLastReleasedLSNWithoutSource() + 1);
+}
+
+void DigestPrefetchStorageTask::execute() {
+  LocalLogStore& store = storageThreadPool_->getLocalLogStore();
+  LogStorageStateMap& state_map =
+      storageThreadPool_->getProcessor().getLogStorageStateMap();
+
+  struct Range {
+    logid_t log_id;
+    lsn_t from;
+    lsn_t until;
+  };
+  std::vector<Range> ranges;
+  state_map.forEachLogOnShard(
+      store.getShardIdx(),
+      [&](logid_t log_id, const LogStorageState& log_state) {
+        folly::Optional<Seal> soft_seal =
+            log_state.getSeal(LogStorageState::SealType::SOFT);
+        if (!soft_seal.hasValue() || !soft_seal.value().valid() ||
+            soft_seal.value().seq_node.index() != sequencer_node_) {
+          return 0;
+        }
+        const epoch_t epoch = soft_seal.value().epoch;
+        lsn_t from = prefetchStart(log_state, epoch);
+        if (from != LSN_INVALID) {
+          ranges.push_back(Range{log_id, from, compose_lsn(epoch, ESN_MAX)});
+        }
+        return 0;
+      });
+
+  if (ranges.empty()) {
+    return;
+  }
+
+  size_t bytes = 0;
+  size_t records = 0;
+  for (const Range& range : ranges) {
+    if (bytes >= max_bytes_) {
+      break;
+    }
+    LocalLogStore::ReadOptions read_options("DigestPrefetch");
+    read_options.allow_blocking_io = true;
+    read_options.tailing = false;
+    auto it = store.read(range.log_id, read_options);
+    ld_check(it != nullptr);
+    for (it->seek(range.from);
+         it->state() == IteratorState::AT_RECORD &&
+         it->getLSN() <= range.until && bytes < max_bytes_;
+         it->next()) {
+      bytes += it->getRecord().size;
+      ++records;
+    }
+    if (it->state() == IteratorState::ERROR) {
+      RATELIMIT_WARNING(std::chrono::seconds(10),
+                        2,
+                        "Error reading log %lu on shard %d while prefetching "
+                        "recovery digests for N%d",
+                        range.log_id.val_,
+                        store.getShardIdx(),
+                        sequencer_node_);
+    }
+  }
+
+  ld_info("Prefetched %zu records (%zu bytes) of %zu logs on shard %d whose "
+          "sequencer was on N%d",
+          records,
+          bytes,
+          ranges.size(),
+          store.getShardIdx(),
+          sequencer_node_);
+  STAT_ADD(stats_, recovery_digest_prefetch_logs, ranges.size());
+  STAT_ADD(stats_, recovery_digest_prefetch_bytes, bytes);
+}
+
+}} // namespace facebook::logdevice
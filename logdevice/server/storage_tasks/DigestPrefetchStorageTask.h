@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+class LogStorageState;
+
+/**
+ * @file Task created on a storage node when the failure detector declares a
+ *       node dead. For every log on the shard whose latest soft seal was set
+ *       by the dead node (i.e. the dead node was running its sequencer) and
+ *       that still has unclean epochs, reads the records that the SEAL and
+ *       the digest of the upcoming log recovery will ask for, so that they
+ *       are in the local log store's caches by the time recovery starts.
+ *
+ *       Logs whose unclean epochs are served by the record cache are
+ *       skipped, as recovery doesn't read them from the local log store.
+ *       The records read are discarded; nothing is sent anywhere.
+ */
+
+class DigestPrefetchStorageTask : public StorageTask {
+ public:
+  /**
+   * @param sequencer_node  node that was declared dead
+   * @param max_bytes       stop after reading this many bytes of records
+   */
+  DigestPrefetchStorageTask(node_index_t sequencer_node, size_t max_bytes)
+      : StorageTask(StorageTask::Type::DIGEST_PREFETCH),
+        sequencer_node_(sequencer_node),
+        max_bytes_(max_bytes) {}
+
+  void execute() override;
+  void onDone() override {}
+  void onDropped() override {}
+
+  Durability durability() const override {
+    return Durability::INVALID;
+  }
+
+  StorageTaskPriority getPriority() const override {
+    return StorageTaskPriority::LOW;
+  }
+
+ private:
+  // @return  first LSN that recovery is expected to read for the log, or
+  //          LSN_INVALID if the log doesn't need to be prefetched
+  lsn_t prefetchStart(const LogStorageState& log_state, epoch_t seal_epoch);
+
+  const node_index_t sequencer_node_;
+  const size_t max_bytes_;
+};
+
+}} // namespace facebook::logdevice
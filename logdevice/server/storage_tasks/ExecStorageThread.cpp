@@ -9,13 +9,16 @@
 
 #include <chrono>
 
+#include "logdevice/common/PerfCounters.h"
 #include "logdevice/common/SlowStorageTasksTracer.h"
 #include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/stats/PerShardHistograms.h"
 #include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/util.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/locallogstore/RocksDBCache.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
 #include "logdevice/server/storage_tasks/StorageTaskResponse.h"
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
@@ -31,10 +34,23 @@ void ExecStorageThread::run() {
        thread_type_ == StorageTask::ThreadType::DEFAULT) &&
       settings->slow_ioprio.hasValue()) {
     set_io_priority_of_this_thread(settings->slow_ioprio.value());
+  } else if ((thread_type_ == StorageTask::ThreadType::FAST_TIME_SENSITIVE ||
+              thread_type_ == StorageTask::ThreadType::FAST_STALLABLE) &&
+             settings->fast_ioprio.hasValue()) {
+    set_io_priority_of_this_thread(settings->fast_ioprio.value());
   }
+  // Priority to go back to after running a task with a different one.
+  std::pair<int, int> thread_ioprio;
+  bool have_thread_ioprio =
+      get_io_priority_of_this_thread(&thread_ioprio) == 0;
 
   SlowStorageTasksTracer slow_task_tracer{pool_->getTraceLogger()};
 
+  std::unique_ptr<ThreadPerfCounters> perf_counters;
+  if (settings->enable_perf_counters) {
+    perf_counters = std::make_unique<ThreadPerfCounters>();
+  }
+
   while (shouldProcessTasks_) {
     std::unique_ptr<StorageTask> task = pool_->blockingGetTask(thread_type_);
     task->setStorageThread(this);
@@ -52,10 +68,54 @@ void ExecStorageThread::run() {
           storage_task_queue_time[static_cast<int>(task->getType())],
           task->reply_shard_idx_,
           queueing_usec);
+      auto priority = task->getPriority();
+      if (priority < StorageTaskPriority::NUM_PRIORITIES) {
+        PER_SHARD_HISTOGRAM_ADD(
+            pool_->stats(),
+            storage_task_priority_queue_time[static_cast<int>(priority)],
+            task->reply_shard_idx_,
+            queueing_usec);
+      }
     }
 
     auto execution_start_time = std::chrono::steady_clock::now();
-    task->execute();
+    {
+      folly::Optional<std::pair<int, int>> task_ioprio;
+      if (task->getPrincipal() == StorageTaskPrincipal::REBUILD &&
+          have_thread_ioprio) {
+        task_ioprio = pool_->getSettings()->rebuilding_ioprio;
+      }
+      if (task_ioprio.hasValue() && task_ioprio.value() != thread_ioprio) {
+        set_io_priority_of_this_thread(task_ioprio.value());
+      } else {
+        task_ioprio.clear();
+      }
+
+      RocksDBCache::ReadClassGuard read_class(task->getPrincipal());
+      PerfCounterValues perf_start;
+      if (perf_counters) {
+        perf_counters->read(perf_start);
+      }
+      task->execute();
+      if (perf_counters) {
+        PerfCounterValues perf_end = perf_start;
+        perf_counters->read(perf_end);
+        const PerfCounterValues delta = perf_end - perf_start;
+        STAT_ADD(pool_->stats(), perf_cycles_storage_tasks, delta.cycles);
+        STAT_ADD(pool_->stats(),
+                 perf_instructions_storage_tasks,
+                 delta.instructions);
+        STAT_ADD(
+            pool_->stats(), perf_llc_misses_storage_tasks, delta.llc_misses);
+        STAT_ADD(pool_->stats(),
+                 perf_context_switches_storage_tasks,
+                 delta.context_switches);
+      }
+
+      if (task_ioprio.hasValue()) {
+        set_io_priority_of_this_thread(thread_ioprio);
+      }
+    }
     auto execution_end_time = std::chrono::steady_clock::now();
     auto usec = SystemTimestamp(execution_end_time - execution_start_time)
                     .toMicroseconds()
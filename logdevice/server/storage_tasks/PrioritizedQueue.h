@@ -70,6 +70,15 @@ class PrioritizedQueue {
     return true;
   }
 
+  // same as blockingRead(), but gives up after `timeout`
+  bool blockingReadFor(T& out, std::chrono::milliseconds timeout) {
+    if (sem_.timedwait(timeout) != 0) {
+      return false;
+    }
+    readQueueGuaranteedNonEmpty(out);
+    return true;
+  }
+
   void readQueueGuaranteedNonEmpty(T& out) {
     shared_lock<folly::SharedMutex> l(introspection_mutex_);
 
@@ -131,6 +140,16 @@ class PrioritizedQueue {
 
     return res;
   }
+  // Whether any item of priority higher than `pri' is waiting. Approximate:
+  // doesn't synchronize with concurrent reads and writes.
+  bool hasItemsAbove(size_t pri) const {
+    for (size_t p = pri + 1; p < NumPriorities; ++p) {
+      if (queues_[p].size() > 0) {
+        return true;
+      }
+    }
+    return false;
+  }
   ssize_t size() const {
     shared_lock<folly::SharedMutex> l(introspection_mutex_);
     ssize_t res = 0;
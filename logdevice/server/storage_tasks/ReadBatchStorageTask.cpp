@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/storage_tasks/ReadBatchStorageTask.h"
+
+#include <algorithm>
+
+#include <folly/Format.h>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+ReadBatchStorageTask::ReadBatchStorageTask(
+    std::vector<std::unique_ptr<ReadStorageTask>> tasks)
+    : StorageTask(StorageTask::Type::READ_BATCH), tasks_(std::move(tasks)) {
+  ld_check(!tasks_.empty());
+  reqTenant(tasks_.front()->reqTenant(), tasks_.front()->reqTenantWeight());
+
+  std::stable_sort(tasks_.begin(),
+                   tasks_.end(),
+                   [](const std::unique_ptr<ReadStorageTask>& a,
+                      const std::unique_ptr<ReadStorageTask>& b) {
+                     return std::make_pair(a->read_ctx_.logid_,
+                                           a->read_ctx_.read_ptr_.lsn) <
+                         std::make_pair(b->read_ctx_.logid_,
+                                        b->read_ctx_.read_ptr_.lsn);
+                   });
+}
+
+void ReadBatchStorageTask::setUpTasks() {
+  ld_check(storageThreadPool_);
+  for (auto& task : tasks_) {
+    task->setStorageThreadPool(storageThreadPool_);
+    task->setStorageThread(storageThread_);
+  }
+}
+
+void ReadBatchStorageTask::execute() {
+  setUpTasks();
+  for (auto& task : tasks_) {
+    task->execute();
+  }
+}
+
+void ReadBatchStorageTask::onDone() {
+  for (auto& task : tasks_) {
+    task->onDone();
+  }
+}
+
+void ReadBatchStorageTask::onDropped() {
+  setUpTasks();
+  for (auto& task : tasks_) {
+    task->onDropped();
+  }
+}
+
+void ReadBatchStorageTask::getDebugInfoDetailed(
+    StorageTaskDebugInfo& info) const {
+  const ReadStorageTask& first = *tasks_.front();
+  info.log_id = first.read_ctx_.logid_;
+  info.lsn = first.read_ctx_.read_ptr_.lsn;
+  info.extra_info = folly::sformat("Batch of {} reads", tasks_.size());
+}
+
+}} // namespace facebook::logdevice
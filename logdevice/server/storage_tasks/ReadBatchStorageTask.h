@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/server/storage_tasks/ReadStorageTask.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  Executes the ReadStorageTasks of several read streams on the same
+ *        shard in a single storage task, see
+ *        --read-storage-task-max-batch-size.  The reads are done in the
+ *        order of the keys they start at, (log id, lsn), so that consecutive
+ *        reads tend to hit the same data blocks.  Each read is done and its
+ *        records are handed back to its stream exactly as by a separate
+ *        ReadStorageTask, but the batch takes a single slot in the storage
+ *        task queues and a single round trip to the storage thread.
+ *
+ *        All tasks of a batch must have the same thread type, priority,
+ *        principal and read tenant.
+ */
+
+class ReadBatchStorageTask : public StorageTask {
+ public:
+  explicit ReadBatchStorageTask(
+      std::vector<std::unique_ptr<ReadStorageTask>> tasks);
+
+  // see StorageTask.h
+  void execute() override;
+
+  void onDone() override;
+  void onDropped() override;
+
+  ThreadType getThreadType() const override {
+    return tasks_.front()->getThreadType();
+  }
+
+  StorageTaskPriority getPriority() const override {
+    return tasks_.front()->getPriority();
+  }
+
+  Principal getPrincipal() const override {
+    return tasks_.front()->getPrincipal();
+  }
+
+  const std::vector<std::unique_ptr<ReadStorageTask>>& getTasks() const {
+    return tasks_;
+  }
+
+ private:
+  // Gives the tasks of the batch access to the storage thread pool.
+  void setUpTasks();
+
+  void getDebugInfoDetailed(StorageTaskDebugInfo&) const override;
+
+  std::vector<std::unique_ptr<ReadStorageTask>> tasks_;
+};
+
+}} // namespace facebook::logdevice
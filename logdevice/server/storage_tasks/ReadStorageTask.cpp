@@ -133,6 +133,7 @@ void ReadStorageTask::execute() {
       // CatchupOneStream.
       owned_iterator_ = storageThreadPool_->getLocalLogStore().read(
           read_ctx_.logid_, options_);
+      STAT_INCR(storageThreadPool_->stats(), read_iterators_created);
     }
 
     ld_check(owned_iterator_);
@@ -143,7 +144,12 @@ void ReadStorageTask::execute() {
                                   callback,
                                   &read_ctx_,
                                   storageThreadPool_->stats(),
-                                  *storageThreadPool_->getSettings().get());
+                                  *storageThreadPool_->getSettings().get(),
+                                  [this] {
+                                    return storageThreadPool_
+                                        ->hasWaitingTasksAbove(
+                                            getThreadType(), getPriority());
+                                  });
 
     // The `read()` call populated `callback` with some records.  Now move them
     // into the ReadStorageTask instance, which will get passed back to the
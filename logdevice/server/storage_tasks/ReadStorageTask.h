@@ -131,6 +131,11 @@ class ReadStorageTask : public StorageTask {
   // Used for stats.
   size_t total_bytes_{0};
 
+  // When the task was created by CatchupOneStream. Used for the
+  // read_storage_task_round_trip histogram.
+  const std::chrono::steady_clock::time_point creation_time_{
+      std::chrono::steady_clock::now()};
+
   ThreadType thread_type_;
   StorageTaskPriority priority_;
   Principal principal_;
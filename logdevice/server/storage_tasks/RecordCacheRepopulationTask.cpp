@@ -7,12 +7,19 @@
  */
 #include "logdevice/server/storage_tasks/RecordCacheRepopulationTask.h"
 
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/server/RecordCache.h"
+#include "logdevice/server/RecordCachePersistence.h"
+#include "logdevice/server/RecordCacheSnapshotFile.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
@@ -32,8 +39,11 @@ void RecordCacheRepopulationTask::execute() {
   LogStorageStateMap& log_storage_state_map =
       storageThreadPool_->getProcessor().getLogStorageStateMap();
 
-  // On exit, always delete all snapshot blobs, so that future instances
-  // do not repopulate record caches from old data!
+  const std::string snapshot_file_path =
+      RecordCachePersistence::snapshotFilePath(shard);
+
+  // On exit, always delete all snapshot blobs and the snapshot file, so that
+  // future instances do not repopulate record caches from old data!
   SCOPE_EXIT {
     int rv = storageThreadPool_->getLocalLogStore().deleteAllLogSnapshotBlobs();
     if (rv != 0) {
@@ -41,6 +51,16 @@ void RecordCacheRepopulationTask::execute() {
           "Failed to delete all log snapshot blobs on shard %d", shard_idx_);
       status_ = E::FAILED;
     }
+    // Caches repopulated from the file keep it mapped, unlinking it is fine.
+    if (!snapshot_file_path.empty() &&
+        unlink(snapshot_file_path.c_str()) != 0 && errno != ENOENT) {
+      ld_critical("Failed to delete record cache snapshot file %s on shard "
+                  "%d: %s",
+                  snapshot_file_path.c_str(),
+                  shard_idx_,
+                  strerror(errno));
+      status_ = E::FAILED;
+    }
   };
 
   if (!repopulate_record_caches_) {
@@ -56,6 +76,10 @@ void RecordCacheRepopulationTask::execute() {
       storageThreadPool_->getProcessor().settings()->record_cache_max_size /
       sharded_store->numShards();
 
+  // Set while repopulating from the snapshot file, see
+  // RecordCache::fromLinearBuffer().
+  std::shared_ptr<const void> buffer_owner;
+
   LocalLogStore::LogSnapshotBlobCallback repopulate = [&](logid_t log_id,
                                                           Slice data) {
     if (bytes_limit_per_shard > 0 &&
@@ -74,7 +98,8 @@ void RecordCacheRepopulationTask::execute() {
         log_id,
         shard_idx_,
         reinterpret_cast<const char*>(data.data),
-        data.size);
+        data.size,
+        buffer_owner);
     if (rv == 0) {
       repopulated_caches++;
       repopulated_bytes += data.size;
@@ -82,8 +107,24 @@ void RecordCacheRepopulationTask::execute() {
     return rv;
   };
 
-  int rv = shard.readAllLogSnapshotBlobs(
-      LocalLogStore::LogSnapshotBlobType::RECORD_CACHE, repopulate);
+  int rv = 0;
+  std::shared_ptr<RecordCacheSnapshotFile> snapshot_file;
+  if (!snapshot_file_path.empty()) {
+    snapshot_file = RecordCacheSnapshotFile::open(snapshot_file_path);
+    if (snapshot_file) {
+      buffer_owner = snapshot_file;
+      rv = snapshot_file->forEachLog(repopulate);
+      buffer_owner.reset();
+    } else if (err != E::NOTFOUND) {
+      rv = -1;
+    }
+  }
+  // Shutdown writes either the file or the blobs, but read both: the setting
+  // may have changed.
+  if (rv == 0) {
+    rv = shard.readAllLogSnapshotBlobs(
+        LocalLogStore::LogSnapshotBlobType::RECORD_CACHE, repopulate);
+  }
   if (rv == 0) {
     status_ = E::OK;
   } else {
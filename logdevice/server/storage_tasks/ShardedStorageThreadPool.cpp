@@ -9,6 +9,8 @@
 
 #include <folly/Memory.h>
 
+#include "logdevice/common/NumaTopology.h"
+
 namespace facebook { namespace logdevice {
 
 ShardedStorageThreadPool::ShardedStorageThreadPool(
@@ -21,19 +23,48 @@ ShardedStorageThreadPool::ShardedStorageThreadPool(
     const std::shared_ptr<TraceLogger> trace_logger)
     : sharded_log_store_(store) {
   shard_size_t nshards = store->numShards();
+  numa_nodes_.assign(nshards, -1);
+  // CPUs to pin each shard's threads to, empty if not pinned.
+  std::vector<std::vector<int>> cpu_affinity(nshards);
+  if (settings->numa_aware_placement) {
+    NumaTopology topology = NumaTopology::detect();
+    for (shard_index_t shard_idx = 0;
+         shard_idx < nshards && topology.numNodes() > 1;
+         ++shard_idx) {
+      dev_t dev;
+      if (store->getShardDevice(shard_idx, &dev) != 0) {
+        continue;
+      }
+      const int node = topology.nodeOfBlockDevice(dev);
+      if (node < 0 || topology.cpusOfNode(node).empty()) {
+        ld_info("Don't know which NUMA node the disk of shard %d is attached "
+                "to, not pinning its storage threads",
+                shard_idx);
+        continue;
+      }
+      numa_nodes_[shard_idx] = node;
+      cpu_affinity[shard_idx] = topology.cpusOfNode(node);
+      ld_info("Storage threads of shard %d will run on NUMA node %d",
+              shard_idx,
+              node);
+    }
+  }
+
   pools_.reserve(nshards);
   for (shard_index_t shard_idx = 0; shard_idx < nshards; ++shard_idx) {
     pools_.push_back(
         // may throw
-        std::make_unique<StorageThreadPool>(shard_idx,
-                                            nshards,
-                                            params,
-                                            server_settings,
-                                            settings,
-                                            store->getByIndex(shard_idx),
-                                            task_queue_size,
-                                            stats,
-                                            trace_logger));
+        std::make_unique<StorageThreadPool>(
+            shard_idx,
+            nshards,
+            params,
+            server_settings,
+            settings,
+            store->getByIndex(shard_idx),
+            task_queue_size,
+            stats,
+            trace_logger,
+            std::move(cpu_affinity[shard_idx])));
   }
 }
 }} // namespace facebook::logdevice
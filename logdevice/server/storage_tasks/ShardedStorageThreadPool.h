@@ -72,8 +72,19 @@ class ShardedStorageThreadPool {
     return sharded_log_store_;
   }
 
+  /**
+   * @return NUMA node whose CPUs the given shard's storage threads are pinned
+   *         to, or -1 if they aren't pinned.
+   */
+  int getNumaNode(shard_index_t shard_idx) const {
+    ld_check(shard_idx < numa_nodes_.size());
+    return numa_nodes_[shard_idx];
+  }
+
  private:
   std::vector<std::unique_ptr<StorageThreadPool>> pools_;
+  // see getNumaNode()
+  std::vector<int> numa_nodes_;
   ShardedLocalLogStore* const sharded_log_store_;
 };
 }} // namespace facebook::logdevice
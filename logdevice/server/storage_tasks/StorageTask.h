@@ -203,6 +203,19 @@ class StorageTask {
     reqSize_ = reqSize;
   }
 
+  inline uint64_t reqTenant() const {
+    return reqTenant_;
+  }
+
+  inline uint32_t reqTenantWeight() const {
+    return reqTenantWeight_;
+  }
+
+  inline void reqTenant(uint64_t tenant, uint32_t weight) {
+    reqTenant_ = tenant;
+    reqTenantWeight_ = weight;
+  }
+
   /**
    * Fetches debug information that is common for all task types, then calls
    * into a virtual function that can fetch type-specific fields
@@ -260,6 +273,13 @@ class StorageTask {
   // share.
   uint32_t reqSize_{1};
 
+  // Also for IO scheduling: tasks of the same Principal are shared between
+  // tenants in proportion to the tenants' weights. ReadStorageTasks use the
+  // reader's principal from the config (see ServerReadStream::read_tenant_),
+  // all other tasks belong to tenant 0.
+  uint64_t reqTenant_{0};
+  uint32_t reqTenantWeight_{1};
+
   folly::IntrusiveListHook schedulerQHook_;
 
  protected:
@@ -72,7 +72,8 @@ StorageThreadPool::StorageThreadPool(
     LocalLogStore* local_log_store,
     size_t task_queue_size,
     StatsHolder* stats,
-    const std::shared_ptr<TraceLogger> trace_logger)
+    const std::shared_ptr<TraceLogger> trace_logger,
+    std::vector<int> cpu_affinity)
     : server_settings_(server_settings),
       settings_(settings),
       nthreads_slow_(params[(size_t)ThreadType::SLOW].nthreads),
@@ -119,11 +120,20 @@ StorageThreadPool::StorageThreadPool(
                 "");
   static_assert((int)ThreadType::MAX == 4, "");
 
+  append_stores_budget_handle_ = MemoryGovernor::get()->registerBudget(
+      "append_stores",
+      &taskQueues_[ThreadType::FAST_TIME_SENSITIVE].memory_budget,
+      settings_->append_stores_max_mem_bytes / num_shards_);
+  rebuilding_stores_budget_handle_ = MemoryGovernor::get()->registerBudget(
+      "rebuilding_stores",
+      &taskQueues_[ThreadType::FAST_STALLABLE].memory_budget,
+      settings_->rebuilding_stores_max_mem_bytes / num_shards_);
+
   // Set memory budgets from settings.
   settings_subscription_ = settings_.callAndSubscribeToUpdates([this] {
-    taskQueues_[ThreadType::FAST_TIME_SENSITIVE].memory_budget.setLimit(
+    append_stores_budget_handle_.setBaseLimit(
         settings_->append_stores_max_mem_bytes / num_shards_);
-    taskQueues_[ThreadType::FAST_STALLABLE].memory_budget.setLimit(
+    rebuilding_stores_budget_handle_.setBaseLimit(
         settings_->rebuilding_stores_max_mem_bytes / num_shards_);
 
     std::vector<DRRPrincipal> principals;
@@ -147,6 +157,7 @@ StorageThreadPool::StorageThreadPool(
     for (int i = 0; i < params[type].nthreads; ++i) {
       auto thread =
           std::make_unique<ExecStorageThread>(this, (ThreadType)type, i);
+      thread->setCPUAffinity(cpu_affinity);
       if (thread->start() != 0) {
         this->shutDown(); // shut down any already started threads
         this->join();
@@ -160,6 +171,7 @@ StorageThreadPool::StorageThreadPool(
   {
     auto thread =
         std::make_unique<SyncingStorageThread>(this, max_tasks_in_flight);
+    thread->setCPUAffinity(cpu_affinity);
     if (thread->start() != 0) {
       this->shutDown(); // shut down any already started threads
       this->join();
@@ -306,7 +318,10 @@ int StorageThreadPool::tryPutTask(std::unique_ptr<StorageTask>&& task) {
   bool ret = true;
   if (useDRR_ && (thread_type == StorageTask::ThreadType::SLOW)) {
     uint64_t principal = static_cast<uint64_t>(task->getPrincipal());
-    taskQueues_[thread_type].drrQueue.enqueue(task.get(), principal);
+    taskQueues_[thread_type].drrQueue.enqueue(task.get(),
+                                              principal,
+                                              task->reqTenant(),
+                                              task->reqTenantWeight());
   } else {
     ret = taskQueues_[thread_type].queue.writeIfNotFull(task.get());
   }
@@ -353,7 +368,10 @@ bool StorageThreadPool::blockingPutTask(std::unique_ptr<StorageTask>&& task) {
   task->setStorageThreadPool(this);
   if (useDRR_ && (thread_type == StorageTask::ThreadType::SLOW)) {
     uint64_t principal = static_cast<uint64_t>(task->getPrincipal());
-    taskQueues_[thread_type].drrQueue.enqueue(task.release(), principal);
+    uint64_t tenant = task->reqTenant();
+    uint64_t weight = task->reqTenantWeight();
+    taskQueues_[thread_type].drrQueue.enqueue(
+        task.release(), principal, tenant, weight);
   } else {
     taskQueues_[thread_type].queue.blockingWrite(task.release());
   }
@@ -364,20 +382,25 @@ bool StorageThreadPool::blockingPutTask(std::unique_ptr<StorageTask>&& task) {
 
 std::unique_ptr<StorageTask>
 StorageThreadPool::blockingGetTask(StorageTask::ThreadType type) {
-  auto& task_queue = taskQueues_[getThreadType(type)];
   std::map<StorageTaskType, int> dropped_by_type;
 
   while (true) {
     StorageTask* rawptr;
-    if (useDRR_ && (type == StorageTask::ThreadType::SLOW)) {
-      rawptr = task_queue.drrQueue.blockingDequeue();
+    // Type of the queue the task was taken from. Differs from `type` if the
+    // task was stolen from another queue.
+    ThreadType from = type;
+    if (settings_->storage_tasks_work_stealing && !shutting_down_.load()) {
+      rawptr = waitForTaskOrSteal(type, from);
+    } else if (useDRR_ && (type == StorageTask::ThreadType::SLOW)) {
+      rawptr = taskQueues_[getThreadType(type)].drrQueue.blockingDequeue();
     } else {
-      task_queue.queue.blockingRead(rawptr);
+      taskQueues_[getThreadType(type)].queue.blockingRead(rawptr);
     }
 
     std::unique_ptr<StorageTask> task(rawptr);
+    auto& task_queue = taskQueues_[getThreadType(from)];
 
-    STORAGE_TASK_STAT_DECR(stats_, type, num_storage_tasks);
+    STORAGE_TASK_STAT_DECR(stats_, from, num_storage_tasks);
 
     // Check if we should drop the task.  Doing a load first to avoid an
     // std::atomic write in the common case when there is nothing to drop.
@@ -399,6 +422,114 @@ StorageThreadPool::blockingGetTask(StorageTask::ThreadType type) {
   }
 }
 
+bool StorageThreadPool::hasWaitingTasksAbove(
+    StorageTask::ThreadType type,
+    StorageTaskPriority priority) const {
+  type = getThreadType(type);
+  if (useDRR_ && type == StorageTask::ThreadType::SLOW) {
+    return false;
+  }
+  return taskQueues_[type].queue.hasItemsAbove(static_cast<size_t>(priority));
+}
+
+bool StorageThreadPool::hasPendingWrites() const {
+  for (int type = 0; type < (int)ThreadType::MAX; ++type) {
+    if (taskQueues_[static_cast<ThreadType>(type)].write_queue.size() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+StorageTask*
+StorageThreadPool::waitForTaskOrSteal(StorageTask::ThreadType type,
+                                      StorageTask::ThreadType& from_out) {
+  // How long an idle thread waits on its own queue before looking at other
+  // queues again.
+  const std::chrono::milliseconds poll_interval(5);
+
+  auto& own_queue = taskQueues_[getThreadType(type)];
+  const bool drr = useDRR_ && (type == StorageTask::ThreadType::SLOW);
+  from_out = type;
+
+  while (true) {
+    // Own queue always takes precedence.
+    StorageTask* rawptr = nullptr;
+    if (drr) {
+      rawptr = own_queue.drrQueue.dequeue();
+    } else if (!own_queue.queue.read(rawptr)) {
+      rawptr = nullptr;
+    }
+    if (rawptr) {
+      return rawptr;
+    }
+
+    if (!shutting_down_.load()) {
+      rawptr = trySteal(type, from_out);
+      if (rawptr) {
+        return rawptr;
+      }
+    }
+
+    // Nothing to do anywhere. Block on our own queue for a while.
+    if (drr) {
+      rawptr = own_queue.drrQueue.blockingDequeueFor(poll_interval);
+    } else if (!own_queue.queue.blockingReadFor(rawptr, poll_interval)) {
+      rawptr = nullptr;
+    }
+    if (rawptr) {
+      return rawptr;
+    }
+  }
+}
+
+StorageTask* StorageThreadPool::trySteal(StorageTask::ThreadType thief,
+                                         StorageTask::ThreadType& from_out) {
+  // Which queues threads of each type may take tasks from, in order of
+  // preference. Fast threads never steal: they must not get stuck on reads.
+  // FAST_STALLABLE tasks are never stolen since they may stall until
+  // memtables are flushed.
+  static const std::array<std::vector<ThreadType>, (size_t)ThreadType::MAX>
+      victims = {{
+          /* SLOW */ {ThreadType::FAST_TIME_SENSITIVE, ThreadType::DEFAULT},
+          /* FAST_STALLABLE */ {},
+          /* FAST_TIME_SENSITIVE */ {},
+          /* DEFAULT */ {ThreadType::FAST_TIME_SENSITIVE},
+      }};
+
+  const ssize_t min_backlog = settings_->storage_tasks_steal_min_backlog;
+  for (ThreadType victim : victims[(size_t)thief]) {
+    if (getThreadType(victim) != victim) {
+      // No threads of this type; its tasks already go to another queue.
+      continue;
+    }
+    auto& victim_queue = taskQueues_[victim];
+    if (victim_queue.queue.size() < min_backlog) {
+      continue;
+    }
+    StorageTask* rawptr;
+    if (!victim_queue.queue.read(rawptr)) {
+      continue;
+    }
+    if (rawptr->getType() == StorageTask::Type::STOP_EXEC) {
+      // Shutdown started after we checked shutting_down_. Each thread must
+      // consume exactly one stop task from its own queue, so put it back.
+      victim_queue.queue.blockingWrite(rawptr);
+      return nullptr;
+    }
+    ++victim_queue.tasks_stolen;
+    STORAGE_TASK_STAT_INCR(stats_, victim, storage_tasks_stolen);
+    from_out = victim;
+    return rawptr;
+  }
+  return nullptr;
+}
+
+uint64_t
+StorageThreadPool::getNumTasksStolen(StorageTask::ThreadType victim) const {
+  return taskQueues_[victim].tasks_stolen.load();
+}
+
 folly::small_vector<std::unique_ptr<WriteStorageTask>, 4>
 StorageThreadPool::tryGetWriteBatch(StorageTask::ThreadType thread_type,
                                     size_t max_count,
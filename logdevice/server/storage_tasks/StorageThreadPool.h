@@ -13,6 +13,7 @@
 #include <folly/small_vector.h>
 
 #include "logdevice/common/DRRScheduler.h"
+#include "logdevice/common/MemoryGovernor.h"
 #include "logdevice/common/ResourceBudget.h"
 #include "logdevice/common/Semaphore.h"
 #include "logdevice/common/SimpleEnumMap.h"
@@ -52,6 +53,9 @@ class StorageThreadPool {
    * Creates the pool and starts all threads.  Does not claim ownership of the
    * local log store.
    *
+   * @param cpu_affinity  if nonempty, all threads of the pool are restricted
+   *                      to these CPUs (see --numa-aware-placement)
+   *
    * @throws ConstructorFailed on failure
    */
   StorageThreadPool(shard_index_t shard_idx,
@@ -62,7 +66,8 @@ class StorageThreadPool {
                     LocalLogStore* local_log_store,
                     size_t task_queue_size,
                     StatsHolder* stats = nullptr,
-                    const std::shared_ptr<TraceLogger> trace_logger = nullptr);
+                    const std::shared_ptr<TraceLogger> trace_logger = nullptr,
+                    std::vector<int> cpu_affinity = {});
 
   ~StorageThreadPool();
 
@@ -212,6 +217,28 @@ class StorageThreadPool {
 
   ResourceBudget& getMemoryBudget(StorageTask::ThreadType thread_type);
 
+  /**
+   * @return number of tasks queued for threads of type `victim` that were
+   *         executed by idle threads of another type since startup.
+   *         See storage-tasks-work-stealing.
+   */
+  uint64_t getNumTasksStolen(StorageTask::ThreadType victim) const;
+
+  /**
+   * @return true if tasks of priority higher than `priority' are waiting in
+   *         the queue of threads of type `type'. Always false for the DRR
+   *         queue. Used by long-running tasks to yield to urgent ones.
+   */
+  bool hasWaitingTasksAbove(StorageTask::ThreadType type,
+                            StorageTaskPriority priority) const;
+
+  /**
+   * @return true if any write tasks are waiting in the write queues to be
+   *         picked up by a WriteBatchStorageTask. Approximate: doesn't
+   *         synchronize with concurrent reads and writes.
+   */
+  bool hasPendingWrites() const;
+
   /**
    * Fetches debug info on all pending storage tasks into the table provided
    */
@@ -258,6 +285,10 @@ class StorageThreadPool {
     // are counted as dropped, as far as this counter is concerned.
     std::atomic<int64_t> tasks_to_drop;
 
+    // How many tasks from this queue were picked up by threads of other
+    // types.
+    std::atomic<uint64_t> tasks_stolen{0};
+
     ResourceBudget memory_budget;
   };
 
@@ -275,6 +306,11 @@ class StorageThreadPool {
   // Separate queue for each type of storage thread.
   SimpleEnumMap<StorageTask::ThreadType, PerTypeTaskQueue> taskQueues_;
 
+  // Register the memory budgets of append and rebuilding stores with
+  // MemoryGovernor.
+  MemoryGovernor::Handle append_stores_budget_handle_;
+  MemoryGovernor::Handle rebuilding_stores_budget_handle_;
+
   // This updates memory budgets whenever they change in settings.
   UpdateableSettings<Settings>::SubscriptionHandle settings_subscription_;
 
@@ -288,6 +324,27 @@ class StorageThreadPool {
   bool tryDropOneTask(std::unique_ptr<StorageTask>& task,
                       std::map<StorageTaskType, int>& dropped_by_type);
 
+  /**
+   * Used by blockingGetTask() when work stealing is enabled. Waits for a task
+   * on the queue of thread type `type`, periodically checking the queues of
+   * other thread types it is allowed to steal from.
+   *
+   * @param from_out  set to the thread type of the queue the task was taken
+   *                  from
+   */
+  StorageTask* waitForTaskOrSteal(StorageTask::ThreadType type,
+                                  StorageTask::ThreadType& from_out);
+
+  /**
+   * Tries to take a task from the queue of a thread type that threads of
+   * type `thief` may steal from. Only considers queues which have at least
+   * storage_tasks_steal_min_backlog tasks waiting.
+   *
+   * @return the task, or nullptr if there was nothing to steal.
+   */
+  StorageTask* trySteal(StorageTask::ThreadType thief,
+                        StorageTask::ThreadType& from_out);
+
   /**
    * Called only by the constructor.
    */
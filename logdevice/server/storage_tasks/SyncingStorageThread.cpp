@@ -52,6 +52,52 @@ void SyncingStorageThread::stopProcessingTasks() {
   queue_.write(std::unique_ptr<StorageTask>());
 }
 
+std::chrono::microseconds SyncingStorageThread::getSyncDelay(
+    std::chrono::steady_clock::time_point batch_start) const {
+  using namespace std::chrono;
+  auto settings = pool_->getServerSettings();
+  const microseconds interval = settings->storage_thread_delaying_sync_interval;
+  const microseconds target = settings->storage_thread_sync_latency_target;
+  if (target.count() == 0) {
+    return interval;
+  }
+
+  // Time the first task of the batch can still wait without missing the
+  // target, given how long the sync itself is going to take.
+  const double budget_us = target.count() - sync_latency_avg_us_ -
+      duration_cast<microseconds>(steady_clock::now() - batch_start).count();
+  if (budget_us <= 0) {
+    return microseconds(0);
+  }
+  // Waiting only pays off if other tasks are likely to join the batch.
+  // At low load, sync right away.
+  if (arrival_rate_avg_ * budget_us / 1e6 < 1) {
+    return microseconds(0);
+  }
+  return std::min(interval, microseconds(static_cast<int64_t>(budget_us)));
+}
+
+void SyncingStorageThread::noteSync(
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end,
+    size_t ntasks) {
+  using namespace std::chrono;
+  const double alpha = 0.2;
+  const double latency_us = duration_cast<microseconds>(end - start).count();
+  sync_latency_avg_us_ =
+      alpha * latency_us + (1 - alpha) * sync_latency_avg_us_;
+  if (last_sync_start_ != steady_clock::time_point()) {
+    // The tasks synced now are the ones that arrived since the previous
+    // sync started.
+    const double since_last_us =
+        std::max<int64_t>(
+            1, duration_cast<microseconds>(start - last_sync_start_).count());
+    const double rate = ntasks * 1e6 / since_last_us;
+    arrival_rate_avg_ = alpha * rate + (1 - alpha) * arrival_rate_avg_;
+  }
+  last_sync_start_ = start;
+}
+
 void SyncingStorageThread::run() {
   pool_->getLocalLogStore().onStorageThreadStarted();
   SlowStorageTasksTracer slow_task_tracer{pool_->getTraceLogger()};
@@ -86,13 +132,27 @@ void SyncingStorageThread::run() {
       queue_.blockingRead(task);
       got_task(std::move(task));
     }
+    const auto batch_start = std::chrono::steady_clock::now();
 
     // Delay some tasks until timeout occurs or undelayable task arrives.
     if (!stop) {
-      const std::chrono::milliseconds interval =
-          pool_->getServerSettings()->storage_thread_delaying_sync_interval;
+      const std::chrono::microseconds delay = getSyncDelay(batch_start);
       std::unique_lock<std::mutex> lock(delay_cv_mutex_);
-      delay_cv_.wait_for(lock, interval, [&]() { return sync_immediately_; });
+      delay_cv_.wait_for(lock, delay, [&]() { return sync_immediately_; });
+
+      // With an adaptive delay, if writes are waiting for a
+      // WriteBatchStorageTask, let them land first so that they're covered
+      // by this sync rather than needing another one, as long as the
+      // target still allows it.
+      if (pool_->getServerSettings()
+              ->storage_thread_sync_latency_target.count() > 0) {
+        while (!sync_immediately_ && pool_->hasPendingWrites() &&
+               getSyncDelay(batch_start).count() > 0) {
+          delay_cv_.wait_for(lock,
+                             std::chrono::microseconds(100),
+                             [&]() { return sync_immediately_; });
+        }
+      }
       // Usage of sync_immediately_ introduces race condition
       // when we set it to false before signalling from enqueueForSync
       // for the same undelayable task. Thus, next batch is going
@@ -129,6 +189,8 @@ void SyncingStorageThread::run() {
         RATELIMIT_ERROR(std::chrono::seconds(60), 1, "Sync failed!?");
       }
 
+      noteSync(start_time, end_time, batch.size());
+
       uint64_t duration_ms =
           duration_cast<milliseconds>(end_time - start_time).count();
       ld_debug("Shard %d: Synced %zu tasks in %ld ms",
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <chrono>
+
 #include <folly/MPMCQueue.h>
 
 #include "logdevice/server/storage_tasks/StorageThread.h"
@@ -59,5 +61,25 @@ class SyncingStorageThread : public StorageThread {
    * Mutex for sync_immediately_ and delay_cv_
    */
   std::mutex delay_cv_mutex_;
+
+  // Exponentially weighted moving averages of the duration of
+  // LocalLogStore::sync() and of the number of tasks needing a sync that
+  // arrive per second. Only used by the syncing thread.
+  double sync_latency_avg_us_{0};
+  double arrival_rate_avg_{0};
+  std::chrono::steady_clock::time_point last_sync_start_{};
+
+  /**
+   * With --storage-thread-sync-latency-target, decides how long to wait for
+   * more tasks before syncing a batch whose first task was picked up at
+   * `batch_start`. Otherwise returns --storage-thread-delaying-sync-interval.
+   */
+  std::chrono::microseconds
+  getSyncDelay(std::chrono::steady_clock::time_point batch_start) const;
+
+  // Updates the averages above after a sync of `ntasks` tasks.
+  void noteSync(std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end,
+                size_t ntasks);
 };
 }} // namespace facebook::logdevice
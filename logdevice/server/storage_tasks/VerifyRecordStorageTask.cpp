@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/storage_tasks/VerifyRecordStorageTask.h"
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+void VerifyRecordStorageTask::execute() {
+  LocalLogStore& store = storageThreadPool_->getLocalLogStore();
+  LocalLogStore::ReadOptions read_options("VerifyRecord");
+  read_options.allow_blocking_io = true;
+  read_options.tailing = false;
+  auto it = store.read(log_id_, read_options);
+  ld_check(it != nullptr);
+  it->seek(lsn_);
+  if (it->state() == IteratorState::ERROR) {
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      2,
+                      "Error reading record %lu%s on shard %d to verify its "
+                      "checksum",
+                      log_id_.val_,
+                      lsn_to_string(lsn_).c_str(),
+                      store.getShardIdx());
+    return;
+  }
+  if (it->state() != IteratorState::AT_RECORD || it->getLSN() != lsn_) {
+    // Trimmed or never here; nothing to check.
+    return;
+  }
+
+  int rv = LocalLogStoreRecordFormat::checkWellFormed(it->getRecord());
+  if (rv == 0) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "%s reported a checksum mismatch for record %lu%s but "
+                   "the copy on shard %d is intact",
+                   reporter_.c_str(),
+                   log_id_.val_,
+                   lsn_to_string(lsn_).c_str(),
+                   store.getShardIdx());
+    return;
+  }
+
+  RATELIMIT_CRITICAL(std::chrono::seconds(10),
+                     10,
+                     "Record %lu%s on shard %d is corrupt (%s); the "
+                     "corruption was reported by %s",
+                     log_id_.val_,
+                     lsn_to_string(lsn_).c_str(),
+                     store.getShardIdx(),
+                     error_name(err),
+                     reporter_.c_str());
+  STAT_INCR(stats_, checksum_fail_reports_confirmed);
+}
+
+}} // namespace facebook::logdevice
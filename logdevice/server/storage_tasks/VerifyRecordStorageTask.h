@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/types.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Task created on a storage node when a reader reports, with a
+ *       CHECKSUM_FAIL message, that a record this node sent failed checksum
+ *       verification. Reads the record from the local log store and verifies
+ *       its checksum with LocalLogStoreRecordFormat::checkWellFormed(), the
+ *       same check done when storing records with
+ *       --rocksdb-verify-checksum-during-store.
+ *
+ *       If the stored copy is corrupt, it is logged and counted in
+ *       checksum_fail_reports_confirmed. Nothing is sent back to the reader,
+ *       which already treats the record as missing from this shard.
+ */
+
+class VerifyRecordStorageTask : public StorageTask {
+ public:
+  /**
+   * @param reporter  description of the reader that reported the record,
+   *                  for logging
+   */
+  VerifyRecordStorageTask(logid_t log_id, lsn_t lsn, std::string reporter)
+      : StorageTask(StorageTask::Type::VERIFY_RECORD),
+        log_id_(log_id),
+        lsn_(lsn),
+        reporter_(std::move(reporter)) {}
+
+  void execute() override;
+  void onDone() override {}
+  void onDropped() override {}
+
+  Durability durability() const override {
+    return Durability::INVALID;
+  }
+
+  StorageTaskPriority getPriority() const override {
+    return StorageTaskPriority::LOW;
+  }
+
+ private:
+  const logid_t log_id_;
+  const lsn_t lsn_;
+  const std::string reporter_;
+};
+
+}} // namespace facebook::logdevice
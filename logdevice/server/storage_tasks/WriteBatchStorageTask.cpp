@@ -60,6 +60,7 @@ void WriteBatchStorageTask::execute() {
 
   std::vector<const WriteOp*> write_ops;
   write_ops.reserve(ntasks * 2); // expect at most 2 write ops per task
+  size_t payload_bytes = 0;
   for (auto& write : writes) {
     if (reject_writes) {
       // Drop write if the store cannot keep up with incoming rate.
@@ -111,6 +112,7 @@ void WriteBatchStorageTask::execute() {
     std::copy(task_write_ops.begin(),
               task_write_ops.end(),
               std::back_inserter(write_ops));
+    payload_bytes += write->getPayloadSize();
 
     if (reply_shard_idx_ >= 0) {
       // Update the histogram of queueing latency for that individual
@@ -131,6 +133,10 @@ void WriteBatchStorageTask::execute() {
     STAT_INCR(stats(), write_batches);
   }
 
+  if (!write_ops.empty()) {
+    storageThreadPool_->getLocalLogStore().paceWrite(payload_bytes);
+  }
+
   int rv = writeMulti(write_ops);
   Status status = rv == 0 ? E::OK : err;
 
@@ -1846,6 +1846,30 @@ TEST_F(CatchupQueueTest, ServerRecordFilterFeatureTest) {
   filterTestHelper(ServerRecordFilterType::RANGE, "b", "a", "", ")");
 }
 
+TEST_F(CatchupQueueTest, ServerRecordFilterBatch) {
+  const folly::StringPiece keys[] = {"a", "b", "", "c", "bb"};
+  const size_t n = sizeof(keys) / sizeof(keys[0]);
+  bool passed[n];
+
+  auto equality = ServerRecordFilterFactory::create(
+      ServerRecordFilterType::EQUALITY, "b", "not used");
+  equality->filterBatch(keys, n, passed);
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_EQ((*equality)(keys[i]), passed[i]) << keys[i];
+  }
+  EXPECT_TRUE(passed[1]);
+  EXPECT_FALSE(passed[4]);
+
+  auto range = ServerRecordFilterFactory::create(
+      ServerRecordFilterType::RANGE, "b", "c");
+  range->filterBatch(keys, n, passed);
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_EQ((*range)(keys[i]), passed[i]) << keys[i];
+  }
+  EXPECT_FALSE(passed[0]);
+  EXPECT_TRUE(passed[4]);
+}
+
 TEST_F(CatchupQueueTest, MergeFilteredOutGapOnServerSide1) {
   resetCatchupQueue();
   read_stream_id_t read_stream_id(1);
@@ -8,6 +8,7 @@
 
 #include "logdevice/common/protocol/GOSSIP_Message.h"
 
+#include <algorithm>
 #include <chrono>
 #include <string>
 
@@ -196,3 +197,63 @@ TEST(GOSSIP_MessageTest, SerializeAndDeserializeWithStarting) {
       "0000000A000000000000000100000000000000020000000000000000";
   serializeAndDeserializeTest(params);
 }
+
+TEST(GOSSIP_MessageTest, CompactNodeList) {
+  // Nodes in hashmap order, some starting, some with failover.
+  node_list_t node_list;
+  for (size_t i = 0; i < 100; ++i) {
+    size_t id = (i * 37) % 101;
+    bool starting = i % 7 == 0;
+    std::chrono::milliseconds ts{1500000000000ll + i * 13 % 50};
+    std::chrono::milliseconds failover = i % 5 == 0 ? ts : 0ms;
+    if (i == 42) {
+      failover = ts - 1000ms;
+    }
+    node_list.push_back(
+        {id, static_cast<uint32_t>(i * 1000 % 7), ts, failover, starting});
+  }
+  GOSSIP_Message msg(NodeID(1),
+                     node_list,
+                     1ms,
+                     2ms,
+                     boycott_list_t{},
+                     boycott_durations_list_t{},
+                     GOSSIP_Message::HAS_FAILOVER_LIST_FLAG |
+                         GOSSIP_Message::HAS_STARTING_LIST_FLAG);
+
+  auto serialize = [&](uint16_t proto, unique_evbuffer& evbuf) {
+    ProtocolWriter writer(msg.type_, evbuf.get(), proto);
+    msg.serialize(writer);
+    return writer.result();
+  };
+  auto new_evbuf = [] {
+    return unique_evbuffer(
+        LD_EV(evbuffer_new)(), [](auto ptr) { LD_EV(evbuffer_free)(ptr); });
+  };
+
+  auto evbuf = new_evbuf();
+  const uint16_t proto = Compatibility::COMPACT_GOSSIP_NODE_LIST;
+  ssize_t size = serialize(proto, evbuf);
+  ASSERT_GT(size, 0);
+
+  auto old_evbuf = new_evbuf();
+  ssize_t old_size =
+      serialize(Compatibility::HASHMAP_SUPPORT_IN_GOSSIP, old_evbuf);
+  ASSERT_GT(old_size, 0);
+  EXPECT_LT(size * 3, old_size);
+
+  ProtocolReader reader(msg.type_, evbuf.get(), size, proto);
+  std::unique_ptr<Message> deserialized_base =
+      GOSSIP_Message::deserialize(reader).msg;
+  ASSERT_NE(nullptr, deserialized_base);
+  auto deserialized = static_cast<GOSSIP_Message*>(deserialized_base.get());
+  // The compact format sorts nodes by id.
+  std::sort(node_list.begin(), node_list.end());
+  checkNodeList(node_list, deserialized->node_list_);
+
+  // A truncated message is rejected.
+  evbuf = new_evbuf();
+  ASSERT_EQ(size, serialize(proto, evbuf));
+  ProtocolReader truncated_reader(msg.type_, evbuf.get(), size - 3, proto);
+  EXPECT_EQ(nullptr, GOSSIP_Message::deserialize(truncated_reader).msg);
+}
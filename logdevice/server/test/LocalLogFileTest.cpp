@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/server/LocalLogFile.h"
+
+#include <cstdio>
+
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/test/TestUtil.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+struct TestEntry {
+  int value;
+};
+
+size_t to_log_entry(const TestEntry& data, char* buf, size_t size) {
+  return snprintf(buf, size, "entry %d\n", data.value);
+}
+
+std::string writeEntries(size_t queue_size, int count) {
+  auto dir = createTemporaryDir("LocalLogFileTest");
+  const std::string path = dir->path().string() + "/log";
+  {
+    LocalLogFile file(queue_size, std::chrono::milliseconds(10));
+    EXPECT_GE(file.open(path), 0);
+    for (int i = 0; i < count; ++i) {
+      EXPECT_GT(file.write(TestEntry{i}), 0);
+    }
+    // the destructor writes whatever is still queued
+  }
+  std::string contents;
+  EXPECT_TRUE(folly::readFile(path.c_str(), contents));
+  return contents;
+}
+
+} // namespace
+
+TEST(LocalLogFileTest, Synchronous) {
+  EXPECT_EQ("entry 0\nentry 1\nentry 2\n", writeEntries(0, 3));
+}
+
+TEST(LocalLogFileTest, Background) {
+  const int count = 1000;
+  std::string expected;
+  for (int i = 0; i < count; ++i) {
+    expected += "entry " + std::to_string(i) + "\n";
+  }
+  // The queue is large enough for all the entries, so none are dropped.
+  EXPECT_EQ(expected, writeEntries(count, count));
+}
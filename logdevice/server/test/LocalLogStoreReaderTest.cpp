@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/read_path/LocalLogStoreReader.h"
 
+#include <map>
+
 #include <folly/Memory.h>
 #include <folly/Random.h>
 #include <gtest/gtest.h>
@@ -359,6 +361,39 @@ TEST_P(LocalLogStoreReaderTest, ZeroExecutionTime_) {
   ASSERT_EQ(E::PARTIAL, st);
   ASSERT_EQ(1, records.size());
 }
+
+// A read is preempted only if the callback says more urgent work is waiting.
+TEST_P(LocalLogStoreReaderTest, Preempt) {
+  auto store = createStore({{1, 1, {N1, N2, N3, N4}},
+                            {2, 1, {N1, N2, N3, N4}},
+                            {3, 1, {N1, N2, N3, N4}},
+                            {4, 1, {N1, N2, N3, N4}}});
+
+  std::vector<RawRecord> records;
+  Status st = ReadOperation()
+                  .use_csi(useCSI())
+                  .until_lsn(4)
+                  .window_high(4)
+                  .last_released(4)
+                  .preempt_after(std::chrono::milliseconds::zero())
+                  .should_preempt([] { return true; })
+                  .process(store.get(), records);
+  ASSERT_EQ(E::PARTIAL, st);
+  ASSERT_EQ(1, records.size());
+
+  records.clear();
+  st = ReadOperation()
+           .use_csi(useCSI())
+           .until_lsn(4)
+           .window_high(4)
+           .last_released(4)
+           .preempt_after(std::chrono::milliseconds::zero())
+           .should_preempt([] { return false; })
+           .process(store.get(), records);
+  ASSERT_EQ(E::UNTIL_LSN_REACHED, st);
+  ASSERT_EQ(4, records.size());
+}
+
 /**
  * If the local log store contains an old-format and a new-format DataKey with
  * the same log ID and LSN, LocalLogStoreReader only delivers the copy with the
@@ -1272,6 +1307,43 @@ TEST(LocalLogStoreReaderTest, HashShuffleFixed) {
             shuf_v1(c({79, 76, 13, 71, 68, 47, 26, 23, 16, 28})));
 }
 
+// HASH_SHUFFLE_LSN_BLOCK_ROTATION keeps the same order within a block of LSNs
+// and spreads the first position of the copyset evenly across blocks.
+TEST(LocalLogStoreReaderTest, LsnBlockRotation) {
+  LLSFilter filter;
+  filter.scd_copyset_reordering_ =
+      SCDCopysetReordering::HASH_SHUFFLE_LSN_BLOCK_ROTATION;
+  filter.csid_hash_pt1 = 0x1234;
+  filter.csid_hash_pt2 = 0x5678;
+
+  const std::vector<ShardID> copyset = {N1, N2, N3};
+  auto reorder = [&](lsn_t lsn) {
+    std::vector<ShardID> v = copyset;
+    filter.applyCopysetReordering(v.data(), v.size(), lsn);
+    return v;
+  };
+
+  std::map<ShardID, int> primaries;
+  const int num_blocks = 300;
+  for (int block = 0; block < num_blocks; ++block) {
+    const lsn_t first = compose_lsn(epoch_t(1), esn_t(0)) +
+        block * SCD_ROTATION_LSN_BLOCK_SIZE;
+    const std::vector<ShardID> v = reorder(first);
+    // Same order for the whole block.
+    EXPECT_EQ(v, reorder(first + SCD_ROTATION_LSN_BLOCK_SIZE - 1));
+    // Still a permutation of the copyset.
+    std::vector<ShardID> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(copyset, sorted);
+    ++primaries[v[0]];
+  }
+
+  ASSERT_EQ(3, primaries.size());
+  for (const auto& kv : primaries) {
+    EXPECT_GT(kv.second, num_blocks / 6) << kv.first.toString();
+  }
+}
+
 // A basic test where we check that records are filtered properly when local scd
 // is in use.
 TEST_P(LocalLogStoreReaderTest, LocalScdSimple) {
@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 
+#include <algorithm>
 #include <deque>
 #include <thread>
 #include <vector>
@@ -14,6 +15,7 @@
 #include <boost/noncopyable.hpp>
 #include <gtest/gtest.h>
 
+#include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/types.h"
@@ -148,3 +150,105 @@ TEST(LogStorageStateMapTest, LastReleasedLSNSource) {
   EXPECT_EQ(
       LogStorageState::LastReleasedSource::RELEASE, released_state.source());
 }
+
+TEST(LogStorageStateMapTest, TrimPointSubscriber) {
+  LogStorageStateMap map(1);
+  LogStorageState log_state(logid_t(42), THIS_SHARD, &map);
+  EXPECT_EQ(NODE_INDEX_INVALID, log_state.getTrimPointSubscriber());
+
+  // Without a processor there's nothing to push to, but the trim point still
+  // advances.
+  log_state.setTrimPointSubscriber(3);
+  EXPECT_EQ(3, log_state.getTrimPointSubscriber());
+  ASSERT_EQ(0, log_state.updateTrimPoint(lsn_t(10)));
+  EXPECT_EQ(lsn_t(10), log_state.getTrimPoint().value());
+  EXPECT_EQ(-1, log_state.updateTrimPoint(lsn_t(5)));
+  EXPECT_EQ(E::UPTODATE, err);
+}
+
+TEST(LogStorageStateMapTest, EpochStartOffsets) {
+  LogStorageStateMap map(1);
+  LogStorageState log_state(logid_t(42), THIS_SHARD, &map);
+  EXPECT_FALSE(log_state.getEpochStartOffsets(epoch_t(1)).hasValue());
+
+  const size_t max = LogStorageState::MAX_EPOCH_START_OFFSETS;
+  for (uint32_t e = 1; e <= max + 1; ++e) {
+    OffsetMap offsets;
+    offsets.setCounter(BYTE_OFFSET, e * 100);
+    log_state.noteEpochStartOffsets(epoch_t(e), std::move(offsets));
+  }
+  // Invalid offsets are ignored.
+  log_state.noteEpochStartOffsets(epoch_t(max + 2), OffsetMap());
+  EXPECT_FALSE(log_state.getEpochStartOffsets(epoch_t(max + 2)).hasValue());
+
+  // The oldest epoch was evicted.
+  EXPECT_FALSE(log_state.getEpochStartOffsets(epoch_t(1)).hasValue());
+  for (uint32_t e = 2; e <= max + 1; ++e) {
+    auto offsets = log_state.getEpochStartOffsets(epoch_t(e));
+    ASSERT_TRUE(offsets.hasValue());
+    EXPECT_EQ(e * 100, offsets->getCounter(BYTE_OFFSET));
+  }
+}
+
+TEST(LogStorageStateMapTest, DenseLayout) {
+  const size_t dense_logs = 100;
+  LogStorageStateMap map(
+      2, std::chrono::microseconds(500000), nullptr, dense_logs);
+
+  const std::vector<logid_t> logs = {
+      logid_t(1),
+      logid_t(63),
+      logid_t(64),
+      logid_t(99),
+      logid_t(100),
+      logid_t(12345),
+      MetaDataLog::metaDataLogID(logid_t(1)),
+      MetaDataLog::metaDataLogID(logid_t(99)),
+      MetaDataLog::metaDataLogID(logid_t(100)),
+  };
+
+  for (logid_t log : logs) {
+    EXPECT_EQ(nullptr, map.find(log, THIS_SHARD));
+    LogStorageState* state = map.insertOrGet(log, THIS_SHARD);
+    ASSERT_NE(nullptr, state);
+    EXPECT_EQ(log, state->getLogID());
+    EXPECT_EQ(THIS_SHARD, state->getShardIdx());
+    EXPECT_EQ(state, map.insertOrGet(log, THIS_SHARD));
+    EXPECT_EQ(state, map.find(log, THIS_SHARD));
+    EXPECT_EQ(state, &map.get(log, THIS_SHARD));
+    // Shards are independent.
+    EXPECT_EQ(nullptr, map.find(log, THIS_SHARD + 1));
+    ASSERT_EQ(
+        0,
+        state->updateLastReleasedLSN(
+            lsn_t(log.val_ % 1000 + 1),
+            LogStorageState::LastReleasedSource::RELEASE));
+  }
+
+  std::vector<logid_t> visited;
+  map.forEachLogOnShard(THIS_SHARD,
+                        [&](logid_t log, const LogStorageState& state) {
+                          EXPECT_EQ(log, state.getLogID());
+                          visited.push_back(log);
+                          return 0;
+                        });
+  std::sort(visited.begin(), visited.end());
+  std::vector<logid_t> expected = logs;
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, visited);
+
+  LogStorageStateMap::ReleaseStates released =
+      map.getAllLastReleasedLSNs(THIS_SHARD);
+  std::sort(released.begin(), released.end());
+  LogStorageStateMap::ReleaseStates expected_released;
+  for (logid_t log : expected) {
+    expected_released.emplace_back(log, lsn_t(log.val_ % 1000 + 1));
+  }
+  EXPECT_EQ(expected_released, released);
+  EXPECT_TRUE(map.getAllLastReleasedLSNs(THIS_SHARD + 1).empty());
+
+  map.clear();
+  for (logid_t log : logs) {
+    EXPECT_EQ(nullptr, map.find(log, THIS_SHARD));
+  }
+}
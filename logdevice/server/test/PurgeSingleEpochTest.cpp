@@ -174,7 +174,7 @@ TEST_F(PurgeSingleEpochTest, Basic) {
                            epoch_end_offsets);
   EpochRecoveryStateMap map{{8, {E::OK, md}}};
   purge_->onGetEpochRecoveryMetadataComplete(E::OK, map);
-  CHECK_STORAGE_TASK(PurgeDeleteRecordsStorageTask);
+  CHECK_STORAGE_TASK(PurgeDeleteKeysStorageTask);
   purge_->onPurgeRecordsTaskDone(E::OK);
   CHECK_STORAGE_TASK(PurgeWriteEpochRecoveryMetadataStorageTask);
   purge_->onWriteEpochRecoveryMetadataDone(E::OK);
@@ -199,7 +199,7 @@ TEST_F(PurgeSingleEpochTest, ERMKnown) {
   setUp();
   purge_->start();
   ASSERT_FALSE(GetERMRequestPosted_);
-  CHECK_STORAGE_TASK(PurgeDeleteRecordsStorageTask);
+  CHECK_STORAGE_TASK(PurgeDeleteKeysStorageTask);
   purge_->onPurgeRecordsTaskDone(E::OK);
   CHECK_STORAGE_TASK(PurgeWriteEpochRecoveryMetadataStorageTask);
   purge_->onWriteEpochRecoveryMetadataDone(E::OK);
@@ -287,6 +287,45 @@ TEST_F(PurgeSingleEpochTest, DeleteRecordsByKey) {
   ASSERT_EQ(0, stats.get().purging_v2_delete_by_reading_data);
 }
 
+// The deletes of PurgeDeleteKeysStorageTask are written by a
+// WriteBatchStorageTask, possibly together with those of other tasks
+TEST_F(PurgeSingleEpochTest, DeleteKeysWriteOps) {
+  TemporaryRocksDBStore store;
+
+  std::vector<TestRecord> test_data = {
+      TestRecord(LOG_ID, lsn(1, 2), esn_t(1)),
+      TestRecord(LOG_ID, lsn(2, 1), esn_t(0)),
+      TestRecord(LOG_ID, lsn(2, 2), esn_t(1)),
+      TestRecord(LOG_ID, lsn(2, 99), esn_t(1)),
+      TestRecord(LOG_ID, lsn(2, 100), esn_t(1)),
+      TestRecord(LOG_ID, lsn(3, 1), esn_t(0)),
+      TestRecord(LOG_ID, lsn(3, 5), esn_t(0)),
+  };
+  store_fill(store, test_data);
+
+  PurgeDeleteKeysStorageTask task1(
+      LOG_ID, epoch_t(2), esn_t(2), esn_t(99), WeakRef<PurgeSingleEpoch>());
+  PurgeDeleteKeysStorageTask task2(
+      LOG_ID, epoch_t(3), esn_t(2), esn_t(4000), WeakRef<PurgeSingleEpoch>());
+  ASSERT_EQ(98, task1.getNumWriteOps());
+  ASSERT_EQ(3999, task2.getNumWriteOps());
+
+  std::vector<const WriteOp*> ops(task1.getNumWriteOps() +
+                                  task2.getNumWriteOps());
+  size_t n = task1.getWriteOps(ops.data(), ops.size());
+  n += task2.getWriteOps(ops.data() + n, ops.size() - n);
+  ASSERT_EQ(ops.size(), n);
+  ASSERT_EQ(0, store.writeMulti(ops));
+
+  const std::vector<lsn_t> expected_lsns = {
+      lsn(1, 2),
+      lsn(2, 1),
+      lsn(2, 100),
+      lsn(3, 1),
+  };
+  ASSERT_EQ(expected_lsns, getLsnsForLog(LOG_ID, store));
+}
+
 TEST_F(PurgeSingleEpochTest, DeleteRecordsByReadingData) {
   TemporaryRocksDBStore store;
   StatsHolder stats(StatsParams().setIsServer(true));
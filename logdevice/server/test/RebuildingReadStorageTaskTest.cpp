@@ -517,3 +517,54 @@ TEST_F(RebuildingReadStorageTaskTest, TimeRanges) {
               convertChunks(chunks));
   }
 }
+
+TEST_F(RebuildingReadStorageTaskTest, DonorTakeover) {
+  // N1 is us. N9 needs to be rebuilt.
+  // N0 lags far behind, N2 is far ahead, N3 is slightly ahead of us.
+  logid_t L1(1);
+  auto& P = partition_start;
+  ReplicationProperty R({{NodeLocationScope::NODE, 3}});
+  StorageSet all_nodes{N0, N1, N2, N3, N4, N5, N6, N7, N8, N9};
+
+  setRebuildingSettings({{"rebuilding-donor-takeover-lag", "20min"}});
+
+  auto rebuilding_set = std::make_shared<RebuildingSet>();
+  rebuilding_set->shards.emplace(
+      N9, RebuildingNodeInfo(RebuildingMode::RESTORE));
+  auto c = createContext(rebuilding_set);
+  c->logs[L1].plan.untilLSN = LSN_MAX;
+  c->logs[L1].plan.addEpochRange(
+      EPOCH_INVALID, EPOCH_MAX, std::make_shared<EpochMetaData>(all_nodes, R));
+  c->donorProgress = {{0, P[1]},
+                      {1, P[0]},
+                      {2, P[5] + PARTITION_DURATION * 2},
+                      {3, P[0] + MINUTE}};
+  c->myReportedProgress = P[0];
+
+  // We're not lagging behind this one.
+  store->putRecord(L1, mklsn(1, 1), P[0] + MINUTE * 2, {N1, N2, N9}); // +
+  // N0 is not lagging behind this one by more than 20 minutes.
+  store->putRecord(L1, mklsn(1, 2), P[1] + MINUTE, {N0, N1, N9}); // -
+  // N0 is lagging, we're taking over.
+  store->putRecord(L1, mklsn(1, 3), P[3] + MINUTE, {N0, N1, N9}); // +
+  // We're lagging and N2 has already gone past this record.
+  store->putRecord(L1, mklsn(1, 4), P[3] + MINUTE, {N1, N2, N9}); // -
+  // We're lagging but N3 hasn't taken over this record yet.
+  store->putRecord(L1, mklsn(1, 5), P[3] + MINUTE, {N1, N3, N9}); // +
+  // N2 is not lagging.
+  store->putRecord(L1, mklsn(1, 6), P[3] + MINUTE, {N2, N1, N9}); // -
+  // Progress of N4 is unknown.
+  store->putRecord(L1, mklsn(1, 7), P[3] + MINUTE, {N4, N1, N9}); // -
+
+  {
+    MockRebuildingReadStorageTaskV2 task(this, c);
+    task.execute();
+    task.onDone();
+    EXPECT_TRUE(c->reachedEnd);
+    EXPECT_FALSE(c->persistentError);
+    EXPECT_EQ(std::vector<ChunkDescription>({{L1, mklsn(1, 1)},
+                                             {L1, mklsn(1, 3)},
+                                             {L1, mklsn(1, 5)}}),
+              convertChunks(chunks));
+  }
+}
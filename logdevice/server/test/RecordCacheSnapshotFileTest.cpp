@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/RecordCacheSnapshotFile.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/include/Err.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+class RecordCacheSnapshotFileTest : public ::testing::Test {
+ public:
+  RecordCacheSnapshotFileTest()
+      : dir_(createTemporaryDir("RecordCacheSnapshotFileTest")),
+        path_(dir_->path().string() + "/snapshot") {}
+
+  // Writes a file with the given contents, returns whether it succeeded.
+  bool write(const std::map<logid_t, std::string>& logs) {
+    auto writer = RecordCacheSnapshotFileWriter::create(path_);
+    if (!writer) {
+      return false;
+    }
+    for (const auto& kv : logs) {
+      if (writer->add(kv.first, Slice::fromString(kv.second)) != 0) {
+        return false;
+      }
+    }
+    return writer->finish() == 0;
+  }
+
+  // Reads the file, returns -1 if it couldn't be opened, or the return value
+  // of forEachLog().
+  int read(std::map<logid_t, std::string>& out) {
+    auto file = RecordCacheSnapshotFile::open(path_);
+    if (!file) {
+      return -1;
+    }
+    return file->forEachLog([&](logid_t log, Slice data) {
+      out[log] = std::string(data.ptr(), data.size);
+      return 0;
+    });
+  }
+
+  void corrupt(size_t offset) {
+    std::string contents;
+    ASSERT_TRUE(folly::readFile(path_.c_str(), contents));
+    ASSERT_LT(offset, contents.size());
+    contents[offset] ^= 1;
+    ASSERT_TRUE(folly::writeFile(contents, path_.c_str()));
+  }
+
+  std::unique_ptr<folly::test::TemporaryDirectory> dir_;
+  const std::string path_;
+};
+
+} // namespace
+
+TEST_F(RecordCacheSnapshotFileTest, WriteAndRead) {
+  std::map<logid_t, std::string> logs;
+  logs[logid_t(1)] = "a";
+  logs[logid_t(2)] = "";
+  // spans a few pages
+  logs[logid_t(3)] =
+      std::string(RecordCacheSnapshotFile::CHECKSUM_PAGE_SIZE * 5 / 2, 'x');
+  logs[logid_t(4)] = "bcd";
+  ASSERT_TRUE(write(logs));
+
+  std::map<logid_t, std::string> read_logs;
+  ASSERT_EQ(0, read(read_logs));
+  EXPECT_EQ(logs, read_logs);
+
+  // empty file
+  ASSERT_TRUE(write({}));
+  read_logs.clear();
+  ASSERT_EQ(0, read(read_logs));
+  EXPECT_TRUE(read_logs.empty());
+}
+
+TEST_F(RecordCacheSnapshotFileTest, NotFound) {
+  EXPECT_EQ(nullptr, RecordCacheSnapshotFile::open(path_));
+  EXPECT_EQ(E::NOTFOUND, err);
+}
+
+TEST_F(RecordCacheSnapshotFileTest, CorruptedPage) {
+  const size_t page = RecordCacheSnapshotFile::CHECKSUM_PAGE_SIZE;
+  std::map<logid_t, std::string> logs;
+  // one page each
+  logs[logid_t(1)] = std::string(page, 'a');
+  logs[logid_t(2)] = std::string(page, 'b');
+  logs[logid_t(3)] = std::string(page, 'c');
+  ASSERT_TRUE(write(logs));
+
+  // Corrupt the page of log 2, the other logs are still readable.
+  corrupt(RecordCacheSnapshotFile::HEADER_SIZE + page + 10);
+  std::map<logid_t, std::string> read_logs;
+  EXPECT_EQ(-1, read(read_logs));
+  EXPECT_EQ(E::CHECKSUM_MISMATCH, err);
+  logs.erase(logid_t(2));
+  EXPECT_EQ(logs, read_logs);
+}
+
+TEST_F(RecordCacheSnapshotFileTest, CorruptedHeader) {
+  ASSERT_TRUE(write({{logid_t(1), "a"}}));
+  corrupt(offsetof(RecordCacheSnapshotFile::Header, num_logs));
+  EXPECT_EQ(nullptr, RecordCacheSnapshotFile::open(path_));
+  EXPECT_EQ(E::CHECKSUM_MISMATCH, err);
+
+  // not a snapshot file at all
+  ASSERT_TRUE(folly::writeFile(std::string(10000, 'z'), path_.c_str()));
+  EXPECT_EQ(nullptr, RecordCacheSnapshotFile::open(path_));
+  EXPECT_EQ(E::BADMSG, err);
+}
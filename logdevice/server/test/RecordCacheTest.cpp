@@ -256,6 +256,7 @@ class EpochRecordCacheTest : public ::testing::Test {
   std::vector<std::unique_ptr<Entry>> dropped_;
   bool tail_optimized_ = false;
   StoredBefore stored_before_ = StoredBefore::MAYBE;
+  size_t inline_payload_max_bytes_ = 0;
   std::unique_ptr<EpochRecordCacheDependencies> deps_;
   std::unique_ptr<EpochRecordCache> cache_;
 
@@ -334,6 +335,10 @@ class MockEpochRecordCacheDependencies : public EpochRecordCacheDependencies {
                          lsn_t /*end*/,
                          const ReleasedVector& /*entries*/) override {}
 
+  size_t getInlinePayloadMaxBytes() const override {
+    return test_->inline_payload_max_bytes_;
+  }
+
  private:
   EpochRecordCacheTest* const test_;
 };
@@ -380,6 +385,46 @@ TEST_F(EpochRecordCacheTest, Basic) {
   verifyEntry(*dropped_.back(), lsn(EPOCH, 4));
 }
 
+TEST_F(EpochRecordCacheTest, InlinePayload) {
+  capacity_ = 128;
+  stored_before_ = StoredBefore::NEVER;
+  inline_payload_max_bytes_ = sizeof(lsn_t);
+  create();
+
+  int rv = putRecord(cache_.get(), lsn(EPOCH, 4), 2);
+  ASSERT_EQ(0, rv);
+  ASSERT_CACHE_ENTRY(cache_, 4, lsn(EPOCH, 4));
+  // the payload is copied right after the entry
+  auto result = cache_->getEntry(esn_t(4));
+  ASSERT_TRUE(result.first);
+  EXPECT_EQ(reinterpret_cast<const char*>(result.second.get() + 1),
+            result.second->payload_raw.data);
+
+  // holes have no payload and are not inlined
+  rv = putRecord(cache_.get(), lsn(EPOCH, 5), 2, STORE_Header::HOLE);
+  ASSERT_EQ(0, rv);
+  ASSERT_CACHE_ENTRY_FLAG(cache_,
+                          5,
+                          lsn(EPOCH, 5),
+                          STORE_Header::HOLE,
+                          {},
+                          uint32_t(1),
+                          copyset_t({N0, N1, N2}));
+
+  // payloads larger than the limit still reference their PayloadHolder
+  inline_payload_max_bytes_ = sizeof(lsn_t) - 1;
+  rv = putRecord(cache_.get(), lsn(EPOCH, 6), 2);
+  ASSERT_EQ(0, rv);
+  ASSERT_CACHE_ENTRY(cache_, 6, lsn(EPOCH, 6));
+  result = cache_->getEntry(esn_t(6));
+  ASSERT_TRUE(result.first);
+  EXPECT_NE(reinterpret_cast<const char*>(result.second.get() + 1),
+            result.second->payload_raw.data);
+
+  cache_.reset();
+  ASSERT_EQ(3, dropped_.size());
+}
+
 TEST_F(EpochRecordCacheTest, OffsetWithinEpoch) {
   capacity_ = 128;
   stored_before_ = StoredBefore::NEVER;
@@ -2173,6 +2218,41 @@ TEST_F(RecordCacheTest, RepopulateFromIncompleteBuffer) {
   ASSERT_TRUE(testRecordCachesIdentical(*cache_, *repopulated_cache));
 }
 
+// Repopulating with a buffer owner references payloads in the buffer instead
+// of copying them.
+TEST_F(RecordCacheTest, RepopulateWithoutCopyingPayloads) {
+  epoch_cache_capacity_ = 10;
+  create();
+  ASSERT_EQ(0, putRecord(cache_.get(), lsn(EPOCH, 4), 2));
+  ASSERT_EQ(0, putRecord(cache_.get(), lsn(EPOCH, 5), 2));
+
+  const ssize_t buflen = cache_->sizeInLinearBuffer();
+  ASSERT_GT(buflen, 0);
+  std::shared_ptr<char> buf(new char[buflen], std::default_delete<char[]>());
+  ASSERT_EQ(buflen, cache_->toLinearBuffer(buf.get(), buflen));
+
+  auto repopulated_cache = RecordCache::fromLinearBuffer(
+      buf.get(), buflen, deps_.get(), SHARD, buf);
+  ASSERT_NE(nullptr, repopulated_cache);
+  ASSERT_TRUE(testRecordCachesIdentical(*cache_, *repopulated_cache));
+  // One reference per cached payload.
+  EXPECT_EQ(3, buf.use_count());
+
+  auto result = repopulated_cache->getEpochRecordCache(EPOCH);
+  ASSERT_EQ(Result::HIT, result.first);
+  auto entry = result.second->getEntry(esn_t(4));
+  ASSERT_TRUE(entry.first);
+  const char* payload = entry.second->payload_raw.ptr();
+  EXPECT_GE(payload, buf.get());
+  EXPECT_LT(payload, buf.get() + buflen);
+
+  entry.second.reset();
+  result.second.reset();
+  repopulated_cache.reset();
+  dropped_.clear();
+  EXPECT_EQ(1, buf.use_count());
+}
+
 TEST_F(RecordCacheTest, SequencingSizeCalculation) {
   epoch_cache_capacity_ = 10;
   create();
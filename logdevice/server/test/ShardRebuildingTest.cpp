@@ -5,6 +5,8 @@
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include <set>
+
 #include <gtest/gtest.h>
 
 #include "logdevice/common/settings/SettingsUpdater.h"
@@ -28,7 +30,10 @@ class MockedShardRebuilding : public ShardRebuildingV2,
   };
 
   StatsHolder stats;
+  // Whether reader 0 has a storage task in flight.
   bool taskInFlight = false;
+  // Readers that have a storage task in flight.
+  std::set<size_t> readersWithTaskInFlight;
   bool waitingForGlobalWindow = false;
   bool completed = false;
 
@@ -113,9 +118,10 @@ class MockedShardRebuilding : public ShardRebuildingV2,
         ChunkInfo{.id = chunk_id, .data = std::move(chunk), .worker = worker});
     return worker;
   }
-  void putStorageTask() override {
-    EXPECT_FALSE(taskInFlight);
-    taskInFlight = true;
+  void putStorageTask(size_t reader_idx) override {
+    EXPECT_EQ(0, readersWithTaskInFlight.count(reader_idx));
+    readersWithTaskInFlight.insert(reader_idx);
+    taskInFlight = readersWithTaskInFlight.count(0);
   }
 
   void onShardRebuildingComplete(uint32_t shard_idx) override {
@@ -144,29 +150,52 @@ class MockedShardRebuilding : public ShardRebuildingV2,
     globalWindowWaitingMayHaveChanged(before);
   }
 
-  void simulateReadTaskDone(std::vector<ChunkData*> chunks,
-                            bool reached_end = false) {
-    ld_check(taskInFlight);
-    taskInFlight = false;
-
-    ld_check(!readContext_->reachedEnd);
-    readContext_->reachedEnd = reached_end;
+  void
+  simulateReadTaskDone(std::vector<ChunkData*> chunks,
+                       bool reached_end = false,
+                       size_t reader_idx = 0,
+                       RecordTimestamp progress_ts = RecordTimestamp::min()) {
+    ld_check(readersWithTaskInFlight.count(reader_idx));
+    readersWithTaskInFlight.erase(reader_idx);
+    taskInFlight = readersWithTaskInFlight.count(0);
+
+    auto& context = readers_.at(reader_idx).context;
+    ld_check(!context->reachedEnd);
+    context->reachedEnd = reached_end;
+    context->progressTimestamp = progress_ts;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone(
+    context->onDone(
         std::vector<std::unique_ptr<ChunkData>>(chunks.begin(), chunks.end()));
     globalWindowWaitingMayHaveChanged(before);
   }
 
-  void simulatePersistentError() {
-    ld_check(taskInFlight);
-    taskInFlight = false;
+  void simulatePersistentError(size_t reader_idx = 0) {
+    ld_check(readersWithTaskInFlight.count(reader_idx));
+    readersWithTaskInFlight.erase(reader_idx);
+    taskInFlight = readersWithTaskInFlight.count(0);
 
-    readContext_->persistentError = true;
+    auto& context = readers_.at(reader_idx).context;
+    context->persistentError = true;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone({});
+    context->onDone({});
     globalWindowWaitingMayHaveChanged(before);
   }
 
+  size_t numReaders() const {
+    return readers_.size();
+  }
+
+  // Which reader got the given log.
+  size_t readerOfLog(logid_t log) const {
+    for (size_t i = 0; i < readers_.size(); ++i) {
+      if (readers_[i].context->logs.count(log)) {
+        return i;
+      }
+    }
+    ADD_FAILURE() << "log " << log.val() << " not assigned to any reader";
+    return 0;
+  }
+
   // idx is index in chunkRebuildings.
   void simulateChunkRebuildingDone(size_t idx) {
     auto before = SteadyTimestamp::now();
@@ -230,7 +259,7 @@ ChunkData* makeChunk(logid_t log,
 TEST_F(ShardRebuildingTest, Basic) {
   MockedShardRebuilding reb(rebuildingSettings_);
   // ShardRebuilding doesn't directly use rebuilding plan, it just passes it to
-  // readContext_. So we can pass an empty plan.
+  // the read context. So we can pass an empty plan.
   reb.start({});
   EXPECT_TRUE(reb.taskInFlight);
   EXPECT_EQ(0, reb.chunkRebuildings.size());
@@ -446,6 +475,62 @@ TEST_F(ShardRebuildingTest, TestStallRebuilding) {
   ASSERT_EQ(0, reb.donorProgress.size());
 }
 
+TEST_F(ShardRebuildingTest, ParallelReaders) {
+  rebuildingSettingsUpdater_.setFromCLI(
+      {{"rebuilding-read-parallelism", "2"}});
+
+  MockedShardRebuilding reb(rebuildingSettings_);
+  std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan;
+  for (logid_t::raw_type log = 1; log <= 20; ++log) {
+    plan[logid_t(log)] = std::make_unique<RebuildingPlan>();
+  }
+  reb.start(std::move(plan));
+  ASSERT_EQ(2, reb.numReaders());
+  EXPECT_EQ(2, reb.readersWithTaskInFlight.size());
+
+  // Pick a log read by each of the readers.
+  logid_t log_a = LOGID_INVALID;
+  logid_t log_b = LOGID_INVALID;
+  for (logid_t::raw_type log = 1; log <= 20; ++log) {
+    (reb.readerOfLog(logid_t(log)) == 0 ? log_a : log_b) = logid_t(log);
+  }
+  ASSERT_NE(LOGID_INVALID, log_a);
+  ASSERT_NE(LOGID_INVALID, log_b);
+
+  // Reader 0 returns a chunk. It gets rebuilt right away, but donor progress
+  // is held back by reader 1, which hasn't read anything yet.
+  reb.simulateReadTaskDone({makeChunk(log_a, 100, 101, 10, BASE_TIME + MINUTE)},
+                           false,
+                           0,
+                           BASE_TIME + MINUTE);
+  ASSERT_EQ(1, reb.chunkRebuildings.size());
+  EXPECT_EQ(0, reb.donorProgress.size());
+  EXPECT_EQ(2, reb.readersWithTaskInFlight.size());
+
+  // Reader 1 returns an older chunk and reaches the end.
+  reb.simulateReadTaskDone({makeChunk(log_b, 200, 201, 10, BASE_TIME)},
+                           true,
+                           1,
+                           BASE_TIME + MINUTE * 2);
+  ASSERT_EQ(2, reb.chunkRebuildings.size());
+  EXPECT_EQ(log_b, reb.chunkRebuildings[1].data->address.log);
+  EXPECT_DONOR_PROGRESS(BASE_TIME);
+  EXPECT_EQ(1, reb.readersWithTaskInFlight.size());
+
+  // Reader 0 may still produce records older than its in-flight chunk.
+  reb.simulateChunkRebuildingDone(1);
+  EXPECT_DONOR_PROGRESS(BASE_TIME + MINUTE);
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_DONOR_PROGRESS(BASE_TIME + MINUTE);
+  EXPECT_FALSE(reb.completed);
+
+  // Reading is done only when both readers have reached the end.
+  reb.simulateReadTaskDone({}, true, 0, BASE_TIME + MINUTE * 3);
+  EXPECT_DONOR_PROGRESS(BASE_TIME + MINUTE * 3);
+  EXPECT_EQ(0, reb.readersWithTaskInFlight.size());
+  EXPECT_TRUE(reb.completed);
+}
+
 // TODO: getDebugInfo()
 // TODO: getDebugInfo() while waiting for global window
 // TODO: getDebugInfo() while have and don't have storage task in flight
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/read_path/SharedRecordPayloads.h"
+
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+TEST(SharedRecordPayloadsTest, SharesWhileReferenced) {
+  SharedRecordPayloads payloads;
+  const std::string data = "payload";
+  const Payload payload(data.data(), data.size());
+  bool shared = true;
+
+  auto first = payloads.get(logid_t(1), 10, payload, &shared);
+  EXPECT_FALSE(shared);
+  ASSERT_NE(nullptr, first);
+  EXPECT_NE(data.data(), first.get());
+  EXPECT_EQ(0, memcmp(data.data(), first.get(), data.size()));
+
+  // Same record, same buffer.
+  auto second = payloads.get(logid_t(1), 10, payload, &shared);
+  EXPECT_TRUE(shared);
+  EXPECT_EQ(first.get(), second.get());
+
+  // Other records of the log or the same LSN of other logs get their own.
+  auto other_lsn = payloads.get(logid_t(1), 11, payload, &shared);
+  EXPECT_FALSE(shared);
+  EXPECT_NE(first.get(), other_lsn.get());
+  auto other_log = payloads.get(logid_t(2), 10, payload, &shared);
+  EXPECT_FALSE(shared);
+  EXPECT_NE(first.get(), other_log.get());
+
+  // Once no message references the buffer, the next one makes a new copy.
+  first.reset();
+  second.reset();
+  auto third = payloads.get(logid_t(1), 10, payload, &shared);
+  EXPECT_FALSE(shared);
+  EXPECT_EQ(0, memcmp(data.data(), third.get(), data.size()));
+}
+
+TEST(SharedRecordPayloadsTest, SweepsUnreferenced) {
+  SharedRecordPayloads payloads;
+  const std::string data = "x";
+  const Payload payload(data.data(), data.size());
+  bool shared;
+
+  auto kept = payloads.get(logid_t(1), 1, payload, &shared);
+  for (lsn_t lsn = 2; lsn <= 10000; ++lsn) {
+    payloads.get(logid_t(1), lsn, payload, &shared);
+  }
+  // Buffers nobody references don't accumulate.
+  EXPECT_LT(payloads.size(), 3000);
+
+  auto again = payloads.get(logid_t(1), 1, payload, &shared);
+  EXPECT_TRUE(shared);
+  EXPECT_EQ(kept.get(), again.get());
+}
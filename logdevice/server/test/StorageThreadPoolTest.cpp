@@ -136,6 +136,68 @@ TEST(StorageThreadPoolTest, Basic) {
   }
 }
 
+// With work stealing enabled, an idle slow thread should pick up fast tasks
+// while the only fast thread is busy, as long as the fast queue has at least
+// storage_tasks_steal_min_backlog tasks.
+TEST(StorageThreadPoolTest, WorkStealing) {
+  Alarm alarm(std::chrono::seconds(60));
+  for (int testIter = 0; testIter < 2; testIter++) {
+    ld_info("starting test iter %d", testIter);
+    Settings init_settings = create_default_settings<Settings>();
+    init_settings.storage_tasks_work_stealing = true;
+    init_settings.storage_tasks_steal_min_backlog = 2;
+    if (testIter == 1) {
+      init_settings.storage_tasks_use_drr = true;
+    }
+    UpdateableSettings<Settings> settings(init_settings);
+    ServerSettings init_server_settings =
+        create_default_settings<ServerSettings>();
+    UpdateableSettings<ServerSettings> server_settings(init_server_settings);
+
+    Params params;
+    params[(size_t)StorageTaskThreadType::SLOW].nthreads = 1;
+    params[(size_t)StorageTaskThreadType::FAST_TIME_SENSITIVE].nthreads = 1;
+
+    TemporaryRocksDBStore store;
+    auto pool = std::make_unique<StorageThreadPool>(
+        0, 1, params, server_settings, settings, &store, 16);
+
+    // Occupy the fast thread. The backlog is below the threshold, so the slow
+    // thread leaves this task alone.
+    folly::Baton<> fast_thread_busy;
+    folly::Baton<> unblock_fast_thread;
+    ASSERT_TRUE(pool->blockingPutTask(std::make_unique<TestTask>(
+        StorageTask::ThreadType::FAST_TIME_SENSITIVE, [&] {
+          fast_thread_busy.post();
+          unblock_fast_thread.wait();
+        })));
+    fast_thread_busy.wait();
+
+    const int ntasks = 5;
+    Semaphore sem;
+    for (int i = 0; i < ntasks; ++i) {
+      ASSERT_TRUE(pool->blockingPutTask(std::make_unique<TestTask>(
+          StorageTask::ThreadType::FAST_TIME_SENSITIVE, [&] { sem.post(); })));
+    }
+    // The slow thread steals until only one task is left in the queue.
+    for (int i = 0; i < ntasks - 1; ++i) {
+      sem.wait();
+    }
+    EXPECT_EQ(ntasks - 1,
+              pool->getNumTasksStolen(
+                  StorageTask::ThreadType::FAST_TIME_SENSITIVE));
+    EXPECT_EQ(0, pool->getNumTasksStolen(StorageTask::ThreadType::SLOW));
+
+    // The last one is executed by the fast thread once it's free.
+    unblock_fast_thread.post();
+    sem.wait();
+    EXPECT_EQ(ntasks - 1,
+              pool->getNumTasksStolen(
+                  StorageTask::ThreadType::FAST_TIME_SENSITIVE));
+    pool.reset();
+  }
+}
+
 // A slow storage task that needs syncing should not be dropped on the floor
 // during shutdown
 TEST(StorageThreadPoolTest, SyncingShutdown) {
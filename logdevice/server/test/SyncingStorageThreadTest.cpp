@@ -189,3 +189,33 @@ TEST(SyncingStorageThreadTest, DelayableAndLaterUndelayableTasks) {
 
   pool.reset();
 }
+
+/**
+ * With an adaptive delay, a lone delayable task arriving at an idle shard is
+ * synced right away instead of waiting for the delaying interval.
+ */
+TEST(SyncingStorageThreadTest, AdaptiveDelayLoneTask) {
+  UpdateableSettings<Settings> settings;
+  ServerSettings init_server_settings =
+      create_default_settings<ServerSettings>();
+  init_server_settings.storage_thread_delaying_sync_interval =
+      std::chrono::milliseconds(TIMEOUT_MS);
+  init_server_settings.storage_thread_sync_latency_target =
+      std::chrono::milliseconds(TIMEOUT_MS);
+  UpdateableSettings<ServerSettings> server_settings(init_server_settings);
+
+  Params params;
+  params[(size_t)StorageTaskThreadType::SLOW].nthreads = 4;
+  const int task_queue_slots = 4;
+
+  TemporaryRocksDBStore store;
+  auto pool = std::make_unique<StorageThreadPool>(
+      0, 1, params, server_settings, settings, &store, task_queue_slots);
+
+  Semaphore sem;
+  pool->enqueueForSync(
+      std::make_unique<DelayableStorageTask>(&sem, 0, ARRIVAL_TIMEOUT_MS));
+  sem.wait();
+
+  pool.reset();
+}
@@ -111,6 +111,7 @@ void shutdown_test_server(std::shared_ptr<ServerProcessor>& processor) {
   std::unique_ptr<Listener> command_listener;
   std::unique_ptr<Listener> gossip_listener;
   std::unique_ptr<Listener> ssl_connection_listener;
+  std::vector<std::unique_ptr<Listener>> worker_connection_listeners;
   std::unique_ptr<EventLoop> connection_listener_loop;
   std::unique_ptr<EventLoop> command_listener_loop;
   std::unique_ptr<EventLoop> gossip_listener_loop;
@@ -131,6 +132,7 @@ void shutdown_test_server(std::shared_ptr<ServerProcessor>& processor) {
                   command_listener,
                   gossip_listener,
                   ssl_connection_listener,
+                  worker_connection_listeners,
                   connection_listener_loop,
                   command_listener_loop,
                   gossip_listener_loop,
@@ -938,3 +938,73 @@ TEST_F(ZookeeperEpochStoreTest, LastCleanEpochWithTailRecord) {
   ASSERT_EQ(0, rv);
   sem.wait();
 }
+
+// Concurrent LCE updates of different logs are grouped into multi-ops when
+// write batching is enabled. Every request still gets its own result.
+TEST_F(ZookeeperEpochStoreTest, BatchedWrites) {
+  SettingsUpdater updater;
+  updater.registerSettings(processor->updateableSettings());
+  updater.setFromAdminCmd("zk-epoch-store-write-batch-max-ops", "16");
+
+  const std::vector<std::pair<logid_t, epoch_t>> lces{
+      {logid_t(1), epoch_t(3559930028)},
+      {MetaDataLog::metaDataLogID(logid_t(1)), epoch_t(3522255020)},
+      {logid_t(2), epoch_t(3502237871)},
+      {MetaDataLog::metaDataLogID(logid_t(2)), epoch_t(4244623534)}};
+
+  Semaphore sem;
+  for (const auto& it : lces) {
+    const logid_t log = it.first;
+    const epoch_t new_lce(it.second.val_ + 1);
+    int rv = epochstore->setLastCleanEpoch(
+        log,
+        new_lce,
+        gen_tail_record(log, LSN_INVALID, 0, OffsetMap()),
+        [&sem, log, new_lce](
+            Status st, logid_t logid, epoch_t lce, TailRecord) {
+          EXPECT_EQ(E::OK, st);
+          EXPECT_EQ(log, logid);
+          EXPECT_EQ(new_lce, lce);
+          sem.post();
+        });
+    ASSERT_EQ(0, rv);
+  }
+  for (size_t i = 0; i < lces.size(); ++i) {
+    sem.wait();
+  }
+
+  // a stale update fails without affecting the others
+  for (size_t i = 0; i < lces.size(); ++i) {
+    const logid_t log = lces[i].first;
+    const epoch_t new_lce(lces[i].second.val_ + (i == 0 ? 0 : 2));
+    const Status expected = i == 0 ? E::STALE : E::OK;
+    int rv = epochstore->setLastCleanEpoch(
+        log,
+        new_lce,
+        gen_tail_record(log, LSN_INVALID, 0, OffsetMap()),
+        [&sem, log, expected](Status st, logid_t logid, epoch_t, TailRecord) {
+          EXPECT_EQ(expected, st);
+          EXPECT_EQ(log, logid);
+          sem.post();
+        });
+    ASSERT_EQ(0, rv);
+  }
+  for (size_t i = 0; i < lces.size(); ++i) {
+    sem.wait();
+  }
+
+  for (size_t i = 0; i < lces.size(); ++i) {
+    const logid_t log = lces[i].first;
+    const epoch_t expected(lces[i].second.val_ + (i == 0 ? 1 : 2));
+    int rv = epochstore->getLastCleanEpoch(
+        log, [&sem, expected](Status st, logid_t, epoch_t lce, TailRecord) {
+          EXPECT_EQ(E::OK, st);
+          EXPECT_EQ(expected, lce);
+          sem.post();
+        });
+    ASSERT_EQ(0, rv);
+  }
+  for (size_t i = 0; i < lces.size(); ++i) {
+    sem.wait();
+  }
+}
@@ -89,6 +89,30 @@ BENCHMARK(LogStorageStateMapWithMetaDataLogs, iters) {
   accessMap(map.get(), FLAGS_num_threads, iters / FLAGS_num_threads);
 }
 
+BENCHMARK(LogStorageStateMapDenseWithDataLogs, iters) {
+  std::unique_ptr<LogStorageStateMap> map = nullptr;
+
+  BENCHMARK_SUSPEND {
+    map.reset(new LogStorageStateMap(
+        1, std::chrono::microseconds(500000), nullptr, N_LOGS + 1));
+    populateLogs(map.get(), false);
+  }
+
+  accessMap(map.get(), FLAGS_num_threads, iters / FLAGS_num_threads);
+}
+
+BENCHMARK(LogStorageStateMapDenseWithMetaDataLogs, iters) {
+  std::unique_ptr<LogStorageStateMap> map = nullptr;
+
+  BENCHMARK_SUSPEND {
+    map.reset(new LogStorageStateMap(
+        1, std::chrono::microseconds(500000), nullptr, N_LOGS / 2 + 1));
+    populateLogs(map.get(), true);
+  }
+
+  accessMap(map.get(), FLAGS_num_threads, iters / FLAGS_num_threads);
+}
+
 BENCHMARK_DRAW_LINE();
 
 int main(int argc, char* argv[]) {
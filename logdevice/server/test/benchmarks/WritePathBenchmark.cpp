@@ -0,0 +1,367 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+#include <rocksdb/env.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/OffsetMap.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/settings/RebuildingSettings.h"
+#include "logdevice/common/settings/UpdateableSettings.h"
+#include "logdevice/server/locallogstore/RocksDBLocalLogStore.h"
+#include "logdevice/server/locallogstore/RocksDBLogStoreConfig.h"
+#include "logdevice/server/locallogstore/RocksDBSettings.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
+#include "logdevice/server/storage_tasks/WriteBatchStorageTask.h"
+#include "logdevice/server/storage_tasks/WriteStorageTask.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file Benchmarks of the storage write path, from forming the record
+ *       header and copyset index entry to RocksDBWriter::writeMulti() and
+ *       WriteBatchStorageTask batching, against RocksDB on an in-memory env
+ *       so that numbers don't depend on the disk.
+ *
+ *       Copyset widths and batch sizes are benchmark parameters; payload size
+ *       is a flag, e.g. --payload_size=16384 to simulate large records.
+ */
+
+DEFINE_int32(payload_size, 1024, "Payload size in bytes.");
+
+namespace {
+
+using RecordFormat = LocalLogStoreRecordFormat;
+
+const logid_t LOG_ID(1);
+
+std::vector<ShardID> makeCopyset(size_t width) {
+  std::vector<ShardID> copyset;
+  for (size_t i = 0; i < width; ++i) {
+    copyset.emplace_back(node_index_t(i), 0);
+  }
+  return copyset;
+}
+
+const RecordFormat::flags_t RECORD_FLAGS = RecordFormat::FLAG_SHARD_ID |
+    RecordFormat::FLAG_CHECKSUM_PARITY | RecordFormat::FLAG_OFFSET_WITHIN_EPOCH;
+
+// A record ready to be written: its header, CSI entry and the PutWriteOp
+// pointing to them.
+struct Record {
+  Record(lsn_t lsn, const std::vector<ShardID>& copyset, Slice payload) {
+    header = RecordFormat::formRecordHeader(
+        1000000000000 + lsn,
+        esn_t(0),
+        RECORD_FLAGS,
+        1, // wave
+        folly::Range<const ShardID*>(copyset.data(), copyset.size()),
+        OffsetMap::fromLegacy(lsn * payload.size),
+        {}, // keys
+        &header_buf);
+    csi_entry = RecordFormat::formCopySetIndexEntry(
+        1, // wave
+        copyset.data(),
+        copyset.size(),
+        LSN_INVALID,
+        RecordFormat::formCopySetIndexFlags(RECORD_FLAGS),
+        &csi_buf);
+    op = std::make_unique<PutWriteOp>(LOG_ID,
+                                      lsn,
+                                      header,
+                                      payload,
+                                      node_index_t(0), // coordinator
+                                      LSN_INVALID,     // block starting LSN
+                                      csi_entry,
+                                      {}, // keys
+                                      Durability::ASYNC_WRITE,
+                                      false); // is_rebuilding
+  }
+
+  std::string header_buf;
+  std::string csi_buf;
+  Slice header;
+  Slice csi_entry;
+  std::unique_ptr<PutWriteOp> op;
+};
+
+/**
+ * A RocksDBLocalLogStore on an in-memory env. Destroyed with the benchmark,
+ * so each benchmark starts with an empty store.
+ */
+class InMemoryStore {
+ public:
+  InMemoryStore()
+      : mem_env_(rocksdb::NewMemEnv(rocksdb::Env::Default())),
+        env_(mem_env_.get()) {
+    RocksDBSettings raw_settings = RocksDBSettings::defaultTestSettings();
+    raw_settings.use_copyset_index = true;
+    UpdateableSettings<RocksDBSettings> settings(raw_settings);
+    UpdateableSettings<RebuildingSettings> rebuilding_settings;
+    RocksDBLogStoreConfig config(
+        settings, rebuilding_settings, &env_, nullptr, nullptr);
+    config.createMergeOperator(0);
+    store_ = std::make_unique<RocksDBLocalLogStore>(
+        0, 1, "/write_path_benchmark", std::move(config));
+  }
+
+  // Destroy the store before the env it lives in.
+  ~InMemoryStore() {
+    store_.reset();
+  }
+
+  RocksDBLocalLogStore& store() {
+    return *store_;
+  }
+
+ private:
+  std::unique_ptr<rocksdb::Env> mem_env_;
+  rocksdb::EnvWrapper env_;
+  std::unique_ptr<RocksDBLocalLogStore> store_;
+};
+
+/**
+ * A WriteStorageTask wrapping a single record.
+ */
+class BenchmarkWriteTask : public WriteStorageTask {
+ public:
+  explicit BenchmarkWriteTask(std::unique_ptr<Record> record)
+      : WriteStorageTask(StorageTask::Type::STORE),
+        record_(std::move(record)) {}
+
+  size_t getNumWriteOps() const override {
+    return 1;
+  }
+
+  size_t getPayloadSize() const override {
+    return record_->op->data.size;
+  }
+
+  size_t getWriteOps(const WriteOp** write_ops,
+                     size_t write_ops_len) const override {
+    if (write_ops_len == 0) {
+      return 0;
+    }
+    write_ops[0] = record_->op.get();
+    return 1;
+  }
+
+  void onDone() override {}
+  void onDropped() override {}
+
+ private:
+  std::unique_ptr<Record> record_;
+};
+
+/**
+ * WriteBatchStorageTask with its queue and store replaced by a local queue
+ * and an InMemoryStore, the way StoreStorageTaskTest mocks it.
+ */
+class BenchmarkWriteBatchStorageTask : public WriteBatchStorageTask {
+ public:
+  BenchmarkWriteBatchStorageTask(LocalLogStore* store, size_t batch_size)
+      : WriteBatchStorageTask(ThreadType::FAST_TIME_SENSITIVE),
+        store_(store),
+        batch_size_(batch_size) {}
+
+  void add(std::unique_ptr<WriteStorageTask> task) {
+    queue_.push(std::move(task));
+  }
+
+  bool empty() const {
+    return queue_.empty();
+  }
+
+  size_t completed_ = 0;
+
+ protected:
+  size_t getWriteBatchSize() const override {
+    return batch_size_;
+  }
+
+  size_t getWriteBatchBytes() const override {
+    return std::numeric_limits<size_t>::max();
+  }
+
+  StatsHolder* stats() override {
+    return nullptr;
+  }
+
+  void sendBackToWorker(std::unique_ptr<WriteStorageTask> task) override {
+    ld_check(task->status_ == E::OK);
+    ++completed_;
+  }
+
+  void sendDroppedToWorker(std::unique_ptr<WriteStorageTask>) override {}
+
+  int writeMulti(const std::vector<const WriteOp*>& write_ops) override {
+    return store_->writeMulti(write_ops);
+  }
+
+  bool throttleIfNeeded() override {
+    return false;
+  }
+
+  std::unique_ptr<WriteStorageTask> tryGetWrite() override {
+    if (queue_.empty()) {
+      return nullptr;
+    }
+    auto task = std::move(queue_.front());
+    queue_.pop();
+    return task;
+  }
+
+  folly::small_vector<std::unique_ptr<WriteStorageTask>, 4>
+  tryGetWriteBatch(size_t max_count, size_t /* max_bytes */) override {
+    folly::small_vector<std::unique_ptr<WriteStorageTask>, 4> res;
+    while (res.size() < max_count) {
+      auto task = tryGetWrite();
+      if (!task) {
+        break;
+      }
+      res.push_back(std::move(task));
+    }
+    return res;
+  }
+
+ private:
+  LocalLogStore* store_;
+  const size_t batch_size_;
+  std::queue<std::unique_ptr<WriteStorageTask>> queue_;
+};
+
+void formRecordHeader(size_t iters, size_t copyset_width) {
+  std::vector<ShardID> copyset;
+  std::string buf;
+  BENCHMARK_SUSPEND {
+    copyset = makeCopyset(copyset_width);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(RecordFormat::formRecordHeader(
+        1000000000000 + i,
+        esn_t(0),
+        RECORD_FLAGS,
+        1,
+        folly::Range<const ShardID*>(copyset.data(), copyset.size()),
+        OffsetMap::fromLegacy(i * FLAGS_payload_size),
+        {},
+        &buf));
+  }
+}
+
+void formCopySetIndexEntry(size_t iters, size_t copyset_width) {
+  std::vector<ShardID> copyset;
+  std::string buf;
+  BENCHMARK_SUSPEND {
+    copyset = makeCopyset(copyset_width);
+  }
+  const auto csi_flags = RecordFormat::formCopySetIndexFlags(RECORD_FLAGS);
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(RecordFormat::formCopySetIndexEntry(
+        1, copyset.data(), copyset.size(), LSN_INVALID, csi_flags, &buf));
+  }
+}
+
+// Writes `iters' records in batches of `batch_size' with writeMulti().
+void writeMulti(size_t iters, size_t batch_size) {
+  std::unique_ptr<InMemoryStore> store;
+  std::string payload;
+  std::vector<std::unique_ptr<Record>> records;
+  std::vector<const WriteOp*> ops;
+  BENCHMARK_SUSPEND {
+    store = std::make_unique<InMemoryStore>();
+    payload.assign(FLAGS_payload_size, 'x');
+    const auto copyset = makeCopyset(3);
+    for (size_t i = 0; i < iters; ++i) {
+      records.push_back(std::make_unique<Record>(
+          lsn_t(i + 1), copyset, Slice::fromString(payload)));
+    }
+    ops.reserve(batch_size);
+  }
+  for (size_t i = 0; i < iters; i += batch_size) {
+    ops.clear();
+    for (size_t j = i; j < std::min(iters, i + batch_size); ++j) {
+      ops.push_back(records[j]->op.get());
+    }
+    int rv = store->store().writeMulti(ops, LocalLogStore::WriteOptions());
+    ld_check(rv == 0);
+  }
+  BENCHMARK_SUSPEND {
+    store.reset();
+    records.clear();
+  }
+}
+
+// Same as writeMulti() but goes through WriteBatchStorageTask, including
+// forming the records.
+void writeBatchStorageTask(size_t iters, size_t batch_size) {
+  std::unique_ptr<InMemoryStore> store;
+  std::unique_ptr<BenchmarkWriteBatchStorageTask> task;
+  std::string payload;
+  std::vector<ShardID> copyset;
+  BENCHMARK_SUSPEND {
+    store = std::make_unique<InMemoryStore>();
+    task = std::make_unique<BenchmarkWriteBatchStorageTask>(&store->store(),
+                                                            batch_size);
+    payload.assign(FLAGS_payload_size, 'x');
+    copyset = makeCopyset(3);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    task->add(std::make_unique<BenchmarkWriteTask>(std::make_unique<Record>(
+        lsn_t(i + 1), copyset, Slice::fromString(payload))));
+  }
+  while (!task->empty()) {
+    task->execute();
+  }
+  ld_check(task->completed_ == iters);
+  BENCHMARK_SUSPEND {
+    task.reset();
+    store.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(formRecordHeader, copyset_1, 1)
+BENCHMARK_NAMED_PARAM(formRecordHeader, copyset_3, 3)
+BENCHMARK_NAMED_PARAM(formRecordHeader, copyset_6, 6)
+BENCHMARK_NAMED_PARAM(formRecordHeader, copyset_12, 12)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(formCopySetIndexEntry, copyset_1, 1)
+BENCHMARK_NAMED_PARAM(formCopySetIndexEntry, copyset_3, 3)
+BENCHMARK_NAMED_PARAM(formCopySetIndexEntry, copyset_6, 6)
+BENCHMARK_NAMED_PARAM(formCopySetIndexEntry, copyset_12, 12)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(writeMulti, batch_1, 1)
+BENCHMARK_NAMED_PARAM(writeMulti, batch_16, 16)
+BENCHMARK_NAMED_PARAM(writeMulti, batch_128, 128)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(writeBatchStorageTask, batch_1, 1)
+BENCHMARK_NAMED_PARAM(writeBatchStorageTask, batch_16, 16)
+BENCHMARK_NAMED_PARAM(writeBatchStorageTask, batch_128, 128)
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -7,6 +7,7 @@
  */
 #include <algorithm>
 #include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <pthread.h>
@@ -164,6 +165,59 @@ TEST_F(AppendIntegrationTest, AppendEchoClient) {
   EXPECT_EQ(E::TIMEDOUT, err);
 }
 
+/**
+ * Appends a batch of records with appendBatch() and verifies that each
+ * payload got its own record and that LSNs follow the order of the batch.
+ * Also checks that a batch containing an invalid payload is rejected as a
+ * whole.
+ */
+TEST_F(AppendIntegrationTest, AppendBatch) {
+  auto cluster = IntegrationTestUtils::ClusterFactory().create(1);
+  cluster->waitForMetaDataLogWrites();
+
+  std::shared_ptr<Client> client = cluster->createClient();
+  ASSERT_TRUE((bool)client);
+
+  const size_t nrecords = 20;
+  std::vector<std::string> payloads;
+  for (size_t i = 0; i < nrecords; ++i) {
+    payloads.push_back("record" + std::to_string(i));
+  }
+
+  std::mutex mutex;
+  std::map<std::string, lsn_t> lsns;
+  Semaphore sem;
+  int rv = client->appendBatch(
+      logid_t(1), payloads, [&](Status st, const DataRecord& r) {
+        EXPECT_EQ(E::OK, st);
+        EXPECT_EQ(logid_t(1), r.logid);
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          lsns[r.payload.toString()] = r.attrs.lsn;
+        }
+        sem.post();
+      });
+  ASSERT_EQ(0, rv);
+  for (size_t i = 0; i < nrecords; ++i) {
+    sem.wait();
+  }
+
+  ASSERT_EQ(nrecords, lsns.size());
+  for (size_t i = 1; i < nrecords; ++i) {
+    EXPECT_LT(lsns.at(payloads[i - 1]), lsns.at(payloads[i]));
+  }
+
+  // A batch with a payload that is too big is rejected without appending
+  // anything.
+  std::vector<std::string> bad_batch = {
+      "ok", std::string(client->getMaxPayloadSize() + 1, 'x')};
+  rv = client->appendBatch(logid_t(1),
+                           std::move(bad_batch),
+                           [](Status, const DataRecord&) { ADD_FAILURE(); });
+  EXPECT_EQ(-1, rv);
+  EXPECT_EQ(E::TOOBIG, err);
+}
+
 /**
  * Sends 1000 appends to 1000 logs.
  * Checks throttling in SyncStorageThread.
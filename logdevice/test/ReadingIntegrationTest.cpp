@@ -7,7 +7,9 @@
  */
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <folly/Random.h>
 #include <folly/hash/Checksum.h>
@@ -1433,6 +1435,55 @@ TEST_P(ReadingIntegrationTest,
   EXPECT_EQ(num_records_read, 2) << "Unexpected number of records read";
 }
 
+// With --client-read-stream-sharing, readers of the same log in one client
+// share a read stream and each still gets every record.
+TEST_P(ReadingIntegrationTest, SharedReadStreams) {
+  auto cluster = clusterFactory().create(3);
+  std::unique_ptr<ClientSettings> client_settings(ClientSettings::create());
+  ASSERT_EQ(0, client_settings->set("client-read-stream-sharing", true));
+  std::shared_ptr<Client> client = cluster->createClient(
+      getDefaultTestTimeout(), std::move(client_settings));
+  cluster->waitForRecovery();
+
+  const logid_t logid(1);
+  const size_t num_readers = 5;
+  const size_t num_records = 20;
+  const lsn_t tail_lsn = client->getTailLSNSync(logid);
+  ASSERT_NE(LSN_INVALID, tail_lsn);
+
+  std::vector<std::unique_ptr<AsyncReader>> readers;
+  std::vector<std::vector<std::string>> received(num_readers);
+  std::mutex mutex;
+  Semaphore sem;
+  for (size_t i = 0; i < num_readers; ++i) {
+    readers.push_back(client->createAsyncReader());
+    readers.back()->setRecordCallback([&, i](std::unique_ptr<DataRecord>& r) {
+      std::lock_guard<std::mutex> lock(mutex);
+      received[i].push_back(r->payload.toString());
+      if (received[i].size() == num_records) {
+        sem.post();
+      }
+      return true;
+    });
+    ASSERT_EQ(0, readers.back()->startReading(logid, tail_lsn + 1));
+  }
+
+  std::vector<std::string> appended;
+  for (size_t i = 0; i < num_records; ++i) {
+    appended.push_back("data" + std::to_string(i));
+    ASSERT_NE(LSN_INVALID, client->appendSync(logid, appended.back()));
+  }
+  for (size_t i = 0; i < num_readers; ++i) {
+    sem.wait();
+  }
+  for (size_t i = 0; i < num_readers; ++i) {
+    EXPECT_EQ(appended, received[i]);
+  }
+
+  Stats stats = checked_downcast<ClientImpl&>(*client).stats()->aggregate();
+  EXPECT_GE(stats.client.shared_read_streams_created, 1);
+}
+
 INSTANTIATE_TEST_CASE_P(ReadingIntegrationTest,
                         ReadingIntegrationTest,
                         ::testing::Values(false, true));
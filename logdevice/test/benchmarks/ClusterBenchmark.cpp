@@ -0,0 +1,465 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <folly/FileUtil.h>
+#include <folly/Singleton.h>
+#include <folly/String.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/AsyncReader.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/test/utils/IntegrationTestUtils.h"
+
+/**
+ * @file End-to-end performance scenarios against a local cluster started with
+ *       IntegrationTestUtils. Unlike the microbenchmarks in
+ *       common/test/benchmarks, this goes through real logdeviced processes,
+ *       so it catches regressions anywhere on the append and read paths.
+ *
+ *       Each scenario reports throughput, latency percentiles and CPU time
+ *       per MB (of the logdeviced processes and of this process), as one JSON
+ *       object per scenario, keyed by scenario name. Compare the output of two
+ *       builds with the same flags on the same machine.
+ */
+
+DEFINE_string(scenarios,
+              "append,tail,backfill,slow_node,rebuilding",
+              "comma-separated list of scenarios to run");
+DEFINE_int32(nodes, 5, "number of nodes in the cluster");
+DEFINE_int32(replication, 3, "replication factor of the logs");
+DEFINE_int32(logs, 8, "number of logs to write to");
+DEFINE_int32(records, 200000, "number of records to append per scenario");
+DEFINE_int32(payload_size, 1024, "payload size in bytes");
+DEFINE_int32(max_in_flight, 1000, "maximum number of appends in flight");
+DEFINE_string(output, "", "write results to this file instead of stdout");
+DEFINE_int32(slow_node_latency_ms,
+             20,
+             "slow_node scenario: mean latency injected into the writes and "
+             "STORED replies of one node");
+DEFINE_string(slow_node_distribution,
+              "exponential",
+              "slow_node scenario: fixed, uniform or exponential");
+DEFINE_int32(slow_node_max_latency_ms,
+             1000,
+             "slow_node scenario: maximum injected latency");
+DEFINE_uint64(slow_node_seed,
+              1,
+              "slow_node scenario: seed of the latency samples, 0 for random");
+
+using namespace facebook::logdevice;
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+int64_t usecSince(SteadyClock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             SteadyClock::now() - t)
+      .count();
+}
+
+// CPU time (user + system) of a process, in milliseconds, or -1.
+int64_t processCpuMs(pid_t pid) {
+  std::string stat;
+  if (!folly::readFile(folly::sformat("/proc/{}/stat", pid).c_str(), stat)) {
+    return -1;
+  }
+  // The command name in parentheses may contain spaces; fields after it are
+  // space-separated. utime and stime are fields 14 and 15.
+  auto pos = stat.rfind(')');
+  if (pos == std::string::npos) {
+    return -1;
+  }
+  std::vector<folly::StringPiece> fields;
+  folly::split(' ', folly::StringPiece(stat).subpiece(pos + 2), fields);
+  if (fields.size() < 13) {
+    return -1;
+  }
+  // fields[0] is field 3 (state).
+  int64_t ticks =
+      folly::to<int64_t>(fields[11]) + folly::to<int64_t>(fields[12]);
+  return ticks * 1000 / sysconf(_SC_CLK_TCK);
+}
+
+int64_t clusterCpuMs(IntegrationTestUtils::Cluster& cluster) {
+  int64_t total = 0;
+  for (const auto& kv : cluster.getNodes()) {
+    const auto& node = kv.second;
+    if (node->logdeviced_ && node->isRunning()) {
+      total += std::max(processCpuMs(node->logdeviced_->pid()), 0l);
+    }
+  }
+  return total;
+}
+
+int64_t selfCpuMs() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  auto ms = [](const timeval& tv) {
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  };
+  return ms(usage.ru_utime) + ms(usage.ru_stime);
+}
+
+/**
+ * Measures one scenario: wall time, CPU time of the cluster and of this
+ * process, bytes processed and per-operation latencies.
+ */
+class Measurement {
+ public:
+  explicit Measurement(IntegrationTestUtils::Cluster& cluster)
+      : cluster_(cluster),
+        start_(SteadyClock::now()),
+        cluster_cpu_start_(clusterCpuMs(cluster)),
+        self_cpu_start_(selfCpuMs()) {}
+
+  void addLatency(int64_t usec) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_.push_back(usec);
+  }
+
+  void addBytes(size_t bytes) {
+    bytes_ += bytes;
+  }
+
+  folly::dynamic finish() {
+    const int64_t wall_us = usecSince(start_);
+    const int64_t cluster_cpu_ms = clusterCpuMs(cluster_) - cluster_cpu_start_;
+    const int64_t self_cpu_ms = selfCpuMs() - self_cpu_start_;
+    const double mb = bytes_.load() / 1e6;
+
+    folly::dynamic res = folly::dynamic::object;
+    res["wall_ms"] = wall_us / 1000;
+    res["bytes"] = bytes_.load();
+    res["throughput_mb_per_sec"] = wall_us > 0 ? mb / (wall_us / 1e6) : 0.;
+    res["server_cpu_ms"] = cluster_cpu_ms;
+    res["client_cpu_ms"] = self_cpu_ms;
+    res["server_cpu_ms_per_mb"] = mb > 0 ? cluster_cpu_ms / mb : 0.;
+    res["client_cpu_ms_per_mb"] = mb > 0 ? self_cpu_ms / mb : 0.;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!latencies_.empty()) {
+      std::sort(latencies_.begin(), latencies_.end());
+      auto pct = [&](double p) {
+        return latencies_[std::min(latencies_.size() - 1,
+                                   (size_t)(p * latencies_.size()))];
+      };
+      folly::dynamic lat = folly::dynamic::object;
+      lat["count"] = latencies_.size();
+      lat["p50_us"] = pct(.5);
+      lat["p90_us"] = pct(.9);
+      lat["p99_us"] = pct(.99);
+      lat["p999_us"] = pct(.999);
+      lat["max_us"] = latencies_.back();
+      res["latency"] = std::move(lat);
+    }
+    return res;
+  }
+
+ private:
+  IntegrationTestUtils::Cluster& cluster_;
+  const SteadyClock::time_point start_;
+  const int64_t cluster_cpu_start_;
+  const int64_t self_cpu_start_;
+  std::atomic<size_t> bytes_{0};
+  std::mutex mutex_;
+  std::vector<int64_t> latencies_;
+};
+
+/**
+ * Appends FLAGS_records records round-robin over the logs, at most
+ * FLAGS_max_in_flight at a time. Payloads start with the steady clock time
+ * of the append, for the tail scenario. Waits for all appends to complete.
+ *
+ * @return number of payload bytes appended successfully.
+ */
+size_t appendRecords(Client& client, Measurement* m) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  int in_flight = 0;
+  size_t failed = 0;
+  size_t bytes = 0;
+
+  for (int i = 0; i < FLAGS_records; ++i) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return in_flight < FLAGS_max_in_flight; });
+      ++in_flight;
+    }
+    std::string payload(std::max(FLAGS_payload_size, 8), 'x');
+    const auto start = SteadyClock::now();
+    const int64_t ts = start.time_since_epoch().count();
+    memcpy(&payload[0], &ts, sizeof(ts));
+    auto cb = [&, start](Status st, const DataRecord& r) {
+      if (st == E::OK) {
+        m->addLatency(usecSince(start));
+        m->addBytes(r.payload.size());
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (st == E::OK) {
+        bytes += r.payload.size();
+      } else {
+        ++failed;
+      }
+      --in_flight;
+      cv.notify_one();
+    };
+    logid_t log(1 + i % FLAGS_logs);
+    if (client.append(log, std::move(payload), cb) != 0) {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++failed;
+      --in_flight;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return in_flight == 0; });
+  if (failed > 0) {
+    ld_warning("%lu appends failed", failed);
+  }
+  return bytes;
+}
+
+/**
+ * Reads each log in `ranges' (log -> [from, until]), recording bytes. If
+ * `delivery_latency', also records the latency since the append and stops
+ * after FLAGS_records records, for tailing reads that have no end.
+ * `after_start' is called once all read streams are started.
+ */
+void readRecords(Client& client,
+                 const std::map<logid_t, std::pair<lsn_t, lsn_t>>& ranges,
+                 bool delivery_latency,
+                 Measurement* m,
+                 const std::function<void()>& after_start = nullptr) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t logs_done = 0;
+  size_t records = 0;
+
+  auto reader = client.createAsyncReader();
+  reader->setRecordCallback([&](std::unique_ptr<DataRecord>& r) {
+    m->addBytes(r->payload.size());
+    if (delivery_latency && r->payload.size() >= sizeof(int64_t)) {
+      int64_t ts;
+      memcpy(&ts, r->payload.data(), sizeof(ts));
+      m->addLatency(usecSince(SteadyClock::time_point(
+          SteadyClock::duration(ts))));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ++records;
+    cv.notify_one();
+    return true;
+  });
+  reader->setDoneCallback([&](logid_t) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++logs_done;
+    cv.notify_one();
+  });
+  for (const auto& kv : ranges) {
+    int rv = reader->startReading(kv.first, kv.second.first, kv.second.second);
+    ld_check(rv == 0);
+  }
+  if (after_start) {
+    after_start();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] {
+    return logs_done == ranges.size() ||
+        (delivery_latency && records >= (size_t)FLAGS_records);
+  });
+}
+
+folly::dynamic runAppend(IntegrationTestUtils::Cluster& cluster,
+                         Client& client,
+                         size_t* bytes_written) {
+  Measurement m(cluster);
+  *bytes_written += appendRecords(client, &m);
+  return m.finish();
+}
+
+folly::dynamic runTail(IntegrationTestUtils::Cluster& cluster,
+                       Client& client,
+                       size_t* bytes_written) {
+  std::map<logid_t, std::pair<lsn_t, lsn_t>> ranges;
+  for (int i = 1; i <= FLAGS_logs; ++i) {
+    lsn_t tail = client.getTailLSNSync(logid_t(i));
+    ld_check(tail != LSN_INVALID);
+    ranges[logid_t(i)] = std::make_pair(tail + 1, LSN_MAX);
+  }
+  Measurement m(cluster);
+  // Appends go through a separate measurement, we only report delivery.
+  Measurement appends(cluster);
+  readRecords(client, ranges, /* delivery_latency */ true, &m, [&] {
+    *bytes_written += appendRecords(client, &appends);
+  });
+  return m.finish();
+}
+
+folly::dynamic runBackfill(IntegrationTestUtils::Cluster& cluster,
+                           Client& client) {
+  std::map<logid_t, std::pair<lsn_t, lsn_t>> ranges;
+  for (int i = 1; i <= FLAGS_logs; ++i) {
+    lsn_t tail = client.getTailLSNSync(logid_t(i));
+    ld_check(tail != LSN_INVALID);
+    ranges[logid_t(i)] = std::make_pair(LSN_OLDEST, tail);
+  }
+  Measurement m(cluster);
+  readRecords(client, ranges, /* delivery_latency */ false, &m);
+  return m.finish();
+}
+
+// Appends while the last node is slow: its storage writes and its STORED
+// replies are delayed by latency drawn from --slow_node_distribution. Shows
+// how much one slow node hurts append latency, e.g. to evaluate features
+// meant to hide it.
+folly::dynamic runSlowNode(IntegrationTestUtils::Cluster& cluster,
+                           Client& client,
+                           size_t* bytes_written) {
+  auto& node = cluster.getNode(FLAGS_nodes - 1);
+  const std::string distribution = folly::sformat(
+      "--latency={} --latency_max={} --seed={} --force",
+      FLAGS_slow_node_latency_ms,
+      FLAGS_slow_node_max_latency_ms,
+      FLAGS_slow_node_seed);
+  node.sendCommand(folly::sformat(
+      "inject shard_fault all data write latency --latency_distribution={} {}",
+      FLAGS_slow_node_distribution,
+      distribution));
+  node.sendCommand(
+      folly::sformat("inject message_latency STORED --distribution={} {}",
+                     FLAGS_slow_node_distribution,
+                     distribution));
+
+  Measurement m(cluster);
+  *bytes_written += appendRecords(client, &m);
+  auto res = m.finish();
+
+  node.sendCommand("inject shard_fault all all all none --force");
+  node.sendCommand("inject message_latency none --force");
+  return res;
+}
+
+// Wipes shard 0 of the last node and measures the time it takes to rebuild
+// it. Bytes are an estimate of what the shard held: the bytes written so far
+// times the replication factor, spread evenly over all shards of all nodes.
+folly::dynamic runRebuilding(IntegrationTestUtils::Cluster& cluster,
+                             std::shared_ptr<Client> client,
+                             size_t bytes_written) {
+  const node_index_t node = FLAGS_nodes - 1;
+  int rv = cluster.getNode(node).shutdown();
+  ld_check(rv == 0);
+  cluster.getNode(node).wipeShard(0);
+  rv = cluster.bumpGeneration(node);
+  ld_check(rv == 0);
+  cluster.getNode(node).start();
+  cluster.getNode(node).waitUntilStarted();
+
+  Measurement m(cluster);
+  m.addBytes(bytes_written * FLAGS_replication /
+             (FLAGS_nodes * cluster.getNode(node).num_db_shards_));
+  lsn_t lsn = IntegrationTestUtils::requestShardRebuilding(*client, node, 0);
+  ld_check(lsn != LSN_INVALID);
+  IntegrationTestUtils::waitUntilShardsHaveEventLogState(
+      client,
+      {ShardID(node, 0)},
+      AuthoritativeStatus::FULLY_AUTHORITATIVE,
+      /* wait_for_rebuilding */ true);
+  return m.finish();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::vector<std::string> scenarios;
+  folly::split(',', FLAGS_scenarios, scenarios);
+
+  logsconfig::LogAttributes log_attrs;
+  log_attrs.set_replicationFactor(FLAGS_replication);
+  auto cluster = IntegrationTestUtils::ClusterFactory()
+                     .setLogAttributes(log_attrs)
+                     .setNumLogs(FLAGS_logs)
+                     .setParam("--disable-rebuilding", "false")
+                     .setParam("--disabled-retry-interval", "0s")
+                     .create(FLAGS_nodes);
+  if (!cluster) {
+    std::cerr << "Failed to create cluster" << std::endl;
+    return 1;
+  }
+  cluster->waitForRecovery();
+  auto client = cluster->createClient(std::chrono::hours(1));
+
+  folly::dynamic results = folly::dynamic::object;
+  folly::dynamic params = folly::dynamic::object;
+  params["nodes"] = FLAGS_nodes;
+  params["replication"] = FLAGS_replication;
+  params["logs"] = FLAGS_logs;
+  params["records"] = FLAGS_records;
+  params["payload_size"] = FLAGS_payload_size;
+  params["max_in_flight"] = FLAGS_max_in_flight;
+  params["slow_node_latency_ms"] = FLAGS_slow_node_latency_ms;
+  params["slow_node_distribution"] = FLAGS_slow_node_distribution;
+  results["params"] = std::move(params);
+
+  // Backfill and rebuilding work on whatever the earlier scenarios wrote,
+  // so make sure there's data even if only they are requested.
+  size_t bytes_written = 0;
+  auto ensure_data = [&] {
+    if (bytes_written == 0) {
+      Measurement m(*cluster);
+      bytes_written += appendRecords(*client, &m);
+    }
+  };
+  for (const std::string& s : scenarios) {
+    ld_info("Running scenario %s", s.c_str());
+    if (s == "append") {
+      results[s] = runAppend(*cluster, *client, &bytes_written);
+    } else if (s == "tail") {
+      results[s] = runTail(*cluster, *client, &bytes_written);
+    } else if (s == "slow_node") {
+      results[s] = runSlowNode(*cluster, *client, &bytes_written);
+    } else if (s == "backfill") {
+      ensure_data();
+      results[s] = runBackfill(*cluster, *client);
+    } else if (s == "rebuilding") {
+      ensure_data();
+      results[s] = runRebuilding(*cluster, client, bytes_written);
+    } else {
+      std::cerr << "Unknown scenario " << s << std::endl;
+      return 1;
+    }
+  }
+
+  folly::json::serialization_opts opts;
+  opts.pretty_formatting = true;
+  opts.sort_keys = true;
+  std::string json = folly::json::serialize(results, opts);
+  if (FLAGS_output.empty()) {
+    std::cout << json << std::endl;
+  } else if (!folly::writeFile(json, FLAGS_output.c_str())) {
+    std::cerr << "Failed to write " << FLAGS_output << std::endl;
+    return 1;
+  }
+  return 0;
+}
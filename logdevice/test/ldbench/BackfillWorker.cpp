@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <atomic>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/AsyncReader.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/test/ldbench/Worker.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+namespace {
+
+/**
+ * Reads each log once, from --backfill-depth ago (or from the beginning) up
+ * to its tail as of the start of the worker. Done when all logs reach their
+ * until LSN.
+ */
+class BackfillWorker : public Worker {
+ public:
+  explicit BackfillWorker(WorkerContext& ctx) : ctx_(ctx) {}
+
+  ~BackfillWorker() override {
+    stop();
+  }
+
+  int start() override;
+  void stop() override;
+
+  bool done() const override {
+    return logs_left_.load() == 0;
+  }
+
+ private:
+  WorkerContext& ctx_;
+  const Options& opts_{ctx_.options};
+
+  std::unique_ptr<AsyncReader> reader_;
+  std::atomic<size_t> logs_left_{0};
+};
+
+int BackfillWorker::start() {
+  StatsHolder* stats = &ctx_.stats;
+  reader_ = ctx_.client->createAsyncReader();
+  reader_->setRecordCallback([stats](std::unique_ptr<DataRecord>& record) {
+    onRecordDelivered(stats, *record, /* backlog */ true);
+    return true;
+  });
+  reader_->setGapCallback([stats](const GapRecord& gap) {
+    onGapDelivered(stats, gap);
+    return true;
+  });
+  reader_->setDoneCallback([this, stats](logid_t) {
+    STAT_DECR(stats, ldbench->readers_active);
+    logs_left_--;
+  });
+
+  std::chrono::milliseconds from_time{0};
+  if (opts_.backfill_depth != std::chrono::milliseconds::max()) {
+    from_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()) -
+        opts_.backfill_depth;
+  }
+
+  // Count all logs up front so that done() doesn't flip to true while
+  // we're still starting read streams.
+  logs_left_.store(ctx_.logs.size());
+  for (logid_t log : ctx_.logs) {
+    Status st = E::OK;
+    lsn_t until = ctx_.client->getTailLSNSync(log);
+    lsn_t from = LSN_OLDEST;
+    if (until == LSN_INVALID) {
+      st = err;
+    } else if (from_time.count() > 0) {
+      from = ctx_.client->findTimeSync(log, from_time, &st);
+      if (st == E::PARTIAL) {
+        st = E::OK;
+      }
+    }
+    if (st != E::OK) {
+      ld_error("Could not find the range to backfill of log %lu: %s. "
+               "Skipping it.",
+               log.val_,
+               error_description(st));
+      logs_left_--;
+      continue;
+    }
+    if (from > until) {
+      // Nothing to read.
+      logs_left_--;
+      continue;
+    }
+    STAT_INCR(stats, ldbench->readers_assigned);
+    STAT_INCR(stats, ldbench->reader_num_distinct_logs);
+    STAT_INCR(stats, ldbench->readers_active);
+    if (reader_->startReading(log, from, until) != 0) {
+      ld_error("startReading() of log %lu failed: %s",
+               log.val_,
+               error_description(err));
+      STAT_DECR(stats, ldbench->readers_active);
+      logs_left_--;
+    }
+  }
+  return 0;
+}
+
+void BackfillWorker::stop() {
+  reader_.reset();
+  STAT_SUB(&ctx_.stats, ldbench->readers_active, logs_left_.load());
+  logs_left_.store(0);
+}
+
+} // namespace
+
+std::unique_ptr<Worker> createBackfillWorker(WorkerContext& ctx) {
+  return std::make_unique<BackfillWorker>(ctx);
+}
+
+}}} // namespace facebook::logdevice::ldbench
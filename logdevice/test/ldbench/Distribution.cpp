@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/test/ldbench/Distribution.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+int Log2Distribution::parse(const std::string& str) {
+  cumulative_weights_.clear();
+  mean_ = 1;
+  if (str == "constant") {
+    return 0;
+  }
+
+  std::vector<folly::StringPiece> tokens;
+  folly::split(',', str, tokens);
+  double total = 0;
+  double weighted_sum = 0;
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    auto w = folly::tryTo<double>(folly::trimWhitespace(tokens[i]));
+    if (!w.hasValue() || !std::isfinite(w.value()) || w.value() < 0) {
+      cumulative_weights_.clear();
+      return -1;
+    }
+    total += w.value();
+    // Mean of the uniform distribution on [2^i, 2^(i+1)).
+    weighted_sum += w.value() * std::ldexp(1.5, i);
+    cumulative_weights_.push_back(total);
+  }
+  if (total <= 0) {
+    cumulative_weights_.clear();
+    return -1;
+  }
+  mean_ = weighted_sum / total;
+  return 0;
+}
+
+double Log2Distribution::sample(folly::ThreadLocalPRNG& rng) const {
+  if (isConstant()) {
+    return 1;
+  }
+  double x = folly::Random::randDouble(0, cumulative_weights_.back(), rng);
+  size_t bucket = std::upper_bound(cumulative_weights_.begin(),
+                                   cumulative_weights_.end(),
+                                   x) -
+      cumulative_weights_.begin();
+  bucket = std::min(bucket, cumulative_weights_.size() - 1);
+  double lo = std::ldexp(1.0, bucket);
+  return folly::Random::randDouble(lo, lo * 2, rng) / mean_;
+}
+
+size_t roundRandomly(double x, folly::ThreadLocalPRNG& rng) {
+  if (x <= 0) {
+    return 0;
+  }
+  double whole = std::floor(x);
+  return (size_t)whole + (folly::Random::randDouble01(rng) < x - whole);
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <folly/Random.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+/**
+ * @file Variation around an average, as given by a '*-distribution' option,
+ *       see doc/ldbench.md. Either "constant" or a comma-separated
+ *       logarithmic histogram: bucket i is the relative probability of the
+ *       value being in [2^i, 2^(i+1)), uniformly inside the bucket.
+ *
+ *       sample() returns a multiplier to apply to the average, scaled so that
+ *       its expected value is 1.
+ */
+class Log2Distribution {
+ public:
+  // "constant"
+  Log2Distribution() = default;
+
+  /**
+   * @return 0 on success, -1 if `str' is neither "constant" nor a list of
+   *         non-negative numbers with a positive sum.
+   */
+  int parse(const std::string& str);
+
+  bool isConstant() const {
+    return cumulative_weights_.empty();
+  }
+
+  double sample(folly::ThreadLocalPRNG& rng) const;
+
+ private:
+  // Prefix sums of bucket weights.
+  std::vector<double> cumulative_weights_;
+  // Expected value of the unscaled distribution.
+  double mean_ = 1;
+};
+
+// Rounds `x' up or down at random, so that the expected value is `x'.
+size_t roundRandomly(double x, folly::ThreadLocalPRNG& rng);
+
+}}} // namespace facebook::logdevice::ldbench
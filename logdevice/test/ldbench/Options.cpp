@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/test/ldbench/Options.h"
+
+#include <iostream>
+
+#include <boost/program_options.hpp>
+#include <folly/Conv.h>
+#include <folly/String.h>
+
+#include "logdevice/common/commandline_util.h"
+#include "logdevice/common/commandline_util_chrono.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+namespace po = boost::program_options;
+
+static const char* USAGE =
+    R"DOC(Usage: ldbench --worker=WORKER --config-path=CONFIG [options...]
+
+Generates load against a LogDevice cluster and periodically prints a JSON
+line of ldbench_worker_stats to stdout. Workers:
+  write     appends to the logs at --write-bytes-per-sec
+  read      tails the logs with --fanout readers per log
+  backfill  reads the logs from --backfill-depth ago up to their tail as of
+            the start, then exits
+  mixed     write and read at the same time
+
+See doc/ldbench.md for the format of the *-distribution and *-spikiness
+options.
+
+)DOC";
+
+static po::typed_value<std::string>*
+distribution_value(Log2Distribution* out, const char* name) {
+  return po::value<std::string>()
+      ->default_value("constant")
+      ->notifier([out, name](const std::string& val) {
+        if (out->parse(val) != 0) {
+          throw po::error(folly::sformat("invalid --{}: {}", name, val));
+        }
+      });
+}
+
+static po::typed_value<std::string>* spikiness_value(Spikiness* out,
+                                                     const char* name) {
+  return po::value<std::string>()
+      ->default_value("0%/0%/1s")
+      ->notifier([out, name](const std::string& val) {
+        if (out->parse(val) != 0) {
+          throw po::error(folly::sformat("invalid --{}: {}", name, val));
+        }
+      });
+}
+
+Options parseCommandLine(int argc, const char** argv) {
+  Options o;
+  std::string logs;
+  std::vector<std::string> client_settings;
+
+  // clang-format off
+  po::options_description desc("Options");
+  desc.add_options()
+    ("help,h",
+     "produce this help message and exit")
+    ("worker",
+     po::value<std::string>(&o.worker)->required(),
+     "write, read, backfill or mixed")
+    ("config-path",
+     po::value<std::string>(&o.config_path)->required(),
+     "path to the cluster's config file")
+    ("duration",
+     chrono_value(&o.duration),
+     "how long to run; backfill stops earlier if it reaches the tail")
+    ("client-timeout",
+     chrono_value(&o.client_timeout),
+     "timeout for creating the client and for sync calls")
+    ("stats-interval",
+     chrono_value(&o.stats_interval),
+     "how often to print stats")
+    ("client-setting,o",
+     po::value<std::vector<std::string>>(&client_settings),
+     "client setting as name=value, can be given multiple times")
+    ("log-range-name",
+     po::value<std::string>(&o.log_range_name),
+     "use logs of this log group")
+    ("logs",
+     po::value<std::string>(&logs),
+     "use this range of logs, as lo..hi; alternative to --log-range-name")
+    ("instance-id",
+     po::value<size_t>(&o.instance_id)->default_value(o.instance_id),
+     "index of this ldbench process among --num-instances")
+    ("num-instances",
+     po::value<size_t>(&o.num_instances)->default_value(o.num_instances),
+     "number of ldbench processes sharing the logs and the rates")
+    ("write-bytes-per-sec",
+     po::value<double>(&o.write_bytes_per_sec)
+       ->default_value(o.write_bytes_per_sec),
+     "total append throughput over all logs and instances")
+    ("log-write-bytes-distribution",
+     distribution_value(&o.log_write_bytes_distribution,
+                        "log-write-bytes-distribution"),
+     "variation of the append throughput across logs")
+    ("write-spikiness",
+     spikiness_value(&o.write_spikiness, "write-spikiness"),
+     "spikiness of appends to each log")
+    ("payload-size",
+     po::value<size_t>(&o.payload_size)->default_value(o.payload_size),
+     "average payload size in bytes")
+    ("payload-size-distribution",
+     distribution_value(&o.payload_size_distribution,
+                        "payload-size-distribution"),
+     "variation of the payload size across appends")
+    ("max-appends-in-flight",
+     po::value<size_t>(&o.max_appends_in_flight)
+       ->default_value(o.max_appends_in_flight),
+     "appends over this limit are skipped and counted in "
+     "writer_appends_skipped")
+    ("max-append-bytes-in-flight",
+     po::value<size_t>(&o.max_append_bytes_in_flight)
+       ->default_value(o.max_append_bytes_in_flight),
+     "same as --max-appends-in-flight but for payload bytes")
+    ("fanout",
+     po::value<double>(&o.fanout)->default_value(o.fanout),
+     "average number of readers per log")
+    ("fanout-distribution",
+     distribution_value(&o.fanout_distribution, "fanout-distribution"),
+     "variation of the number of readers across logs")
+    ("backfill-depth",
+     chrono_value(&o.backfill_depth),
+     "backfill from this long ago; 'max' reads from the beginning")
+    ("loglevel",
+     po::value<std::string>()
+       ->default_value("warning")
+       ->notifier(dbg::parseLoglevelOption),
+     "One of the following: critical, error, warning, info, debug, spew");
+  // clang-format on
+
+  try {
+    po::variables_map parsed =
+        program_options_parse_no_positional(argc, argv, desc);
+    if (parsed.count("help")) {
+      std::cout << USAGE << desc << std::endl;
+      exit(0);
+    }
+    po::notify(parsed);
+
+    if (o.worker != "write" && o.worker != "read" &&
+        o.worker != "backfill" && o.worker != "mixed") {
+      throw po::error("unknown --worker: " + o.worker);
+    }
+    if (o.log_range_name.empty() == logs.empty()) {
+      throw po::error("exactly one of --log-range-name and --logs is needed");
+    }
+    if (!logs.empty()) {
+      std::string lo, hi;
+      if (!folly::split("..", logs, lo, hi)) {
+        lo = hi = logs;
+      }
+      o.log_lo = logid_t(folly::to<logid_t::raw_type>(lo));
+      o.log_hi = logid_t(folly::to<logid_t::raw_type>(hi));
+      if (o.log_lo == LOGID_INVALID || o.log_lo > o.log_hi) {
+        throw po::error("invalid --logs: " + logs);
+      }
+    }
+    if (o.num_instances == 0 || o.instance_id >= o.num_instances) {
+      throw po::error("--instance-id must be less than --num-instances");
+    }
+    if (o.payload_size == 0) {
+      throw po::error("--payload-size must be positive");
+    }
+    for (const std::string& s : client_settings) {
+      std::string name, value;
+      if (!folly::split('=', s, name, value)) {
+        throw po::error("invalid --client-setting: " + s);
+      }
+      o.client_settings.emplace_back(std::move(name), std::move(value));
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << argv[0] << ": " << ex.what() << std::endl
+              << "Try --help." << std::endl;
+    exit(1);
+  }
+  return o;
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "logdevice/include/types.h"
+#include "logdevice/test/ldbench/Distribution.h"
+#include "logdevice/test/ldbench/RandomEventSequence.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+/**
+ * Command line options shared by all workers. Rates are totals for the whole
+ * benchmark; with --num-instances N each ldbench process takes 1/N of the
+ * logs, so the overall load doesn't depend on how many processes run it.
+ */
+struct Options {
+  std::string worker;
+  std::string config_path;
+  std::chrono::milliseconds duration{60000};
+  std::chrono::milliseconds client_timeout{30000};
+  std::chrono::milliseconds stats_interval{10000};
+  std::vector<std::pair<std::string, std::string>> client_settings;
+
+  // Logs to use: either a log range name or an explicit range.
+  std::string log_range_name;
+  logid_t log_lo = LOGID_INVALID;
+  logid_t log_hi = LOGID_INVALID;
+  // This process uses logs whose index in the range is
+  // instance_id modulo num_instances.
+  size_t instance_id = 0;
+  size_t num_instances = 1;
+
+  // Writers.
+  double write_bytes_per_sec = 1e6;
+  Log2Distribution log_write_bytes_distribution;
+  Spikiness write_spikiness;
+  size_t payload_size = 1024;
+  Log2Distribution payload_size_distribution;
+  size_t max_appends_in_flight = 10000;
+  size_t max_append_bytes_in_flight = 1ul << 30;
+
+  // Readers.
+  double fanout = 1;
+  Log2Distribution fanout_distribution;
+
+  // Backfill: how far back from the tail to start reading, found with
+  // findTime(). max() means from the beginning of the log.
+  std::chrono::milliseconds backfill_depth = std::chrono::milliseconds::max();
+};
+
+/**
+ * Parses the command line. Prints usage and exits on --help or errors.
+ */
+Options parseCommandLine(int argc, const char** argv);
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/test/ldbench/RandomEventSequence.h"
+
+#include <cmath>
+#include <limits>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+
+#include "logdevice/common/commandline_util_chrono.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+static int parsePercentage(folly::StringPiece s, double* out) {
+  if (!s.removeSuffix("%")) {
+    return -1;
+  }
+  auto v = folly::tryTo<double>(s);
+  if (!v.hasValue() || !(v.value() >= 0 && v.value() <= 100)) {
+    return -1;
+  }
+  *out = v.value() / 100;
+  return 0;
+}
+
+int Spikiness::parse(const std::string& str) {
+  std::vector<std::string> tokens;
+  folly::split('/', str, tokens);
+  if (tokens.size() != 3 && tokens.size() != 4) {
+    return -1;
+  }
+  if (tokens.size() == 4 && tokens[3] != "aligned") {
+    return -1;
+  }
+  Spikiness s;
+  if (parsePercentage(tokens[0], &s.spike_events_fraction) != 0 ||
+      parsePercentage(tokens[1], &s.spike_duration_fraction) != 0 ||
+      parse_chrono_string(tokens[2], &s.period) != 0 ||
+      s.period.count() <= 0) {
+    return -1;
+  }
+  s.aligned = tokens.size() == 4;
+  *this = s;
+  return 0;
+}
+
+RandomEventSequence::RandomEventSequence(
+    double events_per_sec,
+    Spikiness spikiness,
+    std::chrono::steady_clock::time_point start,
+    folly::ThreadLocalPRNG& rng)
+    : events_per_sec_(events_per_sec),
+      spikiness_(spikiness),
+      start_(start),
+      rng_(rng),
+      period_sec_(spikiness.period.count() / 1000.) {
+  ld_check(period_sec_ > 0);
+  if (spikiness_.aligned) {
+    double now = std::chrono::duration_cast<std::chrono::duration<double>>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+    phase_sec_ = std::fmod(now, period_sec_);
+  } else {
+    phase_sec_ = folly::Random::randDouble(0, period_sec_, rng_);
+  }
+
+  const double spike_len = spikiness_.spike_duration_fraction * period_sec_;
+  if (phase_sec_ < spike_len) {
+    in_spike_ = true;
+    seg_start_ = 0;
+    seg_len_ = spike_len;
+  } else {
+    in_spike_ = false;
+    seg_start_ = spike_len;
+    seg_len_ = period_sec_ - spike_len;
+  }
+  seg_mass_ = segmentMass();
+  // seg_len_ > 0 here: phase_sec_ is inside the segment.
+  mass_left_ = seg_mass_ * (1 - (phase_sec_ - seg_start_) / seg_len_);
+}
+
+double RandomEventSequence::segmentMass() const {
+  double fraction = in_spike_ ? spikiness_.spike_events_fraction
+                              : 1 - spikiness_.spike_events_fraction;
+  return events_per_sec_ * period_sec_ * fraction;
+}
+
+double RandomEventSequence::next() {
+  if (!(events_per_sec_ > 0)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  // Expected number of events until the next one, 1 on average.
+  double e = -std::log(1 - folly::Random::randDouble01(rng_));
+  while (e > mass_left_) {
+    e -= mass_left_;
+    seg_start_ += seg_len_;
+    in_spike_ = !in_spike_;
+    seg_len_ = period_sec_ *
+        (in_spike_ ? spikiness_.spike_duration_fraction
+                   : 1 - spikiness_.spike_duration_fraction);
+    seg_mass_ = segmentMass();
+    mass_left_ = seg_mass_;
+  }
+  mass_left_ -= e;
+  // Zero-length segments put all their events at their start.
+  double t = seg_start_;
+  if (seg_mass_ > 0) {
+    t += seg_len_ * (1 - mass_left_ / seg_mass_);
+  }
+  return std::max(0., t - phase_sec_);
+}
+
+std::chrono::steady_clock::time_point
+RandomEventSequence::toTimePoint(double t) const {
+  return start_ +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+             std::chrono::duration<double>(t));
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include <folly/Random.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+/**
+ * A '*-spikiness' option, "x%/y%/t" or "x%/y%/t/aligned": fraction x of the
+ * events happen during spikes that last fraction y of each period t. See
+ * doc/ldbench.md.
+ */
+struct Spikiness {
+  double spike_events_fraction = 0;
+  double spike_duration_fraction = 0;
+  std::chrono::milliseconds period{1000};
+  // Spikes happen at the same time in all sequences, including sequences in
+  // other ldbench processes (as long as their clocks agree).
+  bool aligned = false;
+
+  // @return 0 on success, -1 if `str' is malformed.
+  int parse(const std::string& str);
+};
+
+/**
+ * Times of events of a Poisson process whose rate is piecewise constant:
+ * higher during spikes, lower between them, averaging to `events_per_sec'.
+ * Time between events is -log(x)/rate for x uniform in (0, 1], carried over
+ * segment boundaries.
+ *
+ * Times are in seconds since the steady_clock time passed to the
+ * constructor. Not thread-safe.
+ */
+class RandomEventSequence {
+ public:
+  RandomEventSequence(double events_per_sec,
+                      Spikiness spikiness,
+                      std::chrono::steady_clock::time_point start,
+                      folly::ThreadLocalPRNG& rng);
+
+  // Time of the next event, infinity if events_per_sec is zero. Never less
+  // than the time returned by the previous call.
+  double next();
+
+  std::chrono::steady_clock::time_point toTimePoint(double t) const;
+
+ private:
+  const double events_per_sec_;
+  const Spikiness spikiness_;
+  const std::chrono::steady_clock::time_point start_;
+  folly::ThreadLocalPRNG& rng_;
+
+  const double period_sec_;
+  // Offset of time 0 into the first period. Periods start with a spike.
+  double phase_sec_;
+
+  // The spike or the gap between spikes containing the last event. Start is
+  // in seconds since the start of the first period.
+  bool in_spike_;
+  double seg_start_;
+  double seg_len_;
+  // Expected number of events in the segment, and how many of them are
+  // after the last event.
+  double seg_mass_;
+  double mass_left_;
+
+  double segmentMass() const;
+};
+
+}}} // namespace facebook::logdevice::ldbench
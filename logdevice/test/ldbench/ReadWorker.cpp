@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/AsyncReader.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/test/ldbench/Worker.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+namespace {
+
+/**
+ * Tails the logs. Each log gets its own number of readers, drawn from
+ * --fanout and --fanout-distribution. Reader i of every log is read by the
+ * i-th AsyncReader, since an AsyncReader reads each log at most once.
+ */
+class ReadWorker : public Worker {
+ public:
+  explicit ReadWorker(WorkerContext& ctx) : ctx_(ctx) {}
+
+  ~ReadWorker() override {
+    stop();
+  }
+
+  int start() override;
+  void stop() override;
+
+ private:
+  WorkerContext& ctx_;
+  const Options& opts_{ctx_.options};
+  folly::ThreadLocalPRNG rng_;
+
+  std::vector<std::unique_ptr<AsyncReader>> readers_;
+  size_t streams_started_ = 0;
+};
+
+int ReadWorker::start() {
+  StatsHolder* stats = &ctx_.stats;
+  std::vector<size_t> num_readers(ctx_.logs.size());
+  size_t max_readers = 0;
+  for (size_t i = 0; i < ctx_.logs.size(); ++i) {
+    num_readers[i] = roundRandomly(
+        opts_.fanout * opts_.fanout_distribution.sample(rng_), rng_);
+    max_readers = std::max(max_readers, num_readers[i]);
+    STAT_ADD(stats, ldbench->readers_assigned, num_readers[i]);
+    STAT_ADD(stats, ldbench->reader_num_distinct_logs, num_readers[i] > 0);
+  }
+  STAT_SET(stats, ldbench->reader_max_readers_per_log, max_readers);
+  STAT_SET(stats,
+           ldbench->reader_avg_fanout_target_1000x,
+           (int64_t)(opts_.fanout * 1000));
+
+  for (size_t r = 0; r < max_readers; ++r) {
+    std::unique_ptr<AsyncReader> reader = ctx_.client->createAsyncReader();
+    reader->setRecordCallback([stats](std::unique_ptr<DataRecord>& record) {
+      onRecordDelivered(stats, *record, /* backlog */ false);
+      return true;
+    });
+    reader->setGapCallback([stats](const GapRecord& gap) {
+      onGapDelivered(stats, gap);
+      return true;
+    });
+    readers_.push_back(std::move(reader));
+  }
+
+  for (size_t i = 0; i < ctx_.logs.size(); ++i) {
+    if (num_readers[i] == 0) {
+      continue;
+    }
+    logid_t log = ctx_.logs[i];
+    lsn_t tail = ctx_.client->getTailLSNSync(log);
+    if (tail == LSN_INVALID) {
+      ld_error("Could not get tail LSN of log %lu: %s. Not reading it.",
+               log.val_,
+               error_description(err));
+      continue;
+    }
+    for (size_t r = 0; r < num_readers[i]; ++r) {
+      int rv = readers_[r]->startReading(log, tail + 1);
+      if (rv != 0) {
+        ld_error("startReading() of log %lu failed: %s",
+                 log.val_,
+                 error_description(err));
+        continue;
+      }
+      STAT_INCR(stats, ldbench->readers_active);
+      ++streams_started_;
+    }
+  }
+  return 0;
+}
+
+void ReadWorker::stop() {
+  // Destroying AsyncReaders stops their read streams and waits for
+  // callbacks in progress.
+  readers_.clear();
+  STAT_SUB(&ctx_.stats, ldbench->readers_active, streams_started_);
+  streams_started_ = 0;
+}
+
+} // namespace
+
+std::unique_ptr<Worker> createReadWorker(WorkerContext& ctx) {
+  return std::make_unique<ReadWorker>(ctx);
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/test/ldbench/Worker.h"
+
+#include <cstring>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/ClientFactory.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+static uint64_t usecSinceEpoch() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+WorkerContext::WorkerContext(const Options& opts)
+    : options(opts),
+      stats(StatsParams().setIsServer(false).setStatsSet(
+          StatsParams::StatsSet::LDBENCH_WORKER)),
+      start_time(std::chrono::steady_clock::now()) {}
+
+int WorkerContext::init() {
+  ClientFactory factory;
+  factory.setTimeout(options.client_timeout);
+  for (const auto& kv : options.client_settings) {
+    factory.setSetting(kv.first, kv.second);
+  }
+  client = factory.create(options.config_path);
+  if (!client) {
+    ld_error("Could not create client: %s", error_description(err));
+    return -1;
+  }
+
+  logid_range_t range(options.log_lo, options.log_hi);
+  if (!options.log_range_name.empty()) {
+    range = client->getLogRangeByName(options.log_range_name);
+    if (range.first == LOGID_INVALID) {
+      ld_error("Could not find log range %s: %s",
+               options.log_range_name.c_str(),
+               error_description(err));
+      return -1;
+    }
+  }
+
+  total_num_logs = range.second.val_ - range.first.val_ + 1;
+  for (size_t i = options.instance_id; i < total_num_logs;
+       i += options.num_instances) {
+    logs.push_back(logid_t(range.first.val_ + i));
+  }
+  if (logs.empty()) {
+    ld_error("No logs left for instance %lu out of %lu, range has %lu logs",
+             options.instance_id,
+             options.num_instances,
+             total_num_logs);
+    return -1;
+  }
+  STAT_INCR(&stats, ldbench->workers_started);
+  return 0;
+}
+
+std::vector<std::unique_ptr<Worker>> createWorkers(WorkerContext& ctx) {
+  const std::string& name = ctx.options.worker;
+  std::vector<std::unique_ptr<Worker>> workers;
+  if (name == "write" || name == "mixed") {
+    workers.push_back(createWriteWorker(ctx));
+  }
+  if (name == "read" || name == "mixed") {
+    workers.push_back(createReadWorker(ctx));
+  }
+  if (name == "backfill") {
+    workers.push_back(createBackfillWorker(ctx));
+  }
+  ld_check(!workers.empty());
+  return workers;
+}
+
+std::string makePayload(size_t size) {
+  std::string payload(size, 'x');
+  uint64_t ts = usecSinceEpoch();
+  memcpy(&payload[0], &ts, std::min(size, sizeof(ts)));
+  return payload;
+}
+
+void onRecordDelivered(StatsHolder* stats,
+                       const DataRecord& record,
+                       bool backlog) {
+  const Payload& payload = record.payload;
+  STAT_INCR(stats, ldbench->reader_records);
+  STAT_ADD(stats, ldbench->reader_bytes, payload.size());
+  if (backlog) {
+    STAT_ADD(stats, ldbench->reader_backlog_bytes, payload.size());
+    // Latency of backlog reads says nothing about delivery.
+    return;
+  }
+  uint64_t ts;
+  if (payload.size() < sizeof(ts)) {
+    STAT_INCR(stats, ldbench->reader_records_without_writer_info);
+    return;
+  }
+  memcpy(&ts, payload.data(), sizeof(ts));
+  uint64_t now = usecSinceEpoch();
+  stats->get().ldbench->delivery_latency->add(now > ts ? now - ts : 0);
+}
+
+void onGapDelivered(StatsHolder* stats, const GapRecord& gap) {
+  switch (gap.type) {
+    case GapType::ACCESS:
+      STAT_INCR(stats, ldbench->reader_gap_ACCESS);
+      break;
+    case GapType::DATALOSS:
+      STAT_INCR(stats, ldbench->reader_gap_DATALOSS);
+      break;
+    case GapType::BRIDGE:
+    case GapType::HOLE:
+    case GapType::TRIM:
+    case GapType::FILTERED_OUT:
+      // Benign.
+      break;
+    case GapType::UNKNOWN:
+    case GapType::NOTINCONFIG:
+    case GapType::MAX:
+      STAT_INCR(stats, ldbench->reader_gap_OTHER);
+      break;
+  }
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/test/ldbench/Options.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+/**
+ * Things shared by all workers of an ldbench process.
+ */
+struct WorkerContext {
+  explicit WorkerContext(const Options& opts);
+
+  /**
+   * Creates the client and resolves the logs of this instance.
+   *
+   * @return 0 on success, -1 on failure (the reason is logged).
+   */
+  int init();
+
+  const Options& options;
+  StatsHolder stats;
+  // After stats, so that the client and its callbacks go away first.
+  std::shared_ptr<Client> client;
+  // Logs used by this instance.
+  std::vector<logid_t> logs;
+  // Number of logs used by all instances. Rates in options are spread over
+  // this many logs.
+  size_t total_num_logs = 0;
+  std::chrono::steady_clock::time_point start_time;
+};
+
+/**
+ * A source of load. start() and stop() are called from the main thread;
+ * everything else happens on the worker's own threads or on client threads.
+ */
+class Worker {
+ public:
+  virtual ~Worker() {}
+
+  // @return 0 on success, -1 on failure (the reason is logged).
+  virtual int start() = 0;
+
+  // Stops generating load and waits for callbacks in flight.
+  virtual void stop() = 0;
+
+  // Workers with a finite amount of work (backfill) return true once they're
+  // done; the others run until the end of --duration.
+  virtual bool done() const {
+    return false;
+  }
+};
+
+std::unique_ptr<Worker> createWriteWorker(WorkerContext& ctx);
+std::unique_ptr<Worker> createReadWorker(WorkerContext& ctx);
+std::unique_ptr<Worker> createBackfillWorker(WorkerContext& ctx);
+
+/**
+ * Workers for the --worker option. "mixed" is a write and a read worker.
+ */
+std::vector<std::unique_ptr<Worker>> createWorkers(WorkerContext& ctx);
+
+// Payloads written by ldbench start with the time of the append, so that
+// readers can report delivery latency.
+std::string makePayload(size_t size);
+
+// Accounting shared by readers: updates reader_records, reader_bytes,
+// delivery_latency and reader_gap_* stats.
+void onRecordDelivered(StatsHolder* stats,
+                       const DataRecord& record,
+                       bool backlog);
+void onGapDelivered(StatsHolder* stats, const GapRecord& gap);
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/test/ldbench/Worker.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+namespace {
+
+/**
+ * Appends to each log at its own rate, drawn from
+ * --log-write-bytes-distribution, with times of appends from a
+ * RandomEventSequence per log. Appends that would exceed the in-flight
+ * limits are skipped rather than delayed, so that a slow cluster doesn't
+ * change the offered load.
+ */
+class WriteWorker : public Worker {
+ public:
+  explicit WriteWorker(WorkerContext& ctx) : ctx_(ctx) {}
+
+  ~WriteWorker() override {
+    stop();
+  }
+
+  int start() override;
+  void stop() override;
+
+ private:
+  // Appends in flight. Shared with append callbacks, which may outlive the
+  // worker if stop() times out waiting for them.
+  struct InFlight {
+    std::atomic<size_t> appends{0};
+    std::atomic<size_t> bytes{0};
+  };
+
+  void run();
+  void append(logid_t log);
+
+  WorkerContext& ctx_;
+  const Options& opts_{ctx_.options};
+  folly::ThreadLocalPRNG rng_;
+
+  std::vector<RandomEventSequence> events_;
+  std::shared_ptr<InFlight> in_flight_ = std::make_shared<InFlight>();
+  size_t max_payload_size_ = 0;
+  size_t largest_payload_size_ = 0;
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
+};
+
+int WriteWorker::start() {
+  StatsHolder* stats = &ctx_.stats;
+  max_payload_size_ = ctx_.client->getMaxPayloadSize();
+
+  const double avg_log_bytes_per_sec =
+      opts_.write_bytes_per_sec / ctx_.total_num_logs;
+  double total_bytes_per_sec = 0;
+  double highest_log_bytes_per_sec = 0;
+  events_.reserve(ctx_.logs.size());
+  for (size_t i = 0; i < ctx_.logs.size(); ++i) {
+    double bytes_per_sec =
+        avg_log_bytes_per_sec * opts_.log_write_bytes_distribution.sample(rng_);
+    total_bytes_per_sec += bytes_per_sec;
+    highest_log_bytes_per_sec =
+        std::max(highest_log_bytes_per_sec, bytes_per_sec);
+    events_.emplace_back(bytes_per_sec / opts_.payload_size,
+                         opts_.write_spikiness,
+                         ctx_.start_time,
+                         rng_);
+  }
+
+  STAT_SET(stats, ldbench->writer_throughput_total_target, total_bytes_per_sec);
+  STAT_SET(stats, ldbench->writer_payload_target_avg_size, opts_.payload_size);
+  STAT_SET(stats,
+           ldbench->writer_highest_target_log_throughput,
+           highest_log_bytes_per_sec);
+  STAT_SET(stats,
+           ldbench->writer_max_appends_in_flight,
+           opts_.max_appends_in_flight);
+  STAT_SET(stats,
+           ldbench->writer_max_append_bytes_in_flight,
+           opts_.max_append_bytes_in_flight);
+
+  thread_ = std::thread([this] { run(); });
+  return 0;
+}
+
+void WriteWorker::run() {
+  // (time of next append, index of log), earliest first.
+  using Event = std::pair<double, size_t>;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> queue;
+  for (size_t i = 0; i < events_.size(); ++i) {
+    double t = events_[i].next();
+    if (std::isfinite(t)) {
+      queue.emplace(t, i);
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopped_ && !queue.empty()) {
+    Event ev = queue.top();
+    auto when = events_[ev.second].toTimePoint(ev.first);
+    if (cv_.wait_until(lock, when, [this] { return stopped_; })) {
+      break;
+    }
+    lock.unlock();
+    queue.pop();
+    append(ctx_.logs[ev.second]);
+    queue.emplace(events_[ev.second].next(), ev.second);
+    lock.lock();
+  }
+}
+
+void WriteWorker::append(logid_t log) {
+  StatsHolder* stats = &ctx_.stats;
+  size_t size = roundRandomly(
+      opts_.payload_size * opts_.payload_size_distribution.sample(rng_), rng_);
+  size = std::min(std::max(size, 1ul), max_payload_size_);
+  if (size > largest_payload_size_) {
+    largest_payload_size_ = size;
+    STAT_SET(stats, ldbench->writer_largest_payload_size, size);
+  }
+
+  if (in_flight_->appends.load() >= opts_.max_appends_in_flight) {
+    STAT_INCR(stats, ldbench->writer_appends_skipped);
+    STAT_INCR(stats, ldbench->writer_appends_skipped_appends_in_flight);
+    return;
+  }
+  if (in_flight_->bytes.load() + size > opts_.max_append_bytes_in_flight) {
+    STAT_INCR(stats, ldbench->writer_appends_skipped);
+    STAT_INCR(stats, ldbench->writer_appends_skipped_bytes_in_flight);
+    return;
+  }
+
+  in_flight_->appends++;
+  in_flight_->bytes += size;
+  STAT_INCR(stats, ldbench->writer_appends_in_flight);
+  STAT_ADD(stats, ldbench->writer_append_bytes_in_flight, size);
+
+  auto on_done = [stats, in_flight = in_flight_, size](Status st) {
+    in_flight->appends--;
+    in_flight->bytes -= size;
+    STAT_DECR(stats, ldbench->writer_appends_in_flight);
+    STAT_SUB(stats, ldbench->writer_append_bytes_in_flight, size);
+    if (st == E::OK) {
+      STAT_INCR(stats, ldbench->writer_appends_succeeded);
+      STAT_ADD(stats, ldbench->writer_bytes_appended, size);
+    } else {
+      STAT_INCR(stats, ldbench->writer_appends_failed);
+    }
+  };
+  int rv = ctx_.client->append(
+      log, makePayload(size), [on_done](Status st, const DataRecord&) {
+        on_done(st);
+      });
+  if (rv != 0) {
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      2,
+                      "append() to log %lu failed: %s",
+                      log.val_,
+                      error_description(err));
+    on_done(err);
+  }
+}
+
+void WriteWorker::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  // Let appends in flight finish so that the final stats include them.
+  auto deadline = std::chrono::steady_clock::now() + opts_.client_timeout;
+  while (in_flight_->appends.load() > 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+} // namespace
+
+std::unique_ptr<Worker> createWriteWorker(WorkerContext& ctx) {
+  return std::make_unique<WriteWorker>(ctx);
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+#include <folly/Singleton.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/test/ldbench/Options.h"
+#include "logdevice/test/ldbench/Worker.h"
+
+using namespace facebook::logdevice;
+using namespace facebook::logdevice::ldbench;
+
+static std::atomic<bool> interrupted{false};
+
+static void handle_signal(int) {
+  interrupted.store(true);
+}
+
+// Prints a JSON line with the aggregated ldbench stats of this process.
+static void print_stats(const StatsHolder& holder,
+                        std::chrono::steady_clock::time_point start_time) {
+  Stats stats = holder.aggregate();
+  folly::dynamic obj = folly::dynamic::object;
+  obj["uptime_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - start_time)
+                         .count();
+#define STAT_DEFINE(name, _) obj[#name] = (int64_t)stats.ldbench->name;
+#include "logdevice/common/stats/ldbench_worker_stats.inc" // nolint
+
+  const double percentiles[] = {.5, .99};
+  int64_t samples[2];
+  uint64_t count;
+  int64_t sum;
+  stats.ldbench->delivery_latency->estimatePercentiles(
+      percentiles, 2, samples, &count, &sum);
+  obj["delivery_latency_count"] = count;
+  obj["delivery_latency_p50_us"] = samples[0];
+  obj["delivery_latency_p99_us"] = samples[1];
+  std::cout << folly::toJson(obj) << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  Options options = parseCommandLine(argc, argv);
+
+  WorkerContext ctx(options);
+  if (ctx.init() != 0) {
+    return 1;
+  }
+  std::vector<std::unique_ptr<Worker>> workers = createWorkers(ctx);
+  for (auto& worker : workers) {
+    if (worker->start() != 0) {
+      return 1;
+    }
+  }
+
+  std::signal(SIGINT, handle_signal);
+  std::signal(SIGTERM, handle_signal);
+
+  const auto deadline = ctx.start_time + options.duration;
+  auto next_stats = ctx.start_time + options.stats_interval;
+  while (!interrupted.load()) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline ||
+        std::all_of(workers.begin(), workers.end(), [](const auto& w) {
+          return w->done();
+        })) {
+      break;
+    }
+    if (now >= next_stats) {
+      print_stats(ctx.stats, ctx.start_time);
+      next_stats += options.stats_interval;
+    }
+    /* sleep override */
+    std::this_thread::sleep_for(std::min(
+        std::chrono::steady_clock::duration(std::chrono::milliseconds(100)),
+        std::min(deadline, next_stats) - now));
+  }
+
+  for (auto& worker : workers) {
+    worker->stop();
+  }
+  print_stats(ctx.stats, ctx.start_time);
+  workers.clear();
+  return 0;
+}